@@ -0,0 +1,106 @@
+#type compute
+#version 450 core
+
+// Linear blend skinning, see Engine::SkinningSystem.
+//
+// One dispatch per bind-pose source and output buffer: workgroup row y is
+// one instance (u_Jobs[y]), x runs over its vertices. Each vertex is skinned
+// by up to four joints of the instance's palette and written over the
+// instance's range as an Engine::Vertex, plus its position into the depth
+// stream, which the G-buffer, depth and shadow passes then draw as is.
+
+layout(local_size_x = 64) in;
+
+// Must match Engine::GPUSkinVertex
+struct SkinVertex {
+    vec3 Position;
+    uint Joints;            // Four 8-bit joint indices, first in the low byte
+    vec3 Normal;
+    float U;
+    vec3 Tangent;
+    float V;
+    vec3 Bitangent;
+    uint Padding;
+    vec4 Weights;
+};
+
+// Must match Engine::SkinningSystem::GPUSkinJob
+struct SkinJob {
+    uint VertexCount;
+    uint OutputVertex;      // Base vertex of the instance in the output buffers
+    uint PaletteOffset;     // First joint matrix of the instance
+    uint Padding;
+};
+
+layout(std430, binding = 0) readonly buffer SourceBuffer {
+    SkinVertex u_Source[];
+};
+
+layout(std430, binding = 1) readonly buffer PaletteBuffer {
+    mat4 u_Palette[];
+};
+
+layout(std430, binding = 2) readonly buffer JobBuffer {
+    SkinJob u_Jobs[];
+};
+
+// Engine::Vertex, 14 floats: position, normal, uv, tangent, bitangent
+layout(std430, binding = 3) writeonly buffer VertexBuffer {
+    float u_Vertices[];
+};
+
+// Depth stream, 3 floats per vertex
+layout(std430, binding = 4) writeonly buffer PositionBuffer {
+    float u_Positions[];
+};
+
+uniform bool u_WritePositions;
+
+const uint VERTEX_FLOATS = 14u;
+
+void WriteVec3(uint offset, vec3 v) {
+    u_Vertices[offset + 0u] = v.x;
+    u_Vertices[offset + 1u] = v.y;
+    u_Vertices[offset + 2u] = v.z;
+}
+
+void main() {
+    SkinJob job = u_Jobs[gl_WorkGroupID.y];
+    uint vertex = gl_GlobalInvocationID.x;
+    if (vertex >= job.VertexCount) return;
+
+    SkinVertex source = u_Source[vertex];
+    uvec4 joints = (uvec4(source.Joints) >> uvec4(0u, 8u, 16u, 24u)) & 0xFFu;
+    joints += job.PaletteOffset;
+
+    mat4 skin = u_Palette[joints.x] * source.Weights.x
+              + u_Palette[joints.y] * source.Weights.y
+              + u_Palette[joints.z] * source.Weights.z
+              + u_Palette[joints.w] * source.Weights.w;
+
+    vec3 position = (skin * vec4(source.Position, 1.0)).xyz;
+
+    // Cofactor matrix for the normal, as deferred/geometry.glsl does for
+    // the instance transform; tangents follow the joints directly
+    mat3 m = mat3(skin);
+    mat3 normalMatrix = mat3(cross(m[1], m[2]), cross(m[2], m[0]), cross(m[0], m[1]));
+    normalMatrix *= sign(dot(m[0], cross(m[1], m[2])));
+    vec3 normal = normalize(normalMatrix * source.Normal);
+    vec3 tangent = normalize(m * source.Tangent);
+    vec3 bitangent = normalize(m * source.Bitangent);
+
+    uint target = job.OutputVertex + vertex;
+    uint offset = target * VERTEX_FLOATS;
+    WriteVec3(offset, position);
+    WriteVec3(offset + 3u, normal);
+    u_Vertices[offset + 6u] = source.U;
+    u_Vertices[offset + 7u] = source.V;
+    WriteVec3(offset + 8u, tangent);
+    WriteVec3(offset + 11u, bitangent);
+
+    if (u_WritePositions) {
+        u_Positions[target * 3u + 0u] = position.x;
+        u_Positions[target * 3u + 1u] = position.y;
+        u_Positions[target * 3u + 2u] = position.z;
+    }
+}
@@ -0,0 +1,12 @@
+// Per-instance attributes streamed by BatchRenderer - vertex stage only
+// Locations and layout must match BatchRenderer's InstanceLayout
+
+#ifndef COMMON_BATCH_INSTANCE_GLSL
+#define COMMON_BATCH_INSTANCE_GLSL
+
+layout(location = 9) in mat4 a_Transform;          // Occupies 9-12
+layout(location = 13) in vec4 a_Color;
+layout(location = 14) in vec4 a_MaterialParams;    // Metallic, roughness, AO, normal strength
+layout(location = 15) in uint a_EntityId;          // Pass through as a flat varying for picking
+
+#endif // COMMON_BATCH_INSTANCE_GLSL
@@ -0,0 +1,33 @@
+// Per-frame camera block - written once per frame by CameraUniformBuffer
+// Include this file instead of declaring view / projection uniforms
+
+#ifndef COMMON_CAMERA_GLSL
+#define COMMON_CAMERA_GLSL
+
+layout(std140, binding = 1) uniform CameraBlock {
+    mat4 u_View;
+    mat4 u_Projection;
+    mat4 u_ViewProjection;
+    mat4 u_InverseView;
+    mat4 u_InverseProjection;
+    mat4 u_InverseViewProjection;
+    mat4 u_JitteredProjection;
+    mat4 u_JitteredViewProjection;
+    mat4 u_PreviousViewProjection;  // Unjittered, last frame
+    vec4 u_FrustumPlanes[6];        // xyz = normal, w = distance
+    vec3 u_CameraPosition;
+    float u_CameraNear;
+    vec2 u_ProjectionJitter;        // NDC units, zero without TAA
+    float u_CameraFar;
+};
+
+// World-space camera axes, for billboards
+vec3 CameraRight() {
+    return u_InverseView[0].xyz;
+}
+
+vec3 CameraUp() {
+    return u_InverseView[1].xyz;
+}
+
+#endif // COMMON_CAMERA_GLSL
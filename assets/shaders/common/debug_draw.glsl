@@ -0,0 +1,43 @@
+// Debug lines from compute shaders, drawn by Engine::DebugDraw::Render()
+// Constants and layout must match DebugDraw; BeginFrame() empties the buffer
+
+#ifndef COMMON_DEBUG_DRAW_GLSL
+#define COMMON_DEBUG_DRAW_GLSL
+
+#define DEBUG_DRAW_VERTICES_PER_MODE 65536u
+
+struct DebugDrawCommand {
+    uint Count;             // DrawArraysIndirectCommand, one per DebugDrawMode
+    uint InstanceCount;
+    uint First;
+    uint BaseInstance;
+};
+
+struct DebugDrawVertex {
+    vec3 Position;
+    uint Color;             // RGBA8
+};
+
+layout(std430, binding = 15) coherent buffer DebugDrawBuffer {
+    DebugDrawCommand DebugDrawCommands[2];
+    uint DebugDrawPadding[56];                  // Vertices start at 256 bytes
+    DebugDrawVertex DebugDrawVertices[];        // Depth-tested, then overlay
+};
+
+// Lines past the capacity are dropped
+void DebugDrawLine(vec3 from, vec3 to, vec4 color, bool overlay) {
+    uint mode = overlay ? 1u : 0u;
+    uint index = atomicAdd(DebugDrawCommands[mode].Count, 2u);
+    if (index + 2u > DEBUG_DRAW_VERTICES_PER_MODE) return;
+
+    uint base = mode * DEBUG_DRAW_VERTICES_PER_MODE + index;
+    uint packedColor = packUnorm4x8(color);
+    DebugDrawVertices[base] = DebugDrawVertex(from, packedColor);
+    DebugDrawVertices[base + 1u] = DebugDrawVertex(to, packedColor);
+}
+
+void DebugDrawLine(vec3 from, vec3 to, vec4 color) {
+    DebugDrawLine(from, to, color, false);
+}
+
+#endif // COMMON_DEBUG_DRAW_GLSL
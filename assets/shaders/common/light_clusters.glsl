@@ -0,0 +1,70 @@
+// Cluster lookup (see ClusteredLightCuller). Include after
+// common/lighting.glsl; the lists are only valid for fragments of the
+// render viewport the clusters were built for.
+
+#ifndef COMMON_LIGHT_CLUSTERS_GLSL
+#define COMMON_LIGHT_CLUSTERS_GLSL
+
+uniform uvec3 u_ClusterGridSize;
+uniform vec2 u_ScreenSize;
+uniform float u_ZNear;
+uniform float u_ClusterScale;
+uniform float u_ClusterBias;
+
+// x = first index in u_LightIndices, y = point count, z = spot count
+layout(std430, binding = 7) readonly buffer ClusterBuffer {
+    uvec4 u_Clusters[];
+};
+
+layout(std430, binding = 8) readonly buffer LightIndexBuffer {
+    uint u_LightIndices[];
+};
+
+// Cluster at screenUV (over the render viewport) and view depth viewZ
+uvec4 GetClusterAt(vec2 screenUV, float viewZ) {
+    uint slice = uint(max(log(max(viewZ, u_ZNear)) * u_ClusterScale + u_ClusterBias, 0.0));
+    uvec2 tile = uvec2(max(screenUV, vec2(0.0)) * vec2(u_ClusterGridSize.xy));
+
+    uvec3 cluster = min(uvec3(tile, slice), u_ClusterGridSize - 1u);
+    uint index = cluster.x + cluster.y * u_ClusterGridSize.x +
+                 cluster.z * u_ClusterGridSize.x * u_ClusterGridSize.y;
+    return u_Clusters[index];
+}
+
+// Compute shaders define LIGHT_CLUSTERS_NO_FRAGMENT: they have no
+// gl_FragCoord and look clusters up with GetClusterAt
+#ifndef LIGHT_CLUSTERS_NO_FRAGMENT
+
+uvec4 GetCluster(vec3 worldPos) {
+    float viewZ = -(u_View * vec4(worldPos, 1.0)).z;
+    return GetClusterAt(gl_FragCoord.xy / u_ScreenSize, viewZ);
+}
+
+// Point and spot lights binned into the cluster of a fragment at worldPos
+vec3 CalculateClusteredLights(vec3 worldPos, vec3 V, vec3 N,
+                              vec3 albedo, float metallic, float roughness, vec3 F0) {
+    vec3 Lo = vec3(0.0);
+    uvec4 cluster = GetCluster(worldPos);
+
+    for (uint i = 0u; i < cluster.y; ++i) {
+        uint lightIndex = u_LightIndices[cluster.x + i];
+        // attenuation.w holds the light's shadow slot, -1 when unshadowed
+        int shadowIndex = int(u_PointLights[lightIndex].attenuation.w);
+        Lo += CalculatePointLight(u_PointLights[lightIndex], worldPos, V, N,
+                                   albedo, metallic, roughness, F0, shadowIndex);
+    }
+
+    for (uint i = 0u; i < cluster.z; ++i) {
+        uint lightIndex = u_LightIndices[cluster.x + cluster.y + i];
+        // direction.w holds the light's shadow slot, -1 when unshadowed
+        int shadowIndex = int(u_SpotLights[lightIndex].direction.w);
+        Lo += CalculateSpotLight(u_SpotLights[lightIndex], worldPos, V, N,
+                                  albedo, metallic, roughness, F0, shadowIndex);
+    }
+
+    return Lo;
+}
+
+#endif // LIGHT_CLUSTERS_NO_FRAGMENT
+
+#endif // COMMON_LIGHT_CLUSTERS_GLSL
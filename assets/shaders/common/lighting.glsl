@@ -0,0 +1,514 @@
+// Shared light and shadow evaluation for the shading passes:
+// lighting.glsl (clustered), lighting_tiled.glsl and forward.glsl. The light
+// buffers and shadow data are bound by DeferredLightingSystem; include after
+// common/camera.glsl and before any use of the Calculate* functions.
+
+#ifndef COMMON_LIGHTING_GLSL
+#define COMMON_LIGHTING_GLSL
+
+// Shadow maps
+uniform sampler2DArray u_CSMShadowMap;
+uniform sampler2D u_SpotShadowAtlas;
+uniform sampler2D u_PointShadowAtlas;
+#ifdef EVSM
+uniform sampler2DArray u_CSMMoments;
+uniform sampler2D u_SpotMoments;
+uniform sampler2D u_PointMoments;
+#endif
+#ifdef VIRTUAL_SHADOWS
+uniform sampler2D u_VSMShadowMap;
+uniform usampler2D u_VSMPageTable;  // 1 = page holds a valid render
+#endif
+
+// Variant keywords (see DeferredLightingSystem::LightingVariantKey):
+//   SHADOWS      defined when the shadow system is enabled
+//   PCF_SAMPLES  Poisson taps per shadow lookup, 4, 8 or 16
+//   VIRTUAL_SHADOWS  the directional light has a virtual shadow map
+//   EVSM         cascades and atlases are sampled from prefiltered moments
+//                (ShadowFilter::EVSM) instead of PCF_SAMPLES depth taps
+#ifndef PCF_SAMPLES
+#define PCF_SAMPLES 16
+#endif
+
+// ============================================================================
+// Light buffer definitions
+// ============================================================================
+
+struct DirectionalLight {
+    vec4 direction;
+    vec4 colorIntensity;
+};
+
+struct PointLight {
+    vec4 position;
+    vec4 colorIntensity;
+    vec4 attenuation;
+};
+
+struct SpotLight {
+    vec4 position;
+    vec4 direction;
+    vec4 colorIntensity;
+    vec4 cutoffAtten;
+};
+
+layout(std140, binding = 0) uniform DirectionalLightBlock {
+    DirectionalLight u_DirectionalLights[4];
+};
+
+layout(std430, binding = 5) readonly buffer PointLightBuffer {
+    PointLight u_PointLights[];
+};
+
+layout(std430, binding = 6) readonly buffer SpotLightBuffer {
+    SpotLight u_SpotLights[];
+};
+
+// ============================================================================
+// Shadow UBO definitions
+// ============================================================================
+
+struct CascadeData {
+    mat4 viewProjection;
+    vec4 splitDepthBias;  // x=splitDepth, y=texelSize, z=bias, w=normalBias
+};
+
+struct SpotShadowData {
+    mat4 viewProjection;
+    vec4 atlasScaleOffset;  // xy=scale, zw=offset
+    vec4 params;            // x=bias, y=normalBias, z=softness, w=strength (0 = off)
+};
+
+struct VirtualShadowData {
+    mat4 viewProjection;
+    vec4 params;  // x=texelSize, y=bias, z=normalBias, w=enabled
+};
+
+struct PointShadowData {
+    vec4 positionFarPlane;        // xyz=position, w=farPlane
+    vec4 params;                  // x=bias, y=normalBias, z=softness, w=strength (0 = off)
+    vec4 faceScaleOffset[6];      // xy=scale, zw=offset, scale 0 = no casters
+    mat4 faceViewProjection[6];   // +X, -X, +Y, -Y, +Z, -Z
+};
+
+layout(std140, binding = 3) uniform ShadowDataBlock {
+    // CSM data
+    CascadeData u_Cascades[4];
+    vec4 u_CascadeSplitDepths;
+    vec4 u_ShadowParams;  // x=softness, y=maxDist, z=fadeStart, w=enabled
+
+    // Spot shadow data
+    SpotShadowData u_SpotShadows[16];
+
+    // Point shadow data
+    PointShadowData u_PointShadows[8];
+    ivec4 u_ShadowCounts;  // x=spotCount, y=pointCount
+
+    // Virtual shadow map of the directional light
+    VirtualShadowData u_VirtualShadow;
+
+    vec4 u_ShadowFilterParams;  // x=positiveExponent, y=negativeExponent, z=lightBleedReduction, w=evsm
+};
+
+#include "common/pbr.glsl"
+
+// ============================================================================
+// Shadow Functions
+// ============================================================================
+
+const vec2 POISSON_DISK[16] = vec2[](
+    vec2(-0.94201624, -0.39906216),
+    vec2(0.94558609, -0.76890725),
+    vec2(-0.094184101, -0.92938870),
+    vec2(0.34495938, 0.29387760),
+    vec2(-0.91588581, 0.45771432),
+    vec2(-0.81544232, -0.87912464),
+    vec2(-0.38277543, 0.27676845),
+    vec2(0.97484398, 0.75648379),
+    vec2(0.44323325, -0.97511554),
+    vec2(0.53742981, -0.47373420),
+    vec2(-0.26496911, -0.41893023),
+    vec2(0.79197514, 0.19090188),
+    vec2(-0.24188840, 0.99706507),
+    vec2(-0.81409955, 0.91437590),
+    vec2(0.19984126, 0.78641367),
+    vec2(0.14383161, -0.14100790)
+);
+
+int GetCascadeIndex(float viewDepth) {
+    int cascadeIndex = 0;
+    for (int i = 0; i < 4; i++) {
+        if (viewDepth > u_CascadeSplitDepths[i]) {
+            cascadeIndex = i + 1;
+        }
+    }
+    return min(cascadeIndex, 3);
+}
+
+float SampleShadowPCF(vec3 shadowCoord, int cascadeIndex, float softness, float texelSize, float bias) {
+    float shadow = 0.0;
+    float currentDepth = shadowCoord.z;
+
+    for (int i = 0; i < PCF_SAMPLES; i++) {
+        vec2 offset = POISSON_DISK[i] * softness * texelSize;
+        float closestDepth = texture(u_CSMShadowMap, vec3(shadowCoord.xy + offset, float(cascadeIndex))).r;
+        shadow += (currentDepth - bias) > closestDepth ? 0.0 : 1.0;
+    }
+
+    return shadow / float(PCF_SAMPLES);
+}
+
+#ifdef VIRTUAL_SHADOWS
+// Shadow from the virtual shadow map, or -1 where it has no valid render
+// under the kernel (outside the window, page not resident or not drawn yet)
+float SampleVirtualShadow(vec3 worldPos, vec3 normal, float softness) {
+    float texelSize = u_VirtualShadow.params.x;
+    float bias = u_VirtualShadow.params.y;
+    float normalBias = u_VirtualShadow.params.z;
+
+    vec4 shadowPos = u_VirtualShadow.viewProjection * vec4(worldPos + normal * normalBias, 1.0);
+    vec3 projCoords = shadowPos.xyz / shadowPos.w * 0.5 + 0.5;
+
+    // Same footprint vsm_mark_pages.glsl requested
+    float radius = (softness + 1.0) * texelSize;
+    if (projCoords.z > 1.0 ||
+        any(lessThan(projCoords.xy, vec2(radius))) ||
+        any(greaterThan(projCoords.xy, vec2(1.0 - radius)))) {
+        return -1.0;
+    }
+
+    vec2 pageCount = vec2(textureSize(u_VSMPageTable, 0));
+    ivec2 minPage = ivec2((projCoords.xy - radius) * pageCount);
+    ivec2 maxPage = ivec2((projCoords.xy + radius) * pageCount);
+    if (texelFetch(u_VSMPageTable, minPage, 0).r == 0u ||
+        texelFetch(u_VSMPageTable, ivec2(maxPage.x, minPage.y), 0).r == 0u ||
+        texelFetch(u_VSMPageTable, ivec2(minPage.x, maxPage.y), 0).r == 0u ||
+        texelFetch(u_VSMPageTable, maxPage, 0).r == 0u) {
+        return -1.0;
+    }
+
+    float shadow = 0.0;
+    for (int i = 0; i < PCF_SAMPLES; i++) {
+        vec2 offset = POISSON_DISK[i] * softness * texelSize;
+        float closestDepth = texture(u_VSMShadowMap, projCoords.xy + offset).r;
+        shadow += (projCoords.z - bias) > closestDepth ? 0.0 : 1.0;
+    }
+    return shadow / float(PCF_SAMPLES);
+}
+#endif
+
+#ifdef EVSM
+// Exponential variance shadows, see ShadowMomentMaps. Softness picks a
+// wider prefiltered level instead of more taps.
+float ChebyshevUpperBound(vec2 moments, float mean, float minVariance) {
+    float variance = max(moments.y - moments.x * moments.x, minVariance);
+    float d = mean - moments.x;
+    float pMax = variance / (variance + d * d);
+
+    // Cut off the tail that leaks light where casters overlap
+    float bleed = u_ShadowFilterParams.z;
+    pMax = clamp((pMax - bleed) / (1.0 - bleed), 0.0, 1.0);
+    return mean <= moments.x ? 1.0 : pMax;
+}
+
+float EVSMVisibility(vec4 moments, float depth) {
+    vec2 exponents = u_ShadowFilterParams.xy;
+    depth = 2.0 * depth - 1.0;
+    vec2 warped = vec2(exp(exponents.x * depth), -exp(-exponents.y * depth));
+
+    // Variance floor that follows the slope of each warp
+    vec2 depthScale = 0.0001 * exponents * warped;
+    vec2 minVariance = depthScale * depthScale;
+
+    return min(ChebyshevUpperBound(moments.xy, warped.x, minVariance.x),
+               ChebyshevUpperBound(moments.zw, warped.y, minVariance.y));
+}
+
+float MomentLevel(float softness) {
+    return max(log2(softness), 0.0);
+}
+
+// One lookup in an atlas tile, kept half a texel of the level inside it
+float SampleAtlasEVSM(sampler2D moments, vec2 tileUV, vec4 scaleOffset, float depth, float softness) {
+    float level = MomentLevel(softness);
+    vec2 texel = exp2(level) / vec2(textureSize(moments, 0));
+    vec2 tileMin = scaleOffset.zw + texel * 0.5;
+    vec2 tileMax = scaleOffset.zw + scaleOffset.xy - texel * 0.5;
+    vec2 atlasUV = clamp(tileUV * scaleOffset.xy + scaleOffset.zw, tileMin, tileMax);
+    return EVSMVisibility(textureLod(moments, atlasUV, level), depth);
+}
+#endif
+
+float CalculateCSMShadow(vec3 worldPos, vec3 normal, float viewDepth) {
+    // Check if shadows are disabled or beyond max distance
+    if (u_ShadowParams.w < 0.5 || viewDepth > u_ShadowParams.y) {
+        return 1.0;
+    }
+
+#ifdef VIRTUAL_SHADOWS
+    // The virtual map covers the camera's surroundings; the cascades fill in
+    // everywhere else
+    if (u_VirtualShadow.params.w > 0.5) {
+        float virtualShadow = SampleVirtualShadow(worldPos, normal, u_ShadowParams.x);
+        if (virtualShadow >= 0.0) {
+            return virtualShadow;
+        }
+    }
+#endif
+
+    // Select cascade
+    int cascadeIndex = GetCascadeIndex(viewDepth);
+
+    // Get cascade parameters
+    float bias = u_Cascades[cascadeIndex].splitDepthBias.z;
+    float normalBias = u_Cascades[cascadeIndex].splitDepthBias.w;
+    float texelSize = u_Cascades[cascadeIndex].splitDepthBias.y;
+    float softness = u_ShadowParams.x;
+
+    // Apply normal offset bias
+    vec3 samplingPos = worldPos + normal * normalBias;
+
+    // Transform to light space
+    vec4 shadowPos = u_Cascades[cascadeIndex].viewProjection * vec4(samplingPos, 1.0);
+    vec3 projCoords = shadowPos.xyz / shadowPos.w;
+    projCoords = projCoords * 0.5 + 0.5;
+
+    // Check bounds
+    if (projCoords.z > 1.0 ||
+        projCoords.x < 0.0 || projCoords.x > 1.0 ||
+        projCoords.y < 0.0 || projCoords.y > 1.0) {
+        return 1.0;
+    }
+
+#ifdef EVSM
+    vec4 moments = textureLod(u_CSMMoments, vec3(projCoords.xy, float(cascadeIndex)), MomentLevel(softness));
+    float shadow = EVSMVisibility(moments, projCoords.z - bias);
+#else
+    // Sample shadow with PCF
+    float shadow = SampleShadowPCF(projCoords, cascadeIndex, softness, texelSize, bias);
+#endif
+
+    // Fade out at max distance
+    float fadeStart = u_ShadowParams.z;
+    float maxDist = u_ShadowParams.y;
+    if (viewDepth > fadeStart) {
+        float fadeRatio = (viewDepth - fadeStart) / (maxDist - fadeStart);
+        shadow = mix(shadow, 1.0, fadeRatio);
+    }
+
+    return shadow;
+}
+
+float CalculateSpotShadow(int spotIndex, vec3 worldPos, vec3 normal) {
+    if (spotIndex < 0 || spotIndex >= u_ShadowCounts.x) {
+        return 1.0;
+    }
+
+    SpotShadowData shadow = u_SpotShadows[spotIndex];
+
+    if (shadow.params.w <= 0.0) {
+        return 1.0;  // Shadow disabled for this light
+    }
+
+    float bias = shadow.params.x;
+    float normalBias = shadow.params.y;
+    float softness = shadow.params.z;
+
+    // Apply normal offset bias
+    vec3 samplingPos = worldPos + normal * normalBias;
+
+    // Transform to light space
+    vec4 shadowPos = shadow.viewProjection * vec4(samplingPos, 1.0);
+    vec3 projCoords = shadowPos.xyz / shadowPos.w;
+    projCoords = projCoords * 0.5 + 0.5;
+
+    // Check bounds
+    if (projCoords.z > 1.0 ||
+        projCoords.x < 0.0 || projCoords.x > 1.0 ||
+        projCoords.y < 0.0 || projCoords.y > 1.0) {
+        return 1.0;
+    }
+
+#ifdef EVSM
+    return SampleAtlasEVSM(u_SpotMoments, projCoords.xy, shadow.atlasScaleOffset, projCoords.z - bias, softness);
+#else
+    // Transform UV to atlas tile coordinates
+    vec2 atlasUV = projCoords.xy * shadow.atlasScaleOffset.xy + shadow.atlasScaleOffset.zw;
+
+    // PCF sampling in atlas
+    float result = 0.0;
+    float texelSize = shadow.atlasScaleOffset.x / 512.0;  // Approximate texel size
+
+    for (int i = 0; i < PCF_SAMPLES; i++) {
+        vec2 offset = POISSON_DISK[i] * softness * texelSize;
+        float closestDepth = texture(u_SpotShadowAtlas, atlasUV + offset).r;
+        result += (projCoords.z - bias) > closestDepth ? 0.0 : 1.0;
+    }
+
+    return result / float(PCF_SAMPLES);
+#endif
+}
+
+float CalculatePointShadow(int pointIndex, vec3 worldPos, vec3 normal) {
+    if (pointIndex < 0 || pointIndex >= u_ShadowCounts.y) {
+        return 1.0;
+    }
+
+    PointShadowData shadow = u_PointShadows[pointIndex];
+
+    if (shadow.params.w <= 0.0) {
+        return 1.0;
+    }
+
+    float bias = shadow.params.x;
+    float normalBias = shadow.params.y;
+    float softness = shadow.params.z;
+
+    vec3 samplingPos = worldPos + normal * normalBias;
+
+    // Cube face from the major axis, same order as ShadowMapSystem
+    vec3 toFragment = samplingPos - shadow.positionFarPlane.xyz;
+    vec3 absDir = abs(toFragment);
+    int face;
+    if (absDir.x >= absDir.y && absDir.x >= absDir.z) {
+        face = toFragment.x > 0.0 ? 0 : 1;
+    } else if (absDir.y >= absDir.z) {
+        face = toFragment.y > 0.0 ? 2 : 3;
+    } else {
+        face = toFragment.z > 0.0 ? 4 : 5;
+    }
+
+    // Faces without casters get no tile
+    vec4 scaleOffset = shadow.faceScaleOffset[face];
+    if (scaleOffset.x <= 0.0) {
+        return 1.0;
+    }
+
+    vec4 shadowPos = shadow.faceViewProjection[face] * vec4(samplingPos, 1.0);
+    vec3 projCoords = shadowPos.xyz / shadowPos.w;
+    projCoords = projCoords * 0.5 + 0.5;
+
+    if (projCoords.z > 1.0) {
+        return 1.0;
+    }
+
+#ifdef EVSM
+    return SampleAtlasEVSM(u_PointMoments, clamp(projCoords.xy, 0.0, 1.0), scaleOffset, projCoords.z - bias, softness);
+#else
+    // Keep PCF taps inside the face's tile, neighbours belong to other faces
+    vec2 atlasTexel = 1.0 / vec2(textureSize(u_PointShadowAtlas, 0));
+    vec2 tileMin = scaleOffset.zw + atlasTexel * 0.5;
+    vec2 tileMax = scaleOffset.zw + scaleOffset.xy - atlasTexel * 0.5;
+    vec2 atlasUV = clamp(projCoords.xy, 0.0, 1.0) * scaleOffset.xy + scaleOffset.zw;
+
+    float result = 0.0;
+
+    for (int i = 0; i < PCF_SAMPLES; i++) {
+        vec2 offset = POISSON_DISK[i] * softness * atlasTexel;
+        float closestDepth = texture(u_PointShadowAtlas, clamp(atlasUV + offset, tileMin, tileMax)).r;
+        result += (projCoords.z - bias) > closestDepth ? 0.0 : 1.0;
+    }
+
+    return result / float(PCF_SAMPLES);
+#endif
+}
+
+// ============================================================================
+// Lighting Calculations
+// ============================================================================
+
+// Distance falloff of a point light at distance (within its radius)
+float PointLightAttenuation(PointLight light, float distance) {
+    float attenuation = 1.0 / (light.attenuation.x +
+                               light.attenuation.y * distance +
+                               light.attenuation.z * distance * distance);
+
+    float smoothFalloff = clamp(1.0 - distance / light.position.w, 0.0, 1.0);
+    return attenuation * smoothFalloff * smoothFalloff;
+}
+
+// Cone and distance falloff of a spot light; L is the unit direction to the
+// light from a point at distance (within its range)
+float SpotLightAttenuation(SpotLight light, vec3 L, float distance) {
+    float theta = dot(L, normalize(-light.direction.xyz));
+    float epsilon = light.cutoffAtten.x - light.cutoffAtten.y;
+    float intensity = clamp((theta - light.cutoffAtten.y) / epsilon, 0.0, 1.0);
+
+    float attenuation = 1.0 / (1.0 + light.cutoffAtten.z * distance +
+                               light.cutoffAtten.w * distance * distance);
+    return intensity * attenuation;
+}
+
+vec3 CalculateDirectionalLight(DirectionalLight light, vec3 worldPos, vec3 V, vec3 N,
+                                vec3 albedo, float metallic, float roughness, vec3 F0,
+                                float viewDepth, bool castsShadow) {
+    vec3 L = normalize(-light.direction.xyz);
+    vec3 lightColor = light.colorIntensity.rgb * light.colorIntensity.a;
+
+    vec3 lighting = CalculatePBR(L, V, N, lightColor, albedo, metallic, roughness, F0);
+
+#ifdef SHADOWS
+    if (castsShadow) {
+        float shadow = CalculateCSMShadow(worldPos, N, viewDepth);
+        lighting *= shadow;
+    }
+#endif
+
+    return lighting;
+}
+
+vec3 CalculatePointLight(PointLight light, vec3 worldPos, vec3 V, vec3 N,
+                          vec3 albedo, float metallic, float roughness, vec3 F0,
+                          int shadowIndex) {
+    vec3 L = light.position.xyz - worldPos;
+    float distance = length(L);
+
+    if (distance > light.position.w) return vec3(0.0);
+
+    L = normalize(L);
+
+    float attenuation = PointLightAttenuation(light, distance);
+    vec3 lightColor = light.colorIntensity.rgb * light.colorIntensity.a * attenuation;
+
+    vec3 lighting = CalculatePBR(L, V, N, lightColor, albedo, metallic, roughness, F0);
+
+#ifdef SHADOWS
+    if (shadowIndex >= 0) {
+        // params.w fades the shadow in and out of the shadow budget
+        float shadow = CalculatePointShadow(shadowIndex, worldPos, N);
+        lighting *= mix(1.0, shadow, u_PointShadows[shadowIndex].params.w);
+    }
+#endif
+
+    return lighting;
+}
+
+vec3 CalculateSpotLight(SpotLight light, vec3 worldPos, vec3 V, vec3 N,
+                         vec3 albedo, float metallic, float roughness, vec3 F0,
+                         int shadowIndex) {
+    vec3 L = light.position.xyz - worldPos;
+    float distance = length(L);
+
+    if (distance > light.position.w) return vec3(0.0);
+
+    L = normalize(L);
+
+    float attenuation = SpotLightAttenuation(light, L, distance);
+    if (attenuation <= 0.0) return vec3(0.0);
+
+    vec3 lightColor = light.colorIntensity.rgb * light.colorIntensity.a * attenuation;
+
+    vec3 lighting = CalculatePBR(L, V, N, lightColor, albedo, metallic, roughness, F0);
+
+    // Apply spot shadow if available
+#ifdef SHADOWS
+    if (shadowIndex >= 0) {
+        float shadow = CalculateSpotShadow(shadowIndex, worldPos, N);
+        lighting *= mix(1.0, shadow, u_SpotShadows[shadowIndex].params.w);
+    }
+#endif
+
+    return lighting;
+}
+
+#endif // COMMON_LIGHTING_GLSL
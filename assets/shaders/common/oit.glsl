@@ -0,0 +1,26 @@
+// Weighted blended order-independent transparency (McGuire and Bavoil,
+// "Weighted Blended Order-Independent Transparency", JCGT 2013).
+// Include from the fragment stage of a shader drawn between
+// WeightedBlendedOIT::Begin() and End() instead of declaring outputs; the
+// surfaces can be drawn in any order.
+
+#ifndef COMMON_OIT_GLSL
+#define COMMON_OIT_GLSL
+
+layout(location = 0) out vec4 o_Accumulation;  // Blended ONE, ONE
+layout(location = 1) out float o_Revealage;    // Blended ZERO, ONE_MINUS_SRC_COLOR
+
+// Favours near and opaque surfaces; the clamp keeps the 16-bit float
+// accumulation in range
+float TransparencyWeight(float alpha) {
+    float depth = 1.0 - gl_FragCoord.z * 0.9;
+    return clamp(pow(min(1.0, alpha * 10.0) + 0.01, 3.0) * 1e8 * depth * depth * depth, 1e-2, 3e3);
+}
+
+void WriteTransparent(vec3 premultipliedColor, float alpha) {
+    float weight = TransparencyWeight(alpha);
+    o_Accumulation = vec4(premultipliedColor, alpha) * weight;
+    o_Revealage = alpha;
+}
+
+#endif
@@ -1,6 +1,9 @@
 // PBR Functions - Cook-Torrance BRDF
 // Include this file in shaders that need PBR calculations
 
+#ifndef COMMON_PBR_GLSL
+#define COMMON_PBR_GLSL
+
 const float PI = 3.14159265359;
 
 // Normal Distribution Function (GGX/Trowbridge-Reitz)
@@ -72,3 +75,5 @@ vec3 CalculatePBR(vec3 L, vec3 V, vec3 N, vec3 lightColor, vec3 albedo,
 
     return (kD * albedo / PI + specular) * lightColor * NdotL;
 }
+
+#endif // COMMON_PBR_GLSL
@@ -0,0 +1,29 @@
+// Volumetric fog lookup (see Engine::VolumetricFog). Include after
+// common/camera.glsl; DeferredLightingSystem binds the volume of the main
+// view and clears u_HasVolumetricFog for every other one.
+
+#ifndef COMMON_VOLUMETRIC_FOG_GLSL
+#define COMMON_VOLUMETRIC_FOG_GLSL
+
+uniform sampler3D u_VolumetricFog;  // rgb = in-scattered light, a = transmittance
+uniform bool u_HasVolumetricFog;
+uniform float u_FogRange;
+
+// Depth slices are exponential between the camera's near plane and the
+// fog range, as in volumetric_fog_inject.glsl
+float FogSliceCoord(float viewZ) {
+    return log(max(viewZ, u_CameraNear) / u_CameraNear) / log(u_FogRange / u_CameraNear);
+}
+
+// color of a surface at screenUV (over the render viewport) and view depth
+// viewZ, as seen through the fog in front of it
+vec3 ApplyVolumetricFog(vec3 color, vec2 screenUV, float viewZ) {
+    if (!u_HasVolumetricFog) return color;
+
+    // A slice's texel holds the fog up to its far side, half a texel past its center
+    float sliceCoord = FogSliceCoord(viewZ) - 0.5 / float(textureSize(u_VolumetricFog, 0).z);
+    vec4 fog = textureLod(u_VolumetricFog, vec3(screenUV, sliceCoord), 0.0);
+    return color * fog.a + fog.rgb;
+}
+
+#endif // COMMON_VOLUMETRIC_FOG_GLSL
@@ -0,0 +1,54 @@
+#type vertex
+#version 450 core
+
+// World-space debug lines, see Engine::DebugDraw. No vertex attributes:
+// vertices are pulled from the bound buffer by gl_VertexID.
+
+#include "common/camera.glsl"
+
+struct DebugVertex {
+    vec3 Position;
+    uint Color;     // RGBA8
+};
+
+layout(std430, binding = 0) readonly buffer DebugVertices {
+    DebugVertex Vertices[];
+};
+
+// Vertices from here on are past what the draw may read (GPU lines whose
+// count ran over the capacity)
+uniform int u_VertexEnd;
+
+flat out vec4 v_Color;
+
+void main() {
+    if (gl_VertexID >= u_VertexEnd) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);    // Clipped
+        v_Color = vec4(0.0);
+        return;
+    }
+
+    DebugVertex vertex = Vertices[gl_VertexID];
+    gl_Position = u_ViewProjection * vec4(vertex.Position, 1.0);
+    v_Color = unpackUnorm4x8(vertex.Color);
+}
+
+#type fragment
+#version 450 core
+
+flat in vec4 v_Color;
+out vec4 FragColor;
+
+layout(binding = 0) uniform sampler2D u_SceneDepth;
+
+uniform int u_DepthTest;        // Compare against u_SceneDepth
+uniform vec2 u_ViewportSize;
+uniform vec2 u_DepthUVScale;    // Rendered part of u_SceneDepth
+
+void main() {
+    if (u_DepthTest != 0) {
+        vec2 uv = gl_FragCoord.xy / u_ViewportSize * u_DepthUVScale;
+        if (gl_FragCoord.z > texture(u_SceneDepth, uv).r + 1e-5) discard;
+    }
+    FragColor = v_Color;
+}
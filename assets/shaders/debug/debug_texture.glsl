@@ -8,6 +8,8 @@ out vec2 v_TexCoords;
 
 // Viewport in normalized coordinates: x, y (bottom-left), width, height
 uniform vec4 u_Viewport;
+// Part of the texture to show (G-Buffer rendered below full resolution)
+uniform vec2 u_UVScale;
 
 void main() {
     // Transform vertex position to viewport location
@@ -17,7 +19,7 @@ void main() {
     pos = pos * 2.0 - 1.0;  // Back to -1 to 1
 
     gl_Position = vec4(pos, 0.0, 1.0);
-    v_TexCoords = a_TexCoords;
+    v_TexCoords = a_TexCoords * u_UVScale;
 }
 
 #type fragment
@@ -30,11 +32,15 @@ out vec4 FragColor;
 uniform sampler2DArray u_DepthArray;  // CSM cascades
 uniform sampler2D u_Texture2D;         // Regular 2D texture
 uniform sampler2D u_DepthTexture;      // Single depth texture
+uniform usampler2D u_Counts;           // Overdraw counts
 
-uniform int u_Mode;       // 0=CSM depth array, 1=color texture, 2=single depth, 3=GBuffer normal
-uniform int u_Layer;      // Array layer for CSM
+uniform int u_Mode;       // 0=CSM depth array, 1=color texture, 2=single depth, 3=GBuffer normal,
+                          // 4=compact GBuffer normal, 5=compact GBuffer metal/rough, 6=Hi-Z level,
+                          // 7=overdraw heatmap
+uniform int u_Layer;      // Array layer for CSM, mip level for Hi-Z
 uniform float u_NearPlane;
 uniform float u_FarPlane;
+uniform float u_HeatmapMax;   // Count shown at full heat
 
 // Linearize depth for better visualization
 float LinearizeDepth(float depth) {
@@ -65,6 +71,35 @@ void main() {
         vec3 normal = texture(u_Texture2D, v_TexCoords).rgb;
         color = normal * 0.5 + 0.5;  // Map -1..1 to 0..1 for visualization
     }
+    else if (u_Mode == 4) {
+        // Compact GBuffer normals (octahedral RG16)
+        vec2 e = texture(u_Texture2D, v_TexCoords).rg * 2.0 - 1.0;
+        vec3 normal = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+        float t = clamp(-normal.z, 0.0, 1.0);
+        normal.xy += vec2(normal.x >= 0.0 ? -t : t, normal.y >= 0.0 ? -t : t);
+        color = normalize(normal) * 0.5 + 0.5;
+    }
+    else if (u_Mode == 5) {
+        // Compact GBuffer metallic (R) / roughness (G) from the albedo alpha
+        uint packedMR = uint(texture(u_Texture2D, v_TexCoords).a * 255.0 + 0.5);
+        color = vec3(float(packedMR >> 5u) / 7.0, float(packedMR & 31u) / 31.0, 0.0);
+    }
+    else if (u_Mode == 6) {
+        // Hi-Z min (R) / max (GB): gray where a texel is flat, red-shifted
+        // where it spans a depth edge
+        vec2 minMax = textureLod(u_Texture2D, v_TexCoords, float(u_Layer)).rg;
+        color = vec3(minMax.y, minMax.x, minMax.x);
+    }
+    else if (u_Mode == 7) {
+        // Overdraw: black where nothing was shaded, then blue (once), green,
+        // yellow and red at u_HeatmapMax invocations or more
+        uint count = texture(u_Counts, v_TexCoords).r;
+        float heat = clamp(float(count) / u_HeatmapMax, 0.0, 1.0);
+        color = count == 0u ? vec3(0.0)
+              : heat < 0.33 ? mix(vec3(0.0, 0.0, 1.0), vec3(0.0, 1.0, 0.0), heat / 0.33)
+              : heat < 0.66 ? mix(vec3(0.0, 1.0, 0.0), vec3(1.0, 1.0, 0.0), (heat - 0.33) / 0.33)
+              : mix(vec3(1.0, 1.0, 0.0), vec3(1.0, 0.0, 0.0), (heat - 0.66) / 0.34);
+    }
     else {
         color = vec3(1.0, 0.0, 1.0);  // Magenta for unknown mode
     }
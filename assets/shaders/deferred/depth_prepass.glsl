@@ -0,0 +1,43 @@
+#type vertex
+#version 450 core
+
+// Depth prepass for the G-Buffer fill (DeferredLightingSystem::DepthPrepass).
+// Fed from the mesh's position-only stream; packed positions are
+// dequantized by the instance transform as in geometry.glsl.
+layout(location = 0) in vec4 a_Position;
+
+// Per-instance index (baseInstance + gl_InstanceID), see IndirectDrawBatcher
+layout(location = 8) in uint a_InstanceIndex;
+
+// Must match Engine::InstanceData
+struct InstanceData {
+    mat4 Transform;
+    vec4 Color;
+    vec4 MaterialParams;
+    uint EntityId;
+    uint Flags;
+    uint MaterialIndex;
+    uint Padding;
+};
+
+layout(std430, binding = 4) readonly buffer InstanceBuffer {
+    InstanceData u_Instances[];
+};
+
+#include "common/camera.glsl"
+
+// The G-Buffer pass depth-tests GL_EQUAL against this; keep the position
+// math identical to geometry.glsl
+invariant gl_Position;
+
+void main() {
+    vec4 worldPos = u_Instances[a_InstanceIndex].Transform * vec4(a_Position.xyz, 1.0);
+    gl_Position = u_JitteredViewProjection * worldPos;
+}
+
+#type fragment
+#version 450 core
+
+void main() {
+    // Depth only; color writes are masked
+}
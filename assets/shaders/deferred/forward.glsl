@@ -0,0 +1,267 @@
+#type vertex
+#version 450 core
+
+// Forward+ shading of masked and transparent materials, drawn into the
+// lighting buffer after the deferred lighting pass (see
+// DeferredLightingSystem::ForwardPass). Same vertex inputs and instance
+// stream as geometry.glsl.
+layout(location = 0) in vec4 a_Position;
+layout(location = 1) in vec3 a_Normal;
+layout(location = 2) in vec2 a_TexCoords;
+layout(location = 3) in vec3 a_Tangent;
+layout(location = 4) in vec3 a_Bitangent;
+layout(location = 5) in vec4 a_PackedNormalTangent;
+
+// Per-instance index (baseInstance + gl_InstanceID), see IndirectDrawBatcher
+layout(location = 8) in uint a_InstanceIndex;
+
+// Must match Engine::InstanceData
+struct InstanceData {
+    mat4 Transform;
+    vec4 Color;
+    vec4 MaterialParams;    // metallic, roughness, ao, normal strength
+    uint EntityId;
+    uint Flags;
+    uint MaterialIndex;     // Engine::MaterialLibrary id, 0 = instance color only
+    uint Padding;
+};
+
+layout(std430, binding = 4) readonly buffer InstanceBuffer {
+    InstanceData u_Instances[];
+};
+
+// Must match Engine::GPUMaterial
+struct MaterialData {
+    vec4 BaseColor;
+    vec4 Params;            // metallic, roughness, ao, normal strength
+    vec4 Emissive;          // rgb = color * intensity, w = intensity
+    vec2 TilingFactor;
+    uint Flags;             // texture flags
+    float AlphaCutoff;
+    uvec2 Maps[5];
+    uvec2 Padding1;
+};
+
+layout(std430, binding = 11) readonly buffer MaterialBuffer {
+    MaterialData u_Materials[];
+};
+
+#include "common/camera.glsl"
+
+out VS_OUT {
+    vec3 WorldPos;
+    vec3 Normal;
+    vec2 TexCoords;
+    mat3 TBN;
+} vs_out;
+
+flat out vec4 v_AlbedoColor;
+flat out vec4 v_MaterialParams;
+flat out uint v_MaterialIndex;
+
+vec3 DecodeOctahedral(vec2 e) {
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main() {
+    InstanceData instance = u_Instances[a_InstanceIndex];
+    mat4 model = instance.Transform;
+
+    vec4 worldPos = model * vec4(a_Position.xyz, 1.0);
+    vs_out.WorldPos = worldPos.xyz;
+    vs_out.TexCoords = a_TexCoords;
+
+    // Cofactor matrix, as in geometry.glsl
+    mat3 m = mat3(model);
+    mat3 normalMatrix = mat3(cross(m[1], m[2]), cross(m[2], m[0]), cross(m[0], m[1]));
+    normalMatrix *= sign(dot(m[0], cross(m[1], m[2])));
+
+    vec3 normal = a_Normal;
+    vec3 tangent = a_Tangent;
+    float handedness = dot(cross(a_Normal, a_Tangent), a_Bitangent) < 0.0 ? -1.0 : 1.0;
+    if (dot(a_Normal, a_Normal) == 0.0) {
+        normal = DecodeOctahedral(a_PackedNormalTangent.xy);
+        tangent = DecodeOctahedral(a_PackedNormalTangent.zw);
+        handedness = a_Position.w * 2.0 - 1.0;
+    }
+
+    vec3 N = normalize(normalMatrix * normal);
+    vec3 T = normalize(normalMatrix * tangent);
+    T = normalize(T - dot(T, N) * N);
+    vec3 B = cross(N, T) * handedness;
+
+    vs_out.Normal = N;
+    vs_out.TBN = mat3(T, B, N);
+
+    v_AlbedoColor = instance.Color;
+    v_MaterialParams = instance.MaterialParams;
+    v_MaterialIndex = instance.MaterialIndex;
+    if (instance.MaterialIndex != 0u) {
+        v_AlbedoColor *= u_Materials[instance.MaterialIndex].BaseColor;
+        v_MaterialParams = u_Materials[instance.MaterialIndex].Params;
+    }
+
+    // Jittered like the G-Buffer, so its depth tests these exactly
+    gl_Position = u_JitteredViewProjection * worldPos;
+}
+
+#type fragment
+#version 450 core
+#ifdef BINDLESS_TEXTURES
+#extension GL_ARB_bindless_texture : require
+#endif
+
+// Variant keywords: those of lighting.glsl, plus
+//   OIT                transparent materials, written into
+//                      WeightedBlendedOIT's targets; masked ones otherwise
+//   BINDLESS_TEXTURES  material maps are bindless handles
+#ifdef OIT
+#include "common/oit.glsl"
+#else
+layout(location = 0) out vec4 FragColor;
+#endif
+
+in VS_OUT {
+    vec3 WorldPos;
+    vec3 Normal;
+    vec2 TexCoords;
+    mat3 TBN;
+} fs_in;
+
+flat in vec4 v_AlbedoColor;
+flat in vec4 v_MaterialParams;    // metallic, roughness, ao, normal strength
+flat in uint v_MaterialIndex;
+
+// Must match Engine::GPUMaterial
+struct MaterialData {
+    vec4 BaseColor;
+    vec4 Params;
+    vec4 Emissive;
+    vec2 TilingFactor;
+    uint Flags;
+    float AlphaCutoff;
+    uvec2 Maps[5];          // Bindless handle, or texture array slot and layer
+    uvec2 Padding1;
+};
+
+layout(std430, binding = 11) readonly buffer MaterialBuffer {
+    MaterialData u_Materials[];
+};
+
+#ifdef BINDLESS_TEXTURES
+vec4 SampleMap(uvec2 map, vec2 uv) {
+    return texture(sampler2D(map), uv);
+}
+#else
+// Engine::MaterialLibrary::MaxTextureArrays arrays from unit 8; the shadow
+// maps sit below them (DeferredLightingSystem::ForwardShadowUnit)
+layout(binding = 8) uniform sampler2DArray u_MaterialArrays[8];
+
+vec4 SampleMap(uvec2 map, vec2 uv) {
+    vec3 coord = vec3(uv, float(map.y));
+    switch (map.x) {
+        case 0u: return texture(u_MaterialArrays[0], coord);
+        case 1u: return texture(u_MaterialArrays[1], coord);
+        case 2u: return texture(u_MaterialArrays[2], coord);
+        case 3u: return texture(u_MaterialArrays[3], coord);
+        case 4u: return texture(u_MaterialArrays[4], coord);
+        case 5u: return texture(u_MaterialArrays[5], coord);
+        case 6u: return texture(u_MaterialArrays[6], coord);
+        case 7u: return texture(u_MaterialArrays[7], coord);
+    }
+    return vec4(1.0);
+}
+#endif
+
+const uint HAS_ALBEDO = 1u;
+const uint HAS_NORMAL = 2u;
+const uint HAS_METALLIC_ROUGHNESS = 4u;
+const uint HAS_AO = 8u;
+const uint HAS_EMISSIVE = 16u;
+
+// Camera
+#include "common/camera.glsl"
+
+// Ambient
+uniform vec4 u_AmbientLight;
+
+// Light counts (point / spot counts come per cluster)
+uniform int u_DirectionalLightCount;
+
+// Lights, shadows and the cluster lists built for the deferred pass
+#include "common/lighting.glsl"
+#include "common/light_clusters.glsl"
+
+void main() {
+    MaterialData material = u_Materials[v_MaterialIndex];
+    uint textureFlags = material.Flags;
+    vec2 uv = fs_in.TexCoords * material.TilingFactor;
+
+    vec4 albedo = v_AlbedoColor;
+    if ((textureFlags & HAS_ALBEDO) != 0u) {
+        albedo *= SampleMap(material.Maps[0], uv);
+    }
+
+#ifndef OIT
+    if (albedo.a < material.AlphaCutoff) {
+        discard;
+    }
+#endif
+
+    vec3 normal = normalize(fs_in.Normal);
+    if ((textureFlags & HAS_NORMAL) != 0u) {
+        vec3 tangentNormal = SampleMap(material.Maps[1], uv).rgb * 2.0 - 1.0;
+        tangentNormal.xy *= v_MaterialParams.w;
+        normal = normalize(fs_in.TBN * tangentNormal);
+    }
+
+    float metallic = v_MaterialParams.x;
+    float roughness = v_MaterialParams.y;
+    if ((textureFlags & HAS_METALLIC_ROUGHNESS) != 0u) {
+        vec2 mr = SampleMap(material.Maps[2], uv).bg;
+        metallic = mr.x;
+        roughness = mr.y;
+    }
+
+    float ao = v_MaterialParams.z;
+    if ((textureFlags & HAS_AO) != 0u) {
+        ao = SampleMap(material.Maps[3], uv).r;
+    }
+
+    vec3 emission = material.Emissive.rgb;
+    if ((textureFlags & HAS_EMISSIVE) != 0u) {
+        emission = SampleMap(material.Maps[4], uv).rgb * material.Emissive.w;
+    }
+
+    vec3 worldPos = fs_in.WorldPos;
+    vec3 V = normalize(u_CameraPosition - worldPos);
+
+    vec3 F0 = vec3(0.04);
+    F0 = mix(F0, albedo.rgb, metallic);
+
+    vec3 Lo = vec3(0.0);
+    float viewDepth = -(u_View * vec4(worldPos, 1.0)).z;
+
+    for (int i = 0; i < u_DirectionalLightCount; ++i) {
+        // First directional light casts shadows, as in lighting.glsl
+        bool castsShadow = (i == 0);
+        Lo += CalculateDirectionalLight(u_DirectionalLights[i], worldPos, V, normal,
+                                         albedo.rgb, metallic, roughness, F0,
+                                         viewDepth, castsShadow);
+    }
+
+    Lo += CalculateClusteredLights(worldPos, V, normal, albedo.rgb, metallic, roughness, F0);
+
+    vec3 ambient = u_AmbientLight.rgb * u_AmbientLight.a * albedo.rgb * ao;
+
+#ifdef OIT
+    // Reflected light scales with coverage, emitted light does not
+    WriteTransparent((ambient + Lo) * albedo.a + emission, albedo.a);
+#else
+    FragColor = vec4(ambient + Lo + emission, 1.0);
+#endif
+}
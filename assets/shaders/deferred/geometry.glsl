@@ -1,15 +1,58 @@
 #type vertex
 #version 450 core
 
-layout(location = 0) in vec3 a_Position;
+// Engine::Vertex fills 0-4. Engine::PackedVertex fills 0 (UNORM16, w =
+// bitangent sign), 2 (half floats) and 5 (octahedral normal and tangent);
+// its positions are dequantized by the instance transform. Either way the
+// other format's locations read (0, 0, 0, 1).
+layout(location = 0) in vec4 a_Position;
 layout(location = 1) in vec3 a_Normal;
 layout(location = 2) in vec2 a_TexCoords;
 layout(location = 3) in vec3 a_Tangent;
 layout(location = 4) in vec3 a_Bitangent;
+layout(location = 5) in vec4 a_PackedNormalTangent;
 
-uniform mat4 u_ViewProjection;
-uniform mat4 u_Model;
-uniform mat3 u_NormalMatrix;
+// Per-instance index (baseInstance + gl_InstanceID), see IndirectDrawBatcher
+layout(location = 8) in uint a_InstanceIndex;
+
+// Must match Engine::InstanceData
+struct InstanceData {
+    mat4 Transform;
+    vec4 Color;
+    vec4 MaterialParams;    // metallic, roughness, ao, normal strength
+    uint EntityId;
+    uint Flags;             // pass-specific, unused here
+    uint MaterialIndex;     // Engine::MaterialLibrary id, 0 = instance color only
+    uint Padding;
+};
+
+layout(std430, binding = 4) readonly buffer InstanceBuffer {
+    InstanceData u_Instances[];
+};
+
+// Last frame's transform per instance, indexed like u_Instances (see
+// IndirectDrawBatcher::PreviousTransformBinding)
+layout(std430, binding = 14) readonly buffer PreviousTransformBuffer {
+    mat4 u_PreviousTransforms[];
+};
+
+// Must match Engine::GPUMaterial
+struct MaterialData {
+    vec4 BaseColor;
+    vec4 Params;            // metallic, roughness, ao, normal strength
+    vec4 Emissive;          // rgb = color * intensity, w = intensity
+    vec2 TilingFactor;
+    uint Flags;             // texture flags
+    float AlphaCutoff;      // Masked materials only, drawn by forward.glsl
+    uvec2 Maps[5];
+    uvec2 Padding1;
+};
+
+layout(std430, binding = 11) readonly buffer MaterialBuffer {
+    MaterialData u_Materials[];
+};
+
+#include "common/camera.glsl"
 
 out VS_OUT {
     vec3 WorldPos;
@@ -18,29 +61,98 @@ out VS_OUT {
     mat3 TBN;
 } vs_out;
 
+flat out vec4 v_AlbedoColor;
+flat out vec4 v_MaterialParams;
+flat out uint v_MaterialIndex;
+flat out uint v_EntityId;
+
+// Unjittered clip positions, this frame and last, for the velocity target
+out vec4 v_CurrentClip;
+out vec4 v_PreviousClip;
+
+// Matches depth_prepass.glsl, which this pass depth-tests GL_EQUAL against
+invariant gl_Position;
+
+// Octahedral [-1, 1]^2 back to a unit vector
+vec3 DecodeOctahedral(vec2 e) {
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
 void main() {
-    vec4 worldPos = u_Model * vec4(a_Position, 1.0);
+    InstanceData instance = u_Instances[a_InstanceIndex];
+    mat4 model = instance.Transform;
+
+    vec4 worldPos = model * vec4(a_Position.xyz, 1.0);
     vs_out.WorldPos = worldPos.xyz;
     vs_out.TexCoords = a_TexCoords;
 
-    vec3 N = normalize(u_NormalMatrix * a_Normal);
-    vec3 T = normalize(u_NormalMatrix * a_Tangent);
+    // Cofactor matrix: inverse-transpose up to scale, which the normalize
+    // below removes. Avoids a per-vertex matrix inverse.
+    mat3 m = mat3(model);
+    mat3 normalMatrix = mat3(cross(m[1], m[2]), cross(m[2], m[0]), cross(m[0], m[1]));
+    normalMatrix *= sign(dot(m[0], cross(m[1], m[2])));
+
+    // Full vertices always carry a unit normal, so a zero one means packed
+    vec3 normal = a_Normal;
+    vec3 tangent = a_Tangent;
+    float handedness = dot(cross(a_Normal, a_Tangent), a_Bitangent) < 0.0 ? -1.0 : 1.0;
+    if (dot(a_Normal, a_Normal) == 0.0) {
+        normal = DecodeOctahedral(a_PackedNormalTangent.xy);
+        tangent = DecodeOctahedral(a_PackedNormalTangent.zw);
+        handedness = a_Position.w * 2.0 - 1.0;
+    }
+
+    vec3 N = normalize(normalMatrix * normal);
+    vec3 T = normalize(normalMatrix * tangent);
     T = normalize(T - dot(T, N) * N);
-    vec3 B = cross(N, T);
+    vec3 B = cross(N, T) * handedness;
 
     vs_out.Normal = N;
     vs_out.TBN = mat3(T, B, N);
 
-    gl_Position = u_ViewProjection * worldPos;
+    v_AlbedoColor = instance.Color;
+    v_MaterialParams = instance.MaterialParams;
+    v_MaterialIndex = instance.MaterialIndex;
+    v_EntityId = instance.EntityId;
+    if (instance.MaterialIndex != 0u) {
+        v_AlbedoColor *= u_Materials[instance.MaterialIndex].BaseColor;
+        v_MaterialParams = u_Materials[instance.MaterialIndex].Params;
+    }
+
+    vec4 previousWorldPos = u_PreviousTransforms[a_InstanceIndex] * vec4(a_Position.xyz, 1.0);
+    v_CurrentClip = u_ViewProjection * worldPos;
+    v_PreviousClip = u_PreviousViewProjection * previousWorldPos;
+
+    // The jitter is zero unless TAA is on
+    gl_Position = u_JitteredViewProjection * worldPos;
 }
 
 #type fragment
 #version 450 core
+#ifdef BINDLESS_TEXTURES
+#extension GL_ARB_bindless_texture : require
+#endif
+
+// Standard layout: Position, Normal, Albedo, Emission
+// Compact layout:  Normal (octahedral), Albedo + packed metal/rough, Emission
+// Both: entity ID at location 4, velocity at 5 (see GBuffer.hpp)
+layout(location = 0) out vec4 gTarget0;
+layout(location = 1) out vec4 gTarget1;
+layout(location = 2) out vec4 gTarget2;
+layout(location = 3) out vec4 gTarget3;
+layout(location = 4) out uint gEntityId;
+layout(location = 5) out vec2 gVelocity;
 
-layout(location = 0) out vec4 gPosition;
-layout(location = 1) out vec4 gNormal;
-layout(location = 2) out vec4 gAlbedo;
-layout(location = 3) out vec4 gEmission;
+#ifdef OVERDRAW
+// Engine::OverdrawCounter: one increment per invocation. The image store
+// would otherwise turn early depth testing off.
+layout(early_fragment_tests) in;
+layout(r32ui, binding = 0) uniform coherent uimage2D u_OverdrawCounts;
+#endif
 
 in VS_OUT {
     vec3 WorldPos;
@@ -49,29 +161,61 @@ in VS_OUT {
     mat3 TBN;
 } fs_in;
 
-// Material uniforms
-uniform vec4 u_AlbedoColor;
-uniform float u_Metallic;
-uniform float u_Roughness;
-uniform float u_AO;
-uniform vec3 u_EmissiveColor;
-uniform float u_EmissiveIntensity;
-uniform float u_NormalStrength;
-uniform vec2 u_TilingFactor;
-
-// Texture flags
-uniform uint u_TextureFlags;
-
-// Textures
-uniform sampler2D u_AlbedoMap;
-uniform sampler2D u_NormalMap;
-uniform sampler2D u_MetallicRoughnessMap;
-uniform sampler2D u_AOMap;
-uniform sampler2D u_EmissiveMap;
+// Per-instance material
+flat in vec4 v_AlbedoColor;
+flat in vec4 v_MaterialParams;    // metallic, roughness, ao, normal strength
+flat in uint v_MaterialIndex;
+flat in uint v_EntityId;
+
+in vec4 v_CurrentClip;
+in vec4 v_PreviousClip;
+
+// Must match Engine::GPUMaterial
+struct MaterialData {
+    vec4 BaseColor;
+    vec4 Params;
+    vec4 Emissive;
+    vec2 TilingFactor;
+    uint Flags;
+    float AlphaCutoff;
+    uvec2 Maps[5];          // Bindless handle, or texture array slot and layer
+    uvec2 Padding1;
+};
+
+layout(std430, binding = 11) readonly buffer MaterialBuffer {
+    MaterialData u_Materials[];
+};
+
+#ifdef BINDLESS_TEXTURES
+vec4 SampleMap(uvec2 map, vec2 uv) {
+    return texture(sampler2D(map), uv);
+}
+#else
+// Engine::MaterialLibrary::MaxTextureArrays arrays from unit 8. Constant
+// indices only: the slot need not be uniform across the draw.
+layout(binding = 8) uniform sampler2DArray u_MaterialArrays[8];
+
+vec4 SampleMap(uvec2 map, vec2 uv) {
+    vec3 coord = vec3(uv, float(map.y));
+    switch (map.x) {
+        case 0u: return texture(u_MaterialArrays[0], coord);
+        case 1u: return texture(u_MaterialArrays[1], coord);
+        case 2u: return texture(u_MaterialArrays[2], coord);
+        case 3u: return texture(u_MaterialArrays[3], coord);
+        case 4u: return texture(u_MaterialArrays[4], coord);
+        case 5u: return texture(u_MaterialArrays[5], coord);
+        case 6u: return texture(u_MaterialArrays[6], coord);
+        case 7u: return texture(u_MaterialArrays[7], coord);
+    }
+    return vec4(1.0);
+}
+#endif
 
 // Camera
-uniform float u_NearPlane;
-uniform float u_FarPlane;
+#include "common/camera.glsl"
+
+// G-Buffer layout (see GBuffer.hpp)
+uniform bool u_CompactGBuffer;
 
 const uint HAS_ALBEDO = 1u;
 const uint HAS_NORMAL = 2u;
@@ -79,54 +223,93 @@ const uint HAS_METALLIC_ROUGHNESS = 4u;
 const uint HAS_AO = 8u;
 const uint HAS_EMISSIVE = 16u;
 
+// Octahedral normal encoding into [0, 1]^2
+vec2 OctWrap(vec2 v) {
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 EncodeOctahedral(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    n.xy = n.z >= 0.0 ? n.xy : OctWrap(n.xy);
+    return n.xy * 0.5 + 0.5;
+}
+
+// 3 bits metallic (mostly 0 or 1 in practice) and 5 bits roughness
+float PackMetallicRoughness(float metallic, float roughness) {
+    uint m = uint(round(clamp(metallic, 0.0, 1.0) * 7.0));
+    uint r = uint(round(clamp(roughness, 0.0, 1.0) * 31.0));
+    return float((m << 5u) | r) / 255.0;
+}
+
 float LinearizeDepth(float depth) {
     float z = depth * 2.0 - 1.0;
-    return (2.0 * u_NearPlane * u_FarPlane) / (u_FarPlane + u_NearPlane - z * (u_FarPlane - u_NearPlane));
+    return (2.0 * u_CameraNear * u_CameraFar) / (u_CameraFar + u_CameraNear - z * (u_CameraFar - u_CameraNear));
 }
 
 void main() {
-    vec2 uv = fs_in.TexCoords * u_TilingFactor;
+#ifdef OVERDRAW
+    imageAtomicAdd(u_OverdrawCounts, ivec2(gl_FragCoord.xy), 1u);
+#endif
+
+    MaterialData material = u_Materials[v_MaterialIndex];
+    uint textureFlags = material.Flags;
+    vec2 uv = fs_in.TexCoords * material.TilingFactor;
 
     // Albedo
-    vec4 albedo = u_AlbedoColor;
-    if ((u_TextureFlags & HAS_ALBEDO) != 0u) {
-        albedo *= texture(u_AlbedoMap, uv);
+    vec4 albedo = v_AlbedoColor;
+    if ((textureFlags & HAS_ALBEDO) != 0u) {
+        albedo *= SampleMap(material.Maps[0], uv);
     }
 
     // Normal
     vec3 normal = fs_in.Normal;
-    if ((u_TextureFlags & HAS_NORMAL) != 0u) {
-        vec3 tangentNormal = texture(u_NormalMap, uv).rgb * 2.0 - 1.0;
-        tangentNormal.xy *= u_NormalStrength;
+    if ((textureFlags & HAS_NORMAL) != 0u) {
+        vec3 tangentNormal = SampleMap(material.Maps[1], uv).rgb * 2.0 - 1.0;
+        tangentNormal.xy *= v_MaterialParams.w;
         normal = normalize(fs_in.TBN * tangentNormal);
     }
 
     // Metallic & Roughness
-    float metallic = u_Metallic;
-    float roughness = u_Roughness;
-    if ((u_TextureFlags & HAS_METALLIC_ROUGHNESS) != 0u) {
-        vec2 mr = texture(u_MetallicRoughnessMap, uv).bg;
+    float metallic = v_MaterialParams.x;
+    float roughness = v_MaterialParams.y;
+    if ((textureFlags & HAS_METALLIC_ROUGHNESS) != 0u) {
+        vec2 mr = SampleMap(material.Maps[2], uv).bg;
         metallic = mr.x;
         roughness = mr.y;
     }
 
     // AO
-    float ao = u_AO;
-    if ((u_TextureFlags & HAS_AO) != 0u) {
-        ao = texture(u_AOMap, uv).r;
+    float ao = v_MaterialParams.z;
+    if ((textureFlags & HAS_AO) != 0u) {
+        ao = SampleMap(material.Maps[3], uv).r;
     }
 
     // Emission
-    vec3 emission = u_EmissiveColor * u_EmissiveIntensity;
-    if ((u_TextureFlags & HAS_EMISSIVE) != 0u) {
-        emission = texture(u_EmissiveMap, uv).rgb * u_EmissiveIntensity;
+    vec3 emission = material.Emissive.rgb;
+    if ((textureFlags & HAS_EMISSIVE) != 0u) {
+        emission = SampleMap(material.Maps[4], uv).rgb * material.Emissive.w;
     }
 
     // Output to G-Buffer
+    gEntityId = v_EntityId;
+
+    // Screen UV moved since last frame; nothing to reproject from behind
+    // the previous camera
+    vec2 current = v_CurrentClip.xy / v_CurrentClip.w;
+    vec2 previous = v_PreviousClip.w > 0.0 ? v_PreviousClip.xy / v_PreviousClip.w : current;
+    gVelocity = (current - previous) * 0.5;
+    if (u_CompactGBuffer) {
+        gTarget0 = vec4(EncodeOctahedral(normalize(normal)), 0.0, 0.0);
+        gTarget1 = vec4(albedo.rgb, PackMetallicRoughness(metallic, roughness));
+        gTarget2 = vec4(emission, ao);
+        gTarget3 = vec4(0.0);
+        return;
+    }
+
     float linearDepth = LinearizeDepth(gl_FragCoord.z);
 
-    gPosition = vec4(fs_in.WorldPos, linearDepth);
-    gNormal = vec4(normal * 0.5 + 0.5, metallic);
-    gAlbedo = vec4(albedo.rgb, roughness);
-    gEmission = vec4(emission, ao);
+    gTarget0 = vec4(fs_in.WorldPos, linearDepth);
+    gTarget1 = vec4(normal * 0.5 + 0.5, metallic);
+    gTarget2 = vec4(albedo.rgb, roughness);
+    gTarget3 = vec4(emission, ao);
 }
@@ -0,0 +1,150 @@
+#type compute
+#version 450 core
+
+// Half resolution ground-truth ambient occlusion, see Engine::AmbientOcclusion.
+//
+// One invocation per Hi-Z level 0 texel: the view-space position comes from
+// the texel's nearest depth and the normal from the G-Buffer pixel at its
+// corner. Each of u_Directions screen-space slices, rotated per pixel by
+// interleaved gradient noise, is searched on both sides for its highest
+// horizon within u_Radius; the cosine-weighted arc between the two horizons,
+// clamped to the hemisphere around the projected normal, is the slice's
+// visibility. Steps farther than a few texels read coarser pyramid levels.
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+// Must match AmbientOcclusion::MaxDirections / MaxSteps
+#define MAX_DIRECTIONS 4
+#define MAX_STEPS 8
+
+layout(binding = 0) uniform sampler2D u_HiZ;        // R = nearest depth
+layout(binding = 1) uniform sampler2D u_GNormal;
+layout(r8, binding = 0) uniform writeonly image2D u_Occlusion;
+
+#include "common/camera.glsl"
+
+uniform ivec2 u_HalfSize;       // Texels to write, half the depth viewport rounded up
+uniform ivec2 u_DepthSize;      // Rendered depth viewport
+uniform int u_LevelCount;
+uniform bool u_CompactGBuffer;
+
+uniform float u_Radius;
+uniform float u_Intensity;
+uniform float u_MaxPixelRadius;
+uniform int u_Directions;
+uniform int u_Steps;
+
+const float PI = 3.14159265359;
+const float HALF_PI = 1.57079632679;
+
+vec3 DecodeOctahedral(vec2 e) {
+    e = e * 2.0 - 1.0;
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+vec3 ViewNormal(ivec2 texel) {
+    ivec2 pixel = min(texel * 2, u_DepthSize - 1);
+    vec4 encoded = texelFetch(u_GNormal, pixel, 0);
+    vec3 world = u_CompactGBuffer ? DecodeOctahedral(encoded.rg) : normalize(encoded.rgb * 2.0 - 1.0);
+    return normalize(mat3(u_View) * world);
+}
+
+// position in half resolution texels, depth in [0, 1]
+vec3 ViewPosition(vec2 position, float depth) {
+    vec2 uv = position * 2.0 / vec2(u_DepthSize);
+    vec4 view = u_InverseProjection * vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    return view.xyz / view.w;
+}
+
+float InterleavedGradientNoise(vec2 p) {
+    return fract(52.9829189 * fract(dot(p, vec2(0.06711056, 0.00583715))));
+}
+
+// Nearest depth around position, from a level whose texels are about as
+// large as the step between samples
+float SampleDepth(vec2 position, float distance) {
+    int level = clamp(int(log2(max(distance, 1.0))) - 2, 0, u_LevelCount - 1);
+    return texelFetch(u_HiZ, ivec2(position) >> level, level).r;
+}
+
+void main() {
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(texel, u_HalfSize))) return;
+
+    float depth = texelFetch(u_HiZ, texel, 0).r;
+    if (depth >= 1.0) {
+        imageStore(u_Occlusion, texel, vec4(1.0));
+        return;
+    }
+
+    vec2 center = vec2(texel) + 0.5;
+    vec3 P = ViewPosition(center, depth);
+    vec3 N = ViewNormal(texel);
+    vec3 V = normalize(-P);
+
+    // World radius projected to half resolution texels
+    float projectedRadius = u_Radius * u_Projection[1][1] * 0.5 * float(u_HalfSize.y) / -P.z;
+    float pixelRadius = min(projectedRadius, u_MaxPixelRadius);
+    if (pixelRadius < 1.0) {
+        imageStore(u_Occlusion, texel, vec4(1.0));
+        return;
+    }
+
+    int directions = clamp(u_Directions, 1, MAX_DIRECTIONS);
+    int steps = clamp(u_Steps, 1, MAX_STEPS);
+    float stepSize = pixelRadius / float(steps);
+    float noise = InterleavedGradientNoise(vec2(texel));
+    float falloff = 1.0 / (u_Radius * u_Radius);
+
+    float visibility = 0.0;
+    for (int d = 0; d < directions; ++d) {
+        float phi = (float(d) + noise) * PI / float(directions);
+        vec2 direction = vec2(cos(phi), sin(phi));
+
+        // Slice plane through V, and the normal projected into it
+        vec3 sliceDirection = vec3(direction, 0.0);
+        vec3 orthoDirection = sliceDirection - dot(sliceDirection, V) * V;
+        vec3 axis = normalize(cross(orthoDirection, V));
+        vec3 projectedNormal = N - axis * dot(N, axis);
+        float projectedLength = length(projectedNormal);
+        if (projectedLength < 1e-4) continue;
+
+        float cosN = clamp(dot(projectedNormal, V) / projectedLength, 0.0, 1.0);
+        float n = sign(dot(orthoDirection, projectedNormal)) * acos(cosN);
+
+        // Highest horizon on each side, starting from the tangent plane
+        float horizons[2];
+        for (int side = 0; side < 2; ++side) {
+            float sideSign = side == 0 ? -1.0 : 1.0;
+            float lowest = cos(n + sideSign * HALF_PI);
+            float cosHorizon = lowest;
+
+            for (int s = 0; s < steps; ++s) {
+                float distance = max((float(s) + fract(noise + 0.618 * float(s))) * stepSize, 1.0);
+                vec2 position = center + direction * sideSign * distance;
+                if (any(lessThan(position, vec2(0.0))) || any(greaterThanEqual(position, vec2(u_HalfSize)))) break;
+
+                vec3 delta = ViewPosition(position, SampleDepth(position, distance)) - P;
+                float lengthSquared = dot(delta, delta);
+                float cosSample = dot(delta, V) * inversesqrt(max(lengthSquared, 1e-8));
+                float weight = clamp(1.0 - lengthSquared * falloff, 0.0, 1.0);
+                cosHorizon = max(cosHorizon, mix(lowest, cosSample, weight));
+            }
+            horizons[side] = sideSign * acos(clamp(cosHorizon, -1.0, 1.0));
+        }
+
+        float h0 = n + max(horizons[0] - n, -HALF_PI);
+        float h1 = n + min(horizons[1] - n, HALF_PI);
+        float sinN = sin(n);
+        float arc0 = -cos(2.0 * h0 - n) + cosN + 2.0 * h0 * sinN;
+        float arc1 = -cos(2.0 * h1 - n) + cosN + 2.0 * h1 * sinN;
+        visibility += projectedLength * 0.25 * (arc0 + arc1);
+    }
+    visibility = clamp(visibility / float(directions), 0.0, 1.0);
+
+    imageStore(u_Occlusion, texel, vec4(pow(visibility, u_Intensity)));
+}
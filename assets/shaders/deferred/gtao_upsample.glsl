@@ -0,0 +1,59 @@
+#type compute
+#version 450 core
+
+// Depth-aware upsample of gtao.glsl's half resolution visibility, see
+// Engine::AmbientOcclusion. Each pixel averages the 3x3 half resolution
+// texels around its own, weighted by distance and by how close their
+// linear depth (the Hi-Z level 0 nearest depth they were computed at) is
+// to the pixel's.
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler2D u_HiZ;
+layout(binding = 1) uniform sampler2D u_HalfOcclusion;
+layout(binding = 2) uniform sampler2D u_Depth;
+layout(r8, binding = 0) uniform writeonly image2D u_Occlusion;
+
+#include "common/camera.glsl"
+
+uniform ivec2 u_Size;           // Rendered depth viewport
+uniform ivec2 u_HalfSize;
+uniform float u_DepthSharpness;
+
+float LinearDepth(float depth) {
+    return u_Projection[3][2] / (depth * 2.0 - 1.0 + u_Projection[2][2]);
+}
+
+void main() {
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(pixel, u_Size))) return;
+
+    float depth = texelFetch(u_Depth, pixel, 0).r;
+    if (depth >= 1.0) {
+        imageStore(u_Occlusion, pixel, vec4(1.0));
+        return;
+    }
+
+    float z = LinearDepth(depth);
+    ivec2 home = pixel / 2;
+    vec2 position = vec2(pixel) + 0.5;
+
+    float sum = 0.0;
+    float weightSum = 0.0;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            ivec2 texel = clamp(home + ivec2(x, y), ivec2(0), u_HalfSize - 1);
+            vec2 offset = (vec2(texel) + 0.5) * 2.0 - position;
+            float spatial = exp(-0.25 * dot(offset, offset));
+            float texelZ = LinearDepth(texelFetch(u_HiZ, texel, 0).r);
+            float weight = spatial * exp(-abs(z - texelZ) * u_DepthSharpness / z);
+            sum += texelFetch(u_HalfOcclusion, texel, 0).r * weight;
+            weightSum += weight;
+        }
+    }
+
+    // Nothing at a similar depth nearby: take the texel this pixel belongs to
+    float occlusion = weightSum > 1e-4 ? sum / weightSum
+                                       : texelFetch(u_HalfOcclusion, min(home, u_HalfSize - 1), 0).r;
+    imageStore(u_Occlusion, pixel, vec4(occlusion));
+}
@@ -0,0 +1,130 @@
+#type compute
+#version 450 core
+
+// Hi-Z pyramid in one dispatch, see Engine::HiZPyramid.
+//
+// R = min (nearest) depth, G = max (farthest). Level 0 is the depth buffer
+// halved and padded to a power of two, so texel p of any level reduces
+// texels 2p .. 2p + 1 of the level below; anything outside the depth
+// viewport or a level's size reads as Empty.
+//
+// Each 16x16 group takes a 64x64 depth tile: every thread writes 2x2 level 0
+// texels and their level 1 texel, then levels 2-5 reduce in shared memory.
+// The group that finishes last reduces the levels above 5 from the level 5
+// texels every group wrote.
+
+layout(local_size_x = 16, local_size_y = 16) in;
+
+// Must match HiZPyramid::MaxLevels
+#define MAX_LEVELS 8
+
+layout(binding = 0) uniform sampler2D u_Depth;
+layout(rg32f, binding = 0) uniform coherent image2D u_Levels[MAX_LEVELS];
+
+// Groups done this build; the last one resets it
+layout(std430, binding = 0) coherent buffer HiZCounter {
+    uint u_GroupsDone;
+};
+
+uniform ivec2 u_DepthSize;      // Rendered viewport
+uniform int u_LevelCount;
+
+const vec2 Empty = vec2(1.0, 0.0);
+
+shared vec2 s_Reduce[16 * 16];
+shared bool s_IsLastGroup;
+
+vec2 Combine(vec2 a, vec2 b) {
+    return vec2(min(a.x, b.x), max(a.y, b.y));
+}
+
+vec2 Combine4(vec2 a, vec2 b, vec2 c, vec2 d) {
+    return Combine(Combine(a, b), Combine(c, d));
+}
+
+vec2 LoadDepth(ivec2 p) {
+    if (any(greaterThanEqual(p, u_DepthSize))) return Empty;
+    return vec2(texelFetch(u_Depth, p, 0).r);
+}
+
+vec2 LoadLevel(int level, ivec2 p) {
+    if (any(greaterThanEqual(p, imageSize(u_Levels[level])))) return Empty;
+    return imageLoad(u_Levels[level], p).rg;
+}
+
+// Stores past a level's size are dropped by imageStore
+void StoreLevel(int level, ivec2 p, vec2 value) {
+    if (level < u_LevelCount) {
+        imageStore(u_Levels[level], p, vec4(value, 0.0, 0.0));
+    }
+}
+
+vec2 LoadShared(ivec2 p) {
+    return s_Reduce[p.y * 16 + p.x];
+}
+
+void main() {
+    ivec2 tid = ivec2(gl_LocalInvocationID.xy);
+    ivec2 group = ivec2(gl_WorkGroupID.xy);
+
+    // Levels 0 and 1 straight from depth
+    vec2 level1 = Empty;
+    for (int y = 0; y < 2; ++y) {
+        for (int x = 0; x < 2; ++x) {
+            ivec2 p = group * 32 + tid * 2 + ivec2(x, y);
+            ivec2 d = p * 2;
+            vec2 value = Combine4(LoadDepth(d), LoadDepth(d + ivec2(1, 0)),
+                                  LoadDepth(d + ivec2(0, 1)), LoadDepth(d + ivec2(1, 1)));
+            StoreLevel(0, p, value);
+            level1 = Combine(level1, value);
+        }
+    }
+    StoreLevel(1, group * 16 + tid, level1);
+    s_Reduce[tid.y * 16 + tid.x] = level1;
+    barrier();
+
+    // Levels 2-5 in shared memory, 8x8 down to this group's single texel
+    for (int level = 2, size = 8; level <= 5; ++level, size >>= 1) {
+        bool active = all(lessThan(tid, ivec2(size)));
+        vec2 value = Empty;
+        if (active) {
+            ivec2 s = tid * 2;
+            value = Combine4(LoadShared(s), LoadShared(s + ivec2(1, 0)),
+                             LoadShared(s + ivec2(0, 1)), LoadShared(s + ivec2(1, 1)));
+            StoreLevel(level, group * size + tid, value);
+        }
+        barrier();
+        if (active) {
+            s_Reduce[tid.y * 16 + tid.x] = value;
+        }
+        barrier();
+    }
+
+    // Thread 0 wrote level 5; make it visible before counting the group done
+    if (gl_LocalInvocationIndex == 0u) {
+        memoryBarrierImage();
+        uint groupCount = gl_NumWorkGroups.x * gl_NumWorkGroups.y;
+        s_IsLastGroup = atomicAdd(u_GroupsDone, 1u) == groupCount - 1u;
+    }
+    barrier();
+
+    if (!s_IsLastGroup) return;
+
+    // Every level 5 texel is in; finish the chain
+    for (int level = 6; level < u_LevelCount; ++level) {
+        ivec2 size = imageSize(u_Levels[level]);
+        for (int i = int(gl_LocalInvocationIndex); i < size.x * size.y; i += 256) {
+            ivec2 p = ivec2(i % size.x, i / size.x);
+            ivec2 s = p * 2;
+            vec2 value = Combine4(LoadLevel(level - 1, s), LoadLevel(level - 1, s + ivec2(1, 0)),
+                                  LoadLevel(level - 1, s + ivec2(0, 1)), LoadLevel(level - 1, s + ivec2(1, 1)));
+            imageStore(u_Levels[level], p, vec4(value, 0.0, 0.0));
+        }
+        memoryBarrierImage();
+        barrier();
+    }
+
+    if (gl_LocalInvocationIndex == 0u) {
+        u_GroupsDone = 0u;
+    }
+}
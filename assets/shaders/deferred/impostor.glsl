@@ -0,0 +1,236 @@
+#type vertex
+#version 450 core
+
+// Impostor G-Buffer fill, see Engine::ImpostorLibrary. One quad per
+// instance facing the baked view nearest the camera direction; instances
+// come from an IndirectDrawBatcher as in geometry.glsl, with the impostor
+// index in InstanceData::Flags and the untransformed world matrix.
+
+layout(location = 0) in vec2 a_Corner;
+
+// Per-instance index (baseInstance + gl_InstanceID), see IndirectDrawBatcher
+layout(location = 8) in uint a_InstanceIndex;
+
+// Must match Engine::InstanceData
+struct InstanceData {
+    mat4 Transform;
+    vec4 Color;
+    vec4 MaterialParams;    // metallic, roughness, ao, normal strength
+    uint EntityId;
+    uint Flags;             // Impostor index
+    uint MaterialIndex;
+    uint Padding;
+};
+
+layout(std430, binding = 4) readonly buffer InstanceBuffer {
+    InstanceData u_Instances[];
+};
+
+layout(std430, binding = 14) readonly buffer PreviousTransformBuffer {
+    mat4 u_PreviousTransforms[];
+};
+
+// Must match ImpostorLibrary::GPUImpostor
+struct Impostor {
+    vec4 Sphere;            // Mesh space center, radius
+    uint Layer;
+    uint Padding0;
+    uint Padding1;
+    uint Padding2;
+};
+
+layout(std430, binding = 7) readonly buffer ImpostorBuffer {
+    Impostor u_Impostors[];
+};
+
+// Must match Engine::GPUMaterial
+struct MaterialData {
+    vec4 BaseColor;
+    vec4 Params;
+    vec4 Emissive;
+    vec2 TilingFactor;
+    uint Flags;
+    uint Padding;
+    uvec2 Maps[5];
+    uvec2 Padding1;
+};
+
+layout(std430, binding = 11) readonly buffer MaterialBuffer {
+    MaterialData u_Materials[];
+};
+
+#include "common/camera.glsl"
+
+uniform int u_FramesPerSide;
+
+out vec3 v_WorldPos;
+out vec3 v_AtlasCoord;          // uv, layer
+flat out vec3 v_FrameDirection; // World, scaled by the instance
+flat out float v_Radius;
+flat out mat3 v_NormalMatrix;
+flat out vec4 v_AlbedoColor;
+flat out vec4 v_MaterialParams;
+flat out vec3 v_Emission;
+flat out uint v_EntityId;
+
+out vec4 v_CurrentClip;
+out vec4 v_PreviousClip;
+
+vec2 SignNotZero(vec2 v) {
+    return vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+// Direction to [0, 1]^2, +Y at the center
+vec2 OctahedralEncode(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 e = n.y >= 0.0 ? n.xz : (1.0 - abs(n.zx)) * SignNotZero(n.xz);
+    return e * 0.5 + 0.5;
+}
+
+// Must match OctahedralDecode in ImpostorLibrary.cpp
+vec3 OctahedralDecode(vec2 uv) {
+    vec2 e = uv * 2.0 - 1.0;
+    vec3 n = vec3(e.x, 1.0 - abs(e.x) - abs(e.y), e.y);
+    if (n.y < 0.0) {
+        n.xz = (1.0 - abs(n.zx)) * SignNotZero(n.xz);
+    }
+    return normalize(n);
+}
+
+// Must match FrameBasis in ImpostorLibrary.cpp
+void FrameBasis(vec3 direction, out vec3 right, out vec3 up) {
+    vec3 worldUp = abs(direction.y) > 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(0.0, 1.0, 0.0);
+    right = normalize(cross(worldUp, direction));
+    up = cross(direction, right);
+}
+
+void main() {
+    InstanceData instance = u_Instances[a_InstanceIndex];
+    Impostor impostor = u_Impostors[instance.Flags];
+    mat4 model = instance.Transform;
+    mat3 linear = mat3(model);
+
+    // Camera direction in mesh space; the scale is uniform, so the
+    // transpose undoes the rotation
+    vec3 center = (model * vec4(impostor.Sphere.xyz, 1.0)).xyz;
+    vec3 toCamera = normalize(transpose(linear) * (u_CameraPosition - center));
+
+    float frames = float(u_FramesPerSide);
+    vec2 frame = clamp(floor(OctahedralEncode(toCamera) * frames), vec2(0.0), vec2(frames - 1.0));
+    vec3 direction = OctahedralDecode((frame + 0.5) / frames);
+    vec3 right, up;
+    FrameBasis(direction, right, up);
+
+    vec3 local = impostor.Sphere.xyz + (right * a_Corner.x + up * a_Corner.y) * impostor.Sphere.w;
+    vec4 worldPos = model * vec4(local, 1.0);
+
+    v_WorldPos = worldPos.xyz;
+    v_AtlasCoord = vec3((frame + a_Corner * 0.5 + 0.5) / frames, float(impostor.Layer));
+    v_FrameDirection = linear * direction;
+    v_Radius = impostor.Sphere.w;
+    v_NormalMatrix = linear;
+
+    v_AlbedoColor = instance.Color;
+    v_MaterialParams = instance.MaterialParams;
+    v_Emission = vec3(0.0);
+    v_EntityId = instance.EntityId;
+    if (instance.MaterialIndex != 0u) {
+        v_MaterialParams = u_Materials[instance.MaterialIndex].Params;
+        v_Emission = u_Materials[instance.MaterialIndex].Emissive.rgb;
+    }
+
+    v_CurrentClip = u_ViewProjection * worldPos;
+    v_PreviousClip = u_PreviousViewProjection * (u_PreviousTransforms[a_InstanceIndex] * vec4(local, 1.0));
+
+    gl_Position = u_JitteredViewProjection * worldPos;
+}
+
+#type fragment
+#version 450 core
+
+// Same targets as geometry.glsl
+layout(location = 0) out vec4 gTarget0;
+layout(location = 1) out vec4 gTarget1;
+layout(location = 2) out vec4 gTarget2;
+layout(location = 3) out vec4 gTarget3;
+layout(location = 4) out uint gEntityId;
+layout(location = 5) out vec2 gVelocity;
+
+in vec3 v_WorldPos;
+in vec3 v_AtlasCoord;
+flat in vec3 v_FrameDirection;
+flat in float v_Radius;
+flat in mat3 v_NormalMatrix;
+flat in vec4 v_AlbedoColor;
+flat in vec4 v_MaterialParams;
+flat in vec3 v_Emission;
+flat in uint v_EntityId;
+
+in vec4 v_CurrentClip;
+in vec4 v_PreviousClip;
+
+layout(binding = 0) uniform sampler2DArray u_ImpostorAlbedo;
+layout(binding = 1) uniform sampler2DArray u_ImpostorNormalDepth;
+
+#include "common/camera.glsl"
+
+uniform bool u_CompactGBuffer;
+
+vec2 OctWrap(vec2 v) {
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 EncodeOctahedral(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    n.xy = n.z >= 0.0 ? n.xy : OctWrap(n.xy);
+    return n.xy * 0.5 + 0.5;
+}
+
+float PackMetallicRoughness(float metallic, float roughness) {
+    uint m = uint(round(clamp(metallic, 0.0, 1.0) * 7.0));
+    uint r = uint(round(clamp(roughness, 0.0, 1.0) * 31.0));
+    return float((m << 5u) | r) / 255.0;
+}
+
+float LinearizeDepth(float depth) {
+    float z = depth * 2.0 - 1.0;
+    return (2.0 * u_CameraNear * u_CameraFar) / (u_CameraFar + u_CameraNear - z * (u_CameraFar - u_CameraNear));
+}
+
+void main() {
+    vec4 albedo = texture(u_ImpostorAlbedo, v_AtlasCoord);
+    if (albedo.a < 0.5) {
+        discard;
+    }
+    vec4 normalDepth = texture(u_ImpostorNormalDepth, v_AtlasCoord);
+
+    // The quad passes through the sphere's center; push the fragment to the
+    // baked surface along the view
+    vec3 worldPos = v_WorldPos + v_FrameDirection * ((normalDepth.a * 2.0 - 1.0) * v_Radius);
+    vec4 clip = u_JitteredViewProjection * vec4(worldPos, 1.0);
+    gl_FragDepth = clip.z / clip.w * 0.5 + 0.5;
+
+    vec3 normal = normalize(v_NormalMatrix * (normalDepth.rgb * 2.0 - 1.0));
+    vec3 color = albedo.rgb / albedo.a * v_AlbedoColor.rgb;
+    float metallic = v_MaterialParams.x;
+    float roughness = v_MaterialParams.y;
+    float ao = v_MaterialParams.z;
+
+    gEntityId = v_EntityId;
+
+    vec2 current = v_CurrentClip.xy / v_CurrentClip.w;
+    vec2 previous = v_PreviousClip.w > 0.0 ? v_PreviousClip.xy / v_PreviousClip.w : current;
+    gVelocity = (current - previous) * 0.5;
+    if (u_CompactGBuffer) {
+        gTarget0 = vec4(EncodeOctahedral(normal), 0.0, 0.0);
+        gTarget1 = vec4(color, PackMetallicRoughness(metallic, roughness));
+        gTarget2 = vec4(v_Emission, ao);
+        gTarget3 = vec4(0.0);
+        return;
+    }
+
+    gTarget0 = vec4(worldPos, LinearizeDepth(gl_FragDepth));
+    gTarget1 = vec4(normal * 0.5 + 0.5, metallic);
+    gTarget2 = vec4(color, roughness);
+    gTarget3 = vec4(v_Emission, ao);
+}
@@ -0,0 +1,114 @@
+#type vertex
+#version 450 core
+
+// One octahedral view of Engine::ImpostorLibrary::Bake: an orthographic
+// projection of the bounding sphere along -u_FrameDirection. Vertex inputs
+// as geometry.glsl.
+layout(location = 0) in vec4 a_Position;
+layout(location = 1) in vec3 a_Normal;
+layout(location = 2) in vec2 a_TexCoords;
+layout(location = 5) in vec4 a_PackedNormalTangent;
+
+uniform mat4 u_Model;           // Mesh::GetDrawTransform of identity: dequantization only
+uniform vec4 u_Sphere;          // Mesh space center, radius
+uniform vec3 u_FrameDirection;  // Toward the viewer
+uniform vec3 u_FrameRight;
+uniform vec3 u_FrameUp;
+
+out vec3 v_Normal;              // Mesh space
+out vec2 v_TexCoords;
+out float v_Depth;              // -1 far side of the sphere, 1 near side
+
+vec3 DecodeOctahedral(vec2 e) {
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main() {
+    vec3 offset = (u_Model * vec4(a_Position.xyz, 1.0)).xyz - u_Sphere.xyz;
+
+    // Full vertices always carry a unit normal, so a zero one means packed
+    vec3 normal = a_Normal;
+    if (dot(a_Normal, a_Normal) == 0.0) {
+        normal = DecodeOctahedral(a_PackedNormalTangent.xy);
+    }
+    v_Normal = normal;
+    v_TexCoords = a_TexCoords;
+    v_Depth = dot(offset, u_FrameDirection) / u_Sphere.w;
+
+    gl_Position = vec4(dot(offset, u_FrameRight) / u_Sphere.w, dot(offset, u_FrameUp) / u_Sphere.w, -v_Depth, 1.0);
+}
+
+#type fragment
+#version 450 core
+#ifdef BINDLESS_TEXTURES
+#extension GL_ARB_bindless_texture : require
+#endif
+
+layout(location = 0) out vec4 o_Albedo;         // rgb, coverage
+layout(location = 1) out vec4 o_NormalDepth;    // Mesh space normal, depth, all [0, 1]
+
+in vec3 v_Normal;
+in vec2 v_TexCoords;
+in float v_Depth;
+
+// Must match Engine::GPUMaterial
+struct MaterialData {
+    vec4 BaseColor;
+    vec4 Params;
+    vec4 Emissive;
+    vec2 TilingFactor;
+    uint Flags;
+    uint Padding;
+    uvec2 Maps[5];          // Bindless handle, or texture array slot and layer
+    uvec2 Padding1;
+};
+
+layout(std430, binding = 11) readonly buffer MaterialBuffer {
+    MaterialData u_Materials[];
+};
+
+#ifdef BINDLESS_TEXTURES
+vec4 SampleMap(uvec2 map, vec2 uv) {
+    return texture(sampler2D(map), uv);
+}
+#else
+// Engine::MaterialLibrary::MaxTextureArrays arrays from unit 8
+layout(binding = 8) uniform sampler2DArray u_MaterialArrays[8];
+
+vec4 SampleMap(uvec2 map, vec2 uv) {
+    vec3 coord = vec3(uv, float(map.y));
+    switch (map.x) {
+        case 0u: return texture(u_MaterialArrays[0], coord);
+        case 1u: return texture(u_MaterialArrays[1], coord);
+        case 2u: return texture(u_MaterialArrays[2], coord);
+        case 3u: return texture(u_MaterialArrays[3], coord);
+        case 4u: return texture(u_MaterialArrays[4], coord);
+        case 5u: return texture(u_MaterialArrays[5], coord);
+        case 6u: return texture(u_MaterialArrays[6], coord);
+        case 7u: return texture(u_MaterialArrays[7], coord);
+    }
+    return vec4(1.0);
+}
+#endif
+
+uniform uint u_MaterialIndex;
+
+const uint HAS_ALBEDO = 1u;
+
+void main() {
+    MaterialData material = u_Materials[u_MaterialIndex];
+
+    // Untinted; the instance color multiplies in when drawn
+    vec3 albedo = material.BaseColor.rgb;
+    if ((material.Flags & HAS_ALBEDO) != 0u) {
+        albedo *= SampleMap(material.Maps[0], v_TexCoords * material.TilingFactor).rgb;
+    }
+
+    vec3 normal = normalize(gl_FrontFacing ? v_Normal : -v_Normal);
+    o_Albedo = vec4(albedo, 1.0);
+    o_NormalDepth = vec4(normal * 0.5 + 0.5, v_Depth * 0.5 + 0.5);
+}
@@ -0,0 +1,163 @@
+#type compute
+#version 450 core
+
+// Clustered light culling: one invocation per froxel. Each cluster's view
+// space AABB is rebuilt from the inverse projection, tested against every
+// point / spot light bounding sphere (streamed through shared memory in
+// batches) and the visible light indices are appended to a global list.
+//
+// Must match ClusteredLightCuller.
+#define CLUSTER_THREADS 128
+#define MAX_LIGHTS_PER_CLUSTER 128
+
+layout(local_size_x = CLUSTER_THREADS, local_size_y = 1, local_size_z = 1) in;
+
+struct PointLight {
+    vec4 position;        // xyz = position, w = radius (0 = culled by the light budget)
+    vec4 colorIntensity;
+    vec4 attenuation;
+};
+
+struct SpotLight {
+    vec4 position;        // xyz = position, w = range (0 = culled by the light budget)
+    vec4 direction;
+    vec4 colorIntensity;
+    vec4 cutoffAtten;
+};
+
+layout(std430, binding = 5) readonly buffer PointLightBuffer {
+    PointLight u_PointLights[];
+};
+
+layout(std430, binding = 6) readonly buffer SpotLightBuffer {
+    SpotLight u_SpotLights[];
+};
+
+// x = first index in u_LightIndices, y = point count, z = spot count
+layout(std430, binding = 7) writeonly buffer ClusterBuffer {
+    uvec4 u_Clusters[];
+};
+
+// Point indices of a cluster followed by its spot indices
+layout(std430, binding = 8) writeonly buffer LightIndexBuffer {
+    uint u_LightIndices[];
+};
+
+layout(std430, binding = 9) buffer LightIndexCounter {
+    uint u_LightIndexCount;
+};
+
+#include "common/camera.glsl"
+
+uniform uvec3 u_GridSize;
+uniform vec2 u_ScreenSize;
+uniform float u_ZNear;
+uniform float u_ZFar;
+uniform uint u_PointLightCount;
+uniform uint u_SpotLightCount;
+uniform uint u_MaxLightIndices;
+
+shared vec4 s_Spheres[CLUSTER_THREADS];  // View-space center + radius
+
+vec3 ScreenToView(vec2 screen) {
+    vec2 ndc = screen / u_ScreenSize * 2.0 - 1.0;
+    vec4 view = u_InverseProjection * vec4(ndc, -1.0, 1.0);
+    return view.xyz / view.w;
+}
+
+// Point where the ray from the eye through p crosses the plane z = viewZ
+vec3 IntersectZPlane(vec3 p, float viewZ) {
+    return p * (viewZ / p.z);
+}
+
+float SquaredDistanceToAABB(vec3 p, vec3 aabbMin, vec3 aabbMax) {
+    vec3 closest = clamp(p, aabbMin, aabbMax);
+    vec3 delta = closest - p;
+    return dot(delta, delta);
+}
+
+void main() {
+    uint clusterCount = u_GridSize.x * u_GridSize.y * u_GridSize.z;
+    uint clusterIndex = gl_GlobalInvocationID.x;
+    bool active = clusterIndex < clusterCount;
+
+    // Cluster bounds in view space
+    uint x = clusterIndex % u_GridSize.x;
+    uint y = (clusterIndex / u_GridSize.x) % u_GridSize.y;
+    uint z = clusterIndex / (u_GridSize.x * u_GridSize.y);
+
+    vec2 tileSize = u_ScreenSize / vec2(u_GridSize.xy);
+    vec3 minPoint = ScreenToView(vec2(x, y) * tileSize);
+    vec3 maxPoint = ScreenToView(vec2(x + 1, y + 1) * tileSize);
+
+    // Exponential depth slices
+    float sliceNear = -u_ZNear * pow(u_ZFar / u_ZNear, float(z) / float(u_GridSize.z));
+    float sliceFar = -u_ZNear * pow(u_ZFar / u_ZNear, float(z + 1) / float(u_GridSize.z));
+
+    vec3 a = IntersectZPlane(minPoint, sliceNear);
+    vec3 b = IntersectZPlane(minPoint, sliceFar);
+    vec3 c = IntersectZPlane(maxPoint, sliceNear);
+    vec3 d = IntersectZPlane(maxPoint, sliceFar);
+    vec3 aabbMin = min(min(a, b), min(c, d));
+    vec3 aabbMax = max(max(a, b), max(c, d));
+
+    uint visible[MAX_LIGHTS_PER_CLUSTER];
+    uint count = 0;
+
+    // Point lights
+    for (uint base = 0; base < u_PointLightCount; base += CLUSTER_THREADS) {
+        uint light = base + gl_LocalInvocationIndex;
+        if (light < u_PointLightCount) {
+            vec4 position = u_PointLights[light].position;
+            s_Spheres[gl_LocalInvocationIndex] = vec4((u_View * vec4(position.xyz, 1.0)).xyz, position.w);
+        }
+        barrier();
+
+        uint batch = min(uint(CLUSTER_THREADS), u_PointLightCount - base);
+        if (active) {
+            for (uint i = 0; i < batch && count < MAX_LIGHTS_PER_CLUSTER; ++i) {
+                vec4 sphere = s_Spheres[i];
+                if (sphere.w > 0.0 && SquaredDistanceToAABB(sphere.xyz, aabbMin, aabbMax) <= sphere.w * sphere.w) {
+                    visible[count++] = base + i;
+                }
+            }
+        }
+        barrier();
+    }
+
+    uint pointCount = count;
+
+    // Spot lights (bounded by a sphere of their range)
+    for (uint base = 0; base < u_SpotLightCount; base += CLUSTER_THREADS) {
+        uint light = base + gl_LocalInvocationIndex;
+        if (light < u_SpotLightCount) {
+            vec4 position = u_SpotLights[light].position;
+            s_Spheres[gl_LocalInvocationIndex] = vec4((u_View * vec4(position.xyz, 1.0)).xyz, position.w);
+        }
+        barrier();
+
+        uint batch = min(uint(CLUSTER_THREADS), u_SpotLightCount - base);
+        if (active) {
+            for (uint i = 0; i < batch && count < MAX_LIGHTS_PER_CLUSTER; ++i) {
+                vec4 sphere = s_Spheres[i];
+                if (sphere.w > 0.0 && SquaredDistanceToAABB(sphere.xyz, aabbMin, aabbMax) <= sphere.w * sphere.w) {
+                    visible[count++] = base + i;
+                }
+            }
+        }
+        barrier();
+    }
+
+    if (!active) return;
+
+    // Reserve space in the global list; drop what doesn't fit
+    uint offset = atomicAdd(u_LightIndexCount, count);
+    uint stored = offset < u_MaxLightIndices ? min(count, u_MaxLightIndices - offset) : 0;
+
+    for (uint i = 0; i < stored; ++i) {
+        u_LightIndices[offset + i] = visible[i];
+    }
+
+    uint storedPoints = min(pointCount, stored);
+    u_Clusters[clusterIndex] = uvec4(offset, storedPoints, stored - storedPoints, 0);
+}
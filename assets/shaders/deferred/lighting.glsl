@@ -18,364 +18,83 @@ out vec4 FragColor;
 
 in vec2 v_TexCoords;
 
-// G-Buffer textures
+// G-Buffer textures (u_GPosition holds hardware depth in the compact layout)
 uniform sampler2D u_GPosition;
 uniform sampler2D u_GNormal;
 uniform sampler2D u_GAlbedo;
 uniform sampler2D u_GEmission;
-
-// Shadow maps
-uniform sampler2DArray u_CSMShadowMap;
-uniform sampler2D u_SpotShadowAtlas;
+uniform bool u_CompactGBuffer;
+// Rendered fraction of the G-Buffer (dynamic resolution)
+uniform vec2 u_UVScale;
 
 // Camera
-uniform vec3 u_CameraPos;
+#include "common/camera.glsl"
 
-// Ambient
+// Ambient, and the screen-space occlusion over it (Engine::AmbientOcclusion)
 uniform vec4 u_AmbientLight;
+uniform sampler2D u_AmbientOcclusion;
+uniform bool u_HasAmbientOcclusion;
 
-// Light counts
+// Light counts (point / spot counts come per cluster)
 uniform int u_DirectionalLightCount;
-uniform int u_PointLightCount;
-uniform int u_SpotLightCount;
 
-// Shadow settings
-uniform bool u_ShadowsEnabled;
+// Lights, shadows and the cluster lists
+#include "common/lighting.glsl"
+#include "common/light_clusters.glsl"
+#include "common/volumetric_fog.glsl"
 
 // ============================================================================
-// Light UBO definitions
+// G-Buffer decoding (see GBuffer.hpp for both layouts)
 // ============================================================================
 
-struct DirectionalLight {
-    vec4 direction;
-    vec4 colorIntensity;
-};
-
-struct PointLight {
-    vec4 position;
-    vec4 colorIntensity;
-    vec4 attenuation;
-};
-
-struct SpotLight {
-    vec4 position;
-    vec4 direction;
-    vec4 colorIntensity;
-    vec4 cutoffAtten;
-};
-
-layout(std140, binding = 0) uniform DirectionalLightBlock {
-    DirectionalLight u_DirectionalLights[4];
+struct GBufferSample {
+    vec3 worldPos;
+    float viewDepth;
+    vec3 normal;
+    vec3 albedo;
+    float metallic;
+    float roughness;
+    vec3 emission;
+    float ao;
 };
 
-layout(std140, binding = 1) uniform PointLightBlock {
-    PointLight u_PointLights[256];
-};
-
-layout(std140, binding = 2) uniform SpotLightBlock {
-    SpotLight u_SpotLights[64];
-};
-
-// ============================================================================
-// Shadow UBO definitions
-// ============================================================================
-
-struct CascadeData {
-    mat4 viewProjection;
-    vec4 splitDepthBias;  // x=splitDepth, y=texelSize, z=bias, w=normalBias
-};
-
-struct SpotShadowData {
-    mat4 viewProjection;
-    vec4 atlasScaleOffset;  // xy=scale, zw=offset
-    vec4 params;            // x=bias, y=normalBias, z=softness, w=enabled
-};
-
-layout(std140, binding = 3) uniform ShadowDataBlock {
-    // CSM data
-    CascadeData u_Cascades[4];
-    vec4 u_CascadeSplitDepths;
-    vec4 u_ShadowParams;  // x=softness, y=maxDist, z=fadeStart, w=enabled
-
-    // Spot shadow data
-    SpotShadowData u_SpotShadows[16];
-    ivec4 u_ShadowCounts;  // x=spotCount
-};
-
-// ============================================================================
-// PBR Functions (Cook-Torrance BRDF)
-// ============================================================================
-
-const float PI = 3.14159265359;
-
-float DistributionGGX(vec3 N, vec3 H, float roughness) {
-    float a = roughness * roughness;
-    float a2 = a * a;
-    float NdotH = max(dot(N, H), 0.0);
-    float NdotH2 = NdotH * NdotH;
-
-    float nom = a2;
-    float denom = (NdotH2 * (a2 - 1.0) + 1.0);
-    denom = PI * denom * denom;
-
-    return nom / max(denom, 0.0001);
-}
-
-float GeometrySchlickGGX(float NdotV, float roughness) {
-    float r = (roughness + 1.0);
-    float k = (r * r) / 8.0;
-
-    float nom = NdotV;
-    float denom = NdotV * (1.0 - k) + k;
-
-    return nom / max(denom, 0.0001);
-}
-
-float GeometrySmith(vec3 N, vec3 V, vec3 L, float roughness) {
-    float NdotV = max(dot(N, V), 0.0);
-    float NdotL = max(dot(N, L), 0.0);
-    float ggx2 = GeometrySchlickGGX(NdotV, roughness);
-    float ggx1 = GeometrySchlickGGX(NdotL, roughness);
-
-    return ggx1 * ggx2;
-}
-
-vec3 FresnelSchlick(float cosTheta, vec3 F0) {
-    return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
-}
-
-// ============================================================================
-// Shadow Functions
-// ============================================================================
-
-const int PCF_SAMPLES = 16;
-const vec2 POISSON_DISK[16] = vec2[](
-    vec2(-0.94201624, -0.39906216),
-    vec2(0.94558609, -0.76890725),
-    vec2(-0.094184101, -0.92938870),
-    vec2(0.34495938, 0.29387760),
-    vec2(-0.91588581, 0.45771432),
-    vec2(-0.81544232, -0.87912464),
-    vec2(-0.38277543, 0.27676845),
-    vec2(0.97484398, 0.75648379),
-    vec2(0.44323325, -0.97511554),
-    vec2(0.53742981, -0.47373420),
-    vec2(-0.26496911, -0.41893023),
-    vec2(0.79197514, 0.19090188),
-    vec2(-0.24188840, 0.99706507),
-    vec2(-0.81409955, 0.91437590),
-    vec2(0.19984126, 0.78641367),
-    vec2(0.14383161, -0.14100790)
-);
-
-int GetCascadeIndex(float viewDepth) {
-    int cascadeIndex = 0;
-    for (int i = 0; i < 4; i++) {
-        if (viewDepth > u_CascadeSplitDepths[i]) {
-            cascadeIndex = i + 1;
-        }
-    }
-    return min(cascadeIndex, 3);
-}
-
-float SampleShadowPCF(vec3 shadowCoord, int cascadeIndex, float softness, float texelSize, float bias) {
-    float shadow = 0.0;
-    float currentDepth = shadowCoord.z;
-
-    for (int i = 0; i < PCF_SAMPLES; i++) {
-        vec2 offset = POISSON_DISK[i] * softness * texelSize;
-        float closestDepth = texture(u_CSMShadowMap, vec3(shadowCoord.xy + offset, float(cascadeIndex))).r;
-        shadow += (currentDepth - bias) > closestDepth ? 0.0 : 1.0;
-    }
-
-    return shadow / float(PCF_SAMPLES);
-}
-
-float CalculateCSMShadow(vec3 worldPos, vec3 normal, float viewDepth) {
-    // Check if shadows are disabled or beyond max distance
-    if (u_ShadowParams.w < 0.5 || viewDepth > u_ShadowParams.y) {
-        return 1.0;
-    }
-
-    // Select cascade
-    int cascadeIndex = GetCascadeIndex(viewDepth);
-
-    // Get cascade parameters
-    float bias = u_Cascades[cascadeIndex].splitDepthBias.z;
-    float normalBias = u_Cascades[cascadeIndex].splitDepthBias.w;
-    float texelSize = u_Cascades[cascadeIndex].splitDepthBias.y;
-    float softness = u_ShadowParams.x;
-
-    // Apply normal offset bias
-    vec3 samplingPos = worldPos + normal * normalBias;
-
-    // Transform to light space
-    vec4 shadowPos = u_Cascades[cascadeIndex].viewProjection * vec4(samplingPos, 1.0);
-    vec3 projCoords = shadowPos.xyz / shadowPos.w;
-    projCoords = projCoords * 0.5 + 0.5;
-
-    // Check bounds
-    if (projCoords.z > 1.0 ||
-        projCoords.x < 0.0 || projCoords.x > 1.0 ||
-        projCoords.y < 0.0 || projCoords.y > 1.0) {
-        return 1.0;
-    }
-
-    // Sample shadow with PCF
-    float shadow = SampleShadowPCF(projCoords, cascadeIndex, softness, texelSize, bias);
-
-    // Fade out at max distance
-    float fadeStart = u_ShadowParams.z;
-    float maxDist = u_ShadowParams.y;
-    if (viewDepth > fadeStart) {
-        float fadeRatio = (viewDepth - fadeStart) / (maxDist - fadeStart);
-        shadow = mix(shadow, 1.0, fadeRatio);
-    }
-
-    return shadow;
+vec3 DecodeOctahedral(vec2 e) {
+    e = e * 2.0 - 1.0;
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
 }
 
-float CalculateSpotShadow(int spotIndex, vec3 worldPos, vec3 normal) {
-    if (spotIndex < 0 || spotIndex >= u_ShadowCounts.x) {
-        return 1.0;
+// t0..t3 are the four G-Buffer slots in BindTextures order; uv in [0, 1]
+GBufferSample DecodeGBuffer(vec4 t0, vec4 t1, vec4 t2, vec4 t3, vec2 uv) {
+    GBufferSample s;
+
+    if (u_CompactGBuffer) {
+        // t0 = hardware depth, t1 = octahedral normal, t2 = albedo + metal/rough, t3 = emission + AO
+        vec4 clip = vec4(uv * 2.0 - 1.0, t0.r * 2.0 - 1.0, 1.0);
+        vec4 world = u_InverseViewProjection * clip;
+        s.worldPos = world.xyz / world.w;
+        s.viewDepth = -(u_View * vec4(s.worldPos, 1.0)).z;
+        s.normal = DecodeOctahedral(t1.rg);
+
+        uint packedMR = uint(t2.a * 255.0 + 0.5);
+        s.albedo = t2.rgb;
+        s.metallic = float(packedMR >> 5u) / 7.0;
+        s.roughness = float(packedMR & 31u) / 31.0;
+    } else {
+        s.worldPos = t0.rgb;
+        s.viewDepth = t0.a;
+        s.normal = normalize(t1.rgb * 2.0 - 1.0);
+        s.albedo = t2.rgb;
+        s.metallic = t1.a;
+        s.roughness = t2.a;
     }
 
-    SpotShadowData shadow = u_SpotShadows[spotIndex];
-
-    if (shadow.params.w < 0.5) {
-        return 1.0;  // Shadow disabled for this light
-    }
-
-    float bias = shadow.params.x;
-    float normalBias = shadow.params.y;
-    float softness = shadow.params.z;
-
-    // Apply normal offset bias
-    vec3 samplingPos = worldPos + normal * normalBias;
-
-    // Transform to light space
-    vec4 shadowPos = shadow.viewProjection * vec4(samplingPos, 1.0);
-    vec3 projCoords = shadowPos.xyz / shadowPos.w;
-    projCoords = projCoords * 0.5 + 0.5;
-
-    // Check bounds
-    if (projCoords.z > 1.0 ||
-        projCoords.x < 0.0 || projCoords.x > 1.0 ||
-        projCoords.y < 0.0 || projCoords.y > 1.0) {
-        return 1.0;
-    }
-
-    // Transform UV to atlas tile coordinates
-    vec2 atlasUV = projCoords.xy * shadow.atlasScaleOffset.xy + shadow.atlasScaleOffset.zw;
-
-    // PCF sampling in atlas
-    float result = 0.0;
-    float texelSize = shadow.atlasScaleOffset.x / 512.0;  // Approximate texel size
-
-    for (int i = 0; i < PCF_SAMPLES; i++) {
-        vec2 offset = POISSON_DISK[i] * softness * texelSize;
-        float closestDepth = texture(u_SpotShadowAtlas, atlasUV + offset).r;
-        result += (projCoords.z - bias) > closestDepth ? 0.0 : 1.0;
-    }
-
-    return result / float(PCF_SAMPLES);
-}
-
-// ============================================================================
-// Lighting Calculations
-// ============================================================================
-
-vec3 CalculatePBR(vec3 L, vec3 V, vec3 N, vec3 lightColor, vec3 albedo,
-                  float metallic, float roughness, vec3 F0) {
-    vec3 H = normalize(V + L);
-
-    float NDF = DistributionGGX(N, H, roughness);
-    float G = GeometrySmith(N, V, L, roughness);
-    vec3 F = FresnelSchlick(max(dot(H, V), 0.0), F0);
-
-    vec3 numerator = NDF * G * F;
-    float denominator = 4.0 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.0001;
-    vec3 specular = numerator / denominator;
-
-    vec3 kS = F;
-    vec3 kD = (1.0 - kS) * (1.0 - metallic);
-
-    float NdotL = max(dot(N, L), 0.0);
-
-    return (kD * albedo / PI + specular) * lightColor * NdotL;
-}
-
-vec3 CalculateDirectionalLight(DirectionalLight light, vec3 worldPos, vec3 V, vec3 N,
-                                vec3 albedo, float metallic, float roughness, vec3 F0,
-                                float viewDepth, bool castsShadow) {
-    vec3 L = normalize(-light.direction.xyz);
-    vec3 lightColor = light.colorIntensity.rgb * light.colorIntensity.a;
-
-    vec3 lighting = CalculatePBR(L, V, N, lightColor, albedo, metallic, roughness, F0);
-
-    // Apply shadow
-    if (castsShadow && u_ShadowsEnabled) {
-        float shadow = CalculateCSMShadow(worldPos, N, viewDepth);
-        lighting *= shadow;
-    }
-
-    return lighting;
-}
-
-vec3 CalculatePointLight(PointLight light, vec3 worldPos, vec3 V, vec3 N,
-                          vec3 albedo, float metallic, float roughness, vec3 F0) {
-    vec3 L = light.position.xyz - worldPos;
-    float distance = length(L);
-
-    float radius = light.position.w;
-    if (distance > radius) return vec3(0.0);
-
-    L = normalize(L);
-
-    float attenuation = 1.0 / (light.attenuation.x +
-                               light.attenuation.y * distance +
-                               light.attenuation.z * distance * distance);
-
-    float smoothFalloff = clamp(1.0 - distance / radius, 0.0, 1.0);
-    smoothFalloff *= smoothFalloff;
-    attenuation *= smoothFalloff;
-
-    vec3 lightColor = light.colorIntensity.rgb * light.colorIntensity.a * attenuation;
-
-    return CalculatePBR(L, V, N, lightColor, albedo, metallic, roughness, F0);
-}
-
-vec3 CalculateSpotLight(SpotLight light, vec3 worldPos, vec3 V, vec3 N,
-                         vec3 albedo, float metallic, float roughness, vec3 F0,
-                         int shadowIndex) {
-    vec3 L = light.position.xyz - worldPos;
-    float distance = length(L);
-
-    float range = light.position.w;
-    if (distance > range) return vec3(0.0);
-
-    L = normalize(L);
-
-    float theta = dot(L, normalize(-light.direction.xyz));
-    float epsilon = light.cutoffAtten.x - light.cutoffAtten.y;
-    float intensity = clamp((theta - light.cutoffAtten.y) / epsilon, 0.0, 1.0);
-
-    if (intensity <= 0.0) return vec3(0.0);
-
-    float attenuation = 1.0 / (1.0 + light.cutoffAtten.z * distance +
-                               light.cutoffAtten.w * distance * distance);
-
-    vec3 lightColor = light.colorIntensity.rgb * light.colorIntensity.a * attenuation * intensity;
-
-    vec3 lighting = CalculatePBR(L, V, N, lightColor, albedo, metallic, roughness, F0);
-
-    // Apply spot shadow if available
-    if (u_ShadowsEnabled && shadowIndex >= 0) {
-        float shadow = CalculateSpotShadow(shadowIndex, worldPos, N);
-        lighting *= shadow;
-    }
-
-    return lighting;
+    s.emission = t3.rgb;
+    s.ao = t3.a;
+    return s;
 }
 
 // ============================================================================
@@ -383,20 +102,26 @@ vec3 CalculateSpotLight(SpotLight light, vec3 worldPos, vec3 V, vec3 N,
 // ============================================================================
 
 void main() {
-    vec4 gPosDepth = texture(u_GPosition, v_TexCoords);
-    vec4 gNormalMetallic = texture(u_GNormal, v_TexCoords);
-    vec4 gAlbedoRoughness = texture(u_GAlbedo, v_TexCoords);
-    vec4 gEmissionAO = texture(u_GEmission, v_TexCoords);
-
-    vec3 worldPos = gPosDepth.rgb;
-    vec3 normal = normalize(gNormalMetallic.rgb * 2.0 - 1.0);
-    vec3 albedo = gAlbedoRoughness.rgb;
-    float metallic = gNormalMetallic.a;
-    float roughness = gAlbedoRoughness.a;
-    vec3 emission = gEmissionAO.rgb;
-    float ao = gEmissionAO.a;
+    // The quad covers the render viewport; v_TexCoords stays the screen UV
+    vec2 gbufferUV = v_TexCoords * u_UVScale;
+    GBufferSample g = DecodeGBuffer(texture(u_GPosition, gbufferUV),
+                                    texture(u_GNormal, gbufferUV),
+                                    texture(u_GAlbedo, gbufferUV),
+                                    texture(u_GEmission, gbufferUV),
+                                    v_TexCoords);
+
+    vec3 worldPos = g.worldPos;
+    vec3 normal = g.normal;
+    vec3 albedo = g.albedo;
+    float metallic = g.metallic;
+    float roughness = g.roughness;
+    vec3 emission = g.emission;
+    float ao = g.ao;
+    if (u_HasAmbientOcclusion) {
+        ao *= texture(u_AmbientOcclusion, gbufferUV).r;
+    }
 
-    vec3 V = normalize(u_CameraPos - worldPos);
+    vec3 V = normalize(u_CameraPosition - worldPos);
 
     vec3 F0 = vec3(0.04);
     F0 = mix(F0, albedo, metallic);
@@ -404,7 +129,7 @@ void main() {
     vec3 Lo = vec3(0.0);
 
     // Use linear depth from G-Buffer for cascade selection
-    float viewDepth = gPosDepth.a;
+    float viewDepth = g.viewDepth;
 
     for (int i = 0; i < u_DirectionalLightCount; ++i) {
         // First directional light casts shadows (typically the sun)
@@ -414,21 +139,13 @@ void main() {
                                          viewDepth, castsShadow);
     }
 
-    for (int i = 0; i < u_PointLightCount; ++i) {
-        Lo += CalculatePointLight(u_PointLights[i], worldPos, V, normal,
-                                   albedo, metallic, roughness, F0);
-    }
-
-    for (int i = 0; i < u_SpotLightCount; ++i) {
-        // Map spotlight index to shadow index (assumes shadow-casting lights come first)
-        int shadowIndex = (i < u_ShadowCounts.x) ? i : -1;
-        Lo += CalculateSpotLight(u_SpotLights[i], worldPos, V, normal,
-                                  albedo, metallic, roughness, F0, shadowIndex);
-    }
+    // Only the lights binned into this pixel's cluster
+    Lo += CalculateClusteredLights(worldPos, V, normal, albedo, metallic, roughness, F0);
 
     vec3 ambient = u_AmbientLight.rgb * u_AmbientLight.a * albedo * ao;
 
     vec3 color = ambient + Lo + emission;
+    color = ApplyVolumetricFog(color, v_TexCoords, viewDepth);
 
     FragColor = vec4(color, 1.0);
 }
@@ -0,0 +1,264 @@
+#type compute
+#version 450 core
+
+// Tiled deferred shading: one work group per 16x16 screen tile. The group
+// reduces the tile's min / max view depth, culls point and spot lights
+// against the tile frustum in shared memory, then every invocation shades
+// its own pixel against that local list and writes it to the lighting
+// buffer with imageStore.
+//
+// Alternative to lighting.glsl (selected with LightingMode::TiledCompute);
+// the BRDF and shadow code is shared with it through common/lighting.glsl.
+#define TILE_SIZE 16
+#define TILE_THREADS (TILE_SIZE * TILE_SIZE)
+#define MAX_POINT_LIGHTS_PER_TILE 256
+#define MAX_SPOT_LIGHTS_PER_TILE 128
+
+layout(local_size_x = TILE_SIZE, local_size_y = TILE_SIZE, local_size_z = 1) in;
+
+layout(rgba16f, binding = 0) uniform writeonly image2D u_Output;
+
+// G-Buffer textures (u_GPosition holds hardware depth in the compact layout)
+uniform sampler2D u_GPosition;
+uniform sampler2D u_GNormal;
+uniform sampler2D u_GAlbedo;
+uniform sampler2D u_GEmission;
+uniform bool u_CompactGBuffer;
+
+// Camera
+#include "common/camera.glsl"
+uniform vec2 u_ScreenSize;        // Render viewport, the lower-left part of the targets
+
+// Ambient, and the screen-space occlusion over it (Engine::AmbientOcclusion)
+uniform vec4 u_AmbientLight;
+uniform sampler2D u_AmbientOcclusion;
+uniform bool u_HasAmbientOcclusion;
+
+// Light counts
+uniform int u_DirectionalLightCount;
+uniform uint u_PointLightCount;
+uniform uint u_SpotLightCount;
+
+// Lights and shadows
+#include "common/lighting.glsl"
+#include "common/volumetric_fog.glsl"
+
+// ============================================================================
+// G-Buffer decoding (see GBuffer.hpp for both layouts)
+// ============================================================================
+
+struct GBufferSample {
+    vec3 worldPos;
+    float viewDepth;
+    vec3 normal;
+    vec3 albedo;
+    float metallic;
+    float roughness;
+    vec3 emission;
+    float ao;
+};
+
+vec3 DecodeOctahedral(vec2 e) {
+    e = e * 2.0 - 1.0;
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+// t0..t3 are the four G-Buffer slots in BindTextures order; uv in [0, 1]
+GBufferSample DecodeGBuffer(vec4 t0, vec4 t1, vec4 t2, vec4 t3, vec2 uv) {
+    GBufferSample s;
+
+    if (u_CompactGBuffer) {
+        // t0 = hardware depth, t1 = octahedral normal, t2 = albedo + metal/rough, t3 = emission + AO
+        vec4 clip = vec4(uv * 2.0 - 1.0, t0.r * 2.0 - 1.0, 1.0);
+        vec4 world = u_InverseViewProjection * clip;
+        s.worldPos = world.xyz / world.w;
+        s.viewDepth = -(u_View * vec4(s.worldPos, 1.0)).z;
+        s.normal = DecodeOctahedral(t1.rg);
+
+        uint packedMR = uint(t2.a * 255.0 + 0.5);
+        s.albedo = t2.rgb;
+        s.metallic = float(packedMR >> 5u) / 7.0;
+        s.roughness = float(packedMR & 31u) / 31.0;
+    } else {
+        s.worldPos = t0.rgb;
+        s.viewDepth = t0.a;
+        s.normal = normalize(t1.rgb * 2.0 - 1.0);
+        s.albedo = t2.rgb;
+        s.metallic = t1.a;
+        s.roughness = t2.a;
+    }
+
+    s.emission = t3.rgb;
+    s.ao = t3.a;
+    return s;
+}
+
+// ============================================================================
+// Tile light lists
+// ============================================================================
+
+shared uint s_MinDepth;   // floatBitsToUint of positive depths keeps ordering
+shared uint s_MaxDepth;
+shared vec4 s_TilePlanes[4];
+shared uint s_PointCount;
+shared uint s_SpotCount;
+shared uint s_PointIndices[MAX_POINT_LIGHTS_PER_TILE];
+shared uint s_SpotIndices[MAX_SPOT_LIGHTS_PER_TILE];
+
+vec3 ScreenToView(vec2 screen) {
+    vec2 ndc = screen / u_ScreenSize * 2.0 - 1.0;
+    vec4 view = u_InverseProjection * vec4(ndc, -1.0, 1.0);
+    return view.xyz / view.w;
+}
+
+// View-space sphere against the tile's side planes and depth range
+bool SphereInTile(vec3 center, float radius, float minDepth, float maxDepth) {
+    // Zero radius: culled by the light budget
+    if (radius <= 0.0) {
+        return false;
+    }
+    float depth = -center.z;
+    if (depth + radius < minDepth || depth - radius > maxDepth) {
+        return false;
+    }
+    for (int i = 0; i < 4; ++i) {
+        if (dot(s_TilePlanes[i].xyz, center) < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+void main() {
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 screenSize = ivec2(u_ScreenSize);
+    bool inside = pixel.x < screenSize.x && pixel.y < screenSize.y;
+
+    if (gl_LocalInvocationIndex == 0u) {
+        s_MinDepth = 0x7F7FFFFFu;  // FLT_MAX
+        s_MaxDepth = 0u;
+        s_PointCount = 0u;
+        s_SpotCount = 0u;
+
+        // Side planes through the eye, normals pointing into the tile
+        vec2 tileMin = vec2(gl_WorkGroupID.xy * uint(TILE_SIZE));
+        vec2 tileMax = min(tileMin + float(TILE_SIZE), u_ScreenSize);
+        vec3 p0 = ScreenToView(vec2(tileMin.x, tileMin.y));
+        vec3 p1 = ScreenToView(vec2(tileMax.x, tileMin.y));
+        vec3 p2 = ScreenToView(vec2(tileMax.x, tileMax.y));
+        vec3 p3 = ScreenToView(vec2(tileMin.x, tileMax.y));
+        s_TilePlanes[0] = vec4(normalize(cross(p0, p3)), 0.0);
+        s_TilePlanes[1] = vec4(normalize(cross(p3, p2)), 0.0);
+        s_TilePlanes[2] = vec4(normalize(cross(p2, p1)), 0.0);
+        s_TilePlanes[3] = vec4(normalize(cross(p1, p0)), 0.0);
+    }
+    barrier();
+
+    // G-Buffer is read once per pixel for every light in the tile
+    GBufferSample g;
+    if (inside) {
+        vec2 uv = (vec2(pixel) + 0.5) / u_ScreenSize;
+        g = DecodeGBuffer(texelFetch(u_GPosition, pixel, 0),
+                          texelFetch(u_GNormal, pixel, 0),
+                          texelFetch(u_GAlbedo, pixel, 0),
+                          texelFetch(u_GEmission, pixel, 0),
+                          uv);
+
+        float depth = max(-(u_View * vec4(g.worldPos, 1.0)).z, 0.0);
+        atomicMin(s_MinDepth, floatBitsToUint(depth));
+        atomicMax(s_MaxDepth, floatBitsToUint(depth));
+    }
+    barrier();
+
+    float minDepth = uintBitsToFloat(s_MinDepth);
+    float maxDepth = uintBitsToFloat(s_MaxDepth);
+
+    // Each invocation tests every TILE_THREADS-th light
+    for (uint i = gl_LocalInvocationIndex; i < u_PointLightCount; i += uint(TILE_THREADS)) {
+        vec4 position = u_PointLights[i].position;
+        vec3 center = (u_View * vec4(position.xyz, 1.0)).xyz;
+        if (SphereInTile(center, position.w, minDepth, maxDepth)) {
+            uint slot = atomicAdd(s_PointCount, 1u);
+            if (slot < uint(MAX_POINT_LIGHTS_PER_TILE)) {
+                s_PointIndices[slot] = i;
+            }
+        }
+    }
+
+    // Spot lights are bounded by a sphere of their range
+    for (uint i = gl_LocalInvocationIndex; i < u_SpotLightCount; i += uint(TILE_THREADS)) {
+        vec4 position = u_SpotLights[i].position;
+        vec3 center = (u_View * vec4(position.xyz, 1.0)).xyz;
+        if (SphereInTile(center, position.w, minDepth, maxDepth)) {
+            uint slot = atomicAdd(s_SpotCount, 1u);
+            if (slot < uint(MAX_SPOT_LIGHTS_PER_TILE)) {
+                s_SpotIndices[slot] = i;
+            }
+        }
+    }
+    barrier();
+
+    if (!inside) return;
+
+    vec3 worldPos = g.worldPos;
+    vec3 normal = g.normal;
+    vec3 albedo = g.albedo;
+    float metallic = g.metallic;
+    float roughness = g.roughness;
+    vec3 emission = g.emission;
+    float ao = g.ao;
+    if (u_HasAmbientOcclusion) {
+        ao *= texelFetch(u_AmbientOcclusion, pixel, 0).r;
+    }
+
+    vec3 V = normalize(u_CameraPosition - worldPos);
+
+    vec3 F0 = vec3(0.04);
+    F0 = mix(F0, albedo, metallic);
+
+    vec3 Lo = vec3(0.0);
+
+    // Use linear depth from G-Buffer for cascade selection
+    float viewDepth = g.viewDepth;
+
+    for (int i = 0; i < u_DirectionalLightCount; ++i) {
+        // First directional light casts shadows (typically the sun)
+        bool castsShadow = (i == 0);
+        Lo += CalculateDirectionalLight(u_DirectionalLights[i], worldPos, V, normal,
+                                         albedo, metallic, roughness, F0,
+                                         viewDepth, castsShadow);
+    }
+
+    uint pointCount = min(s_PointCount, uint(MAX_POINT_LIGHTS_PER_TILE));
+    for (uint i = 0u; i < pointCount; ++i) {
+        uint lightIndex = s_PointIndices[i];
+        // attenuation.w holds the light's shadow slot, -1 when unshadowed
+        int shadowIndex = int(u_PointLights[lightIndex].attenuation.w);
+        Lo += CalculatePointLight(u_PointLights[lightIndex], worldPos, V, normal,
+                                   albedo, metallic, roughness, F0, shadowIndex);
+    }
+
+    uint spotCount = min(s_SpotCount, uint(MAX_SPOT_LIGHTS_PER_TILE));
+    for (uint i = 0u; i < spotCount; ++i) {
+        uint lightIndex = s_SpotIndices[i];
+        // direction.w holds the light's shadow slot, -1 when unshadowed
+        int shadowIndex = int(u_SpotLights[lightIndex].direction.w);
+        Lo += CalculateSpotLight(u_SpotLights[lightIndex], worldPos, V, normal,
+                                  albedo, metallic, roughness, F0, shadowIndex);
+    }
+
+    vec3 ambient = u_AmbientLight.rgb * u_AmbientLight.a * albedo * ao;
+
+    vec3 color = ambient + Lo + emission;
+    color = ApplyVolumetricFog(color, (vec2(pixel) + 0.5) / u_ScreenSize, viewDepth);
+
+    imageStore(u_Output, pixel, vec4(color, 1.0));
+}
@@ -0,0 +1,192 @@
+#type compute
+#version 450 core
+
+// Meshlet culling and index compaction, see Engine::MeshletCuller.
+//
+// One workgroup per task (instance, meshlet). The first thread tests the
+// meshlet and writes its indirect command; if it survives, the group copies
+// its indices from the mesh's index buffer into the compacted one.
+
+layout(local_size_x = 64) in;
+
+#include "common/camera.glsl"
+
+// Must match Engine::Meshlet
+struct Meshlet {
+    vec3 Center;
+    float Radius;
+    vec3 ConeAxis;
+    float ConeCutoff;       // > 1 never culls
+    vec3 ConeApex;
+    uint TriangleCount;
+    uint IndexOffset;       // From the mesh's LOD 0 base index
+    uint VertexCount;
+    uint Padding0;
+    uint Padding1;
+};
+
+// Must match MeshletCuller::Task
+struct Task {
+    uint Instance;
+    uint Meshlet;
+    uint BaseIndex;
+    uint BaseVertex;
+};
+
+// Must match Engine::InstanceData
+struct InstanceData {
+    mat4 Transform;
+    vec4 Color;
+    vec4 MaterialParams;
+    uint EntityId;
+    uint Flags;
+    uint MaterialIndex;
+    uint Padding;
+};
+
+struct DrawCommand {
+    uint Count;
+    uint InstanceCount;
+    uint FirstIndex;
+    int BaseVertex;
+    uint BaseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer MeshletBuffer {
+    Meshlet u_Meshlets[];
+};
+
+layout(std430, binding = 1) readonly buffer TaskBuffer {
+    Task u_Tasks[];
+};
+
+layout(std430, binding = 2) readonly buffer SourceIndexBuffer {
+    uint u_SourceIndices[];
+};
+
+layout(std430, binding = 3) writeonly buffer OutputIndexBuffer {
+    uint u_OutputIndices[];
+};
+
+layout(std430, binding = 4) readonly buffer InstanceBuffer {
+    InstanceData u_Instances[];
+};
+
+// One per task, indexed like u_Tasks
+layout(std430, binding = 12) writeonly buffer CommandBuffer {
+    DrawCommand u_Commands[];
+};
+
+layout(std430, binding = 13) buffer CounterBuffer {
+    uint u_OutputIndexCount;
+};
+
+uniform uint u_FirstTask;
+uniform uint u_TaskCount;
+
+// Previous frame's pyramid, see HiZPyramid
+layout(binding = 0) uniform sampler2D u_HiZ;
+uniform int u_HiZEnabled;
+uniform mat4 u_HiZViewProjection;
+uniform vec2 u_HiZUVScale;
+uniform int u_HiZLevelCount;
+
+shared bool s_Visible;
+shared uint s_OutputOffset;
+
+bool IsOutsideFrustum(vec3 center, float radius) {
+    for (int i = 0; i < 6; ++i) {
+        if (dot(u_FrustumPlanes[i].xyz, center) + u_FrustumPlanes[i].w < -radius) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Every triangle faces away from the camera
+bool IsBackFacing(Meshlet meshlet, mat4 transform) {
+    if (meshlet.ConeCutoff > 1.0) return false;
+
+    vec3 apex = (transform * vec4(meshlet.ConeApex, 1.0)).xyz;
+    vec3 axis = normalize(mat3(transform) * meshlet.ConeAxis);
+    return dot(normalize(apex - u_CameraPosition), axis) >= meshlet.ConeCutoff;
+}
+
+// The sphere's box is behind last frame's farthest depth over its whole
+// screen rectangle. Anything crossing the near plane or too large for the
+// pyramid counts as visible.
+bool IsOccluded(vec3 center, float radius) {
+    vec2 uvMin = vec2(1.0);
+    vec2 uvMax = vec2(0.0);
+    float nearest = 1.0;
+    for (int i = 0; i < 8; ++i) {
+        vec3 corner = center + radius * vec3((i & 1) != 0 ? 1.0 : -1.0,
+                                             (i & 2) != 0 ? 1.0 : -1.0,
+                                             (i & 4) != 0 ? 1.0 : -1.0);
+        vec4 clip = u_HiZViewProjection * vec4(corner, 1.0);
+        if (clip.w <= 0.0) return false;
+
+        vec3 ndc = clip.xyz / clip.w;
+        vec2 uv = ndc.xy * 0.5 + 0.5;
+        uvMin = min(uvMin, uv);
+        uvMax = max(uvMax, uv);
+        nearest = min(nearest, ndc.z * 0.5 + 0.5);
+    }
+
+    // Stay inside the rendered region; the padding past it reads as empty
+    uvMin = clamp(uvMin, vec2(0.0), vec2(0.99999)) * u_HiZUVScale;
+    uvMax = clamp(uvMax, vec2(0.0), vec2(0.99999)) * u_HiZUVScale;
+
+    // The level where the rectangle spans at most 2x2 texels
+    vec2 extent = (uvMax - uvMin) * vec2(textureSize(u_HiZ, 0));
+    int level = int(ceil(log2(max(max(extent.x, extent.y), 1.0))));
+    if (level >= u_HiZLevelCount) return false;
+
+    vec2 levelSize = vec2(textureSize(u_HiZ, level));
+    ivec2 t0 = ivec2(uvMin * levelSize);
+    ivec2 t1 = ivec2(uvMax * levelSize);
+    float farthest = max(max(texelFetch(u_HiZ, t0, level).g, texelFetch(u_HiZ, ivec2(t1.x, t0.y), level).g),
+                         max(texelFetch(u_HiZ, ivec2(t0.x, t1.y), level).g, texelFetch(u_HiZ, t1, level).g));
+    return nearest > farthest;
+}
+
+void main() {
+    // Groups past 65535 wrap into y
+    uint taskIndex = u_FirstTask + gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+    if (taskIndex >= u_FirstTask + u_TaskCount) return;
+
+    Task task = u_Tasks[taskIndex];
+    Meshlet meshlet = u_Meshlets[task.Meshlet];
+    uint indexCount = meshlet.TriangleCount * 3u;
+
+    if (gl_LocalInvocationIndex == 0u) {
+        mat4 transform = u_Instances[task.Instance].Transform;
+        vec3 center = (transform * vec4(meshlet.Center, 1.0)).xyz;
+        float scale = max(max(length(transform[0].xyz), length(transform[1].xyz)), length(transform[2].xyz));
+        float radius = meshlet.Radius * scale;
+
+        bool visible = !IsOutsideFrustum(center, radius) && !IsBackFacing(meshlet, transform);
+        if (visible && u_HiZEnabled != 0) {
+            visible = !IsOccluded(center, radius);
+        }
+
+        s_Visible = visible;
+        s_OutputOffset = visible ? atomicAdd(u_OutputIndexCount, indexCount) : 0u;
+
+        DrawCommand command;
+        command.Count = indexCount;
+        command.InstanceCount = visible ? 1u : 0u;
+        command.FirstIndex = s_OutputOffset;
+        command.BaseVertex = int(task.BaseVertex);
+        command.BaseInstance = task.Instance;
+        u_Commands[taskIndex] = command;
+    }
+    barrier();
+
+    if (!s_Visible) return;
+
+    uint source = task.BaseIndex + meshlet.IndexOffset;
+    for (uint i = gl_LocalInvocationIndex; i < indexCount; i += gl_WorkGroupSize.x) {
+        u_OutputIndices[s_OutputOffset + i] = u_SourceIndices[source + i];
+    }
+}
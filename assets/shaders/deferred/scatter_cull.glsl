@@ -0,0 +1,270 @@
+#type compute
+#version 450 core
+
+// Scatter culling, see Engine::ScatterRenderer. Compiled once per stage:
+//
+//   CULL_CELLS      - one thread per cell: frustum, distance and LOD, then
+//                     reserve output room for the whole cell
+//   BUILD_COMMANDS  - one thread: prefix sum of the per-command counts
+//   CULL_INSTANCES  - one workgroup per visible cell: test each instance and
+//                     append survivors to their command's range
+
+#ifdef BUILD_COMMANDS
+layout(local_size_x = 1) in;
+#else
+layout(local_size_x = 64) in;
+#endif
+
+#include "common/camera.glsl"
+
+const uint MAX_LODS = 8u;
+const uint CELL_CULLED = 0xFFFFFFFFu;
+
+// Must match ScatterRenderer::GPUScatterInstance
+struct ScatterInstance {
+    vec3 Position;
+    uint YawScale;          // Two halves: yaw in radians, uniform scale
+};
+
+// Must match ScatterRenderer::GPUCell
+struct Cell {
+    vec3 Min;
+    uint FirstInstance;
+    vec3 Max;
+    uint InstanceCount;
+    uint Layer;
+    float MaxScale;
+    uint Padding0;
+    uint Padding1;
+};
+
+// Must match ScatterRenderer::GPULayer
+struct Layer {
+    vec4 Color;
+    vec4 MaterialParams;
+    vec4 Sphere;            // Mesh space center, radius
+    vec4 Dequant;           // Stored position * w + xyz = mesh space
+    float MaxDistance;
+    float MaxScreenError;
+    uint MaterialIndex;
+    uint LODCount;
+};
+
+// Must match ScatterRenderer::GPULOD, layer * MAX_LODS + LOD
+struct LOD {
+    uint IndexCount;
+    uint FirstIndex;
+    int BaseVertex;
+    float Error;
+};
+
+// Must match Engine::InstanceData
+struct InstanceData {
+    mat4 Transform;
+    vec4 Color;
+    vec4 MaterialParams;
+    uint EntityId;
+    uint Flags;
+    uint MaterialIndex;
+    uint Padding;
+};
+
+struct DrawCommand {
+    uint Count;
+    uint InstanceCount;
+    uint FirstIndex;
+    int BaseVertex;
+    uint BaseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer ScatterInstanceBuffer {
+    ScatterInstance u_ScatterInstances[];
+};
+
+layout(std430, binding = 1) readonly buffer CellBuffer {
+    Cell u_Cells[];
+};
+
+layout(std430, binding = 2) readonly buffer LayerBuffer {
+    Layer u_Layers[];
+};
+
+layout(std430, binding = 3) readonly buffer LODBuffer {
+    LOD u_LODs[];
+};
+
+layout(std430, binding = 4) writeonly buffer InstanceBuffer {
+    InstanceData u_Instances[];
+};
+
+// Command of each cell this view, CELL_CULLED if dropped
+layout(std430, binding = 5) buffer CellStateBuffer {
+    uint u_CellStates[];
+};
+
+layout(std430, binding = 12) buffer CommandBuffer {
+    DrawCommand u_Commands[];
+};
+
+// Cleared before the cell pass
+layout(std430, binding = 13) buffer CounterBuffer {
+    uint u_Reserved;        // Output instances claimed by visible cells
+    uint u_Counts[];        // Per command
+};
+
+layout(std430, binding = 14) writeonly buffer PreviousTransformBuffer {
+    mat4 u_PreviousTransforms[];
+};
+
+uniform uint u_CellCount;
+uniform uint u_CommandCount;
+uniform uint u_OutputCapacity;
+uniform float u_ViewportHeight;
+
+// Groups past 65535 wrap into y
+uint WrappedGroup() {
+    return gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+}
+
+bool IsOutsideFrustum(vec3 center, float radius) {
+    for (int i = 0; i < 6; ++i) {
+        if (dot(u_FrustumPlanes[i].xyz, center) + u_FrustumPlanes[i].w < -radius) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Box entirely behind one plane
+bool IsOutsideFrustum(vec3 boxMin, vec3 boxMax) {
+    for (int i = 0; i < 6; ++i) {
+        vec3 normal = u_FrustumPlanes[i].xyz;
+        vec3 positive = mix(boxMin, boxMax, greaterThanEqual(normal, vec3(0.0)));
+        if (dot(normal, positive) + u_FrustumPlanes[i].w < 0.0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+vec3 RotateYaw(vec3 v, float yaw) {
+    float c = cos(yaw);
+    float s = sin(yaw);
+    return vec3(c * v.x + s * v.z, v.y, -s * v.x + c * v.z);
+}
+
+#ifdef CULL_CELLS
+
+void main() {
+    uint cellIndex = WrappedGroup() * gl_WorkGroupSize.x + gl_LocalInvocationIndex;
+    if (cellIndex >= u_CellCount) return;
+
+    Cell cell = u_Cells[cellIndex];
+    Layer layer = u_Layers[cell.Layer];
+
+    vec3 nearest = clamp(u_CameraPosition, cell.Min, cell.Max);
+    float distance = length(nearest - u_CameraPosition);
+    if (distance > layer.MaxDistance || IsOutsideFrustum(cell.Min, cell.Max)) {
+        u_CellStates[cellIndex] = CELL_CULLED;
+        return;
+    }
+
+    // LODSelectionSystem's metric for the cell's largest instance at its
+    // nearest point: errors are relative to the radius, scaled to pixels
+    float pixelsPerUnit = u_Projection[1][1] * 0.5 * u_ViewportHeight;
+    float pixelsPerError = layer.Sphere.w * cell.MaxScale * pixelsPerUnit / max(distance, 0.1);
+    uint firstLOD = cell.Layer * MAX_LODS;
+    uint level = 0u;
+    while (level + 1u < layer.LODCount && u_LODs[firstLOD + level + 1u].Error * pixelsPerError <= layer.MaxScreenError) {
+        ++level;
+    }
+
+    // Room for every instance up front, so a command's range never
+    // overflows; past the capacity the whole cell is dropped
+    uint reserved = atomicAdd(u_Reserved, cell.InstanceCount);
+    if (reserved + cell.InstanceCount > u_OutputCapacity) {
+        u_CellStates[cellIndex] = CELL_CULLED;
+        return;
+    }
+
+    uint command = firstLOD + level;
+    atomicAdd(u_Counts[command], cell.InstanceCount);
+    u_CellStates[cellIndex] = command;
+}
+
+#endif // CULL_CELLS
+
+#ifdef BUILD_COMMANDS
+
+void main() {
+    uint offset = 0u;
+    for (uint i = 0u; i < u_CommandCount; ++i) {
+        LOD lod = u_LODs[i];
+
+        DrawCommand command;
+        command.Count = lod.IndexCount;
+        command.InstanceCount = 0u;
+        command.FirstIndex = lod.FirstIndex;
+        command.BaseVertex = lod.BaseVertex;
+        command.BaseInstance = offset;
+        u_Commands[i] = command;
+
+        offset += u_Counts[i];
+    }
+}
+
+#endif // BUILD_COMMANDS
+
+#ifdef CULL_INSTANCES
+
+void main() {
+    uint cellIndex = WrappedGroup();
+    if (cellIndex >= u_CellCount) return;
+
+    uint command = u_CellStates[cellIndex];
+    if (command == CELL_CULLED) return;
+
+    Cell cell = u_Cells[cellIndex];
+    Layer layer = u_Layers[cell.Layer];
+    uint baseInstance = u_Commands[command].BaseInstance;
+
+    for (uint i = gl_LocalInvocationIndex; i < cell.InstanceCount; i += gl_WorkGroupSize.x) {
+        ScatterInstance instance = u_ScatterInstances[cell.FirstInstance + i];
+        vec2 yawScale = unpackHalf2x16(instance.YawScale);
+        float c = cos(yawScale.x);
+        float s = sin(yawScale.x);
+        float scale = yawScale.y;
+
+        vec3 center = instance.Position + scale * RotateYaw(layer.Sphere.xyz, yawScale.x);
+        float radius = layer.Sphere.w * scale;
+        if (length(center - u_CameraPosition) - radius > layer.MaxDistance || IsOutsideFrustum(center, radius)) {
+            continue;
+        }
+
+        // Translation * yaw * scale, with Mesh::GetDrawTransform's
+        // dequantization applied first
+        float axisScale = scale * layer.Dequant.w;
+        mat4 transform;
+        transform[0] = vec4(c * axisScale, 0.0, -s * axisScale, 0.0);
+        transform[1] = vec4(0.0, axisScale, 0.0, 0.0);
+        transform[2] = vec4(s * axisScale, 0.0, c * axisScale, 0.0);
+        transform[3] = vec4(instance.Position + scale * RotateYaw(layer.Dequant.xyz, yawScale.x), 1.0);
+
+        uint slot = baseInstance + atomicAdd(u_Commands[command].InstanceCount, 1u);
+
+        InstanceData data;
+        data.Transform = transform;
+        data.Color = layer.Color;
+        data.MaterialParams = layer.MaterialParams;
+        data.EntityId = 0xFFFFFFFFu;    // entt::null, never picked
+        data.Flags = 0u;
+        data.MaterialIndex = layer.MaterialIndex;
+        data.Padding = 0u;
+        u_Instances[slot] = data;
+
+        // Static, so last frame's matrix is this one
+        u_PreviousTransforms[slot] = transform;
+    }
+}
+
+#endif // CULL_INSTANCES
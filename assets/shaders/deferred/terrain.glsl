@@ -0,0 +1,278 @@
+#type vertex
+#version 450 core
+
+// CDLOD terrain, see Engine::TerrainRenderer. One quarter-node grid of
+// integer coordinates, instanced per selected node. Built plain for the
+// G-Buffer pass and with DEPTH_ONLY for the depth prepass; the position
+// math is shared so the GL_EQUAL test holds.
+
+layout(location = 0) in vec2 a_Grid;
+
+// Must match TerrainRenderer::GPUNode
+struct TerrainNode {
+    ivec2 Sample;           // First global sample of the quarter
+    uint Level;             // Grid step is 2^Level samples
+    uint Padding;
+    float MorphStart;
+    float MorphScale;
+    vec2 Padding1;
+};
+
+layout(std430, binding = 6) readonly buffer NodeBuffer {
+    TerrainNode u_Nodes[];
+};
+
+// Tile, +X, +Z and +XZ neighbours. Stored level 0 of each is the streamed
+// u_HeightMips level; RG8, high byte first.
+layout(binding = 0) uniform sampler2D u_Heights[4];
+uniform int u_HeightMips[4];
+uniform int u_NeighbourMask;    // Bit i: neighbour i + 1 is bound
+
+uniform vec3 u_TerrainOrigin;
+uniform float u_SampleSpacing;
+uniform float u_HeightScale;
+uniform int u_TileResolution;
+uniform ivec2 u_TileSample;
+uniform uint u_FirstNode;
+
+#include "common/camera.glsl"
+
+#ifndef DEPTH_ONLY
+out vec3 v_WorldPos;
+out vec3 v_Normal;
+out vec2 v_TileCoord;       // Samples from the tile's first
+
+out vec4 v_CurrentClip;
+out vec4 v_PreviousClip;
+#endif
+
+invariant gl_Position;
+
+float DecodeHeight(vec2 texel) {
+    return (texel.r * 65280.0 + texel.g * 255.0) / 65535.0;
+}
+
+float FetchHeight(int tile, ivec2 texel) {
+    // Constant indices only
+    switch (tile) {
+        case 1: return DecodeHeight(texelFetch(u_Heights[1], texel, 0).rg);
+        case 2: return DecodeHeight(texelFetch(u_Heights[2], texel, 0).rg);
+        case 3: return DecodeHeight(texelFetch(u_Heights[3], texel, 0).rg);
+    }
+    return DecodeHeight(texelFetch(u_Heights[0], texel, 0).rg);
+}
+
+// Normalized height of a global sample. Exact while the owning texture has
+// the sample's level resident, bilinear over the coarser level otherwise.
+float Height(ivec2 sampleIndex) {
+    ivec2 local = max(sampleIndex - u_TileSample, ivec2(0));
+    ivec2 side = ivec2(greaterThanEqual(local, ivec2(u_TileResolution)));
+    int tile = side.x + side.y * 2;
+    if (tile != 0 && (u_NeighbourMask & (1 << (tile - 1))) == 0) {
+        // Far edge: the tile's own last row / column
+        tile = 0;
+        local = min(local, ivec2(u_TileResolution - 1));
+    } else {
+        local -= side * u_TileResolution;
+    }
+
+    int mip = u_HeightMips[tile];
+    int last = (u_TileResolution >> mip) - 1;
+    ivec2 texel = local >> mip;
+    ivec2 remainder = local - (texel << mip);
+    if (remainder == ivec2(0)) {
+        return FetchHeight(tile, texel);
+    }
+
+    vec2 f = vec2(remainder) / float(1 << mip);
+    ivec2 next = min(texel + 1, ivec2(last));
+    float h0 = mix(FetchHeight(tile, texel), FetchHeight(tile, ivec2(next.x, texel.y)), f.x);
+    float h1 = mix(FetchHeight(tile, ivec2(texel.x, next.y)), FetchHeight(tile, next), f.x);
+    return mix(h0, h1, f.y);
+}
+
+#ifndef DEPTH_ONLY
+// World space slope over +-step samples
+vec2 Gradient(ivec2 sampleIndex, int step) {
+    float dx = Height(sampleIndex + ivec2(step, 0)) - Height(sampleIndex - ivec2(step, 0));
+    float dz = Height(sampleIndex + ivec2(0, step)) - Height(sampleIndex - ivec2(0, step));
+    return vec2(dx, dz) * u_HeightScale / (2.0 * float(step) * u_SampleSpacing);
+}
+#endif
+
+void main() {
+    TerrainNode node = u_Nodes[u_FirstNode + uint(gl_InstanceID)];
+    int step = 1 << node.Level;
+
+    // Odd vertices (in this level's grid) slide onto their even neighbour,
+    // so at morph 1 the grid is the next level's
+    ivec2 sampleIndex = node.Sample + ivec2(a_Grid) * step;
+    ivec2 odd = (sampleIndex >> node.Level) & 1;
+    ivec2 morphIndex = sampleIndex - odd * step;
+
+    float height = Height(sampleIndex);
+    vec3 worldPos = u_TerrainOrigin + vec3(vec2(sampleIndex).x * u_SampleSpacing, height * u_HeightScale,
+                                           vec2(sampleIndex).y * u_SampleSpacing);
+    float morph = clamp((length(worldPos - u_CameraPosition) - node.MorphStart) * node.MorphScale, 0.0, 1.0);
+
+    vec2 position = mix(vec2(sampleIndex), vec2(morphIndex), morph);
+    height = mix(height, Height(morphIndex), morph);
+    worldPos = u_TerrainOrigin + vec3(position.x * u_SampleSpacing, height * u_HeightScale, position.y * u_SampleSpacing);
+
+#ifndef DEPTH_ONLY
+    vec2 slope = mix(Gradient(sampleIndex, step), Gradient(morphIndex, step), morph);
+    v_Normal = normalize(vec3(-slope.x, 1.0, -slope.y));
+    v_WorldPos = worldPos;
+    v_TileCoord = position - vec2(u_TileSample);
+
+    // Static: last frame's position differs by the camera only
+    v_CurrentClip = u_ViewProjection * vec4(worldPos, 1.0);
+    v_PreviousClip = u_PreviousViewProjection * vec4(worldPos, 1.0);
+#endif
+
+    gl_Position = u_JitteredViewProjection * vec4(worldPos, 1.0);
+}
+
+#type fragment
+#version 450 core
+#if defined(BINDLESS_TEXTURES) && !defined(DEPTH_ONLY)
+#extension GL_ARB_bindless_texture : require
+#endif
+
+#ifdef DEPTH_ONLY
+
+void main() {
+    // Depth only; color writes are masked
+}
+
+#else
+
+// Same targets as geometry.glsl
+layout(location = 0) out vec4 gTarget0;
+layout(location = 1) out vec4 gTarget1;
+layout(location = 2) out vec4 gTarget2;
+layout(location = 3) out vec4 gTarget3;
+layout(location = 4) out uint gEntityId;
+layout(location = 5) out vec2 gVelocity;
+
+in vec3 v_WorldPos;
+in vec3 v_Normal;
+in vec2 v_TileCoord;
+
+in vec4 v_CurrentClip;
+in vec4 v_PreviousClip;
+
+// Must match Engine::GPUMaterial
+struct MaterialData {
+    vec4 BaseColor;
+    vec4 Params;
+    vec4 Emissive;
+    vec2 TilingFactor;
+    uint Flags;
+    uint Padding;
+    uvec2 Maps[5];          // Bindless handle, or texture array slot and layer
+    uvec2 Padding1;
+};
+
+layout(std430, binding = 11) readonly buffer MaterialBuffer {
+    MaterialData u_Materials[];
+};
+
+#ifdef BINDLESS_TEXTURES
+vec4 SampleMap(uvec2 map, vec2 uv) {
+    return texture(sampler2D(map), uv);
+}
+#else
+// Engine::MaterialLibrary::MaxTextureArrays arrays from unit 8
+layout(binding = 8) uniform sampler2DArray u_MaterialArrays[8];
+
+vec4 SampleMap(uvec2 map, vec2 uv) {
+    vec3 coord = vec3(uv, float(map.y));
+    switch (map.x) {
+        case 0u: return texture(u_MaterialArrays[0], coord);
+        case 1u: return texture(u_MaterialArrays[1], coord);
+        case 2u: return texture(u_MaterialArrays[2], coord);
+        case 3u: return texture(u_MaterialArrays[3], coord);
+        case 4u: return texture(u_MaterialArrays[4], coord);
+        case 5u: return texture(u_MaterialArrays[5], coord);
+        case 6u: return texture(u_MaterialArrays[6], coord);
+        case 7u: return texture(u_MaterialArrays[7], coord);
+    }
+    return vec4(1.0);
+}
+#endif
+
+#include "common/camera.glsl"
+
+// Splat weights per sample of the tile, RGBA = layers 0-3
+layout(binding = 4) uniform sampler2D u_Splat;
+
+uniform uint u_LayerMaterials[4];
+uniform vec4 u_LayerTiling;     // Repeats per world unit
+uniform int u_TileResolution;
+uniform bool u_CompactGBuffer;
+
+const uint HAS_ALBEDO = 1u;
+
+vec2 OctWrap(vec2 v) {
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 EncodeOctahedral(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    n.xy = n.z >= 0.0 ? n.xy : OctWrap(n.xy);
+    return n.xy * 0.5 + 0.5;
+}
+
+float PackMetallicRoughness(float metallic, float roughness) {
+    uint m = uint(round(clamp(metallic, 0.0, 1.0) * 7.0));
+    uint r = uint(round(clamp(roughness, 0.0, 1.0) * 31.0));
+    return float((m << 5u) | r) / 255.0;
+}
+
+float LinearizeDepth(float depth) {
+    float z = depth * 2.0 - 1.0;
+    return (2.0 * u_CameraNear * u_CameraFar) / (u_CameraFar + u_CameraNear - z * (u_CameraFar - u_CameraNear));
+}
+
+void main() {
+    vec4 weights = texture(u_Splat, (v_TileCoord + 0.5) / float(u_TileResolution));
+    weights /= max(dot(weights, vec4(1.0)), 1e-4);
+
+    // Every layer is sampled, keeping the derivatives in uniform control flow
+    vec3 albedo = vec3(0.0);
+    float metallic = 0.0;
+    float roughness = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        MaterialData material = u_Materials[u_LayerMaterials[i]];
+        vec4 color = material.BaseColor;
+        if ((material.Flags & HAS_ALBEDO) != 0u) {
+            color *= SampleMap(material.Maps[0], v_WorldPos.xz * u_LayerTiling[i]);
+        }
+        albedo += color.rgb * weights[i];
+        metallic += material.Params.x * weights[i];
+        roughness += material.Params.y * weights[i];
+    }
+
+    vec3 normal = normalize(v_Normal);
+
+    gEntityId = 0xFFFFFFFFu;    // entt::null, never picked
+
+    vec2 current = v_CurrentClip.xy / v_CurrentClip.w;
+    vec2 previous = v_PreviousClip.w > 0.0 ? v_PreviousClip.xy / v_PreviousClip.w : current;
+    gVelocity = (current - previous) * 0.5;
+    if (u_CompactGBuffer) {
+        gTarget0 = vec4(EncodeOctahedral(normal), 0.0, 0.0);
+        gTarget1 = vec4(albedo, PackMetallicRoughness(metallic, roughness));
+        gTarget2 = vec4(0.0, 0.0, 0.0, 1.0);
+        gTarget3 = vec4(0.0);
+        return;
+    }
+
+    gTarget0 = vec4(v_WorldPos, LinearizeDepth(gl_FragCoord.z));
+    gTarget1 = vec4(normal * 0.5 + 0.5, metallic);
+    gTarget2 = vec4(albedo, roughness);
+    gTarget3 = vec4(0.0, 0.0, 0.0, 1.0);
+}
+
+#endif // DEPTH_ONLY
@@ -0,0 +1,150 @@
+#type compute
+#version 450 core
+
+// Volumetric fog light injection, see Engine::VolumetricFog.
+//
+// One invocation per froxel: its sample point, jittered along the slice
+// every frame, gets the fog density there and the light scattered towards
+// the camera from the ambient term, the directional lights and the point
+// and spot lights binned into its light cluster, shadowed like the lighting
+// pass shadows surfaces. The result is blended with last frame's, sampled
+// where the point was then through the previous view-projection.
+
+layout(local_size_x = 4, local_size_y = 4, local_size_z = 4) in;
+
+layout(rgba16f, binding = 0) uniform writeonly image3D u_Scattering;  // rgb = scattered light, a = extinction
+layout(binding = 8) uniform sampler3D u_History;
+
+#include "common/camera.glsl"
+
+uniform uvec3 u_GridSize;
+uniform float u_Range;
+uniform float u_Jitter;             // Sample depth within the slice, [0, 1)
+uniform float u_TemporalBlend;      // Weight of this frame, 1 without a history
+
+// Medium
+uniform float u_Density;
+uniform vec3 u_Albedo;
+uniform float u_Anisotropy;
+uniform float u_BaseHeight;
+uniform float u_HeightFalloff;
+uniform float u_AmbientIntensity;
+
+// Lights, as bound for the lighting pass
+uniform vec4 u_AmbientLight;
+uniform int u_DirectionalLightCount;
+uniform bool u_Shadows;
+
+#define LIGHT_CLUSTERS_NO_FRAGMENT
+#include "common/lighting.glsl"
+#include "common/light_clusters.glsl"
+
+const float PI = 3.14159265359;
+
+// View depth at slice, exponential from the near plane to u_Range
+float SliceDepth(float slice) {
+    return u_CameraNear * pow(u_Range / u_CameraNear, slice / float(u_GridSize.z));
+}
+
+float SliceCoord(float viewZ) {
+    return log(max(viewZ, u_CameraNear) / u_CameraNear) / log(u_Range / u_CameraNear);
+}
+
+// Henyey-Greenstein; cosTheta between the light's travel and the view ray back to the camera
+float Phase(float cosTheta) {
+    float g = u_Anisotropy;
+    float denominator = 1.0 + g * g - 2.0 * g * cosTheta;
+    return (1.0 - g * g) / (4.0 * PI * denominator * sqrt(denominator));
+}
+
+float FogDensity(vec3 worldPos) {
+    return u_Density * exp(-u_HeightFalloff * max(worldPos.y - u_BaseHeight, 0.0));
+}
+
+vec3 InScatteredLight(vec3 worldPos, vec2 uv, float viewZ) {
+    vec3 V = normalize(u_CameraPosition - worldPos);
+
+    // Ambient arrives from every direction, the phase function integrates to one
+    vec3 light = u_AmbientLight.rgb * u_AmbientLight.a * u_AmbientIntensity;
+
+    for (int i = 0; i < u_DirectionalLightCount; ++i) {
+        vec3 L = normalize(-u_DirectionalLights[i].direction.xyz);
+        vec3 radiance = u_DirectionalLights[i].colorIntensity.rgb * u_DirectionalLights[i].colorIntensity.a;
+        // First directional light casts shadows, as in the lighting pass
+        if (i == 0 && u_Shadows) {
+            radiance *= CalculateCSMShadow(worldPos, vec3(0.0), viewZ);
+        }
+        light += radiance * Phase(dot(-L, V));
+    }
+
+    uvec4 cluster = GetClusterAt(uv, viewZ);
+
+    for (uint i = 0u; i < cluster.y; ++i) {
+        PointLight pointLight = u_PointLights[u_LightIndices[cluster.x + i]];
+        vec3 toLight = pointLight.position.xyz - worldPos;
+        float distance = length(toLight);
+        if (distance > pointLight.position.w) continue;
+
+        vec3 L = toLight / max(distance, 1e-4);
+        vec3 radiance = pointLight.colorIntensity.rgb * pointLight.colorIntensity.a *
+                        PointLightAttenuation(pointLight, distance);
+        int shadowIndex = int(pointLight.attenuation.w);
+        if (shadowIndex >= 0 && u_Shadows) {
+            float shadow = CalculatePointShadow(shadowIndex, worldPos, vec3(0.0));
+            radiance *= mix(1.0, shadow, u_PointShadows[shadowIndex].params.w);
+        }
+        light += radiance * Phase(dot(-L, V));
+    }
+
+    for (uint i = 0u; i < cluster.z; ++i) {
+        SpotLight spotLight = u_SpotLights[u_LightIndices[cluster.x + cluster.y + i]];
+        vec3 toLight = spotLight.position.xyz - worldPos;
+        float distance = length(toLight);
+        if (distance > spotLight.position.w) continue;
+
+        vec3 L = toLight / max(distance, 1e-4);
+        float attenuation = SpotLightAttenuation(spotLight, L, distance);
+        if (attenuation <= 0.0) continue;
+
+        vec3 radiance = spotLight.colorIntensity.rgb * spotLight.colorIntensity.a * attenuation;
+        int shadowIndex = int(spotLight.direction.w);
+        if (shadowIndex >= 0 && u_Shadows) {
+            float shadow = CalculateSpotShadow(shadowIndex, worldPos, vec3(0.0));
+            radiance *= mix(1.0, shadow, u_SpotShadows[shadowIndex].params.w);
+        }
+        light += radiance * Phase(dot(-L, V));
+    }
+
+    return light;
+}
+
+void main() {
+    uvec3 froxel = gl_GlobalInvocationID;
+    if (any(greaterThanEqual(froxel, u_GridSize))) return;
+
+    // Sample point: the tile's center ray at a jittered depth in the slice
+    vec2 uv = (vec2(froxel.xy) + 0.5) / vec2(u_GridSize.xy);
+    vec4 ray = u_InverseProjection * vec4(uv * 2.0 - 1.0, 1.0, 1.0);
+    vec3 viewDir = ray.xyz / ray.w;
+    float viewZ = SliceDepth(float(froxel.z) + u_Jitter);
+    vec3 viewPos = viewDir * (viewZ / -viewDir.z);
+    vec3 worldPos = (u_InverseView * vec4(viewPos, 1.0)).xyz;
+
+    float density = FogDensity(worldPos);
+    vec3 scattering = density * u_Albedo * InScatteredLight(worldPos, uv, viewZ);
+    vec4 result = vec4(scattering, density);
+
+    // Last frame's value at this point, if it was inside the volume then
+    if (u_TemporalBlend < 1.0) {
+        vec4 previousClip = u_PreviousViewProjection * vec4(worldPos, 1.0);
+        if (previousClip.w > 0.0) {
+            vec3 previous = vec3(previousClip.xy / previousClip.w * 0.5 + 0.5, SliceCoord(previousClip.w));
+            if (all(greaterThanEqual(previous, vec3(0.0))) && all(lessThanEqual(previous, vec3(1.0)))) {
+                vec4 history = textureLod(u_History, previous, 0.0);
+                result = mix(history, result, u_TemporalBlend);
+            }
+        }
+    }
+
+    imageStore(u_Scattering, ivec3(froxel), result);
+}
@@ -0,0 +1,56 @@
+#type compute
+#version 450 core
+
+// Volumetric fog integration, see Engine::VolumetricFog.
+//
+// One invocation per froxel column, walking its slices front to back. Each
+// slice's scattered light is integrated analytically over the slice's
+// length along the view ray, assuming constant extinction inside it, so
+// thick slices neither lose nor gain energy. Every slice stores the light
+// scattered towards the camera up to its far side and the transmittance to
+// there; a surface's color becomes color * a + rgb.
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler3D u_Scattering;     // rgb = scattered light, a = extinction
+layout(rgba16f, binding = 0) uniform writeonly image3D u_Integrated;
+
+#include "common/camera.glsl"
+
+uniform uvec3 u_GridSize;
+uniform float u_Range;
+
+// Must match volumetric_fog_inject.glsl
+float SliceDepth(float slice) {
+    return u_CameraNear * pow(u_Range / u_CameraNear, slice / float(u_GridSize.z));
+}
+
+void main() {
+    uvec2 column = gl_GlobalInvocationID.xy;
+    if (any(greaterThanEqual(column, u_GridSize.xy))) return;
+
+    // Ray length per unit of view depth through the column's center
+    vec2 uv = (vec2(column) + 0.5) / vec2(u_GridSize.xy);
+    vec4 ray = u_InverseProjection * vec4(uv * 2.0 - 1.0, 1.0, 1.0);
+    vec3 viewDir = ray.xyz / ray.w;
+    float rayScale = length(viewDir) / -viewDir.z;
+
+    vec3 inScattered = vec3(0.0);
+    float transmittance = 1.0;
+    float sliceStart = SliceDepth(0.0);
+
+    for (uint z = 0u; z < u_GridSize.z; ++z) {
+        float sliceEnd = SliceDepth(float(z + 1u));
+        float thickness = (sliceEnd - sliceStart) * rayScale;
+        sliceStart = sliceEnd;
+
+        vec4 froxel = texelFetch(u_Scattering, ivec3(column, z), 0);
+        float extinction = max(froxel.a, 1e-6);
+        float sliceTransmittance = exp(-extinction * thickness);
+
+        inScattered += transmittance * (froxel.rgb - froxel.rgb * sliceTransmittance) / extinction;
+        transmittance *= sliceTransmittance;
+
+        imageStore(u_Integrated, ivec3(column, z), vec4(inScattered, transmittance));
+    }
+}
@@ -3,7 +3,7 @@
 
 layout(location = 0) in vec3 a_Position;
 
-uniform mat4 u_ViewProjection;
+#include "common/camera.glsl"
 
 out vec3 v_WorldPos;
 
@@ -20,7 +20,8 @@ out vec4 FragColor;
 
 uniform float u_GridSize;
 uniform float u_FadeDistance;
-uniform vec3 u_CameraPos;
+
+#include "common/camera.glsl"
 
 void main() {
     // Grid lines using screen-space derivatives
@@ -30,7 +31,7 @@ void main() {
     float alpha = 1.0 - min(line, 1.0);
 
     // Fade with distance from camera
-    float dist = length(v_WorldPos.xz - u_CameraPos.xz);
+    float dist = length(v_WorldPos.xz - u_CameraPosition.xz);
     float distanceFade = 1.0 - smoothstep(u_FadeDistance * 0.3, u_FadeDistance, dist);
     alpha *= distanceFade;
 
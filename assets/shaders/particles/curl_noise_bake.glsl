@@ -0,0 +1,95 @@
+#type compute
+#version 450 core
+
+// Bakes a tiling curl noise vector field, see Engine::VectorField.
+//
+// Pass 0 writes a vector potential: three decorrelated octaves of periodic
+// gradient noise, every octave's period a whole number of cells per tile.
+// Pass 1 writes its curl from wrapped central differences, which is
+// divergence-free, so particles following it swirl without bunching up.
+
+layout(local_size_x = 4, local_size_y = 4, local_size_z = 4) in;
+
+layout(rgba16f, binding = 0) uniform writeonly image3D u_Output;
+layout(rgba16f, binding = 1) uniform readonly image3D u_Potential;
+
+uniform int u_Pass;
+uniform int u_Resolution;
+uniform int u_Frequency;    // Cells per tile on the first octave
+uniform int u_Octaves;
+uniform uint u_Seed;
+
+uint Hash(uint x) {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+vec3 Gradient(ivec3 cell, uint seed) {
+    uint h = Hash(uint(cell.x) ^ Hash(uint(cell.y) ^ Hash(uint(cell.z) ^ seed)));
+    vec3 g = vec3(uvec3(h, h >> 10, h >> 20) & 1023u) / 511.5 - 1.0;
+    return normalize(g + 1e-4);
+}
+
+// Gradient noise repeating every period cells, in about [-1, 1]
+float PeriodicNoise(vec3 p, int period, uint seed) {
+    ivec3 i = ivec3(floor(p));
+    vec3 f = fract(p);
+    vec3 u = f * f * f * (f * (f * 6.0 - 15.0) + 10.0);
+
+    float corners[8];
+    for (int c = 0; c < 8; ++c) {
+        ivec3 offset = ivec3(c & 1, (c >> 1) & 1, (c >> 2) & 1);
+        ivec3 cell = ((i + offset) % period + period) % period;
+        corners[c] = dot(Gradient(cell, seed), f - vec3(offset));
+    }
+
+    float x0 = mix(mix(corners[0], corners[1], u.x), mix(corners[2], corners[3], u.x), u.y);
+    float x1 = mix(mix(corners[4], corners[5], u.x), mix(corners[6], corners[7], u.x), u.y);
+    return mix(x0, x1, u.z);
+}
+
+vec3 Potential(vec3 tile) {
+    vec3 sum = vec3(0.0);
+    float amplitude = 1.0;
+    float amplitudeSum = 0.0;
+    int period = u_Frequency;
+    for (int octave = 0; octave < u_Octaves; ++octave) {
+        vec3 p = tile * float(period);
+        uint seed = Hash(u_Seed + uint(octave) * 3u);
+        sum += amplitude * vec3(PeriodicNoise(p, period, seed),
+                                PeriodicNoise(p, period, seed + 1u),
+                                PeriodicNoise(p, period, seed + 2u));
+        amplitudeSum += amplitude;
+        amplitude *= 0.5;
+        period *= 2;
+    }
+    return sum / amplitudeSum;
+}
+
+vec3 LoadPotential(ivec3 texel) {
+    return imageLoad(u_Potential, (texel + u_Resolution) % u_Resolution).xyz;
+}
+
+void main() {
+    ivec3 texel = ivec3(gl_GlobalInvocationID);
+    if (any(greaterThanEqual(texel, ivec3(u_Resolution)))) return;
+
+    if (u_Pass == 0) {
+        vec3 tile = vec3(texel) / float(u_Resolution);
+        imageStore(u_Output, texel, vec4(Potential(tile), 0.0));
+        return;
+    }
+
+    vec3 dx = LoadPotential(texel + ivec3(1, 0, 0)) - LoadPotential(texel - ivec3(1, 0, 0));
+    vec3 dy = LoadPotential(texel + ivec3(0, 1, 0)) - LoadPotential(texel - ivec3(0, 1, 0));
+    vec3 dz = LoadPotential(texel + ivec3(0, 0, 1)) - LoadPotential(texel - ivec3(0, 0, 1));
+    vec3 curl = vec3(dy.z - dz.y, dz.x - dx.z, dx.y - dy.x);
+
+    // Differences per texel to per first-octave cell, about unit length
+    curl *= 0.5 * float(u_Resolution) / float(u_Frequency);
+    imageStore(u_Output, texel, vec4(curl, 0.0));
+}
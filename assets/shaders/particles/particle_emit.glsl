@@ -0,0 +1,168 @@
+#type compute
+#version 450 core
+
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+// GPU Particle struct
+struct Particle {
+    vec4 posSize;      // xyz = position, w = size
+    vec4 velLife;      // xyz = velocity, w = remaining lifetime
+    vec4 color;        // rgba
+    vec4 params;       // x = age, y = rotation, z = angularVel, w = maxLife
+};
+
+layout(std430, binding = 0) buffer ParticleBuffer {
+    Particle particles[];
+};
+
+// Atomic counters
+layout(std430, binding = 1) buffer CounterBuffer {
+    uint aliveCount;
+    uint deadCount;
+    uint padding[2];
+};
+
+// Stack of free particle slots, deadCount entries deep
+layout(std430, binding = 2) buffer DeadList {
+    uint deadIndices[];
+};
+
+// Compacted indices of live particles, appended by the update / emit passes
+layout(std430, binding = 3) buffer AliveList {
+    uint aliveIndices[];
+};
+
+// DrawArraysIndirectCommand for the render pass; instanceCount = alive list size
+layout(std430, binding = 4) buffer DrawCommand {
+    uint drawVertexCount;
+    uint drawInstanceCount;
+    uint drawFirst;
+    uint drawBaseInstance;
+};
+
+// Emitter parameters, must match Engine::GPUParticleEmitter
+// (PARTICLE_EMITTER_UBO_BINDING; std140 has the same layout as std430 here)
+layout(std140, binding = 2) uniform EmitterBlock {
+    vec4 position;
+    vec4 shapeSize;
+    vec4 velocityMin;      // w = speed min
+    vec4 velocityMax;      // w = speed max
+    vec4 gravityDrag;      // w = drag
+    vec4 colorStart;
+    vec4 colorEnd;
+    vec4 lifetimeSize;     // x/y = lifetime min/max, z/w = size start/end
+    vec4 spawnParams;      // x = size variance, y/z = rotation min/max, w = turbulence
+    vec4 timeParams;       // x = delta time, y = time, z/w = angular velocity min/max
+    vec4 collisionParams;  // x = bounce, y = friction, z = thickness, w = soft particle distance
+    uvec4 range;           // z = emit count, w = seed
+    uvec4 draw;            // y = EmitterShape, z = flags
+    vec4 fieldParams;
+} u_Emitter;
+
+const uint SHAPE_SPHERE = 1u;
+const uint SHAPE_BOX = 2u;
+const uint SHAPE_CIRCLE = 4u;
+const uint SHAPE_LINE = 5u;
+
+const float PI = 3.14159265359;
+
+// PCG hash, one stream per invocation
+uint g_RngState;
+
+uint pcgHash(uint value) {
+    uint state = value * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+float random01() {
+    g_RngState = pcgHash(g_RngState);
+    return float(g_RngState) / 4294967295.0;
+}
+
+float randomRange(float minValue, float maxValue) {
+    return minValue + random01() * (maxValue - minValue);
+}
+
+vec3 randomRange(vec3 minValue, vec3 maxValue) {
+    return vec3(randomRange(minValue.x, maxValue.x),
+                randomRange(minValue.y, maxValue.y),
+                randomRange(minValue.z, maxValue.z));
+}
+
+vec3 spawnOffset() {
+    if (u_Emitter.draw.y == SHAPE_BOX) {
+        return randomRange(-u_Emitter.shapeSize.xyz * 0.5, u_Emitter.shapeSize.xyz * 0.5);
+    }
+    if (u_Emitter.draw.y == SHAPE_SPHERE) {
+        float theta = 2.0 * PI * random01();
+        float phi = acos(2.0 * random01() - 1.0);
+        float r = u_Emitter.shapeSize.x * pow(random01(), 1.0 / 3.0);
+        return vec3(r * sin(phi) * cos(theta), r * sin(phi) * sin(theta), r * cos(phi));
+    }
+    if (u_Emitter.draw.y == SHAPE_CIRCLE) {
+        float angle = randomRange(0.0, 2.0 * PI);
+        float r = u_Emitter.shapeSize.x * sqrt(random01());
+        return vec3(r * cos(angle), 0.0, r * sin(angle));
+    }
+    if (u_Emitter.draw.y == SHAPE_LINE) {
+        return vec3((random01() - 0.5) * u_Emitter.shapeSize.x, 0.0, 0.0);
+    }
+    return vec3(0.0);
+}
+
+vec3 spawnVelocity() {
+    vec3 velocity = randomRange(u_Emitter.velocityMin.xyz, u_Emitter.velocityMax.xyz);
+    float speed = randomRange(u_Emitter.velocityMin.w, u_Emitter.velocityMax.w);
+
+    // Random direction if the velocity range is zero
+    if (length(velocity) <= 0.001) {
+        velocity = randomRange(vec3(-1.0), vec3(1.0));
+    }
+    if (length(velocity) > 0.001) {
+        velocity = normalize(velocity) * speed;
+    }
+    return velocity;
+}
+
+void main() {
+    uint idx = gl_GlobalInvocationID.x;
+    if (idx >= u_Emitter.range.z) {
+        return;
+    }
+
+    // Pop a free slot. Only pops run in this dispatch, so when the stack
+    // runs dry every over-pop puts its count back and the counter ends at 0.
+    uint previous = atomicAdd(deadCount, 0xFFFFFFFFu);
+    if (previous == 0u || previous > uint(deadIndices.length())) {
+        atomicAdd(deadCount, 1u);
+        return;
+    }
+
+    uint slot = deadIndices[previous - 1u];
+    if (slot >= uint(particles.length())) {
+        return;
+    }
+
+    g_RngState = pcgHash(u_Emitter.range.w ^ pcgHash(idx));
+
+    Particle p;
+    p.posSize.xyz = u_Emitter.position.xyz + spawnOffset();
+    p.posSize.w = u_Emitter.lifetimeSize.z + randomRange(-u_Emitter.spawnParams.x, u_Emitter.spawnParams.x);
+
+    float lifetime = randomRange(u_Emitter.lifetimeSize.x, u_Emitter.lifetimeSize.y);
+    p.velLife = vec4(spawnVelocity(), lifetime);
+
+    p.color = u_Emitter.colorStart;
+
+    // Params: age, rotation, angularVelocity, maxLifetime
+    p.params = vec4(0.0,
+                    randomRange(u_Emitter.spawnParams.y, u_Emitter.spawnParams.z),
+                    randomRange(u_Emitter.timeParams.z, u_Emitter.timeParams.w),
+                    lifetime);
+
+    particles[slot] = p;
+    atomicAdd(aliveCount, 1u);
+
+    aliveIndices[atomicAdd(drawInstanceCount, 1u)] = slot;
+}
@@ -0,0 +1,189 @@
+#type compute
+#version 450 core
+
+// Pooled emission: workgroup row y spawns for emitter slot y of the shared
+// ParticlePool, x covers that emitter's emit count. Spawn logic must stay in
+// sync with particle_emit.glsl.
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+// GPU Particle struct
+struct Particle {
+    vec4 posSize;      // xyz = position, w = size
+    vec4 velLife;      // xyz = velocity, w = remaining lifetime
+    vec4 color;        // rgba
+    vec4 params;       // x = age, y = rotation, z = angularVel, w = maxLife
+};
+
+// Must match Engine::GPUParticleEmitter
+struct EmitterParams {
+    vec4 position;
+    vec4 shapeSize;
+    vec4 velocityMin;      // w = speed min
+    vec4 velocityMax;      // w = speed max
+    vec4 gravityDrag;      // w = drag
+    vec4 colorStart;
+    vec4 colorEnd;
+    vec4 lifetimeSize;     // x/y = lifetime min/max, z/w = size start/end
+    vec4 spawnParams;      // x = size variance, y/z = rotation min/max, w = turbulence
+    vec4 timeParams;       // x = delta time, y = time, z/w = angular velocity min/max
+    vec4 collisionParams;  // x = bounce, y = friction, z = thickness, w = soft particle distance
+    uvec4 range;           // x = first particle, y = capacity, z = emit count, w = seed
+    uvec4 draw;            // x = draw command index, y = shape, z = flags
+    vec4 fieldParams;
+};
+
+struct EmitterCounters {
+    uint aliveCount;
+    uint deadCount;
+    uint padding0;
+    uint padding1;
+};
+
+struct DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint first;
+    uint baseInstance;
+};
+
+const uint NO_EMITTER = 0xFFFFFFFFu;
+
+layout(std430, binding = 0) buffer ParticleBuffer {
+    Particle particles[];
+};
+
+layout(std430, binding = 1) buffer CounterBuffer {
+    EmitterCounters counters[];
+};
+
+layout(std430, binding = 2) buffer DeadList {
+    uint deadIndices[];
+};
+
+layout(std430, binding = 3) buffer AliveList {
+    uint aliveIndices[];
+};
+
+layout(std430, binding = 4) buffer DrawCommands {
+    DrawCommand commands[];
+};
+
+layout(std430, binding = 5) readonly buffer EmitterBuffer {
+    EmitterParams emitters[];
+};
+
+const uint SHAPE_SPHERE = 1u;
+const uint SHAPE_BOX = 2u;
+const uint SHAPE_CIRCLE = 4u;
+const uint SHAPE_LINE = 5u;
+
+const float PI = 3.14159265359;
+
+// PCG hash, one stream per invocation
+uint g_RngState;
+
+uint pcgHash(uint value) {
+    uint state = value * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+float random01() {
+    g_RngState = pcgHash(g_RngState);
+    return float(g_RngState) / 4294967295.0;
+}
+
+float randomRange(float minValue, float maxValue) {
+    return minValue + random01() * (maxValue - minValue);
+}
+
+vec3 randomRange(vec3 minValue, vec3 maxValue) {
+    return vec3(randomRange(minValue.x, maxValue.x),
+                randomRange(minValue.y, maxValue.y),
+                randomRange(minValue.z, maxValue.z));
+}
+
+vec3 spawnOffset(EmitterParams e) {
+    uint shape = e.draw.y;
+    vec3 shapeSize = e.shapeSize.xyz;
+
+    if (shape == SHAPE_BOX) {
+        return randomRange(-shapeSize * 0.5, shapeSize * 0.5);
+    }
+    if (shape == SHAPE_SPHERE) {
+        float theta = 2.0 * PI * random01();
+        float phi = acos(2.0 * random01() - 1.0);
+        float r = shapeSize.x * pow(random01(), 1.0 / 3.0);
+        return vec3(r * sin(phi) * cos(theta), r * sin(phi) * sin(theta), r * cos(phi));
+    }
+    if (shape == SHAPE_CIRCLE) {
+        float angle = randomRange(0.0, 2.0 * PI);
+        float r = shapeSize.x * sqrt(random01());
+        return vec3(r * cos(angle), 0.0, r * sin(angle));
+    }
+    if (shape == SHAPE_LINE) {
+        return vec3((random01() - 0.5) * shapeSize.x, 0.0, 0.0);
+    }
+    return vec3(0.0);
+}
+
+vec3 spawnVelocity(EmitterParams e) {
+    vec3 velocity = randomRange(e.velocityMin.xyz, e.velocityMax.xyz);
+    float speed = randomRange(e.velocityMin.w, e.velocityMax.w);
+
+    // Random direction if the velocity range is zero
+    if (length(velocity) <= 0.001) {
+        velocity = randomRange(vec3(-1.0), vec3(1.0));
+    }
+    if (length(velocity) > 0.001) {
+        velocity = normalize(velocity) * speed;
+    }
+    return velocity;
+}
+
+void main() {
+    uint emitterSlot = gl_WorkGroupID.y;
+    uint idx = gl_GlobalInvocationID.x;
+
+    EmitterParams e = emitters[emitterSlot];
+    if (idx >= e.range.z) {
+        return;
+    }
+
+    // Pop a free slot off this emitter's stack (see particle_emit.glsl)
+    uint previous = atomicAdd(counters[emitterSlot].deadCount, 0xFFFFFFFFu);
+    if (previous == 0u || previous > e.range.y) {
+        atomicAdd(counters[emitterSlot].deadCount, 1u);
+        return;
+    }
+
+    uint slot = deadIndices[e.range.x + previous - 1u];
+    if (slot >= uint(particles.length())) {
+        return;
+    }
+
+    g_RngState = pcgHash(e.range.w ^ pcgHash(idx));
+
+    Particle p;
+    p.posSize.xyz = e.position.xyz + spawnOffset(e);
+    p.posSize.w = e.lifetimeSize.z + randomRange(-e.spawnParams.x, e.spawnParams.x);
+
+    float lifetime = randomRange(e.lifetimeSize.x, e.lifetimeSize.y);
+    p.velLife = vec4(spawnVelocity(e), lifetime);
+
+    p.color = e.colorStart;
+
+    // Params: age, rotation, angularVelocity, maxLifetime
+    p.params = vec4(0.0,
+                    randomRange(e.spawnParams.y, e.spawnParams.z),
+                    randomRange(e.timeParams.z, e.timeParams.w),
+                    lifetime);
+
+    particles[slot] = p;
+    atomicAdd(counters[emitterSlot].aliveCount, 1u);
+
+    uint drawIndex = e.draw.x;
+    if (drawIndex != NO_EMITTER) {
+        aliveIndices[e.range.x + atomicAdd(commands[drawIndex].instanceCount, 1u)] = slot;
+    }
+}
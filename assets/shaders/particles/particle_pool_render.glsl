@@ -0,0 +1,188 @@
+#type vertex
+#version 450 core
+
+// Pooled rendering: one glMultiDrawArraysIndirect command per emitter of the
+// shared ParticlePool, with baseInstance at the emitter's range. Otherwise
+// identical to particle_render.glsl, keep the two in sync.
+
+// GPU Particle struct (must match C++ GPUParticle layout)
+struct Particle {
+    vec4 posSize;      // xyz = position, w = size
+    vec4 velLife;      // xyz = velocity, w = remaining lifetime
+    vec4 color;        // rgba
+    vec4 params;       // x = age, y = rotation, z = angularVel, w = maxLife
+};
+
+layout(std430, binding = 0) readonly buffer ParticleBuffer {
+    Particle particles[];
+};
+
+// Live particle indices, one instance each (written by the update / emit passes)
+layout(std430, binding = 3) readonly buffer AliveList {
+    uint aliveIndices[];
+};
+
+// baseInstance + gl_InstanceID through an instanced attribute, since GL 4.5
+// doesn't expose gl_BaseInstance
+layout(location = 8) in uint a_InstanceIndex;
+
+#include "common/camera.glsl"
+
+// Must match Engine::GPUParticleEmitter; only the soft distance is read here
+struct EmitterParams {
+    vec4 position;
+    vec4 shapeSize;
+    vec4 velocityMin;
+    vec4 velocityMax;
+    vec4 gravityDrag;
+    vec4 colorStart;
+    vec4 colorEnd;
+    vec4 lifetimeSize;
+    vec4 spawnParams;
+    vec4 timeParams;
+    vec4 collisionParams;  // w = soft particle distance
+    uvec4 range;
+    uvec4 draw;
+    vec4 fieldParams;
+};
+
+layout(std430, binding = 5) readonly buffer EmitterBuffer {
+    EmitterParams emitters[];
+};
+
+layout(std430, binding = 6) readonly buffer OwnerBuffer {
+    uint owners[];
+};
+
+// Outputs
+out vec4 v_Color;
+out vec2 v_TexCoord;
+out float v_SoftDistance;
+
+// Quad corners (4 vertices per particle, using gl_VertexID)
+const vec2 QUAD_CORNERS[4] = vec2[](
+    vec2(-0.5, -0.5),  // Bottom-left
+    vec2( 0.5, -0.5),  // Bottom-right
+    vec2( 0.5,  0.5),  // Top-right
+    vec2(-0.5,  0.5)   // Top-left
+);
+
+const vec2 QUAD_UVS[4] = vec2[](
+    vec2(0.0, 0.0),
+    vec2(1.0, 0.0),
+    vec2(1.0, 1.0),
+    vec2(0.0, 1.0)
+);
+
+void main() {
+    // Instances cover only the emitter's live list, see ParticlePool::Render
+    uint particleIndex = aliveIndices[a_InstanceIndex];
+    Particle p = particles[particleIndex];
+
+    // Skip dead particles (lifetime <= 0); only possible if a draw reuses a
+    // list from before particles expired
+    if (p.velLife.w <= 0.0) {
+        gl_Position = vec4(-1000.0, -1000.0, -1000.0, 1.0);  // Off-screen
+        v_Color = vec4(0.0);
+        v_TexCoord = vec2(0.0);
+        v_SoftDistance = 0.0;
+        return;
+    }
+
+    // Get corner for this vertex
+    int vertexIndex = gl_VertexID % 4;
+    vec2 corner = QUAD_CORNERS[vertexIndex];
+
+    // Apply rotation
+    float rotation = p.params.y;
+    float cosR = cos(rotation);
+    float sinR = sin(rotation);
+    vec2 rotatedCorner = vec2(
+        corner.x * cosR - corner.y * sinR,
+        corner.x * sinR + corner.y * cosR
+    );
+
+    // Scale by particle size
+    float size = p.posSize.w;
+    rotatedCorner *= size;
+
+    // Billboard: offset in camera space
+    vec3 worldPos = p.posSize.xyz;
+    worldPos += CameraRight() * rotatedCorner.x;
+    worldPos += CameraUp() * rotatedCorner.y;
+
+    // Transform to clip space, jittered like the scene they blend into
+    gl_Position = u_JitteredViewProjection * vec4(worldPos, 1.0);
+
+    // Pass color and UVs
+    v_Color = p.color;
+    v_TexCoord = QUAD_UVS[vertexIndex];
+    v_SoftDistance = emitters[owners[particleIndex]].collisionParams.w;
+}
+
+#type fragment
+#version 450 core
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+
+// OIT: drawn between WeightedBlendedOIT::Begin() and End(), Alpha and
+// Premultiplied emitters only
+#ifdef OIT
+#include "common/oit.glsl"
+#else
+out vec4 FragColor;
+#endif
+
+uniform sampler2D u_Texture;
+uniform bool u_UseTexture;
+uniform int u_BlendMode;  // 0=Additive, 1=Alpha, 2=Multiply, 3=Premultiplied
+
+in float v_SoftDistance;
+
+// Soft particles: fade where the quad nears the scene depth buffer
+uniform sampler2D u_SceneDepth;
+uniform bool u_SceneDepthValid;
+uniform vec2 u_ScreenSize;
+uniform vec2 u_ProjectionParams;    // projection[2][2], projection[3][2]
+
+float linearDepth(float depth) {
+    return u_ProjectionParams.y / ((depth * 2.0 - 1.0) + u_ProjectionParams.x);
+}
+
+float softParticleFade(float softDistance) {
+    if (!u_SceneDepthValid || softDistance <= 0.0) {
+        return 1.0;
+    }
+    float sceneDepth = texture(u_SceneDepth, gl_FragCoord.xy / u_ScreenSize).r;
+    return clamp((linearDepth(sceneDepth) - linearDepth(gl_FragCoord.z)) / softDistance, 0.0, 1.0);
+}
+
+void main() {
+    vec4 color = v_Color;
+
+    // Sample texture if available
+    if (u_UseTexture) {
+        vec4 texColor = texture(u_Texture, v_TexCoord);
+        color *= texColor;
+    } else {
+        // Soft circular falloff for particles without texture
+        float dist = length(v_TexCoord - 0.5) * 2.0;
+        float alpha = 1.0 - smoothstep(0.0, 1.0, dist);
+        color.a *= alpha;
+    }
+
+    color.a *= softParticleFade(v_SoftDistance);
+
+    // Discard fully transparent pixels
+    if (color.a < 0.01) {
+        discard;
+    }
+
+#ifdef OIT
+    vec3 premultiplied = u_BlendMode == 3 ? color.rgb : color.rgb * color.a;
+    WriteTransparent(premultiplied, color.a);
+#else
+    FragColor = color;
+#endif
+}
@@ -0,0 +1,255 @@
+#type compute
+#version 450 core
+
+layout(local_size_x = 256, local_size_y = 1, local_size_z = 1) in;
+
+// Pooled simulation: one dispatch steps the particles of every emitter in
+// the shared ParticlePool. Each particle finds its emitter through the owner
+// buffer. Physics must stay in sync with particle_update.glsl.
+
+// GPU Particle struct
+struct Particle {
+    vec4 posSize;      // xyz = position, w = size
+    vec4 velLife;      // xyz = velocity, w = remaining lifetime
+    vec4 color;        // rgba
+    vec4 params;       // x = age, y = rotation, z = angularVel, w = maxLife
+};
+
+// Must match Engine::GPUParticleEmitter
+struct EmitterParams {
+    vec4 position;
+    vec4 shapeSize;
+    vec4 velocityMin;      // w = speed min
+    vec4 velocityMax;      // w = speed max
+    vec4 gravityDrag;      // w = drag
+    vec4 colorStart;
+    vec4 colorEnd;
+    vec4 lifetimeSize;     // x/y = lifetime min/max, z/w = size start/end
+    vec4 spawnParams;      // x = size variance, y/z = rotation min/max, w = turbulence
+    vec4 timeParams;       // x = delta time, y = time, z/w = angular velocity min/max
+    vec4 collisionParams;  // x = bounce, y = friction, z = thickness, w = soft particle distance
+    uvec4 range;           // x = first particle, y = capacity, z = emit count, w = seed
+    uvec4 draw;            // x = draw command index, y = shape, z = flags, w = vector field slot
+    vec4 fieldParams;      // xyz = field offset, w = 1 / field tile size
+};
+
+const uint EMITTER_FLAG_DEPTH_COLLISION = 1u;
+const uint NO_VECTOR_FIELD = 0xFFFFFFFFu;
+
+struct EmitterCounters {
+    uint aliveCount;
+    uint deadCount;
+    uint padding0;
+    uint padding1;
+};
+
+struct DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint first;
+    uint baseInstance;
+};
+
+const uint NO_EMITTER = 0xFFFFFFFFu;
+
+layout(std430, binding = 0) buffer ParticleBuffer {
+    Particle particles[];
+};
+
+layout(std430, binding = 1) buffer CounterBuffer {
+    EmitterCounters counters[];
+};
+
+// Per-emitter dead stacks at range.x, deadCount entries deep
+layout(std430, binding = 2) buffer DeadList {
+    uint deadIndices[];
+};
+
+// Per-emitter alive lists at range.x, sized by the emitter's draw command
+layout(std430, binding = 3) buffer AliveList {
+    uint aliveIndices[];
+};
+
+layout(std430, binding = 4) buffer DrawCommands {
+    DrawCommand commands[];
+};
+
+layout(std430, binding = 5) readonly buffer EmitterBuffer {
+    EmitterParams emitters[];
+};
+
+// Emitter slot of every particle, NO_EMITTER for unreserved slots
+layout(std430, binding = 6) readonly buffer OwnerBuffer {
+    uint owners[];
+};
+
+uniform uint u_ParticleCount;
+
+// Scene depth from the previous frame, with the matrix it was rendered with
+uniform sampler2D u_SceneDepth;
+uniform bool u_SceneDepthValid;
+uniform mat4 u_DepthViewProjection;
+uniform mat4 u_DepthInverseViewProjection;
+uniform vec3 u_DepthCameraPosition;
+uniform vec2 u_DepthUVScale;    // Rendered fraction of the depth texture
+
+// Baked turbulence fields of this dispatch (Engine::VectorField), by the
+// slot in draw.w; must match MAX_PARTICLE_VECTOR_FIELDS
+layout(binding = 2) uniform sampler3D u_VectorFields[4];
+
+// Slots differ between emitters in one wave, so index with constants
+vec3 SampleVectorField(uint slot, vec3 coord) {
+    switch (slot) {
+        case 0u: return textureLod(u_VectorFields[0], coord, 0.0).xyz;
+        case 1u: return textureLod(u_VectorFields[1], coord, 0.0).xyz;
+        case 2u: return textureLod(u_VectorFields[2], coord, 0.0).xyz;
+        case 3u: return textureLod(u_VectorFields[3], coord, 0.0).xyz;
+    }
+    return vec3(0.0);
+}
+
+// Simple pseudo-random function
+float rand(vec2 co) {
+    return fract(sin(dot(co, vec2(12.9898, 78.233))) * 43758.5453);
+}
+
+vec3 worldFromDepth(vec2 uv) {
+    float depth = textureLod(u_SceneDepth, uv * u_DepthUVScale, 0.0).r;
+    vec4 world = u_DepthInverseViewProjection * vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    return world.xyz / world.w;
+}
+
+// Screen-space collision (keep in sync with particle_update.glsl): a particle up to `thickness` behind the depth
+// buffer surface is pushed back out and reflected off the reconstructed
+// normal. Off-screen particles and sky pixels pass through.
+void collideWithDepth(inout vec3 position, inout vec3 velocity,
+                      float bounce, float friction, float thickness) {
+    vec4 clip = u_DepthViewProjection * vec4(position, 1.0);
+    if (clip.w <= 0.0) {
+        return;
+    }
+
+    vec2 ndc = clip.xy / clip.w;
+    if (any(greaterThan(abs(ndc), vec2(1.0)))) {
+        return;
+    }
+
+    vec2 uv = ndc * 0.5 + 0.5;
+    if (textureLod(u_SceneDepth, uv * u_DepthUVScale, 0.0).r >= 1.0) {
+        return;
+    }
+
+    vec3 surface = worldFromDepth(uv);
+    float penetration = clip.w - (u_DepthViewProjection * vec4(surface, 1.0)).w;
+    if (penetration < 0.0 || penetration > thickness) {
+        return;
+    }
+
+    vec2 texel = 1.0 / (vec2(textureSize(u_SceneDepth, 0)) * u_DepthUVScale);
+    vec3 dx = worldFromDepth(uv + vec2(texel.x, 0.0)) - surface;
+    vec3 dy = worldFromDepth(uv + vec2(0.0, texel.y)) - surface;
+    vec3 normal = cross(dx, dy);
+    if (dot(normal, normal) < 1e-12) {
+        return;
+    }
+    normal = normalize(normal);
+    if (dot(normal, u_DepthCameraPosition - surface) < 0.0) {
+        normal = -normal;
+    }
+
+    float approach = dot(velocity, normal);
+    if (approach < 0.0) {
+        vec3 normalVelocity = approach * normal;
+        vec3 tangentVelocity = velocity - normalVelocity;
+        velocity = tangentVelocity * (1.0 - friction) - normalVelocity * bounce;
+    }
+    position = surface + normal * 0.01;
+}
+
+vec3 randomDirection(uint seed, float time) {
+    float u = rand(vec2(float(seed), time)) * 2.0 - 1.0;
+    float theta = rand(vec2(time, float(seed))) * 6.28318;
+    float s = sqrt(1.0 - u * u);
+    return vec3(s * cos(theta), s * sin(theta), u);
+}
+
+void main() {
+    uint idx = gl_GlobalInvocationID.x;
+    if (idx >= u_ParticleCount) {
+        return;
+    }
+
+    uint emitterSlot = owners[idx];
+    if (emitterSlot == NO_EMITTER) {
+        return;
+    }
+
+    Particle p = particles[idx];
+
+    // Skip already dead particles
+    if (p.velLife.w <= 0.0) {
+        return;
+    }
+
+    EmitterParams e = emitters[emitterSlot];
+
+    // Update lifetime (paused emitters step by 0 and are only re-listed)
+    float dt = e.timeParams.x;
+    p.velLife.w -= dt;
+    p.params.x += dt;  // Increment age
+
+    // Check if particle just died
+    if (p.velLife.w <= 0.0) {
+        // Push onto the emitter's dead stack for recycling
+        uint deadIdx = atomicAdd(counters[emitterSlot].deadCount, 1u);
+        if (deadIdx < e.range.y) {
+            deadIndices[e.range.x + deadIdx] = idx;
+        }
+        atomicAdd(counters[emitterSlot].aliveCount, 0xFFFFFFFFu);
+
+        // Mark as dead
+        p.color.a = 0.0;
+        p.velLife.w = -1.0;
+
+        particles[idx] = p;
+        return;
+    }
+
+    // === Physics Update ===
+
+    vec3 velocity = p.velLife.xyz;
+    velocity += e.gravityDrag.xyz * dt;
+    velocity *= (1.0 - e.gravityDrag.w * dt);
+
+    float turbulence = e.spawnParams.w;
+    if (turbulence > 0.0) {
+        vec3 force = e.draw.w != NO_VECTOR_FIELD
+            ? SampleVectorField(e.draw.w, (p.posSize.xyz + e.fieldParams.xyz) * e.fieldParams.w)
+            : randomDirection(idx, e.timeParams.y);
+        velocity += force * turbulence * dt;
+    }
+
+    p.posSize.xyz += velocity * dt;
+
+    if ((e.draw.z & EMITTER_FLAG_DEPTH_COLLISION) != 0u && u_SceneDepthValid) {
+        collideWithDepth(p.posSize.xyz, velocity,
+                         e.collisionParams.x, e.collisionParams.y, e.collisionParams.z);
+    }
+
+    p.velLife.xyz = velocity;
+
+    // === Visual Update ===
+
+    float lifeRatio = clamp(p.params.x / p.params.w, 0.0, 1.0);
+    p.color = mix(e.colorStart, e.colorEnd, lifeRatio);
+    p.posSize.w = mix(e.lifetimeSize.z, e.lifetimeSize.w, lifeRatio);
+    p.params.y += p.params.z * dt;
+
+    particles[idx] = p;
+
+    // Still alive: list it for the emitter's draw
+    uint drawIndex = e.draw.x;
+    if (drawIndex != NO_EMITTER) {
+        aliveIndices[e.range.x + atomicAdd(commands[drawIndex].instanceCount, 1u)] = idx;
+    }
+}
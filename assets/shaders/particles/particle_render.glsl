@@ -13,11 +13,12 @@ layout(std430, binding = 0) readonly buffer ParticleBuffer {
     Particle particles[];
 };
 
-// Camera uniforms
-uniform mat4 u_ViewProjection;
-uniform vec3 u_CameraRight;
-uniform vec3 u_CameraUp;
-uniform vec3 u_CameraPosition;
+// Live particle indices, one instance each (written by the update / emit passes)
+layout(std430, binding = 3) readonly buffer AliveList {
+    uint aliveIndices[];
+};
+
+#include "common/camera.glsl"
 
 // Outputs
 out vec4 v_Color;
@@ -39,11 +40,12 @@ const vec2 QUAD_UVS[4] = vec2[](
 );
 
 void main() {
-    // Get particle from buffer using instance ID
-    uint particleIndex = gl_InstanceID;
+    // Instances cover only the live list, see ParticleEmitter::Render
+    uint particleIndex = aliveIndices[gl_InstanceID];
     Particle p = particles[particleIndex];
 
-    // Skip dead particles (lifetime <= 0)
+    // Skip dead particles (lifetime <= 0); only possible if a draw reuses a
+    // list from before particles expired
     if (p.velLife.w <= 0.0) {
         gl_Position = vec4(-1000.0, -1000.0, -1000.0, 1.0);  // Off-screen
         v_Color = vec4(0.0);
@@ -70,11 +72,11 @@ void main() {
 
     // Billboard: offset in camera space
     vec3 worldPos = p.posSize.xyz;
-    worldPos += u_CameraRight * rotatedCorner.x;
-    worldPos += u_CameraUp * rotatedCorner.y;
+    worldPos += CameraRight() * rotatedCorner.x;
+    worldPos += CameraUp() * rotatedCorner.y;
 
-    // Transform to clip space
-    gl_Position = u_ViewProjection * vec4(worldPos, 1.0);
+    // Transform to clip space, jittered like the scene they blend into
+    gl_Position = u_JitteredViewProjection * vec4(worldPos, 1.0);
 
     // Pass color and UVs
     v_Color = p.color;
@@ -87,11 +89,36 @@ void main() {
 in vec4 v_Color;
 in vec2 v_TexCoord;
 
+// OIT: drawn between WeightedBlendedOIT::Begin() and End(), Alpha and
+// Premultiplied emitters only
+#ifdef OIT
+#include "common/oit.glsl"
+#else
 out vec4 FragColor;
+#endif
 
 uniform sampler2D u_Texture;
 uniform bool u_UseTexture;
-uniform int u_BlendMode;  // 0=Additive, 1=Alpha, 2=Multiply
+uniform int u_BlendMode;  // 0=Additive, 1=Alpha, 2=Multiply, 3=Premultiplied
+uniform float u_SoftDistance;
+
+// Soft particles: fade where the quad nears the scene depth buffer
+uniform sampler2D u_SceneDepth;
+uniform bool u_SceneDepthValid;
+uniform vec2 u_ScreenSize;
+uniform vec2 u_ProjectionParams;    // projection[2][2], projection[3][2]
+
+float linearDepth(float depth) {
+    return u_ProjectionParams.y / ((depth * 2.0 - 1.0) + u_ProjectionParams.x);
+}
+
+float softParticleFade(float softDistance) {
+    if (!u_SceneDepthValid || softDistance <= 0.0) {
+        return 1.0;
+    }
+    float sceneDepth = texture(u_SceneDepth, gl_FragCoord.xy / u_ScreenSize).r;
+    return clamp((linearDepth(sceneDepth) - linearDepth(gl_FragCoord.z)) / softDistance, 0.0, 1.0);
+}
 
 void main() {
     vec4 color = v_Color;
@@ -107,10 +134,17 @@ void main() {
         color.a *= alpha;
     }
 
+    color.a *= softParticleFade(u_SoftDistance);
+
     // Discard fully transparent pixels
     if (color.a < 0.01) {
         discard;
     }
 
+#ifdef OIT
+    vec3 premultiplied = u_BlendMode == 3 ? color.rgb : color.rgb * color.a;
+    WriteTransparent(premultiplied, color.a);
+#else
     FragColor = color;
+#endif
 }
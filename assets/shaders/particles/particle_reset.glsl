@@ -0,0 +1,37 @@
+#type compute
+#version 450 core
+
+layout(local_size_x = 256, local_size_y = 1, local_size_z = 1) in;
+
+// Kills a range of particles and puts every slot of it back on the dead
+// stack, so resets never round-trip through a CPU copy of the buffers
+
+struct Particle {
+    vec4 posSize;
+    vec4 velLife;      // w = remaining lifetime, < 0 = dead
+    vec4 color;
+    vec4 params;
+};
+
+layout(std430, binding = 0) buffer ParticleBuffer {
+    Particle particles[];
+};
+
+layout(std430, binding = 2) buffer DeadList {
+    uint deadIndices[];
+};
+
+uniform uint u_Offset;
+uniform uint u_Count;
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= u_Count) return;
+
+    uint index = u_Offset + i;
+    particles[index].posSize = vec4(0.0);
+    particles[index].velLife = vec4(0.0, 0.0, 0.0, -1.0);
+    particles[index].color = vec4(0.0);
+    particles[index].params = vec4(0.0);
+    deadIndices[index] = index;
+}
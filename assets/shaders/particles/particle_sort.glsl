@@ -0,0 +1,148 @@
+#type compute
+#version 450 core
+
+// Bitonic sort of an emitter's alive list, farthest particle first, so
+// alpha-blended particles composite back to front. Blocks of 1024 keys are
+// sorted and merged in shared memory; only merge distances of 1024 and up
+// need a global pass. See ParticleSorter for the dispatch sequence.
+layout(local_size_x = 512, local_size_y = 1, local_size_z = 1) in;
+
+const uint BLOCK_SIZE = 1024u;
+
+const uint MODE_BUILD_SORT_LOCAL = 0u;  // Build keys, sort each block
+const uint MODE_MERGE_GLOBAL = 1u;      // One compare-exchange step across blocks
+const uint MODE_MERGE_LOCAL = 2u;       // Remaining steps of a merge inside each block
+const uint MODE_WRITE_BACK = 3u;        // Sorted indices -> alive list
+
+const uint PADDING_KEY = 0xFFFFFFFFu;
+
+// GPU Particle struct
+struct Particle {
+    vec4 posSize;      // xyz = position, w = size
+    vec4 velLife;      // xyz = velocity, w = remaining lifetime
+    vec4 color;        // rgba
+    vec4 params;       // x = age, y = rotation, z = angularVel, w = maxLife
+};
+
+layout(std430, binding = 0) readonly buffer ParticleBuffer {
+    Particle particles[];
+};
+
+layout(std430, binding = 3) buffer AliveList {
+    uint aliveIndices[];
+};
+
+// instanceCount = alive list size
+layout(std430, binding = 4) readonly buffer DrawCommand {
+    uint drawVertexCount;
+    uint drawInstanceCount;
+    uint drawFirst;
+    uint drawBaseInstance;
+};
+
+// x = depth key, y = particle index
+layout(std430, binding = 5) buffer SortBuffer {
+    uvec2 sortKeys[];
+};
+
+uniform uint u_Mode;
+uniform uint u_MergeSize;       // k: size of the bitonic sequences being merged
+uniform uint u_MergeStride;     // j: compare distance
+
+#include "common/camera.glsl"
+
+shared uvec2 s_Keys[BLOCK_SIZE];
+
+// Ascending keys = descending distance. Squared distance is positive, so its
+// bits order like the float.
+uint depthKey(uint particleIndex) {
+    vec3 toCamera = particles[particleIndex].posSize.xyz - u_CameraPosition;
+    return (PADDING_KEY - 1u) - floatBitsToUint(dot(toCamera, toCamera));
+}
+
+// Compare-exchange of element i and i + j; ascending where bit k of i is clear
+void compareExchangeShared(uint localIndex, uint globalIndex, uint k, uint j) {
+    uvec2 a = s_Keys[localIndex];
+    uvec2 b = s_Keys[localIndex + j];
+    bool ascending = (globalIndex & k) == 0u;
+    if ((a.x > b.x) == ascending) {
+        s_Keys[localIndex] = b;
+        s_Keys[localIndex + j] = a;
+    }
+}
+
+// Pair (i, i + j) handled by thread t for stride j
+uint pairIndex(uint t, uint j) {
+    return 2u * j * (t / j) + (t % j);
+}
+
+void mergeShared(uint blockBase, uint k, uint startStride) {
+    uint t = gl_LocalInvocationID.x;
+    for (uint j = startStride; j > 0u; j >>= 1u) {
+        barrier();
+        uint i = pairIndex(t, j);
+        compareExchangeShared(i, blockBase + i, k, j);
+    }
+    barrier();
+}
+
+void loadBlock(uint blockBase) {
+    uint t = gl_LocalInvocationID.x;
+    s_Keys[t] = sortKeys[blockBase + t];
+    s_Keys[t + BLOCK_SIZE / 2u] = sortKeys[blockBase + t + BLOCK_SIZE / 2u];
+}
+
+void storeBlock(uint blockBase) {
+    uint t = gl_LocalInvocationID.x;
+    sortKeys[blockBase + t] = s_Keys[t];
+    sortKeys[blockBase + t + BLOCK_SIZE / 2u] = s_Keys[t + BLOCK_SIZE / 2u];
+}
+
+void main() {
+    uint t = gl_LocalInvocationID.x;
+    uint blockBase = gl_WorkGroupID.x * BLOCK_SIZE;
+    uint aliveCount = drawInstanceCount;
+
+    if (u_Mode == MODE_BUILD_SORT_LOCAL) {
+        // Entries past the alive list sort to the end
+        for (uint n = 0u; n < 2u; n++) {
+            uint local = t + n * (BLOCK_SIZE / 2u);
+            uint index = blockBase + local;
+            uvec2 key = uvec2(PADDING_KEY, 0u);
+            if (index < aliveCount) {
+                uint particleIndex = aliveIndices[index];
+                key = uvec2(depthKey(particleIndex), particleIndex);
+            }
+            s_Keys[local] = key;
+        }
+
+        for (uint k = 2u; k <= BLOCK_SIZE; k <<= 1u) {
+            mergeShared(blockBase, k, k >> 1u);
+        }
+
+        storeBlock(blockBase);
+    } else if (u_Mode == MODE_MERGE_GLOBAL) {
+        uint globalThread = gl_GlobalInvocationID.x;
+        uint i = pairIndex(globalThread, u_MergeStride);
+        uint l = i + u_MergeStride;
+
+        uvec2 a = sortKeys[i];
+        uvec2 b = sortKeys[l];
+        bool ascending = (i & u_MergeSize) == 0u;
+        if ((a.x > b.x) == ascending) {
+            sortKeys[i] = b;
+            sortKeys[l] = a;
+        }
+    } else if (u_Mode == MODE_MERGE_LOCAL) {
+        loadBlock(blockBase);
+        mergeShared(blockBase, u_MergeSize, BLOCK_SIZE / 2u);
+        storeBlock(blockBase);
+    } else if (u_Mode == MODE_WRITE_BACK) {
+        for (uint n = 0u; n < 2u; n++) {
+            uint index = blockBase + t + n * (BLOCK_SIZE / 2u);
+            if (index < aliveCount) {
+                aliveIndices[index] = sortKeys[index].y;
+            }
+        }
+    }
+}
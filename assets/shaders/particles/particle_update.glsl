@@ -28,29 +28,113 @@ layout(std430, binding = 2) buffer DeadList {
     uint deadIndices[];
 };
 
-// Uniforms
-uniform float u_DeltaTime;
-uniform float u_Time;
-uniform vec3 u_Gravity;
-uniform float u_Drag;
-uniform float u_Turbulence;
+// Compacted indices of live particles, appended by the update / emit passes
+layout(std430, binding = 3) buffer AliveList {
+    uint aliveIndices[];
+};
 
-// Color interpolation
-uniform vec4 u_ColorStart;
-uniform vec4 u_ColorEnd;
+// DrawArraysIndirectCommand for the render pass; instanceCount = alive list size
+layout(std430, binding = 4) buffer DrawCommand {
+    uint drawVertexCount;
+    uint drawInstanceCount;
+    uint drawFirst;
+    uint drawBaseInstance;
+};
 
-// Size interpolation
-uniform float u_SizeStart;
-uniform float u_SizeEnd;
+// Emitter parameters, must match Engine::GPUParticleEmitter
+// (PARTICLE_EMITTER_UBO_BINDING; std140 has the same layout as std430 here)
+layout(std140, binding = 2) uniform EmitterBlock {
+    vec4 position;
+    vec4 shapeSize;
+    vec4 velocityMin;      // w = speed min
+    vec4 velocityMax;      // w = speed max
+    vec4 gravityDrag;      // w = drag
+    vec4 colorStart;
+    vec4 colorEnd;
+    vec4 lifetimeSize;     // x/y = lifetime min/max, z/w = size start/end
+    vec4 spawnParams;      // x = size variance, y/z = rotation min/max, w = turbulence
+    vec4 timeParams;       // x = delta time, y = time, z/w = angular velocity min/max
+    vec4 collisionParams;  // x = bounce, y = friction, z = thickness, w = soft particle distance
+    uvec4 range;           // z = emit count, w = seed
+    uvec4 draw;            // y = EmitterShape, z = flags, w = vector field slot
+    vec4 fieldParams;      // xyz = field offset, w = 1 / field tile size
+} u_Emitter;
+
+const uint EMITTER_FLAG_DEPTH_COLLISION = 1u;
+const uint NO_VECTOR_FIELD = 0xFFFFFFFFu;
+
+// Baked turbulence (Engine::VectorField), bound when draw.w is not NO_VECTOR_FIELD
+uniform sampler3D u_VectorField;
+
+// Scene depth from the previous frame, with the matrix it was rendered with
+uniform sampler2D u_SceneDepth;
+uniform bool u_SceneDepthValid;
+uniform mat4 u_DepthViewProjection;
+uniform mat4 u_DepthInverseViewProjection;
+uniform vec3 u_DepthCameraPosition;
+uniform vec2 u_DepthUVScale;    // Rendered fraction of the depth texture
 
 // Simple pseudo-random function
 float rand(vec2 co) {
     return fract(sin(dot(co, vec2(12.9898, 78.233))) * 43758.5453);
 }
 
+vec3 worldFromDepth(vec2 uv) {
+    float depth = textureLod(u_SceneDepth, uv * u_DepthUVScale, 0.0).r;
+    vec4 world = u_DepthInverseViewProjection * vec4(uv * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    return world.xyz / world.w;
+}
+
+// Screen-space collision (keep in sync with particle_pool_update.glsl): a particle up to `thickness` behind the depth
+// buffer surface is pushed back out and reflected off the reconstructed
+// normal. Off-screen particles and sky pixels pass through.
+void collideWithDepth(inout vec3 position, inout vec3 velocity,
+                      float bounce, float friction, float thickness) {
+    vec4 clip = u_DepthViewProjection * vec4(position, 1.0);
+    if (clip.w <= 0.0) {
+        return;
+    }
+
+    vec2 ndc = clip.xy / clip.w;
+    if (any(greaterThan(abs(ndc), vec2(1.0)))) {
+        return;
+    }
+
+    vec2 uv = ndc * 0.5 + 0.5;
+    if (textureLod(u_SceneDepth, uv * u_DepthUVScale, 0.0).r >= 1.0) {
+        return;
+    }
+
+    vec3 surface = worldFromDepth(uv);
+    float penetration = clip.w - (u_DepthViewProjection * vec4(surface, 1.0)).w;
+    if (penetration < 0.0 || penetration > thickness) {
+        return;
+    }
+
+    vec2 texel = 1.0 / (vec2(textureSize(u_SceneDepth, 0)) * u_DepthUVScale);
+    vec3 dx = worldFromDepth(uv + vec2(texel.x, 0.0)) - surface;
+    vec3 dy = worldFromDepth(uv + vec2(0.0, texel.y)) - surface;
+    vec3 normal = cross(dx, dy);
+    if (dot(normal, normal) < 1e-12) {
+        return;
+    }
+    normal = normalize(normal);
+    if (dot(normal, u_DepthCameraPosition - surface) < 0.0) {
+        normal = -normal;
+    }
+
+    float approach = dot(velocity, normal);
+    if (approach < 0.0) {
+        vec3 normalVelocity = approach * normal;
+        vec3 tangentVelocity = velocity - normalVelocity;
+        velocity = tangentVelocity * (1.0 - friction) - normalVelocity * bounce;
+    }
+    position = surface + normal * 0.01;
+}
+
 vec3 randomDirection(uint seed) {
-    float u = rand(vec2(float(seed), u_Time)) * 2.0 - 1.0;
-    float theta = rand(vec2(u_Time, float(seed))) * 6.28318;
+    float u = rand(vec2(float(seed), u_Emitter.timeParams.y)) * 2.0 - 1.0;
+    float theta = rand(vec2(u_Emitter.timeParams.y, float(seed))) * 6.28318;
     float s = sqrt(1.0 - u * u);
     return vec3(s * cos(theta), s * sin(theta), u);
 }
@@ -71,7 +155,7 @@ void main() {
     }
 
     // Update lifetime
-    float dt = u_DeltaTime;
+    float dt = u_Emitter.timeParams.x;
     p.velLife.w -= dt;
     p.params.x += dt;  // Increment age
 
@@ -96,19 +180,31 @@ void main() {
 
     // Apply gravity
     vec3 velocity = p.velLife.xyz;
-    velocity += u_Gravity * dt;
+    velocity += u_Emitter.gravityDrag.xyz * dt;
 
     // Apply drag (air resistance)
-    velocity *= (1.0 - u_Drag * dt);
-
-    // Apply turbulence (random force)
-    if (u_Turbulence > 0.0) {
-        vec3 turbForce = randomDirection(idx) * u_Turbulence;
-        velocity += turbForce * dt;
+    velocity *= (1.0 - u_Emitter.gravityDrag.w * dt);
+
+    // Apply turbulence: one fetch from the emitter's field, or a random force
+    if (u_Emitter.spawnParams.w > 0.0) {
+        vec3 turbForce;
+        if (u_Emitter.draw.w != NO_VECTOR_FIELD) {
+            vec3 fieldCoord = (p.posSize.xyz + u_Emitter.fieldParams.xyz) * u_Emitter.fieldParams.w;
+            turbForce = textureLod(u_VectorField, fieldCoord, 0.0).xyz;
+        } else {
+            turbForce = randomDirection(idx);
+        }
+        velocity += turbForce * u_Emitter.spawnParams.w * dt;
     }
 
     // Update position
     p.posSize.xyz += velocity * dt;
+
+    if ((u_Emitter.draw.z & EMITTER_FLAG_DEPTH_COLLISION) != 0u && u_SceneDepthValid) {
+        collideWithDepth(p.posSize.xyz, velocity,
+                         u_Emitter.collisionParams.x, u_Emitter.collisionParams.y, u_Emitter.collisionParams.z);
+    }
+
     p.velLife.xyz = velocity;
 
     // === Visual Update ===
@@ -118,14 +214,17 @@ void main() {
     lifeRatio = clamp(lifeRatio, 0.0, 1.0);
 
     // Interpolate color
-    p.color = mix(u_ColorStart, u_ColorEnd, lifeRatio);
+    p.color = mix(u_Emitter.colorStart, u_Emitter.colorEnd, lifeRatio);
 
     // Interpolate size
-    p.posSize.w = mix(u_SizeStart, u_SizeEnd, lifeRatio);
+    p.posSize.w = mix(u_Emitter.lifetimeSize.z, u_Emitter.lifetimeSize.w, lifeRatio);
 
     // Update rotation
     p.params.y += p.params.z * dt;  // rotation += angularVelocity * dt
 
     // Write back
     particles[idx] = p;
+
+    // Still alive: draw it this frame
+    aliveIndices[atomicAdd(drawInstanceCount, 1u)] = idx;
 }
@@ -0,0 +1,128 @@
+#type compute
+#version 450 core
+
+// Bloom downsample, see Engine::PostProcessStack.
+//
+// 13-tap filter (Jimenez, "Next Generation Post Processing in Call of Duty:
+// Advanced Warfare"): five overlapping 2x2 boxes of bilinear taps, so every
+// source texel contributes and nothing flickers as bright pixels move. The
+// first pass reads the scene, weights each box by 1 / (1 + luma) (Karis
+// average) so single hot pixels can't blow up into squares, applies the
+// soft threshold, and bins the scene's log luminance for auto-exposure.
+
+layout(local_size_x = 16, local_size_y = 16) in;
+
+layout(binding = 0) uniform sampler2D u_Source;
+layout(r11f_g11f_b10f, binding = 0) uniform writeonly image2D u_Destination;
+
+// Must match PostProcessStack::HistogramBins; bin 0 holds black texels
+layout(std430, binding = 0) buffer HistogramBuffer {
+    uint u_Bins[256];
+};
+
+uniform int u_SourceLevel;
+uniform vec2 u_SourceUVMax;     // Rendered region of the source level
+uniform ivec2 u_DestSize;       // Texels to write
+uniform int u_FirstPass;
+uniform int u_Histogram;
+
+uniform float u_Threshold;
+uniform float u_Knee;
+uniform float u_MinLogLuminance;
+uniform float u_LogLuminanceRange;
+
+shared uint s_Bins[256];
+
+float Luminance(vec3 color) {
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+// Bilinear tap kept half a texel inside the rendered region
+vec3 Sample(vec2 uv, vec2 texel) {
+    vec2 halfTexel = 0.5 * texel;
+    return textureLod(u_Source, clamp(uv, halfTexel, u_SourceUVMax - halfTexel), float(u_SourceLevel)).rgb;
+}
+
+// Quadratic ramp from threshold - knee to threshold + knee, linear above
+vec3 Prefilter(vec3 color) {
+    float brightness = max(color.r, max(color.g, color.b));
+    float knee = u_Threshold * u_Knee + 1e-5;
+    float soft = clamp(brightness - u_Threshold + knee, 0.0, 2.0 * knee);
+    soft = soft * soft / (4.0 * knee);
+    return color * (max(soft, brightness - u_Threshold) / max(brightness, 1e-5));
+}
+
+vec3 KarisAverage(vec3 boxes[5], float weights[5]) {
+    vec3 sum = vec3(0.0);
+    float weightSum = 0.0;
+    for (int i = 0; i < 5; ++i) {
+        float w = weights[i] / (1.0 + Luminance(boxes[i]));
+        sum += boxes[i] * w;
+        weightSum += w;
+    }
+    return sum / weightSum;
+}
+
+uint HistogramBin(float luminance) {
+    if (luminance < 1e-5) return 0u;
+    float t = clamp((log2(luminance) - u_MinLogLuminance) / u_LogLuminanceRange, 0.0, 1.0);
+    return 1u + uint(t * 254.0);
+}
+
+void main() {
+    if (u_Histogram != 0) {
+        s_Bins[gl_LocalInvocationIndex] = 0u;
+        barrier();
+    }
+
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    if (all(lessThan(p, u_DestSize))) {
+        vec2 texel = 1.0 / vec2(textureSize(u_Source, u_SourceLevel));
+        vec2 uv = (vec2(p) + 0.5) / vec2(u_DestSize) * u_SourceUVMax;
+
+        vec3 a = Sample(uv + texel * vec2(-2.0,  2.0), texel);
+        vec3 b = Sample(uv + texel * vec2( 0.0,  2.0), texel);
+        vec3 c = Sample(uv + texel * vec2( 2.0,  2.0), texel);
+        vec3 d = Sample(uv + texel * vec2(-2.0,  0.0), texel);
+        vec3 e = Sample(uv, texel);
+        vec3 f = Sample(uv + texel * vec2( 2.0,  0.0), texel);
+        vec3 g = Sample(uv + texel * vec2(-2.0, -2.0), texel);
+        vec3 h = Sample(uv + texel * vec2( 0.0, -2.0), texel);
+        vec3 i = Sample(uv + texel * vec2( 2.0, -2.0), texel);
+        vec3 j = Sample(uv + texel * vec2(-1.0,  1.0), texel);
+        vec3 k = Sample(uv + texel * vec2( 1.0,  1.0), texel);
+        vec3 l = Sample(uv + texel * vec2(-1.0, -1.0), texel);
+        vec3 m = Sample(uv + texel * vec2( 1.0, -1.0), texel);
+
+        vec3 boxes[5] = vec3[5](
+            (j + k + l + m) * 0.25,
+            (a + b + d + e) * 0.25,
+            (b + c + e + f) * 0.25,
+            (d + e + g + h) * 0.25,
+            (e + f + h + i) * 0.25);
+        float weights[5] = float[5](0.5, 0.125, 0.125, 0.125, 0.125);
+
+        vec3 color;
+        if (u_FirstPass != 0) {
+            color = Prefilter(KarisAverage(boxes, weights));
+            if (u_Histogram != 0) {
+                atomicAdd(s_Bins[HistogramBin(Luminance(e))], 1u);
+            }
+        } else {
+            color = vec3(0.0);
+            for (int n = 0; n < 5; ++n) {
+                color += boxes[n] * weights[n];
+            }
+        }
+        imageStore(u_Destination, p, vec4(color, 1.0));
+    }
+
+    // One global atomic per bin and group
+    if (u_Histogram != 0) {
+        barrier();
+        uint count = s_Bins[gl_LocalInvocationIndex];
+        if (count > 0u) {
+            atomicAdd(u_Bins[gl_LocalInvocationIndex], count);
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#type compute
+#version 450 core
+
+// Bloom upsample, see Engine::PostProcessStack.
+//
+// Tent-filters the level below (3x3 bilinear taps one source texel apart)
+// and adds it to this level, so level 0 ends up with every level's blur.
+
+layout(local_size_x = 16, local_size_y = 16) in;
+
+layout(binding = 0) uniform sampler2D u_Source;
+layout(r11f_g11f_b10f, binding = 0) uniform image2D u_Destination;
+
+uniform int u_SourceLevel;
+uniform vec2 u_SourceUVMax;     // Rendered region of the source level
+uniform ivec2 u_DestSize;
+
+vec3 Sample(vec2 uv, vec2 texel) {
+    vec2 halfTexel = 0.5 * texel;
+    return textureLod(u_Source, clamp(uv, halfTexel, u_SourceUVMax - halfTexel), float(u_SourceLevel)).rgb;
+}
+
+void main() {
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(p, u_DestSize))) return;
+
+    vec2 texel = 1.0 / vec2(textureSize(u_Source, u_SourceLevel));
+    vec2 uv = (vec2(p) + 0.5) / vec2(u_DestSize) * u_SourceUVMax;
+
+    vec3 sum = Sample(uv, texel) * 4.0;
+    sum += (Sample(uv + vec2(texel.x, 0.0), texel) + Sample(uv - vec2(texel.x, 0.0), texel) +
+            Sample(uv + vec2(0.0, texel.y), texel) + Sample(uv - vec2(0.0, texel.y), texel)) * 2.0;
+    sum += Sample(uv + texel, texel) + Sample(uv - texel, texel) +
+           Sample(uv + vec2(texel.x, -texel.y), texel) + Sample(uv + vec2(-texel.x, texel.y), texel);
+
+    vec3 color = imageLoad(u_Destination, p).rgb + sum / 16.0;
+    imageStore(u_Destination, p, vec4(color, 1.0));
+}
@@ -0,0 +1,65 @@
+#type compute
+#version 450 core
+
+// Auto-exposure from the luminance histogram, see Engine::PostProcessStack.
+//
+// Averages log luminance over the texels between the low and high
+// percentiles (bin 0, black, is left out), eases the adapted luminance
+// toward it and clears the histogram for the next frame.
+
+layout(local_size_x = 256) in;
+
+layout(std430, binding = 0) buffer HistogramBuffer {
+    uint u_Bins[256];
+};
+
+// Must match ExposureState in PostProcessStack.cpp
+layout(std430, binding = 1) buffer ExposureBuffer {
+    float u_AdaptedLuminance;
+    float u_AdaptedExposure;
+};
+
+uniform float u_MinLogLuminance;
+uniform float u_LogLuminanceRange;
+uniform float u_LowPercent;
+uniform float u_HighPercent;
+uniform float u_Adaptation;     // Fraction of the way to go this frame
+uniform float u_KeyValue;
+
+shared uint s_Bins[256];
+
+void main() {
+    uint bin = gl_LocalInvocationIndex;
+    s_Bins[bin] = u_Bins[bin];
+    u_Bins[bin] = 0u;
+    barrier();
+
+    if (bin != 0u) return;
+
+    float total = 0.0;
+    for (uint b = 1u; b < 256u; ++b) {
+        total += float(s_Bins[b]);
+    }
+    if (total == 0.0) return;
+
+    float low = total * u_LowPercent;
+    float high = total * u_HighPercent;
+    float seen = 0.0;
+    float logSum = 0.0;
+    float weight = 0.0;
+    for (uint b = 1u; b < 256u; ++b) {
+        float count = float(s_Bins[b]);
+        float inside = max(min(seen + count, high) - max(seen, low), 0.0);
+        seen += count;
+
+        float logLuminance = (float(b) - 0.5) / 254.0 * u_LogLuminanceRange + u_MinLogLuminance;
+        logSum += logLuminance * inside;
+        weight += inside;
+    }
+    if (weight == 0.0) return;
+
+    float target = exp2(logSum / weight);
+    float adapted = u_AdaptedLuminance > 0.0 ? mix(u_AdaptedLuminance, target, u_Adaptation) : target;
+    u_AdaptedLuminance = adapted;
+    u_AdaptedExposure = u_KeyValue / max(adapted, 1e-4);
+}
@@ -0,0 +1,32 @@
+#type compute
+#version 450 core
+
+// Weighted blended OIT resolve, see Engine::WeightedBlendedOIT.
+//
+// One thread per pixel of the target's viewport: the weighted average of
+// the transparent surfaces is blended over the opaque color with the
+// coverage left by all of them.
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler2D u_Accumulation;
+layout(binding = 1) uniform sampler2D u_Revealage;
+
+layout(rgba16f, binding = 0) uniform image2D u_Target;
+
+uniform ivec2 u_Size;
+
+void main() {
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(p, u_Size))) return;
+
+    // Product of (1 - alpha) over every surface; 1 where none was drawn
+    float revealage = texelFetch(u_Revealage, p, 0).r;
+    if (revealage >= 1.0) return;
+
+    vec4 accumulation = texelFetch(u_Accumulation, p, 0);
+    vec3 average = accumulation.rgb / clamp(accumulation.a, 1e-4, 5e4);
+
+    vec4 target = imageLoad(u_Target, p);
+    imageStore(u_Target, p, vec4(mix(average, target.rgb, revealage), target.a));
+}
@@ -0,0 +1,96 @@
+#type compute
+#version 450 core
+
+// Final post pass, see Engine::PostProcessStack: scene (upscaled and
+// sharpened when rendered below output size) + bloom, exposure, ACES,
+// gamma, then the grading LUT, written as the display image.
+
+layout(local_size_x = 16, local_size_y = 16) in;
+
+layout(binding = 0) uniform sampler2D u_HDRBuffer;
+layout(binding = 1) uniform sampler2D u_Bloom;
+layout(binding = 2) uniform sampler3D u_GradingLUT;
+layout(rgba8, binding = 0) uniform writeonly image2D u_Output;
+
+layout(std430, binding = 1) readonly buffer ExposureBuffer {
+    float u_AdaptedLuminance;
+    float u_AdaptedExposure;
+};
+
+uniform ivec2 u_OutputSize;
+uniform float u_Exposure;       // Manual, or compensation on top of auto
+uniform int u_AutoExposure;
+uniform float u_Gamma;
+uniform float u_BloomIntensity; // 0 = off
+uniform vec2 u_BloomUVMax;      // Rendered region of bloom level 0
+
+// Upscaling (dynamic resolution): the scene covers u_UVScale of u_HDRBuffer
+// and is stretched over the output. u_Sharpness in [0, 1] restores some of
+// the detail lost to the bilinear filter; 0 skips the extra taps.
+uniform vec2 u_UVScale;
+uniform float u_Sharpness;
+
+// Must match PostProcessStack::LUTSize
+const float LUTSize = 32.0;
+
+// Bilinear tap kept half a texel inside the rendered region, so nothing
+// bleeds in from the unused part of the buffer
+vec3 SampleScene(vec2 uv) {
+    vec2 halfTexel = 0.5 / vec2(textureSize(u_HDRBuffer, 0));
+    return textureLod(u_HDRBuffer, clamp(uv * u_UVScale, halfTexel, u_UVScale - halfTexel), 0.0).rgb;
+}
+
+// Unsharp mask over the four neighbours one source texel away, clamped to
+// their range so edges don't ring
+vec3 SharpenScene(vec2 uv, vec3 center) {
+    vec2 offset = 1.0 / (vec2(textureSize(u_HDRBuffer, 0)) * u_UVScale);
+    vec3 north = SampleScene(uv + vec2(0.0, offset.y));
+    vec3 south = SampleScene(uv - vec2(0.0, offset.y));
+    vec3 east = SampleScene(uv + vec2(offset.x, 0.0));
+    vec3 west = SampleScene(uv - vec2(offset.x, 0.0));
+
+    vec3 minColor = min(center, min(min(north, south), min(east, west)));
+    vec3 maxColor = max(center, max(max(north, south), max(east, west)));
+    vec3 blurred = (north + south + east + west) * 0.25;
+
+    return clamp(center + (center - blurred) * (2.0 * u_Sharpness), minColor, maxColor);
+}
+
+vec3 SampleBloom(vec2 uv) {
+    vec2 halfTexel = 0.5 / vec2(textureSize(u_Bloom, 0));
+    return textureLod(u_Bloom, clamp(uv * u_BloomUVMax, halfTexel, u_BloomUVMax - halfTexel), 0.0).rgb;
+}
+
+// ACES Filmic Tone Mapping
+vec3 ACESFilm(vec3 x) {
+    float a = 2.51f;
+    float b = 0.03f;
+    float c = 2.43f;
+    float d = 0.59f;
+    float e = 0.14f;
+    return clamp((x * (a * x + b)) / (x * (c * x + d) + e), 0.0, 1.0);
+}
+
+void main() {
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(p, u_OutputSize))) return;
+
+    vec2 uv = (vec2(p) + 0.5) / vec2(u_OutputSize);
+
+    vec3 hdrColor = SampleScene(uv);
+    if (u_Sharpness > 0.0) {
+        hdrColor = SharpenScene(uv, hdrColor);
+    }
+    if (u_BloomIntensity > 0.0) {
+        hdrColor += SampleBloom(uv) * u_BloomIntensity;
+    }
+
+    float exposure = u_Exposure * (u_AutoExposure != 0 ? u_AdaptedExposure : 1.0);
+    vec3 mapped = ACESFilm(hdrColor * exposure);
+    mapped = pow(mapped, vec3(1.0 / u_Gamma));
+
+    // The LUT is indexed by display color; hit texel centers at the ends
+    mapped = textureLod(u_GradingLUT, mapped * ((LUTSize - 1.0) / LUTSize) + 0.5 / LUTSize, 0.0).rgb;
+
+    imageStore(u_Output, p, vec4(mapped, 1.0));
+}
@@ -0,0 +1,163 @@
+#type compute
+#version 450 core
+
+// Temporal AA resolve and upscale, see Engine::TemporalAA.
+//
+// One thread per output pixel. Inputs are read by texel inside the rendered
+// region (u_RenderSize); the history covers the whole output.
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler2D u_Color;      // Lighting buffer
+layout(binding = 1) uniform sampler2D u_Velocity;   // G-Buffer, screen UV moved since last frame
+layout(binding = 2) uniform sampler2D u_Depth;      // G-Buffer
+layout(binding = 3) uniform sampler2D u_History;    // Last resolve
+
+layout(rgba16f, binding = 0) uniform writeonly image2D u_Output;
+
+uniform ivec2 u_RenderSize;
+uniform ivec2 u_OutputSize;
+uniform vec2 u_JitterPixels;        // Texel t sampled the unjittered position t + 0.5 + this
+uniform int u_HistoryValid;
+uniform float u_BlendFactor;
+uniform float u_MotionBlendFactor;
+uniform float u_MotionScale;        // Output pixels of motion for u_MotionBlendFactor
+uniform float u_VarianceClip;
+
+float Luminance(vec3 color) {
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+vec3 RGBToYCoCg(vec3 c) {
+    return vec3(dot(c, vec3(0.25, 0.5, 0.25)),
+                dot(c, vec3(0.5, 0.0, -0.5)),
+                dot(c, vec3(-0.25, 0.5, -0.25)));
+}
+
+vec3 YCoCgToRGB(vec3 c) {
+    return vec3(c.x + c.y - c.z, c.x + c.z, c.x - c.y - c.z);
+}
+
+// Compresses HDR so one very bright sample can't dominate a blend; undone
+// after blending
+vec3 Compress(vec3 color) {
+    return color / (1.0 + Luminance(color));
+}
+
+vec3 Uncompress(vec3 color) {
+    return color / max(1.0 - Luminance(color), 1e-4);
+}
+
+// Bicubic Catmull-Rom in 5 bilinear taps (corners dropped)
+vec3 SampleHistory(vec2 uv) {
+    vec2 size = vec2(u_OutputSize);
+    vec2 position = uv * size;
+    vec2 center = floor(position - 0.5) + 0.5;
+    vec2 f = position - center;
+
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+    vec2 w12 = w1 + w2;
+
+    vec2 tc0 = (center - 1.0) / size;
+    vec2 tc3 = (center + 2.0) / size;
+    vec2 tc12 = (center + w2 / w12) / size;
+
+    vec3 result = texture(u_History, vec2(tc12.x, tc0.y)).rgb * (w12.x * w0.y) +
+                  texture(u_History, vec2(tc0.x, tc12.y)).rgb * (w0.x * w12.y) +
+                  texture(u_History, vec2(tc12.x, tc12.y)).rgb * (w12.x * w12.y) +
+                  texture(u_History, vec2(tc3.x, tc12.y)).rgb * (w3.x * w12.y) +
+                  texture(u_History, vec2(tc12.x, tc3.y)).rgb * (w12.x * w3.y);
+    float weight = w12.x * w0.y + w0.x * w12.y + w12.x * w12.y + w3.x * w12.y + w12.x * w3.y;
+
+    // The negative lobes can ring below zero next to bright edges
+    return max(result / weight, vec3(0.0));
+}
+
+// Pull history toward the box center until it lies inside the box
+vec3 ClipToBox(vec3 history, vec3 boxMin, vec3 boxMax) {
+    vec3 center = 0.5 * (boxMax + boxMin);
+    vec3 extent = max(0.5 * (boxMax - boxMin), vec3(1e-5));
+    vec3 offset = history - center;
+    vec3 units = abs(offset / extent);
+    float maxUnit = max(units.x, max(units.y, units.z));
+    return maxUnit > 1.0 ? center + offset / maxUnit : history;
+}
+
+void main() {
+    ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(pixel, u_OutputSize))) return;
+
+    vec2 uv = (vec2(pixel) + 0.5) / vec2(u_OutputSize);
+
+    // The output pixel center in unjittered input texels, and the texel
+    // whose jittered sample lies nearest to it
+    vec2 inputPosition = uv * vec2(u_RenderSize);
+    ivec2 nearest = ivec2(floor(inputPosition - u_JitterPixels));
+
+    // Reconstruct the current frame at the output pixel and gather the
+    // neighbourhood's moments and nearest surface
+    vec3 current = vec3(0.0);
+    float totalWeight = 0.0;
+    float peakWeight = 0.0;
+    vec3 m1 = vec3(0.0);
+    vec3 m2 = vec3(0.0);
+    float closestDepth = 1.0;
+    ivec2 closestTexel = clamp(nearest, ivec2(0), u_RenderSize - 1);
+
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            ivec2 texel = clamp(nearest + ivec2(x, y), ivec2(0), u_RenderSize - 1);
+            vec3 color = Compress(texelFetch(u_Color, texel, 0).rgb);
+
+            // Gaussian fit of Blackman-Harris over the sample's distance
+            vec2 offset = vec2(texel) + 0.5 + u_JitterPixels - inputPosition;
+            float weight = exp(-2.29 * dot(offset, offset));
+            current += color * weight;
+            totalWeight += weight;
+            peakWeight = max(peakWeight, weight);
+
+            vec3 ycocg = RGBToYCoCg(color);
+            m1 += ycocg;
+            m2 += ycocg * ycocg;
+
+            float depth = texelFetch(u_Depth, texel, 0).r;
+            if (depth < closestDepth) {
+                closestDepth = depth;
+                closestTexel = texel;
+            }
+        }
+    }
+    current /= max(totalWeight, 1e-5);
+
+    // The closest surface's motion keeps edges of moving objects from
+    // reprojecting the background behind them
+    vec2 velocity = texelFetch(u_Velocity, closestTexel, 0).xy;
+    vec2 previousUV = uv - velocity;
+
+    bool offscreen = any(lessThan(previousUV, vec2(0.0))) || any(greaterThan(previousUV, vec2(1.0)));
+    if (u_HistoryValid == 0 || offscreen) {
+        imageStore(u_Output, pixel, vec4(Uncompress(current), 1.0));
+        return;
+    }
+
+    vec3 mean = m1 / 9.0;
+    vec3 sigma = sqrt(max(m2 / 9.0 - mean * mean, vec3(0.0)));
+    vec3 boxMin = mean - u_VarianceClip * sigma;
+    vec3 boxMax = mean + u_VarianceClip * sigma;
+
+    vec3 history = RGBToYCoCg(Compress(SampleHistory(previousUV)));
+    history = YCoCgToRGB(ClipToBox(history, boxMin, boxMax));
+
+    // Trust this frame more where it moves (the history is resampled and
+    // softer) and less where no sample landed close to the pixel, which is
+    // most pixels when upscaling
+    float motion = length(velocity * vec2(u_OutputSize)) / u_MotionScale;
+    float blend = mix(u_BlendFactor, u_MotionBlendFactor, clamp(motion, 0.0, 1.0));
+    blend *= clamp(peakWeight, 0.25, 1.0);
+
+    vec3 result = mix(history, current, blend);
+    imageStore(u_Output, pixel, vec4(Uncompress(result), 1.0));
+}
@@ -1,6 +1,7 @@
 #type vertex
 #version 450 core
 
+// Fed from the mesh's position-only stream (MeshComponent::DepthVAO)
 layout(location = 0) in vec3 a_Position;
 
 uniform mat4 u_LightViewProj;
@@ -0,0 +1,44 @@
+#type vertex
+#version 450 core
+#extension GL_ARB_shader_viewport_layer_array : require
+
+// Single-pass CSM: every instance is one (caster, cascade) pair written by
+// ShadowMapSystem through IndirectDrawBatcher. The cascade index travels in
+// InstanceData::Flags and selects both the matrix and the target layer.
+
+layout(location = 0) in vec3 a_Position;
+
+// Per-instance index (baseInstance + gl_InstanceID), see IndirectDrawBatcher
+layout(location = 8) in uint a_InstanceIndex;
+
+// Must match Engine::InstanceData
+struct InstanceData {
+    mat4 Transform;
+    vec4 Color;
+    vec4 MaterialParams;
+    uint EntityId;
+    uint Flags;             // cascade index
+    uint MaterialIndex;
+    uint Padding;
+};
+
+layout(std430, binding = 4) readonly buffer InstanceBuffer {
+    InstanceData u_Instances[];
+};
+
+uniform mat4 u_CascadeViewProj[4];
+
+void main() {
+    InstanceData instance = u_Instances[a_InstanceIndex];
+    uint cascade = instance.Flags;
+
+    gl_Position = u_CascadeViewProj[cascade] * instance.Transform * vec4(a_Position, 1.0);
+    gl_Layer = int(cascade);
+}
+
+#type fragment
+#version 450 core
+
+void main() {
+    // Depth is written automatically
+}
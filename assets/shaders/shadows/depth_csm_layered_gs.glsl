@@ -0,0 +1,63 @@
+#type vertex
+#version 450 core
+
+// Fallback for depth_csm_layered.glsl on drivers without
+// GL_ARB_shader_viewport_layer_array: the vertex stage can't write gl_Layer,
+// so a pass-through geometry shader routes each triangle instead.
+// Keep the vertex stage in sync with depth_csm_layered.glsl.
+
+layout(location = 0) in vec3 a_Position;
+
+// Per-instance index (baseInstance + gl_InstanceID), see IndirectDrawBatcher
+layout(location = 8) in uint a_InstanceIndex;
+
+// Must match Engine::InstanceData
+struct InstanceData {
+    mat4 Transform;
+    vec4 Color;
+    vec4 MaterialParams;
+    uint EntityId;
+    uint Flags;             // cascade index
+    uint MaterialIndex;
+    uint Padding;
+};
+
+layout(std430, binding = 4) readonly buffer InstanceBuffer {
+    InstanceData u_Instances[];
+};
+
+uniform mat4 u_CascadeViewProj[4];
+
+flat out uint v_Cascade;
+
+void main() {
+    InstanceData instance = u_Instances[a_InstanceIndex];
+    uint cascade = instance.Flags;
+
+    gl_Position = u_CascadeViewProj[cascade] * instance.Transform * vec4(a_Position, 1.0);
+    v_Cascade = cascade;
+}
+
+#type geometry
+#version 450 core
+
+layout(triangles) in;
+layout(triangle_strip, max_vertices = 3) out;
+
+flat in uint v_Cascade[];
+
+void main() {
+    for (int i = 0; i < 3; ++i) {
+        gl_Position = gl_in[i].gl_Position;
+        gl_Layer = int(v_Cascade[0]);
+        EmitVertex();
+    }
+    EndPrimitive();
+}
+
+#type fragment
+#version 450 core
+
+void main() {
+    // Depth is written automatically
+}
@@ -0,0 +1,68 @@
+#type vertex
+#version 450 core
+
+// Single-pass point shadows: every instance is one (caster, cube face) pair
+// written by ShadowMapSystem through IndirectDrawBatcher. InstanceData::Flags
+// indexes the face list, which holds the face's matrix and its atlas tile.
+// The face is rendered into its tile by remapping clip space, and clip
+// distances trim geometry to the face's own frustum so it can't spill into
+// neighbouring tiles. No layered target or geometry shader needed.
+
+layout(location = 0) in vec3 a_Position;
+
+// Per-instance index (baseInstance + gl_InstanceID), see IndirectDrawBatcher
+layout(location = 8) in uint a_InstanceIndex;
+
+// Must match Engine::InstanceData
+struct InstanceData {
+    mat4 Transform;
+    vec4 Color;
+    vec4 MaterialParams;
+    uint EntityId;
+    uint Flags;             // face index
+    uint MaterialIndex;
+    uint Padding;
+};
+
+layout(std430, binding = 4) readonly buffer InstanceBuffer {
+    InstanceData u_Instances[];
+};
+
+// Must match Engine::GPUPointShadowFace
+struct PointShadowFace {
+    mat4 viewProjection;
+    vec4 atlasScaleOffset;  // xy=scale, zw=offset in atlas UV
+};
+
+layout(std430, binding = 10) readonly buffer PointShadowFaceBuffer {
+    PointShadowFace u_Faces[];
+};
+
+out float gl_ClipDistance[4];
+
+void main() {
+    InstanceData instance = u_Instances[a_InstanceIndex];
+    PointShadowFace face = u_Faces[instance.Flags];
+
+    vec4 clipPos = face.viewProjection * instance.Transform * vec4(a_Position, 1.0);
+
+    // Keep the face's [-w, w] square
+    gl_ClipDistance[0] = clipPos.w - clipPos.x;
+    gl_ClipDistance[1] = clipPos.w + clipPos.x;
+    gl_ClipDistance[2] = clipPos.w - clipPos.y;
+    gl_ClipDistance[3] = clipPos.w + clipPos.y;
+
+    // Face NDC -> atlas NDC: ndc * scale + (2 * offset - 1 + scale)
+    vec2 scale = face.atlasScaleOffset.xy;
+    vec2 offset = face.atlasScaleOffset.zw * 2.0 - 1.0 + scale;
+    clipPos.xy = clipPos.xy * scale + offset * clipPos.w;
+
+    gl_Position = clipPos;
+}
+
+#type fragment
+#version 450 core
+
+void main() {
+    // Depth is written automatically
+}
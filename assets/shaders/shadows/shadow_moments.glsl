@@ -0,0 +1,88 @@
+#type compute
+#version 450 core
+
+// Exponential variance shadow map filter, see Engine::ShadowMomentMaps.
+//
+// Two dispatches per region. Pass 0 warps the depth map into EVSM moments
+// (positive and negative exponential, each with its square), averaging the
+// 2x2 depth texels under every moment texel, and blurs them horizontally
+// into the scratch image at region-local coordinates. Pass 1 blurs the
+// scratch vertically into the region of the moment map. Taps are clamped to
+// the region so atlas tiles never bleed into their neighbours.
+//
+// Variants: DEPTH_ARRAY reads one layer of a 2D array (the cascades).
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+#ifdef DEPTH_ARRAY
+layout(binding = 0) uniform sampler2DArray u_Depth;
+uniform int u_DepthLayer;
+#else
+layout(binding = 0) uniform sampler2D u_Depth;
+#endif
+layout(binding = 1) uniform sampler2D u_Scratch;
+
+layout(rgba32f, binding = 0) uniform writeonly image2D u_Output;
+
+// Must match ShadowMomentMaps::MaxBlurRadius
+#define MAX_BLUR_RADIUS 4
+
+uniform int u_Pass;                 // 0 = warp + horizontal, 1 = vertical
+uniform ivec2 u_RegionOffset;       // Moment texels, in the moment map
+uniform int u_RegionSize;           // Moment texels, square
+uniform int u_BlurRadius;
+uniform vec2 u_Exponents;           // Positive, negative
+
+// Same warp as the lighting pass
+vec2 WarpDepth(float depth) {
+    depth = 2.0 * depth - 1.0;
+    return vec2(exp(u_Exponents.x * depth), -exp(-u_Exponents.y * depth));
+}
+
+vec4 FetchDepthMoments(ivec2 local) {
+    ivec2 base = (u_RegionOffset + clamp(local, ivec2(0), ivec2(u_RegionSize - 1))) * 2;
+
+    vec4 moments = vec4(0.0);
+    for (int i = 0; i < 4; i++) {
+        ivec2 p = base + ivec2(i & 1, i >> 1);
+#ifdef DEPTH_ARRAY
+        float depth = texelFetch(u_Depth, ivec3(p, u_DepthLayer), 0).r;
+#else
+        float depth = texelFetch(u_Depth, p, 0).r;
+#endif
+        vec2 warped = WarpDepth(depth);
+        moments += vec4(warped.x, warped.x * warped.x, warped.y, warped.y * warped.y);
+    }
+    return moments * 0.25;
+}
+
+vec4 FetchScratch(ivec2 local) {
+    return texelFetch(u_Scratch, clamp(local, ivec2(0), ivec2(u_RegionSize - 1)), 0);
+}
+
+void main() {
+    ivec2 local = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(local, ivec2(u_RegionSize)))) return;
+
+    // Gaussian with the kernel edge at ~2 sigma
+    float sigma = max(float(u_BlurRadius) * 0.5, 0.5);
+    ivec2 axis = u_Pass == 0 ? ivec2(1, 0) : ivec2(0, 1);
+
+    vec4 sum = vec4(0.0);
+    float weightSum = 0.0;
+    for (int k = -MAX_BLUR_RADIUS; k <= MAX_BLUR_RADIUS; k++) {
+        if (abs(k) > u_BlurRadius) continue;
+
+        float weight = exp(-float(k * k) / (2.0 * sigma * sigma));
+        ivec2 tap = local + axis * k;
+        sum += weight * (u_Pass == 0 ? FetchDepthMoments(tap) : FetchScratch(tap));
+        weightSum += weight;
+    }
+    sum /= weightSum;
+
+    if (u_Pass == 0) {
+        imageStore(u_Output, local, sum);
+    } else {
+        imageStore(u_Output, u_RegionOffset + local, sum);
+    }
+}
@@ -0,0 +1,57 @@
+#type compute
+#version 450 core
+
+// Page requests of the virtual shadow map, see Engine::VirtualShadowMap.
+//
+// One thread per depth texel of the main view: the surface is projected into
+// the map and the pages under the corners of its PCF footprint get their
+// bit set. Sky texels request nothing.
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler2D u_Depth;
+
+// Must match VirtualShadowMap::RequestBinding; cleared before the dispatch
+layout(std430, binding = 0) buffer PageRequests {
+    uint u_RequestBits[];
+};
+
+uniform ivec2 u_DepthSize;          // Rendered viewport
+uniform mat4 u_InvViewProjection;
+uniform mat4 u_ShadowViewProjection;
+uniform ivec2 u_PageCount;
+uniform float u_FilterRadius;       // PCF footprint, in shadow map UV
+
+void RequestPage(vec2 uv) {
+    ivec2 page = clamp(ivec2(uv * vec2(u_PageCount)), ivec2(0), u_PageCount - 1);
+    uint index = uint(page.y * u_PageCount.x + page.x);
+    uint bit = 1u << (index & 31u);
+
+    // Neighbouring texels mostly hit the same page: skip the atomic then
+    if ((u_RequestBits[index >> 5u] & bit) == 0u) {
+        atomicOr(u_RequestBits[index >> 5u], bit);
+    }
+}
+
+void main() {
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(p, u_DepthSize))) return;
+
+    float depth = texelFetch(u_Depth, p, 0).r;
+    if (depth >= 1.0) return;
+
+    vec2 ndc = (vec2(p) + 0.5) / vec2(u_DepthSize) * 2.0 - 1.0;
+    vec4 world = u_InvViewProjection * vec4(ndc, depth * 2.0 - 1.0, 1.0);
+    world /= world.w;
+
+    vec3 shadow = (u_ShadowViewProjection * world).xyz * 0.5 + 0.5;
+    if (any(lessThan(shadow.xy, vec2(-u_FilterRadius))) ||
+        any(greaterThan(shadow.xy, vec2(1.0 + u_FilterRadius)))) {
+        return;
+    }
+
+    RequestPage(shadow.xy + vec2(-u_FilterRadius, -u_FilterRadius));
+    RequestPage(shadow.xy + vec2( u_FilterRadius, -u_FilterRadius));
+    RequestPage(shadow.xy + vec2(-u_FilterRadius,  u_FilterRadius));
+    RequestPage(shadow.xy + vec2( u_FilterRadius,  u_FilterRadius));
+}
@@ -0,0 +1,139 @@
+// ECS micro-benchmarks: hierarchy reparenting at depth, and EnTT view vs
+// group iteration over the component sets the renderer walks. Part of
+// MicroBenchmarks (Google Benchmark).
+
+#include "ecs/Components/Transform.hpp"
+#include "ecs/Components/Renderable.hpp"
+#include "ecs/Components/Hierarchy.hpp"
+#include "renderer/RenderGroups.hpp"
+
+#include <benchmark/benchmark.h>
+#include <entt/entt.hpp>
+
+using namespace Engine;
+
+namespace {
+
+// Reparent a subtree whose leaf sits range(0) levels down: SetParent
+// walks the subtree to update depths
+void BM_HierarchySetParent(benchmark::State& state) {
+    const u32 depth = static_cast<u32>(state.range(0));
+
+    entt::registry registry;
+    const entt::entity rootA = registry.create();
+    const entt::entity rootB = registry.create();
+    registry.emplace<Hierarchy>(rootA);
+    registry.emplace<Hierarchy>(rootB);
+
+    const entt::entity top = registry.create();
+    HierarchyUtils::SetParent(registry, top, rootA);
+    entt::entity parent = top;
+    for (u32 i = 1; i < depth; ++i) {
+        const entt::entity child = registry.create();
+        HierarchyUtils::SetParent(registry, child, parent);
+        parent = child;
+    }
+
+    bool underA = true;
+    for (auto _ : state) {
+        HierarchyUtils::SetParent(registry, top, underA ? rootB : rootA);
+        underA = !underA;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HierarchySetParent)->RangeMultiplier(8)->Range(1, 512);
+
+// Registry shaped like a scene: every entity has a Transform, most are
+// drawn, lights and empties are not
+void Populate(entt::registry& registry, usize count) {
+    for (usize i = 0; i < count; ++i) {
+        const entt::entity entity = registry.create();
+        auto& transform = registry.emplace<Transform>(entity);
+        transform.SetPosition(static_cast<f32>(i % 1000), 0.0f, static_cast<f32>(i / 1000));
+        transform.UpdateWorldMatrix();
+
+        if (i % 8 != 0) {
+            registry.emplace<MeshComponent>(entity);
+            registry.emplace<MaterialComponent>(entity);
+            registry.emplace<Renderable>(entity);
+        }
+    }
+}
+
+// What the geometry gather does per entity, enough to touch every component
+template<typename Each>
+f32 Gather(Each&& each) {
+    f32 sum = 0.0f;
+    each([&sum](const Transform& transform, const MeshComponent& mesh,
+                const MaterialComponent& material, const Renderable& renderable) {
+        if (renderable.Visible && renderable.InFrustum) {
+            sum += transform.WorldMatrix[3].x + material.BaseColor.r + static_cast<f32>(mesh.MeshId);
+        }
+    });
+    return sum;
+}
+
+void BM_ECSViewIteration(benchmark::State& state) {
+    entt::registry registry;
+    Populate(registry, static_cast<usize>(state.range(0)));
+    auto view = registry.view<Transform, MeshComponent, MaterialComponent, Renderable>();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Gather([&](auto&& fn) { view.each(fn); }));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ECSViewIteration)->RangeMultiplier(10)->Range(1000, 1000000);
+
+// Owning group: the four storages are packed in the same order
+void BM_ECSOwningGroupIteration(benchmark::State& state) {
+    entt::registry registry;
+    auto group = registry.group<Transform, MeshComponent, MaterialComponent, Renderable>();
+    Populate(registry, static_cast<usize>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Gather([&](auto&& fn) { group.each(fn); }));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ECSOwningGroupIteration)->RangeMultiplier(10)->Range(1000, 1000000);
+
+// Partial-owning group: Transform stays free for other groups / systems
+void BM_ECSPartialGroupIteration(benchmark::State& state) {
+    entt::registry registry;
+    auto group = registry.group<MeshComponent, MaterialComponent, Renderable>(entt::get<Transform>);
+    Populate(registry, static_cast<usize>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Gather([&](auto&& fn) {
+            group.each([&fn](const MeshComponent& mesh, const MaterialComponent& material,
+                             const Renderable& renderable, const Transform& transform) {
+                fn(transform, mesh, material, renderable);
+            });
+        }));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ECSPartialGroupIteration)->RangeMultiplier(10)->Range(1000, 1000000);
+
+// The group the renderer registers (RenderableGroup): the material is
+// looked up, the rest streams from the group
+void BM_ECSRenderableGroupIteration(benchmark::State& state) {
+    entt::registry registry;
+    auto group = RenderableGroup(registry);
+    Populate(registry, static_cast<usize>(state.range(0)));
+    const auto& materials = registry.storage<MaterialComponent>();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Gather([&](auto&& fn) {
+            group.each([&](entt::entity entity, const MeshComponent& mesh, const Renderable& renderable,
+                           const Transform& transform) {
+                if (materials.contains(entity)) fn(transform, mesh, materials.get(entity), renderable);
+            });
+        }));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ECSRenderableGroupIteration)->RangeMultiplier(10)->Range(1000, 1000000);
+
+} // anonymous namespace
@@ -0,0 +1,209 @@
+// Math and culling micro-benchmarks: frustum extraction and tests, AABB
+// transform, ray / AABB intersection, TRS matrices and the SIMD sphere
+// culling kernels. Part of MicroBenchmarks (Google Benchmark).
+
+#include "math/Frustum.hpp"
+#include "math/Ray.hpp"
+#include "math/CullingKernels.hpp"
+#include "ecs/Components/Transform.hpp"
+
+#include <benchmark/benchmark.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+using namespace Engine;
+
+namespace {
+
+constexpr usize SetSize = 4096;     // Inputs cycled through, fits in L2
+
+glm::mat4 MakeViewProjection() {
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 20.0f, 60.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    return projection * view;
+}
+
+Frustum MakeFrustum() {
+    Frustum frustum;
+    frustum.ExtractPlanes(MakeViewProjection());
+    return frustum;
+}
+
+// Boxes and spheres around the camera, about half of them visible
+Vector<AABB> MakeBoxes(usize count) {
+    std::mt19937 rng(1337);
+    std::uniform_real_distribution<f32> position(-200.0f, 200.0f);
+    std::uniform_real_distribution<f32> extent(0.5f, 4.0f);
+
+    Vector<AABB> boxes(count);
+    for (auto& box : boxes) {
+        const glm::vec3 center(position(rng), position(rng) * 0.25f, position(rng));
+        const glm::vec3 half(extent(rng), extent(rng), extent(rng));
+        box = AABB(center - half, center + half);
+    }
+    return boxes;
+}
+
+Vector<glm::mat4> MakeMatrices(usize count) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<f32> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<f32> angle(-3.14159f, 3.14159f);
+    std::uniform_real_distribution<f32> scale(0.5f, 2.0f);
+
+    Vector<glm::mat4> matrices(count);
+    for (auto& matrix : matrices) {
+        Transform t;
+        t.Position = glm::vec3(position(rng), position(rng), position(rng));
+        t.Rotation = glm::normalize(glm::quat(glm::vec3(angle(rng), angle(rng), angle(rng))));
+        t.Scale = glm::vec3(scale(rng), scale(rng), scale(rng));
+        matrix = t.GetLocalMatrix();
+    }
+    return matrices;
+}
+
+void BM_FrustumExtractPlanes(benchmark::State& state) {
+    glm::mat4 viewProjection = MakeViewProjection();
+    Frustum frustum;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(viewProjection);
+        frustum.ExtractPlanes(viewProjection);
+        benchmark::DoNotOptimize(frustum);
+    }
+}
+BENCHMARK(BM_FrustumExtractPlanes);
+
+void BM_FrustumSphereVisible(benchmark::State& state) {
+    const Frustum frustum = MakeFrustum();
+    const auto boxes = MakeBoxes(SetSize);
+    Vector<BoundingSphere> spheres;
+    for (const auto& box : boxes) {
+        spheres.push_back(BoundingSphere::FromAABB(box));
+    }
+
+    usize i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(frustum.IsSphereVisible(spheres[i]));
+        i = (i + 1) & (SetSize - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FrustumSphereVisible);
+
+void BM_FrustumBoxVisible(benchmark::State& state) {
+    const Frustum frustum = MakeFrustum();
+    const auto boxes = MakeBoxes(SetSize);
+
+    usize i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(frustum.IsBoxVisible(boxes[i]));
+        i = (i + 1) & (SetSize - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FrustumBoxVisible);
+
+void BM_FrustumClassifyBox(benchmark::State& state) {
+    const Frustum frustum = MakeFrustum();
+    const auto boxes = MakeBoxes(SetSize);
+
+    usize i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(frustum.ClassifyBox(boxes[i]));
+        i = (i + 1) & (SetSize - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FrustumClassifyBox);
+
+// Whole batches through the SoA kernels; the argument is the SimdLevel
+void BM_CullingKernelsTestSpheres(benchmark::State& state) {
+    const auto level = static_cast<SimdLevel>(state.range(0));
+    if (!CPUFeatures::IsSupported(level)) {
+        state.SkipWithError("SIMD level not supported on this CPU");
+        return;
+    }
+
+    const usize count = static_cast<usize>(state.range(1));
+    const Frustum frustum = MakeFrustum();
+    const auto boxes = MakeBoxes(count);
+    Vector<f32> x(count), y(count), z(count), radius(count);
+    for (usize i = 0; i < count; ++i) {
+        const auto sphere = BoundingSphere::FromAABB(boxes[i]);
+        x[i] = sphere.Center.x;
+        y[i] = sphere.Center.y;
+        z[i] = sphere.Center.z;
+        radius[i] = sphere.Radius;
+    }
+    Vector<u8> visible(count);
+    const SphereStreams streams{x.data(), y.data(), z.data(), radius.data()};
+
+    const SimdLevel previous = CullingKernels::GetSimdLevel();
+    CullingKernels::SetSimdLevel(level);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CullingKernels::TestSpheres(frustum, streams, visible.data(), count));
+        benchmark::ClobberMemory();
+    }
+    CullingKernels::SetSimdLevel(previous);
+
+    state.SetItemsProcessed(state.iterations() * static_cast<i64>(count));
+    state.SetLabel(SimdLevelToString(level));
+}
+BENCHMARK(BM_CullingKernelsTestSpheres)
+    ->ArgsProduct({{static_cast<i64>(SimdLevel::Scalar), static_cast<i64>(SimdLevel::SSE2),
+                    static_cast<i64>(SimdLevel::AVX2), static_cast<i64>(SimdLevel::NEON)},
+                   {1024, 65536}});
+
+void BM_AABBTransform(benchmark::State& state) {
+    const auto boxes = MakeBoxes(SetSize);
+    const auto matrices = MakeMatrices(SetSize);
+
+    usize i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(boxes[i].Transform(matrices[i]));
+        i = (i + 1) & (SetSize - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AABBTransform);
+
+void BM_RayIntersectsAABB(benchmark::State& state) {
+    const auto boxes = MakeBoxes(SetSize);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<f32> direction(-1.0f, 1.0f);
+    Vector<Ray> rays;
+    for (usize i = 0; i < SetSize; ++i) {
+        rays.emplace_back(glm::vec3(0.0f, 10.0f, 0.0f),
+                          glm::vec3(direction(rng), direction(rng) * 0.2f - 0.05f, direction(rng)));
+    }
+
+    usize i = 0;
+    for (auto _ : state) {
+        f32 distance = 0.0f;
+        benchmark::DoNotOptimize(rays[i].IntersectsAABB(boxes[(i * 7) & (SetSize - 1)], distance));
+        benchmark::DoNotOptimize(distance);
+        i = (i + 1) & (SetSize - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RayIntersectsAABB);
+
+void BM_TransformGetLocalMatrix(benchmark::State& state) {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<f32> value(-1.0f, 1.0f);
+    Vector<Transform> transforms(SetSize);
+    for (auto& t : transforms) {
+        t.Position = glm::vec3(value(rng), value(rng), value(rng)) * 100.0f;
+        t.Rotation = glm::normalize(glm::quat(value(rng), value(rng), value(rng), value(rng)));
+        t.Scale = glm::vec3(1.0f + value(rng) * 0.5f);
+    }
+
+    usize i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(transforms[i].GetLocalMatrix());
+        i = (i + 1) & (SetSize - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TransformGetLocalMatrix);
+
+} // anonymous namespace
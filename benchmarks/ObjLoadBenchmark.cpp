@@ -0,0 +1,114 @@
+// ObjLoadBenchmark - times MeshLoader::LoadOBJ (parse, deduplication,
+// tangents) on one thread and with the job system's parallel chunk parse.
+//
+// Usage: ObjLoadBenchmark [iterations] [file.obj ...]
+// Without files a synthetic grid of about 2M triangles is written to the
+// working directory and used as the corpus.
+
+#include "resources/loaders/MeshLoader.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+
+using namespace Engine;
+
+namespace {
+
+// size x size quads on a wavy plane, with normals and UVs (v/vt/vn corners)
+String WriteGridOBJ(u32 size) {
+    const String path = "ObjLoadBenchmark_grid.obj";
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) return String();
+
+    const u32 side = size + 1;
+    for (u32 y = 0; y < side; ++y) {
+        for (u32 x = 0; x < side; ++x) {
+            std::fprintf(file, "v %.6f %.6f %.6f\n", x * 0.1f, std::sin(x * 0.05f) * std::cos(y * 0.05f), y * 0.1f);
+        }
+    }
+    for (u32 y = 0; y < side; ++y) {
+        for (u32 x = 0; x < side; ++x) {
+            std::fprintf(file, "vt %.6f %.6f\n", static_cast<f32>(x) / size, static_cast<f32>(y) / size);
+        }
+    }
+    std::fprintf(file, "vn 0 1 0\n");
+
+    for (u32 y = 0; y < size; ++y) {
+        for (u32 x = 0; x < size; ++x) {
+            const u32 a = y * side + x + 1;
+            const u32 b = a + 1;
+            const u32 c = a + side + 1;
+            const u32 d = a + side;
+            std::fprintf(file, "f %u/%u/1 %u/%u/1 %u/%u/1 %u/%u/1\n", a, a, b, b, c, c, d, d);
+        }
+    }
+
+    std::fclose(file);
+    return path;
+}
+
+template<typename Func>
+f64 MeasureBest(u32 iterations, Func&& func) {
+    f64 best = 1e30;
+    for (u32 i = 0; i < iterations; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        func();
+        auto end = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<f64, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Logger::Init();
+    Logger::GetCoreLogger()->set_level(spdlog::level::warn);
+
+    const u32 iterations = argc > 1 ? static_cast<u32>(std::strtoul(argv[1], nullptr, 10)) : 5;
+
+    Vector<String> corpus;
+    for (int i = 2; i < argc; ++i) {
+        corpus.push_back(argv[i]);
+    }
+    if (corpus.empty()) {
+        String grid = WriteGridOBJ(1000);
+        if (grid.empty()) {
+            std::printf("Failed to write the synthetic grid\n");
+            return 1;
+        }
+        corpus.push_back(grid);
+    }
+
+    MeshLoadOptions options;
+    std::printf("OBJ load: best of %u runs\n\n", iterations);
+    std::printf("  %-32s %9s %9s %11s %11s\n", "file", "MB", "triangles", "1 thread", "job system");
+
+    for (const auto& path : corpus) {
+        const f64 megabytes = std::filesystem::file_size(path) / (1024.0 * 1024.0);
+        u32 triangles = 0;
+
+        f64 serialMs = MeasureBest(iterations, [&] {
+            auto mesh = MeshLoader::LoadOBJ(path, options);
+            triangles = mesh ? mesh->GetIndexCount() / 3 : 0;
+        });
+
+        JobSystem::Init();
+        f64 parallelMs = MeasureBest(iterations, [&] {
+            auto mesh = MeshLoader::LoadOBJ(path, options);
+        });
+        JobSystem::Shutdown();
+
+        String name = std::filesystem::path(path).filename().string();
+        std::printf("  %-32s %9.1f %9u %8.1f ms %8.1f ms\n",
+                    name.c_str(), megabytes, triangles, serialMs, parallelMs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+// RenderQueue micro-benchmarks: key building + radix sort, and submission.
+// Commands carry no shader or vertex array, so no GL context is needed;
+// the material id and depth spread the keys. Part of MicroBenchmarks
+// (Google Benchmark).
+
+#include "renderer/RenderQueue.hpp"
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+using namespace Engine;
+
+namespace {
+
+Vector<RenderCommand> MakeCommands(usize count) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<u32> material(0, 255);
+    std::uniform_real_distribution<f32> depth(0.1f, 1000.0f);
+    std::uniform_int_distribution<u32> translucent(0, 9);
+
+    Vector<RenderCommand> commands(count);
+    for (auto& command : commands) {
+        command.MaterialId = material(rng);
+        command.Depth = depth(rng);
+        command.Translucent = translucent(rng) == 0;
+        command.IndexCount = 36;
+    }
+    return commands;
+}
+
+// Sort() rebuilds every key from the merged commands, so it can be
+// repeated on one submission
+void BM_RenderQueueSort(benchmark::State& state) {
+    const usize count = static_cast<usize>(state.range(0));
+    RenderQueue queue;
+    for (const auto& command : MakeCommands(count)) {
+        queue.Submit(command);
+    }
+
+    for (auto _ : state) {
+        queue.Sort();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RenderQueueSort)->RangeMultiplier(8)->Range(512, 262144);
+
+void BM_RenderQueueSubmit(benchmark::State& state) {
+    const usize count = static_cast<usize>(state.range(0));
+    const auto commands = MakeCommands(count);
+    RenderQueue queue;
+
+    for (auto _ : state) {
+        queue.Clear();
+        for (const auto& command : commands) {
+            queue.Submit(command);
+        }
+        benchmark::DoNotOptimize(queue.GetCommandCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RenderQueueSubmit)->RangeMultiplier(8)->Range(512, 262144);
+
+} // anonymous namespace
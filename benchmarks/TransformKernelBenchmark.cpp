@@ -0,0 +1,119 @@
+// TransformKernelBenchmark - compares the SIMD TRS composition kernels with
+// the scalar glm path (translate * mat4_cast * scale).
+//
+// Usage: TransformKernelBenchmark [transformCount] [iterations]
+
+#include "math/TransformKernels.hpp"
+#include "core/CPUFeatures.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace Engine;
+
+namespace {
+
+struct StreamData {
+    Vector<f32> Streams[10];
+
+    explicit StreamData(usize count) {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<f32> position(-100.0f, 100.0f);
+        std::uniform_real_distribution<f32> angle(-3.14159f, 3.14159f);
+        std::uniform_real_distribution<f32> scale(0.5f, 2.0f);
+
+        for (auto& stream : Streams) {
+            stream.resize(count);
+        }
+
+        for (usize i = 0; i < count; ++i) {
+            glm::quat rotation = glm::normalize(glm::quat(glm::vec3(angle(rng), angle(rng), angle(rng))));
+
+            Streams[0][i] = position(rng);
+            Streams[1][i] = position(rng);
+            Streams[2][i] = position(rng);
+            Streams[3][i] = rotation.x;
+            Streams[4][i] = rotation.y;
+            Streams[5][i] = rotation.z;
+            Streams[6][i] = rotation.w;
+            Streams[7][i] = scale(rng);
+            Streams[8][i] = scale(rng);
+            Streams[9][i] = scale(rng);
+        }
+    }
+
+    TRSStreams View() const {
+        return TRSStreams{Streams[0].data(), Streams[1].data(), Streams[2].data(),
+                          Streams[3].data(), Streams[4].data(), Streams[5].data(), Streams[6].data(),
+                          Streams[7].data(), Streams[8].data(), Streams[9].data()};
+    }
+};
+
+template<typename Func>
+f64 MeasureBest(u32 iterations, Func&& func) {
+    f64 best = 1e30;
+    for (u32 i = 0; i < iterations; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        func();
+        auto end = std::chrono::high_resolution_clock::now();
+        best = std::min(best, std::chrono::duration<f64, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+f32 MaxError(const Vector<glm::mat4>& a, const Vector<glm::mat4>& b) {
+    f32 error = 0.0f;
+    for (usize i = 0; i < a.size(); ++i) {
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                error = std::max(error, std::abs(a[i][c][r] - b[i][c][r]));
+            }
+        }
+    }
+    return error;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    const usize count = argc > 1 ? static_cast<usize>(std::strtoul(argv[1], nullptr, 10)) : 100000;
+    const u32 iterations = argc > 2 ? static_cast<u32>(std::strtoul(argv[2], nullptr, 10)) : 50;
+
+    StreamData data(count);
+    TRSStreams streams = data.View();
+
+    Vector<glm::mat4> reference(count), results(count);
+    Vector<glm::mat4*> referenceOutputs(count), resultOutputs(count);
+    for (usize i = 0; i < count; ++i) {
+        referenceOutputs[i] = &reference[i];
+        resultOutputs[i] = &results[i];
+    }
+
+    std::printf("TRS composition: %zu transforms, best of %u runs\n", count, iterations);
+    std::printf("Best SIMD level: %s\n\n", SimdLevelToString(CPUFeatures::GetBestSimdLevel()));
+
+    f64 scalarMs = MeasureBest(iterations, [&] {
+        TransformKernels::ComposeTRSScalar(streams, referenceOutputs.data(), count);
+    });
+    std::printf("  %-8s %9.3f ms  %7.2f ns/transform\n", "glm", scalarMs, scalarMs * 1e6 / count);
+
+    for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON}) {
+        if (!TransformKernels::IsSimdLevelSupported(level)) continue;
+
+        TransformKernels::SetSimdLevel(level);
+        f64 ms = MeasureBest(iterations, [&] {
+            TransformKernels::ComposeTRS(streams, resultOutputs.data(), count);
+        });
+
+        std::printf("  %-8s %9.3f ms  %7.2f ns/transform  %5.2fx  max error %.2e\n",
+                    SimdLevelToString(level), ms, ms * 1e6 / count, scalarMs / ms,
+                    MaxError(reference, results));
+    }
+
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include "core/Input.hpp"
 #include "core/InputBindings.hpp"
 #include "core/Time.hpp"
+#include "core/FrameRecorder.hpp"
 
 // Events
 #include "events/Event.hpp"
@@ -24,14 +25,33 @@
 #include "renderer/opengl/GLShader.hpp"
 #include "renderer/RenderCommand.hpp"
 #include "renderer/RenderQueue.hpp"
+#include "renderer/FramePacket.hpp"
+#include "renderer/RenderThread.hpp"
+#include "renderer/rhi/CommandList.hpp"
+#include "renderer/rhi/RenderDevice.hpp"
 #include "renderer/BatchRenderer.hpp"
+#include "renderer/RenderGroups.hpp"
+#include "renderer/debug/DebugDraw.hpp"
 #include "renderer/Texture.hpp"
 #include "renderer/Mesh.hpp"
 #include "renderer/pipeline/Framebuffer.hpp"
 #include "renderer/pipeline/GBuffer.hpp"
+#include "renderer/pipeline/PostProcessStack.hpp"
+#include "renderer/pipeline/TemporalAA.hpp"
 #include "renderer/lighting/DeferredLightingSystem.hpp"
+#include "renderer/scatter/ScatterRenderer.hpp"
+#include "renderer/impostor/ImpostorLibrary.hpp"
+#include "renderer/terrain/TerrainRenderer.hpp"
 #include "renderer/shadows/ShadowMapSystem.hpp"
 
+// Animation
+#include "animation/Skeleton.hpp"
+#include "animation/AnimationClip.hpp"
+#include "animation/AnimationSystem.hpp"
+#include "ecs/Components/Animation.hpp"
+#include "renderer/SkinnedMesh.hpp"
+#include "renderer/SkinningSystem.hpp"
+
 // Light Components
 #include "ecs/Components/LightComponents.hpp"
 
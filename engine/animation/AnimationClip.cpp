@@ -0,0 +1,34 @@
+#include "AnimationClip.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+AnimationClip::AnimationClip(const String& name, u32 jointCount, u32 frameCount, f32 sampleRate)
+    : m_Name(name)
+    , m_JointCount(jointCount)
+    , m_FrameCount(std::max(frameCount, 1u))
+    , m_SampleRate(sampleRate > 0.0f ? sampleRate : 30.0f)
+    , m_Frames(static_cast<usize>(jointCount) * m_FrameCount) {
+}
+
+f32 AnimationClip::ResolveTime(f32 time, bool loop) const {
+    const f32 duration = GetDuration();
+    if (duration <= 0.0f) return 0.0f;
+
+    if (loop) {
+        time = std::fmod(time, duration);
+        return time < 0.0f ? time + duration : time;
+    }
+    return std::clamp(time, 0.0f, duration);
+}
+
+void AnimationClip::Sample(f32 time, bool loop, JointTransform* pose) const {
+    const f32 position = ResolveTime(time, loop) * m_SampleRate;
+    const u32 frame = std::min(static_cast<u32>(position), m_FrameCount - 1);
+    const u32 next = std::min(frame + 1, m_FrameCount - 1);
+
+    PoseKernels::Blend(GetFrame(frame), GetFrame(next), position - static_cast<f32>(frame), pose, m_JointCount);
+}
+
+} // namespace Engine
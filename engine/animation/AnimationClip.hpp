@@ -0,0 +1,44 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "animation/PoseKernels.hpp"
+
+namespace Engine {
+
+// AnimationClip - joint poses sampled at a fixed rate.
+//
+// Keys are resampled to uniform frames when the clip is built, so sampling
+// is two frame lookups and one PoseKernels::Blend rather than a key search
+// per joint and channel. Frames are stored frame-major: GetFrame(f) is the
+// whole pose at time f / sample rate.
+class AnimationClip {
+public:
+    // frameCount poses of jointCount joints, every joint at identity
+    AnimationClip(const String& name, u32 jointCount, u32 frameCount, f32 sampleRate);
+
+    JointTransform* GetFrame(u32 frame) { return &m_Frames[static_cast<usize>(frame) * m_JointCount]; }
+    const JointTransform* GetFrame(u32 frame) const { return &m_Frames[static_cast<usize>(frame) * m_JointCount]; }
+
+    // The pose at time, between the two frames around it: wrapped into the
+    // clip when looping, clamped to it otherwise. A looping clip's last
+    // frame should repeat its first.
+    void Sample(f32 time, bool loop, JointTransform* pose) const;
+
+    // Wrapped or clamped as Sample would
+    f32 ResolveTime(f32 time, bool loop) const;
+
+    const String& GetName() const { return m_Name; }
+    u32 GetJointCount() const { return m_JointCount; }
+    u32 GetFrameCount() const { return m_FrameCount; }
+    f32 GetSampleRate() const { return m_SampleRate; }
+    f32 GetDuration() const { return m_FrameCount > 1 ? static_cast<f32>(m_FrameCount - 1) / m_SampleRate : 0.0f; }
+
+private:
+    String m_Name;
+    u32 m_JointCount = 0;
+    u32 m_FrameCount = 0;
+    f32 m_SampleRate = 30.0f;
+    Vector<JointTransform> m_Frames;
+};
+
+} // namespace Engine
@@ -0,0 +1,120 @@
+#include "animation/AnimationSystem.hpp"
+#include "animation/AnimationClip.hpp"
+#include "animation/Skeleton.hpp"
+#include "renderer/SkinnedMesh.hpp"
+#include "core/FrameAllocator.hpp"
+#include "core/JobSystem.hpp"
+#include <algorithm>
+#include <atomic>
+
+namespace Engine {
+
+namespace {
+
+// Union of each moving joint's sphere, radius scaled by the joint's largest
+// axis scale; empty (false) when no joint moves a vertex
+bool ComputeSkinnedBounds(const glm::mat4* models, const Vector<f32>& radii, AABB& bounds) {
+    bool any = false;
+    for (usize joint = 0; joint < radii.size(); ++joint) {
+        if (radii[joint] < 0.0f) continue;
+
+        const glm::mat4& model = models[joint];
+        const f32 scale = std::max({glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])),
+                                    glm::length(glm::vec3(model[2]))});
+        const glm::vec3 center(model[3]);
+        const glm::vec3 extents(radii[joint] * scale);
+
+        const AABB sphere(center - extents, center + extents);
+        if (any) {
+            bounds.ExpandToInclude(sphere);
+        } else {
+            bounds = sphere;
+            any = true;
+        }
+    }
+    return any;
+}
+
+} // anonymous namespace
+
+void AnimationSystem::OnUpdate(entt::registry& registry, f32 deltaTime) {
+    m_Entities.clear();
+    for (auto entity : registry.view<AnimatorComponent>()) {
+        m_Entities.push_back(entity);
+    }
+
+    auto& animators = registry.storage<AnimatorComponent>();
+    auto& skinned = registry.storage<SkinnedMeshComponent>();
+    auto& meshes = registry.storage<MeshComponent>();
+
+    std::atomic<u32> posed{0};
+    std::atomic<u32> joints{0};
+    std::atomic<u32> blended{0};
+
+    JobSystem::ParallelFor(static_cast<u32>(m_Entities.size()), Grain, [&](u32 first, u32 last) {
+        // Reused by every animator of the chunk
+        FrameVector<JointTransform> pose;
+        FrameVector<JointTransform> blendPose;
+        FrameVector<glm::mat4> models;
+        u32 chunkPosed = 0;
+        u32 chunkJoints = 0;
+        u32 chunkBlended = 0;
+
+        for (u32 i = first; i < last; ++i) {
+            const entt::entity entity = m_Entities[i];
+            AnimatorComponent& animator = animators.get(entity);
+            const Skeleton* skeleton = animator.Skeleton.get();
+            const AnimationClip* clip = animator.Clip.get();
+            if (!skeleton || !clip) continue;
+
+            const u32 jointCount = skeleton->GetJointCount();
+            if (clip->GetJointCount() != jointCount) continue;
+
+            const f32 step = animator.Playing ? deltaTime * animator.Speed : 0.0f;
+            animator.Time = clip->ResolveTime(animator.Time + step, animator.Loop);
+
+            pose.resize(jointCount);
+            clip->Sample(animator.Time, animator.Loop, pose.data());
+
+            const AnimationClip* blendClip = animator.BlendClip.get();
+            if (blendClip && animator.BlendWeight > 0.0f && blendClip->GetJointCount() == jointCount) {
+                animator.BlendTime = blendClip->ResolveTime(animator.BlendTime + step, animator.Loop);
+
+                blendPose.resize(jointCount);
+                blendClip->Sample(animator.BlendTime, animator.Loop, blendPose.data());
+                PoseKernels::Blend(pose.data(), blendPose.data(), std::min(animator.BlendWeight, 1.0f),
+                                   pose.data(), jointCount);
+                ++chunkBlended;
+            }
+
+            models.resize(jointCount);
+            skeleton->ComputeModelMatrices(pose.data(), models.data());
+            animator.Palette.resize(jointCount);
+            skeleton->ComputeSkinningMatrices(models.data(), animator.Palette.data());
+
+            if (skinned.contains(entity) && meshes.contains(entity)) {
+                const SkinnedMesh* source = skinned.get(entity).Source.get();
+                AABB bounds;
+                if (source && source->GetJointRadii().size() == jointCount &&
+                    ComputeSkinnedBounds(models.data(), source->GetJointRadii(), bounds)) {
+                    MeshComponent& mesh = meshes.get(entity);
+                    mesh.LocalBounds = bounds;
+                    mesh.LocalSphere = BoundingSphere::FromAABB(bounds);
+                }
+            }
+
+            ++chunkPosed;
+            chunkJoints += jointCount;
+        }
+
+        posed.fetch_add(chunkPosed, std::memory_order_relaxed);
+        joints.fetch_add(chunkJoints, std::memory_order_relaxed);
+        blended.fetch_add(chunkBlended, std::memory_order_relaxed);
+    });
+
+    m_Stats.Animators = posed.load(std::memory_order_relaxed);
+    m_Stats.Joints = joints.load(std::memory_order_relaxed);
+    m_Stats.Blended = blended.load(std::memory_order_relaxed);
+}
+
+} // namespace Engine
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "ecs/System.hpp"
+#include "ecs/Components/Animation.hpp"
+#include "ecs/Components/Renderable.hpp"
+
+namespace Engine {
+
+// AnimationSystem - poses every AnimatorComponent on the job system.
+//
+// Per entity: advance the clip times, sample Clip (and BlendClip, blended
+// over it by BlendWeight) with PoseKernels, walk the skeleton to model
+// space and leave the skinning matrices in the component's Palette, where
+// SkinningSystem picks them up for the GPU. Entities with a
+// SkinnedMeshComponent also get MeshComponent::LocalBounds from the posed
+// joints and SkinnedMesh::GetJointRadii, so culling and shadow casting
+// follow the animated mesh rather than its bind pose.
+//
+// Animators whose clips don't match the skeleton's joint count are left as
+// they were.
+class AnimationSystem : public ISystem {
+public:
+    DEFINE_SYSTEM(AnimationSystem, PostUpdate, 20)
+    SYSTEM_ACCESS(.Read<SkinnedMeshComponent>().Write<AnimatorComponent, MeshComponent>())
+
+    // Animators per job; each is a few microseconds for typical rigs
+    static constexpr u32 Grain = 16;
+
+    struct Stats {
+        u32 Animators = 0;      // Posed this frame
+        u32 Joints = 0;
+        u32 Blended = 0;        // With a BlendClip weighed in
+    };
+
+    void OnUpdate(entt::registry& registry, f32 deltaTime) override;
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    Vector<entt::entity> m_Entities;
+    Stats m_Stats;
+};
+
+} // namespace Engine
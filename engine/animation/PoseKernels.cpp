@@ -0,0 +1,120 @@
+#include "PoseKernels.hpp"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #include <immintrin.h>
+    #define ENGINE_KERNELS_X86 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define ENGINE_KERNELS_NEON 1
+#endif
+
+namespace Engine {
+
+glm::mat4 JointTransform::ToMatrix() const {
+    glm::mat4 matrix = glm::mat4_cast(GetRotation());
+    matrix[0] *= Scale.x;
+    matrix[1] *= Scale.y;
+    matrix[2] *= Scale.z;
+    matrix[3] = glm::vec4(glm::vec3(Translation), 1.0f);
+    return matrix;
+}
+
+namespace {
+
+#if ENGINE_KERNELS_X86
+
+// Sum of the four lanes, in every lane
+__m128 HorizontalSum(__m128 v) {
+    __m128 sums = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_add_ps(sums, _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+void BlendSSE2(const JointTransform* a, const JointTransform* b, f32 weight, JointTransform* out, usize count) {
+    const __m128 w = _mm_set1_ps(weight);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+
+    for (usize j = 0; j < count; ++j) {
+        const f32* lhs = &a[j].Translation.x;
+        const f32* rhs = &b[j].Translation.x;
+        f32* result = &out[j].Translation.x;
+
+        const __m128 ta = _mm_load_ps(lhs);
+        const __m128 qa = _mm_load_ps(lhs + 4);
+        const __m128 sa = _mm_load_ps(lhs + 8);
+        const __m128 tb = _mm_load_ps(rhs);
+        __m128 qb = _mm_load_ps(rhs + 4);
+        const __m128 sb = _mm_load_ps(rhs + 8);
+
+        // Flip b onto a's hemisphere when they are more than 180 degrees apart
+        qb = _mm_xor_ps(qb, _mm_and_ps(HorizontalSum(_mm_mul_ps(qa, qb)), signBit));
+        __m128 q = _mm_add_ps(qa, _mm_mul_ps(_mm_sub_ps(qb, qa), w));
+        q = _mm_div_ps(q, _mm_sqrt_ps(HorizontalSum(_mm_mul_ps(q, q))));
+
+        _mm_store_ps(result, _mm_add_ps(ta, _mm_mul_ps(_mm_sub_ps(tb, ta), w)));
+        _mm_store_ps(result + 4, q);
+        _mm_store_ps(result + 8, _mm_add_ps(sa, _mm_mul_ps(_mm_sub_ps(sb, sa), w)));
+    }
+}
+
+#endif
+
+#if ENGINE_KERNELS_NEON
+
+void BlendNEON(const JointTransform* a, const JointTransform* b, f32 weight, JointTransform* out, usize count) {
+    const float32x4_t w = vdupq_n_f32(weight);
+
+    for (usize j = 0; j < count; ++j) {
+        const f32* lhs = &a[j].Translation.x;
+        const f32* rhs = &b[j].Translation.x;
+        f32* result = &out[j].Translation.x;
+
+        const float32x4_t ta = vld1q_f32(lhs);
+        const float32x4_t qa = vld1q_f32(lhs + 4);
+        const float32x4_t sa = vld1q_f32(lhs + 8);
+        const float32x4_t tb = vld1q_f32(rhs);
+        float32x4_t qb = vld1q_f32(rhs + 4);
+        const float32x4_t sb = vld1q_f32(rhs + 8);
+
+        if (vaddvq_f32(vmulq_f32(qa, qb)) < 0.0f) qb = vnegq_f32(qb);
+        float32x4_t q = vaddq_f32(qa, vmulq_f32(vsubq_f32(qb, qa), w));
+        q = vdivq_f32(q, vdupq_n_f32(std::sqrt(vaddvq_f32(vmulq_f32(q, q)))));
+
+        vst1q_f32(result, vaddq_f32(ta, vmulq_f32(vsubq_f32(tb, ta), w)));
+        vst1q_f32(result + 4, q);
+        vst1q_f32(result + 8, vaddq_f32(sa, vmulq_f32(vsubq_f32(sb, sa), w)));
+    }
+}
+
+#endif
+
+} // anonymous namespace
+
+namespace PoseKernels {
+
+void Blend(const JointTransform* a, const JointTransform* b, f32 weight, JointTransform* out, usize count) {
+#if ENGINE_KERNELS_X86
+    BlendSSE2(a, b, weight, out, count);
+#elif ENGINE_KERNELS_NEON
+    BlendNEON(a, b, weight, out, count);
+#else
+    BlendScalar(a, b, weight, out, count);
+#endif
+}
+
+void BlendScalar(const JointTransform* a, const JointTransform* b, f32 weight, JointTransform* out, usize count) {
+    for (usize j = 0; j < count; ++j) {
+        const glm::vec4 qa = a[j].Rotation;
+        glm::vec4 qb = b[j].Rotation;
+        if (glm::dot(qa, qb) < 0.0f) qb = -qb;
+        const glm::vec4 q = qa + (qb - qa) * weight;
+
+        out[j].Translation = a[j].Translation + (b[j].Translation - a[j].Translation) * weight;
+        out[j].Rotation = q / std::sqrt(glm::dot(q, q));
+        out[j].Scale = a[j].Scale + (b[j].Scale - a[j].Scale) * weight;
+    }
+}
+
+} // namespace PoseKernels
+
+} // namespace Engine
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Engine {
+
+// Local transform of one joint relative to its parent: three 16-byte lanes,
+// which the pose kernels work on as float4s. Rotation is a unit quaternion
+// stored xyzw, whatever glm's own quaternion layout.
+struct alignas(16) JointTransform {
+    glm::vec4 Translation{0.0f};                    // w unused
+    glm::vec4 Rotation{0.0f, 0.0f, 0.0f, 1.0f};
+    glm::vec4 Scale{1.0f, 1.0f, 1.0f, 0.0f};        // w unused
+
+    glm::quat GetRotation() const { return glm::quat(Rotation.w, Rotation.x, Rotation.y, Rotation.z); }
+    void SetRotation(const glm::quat& rotation) { Rotation = glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w); }
+
+    // T * R * S
+    glm::mat4 ToMatrix() const;
+};
+static_assert(sizeof(JointTransform) == 48, "JointTransform must stay three float4 lanes");
+
+// Vectorized pose arithmetic, one joint per step with its translation,
+// rotation and scale each a single SSE2 / NEON register. AnimationClip
+// sampling (between two frames) and AnimationSystem blending (between two
+// clips) are both Blend.
+namespace PoseKernels {
+
+    // out[j] = a[j] .. b[j] at weight: translation and scale interpolated
+    // linearly, rotation normalized-linearly along the shorter arc. out may
+    // be a or b.
+    void Blend(const JointTransform* a, const JointTransform* b, f32 weight, JointTransform* out, usize count);
+    void BlendScalar(const JointTransform* a, const JointTransform* b, f32 weight, JointTransform* out, usize count);
+
+} // namespace PoseKernels
+
+} // namespace Engine
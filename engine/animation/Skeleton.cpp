@@ -0,0 +1,51 @@
+#include "Skeleton.hpp"
+#include "core/Logger.hpp"
+
+namespace Engine {
+
+u32 Skeleton::AddJoint(const String& name, i32 parent, const JointTransform& bindPose) {
+    const u32 index = GetJointCount();
+    if (index >= MaxJoints) {
+        LOG_CORE_ERROR("Skeleton: Joint '{}' exceeds the {} joint limit", name, MaxJoints);
+        return InvalidJoint;
+    }
+    if (parent != NoParent && (parent < 0 || static_cast<u32>(parent) >= index)) {
+        LOG_CORE_ERROR("Skeleton: Joint '{}' has parent {}, which must be added before it", name, parent);
+        return InvalidJoint;
+    }
+
+    const glm::mat4 local = bindPose.ToMatrix();
+    const glm::mat4 model = parent == NoParent ? local : m_BindModels[parent] * local;
+
+    m_Parents.push_back(parent);
+    m_Names.push_back(name);
+    m_BindPose.push_back(bindPose);
+    m_BindModels.push_back(model);
+    m_InverseBind.push_back(glm::inverse(model));
+    return index;
+}
+
+u32 Skeleton::FindJoint(const String& name) const {
+    for (u32 joint = 0; joint < GetJointCount(); ++joint) {
+        if (m_Names[joint] == name) return joint;
+    }
+    return InvalidJoint;
+}
+
+void Skeleton::ComputeModelMatrices(const JointTransform* locals, glm::mat4* models) const {
+    const u32 count = GetJointCount();
+    for (u32 joint = 0; joint < count; ++joint) {
+        const glm::mat4 local = locals[joint].ToMatrix();
+        const i32 parent = m_Parents[joint];
+        models[joint] = parent == NoParent ? local : models[parent] * local;
+    }
+}
+
+void Skeleton::ComputeSkinningMatrices(const glm::mat4* models, glm::mat4* palette) const {
+    const u32 count = GetJointCount();
+    for (u32 joint = 0; joint < count; ++joint) {
+        palette[joint] = models[joint] * m_InverseBind[joint];
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "animation/PoseKernels.hpp"
+
+namespace Engine {
+
+// Skeleton - joint hierarchy and bind pose of a skinned mesh.
+//
+// Joints are stored parents first, so a single forward pass turns local
+// transforms into model-space ones. Skinning vertices address joints with a
+// byte each, which caps a skeleton at MaxJoints.
+class Skeleton {
+public:
+    static constexpr u32 MaxJoints = 256;
+    static constexpr i32 NoParent = -1;
+    static constexpr u32 InvalidJoint = ~0u;
+
+    // Append a joint whose parent is already in (or NoParent for a root),
+    // bindPose being its local transform in the pose the mesh was modelled
+    // in. Returns its index, or InvalidJoint when full or the parent is not.
+    u32 AddJoint(const String& name, i32 parent, const JointTransform& bindPose);
+
+    u32 GetJointCount() const { return static_cast<u32>(m_Parents.size()); }
+    i32 GetParent(u32 joint) const { return m_Parents[joint]; }
+    const String& GetJointName(u32 joint) const { return m_Names[joint]; }
+    u32 FindJoint(const String& name) const;
+
+    const Vector<JointTransform>& GetBindPose() const { return m_BindPose; }
+
+    // Each joint's space to model space in the bind pose, and back
+    const Vector<glm::mat4>& GetBindModelMatrices() const { return m_BindModels; }
+    const Vector<glm::mat4>& GetInverseBindMatrices() const { return m_InverseBind; }
+
+    // models[j] = models[parent] * locals[j].ToMatrix(), one per joint
+    void ComputeModelMatrices(const JointTransform* locals, glm::mat4* models) const;
+
+    // palette[j] = models[j] * inverse bind: what moves a bind-pose vertex
+    // with joint j. models and palette may be the same array.
+    void ComputeSkinningMatrices(const glm::mat4* models, glm::mat4* palette) const;
+
+private:
+    Vector<i32> m_Parents;
+    Vector<String> m_Names;
+    Vector<JointTransform> m_BindPose;
+    Vector<glm::mat4> m_InverseBind;
+    Vector<glm::mat4> m_BindModels;
+};
+
+} // namespace Engine
@@ -1,10 +1,16 @@
 #pragma once
 
 #include "core/Types.hpp"
+#include "math/Frustum.hpp"
 #include <glm/glm.hpp>
 
 namespace Engine {
 
+// Camera - view and projection plus everything derived from them.
+//
+// The products, inverses and frustum planes are recomputed when the view or
+// projection changes rather than by every pass that needs them, so culling,
+// shadows and the per-frame camera uniform block all read the same values.
 class Camera {
 public:
     Camera() = default;
@@ -12,14 +18,67 @@ public:
 
     const glm::mat4& GetViewMatrix() const { return m_ViewMatrix; }
     const glm::mat4& GetProjectionMatrix() const { return m_ProjectionMatrix; }
-    glm::mat4 GetViewProjectionMatrix() const { return m_ProjectionMatrix * m_ViewMatrix; }
+    const glm::mat4& GetViewProjectionMatrix() const { return m_ViewProjectionMatrix; }
+
+    const glm::mat4& GetInverseViewMatrix() const { return m_InverseViewMatrix; }
+    const glm::mat4& GetInverseProjectionMatrix() const { return m_InverseProjectionMatrix; }
+    const glm::mat4& GetInverseViewProjectionMatrix() const { return m_InverseViewProjectionMatrix; }
+
+    // Projection offset by the sub-pixel jitter, in NDC units
+    const glm::mat4& GetJitteredProjectionMatrix() const { return m_JitteredProjectionMatrix; }
+    const glm::mat4& GetJitteredViewProjectionMatrix() const { return m_JitteredViewProjectionMatrix; }
+    const glm::vec2& GetProjectionJitter() const { return m_ProjectionJitter; }
+
+    void SetProjectionJitter(const glm::vec2& jitter) {
+        m_ProjectionJitter = jitter;
+        UpdateJitter();
+    }
+
+    // Planes of the unjittered view-projection
+    const Frustum& GetFrustum() const { return m_Frustum; }
 
     const glm::vec3& GetPosition() const { return m_Position; }
 
+protected:
+    void OnViewChanged() {
+        m_InverseViewMatrix = glm::inverse(m_ViewMatrix);
+        UpdateViewProjection();
+    }
+
+    void OnProjectionChanged() {
+        m_InverseProjectionMatrix = glm::inverse(m_ProjectionMatrix);
+        UpdateJitter();
+    }
+
+private:
+    void UpdateJitter() {
+        m_JitteredProjectionMatrix = m_ProjectionMatrix;
+        m_JitteredProjectionMatrix[2][0] += m_ProjectionJitter.x;
+        m_JitteredProjectionMatrix[2][1] += m_ProjectionJitter.y;
+        UpdateViewProjection();
+    }
+
+    void UpdateViewProjection() {
+        m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix;
+        m_InverseViewProjectionMatrix = glm::inverse(m_ViewProjectionMatrix);
+        m_JitteredViewProjectionMatrix = m_JitteredProjectionMatrix * m_ViewMatrix;
+        m_Frustum.ExtractPlanes(m_ViewProjectionMatrix);
+    }
+
 protected:
     glm::vec3 m_Position{0.0f, 0.0f, 0.0f};
     glm::mat4 m_ViewMatrix{1.0f};
     glm::mat4 m_ProjectionMatrix{1.0f};
+
+private:
+    glm::mat4 m_ViewProjectionMatrix{1.0f};
+    glm::mat4 m_InverseViewMatrix{1.0f};
+    glm::mat4 m_InverseProjectionMatrix{1.0f};
+    glm::mat4 m_InverseViewProjectionMatrix{1.0f};
+    glm::mat4 m_JitteredProjectionMatrix{1.0f};
+    glm::mat4 m_JitteredViewProjectionMatrix{1.0f};
+    glm::vec2 m_ProjectionJitter{0.0f};
+    Frustum m_Frustum;
 };
 
 } // namespace Engine
@@ -1,5 +1,7 @@
 #include "CameraManager.hpp"
+#include "Camera.hpp"
 #include "core/Logger.hpp"
+#include "core/FrameRecorder.hpp"
 
 namespace Engine {
 
@@ -69,6 +71,9 @@ bool CameraManager::Has(const String& name) const {
 void CameraManager::OnUpdate(f32 deltaTime) {
     if (m_ActiveCamera) {
         m_ActiveCamera->OnUpdate(deltaTime);
+
+        const Camera& camera = m_ActiveCamera->GetCamera();
+        FrameRecorder::TrackCamera(camera.GetPosition(), -glm::vec3(camera.GetInverseViewMatrix()[2]));
     }
 }
 
@@ -78,6 +83,15 @@ void CameraManager::OnEvent(Event& event) {
     }
 }
 
+void CameraManager::UploadUniforms() {
+    if (!m_ActiveCamera) return;
+
+    if (!m_Uniforms) {
+        m_Uniforms = CreateScope<CameraUniformBuffer>();
+    }
+    m_Uniforms->Upload(m_ActiveCamera->GetCamera());
+}
+
 Vector<String> CameraManager::GetCameraNames() const {
     Vector<String> names;
     names.reserve(m_Cameras.size());
@@ -3,6 +3,7 @@
 #include "core/Types.hpp"
 #include "CameraController.hpp"
 #include "events/Event.hpp"
+#include "renderer/CameraUniformBuffer.hpp"
 #include <unordered_map>
 
 namespace Engine {
@@ -44,6 +45,10 @@ public:
     // Forward events to the active camera
     void OnEvent(Event& event);
 
+    // Write the active camera to the per-frame camera uniform block; once
+    // per frame, before the first pass that renders with it
+    void UploadUniforms();
+
     // Get all registered camera names
     Vector<String> GetCameraNames() const;
 
@@ -51,6 +56,7 @@ private:
     HashMap<String, Scope<CameraController>> m_Cameras;
     CameraController* m_ActiveCamera = nullptr;
     String m_ActiveName;
+    Scope<CameraUniformBuffer> m_Uniforms;     // Created on first upload, with a GL context
 };
 
 } // namespace Engine
@@ -43,6 +43,12 @@ FPSCameraController::FPSCameraController(f32 aspectRatio, const FPSCameraSetting
 void FPSCameraController::OnUpdate(f32 deltaTime) {
     if (!m_Enabled) return;
 
+    // Every motion since last frame, raw while the cursor is captured
+    const glm::vec2 mouseDelta = Input::GetGameMouseDelta();
+    if (mouseDelta.x != 0.0f || mouseDelta.y != 0.0f) {
+        ProcessMouseMovement(mouseDelta.x, -mouseDelta.y);
+    }
+
     ProcessKeyboardInput(deltaTime);
 
     // Apply smoothing interpolation
@@ -64,7 +70,6 @@ void FPSCameraController::OnEvent(Event& event) {
     if (!m_Enabled) return;
 
     EventDispatcher dispatcher(event);
-    dispatcher.Dispatch<MouseMovedEvent>([this](MouseMovedEvent& e) { return OnMouseMoved(e); });
     dispatcher.Dispatch<MouseScrolledEvent>([this](MouseScrolledEvent& e) { return OnMouseScrolled(e); });
     dispatcher.Dispatch<WindowResizeEvent>([this](WindowResizeEvent& e) { return OnWindowResize(e); });
 }
@@ -76,27 +81,14 @@ void FPSCameraController::ProcessKeyboardInput(f32 deltaTime) {
         velocity *= m_SprintMultiplier;
     }
 
-    // Move target position (will be smoothly interpolated to actual position)
+    // Move target position (will be smoothly interpolated to actual position).
+    // Scaled by how long each key was held, so taps shorter than a frame move
+    auto held = [](i32 key) { return Input::GetGameKeyHeldFraction(key); };
     glm::vec3& pos = m_SmoothingEnabled ? m_TargetPosition : m_Position;
 
-    if (Input::IsGameKeyPressed(Key::W)) {
-        pos += m_Front * velocity;
-    }
-    if (Input::IsGameKeyPressed(Key::S)) {
-        pos -= m_Front * velocity;
-    }
-    if (Input::IsGameKeyPressed(Key::A)) {
-        pos -= m_Right * velocity;
-    }
-    if (Input::IsGameKeyPressed(Key::D)) {
-        pos += m_Right * velocity;
-    }
-    if (Input::IsGameKeyPressed(Key::Space)) {
-        pos += m_WorldUp * velocity;
-    }
-    if (Input::IsGameKeyPressed(Key::LeftControl)) {
-        pos -= m_WorldUp * velocity;
-    }
+    pos += m_Front * velocity * (held(Key::W) - held(Key::S));
+    pos += m_Right * velocity * (held(Key::D) - held(Key::A));
+    pos += m_WorldUp * velocity * (held(Key::Space) - held(Key::LeftControl));
 }
 
 void FPSCameraController::ProcessMouseMovement(f32 xOffset, f32 yOffset) {
@@ -132,28 +124,6 @@ void FPSCameraController::UpdateViewMatrix() {
     m_Camera.SetView(m_Position, m_Front, m_Up);
 }
 
-bool FPSCameraController::OnMouseMoved(MouseMovedEvent& event) {
-    // Don't process mouse movement when ImGui wants the mouse
-    if (Input::IsImGuiCapturingMouse()) return false;
-
-    f32 xPos = event.GetX();
-    f32 yPos = event.GetY();
-
-    if (m_FirstMouse) {
-        m_LastMousePosition = {xPos, yPos};
-        m_FirstMouse = false;
-        return false;
-    }
-
-    f32 xOffset = xPos - m_LastMousePosition.x;
-    f32 yOffset = m_LastMousePosition.y - yPos;
-
-    m_LastMousePosition = {xPos, yPos};
-
-    ProcessMouseMovement(xOffset, yOffset);
-    return false;
-}
-
 bool FPSCameraController::OnMouseScrolled(MouseScrolledEvent& event) {
     // Don't process scroll when ImGui wants the mouse
     if (Input::IsImGuiCapturingMouse()) return false;
@@ -64,7 +64,6 @@ private:
     void UpdateCameraVectors();
     void UpdateViewMatrix();
 
-    bool OnMouseMoved(MouseMovedEvent& event);
     bool OnMouseScrolled(MouseScrolledEvent& event);
     bool OnWindowResize(WindowResizeEvent& event);
 
@@ -97,8 +96,6 @@ private:
     f32 m_RotationSmoothing = 15.0f;
     f32 m_PositionSmoothing = 12.0f;
 
-    glm::vec2 m_LastMousePosition{0.0f, 0.0f};
-    bool m_FirstMouse = true;
     bool m_Enabled = true;
 };
 
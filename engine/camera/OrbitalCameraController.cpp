@@ -49,6 +49,12 @@ void OrbitalCameraController::OnUpdate(f32 deltaTime) {
     m_Orbiting = Input::IsGameMouseButtonPressed(Mouse::Left);
     m_Panning = Input::IsGameMouseButtonPressed(Mouse::Middle);
 
+    // Every motion since last frame
+    const glm::vec2 mouseDelta = Input::GetGameMouseDelta();
+    if (mouseDelta.x != 0.0f || mouseDelta.y != 0.0f) {
+        ProcessMouseMovement(mouseDelta.x, -mouseDelta.y);
+    }
+
     // Smooth interpolation
     m_Azimuth = Math::ExpDecay(m_Azimuth, m_TargetAzimuth, m_Smoothing, deltaTime);
     m_Elevation = Math::ExpDecay(m_Elevation, m_TargetElevation, m_Smoothing, deltaTime);
@@ -82,27 +88,11 @@ void OrbitalCameraController::OnEvent(Event& event) {
     if (!m_Enabled) return;
 
     EventDispatcher dispatcher(event);
-    dispatcher.Dispatch<MouseMovedEvent>([this](MouseMovedEvent& e) { return OnMouseMoved(e); });
     dispatcher.Dispatch<MouseScrolledEvent>([this](MouseScrolledEvent& e) { return OnMouseScrolled(e); });
     dispatcher.Dispatch<WindowResizeEvent>([this](WindowResizeEvent& e) { return OnWindowResize(e); });
 }
 
-bool OrbitalCameraController::OnMouseMoved(MouseMovedEvent& event) {
-    // Don't process mouse movement when ImGui wants the mouse
-    if (Input::IsImGuiCapturingMouse()) return false;
-
-    f32 xPos = event.GetX();
-    f32 yPos = event.GetY();
-
-    if (m_FirstMouse) {
-        m_LastMousePosition = {xPos, yPos};
-        m_FirstMouse = false;
-        return false;
-    }
-
-    f32 xOffset = xPos - m_LastMousePosition.x;
-    f32 yOffset = m_LastMousePosition.y - yPos;
-
+void OrbitalCameraController::ProcessMouseMovement(f32 xOffset, f32 yOffset) {
     if (m_Orbiting) {
         m_TargetAzimuth += xOffset * m_RotationSpeed;
         m_TargetElevation += yOffset * m_RotationSpeed;
@@ -119,9 +109,6 @@ bool OrbitalCameraController::OnMouseMoved(MouseMovedEvent& event) {
         m_TargetFocusPoint -= right * xOffset * panScale;
         m_TargetFocusPoint += up * yOffset * panScale;
     }
-
-    m_LastMousePosition = {xPos, yPos};
-    return false;
 }
 
 bool OrbitalCameraController::OnMouseScrolled(MouseScrolledEvent& event) {
@@ -62,7 +62,8 @@ public:
 private:
     void UpdateCameraPosition(f32 deltaTime);
 
-    bool OnMouseMoved(MouseMovedEvent& event);
+    void ProcessMouseMovement(f32 xOffset, f32 yOffset);
+
     bool OnMouseScrolled(MouseScrolledEvent& event);
     bool OnWindowResize(WindowResizeEvent& event);
 
@@ -89,8 +90,6 @@ private:
     f32 m_PanSpeed = 0.01f;
     f32 m_Smoothing = 12.0f;
 
-    glm::vec2 m_LastMousePosition{0.0f};
-    bool m_FirstMouse = true;
     bool m_Enabled = true;
     bool m_Orbiting = false;
     bool m_Panning = false;
@@ -32,10 +32,12 @@ void PerspectiveCamera::SetFOV(f32 fov) {
 void PerspectiveCamera::SetView(const glm::vec3& position, const glm::vec3& front, const glm::vec3& up) {
     m_Position = position;
     m_ViewMatrix = glm::lookAt(position, position + front, up);
+    OnViewChanged();
 }
 
 void PerspectiveCamera::RecalculateProjection() {
     m_ProjectionMatrix = glm::perspective(glm::radians(m_FOV), m_AspectRatio, m_NearPlane, m_FarPlane);
+    OnProjectionChanged();
 }
 
 } // namespace Engine
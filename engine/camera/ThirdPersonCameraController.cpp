@@ -1,11 +1,20 @@
 #include "ThirdPersonCameraController.hpp"
 #include "core/Input.hpp"
 #include "math/Interpolation.hpp"
+#include "renderer/culling/SceneQuery.hpp"
 #include <glm/gtc/matrix_transform.hpp>
 #include <algorithm>
+#include <limits>
 
 namespace Engine {
 
+namespace {
+
+// Closest a collision may pull the camera to the target, so it still has a view direction
+constexpr f32 MinCollisionDistance = 0.1f;
+
+} // anonymous namespace
+
 ThirdPersonCameraController::ThirdPersonCameraController(f32 aspectRatio) {
     PerspectiveCameraSettings camSettings;
     camSettings.AspectRatio = aspectRatio;
@@ -28,7 +37,8 @@ ThirdPersonCameraController::ThirdPersonCameraController(f32 aspectRatio, const
     , m_TargetYaw(settings.InitialYaw)
     , m_TargetPitch(settings.InitialPitch)
     , m_MinPitch(settings.MinPitch)
-    , m_MaxPitch(settings.MaxPitch) {
+    , m_MaxPitch(settings.MaxPitch)
+    , m_CollisionRadius(settings.CollisionRadius) {
 
     PerspectiveCameraSettings camSettings;
     camSettings.FOV = settings.FOV;
@@ -46,6 +56,14 @@ void ThirdPersonCameraController::OnUpdate(f32 deltaTime) {
     // Check if right mouse button is held for rotation (respects ImGui capture)
     m_Rotating = Input::IsGameMouseButtonPressed(Mouse::Right);
 
+    // Every motion since last frame
+    const glm::vec2 mouseDelta = Input::GetGameMouseDelta();
+    if (m_Rotating) {
+        m_TargetYaw += mouseDelta.x * m_RotationSpeed;
+        m_TargetPitch -= mouseDelta.y * m_RotationSpeed;
+        m_TargetPitch = std::clamp(m_TargetPitch, m_MinPitch, m_MaxPitch);
+    }
+
     // Smooth interpolation
     m_Yaw = Math::ExpDecay(m_Yaw, m_TargetYaw, m_Smoothing, deltaTime);
     m_Pitch = Math::ExpDecay(m_Pitch, m_TargetPitch, m_Smoothing, deltaTime);
@@ -67,6 +85,23 @@ void ThirdPersonCameraController::UpdateCameraPosition(f32 deltaTime) {
     glm::vec3 targetPos = m_TargetPosition + glm::vec3(0.0f, m_HeightOffset, 0.0f);
     glm::vec3 desiredPosition = m_TargetPosition + offset;
 
+    f32 allowedDistance = std::numeric_limits<f32>::max();
+    if (m_CollisionIndex) {
+        const glm::vec3 toCamera = desiredPosition - targetPos;
+        const f32 length = glm::length(toCamera);
+        if (length > MinCollisionDistance) {
+            const Ray ray(targetPos, toCamera);
+            const entt::entity ignore = m_CollisionIgnore;
+            SceneQuery::RayHit hit;
+            SceneQuery(*m_CollisionIndex).SweepSphere(&ray, 1, m_CollisionRadius, &hit, &length,
+                                                      [ignore](entt::entity entity) { return entity != ignore; });
+            if (hit) {
+                allowedDistance = std::max(hit.Distance, MinCollisionDistance);
+                desiredPosition = targetPos + ray.Direction * allowedDistance;
+            }
+        }
+    }
+
     // Smooth camera position
     if (deltaTime > 0.0f) {
         m_CurrentPosition = Math::ExpDecay(m_CurrentPosition, desiredPosition, m_Smoothing, deltaTime);
@@ -74,6 +109,11 @@ void ThirdPersonCameraController::UpdateCameraPosition(f32 deltaTime) {
         m_CurrentPosition = desiredPosition;
     }
 
+    // Easing out again is fine, but never show the inside of what blocks
+    if (glm::length(m_CurrentPosition - targetPos) > allowedDistance) {
+        m_CurrentPosition = desiredPosition;
+    }
+
     // Look at target
     glm::vec3 front = glm::normalize(targetPos - m_CurrentPosition);
     glm::vec3 right = glm::normalize(glm::cross(front, glm::vec3(0.0f, 1.0f, 0.0f)));
@@ -86,37 +126,10 @@ void ThirdPersonCameraController::OnEvent(Event& event) {
     if (!m_Enabled) return;
 
     EventDispatcher dispatcher(event);
-    dispatcher.Dispatch<MouseMovedEvent>([this](MouseMovedEvent& e) { return OnMouseMoved(e); });
     dispatcher.Dispatch<MouseScrolledEvent>([this](MouseScrolledEvent& e) { return OnMouseScrolled(e); });
     dispatcher.Dispatch<WindowResizeEvent>([this](WindowResizeEvent& e) { return OnWindowResize(e); });
 }
 
-bool ThirdPersonCameraController::OnMouseMoved(MouseMovedEvent& event) {
-    // Don't process mouse movement when ImGui wants the mouse
-    if (Input::IsImGuiCapturingMouse()) return false;
-
-    f32 xPos = event.GetX();
-    f32 yPos = event.GetY();
-
-    if (m_FirstMouse) {
-        m_LastMousePosition = {xPos, yPos};
-        m_FirstMouse = false;
-        return false;
-    }
-
-    if (m_Rotating) {
-        f32 xOffset = (xPos - m_LastMousePosition.x) * m_RotationSpeed;
-        f32 yOffset = (m_LastMousePosition.y - yPos) * m_RotationSpeed;
-
-        m_TargetYaw += xOffset;
-        m_TargetPitch += yOffset;
-        m_TargetPitch = std::clamp(m_TargetPitch, m_MinPitch, m_MaxPitch);
-    }
-
-    m_LastMousePosition = {xPos, yPos};
-    return false;
-}
-
 bool ThirdPersonCameraController::OnMouseScrolled(MouseScrolledEvent& event) {
     // Don't process scroll when ImGui wants the mouse
     if (Input::IsImGuiCapturingMouse()) return false;
@@ -4,10 +4,13 @@
 #include "PerspectiveCamera.hpp"
 #include "events/MouseEvents.hpp"
 #include "events/WindowEvents.hpp"
+#include <entt/entt.hpp>
 #include <glm/glm.hpp>
 
 namespace Engine {
 
+class SpatialIndex;
+
 struct ThirdPersonCameraSettings {
     f32 Distance = 5.0f;
     f32 MinDistance = 2.0f;
@@ -23,6 +26,7 @@ struct ThirdPersonCameraSettings {
     f32 InitialPitch = 20.0f;
     f32 MinPitch = -60.0f;
     f32 MaxPitch = 80.0f;
+    f32 CollisionRadius = 0.3f;     // Of the sphere swept with SetCollision
 };
 
 class ThirdPersonCameraController : public CameraController {
@@ -48,6 +52,15 @@ public:
     void SetRotationSpeed(f32 speed) { m_RotationSpeed = speed; }
     void SetSmoothing(f32 smoothing) { m_Smoothing = smoothing; }
 
+    // Keep the camera out of scene bounds: a sphere is swept from the target
+    // towards the camera (SceneQuery) and the camera pulled in ahead of the
+    // first hit. ignore is the followed entity, whose own bounds would
+    // block every sweep. Null index turns it off; it must outlive its use.
+    void SetCollision(const SpatialIndex* index, entt::entity ignore = entt::null) {
+        m_CollisionIndex = index;
+        m_CollisionIgnore = ignore;
+    }
+
     void SetEnabled(bool enabled) { m_Enabled = enabled; }
     bool IsEnabled() const { return m_Enabled; }
 
@@ -57,7 +70,6 @@ public:
 private:
     void UpdateCameraPosition(f32 deltaTime);
 
-    bool OnMouseMoved(MouseMovedEvent& event);
     bool OnMouseScrolled(MouseScrolledEvent& event);
     bool OnWindowResize(WindowResizeEvent& event);
 
@@ -84,8 +96,10 @@ private:
     f32 m_MinPitch = -60.0f;
     f32 m_MaxPitch = 80.0f;
 
-    glm::vec2 m_LastMousePosition{0.0f};
-    bool m_FirstMouse = true;
+    const SpatialIndex* m_CollisionIndex = nullptr;
+    entt::entity m_CollisionIgnore = entt::null;
+    f32 m_CollisionRadius = 0.3f;
+
     bool m_Enabled = true;
     bool m_Rotating = false;
 };
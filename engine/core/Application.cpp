@@ -2,7 +2,26 @@
 #include "Logger.hpp"
 #include "Input.hpp"
 #include "Time.hpp"
+#include "FrameRecorder.hpp"
+#include "JobSystem.hpp"
+#include "InitGraph.hpp"
+#include "FrameAllocator.hpp"
+#include "MemoryTracker.hpp"
+#include "Profiler.hpp"
+#include "Telemetry.hpp"
 #include "ecs/System.hpp"
+#include "ecs/TransformSystem.hpp"
+#include "ecs/TransformInterpolationSystem.hpp"
+#include "animation/AnimationSystem.hpp"
+#include "renderer/RenderThread.hpp"
+#include "renderer/debug/DebugDraw.hpp"
+#include "renderer/opengl/GPUProfiler.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/TextureUploadRing.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
+#include "renderer/pipeline/RenderTargetPool.hpp"
+#include "resources/ResourceManager.hpp"
 
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
@@ -10,107 +29,406 @@
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_opengl3.h>
 #include <ImGuizmo.h>
+#include <algorithm>
+#include <utility>
 
 namespace Engine {
 
+namespace {
+
+const TelemetryGauge s_CPUTime("Frame.CPUMs");
+const TelemetryGauge s_RenderTime("Frame.RenderThreadMs");
+const TelemetryGauge s_Hitches("Frame.Hitches");
+const TelemetryGauge s_StartupTime("Startup.FirstFrameMs");
+
+} // anonymous namespace
+
+// ImGui rebuilds its draw lists every NewFrame, so the render thread draws
+// from copies taken when the UI frame ends
+struct ImGuiDrawSnapshot {
+    ImDrawData Data;
+
+    ~ImGuiDrawSnapshot() { Release(); }
+
+    void Capture(const ImDrawData& source) {
+        Release();
+        Data.Valid = source.Valid;
+        Data.DisplayPos = source.DisplayPos;
+        Data.DisplaySize = source.DisplaySize;
+        Data.FramebufferScale = source.FramebufferScale;
+        Data.OwnerViewport = source.OwnerViewport;
+        Data.Textures = source.Textures;
+        for (ImDrawList* list : source.CmdLists) {
+            Data.AddDrawList(list->CloneOutput());
+        }
+    }
+
+    void Release() {
+        for (ImDrawList* list : Data.CmdLists) {
+            IM_DELETE(list);
+        }
+        Data.Clear();
+    }
+};
+
 Application* Application::s_Instance = nullptr;
 
 Application::Application(const String& name, u32 width, u32 height) {
     s_Instance = this;
+    m_StartTime = Profiler::Now();
 
     Logger::Init();
     LOG_CORE_INFO("Initializing Engine...");
 
-    WindowProps props;
-    props.Title = name;
-    props.Width = width;
-    props.Height = height;
+    JobSystem::Init();
 
-    m_Window = Window::Create(props);
-    m_Window->SetEventCallback([this](Event& e) { OnEvent(e); });
+    // Startup as a task graph: shader files are read on the workers while
+    // the window and GL context are created on this thread
+    using Thread = InitGraph::Thread;
+    InitGraph init;
 
-    Input::Init(m_Window->GetNativeWindow());
-    Time::Init();
+    init.Add("ShaderPrefetch", Thread::Worker, [] { Shader::PrefetchSources("assets/shaders"); });
 
-    // Initialize ImGui
-    IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
-    ImGuiIO& io = ImGui::GetIO();
-    io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
-    (void)io; // Unused warning suppression
+    const auto window = init.Add("Window", Thread::Main, [&] {
+        WindowProps props;
+        props.Title = name;
+        props.Width = width;
+        props.Height = height;
 
-    ImGui::StyleColorsDark();
-    ImGuiStyle& style = ImGui::GetStyle();
-    style.WindowRounding = 4.0f;
-    style.FrameRounding = 2.0f;
+        m_Window = Window::Create(props);
+        m_Window->SetEventQueue(&m_EventQueue);
 
-    ImGui_ImplGlfw_InitForOpenGL(m_Window->GetNativeWindow(), true);
-    ImGui_ImplOpenGL3_Init("#version 450");
+        m_EventQueue.Subscribe<&Application::OnWindowClose>(this);
+        m_EventQueue.Subscribe<&Application::OnWindowResize>(this);
+
+        // The window's context is current on this thread from here on
+        ResourceManager::Instance().SetGLThread(std::this_thread::get_id());
+
+        Input::Init(m_Window->GetNativeWindow());
+        Time::Init();
+    });
+
+    init.Add("ImGui", Thread::Main, [this] {
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+        ImGuiIO& io = ImGui::GetIO();
+        io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
+        (void)io; // Unused warning suppression
+
+        ImGui::StyleColorsDark();
+        ImGuiStyle& style = ImGui::GetStyle();
+        style.WindowRounding = 4.0f;
+        style.FrameRounding = 2.0f;
+
+        ImGui_ImplGlfw_InitForOpenGL(m_Window->GetNativeWindow(), true);
+        ImGui_ImplOpenGL3_Init("#version 450");
+    }, {window});
+
+    init.Add("GPUProfiler", Thread::Main, [] { GPUProfiler::Init(); }, {window});
+    init.Add("DebugDraw", Thread::Main, [] { DebugDraw::Init(); }, {window});
+    init.Add("TextureUploadRing", Thread::Main, [] { TextureUploadRing::Init(); }, {window});
+    init.Add("PipelineWarmup", Thread::Main, [] { PipelineWarmup::Init(); }, {window});
+
+    init.Add("Systems", Thread::Main, [this] {
+        // Built-in systems
+        m_SystemScheduler.AddSystem<TransformSystem>();
+        m_SystemScheduler.AddSystem<TransformInterpolationSystem>();
+        m_SystemScheduler.AddSystem<AnimationSystem>();
+    });
+
+    init.Run();
 
     LOG_CORE_INFO("Engine initialized successfully!");
 }
 
 Application::~Application() {
+    PipelineWarmup::Shutdown();
+    RenderTargetPool::Clear();
+    TextureUploadRing::Shutdown();
+    DebugDraw::Shutdown();
+    GPUProfiler::Shutdown();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
+    JobSystem::Shutdown();
     LOG_CORE_INFO("Shutting down Engine...");
+    Logger::Shutdown();
 }
 
 void Application::Run() {
+    PROFILE_THREAD("Main");
     OnInit();
 
     // Initialize ECS systems
     m_SystemScheduler.Initialize(m_Registry.Raw());
     LOG_CORE_INFO("ECS Systems initialized");
 
+    // Pipelines recorded in earlier sessions, drawn once before the first frame
+    PipelineWarmup::Run();
+
+    if (m_RenderThreadEnabled) {
+        // RunFrameThreaded has no Render / PostRender phases; rather than
+        // drop those systems, stay on the single-threaded loop
+        bool renderSystems = false;
+        for (SystemPhase phase : {SystemPhase::Render, SystemPhase::PostRender}) {
+            m_SystemScheduler.ForEachSystemInPhase(phase, [phase, &renderSystems](ISystem* system) {
+                LOG_CORE_ERROR("Render thread: system '{}' ({}) can't run on it", system->GetName(),
+                               SystemPhaseToString(phase));
+                renderSystems = true;
+            });
+        }
+        if (renderSystems) {
+            LOG_CORE_ERROR("Render thread disabled: rendering on the main thread");
+            m_RenderThreadEnabled = false;
+        }
+    }
+
+    if (m_RenderThreadEnabled) {
+        // ImGui's device objects are created lazily by NewFrame, which from now
+        // on runs without the context
+        ImGui_ImplOpenGL3_NewFrame();
+        m_ImGuiSnapshot = CreateScope<ImGuiDrawSnapshot>();
+        m_RenderThread = CreateScope<RenderThread>(*m_Window);
+    }
+
     while (m_Running) {
+        // Frame limiter; input is sampled after it so it is as fresh as possible
+        m_FramePacer.BeginFrame();
+
+        PROFILE_SCOPE("Frame");
+        const u64 frameStart = Profiler::Now();
+
+        // Frame arenas of the frame before last are free again
+        FrameArena::BeginFrame();
+
+        // Poll as late as possible; Input::Update consumes the samples
+        // recorded since last frame, including any polled by the limiter.
+        // A replay substitutes its logged input and delta. An idle tool
+        // sleeps here until input arrives (SetIdleFrameRate).
+        if (m_IdleFrameRate > 0.0f && m_QuietFrames >= IdleGraceFrames && IsIdle()) {
+            m_Window->WaitEvents(1.0 / static_cast<f64>(m_IdleFrameRate));
+        } else {
+            m_Window->PollEvents();
+        }
         Time::Update();
-        Input::Update();
+        FrameRecorder::BeginFrame();
         f32 deltaTime = Time::GetDeltaTime();
 
+        {
+            // Everything polled since last frame or posted since
+            PROFILE_SCOPE("Events");
+            const u32 delivered = m_EventQueue.Drain([this](Event& e) { OnAppEvent(e); });
+            m_QuietFrames = delivered > 0 ? 0 : m_QuietFrames + 1;
+        }
+
+        if (m_RenderThread) {
+            if (!m_Minimized) {
+                RunFrameThreaded(deltaTime);
+            }
+
+            m_CPUTimeMs = static_cast<f32>(static_cast<f64>(Profiler::Now() - frameStart) / 1.0e6);
+            if (m_StartupTimeMs == 0.0f) ReportStartup();
+            continue;
+        }
+
+        if (!m_Minimized) {
+            RunFrame(deltaTime);
+        }
+
+        m_CPUTimeMs = static_cast<f32>(static_cast<f64>(Profiler::Now() - frameStart) / 1.0e6);
+
+        {
+            PROFILE_SCOPE("SwapBuffers");
+            m_Window->SwapBuffers();
+        }
+        if (m_StartupTimeMs == 0.0f) ReportStartup();
+
         if (!m_Minimized) {
-            // Update ECS systems (PreUpdate, Update, PostUpdate phases)
-            m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::PreUpdate, deltaTime);
-            m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::Update, deltaTime);
-            m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::PostUpdate, deltaTime);
+            m_FramePacer.EndFrame(m_FramePacer.GetFrameStart());
+        }
+    }
+
+    FrameRecorder::StopRecording();
+
+    // Systems and the application free GL objects on shutdown
+    m_RenderThread.reset();
+    m_FramePacer.Shutdown();
+
+    // Shutdown ECS systems
+    m_SystemScheduler.Shutdown(m_Registry.Raw());
+
+    OnShutdown();
+}
+
+void Application::UpdateSimulation(f32 deltaTime) {
+    // Update ECS systems (PreUpdate, Update, PostUpdate phases)
+    {
+        MEMORY_TAG(ECS);
+        m_SystemScheduler.BeginFrame();
+        m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::PreUpdate, deltaTime);
+        m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::Update, deltaTime);
+        m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::PostUpdate, deltaTime);
+    }
+
+    // User update callback
+    {
+        MEMORY_TAG(Gameplay);
+        OnUpdate(deltaTime);
+    }
+
+    // Physics phases, 0..N fixed steps (or once with the frame's delta)
+    {
+        PROFILE_SCOPE("Physics");
+        MEMORY_TAG(ECS);
+        const bool fixedStep = Time::GetSimulationStep() > 0.0f;
+        const f32 step = fixedStep ? Time::GetSimulationStep() : deltaTime;
+        const u32 steps = Time::AccumulateSimulation(deltaTime);
+
+        for (u32 i = 0; i < steps; ++i) {
+            if (fixedStep) {
+                TransformInterpolationSystem::CaptureState(m_Registry.Raw());
+            }
+            m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::PrePhysics, step);
+            m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::Physics, step);
+            m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::PostPhysics, step);
+        }
+    }
+}
+
+void Application::RunFrame(f32 deltaTime) {
+    GPUProfiler::BeginFrame();
+    GLStateCache::Instance().BeginFrame();
+    RenderTargetPool::BeginFrame();
+    DebugDraw::BeginFrame();
+
+    {
+        PROFILE_SCOPE("Resources");
+        MEMORY_TAG(Resources);
 
-            // User update callback
-            OnUpdate(deltaTime);
+        // Finish asynchronous texture / mesh loads within the frame's budget
+        ResourceManager::Instance().ProcessUploads();
 
-            // Physics phases
-            m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::PrePhysics, deltaTime);
-            m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::Physics, deltaTime);
-            m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::PostPhysics, deltaTime);
+        // Stream texture mips towards last frame's requests, and evict or
+        // bring back mesh geometry by the same feedback
+        ResourceManager::Instance().UpdateTextureStreaming();
+        ResourceManager::Instance().UpdateMeshResidency();
+    }
+
+    UpdateSimulation(deltaTime);
+
+    // Render phases
+    {
+        MEMORY_TAG(Renderer);
+        m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::PreRender, deltaTime);
 
-            // Render phases
-            m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::PreRender, deltaTime);
+        OnRender();
 
-            OnRender();
+        m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::Render, deltaTime);
+        m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::PostRender, deltaTime);
+    }
 
-            m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::Render, deltaTime);
-            m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::PostRender, deltaTime);
+    BuildImGuiFrame();
+    {
+        GPU_PROFILE_SCOPE("ImGui");
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
 
-            // ImGui frame
-            ImGui_ImplOpenGL3_NewFrame();
-            ImGui_ImplGlfw_NewFrame();
-            ImGui::NewFrame();
-            ImGuizmo::BeginFrame();
+    MemoryTracker::EndFrame();
+    m_FrameStats.Update(Time::GetFrameTime() * 1000.0f, m_SystemScheduler);
+    PublishTelemetry();
+}
 
-            OnImGuiRender();
-            OnPostImGuiRender();
+void Application::RunFrameThreaded(f32 deltaTime) {
+    FramePacket& packet = m_RenderThread->GetPacket();
+    packet.Reset(m_FrameIndex++, deltaTime);
 
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    // GL work the single-threaded frame does before simulating
+    const bool resize = std::exchange(m_ViewportDirty, false);
+    packet.Enqueue([resize, width = m_ViewportWidth, height = m_ViewportHeight](const FramePacket&) {
+        if (resize) {
+            glViewport(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
         }
 
-        m_Window->OnUpdate();
+        GPUProfiler::BeginFrame();
+        GLStateCache::Instance().BeginFrame();
+        RenderTargetPool::BeginFrame();
+        DebugDraw::BeginFrame();
+
+        PROFILE_SCOPE("Resources");
+        MEMORY_TAG(Resources);
+        ResourceManager::Instance().ProcessUploads();
+        ResourceManager::Instance().UpdateTextureStreaming();
+        ResourceManager::Instance().UpdateMeshResidency();
+    });
+
+    // Runs while the render thread draws the previous packet
+    UpdateSimulation(deltaTime);
+
+    // Extraction point: PreRender systems finish culling / LOD, then the
+    // application copies what this frame draws into the packet
+    {
+        MEMORY_TAG(Renderer);
+        m_SystemScheduler.UpdatePhase(m_Registry.Raw(), SystemPhase::PreRender, deltaTime);
+        OnExtract(packet);
     }
 
-    // Shutdown ECS systems
-    m_SystemScheduler.Shutdown(m_Registry.Raw());
+    // ImGui's state (and the draw lists of the last frame) belong to the render
+    // thread until it has presented
+    m_RenderThread->WaitIdle();
+    m_RenderTimeMs = m_RenderThread->GetRenderTimeMs();
 
-    OnShutdown();
+    BuildImGuiFrame();
+    m_ImGuiSnapshot->Capture(*ImGui::GetDrawData());
+    packet.Enqueue([snapshot = m_ImGuiSnapshot.get()](const FramePacket&) {
+        GPU_PROFILE_SCOPE("ImGui");
+        ImGui_ImplOpenGL3_RenderDrawData(&snapshot->Data);
+    });
+
+    // Fence the frame and cap the frames in flight on the render thread
+    packet.Enqueue([pacer = &m_FramePacer, frameStart = m_FramePacer.GetFrameStart()](const FramePacket&) {
+        pacer->EndFrame(frameStart);
+    });
+
+    m_RenderThread->Submit();
+
+    MemoryTracker::EndFrame();
+    m_FrameStats.Update(Time::GetFrameTime() * 1000.0f, m_SystemScheduler);
+    PublishTelemetry();
+}
+
+void Application::ReportStartup() {
+    const u64 now = Profiler::Now();
+    m_StartupTimeMs = std::max(static_cast<f32>(static_cast<f64>(now - m_StartTime) / 1.0e6), 0.001f);
+#ifdef ENGINE_ENABLE_PROFILING
+    Profiler::Record("Startup", m_StartTime, now);
+#endif
+    LOG_CORE_INFO("First frame {:.1f} ms after startup", m_StartupTimeMs);
+
+    // Shaders created from here on are few; read them from disk
+    Shader::ReleasePrefetchedSources();
+}
+
+void Application::PublishTelemetry() {
+    s_CPUTime.Set(m_CPUTimeMs);
+    s_RenderTime.Set(m_RenderTimeMs);
+    s_Hitches.Set(static_cast<f64>(m_FrameStats.GetHitches().Count));
+    s_StartupTime.Set(m_StartupTimeMs);
+    m_SystemScheduler.PublishTelemetry();
+    Telemetry::EndFrame(m_FrameStats.GetFrameNumber(), Time::GetFrameTime() * 1000.0f);
+}
+
+void Application::BuildImGuiFrame() {
+    PROFILE_SCOPE("ImGui");
+    MEMORY_TAG(Editor);
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui_ImplGlfw_NewFrame();
+    ImGui::NewFrame();
+    ImGuizmo::BeginFrame();
+
+    OnImGuiRender();
+    OnPostImGuiRender();
+
+    ImGui::Render();
 }
 
 void Application::Close() {
@@ -118,14 +436,7 @@ void Application::Close() {
 }
 
 void Application::OnEvent(Event& e) {
-    EventDispatcher dispatcher(e);
-    dispatcher.Dispatch<WindowCloseEvent>([this](WindowCloseEvent& event) {
-        return OnWindowClose(event);
-    });
-    dispatcher.Dispatch<WindowResizeEvent>([this](WindowResizeEvent& event) {
-        return OnWindowResize(event);
-    });
-
+    m_EventQueue.Dispatch(e);
     OnAppEvent(e);
 }
 
@@ -141,6 +452,14 @@ bool Application::OnWindowResize(WindowResizeEvent& e) {
     }
 
     m_Minimized = false;
+    if (m_RenderThread) {
+        // No context on this thread; the next packet applies it
+        m_ViewportDirty = true;
+        m_ViewportWidth = e.GetWidth();
+        m_ViewportHeight = e.GetHeight();
+        return false;
+    }
+
     glViewport(0, 0, e.GetWidth(), e.GetHeight());
     return false;
 }
@@ -2,13 +2,20 @@
 
 #include "Types.hpp"
 #include "Window.hpp"
+#include "FrameStats.hpp"
+#include "FramePacer.hpp"
 #include "events/Event.hpp"
+#include "events/EventQueue.hpp"
 #include "events/WindowEvents.hpp"
 #include "ecs/Registry.hpp"
 #include "ecs/SystemScheduler.hpp"
+#include "renderer/FramePacket.hpp"
 
 namespace Engine {
 
+class RenderThread;
+struct ImGuiDrawSnapshot;
+
 class Application {
 public:
     Application(const String& name = "Game Engine", u32 width = 1280, u32 height = 720);
@@ -17,8 +24,14 @@ public:
     void Run();
     void Close();
 
+    // Delivers an event now: the handlers subscribed on the event queue,
+    // then OnAppEvent()
     void OnEvent(Event& e);
 
+    // Window events and anything posted from other threads, drained through
+    // OnEvent() at the start of every frame
+    EventQueue& GetEventQueue() { return m_EventQueue; }
+
     Window& GetWindow() { return *m_Window; }
 
     // ECS access
@@ -27,29 +40,102 @@ public:
     SystemScheduler& GetSystemScheduler() { return m_SystemScheduler; }
     const SystemScheduler& GetSystemScheduler() const { return m_SystemScheduler; }
 
+    FrameStats& GetFrameStats() { return m_FrameStats; }
+
+    // Frame limiter, frames-in-flight cap and latency estimate
+    FramePacer& GetFramePacer() { return m_FramePacer; }
+
+    // Main thread time of the last frame up to the buffer swap
+    f32 GetCPUTimeMs() const { return m_CPUTimeMs; }
+
+    // From construction to the end of the first frame; 0 until then. The
+    // startup tasks are zones of the profiler trace, the whole span a
+    // "Startup" zone.
+    f32 GetStartupTimeMs() const { return m_StartupTimeMs; }
+
+    // Draw on a dedicated render thread, one frame behind the simulation.
+    // Takes effect when Run() starts. In this mode OnRender() and the Render /
+    // PostRender phases are not run: the frame is drawn only from what
+    // OnExtract() records into the FramePacket, and the main thread makes no
+    // GL calls after OnInit(). Render-phase systems read the registry the
+    // next frame's simulation is writing, so they can't move to the render
+    // thread as they are: if any are registered when Run() starts, it logs
+    // them and stays single-threaded. The sandbox demo launcher's
+    // --render-thread mode is the reference client.
+    void SetRenderThreadEnabled(bool enabled) { m_RenderThreadEnabled = enabled; }
+    bool IsRenderThreadEnabled() const { return m_RenderThreadEnabled; }
+
+    // Render thread time of the last packet (0 without a render thread)
+    f32 GetRenderTimeMs() const { return m_RenderTimeMs; }
+
+    // Idle throttling, for tools. At a nonzero rate, once IdleGraceFrames
+    // frames in a row have delivered no events and IsIdle() agrees, the loop
+    // sleeps on window events for up to 1 / fps instead of polling, so an
+    // untouched window runs at that rate and any input wakes it at once.
+    // Events posted from other threads wait for the timeout. 0 = always poll.
+    void SetIdleFrameRate(f32 fps) { m_IdleFrameRate = fps; }
+    f32 GetIdleFrameRate() const { return m_IdleFrameRate; }
+
+    // Quiet frames before the loop may sleep, so UI reacting to the last
+    // input (hover, fades) gets to settle
+    static constexpr u32 IdleGraceFrames = 3;
+
     static Application& Get() { return *s_Instance; }
 
 protected:
     virtual void OnInit() {}
     virtual void OnShutdown() {}
     virtual void OnUpdate(f32 deltaTime) { (void)deltaTime; }
+    // Single-threaded mode only, between the PreRender and Render phases
     virtual void OnRender() {}
+    // Render thread mode: record this frame's drawing, after the PreRender phase
+    virtual void OnExtract(FramePacket& packet) { (void)packet; }
     virtual void OnImGuiRender() {}
     virtual void OnPostImGuiRender() {}
     virtual void OnAppEvent(Event& e) { (void)e; }
 
+    // Whether nothing but input can change what the next frame shows; see
+    // SetIdleFrameRate
+    virtual bool IsIdle() const { return true; }
+
     // ECS members accessible to derived classes
     Registry m_Registry;
     SystemScheduler m_SystemScheduler;
 
 private:
+    void UpdateSimulation(f32 deltaTime);
+    void RunFrame(f32 deltaTime);
+    void RunFrameThreaded(f32 deltaTime);
+    void BuildImGuiFrame();
+    void ReportStartup();
+    void PublishTelemetry();
+
     bool OnWindowClose(WindowCloseEvent& e);
     bool OnWindowResize(WindowResizeEvent& e);
 
 private:
+    EventQueue m_EventQueue;
     Scope<Window> m_Window;
     bool m_Running = true;
     bool m_Minimized = false;
+    FrameStats m_FrameStats;
+    FramePacer m_FramePacer;
+    f32 m_CPUTimeMs = 0.0f;
+    f32 m_RenderTimeMs = 0.0f;
+    u64 m_StartTime = 0;            // Profiler::Now() at construction
+    f32 m_StartupTimeMs = 0.0f;
+    f32 m_IdleFrameRate = 0.0f;
+    u32 m_QuietFrames = 0;          // Frames in a row without events
+
+    bool m_RenderThreadEnabled = false;
+    Scope<RenderThread> m_RenderThread;
+    Scope<ImGuiDrawSnapshot> m_ImGuiSnapshot;   // Last UI frame, drawn by the render thread
+    u64 m_FrameIndex = 0;
+
+    // Resizes seen on the main thread, applied by the next packet
+    bool m_ViewportDirty = false;
+    u32 m_ViewportWidth = 0;
+    u32 m_ViewportHeight = 0;
 
     static Application* s_Instance;
 };
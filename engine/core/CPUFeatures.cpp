@@ -0,0 +1,100 @@
+#include "CPUFeatures.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #define ENGINE_CPU_X86 1
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <cpuid.h>
+    #define ENGINE_CPU_X86 1
+#endif
+
+namespace Engine {
+
+namespace {
+
+struct DetectedFeatures {
+    bool SSE2 = false;
+    bool AVX2 = false;
+    bool NEON = false;
+};
+
+#if defined(ENGINE_CPU_X86)
+void CpuId(u32 leaf, u32 subLeaf, u32 regs[4]) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subLeaf));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<u32>(info[i]);
+#else
+    __cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+u64 ReadXCR0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    u32 eax = 0, edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<u64>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+DetectedFeatures Detect() {
+    DetectedFeatures features;
+
+#if defined(ENGINE_CPU_X86)
+    u32 regs[4] = {};
+    CpuId(0, 0, regs);
+    const u32 maxLeaf = regs[0];
+
+    CpuId(1, 0, regs);
+    features.SSE2 = (regs[3] & (1u << 26)) != 0;
+
+    const bool osxsave = (regs[2] & (1u << 27)) != 0;
+    const bool avx = (regs[2] & (1u << 28)) != 0;
+    const bool fma = (regs[2] & (1u << 12)) != 0;
+
+    // The OS must save XMM and YMM registers on context switch
+    const bool osAvx = osxsave && (ReadXCR0() & 0x6) == 0x6;
+
+    if (maxLeaf >= 7 && avx && fma && osAvx) {
+        CpuId(7, 0, regs);
+        features.AVX2 = (regs[1] & (1u << 5)) != 0;
+    }
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    features.NEON = true;
+#endif
+
+    return features;
+}
+
+const DetectedFeatures& GetFeatures() {
+    static const DetectedFeatures features = Detect();
+    return features;
+}
+
+} // anonymous namespace
+
+bool CPUFeatures::HasSSE2() { return GetFeatures().SSE2; }
+bool CPUFeatures::HasAVX2() { return GetFeatures().AVX2; }
+bool CPUFeatures::HasNEON() { return GetFeatures().NEON; }
+
+SimdLevel CPUFeatures::GetBestSimdLevel() {
+    if (HasAVX2()) return SimdLevel::AVX2;
+    if (HasSSE2()) return SimdLevel::SSE2;
+    if (HasNEON()) return SimdLevel::NEON;
+    return SimdLevel::Scalar;
+}
+
+bool CPUFeatures::IsSupported(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return true;
+        case SimdLevel::SSE2:   return HasSSE2();
+        case SimdLevel::AVX2:   return HasAVX2();
+        case SimdLevel::NEON:   return HasNEON();
+        default:                return false;
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Types.hpp"
+
+namespace Engine {
+
+// SIMD instruction sets usable by vectorized kernels, ordered by preference
+enum class SimdLevel : u8 {
+    Scalar = 0,
+    SSE2,
+    AVX2,
+    NEON
+};
+
+inline const char* SimdLevelToString(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "Scalar";
+        case SimdLevel::SSE2:   return "SSE2";
+        case SimdLevel::AVX2:   return "AVX2";
+        case SimdLevel::NEON:   return "NEON";
+        default:                return "Unknown";
+    }
+}
+
+// Runtime CPU feature detection (queried once, cached)
+class CPUFeatures {
+public:
+    static bool HasSSE2();
+    static bool HasAVX2();   // AVX2 + FMA with OS support for YMM state
+    static bool HasNEON();
+
+    // Best SIMD level available on this machine
+    static SimdLevel GetBestSimdLevel();
+
+    static bool IsSupported(SimdLevel level);
+};
+
+} // namespace Engine
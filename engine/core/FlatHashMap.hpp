@@ -0,0 +1,475 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ENGINE_FLAT_HASH_SSE2
+#endif
+
+namespace Engine {
+
+namespace FlatHashDetail {
+
+// One control byte per slot. Full slots hold the top 7 bits of their
+// key's hash, so the high bit tells free from full.
+using Control = std::int8_t;
+constexpr Control Empty = -128;     // 0b10000000
+constexpr Control Deleted = -2;     // 0b11111110
+
+constexpr std::size_t GroupWidth = 16;
+
+// The control bytes of GroupWidth consecutive slots; each query is a bit
+// per slot
+class Group {
+public:
+    explicit Group(const Control* control) {
+#if defined(ENGINE_FLAT_HASH_SSE2)
+        m_Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+#else
+        for (std::size_t i = 0; i < GroupWidth; ++i) m_Bytes[i] = control[i];
+#endif
+    }
+
+    std::uint32_t Match(Control h2) const {
+#if defined(ENGINE_FLAT_HASH_SSE2)
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_Bytes)));
+#else
+        std::uint32_t bits = 0;
+        for (std::size_t i = 0; i < GroupWidth; ++i) bits |= static_cast<std::uint32_t>(m_Bytes[i] == h2) << i;
+        return bits;
+#endif
+    }
+
+    std::uint32_t MatchEmpty() const { return Match(Empty); }
+
+    std::uint32_t MatchFree() const {
+#if defined(ENGINE_FLAT_HASH_SSE2)
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(m_Bytes));
+#else
+        std::uint32_t bits = 0;
+        for (std::size_t i = 0; i < GroupWidth; ++i) bits |= static_cast<std::uint32_t>(m_Bytes[i] < 0) << i;
+        return bits;
+#endif
+    }
+
+private:
+#if defined(ENGINE_FLAT_HASH_SSE2)
+    __m128i m_Bytes;
+#else
+    Control m_Bytes[GroupWidth];
+#endif
+};
+
+inline std::uint32_t LowestBit(std::uint32_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::uint32_t>(__builtin_ctz(bits));
+#else
+    std::uint32_t index = 0;
+    while (!(bits & 1u)) { bits >>= 1; ++index; }
+    return index;
+#endif
+}
+
+// std::hash of integers and pointers is the identity; spread every input
+// bit over the whole word before splitting it into group and tag
+inline std::uint64_t Mix(std::size_t hash) {
+    std::uint64_t h = static_cast<std::uint64_t>(hash);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+} // namespace FlatHashDetail
+
+// FlatHashMap - open-addressing hash map in the style of a swiss table.
+//
+// Keys and values live inline in one flat slot array next to an array of
+// control bytes, a 7-bit hash tag per slot. Lookups probe a group of 16
+// slots at a time: one SSE2 compare of the group's control bytes against
+// the key's tag yields every candidate slot, so a lookup usually reads one
+// control line and one slot, where std::unordered_map chases a bucket and
+// then a node pointer. The table grows at 7/8 load; erased slots become
+// tombstones only when their group is full, so probe chains stay short.
+//
+// This is what the HashMap alias (core/Types.hpp) is. It follows the
+// std::unordered_map interface the engine uses, with one difference:
+// inserting may move every element, so references, pointers and iterators
+// into the map do not survive an insertion - look the element up again.
+// Erasing leaves the others where they are.
+template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class FlatHashMap {
+    using Control = FlatHashDetail::Control;
+    static constexpr std::size_t GroupWidth = FlatHashDetail::GroupWidth;
+
+    union Slot {
+        Slot() {}
+        ~Slot() {}
+        std::pair<const K, V> Value;
+    };
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<const K, V>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+    template<bool IsConst>
+    class Iterator {
+        using Map = std::conditional_t<IsConst, const FlatHashMap, FlatHashMap>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = FlatHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+        using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+
+        Iterator() = default;
+
+        // iterator converts to const_iterator
+        template<bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        Iterator(const Iterator<OtherConst>& other) : m_Map(other.m_Map), m_Index(other.m_Index) {}
+
+        reference operator*() const { return m_Map->m_Slots[m_Index].Value; }
+        pointer operator->() const { return &m_Map->m_Slots[m_Index].Value; }
+
+        Iterator& operator++() {
+            m_Index = m_Map->NextFull(m_Index + 1);
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.m_Index == b.m_Index; }
+        friend bool operator!=(const Iterator& a, const Iterator& b) { return a.m_Index != b.m_Index; }
+
+    private:
+        friend class FlatHashMap;
+        template<bool> friend class Iterator;
+
+        Iterator(Map* map, size_type index) : m_Map(map), m_Index(index) {}
+
+        Map* m_Map = nullptr;
+        size_type m_Index = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatHashMap() = default;
+
+    FlatHashMap(std::initializer_list<value_type> values) {
+        reserve(values.size());
+        for (const value_type& value : values) insert(value);
+    }
+
+    FlatHashMap(const FlatHashMap& other) : m_Hash(other.m_Hash), m_Equal(other.m_Equal) {
+        reserve(other.size());
+        for (const value_type& value : other) insert(value);
+    }
+
+    FlatHashMap(FlatHashMap&& other) noexcept { swap(other); }
+
+    FlatHashMap& operator=(const FlatHashMap& other) {
+        if (this != &other) {
+            FlatHashMap copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    FlatHashMap& operator=(FlatHashMap&& other) noexcept {
+        if (this != &other) {
+            Release();
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~FlatHashMap() { Release(); }
+
+    iterator begin() { return iterator(this, NextFull(0)); }
+    iterator end() { return iterator(this, m_Capacity); }
+    const_iterator begin() const { return const_iterator(this, NextFull(0)); }
+    const_iterator end() const { return const_iterator(this, m_Capacity); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_type size() const { return m_Size; }
+    bool empty() const { return m_Size == 0; }
+    size_type capacity() const { return m_Capacity; }
+
+    // Destroys every element; the table is kept
+    void clear() {
+        if (m_Size > 0) {
+            for (size_type i = 0; i < m_Capacity; ++i) {
+                if (IsFull(m_Control[i])) std::destroy_at(&m_Slots[i].Value);
+            }
+        }
+        std::fill(m_Control, m_Control + m_Capacity, FlatHashDetail::Empty);
+        m_Size = 0;
+        m_GrowthLeft = MaxLoad(m_Capacity);
+    }
+
+    // Room for count elements without growing
+    void reserve(size_type count) {
+        size_type capacity = m_Capacity == 0 ? GroupWidth : m_Capacity;
+        while (MaxLoad(capacity) < count) capacity *= 2;
+        if (capacity != m_Capacity) Resize(capacity);
+    }
+
+    iterator find(const K& key) { return iterator(this, FindIndex(key, HashOf(key))); }
+    const_iterator find(const K& key) const { return const_iterator(this, FindIndex(key, HashOf(key))); }
+    bool contains(const K& key) const { return FindIndex(key, HashOf(key)) != m_Capacity; }
+    size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+    V& at(const K& key) {
+        const size_type index = FindIndex(key, HashOf(key));
+        if (index == m_Capacity) throw std::out_of_range("FlatHashMap::at");
+        return m_Slots[index].Value.second;
+    }
+
+    const V& at(const K& key) const {
+        const size_type index = FindIndex(key, HashOf(key));
+        if (index == m_Capacity) throw std::out_of_range("FlatHashMap::at");
+        return m_Slots[index].Value.second;
+    }
+
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+    V& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        return EmplaceKey(key, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        return EmplaceKey(std::move(key), std::forward<Args>(args)...);
+    }
+
+    // Builds a key / value pair from args, then inserts it if the key is new
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        std::pair<K, V> value(std::forward<Args>(args)...);
+        return EmplaceKey(std::move(value.first), std::move(value.second));
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) { return EmplaceKey(value.first, value.second); }
+
+    template<typename P, typename = std::enable_if_t<std::is_constructible_v<std::pair<K, V>, P&&>>>
+    std::pair<iterator, bool> insert(P&& value) {
+        return emplace(std::forward<P>(value));
+    }
+
+    template<typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first) insert(*first);
+    }
+
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& value) {
+        auto result = EmplaceKey(key, std::forward<M>(value));
+        if (!result.second) result.first->second = std::forward<M>(value);
+        return result;
+    }
+
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(K&& key, M&& value) {
+        auto result = EmplaceKey(std::move(key), std::forward<M>(value));
+        if (!result.second) result.first->second = std::forward<M>(value);
+        return result;
+    }
+
+    // Iterator to the element after position
+    iterator erase(const_iterator position) {
+        EraseAt(position.m_Index);
+        return iterator(this, NextFull(position.m_Index + 1));
+    }
+
+    iterator erase(iterator position) { return erase(const_iterator(position)); }
+
+    size_type erase(const K& key) {
+        const size_type index = FindIndex(key, HashOf(key));
+        if (index == m_Capacity) return 0;
+        EraseAt(index);
+        return 1;
+    }
+
+    void swap(FlatHashMap& other) noexcept {
+        std::swap(m_Control, other.m_Control);
+        std::swap(m_Slots, other.m_Slots);
+        std::swap(m_Capacity, other.m_Capacity);
+        std::swap(m_Size, other.m_Size);
+        std::swap(m_GrowthLeft, other.m_GrowthLeft);
+        std::swap(m_Hash, other.m_Hash);
+        std::swap(m_Equal, other.m_Equal);
+    }
+
+    friend bool operator==(const FlatHashMap& a, const FlatHashMap& b) {
+        if (a.size() != b.size()) return false;
+        for (const value_type& value : a) {
+            auto it = b.find(value.first);
+            if (it == b.end() || !(it->second == value.second)) return false;
+        }
+        return true;
+    }
+
+private:
+    static bool IsFull(Control control) { return control >= 0; }
+    static Control Tag(std::uint64_t hash) { return static_cast<Control>(hash >> 57); }
+    static size_type MaxLoad(size_type capacity) { return capacity - capacity / 8; }
+
+    std::uint64_t HashOf(const K& key) const { return FlatHashDetail::Mix(m_Hash(key)); }
+
+    // Slot index of key, or m_Capacity
+    size_type FindIndex(const K& key, std::uint64_t hash) const {
+        if (m_Capacity == 0) return 0;
+
+        const Control tag = Tag(hash);
+        const size_type groupMask = m_Capacity / GroupWidth - 1;
+        size_type group = static_cast<size_type>(hash) & groupMask;
+
+        // Triangular steps visit every group of a power-of-two table
+        for (size_type step = 1;; ++step) {
+            const size_type base = group * GroupWidth;
+            const FlatHashDetail::Group controls(m_Control + base);
+            for (std::uint32_t bits = controls.Match(tag); bits; bits &= bits - 1) {
+                const size_type index = base + FlatHashDetail::LowestBit(bits);
+                if (m_Equal(m_Slots[index].Value.first, key)) return index;
+            }
+            // An insertion would have stopped here
+            if (controls.MatchEmpty()) return m_Capacity;
+            group = (group + step) & groupMask;
+        }
+    }
+
+    // First empty or deleted slot on hash's probe sequence
+    size_type FindFree(std::uint64_t hash) const {
+        const size_type groupMask = m_Capacity / GroupWidth - 1;
+        size_type group = static_cast<size_type>(hash) & groupMask;
+        for (size_type step = 1;; ++step) {
+            const size_type base = group * GroupWidth;
+            const std::uint32_t bits = FlatHashDetail::Group(m_Control + base).MatchFree();
+            if (bits) return base + FlatHashDetail::LowestBit(bits);
+            group = (group + step) & groupMask;
+        }
+    }
+
+    size_type NextFull(size_type index) const {
+        while (index < m_Capacity && !IsFull(m_Control[index])) ++index;
+        return index;
+    }
+
+    template<typename Key, typename... Args>
+    std::pair<iterator, bool> EmplaceKey(Key&& key, Args&&... args) {
+        const std::uint64_t hash = HashOf(key);
+        const size_type found = FindIndex(key, hash);
+        if (found != m_Capacity) return {iterator(this, found), false};
+
+        if (m_Capacity == 0) Resize(GroupWidth);
+        size_type index = FindFree(hash);
+        if (m_GrowthLeft == 0 && m_Control[index] == FlatHashDetail::Empty) {
+            // Out of empty slots; a table mostly of tombstones is only rehashed
+            Resize(m_Size < MaxLoad(m_Capacity) / 2 ? m_Capacity : m_Capacity * 2);
+            index = FindFree(hash);
+        }
+
+        std::construct_at(&m_Slots[index].Value, std::piecewise_construct,
+                          std::forward_as_tuple(std::forward<Key>(key)),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+        m_GrowthLeft -= m_Control[index] == FlatHashDetail::Empty ? 1 : 0;
+        m_Control[index] = Tag(hash);
+        ++m_Size;
+        return {iterator(this, index), true};
+    }
+
+    void EraseAt(size_type index) {
+        std::destroy_at(&m_Slots[index].Value);
+        --m_Size;
+
+        // A group that still has an empty slot ends every probe through
+        // it, so nothing can be past this slot: no tombstone needed
+        const size_type base = index & ~(GroupWidth - 1);
+        if (FlatHashDetail::Group(m_Control + base).MatchEmpty()) {
+            m_Control[index] = FlatHashDetail::Empty;
+            ++m_GrowthLeft;
+        } else {
+            m_Control[index] = FlatHashDetail::Deleted;
+        }
+    }
+
+    void Resize(size_type capacity) {
+        Control* oldControl = m_Control;
+        Slot* oldSlots = m_Slots;
+        const size_type oldCapacity = m_Capacity;
+
+        m_Control = new Control[capacity];
+        m_Slots = std::allocator<Slot>().allocate(capacity);
+        m_Capacity = capacity;
+        std::fill(m_Control, m_Control + capacity, FlatHashDetail::Empty);
+
+        for (size_type i = 0; i < oldCapacity; ++i) {
+            if (!IsFull(oldControl[i])) continue;
+
+            value_type& value = oldSlots[i].Value;
+            const std::uint64_t hash = HashOf(value.first);
+            const size_type index = FindFree(hash);
+            // The old element is destroyed right after, so its key may be
+            // moved from like a node handle's
+            std::construct_at(&m_Slots[index].Value, std::move(const_cast<K&>(value.first)), std::move(value.second));
+            m_Control[index] = Tag(hash);
+            std::destroy_at(&value);
+        }
+        m_GrowthLeft = MaxLoad(capacity) - m_Size;
+
+        if (oldControl) {
+            delete[] oldControl;
+            std::allocator<Slot>().deallocate(oldSlots, oldCapacity);
+        }
+    }
+
+    void Release() {
+        if (!m_Control) return;
+        clear();
+        delete[] m_Control;
+        std::allocator<Slot>().deallocate(m_Slots, m_Capacity);
+        m_Control = nullptr;
+        m_Slots = nullptr;
+        m_Capacity = 0;
+        m_GrowthLeft = 0;
+    }
+
+private:
+    Control* m_Control = nullptr;
+    Slot* m_Slots = nullptr;
+    size_type m_Capacity = 0;       // Power of two, a multiple of GroupWidth
+    size_type m_Size = 0;
+    size_type m_GrowthLeft = 0;     // Empty slots that may still be filled before growing
+    [[no_unique_address]] Hash m_Hash;
+    [[no_unique_address]] KeyEqual m_Equal;
+};
+
+} // namespace Engine
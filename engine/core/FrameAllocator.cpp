@@ -0,0 +1,130 @@
+#include "FrameAllocator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace Engine {
+
+namespace {
+
+std::atomic<u64> s_FrameIndex{0};
+
+struct Block {
+    Scope<u8[]> Data;
+    usize Size = 0;
+    usize Offset = 0;
+};
+
+struct Buffer {
+    Vector<Block> Blocks;       // Blocks.back() is the one being filled
+    u64 Frame = ~0ull;
+
+    usize GetUsed() const {
+        usize used = 0;
+        for (const auto& block : Blocks) used += block.Offset;
+        return used;
+    }
+
+    usize GetCapacity() const {
+        usize capacity = 0;
+        for (const auto& block : Blocks) capacity += block.Size;
+        return capacity;
+    }
+};
+
+Block MakeBlock(usize size) {
+    // Not make_unique: the bytes do not need zeroing
+    return Block{Scope<u8[]>(new u8[size]), size, 0};
+}
+
+u8* AlignPointer(u8* pointer, usize alignment) {
+    const auto address = reinterpret_cast<std::uintptr_t>(pointer);
+    const auto aligned = (address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    return pointer + (aligned - address);
+}
+
+class ThreadArena {
+public:
+    void* Allocate(usize size, usize alignment) {
+        Buffer& buffer = GetBuffer();
+        if (buffer.Blocks.empty()) {
+            buffer.Blocks.push_back(MakeBlock(std::max(FrameArena::InitialCapacity, size + alignment)));
+        }
+
+        if (void* pointer = TryAllocate(buffer.Blocks.back(), size, alignment)) {
+            return pointer;
+        }
+
+        // Overflow: chain a block for the rest of this frame, merged on the next rewind
+        const usize blockSize = std::max(buffer.Blocks.back().Size * 2, size + alignment);
+        buffer.Blocks.push_back(MakeBlock(blockSize));
+        return TryAllocate(buffer.Blocks.back(), size, alignment);
+    }
+
+    FrameArena::Stats GetStats() {
+        const Buffer& buffer = GetBuffer();
+        return FrameArena::Stats{buffer.GetUsed(), buffer.GetCapacity(), m_PeakUsed};
+    }
+
+private:
+    static void* TryAllocate(Block& block, usize size, usize alignment) {
+        u8* begin = block.Data.get() + block.Offset;
+        u8* aligned = AlignPointer(begin, alignment);
+        const usize end = static_cast<usize>(aligned - block.Data.get()) + size;
+        if (end > block.Size) return nullptr;
+        block.Offset = end;
+        return aligned;
+    }
+
+    // The buffer for the current frame, rewound if it last served an older one
+    Buffer& GetBuffer() {
+        const u64 frame = s_FrameIndex.load(std::memory_order_relaxed);
+        Buffer& buffer = m_Buffers[frame & 1];
+        if (buffer.Frame != frame) {
+            Rewind(buffer);
+            buffer.Frame = frame;
+        }
+        return buffer;
+    }
+
+    void Rewind(Buffer& buffer) {
+        const usize used = buffer.GetUsed();
+        m_PeakUsed = std::max(m_PeakUsed, used);
+
+        if (buffer.Blocks.size() > 1) {
+            // One block big enough for everything the frame needed
+            const usize capacity = std::max(buffer.GetCapacity(), used + used / 4);
+            buffer.Blocks.clear();
+            buffer.Blocks.push_back(MakeBlock(capacity));
+        } else if (!buffer.Blocks.empty()) {
+            buffer.Blocks.front().Offset = 0;
+        }
+    }
+
+private:
+    Buffer m_Buffers[2];
+    usize m_PeakUsed = 0;
+};
+
+thread_local ThreadArena t_Arena;
+
+} // anonymous namespace
+
+void FrameArena::BeginFrame() {
+    s_FrameIndex.fetch_add(1, std::memory_order_relaxed);
+}
+
+u64 FrameArena::GetFrameIndex() {
+    return s_FrameIndex.load(std::memory_order_relaxed);
+}
+
+void* FrameArena::Allocate(usize size, usize alignment) {
+    return t_Arena.Allocate(size, std::max<usize>(alignment, 1));
+}
+
+FrameArena::Stats FrameArena::GetThreadStats() {
+    return t_Arena.GetStats();
+}
+
+} // namespace Engine
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Types.hpp"
+#include <limits>
+#include <new>
+
+namespace Engine {
+
+// FrameArena - double-buffered per-thread linear allocator for data that
+// lives no longer than a frame or two.
+//
+// Every thread (the main thread and each JobSystem worker) owns two arenas
+// and bump-allocates from the one belonging to the current frame; freeing is
+// a no-op. BeginFrame(), called by Application::Run at the top of every frame,
+// only advances a frame counter: each thread rewinds its arena for the new
+// frame on its own next allocation, so no thread touches another's memory.
+// An allocation made during frame N therefore stays valid until frame N + 2
+// begins - long enough to hand this frame's lists to the next one, and no
+// longer. Jobs that outlive a frame must not use it.
+//
+// Blocks are kept across frames. A frame that overflows its arena gets an
+// extra block, and the arena is re-sized to that frame's total when it is
+// next rewound, so a steady-state frame does no heap allocation at all.
+class FrameArena {
+public:
+    static constexpr usize InitialCapacity = 256 * 1024;
+
+    static void BeginFrame();
+    static u64 GetFrameIndex();
+
+    // From the calling thread's arena for the current frame
+    static void* Allocate(usize size, usize alignment);
+
+    struct Stats {
+        usize Used = 0;         // This frame, calling thread
+        usize Capacity = 0;
+        usize PeakUsed = 0;     // Largest frame so far, either buffer
+    };
+    static Stats GetThreadStats();
+};
+
+// Stateless STL allocator over FrameArena. Containers built with it must
+// not outlive the frame after the one they were filled in.
+template<typename T>
+class FrameAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    FrameAllocator() noexcept = default;
+
+    template<typename U>
+    FrameAllocator(const FrameAllocator<U>&) noexcept {}
+
+    T* allocate(usize count) {
+        if (count > std::numeric_limits<usize>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(FrameArena::Allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, usize) noexcept {}
+
+    template<typename U>
+    bool operator==(const FrameAllocator<U>&) const noexcept { return true; }
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>;
+
+} // namespace Engine
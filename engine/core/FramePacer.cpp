@@ -0,0 +1,104 @@
+#include "FramePacer.hpp"
+#include "Profiler.hpp"
+#include "Input.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace Engine {
+
+namespace {
+
+f32 ToMs(u64 nanoseconds) {
+    return static_cast<f32>(static_cast<f64>(nanoseconds) / 1.0e6);
+}
+
+} // anonymous namespace
+
+void FramePacer::BeginFrame() {
+    u64 now = Profiler::Now();
+    m_Stats.LimiterWaitMs = 0.0f;
+
+    if (m_Settings.TargetFPS > 0.0f) {
+        PROFILE_SCOPE("FrameLimiter");
+        const u64 period = static_cast<u64>(1.0e9 / static_cast<f64>(m_Settings.TargetFPS));
+        const u64 waitStart = now;
+
+        const u64 pollPeriod = m_Settings.InputPollRate > 0.0f
+            ? static_cast<u64>(1.0e9 / static_cast<f64>(m_Settings.InputPollRate))
+            : 0;
+        while (now + SpinMargin < m_NextFrameTime) {
+            const u64 remaining = m_NextFrameTime - now - SpinMargin;
+            if (pollPeriod == 0) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(remaining));
+                now = Profiler::Now();
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::nanoseconds(std::min(remaining, pollPeriod)));
+            Input::Poll();
+            now = Profiler::Now();
+        }
+        while ((now = Profiler::Now()) < m_NextFrameTime) {
+            std::this_thread::yield();
+        }
+        m_Stats.LimiterWaitMs = ToMs(now - waitStart);
+
+        // Keep the cadence; after a slow frame start over instead of bursting
+        m_NextFrameTime = (now - m_NextFrameTime < period) ? m_NextFrameTime + period : now + period;
+    }
+
+    m_FrameStart = now;
+}
+
+void FramePacer::EndFrame(u64 frameStart) {
+    PendingFrame frame;
+    frame.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frame.Start = frameStart;
+    m_Pending.push_back(frame);
+
+    // Retire what the GPU has already finished
+    while (!m_Pending.empty()) {
+        const GLenum status = glClientWaitSync(static_cast<GLsync>(m_Pending.front().Fence), 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+        RetireFrame(Profiler::Now());
+    }
+
+    // Too far ahead: wait for the oldest frame
+    m_Stats.QueueWaitMs = 0.0f;
+    if (m_Settings.MaxFramesInFlight > 0) {
+        PROFILE_SCOPE("FramePacer::WaitGPU");
+        const u64 waitStart = Profiler::Now();
+        while (m_Pending.size() > m_Settings.MaxFramesInFlight) {
+            glClientWaitSync(static_cast<GLsync>(m_Pending.front().Fence), GL_SYNC_FLUSH_COMMANDS_BIT,
+                             GL_TIMEOUT_IGNORED);
+            RetireFrame(Profiler::Now());
+        }
+        m_Stats.QueueWaitMs = ToMs(Profiler::Now() - waitStart);
+    }
+
+    m_Stats.FramesInFlight = static_cast<u32>(m_Pending.size());
+}
+
+void FramePacer::RetireFrame(u64 now) {
+    const PendingFrame& frame = m_Pending.front();
+
+    m_Stats.LastLatencyMs = ToMs(now - frame.Start);
+    m_Stats.LatencyMs = m_Stats.LatencyMs == 0.0f
+        ? m_Stats.LastLatencyMs
+        : m_Stats.LatencyMs + (m_Stats.LastLatencyMs - m_Stats.LatencyMs) * 0.1f;
+
+    glDeleteSync(static_cast<GLsync>(frame.Fence));
+    m_Pending.erase(m_Pending.begin());
+}
+
+void FramePacer::Shutdown() {
+    for (const auto& frame : m_Pending) {
+        glDeleteSync(static_cast<GLsync>(frame.Fence));
+    }
+    m_Pending.clear();
+    m_Stats.FramesInFlight = 0;
+}
+
+} // namespace Engine
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Types.hpp"
+
+namespace Engine {
+
+// FramePacer - frame limiter and CPU/GPU queue depth control.
+//
+// BeginFrame() runs before input is sampled and holds the frame back until
+// the target frame time has passed: it sleeps while more than SpinMargin
+// remains (the OS can overshoot a sleep by about a millisecond), then spins.
+// The sleep is cut into slices of 1 / InputPollRate with window events
+// polled between them, so input arriving during the wait is timestamped
+// when it arrives rather than all at once at the top of the next frame.
+// EndFrame() fences the frame's GL work and, when more than
+// MaxFramesInFlight frames are still queued on the GPU, blocks until the
+// oldest one finishes. Fewer frames in flight means input sampled later
+// relative to display, at the cost of GPU idle bubbles.
+//
+// Latency is estimated per frame as the time from BeginFrame (input
+// sampling) to the frame's fence signalling. It is a lower bound on
+// input-to-photon latency: scan-out adds up to one refresh on top. A
+// fence is only checked once per frame unless the pacer has to wait on it,
+// so a sample can be late by up to one frame.
+class FramePacer {
+public:
+    static constexpr u64 SpinMargin = 2'000'000;   // ns
+
+    struct Settings {
+        f32 TargetFPS = 0.0f;           // 0 = no limit (vsync still applies)
+        u32 MaxFramesInFlight = 2;      // 0 = leave queuing to the driver
+        f32 InputPollRate = 1000.0f;    // Hz while the limiter waits; 0 = sleep through
+    };
+
+    struct Stats {
+        f32 LatencyMs = 0.0f;           // Smoothed input-to-GPU-done estimate
+        f32 LastLatencyMs = 0.0f;
+        f32 LimiterWaitMs = 0.0f;       // Held back by the frame limiter, last frame
+        f32 QueueWaitMs = 0.0f;         // Blocked on a frame in flight, last frame
+        u32 FramesInFlight = 0;
+    };
+
+    FramePacer() = default;
+    ~FramePacer() = default;
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    Settings& GetSettings() { return m_Settings; }
+    const Settings& GetSettings() const { return m_Settings; }
+    const Stats& GetStats() const { return m_Stats; }
+
+    // Main thread, at the top of the frame before input is sampled
+    void BeginFrame();
+
+    // When the current frame began (Profiler::Now() clock)
+    u64 GetFrameStart() const { return m_FrameStart; }
+
+    // GL thread, after the last GL command of the frame that began at frameStart
+    void EndFrame(u64 frameStart);
+
+    // GL thread; forgets the frames still in flight
+    void Shutdown();
+
+private:
+    void RetireFrame(u64 now);
+
+private:
+    struct PendingFrame {
+        void* Fence = nullptr;          // GLsync
+        u64 Start = 0;
+    };
+
+    Settings m_Settings;
+    Stats m_Stats;
+
+    u64 m_FrameStart = 0;
+    u64 m_NextFrameTime = 0;
+    Vector<PendingFrame> m_Pending;     // Oldest first
+};
+
+} // namespace Engine
@@ -0,0 +1,333 @@
+#include "FrameRecorder.hpp"
+#include "Input.hpp"
+#include "Logger.hpp"
+#include "MappedFile.hpp"
+#include "Profiler.hpp"
+#include "Time.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace Engine {
+
+namespace {
+
+static_assert(sizeof(FrameRecorder::FileHeader) == 32);
+static_assert(sizeof(FrameRecorder::FrameHeader) == 24);
+static_assert(sizeof(FrameRecorder::SampleRecord) == 8);
+
+// Camera poses further apart than this count as a divergence
+constexpr f32 CameraPositionTolerance = 1e-3f;
+constexpr f32 CameraDirectionTolerance = 1e-4f;     // 1 - cos(angle)
+
+bool HasValue(InputSampleType type) {
+    return type == InputSampleType::CursorPosition || type == InputSampleType::Scroll;
+}
+
+// Recording: the frame being built, written when the next one begins
+std::FILE* s_File = nullptr;
+String s_RecordPath;
+FrameRecorder::FrameHeader s_Frame{};
+Vector<u8> s_FrameData;             // Samples of s_Frame
+f32 s_Camera[6] = {};
+bool s_HasFrame = false;
+u32 s_RecordedFrames = 0;
+
+// Replay
+MappedFile s_Log;
+Vector<usize> s_FrameOffsets;       // Into s_Log, one per frame
+u32 s_ReplayFrame = 0;
+u64 s_ReplayClock = 0;              // End of the last replayed interval
+Vector<InputSample> s_ReplaySamples;
+f32 s_ExpectedCamera[6] = {};
+bool s_ExpectCamera = false;
+bool s_Diverged = false;
+
+template<typename T>
+void Append(Vector<u8>& data, const T& value) {
+    const auto* bytes = reinterpret_cast<const u8*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+T Read(const u8* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+void WriteFrame() {
+    if (!s_HasFrame) return;
+    std::fwrite(&s_Frame, sizeof(s_Frame), 1, s_File);
+    if (!s_FrameData.empty()) {
+        std::fwrite(s_FrameData.data(), 1, s_FrameData.size(), s_File);
+    }
+    if (s_Frame.Flags & FrameRecorder::FrameHasCamera) {
+        std::fwrite(s_Camera, sizeof(s_Camera), 1, s_File);
+    }
+    s_HasFrame = false;
+    s_RecordedFrames++;
+}
+
+void RecordFrame() {
+    WriteFrame();
+
+    const u64 start = Input::GetIntervalStart();
+    const u64 end = Input::GetIntervalEnd();
+    const auto& samples = Input::GetSamples();
+
+    s_Frame.DeltaTime = Time::GetDeltaTime();
+    s_Frame.FrameTime = Time::GetFrameTime();
+    s_Frame.IntervalLength = end - start;
+    s_Frame.SampleCount = static_cast<u32>(samples.size());
+    s_Frame.Flags = 0;
+
+    s_FrameData.clear();
+    for (const InputSample& sample : samples) {
+        const u64 offset = std::clamp(sample.Time, start, end) - start;
+
+        FrameRecorder::SampleRecord record;
+        record.Offset = static_cast<u32>(std::min<u64>(offset / 1000, ~0u));
+        record.Type = static_cast<u8>(sample.Type);
+        record.Pressed = sample.Pressed ? 1 : 0;
+        record.Code = static_cast<u16>(std::max(sample.Code, 0));
+        Append(s_FrameData, record);
+        if (HasValue(sample.Type)) {
+            Append(s_FrameData, sample.Value.x);
+            Append(s_FrameData, sample.Value.y);
+        }
+    }
+    s_HasFrame = true;
+}
+
+// Offsets of every frame in the log; false if it is cut short
+bool IndexFrames(const u8* data, usize size) {
+    usize offset = sizeof(FrameRecorder::FileHeader);
+    while (offset < size) {
+        if (size - offset < sizeof(FrameRecorder::FrameHeader)) return false;
+        const usize frameStart = offset;
+        const auto frame = Read<FrameRecorder::FrameHeader>(data + offset);
+        offset += sizeof(FrameRecorder::FrameHeader);
+
+        for (u32 i = 0; i < frame.SampleCount; ++i) {
+            if (size - offset < sizeof(FrameRecorder::SampleRecord)) return false;
+            const auto record = Read<FrameRecorder::SampleRecord>(data + offset);
+            offset += sizeof(FrameRecorder::SampleRecord);
+            if (HasValue(static_cast<InputSampleType>(record.Type))) {
+                if (size - offset < 2 * sizeof(f32)) return false;
+                offset += 2 * sizeof(f32);
+            }
+        }
+        if (frame.Flags & FrameRecorder::FrameHasCamera) {
+            if (size - offset < 6 * sizeof(f32)) return false;
+            offset += 6 * sizeof(f32);
+        }
+        s_FrameOffsets.push_back(frameStart);
+    }
+    return true;
+}
+
+void ReplayFrame() {
+    const u8* data = s_Log.Data();
+    usize offset = s_FrameOffsets[s_ReplayFrame];
+    const auto frame = Read<FrameRecorder::FrameHeader>(data + offset);
+    offset += sizeof(FrameRecorder::FrameHeader);
+
+    const u64 start = s_ReplayClock;
+    const u64 end = start + frame.IntervalLength;
+
+    s_ReplaySamples.clear();
+    for (u32 i = 0; i < frame.SampleCount; ++i) {
+        const auto record = Read<FrameRecorder::SampleRecord>(data + offset);
+        offset += sizeof(FrameRecorder::SampleRecord);
+
+        InputSample sample;
+        sample.Time = std::min(start + static_cast<u64>(record.Offset) * 1000, end);
+        sample.Type = static_cast<InputSampleType>(record.Type);
+        sample.Pressed = record.Pressed != 0;
+        sample.Code = record.Code;
+        if (HasValue(sample.Type)) {
+            sample.Value.x = Read<f32>(data + offset);
+            sample.Value.y = Read<f32>(data + offset + sizeof(f32));
+            offset += 2 * sizeof(f32);
+        }
+        s_ReplaySamples.push_back(sample);
+    }
+
+    s_ExpectCamera = (frame.Flags & FrameRecorder::FrameHasCamera) != 0;
+    if (s_ExpectCamera) {
+        std::memcpy(s_ExpectedCamera, data + offset, sizeof(s_ExpectedCamera));
+    }
+
+    Input::Replay(s_ReplaySamples, start, end);
+    Time::OverrideDeltaTime(frame.DeltaTime);
+
+    s_ReplayClock = end;
+    s_ReplayFrame++;
+}
+
+} // anonymous namespace
+
+bool FrameRecorder::StartRecording(const String& path) {
+    StopRecording();
+    StopReplay();
+
+    s_File = std::fopen(path.c_str(), "wb");
+    if (!s_File) {
+        LOG_CORE_ERROR("FrameRecorder: Failed to open {} for writing", path);
+        return false;
+    }
+
+    const glm::vec2 mouse = Input::GetMousePosition();
+    FileHeader header{};
+    header.Magic = Magic;
+    header.Version = Version;
+    header.SimulationStep = Time::GetSimulationStep();
+    header.MaxSimulationSteps = Time::GetMaxSimulationSteps();
+    header.SimulationAccumulator = Time::GetSimulationAccumulator();
+    header.FixedDeltaTime = Time::GetFixedDeltaTime();
+    header.MouseX = mouse.x;
+    header.MouseY = mouse.y;
+    std::fwrite(&header, sizeof(header), 1, s_File);
+
+    // Start from nothing held, like the replay will, and press again what
+    // is down now so the first frame carries it
+    Vector<i32> heldKeys;
+    Vector<i32> heldButtons;
+    for (i32 key = 0; key < Input::MAX_KEYS; ++key) {
+        if (Input::IsKeyPressed(key)) heldKeys.push_back(key);
+    }
+    for (i32 button = 0; button < Input::MAX_MOUSE_BUTTONS; ++button) {
+        if (Input::IsMouseButtonPressed(button)) heldButtons.push_back(button);
+    }
+    Input::ResetState(mouse);
+    for (i32 key : heldKeys) Input::RecordKey(key, true);
+    for (i32 button : heldButtons) Input::RecordMouseButton(button, true);
+
+    s_RecordPath = path;
+    s_HasFrame = false;
+    s_RecordedFrames = 0;
+    LOG_CORE_INFO("FrameRecorder: Recording to {}", path);
+    return true;
+}
+
+void FrameRecorder::StopRecording() {
+    if (!s_File) return;
+
+    WriteFrame();
+    std::fclose(s_File);
+    s_File = nullptr;
+    LOG_CORE_INFO("FrameRecorder: Recorded {} frames to {}", s_RecordedFrames, s_RecordPath);
+}
+
+bool FrameRecorder::IsRecording() {
+    return s_File != nullptr;
+}
+
+bool FrameRecorder::StartReplay(const String& path) {
+    StopRecording();
+    StopReplay();
+
+    if (!s_Log.Open(path) || s_Log.Size() < sizeof(FileHeader)) {
+        LOG_CORE_ERROR("FrameRecorder: Failed to open {}", path);
+        s_Log.Close();
+        return false;
+    }
+
+    const auto header = Read<FileHeader>(s_Log.Data());
+    if (header.Magic != Magic || header.Version != Version) {
+        LOG_CORE_ERROR("FrameRecorder: {} is not a version {} frame recording", path, Version);
+        s_Log.Close();
+        return false;
+    }
+
+    if (!IndexFrames(s_Log.Data(), s_Log.Size())) {
+        // A recording cut short by a crash still replays up to its last whole frame
+        LOG_CORE_WARN("FrameRecorder: {} ends mid-frame, replaying {} whole frames", path, s_FrameOffsets.size());
+    }
+
+    Time::SetSimulationStep(header.SimulationStep);
+    Time::SetMaxSimulationSteps(header.MaxSimulationSteps);
+    Time::SetSimulationAccumulator(header.SimulationAccumulator);
+    Time::SetFixedDeltaTime(header.FixedDeltaTime);
+    Input::ResetState(glm::vec2(header.MouseX, header.MouseY));
+
+    s_ReplayFrame = 0;
+    s_ReplayClock = Profiler::Now();
+    s_ExpectCamera = false;
+    s_Diverged = false;
+    LOG_CORE_INFO("FrameRecorder: Replaying {} frames from {}", s_FrameOffsets.size(), path);
+    return true;
+}
+
+void FrameRecorder::StopReplay() {
+    if (!s_Log.IsOpen()) return;
+
+    s_Log.Close();
+    s_FrameOffsets.clear();
+    s_ReplaySamples.clear();
+    s_ExpectCamera = false;
+}
+
+bool FrameRecorder::IsReplaying() {
+    return s_Log.IsOpen();
+}
+
+u32 FrameRecorder::GetReplayFrameCount() {
+    return static_cast<u32>(s_FrameOffsets.size());
+}
+
+u32 FrameRecorder::GetReplayFrame() {
+    return s_ReplayFrame;
+}
+
+bool FrameRecorder::HasReplayDiverged() {
+    return s_Diverged;
+}
+
+void FrameRecorder::BeginFrame() {
+    if (s_Log.IsOpen()) {
+        if (s_ReplayFrame < s_FrameOffsets.size()) {
+            ReplayFrame();
+            return;
+        }
+        LOG_CORE_INFO("FrameRecorder: Replay finished after {} frames{}", s_ReplayFrame,
+                      s_Diverged ? " (diverged)" : "");
+        StopReplay();
+    }
+
+    Input::Update();
+    if (s_File) {
+        RecordFrame();
+    }
+}
+
+void FrameRecorder::TrackCamera(const glm::vec3& position, const glm::vec3& forward) {
+    if (s_File && s_HasFrame) {
+        s_Frame.Flags |= FrameHasCamera;
+        s_Camera[0] = position.x;
+        s_Camera[1] = position.y;
+        s_Camera[2] = position.z;
+        s_Camera[3] = forward.x;
+        s_Camera[4] = forward.y;
+        s_Camera[5] = forward.z;
+        return;
+    }
+
+    if (!s_ExpectCamera || s_Diverged) return;
+    s_ExpectCamera = false;
+
+    const glm::vec3 expectedPosition(s_ExpectedCamera[0], s_ExpectedCamera[1], s_ExpectedCamera[2]);
+    const glm::vec3 expectedForward(s_ExpectedCamera[3], s_ExpectedCamera[4], s_ExpectedCamera[5]);
+    if (glm::distance(position, expectedPosition) > CameraPositionTolerance ||
+        1.0f - glm::dot(forward, expectedForward) > CameraDirectionTolerance) {
+        s_Diverged = true;
+        LOG_CORE_WARN("FrameRecorder: Replay diverged at frame {}: camera at ({:.3f}, {:.3f}, {:.3f}), "
+                      "recorded ({:.3f}, {:.3f}, {:.3f})", s_ReplayFrame - 1,
+                      position.x, position.y, position.z,
+                      expectedPosition.x, expectedPosition.y, expectedPosition.z);
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Types.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// FrameRecorder - per-frame input and timing log, to run the same frames
+// again.
+//
+// While recording, every frame appends the delta the simulation advanced
+// by, the Input samples of the frame's input interval (offsets into it, so
+// sub-frame hold fractions replay exactly) and the active camera's pose. A
+// replay feeds the logged deltas to Time and the logged samples to Input in
+// place of the live ones, one record per frame, so the fixed-step
+// simulation, the camera controllers and everything reading InputBindings
+// see the same sequence; the wall clock (Time::GetFrameTime) is left alone
+// so the replay can be profiled. When the log runs out, live input resumes.
+//
+// The camera pose is a check, not an input: a replay compares it with the
+// recorded one and warns at the first frame it diverges, which means the
+// run stopped being deterministic (wall-clock animation, unseeded random,
+// changed controller code).
+//
+// Application drives both modes; main thread only.
+//
+// Binary layout, native endianness (version 1): a FileHeader, then per
+// frame a FrameHeader, its samples (SampleRecord, followed by two f32 for
+// cursor and scroll samples) and, when Flags has FrameHasCamera, six f32:
+// camera position and forward direction.
+class FrameRecorder {
+public:
+    static constexpr u32 Magic = 0x43455246;    // "FREC"
+    static constexpr u32 Version = 1;
+
+    struct FileHeader {
+        u32 Magic;
+        u32 Version;
+        f32 SimulationStep;
+        u32 MaxSimulationSteps;
+        f32 SimulationAccumulator;
+        f32 FixedDeltaTime;
+        f32 MouseX;
+        f32 MouseY;
+    };
+
+    static constexpr u32 FrameHasCamera = 1u << 0;
+
+    struct FrameHeader {
+        f32 DeltaTime;              // What the simulation advanced by
+        f32 FrameTime;              // Measured, for reference
+        u64 IntervalLength;         // Input interval, Profiler::Now() units
+        u32 SampleCount;
+        u32 Flags;
+    };
+
+    struct SampleRecord {
+        u32 Offset;                 // Microseconds into the interval
+        u8 Type;                    // InputSampleType
+        u8 Pressed;
+        u16 Code;
+    };
+
+    static bool StartRecording(const String& path);
+    static void StopRecording();
+    static bool IsRecording();
+
+    // Loads the whole log; the next frame is its first
+    static bool StartReplay(const String& path);
+    static void StopReplay();
+    static bool IsReplaying();
+
+    // Frames in the replayed log, and how many have been played
+    static u32 GetReplayFrameCount();
+    static u32 GetReplayFrame();
+
+    // The replayed camera left the recorded path (see above)
+    static bool HasReplayDiverged();
+
+    // Application, once per frame after Time::Update() and in place of
+    // Input::Update(): updates Input from the live samples (recording them
+    // while recording) or from the next replayed frame
+    static void BeginFrame();
+
+    // After the active camera moved this frame (CameraManager::OnUpdate)
+    static void TrackCamera(const glm::vec3& position, const glm::vec3& forward);
+};
+
+} // namespace Engine
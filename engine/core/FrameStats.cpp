@@ -0,0 +1,149 @@
+#include "FrameStats.hpp"
+#include "Logger.hpp"
+#include "MemoryTracker.hpp"
+#include "Profiler.hpp"
+#include "ecs/SystemScheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+
+namespace Engine {
+
+TimingHistory::TimingHistory(u32 capacity)
+    : m_Samples(std::max(capacity, 1u), 0.0f) {
+}
+
+void TimingHistory::Push(f32 value) {
+    m_Samples[m_Next] = value;
+    m_Next = (m_Next + 1) % static_cast<u32>(m_Samples.size());
+    m_Count = std::min(m_Count + 1, static_cast<u32>(m_Samples.size()));
+}
+
+void TimingHistory::Clear() {
+    m_Next = 0;
+    m_Count = 0;
+}
+
+f32 TimingHistory::GetLatest() const {
+    if (m_Count == 0) return 0.0f;
+    const u32 capacity = static_cast<u32>(m_Samples.size());
+    return m_Samples[(m_Next + capacity - 1) % capacity];
+}
+
+TimingHistory::Summary TimingHistory::Summarize() const {
+    Summary summary;
+    summary.Count = m_Count;
+    if (m_Count == 0) return summary;
+
+    CopyOrdered(m_Scratch);
+    std::sort(m_Scratch.begin(), m_Scratch.end());
+
+    f64 sum = 0.0;
+    for (f32 value : m_Scratch) {
+        sum += value;
+    }
+
+    // Nearest rank
+    auto percentile = [&](f32 p) {
+        const auto rank = static_cast<usize>(std::ceil(p * static_cast<f32>(m_Scratch.size())));
+        return m_Scratch[std::clamp<usize>(rank, 1, m_Scratch.size()) - 1];
+    };
+
+    summary.Average = static_cast<f32>(sum / static_cast<f64>(m_Scratch.size()));
+    summary.P50 = percentile(0.50f);
+    summary.P95 = percentile(0.95f);
+    summary.P99 = percentile(0.99f);
+    summary.Max = m_Scratch.back();
+    return summary;
+}
+
+void TimingHistory::CopyOrdered(Vector<f32>& out) const {
+    out.clear();
+    out.reserve(m_Count);
+    const u32 capacity = static_cast<u32>(m_Samples.size());
+    const u32 first = (m_Next + capacity - m_Count) % capacity;
+    for (u32 i = 0; i < m_Count; i++) {
+        out.push_back(m_Samples[(first + i) % capacity]);
+    }
+}
+
+void FrameStats::Update(f32 frameTimeMs, SystemScheduler& scheduler) {
+    m_FrameNumber++;
+    m_FrameTimes.Push(frameTimeMs);
+
+    scheduler.ForEachSystem([this](ISystem* system) {
+        if (system->IsEnabled()) {
+            GetSystemHistory(system->GetName()).Push(system->GetLastExecutionTime());
+        }
+    });
+
+    m_SecondsSinceCapture += frameTimeMs / 1000.0f;
+
+    // The first frame measures startup, not a hitch
+    if (m_FrameNumber > 1 && frameTimeMs > m_Settings.HitchThresholdMs) {
+        m_Hitches.Count++;
+        m_Hitches.LastTimeMs = frameTimeMs;
+        m_Hitches.LastFrame = m_FrameNumber;
+
+#ifdef ENGINE_ENABLE_PROFILING
+        const bool cooledDown = !m_Captured || m_SecondsSinceCapture >= m_Settings.CaptureCooldownSeconds;
+        if (m_Settings.CaptureTraceOnHitch && m_CaptureCountdown == 0 && cooledDown) {
+            m_CaptureCountdown = std::max(m_Settings.CaptureDelayFrames, 1u);
+            m_CaptureFrame = m_FrameNumber;
+            m_CaptureHitchMs = frameTimeMs;
+        }
+#endif
+    }
+
+    // MemoryTracker::EndFrame has just published this frame's count
+    if (MemoryTracker::IsCPUTrackingEnabled()) {
+        const u64 allocations = MemoryTracker::GetTotal().FrameAllocations;
+        m_FrameAllocations.Push(static_cast<f32>(allocations));
+        if (m_FrameNumber > 1 && allocations > m_Settings.AllocationSpikeThreshold) {
+            m_AllocationSpikes.Count++;
+            m_AllocationSpikes.LastAllocations = allocations;
+            m_AllocationSpikes.LastFrame = m_FrameNumber;
+        }
+    }
+
+    if (m_CaptureCountdown > 0 && --m_CaptureCountdown == 0) {
+        CaptureTrace();
+    }
+}
+
+TimingHistory& FrameStats::GetSystemHistory(const char* name) {
+    for (auto& [systemName, history] : m_SystemTimes) {
+        if (systemName == name) return history;
+    }
+    return m_SystemTimes.emplace_back(name, TimingHistory()).second;
+}
+
+void FrameStats::CaptureTrace() {
+    std::error_code error;
+    std::filesystem::create_directories(m_Settings.CaptureDirectory, error);
+
+    char fileName[64];
+    std::snprintf(fileName, sizeof(fileName), "hitch_%llu_%.0fms.json",
+                  static_cast<unsigned long long>(m_CaptureFrame), static_cast<f64>(m_CaptureHitchMs));
+    const String path = (std::filesystem::path(m_Settings.CaptureDirectory) / fileName).string();
+
+    if (Profiler::WriteChromeTrace(path)) {
+        m_Hitches.LastCapture = path;
+        LOG_CORE_WARN("Hitch of {:.1f} ms, trace written to {}", m_CaptureHitchMs, path);
+    }
+    m_Captured = true;
+    m_SecondsSinceCapture = 0.0f;
+}
+
+void FrameStats::Reset() {
+    m_FrameTimes.Clear();
+    m_SystemTimes.clear();
+    m_Hitches = {};
+    m_FrameAllocations.Clear();
+    m_AllocationSpikes = {};
+    m_CaptureCountdown = 0;
+}
+
+} // namespace Engine
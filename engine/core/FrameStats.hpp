@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Types.hpp"
+
+namespace Engine {
+
+class SystemScheduler;
+
+// Rolling window of timings (milliseconds) with percentile summaries.
+// Push is O(1); Summarize sorts a copy, so call it at UI rate rather than
+// per sample.
+class TimingHistory {
+public:
+    static constexpr u32 DefaultCapacity = 600;     // 10 s at 60 Hz
+
+    explicit TimingHistory(u32 capacity = DefaultCapacity);
+
+    void Push(f32 value);
+    void Clear();
+
+    u32 GetCount() const { return m_Count; }
+    u32 GetCapacity() const { return static_cast<u32>(m_Samples.size()); }
+    f32 GetLatest() const;
+
+    struct Summary {
+        f32 Average = 0.0f;
+        f32 P50 = 0.0f;
+        f32 P95 = 0.0f;
+        f32 P99 = 0.0f;
+        f32 Max = 0.0f;
+        u32 Count = 0;
+    };
+    Summary Summarize() const;
+
+    // Samples oldest first, for plotting
+    void CopyOrdered(Vector<f32>& out) const;
+
+private:
+    Vector<f32> m_Samples;
+    u32 m_Next = 0;
+    u32 m_Count = 0;
+    mutable Vector<f32> m_Scratch;
+};
+
+// FrameStats - frame and per-system timing history with hitch detection.
+//
+// Fed once a frame by the Application. A frame longer than
+// HitchThresholdMs counts as a hitch; with ENGINE_ENABLE_PROFILING and
+// CaptureTraceOnHitch, the profiler trace is written CaptureDelayFrames
+// frames later, so it holds the frames before and after the hitch. With
+// ENGINE_ENABLE_MEMORY_TRACKING the heap allocation count of every frame is
+// kept too, and a frame above AllocationSpikeThreshold is recorded.
+class FrameStats {
+public:
+    struct Settings {
+        f32 HitchThresholdMs = 33.3f;
+        bool CaptureTraceOnHitch = true;
+        u32 CaptureDelayFrames = 30;
+        f32 CaptureCooldownSeconds = 10.0f;  // Between two captures
+        String CaptureDirectory = "traces";
+        u32 AllocationSpikeThreshold = 1000;    // Heap allocations in one frame
+    };
+
+    // frameTimeMs is the time since the previous frame; system times are
+    // the last execution times of the scheduler's enabled systems
+    void Update(f32 frameTimeMs, SystemScheduler& scheduler);
+
+    const TimingHistory& GetFrameTimes() const { return m_FrameTimes; }
+
+    // Keyed by ISystem::GetName, in scheduler order
+    const Vector<std::pair<const char*, TimingHistory>>& GetSystemTimes() const { return m_SystemTimes; }
+
+    struct HitchInfo {
+        u32 Count = 0;
+        f32 LastTimeMs = 0.0f;      // Duration of the last hitch
+        u64 LastFrame = 0;
+        String LastCapture;         // Trace written for a hitch, if any
+    };
+    const HitchInfo& GetHitches() const { return m_Hitches; }
+
+    // Heap allocations per frame (MemoryTracker), empty without tracking
+    const TimingHistory& GetFrameAllocations() const { return m_FrameAllocations; }
+
+    struct AllocationSpikeInfo {
+        u32 Count = 0;
+        u64 LastAllocations = 0;
+        u64 LastFrame = 0;
+    };
+    const AllocationSpikeInfo& GetAllocationSpikes() const { return m_AllocationSpikes; }
+    u64 GetFrameNumber() const { return m_FrameNumber; }
+
+    Settings& GetSettings() { return m_Settings; }
+    const Settings& GetSettings() const { return m_Settings; }
+
+    void Reset();
+
+private:
+    TimingHistory& GetSystemHistory(const char* name);
+    void CaptureTrace();
+
+private:
+    Settings m_Settings;
+    TimingHistory m_FrameTimes;
+    Vector<std::pair<const char*, TimingHistory>> m_SystemTimes;
+    HitchInfo m_Hitches;
+    TimingHistory m_FrameAllocations;
+    AllocationSpikeInfo m_AllocationSpikes;
+    u64 m_FrameNumber = 0;
+
+    // Pending trace capture
+    u32 m_CaptureCountdown = 0;
+    u64 m_CaptureFrame = 0;
+    f32 m_CaptureHitchMs = 0.0f;
+    f32 m_SecondsSinceCapture = 0.0f;
+    bool m_Captured = false;
+};
+
+} // namespace Engine
@@ -0,0 +1,109 @@
+#include "InitGraph.hpp"
+#include "JobSystem.hpp"
+#include "Logger.hpp"
+#include "Profiler.hpp"
+
+#include <thread>
+
+namespace Engine {
+
+InitGraph::TaskId InitGraph::Add(const char* name, Thread thread, TaskFunction task,
+                                 std::initializer_list<TaskId> dependencies) {
+    const TaskId id = static_cast<TaskId>(m_Tasks.size());
+    auto entry = CreateScope<Task>();
+    entry->Name = name;
+    entry->RunOn = thread;
+    entry->Function = std::move(task);
+
+    for (TaskId dependency : dependencies) {
+        if (dependency >= id) {
+            LOG_CORE_ERROR("InitGraph: '{}' depends on a task added after it, ignored", name);
+            continue;
+        }
+        m_Tasks[dependency]->Dependents.push_back(id);
+        ++entry->DependencyCount;
+    }
+
+    m_Tasks.push_back(std::move(entry));
+    return id;
+}
+
+void InitGraph::Run() {
+    const u32 count = static_cast<u32>(m_Tasks.size());
+    m_Timings.assign(count, Timing{});
+    m_Finished.store(0, std::memory_order_relaxed);
+    m_MainReady.clear();
+    m_Start = Profiler::Now();
+
+    for (auto& task : m_Tasks) {
+        task->Remaining.store(task->DependencyCount, std::memory_order_relaxed);
+    }
+    for (TaskId id = 0; id < count; ++id) {
+        if (m_Tasks[id]->DependencyCount == 0) Schedule(id);
+    }
+
+    // Main tasks first; queued jobs while none is ready
+    while (m_Finished.load(std::memory_order_acquire) < count) {
+        TaskId next = count;
+        {
+            std::lock_guard<std::mutex> lock(m_MainMutex);
+            if (!m_MainReady.empty()) {
+                next = m_MainReady.front();
+                m_MainReady.erase(m_MainReady.begin());
+            }
+        }
+
+        if (next < count) {
+            Execute(next);
+        } else if (!JobSystem::TryRunPendingJob()) {
+            std::this_thread::yield();
+        }
+    }
+
+    m_TotalMs = static_cast<f32>(static_cast<f64>(Profiler::Now() - m_Start) / 1.0e6);
+
+    f32 mainMs = 0.0f;
+    for (const Timing& timing : m_Timings) {
+        LOG_CORE_TRACE("Init '{}' ({}): {:.1f} ms at {:.1f} ms", timing.Name,
+                       timing.RunOn == Thread::Main ? "main" : "worker", timing.Milliseconds, timing.StartMs);
+        if (timing.RunOn == Thread::Main) mainMs += timing.Milliseconds;
+    }
+    LOG_CORE_INFO("Initialized {} tasks in {:.1f} ms ({:.1f} ms on the main thread)", count, m_TotalMs, mainMs);
+}
+
+void InitGraph::Schedule(TaskId id) {
+    if (m_Tasks[id]->RunOn == Thread::Worker) {
+        JobSystem::Submit([this, id] { Execute(id); });
+    } else {
+        std::lock_guard<std::mutex> lock(m_MainMutex);
+        m_MainReady.push_back(id);
+    }
+}
+
+void InitGraph::Execute(TaskId id) {
+    Task& task = *m_Tasks[id];
+
+    const u64 begin = Profiler::Now();
+    {
+        PROFILE_SCOPE(task.Name);
+        task.Function();
+    }
+    const u64 end = Profiler::Now();
+
+    Timing& timing = m_Timings[id];
+    timing.Name = task.Name;
+    timing.RunOn = task.RunOn;
+    timing.StartMs = static_cast<f32>(static_cast<f64>(begin - m_Start) / 1.0e6);
+    timing.Milliseconds = static_cast<f32>(static_cast<f64>(end - begin) / 1.0e6);
+
+    for (TaskId dependent : task.Dependents) {
+        if (m_Tasks[dependent]->Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Schedule(dependent);
+        }
+    }
+
+    // Last: Run() may return as soon as this is seen
+    m_Finished.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace Engine
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Types.hpp"
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+
+namespace Engine {
+
+// InitGraph - startup work as named tasks with dependencies.
+//
+// Worker tasks go to the JobSystem as soon as everything they depend on has
+// finished. Main tasks - the window and GL context, and anything making GL
+// calls - run on the thread calling Run(), in dependency order, while the
+// workers get on with file reads and CPU-side preparation; the main thread
+// helps with queued jobs whenever none of its own tasks is ready. A task can
+// only depend on tasks added before it, so the graph can't have cycles.
+//
+// Every task is a profiler zone named after it, and its start and duration
+// are kept for GetTimings().
+class InitGraph {
+public:
+    enum class Thread : u8 {
+        Main,       // The thread calling Run()
+        Worker      // Any JobSystem worker
+    };
+
+    using TaskId = u32;
+    using TaskFunction = std::function<void()>;
+
+    struct Timing {
+        const char* Name = "";
+        Thread RunOn = Thread::Main;
+        f32 StartMs = 0.0f;         // Since Run() started
+        f32 Milliseconds = 0.0f;
+    };
+
+    InitGraph() = default;
+    InitGraph(const InitGraph&) = delete;
+    InitGraph& operator=(const InitGraph&) = delete;
+
+    // name must outlive the graph (it is a profiler zone name)
+    TaskId Add(const char* name, Thread thread, TaskFunction task, std::initializer_list<TaskId> dependencies = {});
+
+    // Run every task; returns once all have finished
+    void Run();
+
+    const Vector<Timing>& GetTimings() const { return m_Timings; }
+    f32 GetTotalMs() const { return m_TotalMs; }
+
+private:
+    struct Task {
+        const char* Name;
+        Thread RunOn;
+        TaskFunction Function;
+        Vector<TaskId> Dependents;
+        u32 DependencyCount = 0;
+        std::atomic<u32> Remaining{0};      // Dependencies not finished yet
+    };
+
+    void Schedule(TaskId id);
+    void Execute(TaskId id);
+
+private:
+    Vector<Scope<Task>> m_Tasks;
+    Vector<Timing> m_Timings;
+    u64 m_Start = 0;
+    f32 m_TotalMs = 0.0f;
+    std::atomic<u32> m_Finished{0};
+
+    std::mutex m_MainMutex;
+    Vector<TaskId> m_MainReady;     // Main tasks whose dependencies have finished
+};
+
+} // namespace Engine
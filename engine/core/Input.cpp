@@ -1,5 +1,7 @@
 #include "Input.hpp"
+#include "Profiler.hpp"
 #include <GLFW/glfw3.h>
+#include <algorithm>
 #include <cstring>
 #include <imgui.h>
 
@@ -9,18 +11,27 @@ GLFWwindow* Input::s_Window = nullptr;
 
 bool Input::s_CurrentKeys[MAX_KEYS] = {};
 bool Input::s_PreviousKeys[MAX_KEYS] = {};
+bool Input::s_KeysPressedInInterval[MAX_KEYS] = {};
+bool Input::s_KeysReleasedInInterval[MAX_KEYS] = {};
 
 bool Input::s_CurrentMouseButtons[MAX_MOUSE_BUTTONS] = {};
 bool Input::s_PreviousMouseButtons[MAX_MOUSE_BUTTONS] = {};
+bool Input::s_ButtonsPressedInInterval[MAX_MOUSE_BUTTONS] = {};
+bool Input::s_ButtonsReleasedInInterval[MAX_MOUSE_BUTTONS] = {};
+
+Vector<InputSample> Input::s_Pending;
+Vector<InputSample> Input::s_Samples;
+u64 Input::s_IntervalStart = 0;
+u64 Input::s_IntervalEnd = 0;
 
 glm::vec2 Input::s_MousePosition{0.0f};
 glm::vec2 Input::s_LastMousePosition{0.0f};
 glm::vec2 Input::s_MouseDelta{0.0f};
 
 glm::vec2 Input::s_ScrollDelta{0.0f};
-glm::vec2 Input::s_ScrollAccumulator{0.0f};
 
 bool Input::s_FirstMouse = true;
+bool Input::s_RawMouseMotion = false;
 
 void Input::Init(GLFWwindow* window) {
     s_Window = window;
@@ -31,6 +42,11 @@ void Input::Init(GLFWwindow* window) {
     std::memset(s_CurrentMouseButtons, 0, sizeof(s_CurrentMouseButtons));
     std::memset(s_PreviousMouseButtons, 0, sizeof(s_PreviousMouseButtons));
 
+    s_Pending.clear();
+    s_Pending.reserve(256);
+    s_Samples.reserve(256);
+    s_IntervalEnd = Profiler::Now();
+
     // Get initial mouse position
     double xpos, ypos;
     glfwGetCursorPos(s_Window, &xpos, &ypos);
@@ -39,44 +55,142 @@ void Input::Init(GLFWwindow* window) {
     s_FirstMouse = true;
 }
 
+void Input::Poll() {
+    glfwPollEvents();
+}
+
+void Input::Wait(f64 timeout) {
+    glfwWaitEventsTimeout(timeout);
+}
+
 void Input::Update() {
+    // The samples recorded since the last Update become this frame's interval
+    std::swap(s_Samples, s_Pending);
+    s_Pending.clear();
+    s_IntervalStart = s_IntervalEnd;
+    s_IntervalEnd = Profiler::Now();
+
+    ApplyInterval();
+}
+
+void Input::Replay(const Vector<InputSample>& samples, u64 intervalStart, u64 intervalEnd) {
+    s_Pending.clear();
+    s_Samples.assign(samples.begin(), samples.end());
+    s_IntervalStart = intervalStart;
+    s_IntervalEnd = intervalEnd;
+
+    ApplyInterval();
+}
+
+void Input::ResetState(const glm::vec2& mousePosition) {
+    std::memset(s_CurrentKeys, 0, sizeof(s_CurrentKeys));
+    std::memset(s_CurrentMouseButtons, 0, sizeof(s_CurrentMouseButtons));
+    s_MousePosition = mousePosition;
+    s_LastMousePosition = mousePosition;
+    s_FirstMouse = true;
+}
+
+void Input::ApplyInterval() {
     // Copy current state to previous
     std::memcpy(s_PreviousKeys, s_CurrentKeys, sizeof(s_CurrentKeys));
     std::memcpy(s_PreviousMouseButtons, s_CurrentMouseButtons, sizeof(s_CurrentMouseButtons));
+    std::memset(s_KeysPressedInInterval, 0, sizeof(s_KeysPressedInInterval));
+    std::memset(s_KeysReleasedInInterval, 0, sizeof(s_KeysReleasedInInterval));
+    std::memset(s_ButtonsPressedInInterval, 0, sizeof(s_ButtonsPressedInInterval));
+    std::memset(s_ButtonsReleasedInInterval, 0, sizeof(s_ButtonsReleasedInInterval));
 
-    // Update current key states - only query valid GLFW key ranges
-    // GLFW valid keys: 32-96 (printable), 256-348 (special keys)
-    auto updateKey = [](i32 key) {
-        auto state = glfwGetKey(s_Window, key);
-        s_CurrentKeys[key] = (state == GLFW_PRESS || state == GLFW_REPEAT);
-    };
+    s_LastMousePosition = s_MousePosition;
+    s_MouseDelta = glm::vec2(0.0f);
+    s_ScrollDelta = glm::vec2(0.0f);
+
+    for (const InputSample& sample : s_Samples) {
+        switch (sample.Type) {
+            case InputSampleType::Key:
+                s_CurrentKeys[sample.Code] = sample.Pressed;
+                (sample.Pressed ? s_KeysPressedInInterval : s_KeysReleasedInInterval)[sample.Code] = true;
+                break;
+
+            case InputSampleType::MouseButton:
+                s_CurrentMouseButtons[sample.Code] = sample.Pressed;
+                (sample.Pressed ? s_ButtonsPressedInInterval : s_ButtonsReleasedInInterval)[sample.Code] = true;
+                break;
+
+            case InputSampleType::CursorPosition:
+                // The first position after a cursor mode change jumps
+                if (!s_FirstMouse) {
+                    s_MouseDelta += sample.Value - s_MousePosition;
+                }
+                s_MousePosition = sample.Value;
+                s_FirstMouse = false;
+                break;
+
+            case InputSampleType::Scroll:
+                s_ScrollDelta += sample.Value;
+                break;
+        }
+    }
+}
 
-    for (i32 i = 32; i <= 96; i++) updateKey(i);
-    for (i32 i = 256; i <= 348; i++) updateKey(i);
+void Input::Record(const InputSample& sample) {
+    s_Pending.push_back(sample);
+}
 
-    // Update current mouse button states
-    for (i32 i = 0; i < MAX_MOUSE_BUTTONS; i++) {
-        auto state = glfwGetMouseButton(s_Window, i);
-        s_CurrentMouseButtons[i] = (state == GLFW_PRESS);
-    }
+void Input::RecordKey(i32 keycode, bool pressed) {
+    if (keycode < 0 || keycode >= MAX_KEYS) return;
 
-    // Update mouse position and delta
-    s_LastMousePosition = s_MousePosition;
+    InputSample sample;
+    sample.Time = Profiler::Now();
+    sample.Type = InputSampleType::Key;
+    sample.Pressed = pressed;
+    sample.Code = keycode;
+    Record(sample);
+}
 
-    double xpos, ypos;
-    glfwGetCursorPos(s_Window, &xpos, &ypos);
-    s_MousePosition = { static_cast<f32>(xpos), static_cast<f32>(ypos) };
+void Input::RecordMouseButton(i32 button, bool pressed) {
+    if (button < 0 || button >= MAX_MOUSE_BUTTONS) return;
 
-    if (s_FirstMouse) {
-        s_LastMousePosition = s_MousePosition;
-        s_FirstMouse = false;
-    }
+    InputSample sample;
+    sample.Time = Profiler::Now();
+    sample.Type = InputSampleType::MouseButton;
+    sample.Pressed = pressed;
+    sample.Code = button;
+    Record(sample);
+}
 
-    s_MouseDelta = s_MousePosition - s_LastMousePosition;
+void Input::RecordCursorPosition(f32 x, f32 y) {
+    InputSample sample;
+    sample.Time = Profiler::Now();
+    sample.Type = InputSampleType::CursorPosition;
+    sample.Value = {x, y};
+    Record(sample);
+}
 
-    // Transfer scroll accumulator to delta and reset
-    s_ScrollDelta = s_ScrollAccumulator;
-    s_ScrollAccumulator = glm::vec2(0.0f);
+void Input::RecordScroll(f32 xOffset, f32 yOffset) {
+    InputSample sample;
+    sample.Time = Profiler::Now();
+    sample.Type = InputSampleType::Scroll;
+    sample.Value = {xOffset, yOffset};
+    Record(sample);
+}
+
+f32 Input::GetHeldFraction(InputSampleType type, i32 code, bool downAtStart) {
+    const u64 length = s_IntervalEnd - s_IntervalStart;
+    if (length == 0) return downAtStart ? 1.0f : 0.0f;
+
+    u64 held = 0;
+    u64 since = s_IntervalStart;
+    bool down = downAtStart;
+    for (const InputSample& sample : s_Samples) {
+        if (sample.Type != type || sample.Code != code) continue;
+
+        const u64 time = std::clamp(sample.Time, s_IntervalStart, s_IntervalEnd);
+        if (down) held += time - since;
+        since = time;
+        down = sample.Pressed;
+    }
+    if (down) held += s_IntervalEnd - since;
+
+    return static_cast<f32>(static_cast<f64>(held) / static_cast<f64>(length));
 }
 
 bool Input::IsKeyPressed(i32 keycode) {
@@ -86,12 +200,12 @@ bool Input::IsKeyPressed(i32 keycode) {
 
 bool Input::IsKeyJustPressed(i32 keycode) {
     if (keycode < 0 || keycode >= MAX_KEYS) return false;
-    return s_CurrentKeys[keycode] && !s_PreviousKeys[keycode];
+    return s_KeysPressedInInterval[keycode];
 }
 
 bool Input::IsKeyJustReleased(i32 keycode) {
     if (keycode < 0 || keycode >= MAX_KEYS) return false;
-    return !s_CurrentKeys[keycode] && s_PreviousKeys[keycode];
+    return s_KeysReleasedInInterval[keycode];
 }
 
 bool Input::IsMouseButtonPressed(i32 button) {
@@ -101,12 +215,22 @@ bool Input::IsMouseButtonPressed(i32 button) {
 
 bool Input::IsMouseButtonJustPressed(i32 button) {
     if (button < 0 || button >= MAX_MOUSE_BUTTONS) return false;
-    return s_CurrentMouseButtons[button] && !s_PreviousMouseButtons[button];
+    return s_ButtonsPressedInInterval[button];
 }
 
 bool Input::IsMouseButtonJustReleased(i32 button) {
     if (button < 0 || button >= MAX_MOUSE_BUTTONS) return false;
-    return !s_CurrentMouseButtons[button] && s_PreviousMouseButtons[button];
+    return s_ButtonsReleasedInInterval[button];
+}
+
+f32 Input::GetKeyHeldFraction(i32 keycode) {
+    if (keycode < 0 || keycode >= MAX_KEYS) return 0.0f;
+    return GetHeldFraction(InputSampleType::Key, keycode, s_PreviousKeys[keycode]);
+}
+
+f32 Input::GetMouseButtonHeldFraction(i32 button) {
+    if (button < 0 || button >= MAX_MOUSE_BUTTONS) return 0.0f;
+    return GetHeldFraction(InputSampleType::MouseButton, button, s_PreviousMouseButtons[button]);
 }
 
 glm::vec2 Input::GetMousePosition() {
@@ -137,13 +261,13 @@ glm::vec2 Input::GetScrollDelta() {
     return s_ScrollDelta;
 }
 
-void Input::SetScrollOffset(f32 xOffset, f32 yOffset) {
-    s_ScrollAccumulator.x += xOffset;
-    s_ScrollAccumulator.y += yOffset;
-}
-
 void Input::SetCursorMode(bool enabled) {
     glfwSetInputMode(s_Window, GLFW_CURSOR, enabled ? GLFW_CURSOR_NORMAL : GLFW_CURSOR_DISABLED);
+
+    // Raw motion skips OS acceleration; GLFW only applies it to a disabled cursor
+    s_RawMouseMotion = !enabled && glfwRawMouseMotionSupported();
+    glfwSetInputMode(s_Window, GLFW_RAW_MOUSE_MOTION, s_RawMouseMotion ? GLFW_TRUE : GLFW_FALSE);
+
     if (!enabled) {
         // Reset first mouse flag when disabling cursor to avoid jump
         s_FirstMouse = true;
@@ -192,6 +316,11 @@ bool Input::IsGameMouseButtonJustReleased(i32 button) {
     return IsMouseButtonJustReleased(button);
 }
 
+f32 Input::GetGameKeyHeldFraction(i32 keycode) {
+    if (IsImGuiCapturingKeyboard()) return 0.0f;
+    return GetKeyHeldFraction(keycode);
+}
+
 glm::vec2 Input::GetGameMouseDelta() {
     if (IsImGuiCapturingMouse()) return glm::vec2(0.0f);
     return GetMouseDelta();
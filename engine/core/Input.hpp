@@ -7,13 +7,63 @@ struct GLFWwindow;
 
 namespace Engine {
 
+enum class InputSampleType : u8 {
+    Key,
+    MouseButton,
+    CursorPosition,
+    Scroll
+};
+
+// One input transition, stamped when GLFW delivered it (Profiler::Now() clock)
+struct InputSample {
+    u64 Time = 0;
+    InputSampleType Type = InputSampleType::Key;
+    bool Pressed = false;       // Key, MouseButton
+    i32 Code = -1;              // Keycode or mouse button
+    glm::vec2 Value{0.0f};      // CursorPosition: position; Scroll: offset
+};
+
+// Input - per-frame input state built from a timestamped sample buffer.
+//
+// The window's GLFW callbacks record every key, button, cursor and scroll
+// transition as it is delivered; events are polled at the top of the frame
+// and, while the frame limiter waits, about every millisecond
+// (FramePacer::Settings::InputPollRate), so samples carry sub-frame
+// timestamps. Update() consumes the samples recorded since the previous
+// Update as the frame's input interval: the mouse delta is the sum of every
+// motion in it (raw, unaccelerated motion while the cursor is disabled,
+// where supported), a key tapped and released within one interval still
+// reports JustPressed and JustReleased, and GetKeyHeldFraction() says how
+// much of the interval a key was down, so movement can scale by it instead
+// of by whether the key happened to be down when the frame sampled it.
+//
+// Main thread only: GLFW delivers callbacks from glfwPollEvents.
 class Input {
 public:
+    static constexpr i32 MAX_KEYS = 512;
+    static constexpr i32 MAX_MOUSE_BUTTONS = 8;
+
     static void Init(GLFWwindow* window);
 
-    // Call at the start of each frame to update input state
+    // Call at the start of each frame, after events are polled, to consume
+    // the samples recorded since the last call
     static void Update();
 
+    // glfwPollEvents; recorded samples are consumed by the next Update
+    static void Poll();
+
+    // glfwWaitEventsTimeout: as Poll, but sleeps until an event arrives or
+    // timeout seconds pass
+    static void Wait(f64 timeout);
+
+    // Replay (FrameRecorder): in place of Update, make samples the frame's
+    // input interval. Live samples recorded since the last call are dropped.
+    static void Replay(const Vector<InputSample>& samples, u64 intervalStart, u64 intervalEnd);
+
+    // Release every key and button and place the cursor without a delta, so
+    // a recording and its replay start from the same state
+    static void ResetState(const glm::vec2& mousePosition);
+
     // Key state queries
     static bool IsKeyPressed(i32 keycode);
     static bool IsKeyJustPressed(i32 keycode);
@@ -24,12 +74,16 @@ public:
     static bool IsMouseButtonJustPressed(i32 button);
     static bool IsMouseButtonJustReleased(i32 button);
 
+    // Portion [0, 1] of the last input interval the key / button was down
+    static f32 GetKeyHeldFraction(i32 keycode);
+    static f32 GetMouseButtonHeldFraction(i32 button);
+
     // Mouse position
     static glm::vec2 GetMousePosition();
     static f32 GetMouseX();
     static f32 GetMouseY();
 
-    // Mouse delta (change since last frame)
+    // Mouse delta (every motion since last frame)
     static glm::vec2 GetMouseDelta();
     static f32 GetMouseDeltaX();
     static f32 GetMouseDeltaY();
@@ -37,10 +91,20 @@ public:
     // Scroll delta
     static glm::vec2 GetScrollDelta();
 
+    // Samples of the last input interval, oldest first, and its bounds
+    static const Vector<InputSample>& GetSamples() { return s_Samples; }
+    static u64 GetIntervalStart() { return s_IntervalStart; }
+    static u64 GetIntervalEnd() { return s_IntervalEnd; }
+
+    // Disabling the cursor also switches to raw mouse motion where supported
     static void SetCursorMode(bool enabled);
+    static bool IsRawMouseMotion() { return s_RawMouseMotion; }
 
-    // Internal: called by window to set scroll values
-    static void SetScrollOffset(f32 xOffset, f32 yOffset);
+    // Internal: called from the window's GLFW callbacks
+    static void RecordKey(i32 keycode, bool pressed);
+    static void RecordMouseButton(i32 button, bool pressed);
+    static void RecordCursorPosition(f32 x, f32 y);
+    static void RecordScroll(f32 xOffset, f32 yOffset);
 
     // ImGui awareness - check if ImGui wants to capture input
     static bool IsImGuiCapturingMouse();
@@ -54,29 +118,40 @@ public:
     static bool IsGameMouseButtonPressed(i32 button);
     static bool IsGameMouseButtonJustPressed(i32 button);
     static bool IsGameMouseButtonJustReleased(i32 button);
+    static f32 GetGameKeyHeldFraction(i32 keycode);
     static glm::vec2 GetGameMouseDelta();
     static glm::vec2 GetGameScrollDelta();
 
 private:
-    static constexpr i32 MAX_KEYS = 512;
-    static constexpr i32 MAX_MOUSE_BUTTONS = 8;
+    static void Record(const InputSample& sample);
+    static void ApplyInterval();
+    static f32 GetHeldFraction(InputSampleType type, i32 code, bool downAtStart);
 
     static GLFWwindow* s_Window;
 
     static bool s_CurrentKeys[MAX_KEYS];
     static bool s_PreviousKeys[MAX_KEYS];
+    static bool s_KeysPressedInInterval[MAX_KEYS];
+    static bool s_KeysReleasedInInterval[MAX_KEYS];
 
     static bool s_CurrentMouseButtons[MAX_MOUSE_BUTTONS];
     static bool s_PreviousMouseButtons[MAX_MOUSE_BUTTONS];
+    static bool s_ButtonsPressedInInterval[MAX_MOUSE_BUTTONS];
+    static bool s_ButtonsReleasedInInterval[MAX_MOUSE_BUTTONS];
+
+    static Vector<InputSample> s_Pending;      // Recorded since the last Update
+    static Vector<InputSample> s_Samples;      // The last input interval
+    static u64 s_IntervalStart;
+    static u64 s_IntervalEnd;
 
     static glm::vec2 s_MousePosition;
     static glm::vec2 s_LastMousePosition;
     static glm::vec2 s_MouseDelta;
 
     static glm::vec2 s_ScrollDelta;
-    static glm::vec2 s_ScrollAccumulator;
 
     static bool s_FirstMouse;
+    static bool s_RawMouseMotion;
 };
 
 // Key codes (matching GLFW)
@@ -1,4 +1,5 @@
 #include "InputBindings.hpp"
+#include <algorithm>
 
 namespace Engine {
 
@@ -84,7 +85,19 @@ bool InputBindings::IsActionJustReleased(const String& action) const {
 }
 
 f32 InputBindings::GetActionStrength(const String& action) const {
-    return IsActionPressed(action) ? 1.0f : 0.0f;
+    const InputBinding* binding = GetBinding(action);
+    if (!binding) return 0.0f;
+
+    // The longest held of the bound inputs
+    f32 strength = 0.0f;
+    if (binding->PrimaryKey >= 0)
+        strength = std::max(strength, Input::GetKeyHeldFraction(binding->PrimaryKey));
+    if (binding->SecondaryKey >= 0)
+        strength = std::max(strength, Input::GetKeyHeldFraction(binding->SecondaryKey));
+    if (binding->MouseButton >= 0)
+        strength = std::max(strength, Input::GetMouseButtonHeldFraction(binding->MouseButton));
+
+    return strength;
 }
 
 f32 InputBindings::GetAxis(const String& positiveAction, const String& negativeAction) const {
@@ -37,7 +37,8 @@ public:
     bool IsActionJustPressed(const String& action) const;
     bool IsActionJustReleased(const String& action) const;
 
-    // Get action strength (for analog-like behavior, 0.0 or 1.0 for digital)
+    // Get action strength: for digital inputs, the portion of the last
+    // input interval any bound input was held (sub-frame taps count)
     f32 GetActionStrength(const String& action) const;
 
     // Get axis value (positive - negative actions)
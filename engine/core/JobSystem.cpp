@@ -0,0 +1,260 @@
+#include "JobSystem.hpp"
+#include "Logger.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Engine {
+
+namespace {
+
+struct WorkerQueue {
+    std::mutex Mutex;
+    std::deque<JobSystem::JobFunction> Jobs;
+};
+
+Vector<Scope<WorkerQueue>> s_Queues;
+Vector<std::thread> s_Workers;
+
+std::mutex s_WakeMutex;
+std::condition_variable s_WakeCondition;
+std::atomic<u32> s_PendingJobs{0};
+std::atomic<u32> s_NextQueue{0};
+std::atomic<bool> s_Running{false};
+
+thread_local i32 t_WorkerIndex = -1;
+
+bool PopLocal(u32 index, JobSystem::JobFunction& out) {
+    auto& queue = *s_Queues[index];
+    std::lock_guard<std::mutex> lock(queue.Mutex);
+    if (queue.Jobs.empty()) return false;
+
+    out = std::move(queue.Jobs.back());
+    queue.Jobs.pop_back();
+    return true;
+}
+
+bool Steal(u32 thief, JobSystem::JobFunction& out) {
+    const u32 count = static_cast<u32>(s_Queues.size());
+    for (u32 i = 1; i <= count; ++i) {
+        u32 victim = (thief + i) % count;
+        auto& queue = *s_Queues[victim];
+
+        std::unique_lock<std::mutex> lock(queue.Mutex, std::try_to_lock);
+        if (!lock.owns_lock() || queue.Jobs.empty()) continue;
+
+        out = std::move(queue.Jobs.front());
+        queue.Jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+bool FindJob(JobSystem::JobFunction& out) {
+    if (s_Queues.empty()) return false;
+
+    if (t_WorkerIndex >= 0 && PopLocal(static_cast<u32>(t_WorkerIndex), out)) {
+        return true;
+    }
+
+    u32 start = t_WorkerIndex >= 0 ? static_cast<u32>(t_WorkerIndex)
+                                   : s_NextQueue.load(std::memory_order_relaxed);
+    return Steal(start, out);
+}
+
+void RunJob(JobSystem::JobFunction& job) {
+    s_PendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+    job();
+}
+
+void WorkerLoop(u32 index) {
+    t_WorkerIndex = static_cast<i32>(index);
+    PROFILE_THREAD("Worker " + std::to_string(index));
+
+    while (s_Running.load(std::memory_order_acquire)) {
+        JobSystem::JobFunction job;
+        if (FindJob(job)) {
+            RunJob(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(s_WakeMutex);
+        s_WakeCondition.wait(lock, [] {
+            return !s_Running.load(std::memory_order_acquire) ||
+                   s_PendingJobs.load(std::memory_order_acquire) > 0;
+        });
+    }
+
+    t_WorkerIndex = -1;
+}
+
+} // anonymous namespace
+
+void JobSystem::Init(u32 workerCount) {
+    if (s_Running) return;
+
+    if (workerCount == 0) {
+        u32 hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    s_Running = true;
+    s_Queues.reserve(workerCount);
+    for (u32 i = 0; i < workerCount; ++i) {
+        s_Queues.push_back(CreateScope<WorkerQueue>());
+    }
+
+    s_Workers.reserve(workerCount);
+    for (u32 i = 0; i < workerCount; ++i) {
+        s_Workers.emplace_back(WorkerLoop, i);
+    }
+
+    LOG_CORE_INFO("JobSystem initialized with {} worker threads", workerCount);
+}
+
+void JobSystem::Shutdown() {
+    if (!s_Running) return;
+
+    // Drain remaining work so nobody waits on a job that never runs
+    JobFunction job;
+    while (FindJob(job)) {
+        RunJob(job);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_WakeMutex);
+        s_Running = false;
+    }
+    s_WakeCondition.notify_all();
+
+    for (auto& worker : s_Workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    s_Workers.clear();
+    s_Queues.clear();
+    s_PendingJobs = 0;
+
+    LOG_CORE_INFO("JobSystem shut down");
+}
+
+void JobSystem::Submit(JobFunction job) {
+    if (!s_Running || s_Queues.empty()) {
+        job();
+        return;
+    }
+
+    u32 index = t_WorkerIndex >= 0
+        ? static_cast<u32>(t_WorkerIndex)
+        : s_NextQueue.fetch_add(1, std::memory_order_relaxed) % static_cast<u32>(s_Queues.size());
+
+    {
+        auto& queue = *s_Queues[index];
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        queue.Jobs.push_back(std::move(job));
+    }
+
+    {
+        // Taking the wake mutex prevents a worker from missing the notification
+        // between checking the predicate and going to sleep
+        std::lock_guard<std::mutex> lock(s_WakeMutex);
+        s_PendingJobs.fetch_add(1, std::memory_order_acq_rel);
+    }
+    s_WakeCondition.notify_one();
+}
+
+void JobSystem::Submit(JobFunction job, JobCounter* counter) {
+    if (!counter) {
+        Submit(std::move(job));
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(counter->m_Mutex);
+        counter->m_Value.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    Submit([job = std::move(job), counter]() {
+        job();
+        FinishJob(counter);
+    });
+}
+
+void JobSystem::SubmitAfter(JobCounter& dependency, JobFunction job, JobCounter* counter) {
+    if (counter) {
+        std::lock_guard<std::mutex> lock(counter->m_Mutex);
+        counter->m_Value.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    JobFunction continuation = [job = std::move(job), counter]() {
+        job();
+        FinishJob(counter);
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+        if (dependency.m_Value.load(std::memory_order_acquire) != 0) {
+            dependency.m_Continuations.push_back(std::move(continuation));
+            return;
+        }
+    }
+
+    Submit(std::move(continuation));
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    while (!counter.IsDone()) {
+        if (!TryRunPendingJob()) {
+            std::this_thread::yield();
+        }
+    }
+
+    // The finishing thread decrements under the lock; acquiring it here makes
+    // sure it is done with the counter before the caller may destroy it
+    std::lock_guard<std::mutex> lock(counter.m_Mutex);
+}
+
+void JobSystem::FinishJob(JobCounter* counter) {
+    if (!counter) return;
+
+    Vector<JobFunction> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_Mutex);
+        if (counter->m_Value.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            continuations.swap(counter->m_Continuations);
+        }
+    }
+
+    for (auto& continuation : continuations) {
+        Submit(std::move(continuation));
+    }
+}
+
+bool JobSystem::TryRunPendingJob() {
+    JobFunction job;
+    if (!FindJob(job)) return false;
+
+    RunJob(job);
+    return true;
+}
+
+u32 JobSystem::GetWorkerCount() {
+    return static_cast<u32>(s_Workers.size());
+}
+
+bool JobSystem::IsInitialized() {
+    return s_Running;
+}
+
+i32 JobSystem::GetCurrentWorkerIndex() {
+    return t_WorkerIndex;
+}
+
+} // namespace Engine
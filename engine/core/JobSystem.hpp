@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Types.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+namespace Engine {
+
+class JobCounter;
+
+// Engine-wide work-stealing thread pool.
+// Every worker owns a deque: it pushes and pops its own jobs at the back while
+// idle workers steal from the front of other queues. Jobs submitted from
+// non-worker threads are distributed round-robin across the worker queues.
+//
+// Dependencies are expressed with JobCounter: jobs submitted against a counter
+// increment it and decrement it when they finish. Waiting threads help run
+// queued work, and continuations attached with SubmitAfter are queued as soon
+// as their dependency counter drops to zero.
+//
+// Example:
+//   JobCounter gather;
+//   JobSystem::Submit([&] { GatherLights(); }, &gather);
+//   JobSystem::Submit([&] { GatherCasters(); }, &gather);
+//   JobSystem::SubmitAfter(gather, [&] { BuildClusters(); });
+class JobSystem {
+public:
+    using JobFunction = std::function<void()>;
+
+    // workerCount = 0 uses hardware_concurrency - 1 (the main thread also helps)
+    static void Init(u32 workerCount = 0);
+    static void Shutdown();
+
+    // Queue a job. Runs inline when no workers are available.
+    static void Submit(JobFunction job);
+    static void Submit(JobFunction job, JobCounter* counter);
+
+    // Queue a job once every job tracked by dependency has finished
+    static void SubmitAfter(JobCounter& dependency, JobFunction job, JobCounter* counter = nullptr);
+
+    // Block until counter reaches zero, running pending jobs meanwhile
+    static void Wait(JobCounter& counter);
+
+    // Split [0, count) into chunks of grainSize and run func(begin, end) on
+    // the workers. The calling thread processes the first chunk and waits.
+    template<typename Func>
+    static void ParallelFor(u32 count, u32 grainSize, Func&& func);
+
+    // Execute one pending job on the calling thread. Returns false when
+    // every queue was empty. Used by threads that wait on other jobs.
+    static bool TryRunPendingJob();
+
+    static u32 GetWorkerCount();
+    static bool IsInitialized();
+
+    // Index of the calling worker thread, -1 for non-worker threads
+    static i32 GetCurrentWorkerIndex();
+
+private:
+    static void FinishJob(JobCounter* counter);
+};
+
+// Tracks a group of in-flight jobs and the continuations waiting on them
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool IsDone() const { return m_Value.load(std::memory_order_acquire) == 0; }
+    u32 GetPendingCount() const { return m_Value.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<u32> m_Value{0};
+    std::mutex m_Mutex;
+    Vector<JobSystem::JobFunction> m_Continuations;
+};
+
+template<typename Func>
+void JobSystem::ParallelFor(u32 count, u32 grainSize, Func&& func) {
+    if (count == 0) return;
+
+    grainSize = std::max(grainSize, 1u);
+    if (count <= grainSize || GetWorkerCount() == 0) {
+        func(0u, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (u32 begin = grainSize; begin < count; begin += grainSize) {
+        u32 end = std::min(begin + grainSize, count);
+        Submit([&func, begin, end]() { func(begin, end); }, &counter);
+    }
+
+    func(0u, grainSize);
+    Wait(counter);
+}
+
+} // namespace Engine
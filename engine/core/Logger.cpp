@@ -1,15 +1,248 @@
 #include "Logger.hpp"
 
+#include <spdlog/sinks/base_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/details/null_mutex.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace Engine {
 
+// AsyncLogSink - the loggers' only sink in async mode.
+//
+// The ring uses the same sequence scheme as EventQueue: a slot whose
+// sequence equals the position is free for the producer claiming that
+// position, position + 1 is written and readable, position + capacity is
+// consumed. Producers are any logging thread, the flush thread is the one
+// consumer. Payloads up to InlinePayload bytes live in the slot; longer
+// ones (shader compile logs) spill into a string the slot keeps, so a slot
+// that has carried one long message doesn't allocate for the next.
+class AsyncLogSink final : public spdlog::sinks::base_sink<spdlog::details::null_mutex> {
+public:
+    static constexpr size_t InlinePayload = 200;
+    static constexpr auto FlushInterval = std::chrono::milliseconds(10);
+
+    AsyncLogSink(std::vector<spdlog::sink_ptr> sinks, size_t capacity)
+        : m_Sinks(std::move(sinks))
+        , m_Capacity(std::bit_ceil(std::max<size_t>(capacity, 2)))
+        , m_Mask(m_Capacity - 1)
+        , m_Records(new Record[m_Capacity])
+    {
+        for (size_t i = 0; i < m_Capacity; i++) {
+            m_Records[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+        m_Thread = std::thread([this] { FlushThread(); });
+    }
+
+    ~AsyncLogSink() override { Stop(); }
+
+    // Drain, then write through on the calling thread from now on
+    void Stop() {
+        if (!m_Running.exchange(false)) return;
+        m_Wake.notify_one();
+        m_Thread.join();
+        std::lock_guard<std::mutex> lock(m_SinkMutex);
+        WriteBatch();
+    }
+
+    void Flush() {
+        if (!m_Running.load()) return;
+
+        const uint64_t target = m_EnqueuePosition.load(std::memory_order_acquire);
+        m_Wake.notify_one();
+        while (m_Written.load(std::memory_order_acquire) < target && m_Running.load()) {
+            std::this_thread::yield();
+        }
+    }
+
+    void AddSink(const spdlog::sink_ptr& sink) {
+        std::lock_guard<std::mutex> lock(m_SinkMutex);
+        m_Sinks.push_back(sink);
+    }
+
+    void RemoveSink(const spdlog::sink_ptr& sink) {
+        std::lock_guard<std::mutex> lock(m_SinkMutex);
+        m_Sinks.erase(std::remove(m_Sinks.begin(), m_Sinks.end(), sink), m_Sinks.end());
+    }
+
+    size_t GetDroppedCount() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& msg) override {
+        if (!m_Running.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(m_SinkMutex);
+            WriteToSinks(msg);
+            return;
+        }
+
+        const bool mustKeep = msg.level >= spdlog::level::err;
+        Record* record = Acquire(mustKeep);
+        if (!record) {
+            // Stopped while waiting for room
+            if (mustKeep) {
+                std::lock_guard<std::mutex> lock(m_SinkMutex);
+                WriteToSinks(msg);
+            }
+            return;
+        }
+
+        record->Time = msg.time;
+        record->ThreadId = msg.thread_id;
+        record->Level = msg.level;
+        record->LoggerName = msg.logger_name;   // Names outlive the loggers' sinks
+        record->Length = msg.payload.size();
+        if (record->Length <= InlinePayload) {
+            std::memcpy(record->Inline, msg.payload.data(), record->Length);
+        } else {
+            record->Spill.assign(msg.payload.data(), record->Length);
+        }
+        const uint64_t position = record->Sequence.load(std::memory_order_relaxed);
+        record->Sequence.store(position + 1, std::memory_order_release);
+
+        if (mustKeep) {
+            m_Wake.notify_one();
+            if (msg.level == spdlog::level::critical) {
+                Flush();
+            }
+        }
+    }
+
+    void flush_() override {}
+
+private:
+    struct Record {
+        std::atomic<uint64_t> Sequence{0};
+        spdlog::log_clock::time_point Time;
+        size_t ThreadId = 0;
+        spdlog::level::level_enum Level = spdlog::level::info;
+        spdlog::string_view_t LoggerName;
+        size_t Length = 0;
+        char Inline[InlinePayload];
+        std::string Spill;
+    };
+
+    Record* Acquire(bool wait) {
+        uint64_t position = m_EnqueuePosition.load(std::memory_order_relaxed);
+        while (true) {
+            Record& record = m_Records[position & m_Mask];
+            const uint64_t sequence = record.Sequence.load(std::memory_order_acquire);
+            const int64_t lag = static_cast<int64_t>(sequence - position);
+
+            if (lag == 0) {
+                if (m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    return &record;
+                }
+            } else if (lag < 0) {
+                // Full
+                if (!wait) {
+                    m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                if (!m_Running.load()) return nullptr;
+                m_Wake.notify_one();
+                std::this_thread::yield();
+                position = m_EnqueuePosition.load(std::memory_order_relaxed);
+            } else {
+                position = m_EnqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void FlushThread() {
+        while (m_Running.load()) {
+            size_t written = 0;
+            {
+                std::lock_guard<std::mutex> lock(m_SinkMutex);
+                written = WriteBatch();
+            }
+
+            if (written == 0) {
+                std::unique_lock<std::mutex> lock(m_WakeMutex);
+                m_Wake.wait_for(lock, FlushInterval);
+            }
+        }
+    }
+
+    // Everything published so far; m_SinkMutex held
+    size_t WriteBatch() {
+        size_t written = 0;
+        while (true) {
+            Record& record = m_Records[m_DequeuePosition & m_Mask];
+            if (record.Sequence.load(std::memory_order_acquire) != m_DequeuePosition + 1) break;
+
+            const char* payload = record.Length <= InlinePayload ? record.Inline : record.Spill.data();
+            spdlog::details::log_msg msg(record.Time, spdlog::source_loc{}, record.LoggerName, record.Level,
+                                         spdlog::string_view_t(payload, record.Length));
+            msg.thread_id = record.ThreadId;
+            WriteToSinks(msg);
+
+            record.Spill.clear();
+            record.Sequence.store(m_DequeuePosition + m_Capacity, std::memory_order_release);
+            m_DequeuePosition++;
+            written++;
+        }
+
+        if (written > 0) {
+            ReportDropped();
+            for (auto& sink : m_Sinks) {
+                sink->flush();
+            }
+            m_Written.store(m_DequeuePosition, std::memory_order_release);
+        }
+        return written;
+    }
+
+    void ReportDropped() {
+        const size_t dropped = m_Dropped.load(std::memory_order_relaxed);
+        if (dropped == m_ReportedDropped) return;
+
+        const std::string text = "Log queue full, " + std::to_string(dropped - m_ReportedDropped) + " messages dropped";
+        m_ReportedDropped = dropped;
+        WriteToSinks(spdlog::details::log_msg(spdlog::string_view_t("ENGINE"), spdlog::level::warn, text));
+    }
+
+    void WriteToSinks(const spdlog::details::log_msg& msg) {
+        for (auto& sink : m_Sinks) {
+            if (sink->should_log(msg.level)) {
+                sink->log(msg);
+            }
+        }
+    }
+
+private:
+    std::vector<spdlog::sink_ptr> m_Sinks;
+    std::mutex m_SinkMutex;     // Flush thread vs AddSink / RemoveSink / Stop
+
+    size_t m_Capacity;
+    uint64_t m_Mask;
+    std::unique_ptr<Record[]> m_Records;
+
+    alignas(64) std::atomic<uint64_t> m_EnqueuePosition{0};
+    alignas(64) uint64_t m_DequeuePosition = 0;     // Flush thread
+    std::atomic<uint64_t> m_Written{0};             // Dequeue position after the last flush
+    std::atomic<size_t> m_Dropped{0};
+    size_t m_ReportedDropped = 0;
+
+    std::atomic<bool> m_Running{true};
+    std::mutex m_WakeMutex;
+    std::condition_variable m_Wake;
+    std::thread m_Thread;
+};
+
 std::shared_ptr<spdlog::logger> Logger::s_CoreLogger;
 std::shared_ptr<spdlog::logger> Logger::s_ClientLogger;
+std::shared_ptr<AsyncLogSink> Logger::s_AsyncSink;
 
-void Logger::Init() {
+void Logger::Init(const Settings& settings) {
     std::vector<spdlog::sink_ptr> logSinks;
     logSinks.emplace_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
     logSinks.emplace_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>("engine.log", true));
@@ -17,15 +250,65 @@ void Logger::Init() {
     logSinks[0]->set_pattern("%^[%T] %n: %v%$");
     logSinks[1]->set_pattern("[%T] [%l] %n: %v");
 
+    if (settings.Async) {
+        s_AsyncSink = std::make_shared<AsyncLogSink>(std::move(logSinks), settings.QueueCapacity);
+        logSinks = {s_AsyncSink};
+    }
+
+    const auto level = static_cast<spdlog::level::level_enum>(ENGINE_LOG_LEVEL);
+
     s_CoreLogger = std::make_shared<spdlog::logger>("ENGINE", begin(logSinks), end(logSinks));
     spdlog::register_logger(s_CoreLogger);
-    s_CoreLogger->set_level(spdlog::level::trace);
-    s_CoreLogger->flush_on(spdlog::level::trace);
+    s_CoreLogger->set_level(level);
 
     s_ClientLogger = std::make_shared<spdlog::logger>("APP", begin(logSinks), end(logSinks));
     spdlog::register_logger(s_ClientLogger);
-    s_ClientLogger->set_level(spdlog::level::trace);
-    s_ClientLogger->flush_on(spdlog::level::trace);
+    s_ClientLogger->set_level(level);
+
+    // The async sink flushes per batch on its own thread
+    if (!settings.Async) {
+        s_CoreLogger->flush_on(spdlog::level::trace);
+        s_ClientLogger->flush_on(spdlog::level::trace);
+    }
+}
+
+void Logger::Shutdown() {
+    if (s_AsyncSink) {
+        s_AsyncSink->Stop();
+    }
+}
+
+void Logger::Flush() {
+    if (s_AsyncSink) {
+        s_AsyncSink->Flush();
+    } else if (s_CoreLogger) {
+        s_CoreLogger->flush();
+        s_ClientLogger->flush();
+    }
+}
+
+void Logger::AddSink(const spdlog::sink_ptr& sink) {
+    if (s_AsyncSink) {
+        s_AsyncSink->AddSink(sink);
+        return;
+    }
+    s_CoreLogger->sinks().push_back(sink);
+    s_ClientLogger->sinks().push_back(sink);
+}
+
+void Logger::RemoveSink(const spdlog::sink_ptr& sink) {
+    if (s_AsyncSink) {
+        s_AsyncSink->RemoveSink(sink);
+        return;
+    }
+    for (auto* logger : {s_CoreLogger.get(), s_ClientLogger.get()}) {
+        auto& sinks = logger->sinks();
+        sinks.erase(std::remove(sinks.begin(), sinks.end(), sink), sinks.end());
+    }
+}
+
+size_t Logger::GetDroppedCount() {
+    return s_AsyncSink ? s_AsyncSink->GetDroppedCount() : 0;
 }
 
 } // namespace Engine
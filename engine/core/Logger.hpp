@@ -3,11 +3,56 @@
 #include <spdlog/spdlog.h>
 #include <memory>
 
+// Lowest level compiled in: 0 trace, 1 debug, 2 info, 3 warn, 4 error
+// (error and critical are always in). Release builds drop trace and debug;
+// calls below the level expand to nothing and their arguments are not
+// evaluated.
+#ifndef ENGINE_LOG_LEVEL
+    #ifdef ENGINE_RELEASE
+        #define ENGINE_LOG_LEVEL 2
+    #else
+        #define ENGINE_LOG_LEVEL 0
+    #endif
+#endif
+
 namespace Engine {
 
+class AsyncLogSink;
+
+// Logger - the engine ("ENGINE") and application ("APP") spdlog loggers.
+//
+// In async mode (the default) the loggers have a single sink that formats
+// the message text on the calling thread into a slot of a fixed-size
+// lock-free ring and returns. A background thread drains the ring in
+// batches into the real sinks (console, engine.log, anything added with
+// AddSink), which apply their patterns and flush once per batch. When the
+// ring is full, messages below error are dropped (and counted); error and
+// critical wait for room, and critical also waits until it is written.
+//
+// Synchronous mode writes through the real sinks on the calling thread.
 class Logger {
 public:
-    static void Init();
+    struct Settings {
+        bool Async = true;
+        size_t QueueCapacity = 8192;    // Messages; rounded up to a power of two
+    };
+
+    static void Init() { Init(Settings()); }
+    static void Init(const Settings& settings);
+
+    // Writes out what is queued and stops the flush thread; later messages
+    // are written synchronously
+    static void Shutdown();
+
+    // Block until everything logged before the call has been written
+    static void Flush();
+
+    // Extra sinks for both loggers; in async mode they run on the flush thread
+    static void AddSink(const spdlog::sink_ptr& sink);
+    static void RemoveSink(const spdlog::sink_ptr& sink);
+
+    // Messages lost to a full queue since Init
+    static size_t GetDroppedCount();
 
     static std::shared_ptr<spdlog::logger>& GetCoreLogger() { return s_CoreLogger; }
     static std::shared_ptr<spdlog::logger>& GetClientLogger() { return s_ClientLogger; }
@@ -15,22 +60,45 @@ public:
 private:
     static std::shared_ptr<spdlog::logger> s_CoreLogger;
     static std::shared_ptr<spdlog::logger> s_ClientLogger;
+    static std::shared_ptr<AsyncLogSink> s_AsyncSink;
 };
 
 } // namespace Engine
 
-// Core logging macros
-#define LOG_CORE_TRACE(...)    ::Engine::Logger::GetCoreLogger()->trace(__VA_ARGS__)
-#define LOG_CORE_DEBUG(...)    ::Engine::Logger::GetCoreLogger()->debug(__VA_ARGS__)
-#define LOG_CORE_INFO(...)     ::Engine::Logger::GetCoreLogger()->info(__VA_ARGS__)
-#define LOG_CORE_WARN(...)     ::Engine::Logger::GetCoreLogger()->warn(__VA_ARGS__)
+// Logging macros, core (LOG_CORE_*) and client (LOG_*)
+#if ENGINE_LOG_LEVEL <= 0
+    #define LOG_CORE_TRACE(...)    ::Engine::Logger::GetCoreLogger()->trace(__VA_ARGS__)
+    #define LOG_TRACE(...)         ::Engine::Logger::GetClientLogger()->trace(__VA_ARGS__)
+#else
+    #define LOG_CORE_TRACE(...)    (void)0
+    #define LOG_TRACE(...)         (void)0
+#endif
+
+#if ENGINE_LOG_LEVEL <= 1
+    #define LOG_CORE_DEBUG(...)    ::Engine::Logger::GetCoreLogger()->debug(__VA_ARGS__)
+    #define LOG_DEBUG(...)         ::Engine::Logger::GetClientLogger()->debug(__VA_ARGS__)
+#else
+    #define LOG_CORE_DEBUG(...)    (void)0
+    #define LOG_DEBUG(...)         (void)0
+#endif
+
+#if ENGINE_LOG_LEVEL <= 2
+    #define LOG_CORE_INFO(...)     ::Engine::Logger::GetCoreLogger()->info(__VA_ARGS__)
+    #define LOG_INFO(...)          ::Engine::Logger::GetClientLogger()->info(__VA_ARGS__)
+#else
+    #define LOG_CORE_INFO(...)     (void)0
+    #define LOG_INFO(...)          (void)0
+#endif
+
+#if ENGINE_LOG_LEVEL <= 3
+    #define LOG_CORE_WARN(...)     ::Engine::Logger::GetCoreLogger()->warn(__VA_ARGS__)
+    #define LOG_WARN(...)          ::Engine::Logger::GetClientLogger()->warn(__VA_ARGS__)
+#else
+    #define LOG_CORE_WARN(...)     (void)0
+    #define LOG_WARN(...)          (void)0
+#endif
+
 #define LOG_CORE_ERROR(...)    ::Engine::Logger::GetCoreLogger()->error(__VA_ARGS__)
+#define LOG_ERROR(...)         ::Engine::Logger::GetClientLogger()->error(__VA_ARGS__)
 #define LOG_CORE_CRITICAL(...) ::Engine::Logger::GetCoreLogger()->critical(__VA_ARGS__)
-
-// Client logging macros
-#define LOG_TRACE(...)    ::Engine::Logger::GetClientLogger()->trace(__VA_ARGS__)
-#define LOG_DEBUG(...)    ::Engine::Logger::GetClientLogger()->debug(__VA_ARGS__)
-#define LOG_INFO(...)     ::Engine::Logger::GetClientLogger()->info(__VA_ARGS__)
-#define LOG_WARN(...)     ::Engine::Logger::GetClientLogger()->warn(__VA_ARGS__)
-#define LOG_ERROR(...)    ::Engine::Logger::GetClientLogger()->error(__VA_ARGS__)
-#define LOG_CRITICAL(...) ::Engine::Logger::GetClientLogger()->critical(__VA_ARGS__)
+#define LOG_CRITICAL(...)      ::Engine::Logger::GetClientLogger()->critical(__VA_ARGS__)
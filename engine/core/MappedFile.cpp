@@ -0,0 +1,165 @@
+#include "MappedFile.hpp"
+#include "Logger.hpp"
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Engine {
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_Data(other.m_Data)
+    , m_Size(other.m_Size)
+    , m_IsOpen(other.m_IsOpen)
+#ifdef _WIN32
+    , m_FileHandle(other.m_FileHandle)
+    , m_MappingHandle(other.m_MappingHandle)
+#endif
+{
+    other.m_Data = nullptr;
+    other.m_Size = 0;
+    other.m_IsOpen = false;
+#ifdef _WIN32
+    other.m_FileHandle = nullptr;
+    other.m_MappingHandle = nullptr;
+#endif
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+
+        m_Data = other.m_Data;
+        m_Size = other.m_Size;
+        m_IsOpen = other.m_IsOpen;
+        other.m_Data = nullptr;
+        other.m_Size = 0;
+        other.m_IsOpen = false;
+#ifdef _WIN32
+        m_FileHandle = other.m_FileHandle;
+        m_MappingHandle = other.m_MappingHandle;
+        other.m_FileHandle = nullptr;
+        other.m_MappingHandle = nullptr;
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const String& filepath) {
+    Close();
+
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        LOG_CORE_ERROR("MappedFile: Failed to open {}", filepath);
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        LOG_CORE_ERROR("MappedFile: Failed to query size of {}", filepath);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_FileHandle = file;
+    m_Size = static_cast<usize>(size.QuadPart);
+    m_IsOpen = true;
+    if (m_Size == 0) {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        LOG_CORE_ERROR("MappedFile: Failed to map {}", filepath);
+        if (mapping) CloseHandle(mapping);
+        Close();
+        return false;
+    }
+
+    m_MappingHandle = mapping;
+    m_Data = static_cast<const u8*>(view);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_Data) UnmapViewOfFile(m_Data);
+    if (m_MappingHandle) CloseHandle(static_cast<HANDLE>(m_MappingHandle));
+    if (m_FileHandle) CloseHandle(static_cast<HANDLE>(m_FileHandle));
+
+    m_Data = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+    m_FileHandle = nullptr;
+    m_MappingHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const String& filepath) {
+    Close();
+
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_CORE_ERROR("MappedFile: Failed to open {}", filepath);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        LOG_CORE_ERROR("MappedFile: Failed to query size of {}", filepath);
+        close(fd);
+        return false;
+    }
+
+    m_Size = static_cast<usize>(info.st_size);
+    m_IsOpen = true;
+    if (m_Size == 0) {
+        close(fd);
+        return true;
+    }
+
+    void* view = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps the file referenced
+    if (view == MAP_FAILED) {
+        LOG_CORE_ERROR("MappedFile: Failed to map {}", filepath);
+        m_Size = 0;
+        m_IsOpen = false;
+        return false;
+    }
+
+    madvise(view, m_Size, MADV_SEQUENTIAL);
+    m_Data = static_cast<const u8*>(view);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_Data) {
+        munmap(const_cast<u8*>(m_Data), m_Size);
+    }
+    m_Data = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+}
+
+#endif
+
+} // namespace Engine
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Types.hpp"
+
+namespace Engine {
+
+// Read-only memory mapping of a whole file. Pages are faulted in as they are
+// touched, so large assets can be parsed in place without a copy into a
+// read buffer. Empty files open successfully with a null Data().
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const String& filepath) { Open(filepath); }
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool Open(const String& filepath);
+    void Close();
+
+    bool IsOpen() const { return m_IsOpen; }
+    const u8* Data() const { return m_Data; }
+    usize Size() const { return m_Size; }
+
+    const char* Begin() const { return reinterpret_cast<const char*>(m_Data); }
+    const char* End() const { return Begin() + m_Size; }
+
+private:
+    const u8* m_Data = nullptr;
+    usize m_Size = 0;
+    bool m_IsOpen = false;
+#ifdef _WIN32
+    void* m_FileHandle = nullptr;
+    void* m_MappingHandle = nullptr;
+#endif
+};
+
+} // namespace Engine
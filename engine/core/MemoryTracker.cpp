@@ -0,0 +1,211 @@
+#include "MemoryTracker.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace Engine {
+
+namespace {
+
+constexpr usize TagCount = static_cast<usize>(MemoryTag::Count);
+
+// Constant-initialized: operator new may run before any dynamic
+// initialization of this translation unit
+struct TagCounters {
+    std::atomic<u64> LiveBytes{0};
+    std::atomic<u64> LiveAllocations{0};
+    std::atomic<u64> FrameAllocations{0};
+    std::atomic<u64> FrameBytes{0};
+};
+
+TagCounters s_Counters[TagCount];
+
+// Published by EndFrame, GPU totals; main thread only
+u64 s_LastFrameAllocations[TagCount] = {};
+u64 s_LastFrameBytes[TagCount] = {};
+u64 s_GPUBytes[TagCount][2] = {};
+
+thread_local MemoryTag t_Tag = MemoryTag::General;
+
+usize ToIndex(MemoryTag tag) {
+    const usize index = static_cast<usize>(tag);
+    return index < TagCount ? index : 0;
+}
+
+#ifdef ENGINE_ENABLE_MEMORY_TRACKING
+
+// Sits right before the pointer handed out; Offset leads back to the block
+// malloc returned
+struct AllocationHeader {
+    u64 Size;
+    u32 Offset;
+    MemoryTag Tag;
+};
+
+constexpr usize HeaderSize = 16;
+constexpr usize MallocAlignment = alignof(std::max_align_t);
+static_assert(sizeof(AllocationHeader) <= HeaderSize, "AllocationHeader must fit in HeaderSize");
+
+void* TrackedAllocate(usize size, usize alignment) noexcept {
+    if (alignment < HeaderSize) alignment = HeaderSize;
+
+    // Enough slack to align past the header from any MallocAlignment address
+    const usize padding = HeaderSize + alignment - MallocAlignment;
+    auto* block = static_cast<u8*>(std::malloc(size + padding));
+    if (!block) return nullptr;
+
+    const auto address = reinterpret_cast<std::uintptr_t>(block) + HeaderSize;
+    auto* user = reinterpret_cast<u8*>((address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1));
+
+    auto* header = reinterpret_cast<AllocationHeader*>(user - HeaderSize);
+    header->Size = size;
+    header->Offset = static_cast<u32>(user - block);
+    header->Tag = t_Tag;
+
+    TagCounters& counters = s_Counters[ToIndex(header->Tag)];
+    counters.LiveBytes.fetch_add(size, std::memory_order_relaxed);
+    counters.LiveAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.FrameAllocations.fetch_add(1, std::memory_order_relaxed);
+    counters.FrameBytes.fetch_add(size, std::memory_order_relaxed);
+    return user;
+}
+
+void TrackedFree(void* pointer) noexcept {
+    if (!pointer) return;
+
+    auto* user = static_cast<u8*>(pointer);
+    const auto* header = reinterpret_cast<const AllocationHeader*>(user - HeaderSize);
+
+    TagCounters& counters = s_Counters[ToIndex(header->Tag)];
+    counters.LiveBytes.fetch_sub(header->Size, std::memory_order_relaxed);
+    counters.LiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+
+    std::free(user - header->Offset);
+}
+
+void* TrackedAllocateOrThrow(usize size, usize alignment) {
+    if (void* pointer = TrackedAllocate(size, alignment)) return pointer;
+
+    // As the standard operator new: give the new-handler a chance, then throw
+    while (std::new_handler handler = std::get_new_handler()) {
+        handler();
+        if (void* pointer = TrackedAllocate(size, alignment)) return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+#endif
+
+} // anonymous namespace
+
+const char* MemoryTagToString(MemoryTag tag) {
+    switch (tag) {
+        case MemoryTag::General:   return "General";
+        case MemoryTag::Resources: return "Resources";
+        case MemoryTag::ECS:       return "ECS";
+        case MemoryTag::Gameplay:  return "Gameplay";
+        case MemoryTag::Renderer:  return "Renderer";
+        case MemoryTag::Geometry:  return "Geometry";
+        case MemoryTag::Shadows:   return "Shadows";
+        case MemoryTag::Particles: return "Particles";
+        case MemoryTag::Editor:    return "Editor";
+        default:                   return "Unknown";
+    }
+}
+
+bool MemoryTracker::IsCPUTrackingEnabled() {
+#ifdef ENGINE_ENABLE_MEMORY_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MemoryTracker::EndFrame() {
+    for (usize i = 0; i < TagCount; ++i) {
+        s_LastFrameAllocations[i] = s_Counters[i].FrameAllocations.exchange(0, std::memory_order_relaxed);
+        s_LastFrameBytes[i] = s_Counters[i].FrameBytes.exchange(0, std::memory_order_relaxed);
+    }
+}
+
+MemoryTracker::TagStats MemoryTracker::GetStats(MemoryTag tag) {
+    const usize i = ToIndex(tag);
+    TagStats stats;
+    stats.LiveBytes = s_Counters[i].LiveBytes.load(std::memory_order_relaxed);
+    stats.LiveAllocations = s_Counters[i].LiveAllocations.load(std::memory_order_relaxed);
+    stats.FrameAllocations = s_LastFrameAllocations[i];
+    stats.FrameBytes = s_LastFrameBytes[i];
+    stats.GPUBufferBytes = s_GPUBytes[i][static_cast<usize>(GPUKind::Buffer)];
+    stats.GPUTextureBytes = s_GPUBytes[i][static_cast<usize>(GPUKind::Texture)];
+    return stats;
+}
+
+MemoryTracker::TagStats MemoryTracker::GetTotal() {
+    TagStats total;
+    for (usize i = 0; i < TagCount; ++i) {
+        const TagStats stats = GetStats(static_cast<MemoryTag>(i));
+        total.LiveBytes += stats.LiveBytes;
+        total.LiveAllocations += stats.LiveAllocations;
+        total.FrameAllocations += stats.FrameAllocations;
+        total.FrameBytes += stats.FrameBytes;
+        total.GPUBufferBytes += stats.GPUBufferBytes;
+        total.GPUTextureBytes += stats.GPUTextureBytes;
+    }
+    return total;
+}
+
+MemoryTag MemoryTracker::SetThreadTag(MemoryTag tag) {
+    const MemoryTag previous = t_Tag;
+    t_Tag = tag;
+    return previous;
+}
+
+MemoryTag MemoryTracker::GetThreadTag() {
+    return t_Tag;
+}
+
+void MemoryTracker::RecordGPU(MemoryTag tag, GPUKind kind, i64 deltaBytes) {
+    u64& bytes = s_GPUBytes[ToIndex(tag)][static_cast<usize>(kind)];
+    bytes = deltaBytes < 0 && static_cast<u64>(-deltaBytes) > bytes ? 0 : bytes + static_cast<u64>(deltaBytes);
+}
+
+} // namespace Engine
+
+#ifdef ENGINE_ENABLE_MEMORY_TRACKING
+
+// Global replacements. Defined beside MemoryTracker::EndFrame, which the
+// Application calls, so linking GameEngine always pulls them in.
+void* operator new(std::size_t size) { return Engine::TrackedAllocateOrThrow(size, 0); }
+void* operator new[](std::size_t size) { return Engine::TrackedAllocateOrThrow(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return Engine::TrackedAllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return Engine::TrackedAllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return Engine::TrackedAllocate(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Engine::TrackedAllocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return Engine::TrackedAllocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return Engine::TrackedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept { Engine::TrackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { Engine::TrackedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { Engine::TrackedFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { Engine::TrackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { Engine::TrackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { Engine::TrackedFree(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { Engine::TrackedFree(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { Engine::TrackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { Engine::TrackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { Engine::TrackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { Engine::TrackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { Engine::TrackedFree(pointer); }
+
+#endif
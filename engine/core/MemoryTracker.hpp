@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Types.hpp"
+
+namespace Engine {
+
+// Subsystem an allocation is charged to
+enum class MemoryTag : u8 {
+    General = 0,
+    Resources,      // Loading and streaming, texture storage
+    ECS,            // System updates
+    Gameplay,       // Application::OnUpdate
+    Renderer,       // Render phases, render targets and GPU work buffers
+    Geometry,       // Vertex / index buffers
+    Shadows,
+    Particles,
+    Editor,         // ImGui frame
+    Count
+};
+
+const char* MemoryTagToString(MemoryTag tag);
+
+// MemoryTracker - CPU and GPU memory per subsystem.
+//
+// CPU: with ENGINE_ENABLE_MEMORY_TRACKING the global operator new / delete
+// are replaced. Every allocation carries a header holding its size and the
+// tag of the innermost MEMORY_TAG scope on the allocating thread (General
+// outside any scope); it is charged to that tag, and its delete is credited
+// back to the same tag whichever thread frees it. Counters are relaxed
+// atomics, so any thread may allocate.
+//
+// GPU: GLMemory (renderer/opengl/GLMemory.hpp) records buffer and texture
+// storage as it is created and deleted. Always on; GL thread only.
+//
+// EndFrame(), called by the Application once a frame, publishes the
+// allocation counts of the frame that just ended and starts the next.
+class MemoryTracker {
+public:
+    enum class GPUKind : u8 { Buffer, Texture };
+
+    struct TagStats {
+        u64 LiveBytes = 0;          // CPU, currently allocated
+        u64 LiveAllocations = 0;
+        u64 FrameAllocations = 0;   // CPU, during the last complete frame
+        u64 FrameBytes = 0;
+        u64 GPUBufferBytes = 0;
+        u64 GPUTextureBytes = 0;
+    };
+
+    // False when built without ENGINE_ENABLE_MEMORY_TRACKING; the CPU
+    // figures then stay zero
+    static bool IsCPUTrackingEnabled();
+
+    static void EndFrame();
+
+    static TagStats GetStats(MemoryTag tag);
+    static TagStats GetTotal();
+
+    // Tag new allocations on the calling thread are charged to; returns the
+    // previous one. Use MEMORY_TAG rather than calling this directly.
+    static MemoryTag SetThreadTag(MemoryTag tag);
+    static MemoryTag GetThreadTag();
+
+    // deltaBytes is negative when storage is released
+    static void RecordGPU(MemoryTag tag, GPUKind kind, i64 deltaBytes);
+};
+
+class MemoryTagScope {
+public:
+    explicit MemoryTagScope(MemoryTag tag) : m_Previous(MemoryTracker::SetThreadTag(tag)) {}
+    ~MemoryTagScope() { MemoryTracker::SetThreadTag(m_Previous); }
+
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+private:
+    MemoryTag m_Previous;
+};
+
+} // namespace Engine
+
+#ifdef ENGINE_ENABLE_MEMORY_TRACKING
+    #define MEMORY_TAG_CONCAT_IMPL(a, b) a##b
+    #define MEMORY_TAG_CONCAT(a, b) MEMORY_TAG_CONCAT_IMPL(a, b)
+    #define MEMORY_TAG(tag) ::Engine::MemoryTagScope MEMORY_TAG_CONCAT(memoryTagScope, __COUNTER__)(::Engine::MemoryTag::tag)
+#else
+    #define MEMORY_TAG(tag) ((void)0)
+#endif
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Types.hpp"
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace Engine {
+
+// ObjectPool - typed free-list allocator for objects that are created and
+// destroyed at a high rate (particle emitters and the like).
+//
+// Storage comes in blocks of BlockSize slots that are never moved or freed
+// until the pool is, so an object's address is stable for its whole life and
+// a destroyed object's slot is handed to the next Create() instead of going
+// back to the heap. A pool that has reached its high-water mark does no heap
+// allocation at all.
+//
+// Destroying the pool (or Clear()) destroys every object still alive in it.
+// Not thread-safe.
+template<typename T, usize BlockSize = 64>
+class ObjectPool {
+    static_assert(BlockSize > 0, "ObjectPool needs at least one slot per block");
+
+public:
+    ObjectPool() = default;
+    ~ObjectPool() { Clear(); }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template<typename... Args>
+    T* Create(Args&&... args) {
+        if (!m_FreeList) {
+            AddBlock();
+        }
+
+        Slot* slot = m_FreeList;
+        T* object = new (slot->Storage) T(std::forward<Args>(args)...);
+        m_FreeList = slot->NextFree;
+        slot->Live = true;
+        m_LiveCount++;
+        return object;
+    }
+
+    // Object must have come from this pool
+    void Destroy(T* object) {
+        if (!object) return;
+
+        Slot* slot = reinterpret_cast<Slot*>(reinterpret_cast<u8*>(object) - offsetof(Slot, Storage));
+        object->~T();
+        slot->Live = false;
+        slot->NextFree = m_FreeList;
+        m_FreeList = slot;
+        m_LiveCount--;
+    }
+
+    // Destroys every live object; the blocks are kept
+    void Clear() {
+        if (m_LiveCount == 0) return;
+
+        for (auto& block : m_Blocks) {
+            for (usize i = 0; i < BlockSize; i++) {
+                if (block[i].Live) {
+                    Destroy(reinterpret_cast<T*>(block[i].Storage));
+                }
+            }
+        }
+    }
+
+    usize GetLiveCount() const { return m_LiveCount; }
+    usize GetCapacity() const { return m_Blocks.size() * BlockSize; }
+
+private:
+    struct Slot {
+        alignas(T) u8 Storage[sizeof(T)];
+        Slot* NextFree = nullptr;
+        bool Live = false;
+    };
+
+    void AddBlock() {
+        // Threaded onto the free list in address order
+        auto block = CreateScope<Slot[]>(BlockSize);
+        for (usize i = 0; i + 1 < BlockSize; i++) {
+            block[i].NextFree = &block[i + 1];
+        }
+        block[BlockSize - 1].NextFree = m_FreeList;
+        m_FreeList = &block[0];
+        m_Blocks.push_back(std::move(block));
+    }
+
+private:
+    Vector<Scope<Slot[]>> m_Blocks;
+    Slot* m_FreeList = nullptr;
+    usize m_LiveCount = 0;
+};
+
+} // namespace Engine
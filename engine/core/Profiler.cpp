@@ -0,0 +1,191 @@
+#include "Profiler.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace Engine {
+
+namespace {
+
+struct ProfileEvent {
+    const char* Name = nullptr;
+    u64 Begin = 0;
+    u64 End = 0;
+};
+
+// Written only by its thread (the GL thread for the GPU track). Head counts
+// every event ever recorded; event i lives in slot i % EventsPerThread until
+// event i + EventsPerThread replaces it.
+struct ThreadBuffer {
+    ProfileEvent Events[Profiler::EventsPerThread];
+    std::atomic<u64> Head{0};
+    std::atomic<u64> Tail{0};       // Events before it were cleared
+    u32 ThreadIndex = 0;
+
+    std::atomic<const String*> Name{nullptr};
+    Vector<Scope<String>> Names;    // Every name set, as exports may still read an old one
+
+    ThreadBuffer* Next = nullptr;
+};
+
+static_assert((Profiler::EventsPerThread & (Profiler::EventsPerThread - 1)) == 0,
+              "EventsPerThread must be a power of two");
+
+// Buffers are pushed once per thread and live for the rest of the process,
+// so exports can read threads that have exited
+std::atomic<ThreadBuffer*> s_Buffers{nullptr};
+std::atomic<u32> s_ThreadCount{0};
+
+thread_local ThreadBuffer* t_Buffer = nullptr;
+ThreadBuffer* s_GPUBuffer = nullptr;
+
+ThreadBuffer* CreateBuffer() {
+    auto* buffer = new ThreadBuffer();
+    buffer->ThreadIndex = s_ThreadCount.fetch_add(1, std::memory_order_relaxed);
+    buffer->Next = s_Buffers.load(std::memory_order_relaxed);
+    while (!s_Buffers.compare_exchange_weak(buffer->Next, buffer,
+                                            std::memory_order_release, std::memory_order_relaxed)) {}
+    return buffer;
+}
+
+ThreadBuffer& GetThreadBuffer() {
+    if (!t_Buffer) {
+        t_Buffer = CreateBuffer();
+    }
+    return *t_Buffer;
+}
+
+void Push(ThreadBuffer& buffer, const char* name, u64 begin, u64 end) {
+    const u64 head = buffer.Head.load(std::memory_order_relaxed);
+    buffer.Events[head & (Profiler::EventsPerThread - 1)] = ProfileEvent{name, begin, end};
+    buffer.Head.store(head + 1, std::memory_order_release);
+}
+
+void WriteEscaped(std::FILE* file, const char* text) {
+    for (const char* c = text; *c; ++c) {
+        switch (*c) {
+            case '"':  std::fputs("\\\"", file); break;
+            case '\\': std::fputs("\\\\", file); break;
+            case '\n': std::fputs("\\n", file); break;
+            default:
+                if (static_cast<unsigned char>(*c) >= 0x20) std::fputc(*c, file);
+                break;
+        }
+    }
+}
+
+} // anonymous namespace
+
+u64 Profiler::Now() {
+    using namespace std::chrono;
+    return static_cast<u64>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+void Profiler::Record(const char* name, u64 begin, u64 end) {
+    Push(GetThreadBuffer(), name, begin, end);
+}
+
+void Profiler::RecordGPU(const char* name, u64 begin, u64 end) {
+    if (!s_GPUBuffer) {
+        s_GPUBuffer = CreateBuffer();
+        s_GPUBuffer->Names.push_back(CreateScope<String>("GPU"));
+        s_GPUBuffer->Name.store(s_GPUBuffer->Names.back().get(), std::memory_order_release);
+    }
+    Push(*s_GPUBuffer, name, begin, end);
+}
+
+void Profiler::SetThreadName(const String& name) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    buffer.Names.push_back(CreateScope<String>(name));
+    buffer.Name.store(buffer.Names.back().get(), std::memory_order_release);
+}
+
+void Profiler::Clear() {
+    for (ThreadBuffer* buffer = s_Buffers.load(std::memory_order_acquire); buffer; buffer = buffer->Next) {
+        buffer->Tail.store(buffer->Head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+bool Profiler::WriteChromeTrace(const String& filepath) {
+    // Copy first: the file is written without racing the recording threads
+    struct ThreadEvents {
+        u32 ThreadIndex = 0;
+        String Name;
+        Vector<ProfileEvent> Events;
+    };
+    Vector<ThreadEvents> threads;
+    u64 origin = ~0ull;
+
+    for (ThreadBuffer* buffer = s_Buffers.load(std::memory_order_acquire); buffer; buffer = buffer->Next) {
+        ThreadEvents& thread = threads.emplace_back();
+        thread.ThreadIndex = buffer->ThreadIndex;
+        if (const String* name = buffer->Name.load(std::memory_order_acquire)) {
+            thread.Name = *name;
+        } else {
+            thread.Name = "Thread " + std::to_string(buffer->ThreadIndex);
+        }
+
+        const u64 tail = buffer->Tail.load(std::memory_order_relaxed);
+        const u64 head = buffer->Head.load(std::memory_order_acquire);
+        u64 first = std::max(tail, head > EventsPerThread ? head - EventsPerThread : 0);
+        for (u64 i = first; i < head; i++) {
+            thread.Events.push_back(buffer->Events[i & (EventsPerThread - 1)]);
+        }
+
+        // Slots the owner reached during the copy hold newer events: drop
+        // the copies of those. The slot being written when head was read
+        // again may be torn too, hence the + 1.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const u64 after = buffer->Head.load(std::memory_order_relaxed);
+        const u64 overwritten = after + 1 > EventsPerThread ? after + 1 - EventsPerThread : 0;
+        if (overwritten > first) {
+            const u64 drop = std::min<u64>(overwritten - first, thread.Events.size());
+            thread.Events.erase(thread.Events.begin(), thread.Events.begin() + static_cast<std::ptrdiff_t>(drop));
+        }
+
+        for (const auto& event : thread.Events) {
+            origin = std::min(origin, event.Begin);
+        }
+    }
+
+    std::FILE* file = std::fopen(filepath.c_str(), "wb");
+    if (!file) {
+        LOG_CORE_ERROR("Profiler: could not write {}", filepath);
+        return false;
+    }
+
+    usize eventCount = 0;
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+    bool first = true;
+    for (const auto& thread : threads) {
+        std::fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                     first ? "" : ",", thread.ThreadIndex);
+        WriteEscaped(file, thread.Name.c_str());
+        std::fputs("\"}}", file);
+        first = false;
+
+        // Complete events, microseconds from the earliest one
+        for (const auto& event : thread.Events) {
+            std::fputs(",\n{\"name\":\"", file);
+            WriteEscaped(file, event.Name ? event.Name : "?");
+            std::fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         thread.ThreadIndex,
+                         static_cast<f64>(event.Begin - origin) / 1000.0,
+                         static_cast<f64>(event.End - event.Begin) / 1000.0);
+        }
+        eventCount += thread.Events.size();
+    }
+    std::fputs("\n]}\n", file);
+
+    const bool ok = std::fclose(file) == 0;
+    if (ok) {
+        LOG_CORE_INFO("Profiler: wrote {} events from {} threads to {}", eventCount, threads.size(), filepath);
+    } else {
+        LOG_CORE_ERROR("Profiler: could not write {}", filepath);
+    }
+    return ok;
+}
+
+} // namespace Engine
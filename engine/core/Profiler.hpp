@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Types.hpp"
+#include <atomic>
+
+namespace Engine {
+
+// CPU zone profiler, compiled in with ENGINE_ENABLE_PROFILING.
+//
+// PROFILE_SCOPE / PROFILE_FUNCTION time the enclosing scope and record one
+// event (name, begin, end) into a ring buffer owned by the calling thread:
+// a store and a release increment, no locks and no allocation after the
+// thread's first zone. The newest EventsPerThread events of every thread
+// are kept. WriteChromeTrace() exports them as Chrome trace JSON, which
+// chrome://tracing and ui.perfetto.dev open.
+//
+// Zone names must outlive the profiler (string literals, __FUNCTION__,
+// ISystem::GetName).
+class Profiler {
+public:
+    static constexpr u32 EventsPerThread = 1u << 16;
+
+    // Nanoseconds on a steady clock
+    static u64 Now();
+
+    static void Record(const char* name, u64 begin, u64 end);
+
+    // Record onto the "GPU" track (GPUProfiler); times already converted to
+    // Now()'s clock. GL thread only.
+    static void RecordGPU(const char* name, u64 begin, u64 end);
+
+    // Name the calling thread in exported traces
+    static void SetThreadName(const String& name);
+
+    // Write every thread's buffered events. Safe while other threads record;
+    // events overwritten during the copy are dropped.
+    static bool WriteChromeTrace(const String& filepath);
+
+    // Forget the buffered events of every thread
+    static void Clear();
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : m_Name(name), m_Begin(Profiler::Now()) {}
+    ~ProfileScope() { Profiler::Record(m_Name, m_Begin, Profiler::Now()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_Name;
+    u64 m_Begin;
+};
+
+} // namespace Engine
+
+#ifdef ENGINE_ENABLE_PROFILING
+    #define PROFILE_CONCAT_IMPL(a, b) a##b
+    #define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+    #define PROFILE_SCOPE(name) ::Engine::ProfileScope PROFILE_CONCAT(profileScope, __COUNTER__)(name)
+    #define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+    #define PROFILE_THREAD(name) ::Engine::Profiler::SetThreadName(name)
+#else
+    #define PROFILE_SCOPE(name) ((void)0)
+    #define PROFILE_FUNCTION() ((void)0)
+    #define PROFILE_THREAD(name) ((void)0)
+#endif
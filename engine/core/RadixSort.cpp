@@ -0,0 +1,74 @@
+#include "RadixSort.hpp"
+
+#include <algorithm>
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 RadixBits = 8;
+constexpr u32 BucketCount = 1u << RadixBits;
+constexpr u32 PassCount = 64 / RadixBits;
+
+// Below this insertion sort beats building eight histograms
+constexpr usize SmallSortThreshold = 64;
+
+} // anonymous namespace
+
+void RadixSort(Vector<SortKeyIndex>& entries, Vector<SortKeyIndex>& scratch) {
+    const usize count = entries.size();
+    if (count < 2) return;
+
+    if (count <= SmallSortThreshold) {
+        for (usize i = 1; i < count; ++i) {
+            SortKeyIndex value = entries[i];
+            usize j = i;
+            while (j > 0 && entries[j - 1].Key > value.Key) {
+                entries[j] = entries[j - 1];
+                --j;
+            }
+            entries[j] = value;
+        }
+        return;
+    }
+
+    // All histograms in one read pass
+    u32 histograms[PassCount][BucketCount] = {};
+    for (const auto& entry : entries) {
+        for (u32 pass = 0; pass < PassCount; ++pass) {
+            histograms[pass][(entry.Key >> (pass * RadixBits)) & (BucketCount - 1)]++;
+        }
+    }
+
+    scratch.resize(count);
+    SortKeyIndex* source = entries.data();
+    SortKeyIndex* destination = scratch.data();
+
+    for (u32 pass = 0; pass < PassCount; ++pass) {
+        u32* histogram = histograms[pass];
+        const u32 shift = pass * RadixBits;
+
+        // Every key has the same digit: this pass would be an identity copy
+        if (histogram[(source[0].Key >> shift) & (BucketCount - 1)] == count) continue;
+
+        u32 offset = 0;
+        for (u32 bucket = 0; bucket < BucketCount; ++bucket) {
+            u32 bucketSize = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketSize;
+        }
+
+        for (usize i = 0; i < count; ++i) {
+            const SortKeyIndex& entry = source[i];
+            destination[histogram[(entry.Key >> shift) & (BucketCount - 1)]++] = entry;
+        }
+
+        std::swap(source, destination);
+    }
+
+    if (source != entries.data()) {
+        std::copy(source, source + count, entries.data());
+    }
+}
+
+} // namespace Engine
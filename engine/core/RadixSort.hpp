@@ -0,0 +1,19 @@
+#pragma once
+
+#include "core/Types.hpp"
+
+namespace Engine {
+
+// 64-bit key with the index of the item it was computed for. Sorting these
+// instead of the items keeps the sort cache-friendly for fat records.
+struct SortKeyIndex {
+    u64 Key = 0;
+    u32 Index = 0;
+};
+
+// Stable LSD radix sort on Key, 8 bits per pass. Passes where every key has
+// the same byte are skipped, so keys that only use a few bits sort in fewer
+// passes. scratch is resized as needed and can be reused across calls.
+void RadixSort(Vector<SortKeyIndex>& entries, Vector<SortKeyIndex>& scratch);
+
+} // namespace Engine
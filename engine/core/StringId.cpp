@@ -0,0 +1,134 @@
+#include "StringId.hpp"
+#include "Logger.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+namespace Engine {
+
+namespace {
+
+struct Entry {
+    const char* Text;
+    u32 Length;
+};
+
+// Entries sit in fixed pages that never move, so an id's text is read
+// without the lock; the lock only guards interning
+constexpr u32 PageSize = 4096;
+constexpr u32 PageCount = StringId::MaxCount / PageSize;
+constexpr usize TextBlockSize = 64 * 1024;
+
+struct StringTable {
+    std::mutex Mutex;
+    std::atomic<Entry*> Pages[PageCount] = {};
+    std::atomic<u32> Count{0};
+
+    HashMap<std::string_view, u32> Ids;     // Views into the text blocks
+    Vector<Scope<char[]>> TextBlocks;
+    Vector<Scope<char[]>> LongTexts;
+    usize TextUsed = TextBlockSize;         // In the last block
+    bool Full = false;
+
+    StringTable() {
+        static const char empty[] = "";
+        Append({empty, 0});
+    }
+
+    ~StringTable() {
+        for (auto& page : Pages) delete[] page.load(std::memory_order_relaxed);
+    }
+
+    const char* Store(std::string_view text) {
+        const usize size = text.size() + 1;
+        char* storage;
+        if (size > TextBlockSize / 4) {
+            // Long strings get a block of their own; the current one stays open
+            LongTexts.push_back(Scope<char[]>(new char[size]));
+            storage = LongTexts.back().get();
+        } else {
+            if (TextUsed + size > TextBlockSize) {
+                TextBlocks.push_back(Scope<char[]>(new char[TextBlockSize]));
+                TextUsed = 0;
+            }
+            storage = TextBlocks.back().get() + TextUsed;
+            TextUsed += size;
+        }
+        std::memcpy(storage, text.data(), text.size());
+        storage[text.size()] = '\0';
+        return storage;
+    }
+
+    u32 Append(const Entry& entry) {
+        const u32 id = Count.load(std::memory_order_relaxed);
+        Entry* page = Pages[id / PageSize].load(std::memory_order_relaxed);
+        if (!page) {
+            page = new Entry[PageSize];
+            Pages[id / PageSize].store(page, std::memory_order_release);
+        }
+        page[id % PageSize] = entry;
+        Count.store(id + 1, std::memory_order_release);
+        return id;
+    }
+
+    const Entry& Get(u32 id) const {
+        return Pages[id / PageSize].load(std::memory_order_acquire)[id % PageSize];
+    }
+};
+
+StringTable& GetTable() {
+    static StringTable table;
+    return table;
+}
+
+} // anonymous namespace
+
+StringId::StringId(std::string_view text) {
+    if (text.empty()) return;
+
+    StringTable& table = GetTable();
+    std::lock_guard<std::mutex> lock(table.Mutex);
+
+    if (auto it = table.Ids.find(text); it != table.Ids.end()) {
+        m_Id = it->second;
+        return;
+    }
+
+    if (table.Count.load(std::memory_order_relaxed) == MaxCount) {
+        if (!table.Full) LOG_CORE_ERROR("StringId: table full ({} strings), further names are empty", MaxCount);
+        table.Full = true;
+        return;
+    }
+
+    const char* stored = table.Store(text);
+    m_Id = table.Append({stored, static_cast<u32>(text.size())});
+    table.Ids.emplace(std::string_view(stored, text.size()), m_Id);
+}
+
+StringId StringId::Find(std::string_view text) {
+    StringId id;
+    if (text.empty()) return id;
+
+    StringTable& table = GetTable();
+    std::lock_guard<std::mutex> lock(table.Mutex);
+    if (auto it = table.Ids.find(text); it != table.Ids.end()) {
+        id.m_Id = it->second;
+    }
+    return id;
+}
+
+u32 StringId::GetCount() {
+    return GetTable().Count.load(std::memory_order_acquire);
+}
+
+std::string_view StringId::View() const {
+    const Entry& entry = GetTable().Get(m_Id);
+    return std::string_view(entry.Text, entry.Length);
+}
+
+const char* StringId::CStr() const {
+    return GetTable().Get(m_Id).Text;
+}
+
+} // namespace Engine
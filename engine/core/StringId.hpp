@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Types.hpp"
+#include <string_view>
+
+namespace Engine {
+
+// StringId - a string interned in the process-wide string table, held as a
+// 32-bit index into it.
+//
+// Interning costs one hash lookup; after that copies, comparisons and
+// hashes are integer operations, and components that carry names
+// (NameComponent) stay trivially copyable instead of owning a heap string
+// per entity. Ids mean nothing outside the process - serialize the text,
+// never the id. Interned text lives until exit, so intern names, not
+// arbitrary per-frame strings. Interning locks the table; reading an id's
+// text does not.
+class StringId {
+public:
+    static constexpr u32 MaxCount = 1u << 22;
+
+    StringId() = default;   // The empty string
+
+    // Interns text (implicit, so names assign from literals and strings)
+    StringId(std::string_view text);
+    StringId(const char* text) : StringId(std::string_view(text)) {}
+    StringId(const String& text) : StringId(std::string_view(text)) {}
+
+    // The id text was interned under, or the empty id; never interns
+    static StringId Find(std::string_view text);
+    static u32 GetCount();
+
+    std::string_view View() const;
+    const char* CStr() const;       // Null-terminated
+    String ToString() const { return String(View()); }
+
+    bool IsEmpty() const { return m_Id == 0; }
+    u32 GetValue() const { return m_Id; }
+
+    friend bool operator==(StringId a, StringId b) { return a.m_Id == b.m_Id; }
+    friend bool operator!=(StringId a, StringId b) { return a.m_Id != b.m_Id; }
+
+private:
+    u32 m_Id = 0;
+};
+
+} // namespace Engine
+
+template<>
+struct std::hash<Engine::StringId> {
+    std::size_t operator()(Engine::StringId id) const noexcept { return id.GetValue(); }
+};
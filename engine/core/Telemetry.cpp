@@ -0,0 +1,268 @@
+#include "Telemetry.hpp"
+#include "Logger.hpp"
+
+#include <bit>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Engine {
+
+namespace {
+
+// One past the last id: where values of ids that didn't fit go
+constexpr u32 SinkId = TELEMETRY_MAX_VALUES;
+constexpr u32 SlotCount = TELEMETRY_MAX_VALUES + 1;
+
+// Counter slots of one thread. Only the owner writes, so Add is a relaxed
+// load and store rather than a locked read-modify-write; EndFrame reads
+// every block. Blocks outlive their threads so totals never go back.
+struct alignas(64) ThreadCounters {
+    std::atomic<u64> Values[SlotCount] = {};
+    ThreadCounters* Next = nullptr;
+};
+
+std::atomic<ThreadCounters*> s_ThreadCounters{nullptr};
+thread_local ThreadCounters* t_Counters = nullptr;
+
+std::mutex s_RegisterMutex;
+char s_Names[SlotCount][TELEMETRY_NAME_LENGTH] = {};
+TelemetryKind s_Kinds[SlotCount] = {};
+std::atomic<u32> s_ValueCount{0};
+
+std::atomic<u64> s_Gauges[SlotCount] = {};     // f64 bit patterns
+
+// Main thread, written by EndFrame
+f64 s_Published[SlotCount] = {};
+
+// Shared memory export
+TelemetryShared::Header* s_Header = nullptr;
+TelemetryShared::Frame* s_Frames = nullptr;
+usize s_MappedSize = 0;
+#ifdef _WIN32
+HANDLE s_Mapping = nullptr;
+#else
+String s_SharedName;
+#endif
+
+ThreadCounters& AcquireThreadCounters() {
+    auto* counters = new ThreadCounters();
+    counters->Next = s_ThreadCounters.load(std::memory_order_relaxed);
+    while (!s_ThreadCounters.compare_exchange_weak(counters->Next, counters,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed)) {
+    }
+    t_Counters = counters;
+    return *counters;
+}
+
+void CopyName(char* dst, const char* name) {
+    std::strncpy(dst, name, TELEMETRY_NAME_LENGTH - 1);
+    dst[TELEMETRY_NAME_LENGTH - 1] = '\0';
+}
+
+// Caller holds s_RegisterMutex
+void PublishName(u32 id) {
+    if (!s_Header) return;
+    std::memcpy(s_Header->Names[id], s_Names[id], TELEMETRY_NAME_LENGTH);
+    s_Header->Kinds[id] = s_Kinds[id];
+}
+
+} // anonymous namespace
+
+u32 Telemetry::Register(const char* name, TelemetryKind kind) {
+    std::lock_guard<std::mutex> lock(s_RegisterMutex);
+
+    const u32 count = s_ValueCount.load(std::memory_order_relaxed);
+    for (u32 id = 0; id < count; ++id) {
+        if (std::strncmp(s_Names[id], name, TELEMETRY_NAME_LENGTH - 1) == 0) {
+            return id;
+        }
+    }
+
+    if (count == TELEMETRY_MAX_VALUES) {
+        LOG_CORE_WARN("Telemetry: more than {} values, '{}' is not recorded", TELEMETRY_MAX_VALUES, name);
+        return SinkId;
+    }
+
+    CopyName(s_Names[count], name);
+    s_Kinds[count] = kind;
+    PublishName(count);
+    s_ValueCount.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+void Telemetry::AddCounter(u32 id, u64 amount) {
+    ThreadCounters& counters = t_Counters ? *t_Counters : AcquireThreadCounters();
+    auto& slot = counters.Values[id];
+    slot.store(slot.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+void Telemetry::SetGauge(u32 id, f64 value) {
+    s_Gauges[id].store(std::bit_cast<u64>(value), std::memory_order_relaxed);
+}
+
+void Telemetry::EndFrame(u64 frameNumber, f32 frameTimeMs) {
+    const u32 count = s_ValueCount.load(std::memory_order_acquire);
+    ThreadCounters* threads = s_ThreadCounters.load(std::memory_order_acquire);
+
+    for (u32 id = 0; id < count; ++id) {
+        if (s_Kinds[id] == TelemetryKind::Gauge) {
+            s_Published[id] = std::bit_cast<f64>(s_Gauges[id].load(std::memory_order_relaxed));
+            continue;
+        }
+        u64 total = 0;
+        for (ThreadCounters* counters = threads; counters; counters = counters->Next) {
+            total += counters->Values[id].load(std::memory_order_relaxed);
+        }
+        s_Published[id] = static_cast<f64>(total);
+    }
+
+    if (!s_Header) return;
+
+    // Seqlock per slot: odd while the record is being written
+    const u64 written = s_Header->FramesWritten.load(std::memory_order_relaxed);
+    TelemetryShared::Frame& frame = s_Frames[written % TELEMETRY_RING_FRAMES];
+    frame.Sequence.store(written * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    frame.FrameNumber = frameNumber;
+    frame.FrameTimeMs = static_cast<f64>(frameTimeMs);
+    std::memcpy(frame.Values, s_Published, count * sizeof(f64));
+
+    frame.Sequence.store(written * 2 + 2, std::memory_order_release);
+    s_Header->ValueCount.store(count, std::memory_order_release);
+    s_Header->FramesWritten.store(written + 1, std::memory_order_release);
+}
+
+f64 Telemetry::GetValue(u32 id) {
+    return id < SlotCount ? s_Published[id] : 0.0;
+}
+
+u32 Telemetry::GetValueCount() {
+    return s_ValueCount.load(std::memory_order_acquire);
+}
+
+const char* Telemetry::GetName(u32 id) {
+    return id < SlotCount ? s_Names[id] : "";
+}
+
+TelemetryKind Telemetry::GetKind(u32 id) {
+    return id < SlotCount ? s_Kinds[id] : TelemetryKind::Counter;
+}
+
+bool Telemetry::Export(const String& name) {
+    StopExport();
+
+    const usize size = sizeof(TelemetryShared::Header) +
+                       sizeof(TelemetryShared::Frame) * TELEMETRY_RING_FRAMES;
+    void* memory = nullptr;
+
+#ifdef _WIN32
+    const String objectName = "Local\\" + name;
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(static_cast<u64>(size) >> 32),
+                                        static_cast<DWORD>(size & 0xFFFFFFFFu), objectName.c_str());
+    if (!mapping) {
+        LOG_CORE_ERROR("Telemetry: Failed to create shared memory {}", objectName);
+        return false;
+    }
+    memory = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!memory) {
+        LOG_CORE_ERROR("Telemetry: Failed to map shared memory {}", objectName);
+        CloseHandle(mapping);
+        return false;
+    }
+    s_Mapping = mapping;
+#else
+    const String objectName = "/" + name;
+    const int fd = shm_open(objectName.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        LOG_CORE_ERROR("Telemetry: Failed to create shared memory {}", objectName);
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        LOG_CORE_ERROR("Telemetry: Failed to size shared memory {}", objectName);
+        close(fd);
+        shm_unlink(objectName.c_str());
+        return false;
+    }
+    memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        LOG_CORE_ERROR("Telemetry: Failed to map shared memory {}", objectName);
+        shm_unlink(objectName.c_str());
+        return false;
+    }
+    s_SharedName = objectName;
+#endif
+
+    std::memset(memory, 0, size);
+    auto* header = new (memory) TelemetryShared::Header();
+    header->MaxValues = TELEMETRY_MAX_VALUES;
+    header->RingFrames = TELEMETRY_RING_FRAMES;
+    header->FrameSize = static_cast<u32>(sizeof(TelemetryShared::Frame));
+
+    auto* frames = reinterpret_cast<TelemetryShared::Frame*>(header + 1);
+    for (u32 i = 0; i < TELEMETRY_RING_FRAMES; ++i) {
+        new (&frames[i]) TelemetryShared::Frame();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_RegisterMutex);
+        s_Header = header;
+        s_Frames = frames;
+        s_MappedSize = size;
+        const u32 count = s_ValueCount.load(std::memory_order_relaxed);
+        for (u32 id = 0; id < count; ++id) {
+            PublishName(id);
+        }
+    }
+
+    // Magic last: a reader seeing it sees an initialized header
+    header->Version = TelemetryShared::Version;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->Magic = TelemetryShared::Magic;
+
+    LOG_CORE_INFO("Telemetry exported to shared memory {} ({} KB)", objectName, size / 1024);
+    return true;
+}
+
+void Telemetry::StopExport() {
+    std::lock_guard<std::mutex> lock(s_RegisterMutex);
+    if (!s_Header) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(s_Header);
+    CloseHandle(s_Mapping);
+    s_Mapping = nullptr;
+#else
+    munmap(s_Header, s_MappedSize);
+    shm_unlink(s_SharedName.c_str());
+    s_SharedName.clear();
+#endif
+    s_Header = nullptr;
+    s_Frames = nullptr;
+    s_MappedSize = 0;
+}
+
+bool Telemetry::IsExporting() {
+    return s_Header != nullptr;
+}
+
+} // namespace Engine
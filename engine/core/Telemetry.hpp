@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Types.hpp"
+#include <atomic>
+
+namespace Engine {
+
+// Telemetry - process-wide counters and gauges, published once a frame.
+//
+// A counter accumulates (draws issued, jobs run); Add() goes to a slot owned
+// by the calling thread with a relaxed atomic, so threads never contend and
+// the totals are summed at publish. A gauge holds the latest value set from
+// any thread (entities rendered, queue depth). Register an id once and keep
+// it, typically in a static:
+//
+//   static const TelemetryCounter s_Draws("Renderer.DrawCalls");
+//   s_Draws.Add(batchCount);
+//
+// Registering a name twice returns the same id. Ids are never released.
+//
+// Telemetry::EndFrame(), called by the Application once a frame, snapshots
+// every value. Export() additionally writes each snapshot into a ring in
+// named shared memory (TelemetryShared below) that a monitoring process can
+// map read-only and sample at its own rate. Nothing in the frame path
+// allocates or takes a lock.
+enum class TelemetryKind : u8 {
+    Counter,
+    Gauge
+};
+
+constexpr u32 TELEMETRY_MAX_VALUES = 256;
+constexpr u32 TELEMETRY_NAME_LENGTH = 48;      // Including the terminator
+constexpr u32 TELEMETRY_RING_FRAMES = 128;
+
+// Shared memory layout, version 1. The region starts with a Header,
+// followed by TELEMETRY_RING_FRAMES Frames.
+//
+// Reader: load FramesWritten (acquire); if n > 0 the newest record is in
+// slot (n - 1) % RingFrames. Load its Sequence, copy the frame, load
+// Sequence again: the copy is consistent if both loads are the same even
+// value. An odd Sequence is a write in progress. Names and kinds of ids
+// below ValueCount are stable once ValueCount covers them.
+namespace TelemetryShared {
+
+constexpr u32 Magic = 0x4D4C5445;   // "ETLM"
+constexpr u32 Version = 1;
+
+struct Header {
+    u32 Magic;
+    u32 Version;
+    u32 MaxValues;
+    u32 RingFrames;
+    u32 FrameSize;                  // Bytes per Frame
+    std::atomic<u32> ValueCount;
+    std::atomic<u64> FramesWritten;
+    char Names[TELEMETRY_MAX_VALUES][TELEMETRY_NAME_LENGTH];
+    TelemetryKind Kinds[TELEMETRY_MAX_VALUES];
+};
+
+struct Frame {
+    std::atomic<u64> Sequence;
+    u64 FrameNumber;
+    f64 FrameTimeMs;
+    f64 Values[TELEMETRY_MAX_VALUES];   // Counters: totals since startup
+};
+
+} // namespace TelemetryShared
+
+class Telemetry {
+public:
+    // Id of name, registering it on first use. Past TELEMETRY_MAX_VALUES
+    // the returned id discards its values.
+    static u32 Register(const char* name, TelemetryKind kind);
+
+    static void AddCounter(u32 id, u64 amount);
+    static void SetGauge(u32 id, f64 value);
+
+    // Snapshot every value for the frame that just ended; main thread
+    static void EndFrame(u64 frameNumber, f32 frameTimeMs);
+
+    // Values as of the last EndFrame()
+    static f64 GetValue(u32 id);
+    static u32 GetValueCount();
+    static const char* GetName(u32 id);
+    static TelemetryKind GetKind(u32 id);
+
+    // Publish every EndFrame() into the shared memory object name ("/name"
+    // on POSIX, "Local\name" on Windows). False if it can't be created.
+    static bool Export(const String& name);
+    static void StopExport();
+    static bool IsExporting();
+};
+
+class TelemetryCounter {
+public:
+    explicit TelemetryCounter(const char* name)
+        : m_Id(Telemetry::Register(name, TelemetryKind::Counter)) {}
+
+    void Add(u64 amount = 1) const { Telemetry::AddCounter(m_Id, amount); }
+    u32 GetId() const { return m_Id; }
+
+private:
+    u32 m_Id;
+};
+
+class TelemetryGauge {
+public:
+    explicit TelemetryGauge(const char* name)
+        : m_Id(Telemetry::Register(name, TelemetryKind::Gauge)) {}
+
+    void Set(f64 value) const { Telemetry::SetGauge(m_Id, value); }
+    u32 GetId() const { return m_Id; }
+
+private:
+    u32 m_Id;
+};
+
+} // namespace Engine
@@ -1,11 +1,18 @@
 #include "Time.hpp"
 #include <GLFW/glfw3.h>
+#include <cmath>
 
 namespace Engine {
 
 f32 Time::s_DeltaTime = 0.0f;
+f32 Time::s_FrameTime = 0.0f;
+f32 Time::s_FixedDeltaTime = 0.0f;
 f32 Time::s_LastFrameTime = 0.0f;
 f32 Time::s_TimeScale = 1.0f;
+f32 Time::s_SimulationStep = 1.0f / 60.0f;
+u32 Time::s_MaxSimulationSteps = 4;
+f32 Time::s_SimulationAccumulator = 0.0f;
+f32 Time::s_SimulationAlpha = 1.0f;
 
 void Time::Init() {
     s_LastFrameTime = static_cast<f32>(glfwGetTime());
@@ -13,10 +20,36 @@ void Time::Init() {
 
 void Time::Update() {
     f32 currentTime = static_cast<f32>(glfwGetTime());
-    s_DeltaTime = currentTime - s_LastFrameTime;
+    s_FrameTime = currentTime - s_LastFrameTime;
+    s_DeltaTime = s_FixedDeltaTime > 0.0f ? s_FixedDeltaTime : s_FrameTime;
     s_LastFrameTime = currentTime;
 }
 
+u32 Time::AccumulateSimulation(f32 deltaTime) {
+    if (s_SimulationStep <= 0.0f) {
+        s_SimulationAccumulator = 0.0f;
+        s_SimulationAlpha = 1.0f;
+        return 1;
+    }
+
+    s_SimulationAccumulator += deltaTime;
+
+    u32 steps = 0;
+    while (s_SimulationAccumulator >= s_SimulationStep && steps < s_MaxSimulationSteps) {
+        s_SimulationAccumulator -= s_SimulationStep;
+        steps++;
+    }
+
+    // Behind by more than the step budget (a hitch, a breakpoint): drop the
+    // backlog so later frames don't all run at the limit trying to catch up
+    if (s_SimulationAccumulator >= s_SimulationStep) {
+        s_SimulationAccumulator = std::fmod(s_SimulationAccumulator, s_SimulationStep);
+    }
+
+    s_SimulationAlpha = s_SimulationAccumulator / s_SimulationStep;
+    return steps;
+}
+
 f32 Time::GetTime() {
     return static_cast<f32>(glfwGetTime());
 }
@@ -13,7 +13,39 @@ public:
     static f32 GetDeltaTime() { return s_DeltaTime; }
     static f32 GetUnscaledDeltaTime() { return s_DeltaTime; }
     static f32 GetScaledDeltaTime() { return s_DeltaTime * s_TimeScale; }
-    static f32 GetFPS() { return 1.0f / s_DeltaTime; }
+    static f32 GetFPS() { return 1.0f / s_FrameTime; }
+
+    // Measured time between the last two frames, even with a fixed step
+    static f32 GetFrameTime() { return s_FrameTime; }
+
+    // Step the simulation by a fixed delta instead of the measured one
+    // (0 = measured), for reproducible runs such as benchmarks
+    static void SetFixedDeltaTime(f32 deltaTime) { s_FixedDeltaTime = deltaTime; }
+    static f32 GetFixedDeltaTime() { return s_FixedDeltaTime; }
+
+    // Fixed step the physics phases advance by (0 = once per frame with the
+    // frame's delta). Application runs them as many times as the accumulated
+    // frame time allows, at most GetMaxSimulationSteps() times per frame;
+    // time beyond that is dropped rather than carried into later frames.
+    static void SetSimulationStep(f32 step) { s_SimulationStep = step; }
+    static f32 GetSimulationStep() { return s_SimulationStep; }
+    static void SetMaxSimulationSteps(u32 steps) { s_MaxSimulationSteps = steps > 0 ? steps : 1; }
+    static u32 GetMaxSimulationSteps() { return s_MaxSimulationSteps; }
+
+    // Where this frame falls between the last two simulated states, [0, 1)
+    // (1 without a fixed step)
+    static f32 GetSimulationAlpha() { return s_SimulationAlpha; }
+
+    // Adds deltaTime to the accumulator and returns how many steps to run now
+    static u32 AccumulateSimulation(f32 deltaTime);
+
+    // Time carried towards the next simulation step; restored by replays
+    static f32 GetSimulationAccumulator() { return s_SimulationAccumulator; }
+    static void SetSimulationAccumulator(f32 accumulator) { s_SimulationAccumulator = accumulator; }
+
+    // Replace this frame's delta after Update(), e.g. with a recorded one.
+    // The measured frame time is kept.
+    static void OverrideDeltaTime(f32 deltaTime) { s_DeltaTime = deltaTime; }
 
     static void SetTimeScale(f32 scale) { s_TimeScale = scale; }
     static f32 GetTimeScale() { return s_TimeScale; }
@@ -21,8 +53,14 @@ public:
 
 private:
     static f32 s_DeltaTime;
+    static f32 s_FrameTime;
+    static f32 s_FixedDeltaTime;
     static f32 s_LastFrameTime;
     static f32 s_TimeScale;
+    static f32 s_SimulationStep;
+    static u32 s_MaxSimulationSteps;
+    static f32 s_SimulationAccumulator;
+    static f32 s_SimulationAlpha;
 };
 
 } // namespace Engine
@@ -4,8 +4,8 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <functional>
+#include "FlatHashMap.hpp"
 
 namespace Engine {
 
@@ -51,8 +51,9 @@ using WeakRef = std::weak_ptr<T>;
 template<typename T>
 using Vector = std::vector<T>;
 
+// Open addressing (core/FlatHashMap.hpp): an insertion may move every element
 template<typename K, typename V>
-using HashMap = std::unordered_map<K, V>;
+using HashMap = FlatHashMap<K, V>;
 
 using String = std::string;
 
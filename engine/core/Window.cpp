@@ -1,8 +1,10 @@
 #include "Window.hpp"
 #include "Logger.hpp"
+#include "Input.hpp"
 #include "events/WindowEvents.hpp"
 #include "events/KeyEvents.hpp"
 #include "events/MouseEvents.hpp"
+#include "events/EventQueue.hpp"
 
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
@@ -15,6 +17,15 @@ static void GLFWErrorCallback(int error, const char* description) {
     LOG_CORE_ERROR("GLFW Error ({0}): {1}", error, description);
 }
 
+// Delivered when the application drains the queue at the start of the next
+// frame; a full queue drops the event (EventQueue warns)
+template<typename T, typename... Args>
+static void PostEvent(EventQueue* queue, Args&&... args) {
+    if (queue) {
+        queue->Post<T>(std::forward<Args>(args)...);
+    }
+}
+
 Window::Window(const WindowProps& props) {
     Init(props);
 }
@@ -27,7 +38,6 @@ void Window::Init(const WindowProps& props) {
     m_Data.Title = props.Title;
     m_Data.Width = props.Width;
     m_Data.Height = props.Height;
-    m_Data.VSync = props.VSync;
 
     LOG_CORE_INFO("Creating window {0} ({1}, {2})", props.Title, props.Width, props.Height);
 
@@ -74,6 +84,9 @@ void Window::Init(const WindowProps& props) {
     LOG_CORE_INFO("  Version: {0}", reinterpret_cast<const char*>(glGetString(GL_VERSION)));
 
     glfwSetWindowUserPointer(m_Window, &m_Data);
+
+    m_AdaptiveVSyncSupported = glfwExtensionSupported("WGL_EXT_swap_control_tear") ||
+                               glfwExtensionSupported("GLX_EXT_swap_control_tear");
     SetVSync(props.VSync);
 
     // Set GLFW callbacks
@@ -82,18 +95,12 @@ void Window::Init(const WindowProps& props) {
         data.Width = width;
         data.Height = height;
 
-        WindowResizeEvent event(width, height);
-        if (data.EventCallback) {
-            data.EventCallback(event);
-        }
+        PostEvent<WindowResizeEvent>(data.Events, width, height);
     });
 
     glfwSetWindowCloseCallback(m_Window, [](GLFWwindow* window) {
         WindowData& data = *static_cast<WindowData*>(glfwGetWindowUserPointer(window));
-        WindowCloseEvent event;
-        if (data.EventCallback) {
-            data.EventCallback(event);
-        }
+        PostEvent<WindowCloseEvent>(data.Events);
     });
 
     glfwSetKeyCallback(m_Window, [](GLFWwindow* window, int key, int /*scancode*/, int action, int /*mods*/) {
@@ -101,18 +108,17 @@ void Window::Init(const WindowProps& props) {
 
         switch (action) {
             case GLFW_PRESS: {
-                KeyPressedEvent event(key, false);
-                if (data.EventCallback) data.EventCallback(event);
+                Input::RecordKey(key, true);
+                PostEvent<KeyPressedEvent>(data.Events, key, false);
                 break;
             }
             case GLFW_RELEASE: {
-                KeyReleasedEvent event(key);
-                if (data.EventCallback) data.EventCallback(event);
+                Input::RecordKey(key, false);
+                PostEvent<KeyReleasedEvent>(data.Events, key);
                 break;
             }
             case GLFW_REPEAT: {
-                KeyPressedEvent event(key, true);
-                if (data.EventCallback) data.EventCallback(event);
+                PostEvent<KeyPressedEvent>(data.Events, key, true);
                 break;
             }
         }
@@ -120,8 +126,7 @@ void Window::Init(const WindowProps& props) {
 
     glfwSetCharCallback(m_Window, [](GLFWwindow* window, unsigned int keycode) {
         WindowData& data = *static_cast<WindowData*>(glfwGetWindowUserPointer(window));
-        KeyTypedEvent event(static_cast<i32>(keycode));
-        if (data.EventCallback) data.EventCallback(event);
+        PostEvent<KeyTypedEvent>(data.Events, static_cast<i32>(keycode));
     });
 
     glfwSetMouseButtonCallback(m_Window, [](GLFWwindow* window, int button, int action, int /*mods*/) {
@@ -129,13 +134,13 @@ void Window::Init(const WindowProps& props) {
 
         switch (action) {
             case GLFW_PRESS: {
-                MouseButtonPressedEvent event(button);
-                if (data.EventCallback) data.EventCallback(event);
+                Input::RecordMouseButton(button, true);
+                PostEvent<MouseButtonPressedEvent>(data.Events, button);
                 break;
             }
             case GLFW_RELEASE: {
-                MouseButtonReleasedEvent event(button);
-                if (data.EventCallback) data.EventCallback(event);
+                Input::RecordMouseButton(button, false);
+                PostEvent<MouseButtonReleasedEvent>(data.Events, button);
                 break;
             }
         }
@@ -143,14 +148,14 @@ void Window::Init(const WindowProps& props) {
 
     glfwSetScrollCallback(m_Window, [](GLFWwindow* window, double xOffset, double yOffset) {
         WindowData& data = *static_cast<WindowData*>(glfwGetWindowUserPointer(window));
-        MouseScrolledEvent event(static_cast<f32>(xOffset), static_cast<f32>(yOffset));
-        if (data.EventCallback) data.EventCallback(event);
+        Input::RecordScroll(static_cast<f32>(xOffset), static_cast<f32>(yOffset));
+        PostEvent<MouseScrolledEvent>(data.Events, static_cast<f32>(xOffset), static_cast<f32>(yOffset));
     });
 
     glfwSetCursorPosCallback(m_Window, [](GLFWwindow* window, double xPos, double yPos) {
         WindowData& data = *static_cast<WindowData*>(glfwGetWindowUserPointer(window));
-        MouseMovedEvent event(static_cast<f32>(xPos), static_cast<f32>(yPos));
-        if (data.EventCallback) data.EventCallback(event);
+        Input::RecordCursorPosition(static_cast<f32>(xPos), static_cast<f32>(yPos));
+        PostEvent<MouseMovedEvent>(data.Events, static_cast<f32>(xPos), static_cast<f32>(yPos));
     });
 }
 
@@ -162,13 +167,34 @@ void Window::Shutdown() {
 }
 
 void Window::OnUpdate() {
-    glfwPollEvents();
+    PollEvents();
+    SwapBuffers();
+}
+
+void Window::PollEvents() {
+    Input::Poll();
+}
+
+void Window::WaitEvents(f64 timeout) {
+    Input::Wait(timeout);
+}
+
+void Window::SwapBuffers() {
     glfwSwapBuffers(m_Window);
 }
 
-void Window::SetVSync(bool enabled) {
-    glfwSwapInterval(enabled ? 1 : 0);
-    m_Data.VSync = enabled;
+void Window::SetVSyncMode(VSyncMode mode) {
+    if (mode == VSyncMode::Adaptive && !m_AdaptiveVSyncSupported) {
+        LOG_CORE_WARN("Adaptive vsync not supported by the driver, using vsync");
+        mode = VSyncMode::On;
+    }
+
+    switch (mode) {
+        case VSyncMode::Off:      glfwSwapInterval(0); break;
+        case VSyncMode::On:       glfwSwapInterval(1); break;
+        case VSyncMode::Adaptive: glfwSwapInterval(-1); break;
+    }
+    m_Data.VSync = mode;
 }
 
 bool Window::ShouldClose() const {
@@ -177,8 +203,7 @@ bool Window::ShouldClose() const {
 
 void Window::SetCursorEnabled(bool enabled) {
     m_CursorEnabled = enabled;
-    glfwSetInputMode(m_Window, GLFW_CURSOR,
-                     enabled ? GLFW_CURSOR_NORMAL : GLFW_CURSOR_DISABLED);
+    Input::SetCursorMode(enabled);
 }
 
 Scope<Window> Window::Create(const WindowProps& props) {
@@ -7,6 +7,17 @@ struct GLFWwindow;
 
 namespace Engine {
 
+class EventQueue;
+
+// Adaptive syncs when the frame is on time and tears instead of waiting a
+// whole extra refresh when it is late (swap interval -1). Falls back to On
+// where the driver lacks EXT_swap_control_tear.
+enum class VSyncMode : u8 {
+    Off,
+    On,
+    Adaptive
+};
+
 struct WindowProps {
     String Title;
     u32 Width;
@@ -25,15 +36,30 @@ public:
     Window(const WindowProps& props = WindowProps());
     ~Window();
 
+    // Poll events, then present
     void OnUpdate();
 
+    // The two halves of OnUpdate, for when the GL context lives on another
+    // thread: events are polled on the main thread, the swap happens on the
+    // thread that owns the context
+    void PollEvents();
+    void SwapBuffers();
+
+    // PollEvents that sleeps until an event arrives or timeout seconds pass
+    void WaitEvents(f64 timeout);
+
     u32 GetWidth() const { return m_Data.Width; }
     u32 GetHeight() const { return m_Data.Height; }
     f32 GetAspectRatio() const { return static_cast<f32>(m_Data.Width) / static_cast<f32>(m_Data.Height); }
 
-    void SetEventCallback(const EventCallbackFn& callback) { m_Data.EventCallback = callback; }
-    void SetVSync(bool enabled);
-    bool IsVSync() const { return m_Data.VSync; }
+    // Window and input events are posted here from the GLFW callbacks
+    void SetEventQueue(EventQueue* queue) { m_Data.Events = queue; }
+    // Need the GL context; not while a RenderThread owns it
+    void SetVSync(bool enabled) { SetVSyncMode(enabled ? VSyncMode::On : VSyncMode::Off); }
+    void SetVSyncMode(VSyncMode mode);
+    bool IsVSync() const { return m_Data.VSync != VSyncMode::Off; }
+    VSyncMode GetVSyncMode() const { return m_Data.VSync; }
+    bool IsAdaptiveVSyncSupported() const { return m_AdaptiveVSyncSupported; }
 
     GLFWwindow* GetNativeWindow() const { return m_Window; }
 
@@ -56,12 +82,13 @@ private:
         String Title;
         u32 Width = 0;
         u32 Height = 0;
-        bool VSync = false;
-        EventCallbackFn EventCallback;
+        VSyncMode VSync = VSyncMode::Off;
+        EventQueue* Events = nullptr;
     };
 
     WindowData m_Data;
     bool m_CursorEnabled = true;
+    bool m_AdaptiveVSyncSupported = false;
 };
 
 } // namespace Engine
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include "core/Types.hpp"
+#include <mutex>
+
+namespace Engine {
+
+// ChangeSet - entities whose component T was added, patched or removed.
+//
+// Fed by the registry's on_construct / on_update / on_destroy signals of one
+// component type, so it sees what goes through emplace, replace, patch and
+// remove; writes through a plain reference are invisible to it.
+// TransformSystem patches the Transform (or WorldTransform) of every entity
+// whose world matrix it recomputed, so Transform changes include movement.
+//
+// Signals may fire on any thread: marks go into a pending list under a lock.
+// Rotate() makes the pending list current and starts a new one; the owner
+// reads the current lists between rotations. Both lists are deduplicated;
+// an entity can be in both (added, then removed) and may be gone by the
+// time it is read.
+class ChangeSet {
+public:
+    // Added or patched
+    const Vector<entt::entity>& GetChanged() const { return m_Changed; }
+    const Vector<entt::entity>& GetRemoved() const { return m_Removed; }
+    bool IsEmpty() const { return m_Changed.empty() && m_Removed.empty(); }
+
+    void Rotate() {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Changed.swap(m_PendingChanged);
+        m_Removed.swap(m_PendingRemoved);
+        m_PendingChanged.clear();
+        m_PendingRemoved.clear();
+        ++m_Epoch;
+    }
+
+    template<typename T>
+    void Connect(entt::registry& registry) {
+        registry.on_construct<T>().template connect<&ChangeSet::OnChanged>(*this);
+        registry.on_update<T>().template connect<&ChangeSet::OnChanged>(*this);
+        registry.on_destroy<T>().template connect<&ChangeSet::OnRemoved>(*this);
+    }
+
+    template<typename T>
+    void Disconnect(entt::registry& registry) {
+        registry.on_construct<T>().disconnect(this);
+        registry.on_update<T>().disconnect(this);
+        registry.on_destroy<T>().disconnect(this);
+    }
+
+private:
+    void OnChanged(entt::registry& registry, entt::entity entity) {
+        (void)registry;
+        Mark(entity, false);
+    }
+
+    void OnRemoved(entt::registry& registry, entt::entity entity) {
+        (void)registry;
+        Mark(entity, true);
+    }
+
+    // An entity is listed once per epoch and list; the entity is kept with
+    // the epoch so a recycled slot still gets listed
+    struct SlotMark {
+        entt::entity Entity = entt::null;
+        u32 Epoch = 0;
+    };
+
+    void Mark(entt::entity entity, bool removed) {
+        const usize slot = static_cast<usize>(entt::to_entity(entity));
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto& marks = removed ? m_RemovedMarks : m_ChangedMarks;
+        if (slot >= marks.size()) {
+            marks.resize(slot + 1);
+        }
+        if (marks[slot].Epoch == m_Epoch && marks[slot].Entity == entity) return;
+        marks[slot] = {entity, m_Epoch};
+        (removed ? m_PendingRemoved : m_PendingChanged).push_back(entity);
+    }
+
+private:
+    std::mutex m_Mutex;
+    Vector<entt::entity> m_Changed;
+    Vector<entt::entity> m_Removed;
+    Vector<entt::entity> m_PendingChanged;
+    Vector<entt::entity> m_PendingRemoved;
+    Vector<SlotMark> m_ChangedMarks;    // Per entity slot (entt::to_entity)
+    Vector<SlotMark> m_RemovedMarks;
+    u32 m_Epoch = 1;
+};
+
+// ReactiveAccess - the components a system tracks changes of, declared with
+// SYSTEM_REACTS_TO. ISystem connects one ChangeSet per component in
+// Create() and rotates them at the start of every Update().
+class ReactiveAccess {
+public:
+    template<typename... Components>
+    ReactiveAccess& Track() {
+        (Add<Components>(), ...);
+        return *this;
+    }
+
+    bool IsEmpty() const { return m_Entries.empty(); }
+
+    void Connect(entt::registry& registry) {
+        for (auto& entry : m_Entries) entry.Connect(registry, *entry.Set);
+    }
+
+    void Disconnect(entt::registry& registry) {
+        for (auto& entry : m_Entries) entry.Disconnect(registry, *entry.Set);
+    }
+
+    void Rotate() {
+        for (auto& entry : m_Entries) entry.Set->Rotate();
+    }
+
+    template<typename T>
+    const ChangeSet* Find() const {
+        const entt::id_type id = entt::type_hash<T>::value();
+        for (const auto& entry : m_Entries) {
+            if (entry.TypeId == id) return entry.Set.get();
+        }
+        return nullptr;
+    }
+
+private:
+    struct Entry {
+        entt::id_type TypeId;
+        Scope<ChangeSet> Set;   // Signals hold its address
+        void (*Connect)(entt::registry&, ChangeSet&);
+        void (*Disconnect)(entt::registry&, ChangeSet&);
+    };
+
+    template<typename T>
+    void Add() {
+        if (Find<T>()) return;
+        m_Entries.push_back({
+            entt::type_hash<T>::value(),
+            CreateScope<ChangeSet>(),
+            [](entt::registry& registry, ChangeSet& set) { set.Connect<T>(registry); },
+            [](entt::registry& registry, ChangeSet& set) { set.Disconnect<T>(registry); }
+        });
+    }
+
+private:
+    Vector<Entry> m_Entries;
+};
+
+} // namespace Engine
@@ -2,8 +2,9 @@
 
 #include <entt/entt.hpp>
 #include "core/Types.hpp"
-#include <functional>
+#include <algorithm>
 #include <typeindex>
+#include <type_traits>
 #include <cstring>
 
 namespace Engine {
@@ -19,19 +20,118 @@ struct ComponentMeta {
     static void Register(entt::meta_ctx& ctx) { (void)ctx; }
 };
 
-// Component factory for runtime component creation
+// Dense index of a registered component type, stable for the process. Resolve
+// it once (ComponentRegistry::FindId) and use it for runtime operations
+// instead of the name.
+using ComponentId = u32;
+constexpr ComponentId InvalidComponentId = ~0u;
+
+// Component factory for runtime component creation. Plain function pointers,
+// so calling one costs an indirect call and nothing else.
 struct ComponentFactory {
     const char* Name = nullptr;
     bool IsTag = false;
-    std::function<void*(entt::registry&, entt::entity)> Create;
-    std::function<void(entt::registry&, entt::entity)> Remove;
-    std::function<bool(const entt::registry&, entt::entity)> Has;
-    std::function<void*(entt::registry&, entt::entity)> Get;
-    std::function<void(entt::meta_ctx&)> RegisterMeta;
+    ComponentId Id = InvalidComponentId;
+    void* (*Create)(entt::registry&, entt::entity) = nullptr;
+    void (*Remove)(entt::registry&, entt::entity) = nullptr;
+    bool (*Has)(const entt::registry&, entt::entity) = nullptr;
+    void* (*Get)(entt::registry&, entt::entity) = nullptr;
+    void (*Patch)(entt::registry&, entt::entity) = nullptr;    // Fire on_update after an in-place write; no-op for tags
+    void (*RegisterMeta)(entt::meta_ctx&) = nullptr;
     std::type_index TypeIndex = typeid(void);
+
+    // Hash of Name, stable across builds (unlike the registry key)
+    u32 NameHash = 0;
+
+    // Whole-pool access for serialization. Storage lists the pool's entities
+    // in packed order; SavePool appends its components in that order as raw
+    // bytes, Size each (0 for tags), and LoadPool adds count entities with
+    // components read from such bytes. Only tags and trivially copyable
+    // components have SavePool / LoadPool.
+    u32 Size = 0;
+    entt::sparse_set& (*Storage)(entt::registry&) = nullptr;
+    void (*SavePool)(entt::registry&, Vector<u8>&) = nullptr;
+    void (*LoadPool)(entt::registry&, const entt::entity*, usize, const void*) = nullptr;
 };
 
-// Global component registry - singleton
+// Type-erased operations ComponentRegistry points its factories at
+template<typename T>
+struct ComponentOps {
+    static void* Create(entt::registry& reg, entt::entity e) {
+        if constexpr (ComponentMeta<T>::IsTag) {
+            reg.emplace<T>(e);
+            return nullptr;
+        } else {
+            return &reg.emplace<T>(e);
+        }
+    }
+
+    static void Remove(entt::registry& reg, entt::entity e) {
+        reg.remove<T>(e);
+    }
+
+    static bool Has(const entt::registry& reg, entt::entity e) {
+        const auto* storage = reg.storage<T>();
+        return storage && storage->contains(e);
+    }
+
+    static void* Get(entt::registry& reg, entt::entity e) {
+        if constexpr (ComponentMeta<T>::IsTag) {
+            return nullptr;
+        } else {
+            return reg.try_get<T>(e);
+        }
+    }
+
+    static void Patch(entt::registry& reg, entt::entity e) {
+        if constexpr (!ComponentMeta<T>::IsTag) {
+            if (!reg.on_update<T>().empty()) reg.patch<T>(e);
+        }
+    }
+
+    static entt::sparse_set& Storage(entt::registry& reg) {
+        return reg.storage<T>();
+    }
+
+    static void SaveTags(entt::registry&, Vector<u8>&) {}
+
+    static void LoadTags(entt::registry& reg, const entt::entity* entities, usize count, const void*) {
+        reg.storage<T>().insert(entities, entities + count);
+    }
+
+    // Components sit in fixed-size pages; copy them a page at a time
+    static constexpr usize PageSize = entt::component_traits<T>::page_size;
+
+    static void SavePool(entt::registry& reg, Vector<u8>& out) {
+        auto& storage = reg.storage<T>();
+        const usize offset = out.size();
+        out.resize(offset + storage.size() * sizeof(T));
+        for (usize first = 0; first < storage.size(); first += PageSize) {
+            const usize count = std::min(PageSize, storage.size() - first);
+            std::memcpy(out.data() + offset + first * sizeof(T), storage.raw()[first / PageSize],
+                        count * sizeof(T));
+        }
+    }
+
+    static void LoadPool(entt::registry& reg, const entt::entity* entities, usize count, const void* data) {
+        auto& storage = reg.storage<T>();
+        const usize base = storage.size();
+        storage.insert(entities, entities + count);
+        const u8* bytes = static_cast<const u8*>(data);
+        for (usize i = 0; i < count;) {
+            const usize slot = base + i;
+            const usize run = std::min(PageSize - slot % PageSize, count - i);
+            std::memcpy(&storage.raw()[slot / PageSize][slot % PageSize], bytes + i * sizeof(T),
+                        run * sizeof(T));
+            i += run;
+        }
+    }
+};
+
+// Global component registry - singleton.
+// Factories live in a dense array indexed by ComponentId; entt::type_hash
+// and name hashes map to an id through one hash lookup. Components register
+// during static initialization, so factory pointers stay valid afterwards.
 class ComponentRegistry {
 public:
     static ComponentRegistry& Get() {
@@ -41,71 +141,81 @@ public:
 
     template<typename T>
     void Register() {
-        auto typeId = entt::type_hash<T>::value();
-
-        if (m_Factories.find(typeId) != m_Factories.end()) {
+        const u32 typeHash = entt::type_hash<T>::value();
+        if (m_ByTypeHash.find(typeHash) != m_ByTypeHash.end()) {
             return; // Already registered
         }
 
+        using Ops = ComponentOps<T>;
+
         ComponentFactory factory;
         factory.Name = ComponentMeta<T>::Name;
         factory.IsTag = ComponentMeta<T>::IsTag;
+        factory.Id = static_cast<ComponentId>(m_Factories.size());
         factory.TypeIndex = std::type_index(typeid(T));
+        factory.Create = &Ops::Create;
+        factory.Remove = &Ops::Remove;
+        factory.Has = &Ops::Has;
+        factory.Get = &Ops::Get;
+        factory.Patch = &Ops::Patch;
+        factory.RegisterMeta = &ComponentMeta<T>::Register;
+        factory.NameHash = entt::hashed_string::value(ComponentMeta<T>::Name);
+        factory.Storage = &Ops::Storage;
 
-        factory.Create = [](entt::registry& reg, entt::entity e) -> void* {
-            if constexpr (ComponentMeta<T>::IsTag) {
-                reg.emplace<T>(e);
-                return nullptr;
-            } else {
-                return &reg.emplace<T>(e);
-            }
-        };
-
-        factory.Remove = [](entt::registry& reg, entt::entity e) {
-            reg.remove<T>(e);
-        };
-
-        factory.Has = [](const entt::registry& reg, entt::entity e) -> bool {
-            return reg.all_of<T>(e);
-        };
-
-        factory.Get = [](entt::registry& reg, entt::entity e) -> void* {
-            if constexpr (ComponentMeta<T>::IsTag) {
-                return nullptr;
-            } else {
-                if (reg.all_of<T>(e)) {
-                    return &reg.get<T>(e);
-                }
-                return nullptr;
-            }
-        };
+        if constexpr (ComponentMeta<T>::IsTag) {
+            factory.SavePool = &Ops::SaveTags;
+            factory.LoadPool = &Ops::LoadTags;
+        } else if constexpr (std::is_trivially_copyable_v<T>) {
+            factory.Size = sizeof(T);
+            factory.SavePool = &Ops::SavePool;
+            factory.LoadPool = &Ops::LoadPool;
+        }
 
-        factory.RegisterMeta = ComponentMeta<T>::Register;
+        m_ByTypeHash[typeHash] = factory.Id;
+        m_ByNameHash[factory.NameHash] = factory.Id;
+        m_Factories.push_back(factory);
+    }
 
-        m_Factories[typeId] = factory;
+    // Id of a component by its reflected name ("Engine::Transform")
+    ComponentId FindId(const char* name) const {
+        return FindIdByNameHash(entt::hashed_string::value(name));
+    }
+
+    ComponentId FindIdByNameHash(u32 nameHash) const {
+        auto it = m_ByNameHash.find(nameHash);
+        return it != m_ByNameHash.end() ? it->second : InvalidComponentId;
+    }
+
+    template<typename T>
+    ComponentId FindId() const {
+        auto it = m_ByTypeHash.find(entt::type_hash<T>::value());
+        return it != m_ByTypeHash.end() ? it->second : InvalidComponentId;
+    }
+
+    const ComponentFactory* GetFactoryById(ComponentId id) const {
+        return id < m_Factories.size() ? &m_Factories[id] : nullptr;
     }
 
     const ComponentFactory* GetFactory(u32 typeId) const {
-        auto it = m_Factories.find(typeId);
-        return it != m_Factories.end() ? &it->second : nullptr;
+        auto it = m_ByTypeHash.find(typeId);
+        return it != m_ByTypeHash.end() ? &m_Factories[it->second] : nullptr;
     }
 
     const ComponentFactory* GetFactoryByName(const char* name) const {
-        for (const auto& [id, factory] : m_Factories) {
-            if (std::strcmp(factory.Name, name) == 0) {
-                return &factory;
-            }
-        }
-        return nullptr;
+        return GetFactoryById(FindId(name));
+    }
+
+    const ComponentFactory* GetFactoryByNameHash(u32 nameHash) const {
+        return GetFactoryById(FindIdByNameHash(nameHash));
     }
 
-    const HashMap<u32, ComponentFactory>& GetAllFactories() const {
+    const Vector<ComponentFactory>& GetAllFactories() const {
         return m_Factories;
     }
 
     // Initialize all registered component metadata
     void InitializeMeta(entt::meta_ctx& ctx) {
-        for (auto& [id, factory] : m_Factories) {
+        for (auto& factory : m_Factories) {
             if (factory.RegisterMeta) {
                 factory.RegisterMeta(ctx);
             }
@@ -114,7 +224,9 @@ public:
 
 private:
     ComponentRegistry() = default;
-    HashMap<u32, ComponentFactory> m_Factories;
+    Vector<ComponentFactory> m_Factories;
+    HashMap<u32, ComponentId> m_ByTypeHash;
+    HashMap<u32, ComponentId> m_ByNameHash;
 };
 
 // Helper to auto-register components at static initialization
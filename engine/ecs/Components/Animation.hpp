@@ -0,0 +1,55 @@
+#pragma once
+
+#include "ecs/Component.hpp"
+#include "core/Types.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+class Skeleton;
+class AnimationClip;
+class SkinnedMesh;
+class Mesh;
+
+// Skeletal animation state. AnimationSystem advances the clips, samples and
+// blends them on the job system and leaves the skinning matrices in
+// Palette for SkinningSystem.
+struct AnimatorComponent {
+    Ref<const Engine::Skeleton> Skeleton;
+    Ref<const AnimationClip> Clip;
+    f32 Time = 0.0f;        // Seconds into Clip
+    f32 Speed = 1.0f;       // Also advances BlendTime
+    bool Loop = true;
+    bool Playing = true;
+
+    // Cross-fade: BlendClip weighed in over Clip, 0 = Clip alone. Both clips
+    // must animate the skeleton's joints.
+    Ref<const AnimationClip> BlendClip;
+    f32 BlendTime = 0.0f;
+    f32 BlendWeight = 0.0f;
+
+    // Written by AnimationSystem: model-space joint times inverse bind, one
+    // per joint
+    Vector<glm::mat4> Palette;
+};
+
+// Skinned geometry for an entity with an AnimatorComponent. SkinningSystem
+// gives it a MeshComponent drawing Instance, its own copy of Source that
+// the compute pass skins every frame. Not reflected: a copy would share
+// the instance and skin it twice.
+struct SkinnedMeshComponent {
+    Ref<SkinnedMesh> Source;
+    Ref<Mesh> Instance;     // Created by SkinningSystem
+};
+
+} // namespace Engine
+
+// Reflection registrations
+REFLECT_COMPONENT(Engine::AnimatorComponent,
+    .data<&Engine::AnimatorComponent::Time>("Time"_hs)
+    .data<&Engine::AnimatorComponent::Speed>("Speed"_hs)
+    .data<&Engine::AnimatorComponent::Loop>("Loop"_hs)
+    .data<&Engine::AnimatorComponent::Playing>("Playing"_hs)
+    .data<&Engine::AnimatorComponent::BlendTime>("BlendTime"_hs)
+    .data<&Engine::AnimatorComponent::BlendWeight>("BlendWeight"_hs)
+);
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "ecs/Component.hpp"
+#include "ecs/Components/Transform.hpp"
+#include "math/AABB.hpp"
 #include "core/Types.hpp"
 #include <entt/entt.hpp>
+#include <utility>
 
 namespace Engine {
 
@@ -36,17 +39,71 @@ struct Hierarchy {
 // Tag component for root entities (optimization for queries)
 struct RootEntity {};
 
-// Helper functions for hierarchy management
+// World space bounds of an entity's mesh and every mesh below it, kept by
+// TransformSystem on each resolved entity that has resolved children.
+// Culling passes test it once for the whole subtree. Derived state: not
+// serialized.
+struct SubtreeBounds {
+    AABB Bounds;
+
+    // No mesh anywhere in the subtree
+    bool IsEmpty() const { return Bounds.Min.x > Bounds.Max.x; }
+};
+
+// Helper functions for hierarchy management. Traversals are iterative, so
+// deep rigs can't overflow the stack.
 namespace HierarchyUtils {
 
-    // Forward declaration
-    inline void UpdateChildDepths(entt::registry& registry, entt::entity entity, u32 parentDepth);
+    // Check if ancestor is an ancestor of entity
+    inline bool IsAncestorOf(entt::registry& registry,
+                             entt::entity ancestor,
+                             entt::entity entity) {
+        auto* hierarchy = registry.try_get<Hierarchy>(entity);
+        while (hierarchy && hierarchy->Parent != entt::null) {
+            if (hierarchy->Parent == ancestor) return true;
+            entity = hierarchy->Parent;
+            hierarchy = registry.try_get<Hierarchy>(entity);
+        }
+        return false;
+    }
+
+    // Update depths of all descendants
+    inline void UpdateChildDepths(entt::registry& registry,
+                                  entt::entity entity,
+                                  u32 parentDepth) {
+        auto* hierarchy = registry.try_get<Hierarchy>(entity);
+        if (!hierarchy || hierarchy->FirstChild == entt::null) return;
+
+        // Each entry is a first child and the depth of its siblings
+        Vector<std::pair<entt::entity, u32>> stack;
+        stack.emplace_back(hierarchy->FirstChild, parentDepth + 1);
+
+        while (!stack.empty()) {
+            auto [child, depth] = stack.back();
+            stack.pop_back();
+
+            while (child != entt::null) {
+                auto& childHierarchy = registry.get<Hierarchy>(child);
+                childHierarchy.Depth = depth;
+                if (childHierarchy.FirstChild != entt::null) {
+                    stack.emplace_back(childHierarchy.FirstChild, depth + 1);
+                }
+                child = childHierarchy.NextSibling;
+            }
+        }
+    }
 
-    // Set parent of entity (handles all linking)
+    // Set parent of entity (handles all linking). Parenting an entity to
+    // itself or one of its descendants would make a cycle and is ignored.
     inline void SetParent(entt::registry& registry,
                          entt::entity child,
                          entt::entity newParent) {
+        if (newParent != entt::null && (newParent == child || IsAncestorOf(registry, child, newParent))) {
+            return;
+        }
+
         auto& childHierarchy = registry.get_or_emplace<Hierarchy>(child);
+        const u32 oldDepth = childHierarchy.Depth;
 
         // Remove from old parent if any
         if (childHierarchy.Parent != entt::null) {
@@ -79,43 +136,40 @@ namespace HierarchyUtils {
         childHierarchy.PrevSibling = entt::null;
 
         if (newParent != entt::null) {
+            // May add a component and move childHierarchy; look it up again after
             auto& parentHierarchy = registry.get_or_emplace<Hierarchy>(newParent);
+            auto& linked = registry.get<Hierarchy>(child);
 
             // Add to front of children list
             if (parentHierarchy.FirstChild != entt::null) {
                 auto& firstChild = registry.get<Hierarchy>(parentHierarchy.FirstChild);
                 firstChild.PrevSibling = child;
-                childHierarchy.NextSibling = parentHierarchy.FirstChild;
+                linked.NextSibling = parentHierarchy.FirstChild;
             }
 
             parentHierarchy.FirstChild = child;
             parentHierarchy.ChildCount++;
 
             // Update depth
-            childHierarchy.Depth = parentHierarchy.Depth + 1;
+            linked.Depth = parentHierarchy.Depth + 1;
         } else {
             // No parent = root entity
             registry.emplace_or_replace<RootEntity>(child);
             childHierarchy.Depth = 0;
         }
 
-        // Recursively update children depths
-        UpdateChildDepths(registry, child, childHierarchy.Depth);
-    }
-
-    // Update depths of all descendants
-    inline void UpdateChildDepths(entt::registry& registry,
-                                  entt::entity entity,
-                                  u32 parentDepth) {
-        auto* hierarchy = registry.try_get<Hierarchy>(entity);
-        if (!hierarchy) return;
+        // Descendants keep their depths relative to child, so the subtree
+        // only needs walking when child's own depth changed
+        const u32 newDepth = registry.get<Hierarchy>(child).Depth;
+        if (newDepth != oldDepth) {
+            UpdateChildDepths(registry, child, newDepth);
+        }
 
-        entt::entity child = hierarchy->FirstChild;
-        while (child != entt::null) {
-            auto& childHierarchy = registry.get<Hierarchy>(child);
-            childHierarchy.Depth = parentDepth + 1;
-            UpdateChildDepths(registry, child, childHierarchy.Depth);
-            child = childHierarchy.NextSibling;
+        // Notify observers (TransformSystem patches its level order) and make
+        // sure the world matrix is recomputed against the new parent
+        registry.patch<Hierarchy>(child);
+        if (auto* transform = registry.try_get<Transform>(child)) {
+            transform->Dirty = true;
         }
     }
 
@@ -127,22 +181,30 @@ namespace HierarchyUtils {
     // Destroy entity and all its descendants
     inline void DestroyHierarchy(entt::registry& registry, entt::entity entity) {
         auto* hierarchy = registry.try_get<Hierarchy>(entity);
-        if (hierarchy) {
-            // Recursively destroy children
-            entt::entity child = hierarchy->FirstChild;
-            while (child != entt::null) {
-                auto& childHierarchy = registry.get<Hierarchy>(child);
-                entt::entity nextChild = childHierarchy.NextSibling;
-                DestroyHierarchy(registry, child);
-                child = nextChild;
-            }
+        if (!hierarchy) {
+            registry.destroy(entity);
+            return;
+        }
 
-            // Detach from parent
+        // Only the subtree root is linked to anything that survives
+        if (hierarchy->Parent != entt::null) {
             DetachFromParent(registry, entity);
         }
 
-        // Destroy this entity
-        registry.destroy(entity);
+        // Collect first: destroying invalidates the links being followed
+        Vector<entt::entity> subtree{entity};
+        for (usize i = 0; i < subtree.size(); ++i) {
+            entt::entity child = registry.get<Hierarchy>(subtree[i]).FirstChild;
+            while (child != entt::null) {
+                subtree.push_back(child);
+                child = registry.get<Hierarchy>(child).NextSibling;
+            }
+        }
+
+        // Leaves first, as the recursive version did
+        for (auto it = subtree.rbegin(); it != subtree.rend(); ++it) {
+            registry.destroy(*it);
+        }
     }
 
     // Get root ancestor of entity
@@ -155,19 +217,6 @@ namespace HierarchyUtils {
         return entity;
     }
 
-    // Check if ancestor is an ancestor of entity
-    inline bool IsAncestorOf(entt::registry& registry,
-                             entt::entity ancestor,
-                             entt::entity entity) {
-        auto* hierarchy = registry.try_get<Hierarchy>(entity);
-        while (hierarchy && hierarchy->Parent != entt::null) {
-            if (hierarchy->Parent == ancestor) return true;
-            entity = hierarchy->Parent;
-            hierarchy = registry.try_get<Hierarchy>(entity);
-        }
-        return false;
-    }
-
     // Iterate over all children (non-recursive)
     template<typename Func>
     void ForEachChild(entt::registry& registry, entt::entity parent, Func&& func) {
@@ -183,22 +232,47 @@ namespace HierarchyUtils {
         }
     }
 
-    // Iterate over all descendants (recursive, depth-first)
+    // Iterate over all descendants (depth-first, pre-order)
     template<typename Func>
     void ForEachDescendant(entt::registry& registry, entt::entity parent, Func&& func) {
         auto* hierarchy = registry.try_get<Hierarchy>(parent);
         if (!hierarchy) return;
 
+        // Siblings to resume with once a child's subtree is done
+        Vector<entt::entity> resume;
         entt::entity child = hierarchy->FirstChild;
-        while (child != entt::null) {
-            auto& childHierarchy = registry.get<Hierarchy>(child);
-            entt::entity nextChild = childHierarchy.NextSibling;
+
+        while (true) {
+            while (child == entt::null) {
+                if (resume.empty()) return;
+                child = resume.back();
+                resume.pop_back();
+            }
+
+            entt::entity nextChild = registry.get<Hierarchy>(child).NextSibling;
             func(child);
-            ForEachDescendant(registry, child, func);
-            child = nextChild;
+
+            // func may have changed the registry; read the children afterwards
+            auto* childHierarchy = registry.try_get<Hierarchy>(child);
+            if (childHierarchy && childHierarchy->FirstChild != entt::null) {
+                resume.push_back(nextChild);
+                child = childHierarchy->FirstChild;
+            } else {
+                child = nextChild;
+            }
         }
     }
 
+    // Reorder the Hierarchy pool so views visit parents before children and
+    // siblings next to each other. Call at sync points (after loading a
+    // scene); TransformSystem keeps its own order for the transform pools.
+    inline void SortByDepth(entt::registry& registry) {
+        registry.sort<Hierarchy>([](const Hierarchy& a, const Hierarchy& b) {
+            if (a.Depth != b.Depth) return a.Depth < b.Depth;
+            return a.Parent < b.Parent;
+        });
+    }
+
 } // namespace HierarchyUtils
 
 } // namespace Engine
@@ -1,11 +1,14 @@
 #pragma once
 
 #include "core/Types.hpp"
+#include "core/StringId.hpp"
 
 namespace Engine {
 
+// Interned (StringId), so the component is trivially copyable; assign it
+// a string or literal to rename
 struct NameComponent {
-    String Name;
+    StringId Name;
 };
 
 } // namespace Engine
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "ecs/Component.hpp"
+#include "core/Types.hpp"
+#include "renderer/particles/ParticleTypes.hpp"
+
+namespace Engine {
+
+class ParticleEmitter;
+
+// A particle effect following its entity's Transform (or WorldTransform).
+// ParticleEmitterSystem creates the emitter from Settings the first time it
+// sees the component enabled, then copies Settings to it every frame, so
+// edits go here; Settings.Position is an offset in the entity's local
+// space. Changing MaxParticles or DepthSort restarts the effect. Not
+// reflected: a copy would share the emitter.
+struct ParticleEmitterComponent {
+    EmitterSettings Settings;
+    bool Enabled = true;                    // Disabling destroys the emitter and its particles; cleared when a one-shot finishes
+
+    // Written by ParticleEmitterSystem, which owns it; null while disabled
+    ParticleEmitter* Emitter = nullptr;
+};
+
+} // namespace Engine
@@ -3,42 +3,37 @@
 #include "ecs/Component.hpp"
 #include "core/Types.hpp"
 #include "math/AABB.hpp"
+#include "resources/ResourceHandle.hpp"
 #include <glm/glm.hpp>
 
 namespace Engine {
 
-// Forward declarations for renderer types
-class Shader;
-class VertexArray;
-class Material;
-
-// Mesh reference component
+// Mesh reference component. The mesh stays in ResourceManager's pool and
+// renderers resolve the handle when they draw, so a mesh finishing an async
+// load or being reloaded is picked up without touching the component.
 struct MeshComponent {
-    Ref<VertexArray> VAO;
-    u32 IndexCount = 0;
-    u32 VertexCount = 0;
+    MeshHandle Mesh;
 
     // Bounding volumes for culling
     AABB LocalBounds;
     BoundingSphere LocalSphere;
 
-    // Mesh identification
-    String MeshName;
+    // Mesh identification (batching)
     u32 MeshId = 0;
 };
 
 // Material reference component
 struct MaterialComponent {
-    Ref<Shader> ShaderRef;
-    // Future: Ref<Material> MaterialRef;
+    ShaderHandle Shader;
 
-    // Basic material properties (will be expanded)
+    // Basic material properties. With a MaterialLibrary material BaseColor
+    // tints the material's and Metallic / Roughness come from the library.
     glm::vec4 BaseColor{1.0f, 1.0f, 1.0f, 1.0f};
     f32 Metallic = 0.0f;
     f32 Roughness = 0.5f;
 
-    // Material identification
-    String MaterialName;
+    // MaterialLibrary id; 0 (or an id the library doesn't know) draws with
+    // the properties above only. The library holds the material's name.
     u32 MaterialId = 0;
 };
 
@@ -53,7 +48,9 @@ struct Renderable {
     bool CastShadows = true;
     bool ReceiveShadows = true;
 
-    // LOD
+    // LOD. ImpostorLevel draws the mesh's ImpostorLibrary impostor; passes
+    // without impostors treat it as the coarsest level.
+    static constexpr u8 ImpostorLevel = 0xFF;
     u8 LODLevel = 0;
     u8 MaxLODLevel = 4;
 
@@ -69,7 +66,6 @@ struct Renderable {
 
     // Visibility flags (set by culling system)
     bool InFrustum = true;
-    bool OcclusionCulled = false;
 };
 
 // Tag for entities that need culling check
@@ -81,13 +77,18 @@ struct StaticGeometry {};
 // Tag for dynamic geometry (moves, needs bounds update)
 struct DynamicGeometry {};
 
-// Instance data for batched rendering
+// Instance data for batched rendering. Mirrors the std430 InstanceData
+// struct in the geometry shader, keep both in sync.
 struct InstanceData {
     glm::mat4 Transform;
     glm::vec4 Color{1.0f};
+    glm::vec4 MaterialParams{0.0f, 0.5f, 1.0f, 1.0f};  // Metallic, roughness, AO, normal strength
     u32 EntityId = 0;  // For picking
-    u32 Flags = 0;
+    u32 Flags = 0;     // Pass-specific (shadow cascade / face index)
+    u32 MaterialIndex = 0;  // MaterialLibrary id
+    u32 Padding = 0;
 };
+static_assert(sizeof(InstanceData) % 16 == 0, "InstanceData must match std430 array stride");
 
 // Batch info for instanced rendering
 struct BatchInfo {
@@ -110,16 +111,14 @@ struct RenderStats {
 
 // Reflection registrations
 REFLECT_COMPONENT(Engine::MeshComponent,
-    .data<&Engine::MeshComponent::IndexCount>("IndexCount"_hs)
-    .data<&Engine::MeshComponent::VertexCount>("VertexCount"_hs)
-    .data<&Engine::MeshComponent::MeshName>("MeshName"_hs)
+    .data<&Engine::MeshComponent::MeshId>("MeshId"_hs)
 );
 
 REFLECT_COMPONENT(Engine::MaterialComponent,
     .data<&Engine::MaterialComponent::BaseColor>("BaseColor"_hs)
     .data<&Engine::MaterialComponent::Metallic>("Metallic"_hs)
     .data<&Engine::MaterialComponent::Roughness>("Roughness"_hs)
-    .data<&Engine::MaterialComponent::MaterialName>("MaterialName"_hs)
+    .data<&Engine::MaterialComponent::MaterialId>("MaterialId"_hs)
 );
 
 REFLECT_COMPONENT(Engine::Renderable,
@@ -9,6 +9,7 @@
 namespace Engine {
 
 // Transform component - cache-friendly layout (128 bytes, 16-byte aligned)
+// See TransformSoA.hpp for the split LocalTransform/WorldTransform layout.
 struct alignas(16) Transform {
     // Core transform data
     glm::vec3 Position{0.0f, 0.0f, 0.0f};
@@ -158,6 +159,30 @@ struct alignas(16) Transform {
 static_assert(sizeof(Transform) == 128, "Transform should be 128 bytes");
 static_assert(alignof(Transform) == 16, "Transform should be 16-byte aligned");
 
+// Opt-in render smoothing for a Transform moved by the fixed-step physics
+// phases. Holds the state before the latest step; TransformInterpolationSystem
+// draws the world matrix between it and the Transform by Time::GetSimulationAlpha().
+struct TransformInterpolation {
+    glm::vec3 PreviousPosition{0.0f, 0.0f, 0.0f};
+    glm::quat PreviousRotation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 PreviousScale{1.0f, 1.0f, 1.0f};
+
+    // False until the first step captured a state; drawn unsmoothed until then
+    bool Valid = false;
+
+    // World matrix drawn last frame, which becomes PreviousWorldTransform
+    glm::mat4 DrawnMatrix{1.0f};
+    bool Drawn = false;
+};
+
+// World matrix as of the previous frame, for motion vectors. Kept by
+// TransformSystem for every entity it resolves (either layout), and by
+// TransformInterpolationSystem for the ones it smooths; equal to the world
+// matrix for anything that didn't move.
+struct PreviousWorldTransform {
+    glm::mat4 Matrix{1.0f};
+};
+
 } // namespace Engine
 
 // Reflection registration
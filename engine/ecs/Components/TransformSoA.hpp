@@ -0,0 +1,243 @@
+#pragma once
+
+#include "ecs/Component.hpp"
+#include "ecs/Components/Transform.hpp"
+#include "core/Types.hpp"
+#include <entt/entt.hpp>
+
+namespace Engine {
+
+// =============================================================================
+// SoA transform layout
+// =============================================================================
+// Optional alternative to the 128-byte Transform component. The same data is
+// split across three EnTT storages so hot loops only stream what they read:
+//
+//   LocalTransform  - position / rotation / scale (40 bytes, written by gameplay)
+//   WorldTransform  - cached world matrix (64 bytes, written by TransformSystem)
+//   TransformDirty  - empty tag; its storage is the set of dirty entities
+//
+// An entity uses either Transform or the SoA components, never both.
+// TransformSystem resolves both layouts in the same hierarchy pass, and
+// TransformRef offers the Transform API on top of the split storages.
+
+struct LocalTransform {
+    glm::vec3 Position{0.0f, 0.0f, 0.0f};
+    glm::quat Rotation{1.0f, 0.0f, 0.0f, 0.0f};  // w, x, y, z
+    glm::vec3 Scale{1.0f, 1.0f, 1.0f};
+
+    glm::mat4 GetLocalMatrix() const {
+        glm::mat4 matrix = glm::translate(glm::mat4(1.0f), Position);
+        matrix *= glm::mat4_cast(Rotation);
+        return glm::scale(matrix, Scale);
+    }
+};
+
+struct WorldTransform {
+    glm::mat4 Matrix{1.0f};
+
+    glm::vec3 GetWorldPosition() const {
+        return glm::vec3(Matrix[3]);
+    }
+};
+
+struct TransformDirty {};
+
+static_assert(sizeof(LocalTransform) == 40, "LocalTransform should be 40 bytes");
+static_assert(sizeof(WorldTransform) == 64, "WorldTransform should be 64 bytes");
+
+// Transform-like façade over the SoA storages of one entity.
+// Setters flag the entity with TransformDirty, which emplaces into a storage,
+// so they must not be called from parallel jobs.
+class TransformRef {
+public:
+    TransformRef(entt::registry& registry, entt::entity entity)
+        : m_Registry(&registry)
+        , m_Entity(entity)
+        , m_Local(&registry.get<LocalTransform>(entity))
+        , m_World(&registry.get<WorldTransform>(entity)) {}
+
+    // Read access
+    const glm::vec3& GetPosition() const { return m_Local->Position; }
+    const glm::quat& GetRotation() const { return m_Local->Rotation; }
+    const glm::vec3& GetScale() const { return m_Local->Scale; }
+    const glm::mat4& GetWorldMatrix() const { return m_World->Matrix; }
+
+    bool IsDirty() const { return m_Registry->all_of<TransformDirty>(m_Entity); }
+
+    // Setters (mark dirty)
+    void SetPosition(const glm::vec3& pos) {
+        m_Local->Position = pos;
+        MarkDirty();
+    }
+
+    void SetPosition(f32 x, f32 y, f32 z) {
+        SetPosition(glm::vec3(x, y, z));
+    }
+
+    void Translate(const glm::vec3& delta) {
+        m_Local->Position += delta;
+        MarkDirty();
+    }
+
+    void SetRotation(const glm::quat& rot) {
+        m_Local->Rotation = glm::normalize(rot);
+        MarkDirty();
+    }
+
+    void SetRotationEuler(const glm::vec3& euler) {
+        m_Local->Rotation = glm::quat(euler);
+        MarkDirty();
+    }
+
+    void SetRotationEuler(f32 pitch, f32 yaw, f32 roll) {
+        SetRotationEuler(glm::vec3(pitch, yaw, roll));
+    }
+
+    glm::vec3 GetEulerAngles() const {
+        return glm::eulerAngles(m_Local->Rotation);
+    }
+
+    void Rotate(const glm::quat& rot) {
+        m_Local->Rotation = glm::normalize(rot * m_Local->Rotation);
+        MarkDirty();
+    }
+
+    void RotateAround(const glm::vec3& axis, f32 angle) {
+        Rotate(glm::angleAxis(angle, glm::normalize(axis)));
+    }
+
+    void SetScale(f32 uniformScale) {
+        SetScale(glm::vec3(uniformScale));
+    }
+
+    void SetScale(const glm::vec3& scale) {
+        m_Local->Scale = scale;
+        MarkDirty();
+    }
+
+    void SetScale(f32 x, f32 y, f32 z) {
+        SetScale(glm::vec3(x, y, z));
+    }
+
+    void LookAt(const glm::vec3& target, const glm::vec3& up = glm::vec3(0, 1, 0)) {
+        if (glm::length(target - m_Local->Position) < 0.0001f) return;
+
+        glm::mat4 lookMatrix = glm::lookAt(m_Local->Position, target, up);
+        m_Local->Rotation = glm::quat_cast(glm::inverse(lookMatrix));
+        MarkDirty();
+    }
+
+    void MarkDirty() {
+        m_Registry->emplace_or_replace<TransformDirty>(m_Entity);
+    }
+
+    // Direction vectors
+    glm::vec3 GetForward() const {
+        return glm::normalize(m_Local->Rotation * glm::vec3(0.0f, 0.0f, -1.0f));
+    }
+
+    glm::vec3 GetRight() const {
+        return glm::normalize(m_Local->Rotation * glm::vec3(1.0f, 0.0f, 0.0f));
+    }
+
+    glm::vec3 GetUp() const {
+        return glm::normalize(m_Local->Rotation * glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+
+    // Matrices and world-space queries (from cached world matrix)
+    glm::mat4 GetLocalMatrix() const { return m_Local->GetLocalMatrix(); }
+
+    glm::vec3 GetWorldPosition() const { return m_World->GetWorldPosition(); }
+
+    glm::vec3 TransformPoint(const glm::vec3& localPoint) const {
+        return glm::vec3(m_World->Matrix * glm::vec4(localPoint, 1.0f));
+    }
+
+    glm::vec3 TransformDirection(const glm::vec3& localDir) const {
+        return glm::vec3(m_World->Matrix * glm::vec4(localDir, 0.0f));
+    }
+
+    glm::vec3 InverseTransformPoint(const glm::vec3& worldPoint) const {
+        return glm::vec3(glm::inverse(m_World->Matrix) * glm::vec4(worldPoint, 1.0f));
+    }
+
+    entt::entity GetEntity() const { return m_Entity; }
+
+private:
+    entt::registry* m_Registry;
+    entt::entity m_Entity;
+    LocalTransform* m_Local;
+    WorldTransform* m_World;
+};
+
+namespace TransformLayout {
+
+    // Add the SoA transform components to an entity
+    inline TransformRef EmplaceSoA(entt::registry& registry, entt::entity entity,
+                                   const glm::vec3& position = glm::vec3(0.0f),
+                                   const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                                   const glm::vec3& scale = glm::vec3(1.0f)) {
+        registry.emplace_or_replace<LocalTransform>(entity, LocalTransform{position, rotation, scale});
+        registry.emplace_or_replace<WorldTransform>(entity);
+        registry.emplace_or_replace<TransformDirty>(entity);
+        return TransformRef(registry, entity);
+    }
+
+    // Move an entity from the AoS Transform component to the SoA layout
+    inline void ConvertToSoA(entt::registry& registry, entt::entity entity) {
+        auto* transform = registry.try_get<Transform>(entity);
+        if (!transform) return;
+
+        Transform copy = *transform;
+        registry.remove<Transform>(entity);
+
+        EmplaceSoA(registry, entity, copy.Position, copy.Rotation, copy.Scale);
+        registry.get<WorldTransform>(entity).Matrix = copy.WorldMatrix;
+    }
+
+    // Move an entity from the SoA layout back to the AoS Transform component
+    inline void ConvertToAoS(entt::registry& registry, entt::entity entity) {
+        auto* local = registry.try_get<LocalTransform>(entity);
+        if (!local) return;
+
+        Transform transform;
+        transform.Position = local->Position;
+        transform.Rotation = local->Rotation;
+        transform.Scale = local->Scale;
+        if (auto* world = registry.try_get<WorldTransform>(entity)) {
+            transform.WorldMatrix = world->Matrix;
+        }
+        transform.Dirty = true;
+
+        registry.remove<LocalTransform, WorldTransform, TransformDirty>(entity);
+        registry.emplace<Transform>(entity, transform);
+    }
+
+    inline bool IsSoA(const entt::registry& registry, entt::entity entity) {
+        return registry.all_of<LocalTransform, WorldTransform>(entity);
+    }
+
+    // World matrix of an entity in either layout, nullptr if it has none
+    inline const glm::mat4* TryGetWorldMatrix(const entt::registry& registry, entt::entity entity) {
+        if (auto* transform = registry.try_get<Transform>(entity)) return &transform->WorldMatrix;
+        if (auto* world = registry.try_get<WorldTransform>(entity)) return &world->Matrix;
+        return nullptr;
+    }
+
+} // namespace TransformLayout
+
+} // namespace Engine
+
+// Reflection registration
+REFLECT_COMPONENT(Engine::LocalTransform,
+    .data<&Engine::LocalTransform::Position>("Position"_hs)
+    .data<&Engine::LocalTransform::Rotation>("Rotation"_hs)
+    .data<&Engine::LocalTransform::Scale>("Scale"_hs)
+);
+
+REFLECT_COMPONENT(Engine::WorldTransform,
+    .data<&Engine::WorldTransform::Matrix>("Matrix"_hs)
+);
+
+REFLECT_TAG(Engine::TransformDirty);
@@ -10,6 +10,10 @@
 // This provides access to:
 //   - Entity, Registry (entity management)
 //   - ISystem, SystemScheduler (system management)
+//   - Prefab (bulk spawning from a component template)
+//   - EntityCommandBuffer (structural changes deferred to phase ends)
+//   - TransformSystem, TransformInterpolationSystem, BoundsUpdateSystem
+//     (built-in systems)
 //   - Component reflection macros (REFLECT_COMPONENT, REFLECT_TAG)
 //   - Built-in components (Transform, Hierarchy, Renderable)
 //
@@ -26,12 +30,20 @@
 #include "ecs/Registry.hpp"
 #include "ecs/System.hpp"
 #include "ecs/SystemScheduler.hpp"
+#include "ecs/Prefab.hpp"
+#include "ecs/EntityCommandBuffer.hpp"
+#include "ecs/ChangeTracking.hpp"
 
 // Built-in components
 #include "ecs/Components/Transform.hpp"
+#include "ecs/Components/TransformSoA.hpp"
 #include "ecs/Components/Hierarchy.hpp"
 #include "ecs/Components/Renderable.hpp"
 
+// Built-in systems
+#include "ecs/TransformSystem.hpp"
+#include "ecs/TransformInterpolationSystem.hpp"
+
 namespace Engine {
 
 // =============================================================================
@@ -50,61 +62,12 @@ using HierarchyQuery = std::tuple<Transform, Hierarchy, Extra...>;
 // System utilities
 // =============================================================================
 
-// TransformSystem - updates world matrices respecting hierarchy
-class TransformSystem : public ISystem {
-public:
-    DEFINE_SYSTEM(TransformSystem, Update, 10)
-
-    void OnUpdate(entt::registry& registry, f32 deltaTime) override {
-        (void)deltaTime;
-
-        // First pass: update root transforms
-        auto rootView = registry.view<Transform, RootEntity>();
-        for (auto entity : rootView) {
-            auto& transform = registry.get<Transform>(entity);
-            if (transform.Dirty) {
-                transform.UpdateWorldMatrix();
-            }
-        }
-
-        // Second pass: update transforms with hierarchy (sorted by depth)
-        auto hierarchyView = registry.view<Transform, Hierarchy>();
-
-        // Collect and sort by depth
-        Vector<std::pair<u32, entt::entity>> sortedEntities;
-        for (auto entity : hierarchyView) {
-            auto& hierarchy = registry.get<Hierarchy>(entity);
-            if (!registry.all_of<RootEntity>(entity)) {
-                sortedEntities.emplace_back(hierarchy.Depth, entity);
-            }
-        }
-
-        std::sort(sortedEntities.begin(), sortedEntities.end(),
-            [](const auto& a, const auto& b) { return a.first < b.first; });
-
-        // Update in depth order
-        for (auto& [depth, entity] : sortedEntities) {
-            auto& transform = registry.get<Transform>(entity);
-            auto& hierarchy = registry.get<Hierarchy>(entity);
-
-            if (transform.Dirty || hierarchy.Parent != entt::null) {
-                glm::mat4 parentMatrix{1.0f};
-                if (hierarchy.Parent != entt::null) {
-                    auto* parentTransform = registry.try_get<Transform>(hierarchy.Parent);
-                    if (parentTransform) {
-                        parentMatrix = parentTransform->WorldMatrix;
-                    }
-                }
-                transform.UpdateWorldMatrix(parentMatrix);
-            }
-        }
-    }
-};
-
 // BoundsUpdateSystem - updates world bounds for renderables
 class BoundsUpdateSystem : public ISystem {
 public:
     DEFINE_SYSTEM(BoundsUpdateSystem, PreRender, 5)
+    SYSTEM_ACCESS(.Read<Transform, MeshComponent>()
+                  .Write<Renderable>())
 
     void OnUpdate(entt::registry& registry, f32 deltaTime) override {
         (void)deltaTime;
@@ -0,0 +1,70 @@
+#include "ecs/EntityCommandBuffer.hpp"
+#include "core/JobSystem.hpp"
+
+#include <algorithm>
+
+namespace Engine {
+
+EntityCommandBuffer::~EntityCommandBuffer() = default;
+
+void EntityCommandBuffer::Playback(entt::registry& registry) {
+    if (m_CommandCount == 0) return;
+
+    m_Created.resize(m_CreateCount);
+    registry.create(m_Created.begin(), m_Created.end());
+
+    for (auto& queue : m_Queues) {
+        queue->Playback(registry, m_Created);
+    }
+
+    // Several systems may destroy the same entity
+    std::sort(m_Destroyed.begin(), m_Destroyed.end());
+    m_Destroyed.erase(std::unique(m_Destroyed.begin(), m_Destroyed.end()), m_Destroyed.end());
+    m_Destroyed.erase(std::remove_if(m_Destroyed.begin(), m_Destroyed.end(),
+                                     [&registry](entt::entity entity) { return !registry.valid(entity); }),
+                      m_Destroyed.end());
+    registry.destroy(m_Destroyed.begin(), m_Destroyed.end());
+
+    // m_Created stays readable until the next playback
+    m_CreateCount = 0;
+    m_CommandCount = 0;
+    m_Destroyed.clear();
+    for (auto& queue : m_Queues) {
+        queue->Clear();
+    }
+}
+
+void EntityCommandBuffer::Clear() {
+    m_CreateCount = 0;
+    m_CommandCount = 0;
+    m_Created.clear();
+    m_Destroyed.clear();
+    for (auto& queue : m_Queues) {
+        queue->Clear();
+    }
+}
+
+void ThreadCommandBuffers::Resize() {
+    const usize count = static_cast<usize>(JobSystem::GetWorkerCount()) + 1;
+    while (m_Buffers.size() < count) {
+        m_Buffers.push_back(CreateScope<EntityCommandBuffer>());
+    }
+}
+
+EntityCommandBuffer& ThreadCommandBuffers::ForCurrentThread() {
+    const usize slot = static_cast<usize>(JobSystem::GetCurrentWorkerIndex() + 1);
+    return *m_Buffers[slot < m_Buffers.size() ? slot : 0];
+}
+
+void ThreadCommandBuffers::Playback(entt::registry& registry) {
+    for (auto& buffer : m_Buffers) {
+        buffer->Playback(registry);
+    }
+}
+
+EntityCommandBuffer& GetCommandBuffer(entt::registry& registry) {
+    // Published by SystemScheduler::Initialize
+    return registry.ctx().get<ThreadCommandBuffers*>()->ForCurrentThread();
+}
+
+} // namespace Engine
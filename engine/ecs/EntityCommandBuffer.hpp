@@ -0,0 +1,205 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include "core/Types.hpp"
+#include <type_traits>
+#include <utility>
+
+namespace Engine {
+
+// EntityCommandBuffer - structural changes recorded now, applied later.
+//
+// Systems running on JobSystem workers must not create or destroy entities
+// or add / remove components on the shared registry. They record those
+// operations here instead; SystemScheduler plays every buffer back at the
+// end of the phase, on the main thread.
+//
+// Commands are stored per component type in contiguous arrays that keep
+// their capacity across frames. Playback is batched the same way: one
+// registry.create for all new entities, then per component type (in the
+// order each type was first recorded) its adds, sets and removes with the
+// pool looked up and reserved once, then all destroys. Ordering between
+// commands of different kinds is therefore not preserved; record the end
+// state instead (an Add and a Remove of the same component in one buffer
+// leaves it removed). Signals still fire per entity.
+//
+// A buffer is not thread-safe: use one per thread, see GetCommandBuffer().
+class EntityCommandBuffer {
+public:
+    // Entity created by Create(), only meaningful to this buffer until
+    // Playback() resolves it
+    struct PendingEntity {
+        u32 Index = 0;
+    };
+
+    EntityCommandBuffer() = default;
+    ~EntityCommandBuffer();
+
+    EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+    EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+    PendingEntity Create() {
+        ++m_CommandCount;
+        return {m_CreateCount++};
+    }
+
+    // Stale or already destroyed entities are skipped
+    void Destroy(entt::entity entity) {
+        ++m_CommandCount;
+        m_Destroyed.push_back(entity);
+    }
+
+    // emplace_or_replace
+    template<typename T>
+    void Add(entt::entity entity, T value = {}) {
+        auto& queue = Queue<T>();
+        queue.AddEntities.push_back(entity);
+        if constexpr (!std::is_empty_v<T>) queue.AddValues.push_back(std::move(value));
+        ++m_CommandCount;
+    }
+
+    template<typename T>
+    void Add(PendingEntity entity, T value = {}) {
+        auto& queue = Queue<T>();
+        queue.PendingEntities.push_back(entity.Index);
+        if constexpr (!std::is_empty_v<T>) queue.PendingValues.push_back(std::move(value));
+        ++m_CommandCount;
+    }
+
+    // replace (on_update fires); skipped when the entity has no T
+    template<typename T>
+    void Set(entt::entity entity, T value) {
+        static_assert(!std::is_empty_v<T>, "Tags have no value to set");
+        auto& queue = Queue<T>();
+        queue.SetEntities.push_back(entity);
+        queue.SetValues.push_back(std::move(value));
+        ++m_CommandCount;
+    }
+
+    template<typename T>
+    void Remove(entt::entity entity) {
+        Queue<T>().RemoveEntities.push_back(entity);
+        ++m_CommandCount;
+    }
+
+    // Apply and clear. Main thread, with no system running.
+    void Playback(entt::registry& registry);
+
+    // Drop everything recorded; capacity is kept
+    void Clear();
+
+    bool IsEmpty() const { return m_CommandCount == 0; }
+    u32 GetCommandCount() const { return m_CommandCount; }
+
+    // Entities the last Playback() created, indexed by PendingEntity::Index
+    const Vector<entt::entity>& GetCreatedEntities() const { return m_Created; }
+
+private:
+    struct ComponentQueueBase {
+        virtual ~ComponentQueueBase() = default;
+        virtual void Playback(entt::registry& registry, const Vector<entt::entity>& created) = 0;
+        virtual void Clear() = 0;
+    };
+
+    template<typename T>
+    struct ComponentQueue final : ComponentQueueBase {
+        Vector<entt::entity> AddEntities;
+        Vector<T> AddValues;                // Empty for tags
+        Vector<u32> PendingEntities;
+        Vector<T> PendingValues;
+        Vector<entt::entity> SetEntities;
+        Vector<T> SetValues;
+        Vector<entt::entity> RemoveEntities;
+
+        void Playback(entt::registry& registry, const Vector<entt::entity>& created) override {
+            auto& storage = registry.storage<T>();
+            storage.reserve(storage.size() + AddEntities.size() + PendingEntities.size());
+
+            for (usize i = 0; i < PendingEntities.size(); ++i) {
+                Emplace(storage, created[PendingEntities[i]], i, PendingValues);
+            }
+            for (usize i = 0; i < AddEntities.size(); ++i) {
+                if (registry.valid(AddEntities[i])) {
+                    Emplace(storage, AddEntities[i], i, AddValues);
+                }
+            }
+
+            if constexpr (!std::is_empty_v<T>) {
+                for (usize i = 0; i < SetEntities.size(); ++i) {
+                    if (storage.contains(SetEntities[i])) {
+                        storage.patch(SetEntities[i], [&](T& component) { component = std::move(SetValues[i]); });
+                    }
+                }
+            }
+
+            storage.remove(RemoveEntities.begin(), RemoveEntities.end());
+        }
+
+        template<typename Storage>
+        static void Emplace(Storage& storage, entt::entity entity, usize index, Vector<T>& values) {
+            if constexpr (std::is_empty_v<T>) {
+                (void)index;
+                (void)values;
+                if (!storage.contains(entity)) storage.emplace(entity);
+            } else if (storage.contains(entity)) {
+                storage.patch(entity, [&](T& component) { component = std::move(values[index]); });
+            } else {
+                storage.emplace(entity, std::move(values[index]));
+            }
+        }
+
+        void Clear() override {
+            AddEntities.clear();
+            AddValues.clear();
+            PendingEntities.clear();
+            PendingValues.clear();
+            SetEntities.clear();
+            SetValues.clear();
+            RemoveEntities.clear();
+        }
+    };
+
+    template<typename T>
+    ComponentQueue<T>& Queue() {
+        const entt::id_type id = entt::type_hash<T>::value();
+        auto [it, added] = m_QueueIndex.try_emplace(id, static_cast<u32>(m_Queues.size()));
+        if (added) {
+            m_Queues.push_back(CreateScope<ComponentQueue<T>>());
+        }
+        return static_cast<ComponentQueue<T>&>(*m_Queues[it->second]);
+    }
+
+private:
+    u32 m_CreateCount = 0;
+    u32 m_CommandCount = 0;
+    Vector<entt::entity> m_Created;
+    Vector<entt::entity> m_Destroyed;
+
+    // In first-use order, reused across playbacks
+    Vector<Scope<ComponentQueueBase>> m_Queues;
+    HashMap<entt::id_type, u32> m_QueueIndex;
+};
+
+// One EntityCommandBuffer per thread: slot 0 for the main thread, then one
+// per JobSystem worker. SystemScheduler owns a set and publishes it in the
+// registry context.
+class ThreadCommandBuffers {
+public:
+    // Call on the main thread after JobSystem::Init
+    void Resize();
+
+    // Buffer of the calling thread: the main thread or a JobSystem worker
+    EntityCommandBuffer& ForCurrentThread();
+
+    // Play back and clear every buffer, main thread first
+    void Playback(entt::registry& registry);
+
+private:
+    Vector<Scope<EntityCommandBuffer>> m_Buffers;
+};
+
+// Command buffer of the calling thread for a registry driven by a
+// SystemScheduler; played back at the end of the current phase
+EntityCommandBuffer& GetCommandBuffer(entt::registry& registry);
+
+} // namespace Engine
@@ -2,11 +2,107 @@
 
 #include <entt/entt.hpp>
 #include "core/Types.hpp"
+#include "core/JobSystem.hpp"
+#include "core/FrameAllocator.hpp"
 #include "Component.hpp"
+#include <cstddef>
 #include <functional>
+#include <tuple>
+#include <utility>
 
 namespace Engine {
 
+// Split a view into chunks and process them on JobSystem workers.
+// func receives the same arguments as view.each(): the entity followed by
+// references to every non-empty component. The callback must not create or
+// destroy entities or add/remove components; inside a system, record them in
+// GetCommandBuffer() instead.
+template<typename... Components, typename Func>
+void ParallelEach(entt::registry& registry, Func&& func, u32 grainSize = 256) {
+    auto view = registry.view<Components...>();
+
+    FrameVector<entt::entity> entities;
+    entities.reserve(view.size_hint());
+    for (auto entity : view) {
+        entities.push_back(entity);
+    }
+
+    JobSystem::ParallelFor(static_cast<u32>(entities.size()), grainSize,
+        [&](u32 begin, u32 end) {
+            for (u32 i = begin; i < end; ++i) {
+                entt::entity entity = entities[i];
+                std::apply(func, std::tuple_cat(std::make_tuple(entity), view.get(entity)));
+            }
+        });
+}
+
+// Order-preserving parallel gather. func(out, entity, components...) appends
+// any number of elements to a chunk-local FrameVector<T> (in the arena of the
+// worker running the chunk); chunks are concatenated in view order so the
+// result matches a sequential loop. out may be any vector of T.
+template<typename... Components, typename Out, typename Func>
+void ParallelGather(entt::registry& registry, Out& out, Func&& func, u32 grainSize = 256) {
+    using T = typename Out::value_type;
+    auto view = registry.view<Components...>();
+    grainSize = std::max(grainSize, 1u);
+
+    FrameVector<entt::entity> entities;
+    entities.reserve(view.size_hint());
+    for (auto entity : view) {
+        entities.push_back(entity);
+    }
+
+    const u32 count = static_cast<u32>(entities.size());
+    FrameVector<FrameVector<T>> chunks((count + grainSize - 1) / grainSize);
+
+    JobSystem::ParallelFor(count, grainSize, [&](u32 begin, u32 end) {
+        auto& local = chunks[begin / grainSize];
+        for (u32 i = begin; i < end; ++i) {
+            entt::entity entity = entities[i];
+            std::apply(func, std::tuple_cat(std::forward_as_tuple(local),
+                                            std::make_tuple(entity), view.get(entity)));
+        }
+    });
+
+    for (auto& chunk : chunks) {
+        out.insert(out.end(), chunk.begin(), chunk.end());
+    }
+}
+
+// ParallelGather over a group, in group order. func receives the owned
+// components first, then the get<> ones, as group.each() does. Owned
+// components are read from their packed arrays by index; only the get<>
+// ones go through the sparse set. Every component must be non-empty.
+template<typename... Owned, typename... Get, typename... Exclude, typename Out, typename Func>
+void ParallelGather(const entt::basic_group<entt::owned_t<Owned...>, entt::get_t<Get...>, entt::exclude_t<Exclude...>>& group,
+                    Out& out, Func&& func, u32 grainSize = 256) {
+    using T = typename Out::value_type;
+    grainSize = std::max(grainSize, 1u);
+
+    const u32 count = static_cast<u32>(group.size());
+    FrameVector<FrameVector<T>> chunks((count + grainSize - 1) / grainSize);
+    const auto first = group.begin();
+
+    [&]<std::size_t... O, std::size_t... G>(std::index_sequence<O...>, std::index_sequence<G...>) {
+        const auto owned = std::make_tuple(group.template storage<O>()...);
+        const auto gets = std::make_tuple(group.template storage<sizeof...(Owned) + G>()...);
+
+        JobSystem::ParallelFor(count, grainSize, [&](u32 begin, u32 end) {
+            auto& local = chunks[begin / grainSize];
+            for (u32 i = begin; i < end; ++i) {
+                const auto it = first + static_cast<std::ptrdiff_t>(i);
+                const entt::entity entity = *it;
+                func(local, entity, std::get<O>(owned)->rbegin()[it.index()]...,
+                     std::get<G>(gets)->get(entity)...);
+            }
+        });
+    }(std::index_sequence_for<Owned...>{}, std::index_sequence_for<Get...>{});
+
+    for (auto& chunk : chunks) {
+        out.insert(out.end(), chunk.begin(), chunk.end());
+    }
+}
+
 // Entity handle wrapper for cleaner API
 class Entity {
 public:
@@ -176,6 +272,12 @@ public:
         view.each(std::forward<Func>(func));
     }
 
+    // Same as Each, but splits the view across JobSystem workers
+    template<typename... Components, typename Func>
+    void ParallelEach(Func&& func, u32 grainSize = 256) {
+        Engine::ParallelEach<Components...>(m_Registry, std::forward<Func>(func), grainSize);
+    }
+
     // Clear all entities and components
     void Clear() {
         m_Registry.clear();
@@ -187,28 +289,40 @@ public:
         m_Registry.sort<T>(compare);
     }
 
-    // Runtime component operations (for editor/scripting)
-    void* AddComponentByName(entt::entity entity, const char* componentName) {
-        auto* factory = ComponentRegistry::Get().GetFactoryByName(componentName);
-        if (factory && factory->Create) {
-            return factory->Create(m_Registry, entity);
-        }
-        return nullptr;
+    // Runtime component operations (for editor/scripting). Resolve the id
+    // once with ComponentRegistry::FindId; the by-name versions look it up
+    // on every call.
+    void* AddComponent(entt::entity entity, ComponentId id) {
+        auto* factory = ComponentRegistry::Get().GetFactoryById(id);
+        return factory ? factory->Create(m_Registry, entity) : nullptr;
     }
 
-    void RemoveComponentByName(entt::entity entity, const char* componentName) {
-        auto* factory = ComponentRegistry::Get().GetFactoryByName(componentName);
-        if (factory && factory->Remove) {
+    void RemoveComponent(entt::entity entity, ComponentId id) {
+        if (auto* factory = ComponentRegistry::Get().GetFactoryById(id)) {
             factory->Remove(m_Registry, entity);
         }
     }
 
+    bool HasComponent(entt::entity entity, ComponentId id) const {
+        auto* factory = ComponentRegistry::Get().GetFactoryById(id);
+        return factory && factory->Has(m_Registry, entity);
+    }
+
+    void* GetComponent(entt::entity entity, ComponentId id) {
+        auto* factory = ComponentRegistry::Get().GetFactoryById(id);
+        return factory ? factory->Get(m_Registry, entity) : nullptr;
+    }
+
+    void* AddComponentByName(entt::entity entity, const char* componentName) {
+        return AddComponent(entity, ComponentRegistry::Get().FindId(componentName));
+    }
+
+    void RemoveComponentByName(entt::entity entity, const char* componentName) {
+        RemoveComponent(entity, ComponentRegistry::Get().FindId(componentName));
+    }
+
     bool HasComponentByName(entt::entity entity, const char* componentName) const {
-        auto* factory = ComponentRegistry::Get().GetFactoryByName(componentName);
-        if (factory && factory->Has) {
-            return factory->Has(m_Registry, entity);
-        }
-        return false;
+        return HasComponent(entity, ComponentRegistry::Get().FindId(componentName));
     }
 
     // Get meta context for reflection
@@ -0,0 +1,628 @@
+#include "ecs/SceneSerializer.hpp"
+#include "ecs/Component.hpp"
+#include "ecs/Components/Transform.hpp"
+#include "ecs/Components/TransformSoA.hpp"
+#include "ecs/Components/Renderable.hpp"
+#include "ecs/Components/Hierarchy.hpp"
+#include "ecs/Components/LightComponents.hpp"
+#include "ecs/Components/NameComponent.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Logger.hpp"
+#include "core/MappedFile.hpp"
+#include "resources/ResourceManager.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 SceneFileMagic = 0x43535650;  // 'PVSC'
+constexpr u32 SceneFileVersion = 1;
+constexpr usize SceneFileAlignment = 16;
+
+// Chunk types besides component name hashes
+constexpr u32 ChunkTypeEntities = 0;
+constexpr u32 ChunkTypeNames = 1;
+
+struct SceneFileHeader {
+    u32 Magic = SceneFileMagic;
+    u32 Version = SceneFileVersion;
+    u32 EntityCount = 0;
+    u32 ChunkCount = 0;
+    u32 MeshCount = 0;
+    u32 ShaderCount = 0;
+    u64 TableOffset = 0;
+    u64 ChunkOffset = 0;
+    u64 Reserved = 0;
+};
+static_assert(sizeof(SceneFileHeader) == 48, "SceneFileHeader is part of the file format");
+
+// Followed by DataSize bytes of components (Count * ElementSize, or the
+// strings of a name chunk) and Count u32 entities
+struct SceneChunkHeader {
+    u32 Type = 0;           // ChunkType*, or ComponentFactory::NameHash
+    u32 ElementSize = 0;
+    u32 Count = 0;
+    u32 Reserved = 0;
+    u64 DataSize = 0;
+    u64 Reserved2 = 0;
+};
+static_assert(sizeof(SceneChunkHeader) == 32, "SceneChunkHeader is part of the file format");
+static_assert(sizeof(entt::entity) == sizeof(u32), "Scene files store 32-bit entity identifiers");
+
+usize AlignUp(usize value) {
+    return (value + SceneFileAlignment - 1) & ~(SceneFileAlignment - 1);
+}
+
+// [offset, offset + size) lies inside the file
+bool InFile(u64 offset, u64 size, usize fileSize) {
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+class ByteWriter {
+public:
+    void Write(const void* data, usize size) {
+        const u8* bytes = static_cast<const u8*>(data);
+        m_Bytes.insert(m_Bytes.end(), bytes, bytes + size);
+    }
+
+    template<typename T>
+    void Write(const T& value) { Write(&value, sizeof(T)); }
+
+    void WriteString(std::string_view value) {
+        Write(static_cast<u32>(value.size()));
+        Write(value.data(), value.size());
+    }
+
+    void Align() { m_Bytes.resize(AlignUp(m_Bytes.size())); }
+
+    usize Size() const { return m_Bytes.size(); }
+    u8* Data() { return m_Bytes.data(); }
+
+private:
+    Vector<u8> m_Bytes;
+};
+
+// Bounds-checked reads; any read past the end fails the reader for good
+class ByteReader {
+public:
+    ByteReader(const u8* data, usize size) : m_Data(data), m_Size(size) {}
+
+    bool Read(void* out, usize size) {
+        if (!m_Valid || size > m_Size - m_Offset) {
+            m_Valid = false;
+            return false;
+        }
+        std::memcpy(out, m_Data + m_Offset, size);
+        m_Offset += size;
+        return true;
+    }
+
+    bool ReadString(String& out) {
+        u32 length = 0;
+        if (!Read(&length, sizeof(length)) || length > m_Size - m_Offset) {
+            m_Valid = false;
+            return false;
+        }
+        out.assign(reinterpret_cast<const char*>(m_Data + m_Offset), length);
+        m_Offset += length;
+        return true;
+    }
+
+    bool IsValid() const { return m_Valid; }
+
+private:
+    const u8* m_Data;
+    usize m_Size;
+    usize m_Offset = 0;
+    bool m_Valid = true;
+};
+
+template<typename Handle>
+Handle RemapHandle(const Vector<Handle>& table, Handle handle) {
+    return handle.IsSet() && handle.Index < table.size() ? table[handle.Index] : Handle{};
+}
+
+// Rewrite the handle member of every T in a raw component blob
+template<typename T, typename Handle, typename Func>
+void RemapBlob(u8* data, usize count, Handle T::*member, Func&& remap) {
+    for (usize i = 0; i < count; i++) {
+        T component;
+        std::memcpy(&component, data + i * sizeof(T), sizeof(T));
+        component.*member = remap(component.*member);
+        std::memcpy(data + i * sizeof(T), &component, sizeof(T));
+    }
+}
+
+} // anonymous namespace
+
+bool SceneSerializer::IsSceneFile(const String& filepath) {
+    return std::filesystem::path(filepath).extension() == Extension;
+}
+
+bool SceneSerializer::Save(entt::registry& registry, const String& filepath) {
+    Vector<entt::entity> entities;
+    for (auto [entity] : registry.storage<entt::entity>().each()) {
+        entities.push_back(entity);
+    }
+    return Write(registry, filepath, entities, false);
+}
+
+bool SceneSerializer::Save(entt::registry& registry, const String& filepath, const Vector<entt::entity>& entities) {
+    return Write(registry, filepath, entities, true);
+}
+
+bool SceneSerializer::Write(entt::registry& registry, const String& filepath,
+                            const Vector<entt::entity>& entities, bool partial) {
+    auto& resources = ResourceManager::Instance();
+
+    // Handles become indices into the file's tables, which record what is
+    // needed to find or load the resource again
+    ByteWriter meshTable;
+    ByteWriter shaderTable;
+    HashMap<u64, u32> meshIndices;
+    HashMap<u64, u32> shaderIndices;
+    auto handleKey = [](u32 index, u32 generation) {
+        return static_cast<u64>(index) | (static_cast<u64>(generation) << 32);
+    };
+
+    auto meshIndex = [&](MeshHandle handle) -> MeshHandle {
+        const Mesh* mesh = resources.GetMesh(handle);
+        if (!mesh) return {};
+        auto [it, added] = meshIndices.try_emplace(handleKey(handle.Index, handle.Generation),
+                                                   static_cast<u32>(meshIndices.size()));
+        if (added) {
+            meshTable.WriteString(resources.GetMeshName(handle));
+            meshTable.WriteString(mesh->GetName());
+            meshTable.WriteString(mesh->GetFilePath());
+        }
+        return MeshHandle{it->second, 0};
+    };
+
+    auto shaderIndex = [&](ShaderHandle handle) -> ShaderHandle {
+        const String name = resources.GetShaderName(handle);
+        if (name.empty()) return {};
+        auto [it, added] = shaderIndices.try_emplace(handleKey(handle.Index, handle.Generation),
+                                                     static_cast<u32>(shaderIndices.size()));
+        if (added) {
+            shaderTable.WriteString(name);
+        }
+        return ShaderHandle{it->second, 0};
+    };
+
+    ByteWriter chunks;
+    u32 chunkCount = 0;
+    auto writeChunk = [&](u32 type, u32 elementSize, const entt::entity* chunkEntities, u32 count,
+                          const void* data, usize dataSize) {
+        SceneChunkHeader header;
+        header.Type = type;
+        header.ElementSize = elementSize;
+        header.Count = count;
+        header.DataSize = dataSize;
+        chunks.Write(header);
+        chunks.Write(data, dataSize);
+        chunks.Write(chunkEntities, count * sizeof(entt::entity));
+        chunks.Align();
+        chunkCount++;
+    };
+
+    for (usize first = 0; first < entities.size(); first += ChunkElements) {
+        const u32 count = static_cast<u32>(std::min<usize>(ChunkElements, entities.size() - first));
+        writeChunk(ChunkTypeEntities, 0, entities.data() + first, count, nullptr, 0);
+    }
+
+    // A partial save gathers each pool's share of entities one by one
+    Vector<u8> blob;
+    Vector<entt::entity> selected;
+    auto select = [&](const entt::sparse_set& storage, usize size, auto&& bytes) {
+        selected.clear();
+        blob.clear();
+        for (entt::entity entity : entities) {
+            if (!storage.contains(entity)) continue;
+            selected.push_back(entity);
+            if (size) {
+                const u8* data = static_cast<const u8*>(bytes(entity));
+                blob.insert(blob.end(), data, data + size);
+            }
+        }
+    };
+
+    for (const auto& factory : ComponentRegistry::Get().GetAllFactories()) {
+        auto& storage = factory.Storage(registry);
+        if (storage.empty()) continue;
+        if (!factory.SavePool) {
+            LOG_CORE_WARN("SceneSerializer: {} is not trivially copyable and is not saved", factory.Name);
+            continue;
+        }
+
+        const entt::entity* poolEntities = storage.data();
+        usize poolCount = storage.size();
+        if (partial) {
+            select(storage, factory.Size, [&](entt::entity entity) { return factory.Get(registry, entity); });
+            poolEntities = selected.data();
+            poolCount = selected.size();
+            if (poolCount == 0) continue;
+        } else {
+            blob.clear();
+            factory.SavePool(registry, blob);
+        }
+
+        if (factory.TypeIndex == std::type_index(typeid(MeshComponent))) {
+            RemapBlob(blob.data(), poolCount, &MeshComponent::Mesh, meshIndex);
+        } else if (factory.TypeIndex == std::type_index(typeid(MaterialComponent))) {
+            RemapBlob(blob.data(), poolCount, &MaterialComponent::Shader, shaderIndex);
+        }
+
+        for (usize first = 0; first < poolCount; first += ChunkElements) {
+            const u32 count = static_cast<u32>(std::min<usize>(ChunkElements, poolCount - first));
+            writeChunk(factory.NameHash, factory.Size, poolEntities + first, count,
+                       blob.data() + first * factory.Size, static_cast<usize>(count) * factory.Size);
+        }
+    }
+
+    // Names are strings, not a raw pool
+    auto& names = registry.storage<NameComponent>();
+    const entt::entity* namedEntities = names.data();
+    usize namedCount = names.size();
+    if (partial) {
+        select(names, 0, [](entt::entity) -> const void* { return nullptr; });
+        namedEntities = selected.data();
+        namedCount = selected.size();
+    }
+    for (usize first = 0; first < namedCount; first += ChunkElements) {
+        const u32 count = static_cast<u32>(std::min<usize>(ChunkElements, namedCount - first));
+        ByteWriter strings;
+        for (usize i = first; i < first + count; i++) {
+            strings.WriteString(names.get(namedEntities[i]).Name.View());
+        }
+        writeChunk(ChunkTypeNames, 0, namedEntities + first, count, strings.Data(), strings.Size());
+    }
+
+    SceneFileHeader header;
+    header.EntityCount = static_cast<u32>(entities.size());
+    header.ChunkCount = chunkCount;
+    header.MeshCount = static_cast<u32>(meshIndices.size());
+    header.ShaderCount = static_cast<u32>(shaderIndices.size());
+    header.TableOffset = sizeof(SceneFileHeader);
+    header.ChunkOffset = AlignUp(header.TableOffset + meshTable.Size() + shaderTable.Size());
+
+    std::error_code error;
+    std::filesystem::path path(filepath);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+
+    // Write a temporary and rename it, so a failed save can't leave a
+    // truncated scene behind
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_CORE_WARN("SceneSerializer: could not write {}", filepath);
+            return false;
+        }
+
+        static const char padding[SceneFileAlignment] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(meshTable.Data()), static_cast<std::streamsize>(meshTable.Size()));
+        out.write(reinterpret_cast<const char*>(shaderTable.Data()), static_cast<std::streamsize>(shaderTable.Size()));
+        out.write(padding, static_cast<std::streamsize>(header.ChunkOffset - static_cast<u64>(out.tellp())));
+        out.write(reinterpret_cast<const char*>(chunks.Data()), static_cast<std::streamsize>(chunks.Size()));
+
+        if (!out) {
+            LOG_CORE_WARN("SceneSerializer: could not write {}", filepath);
+            out.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    LOG_CORE_INFO("SceneSerializer: saved {} entities to {}", entities.size(), filepath);
+    return true;
+}
+
+bool SceneLoader::Begin(entt::registry& registry, const String& filepath, LoadMode mode) {
+    Cancel();
+
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(filepath, error)) {
+        LOG_CORE_WARN("SceneLoader: {} not found", filepath);
+        return false;
+    }
+
+    if (mode == LoadMode::Replace) {
+        registry.clear();
+    }
+    m_Registry = &registry;
+    m_FilePath = filepath;
+    m_Mode = mode;
+    m_EntityMap.clear();
+    m_Entities.clear();
+    m_MeshHandles.clear();
+    m_ShaderHandles.clear();
+    m_ResourcesResolved = false;
+    m_ChunkCount = 0;
+    m_CommittedChunks = 0;
+    m_StartTime = std::chrono::steady_clock::now();
+    m_Stats = {};
+
+    m_State = CreateRef<State>();
+    JobSystem::Submit([state = m_State, filepath] { Read(state, filepath); });
+    return true;
+}
+
+void SceneLoader::Cancel() {
+    if (m_State) {
+        m_State->Cancelled.store(true, std::memory_order_relaxed);
+        m_State = nullptr;
+    }
+}
+
+f32 SceneLoader::GetProgress() const {
+    if (!m_State) return 1.0f;
+    return m_ChunkCount ? static_cast<f32>(m_CommittedChunks) / static_cast<f32>(m_ChunkCount) : 0.0f;
+}
+
+void SceneLoader::Read(const Ref<State>& state, const String& filepath) {
+    auto finish = [&] {
+        std::lock_guard<std::mutex> lock(state->Mutex);
+        state->Finished = true;
+    };
+    auto fail = [&](const char* reason) {
+        LOG_CORE_ERROR("SceneLoader: {} is not a valid scene file ({})", filepath, reason);
+        finish();
+    };
+
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        LOG_CORE_ERROR("SceneLoader: could not open {}", filepath);
+        finish();
+        return;
+    }
+
+    const u8* base = file.Data();
+    const usize size = file.Size();
+    if (size < sizeof(SceneFileHeader)) return fail("truncated header");
+
+    SceneFileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (header.Magic != SceneFileMagic) return fail("bad magic");
+    if (header.Version != SceneFileVersion) return fail("unsupported version");
+    if (!InFile(header.TableOffset, 0, size) || !InFile(header.ChunkOffset, 0, size)) {
+        return fail("table outside the file");
+    }
+
+    auto tables = CreateScope<ResourceTables>();
+    ByteReader reader(base + header.TableOffset, size - header.TableOffset);
+    for (u32 i = 0; i < header.MeshCount && reader.IsValid(); i++) {
+        ResourceTables::MeshEntry entry;
+        reader.ReadString(entry.Name);
+        reader.ReadString(entry.MeshName);
+        reader.ReadString(entry.FilePath);
+        tables->Meshes.push_back(std::move(entry));
+    }
+    for (u32 i = 0; i < header.ShaderCount && reader.IsValid(); i++) {
+        String name;
+        reader.ReadString(name);
+        tables->Shaders.push_back(std::move(name));
+    }
+    if (!reader.IsValid()) return fail("truncated resource table");
+
+    {
+        std::lock_guard<std::mutex> lock(state->Mutex);
+        state->Tables = std::move(tables);
+        state->ChunkCount = header.ChunkCount;
+    }
+
+    u64 offset = header.ChunkOffset;
+    for (u32 i = 0; i < header.ChunkCount; i++) {
+        if (state->Cancelled.load(std::memory_order_relaxed)) break;
+
+        SceneChunkHeader chunkHeader;
+        if (!InFile(offset, sizeof(chunkHeader), size)) return fail("truncated chunk");
+        std::memcpy(&chunkHeader, base + offset, sizeof(chunkHeader));
+
+        const u64 dataOffset = offset + sizeof(chunkHeader);
+        const u64 entityBytes = static_cast<u64>(chunkHeader.Count) * sizeof(entt::entity);
+        if (chunkHeader.ElementSize && chunkHeader.DataSize != static_cast<u64>(chunkHeader.Count) * chunkHeader.ElementSize) {
+            return fail("chunk size mismatch");
+        }
+        if (!InFile(dataOffset, chunkHeader.DataSize, size) ||
+            !InFile(dataOffset + chunkHeader.DataSize, entityBytes, size)) {
+            return fail("chunk outside the file");
+        }
+
+        // Copying here faults the mapped pages in on the worker, not in Update()
+        Chunk chunk;
+        chunk.Type = chunkHeader.Type;
+        chunk.ElementSize = chunkHeader.ElementSize;
+        chunk.Data.assign(base + dataOffset, base + dataOffset + chunkHeader.DataSize);
+        chunk.Entities.resize(chunkHeader.Count);
+        std::memcpy(chunk.Entities.data(), base + dataOffset + chunkHeader.DataSize, entityBytes);
+
+        {
+            std::lock_guard<std::mutex> lock(state->Mutex);
+            state->Chunks.push_back(std::move(chunk));
+        }
+        offset = AlignUp(dataOffset + chunkHeader.DataSize + entityBytes);
+    }
+
+    finish();
+}
+
+void SceneLoader::Update(f32 budgetMs) {
+    if (!m_State) return;
+
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::duration<f32, std::milli>(budgetMs);
+
+    if (!m_ResourcesResolved) {
+        Scope<ResourceTables> tables;
+        bool finished = false;
+        {
+            std::lock_guard<std::mutex> lock(m_State->Mutex);
+            tables = std::move(m_State->Tables);
+            m_ChunkCount = m_State->ChunkCount;
+            finished = m_State->Finished;
+        }
+        if (tables) {
+            ResolveResources(*tables);
+        } else {
+            if (finished) {
+                m_State = nullptr;  // The file was invalid, already logged
+            }
+            return;
+        }
+    }
+
+    bool finished = false;
+    do {
+        Chunk chunk;
+        {
+            std::lock_guard<std::mutex> lock(m_State->Mutex);
+            if (m_State->Chunks.empty()) {
+                finished = m_State->Finished;
+                break;
+            }
+            chunk = std::move(m_State->Chunks.front());
+            m_State->Chunks.pop_front();
+        }
+        Commit(chunk);
+        m_CommittedChunks++;
+    } while (Clock::now() < deadline);
+
+    if (finished) {
+        m_State = nullptr;
+
+        // Chunks arrive in file order; put parents before children once
+        HierarchyUtils::SortByDepth(*m_Registry);
+
+        m_Stats.LoadTimeMs = std::chrono::duration<f32, std::milli>(Clock::now() - m_StartTime).count();
+        LOG_CORE_INFO("SceneLoader: loaded {} entities from {} in {:.1f} ms", m_Stats.Entities, m_FilePath,
+                      m_Stats.LoadTimeMs);
+        if (m_Stats.SkippedChunks) {
+            LOG_CORE_WARN("SceneLoader: skipped {} chunks of unknown or changed components", m_Stats.SkippedChunks);
+        }
+    }
+}
+
+void SceneLoader::ResolveResources(const ResourceTables& tables) {
+    auto& resources = ResourceManager::Instance();
+
+    for (const auto& entry : tables.Meshes) {
+        MeshHandle handle = entry.Name.empty() ? MeshHandle{} : resources.FindMesh(entry.Name);
+        if (!handle && !entry.FilePath.empty()) {
+            const String& name = entry.Name.empty() ? entry.FilePath : entry.Name;
+            handle = resources.AddMesh(resources.LoadMeshAsync(name, entry.FilePath));
+        }
+        if (!handle) {
+            // Primitives are unnamed in the pool and have no file
+            if (entry.MeshName == "Cube") handle = resources.AddMesh(resources.GetCube());
+            else if (entry.MeshName == "Sphere") handle = resources.AddMesh(resources.GetSphere());
+            else if (entry.MeshName == "Plane") handle = resources.AddMesh(resources.GetPlane());
+            else if (entry.MeshName == "Cylinder") handle = resources.AddMesh(resources.GetCylinder());
+        }
+        if (!handle) {
+            LOG_CORE_WARN("SceneLoader: mesh '{}' of {} not found", entry.MeshName, m_FilePath);
+        }
+        m_MeshHandles.push_back(handle);
+    }
+
+    for (const auto& name : tables.Shaders) {
+        ShaderHandle handle = resources.FindShader(name);
+        if (!handle) {
+            LOG_CORE_WARN("SceneLoader: shader '{}' of {} not loaded", name, m_FilePath);
+        }
+        m_ShaderHandles.push_back(handle);
+    }
+
+    m_ResourcesResolved = true;
+}
+
+void SceneLoader::Commit(Chunk& chunk) {
+    auto& registry = *m_Registry;
+    const usize count = chunk.Entities.size();
+
+    if (chunk.Type == ChunkTypeEntities) {
+        for (entt::entity entity : chunk.Entities) {
+            if (m_Mode == LoadMode::Append) {
+                const entt::entity created = registry.create();
+                m_EntityMap[entity] = created;
+                m_Entities.push_back(created);
+                m_Stats.Entities++;
+            } else if (!registry.valid(entity)) {
+                m_Entities.push_back(registry.create(entity));
+                m_Stats.Entities++;
+            }
+        }
+        return;
+    }
+
+    const ComponentFactory* factory = nullptr;
+    if (chunk.Type != ChunkTypeNames) {
+        factory = ComponentRegistry::Get().GetFactoryByNameHash(chunk.Type);
+        if (!factory || !factory->LoadPool || factory->Size != chunk.ElementSize) {
+            m_Stats.SkippedChunks++;
+            return;
+        }
+    }
+
+    auto mapEntity = [this](entt::entity entity) -> entt::entity {
+        auto it = m_EntityMap.find(entity);
+        return it != m_EntityMap.end() ? it->second : entt::null;
+    };
+    if (m_Mode == LoadMode::Append) {
+        for (entt::entity& entity : chunk.Entities) {
+            entity = mapEntity(entity);
+        }
+    }
+
+    // Every entity must exist and not have the component yet
+    entt::sparse_set& storage = factory ? factory->Storage(registry)
+                                        : static_cast<entt::sparse_set&>(registry.storage<NameComponent>());
+    for (entt::entity entity : chunk.Entities) {
+        if (!registry.valid(entity) || storage.contains(entity)) {
+            m_Stats.SkippedChunks++;
+            return;
+        }
+    }
+
+    if (!factory) {
+        ByteReader reader(chunk.Data.data(), chunk.Data.size());
+        for (entt::entity entity : chunk.Entities) {
+            String name;
+            if (!reader.ReadString(name)) break;
+            registry.emplace<NameComponent>(entity, StringId(name));
+        }
+        m_Stats.Components += static_cast<u32>(count);
+        return;
+    }
+
+    if (m_Mode == LoadMode::Append && factory->TypeIndex == std::type_index(typeid(Hierarchy))) {
+        for (entt::entity Hierarchy::*link : {&Hierarchy::Parent, &Hierarchy::FirstChild,
+                                              &Hierarchy::NextSibling, &Hierarchy::PrevSibling}) {
+            RemapBlob(chunk.Data.data(), count, link, mapEntity);
+        }
+    } else if (factory->TypeIndex == std::type_index(typeid(MeshComponent))) {
+        RemapBlob(chunk.Data.data(), count, &MeshComponent::Mesh,
+                  [this](MeshHandle handle) { return RemapHandle(m_MeshHandles, handle); });
+    } else if (factory->TypeIndex == std::type_index(typeid(MaterialComponent))) {
+        RemapBlob(chunk.Data.data(), count, &MaterialComponent::Shader,
+                  [this](ShaderHandle handle) { return RemapHandle(m_ShaderHandles, handle); });
+    }
+
+    factory->LoadPool(registry, chunk.Entities.data(), count, chunk.Data.data());
+    m_Stats.Components += static_cast<u32>(count);
+}
+
+} // namespace Engine
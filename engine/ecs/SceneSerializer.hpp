@@ -0,0 +1,152 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "resources/ResourceHandle.hpp"
+#include <entt/entt.hpp>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+
+namespace Engine {
+
+// Binary scene file (.pvscene), built on the ComponentRegistry metadata.
+//
+// Every registered tag and trivially copyable component is stored as raw
+// pool blobs, identified by the hash of its reflected name and checked
+// against its size, so a file outlives component reordering and a changed
+// component is skipped instead of misread. Entities keep their identifiers,
+// which keeps entity references (Hierarchy) valid. NameComponent is stored
+// as strings, its interned ids being per process. Mesh and shader handles are written as indices into a table
+// of names and source files and resolved again on load.
+//
+// Layout, little-endian:
+//   SceneFileHeader | mesh and shader tables | chunks
+// where a chunk is a header, Count components (16-byte aligned) and their
+// Count entities, at most ChunkElements each. Entity chunks come first.
+class SceneSerializer {
+public:
+    static constexpr const char* Extension = ".pvscene";
+    static constexpr u32 ChunkElements = 4096;
+
+    static bool Save(entt::registry& registry, const String& filepath);
+
+    // Save only entities, with their components. Entity references leading
+    // outside the set are nulled when the file is loaded with
+    // SceneLoader::LoadMode::Append.
+    static bool Save(entt::registry& registry, const String& filepath, const Vector<entt::entity>& entities);
+
+    static bool IsSceneFile(const String& filepath);
+
+private:
+    static bool Write(entt::registry& registry, const String& filepath,
+                      const Vector<entt::entity>& entities, bool partial);
+};
+
+// Streaming scene load. Begin() clears the registry and maps the file on the
+// job system, where its chunks are validated and copied out; Update() adds
+// decoded chunks to the registry until its budget is spent, so a large
+// level fills in over a few frames instead of blocking the UI. Meshes
+// referenced by file start loading asynchronously as the tables arrive.
+class SceneLoader {
+public:
+    SceneLoader() = default;
+    ~SceneLoader() { Cancel(); }
+
+    SceneLoader(const SceneLoader&) = delete;
+    SceneLoader& operator=(const SceneLoader&) = delete;
+
+    // Replace clears the registry and keeps the file's entity identifiers.
+    // Append adds the entities next to the existing ones under new
+    // identifiers, and remaps the Hierarchy links between them.
+    enum class LoadMode {
+        Replace,
+        Append
+    };
+
+    // Start loading filepath into registry. The registry must outlive the
+    // load. Returns false when there is no such file; a file found invalid
+    // while reading logs and ends the load.
+    bool Begin(entt::registry& registry, const String& filepath, LoadMode mode = LoadMode::Replace);
+
+    // Commit decoded chunks until budgetMs is spent (at least one per call).
+    // Call once a frame on the GL thread while IsLoading().
+    void Update(f32 budgetMs = DefaultBudgetMs);
+
+    // Stop adding chunks; what was committed stays
+    void Cancel();
+
+    bool IsLoading() const { return m_State != nullptr; }
+
+    // Committed fraction of the file's chunks, 0..1
+    f32 GetProgress() const;
+
+    // Entities created so far, in file order; kept after the load finishes
+    const Vector<entt::entity>& GetEntities() const { return m_Entities; }
+
+    static constexpr f32 DefaultBudgetMs = 4.0f;
+
+    struct Stats {
+        u32 Entities = 0;
+        u32 Components = 0;
+        u32 SkippedChunks = 0;     // Unknown or changed component types
+        f32 LoadTimeMs = 0.0f;     // Begin to the last commit
+    };
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    // A chunk copied out of the file, ready to commit
+    struct Chunk {
+        u32 Type = 0;
+        u32 ElementSize = 0;
+        Vector<entt::entity> Entities;
+        Vector<u8> Data;
+    };
+
+    struct ResourceTables {
+        struct MeshEntry {
+            String Name;        // In ResourceManager, may be empty
+            String MeshName;    // Mesh::GetName, identifies primitives
+            String FilePath;
+        };
+        Vector<MeshEntry> Meshes;
+        Vector<String> Shaders;
+    };
+
+    // Shared with the reading job, which may outlive a cancelled load
+    struct State {
+        std::mutex Mutex;
+        std::deque<Chunk> Chunks;
+        Scope<ResourceTables> Tables;
+        u32 ChunkCount = 0;
+        bool Finished = false;      // Everything read, or the file was invalid
+        std::atomic<bool> Cancelled{false};
+    };
+
+    static void Read(const Ref<State>& state, const String& filepath);
+
+    void ResolveResources(const ResourceTables& tables);
+    void Commit(Chunk& chunk);
+
+private:
+    Ref<State> m_State;
+    entt::registry* m_Registry = nullptr;
+    String m_FilePath;
+    LoadMode m_Mode = LoadMode::Replace;
+
+    // Append: file entity to created entity
+    HashMap<entt::entity, entt::entity> m_EntityMap;
+    Vector<entt::entity> m_Entities;
+
+    // File table index to handle of this run
+    Vector<MeshHandle> m_MeshHandles;
+    Vector<ShaderHandle> m_ShaderHandles;
+    bool m_ResourcesResolved = false;
+
+    u32 m_ChunkCount = 0;
+    u32 m_CommittedChunks = 0;
+    std::chrono::steady_clock::time_point m_StartTime;
+    Stats m_Stats;
+};
+
+} // namespace Engine
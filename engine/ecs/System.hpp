@@ -2,6 +2,10 @@
 
 #include <entt/entt.hpp>
 #include "core/Types.hpp"
+#include "ecs/Registry.hpp"
+#include "ecs/ChangeTracking.hpp"
+#include <algorithm>
+#include <chrono>
 
 namespace Engine {
 
@@ -14,8 +18,8 @@ enum class SystemPhase : u8 {
     Physics,          // Physics simulation
     PostPhysics,      // Physics response
     PreRender,        // Culling, LOD calculations
-    Render,           // Actual rendering
-    PostRender,       // UI, debug rendering
+    Render,           // Actual rendering; not run with a render thread
+    PostRender,       // UI, debug rendering; not run with a render thread
     Count             // Number of phases
 };
 
@@ -35,6 +39,100 @@ inline const char* SystemPhaseToString(SystemPhase phase) {
     }
 }
 
+// Component access declared by a system. The scheduler uses it to find
+// systems within a phase that can safely run concurrently.
+class SystemAccess {
+public:
+    template<typename... Components>
+    SystemAccess& Read() {
+        (AddComponent<Components>(m_Reads), ...);
+        return *this;
+    }
+
+    template<typename... Components>
+    SystemAccess& Write() {
+        (AddComponent<Components>(m_Writes), ...);
+        return *this;
+    }
+
+    // System touches GL state, windows or ImGui and must run on the main thread
+    SystemAccess& MainThread() {
+        m_MainThread = true;
+        return *this;
+    }
+
+    // System conflicts with every other system in its phase.
+    // Required for systems that create/destroy entities or touch undeclared
+    // state, unless they record the structural changes in GetCommandBuffer().
+    SystemAccess& Exclusive() {
+        m_Exclusive = true;
+        return *this;
+    }
+
+    bool IsMainThread() const { return m_MainThread; }
+    bool IsExclusive() const { return m_Exclusive; }
+
+    // Two systems conflict if either writes a component the other reads or writes
+    bool ConflictsWith(const SystemAccess& other) const {
+        if (m_Exclusive || other.m_Exclusive) return true;
+
+        return Intersects(m_Writes, other.m_Reads) ||
+               Intersects(m_Writes, other.m_Writes) ||
+               Intersects(other.m_Writes, m_Reads);
+    }
+
+    // Create component pools up front so concurrent views never insert into the registry
+    void PrepareStorage(entt::registry& registry) const {
+        for (const auto& component : m_Reads) component.EnsureStorage(registry);
+        for (const auto& component : m_Writes) component.EnsureStorage(registry);
+    }
+
+    void Reset() {
+        m_Reads.clear();
+        m_Writes.clear();
+        m_MainThread = false;
+        m_Exclusive = false;
+    }
+
+private:
+    struct ComponentAccess {
+        entt::id_type TypeId;
+        void (*EnsureStorage)(entt::registry&);
+    };
+
+    template<typename T>
+    static void AddComponent(Vector<ComponentAccess>& list) {
+        list.push_back({
+            entt::type_hash<T>::value(),
+            [](entt::registry& registry) { (void)registry.storage<T>(); }
+        });
+    }
+
+    static bool Intersects(const Vector<ComponentAccess>& a, const Vector<ComponentAccess>& b) {
+        for (const auto& lhs : a) {
+            for (const auto& rhs : b) {
+                if (lhs.TypeId == rhs.TypeId) return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    Vector<ComponentAccess> m_Reads;
+    Vector<ComponentAccess> m_Writes;
+    bool m_MainThread = false;
+    bool m_Exclusive = false;
+};
+
+// Per-frame CPU budget of an amortized system, declared with
+// SYSTEM_AMORTIZED. Work that does not fit is resumed next frame.
+struct SystemBudget {
+    f32 MinMs = 0.0f;       // Always granted, so the work keeps progressing
+    f32 MaxMs = 0.0f;       // 0 = not amortized
+
+    bool IsAmortized() const { return MaxMs > 0.0f; }
+};
+
 // Base interface for all systems
 class ISystem {
 public:
@@ -51,12 +149,58 @@ public:
     virtual const char* GetName() const = 0;
     virtual SystemPhase GetPhase() const = 0;
 
-    // Priority within phase (lower = executed first)
+    // Priority within phase (lower = executed first).
+    // Only enforced between systems whose declared access conflicts.
     virtual u32 GetPriority() const { return 100; }
 
+    // Component access used for parallel scheduling. Systems that do not
+    // declare anything stay exclusive and on the main thread.
+    virtual void DeclareAccess(SystemAccess& access) const {
+        access.Exclusive().MainThread();
+    }
+
+    // Components whose changes Changes<T>() reports; see SYSTEM_REACTS_TO
+    virtual void DeclareReactive(ReactiveAccess& access) const { (void)access; }
+
+    // Budget for work spread over frames; see SYSTEM_AMORTIZED
+    virtual void DeclareBudget(SystemBudget& budget) const { (void)budget; }
+
     // Hot-reload callback
     virtual void OnReload() {}
 
+    // What drivers call (SystemScheduler, or code running a system by hand)
+    // instead of the On* hooks, so change tracking is connected before
+    // OnCreate and the change sets rotate before every OnUpdate
+    void Create(entt::registry& registry) {
+        m_Budget = {};
+        DeclareBudget(m_Budget);
+        m_SliceBudgetMs = m_Budget.MaxMs;
+        m_Reactive = {};
+        DeclareReactive(m_Reactive);
+        m_Reactive.Connect(registry);
+        OnCreate(registry);
+    }
+
+    void Destroy(entt::registry& registry) {
+        OnDestroy(registry);
+        m_Reactive.Disconnect(registry);
+    }
+
+    void Update(entt::registry& registry, f32 deltaTime) {
+        m_Reactive.Rotate();
+        m_SliceDeadline = std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<f32, std::milli>(m_SliceBudgetMs));
+        OnUpdate(registry, deltaTime);
+    }
+
+    // Amortization. The scheduler hands out slice budgets within
+    // [MinMs, MaxMs]; systems run by hand get MaxMs.
+    const SystemBudget& GetBudget() const { return m_Budget; }
+    bool IsAmortized() const { return m_Budget.IsAmortized(); }
+    f32 GetSliceBudget() const { return m_SliceBudgetMs; }
+    void SetSliceBudget(f32 ms) { m_SliceBudgetMs = std::clamp(ms, m_Budget.MinMs, m_Budget.MaxMs); }
+
     // Enable/disable system
     bool IsEnabled() const { return m_Enabled; }
     void SetEnabled(bool enabled) { m_Enabled = enabled; }
@@ -66,8 +210,67 @@ public:
     void SetLastExecutionTime(f32 time) { m_LastExecutionTime = time; }
 
 protected:
+    // Entities whose T was added, patched or removed between the start of
+    // the previous Update() and the start of this one. T must be declared in
+    // SYSTEM_REACTS_TO.
+    template<typename T>
+    const ChangeSet& Changes() const {
+        static const ChangeSet none;
+        const ChangeSet* set = m_Reactive.Find<T>();
+        return set ? *set : none;
+    }
+
+    // The slice of this Update() has run out (always false for systems
+    // that are not amortized)
+    bool IsSliceExpired() const {
+        return IsAmortized() && std::chrono::steady_clock::now() >= m_SliceDeadline;
+    }
+
+    // Run func(i) for i in [0, count), resuming where the previous Update()
+    // stopped and stopping when the slice runs out; the clock is read once
+    // per batch. Wraps around to 0 after the last item. Returns true if a
+    // full pass ended during this call. Not amortized: one full pass.
+    template<typename Func>
+    bool ForEachInSlice(u32 count, Func&& func, u32 batchSize = 64) {
+        if (!IsAmortized()) {
+            for (u32 i = 0; i < count; ++i) func(i);
+            m_SliceCursor = 0;
+            return true;
+        }
+
+        if (count == 0) return true;
+        if (m_SliceCursor >= count) m_SliceCursor = 0;
+        u32 done = 0;
+        bool wrapped = false;
+        while (done < count) {
+            const u32 batch = std::min(batchSize, count - done);
+            for (u32 n = 0; n < batch; ++n) {
+                func(m_SliceCursor);
+                if (++m_SliceCursor == count) {
+                    m_SliceCursor = 0;
+                    wrapped = true;
+                }
+            }
+            done += batch;
+            if (IsSliceExpired()) break;
+        }
+        return wrapped;
+    }
+
+    // Start the next ForEachInSlice() from the first item
+    void ResetSliceCursor() { m_SliceCursor = 0; }
+    u32 GetSliceCursor() const { return m_SliceCursor; }
+
     bool m_Enabled = true;
     f32 m_LastExecutionTime = 0.0f;
+
+private:
+    ReactiveAccess m_Reactive;
+
+    SystemBudget m_Budget;
+    f32 m_SliceBudgetMs = 0.0f;
+    std::chrono::steady_clock::time_point m_SliceDeadline{};
+    u32 m_SliceCursor = 0;      // Persists across frames
 };
 
 // Helper macro to define system metadata quickly
@@ -76,6 +279,23 @@ protected:
     SystemPhase GetPhase() const override { return SystemPhase::Phase; } \
     u32 GetPriority() const override { return Priority; }
 
+// Declare component access for parallel scheduling
+// Usage: SYSTEM_ACCESS(.Read<Transform, MeshComponent>()
+//                      .Write<Renderable>())
+#define SYSTEM_ACCESS(...) \
+    void DeclareAccess(Engine::SystemAccess& access) const override { access __VA_ARGS__; }
+
+// Track changes of components for Changes<T>()
+// Usage: SYSTEM_REACTS_TO(Transform, Renderable)
+#define SYSTEM_REACTS_TO(...) \
+    void DeclareReactive(Engine::ReactiveAccess& access) const override { access.Track<__VA_ARGS__>(); }
+
+// Spread the system's work over frames within a CPU budget (milliseconds);
+// iterate with ForEachInSlice() in OnUpdate
+// Usage: SYSTEM_AMORTIZED(0.25f, 2.0f)
+#define SYSTEM_AMORTIZED(minMs, maxMs) \
+    void DeclareBudget(Engine::SystemBudget& budget) const override { budget.MinMs = minMs; budget.MaxMs = maxMs; }
+
 // Template base for systems that need specific component access
 template<typename... Components>
 class System : public ISystem {
@@ -88,12 +308,10 @@ protected:
         return registry.view<Components...>();
     }
 
-    // Parallel iteration helper
+    // Parallel iteration helper - splits the view across JobSystem workers
     template<typename Func>
-    void ParallelEach(entt::registry& registry, Func&& func) {
-        auto view = GetView(registry);
-        // Note: For true parallelism, integrate with JobSystem
-        view.each(std::forward<Func>(func));
+    void ParallelEach(entt::registry& registry, Func&& func, u32 grainSize = 256) {
+        Engine::ParallelEach<Components...>(registry, std::forward<Func>(func), grainSize);
     }
 };
 
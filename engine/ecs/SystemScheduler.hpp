@@ -1,15 +1,26 @@
 #pragma once
 
 #include "System.hpp"
+#include "EntityCommandBuffer.hpp"
 #include "core/Types.hpp"
 #include "core/Logger.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Profiler.hpp"
+#include "core/Telemetry.hpp"
 #include <algorithm>
 #include <chrono>
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 
 namespace Engine {
 
-// Manages system execution order and lifecycle
+// Manages system execution order and lifecycle.
+// Each phase is turned into a dependency graph from the systems' declared
+// component access: conflicting systems run in priority order, independent
+// ones run concurrently on the JobSystem workers.
 class SystemScheduler {
 public:
     SystemScheduler() = default;
@@ -28,6 +39,10 @@ public:
         phaseList.push_back(std::move(system));
 
         SortPhase(phase);
+        m_Graphs[static_cast<usize>(phase)].Dirty = true;
+
+        const String gaugeName = String("System.") + ptr->GetName() + ".Ms";
+        m_SystemGauges.push_back({ptr, TelemetryGauge(gaugeName.c_str())});
 
         LOG_CORE_INFO("Added system '{}' to phase {} with priority {}",
                       ptr->GetName(),
@@ -50,6 +65,8 @@ public:
         if (it != phaseList.end()) {
             LOG_CORE_INFO("Removed system '{}'", system->GetName());
             phaseList.erase(it);
+            m_Graphs[static_cast<usize>(phase)].Dirty = true;
+            std::erase_if(m_SystemGauges, [system](const auto& entry) { return entry.first == system; });
         }
     }
 
@@ -68,9 +85,12 @@ public:
 
     // Initialize all systems
     void Initialize(entt::registry& registry) {
+        m_CommandBuffers.Resize();
+        registry.ctx().insert_or_assign(&m_CommandBuffers);
+
         for (auto& phaseList : m_Systems) {
             for (auto& system : phaseList) {
-                system->OnCreate(registry);
+                system->Create(registry);
             }
         }
         m_Initialized = true;
@@ -82,14 +102,23 @@ public:
         for (i32 phase = static_cast<i32>(SystemPhase::Count) - 1; phase >= 0; --phase) {
             auto& phaseList = m_Systems[phase];
             for (auto it = phaseList.rbegin(); it != phaseList.rend(); ++it) {
-                (*it)->OnDestroy(registry);
+                (*it)->Destroy(registry);
             }
         }
+        m_CommandBuffers.Playback(registry);
+        registry.ctx().erase<ThreadCommandBuffers*>();
         m_Initialized = false;
     }
 
+    // Hand out this frame's amortized slices; call once a frame before the
+    // first phase when driving phases with UpdatePhase (Update does it)
+    void BeginFrame() {
+        BalanceBudgets();
+    }
+
     // Update all systems in order
     void Update(entt::registry& registry, f32 deltaTime) {
+        BeginFrame();
         for (u8 phase = 0; phase < static_cast<u8>(SystemPhase::Count); ++phase) {
             UpdatePhase(registry, static_cast<SystemPhase>(phase), deltaTime);
         }
@@ -98,17 +127,44 @@ public:
     // Update only a specific phase
     void UpdatePhase(entt::registry& registry, SystemPhase phase, f32 deltaTime) {
         auto& phaseList = m_Systems[static_cast<usize>(phase)];
+        if (phaseList.empty()) return;
 
-        for (auto& system : phaseList) {
-            if (!system->IsEnabled()) continue;
+        auto& graph = m_Graphs[static_cast<usize>(phase)];
+        if (graph.Dirty) {
+            BuildGraph(phase);
+        }
 
-            auto start = std::chrono::high_resolution_clock::now();
+        bool parallel = m_ParallelExecution && graph.HasParallelism &&
+                        JobSystem::GetWorkerCount() > 0;
+        if (parallel) {
+            ExecuteGraph(phase, registry, deltaTime);
+        } else {
+            for (auto& system : phaseList) {
+                if (!system->IsEnabled()) continue;
+                RunSystem(*system, registry, deltaTime);
+            }
+        }
 
-            system->OnUpdate(registry, deltaTime);
+        // Sync point: structural changes recorded during the phase
+        PROFILE_SCOPE("CommandBufferPlayback");
+        m_CommandBuffers.Playback(registry);
+    }
 
-            auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration<f32, std::milli>(end - start).count();
-            system->SetLastExecutionTime(duration);
+    // Run independent systems on worker threads (enabled by default)
+    void SetParallelExecution(bool enabled) { m_ParallelExecution = enabled; }
+    bool IsParallelExecution() const { return m_ParallelExecution; }
+
+    // CPU time target (ms) for one Update() of every phase. Amortized
+    // systems share what the other systems took less than this last frame,
+    // in proportion to their MaxMs and never below their MinMs.
+    // 0 = no target, every amortized system gets its MaxMs.
+    void SetFrameTimeTarget(f32 ms) { m_FrameTimeTargetMs = std::max(ms, 0.0f); }
+    f32 GetFrameTimeTarget() const { return m_FrameTimeTargetMs; }
+
+    // Force dependency graphs to be rebuilt (e.g. after a system changed its access)
+    void InvalidateGraphs() {
+        for (auto& graph : m_Graphs) {
+            graph.Dirty = true;
         }
     }
 
@@ -125,12 +181,21 @@ public:
     struct Statistics {
         u32 TotalSystems = 0;
         u32 EnabledSystems = 0;
+        u32 WorkerThreads = 0;
+        u32 AmortizedSystems = 0;
         f32 TotalExecutionTime = 0.0f;
-        HashMap<String, f32> SystemExecutionTimes;
+        f32 AmortizedBudget = 0.0f;     // Sum of the slices handed out this frame
+        Vector<std::pair<const char*, f32>> SystemExecutionTimes;  // ISystem::GetName, in phase order
     };
 
-    Statistics GetStatistics() const {
-        Statistics stats;
+    // Fills stats, reusing its storage: no allocation once it has grown
+    void GetStatistics(Statistics& stats) const {
+        auto times = std::move(stats.SystemExecutionTimes);
+        times.clear();
+        stats = {};
+        stats.SystemExecutionTimes = std::move(times);
+        stats.WorkerThreads = m_ParallelExecution ? JobSystem::GetWorkerCount() : 0;
+        stats.AmortizedBudget = m_AmortizedBudgetMs;
 
         for (const auto& phaseList : m_Systems) {
             for (const auto& system : phaseList) {
@@ -138,15 +203,30 @@ public:
                 if (system->IsEnabled()) {
                     ++stats.EnabledSystems;
                 }
+                if (system->IsAmortized()) {
+                    ++stats.AmortizedSystems;
+                }
                 f32 execTime = system->GetLastExecutionTime();
                 stats.TotalExecutionTime += execTime;
-                stats.SystemExecutionTimes[system->GetName()] = execTime;
+                stats.SystemExecutionTimes.emplace_back(system->GetName(), execTime);
             }
         }
+    }
 
+    Statistics GetStatistics() const {
+        Statistics stats;
+        GetStatistics(stats);
         return stats;
     }
 
+    // Set the System.<Name>.Ms telemetry gauges from the last execution
+    // times; once a frame, before Telemetry::EndFrame
+    void PublishTelemetry() const {
+        for (const auto& [system, gauge] : m_SystemGauges) {
+            gauge.Set(system->IsEnabled() ? system->GetLastExecutionTime() : 0.0f);
+        }
+    }
+
     // Iterate over all systems
     template<typename Func>
     void ForEachSystem(Func&& func) {
@@ -169,17 +249,239 @@ public:
     bool IsInitialized() const { return m_Initialized; }
 
 private:
+    // Per-phase dependency graph, rebuilt whenever systems are added or removed
+    struct PhaseGraph {
+        Vector<SystemAccess> Access;
+        Vector<Vector<u32>> Dependents;
+        Vector<u32> DependencyCount;
+        bool HasParallelism = false;
+        bool Dirty = true;
+    };
+
     void SortPhase(SystemPhase phase) {
         auto& phaseList = m_Systems[static_cast<usize>(phase)];
-        std::sort(phaseList.begin(), phaseList.end(),
+        std::stable_sort(phaseList.begin(), phaseList.end(),
             [](const Scope<ISystem>& a, const Scope<ISystem>& b) {
                 return a->GetPriority() < b->GetPriority();
             });
     }
 
+    void BuildGraph(SystemPhase phase) {
+        auto& phaseList = m_Systems[static_cast<usize>(phase)];
+        auto& graph = m_Graphs[static_cast<usize>(phase)];
+        const u32 count = static_cast<u32>(phaseList.size());
+
+        graph.Access.assign(count, SystemAccess{});
+        graph.Dependents.assign(count, {});
+        graph.DependencyCount.assign(count, 0);
+        graph.HasParallelism = false;
+
+        for (u32 i = 0; i < count; ++i) {
+            phaseList[i]->DeclareAccess(graph.Access[i]);
+        }
+
+        // Systems are sorted by priority, so an edge from every earlier
+        // conflicting system preserves the existing ordering guarantees
+        for (u32 j = 0; j < count; ++j) {
+            for (u32 i = 0; i < j; ++i) {
+                if (graph.Access[i].ConflictsWith(graph.Access[j])) {
+                    graph.Dependents[i].push_back(j);
+                    ++graph.DependencyCount[j];
+                }
+            }
+        }
+
+        // Parallel dispatch only pays off if two independent systems can
+        // overlap and at least one of them may leave the main thread
+        for (u32 j = 0; j < count && !graph.HasParallelism; ++j) {
+            for (u32 i = 0; i < j; ++i) {
+                bool offMainThread = !graph.Access[i].IsMainThread() ||
+                                     !graph.Access[j].IsMainThread();
+                if (offMainThread && !graph.Access[i].ConflictsWith(graph.Access[j])) {
+                    graph.HasParallelism = true;
+                    break;
+                }
+            }
+        }
+
+        graph.Dirty = false;
+    }
+
+    // Hand out this frame's slices from last frame's measured times. Systems
+    // that overlapped on workers are summed as if sequential, which errs on
+    // the side of smaller slices.
+    void BalanceBudgets() {
+        f32 fixedMs = 0.0f;
+        f32 requestedMs = 0.0f;
+        for (const auto& phaseList : m_Systems) {
+            for (const auto& system : phaseList) {
+                if (!system->IsEnabled()) continue;
+                if (system->IsAmortized()) {
+                    requestedMs += system->GetBudget().MaxMs;
+                } else {
+                    fixedMs += system->GetLastExecutionTime();
+                }
+            }
+        }
+
+        m_AmortizedBudgetMs = 0.0f;
+        if (requestedMs <= 0.0f) return;
+
+        f32 scale = 1.0f;
+        if (m_FrameTimeTargetMs > 0.0f) {
+            scale = std::clamp((m_FrameTimeTargetMs - fixedMs) / requestedMs, 0.0f, 1.0f);
+        }
+
+        for (auto& phaseList : m_Systems) {
+            for (auto& system : phaseList) {
+                if (!system->IsEnabled() || !system->IsAmortized()) continue;
+                system->SetSliceBudget(system->GetBudget().MaxMs * scale);
+                m_AmortizedBudgetMs += system->GetSliceBudget();
+            }
+        }
+    }
+
+    void RunSystem(ISystem& system, entt::registry& registry, f32 deltaTime) {
+        PROFILE_SCOPE(system.GetName());
+        auto start = std::chrono::high_resolution_clock::now();
+
+        system.Update(registry, deltaTime);
+
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration<f32, std::milli>(end - start).count();
+        system.SetLastExecutionTime(duration);
+    }
+
+    void ExecuteGraph(SystemPhase phase, entt::registry& registry, f32 deltaTime) {
+        auto& phaseList = m_Systems[static_cast<usize>(phase)];
+        auto& graph = m_Graphs[static_cast<usize>(phase)];
+        const u32 count = static_cast<u32>(phaseList.size());
+
+        // Pools must exist before workers start or views would mutate the registry
+        for (const auto& access : graph.Access) {
+            access.PrepareStorage(registry);
+        }
+
+        if (m_RemainingCapacity < count) {
+            m_Remaining = CreateScope<std::atomic<u32>[]>(count);
+            m_RemainingCapacity = count;
+        }
+        for (u32 i = 0; i < count; ++i) {
+            m_Remaining[i].store(graph.DependencyCount[i], std::memory_order_relaxed);
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_ReadyMutex);
+            m_Completed = 0;
+            m_MainThreadQueue.clear();
+        }
+
+        m_ActivePhase = &phaseList;
+        m_ActiveGraph = &graph;
+        m_ActiveRegistry = &registry;
+        m_ActiveDeltaTime = deltaTime;
+
+        for (u32 i = 0; i < count; ++i) {
+            if (graph.DependencyCount[i] == 0) {
+                Dispatch(i);
+            }
+        }
+
+        // The main thread runs main-thread systems and helps with worker jobs
+        // until every system in the phase has completed
+        while (true) {
+            u32 next = 0;
+            bool hasMainThreadWork = false;
+            {
+                std::lock_guard<std::mutex> lock(m_ReadyMutex);
+                if (m_Completed >= count) break;
+                if (!m_MainThreadQueue.empty()) {
+                    next = m_MainThreadQueue.front();
+                    m_MainThreadQueue.pop_front();
+                    hasMainThreadWork = true;
+                }
+            }
+
+            if (hasMainThreadWork) {
+                RunSystem(*phaseList[next], registry, deltaTime);
+                Complete(next);
+                continue;
+            }
+
+            if (JobSystem::TryRunPendingJob()) continue;
+
+            std::unique_lock<std::mutex> lock(m_ReadyMutex);
+            m_ReadyCondition.wait_for(lock, std::chrono::microseconds(200), [&] {
+                return !m_MainThreadQueue.empty() || m_Completed >= count;
+            });
+        }
+
+        m_ActivePhase = nullptr;
+        m_ActiveGraph = nullptr;
+        m_ActiveRegistry = nullptr;
+    }
+
+    void Dispatch(u32 index) {
+        ISystem& system = *(*m_ActivePhase)[index];
+
+        // Disabled systems complete immediately but still release their dependents
+        if (!system.IsEnabled()) {
+            Complete(index);
+            return;
+        }
+
+        if (m_ActiveGraph->Access[index].IsMainThread()) {
+            {
+                std::lock_guard<std::mutex> lock(m_ReadyMutex);
+                m_MainThreadQueue.push_back(index);
+            }
+            m_ReadyCondition.notify_all();
+            return;
+        }
+
+        JobSystem::Submit([this, index]() {
+            RunSystem(*(*m_ActivePhase)[index], *m_ActiveRegistry, m_ActiveDeltaTime);
+            Complete(index);
+        });
+    }
+
+    void Complete(u32 index) {
+        for (u32 dependent : m_ActiveGraph->Dependents[index]) {
+            if (m_Remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                Dispatch(dependent);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_ReadyMutex);
+        ++m_Completed;
+        m_ReadyCondition.notify_all();
+    }
+
 private:
     std::array<Vector<Scope<ISystem>>, static_cast<usize>(SystemPhase::Count)> m_Systems;
+    std::array<PhaseGraph, static_cast<usize>(SystemPhase::Count)> m_Graphs;
     bool m_Initialized = false;
+    bool m_ParallelExecution = true;
+
+    f32 m_FrameTimeTargetMs = 0.0f;
+    f32 m_AmortizedBudgetMs = 0.0f;
+
+    Vector<std::pair<const ISystem*, TelemetryGauge>> m_SystemGauges;
+
+    // Per-thread structural changes, played back after every phase
+    ThreadCommandBuffers m_CommandBuffers;
+
+    // Execution state of the phase currently being run in parallel
+    Scope<std::atomic<u32>[]> m_Remaining;
+    u32 m_RemainingCapacity = 0;
+    std::mutex m_ReadyMutex;
+    u32 m_Completed = 0;                    // Guarded by m_ReadyMutex, like the queue
+    std::condition_variable m_ReadyCondition;
+    std::deque<u32> m_MainThreadQueue;
+
+    Vector<Scope<ISystem>>* m_ActivePhase = nullptr;
+    PhaseGraph* m_ActiveGraph = nullptr;
+    entt::registry* m_ActiveRegistry = nullptr;
+    f32 m_ActiveDeltaTime = 0.0f;
 };
 
 } // namespace Engine
@@ -0,0 +1,57 @@
+#include "ecs/TransformInterpolationSystem.hpp"
+#include "core/Time.hpp"
+
+namespace Engine {
+
+void TransformInterpolationSystem::CaptureState(entt::registry& registry) {
+    registry.view<const Transform, TransformInterpolation>().each(
+        [](const Transform& transform, TransformInterpolation& interpolation) {
+            interpolation.PreviousPosition = transform.Position;
+            interpolation.PreviousRotation = transform.Rotation;
+            interpolation.PreviousScale = transform.Scale;
+            interpolation.Valid = true;
+        });
+}
+
+void TransformInterpolationSystem::OnUpdate(entt::registry& registry, f32 deltaTime) {
+    (void)deltaTime;
+
+    // Without a fixed step every frame simulates and the Transform is current
+    if (Time::GetSimulationStep() <= 0.0f) return;
+
+    const f32 alpha = Time::GetSimulationAlpha();
+    auto& transforms = registry.storage<Transform>();
+    auto& hierarchies = registry.storage<Hierarchy>();
+
+    auto& previous = registry.storage<PreviousWorldTransform>();
+
+    registry.view<Transform, TransformInterpolation>().each(
+        [&](entt::entity entity, Transform& transform, TransformInterpolation& interpolation) {
+            if (!interpolation.Valid) return;
+
+            const glm::vec3 position = glm::mix(interpolation.PreviousPosition, transform.Position, alpha);
+            const glm::quat rotation = glm::slerp(interpolation.PreviousRotation, transform.Rotation, alpha);
+            const glm::vec3 scale = glm::mix(interpolation.PreviousScale, transform.Scale, alpha);
+
+            glm::mat4 local = glm::translate(glm::mat4(1.0f), position);
+            local *= glm::mat4_cast(rotation);
+            local = glm::scale(local, scale);
+
+            const Hierarchy* hierarchy = hierarchies.contains(entity) ? &hierarchies.get(entity) : nullptr;
+            if (hierarchy && hierarchy->HasParent() && transforms.contains(hierarchy->Parent)) {
+                transform.WorldMatrix = transforms.get(hierarchy->Parent).WorldMatrix * local;
+            } else {
+                transform.WorldMatrix = local;
+            }
+
+            // TransformSystem only sees the simulated matrix; motion vectors
+            // need the one drawn last frame
+            if (interpolation.Drawn && previous.contains(entity)) {
+                previous.get(entity).Matrix = interpolation.DrawnMatrix;
+            }
+            interpolation.DrawnMatrix = transform.WorldMatrix;
+            interpolation.Drawn = true;
+        });
+}
+
+} // namespace Engine
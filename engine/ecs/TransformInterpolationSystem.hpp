@@ -0,0 +1,36 @@
+#pragma once
+
+#include "ecs/System.hpp"
+#include "ecs/Components/Transform.hpp"
+#include "ecs/Components/Hierarchy.hpp"
+
+namespace Engine {
+
+// TransformInterpolationSystem - draws fixed-step bodies between simulated
+// states.
+//
+// When the physics phases run at Time::GetSimulationStep() and rendering
+// runs faster, a Transform only moves on the frames that step, so motion
+// stutters. Application calls CaptureState() before each step; this system
+// then rewrites WorldMatrix from the captured and the latest Position /
+// Rotation / Scale, blended by Time::GetSimulationAlpha(), right before
+// culling. Position and friends keep the simulated values.
+//
+// Applies to entities with a TransformInterpolation component. The matrix is
+// placed under the parent's current world matrix; children of an
+// interpolated entity are not re-resolved and show its simulated state.
+// The PreviousWorldTransform of a smoothed entity is the matrix this system
+// drew last frame.
+class TransformInterpolationSystem : public ISystem {
+public:
+    DEFINE_SYSTEM(TransformInterpolationSystem, PreRender, 0)
+    SYSTEM_ACCESS(.Read<Hierarchy>()
+                  .Write<Transform, TransformInterpolation, PreviousWorldTransform>())
+
+    void OnUpdate(entt::registry& registry, f32 deltaTime) override;
+
+    // Remember the current state as the one before the next step
+    static void CaptureState(entt::registry& registry);
+};
+
+} // namespace Engine
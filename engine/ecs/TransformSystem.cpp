@@ -0,0 +1,620 @@
+#include "ecs/TransformSystem.hpp"
+#include "core/JobSystem.hpp"
+#include "math/TransformKernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+namespace Engine {
+
+namespace {
+
+// Dirty transforms are gathered into SoA streams and composed with the SIMD
+// TRS kernel. Roots are written straight into their world matrix; children compose
+// their local matrix first and are then multiplied by the parent's world.
+struct ComposeBatch {
+    static constexpr usize Capacity = 64;
+
+    f32 PositionX[Capacity], PositionY[Capacity], PositionZ[Capacity];
+    f32 RotationX[Capacity], RotationY[Capacity], RotationZ[Capacity], RotationW[Capacity];
+    f32 ScaleX[Capacity], ScaleY[Capacity], ScaleZ[Capacity];
+
+    glm::mat4 Locals[Capacity];
+    glm::mat4* Outputs[Capacity];
+    glm::mat4* Worlds[Capacity];
+    const glm::mat4* Parents[Capacity];
+    usize Count = 0;
+
+    void Add(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale,
+             glm::mat4* world, const glm::mat4* parent) {
+        const usize i = Count++;
+        PositionX[i] = position.x;
+        PositionY[i] = position.y;
+        PositionZ[i] = position.z;
+        RotationX[i] = rotation.x;
+        RotationY[i] = rotation.y;
+        RotationZ[i] = rotation.z;
+        RotationW[i] = rotation.w;
+        ScaleX[i] = scale.x;
+        ScaleY[i] = scale.y;
+        ScaleZ[i] = scale.z;
+
+        Worlds[i] = world;
+        Parents[i] = parent;
+        Outputs[i] = parent ? &Locals[i] : world;
+    }
+
+    void Flush() {
+        if (Count == 0) return;
+
+        TRSStreams streams{PositionX, PositionY, PositionZ,
+                           RotationX, RotationY, RotationZ, RotationW,
+                           ScaleX, ScaleY, ScaleZ};
+        TransformKernels::ComposeTRS(streams, Outputs, Count);
+
+        for (usize i = 0; i < Count; ++i) {
+            if (Parents[i]) {
+                *Worlds[i] = *Parents[i] * Locals[i];
+            }
+        }
+
+        Count = 0;
+    }
+};
+
+} // anonymous namespace
+
+void TransformSystem::OnCreate(entt::registry& registry) {
+    registry.on_construct<Transform>().connect<&TransformSystem::OnStructureChanged>(this);
+    registry.on_destroy<Transform>().connect<&TransformSystem::OnStructureChanged>(this);
+    registry.on_construct<Hierarchy>().connect<&TransformSystem::OnStructureChanged>(this);
+    registry.on_update<Hierarchy>().connect<&TransformSystem::OnHierarchyPatched>(this);
+    registry.on_destroy<Hierarchy>().connect<&TransformSystem::OnStructureChanged>(this);
+    registry.on_construct<LocalTransform>().connect<&TransformSystem::OnStructureChanged>(this);
+    registry.on_destroy<LocalTransform>().connect<&TransformSystem::OnStructureChanged>(this);
+    registry.on_construct<MeshComponent>().connect<&TransformSystem::OnMeshChanged>(this);
+    registry.on_update<MeshComponent>().connect<&TransformSystem::OnMeshChanged>(this);
+    registry.on_destroy<MeshComponent>().connect<&TransformSystem::OnMeshChanged>(this);
+    m_Connected = true;
+    m_LevelsDirty = true;
+}
+
+void TransformSystem::OnDestroy(entt::registry& registry) {
+    if (!m_Connected) return;
+
+    registry.on_construct<Transform>().disconnect<&TransformSystem::OnStructureChanged>(this);
+    registry.on_destroy<Transform>().disconnect<&TransformSystem::OnStructureChanged>(this);
+    registry.on_construct<Hierarchy>().disconnect<&TransformSystem::OnStructureChanged>(this);
+    registry.on_update<Hierarchy>().disconnect<&TransformSystem::OnHierarchyPatched>(this);
+    registry.on_destroy<Hierarchy>().disconnect<&TransformSystem::OnStructureChanged>(this);
+    registry.on_construct<LocalTransform>().disconnect<&TransformSystem::OnStructureChanged>(this);
+    registry.on_destroy<LocalTransform>().disconnect<&TransformSystem::OnStructureChanged>(this);
+    registry.on_construct<MeshComponent>().disconnect<&TransformSystem::OnMeshChanged>(this);
+    registry.on_update<MeshComponent>().disconnect<&TransformSystem::OnMeshChanged>(this);
+    registry.on_destroy<MeshComponent>().disconnect<&TransformSystem::OnMeshChanged>(this);
+    m_Connected = false;
+}
+
+void TransformSystem::OnStructureChanged(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    (void)entity;
+    m_LevelsDirty = true;
+}
+
+void TransformSystem::OnHierarchyPatched(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    m_Reparented.push_back(entity);
+}
+
+void TransformSystem::OnMeshChanged(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    (void)entity;
+    m_SubtreeMeshesDirty = true;
+}
+
+void TransformSystem::SetSortStorage(bool enabled) {
+    if (enabled && !m_SortStorage) {
+        m_LevelsDirty = true;   // The rebuild sorts
+    }
+    m_SortStorage = enabled;
+}
+
+void TransformSystem::SetSubtreeBounds(bool enabled) {
+    if (enabled && !m_SubtreeBoundsEnabled) {
+        m_SubtreeStructureDirty = true;
+    }
+    m_SubtreeBoundsEnabled = enabled;
+}
+
+void TransformSystem::SubmitEdit(const Vector<entt::entity>& entities, const TransformEdit& edit) {
+    if (entities.empty()) return;
+    m_Edits.push_back({entities, edit});
+}
+
+void TransformSystem::ApplyEdits(entt::registry& registry) {
+    auto& transforms = registry.storage<Transform>();
+    auto& locals = registry.storage<LocalTransform>();
+    auto& worlds = registry.storage<WorldTransform>();
+    auto& hierarchies = registry.storage<Hierarchy>();
+    Vector<entt::entity> sorted;
+    Vector<u8> dirtySoA;
+
+    for (const PendingEdit& pending : m_Edits) {
+        const u32 count = static_cast<u32>(pending.Entities.size());
+        const TransformEdit& edit = pending.Edit;
+
+        sorted.assign(pending.Entities.begin(), pending.Entities.end());
+        std::sort(sorted.begin(), sorted.end());
+        dirtySoA.assign(count, 0);
+
+        auto parentOf = [&](entt::entity entity) {
+            return hierarchies.contains(entity) ? hierarchies.get(entity).Parent : entt::entity{entt::null};
+        };
+
+        // Storages are only read or written in place here, never resized
+        JobSystem::ParallelFor(count, 256, [&](u32 first, u32 last) {
+            for (u32 i = first; i < last; ++i) {
+                const entt::entity entity = pending.Entities[i];
+                const bool soa = !transforms.contains(entity);
+                if (soa && !(locals.contains(entity) && worlds.contains(entity))) continue;
+
+                const entt::entity parent = parentOf(entity);
+                bool followsAncestor = false;
+                for (entt::entity ancestor = parent; ancestor != entt::null; ancestor = parentOf(ancestor)) {
+                    if (std::binary_search(sorted.begin(), sorted.end(), ancestor)) {
+                        followsAncestor = true;
+                        break;
+                    }
+                }
+                if (followsAncestor) continue;
+
+                // Bring the delta into the parent's space
+                glm::vec3 translation = edit.Translation;
+                glm::quat rotation = edit.Rotation;
+                const glm::mat4* parentWorld = nullptr;
+                if (transforms.contains(parent)) {
+                    parentWorld = &transforms.get(parent).WorldMatrix;
+                } else if (worlds.contains(parent)) {
+                    parentWorld = &worlds.get(parent).Matrix;
+                }
+                if (parentWorld) {
+                    const glm::mat3 linear(*parentWorld);
+                    const glm::quat parentRotation = glm::quat_cast(glm::mat3(
+                        glm::normalize(linear[0]), glm::normalize(linear[1]), glm::normalize(linear[2])));
+                    translation = glm::inverse(linear) * translation;
+                    rotation = glm::inverse(parentRotation) * rotation * parentRotation;
+                }
+
+                glm::vec3& position = soa ? locals.get(entity).Position : transforms.get(entity).Position;
+                glm::quat& localRotation = soa ? locals.get(entity).Rotation : transforms.get(entity).Rotation;
+                glm::vec3& scale = soa ? locals.get(entity).Scale : transforms.get(entity).Scale;
+                position += translation;
+                localRotation = glm::normalize(rotation * localRotation);
+                scale *= edit.Scale;
+
+                if (soa) {
+                    dirtySoA[i] = 1;
+                } else {
+                    transforms.get(entity).Dirty = true;
+                }
+            }
+        });
+
+        // Emplacing the tags grows a storage - not from the jobs
+        for (u32 i = 0; i < count; ++i) {
+            if (dirtySoA[i]) registry.emplace_or_replace<TransformDirty>(pending.Entities[i]);
+        }
+    }
+
+    m_Edits.clear();
+}
+
+void TransformSystem::OnUpdate(entt::registry& registry, f32 deltaTime) {
+    (void)deltaTime;
+
+    ApplyEdits(registry);
+
+    // SetParent can only flag AoS transforms; moved SoA ones need recomputing too
+    for (entt::entity entity : m_Reparented) {
+        if (registry.valid(entity) && TransformLayout::IsSoA(registry, entity)) {
+            registry.emplace_or_replace<TransformDirty>(entity);
+        }
+    }
+
+    if (m_LevelsDirty || !m_Reparented.empty()) {
+        m_SubtreeStructureDirty = true;
+    }
+    if (m_LevelsDirty || (!m_Reparented.empty() && !PatchLevels(registry))) {
+        RebuildLevels(registry);
+    }
+    m_Reparented.clear();
+
+    auto& transforms = registry.storage<Transform>();
+    auto& locals = registry.storage<LocalTransform>();
+    auto& worlds = registry.storage<WorldTransform>();
+    auto& dirtySoA = registry.storage<TransformDirty>();
+    auto& previous = registry.storage<PreviousWorldTransform>();
+    std::atomic<u32> updated{0};
+
+    auto worldMatrixOf = [&](const Node& node) -> glm::mat4& {
+        return node.SoA ? worlds.get(node.Entity).Matrix : transforms.get(node.Entity).WorldMatrix;
+    };
+
+    const u32 levelCount = static_cast<u32>(m_LevelOffsets.size()) - 1;
+    for (u32 level = 0; level < levelCount; ++level) {
+        const u32 begin = m_LevelOffsets[level];
+        const u32 count = m_LevelOffsets[level + 1] - begin;
+
+        // Every node of a level only reads its parent from the previous level,
+        // so the level can be split freely across workers
+        JobSystem::ParallelFor(count, 512, [&](u32 first, u32 last) {
+            ComposeBatch batch;
+            u32 localUpdated = 0;
+
+            for (u32 i = begin + first; i < begin + last; ++i) {
+                const Node& node = m_Nodes[i];
+                bool parentChanged = node.ParentIndex >= 0 && m_Changed[node.ParentIndex];
+
+                // Moved last frame: the matrix it was drawn with is now the
+                // previous one, whether or not it changes again below
+                if (m_Changed[i]) {
+                    previous.get(node.Entity).Matrix = worldMatrixOf(node);
+                }
+
+                const glm::mat4* parent = node.ParentIndex >= 0
+                    ? &worldMatrixOf(m_Nodes[node.ParentIndex])
+                    : nullptr;
+
+                if (node.SoA) {
+                    // Dirty tags are cleared after the pass - only read the storage here
+                    if (!dirtySoA.contains(node.Entity) && !parentChanged) {
+                        m_Changed[i] = 0;
+                        continue;
+                    }
+
+                    previous.get(node.Entity).Matrix = worlds.get(node.Entity).Matrix;
+                    const auto& local = locals.get(node.Entity);
+                    batch.Add(local.Position, local.Rotation, local.Scale,
+                              &worlds.get(node.Entity).Matrix, parent);
+                } else {
+                    auto& transform = transforms.get(node.Entity);
+                    if (!transform.Dirty && !parentChanged) {
+                        m_Changed[i] = 0;
+                        continue;
+                    }
+
+                    previous.get(node.Entity).Matrix = transform.WorldMatrix;
+                    batch.Add(transform.Position, transform.Rotation, transform.Scale,
+                              &transform.WorldMatrix, parent);
+                    transform.Dirty = false;
+                }
+
+                m_Changed[i] = 1;
+                ++localUpdated;
+
+                if (batch.Count == ComposeBatch::Capacity) {
+                    batch.Flush();
+                }
+            }
+
+            batch.Flush();
+            updated.fetch_add(localUpdated, std::memory_order_relaxed);
+        });
+    }
+
+    // Entities resolved for the first time have no earlier matrix to move from
+    for (entt::entity entity : m_Fresh) {
+        if (transforms.contains(entity)) {
+            previous.get(entity).Matrix = transforms.get(entity).WorldMatrix;
+        } else if (worlds.contains(entity)) {
+            previous.get(entity).Matrix = worlds.get(entity).Matrix;
+        }
+    }
+    m_Fresh.clear();
+
+    PublishChanges(registry);
+
+    if (m_SubtreeBoundsEnabled) {
+        UpdateSubtreeBounds(registry);
+    } else if (!registry.storage<SubtreeBounds>().empty()) {
+        registry.clear<SubtreeBounds>();
+        m_Stats.SubtreesUpdated = 0;
+    }
+
+    dirtySoA.clear();
+    m_Stats.UpdatedCount = updated.load(std::memory_order_relaxed);
+}
+
+void TransformSystem::PublishChanges(entt::registry& registry) {
+    // World matrices are written in place, which no signal sees; patch the
+    // recomputed ones for on_update listeners (ChangeSet), if there are any
+    const bool transformListeners = !registry.on_update<Transform>().empty();
+    const bool worldListeners = !registry.on_update<WorldTransform>().empty();
+    if (!transformListeners && !worldListeners) return;
+
+    const u32 count = static_cast<u32>(m_Nodes.size());
+    for (u32 i = 0; i < count; ++i) {
+        if (!m_Changed[i]) continue;
+
+        const Node& node = m_Nodes[i];
+        if (node.SoA) {
+            if (worldListeners) registry.patch<WorldTransform>(node.Entity);
+        } else if (transformListeners) {
+            registry.patch<Transform>(node.Entity);
+        }
+    }
+}
+
+void TransformSystem::UpdateSubtreeBounds(entt::registry& registry) {
+    auto& transforms = registry.storage<Transform>();
+    auto& worlds = registry.storage<WorldTransform>();
+    auto& meshes = registry.storage<MeshComponent>();
+    auto& subtrees = registry.storage<SubtreeBounds>();
+    const u32 count = static_cast<u32>(m_Nodes.size());
+    const AABB empty(glm::vec3(std::numeric_limits<f32>::max()), glm::vec3(std::numeric_limits<f32>::lowest()));
+
+    const bool everything = m_SubtreeStructureDirty || m_SubtreeMeshesDirty;
+    if (m_SubtreeStructureDirty) {
+        // Which nodes are parents only changes with the structure
+        registry.clear<SubtreeBounds>();
+        for (const Node& node : m_Nodes) {
+            if (node.ParentIndex < 0) continue;
+            const entt::entity parent = m_Nodes[node.ParentIndex].Entity;
+            if (!subtrees.contains(parent)) registry.emplace<SubtreeBounds>(parent);
+        }
+        m_SubtreeBounds.assign(count, empty);
+    }
+    m_SubtreeStructureDirty = false;
+    m_SubtreeMeshesDirty = false;
+
+    // Levels are stored in order, so walking the nodes backwards reaches
+    // every child before its parent
+    m_SubtreeDirty.resize(count);
+    for (u32 i = 0; i < count; ++i) {
+        m_SubtreeDirty[i] = everything || m_Changed[i];
+    }
+    for (u32 i = count; i-- > 0;) {
+        const i32 parent = m_Nodes[i].ParentIndex;
+        if (m_SubtreeDirty[i] && parent >= 0) m_SubtreeDirty[parent] = 1;
+    }
+
+    // Own bounds of the flagged nodes, then their children's merged in
+    JobSystem::ParallelFor(count, 1024, [&](u32 first, u32 last) {
+        for (u32 i = first; i < last; ++i) {
+            if (!m_SubtreeDirty[i]) continue;
+
+            const Node& node = m_Nodes[i];
+            if (!meshes.contains(node.Entity)) {
+                m_SubtreeBounds[i] = empty;
+                continue;
+            }
+            const glm::mat4& world = node.SoA ? worlds.get(node.Entity).Matrix
+                                              : transforms.get(node.Entity).WorldMatrix;
+            m_SubtreeBounds[i] = meshes.get(node.Entity).LocalBounds.Transform(world);
+        }
+    });
+
+    u32 updated = 0;
+    for (u32 i = count; i-- > 0;) {
+        // Every child of i is further on and already merged in; unchanged
+        // siblings of a changed node still contribute their kept bounds
+        const Node& node = m_Nodes[i];
+        if (node.ParentIndex >= 0 && m_SubtreeDirty[node.ParentIndex]) {
+            m_SubtreeBounds[node.ParentIndex].ExpandToInclude(m_SubtreeBounds[i]);
+        }
+        if (m_SubtreeDirty[i] && subtrees.contains(node.Entity)) {
+            subtrees.get(node.Entity).Bounds = m_SubtreeBounds[i];
+            ++updated;
+        }
+    }
+    m_Stats.SubtreesUpdated = updated;
+}
+
+void TransformSystem::RebuildLevels(entt::registry& registry) {
+    m_Nodes.clear();
+    m_LevelOffsets.clear();
+
+    // Level 0: every transform (either layout) without a parent
+    auto isRoot = [&](entt::entity entity) {
+        auto* hierarchy = registry.try_get<Hierarchy>(entity);
+        return !hierarchy || hierarchy->Parent == entt::null;
+    };
+
+    for (auto entity : registry.view<Transform>()) {
+        if (isRoot(entity)) m_Nodes.push_back({entity, -1, false});
+    }
+    for (auto entity : registry.view<LocalTransform, WorldTransform>(entt::exclude<Transform>)) {
+        if (isRoot(entity)) m_Nodes.push_back({entity, -1, true});
+    }
+
+    // Breadth-first expansion: level n + 1 is the children of level n
+    u32 levelBegin = 0;
+    m_LevelOffsets.push_back(0);
+    while (levelBegin < m_Nodes.size()) {
+        const u32 levelEnd = static_cast<u32>(m_Nodes.size());
+        m_LevelOffsets.push_back(levelEnd);
+
+        for (u32 i = levelBegin; i < levelEnd; ++i) {
+            AppendChildren(registry, m_Nodes[i].Entity, static_cast<i32>(i));
+        }
+
+        levelBegin = levelEnd;
+    }
+
+    m_Changed.assign(m_Nodes.size(), 0);
+    m_LevelsDirty = false;
+
+    // Last frame's change flags were per node index and are gone, so bring
+    // every previous matrix up to date here; the rebuild is a full walk anyway
+    auto& previous = registry.storage<PreviousWorldTransform>();
+    for (const Node& node : m_Nodes) {
+        if (!previous.contains(node.Entity)) {
+            previous.emplace(node.Entity);
+            m_Fresh.push_back(node.Entity);
+        }
+        previous.get(node.Entity).Matrix = node.SoA
+            ? registry.get<WorldTransform>(node.Entity).Matrix
+            : registry.get<Transform>(node.Entity).WorldMatrix;
+    }
+
+    m_Stats.EntityCount = static_cast<u32>(m_Nodes.size());
+    m_Stats.LevelCount = static_cast<u32>(m_LevelOffsets.size()) - 1;
+
+    UpdateNodeIndex();
+    if (m_SortStorage) {
+        SortStorage(registry);
+    }
+}
+
+bool TransformSystem::PatchLevels(entt::registry& registry) {
+    const u32 count = static_cast<u32>(m_Nodes.size());
+
+    // Point the moved nodes at their new parent node
+    for (entt::entity entity : m_Reparented) {
+        if (!registry.valid(entity)) continue;  // Destroyed since; that marks the levels dirty
+
+        const u32 index = NodeIndexOf(entity);
+        i32 parentIndex = -1;
+        if (index == InvalidNode || !FindParentNode(registry, entity, parentIndex)) {
+            // Moved into or out of a subtree the level order doesn't cover
+            return false;
+        }
+        m_Nodes[index].ParentIndex = parentIndex;
+    }
+
+    // Levels from the parent links, descendants of a moved node moving with
+    // it: walk up to the nearest node with a known level, then assign down
+    Vector<u32> levels(count, InvalidNode);
+    Vector<u32> path;
+    u32 levelCount = 0;
+    for (u32 i = 0; i < count; ++i) {
+        u32 node = i;
+        while (levels[node] == InvalidNode && m_Nodes[node].ParentIndex >= 0) {
+            path.push_back(node);
+            node = static_cast<u32>(m_Nodes[node].ParentIndex);
+            if (path.size() > count) return false;  // A cycle; SetParent refuses to make them
+        }
+
+        u32 level = levels[node] == InvalidNode ? 0 : levels[node];
+        levels[node] = level;
+        while (!path.empty()) {
+            levels[path.back()] = ++level;
+            path.pop_back();
+        }
+        levelCount = std::max(levelCount, levels[i] + 1);
+    }
+
+    // Stable counting sort by level; change flags move with their nodes
+    m_LevelOffsets.assign(levelCount + 1, 0);
+    for (u32 i = 0; i < count; ++i) {
+        m_LevelOffsets[levels[i] + 1]++;
+    }
+    for (u32 level = 0; level < levelCount; ++level) {
+        m_LevelOffsets[level + 1] += m_LevelOffsets[level];
+    }
+
+    Vector<u32> remap(count);
+    Vector<u32> cursor(m_LevelOffsets.begin(), m_LevelOffsets.end() - 1);
+    for (u32 i = 0; i < count; ++i) {
+        remap[i] = cursor[levels[i]]++;
+    }
+
+    Vector<Node> nodes(count);
+    Vector<u8> changed(count);
+    for (u32 i = 0; i < count; ++i) {
+        Node node = m_Nodes[i];
+        if (node.ParentIndex >= 0) {
+            node.ParentIndex = static_cast<i32>(remap[node.ParentIndex]);
+        }
+        nodes[remap[i]] = node;
+        changed[remap[i]] = m_Changed[i];
+    }
+    m_Nodes.swap(nodes);
+    m_Changed.swap(changed);
+
+    m_Stats.LevelCount = levelCount;
+
+    UpdateNodeIndex();
+    if (m_SortStorage) {
+        SortStorage(registry);
+    }
+    return true;
+}
+
+bool TransformSystem::FindParentNode(entt::registry& registry, entt::entity entity, i32& parentIndex) const {
+    parentIndex = -1;
+    entt::entity current = entity;
+    while (true) {
+        auto* hierarchy = registry.try_get<Hierarchy>(current);
+        if (!hierarchy || hierarchy->Parent == entt::null) {
+            // entity is a root, or hangs below a root without a transform,
+            // which RebuildLevels leaves out
+            return current == entity;
+        }
+
+        current = hierarchy->Parent;
+        const u32 index = NodeIndexOf(current);
+        if (index != InvalidNode) {
+            parentIndex = static_cast<i32>(index);
+            return true;
+        }
+    }
+}
+
+void TransformSystem::UpdateNodeIndex() {
+    usize slots = 0;
+    for (const Node& node : m_Nodes) {
+        slots = std::max(slots, static_cast<usize>(entt::to_entity(node.Entity)) + 1);
+    }
+
+    m_NodeIndex.assign(slots, InvalidNode);
+    for (u32 i = 0; i < m_Nodes.size(); ++i) {
+        m_NodeIndex[entt::to_entity(m_Nodes[i].Entity)] = i;
+    }
+}
+
+u32 TransformSystem::NodeIndexOf(entt::entity entity) const {
+    const usize slot = static_cast<usize>(entt::to_entity(entity));
+    if (slot >= m_NodeIndex.size()) return InvalidNode;
+
+    // The slot may belong to a newer entity by now
+    const u32 index = m_NodeIndex[slot];
+    return index != InvalidNode && m_Nodes[index].Entity == entity ? index : InvalidNode;
+}
+
+void TransformSystem::SortStorage(entt::registry& registry) {
+    // EnTT sorts a pool so that iteration follows the comparator, and
+    // iterates packed arrays back to front: descending node index leaves
+    // memory in level order. Entities outside the order (InvalidNode) end up
+    // behind it.
+    auto byNode = [this](entt::entity a, entt::entity b) {
+        return NodeIndexOf(a) > NodeIndexOf(b);
+    };
+    registry.sort<Transform>(byNode);
+    registry.sort<WorldTransform>(byNode);
+    registry.sort<PreviousWorldTransform>(byNode);
+}
+
+void TransformSystem::AppendChildren(entt::registry& registry, entt::entity entity, i32 parentIndex) {
+    auto* hierarchy = registry.try_get<Hierarchy>(entity);
+    if (!hierarchy) return;
+
+    entt::entity child = hierarchy->FirstChild;
+    while (child != entt::null) {
+        auto& childHierarchy = registry.get<Hierarchy>(child);
+
+        if (registry.all_of<Transform>(child)) {
+            m_Nodes.push_back({child, parentIndex, false});
+        } else if (TransformLayout::IsSoA(registry, child)) {
+            m_Nodes.push_back({child, parentIndex, true});
+        } else {
+            // Children of a transform-less entity inherit the nearest transform ancestor
+            AppendChildren(registry, child, parentIndex);
+        }
+
+        child = childHierarchy.NextSibling;
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "ecs/System.hpp"
+#include "ecs/Components/Transform.hpp"
+#include "ecs/Components/TransformSoA.hpp"
+#include "ecs/Components/Hierarchy.hpp"
+#include "ecs/Components/Renderable.hpp"
+
+namespace Engine {
+
+// TransformSystem - resolves Transform::WorldMatrix for the whole scene.
+//
+// Entities are kept in breadth-first order grouped by hierarchy level, so a
+// parent is always resolved before its children. Each level is processed in
+// parallel; an entity is recomputed only if it is Dirty or its parent's world
+// matrix changed this frame, so static subtrees cost a flag check.
+//
+// Entities using the SoA layout (ecs/Components/TransformSoA.hpp) take part
+// in the same hierarchy; their TransformDirty tags are cleared after the pass.
+//
+// The level order is rebuilt lazily when Transform or Hierarchy components
+// are added or removed. Reparenting (HierarchyUtils::SetParent patches
+// Hierarchy) only patches it: the moved nodes are pointed at their new
+// parent node and the nodes re-bucketed by level, without walking the
+// registry again.
+//
+// With SetSortStorage(true) the Transform and PreviousWorldTransform pools
+// are sorted into the level order after every rebuild or patch, so the
+// per-level loops stream through them linearly instead of jumping around
+// the pools by entity. None of the three may be owned by a group (see
+// RenderGroups.hpp).
+//
+// Recomputed world matrices are announced with registry.patch when anyone
+// listens to on_update<Transform> / <WorldTransform>, which is what
+// SYSTEM_REACTS_TO(Transform) systems see as movement.
+//
+// SubmitEdit queues one world space delta for many entities (the editor's
+// multi-selection), applied in parallel at the start of the next update so
+// the hierarchy pass resolves them with everything else.
+//
+// Every resolved entity also gets a PreviousWorldTransform, emplaced when the
+// level order is rebuilt. A node copies its world matrix there before it is
+// recomputed and on the frame after it last changed, so static entities cost
+// nothing and the copy always holds the matrix drawn the frame before.
+//
+// With SetSubtreeBounds (on by default) every node with children carries a
+// SubtreeBounds: its MeshComponent bounds merged with all of its
+// descendants', in world space. After the level passes the changed nodes'
+// ancestors are flagged leaves first, then only the flagged nodes are
+// re-merged from their children, so a moving prop costs its path to the
+// root and a static building nothing.
+class TransformSystem : public ISystem {
+public:
+    DEFINE_SYSTEM(TransformSystem, PostUpdate, 10)
+    SYSTEM_ACCESS(.Read<Hierarchy, RootEntity, LocalTransform, MeshComponent>()
+                  .Write<Transform, WorldTransform, TransformDirty, PreviousWorldTransform, SubtreeBounds>())
+
+    struct Stats {
+        u32 EntityCount = 0;
+        u32 LevelCount = 0;
+        u32 UpdatedCount = 0;
+        u32 SubtreesUpdated = 0;    // SubtreeBounds re-merged this frame
+    };
+
+    // World space delta for SubmitEdit. Rotation and scale are about each
+    // entity's own origin.
+    struct TransformEdit {
+        glm::vec3 Translation{0.0f};
+        glm::quat Rotation{1.0f, 0.0f, 0.0f, 0.0f};
+        glm::vec3 Scale{1.0f};          // Multiplies the local scale
+    };
+
+    void OnCreate(entt::registry& registry) override;
+    void OnDestroy(entt::registry& registry) override;
+    void OnUpdate(entt::registry& registry, f32 deltaTime) override;
+
+    // Force the level order to be rebuilt on the next update
+    void Invalidate() { m_LevelsDirty = true; }
+
+    // Keep the transform pools in level order (off by default: sorting is
+    // O(n log n) per structural change, worth it for large, deep scenes)
+    void SetSortStorage(bool enabled);
+    bool GetSortStorage() const { return m_SortStorage; }
+
+    // Maintain SubtreeBounds on hierarchy parents; off removes them
+    void SetSubtreeBounds(bool enabled);
+    bool GetSubtreeBounds() const { return m_SubtreeBoundsEnabled; }
+
+    // Apply edit to entities (either layout) before the next update's pass.
+    // Entities with an ancestor in the same list are skipped - they already
+    // follow it through the hierarchy.
+    void SubmitEdit(const Vector<entt::entity>& entities, const TransformEdit& edit);
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    struct Node {
+        entt::entity Entity;
+        i32 ParentIndex;  // Index into m_Nodes, -1 for roots
+        bool SoA;         // LocalTransform/WorldTransform instead of Transform
+    };
+
+    static constexpr u32 InvalidNode = ~0u;
+
+    struct PendingEdit {
+        Vector<entt::entity> Entities;
+        TransformEdit Edit;
+    };
+
+    void ApplyEdits(entt::registry& registry);
+
+    void RebuildLevels(entt::registry& registry);
+    void AppendChildren(entt::registry& registry, entt::entity entity, i32 parentIndex);
+
+    // Apply m_Reparented to the level order; false if only a rebuild can
+    bool PatchLevels(entt::registry& registry);
+
+    // Node of the nearest ancestor in the level order (-1 for none, a root);
+    // false if the entity hangs below an ancestor that isn't resolved at all
+    bool FindParentNode(entt::registry& registry, entt::entity entity, i32& parentIndex) const;
+
+    void UpdateNodeIndex();
+    u32 NodeIndexOf(entt::entity entity) const;
+    void SortStorage(entt::registry& registry);
+    void PublishChanges(entt::registry& registry);
+    void UpdateSubtreeBounds(entt::registry& registry);
+
+    void OnStructureChanged(entt::registry& registry, entt::entity entity);
+    void OnHierarchyPatched(entt::registry& registry, entt::entity entity);
+    void OnMeshChanged(entt::registry& registry, entt::entity entity);
+
+private:
+    Vector<Node> m_Nodes;
+    Vector<u32> m_LevelOffsets;  // m_Nodes[m_LevelOffsets[i] .. m_LevelOffsets[i + 1]) is level i
+    Vector<u8> m_Changed;        // World matrix changed this frame, per node
+    Vector<entt::entity> m_Fresh;   // PreviousWorldTransform emplaced by the last rebuild
+    Vector<u32> m_NodeIndex;     // Per entity slot (entt::to_entity), index into m_Nodes
+    Vector<entt::entity> m_Reparented;  // Hierarchy patched since the last update
+    Vector<PendingEdit> m_Edits;        // Submitted since the last update
+    Vector<AABB> m_SubtreeBounds;   // Per node; empty (Min > Max) without meshes
+    Vector<u8> m_SubtreeDirty;      // Per node, this frame
+    bool m_LevelsDirty = true;
+    bool m_SortStorage = false;
+    bool m_SubtreeBoundsEnabled = true;
+    bool m_SubtreeStructureDirty = true;    // Nodes or their order changed
+    bool m_SubtreeMeshesDirty = true;       // A MeshComponent came, went or changed
+    bool m_Connected = false;
+    Stats m_Stats;
+};
+
+} // namespace Engine
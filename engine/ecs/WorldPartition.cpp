@@ -0,0 +1,292 @@
+#include "ecs/WorldPartition.hpp"
+#include "ecs/Components/Transform.hpp"
+#include "ecs/Components/TransformSoA.hpp"
+#include "ecs/Components/Hierarchy.hpp"
+#include "camera/CameraManager.hpp"
+#include "core/Logger.hpp"
+#include "resources/ResourceManager.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+
+namespace Engine {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+bool ParseCellFile(const fs::path& path, i32& x, i32& z) {
+    if (path.extension() != SceneSerializer::Extension) return false;
+    const String stem = path.stem().string();
+    char tail = 0;
+    return std::sscanf(stem.c_str(), "cell_%d_%d%c", &x, &z, &tail) == 2;
+}
+
+String CellFileName(i32 x, i32 z) {
+    return "cell_" + std::to_string(x) + "_" + std::to_string(z) + SceneSerializer::Extension;
+}
+
+// Append entity and every entity below it in its hierarchy
+void CollectHierarchy(entt::registry& registry, entt::entity entity, Vector<entt::entity>& out) {
+    out.push_back(entity);
+    if (const auto* hierarchy = registry.try_get<Hierarchy>(entity)) {
+        for (entt::entity child = hierarchy->FirstChild; child != entt::null;
+             child = registry.get<Hierarchy>(child).NextSibling) {
+            CollectHierarchy(registry, child, out);
+        }
+    }
+}
+
+} // anonymous namespace
+
+u32 WorldPartition::Build(entt::registry& registry, const String& directory, f32 cellSize) {
+    std::error_code error;
+    fs::create_directories(directory, error);
+    for (const auto& entry : fs::directory_iterator(directory, error)) {
+        i32 x = 0, z = 0;
+        if (ParseCellFile(entry.path(), x, z)) {
+            fs::remove(entry.path(), error);
+        }
+    }
+
+    // Roots decide the cell of their whole hierarchy; a root's local
+    // position is its world position
+    HashMap<u64, Vector<entt::entity>> cells;
+    Vector<entt::entity> roots;
+    for (auto [entity] : registry.storage<entt::entity>().each()) {
+        const auto* hierarchy = registry.try_get<Hierarchy>(entity);
+        if (!hierarchy || hierarchy->IsRoot()) {
+            roots.push_back(entity);
+        }
+    }
+
+    for (entt::entity root : roots) {
+        glm::vec3 position;
+        if (const auto* transform = registry.try_get<Transform>(root)) {
+            position = transform->Position;
+        } else if (const auto* local = registry.try_get<LocalTransform>(root)) {
+            position = local->Position;
+        } else {
+            continue;
+        }
+
+        const i32 x = static_cast<i32>(std::floor(position.x / cellSize));
+        const i32 z = static_cast<i32>(std::floor(position.z / cellSize));
+        CollectHierarchy(registry, root, cells[CellKey(x, z)]);
+    }
+
+    u32 written = 0;
+    for (auto& [key, entities] : cells) {
+        const i32 x = static_cast<i32>(key >> 32);
+        const i32 z = static_cast<i32>(key & 0xFFFFFFFFu);
+        const String path = (fs::path(directory) / CellFileName(x, z)).string();
+
+        // A cell that fails to save keeps its entities resident
+        if (!SceneSerializer::Save(registry, path, entities)) {
+            LOG_CORE_ERROR("WorldPartition: could not write cell {}", path);
+            continue;
+        }
+        registry.destroy(entities.begin(), entities.end());
+        written++;
+    }
+
+    LOG_CORE_INFO("WorldPartition: built {} cells of {} units in {}", written, cellSize, directory);
+    return written;
+}
+
+bool WorldPartition::Open(entt::registry& registry, const String& directory, const Settings& settings) {
+    Close();
+
+    std::error_code error;
+    if (!fs::is_directory(directory, error)) {
+        LOG_CORE_WARN("WorldPartition: {} is not a directory", directory);
+        return false;
+    }
+
+    m_Registry = &registry;
+    m_Directory = directory;
+    m_Settings = settings;
+    m_Settings.UnloadRadius = std::max(m_Settings.UnloadRadius, m_Settings.LoadRadius);
+    m_CellsLoaded = 0;
+    m_CellsUnloaded = 0;
+
+    for (const auto& entry : fs::directory_iterator(directory, error)) {
+        Cell cell;
+        if (ParseCellFile(entry.path(), cell.X, cell.Z)) {
+            cell.FilePath = entry.path().string();
+            m_Cells.emplace(CellKey(cell.X, cell.Z), std::move(cell));
+        }
+    }
+
+    LOG_CORE_INFO("WorldPartition: opened {} with {} cells", directory, m_Cells.size());
+    return true;
+}
+
+void WorldPartition::Close() {
+    if (!m_Registry) return;
+
+    for (auto& [key, cell] : m_Cells) {
+        if (cell.Loader) {
+            cell.Loader->Cancel();
+            cell.Entities = cell.Loader->GetEntities();
+            cell.Loader.reset();
+        }
+        DestroyEntities(cell, cell.Entities.size());
+    }
+    m_Cells.clear();
+    ResourceManager::Instance().UnloadUnused(m_Registry);
+    m_Registry = nullptr;
+}
+
+void WorldPartition::Update(const CameraManager& cameras) {
+    if (const Camera* camera = cameras.GetActiveCamera()) {
+        Update(camera->GetPosition());
+    }
+}
+
+void WorldPartition::Update(const glm::vec3& cameraPosition) {
+    if (!m_Registry) return;
+
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::duration<f32, std::milli>(m_Settings.FrameBudgetMs);
+    auto remainingMs = [&] {
+        return std::max(std::chrono::duration<f32, std::milli>(deadline - Clock::now()).count(), 0.0f);
+    };
+
+    Vector<Cell*> toLoad;
+    Vector<Cell*> loading;
+    Vector<Cell*> unloading;
+    for (auto& [key, cell] : m_Cells) {
+        cell.Distance = DistanceToCell(cell, cameraPosition);
+
+        const bool outside = cell.Distance > m_Settings.UnloadRadius;
+        switch (cell.State) {
+            case CellState::Unloaded:
+                if (cell.Distance <= m_Settings.LoadRadius) toLoad.push_back(&cell);
+                break;
+            case CellState::Loading:
+                if (outside) {
+                    // Left behind mid-load: drop what was committed
+                    cell.Loader->Cancel();
+                    cell.Entities = cell.Loader->GetEntities();
+                    cell.Loader.reset();
+                    cell.State = CellState::Unloading;
+                    unloading.push_back(&cell);
+                } else {
+                    loading.push_back(&cell);
+                }
+                break;
+            case CellState::Loaded:
+                if (outside) {
+                    cell.State = CellState::Unloading;
+                    unloading.push_back(&cell);
+                }
+                break;
+            case CellState::Unloading:
+                unloading.push_back(&cell);
+                break;
+        }
+    }
+
+    auto nearestFirst = [](const Cell* a, const Cell* b) { return a->Distance < b->Distance; };
+
+    // Start the nearest cells while there is room
+    std::sort(toLoad.begin(), toLoad.end(), nearestFirst);
+    for (Cell* cell : toLoad) {
+        if (loading.size() >= m_Settings.MaxConcurrentLoads) break;
+
+        cell->Loader = CreateScope<SceneLoader>();
+        if (cell->Loader->Begin(*m_Registry, cell->FilePath, SceneLoader::LoadMode::Append)) {
+            cell->State = CellState::Loading;
+            loading.push_back(cell);
+        } else {
+            // Deleted since Open: an empty cell
+            cell->Loader.reset();
+            cell->State = CellState::Loaded;
+        }
+    }
+
+    // Commit nearest first. Every load advances by at least a chunk while
+    // the budget lasts, the nearest one even when it is spent.
+    std::sort(loading.begin(), loading.end(), nearestFirst);
+    for (usize i = 0; i < loading.size(); i++) {
+        Cell* cell = loading[i];
+        const f32 budget = remainingMs();
+        if (i > 0 && budget <= 0.0f) break;
+
+        cell->Loader->Update(budget);
+        if (!cell->Loader->IsLoading()) {
+            cell->Entities = cell->Loader->GetEntities();
+            cell->Loader.reset();
+            cell->State = CellState::Loaded;
+            m_CellsLoaded++;
+        }
+    }
+
+    // Unload farthest first, a batch at a time
+    std::sort(unloading.begin(), unloading.end(), [](const Cell* a, const Cell* b) { return a->Distance > b->Distance; });
+    bool unloaded = false;
+    for (usize i = 0; i < unloading.size(); i++) {
+        if (i > 0 && remainingMs() <= 0.0f) break;
+
+        Cell* cell = unloading[i];
+        bool done = false;
+        do {
+            done = DestroyEntities(*cell, m_Settings.UnloadBatch);
+        } while (!done && remainingMs() > 0.0f);
+
+        if (done) {
+            cell->State = CellState::Unloaded;
+            m_CellsUnloaded++;
+            unloaded = true;
+        }
+    }
+
+    // Release what only the unloaded cells used
+    if (unloaded) {
+        ResourceManager::Instance().UnloadUnused(m_Registry);
+    }
+}
+
+f32 WorldPartition::DistanceToCell(const Cell& cell, const glm::vec3& position) const {
+    const f32 size = m_Settings.CellSize;
+    const f32 minX = static_cast<f32>(cell.X) * size;
+    const f32 minZ = static_cast<f32>(cell.Z) * size;
+    const f32 dx = std::max({minX - position.x, 0.0f, position.x - (minX + size)});
+    const f32 dz = std::max({minZ - position.z, 0.0f, position.z - (minZ + size)});
+    return std::sqrt(dx * dx + dz * dz);
+}
+
+bool WorldPartition::DestroyEntities(Cell& cell, usize count) {
+    const usize n = std::min(count, cell.Entities.size());
+    const auto first = cell.Entities.end() - static_cast<std::ptrdiff_t>(n);
+    for (auto it = first; it != cell.Entities.end(); ++it) {
+        // Gameplay or the editor may have destroyed some already
+        if (m_Registry->valid(*it)) {
+            m_Registry->destroy(*it);
+        }
+    }
+    cell.Entities.erase(first, cell.Entities.end());
+    return cell.Entities.empty();
+}
+
+WorldPartition::Stats WorldPartition::GetStats() const {
+    Stats stats;
+    stats.Cells = static_cast<u32>(m_Cells.size());
+    stats.CellsLoaded = m_CellsLoaded;
+    stats.CellsUnloaded = m_CellsUnloaded;
+    for (const auto& [key, cell] : m_Cells) {
+        if (cell.State == CellState::Loaded) stats.LoadedCells++;
+        if (cell.State == CellState::Loading) {
+            stats.LoadingCells++;
+            stats.ResidentEntities += static_cast<u32>(cell.Loader->GetEntities().size());
+        } else {
+            stats.ResidentEntities += static_cast<u32>(cell.Entities.size());
+        }
+    }
+    return stats;
+}
+
+} // namespace Engine
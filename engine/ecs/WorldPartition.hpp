@@ -0,0 +1,116 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "ecs/SceneSerializer.hpp"
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+class CameraManager;
+
+// WorldPartition - streams a level in grid cells around the camera.
+//
+// The level is split on the XZ plane into square cells, each a scene file
+// (cell_<x>_<z>.pvscene) holding the hierarchies rooted in it. Cells within
+// LoadRadius of the camera are appended to the registry with SceneLoader,
+// cells beyond UnloadRadius have their entities destroyed; the gap between
+// the radii keeps a camera on a cell border from thrashing. Loads, commits
+// and unloads share one per-frame budget, and after an unload the resources
+// nothing uses any more are released (ResourceManager::UnloadUnused), so
+// memory and iteration cost follow what is near the camera rather than the
+// size of the world.
+//
+// Streamed cells are read-only: changes made to their entities are lost
+// when the cell unloads. Entities outside any cell (no Transform, or kept
+// in the registry when building) stay resident. The sandbox's
+// WorldStreamingDemo builds and streams a city this way.
+class WorldPartition {
+public:
+    static constexpr f32 DefaultCellSize = 64.0f;
+
+    struct Settings {
+        f32 CellSize = DefaultCellSize;
+        f32 LoadRadius = 160.0f;        // Camera to cell bounds, on XZ
+        f32 UnloadRadius = 224.0f;      // Greater than LoadRadius
+        f32 FrameBudgetMs = 2.0f;       // Commits and unloads per Update
+        u32 MaxConcurrentLoads = 4;
+        u32 UnloadBatch = 1024;         // Entities destroyed between budget checks
+    };
+
+    WorldPartition() = default;
+    ~WorldPartition() { Close(); }
+
+    WorldPartition(const WorldPartition&) = delete;
+    WorldPartition& operator=(const WorldPartition&) = delete;
+
+    // Move every root entity with a transform of registry, with its
+    // children, into the cell files of directory (replacing the ones there).
+    // Returns the number of cells written.
+    static u32 Build(entt::registry& registry, const String& directory, f32 cellSize = DefaultCellSize);
+
+    // Stream the cells of directory into registry, which must outlive the
+    // partition. The cell size must be the one the cells were built with.
+    bool Open(entt::registry& registry, const String& directory, const Settings& settings);
+    bool Open(entt::registry& registry, const String& directory) { return Open(registry, directory, Settings()); }
+
+    // Unload every cell
+    void Close();
+
+    bool IsOpen() const { return m_Registry != nullptr; }
+
+    // Start, advance and finish loads and unloads for the camera position.
+    // Call once a frame on the GL thread.
+    void Update(const glm::vec3& cameraPosition);
+    void Update(const CameraManager& cameras);
+
+    Settings& GetSettings() { return m_Settings; }
+    const Settings& GetSettings() const { return m_Settings; }
+
+    struct Stats {
+        u32 Cells = 0;
+        u32 LoadedCells = 0;
+        u32 LoadingCells = 0;
+        u32 ResidentEntities = 0;   // In loaded and loading cells
+        u32 CellsLoaded = 0;        // Since Open
+        u32 CellsUnloaded = 0;
+    };
+    Stats GetStats() const;
+
+private:
+    enum class CellState : u8 {
+        Unloaded,
+        Loading,
+        Loaded,
+        Unloading
+    };
+
+    struct Cell {
+        i32 X = 0;
+        i32 Z = 0;
+        String FilePath;
+        CellState State = CellState::Unloaded;
+        Scope<SceneLoader> Loader;      // While loading
+        Vector<entt::entity> Entities;  // Loaded, or left to destroy
+        f32 Distance = 0.0f;            // To the camera this frame
+    };
+
+    static u64 CellKey(i32 x, i32 z) {
+        return (static_cast<u64>(static_cast<u32>(x)) << 32) | static_cast<u32>(z);
+    }
+
+    f32 DistanceToCell(const Cell& cell, const glm::vec3& position) const;
+
+    // Destroy up to count of the cell's entities; true when none are left
+    bool DestroyEntities(Cell& cell, usize count);
+
+private:
+    entt::registry* m_Registry = nullptr;
+    String m_Directory;
+    Settings m_Settings;
+    HashMap<u64, Cell> m_Cells;
+    u32 m_CellsLoaded = 0;
+    u32 m_CellsUnloaded = 0;
+};
+
+} // namespace Engine
@@ -2,6 +2,7 @@
 #include "core/Input.hpp"
 #include "core/Time.hpp"
 #include "core/Logger.hpp"
+#include "core/Profiler.hpp"
 #include "resources/loaders/MeshLoader.hpp"
 #include "ecs/Core.hpp"
 #include "ecs/Components/LightComponents.hpp"
@@ -49,9 +50,15 @@ void EditorApplication::OnInit() {
 
     // Setup editor context
     m_EditorContext.Registry = &m_Registry;
+    m_EditorContext.TransformSystem = GetSystemScheduler().GetSystem<Engine::TransformSystem>();
     m_EditorContext.LightingSystem = m_LightingSystem.get();
     m_EditorContext.ShadowSystem = m_ShadowSystem.get();
+    m_EditorContext.CullingSystem = m_CullingSystem.get();
+    m_EditorContext.LODSystem = m_LODSystem.get();
+    m_EditorContext.PostProcess = m_PostProcess.get();
     m_EditorContext.DebugRenderer = m_DebugRenderer.get();
+    m_EditorContext.FrameStats = &GetFrameStats();
+    m_EditorContext.History = &m_UndoHistory;
 
     // Register entity destruction callback to clear stale selections
     m_Registry.Raw().on_destroy<Engine::Transform>().connect<&EditorApplication::OnEntityDestroyed>(this);
@@ -62,7 +69,7 @@ void EditorApplication::OnInit() {
     // Create panels
     AddPanel<ViewportPanel>(m_EditorCamera.get(), m_ViewportFramebuffer.get(),
                             m_LightingSystem.get(), m_ShadowSystem.get(),
-                            m_TonemapShader, m_ScreenQuadVAO, m_DebugRenderer.get());
+                            m_DebugRenderer.get());
     AddPanel<SceneHierarchyPanel>();
     AddPanel<InspectorPanel>();
     AddPanel<StatsPanel>();
@@ -88,9 +95,16 @@ void EditorApplication::OnShutdown() {
 }
 
 void EditorApplication::OnUpdate(Engine::f32 deltaTime) {
+    SetIdleFrameRate(m_EditorContext.IdleRendering ? m_EditorContext.IdleFrameRate : 0.0f);
+
     HandleShortcuts();
 
+    if (m_SceneLoader.IsLoading()) {
+        m_SceneLoader.Update();
+    }
+
     // Update panels (camera is updated in OnPostImGuiRender after viewport state is known)
+    m_EditorContext.ThumbnailsPending = false;
     for (auto& panel : m_Panels) {
         if (panel->IsVisible()) {
             panel->OnUpdate(deltaTime);
@@ -137,6 +151,11 @@ void EditorApplication::OnAppEvent(Engine::Event& e) {
     }
 }
 
+bool EditorApplication::IsIdle() const {
+    return m_EditorContext.State == PlayState::Edit && !m_EditorContext.ViewportRedrawPending &&
+           !m_EditorContext.ThumbnailsPending && !m_SceneLoader.IsLoading();
+}
+
 void EditorApplication::SetupImGuiStyle() {
     ImGuiStyle& style = ImGui::GetStyle();
 
@@ -253,10 +272,25 @@ void EditorApplication::RenderMenuBar() {
     if (ImGui::BeginMenuBar()) {
         if (ImGui::BeginMenu("File")) {
             if (ImGui::MenuItem("New Scene", "Ctrl+N")) {
+                m_SceneLoader.Cancel();
+                m_UndoHistory.Clear();
                 m_Registry.Clear();
                 m_EditorContext.ClearSelection();
                 CreateDefaultScene();
             }
+            const bool editing = m_EditorContext.State == PlayState::Edit;
+            if (ImGui::MenuItem("Open Scene", "Ctrl+O", false, editing)) {
+                OpenScene();
+            }
+            if (ImGui::MenuItem("Save Scene", "Ctrl+S", false, editing && !m_SceneLoader.IsLoading())) {
+                SaveScene();
+            }
+#ifdef ENGINE_ENABLE_PROFILING
+            ImGui::Separator();
+            if (ImGui::MenuItem("Save Profiler Trace")) {
+                Engine::Profiler::WriteChromeTrace("profile.json");
+            }
+#endif
             ImGui::Separator();
             if (ImGui::MenuItem("Exit", "Alt+F4")) {
                 Close();
@@ -265,8 +299,15 @@ void EditorApplication::RenderMenuBar() {
         }
 
         if (ImGui::BeginMenu("Edit")) {
-            if (ImGui::MenuItem("Undo", "Ctrl+Z", false, false)) {}
-            if (ImGui::MenuItem("Redo", "Ctrl+Y", false, false)) {}
+            const bool editing = m_EditorContext.State == PlayState::Edit;
+            const Engine::String undoLabel = Engine::String("Undo ") + m_UndoHistory.GetUndoLabel();
+            const Engine::String redoLabel = Engine::String("Redo ") + m_UndoHistory.GetRedoLabel();
+            if (ImGui::MenuItem(undoLabel.c_str(), "Ctrl+Z", false, editing && m_UndoHistory.CanUndo())) {
+                m_UndoHistory.Undo(m_Registry.Raw());
+            }
+            if (ImGui::MenuItem(redoLabel.c_str(), "Ctrl+Y", false, editing && m_UndoHistory.CanRedo())) {
+                m_UndoHistory.Redo(m_Registry.Raw());
+            }
             ImGui::Separator();
             if (ImGui::MenuItem("Delete", "Del", false, m_EditorContext.HasSelection())) {
                 if (m_EditorContext.HasSelection()) {
@@ -301,11 +342,9 @@ void EditorApplication::RenderMenuBar() {
                 if (ImGui::MenuItem("Cube")) {
                     auto entity = m_Registry.CreateEntity();
                     entity.AddComponent<Engine::NameComponent>().Name = "Cube";
-                    auto& t = entity.AddComponent<Engine::Transform>();
-                    t.UpdateWorldMatrix();
+                    entity.AddComponent<Engine::Transform>();
                     auto& mc = entity.AddComponent<Engine::MeshComponent>();
-                    mc.VAO = m_CubeMesh->GetVertexArray();
-                    mc.IndexCount = m_CubeMesh->GetIndexCount();
+                    mc.Mesh = Engine::ResourceManager::Instance().AddMesh(m_CubeMesh);
                     mc.LocalBounds = m_CubeMesh->GetBounds();
                     auto& mat = entity.AddComponent<Engine::MaterialComponent>();
                     mat.BaseColor = glm::vec4(0.8f, 0.8f, 0.8f, 1.0f);
@@ -320,11 +359,9 @@ void EditorApplication::RenderMenuBar() {
                 if (ImGui::MenuItem("Sphere")) {
                     auto entity = m_Registry.CreateEntity();
                     entity.AddComponent<Engine::NameComponent>().Name = "Sphere";
-                    auto& t = entity.AddComponent<Engine::Transform>();
-                    t.UpdateWorldMatrix();
+                    entity.AddComponent<Engine::Transform>();
                     auto& mc = entity.AddComponent<Engine::MeshComponent>();
-                    mc.VAO = m_SphereMesh->GetVertexArray();
-                    mc.IndexCount = m_SphereMesh->GetIndexCount();
+                    mc.Mesh = Engine::ResourceManager::Instance().AddMesh(m_SphereMesh);
                     mc.LocalBounds = m_SphereMesh->GetBounds();
                     auto& mat = entity.AddComponent<Engine::MaterialComponent>();
                     mat.BaseColor = glm::vec4(0.8f, 0.8f, 0.8f, 1.0f);
@@ -341,10 +378,8 @@ void EditorApplication::RenderMenuBar() {
                     entity.AddComponent<Engine::NameComponent>().Name = "Plane";
                     auto& t = entity.AddComponent<Engine::Transform>();
                     t.SetScale(glm::vec3(10.0f, 1.0f, 10.0f));
-                    t.UpdateWorldMatrix();
                     auto& mc = entity.AddComponent<Engine::MeshComponent>();
-                    mc.VAO = m_PlaneMesh->GetVertexArray();
-                    mc.IndexCount = m_PlaneMesh->GetIndexCount();
+                    mc.Mesh = Engine::ResourceManager::Instance().AddMesh(m_PlaneMesh);
                     mc.LocalBounds = m_PlaneMesh->GetBounds();
                     auto& mat = entity.AddComponent<Engine::MaterialComponent>();
                     mat.BaseColor = glm::vec4(0.5f, 0.5f, 0.5f, 1.0f);
@@ -359,11 +394,9 @@ void EditorApplication::RenderMenuBar() {
                 if (ImGui::MenuItem("Cylinder")) {
                     auto entity = m_Registry.CreateEntity();
                     entity.AddComponent<Engine::NameComponent>().Name = "Cylinder";
-                    auto& t = entity.AddComponent<Engine::Transform>();
-                    t.UpdateWorldMatrix();
+                    entity.AddComponent<Engine::Transform>();
                     auto& mc = entity.AddComponent<Engine::MeshComponent>();
-                    mc.VAO = m_CylinderMesh->GetVertexArray();
-                    mc.IndexCount = m_CylinderMesh->GetIndexCount();
+                    mc.Mesh = Engine::ResourceManager::Instance().AddMesh(m_CylinderMesh);
                     mc.LocalBounds = m_CylinderMesh->GetBounds();
                     auto& mat = entity.AddComponent<Engine::MaterialComponent>();
                     mat.BaseColor = glm::vec4(0.8f, 0.8f, 0.8f, 1.0f);
@@ -394,7 +427,6 @@ void EditorApplication::RenderMenuBar() {
                     entity.AddComponent<Engine::NameComponent>().Name = "Point Light";
                     auto& t = entity.AddComponent<Engine::Transform>();
                     t.SetPosition(glm::vec3(0.0f, 2.0f, 0.0f));
-                    t.UpdateWorldMatrix();
                     auto& light = entity.AddComponent<Engine::PointLightComponent>();
                     light.Color = glm::vec3(1.0f);
                     light.Intensity = 1.0f;
@@ -406,7 +438,6 @@ void EditorApplication::RenderMenuBar() {
                     entity.AddComponent<Engine::NameComponent>().Name = "Spot Light";
                     auto& t = entity.AddComponent<Engine::Transform>();
                     t.SetPosition(glm::vec3(0.0f, 5.0f, 0.0f));
-                    t.UpdateWorldMatrix();
                     auto& light = entity.AddComponent<Engine::SpotLightComponent>();
                     light.Direction = glm::vec3(0.0f, -1.0f, 0.0f);
                     light.Color = glm::vec3(1.0f);
@@ -470,6 +501,31 @@ void EditorApplication::HandleShortcuts() {
             }
         }
 
+        // Scene files
+        const bool ctrl = Engine::Input::IsKeyPressed(Engine::Key::LeftControl) ||
+                          Engine::Input::IsKeyPressed(Engine::Key::RightControl);
+        if (ctrl && m_EditorContext.State == PlayState::Edit) {
+            if (Engine::Input::IsKeyJustPressed(Engine::Key::O)) {
+                OpenScene();
+            }
+            if (Engine::Input::IsKeyJustPressed(Engine::Key::S) && !m_SceneLoader.IsLoading()) {
+                SaveScene();
+            }
+
+            const bool shift = Engine::Input::IsKeyPressed(Engine::Key::LeftShift) ||
+                               Engine::Input::IsKeyPressed(Engine::Key::RightShift);
+            if (Engine::Input::IsKeyJustPressed(Engine::Key::Z)) {
+                if (shift) {
+                    m_UndoHistory.Redo(m_Registry.Raw());
+                } else {
+                    m_UndoHistory.Undo(m_Registry.Raw());
+                }
+            }
+            if (Engine::Input::IsKeyJustPressed(Engine::Key::Y)) {
+                m_UndoHistory.Redo(m_Registry.Raw());
+            }
+        }
+
         // Debug view cycling
         if (Engine::Input::IsKeyJustPressed(Engine::Key::F3)) {
             m_DebugRenderer->CycleView();
@@ -484,40 +540,26 @@ void EditorApplication::InitializeRenderingSystems() {
     // Load common meshes
     m_CubeMesh = resources.GetCube();
     m_SphereMesh = resources.GetSphere(32, 16);
-    m_PlaneMesh = Engine::MeshLoader::CreatePlane(1.0f, 1.0f, 1);
-    m_CylinderMesh = Engine::MeshLoader::CreateCylinder(0.5f, 1.0f, 32);
+    m_PlaneMesh = resources.GetPlane(1);
+    m_CylinderMesh = resources.GetCylinder(32);
+
+    // Initialize culling system
+    m_CullingSystem = Engine::CreateScope<Engine::CullingSystem>();
+    m_CullingSystem->Create(m_Registry.Raw());
+    m_LODSystem = Engine::CreateScope<Engine::LODSelectionSystem>();
 
     // Initialize shadow system
     m_ShadowSystem = Engine::CreateScope<Engine::ShadowMapSystem>();
-    m_ShadowSystem->OnCreate(m_Registry.Raw());
+    m_ShadowSystem->Create(m_Registry.Raw());
+    m_ShadowSystem->SetSpatialIndex(&m_CullingSystem->GetSpatialIndex());
 
     // Initialize deferred lighting system
     m_LightingSystem = Engine::CreateScope<Engine::DeferredLightingSystem>();
-    m_LightingSystem->OnCreate(m_Registry.Raw());
+    m_LightingSystem->Create(m_Registry.Raw());
     m_LightingSystem->Resize(GetWindow().GetWidth(), GetWindow().GetHeight());
     m_LightingSystem->SetShadowSystem(m_ShadowSystem.get());
 
-    // Load tonemap shader
-    m_TonemapShader = resources.LoadShader("tonemap", "assets/shaders/postprocess/tonemap.glsl");
-
-    // Create screen quad
-    float vertices[] = {
-        -1.0f,  1.0f, 0.0f,  0.0f, 1.0f,
-        -1.0f, -1.0f, 0.0f,  0.0f, 0.0f,
-         1.0f, -1.0f, 0.0f,  1.0f, 0.0f,
-         1.0f,  1.0f, 0.0f,  1.0f, 1.0f
-    };
-    Engine::u32 indices[] = {0, 1, 2, 2, 3, 0};
-
-    m_ScreenQuadVAO = Engine::CreateRef<Engine::VertexArray>();
-    auto vbo = Engine::CreateRef<Engine::VertexBuffer>(vertices, sizeof(vertices));
-    vbo->SetLayout({
-        {Engine::ShaderDataType::Float3, "a_Position"},
-        {Engine::ShaderDataType::Float2, "a_TexCoords"}
-    });
-    auto ibo = Engine::CreateRef<Engine::IndexBuffer>(indices, 6);
-    m_ScreenQuadVAO->AddVertexBuffer(vbo);
-    m_ScreenQuadVAO->SetIndexBuffer(ibo);
+    m_PostProcess = Engine::CreateScope<Engine::PostProcessStack>();
 
     // Create viewport framebuffer
     Engine::FramebufferSpecification fbSpec;
@@ -532,12 +574,15 @@ void EditorApplication::InitializeRenderingSystems() {
     m_DebugRenderer->Initialize();
     m_DebugRenderer->SetCSM(m_ShadowSystem->GetCSM());
     m_DebugRenderer->SetGBuffer(&m_LightingSystem->GetGBuffer());
+    m_DebugRenderer->SetHiZ(&m_LightingSystem->GetHiZPyramid());
+    m_DebugRenderer->SetOverdrawCounter(&m_LightingSystem->GetOverdrawCounter());
 }
 
 void EditorApplication::ShutdownRenderingSystems() {
     if (m_DebugRenderer) m_DebugRenderer->Shutdown();
-    if (m_ShadowSystem) m_ShadowSystem->OnDestroy(m_Registry.Raw());
-    if (m_LightingSystem) m_LightingSystem->OnDestroy(m_Registry.Raw());
+    if (m_CullingSystem) m_CullingSystem->Destroy(m_Registry.Raw());
+    if (m_ShadowSystem) m_ShadowSystem->Destroy(m_Registry.Raw());
+    if (m_LightingSystem) m_LightingSystem->Destroy(m_Registry.Raw());
 }
 
 void EditorApplication::CreateDefaultScene() {
@@ -567,11 +612,9 @@ void EditorApplication::CreateDefaultScene() {
         auto& t = entity.AddComponent<Engine::Transform>();
         t.SetPosition(glm::vec3(0.0f, 0.0f, 0.0f));
         t.SetScale(glm::vec3(20.0f, 1.0f, 20.0f));
-        t.UpdateWorldMatrix();
 
         auto& mc = entity.AddComponent<Engine::MeshComponent>();
-        mc.VAO = m_PlaneMesh->GetVertexArray();
-        mc.IndexCount = m_PlaneMesh->GetIndexCount();
+        mc.Mesh = Engine::ResourceManager::Instance().AddMesh(m_PlaneMesh);
         mc.LocalBounds = m_PlaneMesh->GetBounds();
 
         auto& mat = entity.AddComponent<Engine::MaterialComponent>();
@@ -586,26 +629,24 @@ void EditorApplication::CreateDefaultScene() {
     }
 
     // Create a few sample cubes
-    for (int i = 0; i < 3; ++i) {
-        auto entity = m_Registry.CreateEntity();
-        auto& t = entity.AddComponent<Engine::Transform>();
-        t.SetPosition(glm::vec3(-3.0f + i * 3.0f, 0.5f, 0.0f));
-        t.UpdateWorldMatrix();
-
-        auto& mc = entity.AddComponent<Engine::MeshComponent>();
-        mc.VAO = m_CubeMesh->GetVertexArray();
-        mc.IndexCount = m_CubeMesh->GetIndexCount();
+    {
+        Engine::Prefab<Engine::Transform, Engine::MeshComponent, Engine::MaterialComponent, Engine::Renderable> cube;
+        auto& mc = cube.Get<Engine::MeshComponent>();
+        mc.Mesh = Engine::ResourceManager::Instance().AddMesh(m_CubeMesh);
         mc.LocalBounds = m_CubeMesh->GetBounds();
+        cube.Get<Engine::Renderable>().InFrustum = true;
+
+        Engine::Transform transforms[3];
+        Engine::MaterialComponent materials[3];
+        for (int i = 0; i < 3; ++i) {
+            transforms[i].SetPosition(glm::vec3(-3.0f + i * 3.0f, 0.5f, 0.0f));
+            materials[i].BaseColor = glm::vec4(0.2f + i * 0.3f, 0.3f, 0.8f - i * 0.2f, 1.0f);
+            materials[i].Metallic = i * 0.3f;
+            materials[i].Roughness = 0.3f + i * 0.2f;
+        }
 
-        auto& mat = entity.AddComponent<Engine::MaterialComponent>();
-        mat.BaseColor = glm::vec4(0.2f + i * 0.3f, 0.3f, 0.8f - i * 0.2f, 1.0f);
-        mat.Metallic = i * 0.3f;
-        mat.Roughness = 0.3f + i * 0.2f;
-
-        auto& r = entity.AddComponent<Engine::Renderable>();
-        r.Visible = true;
-        r.InFrustum = true;
-        r.CastShadows = true;
+        entt::entity entities[3];
+        cube.Spawn(m_Registry.Raw(), entities, entities + 3, transforms, materials);
     }
 
     // Create a sphere
@@ -613,11 +654,9 @@ void EditorApplication::CreateDefaultScene() {
         auto entity = m_Registry.CreateEntity();
         auto& t = entity.AddComponent<Engine::Transform>();
         t.SetPosition(glm::vec3(0.0f, 1.5f, 3.0f));
-        t.UpdateWorldMatrix();
 
         auto& mc = entity.AddComponent<Engine::MeshComponent>();
-        mc.VAO = m_SphereMesh->GetVertexArray();
-        mc.IndexCount = m_SphereMesh->GetIndexCount();
+        mc.Mesh = Engine::ResourceManager::Instance().AddMesh(m_SphereMesh);
         mc.LocalBounds = m_SphereMesh->GetBounds();
 
         auto& mat = entity.AddComponent<Engine::MaterialComponent>();
@@ -634,6 +673,21 @@ void EditorApplication::CreateDefaultScene() {
     LOG_CORE_INFO("Default scene created with {} entities", m_Registry.EntityCount());
 }
 
+void EditorApplication::SaveScene() {
+    if (!Engine::SceneSerializer::Save(m_Registry.Raw(), m_ScenePath)) {
+        LOG_CORE_ERROR("Failed to save scene to {}", m_ScenePath);
+    }
+}
+
+void EditorApplication::OpenScene() {
+    m_EditorContext.ClearSelection();
+    m_SceneSnapshot->Clear();
+    m_UndoHistory.Clear();
+    if (m_SceneLoader.Begin(m_Registry.Raw(), m_ScenePath)) {
+        LOG_CORE_INFO("Opening scene {}", m_ScenePath);
+    }
+}
+
 void EditorApplication::OnPlayButtonPressed() {
     if (m_EditorContext.State == PlayState::Edit) {
         // Starting play mode - save scene state
@@ -667,7 +721,9 @@ void EditorApplication::OnStopButtonPressed() {
         if (m_SceneSnapshot->HasSnapshot()) {
             m_SceneSnapshot->Restore(m_Registry);
             m_EditorContext.ClearSelection();
-            LOG_CORE_INFO("Scene restored to pre-play state");
+            const auto& stats = m_SceneSnapshot->GetStats();
+            LOG_CORE_INFO("Scene restored to pre-play state ({} pools unchanged, {} written back, {} rebuilt)",
+                          stats.PoolsUnchanged, stats.PoolsWrittenBack, stats.PoolsRebuilt);
         }
         m_EditorContext.State = PlayState::Edit;
         Engine::Time::SetTimeScale(1.0f);
@@ -4,10 +4,14 @@
 #include "EditorContext.hpp"
 #include "EditorCamera.hpp"
 #include "SceneSnapshot.hpp"
+#include "UndoHistory.hpp"
+#include "ecs/SceneSerializer.hpp"
 #include "panels/Panel.hpp"
 #include "renderer/pipeline/Framebuffer.hpp"
 #include "renderer/lighting/DeferredLightingSystem.hpp"
 #include "renderer/shadows/ShadowMapSystem.hpp"
+#include "renderer/culling/CullingSystem.hpp"
+#include "renderer/culling/LODSelectionSystem.hpp"
 #include "renderer/debug/DebugRenderer.hpp"
 #include "resources/ResourceManager.hpp"
 
@@ -26,6 +30,7 @@ protected:
     void OnImGuiRender() override;
     void OnPostImGuiRender() override;
     void OnAppEvent(Engine::Event& e) override;
+    bool IsIdle() const override;
 
 private:
     void SetupImGuiStyle();
@@ -33,6 +38,8 @@ private:
     void RenderMenuBar();
     void HandleShortcuts();
     void CreateDefaultScene();
+    void SaveScene();
+    void OpenScene();
     void InitializeRenderingSystems();
     void ShutdownRenderingSystems();
 
@@ -63,6 +70,8 @@ private:
     // Rendering systems
     Engine::Scope<Engine::DeferredLightingSystem> m_LightingSystem;
     Engine::Scope<Engine::ShadowMapSystem> m_ShadowSystem;
+    Engine::Scope<Engine::CullingSystem> m_CullingSystem;
+    Engine::Scope<Engine::LODSelectionSystem> m_LODSystem;
     Engine::Scope<Engine::DebugRenderer> m_DebugRenderer;
 
     // Resources
@@ -70,8 +79,7 @@ private:
     Engine::Ref<Engine::Mesh> m_SphereMesh;
     Engine::Ref<Engine::Mesh> m_PlaneMesh;
     Engine::Ref<Engine::Mesh> m_CylinderMesh;
-    Engine::Ref<Engine::Shader> m_TonemapShader;
-    Engine::Ref<Engine::VertexArray> m_ScreenQuadVAO;
+    Engine::Scope<Engine::PostProcessStack> m_PostProcess;
 
     // Viewport framebuffer
     Engine::Scope<Engine::Framebuffer> m_ViewportFramebuffer;
@@ -79,6 +87,12 @@ private:
     // Scene snapshot for play mode
     Engine::Scope<SceneSnapshot> m_SceneSnapshot;
 
+    UndoHistory m_UndoHistory;
+
+    // Scene file, streamed in over several frames when opened
+    Engine::String m_ScenePath = "scenes/untitled.pvscene";
+    Engine::SceneLoader m_SceneLoader;
+
     bool m_ShowDemoWindow = false;
 };
 
@@ -1,10 +1,16 @@
 #pragma once
 
 #include "core/Types.hpp"
+#include "core/FrameStats.hpp"
 #include "ecs/Registry.hpp"
+#include "ecs/TransformSystem.hpp"
+#include "UndoHistory.hpp"
 #include "camera/CameraManager.hpp"
 #include "renderer/lighting/DeferredLightingSystem.hpp"
 #include "renderer/shadows/ShadowMapSystem.hpp"
+#include "renderer/culling/CullingSystem.hpp"
+#include "renderer/culling/LODSelectionSystem.hpp"
+#include "renderer/pipeline/PostProcessStack.hpp"
 #include "renderer/debug/DebugRenderer.hpp"
 #include <glm/glm.hpp>
 #include <entt/entt.hpp>
@@ -65,18 +71,29 @@ struct EditorContext {
     Engine::DebugView CurrentDebugView = Engine::DebugView::None;
 
     // Rendering settings
-    float Exposure = 1.0f;
-    float Gamma = 2.2f;
     bool ShadowsEnabled = true;
-    bool VSyncEnabled = true;
+    bool FrustumCullingEnabled = true;
     bool WireframeMode = false;
 
+    // Idle rendering: in Edit mode the viewport redraws only when something
+    // it shows changed, and without input the editor drops to IdleFrameRate
+    bool IdleRendering = true;
+    float IdleFrameRate = 10.0f;
+    bool ViewportRedrawPending = false;     // Set by ViewportPanel
+    bool ThumbnailsPending = false;         // Set by AssetBrowserPanel while thumbnails are on their way
+
     // References to engine systems (set by Editor)
     Engine::Registry* Registry = nullptr;
     Engine::CameraManager* CameraManager = nullptr;
+    Engine::TransformSystem* TransformSystem = nullptr;     // Batched multi-selection edits
     Engine::DeferredLightingSystem* LightingSystem = nullptr;
     Engine::ShadowMapSystem* ShadowSystem = nullptr;
+    Engine::CullingSystem* CullingSystem = nullptr;
+    Engine::LODSelectionSystem* LODSystem = nullptr;
+    Engine::PostProcessStack* PostProcess = nullptr;    // Exposure, bloom, grading, tonemapping
     Engine::DebugRenderer* DebugRenderer = nullptr;
+    Engine::FrameStats* FrameStats = nullptr;
+    UndoHistory* History = nullptr;     // Edit mode changes only
 
     // Helper methods
     bool HasSelection() const { return SelectedEntity != entt::null; }
@@ -1,132 +1,287 @@
 #include "SceneSnapshot.hpp"
 #include "ecs/Components/Transform.hpp"
+#include "ecs/Components/TransformSoA.hpp"
 #include "ecs/Components/Renderable.hpp"
 #include "ecs/Components/Hierarchy.hpp"
 #include "ecs/Components/LightComponents.hpp"
+#include "ecs/Components/NameComponent.hpp"
+#include "ecs/Components/Animation.hpp"
+#include "ecs/Components/ParticleEmitterComponent.hpp"
+#include <algorithm>
+#include <concepts>
+#include <cstring>
+#include <type_traits>
 
 namespace Editor {
 
-void SceneSnapshot::Capture(Engine::Registry& registry) {
-    m_SnapshotRegistry.clear();
+using namespace Engine;
 
-    auto& srcRegistry = registry.Raw();
+// Per type copy of a component pool, in the pool's packed order
+class SceneSnapshot::PoolSnapshot {
+public:
+    virtual ~PoolSnapshot() = default;
 
-    // Clone all entities and their components
-    // Use view to iterate all entities with Transform (all entities should have Transform)
-    auto view = srcRegistry.view<Engine::Transform>();
-    for (auto entity : view) {
-        auto newEntity = m_SnapshotRegistry.create(entity);
+    virtual void Capture(entt::registry& registry) = 0;
 
-        // Copy Transform
-        if (auto* comp = srcRegistry.try_get<Engine::Transform>(entity)) {
-            m_SnapshotRegistry.emplace<Engine::Transform>(newEntity, *comp);
-        }
+    // The registry holds the captured entities and nothing else; put the
+    // captured contents back, leaving the pool alone when they still match
+    enum class Result { Unchanged, WrittenBack, Rebuilt };
+    virtual Result Restore(entt::registry& registry, bool entitiesRebuilt) = 0;
+
+    virtual usize GetCapturedBytes() const = 0;
+    virtual void Clear() = 0;
+};
+
+namespace {
+
+// Components pointing at an object a system owns and frees together with
+// the component. They are captured without the pointer and always restored
+// by rebuilding the pool: on_destroy lets the system free the live objects,
+// and it creates new ones for the restored components on its next update.
+template<typename T>
+constexpr bool HasSystemOwnedState = false;
 
-        // Copy MeshComponent
-        if (auto* comp = srcRegistry.try_get<Engine::MeshComponent>(entity)) {
-            m_SnapshotRegistry.emplace<Engine::MeshComponent>(newEntity, *comp);
+template<>
+constexpr bool HasSystemOwnedState<ParticleEmitterComponent> = true;
+
+void ClearSystemOwnedState(ParticleEmitterComponent& component) {
+    component.Emitter = nullptr;
+}
+
+template<typename T>
+class TypedPoolSnapshot final : public SceneSnapshot::PoolSnapshot {
+public:
+    void Capture(entt::registry& registry) override {
+        auto& storage = registry.storage<T>();
+        const usize count = storage.size();
+        m_Entities.assign(storage.data(), storage.data() + count);
+
+        if constexpr (!IsTag) {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                m_Values.resize(count);
+                ForEachPage(count, [&](usize first, usize n) {
+                    std::memcpy(m_Values.data() + first, storage.raw()[first / PageSize], n * sizeof(T));
+                });
+            } else {
+                m_Values.clear();
+                m_Values.reserve(count);
+                for (usize i = 0; i < count; i++) {
+                    m_Values.push_back(storage.raw()[i / PageSize][i % PageSize]);
+                }
+            }
+            if constexpr (HasSystemOwnedState<T>) {
+                for (T& value : m_Values) {
+                    ClearSystemOwnedState(value);
+                }
+            }
         }
+    }
+
+    Result Restore(entt::registry& registry, bool entitiesRebuilt) override {
+        auto& storage = registry.storage<T>();
+        const usize count = m_Entities.size();
 
-        // Copy MaterialComponent
-        if (auto* comp = srcRegistry.try_get<Engine::MaterialComponent>(entity)) {
-            m_SnapshotRegistry.emplace<Engine::MaterialComponent>(newEntity, *comp);
+        // Same entities in the same packed slots: only the contents can differ
+        const bool inPlace = !entitiesRebuilt && !HasSystemOwnedState<T>;
+        if (inPlace && storage.size() == count &&
+            std::equal(m_Entities.begin(), m_Entities.end(), storage.data())) {
+            if constexpr (IsTag) {
+                return Result::Unchanged;
+            } else {
+                if (Matches(storage)) {
+                    return Result::Unchanged;
+                }
+                if constexpr (std::is_trivially_copyable_v<T>) {
+                    ForEachPage(count, [&](usize first, usize n) {
+                        std::memcpy(storage.raw()[first / PageSize], m_Values.data() + first, n * sizeof(T));
+                    });
+                } else {
+                    for (usize i = 0; i < count; i++) {
+                        storage.raw()[i / PageSize][i % PageSize] = m_Values[i];
+                    }
+                }
+                NotifyWrittenBack(registry);
+                return Result::WrittenBack;
+            }
         }
 
-        // Copy Renderable
-        if (auto* comp = srcRegistry.try_get<Engine::Renderable>(entity)) {
-            m_SnapshotRegistry.emplace<Engine::Renderable>(newEntity, *comp);
+        // Same entities, reordered (a system sorted the pool)
+        if (inPlace && storage.size() == count &&
+            std::all_of(m_Entities.begin(), m_Entities.end(),
+                        [&](entt::entity entity) { return storage.contains(entity); })) {
+            if constexpr (IsTag) {
+                return Result::Unchanged;
+            } else {
+                for (usize i = 0; i < count; i++) {
+                    storage.get(m_Entities[i]) = m_Values[i];
+                }
+                NotifyWrittenBack(registry);
+                return Result::WrittenBack;
+            }
         }
 
-        // Copy Hierarchy
-        if (auto* comp = srcRegistry.try_get<Engine::Hierarchy>(entity)) {
-            m_SnapshotRegistry.emplace<Engine::Hierarchy>(newEntity, *comp);
+        storage.clear();
+        if constexpr (IsTag) {
+            storage.insert(m_Entities.begin(), m_Entities.end());
+        } else {
+            storage.insert(m_Entities.begin(), m_Entities.end(), m_Values.begin());
         }
+        return Result::Rebuilt;
+    }
 
-        // Copy DirectionalLightComponent
-        if (auto* comp = srcRegistry.try_get<Engine::DirectionalLightComponent>(entity)) {
-            m_SnapshotRegistry.emplace<Engine::DirectionalLightComponent>(newEntity, *comp);
+    usize GetCapturedBytes() const override {
+        if constexpr (IsTag) {
+            return m_Entities.size() * sizeof(entt::entity);
+        } else {
+            return m_Entities.size() * (sizeof(entt::entity) + sizeof(T));
         }
+    }
+
+    void Clear() override {
+        m_Entities = {};
+        m_Values = {};
+    }
+
+private:
+    // Tags have no component storage, only their entities
+    static constexpr usize PageSize = entt::component_traits<T>::page_size;
+    static constexpr bool IsTag = PageSize == 0;
+
+    // Packed arrays with holes would not line up with the entity list
+    static_assert(!entt::component_traits<T>::in_place_delete,
+                  "Snapshotted components must not use in-place deletion");
 
-        // Copy PointLightComponent
-        if (auto* comp = srcRegistry.try_get<Engine::PointLightComponent>(entity)) {
-            m_SnapshotRegistry.emplace<Engine::PointLightComponent>(newEntity, *comp);
+    template<typename Func>
+    static void ForEachPage(usize count, Func&& func) {
+        for (usize first = 0; first < count; first += PageSize) {
+            func(first, std::min(PageSize, count - first));
         }
+    }
 
-        // Copy SpotLightComponent
-        if (auto* comp = srcRegistry.try_get<Engine::SpotLightComponent>(entity)) {
-            m_SnapshotRegistry.emplace<Engine::SpotLightComponent>(newEntity, *comp);
+    // Written back in place, which no signal sees; patch for on_update
+    // listeners (ChangeSet) if there are any. Rebuilt pools already fire
+    // on_destroy / on_construct.
+    void NotifyWrittenBack(entt::registry& registry) const {
+        if (registry.on_update<T>().empty()) return;
+        for (entt::entity entity : m_Entities) {
+            registry.patch<T>(entity);
         }
+    }
 
-        // Copy AmbientLightComponent
-        if (auto* comp = srcRegistry.try_get<Engine::AmbientLightComponent>(entity)) {
-            m_SnapshotRegistry.emplace<Engine::AmbientLightComponent>(newEntity, *comp);
+    bool Matches(const entt::storage_for_t<T>& storage) const {
+        const usize count = m_Values.size();
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            bool equal = true;
+            ForEachPage(count, [&](usize first, usize n) {
+                equal = equal && std::memcmp(storage.raw()[first / PageSize], m_Values.data() + first,
+                                             n * sizeof(T)) == 0;
+            });
+            return equal;
+        } else if constexpr (std::equality_comparable<T>) {
+            for (usize i = 0; i < count; i++) {
+                if (!(storage.raw()[i / PageSize][i % PageSize] == m_Values[i])) {
+                    return false;
+                }
+            }
+            return true;
+        } else {
+            return false;   // No way to tell, always written back
         }
     }
 
-    m_HasSnapshot = true;
+private:
+    Vector<entt::entity> m_Entities;
+    Vector<T> m_Values;
+};
+
+// Every component the editor and play mode put on scene entities. A
+// Restore that rebuilds the registry loses any component not listed here,
+// so new authored components belong on this list. Derived state that its
+// system rebuilds every frame (SubtreeBounds, PreviousWorldTransform) is
+// left out.
+using SnapshotComponents = entt::type_list<
+    Transform, LocalTransform, WorldTransform, TransformDirty, TransformInterpolation,
+    Hierarchy, RootEntity, NameComponent,
+    MeshComponent, MaterialComponent, Renderable,
+    NeedsCulling, StaticGeometry, DynamicGeometry,
+    DirectionalLightComponent, PointLightComponent, SpotLightComponent, AmbientLightComponent,
+    AnimatorComponent, SkinnedMeshComponent, ParticleEmitterComponent>;
+
+template<typename... Components>
+void AddPools(Vector<Scope<SceneSnapshot::PoolSnapshot>>& pools, entt::type_list<Components...>) {
+    (pools.push_back(CreateScope<TypedPoolSnapshot<Components>>()), ...);
 }
 
-void SceneSnapshot::Restore(Engine::Registry& registry) {
-    if (!m_HasSnapshot) return;
+} // namespace
 
-    auto& dstRegistry = registry.Raw();
-    dstRegistry.clear();
+SceneSnapshot::SceneSnapshot() {
+    AddPools(m_Pools, SnapshotComponents{});
+}
 
-    // Restore from snapshot - iterate over all entities with Transform
-    auto view = m_SnapshotRegistry.view<Engine::Transform>();
-    for (auto entity : view) {
-        auto newEntity = dstRegistry.create(entity);
+SceneSnapshot::~SceneSnapshot() = default;
 
-        // Restore Transform
-        if (auto* comp = m_SnapshotRegistry.try_get<Engine::Transform>(entity)) {
-            dstRegistry.emplace<Engine::Transform>(newEntity, *comp);
-        }
+void SceneSnapshot::Capture(Engine::Registry& registry) {
+    auto& srcRegistry = registry.Raw();
 
-        // Restore MeshComponent
-        if (auto* comp = m_SnapshotRegistry.try_get<Engine::MeshComponent>(entity)) {
-            dstRegistry.emplace<Engine::MeshComponent>(newEntity, *comp);
-        }
+    m_Entities.clear();
+    for (auto [entity] : srcRegistry.storage<entt::entity>().each()) {
+        m_Entities.push_back(entity);
+    }
 
-        // Restore MaterialComponent
-        if (auto* comp = m_SnapshotRegistry.try_get<Engine::MaterialComponent>(entity)) {
-            dstRegistry.emplace<Engine::MaterialComponent>(newEntity, *comp);
-        }
+    m_Stats = {};
+    m_Stats.Entities = static_cast<u32>(m_Entities.size());
+    m_Stats.Pools = static_cast<u32>(m_Pools.size());
+    for (auto& pool : m_Pools) {
+        pool->Capture(srcRegistry);
+        m_Stats.CapturedBytes += pool->GetCapturedBytes();
+    }
 
-        // Restore Renderable
-        if (auto* comp = m_SnapshotRegistry.try_get<Engine::Renderable>(entity)) {
-            dstRegistry.emplace<Engine::Renderable>(newEntity, *comp);
-        }
+    m_HasSnapshot = true;
+}
 
-        // Restore Hierarchy
-        if (auto* comp = m_SnapshotRegistry.try_get<Engine::Hierarchy>(entity)) {
-            dstRegistry.emplace<Engine::Hierarchy>(newEntity, *comp);
-        }
+void SceneSnapshot::Restore(Engine::Registry& registry) {
+    if (!m_HasSnapshot) return;
 
-        // Restore DirectionalLightComponent
-        if (auto* comp = m_SnapshotRegistry.try_get<Engine::DirectionalLightComponent>(entity)) {
-            dstRegistry.emplace<Engine::DirectionalLightComponent>(newEntity, *comp);
-        }
+    auto& dstRegistry = registry.Raw();
 
-        // Restore PointLightComponent
-        if (auto* comp = m_SnapshotRegistry.try_get<Engine::PointLightComponent>(entity)) {
-            dstRegistry.emplace<Engine::PointLightComponent>(newEntity, *comp);
-        }
+    // Entities created or destroyed during play (a destroyed one is no
+    // longer valid with its captured version) rebuild the registry
+    usize alive = 0;
+    for ([[maybe_unused]] auto [entity] : dstRegistry.storage<entt::entity>().each()) {
+        alive++;
+    }
+    bool rebuild = alive != m_Entities.size();
+    for (usize i = 0; !rebuild && i < m_Entities.size(); i++) {
+        rebuild = !dstRegistry.valid(m_Entities[i]);
+    }
 
-        // Restore SpotLightComponent
-        if (auto* comp = m_SnapshotRegistry.try_get<Engine::SpotLightComponent>(entity)) {
-            dstRegistry.emplace<Engine::SpotLightComponent>(newEntity, *comp);
+    if (rebuild) {
+        dstRegistry.clear();
+        for (entt::entity entity : m_Entities) {
+            dstRegistry.create(entity);
         }
+    }
 
-        // Restore AmbientLightComponent
-        if (auto* comp = m_SnapshotRegistry.try_get<Engine::AmbientLightComponent>(entity)) {
-            dstRegistry.emplace<Engine::AmbientLightComponent>(newEntity, *comp);
+    m_Stats.PoolsUnchanged = 0;
+    m_Stats.PoolsWrittenBack = 0;
+    m_Stats.PoolsRebuilt = 0;
+    m_Stats.EntitiesRebuilt = rebuild;
+    for (auto& pool : m_Pools) {
+        switch (pool->Restore(dstRegistry, rebuild)) {
+            case PoolSnapshot::Result::Unchanged:   m_Stats.PoolsUnchanged++; break;
+            case PoolSnapshot::Result::WrittenBack: m_Stats.PoolsWrittenBack++; break;
+            case PoolSnapshot::Result::Rebuilt:     m_Stats.PoolsRebuilt++; break;
         }
     }
 }
 
 void SceneSnapshot::Clear() {
-    m_SnapshotRegistry.clear();
+    m_Entities = {};
+    for (auto& pool : m_Pools) {
+        pool->Clear();
+    }
     m_HasSnapshot = false;
+    m_Stats = {};
 }
 
 } // namespace Editor
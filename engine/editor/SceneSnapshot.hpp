@@ -1,13 +1,30 @@
 #pragma once
 
 #include "ecs/Registry.hpp"
+#include "core/Types.hpp"
 #include <entt/entt.hpp>
 
 namespace Editor {
 
-// Captures and restores scene state for Play mode
+// Captures and restores scene state for Play mode.
+//
+// Capture copies every snapshotted component pool as a whole: its packed
+// entity array and its components, page by page with memcpy for trivially
+// copyable types. Entity identifiers (index and version) are kept, so
+// references such as Hierarchy links survive the round trip.
+//
+// Restore is copy-on-write in reverse: pools whose entities and contents
+// are still those captured are left alone, and pools holding the same
+// entities are written back in place. Only when play created or destroyed
+// entities is the registry rebuilt, and even then pool by pool in bulk.
 class SceneSnapshot {
 public:
+    SceneSnapshot();
+    ~SceneSnapshot();
+
+    SceneSnapshot(const SceneSnapshot&) = delete;
+    SceneSnapshot& operator=(const SceneSnapshot&) = delete;
+
     // Take a snapshot of the current scene state
     void Capture(Engine::Registry& registry);
 
@@ -20,9 +37,27 @@ public:
     // Clear the snapshot
     void Clear();
 
+    struct Stats {
+        Engine::u32 Entities = 0;
+        Engine::u32 Pools = 0;            // Snapshotted component types
+        Engine::usize CapturedBytes = 0;  // Component data held by the snapshot
+
+        // Last Restore
+        Engine::u32 PoolsUnchanged = 0;   // Still as captured, not touched
+        Engine::u32 PoolsWrittenBack = 0; // Same entities, contents copied back
+        Engine::u32 PoolsRebuilt = 0;     // Entities changed, pool refilled
+        bool EntitiesRebuilt = false;     // Play created or destroyed entities
+    };
+    const Stats& GetStats() const { return m_Stats; }
+
+    // Copy of one component pool; implemented per type in SceneSnapshot.cpp
+    class PoolSnapshot;
+
 private:
-    entt::registry m_SnapshotRegistry;
+    Engine::Vector<Engine::Scope<PoolSnapshot>> m_Pools;
+    Engine::Vector<entt::entity> m_Entities;   // Every entity in use, with its version
     bool m_HasSnapshot = false;
+    Stats m_Stats;
 };
 
 } // namespace Editor
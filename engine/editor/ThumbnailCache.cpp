@@ -0,0 +1,586 @@
+#include "ThumbnailCache.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Logger.hpp"
+#include "resources/loaders/MeshFile.hpp"
+#include "resources/loaders/MeshLoader.hpp"
+#include "resources/cooking/AssetCooker.hpp"
+#include "resources/cooking/TextureCooker.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+
+namespace Editor {
+
+using namespace Engine;
+
+namespace {
+
+// Bumped whenever thumbnails come out differently, so stale .thumb files
+// stop matching
+constexpr u64 ThumbnailVersion = 1;
+
+constexpr usize ThumbnailBytes = static_cast<usize>(ThumbnailCache::ThumbnailSize) * ThumbnailCache::ThumbnailSize * 4;
+
+// Mesh thumbnails are rasterized at this many samples per pixel edge
+constexpr u32 MeshSupersample = 2;
+
+// FNV-1a over 8-byte words, as ResourceManager hashes reloaded content
+u64 HashContent(const void* data, usize size, u64 seed) {
+    const u8* bytes = static_cast<const u8*>(data);
+    u64 hash = 14695981039346656037ull ^ seed;
+    usize i = 0;
+    for (; i + sizeof(u64) <= size; i += sizeof(u64)) {
+        u64 word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+bool ReadFile(const std::filesystem::path& path, Vector<u8>& bytes) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+
+    const std::streamsize size = file.tellg();
+    if (size <= 0) return false;
+
+    bytes.resize(static_cast<usize>(size));
+    file.seekg(0);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(bytes.data()), size));
+}
+
+bool IsTextureFile(const std::filesystem::path& path) {
+    static const char* const extensions[] = {".png", ".jpg", ".jpeg", ".tga", ".bmp", ".ktx2", ".dds"};
+    const String extension = path.extension().string();
+    return std::any_of(std::begin(extensions), std::end(extensions),
+                       [&](const char* candidate) { return extension == candidate; });
+}
+
+bool IsMeshFile(const std::filesystem::path& path) {
+    return path.extension() == ".obj" || MeshFile::IsMeshFile(path.string());
+}
+
+// Channel c of pixel (x, y) of an uncompressed 8-bit or 32-bit float level
+f32 FetchChannel(const u8* pixels, bool isFloat, u32 channels, u32 width, u32 x, u32 y, u32 c) {
+    const usize index = (static_cast<usize>(y) * width + x) * channels + c;
+    if (!isFloat) {
+        return pixels[index] / 255.0f;
+    }
+
+    f32 value;
+    std::memcpy(&value, pixels + index * sizeof(f32), sizeof(value));
+    return value / (1.0f + std::max(value, 0.0f));  // HDR into [0, 1)
+}
+
+// Box-filtered fit of the image into the thumbnail, centered, transparent
+// around it. Uncompressed 8-bit and 32-bit float images only.
+Vector<u8> DownsampleTexture(const Vector<u8>& bytes, const String& path) {
+    // Top row first, as ImGui::Image samples the atlas
+    TextureImage image = TextureImage::Decode(bytes.data(), bytes.size(), path, false);
+    if (!image.IsValid()) return {};
+
+    bool isFloat = false;
+    switch (image.Format) {
+        case TextureFormat::R8: case TextureFormat::RG8: case TextureFormat::RGB8: case TextureFormat::RGBA8:
+            break;
+        case TextureFormat::R32F: case TextureFormat::RG32F: case TextureFormat::RGB32F: case TextureFormat::RGBA32F:
+            isFloat = true;
+            break;
+        default:
+            return {};
+    }
+
+    // With a stored chain, the smallest level still covering the thumbnail
+    u32 width = image.Width;
+    u32 height = image.Height;
+    const u8* pixels = image.Pixels.data();
+    for (u32 level = 1; level < image.Levels.size(); ++level) {
+        const u32 levelWidth = std::max(image.Width >> level, 1u);
+        const u32 levelHeight = std::max(image.Height >> level, 1u);
+        if (std::max(levelWidth, levelHeight) < ThumbnailCache::ThumbnailSize) break;
+        width = levelWidth;
+        height = levelHeight;
+        pixels = image.Pixels.data() + image.Levels[level].Offset;
+    }
+
+    const u32 channels = image.GetChannelCount();
+    const u32 size = ThumbnailCache::ThumbnailSize;
+    const f32 scale = static_cast<f32>(size) / static_cast<f32>(std::max(width, height));
+    const u32 fitWidth = std::clamp(static_cast<u32>(std::lround(width * scale)), 1u, size);
+    const u32 fitHeight = std::clamp(static_cast<u32>(std::lround(height * scale)), 1u, size);
+    const u32 left = (size - fitWidth) / 2;
+    const u32 top = (size - fitHeight) / 2;
+
+    Vector<u8> out(ThumbnailBytes, 0);
+    for (u32 y = 0; y < fitHeight; ++y) {
+        const u32 y0 = static_cast<u32>(static_cast<u64>(y) * height / fitHeight);
+        const u32 y1 = std::max(y0 + 1, static_cast<u32>(static_cast<u64>(y + 1) * height / fitHeight));
+
+        for (u32 x = 0; x < fitWidth; ++x) {
+            const u32 x0 = static_cast<u32>(static_cast<u64>(x) * width / fitWidth);
+            const u32 x1 = std::max(x0 + 1, static_cast<u32>(static_cast<u64>(x + 1) * width / fitWidth));
+
+            glm::vec4 sum(0.0f);
+            for (u32 sy = y0; sy < y1; ++sy) {
+                for (u32 sx = x0; sx < x1; ++sx) {
+                    glm::vec4 texel(0.0f, 0.0f, 0.0f, 1.0f);
+                    for (u32 c = 0; c < channels; ++c) {
+                        texel[c] = FetchChannel(pixels, isFloat, channels, width, sx, sy, c);
+                    }
+                    if (channels == 1) {
+                        texel.g = texel.b = texel.r;
+                    }
+                    sum += texel;
+                }
+            }
+
+            const glm::vec4 average = sum / static_cast<f32>((x1 - x0) * (y1 - y0));
+            u8* target = &out[((static_cast<usize>(top + y) * size) + left + x) * 4];
+            for (u32 c = 0; c < 4; ++c) {
+                target[c] = static_cast<u8>(std::clamp(average[c], 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+        }
+    }
+
+    return out;
+}
+
+// LOD 0 of a cooked mesh, positions decoded from either vertex format
+bool ReadMeshFile(const String& path, Vector<glm::vec3>& positions, Vector<u32>& indices) {
+    MeshFile file;
+    if (!file.Open(path)) return false;
+
+    const MeshGPUData& data = file.GetData();
+    positions.resize(data.VertexCount);
+    for (u32 i = 0; i < data.VertexCount; ++i) {
+        if (data.Format == VertexFormat::Full) {
+            positions[i] = static_cast<const Vertex*>(data.Vertices)[i].Position;
+        } else {
+            const u16* packed = static_cast<const PackedVertex*>(data.Vertices)[i].Position;
+            positions[i] = glm::vec3(packed[0], packed[1], packed[2]) * (data.PositionDequant.w / 65535.0f)
+                         + glm::vec3(data.PositionDequant);
+        }
+    }
+
+    const u32 first = data.LODs ? data.LODs[0].IndexOffset : 0;
+    const u32 count = data.LODs ? data.LODs[0].IndexCount : data.IndexCount;
+    indices.assign(data.Indices + first, data.Indices + first + count);
+    return true;
+}
+
+// Flat-shaded, depth-tested orthographic view of the bounding sphere from
+// the front right, above
+Vector<u8> RasterizeMesh(const String& path) {
+    Vector<glm::vec3> positions;
+    Vector<u32> indices;
+    if (MeshFile::IsMeshFile(path)) {
+        if (!ReadMeshFile(path, positions, indices)) return {};
+    } else {
+        MeshLoadOptions options;
+        options.GenerateTangents = false;
+        options.Optimize = false;
+        options.Residency = MeshResidency::KeepCPU;
+        Ref<Mesh> mesh = MeshLoader::LoadOBJ(path, options);
+        if (!mesh) return {};
+
+        positions.reserve(mesh->GetVertices().size());
+        for (const Vertex& vertex : mesh->GetVertices()) {
+            positions.push_back(vertex.Position);
+        }
+        indices = mesh->GetIndices();
+    }
+    if (positions.empty() || indices.size() < 3) return {};
+
+    glm::vec3 minimum(positions[0]);
+    glm::vec3 maximum(positions[0]);
+    for (const glm::vec3& position : positions) {
+        minimum = glm::min(minimum, position);
+        maximum = glm::max(maximum, position);
+    }
+    const glm::vec3 center = (minimum + maximum) * 0.5f;
+    f32 radius = 0.0f;
+    for (const glm::vec3& position : positions) {
+        radius = std::max(radius, glm::length(position - center));
+    }
+    if (radius <= 0.0f) return {};
+
+    const glm::vec3 direction = glm::normalize(glm::vec3(0.6f, 0.5f, 0.8f));   // Toward the viewer
+    const glm::vec3 right = glm::normalize(glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), direction));
+    const glm::vec3 up = glm::cross(direction, right);
+    const glm::vec3 light = glm::normalize(direction + up * 0.6f - right * 0.3f);
+
+    const u32 size = ThumbnailCache::ThumbnailSize * MeshSupersample;
+    const f32 half = size * 0.5f;
+    Vector<f32> depth(static_cast<usize>(size) * size, -1e30f);
+    Vector<f32> shade(static_cast<usize>(size) * size, -1.0f);  // Negative: uncovered
+
+    // Screen x right, y down; z toward the viewer
+    Vector<glm::vec3> projected(positions.size());
+    for (usize i = 0; i < positions.size(); ++i) {
+        const glm::vec3 offset = (positions[i] - center) / radius;
+        projected[i] = glm::vec3(half + glm::dot(offset, right) * half * 0.95f,
+                                 half - glm::dot(offset, up) * half * 0.95f,
+                                 glm::dot(offset, direction));
+    }
+
+    for (usize t = 0; t + 2 < indices.size(); t += 3) {
+        const u32 i0 = indices[t], i1 = indices[t + 1], i2 = indices[t + 2];
+        if (i0 >= positions.size() || i1 >= positions.size() || i2 >= positions.size()) continue;
+
+        glm::vec3 normal = glm::cross(positions[i1] - positions[i0], positions[i2] - positions[i0]);
+        const f32 length = glm::length(normal);
+        if (length <= 0.0f) continue;
+        normal /= length;
+        if (glm::dot(normal, direction) < 0.0f) normal = -normal;   // Two-sided
+        const f32 intensity = 0.25f + 0.75f * std::max(glm::dot(normal, light), 0.0f);
+
+        const glm::vec3& a = projected[i0];
+        const glm::vec3& b = projected[i1];
+        const glm::vec3& c = projected[i2];
+        const f32 area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        if (std::abs(area) < 1e-8f) continue;
+
+        const i32 x0 = std::max(static_cast<i32>(std::floor(std::min({a.x, b.x, c.x}))), 0);
+        const i32 y0 = std::max(static_cast<i32>(std::floor(std::min({a.y, b.y, c.y}))), 0);
+        const i32 x1 = std::min(static_cast<i32>(std::ceil(std::max({a.x, b.x, c.x}))), static_cast<i32>(size) - 1);
+        const i32 y1 = std::min(static_cast<i32>(std::ceil(std::max({a.y, b.y, c.y}))), static_cast<i32>(size) - 1);
+
+        for (i32 y = y0; y <= y1; ++y) {
+            for (i32 x = x0; x <= x1; ++x) {
+                const f32 px = x + 0.5f;
+                const f32 py = y + 0.5f;
+                const f32 w0 = ((c.x - b.x) * (py - b.y) - (c.y - b.y) * (px - b.x)) / area;
+                const f32 w1 = ((a.x - c.x) * (py - c.y) - (a.y - c.y) * (px - c.x)) / area;
+                const f32 w2 = 1.0f - w0 - w1;
+                if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+
+                const f32 z = w0 * a.z + w1 * b.z + w2 * c.z;
+                const usize index = static_cast<usize>(y) * size + x;
+                if (z <= depth[index]) continue;
+                depth[index] = z;
+                shade[index] = intensity;
+            }
+        }
+    }
+
+    // Resolve the samples; coverage goes to alpha
+    const glm::vec3 albedo(0.72f, 0.75f, 0.80f);
+    const u32 thumbnailSize = ThumbnailCache::ThumbnailSize;
+    Vector<u8> out(ThumbnailBytes, 0);
+    for (u32 y = 0; y < thumbnailSize; ++y) {
+        for (u32 x = 0; x < thumbnailSize; ++x) {
+            f32 sum = 0.0f;
+            u32 covered = 0;
+            for (u32 sy = 0; sy < MeshSupersample; ++sy) {
+                for (u32 sx = 0; sx < MeshSupersample; ++sx) {
+                    const f32 sample = shade[static_cast<usize>(y * MeshSupersample + sy) * size + x * MeshSupersample + sx];
+                    if (sample < 0.0f) continue;
+                    sum += sample;
+                    covered++;
+                }
+            }
+            if (covered == 0) continue;
+
+            const glm::vec3 color = albedo * (sum / covered);
+            u8* target = &out[(static_cast<usize>(y) * thumbnailSize + x) * 4];
+            target[0] = static_cast<u8>(std::clamp(color.r, 0.0f, 1.0f) * 255.0f + 0.5f);
+            target[1] = static_cast<u8>(std::clamp(color.g, 0.0f, 1.0f) * 255.0f + 0.5f);
+            target[2] = static_cast<u8>(std::clamp(color.b, 0.0f, 1.0f) * 255.0f + 0.5f);
+            target[3] = static_cast<u8>(covered * 255 / (MeshSupersample * MeshSupersample));
+        }
+    }
+
+    return out;
+}
+
+} // anonymous namespace
+
+ThumbnailCache::ThumbnailCache(const String& cacheDirectory)
+    : m_CacheDirectory(cacheDirectory)
+    , m_Shared(CreateRef<Shared>())
+{
+    TextureSpecification spec;
+    spec.Width = ThumbnailSize * AtlasSlotsPerSide;
+    spec.Height = ThumbnailSize * AtlasSlotsPerSide;
+    spec.Format = TextureFormat::RGBA8;
+    spec.WrapS = TextureWrap::ClampToEdge;
+    spec.WrapT = TextureWrap::ClampToEdge;
+    spec.GenerateMipmaps = false;
+    m_Atlas = CreateScope<Texture2D>(spec);
+
+    m_Slots.resize(AtlasSlotsPerSide * AtlasSlotsPerSide);
+
+    std::error_code error;
+    std::filesystem::create_directories(m_CacheDirectory, error);
+    if (error) {
+        LOG_CORE_WARN("ThumbnailCache: can't create {}, thumbnails won't be kept", m_CacheDirectory);
+    }
+}
+
+ThumbnailCache::~ThumbnailCache() {
+    // Jobs still queued skip their work; running ones finish into m_Shared
+    m_Shared->Cancelled = true;
+}
+
+void ThumbnailCache::Rescan(const String& directory, const Vector<String>& skipped) {
+    if (m_Scanning) return;
+    m_Scanning = true;
+
+    Vector<String> excluded = skipped;
+    excluded.push_back(m_CacheDirectory);
+
+    JobSystem::Submit([shared = m_Shared, directory, excluded] {
+        Vector<Asset> scanned[2];
+
+        std::unordered_set<String> excludedPaths;
+        for (const String& path : excluded) {
+            excludedPaths.insert(std::filesystem::path(path).lexically_normal().generic_string());
+        }
+
+        const std::filesystem::path root(directory);
+        std::error_code error;
+        auto options = std::filesystem::directory_options::skip_permission_denied;
+        for (auto it = std::filesystem::recursive_directory_iterator(root, options, error);
+             !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+            if (shared->Cancelled) return;
+
+            const std::filesystem::path& path = it->path();
+            if (it->is_directory(error)) {
+                if (excludedPaths.count(path.lexically_normal().generic_string())) {
+                    it.disable_recursion_pending();
+                }
+                continue;
+            }
+
+            const bool texture = IsTextureFile(path);
+            if (!texture && !IsMeshFile(path)) continue;
+
+            const AssetKind kind = texture ? AssetKind::Texture : AssetKind::Mesh;
+            scanned[static_cast<u32>(kind)].push_back({path.string(), path.lexically_relative(root).generic_string(), kind});
+        }
+
+        // Cooked siblings of listed sources would show the same asset twice
+        std::unordered_set<String> cooked;
+        for (const Asset& asset : scanned[static_cast<u32>(AssetKind::Texture)]) {
+            if (std::filesystem::path(asset.Path).extension() != ".ktx2") {
+                cooked.insert(TextureCooker::GetCookedPath(asset.Path));
+            }
+        }
+        for (const Asset& asset : scanned[static_cast<u32>(AssetKind::Mesh)]) {
+            if (!MeshFile::IsMeshFile(asset.Path)) {
+                cooked.insert(AssetCooker::GetCookedMeshPath(asset.Path, MeshLoadOptions{}));
+            }
+        }
+
+        for (Vector<Asset>& assets : scanned) {
+            assets.erase(std::remove_if(assets.begin(), assets.end(),
+                                        [&](const Asset& asset) { return cooked.count(asset.Path) > 0; }),
+                         assets.end());
+            std::sort(assets.begin(), assets.end(), [](const Asset& a, const Asset& b) { return a.Name < b.Name; });
+        }
+
+        std::lock_guard<std::mutex> lock(shared->Mutex);
+        shared->Scanned[0] = std::move(scanned[0]);
+        shared->Scanned[1] = std::move(scanned[1]);
+        shared->ScanDone = true;
+    });
+}
+
+bool ThumbnailCache::IsScanning() const {
+    return m_Scanning;
+}
+
+const Vector<ThumbnailCache::Asset>& ThumbnailCache::GetAssets(AssetKind kind) const {
+    return m_Assets[static_cast<u32>(kind)];
+}
+
+bool ThumbnailCache::Request(const Asset& asset, Region& region) {
+    auto [it, inserted] = m_Thumbnails.try_emplace(asset.Path);
+    Thumbnail& thumbnail = it->second;
+    thumbnail.LastRequested = m_Frame;
+
+    if (inserted) {
+        thumbnail.Kind = asset.Kind;
+        m_Queue.push_back(asset.Path);
+        return false;
+    }
+    if (thumbnail.Status != State::Ready) return false;
+
+    m_Slots[thumbnail.Slot].LastRequested = m_Frame;
+
+    const f32 slotSize = 1.0f / AtlasSlotsPerSide;
+    const glm::vec2 corner(static_cast<f32>(thumbnail.Slot % AtlasSlotsPerSide),
+                           static_cast<f32>(thumbnail.Slot / AtlasSlotsPerSide));
+    region.UV0 = corner * slotSize;
+    region.UV1 = region.UV0 + glm::vec2(slotSize);
+    return true;
+}
+
+bool ThumbnailCache::IsFailed(const Asset& asset) const {
+    auto it = m_Thumbnails.find(asset.Path);
+    return it != m_Thumbnails.end() && it->second.Status == State::Failed;
+}
+
+void ThumbnailCache::Update() {
+    if (m_Scanning) {
+        std::lock_guard<std::mutex> lock(m_Shared->Mutex);
+        if (m_Shared->ScanDone) {
+            m_Assets[0] = std::move(m_Shared->Scanned[0]);
+            m_Assets[1] = std::move(m_Shared->Scanned[1]);
+            m_Shared->ScanDone = false;
+            m_Scanning = false;
+        }
+    }
+
+    TakeResults();
+    StartJobs();
+
+    m_Stats.Queued = static_cast<u32>(m_Queue.size());
+    m_Stats.InFlight = m_InFlight;
+    m_Frame++;
+}
+
+void ThumbnailCache::StartJobs() {
+    // Enough to keep the workers busy, few enough that a scroll reprioritizes quickly
+    const u32 maxInFlight = std::max(JobSystem::GetWorkerCount(), 1u) * 2;
+
+    while (m_InFlight < maxInFlight && !m_Queue.empty()) {
+        const String path = std::move(m_Queue.back());
+        m_Queue.pop_back();
+
+        auto it = m_Thumbnails.find(path);
+        if (it == m_Thumbnails.end() || it->second.Status != State::Queued) continue;
+
+        // Not asked for this frame or the last: off screen by now
+        if (it->second.LastRequested + 1 < m_Frame) {
+            m_Thumbnails.erase(it);
+            continue;
+        }
+
+        it->second.Status = State::Working;
+        m_InFlight++;
+
+        JobSystem::Submit([shared = m_Shared, path, kind = it->second.Kind, cacheDirectory = m_CacheDirectory] {
+            Result result;
+            result.Path = path;
+            if (!shared->Cancelled) {
+                result.Pixels = MakeThumbnail(path, kind, cacheDirectory, result.FromDisk);
+            }
+
+            std::lock_guard<std::mutex> lock(shared->Mutex);
+            shared->Results.push_back(std::move(result));
+        });
+    }
+
+    // Whatever is left waits for a later frame; drop what went off screen
+    m_Queue.erase(std::remove_if(m_Queue.begin(), m_Queue.end(), [this](const String& path) {
+        auto it = m_Thumbnails.find(path);
+        if (it == m_Thumbnails.end() || it->second.LastRequested + 1 >= m_Frame) return false;
+        m_Thumbnails.erase(it);
+        return true;
+    }), m_Queue.end());
+}
+
+void ThumbnailCache::TakeResults() {
+    Vector<Result> results;
+    {
+        std::lock_guard<std::mutex> lock(m_Shared->Mutex);
+        const usize count = std::min<usize>(m_Shared->Results.size(), MaxUploadsPerFrame);
+        results.assign(std::make_move_iterator(m_Shared->Results.begin()),
+                       std::make_move_iterator(m_Shared->Results.begin() + static_cast<std::ptrdiff_t>(count)));
+        m_Shared->Results.erase(m_Shared->Results.begin(), m_Shared->Results.begin() + static_cast<std::ptrdiff_t>(count));
+    }
+
+    for (Result& result : results) {
+        m_InFlight--;
+
+        auto it = m_Thumbnails.find(result.Path);
+        if (it == m_Thumbnails.end()) continue;
+        Thumbnail& thumbnail = it->second;
+
+        if (result.Pixels.size() != ThumbnailBytes) {
+            thumbnail.Status = State::Failed;
+            m_Stats.Failed++;
+            continue;
+        }
+
+        const u32 slot = AllocateSlot();
+        if (slot == ~0u) {
+            // Every slot is on screen; try again once one frees up
+            m_Thumbnails.erase(it);
+            continue;
+        }
+
+        m_Atlas->SetSubData(result.Pixels.data(), (slot % AtlasSlotsPerSide) * ThumbnailSize,
+                            (slot / AtlasSlotsPerSide) * ThumbnailSize, ThumbnailSize, ThumbnailSize);
+        m_Slots[slot] = {result.Path, thumbnail.LastRequested};
+        thumbnail.Status = State::Ready;
+        thumbnail.Slot = slot;
+        (result.FromDisk ? m_Stats.DiskHits : m_Stats.Generated)++;
+    }
+
+    m_Stats.Resident = static_cast<u32>(std::count_if(m_Slots.begin(), m_Slots.end(),
+                                                      [](const Slot& slot) { return !slot.Path.empty(); }));
+}
+
+u32 ThumbnailCache::AllocateSlot() {
+    u32 oldest = ~0u;
+    for (u32 i = 0; i < m_Slots.size(); ++i) {
+        if (m_Slots[i].Path.empty()) return i;
+        if (m_Slots[i].LastRequested + 1 >= m_Frame) continue;   // On screen
+        if (oldest == ~0u || m_Slots[i].LastRequested < m_Slots[oldest].LastRequested) {
+            oldest = i;
+        }
+    }
+
+    // The evicted thumbnail comes back from the disk cache when asked for again
+    if (oldest != ~0u) {
+        m_Thumbnails.erase(m_Slots[oldest].Path);
+        m_Slots[oldest].Path.clear();
+    }
+    return oldest;
+}
+
+Vector<u8> ThumbnailCache::MakeThumbnail(const String& path, AssetKind kind, const String& cacheDirectory,
+                                         bool& fromDisk) {
+    Vector<u8> bytes;
+    if (!ReadFile(path, bytes)) return {};
+
+    const u64 hash = HashContent(bytes.data(), bytes.size(), (ThumbnailVersion << 8) | static_cast<u64>(kind));
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.thumb", static_cast<unsigned long long>(hash));
+    const std::filesystem::path cachePath = std::filesystem::path(cacheDirectory) / name;
+
+    Vector<u8> pixels;
+    if (ReadFile(cachePath, pixels) && pixels.size() == ThumbnailBytes) {
+        fromDisk = true;
+        return pixels;
+    }
+
+    pixels = kind == AssetKind::Texture ? DownsampleTexture(bytes, path) : RasterizeMesh(path);
+    if (pixels.empty()) return pixels;
+
+    // Written aside and renamed, so no reader sees a partial file
+    std::filesystem::path temporary = cachePath;
+    temporary += ".tmp" + std::to_string(JobSystem::GetCurrentWorkerIndex() + 1);
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, cachePath, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+
+    return pixels;
+}
+
+} // namespace Editor
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/Texture.hpp"
+#include <glm/glm.hpp>
+#include <atomic>
+#include <mutex>
+
+namespace Editor {
+
+// Asset browser thumbnails, made off the GL thread and cached on disk.
+//
+// Rescan() lists the texture and mesh files under a directory on a worker.
+// Request() is called for the thumbnails on screen: the first call queues
+// the asset, and jobs - a few at a time, newest requests first - read the
+// file, hash its contents and look for <cache>/<hash>.thumb. On a miss they
+// make the thumbnail - a box-filtered downsample of the decoded image, or a
+// small software raster of the mesh - and write it there, so an unchanged
+// file is never decoded twice, whatever it is called. Update() copies up to
+// MaxUploadsPerFrame finished thumbnails a frame into slots of one RGBA8
+// atlas, evicting the least recently requested; Request() then returns the
+// slot's coordinates.
+//
+// Queued assets that are no longer requested (scrolled away) are dropped
+// before their job starts. Request, Update and Rescan on the GL thread.
+class ThumbnailCache {
+public:
+    static constexpr Engine::u32 ThumbnailSize = 64;
+    static constexpr Engine::u32 AtlasSlotsPerSide = 16;
+    static constexpr Engine::u32 MaxUploadsPerFrame = 32;
+
+    enum class AssetKind : Engine::u8 { Texture, Mesh };
+
+    struct Asset {
+        Engine::String Path;    // Full
+        Engine::String Name;    // Relative to the scanned directory
+        AssetKind Kind;
+    };
+
+    struct Region {
+        glm::vec2 UV0;
+        glm::vec2 UV1;
+    };
+
+    struct Stats {
+        Engine::u32 Resident = 0;   // In the atlas
+        Engine::u32 Queued = 0;
+        Engine::u32 InFlight = 0;
+        Engine::u32 DiskHits = 0;   // Since creation
+        Engine::u32 Generated = 0;
+        Engine::u32 Failed = 0;
+    };
+
+    // cacheDirectory is where .thumb files go, full path
+    explicit ThumbnailCache(const Engine::String& cacheDirectory);
+    ~ThumbnailCache();
+
+    ThumbnailCache(const ThumbnailCache&) = delete;
+    ThumbnailCache& operator=(const ThumbnailCache&) = delete;
+
+    // List the assets under directory again, not descending into skipped
+    // directories (and the cache's); the old list stays until the new one
+    // is complete. Ignored while a scan is running.
+    void Rescan(const Engine::String& directory, const Engine::Vector<Engine::String>& skipped = {});
+    bool IsScanning() const;
+    const Engine::Vector<Asset>& GetAssets(AssetKind kind) const;
+
+    // Where asset's thumbnail is in the atlas; false (and queued) until it
+    // is there, or if it can't be made (IsFailed)
+    bool Request(const Asset& asset, Region& region);
+    bool IsFailed(const Asset& asset) const;
+
+    // Start jobs, take finished thumbnails into the atlas. Once a frame.
+    void Update();
+
+    // Scanning, or thumbnails queued or being made
+    bool IsBusy() const { return m_Scanning || !m_Queue.empty() || m_InFlight > 0; }
+
+    Engine::u32 GetAtlasID() const { return m_Atlas ? m_Atlas->GetRendererID() : 0; }
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    enum class State : Engine::u8 { Queued, Working, Ready, Failed };
+
+    struct Thumbnail {
+        State Status = State::Queued;
+        AssetKind Kind = AssetKind::Texture;
+        Engine::u32 Slot = 0;
+        Engine::u64 LastRequested = 0;  // Frame
+    };
+
+    struct Slot {
+        Engine::String Path;    // Empty when free
+        Engine::u64 LastRequested = 0;
+    };
+
+    struct Result {
+        Engine::String Path;
+        Engine::Vector<Engine::u8> Pixels;  // ThumbnailSize^2 RGBA8; empty on failure
+        bool FromDisk = false;
+    };
+
+    // Shared with the jobs, which may outlive the cache
+    struct Shared {
+        std::mutex Mutex;
+        Engine::Vector<Result> Results;
+        Engine::Vector<Asset> Scanned[2];
+        bool ScanDone = false;
+        std::atomic<bool> Cancelled{false};
+    };
+
+    void StartJobs();
+    void TakeResults();
+    Engine::u32 AllocateSlot();
+
+    static Engine::Vector<Engine::u8> MakeThumbnail(const Engine::String& path, AssetKind kind,
+                                                    const Engine::String& cacheDirectory, bool& fromDisk);
+
+private:
+    Engine::String m_CacheDirectory;
+    Engine::Scope<Engine::Texture2D> m_Atlas;
+    Engine::Ref<Shared> m_Shared;
+
+    Engine::Vector<Asset> m_Assets[2];     // By AssetKind
+    bool m_Scanning = false;
+
+    Engine::HashMap<Engine::String, Thumbnail> m_Thumbnails;
+    Engine::Vector<Engine::String> m_Queue;     // Newest at the back
+    Engine::Vector<Slot> m_Slots;
+    Engine::u32 m_InFlight = 0;
+    Engine::u64 m_Frame = 0;
+
+    Stats m_Stats;
+};
+
+} // namespace Editor
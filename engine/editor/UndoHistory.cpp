@@ -0,0 +1,344 @@
+#include "UndoHistory.hpp"
+#include "ecs/Components/Transform.hpp"
+#include "ecs/Components/TransformSoA.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace Editor {
+
+using namespace Engine;
+
+namespace {
+
+// Literal runs end at this many zero bytes; shorter gaps are cheaper inline
+// than as a new run header
+constexpr u32 MinZeroRun = 4;
+constexpr u32 MaxRun = 0xFFFF;
+
+void WriteU16(Vector<u8>& out, u32 value) {
+    out.push_back(static_cast<u8>(value & 0xFF));
+    out.push_back(static_cast<u8>(value >> 8));
+}
+
+u32 ReadU16(const u8* bytes) {
+    return static_cast<u32>(bytes[0]) | (static_cast<u32>(bytes[1]) << 8);
+}
+
+} // anonymous namespace
+
+UndoHistory::UndoHistory() {
+    auto& components = ComponentRegistry::Get();
+
+    // Rewritten by TransformSystem from the local transforms every update
+    const ComponentId derived[] = {components.FindId<WorldTransform>(), components.FindId<TransformDirty>()};
+
+    for (const auto& factory : components.GetAllFactories()) {
+        if (!factory.IsTag && factory.Size == 0) continue;     // Not trivially copyable
+        if (std::find(std::begin(derived), std::end(derived), factory.Id) != std::end(derived)) continue;
+        m_Recorded.push_back(factory.Id);
+    }
+}
+
+void UndoHistory::SetSettings(const Settings& settings) {
+    m_Settings = settings;
+    EnforceBudget();
+    UpdateStats();
+}
+
+const char* UndoHistory::GetUndoLabel() const {
+    return CanUndo() ? m_Steps[m_Cursor - 1].Label.c_str() : "";
+}
+
+const char* UndoHistory::GetRedoLabel() const {
+    return CanRedo() ? m_Steps[m_Cursor].Label.c_str() : "";
+}
+
+bool UndoHistory::BeginEdit(entt::registry& registry, entt::entity entity, const char* label) {
+    return BeginEdit(registry, Vector<entt::entity>{entity}, label);
+}
+
+bool UndoHistory::BeginEdit(entt::registry& registry, const Vector<entt::entity>& entities, const char* label) {
+    if (m_Editing) return false;
+
+    m_Editing = true;
+    m_EditLabel = label;
+    m_EditEntities = entities;
+    Capture(registry);
+    return true;
+}
+
+void UndoHistory::Capture(entt::registry& registry) {
+    auto& components = ComponentRegistry::Get();
+    m_Captured.clear();
+    m_Before.clear();
+
+    for (u32 e = 0; e < m_EditEntities.size(); ++e) {
+        const entt::entity entity = m_EditEntities[e];
+        if (!registry.valid(entity)) continue;
+
+        for (ComponentId id : m_Recorded) {
+            const ComponentFactory* factory = components.GetFactoryById(id);
+            if (!factory->Has(registry, entity)) continue;
+
+            m_Captured.push_back({e, id, m_Before.size()});
+            if (factory->Size > 0) {
+                const u8* bytes = static_cast<const u8*>(factory->Get(registry, entity));
+                m_Before.insert(m_Before.end(), bytes, bytes + factory->Size);
+            }
+        }
+    }
+}
+
+void UndoHistory::CancelEdit() {
+    m_Editing = false;
+    m_EditEntities.clear();
+    m_Captured.clear();
+    m_Before.clear();
+}
+
+void UndoHistory::EndEdit(entt::registry& registry) {
+    if (!m_Editing) return;
+
+    auto& components = ComponentRegistry::Get();
+    m_Staging.clear();
+    u32 records = 0;
+    usize rawBytes = 0;
+
+    usize next = 0;     // Into m_Captured, which is in the same order as the walk below
+    for (u32 e = 0; e < m_EditEntities.size(); ++e) {
+        const entt::entity entity = m_EditEntities[e];
+        const bool valid = registry.valid(entity);
+
+        for (ComponentId id : m_Recorded) {
+            const Captured* before = nullptr;
+            if (next < m_Captured.size() && m_Captured[next].EntityIndex == e && m_Captured[next].Component == id) {
+                before = &m_Captured[next++];
+            }
+            if (!valid) continue;   // Destroyed meanwhile; not recorded
+
+            const ComponentFactory* factory = components.GetFactoryById(id);
+            const bool has = factory->Has(registry, entity);
+            const u32 size = factory->Size;
+            const u8* current = has && size > 0 ? static_cast<const u8*>(factory->Get(registry, entity)) : nullptr;
+
+            if (before && has) {
+                if (size == 0) continue;
+
+                m_Scratch.resize(size);
+                const u8* old = m_Before.data() + before->Offset;
+                bool changed = false;
+                for (u32 i = 0; i < size; ++i) {
+                    m_Scratch[i] = old[i] ^ current[i];
+                    changed |= m_Scratch[i] != 0;
+                }
+                if (!changed) continue;
+
+                AppendRecord(entity, id, RecordKind::Modified, m_Scratch.data(), size);
+            } else if (before) {
+                AppendRecord(entity, id, RecordKind::Removed, m_Before.data() + before->Offset, size);
+            } else if (has) {
+                AppendRecord(entity, id, RecordKind::Added, current, size);
+            } else {
+                continue;
+            }
+
+            ++records;
+            rawBytes += size;
+        }
+    }
+
+    const String label = std::move(m_EditLabel);
+    CancelEdit();
+    if (records == 0) return;
+
+    // A new step discards the redo steps
+    if (CanRedo()) {
+        m_Log.resize(m_Steps[m_Cursor].Offset);
+        m_Steps.resize(m_Cursor);
+    }
+
+    m_Steps.push_back({m_Log.size(), m_Staging.size(), records, rawBytes, label});
+    m_Log.insert(m_Log.end(), m_Staging.begin(), m_Staging.end());
+    m_Cursor = m_Steps.size();
+
+    EnforceBudget();
+    UpdateStats();
+}
+
+void UndoHistory::AppendRecord(entt::entity entity, ComponentId component, RecordKind kind,
+                               const u8* bytes, u32 size) {
+    const usize headerOffset = m_Staging.size();
+    m_Staging.resize(headerOffset + sizeof(RecordHeader));
+    Encode(bytes, size, m_Staging);
+
+    RecordHeader header{};
+    header.Entity = entt::to_integral(entity);
+    header.Component = component;
+    header.RawSize = size;
+    header.EncodedSize = static_cast<u32>(m_Staging.size() - headerOffset - sizeof(RecordHeader));
+    header.Kind = kind;
+    std::memcpy(m_Staging.data() + headerOffset, &header, sizeof(header));
+}
+
+bool UndoHistory::Undo(entt::registry& registry) {
+    EndEdit(registry);
+    if (!CanUndo()) return false;
+
+    Apply(registry, m_Steps[--m_Cursor], true);
+    UpdateStats();
+    return true;
+}
+
+bool UndoHistory::Redo(entt::registry& registry) {
+    EndEdit(registry);
+    if (!CanRedo()) return false;
+
+    Apply(registry, m_Steps[m_Cursor++], false);
+    UpdateStats();
+    return true;
+}
+
+void UndoHistory::Apply(entt::registry& registry, const Step& step, bool undo) {
+    auto& components = ComponentRegistry::Get();
+
+    Vector<usize> records;
+    records.reserve(step.Records);
+    for (usize offset = step.Offset; offset < step.Offset + step.Size;) {
+        RecordHeader header;
+        std::memcpy(&header, m_Log.data() + offset, sizeof(header));
+        records.push_back(offset);
+        offset += sizeof(header) + header.EncodedSize;
+    }
+
+    // Undo replays the step backwards
+    if (undo) {
+        std::reverse(records.begin(), records.end());
+    }
+
+    Vector<entt::entity> touched;
+    for (usize offset : records) {
+        RecordHeader header;
+        std::memcpy(&header, m_Log.data() + offset, sizeof(header));
+        const u8* encoded = m_Log.data() + offset + sizeof(header);
+
+        const ComponentFactory* factory = components.GetFactoryById(header.Component);
+        const entt::entity entity{header.Entity};
+        if (!factory || !registry.valid(entity)) continue;
+
+        const bool has = factory->Has(registry, entity);
+        const bool insert = header.Kind == (undo ? RecordKind::Removed : RecordKind::Added);
+        const bool remove = header.Kind == (undo ? RecordKind::Added : RecordKind::Removed);
+
+        if (remove) {
+            if (has) factory->Remove(registry, entity);
+        } else if (insert) {
+            void* data = has ? factory->Get(registry, entity) : factory->Create(registry, entity);
+            if (data && header.RawSize == factory->Size) {
+                Decode(encoded, header.EncodedSize, static_cast<u8*>(data), header.RawSize);
+                factory->Patch(registry, entity);
+            }
+        } else if (has && header.RawSize == factory->Size) {
+            DecodeXor(encoded, header.EncodedSize, static_cast<u8*>(factory->Get(registry, entity)));
+            factory->Patch(registry, entity);
+        }
+
+        touched.push_back(entity);
+    }
+
+    // Restored bytes carry the dirty state they were captured with; have
+    // TransformSystem resolve the entities and their children again
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    for (entt::entity entity : touched) {
+        if (auto* transform = registry.try_get<Transform>(entity)) {
+            transform->Dirty = true;
+        } else if (registry.all_of<LocalTransform, WorldTransform>(entity)) {
+            registry.emplace_or_replace<TransformDirty>(entity);
+        }
+    }
+}
+
+void UndoHistory::EnforceBudget() {
+    // Only applied steps can go, and the newest is kept whatever its size
+    while (m_Steps.size() > 1 && m_Cursor > 0 && m_Log.size() - m_LogBegin > m_Settings.MemoryBudget) {
+        m_LogBegin = m_Steps[1].Offset;
+        m_Steps.erase(m_Steps.begin());
+        m_Cursor--;
+        m_Stats.DroppedSteps++;
+    }
+
+    // Compact once the dropped bytes are half the log
+    if (m_LogBegin > 0 && m_LogBegin >= m_Log.size() / 2) {
+        m_Log.erase(m_Log.begin(), m_Log.begin() + static_cast<std::ptrdiff_t>(m_LogBegin));
+        for (Step& step : m_Steps) {
+            step.Offset -= m_LogBegin;
+        }
+        m_LogBegin = 0;
+    }
+}
+
+void UndoHistory::Clear() {
+    CancelEdit();
+    m_Log = {};
+    m_LogBegin = 0;
+    m_Steps.clear();
+    m_Cursor = 0;
+    m_Stats = {};
+}
+
+void UndoHistory::UpdateStats() {
+    m_Stats.Steps = static_cast<u32>(m_Steps.size());
+    m_Stats.UndoSteps = static_cast<u32>(m_Cursor);
+    m_Stats.LogBytes = m_Log.size() - m_LogBegin;
+    m_Stats.RawBytes = 0;
+    for (const Step& step : m_Steps) {
+        m_Stats.RawBytes += step.RawBytes;
+    }
+}
+
+// Pairs of (zero run, literal run) lengths as u16, each followed by the
+// literal bytes. Trailing zeros are left implicit.
+void UndoHistory::Encode(const u8* bytes, u32 size, Vector<u8>& out) {
+    u32 i = 0;
+    while (i < size) {
+        u32 zeros = 0;
+        while (i < size && bytes[i] == 0 && zeros < MaxRun) {
+            ++zeros;
+            ++i;
+        }
+        if (i == size) break;
+
+        const u32 first = i;
+        while (i < size && i - first < MaxRun) {
+            if (bytes[i] == 0) {
+                u32 run = 0;
+                while (i + run < size && bytes[i + run] == 0 && run < MinZeroRun) ++run;
+                if (run == MinZeroRun || i + run == size) break;
+            }
+            ++i;
+        }
+
+        WriteU16(out, zeros);
+        WriteU16(out, i - first);
+        out.insert(out.end(), bytes + first, bytes + i);
+    }
+}
+
+void UndoHistory::DecodeXor(const u8* encoded, u32 encodedSize, u8* target) {
+    u32 position = 0;
+    for (u32 i = 0; i < encodedSize;) {
+        position += ReadU16(encoded + i);
+        const u32 literal = ReadU16(encoded + i + 2);
+        i += 4;
+        for (u32 j = 0; j < literal; ++j) {
+            target[position++] ^= encoded[i++];
+        }
+    }
+}
+
+void UndoHistory::Decode(const u8* encoded, u32 encodedSize, u8* target, u32 size) {
+    std::memset(target, 0, size);
+    DecodeXor(encoded, encodedSize, target);
+}
+
+} // namespace Editor
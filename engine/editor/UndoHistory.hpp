@@ -0,0 +1,137 @@
+#pragma once
+
+#include "ecs/Component.hpp"
+#include "core/Types.hpp"
+#include <entt/entt.hpp>
+
+namespace Editor {
+
+// Undo / redo of component edits.
+//
+// An edit is bracketed by BeginEdit / EndEdit around everything it touches -
+// a whole gizmo drag, one inspector widget from activation to release - so
+// a continuous edit becomes a single step however many frames it spans.
+// BeginEdit copies every recorded component of the given entities;
+// EndEdit compares them with what is there now and appends one record per
+// changed component to the log:
+//
+//   Modified - XOR of the old and new bytes, which undoes and redoes alike
+//   Added    - the new bytes, removed again on undo
+//   Removed  - the old bytes, put back on undo
+//
+// Record bytes are run-length encoded over zero runs, so an XOR delta costs
+// roughly the bytes that actually changed. Undo and Redo patch only the
+// components of the step's records, through their ComponentFactory, and
+// fire on_update for ChangeSet listeners.
+//
+// Components are found through ComponentRegistry: tags and trivially
+// copyable components are recorded, others (names, mesh references) and the
+// transform state TransformSystem derives are not. Entity creation and
+// destruction are not recorded either; records of entities that no longer
+// exist are skipped.
+//
+// The log is bounded by Settings::MemoryBudget; the oldest steps are
+// dropped to stay under it. Committing an edit discards the redo steps.
+class UndoHistory {
+public:
+    struct Settings {
+        Engine::usize MemoryBudget = 64ull << 20;  // Encoded bytes kept in the log
+    };
+
+    struct Stats {
+        Engine::u32 Steps = 0;          // In the log
+        Engine::u32 UndoSteps = 0;      // Of those, before the cursor
+        Engine::usize LogBytes = 0;     // Encoded
+        Engine::usize RawBytes = 0;     // Component bytes the records stand for
+        Engine::u32 DroppedSteps = 0;   // Over budget, since Clear
+    };
+
+    UndoHistory();
+
+    void SetSettings(const Settings& settings);
+    const Settings& GetSettings() const { return m_Settings; }
+
+    // Start recording an edit of entities; false (and ignored) while another
+    // edit is open, whose owner ends it
+    bool BeginEdit(entt::registry& registry, const Engine::Vector<entt::entity>& entities, const char* label);
+    bool BeginEdit(entt::registry& registry, entt::entity entity, const char* label);
+
+    // Commit the open edit as one step, unless it changed nothing
+    void EndEdit(entt::registry& registry);
+    void CancelEdit();
+    bool IsEditing() const { return m_Editing; }
+
+    bool CanUndo() const { return m_Cursor > 0; }
+    bool CanRedo() const { return m_Cursor < m_Steps.size(); }
+    const char* GetUndoLabel() const;
+    const char* GetRedoLabel() const;
+
+    // Step back / forward; false if there is nothing to. An open edit is
+    // committed first.
+    bool Undo(entt::registry& registry);
+    bool Redo(entt::registry& registry);
+
+    void Clear();
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    enum class RecordKind : Engine::u8 { Modified, Added, Removed };
+
+    // Fixed-size header in front of every record's encoded bytes
+    struct RecordHeader {
+        Engine::u32 Entity;
+        Engine::ComponentId Component;
+        Engine::u32 RawSize;
+        Engine::u32 EncodedSize;
+        RecordKind Kind;
+        Engine::u8 Padding[3];
+    };
+
+    struct Step {
+        Engine::usize Offset;       // Into m_Log
+        Engine::usize Size;
+        Engine::u32 Records;
+        Engine::usize RawBytes;
+        Engine::String Label;
+    };
+
+    // Component of an entity as BeginEdit found it
+    struct Captured {
+        Engine::u32 EntityIndex;    // Into m_EditEntities
+        Engine::ComponentId Component;
+        Engine::usize Offset;       // Into m_Before
+    };
+
+    void Capture(entt::registry& registry);
+    void AppendRecord(entt::entity entity, Engine::ComponentId component, RecordKind kind,
+                      const Engine::u8* bytes, Engine::u32 size);
+    void Apply(entt::registry& registry, const Step& step, bool undo);
+    void EnforceBudget();
+    void UpdateStats();
+
+    static void Encode(const Engine::u8* bytes, Engine::u32 size, Engine::Vector<Engine::u8>& out);
+    static void DecodeXor(const Engine::u8* encoded, Engine::u32 encodedSize, Engine::u8* target);
+    static void Decode(const Engine::u8* encoded, Engine::u32 encodedSize, Engine::u8* target, Engine::u32 size);
+
+private:
+    Settings m_Settings;
+    Engine::Vector<Engine::ComponentId> m_Recorded;     // Component ids, ascending
+
+    Engine::Vector<Engine::u8> m_Log;
+    Engine::usize m_LogBegin = 0;       // Bytes before it belong to dropped steps
+    Engine::Vector<Step> m_Steps;
+    Engine::usize m_Cursor = 0;         // Steps before it are applied
+
+    bool m_Editing = false;
+    Engine::String m_EditLabel;
+    Engine::Vector<entt::entity> m_EditEntities;
+    Engine::Vector<Captured> m_Captured;    // Grouped by entity, components ascending
+    Engine::Vector<Engine::u8> m_Before;
+    Engine::Vector<Engine::u8> m_Staging;   // Records of the edit being committed
+    Engine::Vector<Engine::u8> m_Scratch;
+
+    Stats m_Stats;
+};
+
+} // namespace Editor
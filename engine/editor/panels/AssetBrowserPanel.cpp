@@ -1,6 +1,10 @@
 #include "AssetBrowserPanel.hpp"
 #include "ecs/Core.hpp"
+#include "ecs/Components/NameComponent.hpp"
+#include "resources/ResourceManager.hpp"
 #include <imgui.h>
+#include <algorithm>
+#include <filesystem>
 
 namespace Editor {
 
@@ -16,6 +20,39 @@ AssetBrowserPanel::AssetBrowserPanel(Engine::Ref<Engine::Mesh> cube,
 {
 }
 
+void AssetBrowserPanel::OnInit(EditorContext& context) {
+    Panel::OnInit(context);
+
+    auto& resources = Engine::ResourceManager::Instance();
+    const std::filesystem::path basePath(resources.GetBasePath());
+    m_Thumbnails = Engine::CreateScope<ThumbnailCache>((basePath / "cache/thumbnails").string());
+    Rescan();
+}
+
+void AssetBrowserPanel::OnShutdown() {
+    m_Thumbnails.reset();
+}
+
+void AssetBrowserPanel::OnUpdate(Engine::f32 deltaTime) {
+    (void)deltaTime;
+    if (!m_Thumbnails) return;
+
+    m_Thumbnails->Update();
+    m_Context->ThumbnailsPending |= m_Thumbnails->IsBusy();
+}
+
+void AssetBrowserPanel::Rescan() {
+    auto& resources = Engine::ResourceManager::Instance();
+    const std::filesystem::path basePath(resources.GetBasePath());
+
+    // Cooked meshes are listed by their source
+    Engine::Vector<Engine::String> skipped;
+    if (!resources.GetMeshCacheDirectory().empty()) {
+        skipped.push_back((basePath / resources.GetMeshCacheDirectory()).string());
+    }
+    m_Thumbnails->Rescan(basePath.string(), skipped);
+}
+
 void AssetBrowserPanel::OnImGuiRender() {
     ImGui::Begin("Asset Browser");
 
@@ -60,14 +97,12 @@ void AssetBrowserPanel::DrawMeshesTab() {
             auto& registry = m_Context->Registry->Raw();
             auto entity = registry.create();
 
-            auto& t = registry.emplace<Engine::Transform>(entity);
-            t.UpdateWorldMatrix();
+            registry.emplace<Engine::Transform>(entity);
+            registry.emplace<Engine::NameComponent>(entity).Name = name;
 
             auto& mc = registry.emplace<Engine::MeshComponent>(entity);
-            mc.VAO = mesh->GetVertexArray();
-            mc.IndexCount = mesh->GetIndexCount();
+            mc.Mesh = Engine::ResourceManager::Instance().AddMesh(mesh);
             mc.LocalBounds = mesh->GetBounds();
-            mc.MeshName = name;
 
             auto& mat = registry.emplace<Engine::MaterialComponent>(entity);
             mat.BaseColor = glm::vec4(0.8f, 0.8f, 0.8f, 1.0f);
@@ -95,9 +130,30 @@ void AssetBrowserPanel::DrawMeshesTab() {
 
     ImGui::Separator();
 
-    // TODO: List loaded model files
-    ImGui::TextDisabled("Model files:");
-    ImGui::TextDisabled("  (Not implemented yet)");
+    // Import-time ordering (Mesh::Optimize) on a 16-entry FIFO cache
+    if (ImGui::TreeNode("Vertex Cache (ACMR)")) {
+        DrawOptimizeStats("Cube", *m_CubeMesh);
+        DrawOptimizeStats("Sphere", *m_SphereMesh);
+        DrawOptimizeStats("Plane", *m_PlaneMesh);
+        DrawOptimizeStats("Cylinder", *m_CylinderMesh);
+        ImGui::TreePop();
+    }
+
+    ImGui::Separator();
+
+    ImGui::Text("Model files:");
+    DrawThumbnailGrid(ThumbnailCache::AssetKind::Mesh);
+}
+
+void AssetBrowserPanel::DrawOptimizeStats(const char* name, const Engine::Mesh& mesh) {
+    const auto& stats = mesh.GetOptimizeStats();
+    if (!stats.Optimized) {
+        ImGui::TextDisabled("%s: not optimized", name);
+        return;
+    }
+
+    ImGui::Text("%s: %.3f -> %.3f (ATVR %.2f -> %.2f, %.2f ms)", name,
+                stats.ACMRBefore, stats.ACMRAfter, stats.ATVRBefore, stats.ATVRAfter, stats.Milliseconds);
 }
 
 void AssetBrowserPanel::DrawShadersTab() {
@@ -122,11 +178,73 @@ void AssetBrowserPanel::DrawShadersTab() {
 }
 
 void AssetBrowserPanel::DrawTexturesTab() {
-    ImGui::TextDisabled("Loaded textures:");
-    ImGui::Separator();
+    DrawThumbnailGrid(ThumbnailCache::AssetKind::Texture);
+}
+
+void AssetBrowserPanel::DrawThumbnailGrid(ThumbnailCache::AssetKind kind) {
+    if (!m_Thumbnails) return;
 
-    // TODO: List loaded textures
-    ImGui::TextDisabled("  (Not implemented yet)");
+    const auto& assets = m_Thumbnails->GetAssets(kind);
+    if (ImGui::SmallButton("Rescan")) {
+        Rescan();
+    }
+    ImGui::SameLine();
+    if (m_Thumbnails->IsScanning()) {
+        ImGui::TextDisabled("Scanning...");
+    } else {
+        const auto& stats = m_Thumbnails->GetStats();
+        ImGui::TextDisabled("%zu files, %u thumbnails resident, %u queued", assets.size(), stats.Resident,
+                            stats.Queued + stats.InFlight);
+    }
+
+    const float thumbnailSize = static_cast<float>(ThumbnailCache::ThumbnailSize);
+    const ImGuiStyle& style = ImGui::GetStyle();
+    const float cellWidth = thumbnailSize + style.ItemSpacing.x;
+    const float cellHeight = thumbnailSize + ImGui::GetTextLineHeightWithSpacing() + style.ItemSpacing.y;
+
+    ImGui::BeginChild("ThumbnailGrid");
+    const int columns = std::max(1, static_cast<int>(ImGui::GetContentRegionAvail().x / cellWidth));
+    const int rows = static_cast<int>((assets.size() + columns - 1) / columns);
+    const ImTextureID atlas = static_cast<ImTextureID>(static_cast<uintptr_t>(m_Thumbnails->GetAtlasID()));
+
+    ImGuiListClipper clipper;
+    clipper.Begin(rows, cellHeight);
+    while (clipper.Step()) {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+            ImGui::BeginGroup();
+            for (int column = 0; column < columns; column++) {
+                const size_t index = static_cast<size_t>(row) * columns + column;
+                if (index >= assets.size()) break;
+                const auto& asset = assets[index];
+
+                if (column > 0) ImGui::SameLine();
+                ImGui::BeginGroup();
+                ImGui::PushID(static_cast<int>(index));
+
+                ThumbnailCache::Region region;
+                if (m_Thumbnails->Request(asset, region)) {
+                    ImGui::Image(atlas, ImVec2(thumbnailSize, thumbnailSize),
+                                 ImVec2(region.UV0.x, region.UV0.y), ImVec2(region.UV1.x, region.UV1.y));
+                } else {
+                    // Placeholder until the thumbnail lands
+                    ImGui::Button(m_Thumbnails->IsFailed(asset) ? "?" : "...", ImVec2(thumbnailSize, thumbnailSize));
+                }
+                if (ImGui::IsItemHovered()) {
+                    ImGui::SetTooltip("%s", asset.Name.c_str());
+                }
+
+                // As much of the file name as fits under the thumbnail; the tooltip has all of it
+                const Engine::String filename = std::filesystem::path(asset.Name).filename().string();
+                ImGui::TextUnformatted(filename.c_str(), filename.c_str() + std::min<size_t>(filename.size(), 9));
+
+                ImGui::PopID();
+                ImGui::EndGroup();
+            }
+            ImGui::EndGroup();
+        }
+    }
+    clipper.End();
+    ImGui::EndChild();
 }
 
 } // namespace Editor
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Panel.hpp"
+#include "../ThumbnailCache.hpp"
 #include "renderer/Mesh.hpp"
 
 namespace Editor {
@@ -12,17 +13,28 @@ public:
                       Engine::Ref<Engine::Mesh> plane,
                       Engine::Ref<Engine::Mesh> cylinder);
 
+    void OnInit(EditorContext& context) override;
+    void OnShutdown() override;
+    void OnUpdate(Engine::f32 deltaTime) override;
     void OnImGuiRender() override;
 
 private:
     void DrawMeshesTab();
+    void DrawOptimizeStats(const char* name, const Engine::Mesh& mesh);
     void DrawShadersTab();
     void DrawTexturesTab();
 
+    // Files of kind under the base path, as a grid of thumbnails; only the
+    // rows in view request theirs
+    void DrawThumbnailGrid(ThumbnailCache::AssetKind kind);
+    void Rescan();
+
     Engine::Ref<Engine::Mesh> m_CubeMesh;
     Engine::Ref<Engine::Mesh> m_SphereMesh;
     Engine::Ref<Engine::Mesh> m_PlaneMesh;
     Engine::Ref<Engine::Mesh> m_CylinderMesh;
+
+    Engine::Scope<ThumbnailCache> m_Thumbnails;
 };
 
 } // namespace Editor
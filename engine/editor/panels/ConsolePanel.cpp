@@ -1,14 +1,25 @@
 #include "ConsolePanel.hpp"
 #include "core/Logger.hpp"
 #include <imgui.h>
-#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <ctime>
-#include <iomanip>
-#include <sstream>
 
 namespace Editor {
 
-ConsolePanel::ConsolePanel() : Panel("Console") {
+namespace {
+
+// "[HH:MM:SS] " in front of every entry's text
+constexpr Engine::u32 TimestampLength = 11;
+
+} // anonymous namespace
+
+ConsolePanel::ConsolePanel()
+    : Panel("Console")
+    , m_Entries(EntryCapacity)
+    , m_Text(TextCapacity)
+{
 }
 
 ConsolePanel::~ConsolePanel() {
@@ -18,48 +29,136 @@ void ConsolePanel::OnInit(EditorContext& context) {
     Panel::OnInit(context);
 
     // Add custom sink to spdlog
-    auto sink = std::make_shared<ConsolePanelSink_mt>(this);
-    sink->set_pattern("%v");
-
-    Engine::Logger::GetCoreLogger()->sinks().push_back(sink);
-    Engine::Logger::GetClientLogger()->sinks().push_back(sink);
+    m_Sink = std::make_shared<ConsolePanelSink_mt>(this);
+    m_Sink->set_pattern("%v");
+    Engine::Logger::AddSink(m_Sink);
 }
 
 void ConsolePanel::OnShutdown() {
-    // Note: We should remove our sink from the loggers here, but for simplicity
-    // we'll let spdlog handle cleanup
+    // The sink points at this panel; once removed the flush thread can't reach it
+    if (m_Sink) {
+        Engine::Logger::RemoveSink(m_Sink);
+        m_Sink.reset();
+    }
 }
 
-void ConsolePanel::AddLog(spdlog::level::level_enum level, const Engine::String& message) {
-    std::lock_guard<std::mutex> lock(m_Mutex);
+void ConsolePanel::AddLog(spdlog::level::level_enum level, std::string_view logger, const Engine::String& message,
+                          spdlog::log_clock::time_point time) {
+    std::lock_guard<std::mutex> lock(m_PendingMutex);
+    m_Pending.push_back({level, Engine::String(logger), message, time});
+}
 
-    LogEntry entry;
-    entry.Level = level;
-    entry.Message = message;
+void ConsolePanel::TakePendingLogs() {
+    {
+        std::lock_guard<std::mutex> lock(m_PendingMutex);
+        std::swap(m_Pending, m_Batch);
+    }
+    if (m_Batch.empty()) return;
+
+    for (const auto& pending : m_Batch) {
+        Append(pending);
+    }
+    m_Batch.clear();
 
+    // Evicted entries leave the front of the index
+    while (m_VisibleBegin < m_Visible.size() && m_Visible[m_VisibleBegin] < m_FirstEntry) {
+        m_VisibleBegin++;
+    }
+    if (m_VisibleBegin > 0 && m_VisibleBegin >= m_Visible.size() / 2) {
+        m_Visible.erase(m_Visible.begin(), m_Visible.begin() + static_cast<std::ptrdiff_t>(m_VisibleBegin));
+        m_VisibleBegin = 0;
+    }
+}
+
+void ConsolePanel::Append(const PendingLog& pending) {
     // Remove trailing newline if present
-    if (!entry.Message.empty() && entry.Message.back() == '\n') {
-        entry.Message.pop_back();
+    std::string_view message(pending.Message);
+    if (!message.empty() && message.back() == '\n') {
+        message.remove_suffix(1);
+    }
+    message = message.substr(0, MaxMessageLength);
+
+    const std::time_t time = spdlog::log_clock::to_time_t(pending.Time);
+    char timestamp[TimestampLength + 1];
+    std::strftime(timestamp, sizeof(timestamp), "[%H:%M:%S] ", std::localtime(&time));
+
+    // Entry text is contiguous: skip the ring's tail when it doesn't fit
+    const Engine::u32 length = static_cast<Engine::u32>(TimestampLength + message.size());
+    if (m_TextHead % TextCapacity + length > TextCapacity) {
+        m_TextHead += TextCapacity - m_TextHead % TextCapacity;
+    }
+    const Engine::u64 offset = m_TextHead;
+    m_TextHead += length;
+
+    // Make room in both rings
+    while (m_FirstEntry < m_NextEntry &&
+           (m_NextEntry - m_FirstEntry >= EntryCapacity || GetEntry(m_FirstEntry).TextOffset + TextCapacity < m_TextHead)) {
+        EvictOldest();
+    }
+
+    char* text = m_Text.data() + offset % TextCapacity;
+    std::memcpy(text, timestamp, TimestampLength);
+    std::memcpy(text + TimestampLength, message.data(), message.size());
+
+    LogEntry& entry = m_Entries[m_NextEntry % EntryCapacity];
+    entry.TextOffset = offset;
+    entry.Length = length;
+    entry.Level = static_cast<Engine::u8>(pending.Level);
+    entry.Logger = InternLogger(pending.Logger);
+    m_LevelCounts[entry.Level]++;
+
+    if (PassesFilter(entry)) {
+        m_Visible.push_back(m_NextEntry);
+    }
+    m_NextEntry++;
+}
+
+void ConsolePanel::EvictOldest() {
+    m_LevelCounts[GetEntry(m_FirstEntry).Level]--;
+    m_FirstEntry++;
+}
+
+Engine::u8 ConsolePanel::InternLogger(const Engine::String& name) {
+    if (auto it = m_LoggerIds.find(name); it != m_LoggerIds.end()) {
+        return it->second;
+    }
+    if (m_Loggers.size() == MaxLoggers) {
+        return static_cast<Engine::u8>(MaxLoggers - 1);
     }
 
-    // Get timestamp
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time), "%H:%M:%S");
-    entry.Timestamp = ss.str();
+    const Engine::u8 id = static_cast<Engine::u8>(m_Loggers.size());
+    m_Loggers.push_back(name.empty() ? Engine::String("(default)") : name);
+    m_LoggerIds.emplace(name, id);
+    m_LoggerShown.push_back(true);
+    return id;
+}
 
-    m_Logs.push_back(entry);
+std::string_view ConsolePanel::GetText(const LogEntry& entry, bool timestamp) const {
+    std::string_view text(m_Text.data() + entry.TextOffset % TextCapacity, entry.Length);
+    return timestamp ? text : text.substr(TimestampLength);
+}
 
-    // Limit log size
-    if (m_Logs.size() > 10000) {
-        m_Logs.erase(m_Logs.begin(), m_Logs.begin() + 1000);
+bool ConsolePanel::PassesFilter(const LogEntry& entry) const {
+    if (!(m_LevelMask & (1u << entry.Level))) return false;
+    if (!m_LoggerShown[entry.Logger]) return false;
+    return m_FilterBuffer[0] == '\0' || GetText(entry, false).find(m_FilterBuffer) != std::string_view::npos;
+}
+
+void ConsolePanel::RebuildVisible() {
+    m_Visible.clear();
+    m_VisibleBegin = 0;
+    for (Engine::u64 sequence = m_FirstEntry; sequence < m_NextEntry; ++sequence) {
+        if (PassesFilter(GetEntry(sequence))) {
+            m_Visible.push_back(sequence);
+        }
     }
 }
 
 void ConsolePanel::Clear() {
-    std::lock_guard<std::mutex> lock(m_Mutex);
-    m_Logs.clear();
+    m_FirstEntry = m_NextEntry;
+    std::fill(std::begin(m_LevelCounts), std::end(m_LevelCounts), 0u);
+    m_Visible.clear();
+    m_VisibleBegin = 0;
 }
 
 ImVec4 ConsolePanel::GetLogColor(spdlog::level::level_enum level) const {
@@ -75,6 +174,8 @@ ImVec4 ConsolePanel::GetLogColor(spdlog::level::level_enum level) const {
 }
 
 void ConsolePanel::OnImGuiRender() {
+    TakePendingLogs();
+
     ImGui::Begin("Console");
 
     // Toolbar
@@ -93,88 +194,40 @@ void ConsolePanel::OnImGuiRender() {
     ImGui::Separator();
     ImGui::SameLine();
 
-    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(2, 4));
-
-    auto FilterButton = [](const char* label, bool& enabled, ImVec4 color) {
-        if (enabled) {
-            ImGui::PushStyleColor(ImGuiCol_Button, color);
-            ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(color.x * 1.2f, color.y * 1.2f, color.z * 1.2f, 1.0f));
-        } else {
-            ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.2f, 0.2f, 1.0f));
-            ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.3f, 0.3f, 0.3f, 1.0f));
-        }
-
-        if (ImGui::SmallButton(label)) {
-            enabled = !enabled;
-        }
-
-        ImGui::PopStyleColor(2);
-    };
-
-    FilterButton("T", m_ShowTrace, ImVec4(0.4f, 0.4f, 0.4f, 1.0f));
-    ImGui::SameLine();
-    FilterButton("D", m_ShowDebug, ImVec4(0.3f, 0.6f, 0.3f, 1.0f));
-    ImGui::SameLine();
-    FilterButton("I", m_ShowInfo, ImVec4(0.3f, 0.3f, 0.6f, 1.0f));
-    ImGui::SameLine();
-    FilterButton("W", m_ShowWarn, ImVec4(0.6f, 0.6f, 0.2f, 1.0f));
+    DrawLevelFilters();
     ImGui::SameLine();
-    FilterButton("E", m_ShowError, ImVec4(0.6f, 0.2f, 0.2f, 1.0f));
-    ImGui::SameLine();
-    FilterButton("C", m_ShowCritical, ImVec4(0.8f, 0.1f, 0.1f, 1.0f));
-
-    ImGui::PopStyleVar();
+    DrawLoggerFilter();
 
     // Text filter
     ImGui::SameLine();
     ImGui::SetNextItemWidth(150);
-    ImGui::InputTextWithHint("##filter", "Filter...", m_FilterBuffer, sizeof(m_FilterBuffer));
+    if (ImGui::InputTextWithHint("##filter", "Filter...", m_FilterBuffer, sizeof(m_FilterBuffer))) {
+        RebuildVisible();
+    }
 
     ImGui::Separator();
 
-    // Log display
+    // Log display: only the rows in view
     ImGui::BeginChild("LogScrollRegion", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
 
-    {
-        std::lock_guard<std::mutex> lock(m_Mutex);
-
-        for (const auto& entry : m_Logs) {
-            // Level filter
-            bool show = false;
-            switch (entry.Level) {
-                case spdlog::level::trace:    show = m_ShowTrace; break;
-                case spdlog::level::debug:    show = m_ShowDebug; break;
-                case spdlog::level::info:     show = m_ShowInfo; break;
-                case spdlog::level::warn:     show = m_ShowWarn; break;
-                case spdlog::level::err:      show = m_ShowError; break;
-                case spdlog::level::critical: show = m_ShowCritical; break;
-                default: show = true; break;
-            }
-
-            if (!show) continue;
-
-            // Text filter
-            if (m_FilterBuffer[0] != '\0') {
-                if (entry.Message.find(m_FilterBuffer) == Engine::String::npos) {
-                    continue;
-                }
-            }
+    const bool atBottom = ImGui::GetScrollY() >= ImGui::GetScrollMaxY();
 
-            // Display
-            ImGui::PushStyleColor(ImGuiCol_Text, GetLogColor(entry.Level));
-
-            if (m_ShowTimestamps) {
-                ImGui::TextUnformatted(("[" + entry.Timestamp + "] " + entry.Message).c_str());
-            } else {
-                ImGui::TextUnformatted(entry.Message.c_str());
-            }
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(m_Visible.size() - m_VisibleBegin));
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+            const LogEntry& entry = GetEntry(m_Visible[m_VisibleBegin + i]);
+            const std::string_view text = GetText(entry, m_ShowTimestamps);
 
+            ImGui::PushStyleColor(ImGuiCol_Text, GetLogColor(static_cast<spdlog::level::level_enum>(entry.Level)));
+            ImGui::TextUnformatted(text.data(), text.data() + text.size());
             ImGui::PopStyleColor();
         }
     }
+    clipper.End();
 
     // Auto-scroll
-    if (m_AutoScroll && ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
+    if (m_AutoScroll && atBottom) {
         ImGui::SetScrollHereY(1.0f);
     }
 
@@ -183,4 +236,79 @@ void ConsolePanel::OnImGuiRender() {
     ImGui::End();
 }
 
+void ConsolePanel::DrawLevelFilters() {
+    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(2, 4));
+
+    struct LevelButton {
+        spdlog::level::level_enum Level;
+        const char* Label;
+        ImVec4 Color;
+    };
+    const LevelButton buttons[] = {
+        {spdlog::level::trace,    "T", ImVec4(0.4f, 0.4f, 0.4f, 1.0f)},
+        {spdlog::level::debug,    "D", ImVec4(0.3f, 0.6f, 0.3f, 1.0f)},
+        {spdlog::level::info,     "I", ImVec4(0.3f, 0.3f, 0.6f, 1.0f)},
+        {spdlog::level::warn,     "W", ImVec4(0.6f, 0.6f, 0.2f, 1.0f)},
+        {spdlog::level::err,      "E", ImVec4(0.6f, 0.2f, 0.2f, 1.0f)},
+        {spdlog::level::critical, "C", ImVec4(0.8f, 0.1f, 0.1f, 1.0f)},
+    };
+
+    bool changed = false;
+    for (const auto& button : buttons) {
+        if (&button != buttons) ImGui::SameLine();
+
+        const Engine::u32 bit = 1u << button.Level;
+        const bool enabled = (m_LevelMask & bit) != 0;
+        const ImVec4 color = button.Color;
+        if (enabled) {
+            ImGui::PushStyleColor(ImGuiCol_Button, color);
+            ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(color.x * 1.2f, color.y * 1.2f, color.z * 1.2f, 1.0f));
+        } else {
+            ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.2f, 0.2f, 1.0f));
+            ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.3f, 0.3f, 0.3f, 1.0f));
+        }
+
+        // Entries of the level in the ring
+        char label[32];
+        std::snprintf(label, sizeof(label), "%s %u###%s", button.Label, m_LevelCounts[button.Level], button.Label);
+        if (ImGui::SmallButton(label)) {
+            m_LevelMask ^= bit;
+            changed = true;
+        }
+
+        ImGui::PopStyleColor(2);
+    }
+
+    ImGui::PopStyleVar();
+
+    if (changed) {
+        RebuildVisible();
+    }
+}
+
+void ConsolePanel::DrawLoggerFilter() {
+    if (ImGui::SmallButton("Loggers")) {
+        ImGui::OpenPopup("LoggerFilter");
+    }
+
+    if (ImGui::BeginPopup("LoggerFilter")) {
+        bool changed = false;
+        for (size_t i = 0; i < m_Loggers.size(); i++) {
+            bool shown = m_LoggerShown[i];
+            if (ImGui::Checkbox(m_Loggers[i].c_str(), &shown)) {
+                m_LoggerShown[i] = shown;
+                changed = true;
+            }
+        }
+        if (m_Loggers.empty()) {
+            ImGui::TextDisabled("No loggers yet");
+        }
+        ImGui::EndPopup();
+
+        if (changed) {
+            RebuildVisible();
+        }
+    }
+}
+
 } // namespace Editor
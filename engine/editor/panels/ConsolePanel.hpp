@@ -4,17 +4,36 @@
 #include <imgui.h>
 #include <spdlog/sinks/base_sink.h>
 #include <mutex>
+#include <string_view>
 
 namespace Editor {
 
+// One line in the console's ring. Its text - "[HH:MM:SS] message", the
+// timestamp formatted once on arrival - is a contiguous span of the text
+// ring, so entries own no allocations.
 struct LogEntry {
-    spdlog::level::level_enum Level;
-    Engine::String Message;
-    Engine::String Timestamp;
+    Engine::u64 TextOffset;     // Absolute position in the text ring
+    Engine::u32 Length;
+    Engine::u8 Level;           // spdlog::level::level_enum
+    Engine::u8 Logger;          // Interned logger name
 };
 
+// ConsolePanel - log output, bounded and virtualized.
+//
+// Entries live in a fixed ring of EntryCapacity, their text in a fixed
+// TextCapacity byte ring; the oldest entries go when either fills, so
+// memory stays flat however long the session. The entries passing the
+// level, logger and text filters are indexed by sequence number as they
+// arrive (the index is rebuilt only when a filter changes), and only the
+// rows in view are submitted through ImGuiListClipper, so a frame costs
+// the same with ten lines of history as with the full ring.
 class ConsolePanel : public Panel {
 public:
+    static constexpr Engine::u32 EntryCapacity = 16384;
+    static constexpr Engine::usize TextCapacity = 4ull << 20;
+    static constexpr Engine::u32 MaxMessageLength = 4096;   // Longer messages are cut
+    static constexpr Engine::u32 MaxLoggers = 64;           // Later names share the last slot
+
     ConsolePanel();
     ~ConsolePanel();
 
@@ -22,27 +41,64 @@ public:
     void OnShutdown() override;
     void OnImGuiRender() override;
 
-    void AddLog(spdlog::level::level_enum level, const Engine::String& message);
+    // Any thread (the log flush thread in async mode). Queued; the panel
+    // takes the batch once per frame.
+    void AddLog(spdlog::level::level_enum level, std::string_view logger, const Engine::String& message,
+                spdlog::log_clock::time_point time);
     void Clear();
 
 private:
+    struct PendingLog {
+        spdlog::level::level_enum Level;
+        Engine::String Logger;
+        Engine::String Message;
+        spdlog::log_clock::time_point Time;
+    };
+
+    void TakePendingLogs();
+    void Append(const PendingLog& pending);
+    void EvictOldest();
+    Engine::u8 InternLogger(const Engine::String& name);
+
+    const LogEntry& GetEntry(Engine::u64 sequence) const { return m_Entries[sequence % EntryCapacity]; }
+    std::string_view GetText(const LogEntry& entry, bool timestamp) const;
+
+    bool PassesFilter(const LogEntry& entry) const;
+    void RebuildVisible();
+
+    void DrawLevelFilters();
+    void DrawLoggerFilter();
     ImVec4 GetLogColor(spdlog::level::level_enum level) const;
 
-    Engine::Vector<LogEntry> m_Logs;
+    // Main thread only
+    Engine::Vector<LogEntry> m_Entries;         // Ring, by sequence number
+    Engine::u64 m_FirstEntry = 0;               // Oldest sequence number still held
+    Engine::u64 m_NextEntry = 0;
+    Engine::Vector<char> m_Text;                // Ring of entry text
+    Engine::u64 m_TextHead = 0;                 // Absolute; the ring holds [head - capacity, head)
+    Engine::u32 m_LevelCounts[spdlog::level::n_levels] = {};
+
+    Engine::Vector<Engine::String> m_Loggers;
+    Engine::HashMap<Engine::String, Engine::u8> m_LoggerIds;
+
+    // Sequence numbers passing the filters, ascending; [m_VisibleBegin, end)
+    // are still in the ring
+    Engine::Vector<Engine::u64> m_Visible;
+    Engine::usize m_VisibleBegin = 0;
+
     bool m_AutoScroll = true;
     bool m_ShowTimestamps = false;
 
     // Filters
-    bool m_ShowTrace = true;
-    bool m_ShowDebug = true;
-    bool m_ShowInfo = true;
-    bool m_ShowWarn = true;
-    bool m_ShowError = true;
-    bool m_ShowCritical = true;
-
+    Engine::u32 m_LevelMask = ~0u;              // Bit per spdlog level
+    Engine::Vector<bool> m_LoggerShown;         // By interned id
     char m_FilterBuffer[256] = "";
 
-    std::mutex m_Mutex;
+    spdlog::sink_ptr m_Sink;
+
+    std::mutex m_PendingMutex;
+    Engine::Vector<PendingLog> m_Pending;
+    Engine::Vector<PendingLog> m_Batch;     // Swapped with m_Pending, keeps its capacity
 };
 
 // Custom spdlog sink that forwards to ConsolePanel
@@ -55,7 +111,8 @@ protected:
     void sink_it_(const spdlog::details::log_msg& msg) override {
         spdlog::memory_buf_t formatted;
         spdlog::sinks::base_sink<Mutex>::formatter_->format(msg, formatted);
-        m_Panel->AddLog(msg.level, fmt::to_string(formatted));
+        m_Panel->AddLog(msg.level, std::string_view(msg.logger_name.data(), msg.logger_name.size()),
+                        fmt::to_string(formatted), msg.time);
     }
 
     void flush_() override {}
@@ -1,6 +1,7 @@
 #include "InspectorPanel.hpp"
 #include "ecs/Core.hpp"
 #include "ecs/Components/LightComponents.hpp"
+#include "resources/ResourceManager.hpp"
 #include <imgui.h>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -41,6 +42,12 @@ bool InspectorPanel::DrawComponentHeader(const char* label, bool canRemove) {
 void InspectorPanel::OnImGuiRender() {
     ImGui::Begin("Inspector");
 
+    // Selection went away mid-edit
+    if (m_Editing && !m_Context->HasSelection()) {
+        m_Context->History->EndEdit(m_Context->Registry->Raw());
+        m_Editing = false;
+    }
+
     if (!m_Context->HasSelection()) {
         ImGui::TextDisabled("No entity selected");
         ImGui::End();
@@ -61,6 +68,13 @@ void InspectorPanel::OnImGuiRender() {
     ImGui::Text("Entity ID: %u", static_cast<Engine::u32>(entity));
     ImGui::Separator();
 
+    // Everything changed here, from one click to a whole drag, is one undo
+    // step; capturing the selected entity's components costs little
+    auto* history = m_Context->History;
+    if (history && !m_Editing && m_Context->State == PlayState::Edit) {
+        m_Editing = history->BeginEdit(registry, entity, "Inspector Edit");
+    }
+
     // Draw components
     if (registry.all_of<Engine::Transform>(entity)) {
         DrawTransformComponent();
@@ -100,6 +114,11 @@ void InspectorPanel::OnImGuiRender() {
     // Add component button
     DrawAddComponentButton();
 
+    if (m_Editing && !ImGui::IsAnyItemActive()) {
+        history->EndEdit(registry);
+        m_Editing = false;
+    }
+
     ImGui::End();
 }
 
@@ -115,31 +134,24 @@ void InspectorPanel::DrawTransformComponent() {
         return;
     }
 
-    bool modified = false;
+    // Setters mark the transform dirty; TransformSystem resolves the world matrix
 
     // Position
     glm::vec3 position = transform->Position;
     if (ImGui::DragFloat3("Position", glm::value_ptr(position), 0.1f)) {
         transform->SetPosition(position);
-        modified = true;
     }
 
     // Rotation (as Euler angles in degrees)
     glm::vec3 eulerAngles = glm::degrees(glm::eulerAngles(transform->Rotation));
     if (ImGui::DragFloat3("Rotation", glm::value_ptr(eulerAngles), 1.0f)) {
         transform->SetRotation(glm::quat(glm::radians(eulerAngles)));
-        modified = true;
     }
 
     // Scale
     glm::vec3 scale = transform->Scale;
     if (ImGui::DragFloat3("Scale", glm::value_ptr(scale), 0.1f, 0.01f, 100.0f)) {
         transform->SetScale(scale);
-        modified = true;
-    }
-
-    if (modified) {
-        transform->UpdateWorldMatrix();
     }
 
     ImGui::TreePop();
@@ -157,11 +169,20 @@ void InspectorPanel::DrawMeshComponent() {
         return;
     }
 
-    ImGui::Text("Vertex Count: %u", mesh->VertexCount);
-    ImGui::Text("Index Count: %u", mesh->IndexCount);
+    auto& resources = Engine::ResourceManager::Instance();
+    const Engine::Mesh* data = resources.GetMesh(mesh->Mesh);
+    if (!data) {
+        ImGui::TextDisabled("No mesh (handle %u:%u)", mesh->Mesh.Index, mesh->Mesh.Generation);
+        ImGui::TreePop();
+        return;
+    }
+
+    ImGui::Text("Vertex Count: %u", data->GetVertexCount());
+    ImGui::Text("Index Count: %u", data->GetIndexCount());
 
-    if (!mesh->MeshName.empty()) {
-        ImGui::Text("Name: %s", mesh->MeshName.c_str());
+    const auto& name = resources.GetMeshName(mesh->Mesh);
+    if (!name.empty()) {
+        ImGui::Text("Name: %s", name.c_str());
     }
 
     ImGui::TreePop();
@@ -198,11 +219,21 @@ void InspectorPanel::DrawRenderableComponent() {
         return;
     }
 
-    ImGui::Checkbox("Visible", &renderable->Visible);
-    ImGui::Checkbox("Cast Shadows", &renderable->CastShadows);
-    ImGui::Checkbox("Receive Shadows", &renderable->ReceiveShadows);
+    bool changed = false;
+    changed |= ImGui::Checkbox("Visible", &renderable->Visible);
+    changed |= ImGui::Checkbox("Cast Shadows", &renderable->CastShadows);
+    changed |= ImGui::Checkbox("Receive Shadows", &renderable->ReceiveShadows);
 
-    ImGui::SliderInt("LOD Level", reinterpret_cast<int*>(&renderable->LODLevel), 0, 4);
+    // LODLevel is picked each frame by LODSelectionSystem; only the cap is editable
+    const Engine::u8 minLOD = 0;
+    const Engine::u8 maxLOD = 15;
+    changed |= ImGui::SliderScalar("Max LOD", ImGuiDataType_U8, &renderable->MaxLODLevel, &minLOD, &maxLOD);
+    ImGui::Text("LOD Level: %u", static_cast<unsigned>(renderable->LODLevel));
+
+    // Edited in place: tell SYSTEM_REACTS_TO(Renderable) systems
+    if (changed) {
+        registry.patch<Engine::Renderable>(m_Context->SelectedEntity);
+    }
 
     ImGui::TreePop();
 }
@@ -250,17 +281,23 @@ void InspectorPanel::DrawPointLightComponent() {
         return;
     }
 
-    ImGui::ColorEdit3("Color", glm::value_ptr(light->Color));
-    ImGui::DragFloat("Intensity", &light->Intensity, 0.1f, 0.0f, 100.0f);
-    ImGui::DragFloat("Radius", &light->Radius, 0.1f, 0.1f, 100.0f);
+    // Edits are patched so the lighting system re-uploads just this light
+    bool changed = false;
+    changed |= ImGui::ColorEdit3("Color", glm::value_ptr(light->Color));
+    changed |= ImGui::DragFloat("Intensity", &light->Intensity, 0.1f, 0.0f, 100.0f);
+    changed |= ImGui::DragFloat("Radius", &light->Radius, 0.1f, 0.1f, 100.0f);
 
     if (ImGui::CollapsingHeader("Attenuation")) {
-        ImGui::DragFloat("Constant", &light->Constant, 0.01f, 0.0f, 2.0f);
-        ImGui::DragFloat("Linear", &light->Linear, 0.001f, 0.0f, 1.0f);
-        ImGui::DragFloat("Quadratic", &light->Quadratic, 0.0001f, 0.0f, 0.5f, "%.4f");
+        changed |= ImGui::DragFloat("Constant", &light->Constant, 0.01f, 0.0f, 2.0f);
+        changed |= ImGui::DragFloat("Linear", &light->Linear, 0.001f, 0.0f, 1.0f);
+        changed |= ImGui::DragFloat("Quadratic", &light->Quadratic, 0.0001f, 0.0f, 0.5f, "%.4f");
     }
 
-    ImGui::Checkbox("Enabled", &light->Enabled);
+    changed |= ImGui::Checkbox("Enabled", &light->Enabled);
+
+    if (changed) {
+        registry.patch<Engine::PointLightComponent>(m_Context->SelectedEntity);
+    }
 
     ImGui::TreePop();
 }
@@ -277,9 +314,11 @@ void InspectorPanel::DrawSpotLightComponent() {
         return;
     }
 
-    ImGui::ColorEdit3("Color", glm::value_ptr(light->Color));
-    ImGui::DragFloat("Intensity", &light->Intensity, 0.1f, 0.0f, 100.0f);
-    ImGui::DragFloat3("Direction", glm::value_ptr(light->Direction), 0.01f, -1.0f, 1.0f);
+    // Edits are patched so the lighting system re-uploads just this light
+    bool changed = false;
+    changed |= ImGui::ColorEdit3("Color", glm::value_ptr(light->Color));
+    changed |= ImGui::DragFloat("Intensity", &light->Intensity, 0.1f, 0.0f, 100.0f);
+    changed |= ImGui::DragFloat3("Direction", glm::value_ptr(light->Direction), 0.01f, -1.0f, 1.0f);
 
     // Normalize direction
     if (glm::length(light->Direction) > 0.001f) {
@@ -292,15 +331,21 @@ void InspectorPanel::DrawSpotLightComponent() {
 
     if (ImGui::DragFloat("Inner Angle", &innerAngle, 0.5f, 0.0f, outerAngle)) {
         light->InnerCutOff = glm::radians(innerAngle);
+        changed = true;
     }
     if (ImGui::DragFloat("Outer Angle", &outerAngle, 0.5f, innerAngle, 90.0f)) {
         light->OuterCutOff = glm::radians(outerAngle);
+        changed = true;
     }
 
-    ImGui::DragFloat("Range", &light->Range, 0.1f, 0.1f, 500.0f);
+    changed |= ImGui::DragFloat("Range", &light->Range, 0.1f, 0.1f, 500.0f);
 
     ImGui::Checkbox("Cast Shadows", &light->CastShadows);
 
+    if (changed) {
+        registry.patch<Engine::SpotLightComponent>(m_Context->SelectedEntity);
+    }
+
     ImGui::TreePop();
 }
 
@@ -23,6 +23,8 @@ private:
 
     template<typename T>
     bool DrawComponentHeader(const char* label, bool canRemove = true);
+
+    bool m_Editing = false;     // Owns the open UndoHistory edit
 };
 
 } // namespace Editor
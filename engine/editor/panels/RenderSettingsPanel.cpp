@@ -1,22 +1,161 @@
 #include "RenderSettingsPanel.hpp"
+#include "core/Application.hpp"
 #include <imgui.h>
 
+#include <cstdio>
+
 namespace Editor {
 
 void RenderSettingsPanel::OnImGuiRender() {
     ImGui::Begin("Render Settings");
 
     // Post-Processing
-    if (ImGui::CollapsingHeader("Post-Processing", ImGuiTreeNodeFlags_DefaultOpen)) {
-        ImGui::SliderFloat("Exposure", &m_Context->Exposure, 0.1f, 10.0f);
-        ImGui::SliderFloat("Gamma", &m_Context->Gamma, 1.0f, 3.0f);
+    if (ImGui::CollapsingHeader("Post-Processing", ImGuiTreeNodeFlags_DefaultOpen) && m_Context->PostProcess) {
+        auto& post = m_Context->PostProcess->GetSettings();
+
+        ImGui::SliderFloat("Exposure", &post.Exposure, 0.1f, 10.0f);
+        ImGui::SliderFloat("Gamma", &post.Gamma, 1.0f, 3.0f);
+
+        ImGui::Checkbox("Auto Exposure", &post.AutoExposure);
+        if (post.AutoExposure) {
+            ImGui::SliderFloat("Adaptation Speed", &post.AdaptationSpeed, 0.1f, 10.0f, "%.1f");
+            ImGui::SliderFloat("Key Value", &post.KeyValue, 0.05f, 0.5f, "%.2f");
+            ImGui::DragFloatRange2("Percentiles", &post.LowPercent, &post.HighPercent, 0.01f, 0.0f, 1.0f, "%.2f");
+        }
+
+        ImGui::Checkbox("Bloom", &post.Bloom);
+        if (post.Bloom) {
+            ImGui::SliderFloat("Bloom Threshold", &post.BloomThreshold, 0.0f, 5.0f, "%.2f");
+            ImGui::SliderFloat("Bloom Knee", &post.BloomKnee, 0.0f, 1.0f, "%.2f");
+            ImGui::SliderFloat("Bloom Intensity", &post.BloomIntensity, 0.0f, 0.5f, "%.3f");
+            int levels = static_cast<int>(post.BloomLevels);
+            if (ImGui::SliderInt("Bloom Levels", &levels, 1, static_cast<int>(Engine::PostProcessStack::MaxBloomLevels))) {
+                post.BloomLevels = static_cast<Engine::u32>(levels);
+            }
+        }
+
+        ImGui::SliderFloat("Contrast", &post.Contrast, 0.5f, 1.5f, "%.2f");
+        ImGui::SliderFloat("Saturation", &post.Saturation, 0.0f, 2.0f, "%.2f");
+        ImGui::ColorEdit3("Color Filter", &post.ColorFilter.x);
 
         if (ImGui::Button("Reset Post-Process")) {
-            m_Context->Exposure = 1.0f;
-            m_Context->Gamma = 2.2f;
+            post = Engine::PostProcessStack::Settings();
         }
     }
 
+    // Lighting
+    if (ImGui::CollapsingHeader("Lighting", ImGuiTreeNodeFlags_DefaultOpen) && m_Context->LightingSystem) {
+        static const char* modeNames[] = {"Clustered (Full-screen)", "Tiled Compute"};
+
+        int currentMode = static_cast<int>(m_Context->LightingSystem->GetLightingMode());
+        if (ImGui::Combo("Shading Path", &currentMode, modeNames, 2)) {
+            m_Context->LightingSystem->SetLightingMode(static_cast<Engine::LightingMode>(currentMode));
+        }
+
+        static const char* layoutNames[] = {"Standard", "Compact"};
+
+        auto& gbuffer = m_Context->LightingSystem->GetGBuffer();
+        int currentLayout = static_cast<int>(gbuffer.GetLayout());
+        if (ImGui::Combo("G-Buffer Layout", &currentLayout, layoutNames, 2)) {
+            m_Context->LightingSystem->SetGBufferLayout(static_cast<Engine::GBufferLayout>(currentLayout));
+        }
+
+        bool depthPrepass = m_Context->LightingSystem->IsDepthPrepassEnabled();
+        if (ImGui::Checkbox("Depth Prepass", &depthPrepass)) {
+            m_Context->LightingSystem->SetDepthPrepass(depthPrepass);
+        }
+
+        bool meshletCulling = m_Context->LightingSystem->IsMeshletCullingEnabled();
+        if (ImGui::Checkbox("Meshlet Culling", &meshletCulling)) {
+            m_Context->LightingSystem->SetMeshletCulling(meshletCulling);
+        }
+
+        auto& budget = m_Context->LightingSystem->GetLightBudget();
+        ImGui::Checkbox("Light Budget", &budget.Enabled);
+        if (budget.Enabled) {
+            ImGui::Indent();
+            ImGui::SliderInt("Max Point Lights", reinterpret_cast<int*>(&budget.MaxPointLights), 16, 4096);
+            ImGui::SliderInt("Max Spot Lights", reinterpret_cast<int*>(&budget.MaxSpotLights), 4, 1024);
+            ImGui::SliderFloat("Min Coverage", &budget.MinScreenCoverage, 0.0f, 0.05f, "%.4f");
+            ImGui::SliderFloat("Fade Band", &budget.FadeBand, 1.0f, 4.0f);
+            ImGui::SliderFloat("Fade Time", &budget.FadeTime, 0.0f, 2.0f, "%.2f s");
+            ImGui::Unindent();
+        }
+
+        auto& occlusion = m_Context->LightingSystem->GetAmbientOcclusion().GetSettings();
+        ImGui::Checkbox("Ambient Occlusion", &occlusion.Enabled);
+        if (occlusion.Enabled) {
+            ImGui::Indent();
+            ImGui::SliderFloat("Radius##AO", &occlusion.Radius, 0.1f, 5.0f);
+            ImGui::SliderFloat("Intensity##AO", &occlusion.Intensity, 0.5f, 4.0f);
+            ImGui::SliderInt("Directions##AO", reinterpret_cast<int*>(&occlusion.Directions), 1,
+                             static_cast<int>(Engine::AmbientOcclusion::MaxDirections));
+            ImGui::SliderInt("Steps##AO", reinterpret_cast<int*>(&occlusion.Steps), 1,
+                             static_cast<int>(Engine::AmbientOcclusion::MaxSteps));
+            ImGui::Unindent();
+        }
+
+        auto& volumetricFog = m_Context->LightingSystem->GetVolumetricFog();
+        auto& fog = volumetricFog.GetSettings();
+        ImGui::Checkbox("Volumetric Fog", &fog.Enabled);
+        if (fog.Enabled) {
+            ImGui::Indent();
+            ImGui::SliderFloat("Density##Fog", &fog.Density, 0.0f, 0.2f, "%.4f");
+            ImGui::ColorEdit3("Albedo##Fog", &fog.Albedo.x);
+            ImGui::SliderFloat("Anisotropy##Fog", &fog.Anisotropy, -0.9f, 0.9f, "%.2f");
+            ImGui::DragFloat("Base Height##Fog", &fog.BaseHeight, 0.1f);
+            ImGui::SliderFloat("Height Falloff##Fog", &fog.HeightFalloff, 0.0f, 1.0f, "%.3f");
+            ImGui::SliderFloat("Ambient##Fog", &fog.AmbientIntensity, 0.0f, 4.0f, "%.2f");
+            ImGui::SliderFloat("Range##Fog", &fog.Range, 10.0f, 500.0f, "%.0f");
+            ImGui::SliderFloat("Temporal Blend##Fog", &fog.TemporalBlend, 0.02f, 1.0f, "%.2f");
+            ImGui::TextDisabled("%ux%ux%u froxels, %.1f MB", fog.GridWidth, fog.GridHeight, fog.GridDepth,
+                                static_cast<float>(volumetricFog.GetMemorySize()) / (1024.0f * 1024.0f));
+            ImGui::Unindent();
+        }
+
+        Engine::u32 bytesPerPixel = gbuffer.GetBytesPerPixel();
+        float megabytes = static_cast<float>(bytesPerPixel) * gbuffer.GetWidth() * gbuffer.GetHeight() / (1024.0f * 1024.0f);
+        ImGui::TextDisabled("%u bytes/pixel, %.1f MB per G-Buffer read", bytesPerPixel, megabytes);
+    }
+
+    // Resolution
+    if (ImGui::CollapsingHeader("Resolution") && m_Context->LightingSystem) {
+        auto* lighting = m_Context->LightingSystem;
+        auto& dynamic = lighting->GetDynamicResolution();
+        auto& settings = dynamic.GetSettings();
+
+        if (ImGui::Checkbox("Dynamic Resolution", &settings.Enabled)) {
+            dynamic.Reset();
+        }
+
+        if (settings.Enabled) {
+            ImGui::SliderFloat("GPU Budget (ms)", &settings.TargetGPUTimeMs, 2.0f, 33.3f, "%.1f");
+            ImGui::SliderFloat("Min Scale", &settings.MinScale, 0.25f, 1.0f, "%.2f");
+            ImGui::TextDisabled("GPU %.2f ms averaged", dynamic.GetAverageGPUTimeMs());
+        } else {
+            float scale = lighting->GetFixedRenderScale();
+            if (ImGui::SliderFloat("Render Scale", &scale, 0.25f, 1.0f, "%.2f")) {
+                lighting->SetRenderScale(scale);
+            }
+        }
+
+        bool temporalAA = lighting->IsTemporalAAEnabled();
+        if (ImGui::Checkbox("Temporal AA / Upscaling", &temporalAA)) {
+            lighting->SetTemporalAA(temporalAA);
+        }
+        if (temporalAA) {
+            auto& taa = lighting->GetTemporalAA().GetSettings();
+            ImGui::SliderFloat("History Blend", &taa.BlendFactor, 0.02f, 0.5f, "%.2f");
+            ImGui::SliderFloat("Variance Clip", &taa.VarianceClip, 0.5f, 2.5f, "%.2f");
+        }
+
+        if (m_Context->PostProcess && !temporalAA) {
+            ImGui::SliderFloat("Upscale Sharpness", &m_Context->PostProcess->GetSettings().Sharpness, 0.0f, 1.0f, "%.2f");
+        }
+        ImGui::Text("Rendering %ux%u (%.0f%%)", lighting->GetRenderWidth(), lighting->GetRenderHeight(),
+                    lighting->GetRenderScale() * 100.0f);
+    }
+
     // Shadow Settings
     if (ImGui::CollapsingHeader("Shadows", ImGuiTreeNodeFlags_DefaultOpen)) {
         ImGui::Checkbox("Enable Shadows", &m_Context->ShadowsEnabled);
@@ -37,6 +176,59 @@ void RenderSettingsPanel::OnImGuiRender() {
 
             ImGui::SliderFloat("Max Distance", &settings.MaxShadowDistance, 10.0f, 500.0f);
             ImGui::SliderFloat("Cascade Lambda", &settings.CascadeSplitLambda, 0.0f, 1.0f);
+            ImGui::Checkbox("Single-Pass Cascades", &settings.SinglePassCascades);
+            ImGui::Checkbox("Stable Cascades", &settings.StableCascades);
+
+            // Update interval per cascade, as a power of two
+            static const char* intervals[] = {"Every frame", "Every 2nd", "Every 4th", "Every 8th"};
+            for (Engine::u32 cascade = 0; cascade < Engine::CSM_CASCADE_COUNT; ++cascade) {
+                Engine::u32& interval = settings.CascadeUpdateIntervals[cascade];
+                int current = 0;
+                while (current < 3 && (1u << current) < interval) {
+                    current++;
+                }
+                char label[16];
+                std::snprintf(label, sizeof(label), "Cascade %u", cascade);
+                if (ImGui::Combo(label, &current, intervals, IM_ARRAYSIZE(intervals))) {
+                    interval = 1u << current;
+                }
+            }
+
+            ImGui::Unindent();
+
+            // Virtual shadow map near the camera, cascades beyond
+            ImGui::Text("Virtual Shadow Map:");
+            ImGui::Indent();
+
+            ImGui::Checkbox("Enable##VirtualShadowMap", &settings.UseVirtualShadowMap);
+            if (settings.UseVirtualShadowMap) {
+                if (!m_Context->ShadowSystem->IsVirtualShadowMapActive()) {
+                    ImGui::TextDisabled("Sparse textures unsupported, using cascades");
+                }
+                ImGui::SliderFloat("Distance##VirtualShadowMap", &settings.VirtualShadowDistance, 8.0f, 256.0f);
+                ImGui::SliderInt("Page Budget", reinterpret_cast<int*>(&settings.VirtualShadowPageBudget), 64, 8192);
+                ImGui::SliderInt("Pages Per Frame", reinterpret_cast<int*>(&settings.VirtualShadowPagesPerFrame), 8, 1024);
+            }
+
+            ImGui::Unindent();
+
+            // Spot shadow atlas
+            ImGui::Text("Spot Shadows:");
+            ImGui::Indent();
+
+            ImGui::SliderFloat("Resolution Scale", &settings.SpotShadowResolutionScale, 0.25f, 4.0f);
+            ImGui::SliderInt("Throttle Interval", reinterpret_cast<int*>(&settings.SpotShadowThrottleInterval), 1, 8);
+            ImGui::SliderInt("Max Shadowed##Spot", reinterpret_cast<int*>(&settings.MaxShadowedSpotLights), 0,
+                             static_cast<int>(Engine::MAX_SHADOW_CASTING_SPOT));
+
+            ImGui::Unindent();
+
+            ImGui::Text("Point Shadows:");
+            ImGui::Indent();
+
+            ImGui::SliderInt("Max Shadowed##Point", reinterpret_cast<int*>(&settings.MaxShadowedPointLights), 0,
+                             static_cast<int>(Engine::MAX_SHADOW_CASTING_POINT));
+            ImGui::SliderFloat("Min Shadow Coverage", &settings.MinShadowCoverage, 0.0f, 0.2f, "%.3f");
 
             ImGui::Unindent();
 
@@ -45,8 +237,24 @@ void RenderSettingsPanel::OnImGuiRender() {
             ImGui::Text("Quality:");
             ImGui::Indent();
 
-            ImGui::SliderInt("PCF Samples", reinterpret_cast<int*>(&settings.PCFSamples), 1, 64);
+            static const char* filters[] = {"PCF", "EVSM (prefiltered)"};
+            int filter = static_cast<int>(settings.Filter);
+            if (ImGui::Combo("Filter", &filter, filters, IM_ARRAYSIZE(filters))) {
+                settings.Filter = static_cast<Engine::ShadowFilter>(filter);
+            }
+            if (settings.Filter == Engine::ShadowFilter::EVSM) {
+                ImGui::SliderFloat("Positive Exponent", &settings.EVSMPositiveExponent, 1.0f, 42.0f);
+                ImGui::SliderFloat("Negative Exponent", &settings.EVSMNegativeExponent, 1.0f, 42.0f);
+                ImGui::SliderInt("Blur Radius", reinterpret_cast<int*>(&settings.EVSMBlurRadius), 0, 4);
+                ImGui::SliderFloat("Light Bleed Reduction", &settings.LightBleedReduction, 0.0f, 0.95f);
+            } else {
+                ImGui::SliderInt("PCF Samples", reinterpret_cast<int*>(&settings.PCFSamples), 1, 64);
+            }
             ImGui::Checkbox("Use PCSS", &settings.UsePCSS);
+            ImGui::Checkbox("Cache Static Casters", &settings.CacheStaticShadows);
+            if (ImGui::Button("Invalidate Shadow Cache")) {
+                m_Context->ShadowSystem->InvalidateShadowCache();
+            }
 
             ImGui::Unindent();
         }
@@ -60,11 +268,14 @@ void RenderSettingsPanel::OnImGuiRender() {
             "GBuffer Albedo",
             "GBuffer Normals",
             "GBuffer Depth",
-            "GBuffer Metal/Rough"
+            "GBuffer Metal/Rough",
+            "Hi-Z Pyramid",
+            "Overdraw"
         };
+        static_assert(IM_ARRAYSIZE(viewNames) == static_cast<int>(Engine::DebugView::Count));
 
         int currentView = static_cast<int>(m_Context->CurrentDebugView);
-        if (ImGui::Combo("Debug View", &currentView, viewNames, 6)) {
+        if (ImGui::Combo("Debug View", &currentView, viewNames, IM_ARRAYSIZE(viewNames))) {
             m_Context->CurrentDebugView = static_cast<Engine::DebugView>(currentView);
             if (m_Context->DebugRenderer) {
                 m_Context->DebugRenderer->SetActiveView(m_Context->CurrentDebugView);
@@ -76,10 +287,37 @@ void RenderSettingsPanel::OnImGuiRender() {
 
     // Rendering Options
     if (ImGui::CollapsingHeader("Options")) {
-        ImGui::Checkbox("VSync", &m_Context->VSyncEnabled);
         ImGui::Checkbox("Wireframe Mode", &m_Context->WireframeMode);
     }
 
+    // Frame Pacing
+    if (ImGui::CollapsingHeader("Frame Pacing")) {
+        auto& application = Engine::Application::Get();
+        auto& window = application.GetWindow();
+        auto& pacer = application.GetFramePacer();
+        auto& settings = pacer.GetSettings();
+
+        static const char* vsyncNames[] = {"Off", "On", "Adaptive"};
+        const int vsyncCount = window.IsAdaptiveVSyncSupported() ? 3 : 2;
+        int vsyncMode = static_cast<int>(window.GetVSyncMode());
+        if (ImGui::Combo("VSync", &vsyncMode, vsyncNames, vsyncCount)) {
+            window.SetVSyncMode(static_cast<Engine::VSyncMode>(vsyncMode));
+        }
+
+        ImGui::DragFloat("FPS Limit", &settings.TargetFPS, 1.0f, 0.0f, 1000.0f,
+                         settings.TargetFPS > 0.0f ? "%.0f" : "Off");
+
+        int framesInFlight = static_cast<int>(settings.MaxFramesInFlight);
+        if (ImGui::SliderInt("Max Frames In Flight", &framesInFlight, 0, 3, framesInFlight > 0 ? "%d" : "Driver")) {
+            settings.MaxFramesInFlight = static_cast<Engine::u32>(framesInFlight);
+        }
+
+        const auto& stats = pacer.GetStats();
+        ImGui::Text("Latency (input to GPU done): %.1f ms", stats.LatencyMs);
+        ImGui::TextDisabled("In flight %u, limiter %.2f ms, queue wait %.2f ms",
+                            stats.FramesInFlight, stats.LimiterWaitMs, stats.QueueWaitMs);
+    }
+
     ImGui::End();
 }
 
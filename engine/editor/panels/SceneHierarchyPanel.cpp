@@ -2,12 +2,55 @@
 #include "ecs/Core.hpp"
 #include "ecs/Components/LightComponents.hpp"
 #include "ecs/Components/NameComponent.hpp"
+#include "resources/ResourceManager.hpp"
 #include <imgui.h>
 #include <imgui_internal.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
 #include <cstring>
 
 namespace Editor {
 
+void SceneHierarchyPanel::OnInit(EditorContext& context) {
+    Panel::OnInit(context);
+
+    auto& registry = m_Context->Registry->Raw();
+    registry.on_construct<Engine::Transform>().connect<&SceneHierarchyPanel::OnTreeChanged>(this);
+    registry.on_destroy<Engine::Transform>().connect<&SceneHierarchyPanel::OnTreeChanged>(this);
+    registry.on_construct<Engine::Hierarchy>().connect<&SceneHierarchyPanel::OnTreeChanged>(this);
+    registry.on_update<Engine::Hierarchy>().connect<&SceneHierarchyPanel::OnTreeChanged>(this);
+    registry.on_destroy<Engine::Hierarchy>().connect<&SceneHierarchyPanel::OnTreeChanged>(this);
+    registry.on_construct<Engine::NameComponent>().connect<&SceneHierarchyPanel::OnNameChanged>(this);
+    registry.on_update<Engine::NameComponent>().connect<&SceneHierarchyPanel::OnNameChanged>(this);
+    registry.on_destroy<Engine::NameComponent>().connect<&SceneHierarchyPanel::OnNameChanged>(this);
+}
+
+void SceneHierarchyPanel::OnShutdown() {
+    auto& registry = m_Context->Registry->Raw();
+    registry.on_construct<Engine::Transform>().disconnect(this);
+    registry.on_destroy<Engine::Transform>().disconnect(this);
+    registry.on_construct<Engine::Hierarchy>().disconnect(this);
+    registry.on_update<Engine::Hierarchy>().disconnect(this);
+    registry.on_destroy<Engine::Hierarchy>().disconnect(this);
+    registry.on_construct<Engine::NameComponent>().disconnect(this);
+    registry.on_update<Engine::NameComponent>().disconnect(this);
+    registry.on_destroy<Engine::NameComponent>().disconnect(this);
+}
+
+void SceneHierarchyPanel::OnTreeChanged(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    (void)entity;
+    m_TreeDirty = true;
+    m_NamesDirty = true;
+}
+
+void SceneHierarchyPanel::OnNameChanged(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    (void)entity;
+    m_NamesDirty = true;
+}
+
 void SceneHierarchyPanel::OnImGuiRender() {
     ImGui::Begin("Scene Hierarchy");
 
@@ -27,6 +70,15 @@ void SceneHierarchyPanel::OnImGuiRender() {
         ImGui::EndPopup();
     }
 
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(ImGui::GetContentRegionAvail().x);
+    if (ImGui::InputTextWithHint("##search", "Search", m_SearchBuffer, sizeof(m_SearchBuffer))) {
+        m_Search = m_SearchBuffer;
+        std::transform(m_Search.begin(), m_Search.end(), m_Search.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        m_SearchDirty = true;
+    }
+
     ImGui::Separator();
 
     // Count entities for display
@@ -34,18 +86,37 @@ void SceneHierarchyPanel::OnImGuiRender() {
 
     ImGui::Separator();
 
-    // Draw all entities
-    // First, draw root entities (those without Hierarchy or marked as RootEntity)
-    auto view = registry.view<Engine::Transform>();
-    for (auto entity : view) {
-        // Skip if has parent
-        auto* hierarchy = registry.try_get<Engine::Hierarchy>(entity);
-        if (hierarchy && hierarchy->Parent != entt::null) {
-            continue;
+    if (m_TreeDirty) {
+        RebuildRows();
+    }
+
+    // Search shows matching entities as a flat list
+    const Engine::Vector<Row>* rows = &m_Rows;
+    if (!m_Search.empty()) {
+        if (m_NamesDirty) {
+            RebuildSearchIndex();
         }
+        if (m_SearchDirty) {
+            RebuildSearchRows();
+        }
+        rows = &m_SearchRows;
+    }
 
-        DrawEntityNode(entity);
+    // Only the rows in view are submitted. Toggling a node rebuilds the
+    // rows next frame, so this frame keeps drawing the current list.
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(rows->size()));
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+            const Row& row = (*rows)[i];
+            if (registry.valid(row.Entity)) {
+                DrawRow(row);
+            } else {
+                ImGui::TextDisabled("...");
+            }
+        }
     }
+    clipper.End();
 
     // Deselect when clicking empty space
     if (ImGui::IsMouseDown(0) && ImGui::IsWindowHovered() && !ImGui::IsAnyItemHovered()) {
@@ -76,8 +147,82 @@ void SceneHierarchyPanel::OnImGuiRender() {
     ImGui::End();
 }
 
-void SceneHierarchyPanel::DrawEntityNode(entt::entity entity) {
+void SceneHierarchyPanel::RebuildRows() {
+    auto& registry = m_Context->Registry->Raw();
+
+    m_Rows.clear();
+    for (auto entity : registry.view<Engine::Transform>()) {
+        auto* hierarchy = registry.try_get<Engine::Hierarchy>(entity);
+        if (hierarchy && hierarchy->Parent != entt::null) {
+            continue;
+        }
+        AppendRows(entity, 0);
+    }
+
+    // Forget destroyed entities
+    std::erase_if(m_Expanded, [&](entt::entity entity) { return !registry.valid(entity); });
+
+    m_TreeDirty = false;
+    m_SearchDirty = true;
+}
+
+void SceneHierarchyPanel::AppendRows(entt::entity entity, Engine::u32 depth) {
+    auto& registry = m_Context->Registry->Raw();
+    auto* hierarchy = registry.try_get<Engine::Hierarchy>(entity);
+
+    Row row;
+    row.Entity = entity;
+    row.Depth = depth;
+    row.HasChildren = hierarchy && hierarchy->FirstChild != entt::null;
+    m_Rows.push_back(row);
+
+    if (!row.HasChildren || !m_Expanded.contains(entity)) {
+        return;
+    }
+
+    entt::entity child = hierarchy->FirstChild;
+    while (child != entt::null) {
+        AppendRows(child, depth + 1);
+        auto* childHierarchy = registry.try_get<Engine::Hierarchy>(child);
+        child = childHierarchy ? childHierarchy->NextSibling : entt::null;
+    }
+}
+
+void SceneHierarchyPanel::RebuildSearchIndex() {
+    auto& registry = m_Context->Registry->Raw();
+
+    m_SearchIndex.clear();
+    for (auto entity : registry.view<Engine::Transform>()) {
+        const Engine::FrameString display = GetEntityDisplayName(entity);
+        Engine::String name(display.begin(), display.end());
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        m_SearchIndex.emplace_back(entity, std::move(name));
+    }
+
+    m_NamesDirty = false;
+    m_SearchDirty = true;
+}
+
+void SceneHierarchyPanel::RebuildSearchRows() {
+    m_SearchRows.clear();
+    for (const auto& [entity, name] : m_SearchIndex) {
+        if (name.find(m_Search) != Engine::String::npos) {
+            m_SearchRows.push_back(Row{entity, 0, false});
+        }
+    }
+    m_SearchDirty = false;
+}
+
+void SceneHierarchyPanel::DrawRow(const Row& row) {
     auto& registry = m_Context->Registry->Raw();
+    const entt::entity entity = row.Entity;
+
+    ImGui::PushID(static_cast<int>(static_cast<Engine::u32>(entity)));
+    const float indent = static_cast<float>(row.Depth) * ImGui::GetStyle().IndentSpacing;
+    if (indent > 0.0f) {
+        ImGui::Indent(indent);
+    }
 
     // Check if we're renaming this entity
     if (m_RenamingEntity == entity) {
@@ -91,9 +236,8 @@ void SceneHierarchyPanel::DrawEntityNode(entt::entity entity) {
         if (ImGui::InputText("##rename", buffer, sizeof(buffer),
                             ImGuiInputTextFlags_EnterReturnsTrue |
                             ImGuiInputTextFlags_AutoSelectAll)) {
-            // Apply new name
-            auto& name = registry.get_or_emplace<Engine::NameComponent>(entity);
-            name.Name = buffer;
+            // Apply new name (replace notifies the search index)
+            registry.emplace_or_replace<Engine::NameComponent>(entity, Engine::StringId(buffer));
             m_RenamingEntity = entt::null;
         }
 
@@ -102,80 +246,71 @@ void SceneHierarchyPanel::DrawEntityNode(entt::entity entity) {
             (ImGui::IsMouseClicked(0) && !ImGui::IsItemHovered())) {
             m_RenamingEntity = entt::null;
         }
+    } else {
+        const Engine::FrameString label = GetEntityDisplayName(entity);
 
-        return;
-    }
-
-    Engine::String label = GetEntityDisplayName(entity);
-
-    // Check for children
-    bool hasChildren = false;
-    auto* hierarchy = registry.try_get<Engine::Hierarchy>(entity);
-    if (hierarchy && hierarchy->FirstChild != entt::null) {
-        hasChildren = true;
-    }
-
-    // Tree node flags
-    ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow |
-                               ImGuiTreeNodeFlags_SpanAvailWidth;
+        // Expansion is tracked here, so ImGui never pushes a tree level
+        ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow |
+                                   ImGuiTreeNodeFlags_SpanAvailWidth |
+                                   ImGuiTreeNodeFlags_NoTreePushOnOpen;
 
-    if (m_Context->IsSelected(entity)) {
-        flags |= ImGuiTreeNodeFlags_Selected;
-    }
+        if (m_Context->IsSelected(entity)) {
+            flags |= ImGuiTreeNodeFlags_Selected;
+        }
 
-    if (!hasChildren) {
-        flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
-    }
+        if (!row.HasChildren) {
+            flags |= ImGuiTreeNodeFlags_Leaf;
+        }
 
-    bool opened = ImGui::TreeNodeEx(reinterpret_cast<void*>(static_cast<Engine::u64>(entity)),
-                                    flags, "%s", label.c_str());
+        const bool expanded = m_Expanded.contains(entity);
+        ImGui::SetNextItemOpen(expanded);
+        const bool opened = ImGui::TreeNodeEx("##node", flags, "%s", label.c_str());
+        if (row.HasChildren && opened != expanded) {
+            if (opened) {
+                m_Expanded.insert(entity);
+            } else {
+                m_Expanded.erase(entity);
+            }
+            m_TreeDirty = true;
+        }
 
-    // Selection on single click
-    if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen()) {
-        m_Context->Select(entity);
-    }
+        // Selection on single click
+        if (ImGui::IsItemClicked() && !ImGui::IsItemToggledOpen()) {
+            m_Context->Select(entity);
+        }
 
-    // Start rename on double-click (but not on arrow)
-    if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(0)) {
-        m_RenamingEntity = entity;
-        m_RenameBuffer = label;
-    }
+        // Start rename on double-click (but not on arrow)
+        if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(0)) {
+            m_RenamingEntity = entity;
+            m_RenameBuffer.assign(label.begin(), label.end());
+        }
 
-    // Context menu
-    DrawEntityContextMenu(entity);
+        // Context menu
+        DrawEntityContextMenu(entity);
 
-    // Drag and drop source
-    if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_None)) {
-        ImGui::SetDragDropPayload("ENTITY_DRAG", &entity, sizeof(entt::entity));
-        ImGui::Text("%s", label.c_str());
-        ImGui::EndDragDropSource();
-    }
+        // Drag and drop source
+        if (ImGui::BeginDragDropSource(ImGuiDragDropFlags_None)) {
+            ImGui::SetDragDropPayload("ENTITY_DRAG", &entity, sizeof(entt::entity));
+            ImGui::Text("%s", label.c_str());
+            ImGui::EndDragDropSource();
+        }
 
-    // Drag and drop target (for parenting)
-    if (ImGui::BeginDragDropTarget()) {
-        if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("ENTITY_DRAG")) {
-            entt::entity droppedEntity = *static_cast<const entt::entity*>(payload->Data);
-            if (droppedEntity != entity) {
-                Engine::HierarchyUtils::SetParent(registry, droppedEntity, entity);
+        // Drag and drop target (for parenting)
+        if (ImGui::BeginDragDropTarget()) {
+            if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("ENTITY_DRAG")) {
+                entt::entity droppedEntity = *static_cast<const entt::entity*>(payload->Data);
+                if (droppedEntity != entity) {
+                    Engine::HierarchyUtils::SetParent(registry, droppedEntity, entity);
+                }
             }
+            ImGui::EndDragDropTarget();
         }
-        ImGui::EndDragDropTarget();
     }
 
-    // Draw children
-    if (opened && hasChildren) {
-        // Iterate through children
-        auto* h = registry.try_get<Engine::Hierarchy>(entity);
-        if (h) {
-            entt::entity child = h->FirstChild;
-            while (child != entt::null) {
-                DrawEntityNode(child);
-                auto* childHierarchy = registry.try_get<Engine::Hierarchy>(child);
-                child = childHierarchy ? childHierarchy->NextSibling : entt::null;
-            }
-        }
-        ImGui::TreePop();
+    if (indent > 0.0f) {
+        ImGui::Unindent(indent);
     }
+    ImGui::PopID();
 }
 
 void SceneHierarchyPanel::DrawEntityContextMenu(entt::entity entity) {
@@ -197,13 +332,14 @@ void SceneHierarchyPanel::DrawEntityContextMenu(entt::entity entity) {
     }
 }
 
-Engine::String SceneHierarchyPanel::GetEntityDisplayName(entt::entity entity) {
+Engine::FrameString SceneHierarchyPanel::GetEntityDisplayName(entt::entity entity) {
     auto& registry = m_Context->Registry->Raw();
 
     // First check if entity has a custom name
     if (auto* name = registry.try_get<Engine::NameComponent>(entity)) {
-        if (!name->Name.empty()) {
-            return name->Name;
+        if (!name->Name.IsEmpty()) {
+            const std::string_view text = name->Name.View();
+            return Engine::FrameString(text.begin(), text.end());
         }
     }
 
@@ -222,14 +358,17 @@ Engine::String SceneHierarchyPanel::GetEntityDisplayName(entt::entity entity) {
     }
     if (registry.all_of<Engine::MeshComponent>(entity)) {
         auto& mesh = registry.get<Engine::MeshComponent>(entity);
-        if (!mesh.MeshName.empty()) {
-            return mesh.MeshName;
+        const auto& meshName = Engine::ResourceManager::Instance().GetMeshName(mesh.Mesh);
+        if (!meshName.empty()) {
+            return Engine::FrameString(meshName.begin(), meshName.end());
         }
         return "Mesh Entity";
     }
 
     // Default name
-    return "Entity " + std::to_string(static_cast<Engine::u32>(entity));
+    char fallback[32];
+    std::snprintf(fallback, sizeof(fallback), "Entity %u", static_cast<Engine::u32>(entity));
+    return fallback;
 }
 
 } // namespace Editor
@@ -2,21 +2,58 @@
 
 #include "Panel.hpp"
 #include "core/Types.hpp"
+#include "core/FrameAllocator.hpp"
 #include <entt/entt.hpp>
+#include <unordered_set>
 
 namespace Editor {
 
+// Entity tree of the scene. The tree is kept flattened into the rows an
+// expanded view shows and rebuilt only when registry signals report a
+// change (entities with a Transform created or destroyed, Hierarchy links
+// or names changed) or a node is toggled; only the rows in view are drawn,
+// through ImGuiListClipper. Search filters a prebuilt index of lowercase
+// display names.
 class SceneHierarchyPanel : public Panel {
 public:
     SceneHierarchyPanel() : Panel("Scene Hierarchy") {}
 
+    void OnInit(EditorContext& context) override;
+    void OnShutdown() override;
     void OnImGuiRender() override;
 
 private:
-    void DrawEntityNode(entt::entity entity);
+    struct Row {
+        entt::entity Entity = entt::null;
+        Engine::u32 Depth = 0;
+        bool HasChildren = false;
+    };
+
+    void DrawRow(const Row& row);
     void DrawEntityContextMenu(entt::entity entity);
 
-    Engine::String GetEntityDisplayName(entt::entity entity);
+    // Rebuilt for every row drawn, so it lives in the frame arena
+    Engine::FrameString GetEntityDisplayName(entt::entity entity);
+
+    // Registry signals
+    void OnTreeChanged(entt::registry& registry, entt::entity entity);
+    void OnNameChanged(entt::registry& registry, entt::entity entity);
+
+    void RebuildRows();
+    void RebuildSearchIndex();
+    void RebuildSearchRows();
+    void AppendRows(entt::entity entity, Engine::u32 depth);
+
+    // Flattened tree and the search over it
+    Engine::Vector<Row> m_Rows;
+    Engine::Vector<Row> m_SearchRows;
+    Engine::Vector<std::pair<entt::entity, Engine::String>> m_SearchIndex;  // Lowercase names
+    std::unordered_set<entt::entity> m_Expanded;
+    char m_SearchBuffer[128] = {};
+    Engine::String m_Search;        // Lowercase
+    bool m_TreeDirty = true;
+    bool m_NamesDirty = true;
+    bool m_SearchDirty = true;
 
     // Rename state
     entt::entity m_RenamingEntity = entt::null;
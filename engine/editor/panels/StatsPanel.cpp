@@ -1,40 +1,232 @@
 #include "StatsPanel.hpp"
 #include "core/Time.hpp"
+#include "core/MemoryTracker.hpp"
 #include "ecs/Components/Transform.hpp"
 #include "ecs/Components/Renderable.hpp"
 #include "ecs/Components/LightComponents.hpp"
+#include "renderer/opengl/GPUProfiler.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/TextureUploadRing.hpp"
+#include "resources/ResourceManager.hpp"
 #include <imgui.h>
 
 namespace Editor {
 
+namespace {
+
+float ToMegabytes(Engine::u64 bytes) {
+    return static_cast<float>(static_cast<double>(bytes) / (1024.0 * 1024.0));
+}
+
+} // anonymous namespace
+
 void StatsPanel::OnImGuiRender() {
     ImGui::Begin("Statistics");
 
-    // Update FPS smoothing
-    Engine::f32 deltaTime = Engine::Time::GetDeltaTime();
-    m_FrameTimes.push_back(deltaTime);
-    if (m_FrameTimes.size() > SampleCount) {
-        m_FrameTimes.erase(m_FrameTimes.begin());
-    }
+    Engine::FrameStats* frameStats = m_Context->FrameStats;
 
+    // Percentiles are recomputed a few times a second, not every frame
     Engine::f32 currentTime = Engine::Time::GetTime();
-    if (currentTime - m_LastFPSUpdate >= UpdateInterval) {
-        if (!m_FrameTimes.empty()) {
-            Engine::f32 sum = 0.0f;
-            for (Engine::f32 dt : m_FrameTimes) {
-                sum += dt;
-            }
-            m_SmoothedFPS = static_cast<Engine::f32>(m_FrameTimes.size()) / sum;
-            m_SmoothedFrameTime = (sum / static_cast<Engine::f32>(m_FrameTimes.size())) * 1000.0f;
+    if (frameStats && currentTime - m_LastFPSUpdate >= UpdateInterval) {
+        m_FrameSummary = frameStats->GetFrameTimes().Summarize();
+        frameStats->GetFrameTimes().CopyOrdered(m_FrameHistory);
+
+        m_SystemSummaries.clear();
+        for (const auto& [name, history] : frameStats->GetSystemTimes()) {
+            m_SystemSummaries.emplace_back(name, history.Summarize());
         }
+        m_AllocationSummary = frameStats->GetFrameAllocations().Summarize();
         m_LastFPSUpdate = currentTime;
     }
 
     // Frame stats
     if (ImGui::CollapsingHeader("Performance", ImGuiTreeNodeFlags_DefaultOpen)) {
-        ImGui::Text("FPS: %.1f", m_SmoothedFPS);
-        ImGui::Text("Frame Time: %.2f ms", m_SmoothedFrameTime);
+        const auto& summary = m_FrameSummary;
+        ImGui::Text("FPS: %.1f", summary.Average > 0.0f ? 1000.0f / summary.Average : 0.0f);
+        ImGui::Text("Frame Time: %.2f ms avg", summary.Average);
+        ImGui::Text("p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms", summary.P50, summary.P95, summary.P99, summary.Max);
         ImGui::Text("Total Time: %.1f s", Engine::Time::GetTime());
+
+        if (frameStats) {
+            auto& settings = frameStats->GetSettings();
+            if (!m_FrameHistory.empty()) {
+                // Scaled so the hitch threshold sits at two thirds of the height
+                ImGui::PlotHistogram("##FrameTimes", m_FrameHistory.data(), static_cast<int>(m_FrameHistory.size()),
+                                     0, "Frame times", 0.0f, settings.HitchThresholdMs * 1.5f,
+                                     ImVec2(ImGui::GetContentRegionAvail().x, 60.0f));
+            }
+
+            ImGui::DragFloat("Hitch Threshold", &settings.HitchThresholdMs, 0.5f, 1.0f, 1000.0f, "%.1f ms");
+            const auto& hitches = frameStats->GetHitches();
+            ImGui::Text("Hitches: %u", hitches.Count);
+            if (hitches.Count > 0) {
+                ImGui::SameLine();
+                ImGui::TextDisabled("(last %.1f ms, %llu frames ago)", hitches.LastTimeMs,
+                                    static_cast<unsigned long long>(frameStats->GetFrameNumber() - hitches.LastFrame));
+            }
+#ifdef ENGINE_ENABLE_PROFILING
+            ImGui::Checkbox("Capture Trace on Hitch", &settings.CaptureTraceOnHitch);
+            if (!hitches.LastCapture.empty()) {
+                ImGui::TextDisabled("Last capture: %s", hitches.LastCapture.c_str());
+            }
+#endif
+        }
+    }
+
+    // Per-system CPU time over the same window
+    if (frameStats && ImGui::CollapsingHeader("Systems")) {
+        if (ImGui::BeginTable("SystemTimes", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+            ImGui::TableSetupColumn("System");
+            ImGui::TableSetupColumn("avg");
+            ImGui::TableSetupColumn("p95");
+            ImGui::TableSetupColumn("max");
+            ImGui::TableHeadersRow();
+            for (const auto& [name, summary] : m_SystemSummaries) {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(name);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", summary.Average);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", summary.P95);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", summary.Max);
+            }
+            ImGui::EndTable();
+        }
+    }
+
+    // GPU time per render pass, a few frames behind
+    if (ImGui::CollapsingHeader("GPU Passes", ImGuiTreeNodeFlags_DefaultOpen)) {
+        using Engine::GPUProfiler;
+        if (GPUProfiler::IsPipelineStatisticsSupported()) {
+            bool statistics = GPUProfiler::IsPipelineStatisticsEnabled();
+            if (ImGui::Checkbox("Pipeline statistics", &statistics)) {
+                GPUProfiler::SetPipelineStatisticsEnabled(statistics);
+            }
+        }
+        const bool showStatistics = GPUProfiler::IsPipelineStatisticsEnabled();
+
+        const auto& passes = GPUProfiler::GetResults();
+        if (passes.empty()) {
+            ImGui::TextDisabled("No GPU timings yet");
+        } else if (ImGui::BeginTable("GPUPasses", showStatistics ? 6 : 2, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+            if (showStatistics) {
+                ImGui::TableSetupColumn("Pass");
+                ImGui::TableSetupColumn("Time");
+                ImGui::TableSetupColumn("Vertices");
+                ImGui::TableSetupColumn("Primitives");
+                ImGui::TableSetupColumn("Fragments");
+                ImGui::TableSetupColumn("Compute");
+                ImGui::TableHeadersRow();
+            }
+            for (const auto& pass : passes) {
+                // Smoothed like the frame time, per pass name
+                Engine::f32& smoothed = m_GPUPassTimes[pass.Name];
+                smoothed = smoothed == 0.0f ? pass.TimeMs : smoothed + (pass.TimeMs - smoothed) * GPUTimeSmoothing;
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                if (pass.Depth > 0) {
+                    ImGui::SetCursorPosX(ImGui::GetCursorPosX() + static_cast<float>(pass.Depth) * ImGui::GetStyle().IndentSpacing);
+                }
+                ImGui::TextUnformatted(pass.Name);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f ms", smoothed);
+                if (showStatistics) {
+                    const auto& counts = pass.Statistics;
+                    for (Engine::u64 value : {counts.VerticesSubmitted, counts.PrimitivesSubmitted,
+                                              counts.FragmentInvocations, counts.ComputeInvocations}) {
+                        ImGui::TableNextColumn();
+                        if (pass.HasStatistics) {
+                            ImGui::Text("%llu", static_cast<unsigned long long>(value));
+                        } else {
+                            ImGui::TextDisabled("-");
+                        }
+                    }
+                }
+            }
+            ImGui::EndTable();
+        }
+        ImGui::Text("GPU Total: %.2f ms", GPUProfiler::GetTotalTimeMs());
+        if (Engine::u32 dropped = GPUProfiler::GetDroppedFrames()) {
+            ImGui::TextDisabled("Frames not read back in time: %u", dropped);
+        }
+
+        // Last full frame; ImGui's own state changes bypass the cache
+        const auto& stateStats = Engine::GLStateCache::Instance().GetFrameStats();
+        ImGui::Text("GL state changes: %u", stateStats.Issued);
+        ImGui::SameLine();
+        ImGui::TextDisabled("(%u redundant skipped)", stateStats.Skipped);
+    }
+
+    // CPU heap (MemoryTracker) and GPU storage (GLMemory) per subsystem
+    if (ImGui::CollapsingHeader("Memory")) {
+        using Engine::MemoryTracker;
+        const bool cpuTracking = MemoryTracker::IsCPUTrackingEnabled();
+        const auto total = MemoryTracker::GetTotal();
+
+        if (cpuTracking) {
+            ImGui::Text("CPU: %.1f MB in %llu allocations", ToMegabytes(total.LiveBytes),
+                        static_cast<unsigned long long>(total.LiveAllocations));
+            ImGui::Text("Allocations/frame: %llu  (avg %.0f  p95 %.0f  max %.0f)",
+                        static_cast<unsigned long long>(total.FrameAllocations),
+                        m_AllocationSummary.Average, m_AllocationSummary.P95, m_AllocationSummary.Max);
+            if (frameStats) {
+                auto& settings = frameStats->GetSettings();
+                int threshold = static_cast<int>(settings.AllocationSpikeThreshold);
+                if (ImGui::DragInt("Spike Threshold", &threshold, 10.0f, 1, 1000000)) {
+                    settings.AllocationSpikeThreshold = static_cast<Engine::u32>(threshold);
+                }
+                const auto& spikes = frameStats->GetAllocationSpikes();
+                ImGui::Text("Allocation spikes: %u", spikes.Count);
+                if (spikes.Count > 0) {
+                    ImGui::SameLine();
+                    ImGui::TextDisabled("(last %llu allocations, frame %llu)",
+                                        static_cast<unsigned long long>(spikes.LastAllocations),
+                                        static_cast<unsigned long long>(spikes.LastFrame));
+                }
+            }
+        } else {
+            ImGui::TextDisabled("CPU tracking off (ENGINE_ENABLE_MEMORY_TRACKING)");
+        }
+        ImGui::Text("GPU: %.1f MB buffers, %.1f MB textures", ToMegabytes(total.GPUBufferBytes),
+                    ToMegabytes(total.GPUTextureBytes));
+
+        const auto resources = Engine::ResourceManager::Instance().GetStats();
+        ImGui::Text("Meshes: %.1f MB CPU copies, %.1f MB geometry, %u evicted", ToMegabytes(resources.MeshCPUMemory),
+                    ToMegabytes(resources.MeshGPUMemory), resources.MeshesEvicted);
+
+        if (Engine::TextureUploadRing::IsInitialized()) {
+            const auto ring = Engine::TextureUploadRing::GetStats();
+            ImGui::Text("Texture staging: %.1f / %.1f MB in %u blocks (%u unstaged)", ToMegabytes(ring.BytesInUse),
+                        ToMegabytes(ring.Capacity), ring.BlocksInUse, ring.StagingFailures);
+        }
+
+        if (ImGui::BeginTable("MemoryTags", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp)) {
+            ImGui::TableSetupColumn("Subsystem");
+            ImGui::TableSetupColumn("CPU MB");
+            ImGui::TableSetupColumn("Allocs/frame");
+            ImGui::TableSetupColumn("Buffers MB");
+            ImGui::TableSetupColumn("Textures MB");
+            ImGui::TableHeadersRow();
+            for (Engine::u32 i = 0; i < static_cast<Engine::u32>(Engine::MemoryTag::Count); ++i) {
+                const auto tag = static_cast<Engine::MemoryTag>(i);
+                const auto stats = MemoryTracker::GetStats(tag);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(Engine::MemoryTagToString(tag));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", ToMegabytes(stats.LiveBytes));
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", static_cast<unsigned long long>(stats.FrameAllocations));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", ToMegabytes(stats.GPUBufferBytes));
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", ToMegabytes(stats.GPUTextureBytes));
+            }
+            ImGui::EndTable();
+        }
     }
 
     // Entity stats
@@ -77,13 +269,57 @@ void StatsPanel::OnImGuiRender() {
         if (m_Context->LightingSystem) {
             auto& stats = m_Context->LightingSystem->GetStats();
             ImGui::Text("Entities Rendered: %u", stats.EntitiesRendered);
+            ImGui::Text("Geometry Batches: %u (%u draw calls)", stats.Batches, stats.DrawCalls);
+            if (m_Context->LightingSystem->IsDepthPrepassEnabled()) {
+                ImGui::Text("Depth Prepass: %u draw calls", stats.PrepassDrawCalls);
+            }
+            ImGui::Text("Triangles: %u", stats.Triangles);
+            if (stats.MeshletInstances > 0) {
+                ImGui::Text("Meshlets: %u tested, %u instances (%u draw calls)",
+                            stats.MeshletsTested, stats.MeshletInstances, stats.MeshletDrawCalls);
+            }
+            ImGui::Text("Lights Uploaded: %u", stats.LightsUploaded);
+            if (m_Context->LightingSystem->GetLightBudget().Enabled) {
+                ImGui::Text("Lights Culled: %u (%u fading)", stats.LightsCulled, stats.LightsFading);
+            }
+        }
+
+        if (m_Context->CullingSystem) {
+            auto& stats = m_Context->CullingSystem->GetStats();
+            ImGui::Checkbox("Frustum Culling", &m_Context->FrustumCullingEnabled);
+            ImGui::Text("Visible: %u / %u (culled %u)", stats.Visible, stats.Tested, stats.Culled);
+        }
+
+        if (m_Context->LODSystem) {
+            auto& settings = m_Context->LODSystem->GetSettings();
+            auto& stats = m_Context->LODSystem->GetStats();
+            ImGui::Checkbox("Mesh LODs", &settings.Enabled);
+            ImGui::SliderFloat("LOD Error (px)", &settings.MaxScreenError, 0.25f, 8.0f, "%.2f");
+            ImGui::Text("Reduced LOD: %u / %u (%u switched)", stats.Reduced, stats.Selected, stats.Changed);
         }
 
         if (m_Context->ShadowSystem) {
             auto& stats = m_Context->ShadowSystem->GetStats();
-            ImGui::Text("Shadow Casters: %u", stats.ShadowCastersRendered);
-            ImGui::Text("Cascades Rendered: %u", stats.CascadesRendered);
-            ImGui::Text("Spot Shadows: %u", stats.SpotShadowsRendered);
+            ImGui::Text("Shadow Casters: %u cascade, %u spot", stats.ShadowCastersRendered, stats.SpotCastersRendered);
+            ImGui::Text("Cascades Rendered: %u (%u scheduled out)", stats.CascadesRendered, stats.ScheduledOutCascades);
+            ImGui::Text("Shadow Draw Calls: %u", stats.ShadowDrawCalls);
+            ImGui::Text("Spot Shadows: %u (%u throttled)", stats.SpotShadowsRendered, stats.SpotShadowsThrottled);
+            if (auto* atlas = m_Context->ShadowSystem->GetSpotAtlas()) {
+                ImGui::Text("Spot Atlas: %u tiles, %.0f%% used", atlas->GetAllocatedTileCount(), atlas->GetOccupancy() * 100.0f);
+            }
+            ImGui::Text("Cached: %u cascades, %u spot", stats.CachedCascades, stats.CachedSpotShadows);
+            ImGui::Text("Point Shadows: %u (%u faces, %u skipped)", stats.PointShadowsRendered,
+                        stats.PointFacesRendered, stats.PointFacesSkipped);
+            if (m_Context->ShadowSystem->IsMomentFilteringActive()) {
+                ImGui::Text("EVSM Regions Filtered: %u", stats.MomentRegionsFiltered);
+            }
+            if (const auto* vsm = m_Context->ShadowSystem->GetVirtualShadowMap(); vsm && vsm->IsValid()) {
+                const auto& pages = vsm->GetStats();
+                ImGui::Text("Virtual Pages: %u resident / %u required (budget %u)", pages.ResidentPages,
+                            pages.RequiredPages, vsm->GetPageBudget());
+                ImGui::Text("Virtual Pages: %u rendered, %u dirty, %u committed, %u evicted", pages.PagesRendered,
+                            pages.DirtyPages, pages.PagesCommitted, pages.PagesEvicted);
+            }
         }
     }
 
@@ -2,6 +2,7 @@
 
 #include "Panel.hpp"
 #include "core/Types.hpp"
+#include "core/FrameStats.hpp"
 
 namespace Editor {
 
@@ -12,12 +13,15 @@ public:
     void OnImGuiRender() override;
 
 private:
-    Engine::Vector<Engine::f32> m_FrameTimes;
-    Engine::f32 m_SmoothedFPS = 60.0f;
-    Engine::f32 m_SmoothedFrameTime = 16.67f;
+    // Refreshed every UpdateInterval from EditorContext::FrameStats
+    Engine::TimingHistory::Summary m_FrameSummary;
+    Engine::TimingHistory::Summary m_AllocationSummary;
+    Engine::Vector<Engine::f32> m_FrameHistory;
+    Engine::Vector<std::pair<const char*, Engine::TimingHistory::Summary>> m_SystemSummaries;
     Engine::f32 m_LastFPSUpdate = 0.0f;
-    static constexpr Engine::u32 SampleCount = 60;
+    Engine::HashMap<const char*, Engine::f32> m_GPUPassTimes;
     static constexpr Engine::f32 UpdateInterval = 0.5f;
+    static constexpr Engine::f32 GPUTimeSmoothing = 0.1f;
 };
 
 } // namespace Editor
@@ -1,7 +1,12 @@
 #include "ViewportPanel.hpp"
 #include "ecs/Core.hpp"
+#include "ecs/Components/Animation.hpp"
+#include "ecs/Components/LightComponents.hpp"
+#include "resources/ResourceManager.hpp"
 #include "core/Input.hpp"
 #include "math/Ray.hpp"
+#include "renderer/debug/DebugDraw.hpp"
+#include "renderer/opengl/GPUProfiler.hpp"
 #include <imgui.h>
 #include <ImGuizmo.h>
 #include <glad/gl.h>
@@ -9,6 +14,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/matrix_decompose.hpp>
+#include <algorithm>
 #include <limits>
 
 namespace Editor {
@@ -16,83 +22,209 @@ namespace Editor {
 ViewportPanel::ViewportPanel(EditorCamera* camera, Engine::Framebuffer* framebuffer,
                              Engine::DeferredLightingSystem* lightingSystem,
                              Engine::ShadowMapSystem* shadowSystem,
-                             Engine::Ref<Engine::Shader> tonemapShader,
-                             Engine::Ref<Engine::VertexArray> screenQuadVAO,
                              Engine::DebugRenderer* debugRenderer)
     : Panel("Viewport")
     , m_Camera(camera)
     , m_Framebuffer(framebuffer)
     , m_LightingSystem(lightingSystem)
     , m_ShadowSystem(shadowSystem)
-    , m_TonemapShader(tonemapShader)
-    , m_ScreenQuadVAO(screenQuadVAO)
     , m_DebugRenderer(debugRenderer)
 {
     m_GridRenderer = Engine::CreateScope<Engine::GridRenderer>();
     m_IconRenderer = Engine::CreateScope<Engine::EditorIconRenderer>();
+    m_CameraUniforms = Engine::CreateScope<Engine::CameraUniformBuffer>();
+}
+
+namespace {
+
+// What the viewport draws, besides transforms: those are noticed through
+// TransformSystem's stats rather than a patch per moved entity
+using DrawnComponents = entt::type_list<
+    Engine::MeshComponent, Engine::MaterialComponent, Engine::Renderable,
+    Engine::DirectionalLightComponent, Engine::PointLightComponent,
+    Engine::SpotLightComponent, Engine::AmbientLightComponent>;
+
+template<typename... Components>
+void ConnectChanges(Engine::ChangeSet& changes, entt::registry& registry, entt::type_list<Components...>) {
+    (changes.Connect<Components>(registry), ...);
+}
+
+template<typename... Components>
+void DisconnectChanges(Engine::ChangeSet& changes, entt::registry& registry, entt::type_list<Components...>) {
+    (changes.Disconnect<Components>(registry), ...);
+}
+
+} // anonymous namespace
+
+void ViewportPanel::OnInit(EditorContext& context) {
+    Panel::OnInit(context);
+    ConnectChanges(m_SceneChanges, m_Context->Registry->Raw(), DrawnComponents{});
+}
+
+void ViewportPanel::OnShutdown() {
+    DisconnectChanges(m_SceneChanges, m_Context->Registry->Raw(), DrawnComponents{});
+}
+
+void ViewportPanel::OnEvent(Engine::Event& event) {
+    // Clicks, keys and scrolling may change anything (shortcuts, inspector
+    // writes, picking); plain mouse movement only hovers
+    switch (event.GetEventType()) {
+        case Engine::EventType::KeyPressed:
+        case Engine::EventType::KeyReleased:
+        case Engine::EventType::MouseButtonPressed:
+        case Engine::EventType::MouseButtonReleased:
+        case Engine::EventType::MouseScrolled:
+        case Engine::EventType::WindowResize:
+        case Engine::EventType::WindowFocus:
+            RequestRedraw();
+            break;
+        default:
+            break;
+    }
+}
+
+bool ViewportPanel::UpdateRedraw() {
+    auto& registry = m_Context->Registry->Raw();
+    auto& resources = Engine::ResourceManager::Instance();
+
+    bool changed = !m_Context->IdleRendering || m_Context->State != PlayState::Edit ||
+                   ImGui::IsAnyItemActive();
+
+    m_SceneChanges.Rotate();
+    if (!m_SceneChanges.IsEmpty()) {
+        changed = true;
+    }
+
+    const glm::mat4& view = m_Camera->GetViewMatrix();
+    const glm::mat4& projection = m_Camera->GetProjectionMatrix();
+    if (view != m_LastView || projection != m_LastProjection) {
+        m_LastView = view;
+        m_LastProjection = projection;
+        changed = true;
+    }
+
+    if (m_Context->TransformSystem && m_Context->TransformSystem->GetStats().UpdatedCount > 0) {
+        changed = true;
+    }
+
+    // Hot reloads and loads landing, mips streaming in
+    if (resources.GetUploadCount() != m_LastUploadCount) {
+        m_LastUploadCount = resources.GetUploadCount();
+        changed = true;
+    }
+    if (resources.GetTextureStreamer().GetStats().LevelsStreamedIn > 0) {
+        changed = true;
+    }
+
+    // Animations advance in Edit mode too
+    if (!changed) {
+        auto animators = registry.view<Engine::AnimatorComponent>();
+        for (auto entity : animators) {
+            if (animators.get<Engine::AnimatorComponent>(entity).Playing) {
+                changed = true;
+                break;
+            }
+        }
+    }
+
+    if (changed) {
+        RequestRedraw();
+    }
+
+    const bool redraw = m_RedrawFrames > 0;
+    m_RedrawFrames = redraw ? m_RedrawFrames - 1 : 0;
+    m_Context->ViewportRedrawPending = m_RedrawFrames > 0;
+    return redraw;
 }
 
 void ViewportPanel::OnUpdate(Engine::f32 deltaTime) {
     (void)deltaTime;
 
     if (m_ViewportSizeChanged && m_ViewportSize.x > 0 && m_ViewportSize.y > 0) {
-        m_Framebuffer->Resize(static_cast<Engine::u32>(m_ViewportSize.x),
-                              static_cast<Engine::u32>(m_ViewportSize.y));
+        RequestRedraw();
+        // Only moves the viewport while a dock splitter is dragged, see Framebuffer::Fit
+        m_Framebuffer->Fit(static_cast<Engine::u32>(m_ViewportSize.x),
+                           static_cast<Engine::u32>(m_ViewportSize.y));
         m_LightingSystem->Resize(static_cast<Engine::u32>(m_ViewportSize.x),
                                   static_cast<Engine::u32>(m_ViewportSize.y));
         m_Camera->SetViewportSize(m_ViewportSize.x, m_ViewportSize.y);
         m_ViewportSizeChanged = false;
+        m_ResizeFramesToSettle = Engine::DeferredLightingSystem::ResizeSettleFrames;
+    } else if (m_ResizeFramesToSettle > 0 && --m_ResizeFramesToSettle == 0) {
+        // A reallocation loses the last frame; the redraw also lets the
+        // lighting system count down to trimming its own buffers
+        if (m_Framebuffer->Fit(static_cast<Engine::u32>(m_ViewportSize.x),
+                               static_cast<Engine::u32>(m_ViewportSize.y), true)) {
+            RequestRedraw();
+        }
     }
 }
 
 void ViewportPanel::RenderScene() {
     auto& registry = m_Context->Registry->Raw();
 
+    // Every pass below reads the camera from the shared uniform block
+    m_CameraUniforms->Upload(m_Camera->GetCamera());
+
     // Set camera for systems
     m_ShadowSystem->SetCamera(const_cast<Engine::Camera*>(&m_Camera->GetCamera()));
     m_LightingSystem->SetCamera(const_cast<Engine::Camera*>(&m_Camera->GetCamera()));
 
+    // Bounds and frustum visibility for the geometry pass
+    if (auto* culling = m_Context->CullingSystem) {
+        culling->SetCamera(const_cast<Engine::Camera*>(&m_Camera->GetCamera()));
+        culling->SetCullingEnabled(m_Context->FrustumCullingEnabled);
+        culling->Update(registry, 0.0f);
+    }
+
+    // Level of detail for what survived culling
+    if (auto* lod = m_Context->LODSystem) {
+        lod->SetCamera(const_cast<Engine::Camera*>(&m_Camera->GetCamera()));
+        lod->SetViewportHeight(static_cast<Engine::u32>(m_ViewportSize.y));
+        lod->Update(registry, 0.0f);
+    }
+
     // Shadow pass
     if (m_Context->ShadowsEnabled) {
-        m_ShadowSystem->OnUpdate(registry, 0.0f);
+        m_ShadowSystem->Update(registry, 0.0f);
     }
 
     // Deferred lighting pass
-    m_LightingSystem->OnUpdate(registry, 0.0f);
+    m_LightingSystem->Update(registry, 0.0f);
+
+    // Post-process into the viewport framebuffer, upscaling whatever
+    // fraction of the lighting buffer was rendered (or the TAA history)
+    const auto scene = m_LightingSystem->ResolveSceneColor();
+    {
+        GPU_PROFILE_SCOPE("Post Process");
+        m_Context->PostProcess->Render(*scene.Buffer, scene.UVScale,
+                                       static_cast<Engine::u32>(m_ViewportSize.x),
+                                       static_cast<Engine::u32>(m_ViewportSize.y), ImGui::GetIO().DeltaTime);
+        m_Context->PostProcess->Blit(m_Framebuffer->GetRendererID());
+    }
 
-    // Tonemap to viewport framebuffer
     m_Framebuffer->Bind();
     glViewport(0, 0, static_cast<GLsizei>(m_ViewportSize.x), static_cast<GLsizei>(m_ViewportSize.y));
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glDisable(GL_DEPTH_TEST);
-
-    m_TonemapShader->Bind();
-    m_TonemapShader->SetInt("u_HDRBuffer", 0);
-    m_TonemapShader->SetFloat("u_Exposure", m_Context->Exposure);
-    m_TonemapShader->SetFloat("u_Gamma", m_Context->Gamma);
+    glClear(GL_DEPTH_BUFFER_BIT);
 
-    m_LightingSystem->GetLightingBuffer().BindColorTexture(0, 0);
-
-    m_ScreenQuadVAO->Bind();
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
-
-    glEnable(GL_DEPTH_TEST);
+    GPU_PROFILE_SCOPE("Editor Overlays");
 
     // Render grid
     if (m_GridRenderer && m_GridRenderer->IsVisible()) {
-        glm::mat4 vp = m_Camera->GetProjectionMatrix() * m_Camera->GetViewMatrix();
-        m_GridRenderer->Render(vp, m_Camera->GetPosition());
+        m_GridRenderer->Render();
     }
 
     // Render editor icons for entities without meshes
     if (m_IconRenderer && m_IconRenderer->IsVisible()) {
-        glm::mat4 view = m_Camera->GetViewMatrix();
-        glm::mat4 projection = m_Camera->GetProjectionMatrix();
-        glm::vec3 cameraRight = glm::vec3(view[0][0], view[1][0], view[2][0]);
-        glm::vec3 cameraUp = glm::vec3(view[0][1], view[1][1], view[2][1]);
-        m_IconRenderer->Render(registry, view, projection, cameraRight, cameraUp);
+        m_IconRenderer->Render(registry);
     }
 
+    // World-space debug lines, tested against the scene's depth
+    Engine::DebugDraw::Render(m_LightingSystem->GetGBuffer().GetDepthTextureID(),
+                              m_LightingSystem->GetRenderUVScale(),
+                              static_cast<Engine::u32>(m_ViewportSize.x),
+                              static_cast<Engine::u32>(m_ViewportSize.y));
+
     // Debug overlay
     if (m_Context->CurrentDebugView != Engine::DebugView::None) {
         m_DebugRenderer->Render(static_cast<Engine::u32>(m_ViewportSize.x),
@@ -102,12 +234,19 @@ void ViewportPanel::RenderScene() {
     m_Framebuffer->Unbind();
 }
 
-void ViewportPanel::RenderGizmo() {
-    if (!m_Context->HasSelection()) return;
-
+bool ViewportPanel::RenderGizmo() {
     auto& registry = m_Context->Registry->Raw();
+
+    // A drag is one undo step, ending once the gizmo is let go
+    if (m_GizmoEditing && !ImGuizmo::IsUsing()) {
+        m_Context->History->EndEdit(registry);
+        m_GizmoEditing = false;
+    }
+
+    if (!m_Context->HasSelection()) return false;
+
     auto* transform = registry.try_get<Engine::Transform>(m_Context->SelectedEntity);
-    if (!transform) return;
+    if (!transform) return false;
 
     ImGuizmo::SetOrthographic(false);
     ImGuizmo::SetDrawlist();
@@ -157,49 +296,73 @@ void ViewportPanel::RenderGizmo() {
         }
     }
 
-    // Store original position for symmetry calculation
-    glm::vec3 originalPos = transform->Position;
+    // The selection's deltas are taken against this
+    const glm::mat4 originalWorld = transformMatrix;
+
+    // Capture before the press moves anything
+    if (m_Context->History && !m_GizmoEditing && m_Context->State == PlayState::Edit &&
+        ImGuizmo::IsOver() && ImGui::IsMouseClicked(ImGuiMouseButton_Left)) {
+        m_GizmoEditing = m_Context->History->BeginEdit(
+            registry,
+            m_Context->MultiSelection.empty() ? Engine::Vector<entt::entity>{m_Context->SelectedEntity}
+                                              : m_Context->MultiSelection,
+            "Transform");
+    }
 
     // Manipulate
-    if (ImGuizmo::Manipulate(glm::value_ptr(view), glm::value_ptr(projection),
-                             operation, mode, glm::value_ptr(transformMatrix),
-                             nullptr, snapValues)) {
-        // Decompose and apply
-        glm::vec3 translation, scale, skew;
-        glm::vec4 perspective;
-        glm::quat rotation;
+    if (!ImGuizmo::Manipulate(glm::value_ptr(view), glm::value_ptr(projection),
+                              operation, mode, glm::value_ptr(transformMatrix),
+                              nullptr, snapValues)) {
+        return false;
+    }
+
+    // Decompose and apply
+    glm::vec3 translation, scale, skew;
+    glm::vec4 perspective;
+    glm::quat rotation;
 
-        glm::decompose(transformMatrix, scale, rotation, translation, skew, perspective);
+    glm::decompose(transformMatrix, scale, rotation, translation, skew, perspective);
 
+    if (!m_Context->TransformSystem) {
         transform->SetPosition(translation);
         transform->SetRotation(rotation);
         transform->SetScale(scale);
-        transform->UpdateWorldMatrix();
+        return true;
+    }
+
+    // The whole selection moves as world space deltas, which TransformSystem
+    // brings into each entity's parent space and resolves with the hierarchy
+    glm::vec3 originalScale, originalTranslation;
+    glm::quat originalRotation;
+    glm::decompose(originalWorld, originalScale, originalRotation, originalTranslation, skew, perspective);
+
+    Engine::TransformSystem::TransformEdit edit;
+    edit.Translation = translation - originalTranslation;
+    edit.Rotation = glm::normalize(rotation * glm::inverse(originalRotation));
+    edit.Scale = scale / glm::max(originalScale, glm::vec3(1e-6f));
+    m_Context->TransformSystem->SubmitEdit({m_Context->SelectedEntity}, edit);
+
+    if (m_Context->MultiSelection.size() > 1) {
+        Engine::Vector<entt::entity> others;
+        others.reserve(m_Context->MultiSelection.size() - 1);
+        for (auto entity : m_Context->MultiSelection) {
+            if (entity != m_Context->SelectedEntity) others.push_back(entity);
+        }
 
-        // Apply symmetry to other selected entities
         auto& sym = m_Context->Symmetry;
         if (sym.Enabled && (sym.MirrorX || sym.MirrorY || sym.MirrorZ)) {
-            glm::vec3 delta = translation - originalPos;
-
-            // Mirror the delta
-            glm::vec3 mirroredDelta = delta;
-            if (sym.MirrorX) mirroredDelta.x = -mirroredDelta.x;
-            if (sym.MirrorY) mirroredDelta.y = -mirroredDelta.y;
-            if (sym.MirrorZ) mirroredDelta.z = -mirroredDelta.z;
-
-            // Apply mirrored delta to other entities in multi-selection
-            for (auto entity : m_Context->MultiSelection) {
-                if (entity == m_Context->SelectedEntity) continue;
-
-                auto* otherTransform = registry.try_get<Engine::Transform>(entity);
-                if (otherTransform) {
-                    glm::vec3 otherPos = otherTransform->Position;
-                    otherTransform->SetPosition(otherPos + mirroredDelta);
-                    otherTransform->UpdateWorldMatrix();
-                }
-            }
+            // Mirror the translation only
+            Engine::TransformSystem::TransformEdit mirrored;
+            mirrored.Translation = edit.Translation;
+            if (sym.MirrorX) mirrored.Translation.x = -mirrored.Translation.x;
+            if (sym.MirrorY) mirrored.Translation.y = -mirrored.Translation.y;
+            if (sym.MirrorZ) mirrored.Translation.z = -mirrored.Translation.z;
+            m_Context->TransformSystem->SubmitEdit(others, mirrored);
+        } else {
+            m_Context->TransformSystem->SubmitEdit(others, edit);
         }
     }
+    return true;
 }
 
 void ViewportPanel::RenderViewportToolbar() {
@@ -397,13 +560,14 @@ void ViewportPanel::OnImGuiRender() {
 
     // Render scene to framebuffer
     if (m_ViewportSize.x > 0 && m_ViewportSize.y > 0) {
-        RenderScene();
-
-        // Display framebuffer texture
+        // Display framebuffer texture; only the viewport region is drawn.
+        // ImGui samples it when the frame is drawn, so the scene is still
+        // rendered into it below, once the gizmo has had its say.
         Engine::u32 textureID = m_Framebuffer->GetColorAttachmentRendererID();
+        const glm::vec2 uvScale = m_Framebuffer->GetViewportUVScale();
         ImGui::Image(static_cast<ImTextureID>(static_cast<uintptr_t>(textureID)),
                      ImVec2(m_ViewportSize.x, m_ViewportSize.y),
-                     ImVec2(0, 1), ImVec2(1, 0));
+                     ImVec2(0, uvScale.y), ImVec2(uvScale.x, 0));
 
         // Get the exact rect of the viewport image (for gizmo and picking)
         ImVec2 imageMin = ImGui::GetItemRectMin();
@@ -411,8 +575,17 @@ void ViewportPanel::OnImGuiRender() {
         m_Context->ViewportBounds[0] = {imageMin.x, imageMin.y};
         m_Context->ViewportBounds[1] = {imageMax.x, imageMax.y};
 
-        // Render gizmo over the image
-        RenderGizmo();
+        // Render gizmo over the image. Its edits are applied and resolved
+        // before the scene is drawn, so they show this frame rather than
+        // after the next scheduler pass.
+        if (RenderGizmo() && m_Context->TransformSystem) {
+            m_Context->TransformSystem->Update(m_Context->Registry->Raw(), 0.0f);
+        }
+
+        // Otherwise the framebuffer still holds the last frame
+        if (UpdateRedraw()) {
+            RenderScene();
+        }
     }
 
     // Handle mouse picking
@@ -427,7 +600,9 @@ void ViewportPanel::OnResize(Engine::u32 width, Engine::u32 height) {
     (void)height;
 }
 
-entt::entity ViewportPanel::PickEntity(const glm::vec2& mousePos) {
+entt::entity ViewportPanel::PickIcon(const glm::vec2& mousePos) {
+    if (!m_IconRenderer || !m_IconRenderer->IsVisible()) return entt::null;
+
     auto& registry = m_Context->Registry->Raw();
 
     // Create ray from camera through mouse position
@@ -439,24 +614,24 @@ entt::entity ViewportPanel::PickEntity(const glm::vec2& mousePos) {
         m_Camera->GetProjectionMatrix()
     );
 
-    // Find closest intersected entity
+    // Icons are drawn over the scene, so the nearest icon hit wins
     entt::entity closestEntity = entt::null;
     float closestDistance = std::numeric_limits<float>::max();
 
-    // Iterate all renderable entities with mesh bounds
-    auto view = registry.view<Engine::Transform, Engine::Renderable, Engine::MeshComponent>();
-    for (auto entity : view) {
-        auto& renderable = view.get<Engine::Renderable>(entity);
-        if (!renderable.Visible) continue;
+    auto transformView = registry.view<Engine::Transform>();
+    for (auto entity : transformView) {
+        // Meshes are picked through the entity ID buffer
+        if (registry.any_of<Engine::MeshComponent>(entity)) continue;
 
-        auto& mesh = view.get<Engine::MeshComponent>(entity);
-        auto& transform = view.get<Engine::Transform>(entity);
+        // Check if this entity has an icon
+        auto iconType = Engine::EditorIconRenderer::DetermineIconType(registry, entity);
+        if (iconType == Engine::EditorIconType::None) continue;
 
-        // Transform local bounds to world space
-        Engine::AABB worldBounds = mesh.LocalBounds.Transform(transform.WorldMatrix);
+        const auto& transform = transformView.get<Engine::Transform>(entity);
+        Engine::AABB iconBounds = m_IconRenderer->GetIconBounds(transform);
 
         float hitDistance;
-        if (ray.IntersectsAABB(worldBounds, hitDistance)) {
+        if (ray.IntersectsAABB(iconBounds, hitDistance)) {
             if (hitDistance < closestDistance) {
                 closestDistance = hitDistance;
                 closestEntity = entity;
@@ -464,34 +639,104 @@ entt::entity ViewportPanel::PickEntity(const glm::vec2& mousePos) {
         }
     }
 
-    // Also check entities with icons (no mesh but have Transform)
-    if (m_IconRenderer && m_IconRenderer->IsVisible()) {
-        auto transformView = registry.view<Engine::Transform>();
-        for (auto entity : transformView) {
-            // Skip if already processed (has mesh)
-            if (registry.any_of<Engine::MeshComponent>(entity)) continue;
-
-            // Check if this entity has an icon
-            auto iconType = Engine::EditorIconRenderer::DetermineIconType(registry, entity);
-            if (iconType == Engine::EditorIconType::None) continue;
-
-            const auto& transform = transformView.get<Engine::Transform>(entity);
-            Engine::AABB iconBounds = m_IconRenderer->GetIconBounds(transform);
-
-            float hitDistance;
-            if (ray.IntersectsAABB(iconBounds, hitDistance)) {
-                if (hitDistance < closestDistance) {
-                    closestDistance = hitDistance;
-                    closestEntity = entity;
-                }
+    return closestEntity;
+}
+
+void ViewportPanel::RequestPick(const glm::vec2& min, const glm::vec2& max) {
+    const auto& gbuffer = m_LightingSystem->GetGBuffer();
+    const glm::vec2 size(static_cast<float>(gbuffer.GetViewportWidth()), static_cast<float>(gbuffer.GetViewportHeight()));
+
+    // Screen space (top-left origin) to texels (bottom-left origin), scaled
+    // to the rendered region when below output resolution
+    const glm::vec2 origin = m_Context->ViewportBounds[0];
+    const float scale = m_LightingSystem->GetRenderScale();
+    const glm::vec2 first = glm::clamp(glm::floor((glm::min(min, max) - origin) * scale), glm::vec2(0.0f), size - 1.0f);
+    const glm::vec2 last = glm::clamp(glm::floor((glm::max(min, max) - origin) * scale), glm::vec2(0.0f), size - 1.0f);
+
+    const auto x = static_cast<Engine::u32>(first.x);
+    const auto y = static_cast<Engine::u32>(size.y - 1.0f - last.y);
+    const auto width = static_cast<Engine::u32>(last.x - first.x) + 1;
+    const auto height = static_cast<Engine::u32>(last.y - first.y) + 1;
+    m_Picker.Request(gbuffer.GetEntityIdTextureID(), x, y, width, height);
+}
+
+void ViewportPanel::ApplyPick(const Engine::Vector<entt::entity>& entities, bool additive, bool marquee) {
+    auto& registry = m_Context->Registry->Raw();
+
+    if (marquee) {
+        if (!additive) {
+            m_Context->ClearSelection();
+        }
+        for (entt::entity entity : entities) {
+            if (!registry.valid(entity)) continue;
+            if (m_Context->HasSelection()) {
+                m_Context->AddToSelection(entity);
+            } else {
+                m_Context->Select(entity);
             }
         }
+        return;
     }
 
-    return closestEntity;
+    // A single pixel covers at most one entity
+    entt::entity picked = entt::null;
+    if (!entities.empty() && registry.valid(entities.front())) {
+        picked = entities.front();
+    }
+
+    if (picked != entt::null) {
+        // Check for multi-select (Ctrl held)
+        if (additive) {
+            if (m_Context->IsSelected(picked)) {
+                // Deselect if already selected
+                auto& multi = m_Context->MultiSelection;
+                multi.erase(std::remove(multi.begin(), multi.end(), picked), multi.end());
+                if (m_Context->SelectedEntity == picked) {
+                    m_Context->SelectedEntity = multi.empty() ? entt::null : multi.front();
+                }
+            } else {
+                m_Context->AddToSelection(picked);
+            }
+        } else {
+            m_Context->Select(picked);
+        }
+    } else if (!additive) {
+        // Clicked on nothing - clear selection (unless Ctrl is held)
+        m_Context->ClearSelection();
+    }
 }
 
 void ViewportPanel::HandleMousePicking() {
+    // Apply a readback that has landed
+    if (m_Picker.Poll(m_PickResult)) {
+        ApplyPick(m_PickResult, m_PickAdditive, m_PickMarquee);
+    }
+
+    const glm::vec2 mousePos = Engine::Input::GetMousePosition();
+
+    // Marquee: drag with the left button, selected on release
+    if (m_MarqueePressed) {
+        if (!Engine::Input::IsMouseButtonPressed(Engine::Mouse::Left)) {
+            if (m_MarqueeActive) {
+                m_PickMarquee = true;
+                RequestPick(m_MarqueeStart, mousePos);
+            }
+            m_MarqueePressed = false;
+            m_MarqueeActive = false;
+        } else {
+            if (glm::length(mousePos - m_MarqueeStart) > MarqueeThreshold) {
+                m_MarqueeActive = true;
+            }
+            if (m_MarqueeActive) {
+                ImDrawList* drawList = ImGui::GetWindowDrawList();
+                const ImVec2 a(m_MarqueeStart.x, m_MarqueeStart.y);
+                const ImVec2 b(mousePos.x, mousePos.y);
+                drawList->AddRectFilled(a, b, IM_COL32(80, 140, 255, 40));
+                drawList->AddRect(a, b, IM_COL32(80, 140, 255, 200));
+            }
+        }
+    }
+
     // Only pick when hovering viewport and not using gizmo
     if (!m_Context->ViewportHovered) return;
     if (ImGuizmo::IsOver() || ImGuizmo::IsUsing()) return;
@@ -503,37 +748,25 @@ void ViewportPanel::HandleMousePicking() {
 
     // Left click to select
     if (Engine::Input::IsMouseButtonJustPressed(Engine::Mouse::Left)) {
-        glm::vec2 mousePos = Engine::Input::GetMousePosition();
-
         // Check if mouse is within viewport bounds
         if (mousePos.x >= m_Context->ViewportBounds[0].x &&
             mousePos.x <= m_Context->ViewportBounds[1].x &&
             mousePos.y >= m_Context->ViewportBounds[0].y &&
             mousePos.y <= m_Context->ViewportBounds[1].y) {
 
-            entt::entity picked = PickEntity(mousePos);
-
-            if (picked != entt::null) {
-                // Check for multi-select (Ctrl held)
-                if (Engine::Input::IsKeyPressed(Engine::Key::LeftControl)) {
-                    if (m_Context->IsSelected(picked)) {
-                        // Deselect if already selected
-                        auto& multi = m_Context->MultiSelection;
-                        multi.erase(std::remove(multi.begin(), multi.end(), picked), multi.end());
-                        if (m_Context->SelectedEntity == picked) {
-                            m_Context->SelectedEntity = multi.empty() ? entt::null : multi.front();
-                        }
-                    } else {
-                        m_Context->AddToSelection(picked);
-                    }
-                } else {
-                    m_Context->Select(picked);
-                }
+            m_PickAdditive = Engine::Input::IsKeyPressed(Engine::Key::LeftControl);
+            m_MarqueePressed = true;
+            m_MarqueeActive = false;
+            m_MarqueeStart = mousePos;
+
+            // Icons are not in the entity ID buffer
+            entt::entity icon = PickIcon(mousePos);
+            if (icon != entt::null) {
+                m_Picker.Cancel();
+                ApplyPick({icon}, m_PickAdditive, false);
             } else {
-                // Clicked on nothing - clear selection (unless Ctrl is held)
-                if (!Engine::Input::IsKeyPressed(Engine::Key::LeftControl)) {
-                    m_Context->ClearSelection();
-                }
+                m_PickMarquee = false;
+                RequestPick(mousePos, mousePos);
             }
         }
     }
@@ -6,10 +6,11 @@
 #include "renderer/lighting/DeferredLightingSystem.hpp"
 #include "renderer/shadows/ShadowMapSystem.hpp"
 #include "renderer/debug/DebugRenderer.hpp"
+#include "renderer/CameraUniformBuffer.hpp"
 #include "renderer/GridRenderer.hpp"
 #include "renderer/EditorIconRenderer.hpp"
-#include "renderer/opengl/GLShader.hpp"
-#include "renderer/opengl/GLVertexArray.hpp"
+#include "renderer/EntityPicker.hpp"
+#include "ecs/ChangeTracking.hpp"
 
 namespace Editor {
 
@@ -18,34 +19,67 @@ public:
     ViewportPanel(EditorCamera* camera, Engine::Framebuffer* framebuffer,
                   Engine::DeferredLightingSystem* lightingSystem,
                   Engine::ShadowMapSystem* shadowSystem,
-                  Engine::Ref<Engine::Shader> tonemapShader,
-                  Engine::Ref<Engine::VertexArray> screenQuadVAO,
                   Engine::DebugRenderer* debugRenderer);
 
+    void OnInit(EditorContext& context) override;
+    void OnShutdown() override;
     void OnUpdate(Engine::f32 deltaTime) override;
     void OnImGuiRender() override;
+    void OnEvent(Engine::Event& event) override;
     void OnResize(Engine::u32 width, Engine::u32 height) override;
 
 private:
+    // Idle rendering: whether this frame renders the scene or re-presents
+    // the framebuffer as last rendered. Anything that may change the image
+    // - camera, scene edits, transforms resolved, uploads landing, input -
+    // restarts SettleFrames redraws, which let temporal effects converge.
+    bool UpdateRedraw();
+    void RequestRedraw() { m_RedrawFrames = SettleFrames; }
+
     void RenderScene();
-    void RenderGizmo();
+    bool RenderGizmo();     // True if the gizmo moved the selection
     void RenderViewportToolbar();
+    // Meshes are picked by reading the G-buffer entity ID target back
+    // asynchronously (one pixel per click, the rectangle for a marquee);
+    // editor icons, which are not in it, by a ray test
     void HandleMousePicking();
-    entt::entity PickEntity(const glm::vec2& mousePos);
+    entt::entity PickIcon(const glm::vec2& mousePos);
+    void RequestPick(const glm::vec2& min, const glm::vec2& max);
+    void ApplyPick(const Engine::Vector<entt::entity>& entities, bool additive, bool marquee);
 
     EditorCamera* m_Camera;
     Engine::Framebuffer* m_Framebuffer;
     Engine::DeferredLightingSystem* m_LightingSystem;
     Engine::ShadowMapSystem* m_ShadowSystem;
-    Engine::Ref<Engine::Shader> m_TonemapShader;
-    Engine::Ref<Engine::VertexArray> m_ScreenQuadVAO;
     Engine::DebugRenderer* m_DebugRenderer;
     Engine::Scope<Engine::GridRenderer> m_GridRenderer;
     Engine::Scope<Engine::EditorIconRenderer> m_IconRenderer;
+    Engine::Scope<Engine::CameraUniformBuffer> m_CameraUniforms;
+
+    // Picking
+    static constexpr float MarqueeThreshold = 4.0f;     // Pixels dragged before a click becomes a marquee
+    Engine::EntityPicker m_Picker;
+    Engine::Vector<entt::entity> m_PickResult;
+    bool m_PickAdditive = false;
+    bool m_PickMarquee = false;
+    bool m_MarqueePressed = false;
+    bool m_MarqueeActive = false;
+    glm::vec2 m_MarqueeStart{0.0f};
+
+    bool m_GizmoEditing = false;    // Owns the open UndoHistory edit
+
+    // Idle rendering
+    static constexpr Engine::u32 SettleFrames = 16;
+    Engine::u32 m_RedrawFrames = SettleFrames;
+    Engine::ChangeSet m_SceneChanges;
+    glm::mat4 m_LastView{0.0f};
+    glm::mat4 m_LastProjection{0.0f};
+    Engine::u64 m_LastUploadCount = 0;
 
     glm::vec2 m_ViewportSize{0.0f};
     glm::vec2 m_ViewportBounds[2];
     bool m_ViewportSizeChanged = false;
+    Engine::u32 m_ResizeFramesToSettle = 0;    // Until the framebuffer's headroom is trimmed
 };
 
 } // namespace Editor
@@ -13,7 +13,9 @@ enum class EventType {
     // Key events
     KeyPressed, KeyReleased, KeyTyped,
     // Mouse events
-    MouseButtonPressed, MouseButtonReleased, MouseMoved, MouseScrolled
+    MouseButtonPressed, MouseButtonReleased, MouseMoved, MouseScrolled,
+
+    Count   // Size of per-type tables (EventQueue)
 };
 
 enum EventCategory {
@@ -0,0 +1,88 @@
+#include "EventQueue.hpp"
+#include "core/Logger.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace Engine {
+
+// Bounded MPMC ring after Vyukov, with a single consumer. A slot's sequence
+// says whose turn it is: equal to the position, free for the producer that
+// claims that position; position + 1, published and readable; position +
+// capacity, consumed and free for the next lap.
+
+EventQueue::EventQueue(usize capacity)
+    : m_Capacity(std::bit_ceil(std::max<usize>(capacity, 2)))
+    , m_Mask(m_Capacity - 1)
+{
+    m_Slots = CreateScope<Slot[]>(m_Capacity);
+    for (usize i = 0; i < m_Capacity; i++) {
+        m_Slots[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+EventQueue::~EventQueue() {
+    // Events nobody drained still need destroying
+    Drain([](Event&) {});
+}
+
+EventQueue::Slot* EventQueue::Acquire() {
+    u64 position = m_EnqueuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        Slot& slot = m_Slots[position & m_Mask];
+        const u64 sequence = slot.Sequence.load(std::memory_order_acquire);
+        const i64 lag = static_cast<i64>(sequence - position);
+
+        if (lag == 0) {
+            if (m_EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                return &slot;
+            }
+        } else if (lag < 0) {
+            // The consumer hasn't freed this slot from the previous lap
+            if (m_Dropped.fetch_add(1, std::memory_order_relaxed) == 0) {
+                LOG_CORE_WARN("EventQueue full ({} events), dropping events", m_Capacity);
+            }
+            return nullptr;
+        } else {
+            position = m_EnqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void EventQueue::Publish(Slot* slot) {
+    const u64 position = slot->Sequence.load(std::memory_order_relaxed);
+    slot->Sequence.store(position + 1, std::memory_order_release);
+}
+
+EventQueue::Slot* EventQueue::Front() {
+    Slot& slot = m_Slots[m_DequeuePosition & m_Mask];
+    if (slot.Sequence.load(std::memory_order_acquire) != m_DequeuePosition + 1) {
+        return nullptr;
+    }
+    return &slot;
+}
+
+void EventQueue::Release(Slot* slot) {
+    slot->Object->~Event();
+    slot->Object = nullptr;
+    slot->Sequence.store(m_DequeuePosition + m_Capacity, std::memory_order_release);
+    m_DequeuePosition++;
+}
+
+void EventQueue::Invoke(EventType type, Event& event) {
+    // Indexed, not iterated: a handler may subscribe another one
+    auto& handlers = m_Handlers[Index(type)];
+    for (usize i = 0; i < handlers.size(); i++) {
+        const Handler handler = handlers[i];
+        event.Handled |= handler.Invoke(handler.Instance, event);
+    }
+}
+
+void EventQueue::Remove(usize index, void* instance, InvokeFn invoke) {
+    auto& handlers = m_Handlers[index];
+    handlers.erase(std::remove_if(handlers.begin(), handlers.end(), [instance, invoke](const Handler& handler) {
+        return handler.Instance == instance && handler.Invoke == invoke;
+    }), handlers.end());
+}
+
+} // namespace Engine
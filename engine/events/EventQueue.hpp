@@ -0,0 +1,146 @@
+#pragma once
+
+#include "Event.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Engine {
+
+// EventQueue - deferred event delivery with a dense per-type handler table.
+//
+// Post<T>() constructs the event in place in a bounded lock-free ring and
+// may be called from any thread (window callbacks, the file watcher, job
+// workers); it never blocks or allocates, and returns false when the ring
+// is full. The main thread drains the ring once per frame with Drain():
+// each event goes to the handlers subscribed to its type, found by indexing
+// the table with the type stored at post time, then to the fallthrough
+// callback (Application::OnEvent's layer chain). Events posted by handlers
+// during a drain are delivered by the next one.
+//
+// Handlers are member functions bound at compile time, as entt's delegates
+// are (Subscribe<&Class::OnResize>(this)): a table entry is an object
+// pointer and a function pointer, with no std::function in the way. A
+// handler returning true marks the event handled.
+//
+// Subscribe / Unsubscribe / Dispatch / Drain are main thread only.
+class EventQueue {
+public:
+    static constexpr usize DefaultCapacity = 4096;
+    static constexpr usize MaxEventSize = 64;
+
+    explicit EventQueue(usize capacity = DefaultCapacity);
+    ~EventQueue();
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    // Any thread. False (and the event dropped) when the ring is full.
+    template<typename T, typename... Args>
+    bool Post(Args&&... args) {
+        static_assert(std::is_base_of_v<Event, T>, "EventQueue only carries Event types");
+        static_assert(sizeof(T) <= MaxEventSize, "Event too large for an EventQueue slot");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Event over-aligned for an EventQueue slot");
+
+        Slot* slot = Acquire();
+        if (!slot) return false;
+
+        slot->Object = new (slot->Storage) T(std::forward<Args>(args)...);
+        slot->Type = T::GetStaticType();
+        Publish(slot);
+        return true;
+    }
+
+    // Deliver everything posted before the call. Returns the events delivered.
+    template<typename F>
+    u32 Drain(F&& fallthrough) {
+        u32 delivered = 0;
+        const u64 end = m_EnqueuePosition.load(std::memory_order_acquire);
+        while (m_DequeuePosition != end) {
+            Slot* slot = Front();
+            if (!slot) break;   // Claimed but still being written
+
+            Event& event = *slot->Object;
+            Invoke(slot->Type, event);
+            fallthrough(event);
+            Release(slot);
+            delivered++;
+        }
+        return delivered;
+    }
+
+    // Deliver an event immediately through the handler table (main thread)
+    void Dispatch(Event& event) { Invoke(event.GetEventType(), event); }
+
+    template<auto Method, typename Owner>
+    void Subscribe(Owner* owner) {
+        using EventT = typename HandlerTraits<decltype(Method)>::EventType;
+        m_Handlers[Index(EventT::GetStaticType())].push_back({owner, &Trampoline<Method, Owner, EventT>});
+    }
+
+    template<auto Method, typename Owner>
+    void Unsubscribe(Owner* owner) {
+        using EventT = typename HandlerTraits<decltype(Method)>::EventType;
+        Remove(Index(EventT::GetStaticType()), owner, &Trampoline<Method, Owner, EventT>);
+    }
+
+    usize GetCapacity() const { return m_Capacity; }
+    // Posts refused because the ring was full, since creation
+    u64 GetDroppedCount() const { return m_Dropped.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr usize TypeCount = static_cast<usize>(EventType::Count);
+
+    using InvokeFn = bool (*)(void* instance, Event& event);
+
+    struct Handler {
+        void* Instance = nullptr;
+        InvokeFn Invoke = nullptr;
+    };
+
+    struct Slot {
+        std::atomic<u64> Sequence{0};
+        EventType Type = EventType::None;
+        Event* Object = nullptr;
+        alignas(std::max_align_t) u8 Storage[MaxEventSize];
+    };
+
+    template<typename>
+    struct HandlerTraits;
+
+    template<typename Owner, typename E>
+    struct HandlerTraits<bool (Owner::*)(E&)> {
+        using EventType = E;
+    };
+
+    template<auto Method, typename Owner, typename E>
+    static bool Trampoline(void* instance, Event& event) {
+        return (static_cast<Owner*>(instance)->*Method)(static_cast<E&>(event));
+    }
+
+    static usize Index(EventType type) { return static_cast<usize>(type); }
+
+    Slot* Acquire();
+    void Publish(Slot* slot);
+    Slot* Front();
+    void Release(Slot* slot);
+
+    void Invoke(EventType type, Event& event);
+    void Remove(usize index, void* instance, InvokeFn invoke);
+
+private:
+    Scope<Slot[]> m_Slots;
+    usize m_Capacity = 0;
+    u64 m_Mask = 0;
+
+    alignas(64) std::atomic<u64> m_EnqueuePosition{0};
+    alignas(64) u64 m_DequeuePosition = 0;      // Consumer only
+    std::atomic<u64> m_Dropped{0};
+
+    std::array<Vector<Handler>, TypeCount> m_Handlers;
+};
+
+} // namespace Engine
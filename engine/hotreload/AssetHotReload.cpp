@@ -0,0 +1,58 @@
+#include "AssetHotReload.hpp"
+#include "resources/ResourceManager.hpp"
+#include "core/Logger.hpp"
+
+namespace Engine {
+
+AssetHotReload::AssetHotReload() = default;
+
+AssetHotReload::~AssetHotReload() {
+    Shutdown();
+}
+
+void AssetHotReload::Initialize(const fs::path& assetDirectory) {
+    if (m_Initialized) return;
+
+    m_AssetDirectory = assetDirectory;
+    for (const char* extension : {".png", ".jpg", ".jpeg", ".tga", ".bmp", ".ktx2", ".dds", ".obj", ".pvmesh"}) {
+        m_FileWatcher.AddFilter(extension);
+    }
+    m_FileWatcher.Watch(assetDirectory);
+    m_FileWatcher.OnFileChanged([this](const FileEvent& event) { OnFileChanged(event); });
+    m_FileWatcher.Start();
+
+    m_Initialized = true;
+    LOG_CORE_INFO("AssetHotReload: Watching {}", assetDirectory.string());
+}
+
+void AssetHotReload::Shutdown() {
+    if (!m_Initialized) return;
+
+    m_FileWatcher.Stop();
+    m_Initialized = false;
+}
+
+void AssetHotReload::Update() {
+    if (!m_Initialized || !m_Enabled) return;
+
+    m_FileWatcher.Poll();
+}
+
+u32 AssetHotReload::ReloadFile(const fs::path& filepath) {
+    u32 count = ResourceManager::Instance().ReloadFile(filepath.string());
+    if (count > 0) {
+        m_Stats.ChangedFiles++;
+        m_Stats.ReloadsThisSession += count;
+        LOG_CORE_INFO("AssetHotReload: Reloading {} ({} resources)", filepath.string(), count);
+    }
+    return count;
+}
+
+void AssetHotReload::OnFileChanged(const FileEvent& event) {
+    // A removed file keeps what was loaded from it until it comes back
+    if (event.Action == FileAction::Removed) return;
+
+    ReloadFile(event.Path);
+}
+
+} // namespace Engine
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "FileWatcher.hpp"
+#include <filesystem>
+
+namespace Engine {
+
+namespace fs = std::filesystem;
+
+// Hot-reloads textures and meshes. Changed files under the asset directory
+// go to ResourceManager::ReloadFile, which decodes them on the job system
+// and swaps the results into the loaded resources during ProcessUploads -
+// in their existing GPU storage when size and layout hold - so entities
+// keep their handles and Refs.
+class AssetHotReload {
+public:
+    AssetHotReload();
+    ~AssetHotReload();
+
+    // Initialize with asset directory
+    void Initialize(const fs::path& assetDirectory);
+    void Shutdown();
+
+    // Update - call every frame to process file changes
+    void Update();
+
+    // Force reload whatever was loaded from filepath; returns the number of
+    // resources being reloaded
+    u32 ReloadFile(const fs::path& filepath);
+
+    // Configuration
+    void SetEnabled(bool enabled) { m_Enabled = enabled; }
+    bool IsEnabled() const { return m_Enabled; }
+
+    // Statistics
+    struct Statistics {
+        u32 ChangedFiles = 0;           // Loaded by something when they changed
+        u32 ReloadsThisSession = 0;     // Resources reloaded from them
+    };
+
+    const Statistics& GetStats() const { return m_Stats; }
+
+    // Get the file watcher (for adding additional filters/callbacks)
+    FileWatcher& GetFileWatcher() { return m_FileWatcher; }
+
+private:
+    void OnFileChanged(const FileEvent& event);
+
+private:
+    FileWatcher m_FileWatcher;
+    Statistics m_Stats;
+
+    fs::path m_AssetDirectory;
+    bool m_Enabled = true;
+    bool m_Initialized = false;
+};
+
+} // namespace Engine
@@ -1,10 +1,20 @@
 #include "FileWatcher.hpp"
+#include "FileWatcherBackend.hpp"
 #include "core/Logger.hpp"
 #include <algorithm>
 
 namespace Engine {
 
-FileWatcher::FileWatcher() = default;
+namespace {
+
+// Longest the watcher thread blocks, so Stop() and new polled paths are
+// picked up promptly
+constexpr std::chrono::milliseconds kMaxWait{100};
+
+} // namespace
+
+FileWatcher::FileWatcher()
+    : m_Backend(FileWatcherBackend::Create(*this)) {}
 
 FileWatcher::~FileWatcher() {
     Stop();
@@ -29,9 +39,12 @@ void FileWatcher::Watch(const fs::path& path, bool recursive) {
     WatchedDirectory watchedDir;
     watchedDir.Path = path;
     watchedDir.Recursive = recursive;
+    watchedDir.Native = m_Backend && !m_ForcePolling && m_Backend->Add(path, recursive);
 
-    // Initialize timestamps for existing files
-    if (fs::is_directory(path)) {
+    // Initialize timestamps for existing files (polled paths only)
+    if (watchedDir.Native) {
+        // Nothing to snapshot, the OS reports changes as they happen
+    } else if (fs::is_directory(path)) {
         auto iterator = recursive ?
             fs::recursive_directory_iterator(path) :
             fs::recursive_directory_iterator(path, fs::directory_options::none);
@@ -53,8 +66,9 @@ void FileWatcher::Watch(const fs::path& path, bool recursive) {
         watchedDir.FileTimestamps[path] = fs::last_write_time(path);
     }
 
+    LOG_CORE_INFO("Now watching: {} (recursive: {}, {})", path.string(), recursive,
+                  watchedDir.Native ? "native" : "polling");
     m_WatchedDirs.push_back(std::move(watchedDir));
-    LOG_CORE_INFO("Now watching: {} (recursive: {})", path.string(), recursive);
 }
 
 void FileWatcher::Unwatch(const fs::path& path) {
@@ -64,6 +78,9 @@ void FileWatcher::Unwatch(const fs::path& path) {
         [&path](const WatchedDirectory& dir) { return dir.Path == path; });
 
     if (it != m_WatchedDirs.end()) {
+        if (it->Native) {
+            m_Backend->Remove(path);
+        }
         m_WatchedDirs.erase(it);
         LOG_CORE_INFO("Stopped watching: {}", path.string());
     }
@@ -122,21 +139,44 @@ u32 FileWatcher::Poll() {
     return static_cast<u32>(events.size());
 }
 
+usize FileWatcher::GetPolledDirectoryCount() const {
+    std::lock_guard<std::mutex> lock(m_DirMutex);
+    return static_cast<usize>(std::count_if(m_WatchedDirs.begin(), m_WatchedDirs.end(),
+        [](const WatchedDirectory& dir) { return !dir.Native; }));
+}
+
 void FileWatcher::WatcherThread() {
+    using Clock = std::chrono::steady_clock;
+    auto nextScan = Clock::now();
+
     while (m_Running.load()) {
-        {
+        auto now = Clock::now();
+        if (now >= nextScan) {
             std::lock_guard<std::mutex> lock(m_DirMutex);
 
             for (auto& watchedDir : m_WatchedDirs) {
-                CheckDirectory(watchedDir.Path, watchedDir.Recursive);
+                if (!watchedDir.Native) {
+                    CheckDirectory(watchedDir.Path, watchedDir.Recursive);
+                }
             }
+            nextScan = now + std::chrono::milliseconds(static_cast<i64>(m_PollInterval * 1000.0f));
+        }
+
+        // Wake for whichever comes first: the next rescan or a pending
+        // change settling
+        auto wakeAt = std::min({nextScan, FlushChanges(now), now + kMaxWait});
+        auto timeout = std::chrono::ceil<std::chrono::milliseconds>(wakeAt - now);
+
+        if (m_Backend) {
+            m_Backend->Wait(timeout);
+        } else {
+            std::this_thread::sleep_for(timeout);
         }
 
-        // Sleep for poll interval
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(static_cast<i64>(m_PollInterval * 1000.0f))
-        );
+        FlushChanges(Clock::now());
     }
+
+    FlushChanges(Clock::now(), true);
 }
 
 void FileWatcher::CheckDirectory(const fs::path& dir, bool recursive) {
@@ -165,11 +205,11 @@ void FileWatcher::CheckDirectory(const fs::path& dir, bool recursive) {
         if (it == timestamps.end()) {
             // New file
             timestamps[path] = lastWriteTime;
-            QueueEvent({path, FileAction::Added, std::chrono::system_clock::now()});
+            CoalesceChange(path, FileAction::Added);
         } else if (it->second != lastWriteTime) {
             // Modified file
             it->second = lastWriteTime;
-            QueueEvent({path, FileAction::Modified, std::chrono::system_clock::now()});
+            CoalesceChange(path, FileAction::Modified);
         }
     };
 
@@ -193,7 +233,7 @@ void FileWatcher::CheckDirectory(const fs::path& dir, bool recursive) {
     for (const auto& [path, time] : timestamps) {
         if (currentFiles.find(path) == currentFiles.end()) {
             removedFiles.push_back(path);
-            QueueEvent({path, FileAction::Removed, std::chrono::system_clock::now()});
+            CoalesceChange(path, FileAction::Removed);
         }
     }
 
@@ -212,20 +252,84 @@ bool FileWatcher::PassesFilter(const fs::path& path) const {
     return false;
 }
 
-void FileWatcher::QueueEvent(const FileEvent& event) {
-    // Debouncing - check if we've seen this file recently
+void FileWatcher::RecordChange(const fs::path& path, FileAction action) {
+    if (!PassesFilter(path)) return;
+
+    // Some backends report directory changes too. Only skip what is a
+    // directory now: a file may already be gone again by the time its
+    // creation is recorded, and must still pair up with its removal.
+    std::error_code ec;
+    if (action != FileAction::Removed && fs::is_directory(path, ec)) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_DirMutex);
+
+        bool watched = std::any_of(m_WatchedDirs.begin(), m_WatchedDirs.end(),
+            [&path](const WatchedDirectory& dir) {
+                if (!dir.Native) return false;
+                if (path == dir.Path) return true;
+                if (!dir.Recursive) return path.parent_path() == dir.Path;
+
+                auto rel = path.lexically_relative(dir.Path);
+                return !rel.empty() && *rel.begin() != "..";
+            });
+        if (!watched) return;
+    }
+
+    CoalesceChange(path, action);
+}
+
+void FileWatcher::CoalesceChange(const fs::path& path, FileAction action) {
     auto now = std::chrono::steady_clock::now();
-    String pathStr = event.Path.string();
 
-    auto it = m_LastEventTime.find(pathStr);
-    if (it != m_LastEventTime.end()) {
-        auto elapsed = std::chrono::duration<f32>(now - it->second).count();
-        if (elapsed < m_DebounceTime) {
-            return;  // Skip this event (too soon after last one)
+    auto it = m_Changes.find(path);
+    if (it == m_Changes.end()) {
+        m_Changes.emplace(path, PendingChange{action, now});
+        return;
+    }
+
+    // Fold the new change into the net change since the last delivery
+    FileAction& pending = it->second.Action;
+    switch (action) {
+        case FileAction::Added:
+            // Removed then re-created is a replace-on-save
+            if (pending == FileAction::Removed) pending = FileAction::Modified;
+            break;
+        case FileAction::Modified:
+            if (pending == FileAction::Removed) pending = FileAction::Modified;
+            break;
+        case FileAction::Removed:
+            if (pending == FileAction::Added) {
+                // Never seen by the callbacks, nothing to report
+                m_Changes.erase(it);
+                return;
+            }
+            pending = FileAction::Removed;
+            break;
+    }
+    it->second.LastSeen = now;
+}
+
+std::chrono::steady_clock::time_point FileWatcher::FlushChanges(
+    std::chrono::steady_clock::time_point now, bool all) {
+    auto debounce = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<f32>(m_DebounceTime));
+    auto next = std::chrono::steady_clock::time_point::max();
+
+    for (auto it = m_Changes.begin(); it != m_Changes.end(); ) {
+        auto settlesAt = it->second.LastSeen + debounce;
+        if (all || settlesAt <= now) {
+            QueueEvent({it->first, it->second.Action, std::chrono::system_clock::now()});
+            it = m_Changes.erase(it);
+        } else {
+            next = std::min(next, settlesAt);
+            ++it;
         }
     }
-    m_LastEventTime[pathStr] = now;
+    return next;
+}
 
+void FileWatcher::QueueEvent(const FileEvent& event) {
     std::lock_guard<std::mutex> lock(m_EventMutex);
     m_PendingEvents.push_back(event);
 }
@@ -29,7 +29,18 @@ struct FileEvent {
 // Callback type for file change notifications
 using FileCallback = std::function<void(const FileEvent&)>;
 
-// Cross-platform file watcher using std::filesystem
+// OS change notifications (inotify, ReadDirectoryChangesW, FSEvents)
+class FileWatcherBackend;
+
+// Cross-platform file watcher.
+//
+// Watched paths are followed through the OS's change notifications where
+// there are some, so a change costs nothing until it happens. Paths the
+// native backend can't take (no backend on the platform, the inotify watch
+// limit, ForcePolling) fall back to rescanning their tree every poll
+// interval. Either way raw changes are coalesced per file and delivered
+// once the file has been quiet for the debounce time: an editor's
+// truncate + write save, or delete + re-create, arrives as one event.
 class FileWatcher {
 public:
     FileWatcher();
@@ -58,23 +69,37 @@ public:
     u32 Poll();
 
     // Configuration
-    void SetPollInterval(f32 seconds) { m_PollInterval = seconds; }
-    void SetDebounceTime(f32 seconds) { m_DebounceTime = seconds; }
+    void SetPollInterval(f32 seconds) { m_PollInterval = seconds; }   // Polling fallback rescans
+    void SetDebounceTime(f32 seconds) { m_DebounceTime = seconds; }   // Quiet time before delivery
+
+    // Rescan every path instead of using OS notifications. Call before the
+    // first Watch().
+    void ForcePolling(bool enabled) { m_ForcePolling = enabled; }
 
     // Status
     bool IsRunning() const { return m_Running.load(); }
     usize GetWatchedDirectoryCount() const { return m_WatchedDirs.size(); }
+    usize GetPolledDirectoryCount() const;
+    bool HasNativeBackend() const { return m_Backend != nullptr; }
+
+    // Called by the backends from the watcher thread
+    void RecordChange(const fs::path& path, FileAction action);
 
 private:
     void WatcherThread();
     bool PassesFilter(const fs::path& path) const;
     void QueueEvent(const FileEvent& event);
     void CheckDirectory(const fs::path& dir, bool recursive);
+    void CoalesceChange(const fs::path& path, FileAction action);
+    // Queues the changes that have settled; returns when the next one will
+    std::chrono::steady_clock::time_point FlushChanges(std::chrono::steady_clock::time_point now,
+                                                       bool all = false);
 
 private:
     struct WatchedDirectory {
         fs::path Path;
         bool Recursive;
+        bool Native = false;    // Followed by m_Backend, not rescanned
         HashMap<fs::path, fs::file_time_type> FileTimestamps;
     };
 
@@ -86,16 +111,24 @@ private:
     Vector<FileEvent> m_PendingEvents;
     std::mutex m_EventMutex;
 
-    // Debouncing - prevent multiple events for same file in short time
-    HashMap<String, std::chrono::steady_clock::time_point> m_LastEventTime;
+    // Coalescing - the net change of each file since its last delivery,
+    // held until the file has been quiet for m_DebounceTime (watcher thread)
+    struct PendingChange {
+        FileAction Action;
+        std::chrono::steady_clock::time_point LastSeen;
+    };
+    HashMap<fs::path, PendingChange> m_Changes;
     f32 m_DebounceTime = 0.1f;  // 100ms default
 
+    Scope<FileWatcherBackend> m_Backend;
+    bool m_ForcePolling = false;
+
     // Thread control
     std::thread m_WatcherThread;
     std::atomic<bool> m_Running{false};
     f32 m_PollInterval = 0.5f;  // 500ms default
 
-    std::mutex m_DirMutex;
+    mutable std::mutex m_DirMutex;
 };
 
 } // namespace Engine
@@ -0,0 +1,616 @@
+#include "FileWatcherBackend.hpp"
+#include "core/Logger.hpp"
+#include <algorithm>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#elif defined(__linux__)
+    #include <sys/inotify.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <cstring>
+#elif defined(__APPLE__)
+    #include <CoreServices/CoreServices.h>
+    #include <condition_variable>
+#endif
+
+namespace Engine {
+
+namespace {
+
+using ChangeList = Vector<std::pair<fs::path, FileAction>>;
+
+#if defined(__linux__)
+
+// One inotify watch per directory; recursive roots also get a watch on
+// every subdirectory, including ones created while watching.
+class InotifyBackend final : public FileWatcherBackend {
+public:
+    InotifyBackend(FileWatcher& owner, int fd) : m_Owner(owner), m_Fd(fd) {}
+
+    ~InotifyBackend() override {
+        close(m_Fd);
+    }
+
+    bool Add(const fs::path& path, bool recursive) override {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Roots.contains(path)) return true;
+
+        std::error_code ec;
+        bool isDirectory = fs::is_directory(path, ec);
+
+        Root root;
+        root.Recursive = recursive && isDirectory;
+
+        // A single file is followed through its directory, so replacing it
+        // (write to temp + rename) doesn't lose the watch
+        fs::path dir = isDirectory ? path : path.parent_path();
+        bool ok = AddWatch(dir, root);
+
+        if (ok && root.Recursive) {
+            for (auto it = fs::recursive_directory_iterator(dir,
+                     fs::directory_options::skip_permission_denied, ec);
+                 ok && !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+                if (it->is_directory(ec)) {
+                    ok = AddWatch(it->path(), root);
+                }
+            }
+        }
+
+        if (!ok) {
+            Release(root);
+            return false;
+        }
+
+        m_Roots.emplace(path, std::move(root));
+        return true;
+    }
+
+    void Remove(const fs::path& path) override {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = m_Roots.find(path);
+        if (it == m_Roots.end()) return;
+
+        Release(it->second);
+        m_Roots.erase(it);
+    }
+
+    void Wait(std::chrono::milliseconds timeout) override {
+        pollfd pfd{m_Fd, POLLIN, 0};
+        if (poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0) return;
+
+        ChangeList changes;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            alignas(inotify_event) char buffer[64 * 1024];
+            for (;;) {
+                ssize_t length = read(m_Fd, buffer, sizeof(buffer));
+                if (length <= 0) break;    // EAGAIN: drained
+
+                for (char* ptr = buffer; ptr < buffer + length; ) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+                    ProcessEvent(*event, changes);
+                    ptr += sizeof(inotify_event) + event->len;
+                }
+            }
+        }
+
+        for (const auto& [path, action] : changes) {
+            m_Owner.RecordChange(path, action);
+        }
+    }
+
+private:
+    struct Watch {
+        fs::path Dir;
+        u32 Refs = 0;       // Roots holding this watch
+    };
+
+    struct Root {
+        bool Recursive = false;
+        Vector<int> Wds;
+    };
+
+    static constexpr u32 WatchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE |
+                                     IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+    bool AddWatch(const fs::path& dir, Root& root) {
+        int wd = inotify_add_watch(m_Fd, dir.c_str(), WatchMask);
+        if (wd < 0) {
+            if (errno == ENOSPC) {
+                LOG_CORE_WARN("FileWatcher: inotify watch limit reached at {} "
+                              "(raise fs.inotify.max_user_watches)", dir.string());
+            } else {
+                LOG_CORE_WARN("FileWatcher: inotify_add_watch({}) failed: {}",
+                              dir.string(), std::strerror(errno));
+            }
+            return false;
+        }
+
+        // The kernel hands back the same wd for a directory watched twice
+        auto& watch = m_Watches[wd];
+        if (watch.Refs++ == 0) {
+            watch.Dir = dir;
+        }
+        root.Wds.push_back(wd);
+        return true;
+    }
+
+    void Release(const Root& root) {
+        for (int wd : root.Wds) {
+            auto it = m_Watches.find(wd);
+            if (it != m_Watches.end() && --it->second.Refs == 0) {
+                inotify_rm_watch(m_Fd, wd);
+                m_Watches.erase(it);
+            }
+        }
+    }
+
+    void ProcessEvent(const inotify_event& event, ChangeList& changes) {
+        if (event.mask & IN_Q_OVERFLOW) {
+            LOG_CORE_WARN("FileWatcher: inotify queue overflowed, changes were dropped");
+            return;
+        }
+        if (event.mask & IN_IGNORED) {
+            // Directory deleted or unmounted; the kernel dropped the watch
+            m_Watches.erase(event.wd);
+            return;
+        }
+
+        auto it = m_Watches.find(event.wd);
+        if (it == m_Watches.end() || event.len == 0) return;
+
+        fs::path path = it->second.Dir / event.name;
+
+        if (event.mask & IN_ISDIR) {
+            if (event.mask & (IN_CREATE | IN_MOVED_TO)) {
+                WatchNewDirectory(event.wd, path, changes);
+            } else if (event.mask & IN_MOVED_FROM) {
+                // Watches on a moved-away tree would keep reporting under
+                // the old path
+                UnwatchTree(path);
+            }
+            return;
+        }
+
+        if (event.mask & (IN_CREATE | IN_MOVED_TO)) {
+            changes.emplace_back(std::move(path), FileAction::Added);
+        } else if (event.mask & (IN_DELETE | IN_MOVED_FROM)) {
+            changes.emplace_back(std::move(path), FileAction::Removed);
+        } else {
+            changes.emplace_back(std::move(path), FileAction::Modified);
+        }
+    }
+
+    // A directory appeared under parentWd: watch it for every recursive
+    // root that covers the parent. Anything written into it before the
+    // watch existed is reported as added.
+    void WatchNewDirectory(int parentWd, const fs::path& dir, ChangeList& changes) {
+        bool watched = false;
+        for (auto& [rootPath, root] : m_Roots) {
+            if (!root.Recursive) continue;
+            if (std::find(root.Wds.begin(), root.Wds.end(), parentWd) == root.Wds.end()) continue;
+
+            AddWatch(dir, root);
+            std::error_code ec;
+            for (auto it = fs::recursive_directory_iterator(dir,
+                     fs::directory_options::skip_permission_denied, ec);
+                 !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+                if (it->is_directory(ec)) {
+                    AddWatch(it->path(), root);
+                }
+            }
+            watched = true;
+        }
+        if (!watched) return;
+
+        std::error_code ec;
+        for (auto it = fs::recursive_directory_iterator(dir,
+                 fs::directory_options::skip_permission_denied, ec);
+             !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+            if (it->is_regular_file(ec)) {
+                changes.emplace_back(it->path(), FileAction::Added);
+            }
+        }
+    }
+
+    void UnwatchTree(const fs::path& dir) {
+        for (auto it = m_Watches.begin(); it != m_Watches.end(); ) {
+            auto rel = it->second.Dir.lexically_relative(dir);
+            if (!rel.empty() && *rel.begin() != "..") {
+                inotify_rm_watch(m_Fd, it->first);
+                it = m_Watches.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+private:
+    FileWatcher& m_Owner;
+    int m_Fd;
+
+    std::mutex m_Mutex;
+    HashMap<int, Watch> m_Watches;
+    HashMap<fs::path, Root> m_Roots;
+};
+
+#elif defined(_WIN32)
+
+// One ReadDirectoryChangesW handle per watched path; the OS follows
+// subtrees itself.
+class Win32Backend final : public FileWatcherBackend {
+public:
+    explicit Win32Backend(FileWatcher& owner) : m_Owner(owner) {}
+
+    ~Win32Backend() override {
+        for (auto& dir : m_Dirs) {
+            CancelIoEx(dir->Handle, &dir->Overlapped);
+            m_Retired.push_back(std::move(dir));
+        }
+        CloseRetired();
+    }
+
+    bool Add(const fs::path& path, bool recursive) override {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (Find(path) != m_Dirs.end()) return true;
+
+        std::error_code ec;
+        bool isDirectory = fs::is_directory(path, ec);
+        fs::path dirPath = isDirectory ? path : path.parent_path();
+
+        HANDLE handle = CreateFileW(dirPath.c_str(), FILE_LIST_DIRECTORY,
+                                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                    nullptr, OPEN_EXISTING,
+                                    FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            LOG_CORE_WARN("FileWatcher: Failed to open {} for change notifications", dirPath.string());
+            return false;
+        }
+
+        auto dir = CreateScope<Directory>();
+        dir->Root = path;
+        dir->Path = dirPath;
+        dir->Recursive = recursive && isDirectory;
+        dir->Handle = handle;
+        dir->Overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+        // Armed by the watcher thread: pending I/O belongs to the thread
+        // that issued it
+        m_Dirs.push_back(std::move(dir));
+        return true;
+    }
+
+    void Remove(const fs::path& path) override {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = Find(path);
+        if (it == m_Dirs.end()) return;
+
+        // Closed by the watcher thread once it is no longer waiting on it
+        CancelIoEx((*it)->Handle, &(*it)->Overlapped);
+        m_Retired.push_back(std::move(*it));
+        m_Dirs.erase(it);
+    }
+
+    void Wait(std::chrono::milliseconds timeout) override {
+        Vector<HANDLE> events;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            CloseRetired();
+
+            for (auto& dir : m_Dirs) {
+                if (!dir->Armed) Arm(*dir);
+                if (dir->Armed && events.size() < MAXIMUM_WAIT_OBJECTS) {
+                    events.push_back(dir->Overlapped.hEvent);
+                }
+            }
+        }
+
+        if (events.empty()) {
+            Sleep(static_cast<DWORD>(timeout.count()));
+            return;
+        }
+        // Past MAXIMUM_WAIT_OBJECTS the rest are still checked on every wake
+        WaitForMultipleObjects(static_cast<DWORD>(events.size()), events.data(),
+                               FALSE, static_cast<DWORD>(timeout.count()));
+
+        ChangeList changes;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            for (auto& dir : m_Dirs) {
+                if (!dir->Armed) continue;
+
+                DWORD bytes = 0;
+                if (!GetOverlappedResult(dir->Handle, &dir->Overlapped, &bytes, FALSE)) {
+                    if (GetLastError() != ERROR_IO_INCOMPLETE) dir->Armed = false;
+                    continue;
+                }
+                dir->Armed = false;
+
+                if (bytes == 0) {
+                    LOG_CORE_WARN("FileWatcher: Change buffer for {} overflowed, changes were dropped",
+                                  dir->Path.string());
+                    continue;
+                }
+                Collect(*dir, changes);
+                Arm(*dir);
+            }
+        }
+
+        for (const auto& [path, action] : changes) {
+            m_Owner.RecordChange(path, action);
+        }
+    }
+
+private:
+    struct Directory {
+        fs::path Root;          // As passed to Add
+        fs::path Path;          // Directory actually opened
+        bool Recursive = false;
+        bool Armed = false;
+        HANDLE Handle = INVALID_HANDLE_VALUE;
+        OVERLAPPED Overlapped{};
+        alignas(DWORD) u8 Buffer[64 * 1024];
+    };
+
+    Vector<Scope<Directory>>::iterator Find(const fs::path& root) {
+        return std::find_if(m_Dirs.begin(), m_Dirs.end(),
+            [&root](const Scope<Directory>& dir) { return dir->Root == root; });
+    }
+
+    void Arm(Directory& dir) {
+        constexpr DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                                 FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+        ResetEvent(dir.Overlapped.hEvent);
+        dir.Armed = ReadDirectoryChangesW(dir.Handle, dir.Buffer, sizeof(dir.Buffer),
+                                          dir.Recursive ? TRUE : FALSE, filter,
+                                          nullptr, &dir.Overlapped, nullptr) != 0;
+    }
+
+    void Collect(const Directory& dir, ChangeList& changes) {
+        const u8* ptr = dir.Buffer;
+        for (;;) {
+            const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(ptr);
+            std::wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+            fs::path path = dir.Path / name;
+
+            switch (info->Action) {
+                case FILE_ACTION_ADDED:
+                case FILE_ACTION_RENAMED_NEW_NAME:
+                    changes.emplace_back(std::move(path), FileAction::Added);
+                    break;
+                case FILE_ACTION_REMOVED:
+                case FILE_ACTION_RENAMED_OLD_NAME:
+                    changes.emplace_back(std::move(path), FileAction::Removed);
+                    break;
+                default:
+                    changes.emplace_back(std::move(path), FileAction::Modified);
+                    break;
+            }
+
+            if (info->NextEntryOffset == 0) break;
+            ptr += info->NextEntryOffset;
+        }
+    }
+
+    void CloseRetired() {
+        for (auto& dir : m_Retired) {
+            if (dir->Armed) {
+                // Wait for the cancelled read to finish with the buffer
+                DWORD bytes = 0;
+                GetOverlappedResult(dir->Handle, &dir->Overlapped, &bytes, TRUE);
+            }
+            CloseHandle(dir->Overlapped.hEvent);
+            CloseHandle(dir->Handle);
+        }
+        m_Retired.clear();
+    }
+
+private:
+    FileWatcher& m_Owner;
+
+    std::mutex m_Mutex;
+    Vector<Scope<Directory>> m_Dirs;
+    Vector<Scope<Directory>> m_Retired;
+};
+
+#elif defined(__APPLE__)
+
+// One FSEvents stream per watched path, delivered on a private dispatch
+// queue and handed to the watcher thread from Wait.
+class FSEventsBackend final : public FileWatcherBackend {
+public:
+    explicit FSEventsBackend(FileWatcher& owner)
+        : m_Owner(owner)
+        , m_Queue(dispatch_queue_create("engine.filewatcher", DISPATCH_QUEUE_SERIAL)) {}
+
+    ~FSEventsBackend() override {
+        for (auto& stream : m_Streams) {
+            Destroy(*stream);
+        }
+        dispatch_release(m_Queue);
+    }
+
+    bool Add(const fs::path& path, bool recursive) override {
+        std::lock_guard<std::mutex> lock(m_StreamMutex);
+        if (Find(path) != m_Streams.end()) return true;
+
+        std::error_code ec;
+        bool isDirectory = fs::is_directory(path, ec);
+        fs::path dirPath = isDirectory ? path : path.parent_path();
+
+        auto stream = CreateScope<Stream>();
+        stream->Backend = this;
+        stream->Root = path;
+        stream->Dir = dirPath;
+        // FSEvents reports resolved paths (/private/var for /var)
+        stream->Canonical = fs::canonical(dirPath, ec);
+        if (ec) stream->Canonical = dirPath;
+
+        CFStringRef cfPath = CFStringCreateWithCString(nullptr, stream->Canonical.c_str(),
+                                                       kCFStringEncodingUTF8);
+        CFArrayRef paths = CFArrayCreate(nullptr, reinterpret_cast<const void**>(&cfPath), 1,
+                                         &kCFTypeArrayCallBacks);
+
+        FSEventStreamContext context{};
+        context.info = stream.get();
+        stream->Ref = FSEventStreamCreate(nullptr, &FSEventsBackend::Callback, &context, paths,
+                                          kFSEventStreamEventIdSinceNow, 0.02,
+                                          kFSEventStreamCreateFlagFileEvents |
+                                          kFSEventStreamCreateFlagNoDefer);
+        CFRelease(paths);
+        CFRelease(cfPath);
+
+        if (!stream->Ref) {
+            LOG_CORE_WARN("FileWatcher: Failed to create an FSEvents stream for {}", path.string());
+            return false;
+        }
+
+        FSEventStreamSetDispatchQueue(stream->Ref, m_Queue);
+        if (!FSEventStreamStart(stream->Ref)) {
+            LOG_CORE_WARN("FileWatcher: Failed to start the FSEvents stream for {}", path.string());
+            FSEventStreamInvalidate(stream->Ref);
+            FSEventStreamRelease(stream->Ref);
+            return false;
+        }
+
+        m_Streams.push_back(std::move(stream));
+        return true;
+    }
+
+    void Remove(const fs::path& path) override {
+        std::lock_guard<std::mutex> lock(m_StreamMutex);
+        auto it = Find(path);
+        if (it == m_Streams.end()) return;
+
+        Destroy(**it);
+        m_Streams.erase(it);
+    }
+
+    void Wait(std::chrono::milliseconds timeout) override {
+        ChangeList changes;
+        {
+            std::unique_lock<std::mutex> lock(m_ChangeMutex);
+            m_ChangeReady.wait_for(lock, timeout, [this] { return !m_Changes.empty(); });
+            changes = std::move(m_Changes);
+            m_Changes.clear();
+        }
+
+        for (const auto& [path, action] : changes) {
+            m_Owner.RecordChange(path, action);
+        }
+    }
+
+private:
+    struct Stream {
+        FSEventsBackend* Backend = nullptr;
+        fs::path Root;          // As passed to Add
+        fs::path Dir;           // Directory followed, as the caller spelled it
+        fs::path Canonical;     // The same directory as FSEvents spells it
+        FSEventStreamRef Ref = nullptr;
+    };
+
+    Vector<Scope<Stream>>::iterator Find(const fs::path& root) {
+        return std::find_if(m_Streams.begin(), m_Streams.end(),
+            [&root](const Scope<Stream>& stream) { return stream->Root == root; });
+    }
+
+    void Destroy(Stream& stream) {
+        // Stop + Invalidate drain the queue, so no callback outlives the stream
+        FSEventStreamStop(stream.Ref);
+        FSEventStreamInvalidate(stream.Ref);
+        FSEventStreamRelease(stream.Ref);
+    }
+
+    static void Callback(ConstFSEventStreamRef, void* info, size_t count, void* eventPaths,
+                         const FSEventStreamEventFlags flags[], const FSEventStreamEventId[]) {
+        auto* stream = static_cast<Stream*>(info);
+        auto** paths = static_cast<char**>(eventPaths);
+
+        ChangeList changes;
+        for (size_t i = 0; i < count; ++i) {
+            FSEventStreamEventFlags flag = flags[i];
+            if (flag & (kFSEventStreamEventFlagMustScanSubDirs | kFSEventStreamEventFlagUserDropped |
+                        kFSEventStreamEventFlagKernelDropped)) {
+                LOG_CORE_WARN("FileWatcher: FSEvents dropped changes under {}", stream->Root.string());
+            }
+            if (!(flag & kFSEventStreamEventFlagItemIsFile)) continue;
+
+            // Map back onto the path the caller watched
+            fs::path path(paths[i]);
+            auto rel = path.lexically_relative(stream->Canonical);
+            if (!rel.empty() && *rel.begin() != "..") {
+                path = stream->Dir / rel;
+            }
+
+            // Flags accumulate for an item within one batch, so settle on
+            // what is there now
+            std::error_code ec;
+            bool exists = fs::exists(path, ec);
+            FileAction action;
+            if (!exists) {
+                action = FileAction::Removed;
+            } else if (flag & (kFSEventStreamEventFlagItemCreated | kFSEventStreamEventFlagItemRenamed)) {
+                action = FileAction::Added;
+            } else {
+                action = FileAction::Modified;
+            }
+            changes.emplace_back(std::move(path), action);
+        }
+        if (changes.empty()) return;
+
+        FSEventsBackend* backend = stream->Backend;
+        {
+            std::lock_guard<std::mutex> lock(backend->m_ChangeMutex);
+            for (auto& change : changes) {
+                backend->m_Changes.push_back(std::move(change));
+            }
+        }
+        backend->m_ChangeReady.notify_one();
+    }
+
+private:
+    FileWatcher& m_Owner;
+    dispatch_queue_t m_Queue;
+
+    std::mutex m_StreamMutex;
+    Vector<Scope<Stream>> m_Streams;
+
+    // Filled on the dispatch queue, drained by Wait
+    std::mutex m_ChangeMutex;
+    std::condition_variable m_ChangeReady;
+    ChangeList m_Changes;
+};
+
+#endif
+
+} // namespace
+
+Scope<FileWatcherBackend> FileWatcherBackend::Create(FileWatcher& owner) {
+#if defined(__linux__)
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        LOG_CORE_WARN("FileWatcher: inotify unavailable ({}), falling back to polling",
+                      std::strerror(errno));
+        return nullptr;
+    }
+    return CreateScope<InotifyBackend>(owner, fd);
+#elif defined(_WIN32)
+    return CreateScope<Win32Backend>(owner);
+#elif defined(__APPLE__)
+    return CreateScope<FSEventsBackend>(owner);
+#else
+    (void)owner;
+    return nullptr;
+#endif
+}
+
+} // namespace Engine
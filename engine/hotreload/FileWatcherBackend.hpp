@@ -0,0 +1,30 @@
+#pragma once
+
+#include "FileWatcher.hpp"
+
+namespace Engine {
+
+// Native change notifications behind FileWatcher: inotify on Linux,
+// ReadDirectoryChangesW on Windows, FSEvents on macOS.
+//
+// Add / Remove are called from any thread (under FileWatcher's directory
+// lock); Wait is only called from the watcher thread and reports what it
+// saw through FileWatcher::RecordChange. Changes are reported raw -
+// filtering, scoping to the watched paths and coalescing are FileWatcher's.
+class FileWatcherBackend {
+public:
+    virtual ~FileWatcherBackend() = default;
+
+    // Null when the platform has no backend or it fails to initialize
+    static Scope<FileWatcherBackend> Create(FileWatcher& owner);
+
+    // Start following a directory (or the directory holding a file).
+    // False if the OS refused; the caller rescans the path instead.
+    virtual bool Add(const fs::path& path, bool recursive) = 0;
+    virtual void Remove(const fs::path& path) = 0;
+
+    // Block until changes arrive or the timeout passes, then report them
+    virtual void Wait(std::chrono::milliseconds timeout) = 0;
+};
+
+} // namespace Engine
@@ -0,0 +1,237 @@
+#include "ShaderHotReload.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include "core/Logger.hpp"
+#include <algorithm>
+
+namespace Engine {
+
+namespace {
+
+String NormalizePath(const fs::path& path) {
+    std::error_code error;
+    fs::path normalized = fs::weakly_canonical(path, error);
+    return (error ? path : normalized).generic_string();
+}
+
+} // anonymous namespace
+
+ShaderHotReload::ShaderHotReload() = default;
+
+ShaderHotReload::~ShaderHotReload() {
+    Shutdown();
+}
+
+void ShaderHotReload::Initialize(const fs::path& shaderDirectory) {
+    if (m_Initialized) return;
+
+    m_ShaderDirectory = shaderDirectory;
+    m_FileWatcher.AddFilter(".glsl");
+    m_FileWatcher.Watch(shaderDirectory);
+    m_FileWatcher.OnFileChanged([this](const FileEvent& event) { OnFileChanged(event); });
+    m_FileWatcher.Start();
+
+    m_Initialized = true;
+    LOG_CORE_INFO("ShaderHotReload: Watching {}", shaderDirectory.string());
+}
+
+void ShaderHotReload::Shutdown() {
+    if (!m_Initialized) return;
+
+    m_FileWatcher.Stop();
+    m_PendingReloads.clear();
+    m_RegisteredShaders.clear();
+    m_IncludedBy.clear();
+    m_ChangedFiles.clear();
+    m_Stats.RegisteredShaders = 0;
+    m_Stats.PendingReloads = 0;
+    m_Initialized = false;
+}
+
+void ShaderHotReload::Update() {
+    if (!m_Initialized) return;
+
+    if (m_Enabled) {
+        m_FileWatcher.Poll();
+        ProcessChangedFiles();
+    }
+    PollPendingReloads();
+
+    if (m_IncludeGraphDirty) {
+        RebuildIncludeGraph();
+    }
+}
+
+void ShaderHotReload::RegisterShader(Ref<Shader> shader, const fs::path& filepath) {
+    if (!shader) return;
+
+    RegisteredShader entry;
+    entry.ShaderRef = std::move(shader);
+    entry.FilePath = filepath;
+
+    m_RegisteredShaders[NormalizePath(filepath)] = std::move(entry);
+    m_Stats.RegisteredShaders = static_cast<u32>(m_RegisteredShaders.size());
+    m_IncludeGraphDirty = true;
+}
+
+void ShaderHotReload::UnregisterShader(const fs::path& filepath) {
+    m_RegisteredShaders.erase(NormalizePath(filepath));
+    m_Stats.RegisteredShaders = static_cast<u32>(m_RegisteredShaders.size());
+    m_IncludeGraphDirty = true;
+}
+
+void ShaderHotReload::OnShaderReloaded(ShaderReloadCallback callback) {
+    m_Callbacks.push_back(std::move(callback));
+}
+
+bool ShaderHotReload::ReloadShader(const fs::path& filepath) {
+    auto it = m_RegisteredShaders.find(NormalizePath(filepath));
+    if (it == m_RegisteredShaders.end()) {
+        LOG_CORE_WARN("ShaderHotReload: {} is not registered", filepath.string());
+        return false;
+    }
+    return TryReloadShader(it->second.FilePath, it->second.ShaderRef);
+}
+
+void ShaderHotReload::ReloadAll() {
+    // Every compile is started before any is waited on
+    for (auto& [key, entry] : m_RegisteredShaders) {
+        TryReloadShader(entry.FilePath, entry.ShaderRef);
+    }
+}
+
+void ShaderHotReload::OnFileChanged(const FileEvent& event) {
+    if (event.Action == FileAction::Removed) return;
+
+    String key = NormalizePath(event.Path);
+    if (std::find(m_ChangedFiles.begin(), m_ChangedFiles.end(), key) == m_ChangedFiles.end()) {
+        m_ChangedFiles.push_back(std::move(key));
+    }
+}
+
+void ShaderHotReload::ProcessChangedFiles() {
+    if (m_ChangedFiles.empty()) return;
+
+    // Edits to a shader may change what it includes
+    if (m_IncludeGraphDirty) {
+        RebuildIncludeGraph();
+    }
+
+    Vector<String> dependents;
+    for (const auto& file : m_ChangedFiles) {
+        CollectDependents(file, dependents);
+    }
+    m_ChangedFiles.clear();
+    if (dependents.empty()) return;
+
+    m_Stats.LastChangeDependents = static_cast<u32>(dependents.size());
+    LOG_CORE_INFO("ShaderHotReload: {} shader(s) affected", dependents.size());
+
+    for (const auto& dependent : dependents) {
+        if (auto it = m_RegisteredShaders.find(dependent); it != m_RegisteredShaders.end()) {
+            TryReloadShader(it->second.FilePath, it->second.ShaderRef);
+        }
+    }
+}
+
+void ShaderHotReload::CollectDependents(const String& file, Vector<String>& dependents) const {
+    // Walk up the includers; the graph can't loop (includes are once per
+    // stage) but a visited list keeps a malformed one from spinning
+    Vector<String> visited{file};
+    for (usize i = 0; i < visited.size(); ++i) {
+        const String& current = visited[i];
+
+        if (m_RegisteredShaders.find(current) != m_RegisteredShaders.end() &&
+            std::find(dependents.begin(), dependents.end(), current) == dependents.end()) {
+            dependents.push_back(current);
+        }
+
+        auto it = m_IncludedBy.find(current);
+        if (it == m_IncludedBy.end()) continue;
+        for (const auto& includer : it->second) {
+            if (std::find(visited.begin(), visited.end(), includer) == visited.end()) {
+                visited.push_back(includer);
+            }
+        }
+    }
+}
+
+void ShaderHotReload::RebuildIncludeGraph() {
+    m_IncludedBy.clear();
+
+    for (const auto& [key, entry] : m_RegisteredShaders) {
+        for (const auto& edge : entry.ShaderRef->GetIncludeGraph()) {
+            auto& includers = m_IncludedBy[NormalizePath(edge.Included)];
+            String includer = NormalizePath(edge.Includer);
+            if (std::find(includers.begin(), includers.end(), includer) == includers.end()) {
+                includers.push_back(std::move(includer));
+            }
+        }
+    }
+
+    m_Stats.IncludeFiles = static_cast<u32>(m_IncludedBy.size());
+    m_IncludeGraphDirty = false;
+}
+
+bool ShaderHotReload::TryReloadShader(const fs::path& filepath, Ref<Shader> shader) {
+    if (!shader) return false;
+
+    // A newer edit replaces the compile already in flight
+    auto pending = std::find_if(m_PendingReloads.begin(), m_PendingReloads.end(),
+        [&shader](const PendingReload& reload) { return reload.ShaderRef == shader; });
+
+    if (!shader->Reload()) {
+        LOG_CORE_ERROR("ShaderHotReload: Failed to read {}", filepath.string());
+        m_Stats.FailedReloads++;
+        return false;
+    }
+
+    // Reload() expanded the includes again
+    m_IncludeGraphDirty = true;
+
+    auto now = std::chrono::steady_clock::now();
+    if (pending != m_PendingReloads.end()) {
+        pending->StartTime = now;
+    } else {
+        m_PendingReloads.push_back({shader, now});
+    }
+    m_Stats.PendingReloads = static_cast<u32>(m_PendingReloads.size());
+
+    LOG_CORE_INFO("ShaderHotReload: Recompiling {}", filepath.string());
+    return true;
+}
+
+void ShaderHotReload::PollPendingReloads() {
+    for (usize i = 0; i < m_PendingReloads.size();) {
+        PendingReload& reload = m_PendingReloads[i];
+
+        ShaderCompileStatus status = reload.ShaderRef->Poll();
+        if (status == ShaderCompileStatus::Compiling) {
+            ++i;
+            continue;
+        }
+
+        bool success = status == ShaderCompileStatus::Ready;
+        auto elapsed = std::chrono::steady_clock::now() - reload.StartTime;
+        m_Stats.LastReloadTimeMs = std::chrono::duration<f32, std::milli>(elapsed).count();
+
+        if (success) {
+            m_Stats.ReloadsThisSession++;
+            LOG_CORE_INFO("ShaderHotReload: Reloaded '{}' ({:.1f} ms)",
+                          reload.ShaderRef->GetName(), m_Stats.LastReloadTimeMs);
+        } else {
+            m_Stats.FailedReloads++;
+            LOG_CORE_ERROR("ShaderHotReload: '{}' failed to compile, keeping the previous program",
+                           reload.ShaderRef->GetName());
+        }
+
+        Ref<Shader> shader = reload.ShaderRef;
+        m_PendingReloads.erase(m_PendingReloads.begin() + static_cast<std::ptrdiff_t>(i));
+
+        for (const auto& callback : m_Callbacks) {
+            callback(shader, success);
+        }
+    }
+    m_Stats.PendingReloads = static_cast<u32>(m_PendingReloads.size());
+}
+
+} // namespace Engine
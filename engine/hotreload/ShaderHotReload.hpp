@@ -2,6 +2,7 @@
 
 #include "core/Types.hpp"
 #include "FileWatcher.hpp"
+#include <chrono>
 #include <filesystem>
 #include <functional>
 
@@ -15,7 +16,17 @@ namespace fs = std::filesystem;
 // Callback for shader reload events
 using ShaderReloadCallback = std::function<void(Ref<Shader>, bool success)>;
 
-// Manages hot-reloading of shaders
+// Manages hot-reloading of shaders. Reloads compile in the background
+// (Shader::Reload) and keep the old program bound until the new one links;
+// Update() reports each one when it finishes.
+//
+// Edits are matched against the include graph the preprocessor recorded at
+// each shader's last load (Shader::GetIncludeGraph), so changing a shared
+// file such as common/pbr.glsl recompiles exactly the shaders that include
+// it, directly or through other includes. Files changed during one Update()
+// are gathered first and every affected shader is recompiled once; the
+// graph is refreshed from each reload, so added or removed #includes are
+// picked up.
 class ShaderHotReload {
 public:
     ShaderHotReload();
@@ -35,7 +46,7 @@ public:
     // Callbacks for reload events
     void OnShaderReloaded(ShaderReloadCallback callback);
 
-    // Force reload a specific shader
+    // Force reload a specific shader; returns whether a compile was started
     bool ReloadShader(const fs::path& filepath);
 
     // Force reload all registered shaders
@@ -50,7 +61,10 @@ public:
         u32 RegisteredShaders = 0;
         u32 ReloadsThisSession = 0;
         u32 FailedReloads = 0;
-        f32 LastReloadTimeMs = 0.0f;
+        f32 LastReloadTimeMs = 0.0f;    // Start of the compile to link
+        u32 PendingReloads = 0;
+        u32 IncludeFiles = 0;           // Files in the include graph
+        u32 LastChangeDependents = 0;   // Shaders recompiled for the last batch of edits
     };
 
     const Statistics& GetStats() const { return m_Stats; }
@@ -61,26 +75,44 @@ public:
 private:
     void OnFileChanged(const FileEvent& event);
 
-    // Resolve #include directives and get all dependencies
-    Vector<fs::path> GetShaderDependencies(const fs::path& shaderPath);
+    // Recompile the shaders affected by m_ChangedFiles
+    void ProcessChangedFiles();
 
-    // Try to reload a shader, returns true on success
+    // Registered shaders (normalized paths) that are or include file
+    void CollectDependents(const String& file, Vector<String>& dependents) const;
+
+    // m_IncludedBy from every registered shader's include graph
+    void RebuildIncludeGraph();
+
+    // Start a reload, returns true if it was queued
     bool TryReloadShader(const fs::path& filepath, Ref<Shader> shader);
 
+    // Report reloads whose compile has finished
+    void PollPendingReloads();
+
 private:
     FileWatcher m_FileWatcher;
 
     struct RegisteredShader {
         Ref<Shader> ShaderRef;
         fs::path FilePath;
-        Vector<fs::path> Dependencies;  // #include files
     };
 
     // Map from filepath to registered shader
     HashMap<String, RegisteredShader> m_RegisteredShaders;
 
-    // Map from dependency filepath to shaders that include it
-    HashMap<String, Vector<String>> m_DependencyMap;
+    // Map from a file to the files that #include it (normalized paths)
+    HashMap<String, Vector<String>> m_IncludedBy;
+    bool m_IncludeGraphDirty = false;
+
+    // Changed since the last Update(), normalized
+    Vector<String> m_ChangedFiles;
+
+    struct PendingReload {
+        Ref<Shader> ShaderRef;
+        std::chrono::steady_clock::time_point StartTime;
+    };
+    Vector<PendingReload> m_PendingReloads;
 
     Vector<ShaderReloadCallback> m_Callbacks;
     Statistics m_Stats;
@@ -0,0 +1,225 @@
+#include "BVH.hpp"
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 MaxDepth = 48;
+
+AABB EmptyBounds() {
+    return AABB(glm::vec3(std::numeric_limits<f32>::max()),
+                glm::vec3(std::numeric_limits<f32>::lowest()));
+}
+
+f32 SurfaceArea(const AABB& box) {
+    glm::vec3 size = box.GetSize();
+    if (size.x < 0.0f || size.y < 0.0f || size.z < 0.0f) return 0.0f;
+    return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+struct Bin {
+    AABB Bounds = EmptyBounds();
+    u32 Count = 0;
+};
+
+} // anonymous namespace
+
+void BVH::Build(const Vector<AABB>& itemBounds) {
+    Clear();
+
+    const u32 count = static_cast<u32>(itemBounds.size());
+    if (count == 0) return;
+
+    m_ItemBounds = itemBounds;
+    m_Centroids.resize(count);
+    m_Indices.resize(count);
+    for (u32 i = 0; i < count; ++i) {
+        m_Centroids[i] = itemBounds[i].GetCenter();
+        m_Indices[i] = i;
+    }
+
+    m_Nodes.reserve(count * 2);
+    Node root;
+    root.LeftOrFirst = 0;
+    root.Count = count;
+    m_Nodes.push_back(root);
+    UpdateNodeBounds(0);
+
+    // Explicit work list instead of recursion; children are appended as a
+    // pair so they stay adjacent and after their parent
+    struct Pending { u32 Node; u32 Depth; };
+    Vector<Pending> pending;
+    pending.push_back({0, 0});
+
+    while (!pending.empty()) {
+        Pending current = pending.back();
+        pending.pop_back();
+
+        const u32 leftChild = static_cast<u32>(m_Nodes.size());
+        if (current.Depth >= MaxDepth) continue;
+
+        Subdivide(current.Node);
+        if (m_Nodes[current.Node].IsLeaf()) continue;
+
+        pending.push_back({leftChild, current.Depth + 1});
+        pending.push_back({leftChild + 1, current.Depth + 1});
+    }
+}
+
+void BVH::Refit(const Vector<AABB>& itemBounds) {
+    if (itemBounds.size() != m_ItemBounds.size()) {
+        Build(itemBounds);
+        return;
+    }
+
+    m_ItemBounds = itemBounds;
+    for (usize i = m_Nodes.size(); i-- > 0;) {
+        Node& node = m_Nodes[i];
+        if (node.IsLeaf()) {
+            UpdateNodeBounds(static_cast<u32>(i));
+        } else {
+            node.Bounds = m_Nodes[node.LeftOrFirst].Bounds;
+            node.Bounds.ExpandToInclude(m_Nodes[node.LeftOrFirst + 1].Bounds);
+        }
+    }
+}
+
+void BVH::Clear() {
+    m_Nodes.clear();
+    m_Indices.clear();
+    m_ItemBounds.clear();
+    m_Centroids.clear();
+}
+
+f32 BVH::ComputeSAHCost() const {
+    if (m_Nodes.empty()) return 0.0f;
+
+    const f32 rootArea = SurfaceArea(m_Nodes[0].Bounds);
+    if (rootArea <= 0.0f) return 0.0f;
+
+    // Traversal cost 1 per inner node, intersection cost 1 per item
+    f32 cost = 0.0f;
+    for (const auto& node : m_Nodes) {
+        f32 area = SurfaceArea(node.Bounds);
+        cost += node.IsLeaf() ? area * static_cast<f32>(node.Count) : area;
+    }
+    return cost / rootArea;
+}
+
+void BVH::UpdateNodeBounds(u32 nodeIndex) {
+    Node& node = m_Nodes[nodeIndex];
+    node.Bounds = EmptyBounds();
+    for (u32 i = 0; i < node.Count; ++i) {
+        node.Bounds.ExpandToInclude(m_ItemBounds[m_Indices[node.LeftOrFirst + i]]);
+    }
+}
+
+bool BVH::FindBestSplit(const Node& node, u32& axis, f32& splitPosition, f32& splitCost) const {
+    splitCost = std::numeric_limits<f32>::max();
+
+    // Bin along the centroid bounds rather than the node bounds so large
+    // items don't squeeze every centroid into one bin
+    AABB centroidBounds = EmptyBounds();
+    for (u32 i = 0; i < node.Count; ++i) {
+        centroidBounds.ExpandToInclude(m_Centroids[m_Indices[node.LeftOrFirst + i]]);
+    }
+
+    for (u32 a = 0; a < 3; ++a) {
+        const f32 boundsMin = centroidBounds.Min[a];
+        const f32 boundsMax = centroidBounds.Max[a];
+        if (boundsMax <= boundsMin) continue;
+
+        Bin bins[BinCount];
+        const f32 scale = static_cast<f32>(BinCount) / (boundsMax - boundsMin);
+        for (u32 i = 0; i < node.Count; ++i) {
+            u32 item = m_Indices[node.LeftOrFirst + i];
+            u32 binIndex = std::min(BinCount - 1,
+                static_cast<u32>((m_Centroids[item][a] - boundsMin) * scale));
+            bins[binIndex].Count++;
+            bins[binIndex].Bounds.ExpandToInclude(m_ItemBounds[item]);
+        }
+
+        // Sweep from both sides to get the cost of every plane between bins
+        f32 leftArea[BinCount - 1], rightArea[BinCount - 1];
+        u32 leftCount[BinCount - 1], rightCount[BinCount - 1];
+        AABB leftBox = EmptyBounds(), rightBox = EmptyBounds();
+        u32 leftSum = 0, rightSum = 0;
+        for (u32 i = 0; i < BinCount - 1; ++i) {
+            leftSum += bins[i].Count;
+            leftCount[i] = leftSum;
+            leftBox.ExpandToInclude(bins[i].Bounds);
+            leftArea[i] = SurfaceArea(leftBox);
+
+            rightSum += bins[BinCount - 1 - i].Count;
+            rightCount[BinCount - 2 - i] = rightSum;
+            rightBox.ExpandToInclude(bins[BinCount - 1 - i].Bounds);
+            rightArea[BinCount - 2 - i] = SurfaceArea(rightBox);
+        }
+
+        const f32 binWidth = (boundsMax - boundsMin) / static_cast<f32>(BinCount);
+        for (u32 i = 0; i < BinCount - 1; ++i) {
+            if (leftCount[i] == 0 || rightCount[i] == 0) continue;
+
+            f32 cost = static_cast<f32>(leftCount[i]) * leftArea[i] +
+                       static_cast<f32>(rightCount[i]) * rightArea[i];
+            if (cost < splitCost) {
+                axis = a;
+                splitPosition = boundsMin + binWidth * static_cast<f32>(i + 1);
+                splitCost = cost;
+            }
+        }
+    }
+
+    return splitCost < std::numeric_limits<f32>::max();
+}
+
+void BVH::Subdivide(u32 nodeIndex) {
+    if (m_Nodes[nodeIndex].Count <= MaxLeafSize) return;
+
+    u32 axis = 0;
+    f32 splitPosition = 0.0f;
+    f32 splitCost = 0.0f;
+    if (!FindBestSplit(m_Nodes[nodeIndex], axis, splitPosition, splitCost)) {
+        return;  // All centroids coincide, keep as a (large) leaf
+    }
+
+    // Only split when cheaper than testing every item in this node
+    Node& node = m_Nodes[nodeIndex];
+    const f32 leafCost = static_cast<f32>(node.Count) * SurfaceArea(node.Bounds);
+    if (splitCost >= leafCost) return;
+
+    // Partition item indices in place around the split plane
+    u32 i = node.LeftOrFirst;
+    u32 j = i + node.Count - 1;
+    while (i <= j) {
+        if (m_Centroids[m_Indices[i]][axis] < splitPosition) {
+            ++i;
+        } else {
+            std::swap(m_Indices[i], m_Indices[j]);
+            if (j == 0) break;
+            --j;
+        }
+    }
+
+    const u32 leftCount = i - node.LeftOrFirst;
+    if (leftCount == 0 || leftCount == node.Count) return;
+
+    const u32 leftChild = static_cast<u32>(m_Nodes.size());
+    Node left;
+    left.LeftOrFirst = node.LeftOrFirst;
+    left.Count = leftCount;
+    Node right;
+    right.LeftOrFirst = i;
+    right.Count = node.Count - leftCount;
+
+    // push_back may reallocate; don't touch 'node' after this point
+    node.LeftOrFirst = leftChild;
+    node.Count = 0;
+    m_Nodes.push_back(left);
+    m_Nodes.push_back(right);
+
+    UpdateNodeBounds(leftChild);
+    UpdateNodeBounds(leftChild + 1);
+}
+
+} // namespace Engine
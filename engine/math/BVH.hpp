@@ -0,0 +1,280 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "math/AABB.hpp"
+#include "math/Frustum.hpp"
+#include "math/Ray.hpp"
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace Engine {
+
+// Bounding volume hierarchy over a set of AABBs.
+//
+// Built top-down with binned SAH splits. Nodes are stored depth-first with
+// both children of a node adjacent and always after their parent, so Refit()
+// can update bounds in a single reverse sweep without touching the topology.
+// Items are identified by their index in the array passed to Build().
+class BVH {
+public:
+    static constexpr u32 InvalidItem = std::numeric_limits<u32>::max();
+    static constexpr u32 MaxLeafSize = 4;
+    static constexpr u32 BinCount = 12;
+
+    struct Node {
+        AABB Bounds;
+        u32 LeftOrFirst = 0;  // Left child index (inner) or first item (leaf)
+        u32 Count = 0;        // Item count, 0 for inner nodes
+
+        bool IsLeaf() const { return Count > 0; }
+    };
+
+    struct RayHit {
+        u32 Item = InvalidItem;
+        f32 Distance = std::numeric_limits<f32>::max();
+
+        explicit operator bool() const { return Item != InvalidItem; }
+    };
+
+    // Rebuild the hierarchy from scratch
+    void Build(const Vector<AABB>& itemBounds);
+
+    // Update item bounds and refit node bounds, keeping the topology.
+    // itemBounds must have the same size as the last Build().
+    void Refit(const Vector<AABB>& itemBounds);
+
+    void Clear();
+
+    bool IsEmpty() const { return m_Nodes.empty(); }
+    u32 GetItemCount() const { return static_cast<u32>(m_ItemBounds.size()); }
+    u32 GetNodeCount() const { return static_cast<u32>(m_Nodes.size()); }
+    const AABB& GetItemBounds(u32 item) const { return m_ItemBounds[item]; }
+
+    // Surface area heuristic cost of the current tree. After refits this
+    // grows as the tree degrades, which tells callers when to rebuild.
+    f32 ComputeSAHCost() const;
+
+    // func(u32 item, bool fullyInside) for every item whose node is not
+    // outside the frustum. fullyInside items need no further testing.
+    template<typename Func>
+    void QueryFrustum(const Frustum& frustum, Func&& func) const;
+
+    // func(u32 item) for every item whose bounds intersect box
+    template<typename Func>
+    void QueryAABB(const AABB& box, Func&& func) const;
+
+    // Closest item whose bounds the ray hits. filter(u32 item) -> bool can
+    // reject items (hidden, not pickable, ...).
+    template<typename Filter>
+    RayHit Raycast(const Ray& ray, Filter&& filter, f32 maxDistance = std::numeric_limits<f32>::max()) const;
+
+    // Raycast for the rays of a packet at once: every node is tested
+    // against all of them in one SIMD test and visited while any can still
+    // hit, so coherent rays share one traversal. hits[lane] is the closest
+    // hit of each lane, strictly nearer than its MaxDistance, which is
+    // lowered to it. inflate grows every box on all sides, for sphere sweeps.
+    template<typename Filter>
+    void RaycastPacket(RayPacket& packet, Filter&& filter, RayHit* hits, f32 inflate = 0.0f) const;
+
+private:
+    void UpdateNodeBounds(u32 nodeIndex);
+    void Subdivide(u32 nodeIndex);
+    bool FindBestSplit(const Node& node, u32& axis, f32& splitPosition, f32& splitCost) const;
+
+    template<typename Func>
+    void VisitSubtree(u32 nodeIndex, Func&& func) const;
+
+private:
+    Vector<Node> m_Nodes;
+    Vector<u32> m_Indices;        // Leaf item ranges index into this
+    Vector<AABB> m_ItemBounds;
+    Vector<glm::vec3> m_Centroids;
+};
+
+template<typename Func>
+void BVH::VisitSubtree(u32 nodeIndex, Func&& func) const {
+    u32 stack[64];
+    u32 stackSize = 0;
+    stack[stackSize++] = nodeIndex;
+
+    while (stackSize > 0) {
+        const Node& node = m_Nodes[stack[--stackSize]];
+        if (node.IsLeaf()) {
+            for (u32 i = 0; i < node.Count; ++i) {
+                func(m_Indices[node.LeftOrFirst + i]);
+            }
+        } else {
+            stack[stackSize++] = node.LeftOrFirst;
+            stack[stackSize++] = node.LeftOrFirst + 1;
+        }
+    }
+}
+
+template<typename Func>
+void BVH::QueryFrustum(const Frustum& frustum, Func&& func) const {
+    if (m_Nodes.empty()) return;
+
+    u32 stack[64];
+    u32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const u32 nodeIndex = stack[--stackSize];
+        const Node& node = m_Nodes[nodeIndex];
+
+        auto containment = frustum.ClassifyBox(node.Bounds);
+        if (containment == Frustum::Containment::Outside) continue;
+
+        if (containment == Frustum::Containment::Inside) {
+            VisitSubtree(nodeIndex, [&](u32 item) { func(item, true); });
+        } else if (node.IsLeaf()) {
+            for (u32 i = 0; i < node.Count; ++i) {
+                func(m_Indices[node.LeftOrFirst + i], false);
+            }
+        } else {
+            stack[stackSize++] = node.LeftOrFirst;
+            stack[stackSize++] = node.LeftOrFirst + 1;
+        }
+    }
+}
+
+template<typename Func>
+void BVH::QueryAABB(const AABB& box, Func&& func) const {
+    if (m_Nodes.empty()) return;
+
+    u32 stack[64];
+    u32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = m_Nodes[stack[--stackSize]];
+        if (!node.Bounds.Intersects(box)) continue;
+
+        if (node.IsLeaf()) {
+            for (u32 i = 0; i < node.Count; ++i) {
+                u32 item = m_Indices[node.LeftOrFirst + i];
+                if (m_ItemBounds[item].Intersects(box)) {
+                    func(item);
+                }
+            }
+        } else {
+            stack[stackSize++] = node.LeftOrFirst;
+            stack[stackSize++] = node.LeftOrFirst + 1;
+        }
+    }
+}
+
+template<typename Filter>
+BVH::RayHit BVH::Raycast(const Ray& ray, Filter&& filter, f32 maxDistance) const {
+    RayHit hit;
+    hit.Distance = maxDistance;
+    if (m_Nodes.empty()) return hit;
+
+    u32 stack[64];
+    u32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = m_Nodes[stack[--stackSize]];
+
+        f32 nodeDistance;
+        if (!ray.IntersectsAABB(node.Bounds, nodeDistance) || nodeDistance > hit.Distance) continue;
+
+        if (node.IsLeaf()) {
+            for (u32 i = 0; i < node.Count; ++i) {
+                u32 item = m_Indices[node.LeftOrFirst + i];
+
+                f32 distance;
+                if (ray.IntersectsAABB(m_ItemBounds[item], distance) && distance < hit.Distance && filter(item)) {
+                    hit.Item = item;
+                    hit.Distance = distance;
+                }
+            }
+            continue;
+        }
+
+        // Visit the nearer child first so the far one is usually rejected
+        u32 nearChild = node.LeftOrFirst;
+        u32 farChild = node.LeftOrFirst + 1;
+        f32 nearDistance, farDistance;
+        bool nearHit = ray.IntersectsAABB(m_Nodes[nearChild].Bounds, nearDistance);
+        bool farHit = ray.IntersectsAABB(m_Nodes[farChild].Bounds, farDistance);
+
+        if (nearHit && farHit && farDistance < nearDistance) {
+            std::swap(nearChild, farChild);
+        }
+        if (farHit || nearHit) {
+            // Push far first so near is popped next
+            stack[stackSize++] = farChild;
+            stack[stackSize++] = nearChild;
+        }
+    }
+
+    return hit;
+}
+
+template<typename Filter>
+void BVH::RaycastPacket(RayPacket& packet, Filter&& filter, RayHit* hits, f32 inflate) const {
+    for (u32 lane = 0; lane < RayPacket::Width; ++lane) {
+        hits[lane] = RayHit{};
+        hits[lane].Distance = packet.MaxDistance[lane];
+    }
+    if (m_Nodes.empty()) return;
+
+    u32 stack[64];
+    u32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    f32 distances[RayPacket::Width];
+    while (stackSize > 0) {
+        const Node& node = m_Nodes[stack[--stackSize]];
+        if (!packet.Intersect(node.Bounds, packet.LaneMask, inflate, distances)) continue;
+
+        if (node.IsLeaf()) {
+            for (u32 i = 0; i < node.Count; ++i) {
+                const u32 item = m_Indices[node.LeftOrFirst + i];
+                u32 lanes = packet.Intersect(m_ItemBounds[item], packet.LaneMask, inflate, distances);
+
+                // The filter runs once per item, only when some lane would take it
+                i32 accepted = -1;
+                for (; lanes != 0; lanes &= lanes - 1) {
+                    const u32 lane = static_cast<u32>(std::countr_zero(lanes));
+                    if (distances[lane] >= hits[lane].Distance) continue;
+                    if (accepted < 0) accepted = filter(item) ? 1 : 0;
+                    if (!accepted) break;
+
+                    hits[lane].Item = item;
+                    hits[lane].Distance = distances[lane];
+                    packet.MaxDistance[lane] = distances[lane];
+                }
+            }
+            continue;
+        }
+
+        // Nearer child first, by the closest lane that hits each
+        u32 nearChild = node.LeftOrFirst;
+        u32 farChild = node.LeftOrFirst + 1;
+        auto closest = [&](u32 child, f32& distance) {
+            u32 lanes = packet.Intersect(m_Nodes[child].Bounds, packet.LaneMask, inflate, distances);
+            distance = std::numeric_limits<f32>::max();
+            for (u32 hitLanes = lanes; hitLanes != 0; hitLanes &= hitLanes - 1) {
+                distance = std::min(distance, distances[std::countr_zero(hitLanes)]);
+            }
+            return lanes != 0;
+        };
+        f32 nearDistance, farDistance;
+        bool nearHit = closest(nearChild, nearDistance);
+        bool farHit = closest(farChild, farDistance);
+
+        if (nearHit && farHit && farDistance < nearDistance) {
+            std::swap(nearChild, farChild);
+            std::swap(nearHit, farHit);
+        }
+        // Far first so near is popped next
+        if (farHit) stack[stackSize++] = farChild;
+        if (nearHit) stack[stackSize++] = nearChild;
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,451 @@
+#include "math/BoundsKernels.hpp"
+
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #include <immintrin.h>
+    #define ENGINE_KERNELS_X86 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define ENGINE_KERNELS_NEON 1
+#endif
+
+#if defined(ENGINE_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define ENGINE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+    #define ENGINE_TARGET_AVX2
+#endif
+
+namespace Engine {
+
+namespace {
+
+using FrustumKernel = u32 (*)(const Frustum&, const AABBStreams&, u8*, usize);
+using RayKernel = u32 (*)(const Ray&, const AABBStreams&, u8*, f32*, usize);
+using TransformKernel = void (*)(const AABB*, const glm::mat4* const*, AABB*, usize);
+
+struct KernelSet {
+    FrustumKernel TestAABBs;
+    RayKernel IntersectRay;
+    TransformKernel TransformAABBs;
+};
+
+constexpr u32 PlaneCount = Frustum::Count;
+
+// Streams holding each plane's positive vertex: the box corner furthest
+// along the normal, chosen once per plane instead of once per box
+struct VertexStreams {
+    const f32* X;
+    const f32* Y;
+    const f32* Z;
+};
+
+VertexStreams PositiveVertex(const Plane& plane, const AABBStreams& b) {
+    return {plane.Normal.x >= 0.0f ? b.MaxX : b.MinX,
+            plane.Normal.y >= 0.0f ? b.MaxY : b.MinY,
+            plane.Normal.z >= 0.0f ? b.MaxZ : b.MinZ};
+}
+
+// Same reciprocal as Ray::IntersectsAABB, near-zero components included
+glm::vec3 InverseDirection(const Ray& ray) {
+    const glm::vec3& d = ray.Direction;
+    return glm::vec3(std::abs(d.x) > 1e-6f ? 1.0f / d.x : 1e6f,
+                     std::abs(d.y) > 1e-6f ? 1.0f / d.y : 1e6f,
+                     std::abs(d.z) > 1e-6f ? 1.0f / d.z : 1e6f);
+}
+
+AABB LoadBox(const AABBStreams& b, usize i) {
+    return AABB(glm::vec3(b.MinX[i], b.MinY[i], b.MinZ[i]), glm::vec3(b.MaxX[i], b.MaxY[i], b.MaxZ[i]));
+}
+
+u32 TestRangeScalar(const Frustum& frustum, const AABBStreams& b, u8* visible, usize begin, usize end) {
+    u32 visibleCount = 0;
+    for (usize i = begin; i < end; ++i) {
+        bool inside = frustum.IsBoxVisible(LoadBox(b, i));
+        visible[i] = inside ? 1 : 0;
+        visibleCount += inside ? 1 : 0;
+    }
+    return visibleCount;
+}
+
+u32 TestScalar(const Frustum& frustum, const AABBStreams& b, u8* visible, usize count) {
+    return TestRangeScalar(frustum, b, visible, 0, count);
+}
+
+u32 IntersectRangeScalar(const Ray& ray, const AABBStreams& b, u8* hits, f32* distances, usize begin, usize end) {
+    u32 hitCount = 0;
+    for (usize i = begin; i < end; ++i) {
+        f32 distance = 0.0f;
+        bool hit = ray.IntersectsAABB(LoadBox(b, i), distance);
+        hits[i] = hit ? 1 : 0;
+        distances[i] = distance;
+        hitCount += hit ? 1 : 0;
+    }
+    return hitCount;
+}
+
+u32 IntersectScalar(const Ray& ray, const AABBStreams& b, u8* hits, f32* distances, usize count) {
+    return IntersectRangeScalar(ray, b, hits, distances, 0, count);
+}
+
+void TransformScalar(const AABB* boxes, const glm::mat4* const* matrices, AABB* outputs, usize count) {
+    for (usize i = 0; i < count; ++i) {
+        outputs[i] = boxes[i].Transform(*matrices[i]);
+    }
+}
+
+#if defined(ENGINE_KERNELS_X86)
+
+u32 TestSSE2(const Frustum& frustum, const AABBStreams& b, u8* visible, usize count) {
+    __m128 nx[PlaneCount], ny[PlaneCount], nz[PlaneCount], nd[PlaneCount];
+    VertexStreams vertex[PlaneCount];
+    for (u32 p = 0; p < PlaneCount; ++p) {
+        const Plane& plane = frustum.GetPlane(static_cast<Frustum::PlaneIndex>(p));
+        nx[p] = _mm_set1_ps(plane.Normal.x);
+        ny[p] = _mm_set1_ps(plane.Normal.y);
+        nz[p] = _mm_set1_ps(plane.Normal.z);
+        nd[p] = _mm_set1_ps(plane.Distance);
+        vertex[p] = PositiveVertex(plane, b);
+    }
+
+    const __m128 zero = _mm_setzero_ps();
+    u32 visibleCount = 0;
+    usize i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // inside &= dot(n, positive vertex) + d >= 0 for every plane
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (u32 p = 0; p < PlaneCount; ++p) {
+            __m128 x = _mm_loadu_ps(vertex[p].X + i);
+            __m128 y = _mm_loadu_ps(vertex[p].Y + i);
+            __m128 z = _mm_loadu_ps(vertex[p].Z + i);
+            __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], x), _mm_mul_ps(ny[p], y)),
+                                     _mm_add_ps(_mm_mul_ps(nz[p], z), nd[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(dist, zero));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        for (usize k = 0; k < 4; ++k) {
+            u8 bit = static_cast<u8>((mask >> k) & 1);
+            visible[i + k] = bit;
+            visibleCount += bit;
+        }
+    }
+
+    return visibleCount + TestRangeScalar(frustum, b, visible, i, count);
+}
+
+u32 IntersectSSE2(const Ray& ray, const AABBStreams& b, u8* hits, f32* distances, usize count) {
+    const glm::vec3 invDir = InverseDirection(ray);
+    const __m128 ox = _mm_set1_ps(ray.Origin.x), oy = _mm_set1_ps(ray.Origin.y), oz = _mm_set1_ps(ray.Origin.z);
+    const __m128 ix = _mm_set1_ps(invDir.x), iy = _mm_set1_ps(invDir.y), iz = _mm_set1_ps(invDir.z);
+    const __m128 zero = _mm_setzero_ps();
+
+    u32 hitCount = 0;
+    usize i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // Slab entry / exit per axis
+        __m128 t1x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b.MinX + i), ox), ix);
+        __m128 t2x = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b.MaxX + i), ox), ix);
+        __m128 t1y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b.MinY + i), oy), iy);
+        __m128 t2y = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b.MaxY + i), oy), iy);
+        __m128 t1z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b.MinZ + i), oz), iz);
+        __m128 t2z = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b.MaxZ + i), oz), iz);
+
+        __m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(t1x, t2x), _mm_min_ps(t1y, t2y)), _mm_min_ps(t1z, t2z));
+        __m128 tFar = _mm_min_ps(_mm_min_ps(_mm_max_ps(t1x, t2x), _mm_max_ps(t1y, t2y)), _mm_max_ps(t1z, t2z));
+
+        __m128 hit = _mm_and_ps(_mm_cmple_ps(tNear, tFar), _mm_cmpge_ps(tFar, zero));
+
+        // Closest positive hit: the entry, or the exit from inside the box
+        __m128 nearAhead = _mm_cmpge_ps(tNear, zero);
+        _mm_storeu_ps(distances + i, _mm_or_ps(_mm_and_ps(nearAhead, tNear), _mm_andnot_ps(nearAhead, tFar)));
+
+        int mask = _mm_movemask_ps(hit);
+        for (usize k = 0; k < 4; ++k) {
+            u8 bit = static_cast<u8>((mask >> k) & 1);
+            hits[i + k] = bit;
+            hitCount += bit;
+        }
+    }
+
+    return hitCount + IntersectRangeScalar(ray, b, hits, distances, i, count);
+}
+
+void TransformSSE2(const AABB* boxes, const glm::mat4* const* matrices, AABB* outputs, usize count) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+    for (usize i = 0; i < count; ++i) {
+        const f32* m = &(*matrices[i])[0][0];
+        __m128 c0 = _mm_loadu_ps(m);
+        __m128 c1 = _mm_loadu_ps(m + 4);
+        __m128 c2 = _mm_loadu_ps(m + 8);
+        __m128 c3 = _mm_loadu_ps(m + 12);
+
+        const glm::vec3 center = boxes[i].GetCenter();
+        const glm::vec3 extents = boxes[i].GetExtents();
+
+        // center' = M * center, extents' = |M3x3| * extents
+        __m128 c = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(center.x)), _mm_mul_ps(c1, _mm_set1_ps(center.y))),
+                              _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(center.z)), c3));
+        __m128 e = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(c0, absMask), _mm_set1_ps(extents.x)),
+                                         _mm_mul_ps(_mm_and_ps(c1, absMask), _mm_set1_ps(extents.y))),
+                              _mm_mul_ps(_mm_and_ps(c2, absMask), _mm_set1_ps(extents.z)));
+
+        alignas(16) f32 lo[4];
+        alignas(16) f32 hi[4];
+        _mm_store_ps(lo, _mm_sub_ps(c, e));
+        _mm_store_ps(hi, _mm_add_ps(c, e));
+        outputs[i] = AABB(glm::vec3(lo[0], lo[1], lo[2]), glm::vec3(hi[0], hi[1], hi[2]));
+    }
+}
+
+ENGINE_TARGET_AVX2
+u32 TestAVX2(const Frustum& frustum, const AABBStreams& b, u8* visible, usize count) {
+    __m256 nx[PlaneCount], ny[PlaneCount], nz[PlaneCount], nd[PlaneCount];
+    VertexStreams vertex[PlaneCount];
+    for (u32 p = 0; p < PlaneCount; ++p) {
+        const Plane& plane = frustum.GetPlane(static_cast<Frustum::PlaneIndex>(p));
+        nx[p] = _mm256_set1_ps(plane.Normal.x);
+        ny[p] = _mm256_set1_ps(plane.Normal.y);
+        nz[p] = _mm256_set1_ps(plane.Normal.z);
+        nd[p] = _mm256_set1_ps(plane.Distance);
+        vertex[p] = PositiveVertex(plane, b);
+    }
+
+    const __m256 zero = _mm256_setzero_ps();
+    u32 visibleCount = 0;
+    usize i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (u32 p = 0; p < PlaneCount; ++p) {
+            __m256 x = _mm256_loadu_ps(vertex[p].X + i);
+            __m256 y = _mm256_loadu_ps(vertex[p].Y + i);
+            __m256 z = _mm256_loadu_ps(vertex[p].Z + i);
+            __m256 dist = _mm256_fmadd_ps(nx[p], x, _mm256_fmadd_ps(ny[p], y, _mm256_fmadd_ps(nz[p], z, nd[p])));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(dist, zero, _CMP_GE_OQ));
+        }
+
+        int mask = _mm256_movemask_ps(inside);
+        for (usize k = 0; k < 8; ++k) {
+            u8 bit = static_cast<u8>((mask >> k) & 1);
+            visible[i + k] = bit;
+            visibleCount += bit;
+        }
+    }
+
+    return visibleCount + TestRangeScalar(frustum, b, visible, i, count);
+}
+
+ENGINE_TARGET_AVX2
+u32 IntersectAVX2(const Ray& ray, const AABBStreams& b, u8* hits, f32* distances, usize count) {
+    const glm::vec3 invDir = InverseDirection(ray);
+    const __m256 ox = _mm256_set1_ps(ray.Origin.x), oy = _mm256_set1_ps(ray.Origin.y), oz = _mm256_set1_ps(ray.Origin.z);
+    const __m256 ix = _mm256_set1_ps(invDir.x), iy = _mm256_set1_ps(invDir.y), iz = _mm256_set1_ps(invDir.z);
+    const __m256 zero = _mm256_setzero_ps();
+
+    u32 hitCount = 0;
+    usize i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 t1x = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(b.MinX + i), ox), ix);
+        __m256 t2x = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(b.MaxX + i), ox), ix);
+        __m256 t1y = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(b.MinY + i), oy), iy);
+        __m256 t2y = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(b.MaxY + i), oy), iy);
+        __m256 t1z = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(b.MinZ + i), oz), iz);
+        __m256 t2z = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(b.MaxZ + i), oz), iz);
+
+        __m256 tNear = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(t1x, t2x), _mm256_min_ps(t1y, t2y)),
+                                     _mm256_min_ps(t1z, t2z));
+        __m256 tFar = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(t1x, t2x), _mm256_max_ps(t1y, t2y)),
+                                    _mm256_max_ps(t1z, t2z));
+
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(tNear, tFar, _CMP_LE_OQ), _mm256_cmp_ps(tFar, zero, _CMP_GE_OQ));
+        _mm256_storeu_ps(distances + i, _mm256_blendv_ps(tFar, tNear, _mm256_cmp_ps(tNear, zero, _CMP_GE_OQ)));
+
+        int mask = _mm256_movemask_ps(hit);
+        for (usize k = 0; k < 8; ++k) {
+            u8 bit = static_cast<u8>((mask >> k) & 1);
+            hits[i + k] = bit;
+            hitCount += bit;
+        }
+    }
+
+    return hitCount + IntersectRangeScalar(ray, b, hits, distances, i, count);
+}
+
+#endif // ENGINE_KERNELS_X86
+
+#if defined(ENGINE_KERNELS_NEON)
+
+u32 TestNEON(const Frustum& frustum, const AABBStreams& b, u8* visible, usize count) {
+    float32x4_t nx[PlaneCount], ny[PlaneCount], nz[PlaneCount], nd[PlaneCount];
+    VertexStreams vertex[PlaneCount];
+    for (u32 p = 0; p < PlaneCount; ++p) {
+        const Plane& plane = frustum.GetPlane(static_cast<Frustum::PlaneIndex>(p));
+        nx[p] = vdupq_n_f32(plane.Normal.x);
+        ny[p] = vdupq_n_f32(plane.Normal.y);
+        nz[p] = vdupq_n_f32(plane.Normal.z);
+        nd[p] = vdupq_n_f32(plane.Distance);
+        vertex[p] = PositiveVertex(plane, b);
+    }
+
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    u32 visibleCount = 0;
+    usize i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFu);
+        for (u32 p = 0; p < PlaneCount; ++p) {
+            float32x4_t x = vld1q_f32(vertex[p].X + i);
+            float32x4_t y = vld1q_f32(vertex[p].Y + i);
+            float32x4_t z = vld1q_f32(vertex[p].Z + i);
+            float32x4_t dist = vmlaq_f32(vmlaq_f32(vmlaq_f32(nd[p], nz[p], z), ny[p], y), nx[p], x);
+            inside = vandq_u32(inside, vcgeq_f32(dist, zero));
+        }
+
+        alignas(16) u32 lanes[4];
+        vst1q_u32(lanes, inside);
+        for (usize k = 0; k < 4; ++k) {
+            visible[i + k] = lanes[k] ? 1 : 0;
+            visibleCount += lanes[k] ? 1 : 0;
+        }
+    }
+
+    return visibleCount + TestRangeScalar(frustum, b, visible, i, count);
+}
+
+u32 IntersectNEON(const Ray& ray, const AABBStreams& b, u8* hits, f32* distances, usize count) {
+    const glm::vec3 invDir = InverseDirection(ray);
+    const float32x4_t ox = vdupq_n_f32(ray.Origin.x), oy = vdupq_n_f32(ray.Origin.y), oz = vdupq_n_f32(ray.Origin.z);
+    const float32x4_t ix = vdupq_n_f32(invDir.x), iy = vdupq_n_f32(invDir.y), iz = vdupq_n_f32(invDir.z);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+
+    u32 hitCount = 0;
+    usize i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t t1x = vmulq_f32(vsubq_f32(vld1q_f32(b.MinX + i), ox), ix);
+        float32x4_t t2x = vmulq_f32(vsubq_f32(vld1q_f32(b.MaxX + i), ox), ix);
+        float32x4_t t1y = vmulq_f32(vsubq_f32(vld1q_f32(b.MinY + i), oy), iy);
+        float32x4_t t2y = vmulq_f32(vsubq_f32(vld1q_f32(b.MaxY + i), oy), iy);
+        float32x4_t t1z = vmulq_f32(vsubq_f32(vld1q_f32(b.MinZ + i), oz), iz);
+        float32x4_t t2z = vmulq_f32(vsubq_f32(vld1q_f32(b.MaxZ + i), oz), iz);
+
+        float32x4_t tNear = vmaxq_f32(vmaxq_f32(vminq_f32(t1x, t2x), vminq_f32(t1y, t2y)), vminq_f32(t1z, t2z));
+        float32x4_t tFar = vminq_f32(vminq_f32(vmaxq_f32(t1x, t2x), vmaxq_f32(t1y, t2y)), vmaxq_f32(t1z, t2z));
+
+        uint32x4_t hit = vandq_u32(vcleq_f32(tNear, tFar), vcgeq_f32(tFar, zero));
+        vst1q_f32(distances + i, vbslq_f32(vcgeq_f32(tNear, zero), tNear, tFar));
+
+        alignas(16) u32 lanes[4];
+        vst1q_u32(lanes, hit);
+        for (usize k = 0; k < 4; ++k) {
+            hits[i + k] = lanes[k] ? 1 : 0;
+            hitCount += lanes[k] ? 1 : 0;
+        }
+    }
+
+    return hitCount + IntersectRangeScalar(ray, b, hits, distances, i, count);
+}
+
+void TransformNEON(const AABB* boxes, const glm::mat4* const* matrices, AABB* outputs, usize count) {
+    for (usize i = 0; i < count; ++i) {
+        const f32* m = &(*matrices[i])[0][0];
+        float32x4_t c0 = vld1q_f32(m);
+        float32x4_t c1 = vld1q_f32(m + 4);
+        float32x4_t c2 = vld1q_f32(m + 8);
+        float32x4_t c3 = vld1q_f32(m + 12);
+
+        const glm::vec3 center = boxes[i].GetCenter();
+        const glm::vec3 extents = boxes[i].GetExtents();
+
+        float32x4_t c = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(c3, c0, center.x), c1, center.y), c2, center.z);
+        float32x4_t e = vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(vabsq_f32(c0), extents.x), vabsq_f32(c1), extents.y),
+                                    vabsq_f32(c2), extents.z);
+
+        alignas(16) f32 lo[4];
+        alignas(16) f32 hi[4];
+        vst1q_f32(lo, vsubq_f32(c, e));
+        vst1q_f32(hi, vaddq_f32(c, e));
+        outputs[i] = AABB(glm::vec3(lo[0], lo[1], lo[2]), glm::vec3(hi[0], hi[1], hi[2]));
+    }
+}
+
+#endif // ENGINE_KERNELS_NEON
+
+constexpr KernelSet ScalarKernels{TestScalar, IntersectScalar, TransformScalar};
+#if defined(ENGINE_KERNELS_X86)
+constexpr KernelSet SSE2Kernels{TestSSE2, IntersectSSE2, TransformSSE2};
+constexpr KernelSet AVX2Kernels{TestAVX2, IntersectAVX2, TransformSSE2};
+#endif
+#if defined(ENGINE_KERNELS_NEON)
+constexpr KernelSet NEONKernels{TestNEON, IntersectNEON, TransformNEON};
+#endif
+
+const KernelSet* KernelsForLevel(SimdLevel level) {
+    switch (level) {
+#if defined(ENGINE_KERNELS_X86)
+        case SimdLevel::AVX2: return &AVX2Kernels;
+        case SimdLevel::SSE2: return &SSE2Kernels;
+#endif
+#if defined(ENGINE_KERNELS_NEON)
+        case SimdLevel::NEON: return &NEONKernels;
+#endif
+        default: return &ScalarKernels;
+    }
+}
+
+std::atomic<SimdLevel> s_Level{CPUFeatures::GetBestSimdLevel()};
+std::atomic<const KernelSet*> s_Kernels{KernelsForLevel(CPUFeatures::GetBestSimdLevel())};
+
+} // anonymous namespace
+
+namespace BoundsKernels {
+
+u32 TestAABBs(const Frustum& frustum, const AABBStreams& boxes, u8* visible, usize count) {
+    return s_Kernels.load(std::memory_order_relaxed)->TestAABBs(frustum, boxes, visible, count);
+}
+
+u32 TestAABBsScalar(const Frustum& frustum, const AABBStreams& boxes, u8* visible, usize count) {
+    return TestScalar(frustum, boxes, visible, count);
+}
+
+u32 IntersectRay(const Ray& ray, const AABBStreams& boxes, u8* hits, f32* distances, usize count) {
+    return s_Kernels.load(std::memory_order_relaxed)->IntersectRay(ray, boxes, hits, distances, count);
+}
+
+u32 IntersectRayScalar(const Ray& ray, const AABBStreams& boxes, u8* hits, f32* distances, usize count) {
+    return IntersectScalar(ray, boxes, hits, distances, count);
+}
+
+void TransformAABBs(const AABB* boxes, const glm::mat4* const* matrices, AABB* outputs, usize count) {
+    s_Kernels.load(std::memory_order_relaxed)->TransformAABBs(boxes, matrices, outputs, count);
+}
+
+void TransformAABBsScalar(const AABB* boxes, const glm::mat4* const* matrices, AABB* outputs, usize count) {
+    TransformScalar(boxes, matrices, outputs, count);
+}
+
+u32 CompactIndices(const u8* flags, usize count, u32* indices) {
+    // Branchless: always write, only advance past set flags
+    u32 written = 0;
+    for (usize i = 0; i < count; ++i) {
+        indices[written] = static_cast<u32>(i);
+        written += flags[i] != 0 ? 1 : 0;
+    }
+    return written;
+}
+
+void SetSimdLevel(SimdLevel level) {
+    if (!CPUFeatures::IsSupported(level)) {
+        level = CPUFeatures::GetBestSimdLevel();
+    }
+    s_Level.store(level, std::memory_order_relaxed);
+    s_Kernels.store(KernelsForLevel(level), std::memory_order_relaxed);
+}
+
+SimdLevel GetSimdLevel() {
+    return s_Level.load(std::memory_order_relaxed);
+}
+
+} // namespace BoundsKernels
+
+} // namespace Engine
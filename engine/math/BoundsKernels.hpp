@@ -0,0 +1,53 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/CPUFeatures.hpp"
+#include "math/AABB.hpp"
+#include "math/Frustum.hpp"
+#include "math/Ray.hpp"
+
+namespace Engine {
+
+// SoA axis-aligned box streams for batch tests
+struct AABBStreams {
+    const f32* MinX = nullptr;
+    const f32* MinY = nullptr;
+    const f32* MinZ = nullptr;
+    const f32* MaxX = nullptr;
+    const f32* MaxY = nullptr;
+    const f32* MaxZ = nullptr;
+};
+
+// Vectorized box kernels, the AABB counterparts of CullingKernels: 4
+// (SSE2/NEON) or 8 (AVX2) boxes per step, each with the same result as the
+// scalar AABB / Frustum / Ray function it names. Per-item results are u8
+// flags like CullingKernels::TestSpheres; CompactIndices turns any of them
+// into an index list for the caller to walk.
+namespace BoundsKernels {
+
+    // visible[i] = Frustum::IsBoxVisible for box i. Returns the visible count.
+    u32 TestAABBs(const Frustum& frustum, const AABBStreams& boxes, u8* visible, usize count);
+    u32 TestAABBsScalar(const Frustum& frustum, const AABBStreams& boxes, u8* visible, usize count);
+
+    // hits[i] = Ray::IntersectsAABB for box i; distances[i] is its tMin for
+    // hits and left unspecified for misses. Returns the hit count.
+    u32 IntersectRay(const Ray& ray, const AABBStreams& boxes, u8* hits, f32* distances, usize count);
+    u32 IntersectRayScalar(const Ray& ray, const AABBStreams& boxes, u8* hits, f32* distances, usize count);
+
+    // outputs[i] = boxes[i].Transform(*matrices[i]) up to rounding, for
+    // affine matrices. The SIMD kernels go through centre / extents rather
+    // than eight corners, one box per step; the AVX2 level runs the SSE2 one.
+    void TransformAABBs(const AABB* boxes, const glm::mat4* const* matrices, AABB* outputs, usize count);
+    void TransformAABBsScalar(const AABB* boxes, const glm::mat4* const* matrices, AABB* outputs, usize count);
+
+    // Writes the index of every non-zero flag in order; indices must hold
+    // count entries. Returns how many were written.
+    u32 CompactIndices(const u8* flags, usize count, u32* indices);
+
+    // Kernel selection - defaults to CPUFeatures::GetBestSimdLevel()
+    void SetSimdLevel(SimdLevel level);
+    SimdLevel GetSimdLevel();
+
+} // namespace BoundsKernels
+
+} // namespace Engine
@@ -0,0 +1,199 @@
+#include "math/CullingKernels.hpp"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #include <immintrin.h>
+    #define ENGINE_KERNELS_X86 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define ENGINE_KERNELS_NEON 1
+#endif
+
+#if defined(ENGINE_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define ENGINE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+    #define ENGINE_TARGET_AVX2
+#endif
+
+namespace Engine {
+
+namespace {
+
+using SphereKernel = u32 (*)(const Frustum&, const SphereStreams&, u8*, usize);
+
+constexpr u32 PlaneCount = Frustum::Count;
+
+u32 TestRangeScalar(const Frustum& frustum, const SphereStreams& s, u8* visible, usize begin, usize end) {
+    u32 visibleCount = 0;
+    for (usize i = begin; i < end; ++i) {
+        bool inside = frustum.IsSphereVisible(glm::vec3(s.CenterX[i], s.CenterY[i], s.CenterZ[i]), s.Radius[i]);
+        visible[i] = inside ? 1 : 0;
+        visibleCount += inside ? 1 : 0;
+    }
+    return visibleCount;
+}
+
+u32 TestScalar(const Frustum& frustum, const SphereStreams& s, u8* visible, usize count) {
+    return TestRangeScalar(frustum, s, visible, 0, count);
+}
+
+#if defined(ENGINE_KERNELS_X86)
+
+u32 TestSSE2(const Frustum& frustum, const SphereStreams& s, u8* visible, usize count) {
+    __m128 nx[PlaneCount], ny[PlaneCount], nz[PlaneCount], nd[PlaneCount];
+    for (u32 p = 0; p < PlaneCount; ++p) {
+        const Plane& plane = frustum.GetPlane(static_cast<Frustum::PlaneIndex>(p));
+        nx[p] = _mm_set1_ps(plane.Normal.x);
+        ny[p] = _mm_set1_ps(plane.Normal.y);
+        nz[p] = _mm_set1_ps(plane.Normal.z);
+        nd[p] = _mm_set1_ps(plane.Distance);
+    }
+
+    u32 visibleCount = 0;
+    usize i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(s.CenterX + i);
+        __m128 y = _mm_loadu_ps(s.CenterY + i);
+        __m128 z = _mm_loadu_ps(s.CenterZ + i);
+        __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(s.Radius + i));
+
+        // inside &= dot(n, c) + d >= -r for every plane
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (u32 p = 0; p < PlaneCount; ++p) {
+            __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], x), _mm_mul_ps(ny[p], y)),
+                                     _mm_add_ps(_mm_mul_ps(nz[p], z), nd[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(dist, negRadius));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        for (usize k = 0; k < 4; ++k) {
+            u8 bit = static_cast<u8>((mask >> k) & 1);
+            visible[i + k] = bit;
+            visibleCount += bit;
+        }
+    }
+
+    return visibleCount + TestRangeScalar(frustum, s, visible, i, count);
+}
+
+ENGINE_TARGET_AVX2
+u32 TestAVX2(const Frustum& frustum, const SphereStreams& s, u8* visible, usize count) {
+    __m256 nx[PlaneCount], ny[PlaneCount], nz[PlaneCount], nd[PlaneCount];
+    for (u32 p = 0; p < PlaneCount; ++p) {
+        const Plane& plane = frustum.GetPlane(static_cast<Frustum::PlaneIndex>(p));
+        nx[p] = _mm256_set1_ps(plane.Normal.x);
+        ny[p] = _mm256_set1_ps(plane.Normal.y);
+        nz[p] = _mm256_set1_ps(plane.Normal.z);
+        nd[p] = _mm256_set1_ps(plane.Distance);
+    }
+
+    u32 visibleCount = 0;
+    usize i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(s.CenterX + i);
+        __m256 y = _mm256_loadu_ps(s.CenterY + i);
+        __m256 z = _mm256_loadu_ps(s.CenterZ + i);
+        __m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(s.Radius + i));
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (u32 p = 0; p < PlaneCount; ++p) {
+            __m256 dist = _mm256_fmadd_ps(nx[p], x, _mm256_fmadd_ps(ny[p], y, _mm256_fmadd_ps(nz[p], z, nd[p])));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(dist, negRadius, _CMP_GE_OQ));
+        }
+
+        int mask = _mm256_movemask_ps(inside);
+        for (usize k = 0; k < 8; ++k) {
+            u8 bit = static_cast<u8>((mask >> k) & 1);
+            visible[i + k] = bit;
+            visibleCount += bit;
+        }
+    }
+
+    return visibleCount + TestRangeScalar(frustum, s, visible, i, count);
+}
+
+#endif // ENGINE_KERNELS_X86
+
+#if defined(ENGINE_KERNELS_NEON)
+
+u32 TestNEON(const Frustum& frustum, const SphereStreams& s, u8* visible, usize count) {
+    float32x4_t nx[PlaneCount], ny[PlaneCount], nz[PlaneCount], nd[PlaneCount];
+    for (u32 p = 0; p < PlaneCount; ++p) {
+        const Plane& plane = frustum.GetPlane(static_cast<Frustum::PlaneIndex>(p));
+        nx[p] = vdupq_n_f32(plane.Normal.x);
+        ny[p] = vdupq_n_f32(plane.Normal.y);
+        nz[p] = vdupq_n_f32(plane.Normal.z);
+        nd[p] = vdupq_n_f32(plane.Distance);
+    }
+
+    u32 visibleCount = 0;
+    usize i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t x = vld1q_f32(s.CenterX + i);
+        float32x4_t y = vld1q_f32(s.CenterY + i);
+        float32x4_t z = vld1q_f32(s.CenterZ + i);
+        float32x4_t negRadius = vnegq_f32(vld1q_f32(s.Radius + i));
+
+        uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFu);
+        for (u32 p = 0; p < PlaneCount; ++p) {
+            float32x4_t dist = vmlaq_f32(vmlaq_f32(vmlaq_f32(nd[p], nz[p], z), ny[p], y), nx[p], x);
+            inside = vandq_u32(inside, vcgeq_f32(dist, negRadius));
+        }
+
+        alignas(16) u32 lanes[4];
+        vst1q_u32(lanes, inside);
+        for (usize k = 0; k < 4; ++k) {
+            visible[i + k] = lanes[k] ? 1 : 0;
+            visibleCount += lanes[k] ? 1 : 0;
+        }
+    }
+
+    return visibleCount + TestRangeScalar(frustum, s, visible, i, count);
+}
+
+#endif // ENGINE_KERNELS_NEON
+
+SphereKernel KernelForLevel(SimdLevel level) {
+    switch (level) {
+#if defined(ENGINE_KERNELS_X86)
+        case SimdLevel::AVX2: return TestAVX2;
+        case SimdLevel::SSE2: return TestSSE2;
+#endif
+#if defined(ENGINE_KERNELS_NEON)
+        case SimdLevel::NEON: return TestNEON;
+#endif
+        default: return TestScalar;
+    }
+}
+
+std::atomic<SimdLevel> s_Level{CPUFeatures::GetBestSimdLevel()};
+std::atomic<SphereKernel> s_Kernel{KernelForLevel(CPUFeatures::GetBestSimdLevel())};
+
+} // anonymous namespace
+
+namespace CullingKernels {
+
+u32 TestSpheres(const Frustum& frustum, const SphereStreams& spheres, u8* visible, usize count) {
+    return s_Kernel.load(std::memory_order_relaxed)(frustum, spheres, visible, count);
+}
+
+u32 TestSpheresScalar(const Frustum& frustum, const SphereStreams& spheres, u8* visible, usize count) {
+    return TestScalar(frustum, spheres, visible, count);
+}
+
+void SetSimdLevel(SimdLevel level) {
+    if (!CPUFeatures::IsSupported(level)) {
+        level = CPUFeatures::GetBestSimdLevel();
+    }
+    s_Level.store(level, std::memory_order_relaxed);
+    s_Kernel.store(KernelForLevel(level), std::memory_order_relaxed);
+}
+
+SimdLevel GetSimdLevel() {
+    return s_Level.load(std::memory_order_relaxed);
+}
+
+} // namespace CullingKernels
+
+} // namespace Engine
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/CPUFeatures.hpp"
+#include "math/Frustum.hpp"
+
+namespace Engine {
+
+// SoA bounding sphere streams for batch visibility tests
+struct SphereStreams {
+    const f32* CenterX = nullptr;
+    const f32* CenterY = nullptr;
+    const f32* CenterZ = nullptr;
+    const f32* Radius = nullptr;
+};
+
+// Vectorized sphere-vs-frustum tests, 4 (SSE2/NEON) or 8 (AVX2) spheres per
+// plane test. Same result as Frustum::IsSphereVisible for every sphere.
+namespace CullingKernels {
+
+    // visible[i] = 1 if sphere i intersects the frustum, 0 otherwise.
+    // Returns the number of visible spheres.
+    u32 TestSpheres(const Frustum& frustum, const SphereStreams& spheres, u8* visible, usize count);
+
+    // Reference implementation through Frustum::IsSphereVisible
+    u32 TestSpheresScalar(const Frustum& frustum, const SphereStreams& spheres, u8* visible, usize count);
+
+    // Kernel selection - defaults to CPUFeatures::GetBestSimdLevel()
+    void SetSimdLevel(SimdLevel level);
+    SimdLevel GetSimdLevel();
+
+} // namespace CullingKernels
+
+} // namespace Engine
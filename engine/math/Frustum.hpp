@@ -136,6 +136,33 @@ public:
         return true;
     }
 
+    enum class Containment : u8 {
+        Outside,
+        Intersects,
+        Inside
+    };
+
+    // Classify an AABB against the frustum (used for hierarchical culling:
+    // everything below a fully inside node is visible without further tests)
+    Containment ClassifyBox(const AABB& box) const {
+        Containment result = Containment::Inside;
+        for (const auto& plane : m_Planes) {
+            glm::vec3 positiveVertex = box.Min;
+            glm::vec3 negativeVertex = box.Max;
+            if (plane.Normal.x >= 0.0f) { positiveVertex.x = box.Max.x; negativeVertex.x = box.Min.x; }
+            if (plane.Normal.y >= 0.0f) { positiveVertex.y = box.Max.y; negativeVertex.y = box.Min.y; }
+            if (plane.Normal.z >= 0.0f) { positiveVertex.z = box.Max.z; negativeVertex.z = box.Min.z; }
+
+            if (plane.DistanceToPoint(positiveVertex) < 0.0f) {
+                return Containment::Outside;
+            }
+            if (plane.DistanceToPoint(negativeVertex) < 0.0f) {
+                result = Containment::Intersects;
+            }
+        }
+        return result;
+    }
+
     // Test if a transformed AABB is visible
     bool IsBoxVisible(const AABB& localBox, const glm::mat4& transform) const {
         AABB worldBox = localBox.Transform(transform);
@@ -143,6 +170,11 @@ public:
     }
 
     const Plane& GetPlane(PlaneIndex index) const { return m_Planes[index]; }
+    void SetPlane(PlaneIndex index, const Plane& plane) { m_Planes[index] = plane; }
+
+    // Replace a plane with one nothing is ever behind (e.g. to extrude a
+    // shadow volume towards the light)
+    void DisablePlane(PlaneIndex index) { m_Planes[index] = Plane(glm::vec3(0.0f), 1.0f); }
 
 private:
     std::array<Plane, PlaneIndex::Count> m_Planes;
@@ -0,0 +1,348 @@
+#include "math/MeshKernels.hpp"
+
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #include <immintrin.h>
+    #define ENGINE_KERNELS_X86 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define ENGINE_KERNELS_NEON 1
+#endif
+
+// AVX2 without FMA: the compiler could otherwise contract a multiply and
+// subtract into one rounding and drift from the scalar result
+#if defined(ENGINE_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define ENGINE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define ENGINE_TARGET_AVX2
+#endif
+
+namespace Engine {
+
+namespace {
+
+using NormalKernel = void (*)(const TriangleStreams&, const TriangleVectors&, usize);
+using TangentKernel = void (*)(const TriangleStreams&, const TriangleVectors&, const TriangleVectors&, usize);
+
+struct KernelSet {
+    NormalKernel TriangleNormals;
+    TangentKernel TriangleTangents;
+};
+
+// Below this |det| a triangle's UV mapping is degenerate
+constexpr f32 MinUVDeterminant = 1e-6f;
+
+void NormalsRangeScalar(const TriangleStreams& s, const TriangleVectors& n, usize begin, usize end) {
+    for (usize t = begin; t < end; ++t) {
+        const u32 i0 = s.Indices[t * 3], i1 = s.Indices[t * 3 + 1], i2 = s.Indices[t * 3 + 2];
+
+        const f32 e1x = s.PositionX[i1] - s.PositionX[i0];
+        const f32 e1y = s.PositionY[i1] - s.PositionY[i0];
+        const f32 e1z = s.PositionZ[i1] - s.PositionZ[i0];
+        const f32 e2x = s.PositionX[i2] - s.PositionX[i0];
+        const f32 e2y = s.PositionY[i2] - s.PositionY[i0];
+        const f32 e2z = s.PositionZ[i2] - s.PositionZ[i0];
+
+        n.X[t] = e1y * e2z - e2y * e1z;
+        n.Y[t] = e1z * e2x - e2z * e1x;
+        n.Z[t] = e1x * e2y - e2x * e1y;
+    }
+}
+
+void NormalsScalar(const TriangleStreams& s, const TriangleVectors& n, usize count) {
+    NormalsRangeScalar(s, n, 0, count);
+}
+
+void TangentsRangeScalar(const TriangleStreams& s, const TriangleVectors& tan, const TriangleVectors& bit,
+                         usize begin, usize end) {
+    for (usize t = begin; t < end; ++t) {
+        const u32 i0 = s.Indices[t * 3], i1 = s.Indices[t * 3 + 1], i2 = s.Indices[t * 3 + 2];
+
+        const f32 e1x = s.PositionX[i1] - s.PositionX[i0];
+        const f32 e1y = s.PositionY[i1] - s.PositionY[i0];
+        const f32 e1z = s.PositionZ[i1] - s.PositionZ[i0];
+        const f32 e2x = s.PositionX[i2] - s.PositionX[i0];
+        const f32 e2y = s.PositionY[i2] - s.PositionY[i0];
+        const f32 e2z = s.PositionZ[i2] - s.PositionZ[i0];
+        const f32 du1 = s.U[i1] - s.U[i0], dv1 = s.V[i1] - s.V[i0];
+        const f32 du2 = s.U[i2] - s.U[i0], dv2 = s.V[i2] - s.V[i0];
+
+        const f32 det = du1 * dv2 - du2 * dv1;
+        if (std::abs(det) < MinUVDeterminant) {
+            tan.X[t] = tan.Y[t] = tan.Z[t] = 0.0f;
+            bit.X[t] = bit.Y[t] = bit.Z[t] = 0.0f;
+            continue;
+        }
+        const f32 f = 1.0f / det;
+
+        tan.X[t] = f * (dv2 * e1x - dv1 * e2x);
+        tan.Y[t] = f * (dv2 * e1y - dv1 * e2y);
+        tan.Z[t] = f * (dv2 * e1z - dv1 * e2z);
+        bit.X[t] = f * (du1 * e2x - du2 * e1x);
+        bit.Y[t] = f * (du1 * e2y - du2 * e1y);
+        bit.Z[t] = f * (du1 * e2z - du2 * e1z);
+    }
+}
+
+void TangentsScalar(const TriangleStreams& s, const TriangleVectors& tan, const TriangleVectors& bit, usize count) {
+    TangentsRangeScalar(s, tan, bit, 0, count);
+}
+
+#if defined(ENGINE_KERNELS_X86)
+
+// Attribute of corner c of the 4 triangles starting at indices
+__m128 Gather4(const f32* stream, const u32* indices, u32 c) {
+    return _mm_setr_ps(stream[indices[c]], stream[indices[3 + c]], stream[indices[6 + c]], stream[indices[9 + c]]);
+}
+
+void NormalsSSE2(const TriangleStreams& s, const TriangleVectors& n, usize count) {
+    usize t = 0;
+    for (; t + 4 <= count; t += 4) {
+        const u32* indices = s.Indices + t * 3;
+        const __m128 x0 = Gather4(s.PositionX, indices, 0);
+        const __m128 y0 = Gather4(s.PositionY, indices, 0);
+        const __m128 z0 = Gather4(s.PositionZ, indices, 0);
+        const __m128 e1x = _mm_sub_ps(Gather4(s.PositionX, indices, 1), x0);
+        const __m128 e1y = _mm_sub_ps(Gather4(s.PositionY, indices, 1), y0);
+        const __m128 e1z = _mm_sub_ps(Gather4(s.PositionZ, indices, 1), z0);
+        const __m128 e2x = _mm_sub_ps(Gather4(s.PositionX, indices, 2), x0);
+        const __m128 e2y = _mm_sub_ps(Gather4(s.PositionY, indices, 2), y0);
+        const __m128 e2z = _mm_sub_ps(Gather4(s.PositionZ, indices, 2), z0);
+
+        _mm_storeu_ps(n.X + t, _mm_sub_ps(_mm_mul_ps(e1y, e2z), _mm_mul_ps(e2y, e1z)));
+        _mm_storeu_ps(n.Y + t, _mm_sub_ps(_mm_mul_ps(e1z, e2x), _mm_mul_ps(e2z, e1x)));
+        _mm_storeu_ps(n.Z + t, _mm_sub_ps(_mm_mul_ps(e1x, e2y), _mm_mul_ps(e2x, e1y)));
+    }
+    NormalsRangeScalar(s, n, t, count);
+}
+
+// f * (a * b - c * d), +0 in the lanes valid doesn't set
+__m128 MaskedTerm(__m128 f, __m128 a, __m128 b, __m128 c, __m128 d, __m128 valid) {
+    return _mm_and_ps(_mm_mul_ps(f, _mm_sub_ps(_mm_mul_ps(a, b), _mm_mul_ps(c, d))), valid);
+}
+
+void TangentsSSE2(const TriangleStreams& s, const TriangleVectors& tan, const TriangleVectors& bit, usize count) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 minDet = _mm_set1_ps(MinUVDeterminant);
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    usize t = 0;
+    for (; t + 4 <= count; t += 4) {
+        const u32* indices = s.Indices + t * 3;
+        const __m128 x0 = Gather4(s.PositionX, indices, 0);
+        const __m128 y0 = Gather4(s.PositionY, indices, 0);
+        const __m128 z0 = Gather4(s.PositionZ, indices, 0);
+        const __m128 u0 = Gather4(s.U, indices, 0);
+        const __m128 v0 = Gather4(s.V, indices, 0);
+        const __m128 e1x = _mm_sub_ps(Gather4(s.PositionX, indices, 1), x0);
+        const __m128 e1y = _mm_sub_ps(Gather4(s.PositionY, indices, 1), y0);
+        const __m128 e1z = _mm_sub_ps(Gather4(s.PositionZ, indices, 1), z0);
+        const __m128 e2x = _mm_sub_ps(Gather4(s.PositionX, indices, 2), x0);
+        const __m128 e2y = _mm_sub_ps(Gather4(s.PositionY, indices, 2), y0);
+        const __m128 e2z = _mm_sub_ps(Gather4(s.PositionZ, indices, 2), z0);
+        const __m128 du1 = _mm_sub_ps(Gather4(s.U, indices, 1), u0);
+        const __m128 dv1 = _mm_sub_ps(Gather4(s.V, indices, 1), v0);
+        const __m128 du2 = _mm_sub_ps(Gather4(s.U, indices, 2), u0);
+        const __m128 dv2 = _mm_sub_ps(Gather4(s.V, indices, 2), v0);
+
+        // Degenerate lanes come out +0, as the scalar kernel writes them
+        const __m128 det = _mm_sub_ps(_mm_mul_ps(du1, dv2), _mm_mul_ps(du2, dv1));
+        const __m128 valid = _mm_cmpge_ps(_mm_and_ps(det, absMask), minDet);
+        const __m128 f = _mm_div_ps(one, det);
+
+        _mm_storeu_ps(tan.X + t, MaskedTerm(f, dv2, e1x, dv1, e2x, valid));
+        _mm_storeu_ps(tan.Y + t, MaskedTerm(f, dv2, e1y, dv1, e2y, valid));
+        _mm_storeu_ps(tan.Z + t, MaskedTerm(f, dv2, e1z, dv1, e2z, valid));
+        _mm_storeu_ps(bit.X + t, MaskedTerm(f, du1, e2x, du2, e1x, valid));
+        _mm_storeu_ps(bit.Y + t, MaskedTerm(f, du1, e2y, du2, e1y, valid));
+        _mm_storeu_ps(bit.Z + t, MaskedTerm(f, du1, e2z, du2, e1z, valid));
+    }
+    TangentsRangeScalar(s, tan, bit, t, count);
+}
+
+// Corner c of the 8 triangles starting at indices: the indices themselves
+// are gathered with a stride of 3, then the attribute through them
+ENGINE_TARGET_AVX2
+__m256i CornerIndices8(const u32* indices, u32 c) {
+    const __m256i stride = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    return _mm256_i32gather_epi32(reinterpret_cast<const int*>(indices + c), stride, 4);
+}
+
+ENGINE_TARGET_AVX2
+__m256 Gather8(const f32* stream, __m256i corner) {
+    return _mm256_i32gather_ps(stream, corner, 4);
+}
+
+ENGINE_TARGET_AVX2
+void NormalsAVX2(const TriangleStreams& s, const TriangleVectors& n, usize count) {
+    usize t = 0;
+    for (; t + 8 <= count; t += 8) {
+        const u32* indices = s.Indices + t * 3;
+        const __m256i c0 = CornerIndices8(indices, 0);
+        const __m256i c1 = CornerIndices8(indices, 1);
+        const __m256i c2 = CornerIndices8(indices, 2);
+        const __m256 x0 = Gather8(s.PositionX, c0);
+        const __m256 y0 = Gather8(s.PositionY, c0);
+        const __m256 z0 = Gather8(s.PositionZ, c0);
+        const __m256 e1x = _mm256_sub_ps(Gather8(s.PositionX, c1), x0);
+        const __m256 e1y = _mm256_sub_ps(Gather8(s.PositionY, c1), y0);
+        const __m256 e1z = _mm256_sub_ps(Gather8(s.PositionZ, c1), z0);
+        const __m256 e2x = _mm256_sub_ps(Gather8(s.PositionX, c2), x0);
+        const __m256 e2y = _mm256_sub_ps(Gather8(s.PositionY, c2), y0);
+        const __m256 e2z = _mm256_sub_ps(Gather8(s.PositionZ, c2), z0);
+
+        _mm256_storeu_ps(n.X + t, _mm256_sub_ps(_mm256_mul_ps(e1y, e2z), _mm256_mul_ps(e2y, e1z)));
+        _mm256_storeu_ps(n.Y + t, _mm256_sub_ps(_mm256_mul_ps(e1z, e2x), _mm256_mul_ps(e2z, e1x)));
+        _mm256_storeu_ps(n.Z + t, _mm256_sub_ps(_mm256_mul_ps(e1x, e2y), _mm256_mul_ps(e2x, e1y)));
+    }
+    NormalsRangeScalar(s, n, t, count);
+}
+
+ENGINE_TARGET_AVX2
+__m256 MaskedTerm8(__m256 f, __m256 a, __m256 b, __m256 c, __m256 d, __m256 valid) {
+    return _mm256_and_ps(_mm256_mul_ps(f, _mm256_sub_ps(_mm256_mul_ps(a, b), _mm256_mul_ps(c, d))), valid);
+}
+
+ENGINE_TARGET_AVX2
+void TangentsAVX2(const TriangleStreams& s, const TriangleVectors& tan, const TriangleVectors& bit, usize count) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256 minDet = _mm256_set1_ps(MinUVDeterminant);
+    const __m256 one = _mm256_set1_ps(1.0f);
+
+    usize t = 0;
+    for (; t + 8 <= count; t += 8) {
+        const u32* indices = s.Indices + t * 3;
+        const __m256i c0 = CornerIndices8(indices, 0);
+        const __m256i c1 = CornerIndices8(indices, 1);
+        const __m256i c2 = CornerIndices8(indices, 2);
+        const __m256 x0 = Gather8(s.PositionX, c0);
+        const __m256 y0 = Gather8(s.PositionY, c0);
+        const __m256 z0 = Gather8(s.PositionZ, c0);
+        const __m256 u0 = Gather8(s.U, c0);
+        const __m256 v0 = Gather8(s.V, c0);
+        const __m256 e1x = _mm256_sub_ps(Gather8(s.PositionX, c1), x0);
+        const __m256 e1y = _mm256_sub_ps(Gather8(s.PositionY, c1), y0);
+        const __m256 e1z = _mm256_sub_ps(Gather8(s.PositionZ, c1), z0);
+        const __m256 e2x = _mm256_sub_ps(Gather8(s.PositionX, c2), x0);
+        const __m256 e2y = _mm256_sub_ps(Gather8(s.PositionY, c2), y0);
+        const __m256 e2z = _mm256_sub_ps(Gather8(s.PositionZ, c2), z0);
+        const __m256 du1 = _mm256_sub_ps(Gather8(s.U, c1), u0);
+        const __m256 dv1 = _mm256_sub_ps(Gather8(s.V, c1), v0);
+        const __m256 du2 = _mm256_sub_ps(Gather8(s.U, c2), u0);
+        const __m256 dv2 = _mm256_sub_ps(Gather8(s.V, c2), v0);
+
+        const __m256 det = _mm256_sub_ps(_mm256_mul_ps(du1, dv2), _mm256_mul_ps(du2, dv1));
+        const __m256 valid = _mm256_cmp_ps(_mm256_and_ps(det, absMask), minDet, _CMP_GE_OQ);
+        const __m256 f = _mm256_div_ps(one, det);
+
+        _mm256_storeu_ps(tan.X + t, MaskedTerm8(f, dv2, e1x, dv1, e2x, valid));
+        _mm256_storeu_ps(tan.Y + t, MaskedTerm8(f, dv2, e1y, dv1, e2y, valid));
+        _mm256_storeu_ps(tan.Z + t, MaskedTerm8(f, dv2, e1z, dv1, e2z, valid));
+        _mm256_storeu_ps(bit.X + t, MaskedTerm8(f, du1, e2x, du2, e1x, valid));
+        _mm256_storeu_ps(bit.Y + t, MaskedTerm8(f, du1, e2y, du2, e1y, valid));
+        _mm256_storeu_ps(bit.Z + t, MaskedTerm8(f, du1, e2z, du2, e1z, valid));
+    }
+    TangentsRangeScalar(s, tan, bit, t, count);
+}
+
+#endif // ENGINE_KERNELS_X86
+
+#if defined(ENGINE_KERNELS_NEON)
+
+float32x4_t Gather4(const f32* stream, const u32* indices, u32 c) {
+    alignas(16) const f32 lanes[4] = {stream[indices[c]], stream[indices[3 + c]],
+                                      stream[indices[6 + c]], stream[indices[9 + c]]};
+    return vld1q_f32(lanes);
+}
+
+void NormalsNEON(const TriangleStreams& s, const TriangleVectors& n, usize count) {
+    usize t = 0;
+    for (; t + 4 <= count; t += 4) {
+        const u32* indices = s.Indices + t * 3;
+        const float32x4_t x0 = Gather4(s.PositionX, indices, 0);
+        const float32x4_t y0 = Gather4(s.PositionY, indices, 0);
+        const float32x4_t z0 = Gather4(s.PositionZ, indices, 0);
+        const float32x4_t e1x = vsubq_f32(Gather4(s.PositionX, indices, 1), x0);
+        const float32x4_t e1y = vsubq_f32(Gather4(s.PositionY, indices, 1), y0);
+        const float32x4_t e1z = vsubq_f32(Gather4(s.PositionZ, indices, 1), z0);
+        const float32x4_t e2x = vsubq_f32(Gather4(s.PositionX, indices, 2), x0);
+        const float32x4_t e2y = vsubq_f32(Gather4(s.PositionY, indices, 2), y0);
+        const float32x4_t e2z = vsubq_f32(Gather4(s.PositionZ, indices, 2), z0);
+
+        vst1q_f32(n.X + t, vsubq_f32(vmulq_f32(e1y, e2z), vmulq_f32(e2y, e1z)));
+        vst1q_f32(n.Y + t, vsubq_f32(vmulq_f32(e1z, e2x), vmulq_f32(e2z, e1x)));
+        vst1q_f32(n.Z + t, vsubq_f32(vmulq_f32(e1x, e2y), vmulq_f32(e2x, e1y)));
+    }
+    NormalsRangeScalar(s, n, t, count);
+}
+
+// Tangents stay scalar on NEON: ARMv7 has no vector divide, and a
+// reciprocal estimate would drift from the scalar result
+constexpr TangentKernel TangentsNEON = TangentsScalar;
+
+#endif // ENGINE_KERNELS_NEON
+
+constexpr KernelSet ScalarKernels{NormalsScalar, TangentsScalar};
+#if defined(ENGINE_KERNELS_X86)
+constexpr KernelSet SSE2Kernels{NormalsSSE2, TangentsSSE2};
+constexpr KernelSet AVX2Kernels{NormalsAVX2, TangentsAVX2};
+#endif
+#if defined(ENGINE_KERNELS_NEON)
+constexpr KernelSet NEONKernels{NormalsNEON, TangentsNEON};
+#endif
+
+const KernelSet* KernelsForLevel(SimdLevel level) {
+    switch (level) {
+#if defined(ENGINE_KERNELS_X86)
+        case SimdLevel::AVX2: return &AVX2Kernels;
+        case SimdLevel::SSE2: return &SSE2Kernels;
+#endif
+#if defined(ENGINE_KERNELS_NEON)
+        case SimdLevel::NEON: return &NEONKernels;
+#endif
+        default: return &ScalarKernels;
+    }
+}
+
+std::atomic<SimdLevel> s_Level{CPUFeatures::GetBestSimdLevel()};
+std::atomic<const KernelSet*> s_Kernels{KernelsForLevel(CPUFeatures::GetBestSimdLevel())};
+
+} // anonymous namespace
+
+namespace MeshKernels {
+
+void TriangleNormals(const TriangleStreams& triangles, const TriangleVectors& normals, usize count) {
+    s_Kernels.load(std::memory_order_relaxed)->TriangleNormals(triangles, normals, count);
+}
+
+void TriangleNormalsScalar(const TriangleStreams& triangles, const TriangleVectors& normals, usize count) {
+    NormalsScalar(triangles, normals, count);
+}
+
+void TriangleTangents(const TriangleStreams& triangles, const TriangleVectors& tangents,
+                      const TriangleVectors& bitangents, usize count) {
+    s_Kernels.load(std::memory_order_relaxed)->TriangleTangents(triangles, tangents, bitangents, count);
+}
+
+void TriangleTangentsScalar(const TriangleStreams& triangles, const TriangleVectors& tangents,
+                            const TriangleVectors& bitangents, usize count) {
+    TangentsScalar(triangles, tangents, bitangents, count);
+}
+
+void SetSimdLevel(SimdLevel level) {
+    if (!CPUFeatures::IsSupported(level)) {
+        level = CPUFeatures::GetBestSimdLevel();
+    }
+    s_Level.store(level, std::memory_order_relaxed);
+    s_Kernels.store(KernelsForLevel(level), std::memory_order_relaxed);
+}
+
+SimdLevel GetSimdLevel() {
+    return s_Level.load(std::memory_order_relaxed);
+}
+
+} // namespace MeshKernels
+
+} // namespace Engine
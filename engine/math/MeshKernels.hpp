@@ -0,0 +1,50 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/CPUFeatures.hpp"
+
+namespace Engine {
+
+// SoA vertex attributes and the index list of a triangle batch. Each
+// attribute stream holds one float per vertex; Indices holds three per
+// triangle.
+struct TriangleStreams {
+    const f32* PositionX = nullptr;
+    const f32* PositionY = nullptr;
+    const f32* PositionZ = nullptr;
+    const f32* U = nullptr;     // Texture coordinates, read by TriangleTangents only
+    const f32* V = nullptr;
+    const u32* Indices = nullptr;
+};
+
+// One vector per triangle, SoA
+struct TriangleVectors {
+    f32* X = nullptr;
+    f32* Y = nullptr;
+    f32* Z = nullptr;
+};
+
+// Vectorized per-triangle terms of Mesh::RecalculateNormals / Tangents, 4
+// (SSE2/NEON) or 8 (AVX2) triangles per step. The kernels repeat the scalar
+// operations in the same order without fused multiply-adds, so on x86 every
+// level gives the scalar result bit for bit.
+namespace MeshKernels {
+
+    // normals[t] = cross(p1 - p0, p2 - p0), unnormalized (area-weighted)
+    void TriangleNormals(const TriangleStreams& triangles, const TriangleVectors& normals, usize count);
+    void TriangleNormalsScalar(const TriangleStreams& triangles, const TriangleVectors& normals, usize count);
+
+    // UV-space tangent and bitangent of each triangle, unnormalized; zero
+    // for triangles with degenerate texture coordinates
+    void TriangleTangents(const TriangleStreams& triangles, const TriangleVectors& tangents,
+                          const TriangleVectors& bitangents, usize count);
+    void TriangleTangentsScalar(const TriangleStreams& triangles, const TriangleVectors& tangents,
+                                const TriangleVectors& bitangents, usize count);
+
+    // Kernel selection - defaults to CPUFeatures::GetBestSimdLevel()
+    void SetSimdLevel(SimdLevel level);
+    SimdLevel GetSimdLevel();
+
+} // namespace MeshKernels
+
+} // namespace Engine
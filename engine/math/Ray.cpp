@@ -4,8 +4,25 @@
 #include <limits>
 #include <cmath>
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #include <immintrin.h>
+    #define ENGINE_KERNELS_X86 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define ENGINE_KERNELS_NEON 1
+#endif
+
 namespace Engine {
 
+namespace {
+
+// As IntersectsAABB, so axis-parallel rays behave the same in both
+f32 SafeInverse(f32 direction) {
+    return std::abs(direction) > 1e-6f ? 1.0f / direction : 1e6f;
+}
+
+} // anonymous namespace
+
 bool Ray::IntersectsAABB(const AABB& aabb, f32& tMin) const {
     // Slab method for ray-AABB intersection
     glm::vec3 invDir;
@@ -68,4 +85,94 @@ Ray Ray::FromScreenPoint(
     return Ray(rayWorldNear, direction);
 }
 
+RayPacket::RayPacket(const Ray* rays, u32 count, const f32* maxDistances) {
+    count = std::min(count, Width);
+    for (u32 lane = 0; lane < count; ++lane) {
+        const Ray& ray = rays[lane];
+        OriginX[lane] = ray.Origin.x;
+        OriginY[lane] = ray.Origin.y;
+        OriginZ[lane] = ray.Origin.z;
+        InvDirX[lane] = SafeInverse(ray.Direction.x);
+        InvDirY[lane] = SafeInverse(ray.Direction.y);
+        InvDirZ[lane] = SafeInverse(ray.Direction.z);
+        MaxDistance[lane] = maxDistances ? maxDistances[lane] : std::numeric_limits<f32>::max();
+    }
+    LaneMask = (1u << count) - 1;
+}
+
+u32 RayPacket::Intersect(const AABB& box, u32 laneMask, f32 inflate, f32* distances) const {
+    const glm::vec3 boxMin = box.Min - glm::vec3(inflate);
+    const glm::vec3 boxMax = box.Max + glm::vec3(inflate);
+
+#if defined(ENGINE_KERNELS_X86)
+    const __m128 ix = _mm_load_ps(InvDirX);
+    const __m128 iy = _mm_load_ps(InvDirY);
+    const __m128 iz = _mm_load_ps(InvDirZ);
+    const __m128 ox = _mm_load_ps(OriginX);
+    const __m128 oy = _mm_load_ps(OriginY);
+    const __m128 oz = _mm_load_ps(OriginZ);
+
+    const __m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMin.x), ox), ix);
+    const __m128 x2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMax.x), ox), ix);
+    const __m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMin.y), oy), iy);
+    const __m128 y2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMax.y), oy), iy);
+    const __m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMin.z), oz), iz);
+    const __m128 z2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(boxMax.z), oz), iz);
+
+    // Entry clamped to the origin, so it doubles as the hit distance
+    const __m128 tNear = _mm_max_ps(_mm_max_ps(_mm_min_ps(x1, x2), _mm_min_ps(y1, y2)),
+                                    _mm_max_ps(_mm_min_ps(z1, z2), _mm_setzero_ps()));
+    const __m128 tFar = _mm_min_ps(_mm_min_ps(_mm_max_ps(x1, x2), _mm_max_ps(y1, y2)), _mm_max_ps(z1, z2));
+
+    const __m128 hit = _mm_and_ps(_mm_cmple_ps(tNear, tFar), _mm_cmple_ps(tNear, _mm_load_ps(MaxDistance)));
+    _mm_storeu_ps(distances, tNear);
+    return static_cast<u32>(_mm_movemask_ps(hit)) & laneMask;
+#elif defined(ENGINE_KERNELS_NEON)
+    const float32x4_t ix = vld1q_f32(InvDirX);
+    const float32x4_t iy = vld1q_f32(InvDirY);
+    const float32x4_t iz = vld1q_f32(InvDirZ);
+    const float32x4_t ox = vld1q_f32(OriginX);
+    const float32x4_t oy = vld1q_f32(OriginY);
+    const float32x4_t oz = vld1q_f32(OriginZ);
+
+    const float32x4_t x1 = vmulq_f32(vsubq_f32(vdupq_n_f32(boxMin.x), ox), ix);
+    const float32x4_t x2 = vmulq_f32(vsubq_f32(vdupq_n_f32(boxMax.x), ox), ix);
+    const float32x4_t y1 = vmulq_f32(vsubq_f32(vdupq_n_f32(boxMin.y), oy), iy);
+    const float32x4_t y2 = vmulq_f32(vsubq_f32(vdupq_n_f32(boxMax.y), oy), iy);
+    const float32x4_t z1 = vmulq_f32(vsubq_f32(vdupq_n_f32(boxMin.z), oz), iz);
+    const float32x4_t z2 = vmulq_f32(vsubq_f32(vdupq_n_f32(boxMax.z), oz), iz);
+
+    const float32x4_t tNear = vmaxq_f32(vmaxq_f32(vminq_f32(x1, x2), vminq_f32(y1, y2)),
+                                        vmaxq_f32(vminq_f32(z1, z2), vdupq_n_f32(0.0f)));
+    const float32x4_t tFar = vminq_f32(vminq_f32(vmaxq_f32(x1, x2), vmaxq_f32(y1, y2)), vmaxq_f32(z1, z2));
+
+    const uint32x4_t hit = vandq_u32(vcleq_f32(tNear, tFar), vcleq_f32(tNear, vld1q_f32(MaxDistance)));
+    vst1q_f32(distances, tNear);
+
+    alignas(16) u32 lanes[Width];
+    vst1q_u32(lanes, hit);
+    u32 mask = 0;
+    for (u32 lane = 0; lane < Width; ++lane) {
+        mask |= (lanes[lane] & 1u) << lane;
+    }
+    return mask & laneMask;
+#else
+    u32 mask = 0;
+    for (u32 lane = 0; lane < Width; ++lane) {
+        const glm::vec3 origin(OriginX[lane], OriginY[lane], OriginZ[lane]);
+        const glm::vec3 invDir(InvDirX[lane], InvDirY[lane], InvDirZ[lane]);
+        const glm::vec3 t1 = (boxMin - origin) * invDir;
+        const glm::vec3 t2 = (boxMax - origin) * invDir;
+        const glm::vec3 tMin = glm::min(t1, t2);
+        const glm::vec3 tMax = glm::max(t1, t2);
+
+        const f32 tNear = std::max({tMin.x, tMin.y, tMin.z, 0.0f});
+        const f32 tFar = std::min({tMax.x, tMax.y, tMax.z});
+        distances[lane] = tNear;
+        if (tNear <= tFar && tNear <= MaxDistance[lane]) mask |= 1u << lane;
+    }
+    return mask & laneMask;
+#endif
+}
+
 } // namespace Engine
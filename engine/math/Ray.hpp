@@ -39,4 +39,27 @@ struct Ray {
     );
 };
 
+// Up to four rays in SoA form, tested against a box together (SSE2 / NEON)
+// by BVH::RaycastPacket. Unlike Ray::IntersectsAABB, a ray starting inside
+// a box hits it at distance 0, so traversal never prunes the node it is in.
+struct alignas(16) RayPacket {
+    static constexpr u32 Width = 4;
+
+    f32 OriginX[Width] = {};
+    f32 OriginY[Width] = {};
+    f32 OriginZ[Width] = {};
+    f32 InvDirX[Width] = {};
+    f32 InvDirY[Width] = {};
+    f32 InvDirZ[Width] = {};
+    f32 MaxDistance[Width] = {};    // Lowered by traversal as closer hits are found
+    u32 LaneMask = 0;               // Bit per ray present
+
+    // rays[0 .. count), count <= Width; maxDistances may be null
+    RayPacket(const Ray* rays, u32 count, const f32* maxDistances = nullptr);
+
+    // Lanes of laneMask whose ray enters box, grown by inflate on every
+    // side, within MaxDistance; distances[lane] is where
+    u32 Intersect(const AABB& box, u32 laneMask, f32 inflate, f32* distances) const;
+};
+
 } // namespace Engine
@@ -0,0 +1,284 @@
+#include "math/TransformKernels.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #include <immintrin.h>
+    #define ENGINE_KERNELS_X86 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define ENGINE_KERNELS_NEON 1
+#endif
+
+// AVX2 code lives in the same translation unit and is only reached after
+// runtime detection, so it is compiled with a per-function target attribute
+#if defined(ENGINE_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define ENGINE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+    #define ENGINE_TARGET_AVX2
+#endif
+
+namespace Engine {
+
+namespace {
+
+using ComposeKernel = void (*)(const TRSStreams&, glm::mat4* const*, usize);
+
+void ComposeRangeScalar(const TRSStreams& s, glm::mat4* const* outputs, usize begin, usize end) {
+    for (usize i = begin; i < end; ++i) {
+        glm::quat rotation(s.RotationW[i], s.RotationX[i], s.RotationY[i], s.RotationZ[i]);
+
+        glm::mat4 matrix = glm::translate(glm::mat4(1.0f),
+                                          glm::vec3(s.PositionX[i], s.PositionY[i], s.PositionZ[i]));
+        matrix *= glm::mat4_cast(rotation);
+        matrix = glm::scale(matrix, glm::vec3(s.ScaleX[i], s.ScaleY[i], s.ScaleZ[i]));
+
+        *outputs[i] = matrix;
+    }
+}
+
+void ComposeScalar(const TRSStreams& s, glm::mat4* const* outputs, usize count) {
+    ComposeRangeScalar(s, outputs, 0, count);
+}
+
+#if defined(ENGINE_KERNELS_X86)
+
+// Transpose four column vectors (one lane per transform) and store column
+// `column` of four consecutive output matrices
+inline void StoreColumn4(glm::mat4* const* outputs, usize column,
+                         __m128 x, __m128 y, __m128 z, __m128 w) {
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(&(*outputs[0])[column][0], x);
+    _mm_storeu_ps(&(*outputs[1])[column][0], y);
+    _mm_storeu_ps(&(*outputs[2])[column][0], z);
+    _mm_storeu_ps(&(*outputs[3])[column][0], w);
+}
+
+void ComposeSSE2(const TRSStreams& s, glm::mat4* const* outputs, usize count) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    usize i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 qx = _mm_loadu_ps(s.RotationX + i);
+        __m128 qy = _mm_loadu_ps(s.RotationY + i);
+        __m128 qz = _mm_loadu_ps(s.RotationZ + i);
+        __m128 qw = _mm_loadu_ps(s.RotationW + i);
+
+        __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+        __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+        __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+        __m128 sx = _mm_loadu_ps(s.ScaleX + i);
+        __m128 sy = _mm_loadu_ps(s.ScaleY + i);
+        __m128 sz = _mm_loadu_ps(s.ScaleZ + i);
+
+        // Rotation columns (glm::mat3_cast) scaled per axis
+        __m128 c0x = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+        __m128 c0y = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+        __m128 c0z = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+
+        __m128 c1x = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+        __m128 c1y = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+        __m128 c1z = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+
+        __m128 c2x = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+        __m128 c2y = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+        __m128 c2z = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+
+        __m128 px = _mm_loadu_ps(s.PositionX + i);
+        __m128 py = _mm_loadu_ps(s.PositionY + i);
+        __m128 pz = _mm_loadu_ps(s.PositionZ + i);
+
+        glm::mat4* const* out = outputs + i;
+        StoreColumn4(out, 0, c0x, c0y, c0z, zero);
+        StoreColumn4(out, 1, c1x, c1y, c1z, zero);
+        StoreColumn4(out, 2, c2x, c2y, c2z, zero);
+        StoreColumn4(out, 3, px, py, pz, one);
+    }
+
+    ComposeRangeScalar(s, outputs, i, count);
+}
+
+ENGINE_TARGET_AVX2
+void ComposeAVX2(const TRSStreams& s, glm::mat4* const* outputs, usize count) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one4 = _mm_set1_ps(1.0f);
+
+    usize i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 qx = _mm256_loadu_ps(s.RotationX + i);
+        __m256 qy = _mm256_loadu_ps(s.RotationY + i);
+        __m256 qz = _mm256_loadu_ps(s.RotationZ + i);
+        __m256 qw = _mm256_loadu_ps(s.RotationW + i);
+
+        __m256 xx = _mm256_mul_ps(qx, qx), yy = _mm256_mul_ps(qy, qy), zz = _mm256_mul_ps(qz, qz);
+        __m256 xy = _mm256_mul_ps(qx, qy), xz = _mm256_mul_ps(qx, qz), yz = _mm256_mul_ps(qy, qz);
+        __m256 wx = _mm256_mul_ps(qw, qx), wy = _mm256_mul_ps(qw, qy), wz = _mm256_mul_ps(qw, qz);
+
+        __m256 sx = _mm256_loadu_ps(s.ScaleX + i);
+        __m256 sy = _mm256_loadu_ps(s.ScaleY + i);
+        __m256 sz = _mm256_loadu_ps(s.ScaleZ + i);
+
+        __m256 c0x = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), sx);
+        __m256 c0y = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx);
+        __m256 c0z = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx);
+
+        __m256 c1x = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy);
+        __m256 c1y = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), sy);
+        __m256 c1z = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy);
+
+        __m256 c2x = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz);
+        __m256 c2y = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz);
+        __m256 c2z = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), sz);
+
+        __m256 px = _mm256_loadu_ps(s.PositionX + i);
+        __m256 py = _mm256_loadu_ps(s.PositionY + i);
+        __m256 pz = _mm256_loadu_ps(s.PositionZ + i);
+
+        // Scatter each 128-bit half through the 4-wide transpose
+        glm::mat4* const* lo = outputs + i;
+        glm::mat4* const* hi = outputs + i + 4;
+
+        StoreColumn4(lo, 0, _mm256_castps256_ps128(c0x), _mm256_castps256_ps128(c0y),
+                     _mm256_castps256_ps128(c0z), zero);
+        StoreColumn4(lo, 1, _mm256_castps256_ps128(c1x), _mm256_castps256_ps128(c1y),
+                     _mm256_castps256_ps128(c1z), zero);
+        StoreColumn4(lo, 2, _mm256_castps256_ps128(c2x), _mm256_castps256_ps128(c2y),
+                     _mm256_castps256_ps128(c2z), zero);
+        StoreColumn4(lo, 3, _mm256_castps256_ps128(px), _mm256_castps256_ps128(py),
+                     _mm256_castps256_ps128(pz), one4);
+
+        StoreColumn4(hi, 0, _mm256_extractf128_ps(c0x, 1), _mm256_extractf128_ps(c0y, 1),
+                     _mm256_extractf128_ps(c0z, 1), zero);
+        StoreColumn4(hi, 1, _mm256_extractf128_ps(c1x, 1), _mm256_extractf128_ps(c1y, 1),
+                     _mm256_extractf128_ps(c1z, 1), zero);
+        StoreColumn4(hi, 2, _mm256_extractf128_ps(c2x, 1), _mm256_extractf128_ps(c2y, 1),
+                     _mm256_extractf128_ps(c2z, 1), zero);
+        StoreColumn4(hi, 3, _mm256_extractf128_ps(px, 1), _mm256_extractf128_ps(py, 1),
+                     _mm256_extractf128_ps(pz, 1), one4);
+    }
+
+    if (i == count) return;
+
+    // Finish the remainder with the 4-wide kernel (which tails off to scalar)
+    TRSStreams tail{
+        s.PositionX + i, s.PositionY + i, s.PositionZ + i,
+        s.RotationX + i, s.RotationY + i, s.RotationZ + i, s.RotationW + i,
+        s.ScaleX + i, s.ScaleY + i, s.ScaleZ + i};
+    ComposeSSE2(tail, outputs + i, count - i);
+}
+
+#endif // ENGINE_KERNELS_X86
+
+#if defined(ENGINE_KERNELS_NEON)
+
+inline void StoreColumn4(glm::mat4* const* outputs, usize column,
+                         float32x4_t x, float32x4_t y, float32x4_t z, float32x4_t w) {
+    // vst4q interleaves the lanes, which is exactly the 4x4 transpose
+    alignas(16) f32 transposed[16];
+    float32x4x4_t columns = {{x, y, z, w}};
+    vst4q_f32(transposed, columns);
+
+    for (usize k = 0; k < 4; ++k) {
+        vst1q_f32(&(*outputs[k])[column][0], vld1q_f32(transposed + k * 4));
+    }
+}
+
+void ComposeNEON(const TRSStreams& s, glm::mat4* const* outputs, usize count) {
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t two = vdupq_n_f32(2.0f);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+
+    usize i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t qx = vld1q_f32(s.RotationX + i);
+        float32x4_t qy = vld1q_f32(s.RotationY + i);
+        float32x4_t qz = vld1q_f32(s.RotationZ + i);
+        float32x4_t qw = vld1q_f32(s.RotationW + i);
+
+        float32x4_t xx = vmulq_f32(qx, qx), yy = vmulq_f32(qy, qy), zz = vmulq_f32(qz, qz);
+        float32x4_t xy = vmulq_f32(qx, qy), xz = vmulq_f32(qx, qz), yz = vmulq_f32(qy, qz);
+        float32x4_t wx = vmulq_f32(qw, qx), wy = vmulq_f32(qw, qy), wz = vmulq_f32(qw, qz);
+
+        float32x4_t sx = vld1q_f32(s.ScaleX + i);
+        float32x4_t sy = vld1q_f32(s.ScaleY + i);
+        float32x4_t sz = vld1q_f32(s.ScaleZ + i);
+
+        float32x4_t c0x = vmulq_f32(vmlsq_f32(one, two, vaddq_f32(yy, zz)), sx);
+        float32x4_t c0y = vmulq_f32(vmulq_f32(two, vaddq_f32(xy, wz)), sx);
+        float32x4_t c0z = vmulq_f32(vmulq_f32(two, vsubq_f32(xz, wy)), sx);
+
+        float32x4_t c1x = vmulq_f32(vmulq_f32(two, vsubq_f32(xy, wz)), sy);
+        float32x4_t c1y = vmulq_f32(vmlsq_f32(one, two, vaddq_f32(xx, zz)), sy);
+        float32x4_t c1z = vmulq_f32(vmulq_f32(two, vaddq_f32(yz, wx)), sy);
+
+        float32x4_t c2x = vmulq_f32(vmulq_f32(two, vaddq_f32(xz, wy)), sz);
+        float32x4_t c2y = vmulq_f32(vmulq_f32(two, vsubq_f32(yz, wx)), sz);
+        float32x4_t c2z = vmulq_f32(vmlsq_f32(one, two, vaddq_f32(xx, yy)), sz);
+
+        glm::mat4* const* out = outputs + i;
+        StoreColumn4(out, 0, c0x, c0y, c0z, zero);
+        StoreColumn4(out, 1, c1x, c1y, c1z, zero);
+        StoreColumn4(out, 2, c2x, c2y, c2z, zero);
+        StoreColumn4(out, 3, vld1q_f32(s.PositionX + i), vld1q_f32(s.PositionY + i),
+                     vld1q_f32(s.PositionZ + i), one);
+    }
+
+    ComposeRangeScalar(s, outputs, i, count);
+}
+
+#endif // ENGINE_KERNELS_NEON
+
+ComposeKernel KernelForLevel(SimdLevel level) {
+    switch (level) {
+#if defined(ENGINE_KERNELS_X86)
+        case SimdLevel::AVX2: return ComposeAVX2;
+        case SimdLevel::SSE2: return ComposeSSE2;
+#endif
+#if defined(ENGINE_KERNELS_NEON)
+        case SimdLevel::NEON: return ComposeNEON;
+#endif
+        default: return ComposeScalar;
+    }
+}
+
+std::atomic<SimdLevel> s_Level{CPUFeatures::GetBestSimdLevel()};
+std::atomic<ComposeKernel> s_Kernel{KernelForLevel(CPUFeatures::GetBestSimdLevel())};
+
+} // anonymous namespace
+
+namespace TransformKernels {
+
+void ComposeTRS(const TRSStreams& streams, glm::mat4* const* outputs, usize count) {
+    s_Kernel.load(std::memory_order_relaxed)(streams, outputs, count);
+}
+
+void ComposeTRSScalar(const TRSStreams& streams, glm::mat4* const* outputs, usize count) {
+    ComposeScalar(streams, outputs, count);
+}
+
+bool IsSimdLevelSupported(SimdLevel level) {
+    return CPUFeatures::IsSupported(level);
+}
+
+void SetSimdLevel(SimdLevel level) {
+    if (!IsSimdLevelSupported(level)) {
+        level = CPUFeatures::GetBestSimdLevel();
+    }
+    s_Level.store(level, std::memory_order_relaxed);
+    s_Kernel.store(KernelForLevel(level), std::memory_order_relaxed);
+}
+
+SimdLevel GetSimdLevel() {
+    return s_Level.load(std::memory_order_relaxed);
+}
+
+} // namespace TransformKernels
+
+} // namespace Engine
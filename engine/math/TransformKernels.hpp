@@ -0,0 +1,46 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/CPUFeatures.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// SoA input streams for batch TRS composition.
+// Each pointer addresses `count` consecutive floats; rotation is a unit
+// quaternion split into x, y, z, w streams.
+struct TRSStreams {
+    const f32* PositionX = nullptr;
+    const f32* PositionY = nullptr;
+    const f32* PositionZ = nullptr;
+    const f32* RotationX = nullptr;
+    const f32* RotationY = nullptr;
+    const f32* RotationZ = nullptr;
+    const f32* RotationW = nullptr;
+    const f32* ScaleX = nullptr;
+    const f32* ScaleY = nullptr;
+    const f32* ScaleZ = nullptr;
+};
+
+// Vectorized translate * rotate * scale composition.
+// Produces the same matrices as Transform::GetLocalMatrix(), 4 (SSE2/NEON)
+// or 8 (AVX2) transforms per iteration, written straight to the destination
+// pointers so callers can target Transform::WorldMatrix in place.
+namespace TransformKernels {
+
+    // Compose `count` matrices using the kernel selected for this CPU
+    void ComposeTRS(const TRSStreams& streams, glm::mat4* const* outputs, usize count);
+
+    // Reference implementation through glm, used as fallback and for benchmarks
+    void ComposeTRSScalar(const TRSStreams& streams, glm::mat4* const* outputs, usize count);
+
+    // Kernel selection - defaults to CPUFeatures::GetBestSimdLevel().
+    // Requests for unsupported levels fall back to the best available one.
+    void SetSimdLevel(SimdLevel level);
+    SimdLevel GetSimdLevel();
+
+    bool IsSimdLevelSupported(SimdLevel level);
+
+} // namespace TransformKernels
+
+} // namespace Engine
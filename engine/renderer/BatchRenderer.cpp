@@ -1,105 +1,153 @@
 #include "BatchRenderer.hpp"
+#include "renderer/Mesh.hpp"
 #include "core/Logger.hpp"
+#include "core/Telemetry.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
 
 #include <glad/gl.h>
+#include <algorithm>
+#include <cstddef>
 
 namespace Engine {
 
-BatchRenderer::BatchRenderer() {
-    m_Transforms.reserve(MaxInstances);
+namespace {
 
-    // Create instance buffer for mat4 transforms
-    glGenBuffers(1, &m_InstanceBufferID);
-    glBindBuffer(GL_ARRAY_BUFFER, m_InstanceBufferID);
-    glBufferData(GL_ARRAY_BUFFER, MaxInstances * sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
-}
+const TelemetryCounter s_BatchDrawCalls("BatchRenderer.DrawCalls");
+const TelemetryCounter s_BatchInstances("BatchRenderer.Instances");
 
-BatchRenderer::~BatchRenderer() {
-    glDeleteBuffers(1, &m_InstanceBufferID);
+} // anonymous namespace
+
+BatchRenderer::BatchRenderer() {
+    m_InstanceRing = CreateScope<GPURingBuffer>(InitialCapacity * sizeof(InstanceData));
+    m_Submissions.reserve(InitialCapacity);
+
+    // Flags, MaterialIndex and Padding are pass data the batch shaders don't read
+    m_InstanceLayout = {
+        {ShaderDataType::Mat4, "a_Transform", false, static_cast<i32>(TransformLocation)},
+        {ShaderDataType::Float4, "a_Color", false, static_cast<i32>(ColorLocation)},
+        {ShaderDataType::Float4, "a_MaterialParams", false, static_cast<i32>(MaterialParamsLocation)},
+        {ShaderDataType::UInt, "a_EntityId", false, static_cast<i32>(EntityIdLocation)}
+    };
+    static_assert(offsetof(InstanceData, Color) == 64 && offsetof(InstanceData, MaterialParams) == 80 &&
+                  offsetof(InstanceData, EntityId) == 96, "InstanceLayout must follow InstanceData");
 }
 
-void BatchRenderer::Begin(Ref<Shader> shader, Ref<VertexArray> geometry) {
+BatchRenderer::~BatchRenderer() = default;
+
+void BatchRenderer::Begin() {
     if (m_InBatch) {
         LOG_CORE_WARN("BatchRenderer::Begin called while already in batch!");
         End();
     }
 
-    m_CurrentShader = shader;
-    m_CurrentGeometry = geometry;
-    m_CurrentIndexCount = geometry->GetIndexBuffer()->GetCount();
-    m_Transforms.clear();
+    m_Submissions.clear();
+    m_Shaders.clear();
     m_InBatch = true;
 }
 
-void BatchRenderer::Submit(const glm::mat4& transform) {
+void BatchRenderer::Submit(const Ref<Shader>& shader, const Ref<VertexArray>& geometry,
+                           const InstanceData& instance) {
+    const auto& indexBuffer = geometry->GetIndexBuffer();
+    Submit(shader, geometry.get(), indexBuffer ? indexBuffer->GetCount() : 0, 0, 0, instance);
+}
+
+void BatchRenderer::Submit(const Ref<Shader>& shader, const Mesh& mesh, const InstanceData& instance) {
+    Submit(shader, mesh.GetVertexArray().get(), mesh.GetIndexCount(), mesh.GetBaseIndex(), mesh.GetBaseVertex(),
+           instance);
+}
+
+void BatchRenderer::Submit(const Ref<Shader>& shader, VertexArray* vao, u32 indexCount, u32 baseIndex,
+                           u32 baseVertex, const InstanceData& instance) {
     if (!m_InBatch) {
         LOG_CORE_WARN("BatchRenderer::Submit called outside of Begin/End!");
         return;
     }
+    if (!shader || !vao || indexCount == 0) return;
 
-    if (m_Transforms.size() >= MaxInstances) {
-        Flush();
+    // Consecutive submissions nearly always share a shader
+    if (m_Shaders.empty() || m_Shaders.back() != shader) {
+        m_Shaders.push_back(shader);
     }
 
-    m_Transforms.push_back(transform);
+    Submission submission;
+    submission.ShaderProgram = shader.get();
+    submission.VAO = vao;
+    submission.IndexCount = indexCount;
+    submission.BaseIndex = baseIndex;
+    submission.BaseVertex = baseVertex;
+    submission.Instance = instance;
+    m_Submissions.push_back(submission);
 }
 
 void BatchRenderer::End() {
     if (!m_InBatch) {
         return;
     }
-
-    Flush();
     m_InBatch = false;
-    m_CurrentShader = nullptr;
-    m_CurrentGeometry = nullptr;
-}
 
-void BatchRenderer::Flush() {
-    if (m_Transforms.empty()) {
+    const u32 count = static_cast<u32>(m_Submissions.size());
+    if (count == 0) {
+        m_Shaders.clear();
         return;
     }
 
-    // Upload transforms to GPU
-    glBindBuffer(GL_ARRAY_BUFFER, m_InstanceBufferID);
-    glBufferSubData(GL_ARRAY_BUFFER, 0,
-                    m_Transforms.size() * sizeof(glm::mat4),
-                    m_Transforms.data());
-
-    // Bind shader and geometry
-    m_CurrentShader->Bind();
-    m_CurrentGeometry->Bind();
-
-    // Setup instance attributes (mat4 = 4 vec4s)
-    // Assumes vertex attributes 0-1 are position/color, instance starts at 2
-    const u32 instanceAttribStart = 2;
-    glBindBuffer(GL_ARRAY_BUFFER, m_InstanceBufferID);
-
-    for (u32 i = 0; i < 4; i++) {
-        u32 attribIndex = instanceAttribStart + i;
-        glEnableVertexAttribArray(attribIndex);
-        glVertexAttribPointer(attribIndex, 4, GL_FLOAT, GL_FALSE,
-                              sizeof(glm::mat4),
-                              reinterpret_cast<void*>(sizeof(glm::vec4) * i));
-        glVertexAttribDivisor(attribIndex, 1);
+    std::sort(m_Submissions.begin(), m_Submissions.end(), [](const Submission& a, const Submission& b) {
+        if (a.ShaderProgram != b.ShaderProgram) return a.ShaderProgram < b.ShaderProgram;
+        if (a.VAO != b.VAO) return a.VAO < b.VAO;
+        if (a.BaseIndex != b.BaseIndex) return a.BaseIndex < b.BaseIndex;
+        if (a.BaseVertex != b.BaseVertex) return a.BaseVertex < b.BaseVertex;
+        return a.IndexCount < b.IndexCount;
+    });
+
+    m_InstanceRing->BeginFrame();
+    GPURingBuffer::Allocation allocation = m_InstanceRing->Allocate(count * sizeof(InstanceData));
+    if (!allocation) {
+        m_Submissions.clear();
+        m_Shaders.clear();
+        return;
     }
 
-    // Draw instanced
-    glDrawElementsInstanced(GL_TRIANGLES,
-                            m_CurrentIndexCount,
-                            GL_UNSIGNED_INT,
-                            nullptr,
-                            static_cast<GLsizei>(m_Transforms.size()));
-
-    // Disable instance attributes
-    for (u32 i = 0; i < 4; i++) {
-        glDisableVertexAttribArray(instanceAttribStart + i);
+    InstanceData* instances = static_cast<InstanceData*>(allocation.Data);
+    for (u32 i = 0; i < count; ++i) {
+        instances[i] = m_Submissions[i].Instance;
     }
 
-    m_Stats.DrawCalls++;
-    m_Stats.InstanceCount += static_cast<u32>(m_Transforms.size());
+    Shader* boundShader = nullptr;
+    u32 first = 0;
+    while (first < count) {
+        const Submission& bucket = m_Submissions[first];
+        u32 last = first + 1;
+        while (last < count && m_Submissions[last].ShaderProgram == bucket.ShaderProgram &&
+               m_Submissions[last].VAO == bucket.VAO && m_Submissions[last].BaseIndex == bucket.BaseIndex &&
+               m_Submissions[last].BaseVertex == bucket.BaseVertex &&
+               m_Submissions[last].IndexCount == bucket.IndexCount) {
+            ++last;
+        }
+
+        if (bucket.ShaderProgram != boundShader) {
+            bucket.ShaderProgram->Bind();
+            boundShader = bucket.ShaderProgram;
+        }
+        bucket.VAO->SetInstanceDataBuffer(m_InstanceLayout, sizeof(InstanceData), allocation.Buffer,
+                                          allocation.Offset);
+        bucket.VAO->Bind();
+
+        PipelineWarmup::RecordDraw(GL_TRIANGLES);
+        glDrawElementsInstancedBaseVertexBaseInstance(
+            GL_TRIANGLES, static_cast<GLsizei>(bucket.IndexCount), GL_UNSIGNED_INT,
+            reinterpret_cast<const void*>(static_cast<usize>(bucket.BaseIndex) * sizeof(u32)),
+            static_cast<GLsizei>(last - first), static_cast<GLint>(bucket.BaseVertex), first);
+
+        m_Stats.DrawCalls++;
+        s_BatchDrawCalls.Add();
+        first = last;
+    }
+    m_Stats.InstanceCount += count;
+    s_BatchInstances.Add(count);
 
-    m_Transforms.clear();
+    m_InstanceRing->EndFrame();
+    m_Submissions.clear();
+    m_Shaders.clear();
 }
 
 } // namespace Engine
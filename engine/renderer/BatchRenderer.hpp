@@ -1,43 +1,88 @@
 #pragma once
 
 #include "core/Types.hpp"
+#include "ecs/Components/Renderable.hpp"
 #include "renderer/opengl/GLShader.hpp"
 #include "renderer/opengl/GLVertexArray.hpp"
-#include "renderer/opengl/GLBuffer.hpp"
-
-#include <glm/glm.hpp>
+#include "renderer/opengl/GPURingBuffer.hpp"
 
 namespace Engine {
 
+class Mesh;
+
+// BatchRenderer - instanced drawing of many geometries per Begin()/End().
+//
+// Submit() only records (shader, geometry, InstanceData); End() sorts the
+// submissions into buckets of equal shader and mesh, copies every instance
+// into one GPURingBuffer allocation in bucket order and issues one
+// glDrawElementsInstancedBaseVertexBaseInstance per bucket, whose
+// baseInstance selects the bucket's slice of the allocation.
+//
+// Instances reach the shader as vertex attributes (InstanceLayout, see
+// common/batch_instance.glsl) through the VAO's InstanceDataBinding. The
+// attribute formats are specified once per VAO; afterwards a frame only
+// re-points the binding at the new allocation.
+//
+// Every End() fences its region of the ring, and the ring holds
+// GPURingBuffer::FramesInFlight regions: more Begin()/End() scopes than that
+// per frame wait for the GPU to finish the oldest one.
 class BatchRenderer {
 public:
-    static constexpr u32 MaxInstances = 10000;
+    static constexpr u32 InitialCapacity = 4096;   // Instances per scope before the ring grows
 
-    BatchRenderer();
-    ~BatchRenderer();
-
-    void Begin(Ref<Shader> shader, Ref<VertexArray> geometry);
-    void Submit(const glm::mat4& transform);
-    void End();
+    // Vertex attribute locations, must match batch_instance.glsl. Mesh
+    // attributes use 0-5 and IndirectDrawBatcher's instance index 8.
+    static constexpr u32 TransformLocation = 9;    // 4 columns, 9-12
+    static constexpr u32 ColorLocation = 13;
+    static constexpr u32 MaterialParamsLocation = 14;
+    static constexpr u32 EntityIdLocation = 15;
 
     struct Statistics {
-        u32 DrawCalls = 0;
+        u32 DrawCalls = 0;   // One per (shader, mesh) bucket
         u32 InstanceCount = 0;
     };
 
+    BatchRenderer();
+    ~BatchRenderer();
+
+    BatchRenderer(const BatchRenderer&) = delete;
+    BatchRenderer& operator=(const BatchRenderer&) = delete;
+
+    void Begin();
+
+    // Whole index buffer of geometry
+    void Submit(const Ref<Shader>& shader, const Ref<VertexArray>& geometry, const InstanceData& instance);
+
+    // Mesh LOD 0, with its GeometryPool base offsets. Quantized meshes need
+    // instance.Transform from Mesh::GetDrawTransform.
+    void Submit(const Ref<Shader>& shader, const Mesh& mesh, const InstanceData& instance);
+
+    // Draw everything submitted since Begin()
+    void End();
+
     const Statistics& GetStats() const { return m_Stats; }
     void ResetStats() { m_Stats = {}; }
 
 private:
-    void Flush();
+    struct Submission {
+        Shader* ShaderProgram = nullptr;
+        VertexArray* VAO = nullptr;
+        u32 IndexCount = 0;
+        u32 BaseIndex = 0;
+        u32 BaseVertex = 0;
+        InstanceData Instance;
+    };
+
+    void Submit(const Ref<Shader>& shader, VertexArray* vao, u32 indexCount, u32 baseIndex, u32 baseVertex,
+                const InstanceData& instance);
 
 private:
-    Ref<Shader> m_CurrentShader;
-    Ref<VertexArray> m_CurrentGeometry;
-    u32 m_CurrentIndexCount = 0;
+    Scope<GPURingBuffer> m_InstanceRing;
+    BufferLayout m_InstanceLayout;
 
-    Vector<glm::mat4> m_Transforms;
-    u32 m_InstanceBufferID = 0;
+    // Keep the shaders alive until End(); submissions refer to them by pointer
+    Vector<Ref<Shader>> m_Shaders;
+    Vector<Submission> m_Submissions;
 
     Statistics m_Stats;
     bool m_InBatch = false;
@@ -0,0 +1,57 @@
+#include "CameraUniformBuffer.hpp"
+#include "camera/Camera.hpp"
+
+#include <glad/gl.h>
+
+namespace Engine {
+
+CameraUniformBuffer::CameraUniformBuffer() {
+    m_Ring = CreateScope<GPURingBuffer>(sizeof(CameraUniforms));
+}
+
+CameraUniformBuffer::~CameraUniformBuffer() = default;
+
+CameraUniforms CameraUniformBuffer::Build(const Camera& camera) {
+    CameraUniforms uniforms;
+    uniforms.View = camera.GetViewMatrix();
+    uniforms.Projection = camera.GetProjectionMatrix();
+    uniforms.ViewProjection = camera.GetViewProjectionMatrix();
+    uniforms.InverseView = camera.GetInverseViewMatrix();
+    uniforms.InverseProjection = camera.GetInverseProjectionMatrix();
+    uniforms.InverseViewProjection = camera.GetInverseViewProjectionMatrix();
+    uniforms.JitteredProjection = camera.GetJitteredProjectionMatrix();
+    uniforms.JitteredViewProjection = camera.GetJitteredViewProjectionMatrix();
+    uniforms.PreviousViewProjection = uniforms.ViewProjection;
+
+    const Frustum& frustum = camera.GetFrustum();
+    for (u32 i = 0; i < Frustum::Count; ++i) {
+        const Plane& plane = frustum.GetPlane(static_cast<Frustum::PlaneIndex>(i));
+        uniforms.FrustumPlanes[i] = glm::vec4(plane.Normal, plane.Distance);
+    }
+
+    // Clip planes of an OpenGL perspective projection
+    const glm::mat4& projection = uniforms.Projection;
+    uniforms.Position = camera.GetPosition();
+    uniforms.NearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+    uniforms.FarPlane = projection[3][2] / (projection[2][2] + 1.0f);
+    uniforms.Jitter = camera.GetProjectionJitter();
+    return uniforms;
+}
+
+void CameraUniformBuffer::Upload(const Camera& camera) {
+    const glm::mat4 previous = m_Allocation ? m_Uniforms.ViewProjection : camera.GetViewProjectionMatrix();
+    m_Uniforms = Build(camera);
+    m_Uniforms.PreviousViewProjection = previous;
+
+    // The next frame's BeginFrame fences every pass that read this one
+    m_Ring->BeginFrame();
+    m_Allocation = m_Ring->Upload(&m_Uniforms, 1);
+    Bind();
+}
+
+void CameraUniformBuffer::Bind() const {
+    if (!m_Allocation) return;
+    GPURingBuffer::BindRange(GL_UNIFORM_BUFFER, UniformBinding, m_Allocation);
+}
+
+} // namespace Engine
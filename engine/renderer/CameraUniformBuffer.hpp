@@ -0,0 +1,66 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/opengl/GPURingBuffer.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+class Camera;
+
+// std140 mirror of CameraBlock in assets/shaders/common/camera.glsl
+struct CameraUniforms {
+    glm::mat4 View{1.0f};
+    glm::mat4 Projection{1.0f};
+    glm::mat4 ViewProjection{1.0f};
+    glm::mat4 InverseView{1.0f};
+    glm::mat4 InverseProjection{1.0f};
+    glm::mat4 InverseViewProjection{1.0f};
+    glm::mat4 JitteredProjection{1.0f};
+    glm::mat4 JitteredViewProjection{1.0f};
+    glm::mat4 PreviousViewProjection{1.0f};  // Unjittered, as of the previous Upload
+    glm::vec4 FrustumPlanes[6] = {};     // xyz = normal, w = distance
+    glm::vec3 Position{0.0f};
+    f32 NearPlane = 0.0f;
+    glm::vec2 Jitter{0.0f};
+    f32 FarPlane = 0.0f;
+    f32 Padding = 0.0f;
+};
+static_assert(sizeof(CameraUniforms) == 704, "CameraUniforms must match the std140 CameraBlock");
+
+// CameraUniformBuffer - the per-frame camera uniform block.
+//
+// Upload() writes a camera's cached matrices once and binds them at
+// UniformBinding, where every pass that includes common/camera.glsl reads
+// them; passes no longer set their own view / projection uniforms. The
+// block streams through a GPURingBuffer, so a frame in flight keeps reading
+// the values it was recorded with.
+class CameraUniformBuffer {
+public:
+    static constexpr u32 UniformBinding = 1;
+
+    CameraUniformBuffer();
+    ~CameraUniformBuffer();
+
+    CameraUniformBuffer(const CameraUniformBuffer&) = delete;
+    CameraUniformBuffer& operator=(const CameraUniformBuffer&) = delete;
+
+    // Once per frame, before the first pass that draws with the camera. The
+    // previous upload's view-projection is kept for motion vectors, so each
+    // buffer should follow one camera.
+    void Upload(const Camera& camera);
+
+    // Rebind the last upload, after a pass bound something else there
+    void Bind() const;
+
+    const CameraUniforms& GetUniforms() const { return m_Uniforms; }
+
+    static CameraUniforms Build(const Camera& camera);
+
+private:
+    Scope<GPURingBuffer> m_Ring;
+    CameraUniforms m_Uniforms;
+    GPURingBuffer::Allocation m_Allocation;
+};
+
+} // namespace Engine
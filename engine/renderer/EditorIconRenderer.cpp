@@ -1,12 +1,15 @@
 #include "EditorIconRenderer.hpp"
-#include "renderer/opengl/GLBuffer.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
 #include "resources/ResourceManager.hpp"
 #include "ecs/Components/Renderable.hpp"
 #include "ecs/Components/LightComponents.hpp"
+#include "ecs/Components/TransformSoA.hpp"
 #include "core/Logger.hpp"
 
 #include <glad/gl.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 
 namespace Engine {
 
@@ -42,6 +45,21 @@ EditorIconRenderer::EditorIconRenderer() {
     m_QuadVAO->AddVertexBuffer(vbo);
     m_QuadVAO->SetIndexBuffer(ibo);
 
+    // Per-instance stream on the next binding; VertexArray::Bind() points
+    // it at the region the last SetData wrote
+    m_InstanceBuffer = CreateRef<VertexBuffer>(MaxIconsPerDraw * static_cast<u32>(sizeof(IconInstance)),
+                                               BufferUsage::Stream);
+    m_InstanceBuffer->SetLayout({
+        {ShaderDataType::Float3, "a_IconPosition", false, 2},
+        {ShaderDataType::Int, "a_IconType"},
+        {ShaderDataType::Float4, "a_IconColor"}
+    });
+    const u32 instanceBinding = static_cast<u32>(m_QuadVAO->GetVertexBuffers().size());
+    m_QuadVAO->AddVertexBuffer(m_InstanceBuffer);
+    glVertexArrayBindingDivisor(m_QuadVAO->GetRendererID(), instanceBinding, 1);
+
+    m_Instances.reserve(MaxIconsPerDraw);
+
     LOG_CORE_INFO("EditorIconRenderer initialized");
 }
 
@@ -74,44 +92,29 @@ AABB EditorIconRenderer::GetIconBounds(const Transform& transform) const {
     return AABB(center - halfExtent, center + halfExtent);
 }
 
-void EditorIconRenderer::RenderIcon(const glm::vec3& position, EditorIconType type,
-                                    const glm::mat4& viewProjection,
-                                    const glm::vec3& cameraRight, const glm::vec3& cameraUp) {
-    m_Shader->SetFloat3("u_WorldPosition", position);
-    m_Shader->SetFloat("u_Size", m_IconSize);
-    m_Shader->SetFloat3("u_CameraRight", cameraRight);
-    m_Shader->SetFloat3("u_CameraUp", cameraUp);
-    m_Shader->SetFloat4("u_Color", GetIconColor(type));
-    m_Shader->SetInt("u_IconType", static_cast<i32>(type));
-
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+void EditorIconRenderer::CollectIcon(const glm::vec3& position, EditorIconType type) {
+    m_Instances.push_back({position, static_cast<i32>(type), GetIconColor(type)});
 }
 
-void EditorIconRenderer::Render(entt::registry& registry, const glm::mat4& view,
-                                const glm::mat4& projection,
-                                const glm::vec3& cameraRight, const glm::vec3& cameraUp) {
-    if (!m_Visible || !m_Shader || !m_QuadVAO) return;
+void EditorIconRenderer::DrawInstances() {
+    const auto total = static_cast<u32>(m_Instances.size());
+    for (u32 first = 0; first < total; first += MaxIconsPerDraw) {
+        const u32 count = std::min(total - first, MaxIconsPerDraw);
 
-    // Save state
-    GLboolean depthTest, blend, cullFace;
-    GLint depthFunc;
-    glGetBooleanv(GL_DEPTH_TEST, &depthTest);
-    glGetBooleanv(GL_BLEND, &blend);
-    glGetBooleanv(GL_CULL_FACE, &cullFace);
-    glGetIntegerv(GL_DEPTH_FUNC, &depthFunc);
+        // Upload before Bind() so the VAO picks up this batch's region
+        m_InstanceBuffer->SetData(m_Instances.data() + first, count * static_cast<u32>(sizeof(IconInstance)));
+        m_QuadVAO->Bind();
 
-    // Setup rendering state
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_CULL_FACE);
+        PipelineWarmup::RecordDraw(GL_TRIANGLES);
+        glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(count));
+    }
+}
 
-    glm::mat4 viewProjection = projection * view;
+void EditorIconRenderer::Render(entt::registry& registry) {
+    if (!m_Visible || !m_Shader || !m_QuadVAO) return;
 
-    m_Shader->Bind();
-    m_Shader->SetMat4("u_ViewProjection", viewProjection);
-    m_QuadVAO->Bind();
+    // Collect first: a registry without icons touches no GL state at all
+    m_Instances.clear();
 
     // Render icons for entities without meshes or with light components
     auto transformView = registry.view<Transform>();
@@ -121,15 +124,31 @@ void EditorIconRenderer::Render(entt::registry& registry, const glm::mat4& view,
         // Skip entities that don't need icons (have mesh and no special components)
         if (iconType == EditorIconType::None) continue;
 
-        const auto& transform = transformView.get<Transform>(entity);
-        RenderIcon(transform.Position, iconType, viewProjection, cameraRight, cameraUp);
+        CollectIcon(transformView.get<Transform>(entity).Position, iconType);
     }
 
-    // Restore state
-    if (depthTest) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
-    glDepthFunc(depthFunc);
-    if (blend) glEnable(GL_BLEND); else glDisable(GL_BLEND);
-    if (cullFace) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE);
+    // SoA-layout entities only touch their LocalTransform storage
+    auto localView = registry.view<LocalTransform>(entt::exclude<Transform>);
+    for (auto entity : localView) {
+        EditorIconType iconType = DetermineIconType(registry, entity);
+        if (iconType == EditorIconType::None) continue;
+
+        CollectIcon(localView.get<LocalTransform>(entity).Position, iconType);
+    }
+
+    if (m_Instances.empty()) return;
+
+    GLStateCache::ScopedState savedState;
+    RenderState overlayState;
+    overlayState.DepthFunc = GL_LEQUAL;
+    overlayState.Blend = true;
+    overlayState.CullFace = false;
+    GLStateCache::Instance().Apply(overlayState);
+
+    m_Shader->Bind();
+    m_Shader->SetFloat("u_Size", m_IconSize);
+
+    DrawInstances();
 }
 
 } // namespace Engine
@@ -3,6 +3,7 @@
 #include "core/Types.hpp"
 #include "renderer/opengl/GLShader.hpp"
 #include "renderer/opengl/GLVertexArray.hpp"
+#include "renderer/opengl/GLBuffer.hpp"
 #include "ecs/Components/Transform.hpp"
 #include "math/AABB.hpp"
 #include <glm/glm.hpp>
@@ -19,13 +20,22 @@ enum class EditorIconType : u8 {
     AmbientLight
 };
 
+// EditorIconRenderer - camera-facing icons for lights and empty entities.
+//
+// Render() collects one IconInstance per icon into a stream vertex buffer
+// and draws them all with a single instanced call; the icon shapes are
+// procedural in billboard.glsl, so every type shares the one draw. GL state
+// goes through GLStateCache, so saving and restoring it costs no glGet.
 class EditorIconRenderer {
 public:
+    // Icons per instanced draw (the stream region size); more take further draws
+    static constexpr u32 MaxIconsPerDraw = 4096;
+
     EditorIconRenderer();
     ~EditorIconRenderer() = default;
 
-    void Render(entt::registry& registry, const glm::mat4& view, const glm::mat4& projection,
-                const glm::vec3& cameraRight, const glm::vec3& cameraUp);
+    // Camera from the per-frame camera uniform block
+    void Render(entt::registry& registry);
 
     // Get icon bounds for picking
     AABB GetIconBounds(const Transform& transform) const;
@@ -40,13 +50,22 @@ public:
     bool IsVisible() const { return m_Visible; }
 
 private:
+    // Matches the per-instance attributes of billboard.glsl
+    struct IconInstance {
+        glm::vec3 Position;
+        i32 Type;
+        glm::vec4 Color;
+    };
+    static_assert(sizeof(IconInstance) == 32, "IconInstance must match the instance buffer layout");
+
     glm::vec4 GetIconColor(EditorIconType type) const;
-    void RenderIcon(const glm::vec3& position, EditorIconType type,
-                    const glm::mat4& viewProjection,
-                    const glm::vec3& cameraRight, const glm::vec3& cameraUp);
+    void CollectIcon(const glm::vec3& position, EditorIconType type);
+    void DrawInstances();
 
     Ref<Shader> m_Shader;
     Ref<VertexArray> m_QuadVAO;
+    Ref<VertexBuffer> m_InstanceBuffer;     // Stream: one region per draw
+    Vector<IconInstance> m_Instances;       // Collected this frame, reused
     f32 m_IconSize = 1.5f;
     bool m_Visible = true;
 };
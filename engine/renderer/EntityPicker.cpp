@@ -0,0 +1,81 @@
+#include "renderer/EntityPicker.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+
+namespace Engine {
+
+EntityPicker::~EntityPicker() {
+    Cancel();
+    if (m_Buffer) {
+        GLMemory::DeleteBuffers(1, &m_Buffer);
+    }
+}
+
+void EntityPicker::Request(u32 texture, u32 x, u32 y, u32 width, u32 height) {
+    Cancel();
+    if (!texture || width == 0 || height == 0) return;
+
+    const usize pixelCount = static_cast<usize>(width) * height;
+    const usize size = pixelCount * sizeof(u32);
+    if (size > m_Capacity) {
+        if (m_Buffer) {
+            GLMemory::DeleteBuffers(1, &m_Buffer);
+        }
+        glCreateBuffers(1, &m_Buffer);
+        GLMemory::BufferStorage(m_Buffer, static_cast<GLsizeiptr>(size), nullptr, GL_CLIENT_STORAGE_BIT,
+                                MemoryTag::Editor);
+        m_Capacity = size;
+    }
+
+    // With a pack buffer bound the pixel pointer is an offset into it
+    GLStateCache::Instance().BindBuffer(GL_PIXEL_PACK_BUFFER, m_Buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glGetTextureSubImage(texture, 0,
+                         static_cast<GLint>(x), static_cast<GLint>(y), 0,
+                         static_cast<GLsizei>(width), static_cast<GLsizei>(height), 1,
+                         GL_RED_INTEGER, GL_UNSIGNED_INT,
+                         static_cast<GLsizei>(size), nullptr);
+    GLStateCache::Instance().BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_PixelCount = pixelCount;
+}
+
+bool EntityPicker::Poll(Vector<entt::entity>& outEntities) {
+    if (!m_Fence) return false;
+
+    GLenum status = glClientWaitSync(static_cast<GLsync>(m_Fence), 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return false;
+
+    glDeleteSync(static_cast<GLsync>(m_Fence));
+    m_Fence = nullptr;
+
+    // The copy has finished, so this does not wait on the GPU
+    m_Pixels.resize(m_PixelCount);
+    glGetNamedBufferSubData(m_Buffer, 0, static_cast<GLsizeiptr>(m_PixelCount * sizeof(u32)), m_Pixels.data());
+
+    outEntities.clear();
+    u32 previous = static_cast<u32>(entt::null);
+    for (u32 id : m_Pixels) {
+        // Neighbouring pixels mostly repeat the same entity
+        if (id == previous || id == static_cast<u32>(entt::null)) continue;
+        previous = id;
+        outEntities.push_back(static_cast<entt::entity>(id));
+    }
+
+    std::sort(outEntities.begin(), outEntities.end());
+    outEntities.erase(std::unique(outEntities.begin(), outEntities.end()), outEntities.end());
+    return true;
+}
+
+void EntityPicker::Cancel() {
+    if (m_Fence) {
+        glDeleteSync(static_cast<GLsync>(m_Fence));
+        m_Fence = nullptr;
+    }
+}
+
+} // namespace Engine
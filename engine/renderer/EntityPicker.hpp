@@ -0,0 +1,44 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include <entt/entt.hpp>
+
+namespace Engine {
+
+// EntityPicker - reads entities back from an entity ID texture (the R32UI
+// G-buffer target) without stalling.
+//
+// Request() copies a rectangle of the texture into a pixel pack buffer and
+// fences it; Poll() hands back the entities under it once the copy has
+// finished, usually a frame or two later. A click reads one pixel, so its
+// cost does not depend on the scene; a marquee reads its rectangle. One
+// request is in flight at a time, a new one replaces it.
+class EntityPicker {
+public:
+    EntityPicker() = default;
+    ~EntityPicker();
+
+    EntityPicker(const EntityPicker&) = delete;
+    EntityPicker& operator=(const EntityPicker&) = delete;
+
+    // Read the texels [x, x + width) x [y, y + height) of texture, origin at
+    // the bottom left. The rectangle must lie inside the texture.
+    void Request(u32 texture, u32 x, u32 y, u32 width = 1, u32 height = 1);
+
+    bool IsPending() const { return m_Fence != nullptr; }
+
+    // True once the pending request has landed; outEntities receives the
+    // distinct entities it covers, null excluded
+    bool Poll(Vector<entt::entity>& outEntities);
+
+    void Cancel();
+
+private:
+    u32 m_Buffer = 0;
+    usize m_Capacity = 0;       // Bytes
+    usize m_PixelCount = 0;     // Of the pending request
+    void* m_Fence = nullptr;
+    Vector<u32> m_Pixels;
+};
+
+} // namespace Engine
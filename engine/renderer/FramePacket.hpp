@@ -0,0 +1,46 @@
+#pragma once
+
+#include "core/Types.hpp"
+
+#include <glm/glm.hpp>
+#include <functional>
+
+namespace Engine {
+
+// FramePacket - everything the render thread needs to draw one frame.
+//
+// Filled on the main thread at the extraction point (after the PreRender
+// phase, see Application::OnExtract) and executed on the render thread while
+// the main thread simulates the next frame. Once submitted a packet is
+// immutable: commands must capture what they draw (visible instances, light
+// lists, particle parameters) by value, or point at frame-arena memory, and
+// never at state the simulation keeps changing.
+struct FramePacket {
+    using RenderTask = std::function<void(const FramePacket&)>;
+
+    struct CameraView {
+        glm::mat4 View{1.0f};
+        glm::mat4 Projection{1.0f};
+        glm::mat4 ViewProjection{1.0f};
+        glm::vec3 Position{0.0f};
+    };
+
+    u64 FrameIndex = 0;
+    f32 DeltaTime = 0.0f;
+    CameraView Camera;
+
+    // Run in order on the render thread, which owns the GL context
+    Vector<RenderTask> Commands;
+
+    void Enqueue(RenderTask task) { Commands.push_back(std::move(task)); }
+
+    // Keeps the command storage for the next frame
+    void Reset(u64 frameIndex, f32 deltaTime) {
+        FrameIndex = frameIndex;
+        DeltaTime = deltaTime;
+        Camera = CameraView{};
+        Commands.clear();
+    }
+};
+
+} // namespace Engine
@@ -0,0 +1,248 @@
+#include "renderer/GeometryPool.hpp"
+#include "core/Logger.hpp"
+#include <algorithm>
+
+namespace Engine {
+
+namespace {
+
+bool SameLayout(const BufferLayout& a, const BufferLayout& b) {
+    const auto& elementsA = a.GetElements();
+    const auto& elementsB = b.GetElements();
+    if (a.GetStride() != b.GetStride() || elementsA.size() != elementsB.size()) return false;
+
+    for (usize i = 0; i < elementsA.size(); ++i) {
+        if (elementsA[i].Type != elementsB[i].Type ||
+            elementsA[i].Offset != elementsB[i].Offset ||
+            elementsA[i].Normalized != elementsB[i].Normalized) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+// GeometryRange
+
+GeometryRange::GeometryRange(Ref<GeometryPool> pool, u32 format, u32 page,
+                             u32 baseVertex, u32 vertexCount, u32 baseIndex, u32 indexCount)
+    : m_Pool(std::move(pool))
+    , m_Format(format)
+    , m_Page(page)
+    , m_BaseVertex(baseVertex)
+    , m_VertexCount(vertexCount)
+    , m_BaseIndex(baseIndex)
+    , m_IndexCount(indexCount)
+{
+    const auto& pageData = *m_Pool->m_Formats[format].Pages[page];
+    m_VAO = pageData.VAO;
+    m_DepthVAO = pageData.DepthVAO;
+    m_VBO = pageData.VBO;
+    m_PositionVBO = pageData.PositionVBO;
+}
+
+GeometryRange::~GeometryRange() {
+    if (m_Pool) {
+        m_Pool->Free(*this);
+    }
+}
+
+void GeometryRange::Write(const void* vertices, const u32* indices, const void* positions) {
+    m_Pool->Write(*this, vertices, indices, positions);
+}
+
+// GeometryPool
+
+GeometryPool::GeometryPool(u32 pageVertices, u32 pageIndices)
+    : m_PageVertices(pageVertices)
+    , m_PageIndices(pageIndices) {
+}
+
+u32 GeometryPool::RangeList::Allocate(u32 count) {
+    if (count == 0) return 0;
+
+    for (auto it = Free.begin(); it != Free.end(); ++it) {
+        if (it->Count < count) continue;
+
+        u32 offset = it->Offset;
+        it->Offset += count;
+        it->Count -= count;
+        if (it->Count == 0) {
+            Free.erase(it);
+        }
+        return offset;
+    }
+    return InvalidOffset;
+}
+
+void GeometryPool::RangeList::Release(u32 offset, u32 count) {
+    if (count == 0) return;
+
+    auto it = std::lower_bound(Free.begin(), Free.end(), offset,
+        [](const Range& range, u32 value) { return range.Offset < value; });
+    it = Free.insert(it, Range{offset, count});
+
+    // Merge with the following range, then the preceding one
+    auto next = it + 1;
+    if (next != Free.end() && it->Offset + it->Count == next->Offset) {
+        it->Count += next->Count;
+        Free.erase(next);
+    }
+    if (it != Free.begin()) {
+        auto prev = it - 1;
+        if (prev->Offset + prev->Count == it->Offset) {
+            prev->Count += it->Count;
+            Free.erase(it);
+        }
+    }
+}
+
+u32 GeometryPool::FindOrAddFormat(const BufferLayout& layout, const BufferLayout& positionLayout) {
+    for (u32 i = 0; i < static_cast<u32>(m_Formats.size()); ++i) {
+        if (SameLayout(m_Formats[i].Layout, layout) &&
+            SameLayout(m_Formats[i].PositionLayout, positionLayout)) {
+            return i;
+        }
+    }
+
+    Format format;
+    format.Layout = layout;
+    format.PositionLayout = positionLayout;
+    m_Formats.push_back(std::move(format));
+    m_Stats.Formats++;
+    return static_cast<u32>(m_Formats.size() - 1);
+}
+
+GeometryPool::Page& GeometryPool::CreatePage(Format& format, u32 minVertices, u32 minIndices) {
+    auto page = CreateScope<Page>();
+    page->VertexCapacity = std::max(m_PageVertices, minVertices);
+    page->IndexCapacity = std::max(m_PageIndices, minIndices);
+
+    page->VBO = CreateRef<VertexBuffer>(page->VertexCapacity * format.Layout.GetStride(), BufferUsage::Dynamic);
+    page->VBO->SetLayout(format.Layout);
+    page->IBO = CreateRef<IndexBuffer>(page->IndexCapacity, BufferUsage::Dynamic);
+
+    page->VAO = CreateRef<VertexArray>();
+    page->VAO->AddVertexBuffer(page->VBO);
+    page->VAO->SetIndexBuffer(page->IBO);
+
+    if (format.PositionLayout.GetStride() > 0) {
+        page->PositionVBO = CreateRef<VertexBuffer>(page->VertexCapacity * format.PositionLayout.GetStride(),
+                                                    BufferUsage::Dynamic);
+        page->PositionVBO->SetLayout(format.PositionLayout);
+
+        page->DepthVAO = CreateRef<VertexArray>();
+        page->DepthVAO->AddVertexBuffer(page->PositionVBO);
+        page->DepthVAO->SetIndexBuffer(page->IBO);
+    }
+
+    page->Vertices.Free.push_back(Range{0, page->VertexCapacity});
+    page->Indices.Free.push_back(Range{0, page->IndexCapacity});
+
+    m_Stats.Pages++;
+    m_Stats.VertexCapacity += page->VertexCapacity;
+    m_Stats.IndexCapacity += page->IndexCapacity;
+
+    LOG_CORE_INFO("GeometryPool: New page for stride {}: {} vertices, {} indices",
+                  format.Layout.GetStride(), page->VertexCapacity, page->IndexCapacity);
+
+    format.Pages.push_back(std::move(page));
+    return *format.Pages.back();
+}
+
+Ref<GeometryRange> GeometryPool::Allocate(const BufferLayout& layout, const void* vertices, u32 vertexCount,
+                                          const u32* indices, u32 indexCount,
+                                          const BufferLayout* positionLayout, const void* positions) {
+    if (!vertices || vertexCount == 0) {
+        LOG_CORE_WARN("GeometryPool: Allocate called without vertices");
+        return nullptr;
+    }
+    if (layout.GetStride() == 0) {
+        LOG_CORE_ERROR("GeometryPool: Vertex layout has no elements");
+        return nullptr;
+    }
+
+    const BufferLayout noPositions;
+    const bool hasPositions = positionLayout && positions && positionLayout->GetStride() > 0;
+    const u32 formatIndex = FindOrAddFormat(layout, hasPositions ? *positionLayout : noPositions);
+    Format& format = m_Formats[formatIndex];
+
+    u32 pageIndex = InvalidOffset;
+    u32 baseVertex = InvalidOffset;
+    u32 baseIndex = InvalidOffset;
+
+    for (u32 i = 0; i < static_cast<u32>(format.Pages.size()); ++i) {
+        Page& page = *format.Pages[i];
+        baseVertex = page.Vertices.Allocate(vertexCount);
+        if (baseVertex == InvalidOffset) continue;
+
+        baseIndex = page.Indices.Allocate(indexCount);
+        if (baseIndex == InvalidOffset) {
+            page.Vertices.Release(baseVertex, vertexCount);
+            continue;
+        }
+
+        pageIndex = i;
+        break;
+    }
+
+    if (pageIndex == InvalidOffset) {
+        Page& page = CreatePage(format, vertexCount, indexCount);
+        pageIndex = static_cast<u32>(format.Pages.size() - 1);
+        baseVertex = page.Vertices.Allocate(vertexCount);
+        baseIndex = page.Indices.Allocate(indexCount);
+    }
+
+    Page& page = *format.Pages[pageIndex];
+    const u32 stride = format.Layout.GetStride();
+    page.VBO->SetSubData(vertices, vertexCount * stride, baseVertex * stride);
+    if (hasPositions) {
+        const u32 positionStride = format.PositionLayout.GetStride();
+        page.PositionVBO->SetSubData(positions, vertexCount * positionStride, baseVertex * positionStride);
+    }
+    if (indexCount > 0) {
+        page.IBO->SetSubData(indices, indexCount, baseIndex);
+    }
+
+    m_Stats.Ranges++;
+    m_Stats.VerticesUsed += vertexCount;
+    m_Stats.IndicesUsed += indexCount;
+
+    return CreateRef<GeometryRange>(shared_from_this(), formatIndex, pageIndex,
+                                    baseVertex, vertexCount, baseIndex, indexCount);
+}
+
+void GeometryPool::Write(const GeometryRange& range, const void* vertices, const u32* indices,
+                         const void* positions) {
+    // Like Free, draws already submitted keep reading the old contents
+    const Format& format = m_Formats[range.m_Format];
+    Page& page = *format.Pages[range.m_Page];
+
+    if (vertices) {
+        const u32 stride = format.Layout.GetStride();
+        page.VBO->SetSubData(vertices, range.m_VertexCount * stride, range.m_BaseVertex * stride);
+    }
+    if (positions && page.PositionVBO) {
+        const u32 positionStride = format.PositionLayout.GetStride();
+        page.PositionVBO->SetSubData(positions, range.m_VertexCount * positionStride,
+                                     range.m_BaseVertex * positionStride);
+    }
+    if (indices && range.m_IndexCount > 0) {
+        page.IBO->SetSubData(indices, range.m_IndexCount, range.m_BaseIndex);
+    }
+}
+
+void GeometryPool::Free(const GeometryRange& range) {
+    // Draws already submitted still see the old contents; GL applies a
+    // later SubData upload into this range after them
+    Page& page = *m_Formats[range.m_Format].Pages[range.m_Page];
+    page.Vertices.Release(range.m_BaseVertex, range.m_VertexCount);
+    page.Indices.Release(range.m_BaseIndex, range.m_IndexCount);
+
+    m_Stats.Ranges--;
+    m_Stats.VerticesUsed -= range.m_VertexCount;
+    m_Stats.IndicesUsed -= range.m_IndexCount;
+}
+
+} // namespace Engine
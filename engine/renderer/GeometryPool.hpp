@@ -0,0 +1,153 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/opengl/GLBuffer.hpp"
+#include "renderer/opengl/GLVertexArray.hpp"
+
+namespace Engine {
+
+class GeometryPool;
+
+// A mesh's vertex and index range inside a GeometryPool page. Indices are
+// local to the mesh: draws add BaseVertex and start at BaseIndex. The range
+// goes back to the pool when the last reference is dropped, so anything
+// still drawing it (MeshComponent) holds one.
+class GeometryRange {
+public:
+    GeometryRange(Ref<GeometryPool> pool, u32 format, u32 page,
+                  u32 baseVertex, u32 vertexCount, u32 baseIndex, u32 indexCount);
+    ~GeometryRange();
+
+    GeometryRange(const GeometryRange&) = delete;
+    GeometryRange& operator=(const GeometryRange&) = delete;
+
+    // Shared by every range of the page
+    const Ref<VertexArray>& GetVertexArray() const { return m_VAO; }
+
+    // Position stream of the page, same base vertex / index. Null when the
+    // range was allocated without positions.
+    const Ref<VertexArray>& GetDepthVertexArray() const { return m_DepthVAO; }
+
+    // The page's vertex buffer and position stream (null without one), for
+    // passes that write vertices on the GPU from GetBaseVertex on
+    const Ref<VertexBuffer>& GetVertexBuffer() const { return m_VBO; }
+    const Ref<VertexBuffer>& GetPositionBuffer() const { return m_PositionVBO; }
+
+    u32 GetBaseVertex() const { return m_BaseVertex; }
+    u32 GetVertexCount() const { return m_VertexCount; }
+    u32 GetBaseIndex() const { return m_BaseIndex; }
+    u32 GetIndexCount() const { return m_IndexCount; }
+
+    // Overwrite the contents with as many vertices (in the range's layout)
+    // and indices as it holds. Null streams keep theirs; positions is
+    // ignored without a depth stream.
+    void Write(const void* vertices, const u32* indices, const void* positions = nullptr);
+
+private:
+    friend class GeometryPool;
+
+    Ref<GeometryPool> m_Pool;
+    Ref<VertexArray> m_VAO;
+    Ref<VertexArray> m_DepthVAO;
+    Ref<VertexBuffer> m_VBO;
+    Ref<VertexBuffer> m_PositionVBO;
+    u32 m_Format = 0;
+    u32 m_Page = 0;
+    u32 m_BaseVertex = 0;
+    u32 m_VertexCount = 0;
+    u32 m_BaseIndex = 0;
+    u32 m_IndexCount = 0;
+};
+
+// GeometryPool - shared vertex / index storage for meshes.
+//
+// Meshes are sub-allocated from a few large pages per vertex format. A page
+// is one vertex buffer, one index buffer and the single VAO reading them, so
+// every mesh in it draws without a VAO switch and IndirectDrawBatcher can
+// issue all of them with one glMultiDrawElementsIndirect. Ranges come from
+// first-fit free lists merged on free; a new page is created only when no
+// existing one has room.
+//
+// A format may add a position-only stream: a second vertex buffer indexed
+// like the first, read by a depth VAO on the same index buffer, so depth
+// passes fetch only positions.
+class GeometryPool : public std::enable_shared_from_this<GeometryPool> {
+public:
+    static constexpr u32 DefaultPageVertices = 1u << 18;   // 14 MB of Mesh Vertex
+    static constexpr u32 DefaultPageIndices = 1u << 20;    // 4 MB
+
+    struct Stats {
+        u32 Formats = 0;
+        u32 Pages = 0;
+        u32 Ranges = 0;
+        u32 VertexCapacity = 0;
+        u32 VerticesUsed = 0;
+        u32 IndexCapacity = 0;
+        u32 IndicesUsed = 0;
+    };
+
+    explicit GeometryPool(u32 pageVertices = DefaultPageVertices, u32 pageIndices = DefaultPageIndices);
+    ~GeometryPool() = default;
+
+    GeometryPool(const GeometryPool&) = delete;
+    GeometryPool& operator=(const GeometryPool&) = delete;
+
+    // Copy vertexCount vertices laid out as layout, and their indices, into
+    // the pool. positions, if given, holds the same vertices in positionLayout
+    // for the depth stream. The pool must be owned by a Ref. Returns nullptr
+    // on failure.
+    Ref<GeometryRange> Allocate(const BufferLayout& layout, const void* vertices, u32 vertexCount,
+                                const u32* indices, u32 indexCount,
+                                const BufferLayout* positionLayout = nullptr, const void* positions = nullptr);
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    friend class GeometryRange;
+
+    static constexpr u32 InvalidOffset = ~0u;
+
+    struct Range {
+        u32 Offset = 0;
+        u32 Count = 0;
+    };
+
+    // Free ranges of one buffer, sorted by offset and merged on free
+    struct RangeList {
+        Vector<Range> Free;
+
+        u32 Allocate(u32 count);
+        void Release(u32 offset, u32 count);
+    };
+
+    struct Page {
+        Ref<VertexBuffer> VBO;
+        Ref<IndexBuffer> IBO;
+        Ref<VertexArray> VAO;
+        Ref<VertexBuffer> PositionVBO;   // Depth stream, if the format has one
+        Ref<VertexArray> DepthVAO;
+        u32 VertexCapacity = 0;
+        u32 IndexCapacity = 0;
+        RangeList Vertices;
+        RangeList Indices;
+    };
+
+    struct Format {
+        BufferLayout Layout;
+        BufferLayout PositionLayout;     // Empty without a depth stream
+        Vector<Scope<Page>> Pages;
+    };
+
+    u32 FindOrAddFormat(const BufferLayout& layout, const BufferLayout& positionLayout);
+    Page& CreatePage(Format& format, u32 minVertices, u32 minIndices);
+    void Write(const GeometryRange& range, const void* vertices, const u32* indices, const void* positions);
+    void Free(const GeometryRange& range);
+
+private:
+    u32 m_PageVertices = 0;
+    u32 m_PageIndices = 0;
+    Vector<Format> m_Formats;
+    Stats m_Stats;
+};
+
+} // namespace Engine
@@ -1,5 +1,7 @@
 #include "GridRenderer.hpp"
 #include "renderer/opengl/GLBuffer.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
 #include "resources/ResourceManager.hpp"
 #include "core/Logger.hpp"
 
@@ -42,38 +44,24 @@ GridRenderer::GridRenderer() {
     LOG_CORE_INFO("GridRenderer initialized");
 }
 
-void GridRenderer::Render(const glm::mat4& viewProjection, const glm::vec3& cameraPos) {
+void GridRenderer::Render() {
     if (!m_Visible || !m_Shader || !m_GridVAO) return;
 
-    // Save state
-    GLboolean depthTest, blend, cullFace;
-    GLint depthFunc;
-    glGetBooleanv(GL_DEPTH_TEST, &depthTest);
-    glGetBooleanv(GL_BLEND, &blend);
-    glGetBooleanv(GL_CULL_FACE, &cullFace);
-    glGetIntegerv(GL_DEPTH_FUNC, &depthFunc);
-
-    // Setup rendering state
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_CULL_FACE);
+    // Put back on return; the cache knows what was set, so no glGet
+    GLStateCache::ScopedState savedState;
+    RenderState overlayState;
+    overlayState.DepthFunc = GL_LEQUAL;
+    overlayState.Blend = true;
+    overlayState.CullFace = false;
+    GLStateCache::Instance().Apply(overlayState);
 
     m_Shader->Bind();
-    m_Shader->SetMat4("u_ViewProjection", viewProjection);
     m_Shader->SetFloat("u_GridSize", m_GridSize);
     m_Shader->SetFloat("u_FadeDistance", m_FadeDistance);
-    m_Shader->SetFloat3("u_CameraPos", cameraPos);
 
     m_GridVAO->Bind();
+    PipelineWarmup::RecordDraw(GL_TRIANGLES);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
-
-    // Restore state
-    if (depthTest) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
-    glDepthFunc(depthFunc);
-    if (blend) glEnable(GL_BLEND); else glDisable(GL_BLEND);
-    if (cullFace) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE);
 }
 
 } // namespace Engine
@@ -12,7 +12,8 @@ public:
     GridRenderer();
     ~GridRenderer() = default;
 
-    void Render(const glm::mat4& viewProjection, const glm::vec3& cameraPos);
+    // Camera from the per-frame camera uniform block
+    void Render();
 
     void SetGridSize(f32 size) { m_GridSize = size; }
     f32 GetGridSize() const { return m_GridSize; }
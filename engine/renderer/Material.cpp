@@ -0,0 +1,430 @@
+#include "renderer/Material.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "resources/ResourceManager.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstring>
+
+namespace Engine {
+
+namespace {
+
+bool HasGLExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (extension && std::strcmp(extension, name) == 0) return true;
+    }
+    return false;
+}
+
+// GL_ARB_bindless_texture entry points; glad is generated without extensions
+struct BindlessAPI {
+    using GetTextureHandleFn = GLuint64 (GLAD_API_PTR*)(GLuint texture);
+    using MakeHandleResidentFn = void (GLAD_API_PTR*)(GLuint64 handle);
+
+    GetTextureHandleFn GetTextureHandle = nullptr;
+    MakeHandleResidentFn MakeResident = nullptr;
+    MakeHandleResidentFn MakeNonResident = nullptr;
+
+    bool IsSupported() const { return GetTextureHandle && MakeResident && MakeNonResident; }
+};
+
+const BindlessAPI& GetBindlessAPI() {
+    static const BindlessAPI api = [] {
+        BindlessAPI result;
+        if (!HasGLExtension("GL_ARB_bindless_texture")) return result;
+
+        result.GetTextureHandle = reinterpret_cast<BindlessAPI::GetTextureHandleFn>(
+            glfwGetProcAddress("glGetTextureHandleARB"));
+        result.MakeResident = reinterpret_cast<BindlessAPI::MakeHandleResidentFn>(
+            glfwGetProcAddress("glMakeTextureHandleResidentARB"));
+        result.MakeNonResident = reinterpret_cast<BindlessAPI::MakeHandleResidentFn>(
+            glfwGetProcAddress("glMakeTextureHandleNonResidentARB"));
+        return result;
+    }();
+    return api;
+}
+
+u64 PackHandle(const glm::uvec2& location) {
+    return static_cast<u64>(location.x) | (static_cast<u64>(location.y) << 32);
+}
+
+constexpr u32 InitialArrayLayers = 8;
+
+} // anonymous namespace
+
+MaterialLibrary& MaterialLibrary::Instance() {
+    static MaterialLibrary instance;
+    return instance;
+}
+
+MaterialLibrary::MaterialLibrary() {
+    // Id 0 stays the default material
+    m_Materials.emplace_back();
+    m_Materials[0].Alive = true;
+    m_Materials[0].Data.Name = "Default";
+}
+
+u32 MaterialLibrary::Create(const Material& material) {
+    u32 id;
+    if (!m_FreeIds.empty()) {
+        id = m_FreeIds.back();
+        m_FreeIds.pop_back();
+    } else {
+        id = static_cast<u32>(m_Materials.size());
+        m_Materials.emplace_back();
+    }
+
+    m_Materials[id].Alive = true;
+    m_Materials[id].Data = Material{};
+    Set(id, material);
+    return id;
+}
+
+void MaterialLibrary::Set(u32 id, const Material& material) {
+    if (id == DefaultMaterial || id >= m_Materials.size() || !m_Materials[id].Alive) {
+        LOG_CORE_WARN("MaterialLibrary: cannot set material {}", id);
+        return;
+    }
+
+    Material& current = m_Materials[id].Data;
+    for (u32 i = 0; i < MaterialMapCount; ++i) {
+        if (material.Maps[i]) AddUser(material.Maps[i]);
+        if (current.Maps[i]) RemoveUser(current.Maps[i].get());
+    }
+
+    current = material;
+    m_DirtyIds.push_back(id);
+}
+
+void MaterialLibrary::Destroy(u32 id) {
+    if (id == DefaultMaterial || id >= m_Materials.size() || !m_Materials[id].Alive) return;
+
+    Slot& slot = m_Materials[id];
+    for (const auto& map : slot.Data.Maps) {
+        if (map) RemoveUser(map.get());
+    }
+    slot.Data = Material{};
+    slot.Alive = false;
+    m_FreeIds.push_back(id);
+    m_DirtyIds.push_back(id);
+}
+
+const Material* MaterialLibrary::Get(u32 id) const {
+    if (id >= m_Materials.size() || !m_Materials[id].Alive) return nullptr;
+    return &m_Materials[id].Data;
+}
+
+u32 MaterialLibrary::Find(const String& name) const {
+    for (u32 id = 1; id < m_Materials.size(); ++id) {
+        if (m_Materials[id].Alive && m_Materials[id].Data.Name == name) return id;
+    }
+    return DefaultMaterial;
+}
+
+void MaterialLibrary::ReportScreenSize(u32 id, f32 screenPixels) {
+    if (id >= m_Materials.size()) return;
+    m_Materials[id].ScreenSize = std::max(m_Materials[id].ScreenSize, screenPixels);
+}
+
+bool MaterialLibrary::IsBindless() const {
+    return GetBindlessAPI().IsSupported();
+}
+
+ShaderDefines MaterialLibrary::GetShaderDefines() const {
+    ShaderDefines defines;
+    if (IsBindless()) {
+        defines.push_back({"BINDLESS_TEXTURES", ""});
+    }
+    return defines;
+}
+
+// Textures
+
+void MaterialLibrary::AddUser(const Ref<Texture2D>& texture) {
+    TextureEntry& entry = m_Textures[texture.get()];
+    if (entry.Users++ == 0) {
+        entry.Texture = texture;
+        Locate(entry, *texture);
+    }
+}
+
+void MaterialLibrary::RemoveUser(const Texture2D* texture) {
+    auto it = m_Textures.find(texture);
+    if (it == m_Textures.end()) return;
+
+    if (--it->second.Users == 0) {
+        Release(it->second);
+        m_Textures.erase(it);
+    }
+}
+
+void MaterialLibrary::Locate(TextureEntry& entry, Texture2D& texture) {
+    entry.RendererID = texture.GetRendererID();
+    entry.ContentVersion = texture.GetContentVersion();
+    entry.Valid = false;
+
+    const BindlessAPI& bindless = GetBindlessAPI();
+    if (bindless.IsSupported()) {
+        // The texture's sampling state is frozen from here on
+        const u64 handle = bindless.GetTextureHandle(entry.RendererID);
+        if (handle == 0) {
+            LOG_CORE_WARN("MaterialLibrary: no bindless handle for {}", texture.GetFilePath());
+            return;
+        }
+        bindless.MakeResident(handle);
+        entry.Location = glm::uvec2(static_cast<u32>(handle), static_cast<u32>(handle >> 32));
+        entry.Valid = true;
+        return;
+    }
+
+    entry.Valid = AllocateLayer(texture, entry.Location);
+}
+
+void MaterialLibrary::Release(TextureEntry& entry) {
+    if (!entry.Valid) return;
+    entry.Valid = false;
+
+    if (GetBindlessAPI().IsSupported()) {
+        // A handle goes away with its texture; only live storage is made non-resident
+        Ref<Texture2D> texture = entry.Texture.lock();
+        if (texture && texture->GetRendererID() == entry.RendererID) {
+            GetBindlessAPI().MakeNonResident(PackHandle(entry.Location));
+        }
+        return;
+    }
+
+    FreeLayer(entry.Location);
+}
+
+bool MaterialLibrary::AllocateLayer(Texture2D& texture, glm::uvec2& location) {
+    const u32 source = texture.GetRendererID();
+
+    GLint internalFormat = 0, width = 0, height = 0, levels = 0;
+    glGetTextureLevelParameteriv(source, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+    glGetTextureLevelParameteriv(source, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTextureLevelParameteriv(source, 0, GL_TEXTURE_HEIGHT, &height);
+    glGetTextureParameteriv(source, GL_TEXTURE_IMMUTABLE_LEVELS, &levels);
+    if (width <= 0 || height <= 0 || levels <= 0) return false;
+
+    u32 slot = 0;
+    for (; slot < m_Arrays.size(); ++slot) {
+        const TextureArray& array = m_Arrays[slot];
+        if (array.InternalFormat == static_cast<u32>(internalFormat) && array.Width == static_cast<u32>(width) &&
+            array.Height == static_cast<u32>(height) && array.Levels == static_cast<u32>(levels)) {
+            break;
+        }
+    }
+
+    if (slot == m_Arrays.size()) {
+        if (m_Arrays.size() >= MaxTextureArrays) {
+            LOG_CORE_WARN("MaterialLibrary: out of texture arrays, {} ({}x{}) is not sampled",
+                          texture.GetFilePath(), width, height);
+            return false;
+        }
+
+        TextureArray array;
+        array.InternalFormat = static_cast<u32>(internalFormat);
+        array.Width = static_cast<u32>(width);
+        array.Height = static_cast<u32>(height);
+        array.Levels = static_cast<u32>(levels);
+        m_Arrays.push_back(array);
+    }
+
+    TextureArray& array = m_Arrays[slot];
+    u32 layer;
+    if (!array.FreeLayers.empty()) {
+        layer = array.FreeLayers.back();
+        array.FreeLayers.pop_back();
+    } else {
+        if (array.NextLayer == array.Capacity && !GrowArray(array)) return false;
+        layer = array.NextLayer++;
+    }
+
+    for (u32 level = 0; level < array.Levels; ++level) {
+        glCopyImageSubData(source, GL_TEXTURE_2D, static_cast<GLint>(level), 0, 0, 0,
+                           array.RendererID, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0,
+                           static_cast<GLint>(layer),
+                           std::max(1u, array.Width >> level), std::max(1u, array.Height >> level), 1);
+    }
+
+    location = glm::uvec2(slot, layer);
+    return true;
+}
+
+void MaterialLibrary::FreeLayer(const glm::uvec2& location) {
+    if (location.x < m_Arrays.size()) {
+        m_Arrays[location.x].FreeLayers.push_back(location.y);
+    }
+}
+
+bool MaterialLibrary::GrowArray(TextureArray& array) {
+    const u32 capacity = array.Capacity == 0 ? InitialArrayLayers : array.Capacity * 2;
+
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    if (capacity > static_cast<u32>(maxLayers)) {
+        LOG_CORE_WARN("MaterialLibrary: texture array of {}x{} is full", array.Width, array.Height);
+        return false;
+    }
+
+    u32 texture = 0;
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &texture);
+    GLMemory::TextureStorage3D(texture, static_cast<GLsizei>(array.Levels), array.InternalFormat,
+                               array.Width, array.Height, capacity, MemoryTag::Resources);
+    glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, array.Levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    if (array.RendererID) {
+        for (u32 level = 0; level < array.Levels; ++level) {
+            glCopyImageSubData(array.RendererID, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, 0,
+                               texture, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, 0,
+                               std::max(1u, array.Width >> level), std::max(1u, array.Height >> level),
+                               static_cast<GLsizei>(array.Capacity));
+        }
+        GLMemory::DeleteTextures(1, &array.RendererID);
+    }
+
+    array.RendererID = texture;
+    array.Capacity = capacity;
+    return true;
+}
+
+// Upload
+
+GPUMaterial MaterialLibrary::Pack(const Material& material) const {
+    GPUMaterial gpu;
+    gpu.BaseColor = material.BaseColor;
+    gpu.Params = glm::vec4(material.Metallic, material.Roughness, material.AO, material.NormalStrength);
+    gpu.Emissive = glm::vec4(material.EmissiveColor * material.EmissiveIntensity, material.EmissiveIntensity);
+    gpu.TilingFactor = material.TilingFactor;
+    gpu.AlphaCutoff = material.Blend == MaterialBlend::Masked ? material.AlphaCutoff : 0.0f;
+
+    for (u32 i = 0; i < MaterialMapCount; ++i) {
+        if (!material.Maps[i] || !material.Maps[i]->IsLoaded()) continue;
+
+        auto it = m_Textures.find(material.Maps[i].get());
+        if (it == m_Textures.end() || !it->second.Valid) continue;
+
+        gpu.Flags |= 1u << i;
+        gpu.Maps[i] = it->second.Location;
+    }
+    return gpu;
+}
+
+void MaterialLibrary::EnsureBufferCapacity(u32 count) {
+    if (m_MaterialSSBO && count <= m_BufferCapacity) return;
+
+    u32 capacity = std::max(m_BufferCapacity, 64u);
+    while (capacity < count) {
+        capacity *= 2;
+    }
+
+    if (m_MaterialSSBO) GLMemory::DeleteBuffers(1, &m_MaterialSSBO);
+    glCreateBuffers(1, &m_MaterialSSBO);
+    GLMemory::BufferStorage(m_MaterialSSBO, capacity * sizeof(GPUMaterial), nullptr, GL_DYNAMIC_STORAGE_BIT,
+                            MemoryTag::Resources);
+    m_BufferCapacity = capacity;
+    m_AllDirty = true;
+}
+
+void MaterialLibrary::Update() {
+    m_Stats.UploadedMaterials = 0;
+
+    // Streaming and async loads give textures new storage; handles and
+    // layers follow it, and every material is repacked. Contents rewritten
+    // in place (hot reload) only need the array layer copied again.
+    const bool bindless = GetBindlessAPI().IsSupported();
+    for (auto& [key, entry] : m_Textures) {
+        Ref<Texture2D> texture = entry.Texture.lock();
+        if (!texture) continue;
+
+        const bool moved = texture->GetRendererID() != entry.RendererID;
+        const bool edited = !bindless && texture->GetContentVersion() != entry.ContentVersion;
+        if (!moved && !edited) continue;
+
+        Release(entry);
+        Locate(entry, *texture);
+        m_AllDirty = true;
+    }
+
+    // Mip requests for streamed maps, scaled by how often they repeat
+    TextureStreamer& streamer = ResourceManager::Instance().GetTextureStreamer();
+    for (Slot& slot : m_Materials) {
+        if (slot.ScreenSize <= 0.0f) continue;
+
+        const f32 tiling = std::max(slot.Data.TilingFactor.x, slot.Data.TilingFactor.y);
+        for (const auto& map : slot.Data.Maps) {
+            if (map) streamer.RequestScreenSize(*map, slot.ScreenSize * tiling);
+        }
+        slot.ScreenSize = 0.0f;
+    }
+
+    const u32 count = static_cast<u32>(m_Materials.size());
+    EnsureBufferCapacity(count);
+
+    // Materials change rarely, so edits go straight into the buffer
+    if (m_AllDirty) {
+        Vector<GPUMaterial> packed(count);
+        for (u32 id = 0; id < count; ++id) {
+            packed[id] = Pack(m_Materials[id].Data);
+        }
+        glNamedBufferSubData(m_MaterialSSBO, 0, count * sizeof(GPUMaterial), packed.data());
+        m_Stats.UploadedMaterials = count;
+    } else {
+        std::sort(m_DirtyIds.begin(), m_DirtyIds.end());
+        m_DirtyIds.erase(std::unique(m_DirtyIds.begin(), m_DirtyIds.end()), m_DirtyIds.end());
+        for (u32 id : m_DirtyIds) {
+            const GPUMaterial packed = Pack(m_Materials[id].Data);
+            glNamedBufferSubData(m_MaterialSSBO, id * sizeof(GPUMaterial), sizeof(GPUMaterial), &packed);
+        }
+        m_Stats.UploadedMaterials = static_cast<u32>(m_DirtyIds.size());
+    }
+    m_AllDirty = false;
+    m_DirtyIds.clear();
+
+    m_Stats.Materials = count - static_cast<u32>(m_FreeIds.size());
+    m_Stats.Textures = static_cast<u32>(m_Textures.size());
+    m_Stats.TextureArrays = static_cast<u32>(m_Arrays.size());
+    m_Stats.Bindless = IsBindless();
+}
+
+void MaterialLibrary::Bind() const {
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, MaterialBufferBinding, m_MaterialSSBO);
+
+    for (u32 slot = 0; slot < m_Arrays.size(); ++slot) {
+        GLStateCache::Instance().BindTextureUnit(FirstArrayUnit + slot, m_Arrays[slot].RendererID);
+    }
+}
+
+void MaterialLibrary::Clear() {
+    for (auto& [key, entry] : m_Textures) {
+        Release(entry);
+    }
+    m_Textures.clear();
+
+    for (auto& array : m_Arrays) {
+        if (array.RendererID) GLMemory::DeleteTextures(1, &array.RendererID);
+    }
+    m_Arrays.clear();
+
+    if (m_MaterialSSBO) GLMemory::DeleteBuffers(1, &m_MaterialSSBO);
+    m_MaterialSSBO = 0;
+    m_BufferCapacity = 0;
+
+    m_Materials.resize(1);
+    m_FreeIds.clear();
+    m_DirtyIds.clear();
+    m_AllDirty = true;
+    m_Stats = Stats{};
+}
+
+} // namespace Engine
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/Texture.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// Texture maps of a material. Map i sets bit i of the shader's texture flags
+// (HAS_ALBEDO, HAS_NORMAL, ... in geometry.glsl).
+enum class MaterialMap : u32 {
+    Albedo = 0,
+    Normal,
+    MetallicRoughness,  // glTF packing: roughness in G, metallic in B
+    AO,
+    Emissive,
+    Count
+};
+
+constexpr u32 MaterialMapCount = static_cast<u32>(MaterialMap::Count);
+
+// How surfaces of a material are drawn. Opaque ones fill the G-Buffer; the
+// others are shaded forward, after deferred lighting, against the same light
+// clusters (see DeferredLightingSystem).
+enum class MaterialBlend : u8 {
+    Opaque,
+    Masked,         // Alpha tested against AlphaCutoff, writes depth
+    Transparent     // Alpha blended, order independent (WeightedBlendedOIT)
+};
+
+struct Material {
+    String Name;
+    glm::vec4 BaseColor{1.0f};      // Multiplied by the instance color
+    f32 Metallic = 0.0f;
+    f32 Roughness = 0.5f;
+    f32 AO = 1.0f;
+    f32 NormalStrength = 1.0f;
+    glm::vec3 EmissiveColor{0.0f};
+    f32 EmissiveIntensity = 0.0f;
+    glm::vec2 TilingFactor{1.0f};
+    MaterialBlend Blend = MaterialBlend::Opaque;
+    f32 AlphaCutoff = 0.5f;         // Masked only: albedo alpha below it is discarded
+    Ref<Texture2D> Maps[MaterialMapCount];
+
+    Ref<Texture2D>& Map(MaterialMap map) { return Maps[static_cast<u32>(map)]; }
+    const Ref<Texture2D>& Map(MaterialMap map) const { return Maps[static_cast<u32>(map)]; }
+};
+
+// Mirrors MaterialData in geometry.glsl (std430)
+struct GPUMaterial {
+    glm::vec4 BaseColor{1.0f};
+    glm::vec4 Params{0.0f, 0.5f, 1.0f, 1.0f};  // Metallic, roughness, AO, normal strength
+    glm::vec4 Emissive{0.0f};                   // Color times intensity, w = intensity
+    glm::vec2 TilingFactor{1.0f};
+    u32 Flags = 0;                              // Bit per map present
+    f32 AlphaCutoff = 0.0f;                     // 0 unless masked
+    glm::uvec2 Maps[MaterialMapCount] = {};     // Bindless handle, or texture array slot and layer
+    glm::uvec2 Padding1{0u, 0u};
+};
+static_assert(sizeof(GPUMaterial) % 16 == 0, "GPUMaterial must match std430 array stride");
+
+// MaterialLibrary - every material's parameters and textures in one SSBO.
+//
+// MaterialComponent::MaterialId indexes the library; the geometry pass
+// writes it into InstanceData::MaterialIndex and shaders fetch the material
+// from the buffer, so a multi-draw over many textured materials binds
+// nothing per draw. Textures are reached through GL_ARB_bindless_texture
+// handles where the driver has it. Otherwise each texture is copied into a
+// layer of a texture array shared by every texture with the same size,
+// format and mip count, and the material stores the array slot and layer;
+// up to MaxTextureArrays arrays are bound for the whole pass.
+//
+// Id 0 is reserved: no maps, and shaders take color and parameters from
+// the instance as before. GL thread only.
+class MaterialLibrary {
+public:
+    static constexpr u32 DefaultMaterial = 0;
+    static constexpr u32 MaterialBufferBinding = 11;   // std430 binding point
+    static constexpr u32 FirstArrayUnit = 8;           // Fallback arrays bind to 8..15
+    static constexpr u32 MaxTextureArrays = 8;         // Must match geometry.glsl
+
+    struct Stats {
+        u32 Materials = 0;
+        u32 Textures = 0;
+        u32 TextureArrays = 0;      // Fallback only
+        u32 UploadedMaterials = 0;  // Last Update()
+        bool Bindless = false;
+    };
+
+    static MaterialLibrary& Instance();
+
+    MaterialLibrary(const MaterialLibrary&) = delete;
+    MaterialLibrary& operator=(const MaterialLibrary&) = delete;
+
+    // Returns the new material's id
+    u32 Create(const Material& material);
+    void Set(u32 id, const Material& material);
+    void Destroy(u32 id);
+
+    // Null for unknown or destroyed ids
+    const Material* Get(u32 id) const;
+    bool Contains(u32 id) const { return Get(id) != nullptr; }
+
+    // Id of the first material called name, DefaultMaterial if none
+    u32 Find(const String& name) const;
+
+    // Largest size in pixels anything drawn with id covered this frame;
+    // Update() turns it into mip requests for the material's streamed maps
+    void ReportScreenSize(u32 id, f32 screenPixels);
+
+    // Pick up textures whose storage changed and upload edited materials.
+    // Call once a frame before the passes that Bind().
+    void Update();
+
+    // Material buffer, and the texture arrays without bindless support
+    void Bind() const;
+
+    // Whether maps are bindless handles; geometry shaders are built with
+    // GetShaderDefines() to match
+    bool IsBindless() const;
+    ShaderDefines GetShaderDefines() const;
+
+    // Release GL objects and forget every material (the GL context must
+    // still exist)
+    void Clear();
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    MaterialLibrary();
+    ~MaterialLibrary() = default;
+
+    // Where a texture lives for the shaders
+    struct TextureEntry {
+        WeakRef<Texture2D> Texture;
+        u32 RendererID = 0;         // Storage the handle / layer was made from
+        u32 ContentVersion = 0;     // Texture contents the layer was copied from
+        glm::uvec2 Location{0u, 0u};  // Handle, or (array slot, layer)
+        bool Valid = false;
+        u32 Users = 0;              // Material maps referencing it
+    };
+
+    // Fallback array of textures sharing size, format and mip count
+    struct TextureArray {
+        u32 RendererID = 0;
+        u32 InternalFormat = 0;
+        u32 Width = 0;
+        u32 Height = 0;
+        u32 Levels = 0;
+        u32 Capacity = 0;
+        Vector<u32> FreeLayers;
+        u32 NextLayer = 0;
+    };
+
+    struct Slot {
+        Material Data;
+        bool Alive = false;
+        f32 ScreenSize = 0.0f;      // This frame's ReportScreenSize
+    };
+
+    void AddUser(const Ref<Texture2D>& texture);
+    void RemoveUser(const Texture2D* texture);
+    void Locate(TextureEntry& entry, Texture2D& texture);
+    void Release(TextureEntry& entry);
+
+    bool AllocateLayer(Texture2D& texture, glm::uvec2& location);
+    void FreeLayer(const glm::uvec2& location);
+    bool GrowArray(TextureArray& array);
+
+    GPUMaterial Pack(const Material& material) const;
+    void EnsureBufferCapacity(u32 count);
+
+private:
+    Vector<Slot> m_Materials;
+    Vector<u32> m_FreeIds;
+    Vector<u32> m_DirtyIds;
+    bool m_AllDirty = true;
+
+    HashMap<const Texture2D*, TextureEntry> m_Textures;
+    Vector<TextureArray> m_Arrays;
+
+    u32 m_MaterialSSBO = 0;
+    u32 m_BufferCapacity = 0;
+
+    Stats m_Stats;
+};
+
+} // namespace Engine
@@ -1,16 +1,163 @@
 #include "renderer/Mesh.hpp"
+#include "renderer/MeshletBuilder.hpp"
+#include "renderer/MeshOptimizer.hpp"
+#include "renderer/MeshSimplifier.hpp"
+#include "math/MeshKernels.hpp"
+#include "core/JobSystem.hpp"
 #include "core/Logger.hpp"
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <limits>
 
 namespace Engine {
 
+namespace {
+
+// Octahedral mapping of a unit vector to [-1, 1]^2
+glm::vec2 EncodeOctahedral(const glm::vec3& v) {
+    f32 sum = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+    if (sum <= 0.0f) return glm::vec2(0.0f);
+
+    glm::vec3 n = v / sum;
+    if (n.z < 0.0f) {
+        glm::vec2 folded((1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+                         (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f));
+        return folded;
+    }
+    return glm::vec2(n.x, n.y);
+}
+
+i16 PackSnorm(f32 value) {
+    return static_cast<i16>(glm::packSnorm1x16(value));
+}
+
+std::atomic<MeshResidency> s_DefaultResidency{MeshResidency::KeepCPU};
+
+// Collision positions quantized to their bounds with one scale for all
+// axes, as PrepareVertexData packs them. position(i) is vertex i's.
+template<typename GetPosition>
+void QuantizeCollisionPositions(MeshCollisionData& collision, usize count, GetPosition position) {
+    glm::vec3 min(std::numeric_limits<f32>::max());
+    glm::vec3 max(std::numeric_limits<f32>::lowest());
+    for (usize i = 0; i < count; ++i) {
+        min = glm::min(min, position(i));
+        max = glm::max(max, position(i));
+    }
+    const glm::vec3 size = max - min;
+    f32 scale = std::max(size.x, std::max(size.y, size.z));
+    if (scale <= 0.0f) scale = 1.0f;
+    collision.Dequant = glm::vec4(min, scale);
+
+    const f32 invScale = 1.0f / scale;
+    collision.Positions.resize(count * 3);
+    for (usize i = 0; i < count; ++i) {
+        const glm::vec3 unorm = glm::clamp((position(i) - min) * invScale, 0.0f, 1.0f);
+        collision.Positions[i * 3 + 0] = glm::packUnorm1x16(unorm.x);
+        collision.Positions[i * 3 + 1] = glm::packUnorm1x16(unorm.y);
+        collision.Positions[i * 3 + 2] = glm::packUnorm1x16(unorm.z);
+    }
+}
+
+// Vertices / triangles per job in the Recalculate* passes
+constexpr u32 RecalculateGrain = 16384;
+
+// func(first, last) over [0, count), split over the job system when it runs
+template<typename Func>
+void ParallelRange(usize count, Func&& func) {
+    if (JobSystem::IsInitialized()) {
+        JobSystem::ParallelFor(static_cast<u32>(count), RecalculateGrain, func);
+    } else if (count > 0) {
+        func(0u, static_cast<u32>(count));
+    }
+}
+
+// Vertex attributes as SoA streams for MeshKernels
+struct VertexStreams {
+    Vector<f32> X, Y, Z, U, V;
+
+    VertexStreams(const Vector<Vertex>& vertices, bool texCoords) {
+        const usize count = vertices.size();
+        X.resize(count);
+        Y.resize(count);
+        Z.resize(count);
+        if (texCoords) {
+            U.resize(count);
+            V.resize(count);
+        }
+
+        ParallelRange(count, [&](u32 first, u32 last) {
+            for (u32 i = first; i < last; ++i) {
+                X[i] = vertices[i].Position.x;
+                Y[i] = vertices[i].Position.y;
+                Z[i] = vertices[i].Position.z;
+            }
+            if (texCoords) {
+                for (u32 i = first; i < last; ++i) {
+                    U[i] = vertices[i].TexCoords.x;
+                    V[i] = vertices[i].TexCoords.y;
+                }
+            }
+        });
+    }
+
+    TriangleStreams View(const u32* indices) const {
+        return {X.data(), Y.data(), Z.data(), U.data(), V.data(), indices};
+    }
+};
+
+TriangleStreams OffsetTriangles(TriangleStreams triangles, usize first) {
+    triangles.Indices += first * 3;
+    return triangles;
+}
+
+TriangleVectors OffsetVectors(TriangleVectors vectors, usize first) {
+    return {vectors.X + first, vectors.Y + first, vectors.Z + first};
+}
+
+// X, Y and Z streams of count vectors back to back in storage
+TriangleVectors SplitVectors(Vector<f32>& storage, usize count) {
+    return {storage.data(), storage.data() + count, storage.data() + count * 2};
+}
+
+// Triangles using each vertex, ascending: vertex v's are
+// Triangles[Offsets[v] .. Offsets[v + 1]), once per corner it fills
+struct VertexTriangles {
+    Vector<u32> Offsets;
+    Vector<u32> Triangles;
+};
+
+VertexTriangles BuildVertexTriangles(const u32* indices, usize triangleCount, usize vertexCount) {
+    VertexTriangles adjacency;
+    adjacency.Offsets.assign(vertexCount + 1, 0);
+    for (usize i = 0; i < triangleCount * 3; ++i) {
+        adjacency.Offsets[indices[i] + 1]++;
+    }
+    for (usize v = 0; v < vertexCount; ++v) {
+        adjacency.Offsets[v + 1] += adjacency.Offsets[v];
+    }
+
+    adjacency.Triangles.resize(triangleCount * 3);
+    Vector<u32> cursor(adjacency.Offsets.begin(), adjacency.Offsets.end() - 1);
+    for (usize i = 0; i < triangleCount * 3; ++i) {
+        adjacency.Triangles[cursor[indices[i]]++] = static_cast<u32>(i / 3);
+    }
+    return adjacency;
+}
+
+} // anonymous namespace
+
 Mesh::Mesh(const Vector<Vertex>& vertices, const Vector<u32>& indices)
-    : m_Vertices(vertices), m_Indices(indices) {
+    : m_Vertices(vertices), m_Indices(indices)
+    , m_VertexCount(static_cast<u32>(m_Vertices.size())), m_IndexCount(static_cast<u32>(m_Indices.size())) {
     RecalculateBounds();
 }
 
 Mesh::Mesh(Vector<Vertex>&& vertices, Vector<u32>&& indices)
-    : m_Vertices(std::move(vertices)), m_Indices(std::move(indices)) {
+    : m_Vertices(std::move(vertices)), m_Indices(std::move(indices))
+    , m_VertexCount(static_cast<u32>(m_Vertices.size())), m_IndexCount(static_cast<u32>(m_Indices.size())) {
     RecalculateBounds();
 }
 
@@ -20,158 +167,600 @@ void Mesh::Upload() {
         return;
     }
 
+    Vector<PackedVertex> packed;
+    Vector<u8> positions;
+    Upload(GetGPUData(packed, positions));
+}
+
+void Mesh::Upload(const Ref<GeometryPool>& pool) {
+    if (m_Vertices.empty()) {
+        LOG_CORE_WARN("Attempting to upload empty mesh");
+        return;
+    }
+
+    Vector<PackedVertex> packed;
+    Vector<u8> positions;
+    Upload(GetGPUData(packed, positions), pool);
+}
+
+void Mesh::Upload(const MeshGPUData& data, const Ref<GeometryPool>& pool) {
+    if (!data.Vertices || data.VertexCount == 0) {
+        LOG_CORE_WARN("Attempting to upload empty mesh");
+        return;
+    }
+
+    m_VertexFormat = data.Format;
+    m_PositionDequant = data.PositionDequant;
+    m_DepthStream = data.Positions != nullptr;
+    m_VertexCount = data.VertexCount;
+    m_IndexCount = data.Indices ? data.IndexCount : 0;
+    SetLODs(data);
+
+    const BufferLayout layout = GetLayout(m_VertexFormat);
+    const BufferLayout positionLayout = GetPositionLayout(m_VertexFormat);
+
+    if (pool) {
+        auto geometry = pool->Allocate(layout, data.Vertices, m_VertexCount, data.Indices, m_IndexCount,
+                                       m_DepthStream ? &positionLayout : nullptr, data.Positions);
+        if (geometry) {
+            m_Geometry = std::move(geometry);
+            m_VAO = m_Geometry->GetVertexArray();
+            m_DepthVAO = m_Geometry->GetDepthVertexArray();
+            m_VBO.reset();
+            m_IBO.reset();
+            m_PositionVBO.reset();
+
+            m_Evicted = false;
+            ApplyResidency(data);
+
+            LOG_CORE_INFO("Uploaded mesh '{}' to geometry pool: {} vertices at {}, {} indices at {}",
+                          m_Name.empty() ? "unnamed" : m_Name,
+                          m_VertexCount, m_Geometry->GetBaseVertex(),
+                          m_IndexCount, m_Geometry->GetBaseIndex());
+            return;
+        }
+
+        LOG_CORE_WARN("Mesh '{}' not pooled, uploading to its own buffers",
+                      m_Name.empty() ? "unnamed" : m_Name);
+    }
+
+    m_Geometry.reset();
     m_VAO = CreateRef<VertexArray>();
 
     m_VBO = CreateRef<VertexBuffer>(
-        reinterpret_cast<const f32*>(m_Vertices.data()),
-        static_cast<u32>(m_Vertices.size() * sizeof(Vertex))
+        static_cast<const f32*>(data.Vertices),
+        m_VertexCount * layout.GetStride()
     );
-    m_VBO->SetLayout(GetDefaultLayout());
+    m_VBO->SetLayout(layout);
 
     m_VAO->AddVertexBuffer(m_VBO);
 
-    if (!m_Indices.empty()) {
-        m_IBO = CreateRef<IndexBuffer>(
-            m_Indices.data(),
-            static_cast<u32>(m_Indices.size())
-        );
+    m_IBO.reset();
+    if (m_IndexCount > 0) {
+        m_IBO = CreateRef<IndexBuffer>(data.Indices, m_IndexCount);
         m_VAO->SetIndexBuffer(m_IBO);
     }
 
+    m_PositionVBO.reset();
+    m_DepthVAO.reset();
+    if (m_DepthStream) {
+        m_PositionVBO = CreateRef<VertexBuffer>(
+            static_cast<const f32*>(data.Positions),
+            m_VertexCount * positionLayout.GetStride()
+        );
+        m_PositionVBO->SetLayout(positionLayout);
+
+        m_DepthVAO = CreateRef<VertexArray>();
+        m_DepthVAO->AddVertexBuffer(m_PositionVBO);
+        if (m_IBO) {
+            m_DepthVAO->SetIndexBuffer(m_IBO);
+        }
+    }
+
+    m_Evicted = false;
+    ApplyResidency(data);
+
     LOG_CORE_INFO("Uploaded mesh '{}': {} vertices, {} indices",
                   m_Name.empty() ? "unnamed" : m_Name,
-                  m_Vertices.size(), m_Indices.size());
+                  m_VertexCount, m_IndexCount);
 }
 
-void Mesh::Bind() const {
-    if (m_VAO) {
-        m_VAO->Bind();
+bool Mesh::CanUploadInPlace(const MeshGPUData& data) const {
+    if (!m_Geometry || !data.Vertices) return false;
+
+    return data.Format == m_VertexFormat &&
+           data.VertexCount == m_Geometry->GetVertexCount() &&
+           (data.Indices ? data.IndexCount : 0) == m_Geometry->GetIndexCount() &&
+           (data.Positions != nullptr) == (m_Geometry->GetDepthVertexArray() != nullptr);
+}
+
+void Mesh::UploadInPlace(const MeshGPUData& data, const Ref<GeometryRange>& range) {
+    if (!range) {
+        LOG_CORE_ERROR("Mesh '{}' has no pooled range to upload into", m_Name);
+        return;
     }
+
+    m_VertexFormat = data.Format;
+    m_PositionDequant = data.PositionDequant;
+    m_DepthStream = range->GetDepthVertexArray() != nullptr;
+    m_VertexCount = range->GetVertexCount();
+    m_IndexCount = range->GetIndexCount();
+    SetLODs(data);
+
+    range->Write(data.Vertices, data.Indices, data.Positions);
+
+    m_Geometry = range;
+    m_VAO = m_Geometry->GetVertexArray();
+    m_DepthVAO = m_Geometry->GetDepthVertexArray();
+    m_VBO.reset();
+    m_IBO.reset();
+    m_PositionVBO.reset();
+    m_Evicted = false;
+    ApplyResidency(data);
 }
 
-void Mesh::Unbind() const {
-    if (m_VAO) {
-        m_VAO->Unbind();
+void Mesh::Evict() {
+    if (!IsUploaded()) return;
+
+    // A pooled range goes back to the pool once the last draw holding it is done
+    m_VAO.reset();
+    m_VBO.reset();
+    m_IBO.reset();
+    m_PositionVBO.reset();
+    m_DepthVAO.reset();
+    m_Geometry.reset();
+    m_Evicted = true;
+}
+
+void Mesh::SetResidency(MeshResidency residency) {
+    m_Residency = residency;
+    if (IsUploaded()) {
+        ApplyResidency(MeshGPUData{});
     }
 }
 
-void Mesh::RecalculateBounds() {
-    if (m_Vertices.empty()) {
-        m_Bounds = AABB();
-        m_BoundingSphere = BoundingSphere();
+void Mesh::SetDefaultResidency(MeshResidency residency) {
+    s_DefaultResidency.store(residency, std::memory_order_relaxed);
+}
+
+MeshResidency Mesh::GetDefaultResidency() {
+    return s_DefaultResidency.load(std::memory_order_relaxed);
+}
+
+void Mesh::ApplyResidency(const MeshGPUData& data) {
+    if (m_Residency == MeshResidency::KeepCPU) return;
+
+    if (m_Residency == MeshResidency::Collision) {
+        // From the CPU copy when there is one, else from the uploaded streams;
+        // with neither (an in-place upload of unchanged vertices) the
+        // previous collision data stays
+        const u32 lod0Count = GetIndexCount();
+        if (!m_Vertices.empty() && m_Indices.size() >= lod0Count) {
+            QuantizeCollisionPositions(m_Collision, m_Vertices.size(),
+                                       [this](usize i) { return m_Vertices[i].Position; });
+            m_Collision.Indices.assign(m_Indices.begin(), m_Indices.begin() + lod0Count);
+        } else if (data.Vertices && data.Indices && data.IndexCount >= lod0Count) {
+            if (data.Format == VertexFormat::Full) {
+                const auto* vertices = static_cast<const Vertex*>(data.Vertices);
+                QuantizeCollisionPositions(m_Collision, data.VertexCount,
+                                           [vertices](usize i) { return vertices[i].Position; });
+            } else {
+                // Already quantized to the bounds, with the same dequantization
+                const auto* vertices = static_cast<const PackedVertex*>(data.Vertices);
+                m_Collision.Positions.resize(static_cast<usize>(data.VertexCount) * 3);
+                for (usize i = 0; i < data.VertexCount; ++i) {
+                    std::memcpy(&m_Collision.Positions[i * 3], vertices[i].Position, 3 * sizeof(u16));
+                }
+                m_Collision.Dequant = data.PositionDequant;
+            }
+            m_Collision.Indices.assign(data.Indices, data.Indices + lod0Count);
+        }
+    }
+
+    Vector<Vertex>().swap(m_Vertices);
+    Vector<u32>().swap(m_Indices);
+}
+
+usize Mesh::GetCPUMemorySize() const {
+    return m_Vertices.capacity() * sizeof(Vertex) + m_Indices.capacity() * sizeof(u32) +
+           m_Collision.GetMemorySize();
+}
+
+usize Mesh::GetGPUMemorySize() const {
+    if (!IsUploaded()) return 0;
+
+    usize bytes = static_cast<usize>(m_VertexCount) * GetLayout(m_VertexFormat).GetStride() +
+                  static_cast<usize>(m_IndexCount) * sizeof(u32);
+    if (m_DepthVAO) {
+        bytes += static_cast<usize>(m_VertexCount) * GetPositionLayout(m_VertexFormat).GetStride();
+    }
+    return bytes;
+}
+
+MeshGPUData Mesh::GetGPUData(Vector<PackedVertex>& packed, Vector<u8>& positions) {
+    MeshGPUData data;
+    data.Format = m_VertexFormat;
+    data.Vertices = PrepareVertexData(packed);
+    data.VertexCount = static_cast<u32>(m_Vertices.size());
+    data.Indices = m_Indices.empty() ? nullptr : m_Indices.data();
+    data.IndexCount = static_cast<u32>(m_Indices.size());
+    data.LODs = m_LODs.empty() ? nullptr : m_LODs.data();
+    data.LODCount = static_cast<u32>(m_LODs.size());
+    data.PositionDequant = m_PositionDequant;
+
+    if (m_DepthStream) {
+        PreparePositionData(data.Vertices, positions);
+        data.Positions = positions.data();
+    }
+    return data;
+}
+
+void Mesh::SetLODs(const MeshGPUData& data) {
+    // data may be this mesh's own GetGPUData
+    if (data.LODs == m_LODs.data()) return;
+
+    m_LODs.clear();
+    for (u32 i = 0; i < data.LODCount; ++i) {
+        const MeshLOD& lod = data.LODs[i];
+        if (lod.IndexOffset > m_IndexCount || lod.IndexCount > m_IndexCount - lod.IndexOffset) {
+            LOG_CORE_WARN("Mesh '{}': LOD {} is outside the index buffer, dropping LODs", m_Name, i);
+            m_LODs.clear();
+            return;
+        }
+        m_LODs.push_back(lod);
+    }
+}
+
+void Mesh::AddLOD(const Vector<u32>& indices, f32 error) {
+    if (m_Indices.empty()) {
+        LOG_CORE_WARN("Mesh '{}': LODs need the CPU index copy", m_Name);
         return;
     }
+    if (m_LODs.empty()) {
+        m_LODs.push_back({0, static_cast<u32>(m_Indices.size()), 0.0f});
+    }
 
-    glm::vec3 minPoint(std::numeric_limits<float>::max());
-    glm::vec3 maxPoint(std::numeric_limits<float>::lowest());
+    MeshLOD lod;
+    lod.IndexOffset = static_cast<u32>(m_Indices.size());
+    lod.IndexCount = static_cast<u32>(indices.size());
+    lod.Error = error;
+    m_LODs.push_back(lod);
+
+    m_Indices.insert(m_Indices.end(), indices.begin(), indices.end());
+    m_IndexCount = static_cast<u32>(m_Indices.size());
+}
 
-    for (const auto& vertex : m_Vertices) {
-        minPoint = glm::min(minPoint, vertex.Position);
-        maxPoint = glm::max(maxPoint, vertex.Position);
+u32 Mesh::GenerateLODs(u32 levels, f32 reduction) {
+    if (m_Vertices.empty() || m_Indices.empty()) {
+        LOG_CORE_WARN("Mesh '{}': LODs need the CPU vertex and index copy", m_Name);
+        return 0;
     }
 
-    m_Bounds = AABB(minPoint, maxPoint);
+    // Start over from LOD 0
+    const u32 baseCount = GetIndexCount();
+    m_Indices.resize(baseCount);
+    m_IndexCount = baseCount;
+    m_LODs.clear();
 
-    glm::vec3 center = m_Bounds.GetCenter();
-    float maxDistSq = 0.0f;
-    for (const auto& vertex : m_Vertices) {
-        float distSq = glm::dot(vertex.Position - center, vertex.Position - center);
-        maxDistSq = std::max(maxDistSq, distSq);
+    Vector<glm::vec3> positions(m_Vertices.size());
+    for (usize i = 0; i < m_Vertices.size(); ++i) {
+        positions[i] = m_Vertices[i].Position;
     }
-    m_BoundingSphere.Center = center;
-    m_BoundingSphere.Radius = std::sqrt(maxDistSq);
+    const f32 radius = std::max(m_BoundingSphere.Radius, 1e-6f);
+
+    Vector<u32> simplified;
+    u32 previousCount = baseCount;
+    f32 previousError = 0.0f;
+    f32 target = static_cast<f32>(baseCount);
+    for (u32 level = 1; level <= levels; ++level) {
+        target *= reduction;
+        const u32 targetCount = static_cast<u32>(target) / 3 * 3;
+        if (targetCount < 3) break;
+
+        // Each level from LOD 0, so errors don't compound
+        const f32 error = MeshSimplifier::Simplify(positions, m_Indices.data(), baseCount, targetCount, simplified);
+
+        // Stalled: nothing left to remove without dropping the last triangles
+        if (simplified.empty() || simplified.size() * 10 >= static_cast<usize>(previousCount) * 9) break;
+
+        // Selection assumes coarser levels never look better
+        previousError = std::max(error / radius, previousError);
+        AddLOD(simplified, previousError);
+        previousCount = static_cast<u32>(simplified.size());
+    }
+
+    return GetLODCount() - 1;
 }
 
-void Mesh::RecalculateNormals() {
-    for (auto& vertex : m_Vertices) {
-        vertex.Normal = glm::vec3(0.0f);
+const MeshOptimizeStats& Mesh::Optimize() {
+    if (m_Vertices.empty() || m_Indices.empty()) {
+        LOG_CORE_WARN("Mesh '{}': optimizing needs the CPU vertex and index copy", m_Name);
+        return m_OptimizeStats;
     }
 
-    for (size_t i = 0; i + 2 < m_Indices.size(); i += 3) {
-        u32 i0 = m_Indices[i];
-        u32 i1 = m_Indices[i + 1];
-        u32 i2 = m_Indices[i + 2];
+    const auto startTime = std::chrono::steady_clock::now();
+    const u32 vertexCount = static_cast<u32>(m_Vertices.size());
+    const u32 lod0Count = GetIndexCount();
+
+    const auto before = MeshOptimizer::AnalyzeVertexCache(m_Indices.data(), lod0Count, vertexCount);
 
-        glm::vec3 v0 = m_Vertices[i0].Position;
-        glm::vec3 v1 = m_Vertices[i1].Position;
-        glm::vec3 v2 = m_Vertices[i2].Position;
+    Vector<glm::vec3> positions(vertexCount);
+    for (u32 i = 0; i < vertexCount; ++i) {
+        positions[i] = m_Vertices[i].Position;
+    }
 
-        glm::vec3 edge1 = v1 - v0;
-        glm::vec3 edge2 = v2 - v0;
-        glm::vec3 normal = glm::cross(edge1, edge2);
+    // Triangles only move within their range, so submesh and LOD ranges
+    // stay valid
+    auto optimizeRange = [&](u32 first, u32 count, u32 baseVertex) {
+        if (count < 6 || baseVertex >= vertexCount) return;
+        u32* indices = m_Indices.data() + first;
+        MeshOptimizer::OptimizeVertexCache(indices, count, vertexCount - baseVertex);
+        MeshOptimizer::OptimizeOverdraw(indices, count, positions.data() + baseVertex, vertexCount - baseVertex);
+    };
 
-        m_Vertices[i0].Normal += normal;
-        m_Vertices[i1].Normal += normal;
-        m_Vertices[i2].Normal += normal;
+    bool baseVertexRanges = false;
+    if (m_SubMeshes.empty()) {
+        optimizeRange(0, lod0Count, 0);
+    } else {
+        for (const SubMesh& submesh : m_SubMeshes) {
+            optimizeRange(submesh.BaseIndex, submesh.IndexCount, submesh.BaseVertex);
+            baseVertexRanges = baseVertexRanges || submesh.BaseVertex != 0;
+        }
+    }
+    for (u32 level = 1; level < static_cast<u32>(m_LODs.size()); ++level) {
+        optimizeRange(m_LODs[level].IndexOffset, m_LODs[level].IndexCount, 0);
     }
 
-    for (auto& vertex : m_Vertices) {
-        float len = glm::length(vertex.Normal);
-        if (len > 0.0f) {
-            vertex.Normal /= len;
+    // Renumbering would break submeshes that offset their indices
+    if (!baseVertexRanges) {
+        Vector<u32> remap;
+        MeshOptimizer::OptimizeVertexFetch(m_Indices.data(), m_IndexCount, vertexCount, remap);
+
+        Vector<Vertex> vertices(vertexCount);
+        for (u32 i = 0; i < vertexCount; ++i) {
+            vertices[remap[i]] = m_Vertices[i];
+        }
+        m_Vertices = std::move(vertices);
+        for (u32& index : m_Indices) {
+            index = remap[index];
         }
     }
+
+    const auto after = MeshOptimizer::AnalyzeVertexCache(m_Indices.data(), lod0Count, vertexCount);
+
+    m_OptimizeStats.ACMRBefore = before.ACMR;
+    m_OptimizeStats.ACMRAfter = after.ACMR;
+    m_OptimizeStats.ATVRBefore = before.ATVR;
+    m_OptimizeStats.ATVRAfter = after.ATVR;
+    m_OptimizeStats.Milliseconds = std::chrono::duration<f32, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    m_OptimizeStats.Optimized = true;
+
+    LOG_CORE_TRACE("Mesh '{}': ACMR {:.3f} -> {:.3f} in {:.2f} ms", m_Name,
+                   before.ACMR, after.ACMR, m_OptimizeStats.Milliseconds);
+
+    // The old runs no longer match the triangle order
+    if (!m_Meshlets.empty()) {
+        BuildMeshlets();
+    }
+    return m_OptimizeStats;
 }
 
-void Mesh::RecalculateTangents() {
-    for (auto& vertex : m_Vertices) {
-        vertex.Tangent = glm::vec3(0.0f);
-        vertex.Bitangent = glm::vec3(0.0f);
+u32 Mesh::BuildMeshlets(u32 maxVertices, u32 maxTriangles) {
+    m_Meshlets.clear();
+    if (m_Vertices.empty() || m_Indices.empty()) {
+        LOG_CORE_WARN("Mesh '{}': meshlets need the CPU vertex and index copy", m_Name);
+        return 0;
+    }
+    for (const SubMesh& submesh : m_SubMeshes) {
+        if (submesh.BaseVertex != 0) {
+            LOG_CORE_WARN("Mesh '{}': meshlets can't span submeshes with a base vertex", m_Name);
+            return 0;
+        }
     }
 
-    for (size_t i = 0; i + 2 < m_Indices.size(); i += 3) {
-        u32 i0 = m_Indices[i];
-        u32 i1 = m_Indices[i + 1];
-        u32 i2 = m_Indices[i + 2];
+    Vector<glm::vec3> positions(m_Vertices.size());
+    for (usize i = 0; i < m_Vertices.size(); ++i) {
+        positions[i] = m_Vertices[i].Position;
+    }
+    MeshletBuilder::Build(positions, m_Indices.data(), GetIndexCount(), m_Meshlets, maxVertices, maxTriangles);
+    return static_cast<u32>(m_Meshlets.size());
+}
 
-        Vertex& v0 = m_Vertices[i0];
-        Vertex& v1 = m_Vertices[i1];
-        Vertex& v2 = m_Vertices[i2];
+void Mesh::Bind() const {
+    if (m_VAO) {
+        m_VAO->Bind();
+    }
+}
 
-        glm::vec3 edge1 = v1.Position - v0.Position;
-        glm::vec3 edge2 = v2.Position - v0.Position;
+void Mesh::Unbind() const {
+    if (m_VAO) {
+        m_VAO->Unbind();
+    }
+}
 
-        glm::vec2 deltaUV1 = v1.TexCoords - v0.TexCoords;
-        glm::vec2 deltaUV2 = v2.TexCoords - v0.TexCoords;
+void Mesh::RecalculateBounds() {
+    if (m_Vertices.empty()) {
+        m_Bounds = AABB();
+        m_BoundingSphere = BoundingSphere();
+        return;
+    }
 
-        float det = deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y;
-        if (std::abs(det) < 1e-6f) {
-            continue;
+    // Per-chunk extremes, reduced in chunk order
+    const usize chunkCount = (m_Vertices.size() + RecalculateGrain - 1) / RecalculateGrain;
+    Vector<glm::vec3> chunkMin(chunkCount, glm::vec3(std::numeric_limits<float>::max()));
+    Vector<glm::vec3> chunkMax(chunkCount, glm::vec3(std::numeric_limits<float>::lowest()));
+    ParallelRange(m_Vertices.size(), [&](u32 first, u32 last) {
+        glm::vec3 minPoint = chunkMin[first / RecalculateGrain];
+        glm::vec3 maxPoint = chunkMax[first / RecalculateGrain];
+        for (u32 v = first; v < last; ++v) {
+            minPoint = glm::min(minPoint, m_Vertices[v].Position);
+            maxPoint = glm::max(maxPoint, m_Vertices[v].Position);
         }
-        float f = 1.0f / det;
-
-        glm::vec3 tangent;
-        tangent.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-        tangent.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-        tangent.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
+        chunkMin[first / RecalculateGrain] = minPoint;
+        chunkMax[first / RecalculateGrain] = maxPoint;
+    });
 
-        glm::vec3 bitangent;
-        bitangent.x = f * (-deltaUV2.x * edge1.x + deltaUV1.x * edge2.x);
-        bitangent.y = f * (-deltaUV2.x * edge1.y + deltaUV1.x * edge2.y);
-        bitangent.z = f * (-deltaUV2.x * edge1.z + deltaUV1.x * edge2.z);
+    glm::vec3 minPoint(std::numeric_limits<float>::max());
+    glm::vec3 maxPoint(std::numeric_limits<float>::lowest());
+    for (usize c = 0; c < chunkCount; ++c) {
+        minPoint = glm::min(minPoint, chunkMin[c]);
+        maxPoint = glm::max(maxPoint, chunkMax[c]);
+    }
+    m_Bounds = AABB(minPoint, maxPoint);
 
-        v0.Tangent += tangent;
-        v1.Tangent += tangent;
-        v2.Tangent += tangent;
+    const glm::vec3 center = m_Bounds.GetCenter();
+    Vector<float> chunkDistSq(chunkCount, 0.0f);
+    ParallelRange(m_Vertices.size(), [&](u32 first, u32 last) {
+        float maxDistSq = 0.0f;
+        for (u32 v = first; v < last; ++v) {
+            const glm::vec3 offset = m_Vertices[v].Position - center;
+            maxDistSq = std::max(maxDistSq, glm::dot(offset, offset));
+        }
+        chunkDistSq[first / RecalculateGrain] = maxDistSq;
+    });
 
-        v0.Bitangent += bitangent;
-        v1.Bitangent += bitangent;
-        v2.Bitangent += bitangent;
+    float maxDistSq = 0.0f;
+    for (float distSq : chunkDistSq) {
+        maxDistSq = std::max(maxDistSq, distSq);
     }
+    m_BoundingSphere.Center = center;
+    m_BoundingSphere.Radius = std::sqrt(maxDistSq);
+}
 
-    for (auto& vertex : m_Vertices) {
-        float len = glm::length(vertex.Tangent);
-        if (len > 0.0f) {
-            vertex.Tangent /= len;
+void Mesh::RecalculateNormals() {
+    // LOD 0's triangles; coarser levels reuse the same vertices
+    const usize triangleCount = std::min<usize>(GetIndexCount(), m_Indices.size()) / 3;
+    const usize vertexCount = m_Vertices.size();
+
+    VertexStreams streams(m_Vertices, false);
+    const TriangleStreams triangles = streams.View(m_Indices.data());
+
+    Vector<f32> faceNormals(triangleCount * 3);
+    const TriangleVectors normals = SplitVectors(faceNormals, triangleCount);
+    ParallelRange(triangleCount, [&](u32 first, u32 last) {
+        MeshKernels::TriangleNormals(OffsetTriangles(triangles, first), OffsetVectors(normals, first), last - first);
+    });
+
+    // Each vertex sums its triangles in index order, as a serial pass would
+    const VertexTriangles adjacency = BuildVertexTriangles(m_Indices.data(), triangleCount, vertexCount);
+    ParallelRange(vertexCount, [&](u32 first, u32 last) {
+        for (u32 v = first; v < last; ++v) {
+            glm::vec3 normal(0.0f);
+            for (u32 k = adjacency.Offsets[v]; k < adjacency.Offsets[v + 1]; ++k) {
+                const u32 t = adjacency.Triangles[k];
+                normal += glm::vec3(normals.X[t], normals.Y[t], normals.Z[t]);
+            }
+
+            float len = glm::length(normal);
+            m_Vertices[v].Normal = len > 0.0f ? normal / len : normal;
         }
-        len = glm::length(vertex.Bitangent);
-        if (len > 0.0f) {
-            vertex.Bitangent /= len;
+    });
+}
+
+void Mesh::RecalculateTangents() {
+    // LOD 0's triangles; coarser levels reuse the same vertices
+    const usize triangleCount = std::min<usize>(GetIndexCount(), m_Indices.size()) / 3;
+    const usize vertexCount = m_Vertices.size();
+
+    VertexStreams streams(m_Vertices, true);
+    const TriangleStreams triangles = streams.View(m_Indices.data());
+
+    Vector<f32> faceTangents(triangleCount * 3);
+    Vector<f32> faceBitangents(triangleCount * 3);
+    const TriangleVectors tangents = SplitVectors(faceTangents, triangleCount);
+    const TriangleVectors bitangents = SplitVectors(faceBitangents, triangleCount);
+    ParallelRange(triangleCount, [&](u32 first, u32 last) {
+        MeshKernels::TriangleTangents(OffsetTriangles(triangles, first), OffsetVectors(tangents, first),
+                                      OffsetVectors(bitangents, first), last - first);
+    });
+
+    const VertexTriangles adjacency = BuildVertexTriangles(m_Indices.data(), triangleCount, vertexCount);
+    ParallelRange(vertexCount, [&](u32 first, u32 last) {
+        for (u32 v = first; v < last; ++v) {
+            glm::vec3 tangent(0.0f);
+            glm::vec3 bitangent(0.0f);
+            for (u32 k = adjacency.Offsets[v]; k < adjacency.Offsets[v + 1]; ++k) {
+                const u32 t = adjacency.Triangles[k];
+                tangent += glm::vec3(tangents.X[t], tangents.Y[t], tangents.Z[t]);
+                bitangent += glm::vec3(bitangents.X[t], bitangents.Y[t], bitangents.Z[t]);
+            }
+
+            float len = glm::length(tangent);
+            m_Vertices[v].Tangent = len > 0.0f ? tangent / len : tangent;
+            len = glm::length(bitangent);
+            m_Vertices[v].Bitangent = len > 0.0f ? bitangent / len : bitangent;
         }
+    });
+}
+
+const void* Mesh::PrepareVertexData(Vector<PackedVertex>& packed) {
+    if (m_VertexFormat == VertexFormat::Full) {
+        m_PositionDequant = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        return m_Vertices.data();
+    }
+
+    // One scale for all axes keeps the dequantization a uniform scale, so
+    // normal transforms built from the instance matrix stay valid
+    const glm::vec3 size = m_Bounds.GetSize();
+    f32 scale = std::max(size.x, std::max(size.y, size.z));
+    if (scale <= 0.0f) scale = 1.0f;
+    m_PositionDequant = glm::vec4(m_Bounds.Min, scale);
+
+    const f32 invScale = 1.0f / scale;
+    packed.resize(m_Vertices.size());
+    for (usize i = 0; i < m_Vertices.size(); ++i) {
+        const Vertex& vertex = m_Vertices[i];
+        PackedVertex& out = packed[i];
+
+        glm::vec3 position = glm::clamp((vertex.Position - m_Bounds.Min) * invScale, 0.0f, 1.0f);
+        out.Position[0] = glm::packUnorm1x16(position.x);
+        out.Position[1] = glm::packUnorm1x16(position.y);
+        out.Position[2] = glm::packUnorm1x16(position.z);
+
+        bool rightHanded = glm::dot(glm::cross(vertex.Normal, vertex.Tangent), vertex.Bitangent) >= 0.0f;
+        out.Position[3] = rightHanded ? 0xFFFF : 0;
+
+        glm::vec2 normal = EncodeOctahedral(vertex.Normal);
+        glm::vec2 tangent = EncodeOctahedral(vertex.Tangent);
+        out.NormalTangent[0] = PackSnorm(normal.x);
+        out.NormalTangent[1] = PackSnorm(normal.y);
+        out.NormalTangent[2] = PackSnorm(tangent.x);
+        out.NormalTangent[3] = PackSnorm(tangent.y);
+
+        out.TexCoords[0] = glm::packHalf1x16(vertex.TexCoords.x);
+        out.TexCoords[1] = glm::packHalf1x16(vertex.TexCoords.y);
+    }
+    return packed.data();
+}
+
+void Mesh::PreparePositionData(const void* vertexData, Vector<u8>& positions) const {
+    // Position is the first attribute of both formats
+    const u32 stride = GetLayout(m_VertexFormat).GetStride();
+    const u32 positionSize = GetPositionLayout(m_VertexFormat).GetStride();
+    const u8* source = static_cast<const u8*>(vertexData);
+
+    positions.resize(m_Vertices.size() * positionSize);
+    for (usize i = 0; i < m_Vertices.size(); ++i) {
+        std::memcpy(positions.data() + i * positionSize, source + i * stride, positionSize);
     }
 }
 
 BufferLayout Mesh::GetDefaultLayout() {
+    return GetLayout(VertexFormat::Full);
+}
+
+BufferLayout Mesh::GetLayout(VertexFormat format) {
+    // Packed attributes that decode differently get their own locations, so
+    // one shader takes both formats: locations the bound format leaves
+    // disabled read as (0, 0, 0, 1)
+    if (format == VertexFormat::Packed) {
+        return BufferLayout{
+            { ShaderDataType::UShort4Norm, "a_Position", true, 0 },
+            { ShaderDataType::Short4Norm, "a_PackedNormalTangent", true, 5 },
+            { ShaderDataType::Half2, "a_TexCoords", false, 2 }
+        };
+    }
+
     return BufferLayout{
         { ShaderDataType::Float3, "a_Position" },
         { ShaderDataType::Float3, "a_Normal" },
@@ -181,4 +770,11 @@ BufferLayout Mesh::GetDefaultLayout() {
     };
 }
 
+BufferLayout Mesh::GetPositionLayout(VertexFormat format) {
+    if (format == VertexFormat::Packed) {
+        return BufferLayout{ { ShaderDataType::UShort4Norm, "a_Position", true } };
+    }
+    return BufferLayout{ { ShaderDataType::Float3, "a_Position" } };
+}
+
 } // namespace Engine
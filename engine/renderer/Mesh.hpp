@@ -2,9 +2,12 @@
 
 #include "core/Types.hpp"
 #include "math/AABB.hpp"
+#include "renderer/GeometryPool.hpp"
 #include "renderer/opengl/GLBuffer.hpp"
 #include "renderer/opengl/GLVertexArray.hpp"
 #include <glm/glm.hpp>
+#include <algorithm>
+#include <atomic>
 
 namespace Engine {
 
@@ -16,6 +19,25 @@ struct Vertex {
     glm::vec3 Bitangent;
 };
 
+// How a mesh's vertices are stored on the GPU
+enum class VertexFormat : u8 {
+    Full,       // Vertex as is, 56 bytes
+    Packed      // PackedVertex, 20 bytes
+};
+
+// Compact vertex: position quantized to the mesh bounds, octahedral normal
+// and tangent, and the bitangent reduced to a sign. Positions decode with
+// Mesh::GetPositionDequant (xyz offset, w uniform scale), which is folded
+// into the instance transform; deferred/geometry.glsl decodes the rest.
+struct PackedVertex {
+    u16 Position[4];    // UNORM16 in the bounds; w = 65535 when B = cross(N, T), 0 when -cross(N, T)
+    i16 NormalTangent[4]; // SNORM16 octahedral normal (xy) and tangent (zw)
+    u16 TexCoords[2];   // Half float
+};
+static_assert(sizeof(PackedVertex) == 20, "PackedVertex must stay tightly packed");
+
+// Offsets are relative to the mesh; add Mesh::GetBaseVertex / GetBaseIndex
+// when drawing from a pooled vertex array
 struct SubMesh {
     u32 BaseVertex = 0;
     u32 BaseIndex = 0;
@@ -24,6 +46,80 @@ struct SubMesh {
     String Name;
 };
 
+// One level of detail: a range of the mesh's index buffer over the shared
+// vertices. Error is how far simplification moved any vertex, relative to
+// the bounding sphere radius, so Error * world radius is its world-space
+// deviation (0 for LOD 0).
+struct MeshLOD {
+    u32 IndexOffset = 0;    // Relative to the mesh; add Mesh::GetBaseIndex
+    u32 IndexCount = 0;
+    f32 Error = 0.0f;
+};
+
+// A cluster of up to ~64 vertices / 124 triangles of LOD 0, a contiguous
+// run of its indices (MeshletBuilder). Bounds are in mesh space. Mirrors
+// the std430 Meshlet struct in meshlet_cull.glsl, keep both in sync.
+struct Meshlet {
+    glm::vec3 Center{0.0f};     // Bounding sphere
+    f32 Radius = 0.0f;
+    glm::vec3 ConeAxis{0.0f, 0.0f, 1.0f};
+    f32 ConeCutoff = 2.0f;      // > 1: never back-facing as a whole
+    glm::vec3 ConeApex{0.0f};
+    u32 TriangleCount = 0;
+    u32 IndexOffset = 0;        // Relative to the mesh, inside LOD 0
+    u32 VertexCount = 0;        // Unique vertices referenced
+    u32 Padding[2] = {};
+};
+static_assert(sizeof(Meshlet) == 64, "Meshlet must match the std430 layout");
+
+// What Mesh::Optimize did to LOD 0, on MeshOptimizer's FIFO cache model
+struct MeshOptimizeStats {
+    f32 ACMRBefore = 0.0f;      // Cache misses per triangle
+    f32 ACMRAfter = 0.0f;
+    f32 ATVRBefore = 0.0f;      // Cache misses per vertex, 1.0 ideal
+    f32 ATVRAfter = 0.0f;
+    f32 Milliseconds = 0.0f;
+    bool Optimized = false;
+};
+
+// Vertex data already in a GPU layout - Mesh::GetLayout(Format) and, when
+// Positions is set, its depth stream - such as a cooked mesh file mapped in
+// memory. Mesh::Upload reads the spans in place.
+struct MeshGPUData {
+    VertexFormat Format = VertexFormat::Full;
+    const void* Vertices = nullptr;
+    const void* Positions = nullptr;    // Null without a depth stream
+    u32 VertexCount = 0;
+    const u32* Indices = nullptr;
+    u32 IndexCount = 0;                 // Every LOD's indices
+    const MeshLOD* LODs = nullptr;      // Null for LOD 0 alone
+    u32 LODCount = 0;
+    glm::vec4 PositionDequant{0.0f, 0.0f, 0.0f, 1.0f};
+};
+
+// What a mesh keeps in CPU memory once uploaded
+enum class MeshResidency : u8 {
+    KeepCPU,    // Vertices and indices, for picking, physics, LODs and the Recalculate* functions
+    Collision,  // MeshCollisionData alone
+    GPUOnly     // Nothing past the bounds, submeshes and LOD ranges
+};
+
+// What MeshResidency::Collision keeps: LOD 0's triangles over positions
+// quantized to 16 bits in the bounds, 6 bytes a vertex instead of 56
+struct MeshCollisionData {
+    Vector<u16> Positions;      // xyz per vertex, UNORM16
+    Vector<u32> Indices;        // LOD 0
+    glm::vec4 Dequant{0.0f, 0.0f, 0.0f, 1.0f};  // Mesh space = unorm xyz * w + offset, as PackedVertex
+
+    glm::vec3 GetPosition(u32 vertex) const {
+        const u16* position = &Positions[static_cast<usize>(vertex) * 3];
+        return glm::vec3(position[0], position[1], position[2]) * (Dequant.w / 65535.0f) + glm::vec3(Dequant);
+    }
+
+    u32 GetTriangleCount() const { return static_cast<u32>(Indices.size() / 3); }
+    usize GetMemorySize() const { return Positions.size() * sizeof(u16) + Indices.size() * sizeof(u32); }
+};
+
 class Mesh {
 public:
     Mesh() = default;
@@ -36,19 +132,139 @@ public:
     Mesh(Mesh&&) = default;
     Mesh& operator=(Mesh&&) = default;
 
+    // Layout used by the next Upload()
+    void SetVertexFormat(VertexFormat format) { m_VertexFormat = format; }
+    VertexFormat GetVertexFormat() const { return m_VertexFormat; }
+
+    // Also upload a tightly packed position stream with its own VAO, for
+    // shadow and other depth-only passes (on by default)
+    void SetDepthStream(bool enabled) { m_DepthStream = enabled; }
+    bool HasDepthStream() const { return m_DepthStream; }
+
+    // What the mesh keeps on the CPU after an upload. Set before Upload, or
+    // after it to drop what an earlier policy kept; data already dropped
+    // does not come back. New meshes start with the default policy.
+    void SetResidency(MeshResidency residency);
+    MeshResidency GetResidency() const { return m_Residency; }
+    static void SetDefaultResidency(MeshResidency residency);
+    static MeshResidency GetDefaultResidency();
+
+    // Upload into buffers of its own
     void Upload();
+
+    // Upload into a range of the pool's shared buffers, falling back to
+    // Upload() if the pool can't take it
+    void Upload(const Ref<GeometryPool>& pool);
+
+    // Upload GPU-ready data as is, into the pool when given. The mesh keeps
+    // no CPU copy, so the Recalculate* functions have nothing to work on
+    // afterwards; set the bounds with SetBounds.
+    void Upload(const MeshGPUData& data, const Ref<GeometryPool>& pool = nullptr);
+
+    // Whether data has the layout and counts of the pooled range the mesh
+    // was uploaded to, so it can be written over it
+    bool CanUploadInPlace(const MeshGPUData& data) const;
+
+    // Write data over range instead of allocating a new one: the mesh's own
+    // range, or that of the mesh it was moved over (a reload). It keeps the
+    // range's place in the pool; null streams keep their contents.
+    void UploadInPlace(const MeshGPUData& data, const Ref<GeometryRange>& range);
+
+    // The vertex and position streams Upload() would store. packed and
+    // positions hold the converted data and must outlive the result.
+    MeshGPUData GetGPUData(Vector<PackedVertex>& packed, Vector<u8>& positions);
+
     void Bind() const;
     void Unbind() const;
 
     const Ref<VertexArray>& GetVertexArray() const { return m_VAO; }
-    u32 GetIndexCount() const { return static_cast<u32>(m_Indices.size()); }
-    u32 GetVertexCount() const { return static_cast<u32>(m_Vertices.size()); }
+
+    // Position-only VAO sharing GetVertexArray's indices and base offsets;
+    // null without a depth stream
+    const Ref<VertexArray>& GetDepthVertexArray() const { return m_DepthVAO; }
+
+    // LOD 0's; the index buffer holds every LOD's after it (GetTotalIndexCount)
+    u32 GetIndexCount() const { return m_LODs.empty() ? m_IndexCount : m_LODs[0].IndexCount; }
+    u32 GetTotalIndexCount() const { return m_IndexCount; }
+    u32 GetVertexCount() const { return m_VertexCount; }
+
+    // Where the mesh starts in the vertex array's buffers (0 unless pooled)
+    u32 GetBaseVertex() const { return m_Geometry ? m_Geometry->GetBaseVertex() : 0; }
+    u32 GetBaseIndex() const { return m_Geometry ? m_Geometry->GetBaseIndex() : 0; }
+    bool IsPooled() const { return m_Geometry != nullptr; }
+
+    // Maps stored positions to mesh space: xyz * w + offset. Identity for
+    // VertexFormat::Full; see GetDrawTransform.
+    const glm::vec4& GetPositionDequant() const { return m_PositionDequant; }
+
+    // World matrix with the position dequantization applied first. The scale
+    // is uniform, so normals transformed by it only need renormalizing.
+    glm::mat4 GetDrawTransform(const glm::mat4& world) const {
+        glm::mat4 result = world;
+        result[3] = world * glm::vec4(glm::vec3(m_PositionDequant), 1.0f);
+        result[0] *= m_PositionDequant.w;
+        result[1] *= m_PositionDequant.w;
+        result[2] *= m_PositionDequant.w;
+        return result;
+    }
+
+    // What shadow and other depth-only passes bind
+    VertexArray* GetDepthPassVertexArray() const { return m_DepthVAO ? m_DepthVAO.get() : m_VAO.get(); }
+
+    // Buffers of the vertex and depth streams, the pool page's when pooled;
+    // the mesh's vertices start at GetBaseVertex. Null before the upload /
+    // without a depth stream.
+    VertexBuffer* GetVertexBuffer() const { return m_Geometry ? m_Geometry->GetVertexBuffer().get() : m_VBO.get(); }
+    VertexBuffer* GetPositionBuffer() const {
+        return m_Geometry ? m_Geometry->GetPositionBuffer().get() : m_PositionVBO.get();
+    }
+
+    // Pooled range, kept alive by whoever still draws it
+    const Ref<GeometryRange>& GetGeometryRange() const { return m_Geometry; }
 
     const AABB& GetBounds() const { return m_Bounds; }
     const BoundingSphere& GetBoundingSphere() const { return m_BoundingSphere; }
+    void SetBounds(const AABB& bounds, const BoundingSphere& sphere) {
+        m_Bounds = bounds;
+        m_BoundingSphere = sphere;
+    }
+
+    // Level of detail chain. LOD 0 is the mesh as built; further levels are
+    // coarser index ranges appended after it, coarsest last, and must be
+    // added to the CPU copy before Upload. Submeshes describe LOD 0 only.
+    u32 GetLODCount() const { return m_LODs.empty() ? 1 : static_cast<u32>(m_LODs.size()); }
+    MeshLOD GetLOD(u32 level) const {
+        if (m_LODs.empty()) return {0, m_IndexCount, 0.0f};
+        return m_LODs[std::min(level, static_cast<u32>(m_LODs.size()) - 1)];
+    }
+
+    // An authored level, appended as the coarsest
+    void AddLOD(const Vector<u32>& indices, f32 error);
+
+    // Replace the levels past LOD 0 with up to levels simplified ones, each
+    // targeting reduction times the previous triangle count
+    // (MeshSimplifier). Stops early once simplification stalls; returns the
+    // number of levels added.
+    u32 GenerateLODs(u32 levels, f32 reduction = 0.5f);
+
+    // Reorder the CPU copy for the GPU (MeshOptimizer): triangles of each
+    // submesh (or LOD 0) and of each further LOD for the post-transform
+    // cache, then into overdraw-friendly clusters; vertices in first-use
+    // order. Call after the LODs are built and before Upload.
+    const MeshOptimizeStats& Optimize();
+    const MeshOptimizeStats& GetOptimizeStats() const { return m_OptimizeStats; }
+
+    // Split LOD 0 into meshlets (MeshletBuilder) for GPU cluster culling;
+    // best after Optimize, which keeps them tight and rebuilds them if it
+    // runs later. Returns the meshlet count. Meshes whose submeshes offset
+    // their vertices are left without.
+    u32 BuildMeshlets(u32 maxVertices = 64, u32 maxTriangles = 124);
+    const Vector<Meshlet>& GetMeshlets() const { return m_Meshlets; }
+    void SetMeshlets(Vector<Meshlet> meshlets) { m_Meshlets = std::move(meshlets); }
 
     const Vector<SubMesh>& GetSubMeshes() const { return m_SubMeshes; }
     void AddSubMesh(const SubMesh& submesh) { m_SubMeshes.push_back(submesh); }
+    void SetSubMeshes(Vector<SubMesh> submeshes) { m_SubMeshes = std::move(submeshes); }
 
     const String& GetName() const { return m_Name; }
     void SetName(const String& name) { m_Name = name; }
@@ -57,23 +273,86 @@ public:
 
     bool IsUploaded() const { return m_VAO != nullptr; }
 
+    // Release the GPU buffers or pooled range, keeping everything else;
+    // IsUploaded() is false until the mesh is uploaded again. GL thread.
+    void Evict();
+    bool IsEvicted() const { return m_Evicted; }
+
+    // Residency feedback: the last frame a renderer drew the mesh, 0 when
+    // none has since its upload (ResourceManager::RequestMesh). Any thread.
+    void MarkUsed(u64 frame) const {
+        std::atomic_ref<u64> lastUsed(m_LastUsedFrame);
+        if (lastUsed.load(std::memory_order_relaxed) != frame) lastUsed.store(frame, std::memory_order_relaxed);
+    }
+    u64 GetLastUsedFrame() const { return std::atomic_ref<u64>(m_LastUsedFrame).load(std::memory_order_relaxed); }
+
+    // CPU copy, empty once dropped by the residency policy or never kept
+    // (meshes uploaded from GPU-ready data)
+    bool HasCPUData() const { return !m_Vertices.empty(); }
+    const Vector<Vertex>& GetVertices() const { return m_Vertices; }
+    const Vector<u32>& GetIndices() const { return m_Indices; }
+
+    // Null unless the policy is MeshResidency::Collision and the mesh was uploaded
+    const MeshCollisionData* GetCollisionData() const { return m_Collision.Positions.empty() ? nullptr : &m_Collision; }
+
+    // Bytes held on the CPU (vertices, indices, collision data) and in GPU
+    // buffers or the pool (vertex, depth and index streams)
+    usize GetCPUMemorySize() const;
+    usize GetGPUMemorySize() const;
+
     void RecalculateBounds();
     void RecalculateNormals();
     void RecalculateTangents();
 
     static BufferLayout GetDefaultLayout();
+    static BufferLayout GetLayout(VertexFormat format);
+
+    // Depth stream layout: the format's position attribute alone
+    static BufferLayout GetPositionLayout(VertexFormat format);
+
+private:
+    // m_LODs from uploaded data, checked against m_IndexCount
+    void SetLODs(const MeshGPUData& data);
+
+    // Vertex data in m_VertexFormat, encoded into packed for Packed. Sets
+    // m_PositionDequant.
+    const void* PrepareVertexData(Vector<PackedVertex>& packed);
+
+    // The position of every vertex of vertexData, tightly packed
+    void PreparePositionData(const void* vertexData, Vector<u8>& positions) const;
+
+    // Drop what m_Residency doesn't keep, building the collision data from
+    // data (the uploaded streams) first when it asks for it
+    void ApplyResidency(const MeshGPUData& data);
 
 private:
     Vector<Vertex> m_Vertices;
     Vector<u32> m_Indices;
     Vector<SubMesh> m_SubMeshes;
+    Vector<MeshLOD> m_LODs;     // Empty for LOD 0 alone
+    Vector<Meshlet> m_Meshlets; // Empty unless built or cooked
+    u32 m_VertexCount = 0;      // Also set for meshes uploaded without a CPU copy
+    u32 m_IndexCount = 0;       // All LODs
+
+    MeshCollisionData m_Collision;
+
+    VertexFormat m_VertexFormat = VertexFormat::Full;
+    MeshResidency m_Residency = GetDefaultResidency();
+    bool m_DepthStream = true;
+    bool m_Evicted = false;
+    alignas(std::atomic_ref<u64>::required_alignment) mutable u64 m_LastUsedFrame = 0;
+    glm::vec4 m_PositionDequant{0.0f, 0.0f, 0.0f, 1.0f};
 
     Ref<VertexArray> m_VAO;
     Ref<VertexBuffer> m_VBO;
     Ref<IndexBuffer> m_IBO;
+    Ref<VertexBuffer> m_PositionVBO;
+    Ref<VertexArray> m_DepthVAO;
+    Ref<GeometryRange> m_Geometry;      // Set instead of the buffers when pooled
 
     AABB m_Bounds;
     BoundingSphere m_BoundingSphere;
+    MeshOptimizeStats m_OptimizeStats;
 
     String m_Name;
     String m_FilePath;
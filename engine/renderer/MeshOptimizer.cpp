@@ -0,0 +1,266 @@
+#include "renderer/MeshOptimizer.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 None = ~0u;
+
+// FIFO cache by timestamps: a vertex is resident while fewer than cacheSize
+// misses happened since it was loaded
+struct CacheSimulator {
+    Vector<u32> Loaded;
+    u32 Time;
+    u32 Size;
+
+    CacheSimulator(u32 vertexCount, u32 cacheSize)
+        : Loaded(vertexCount, 0), Time(cacheSize + 1), Size(cacheSize) {}
+
+    bool Access(u32 vertex) {
+        if (Time - Loaded[vertex] <= Size) return false;
+        Loaded[vertex] = Time++;
+        return true;
+    }
+
+    void Flush() { Time += Size + 1; }
+
+    u32 AccessTriangle(const u32* triangle) {
+        return (Access(triangle[0]) ? 1 : 0) + (Access(triangle[1]) ? 1 : 0) + (Access(triangle[2]) ? 1 : 0);
+    }
+};
+
+} // anonymous namespace
+
+MeshOptimizer::VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const u32* indices, u32 indexCount,
+                                                                 u32 vertexCount, u32 cacheSize) {
+    VertexCacheStats stats;
+    const u32 triangleCount = indexCount / 3;
+    if (triangleCount == 0) return stats;
+
+    CacheSimulator cache(vertexCount, cacheSize);
+    Vector<u8> used(vertexCount, 0);
+    u32 misses = 0;
+    u32 usedCount = 0;
+    for (u32 t = 0; t < triangleCount; ++t) {
+        misses += cache.AccessTriangle(indices + t * 3);
+        for (u32 c = 0; c < 3; ++c) {
+            const u32 vertex = indices[t * 3 + c];
+            if (!used[vertex]) {
+                used[vertex] = 1;
+                ++usedCount;
+            }
+        }
+    }
+
+    stats.ACMR = static_cast<f32>(misses) / static_cast<f32>(triangleCount);
+    stats.ATVR = static_cast<f32>(misses) / static_cast<f32>(usedCount);
+    return stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(u32* indices, u32 indexCount, u32 vertexCount, u32 cacheSize) {
+    const u32 triangleCount = indexCount / 3;
+    if (triangleCount < 2) return;
+
+    // Vertex -> triangle adjacency
+    Vector<u32> offsets(vertexCount + 1, 0);
+    for (u32 i = 0; i < triangleCount * 3; ++i) {
+        offsets[indices[i] + 1]++;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    Vector<u32> adjacency(triangleCount * 3);
+    Vector<u32> cursor(offsets.begin(), offsets.end() - 1);
+    for (u32 i = 0; i < triangleCount * 3; ++i) {
+        adjacency[cursor[indices[i]]++] = i / 3;
+    }
+
+    // Triangles still to emit around each vertex
+    Vector<u32> live(vertexCount);
+    for (u32 v = 0; v < vertexCount; ++v) {
+        live[v] = offsets[v + 1] - offsets[v];
+    }
+
+    Vector<u32> loaded(vertexCount, 0);
+    Vector<u8> emitted(triangleCount, 0);
+    Vector<u32> deadEnds;
+    Vector<u32> candidates;
+    Vector<u32> output;
+    deadEnds.reserve(triangleCount * 3);
+    output.reserve(triangleCount * 3);
+
+    u32 time = cacheSize + 1;
+    u32 scan = 0;
+    u32 fanning = indices[0];
+
+    while (fanning != None) {
+        // Emit every remaining triangle around the fanning vertex
+        candidates.clear();
+        for (u32 k = offsets[fanning]; k < offsets[fanning + 1]; ++k) {
+            const u32 triangle = adjacency[k];
+            if (emitted[triangle]) continue;
+            emitted[triangle] = 1;
+
+            for (u32 c = 0; c < 3; ++c) {
+                const u32 vertex = indices[triangle * 3 + c];
+                output.push_back(vertex);
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+                live[vertex]--;
+                if (time - loaded[vertex] > cacheSize) {
+                    loaded[vertex] = time++;
+                }
+            }
+        }
+
+        // Next fan: the oldest candidate that would still be cached after
+        // emitting its remaining triangles
+        u32 next = None;
+        i64 bestPriority = -1;
+        for (u32 vertex : candidates) {
+            if (live[vertex] == 0) continue;
+
+            i64 priority = 0;
+            const u32 age = time - loaded[vertex];
+            if (age + 2 * live[vertex] <= cacheSize) {
+                priority = age;
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = vertex;
+            }
+        }
+
+        // Dead end: recently used vertices first, then any with work left
+        while (next == None && !deadEnds.empty()) {
+            const u32 vertex = deadEnds.back();
+            deadEnds.pop_back();
+            if (live[vertex] > 0) next = vertex;
+        }
+        while (next == None && scan < vertexCount) {
+            if (live[scan] > 0) next = scan;
+            ++scan;
+        }
+
+        fanning = next;
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+void MeshOptimizer::OptimizeOverdraw(u32* indices, u32 indexCount, const glm::vec3* positions, u32 vertexCount,
+                                     f32 threshold, u32 cacheSize) {
+    const u32 triangleCount = indexCount / 3;
+    if (triangleCount < 2) return;
+
+    // Hard boundaries where a triangle misses on every vertex: the cache
+    // starts over there whatever the order
+    Vector<u32> hardStarts;
+    {
+        CacheSimulator cache(vertexCount, cacheSize);
+        for (u32 t = 0; t < triangleCount; ++t) {
+            if (cache.AccessTriangle(indices + t * 3) == 3 || t == 0) {
+                hardStarts.push_back(t);
+            }
+        }
+        hardStarts.push_back(triangleCount);
+    }
+
+    // Soft boundaries split a hard cluster wherever the part so far, from a
+    // cold cache, is within threshold of the whole cluster's ACMR
+    Vector<u32> clusterStarts;
+    CacheSimulator cache(vertexCount, cacheSize);
+    for (usize h = 0; h + 1 < hardStarts.size(); ++h) {
+        const u32 first = hardStarts[h];
+        const u32 last = hardStarts[h + 1];
+
+        cache.Flush();
+        u32 misses = 0;
+        for (u32 t = first; t < last; ++t) {
+            misses += cache.AccessTriangle(indices + t * 3);
+        }
+        const f32 limit = threshold * static_cast<f32>(misses) / static_cast<f32>(last - first);
+
+        cache.Flush();
+        clusterStarts.push_back(first);
+        u32 clusterMisses = 0;
+        u32 clusterTriangles = 0;
+        for (u32 t = first; t < last; ++t) {
+            clusterMisses += cache.AccessTriangle(indices + t * 3);
+            clusterTriangles++;
+            if (t + 1 < last && static_cast<f32>(clusterMisses) <= limit * static_cast<f32>(clusterTriangles)) {
+                clusterStarts.push_back(t + 1);
+                cache.Flush();
+                clusterMisses = 0;
+                clusterTriangles = 0;
+            }
+        }
+    }
+    const u32 clusterCount = static_cast<u32>(clusterStarts.size());
+    clusterStarts.push_back(triangleCount);
+    if (clusterCount < 2) return;
+
+    // Area-weighted centroid and normal per cluster
+    Vector<glm::vec3> centroids(clusterCount, glm::vec3(0.0f));
+    Vector<glm::vec3> normals(clusterCount, glm::vec3(0.0f));
+    Vector<f32> areas(clusterCount, 0.0f);
+    glm::vec3 meshCentroid(0.0f);
+    f32 meshArea = 0.0f;
+
+    for (u32 cluster = 0; cluster < clusterCount; ++cluster) {
+        for (u32 t = clusterStarts[cluster]; t < clusterStarts[cluster + 1]; ++t) {
+            const glm::vec3& p0 = positions[indices[t * 3]];
+            const glm::vec3& p1 = positions[indices[t * 3 + 1]];
+            const glm::vec3& p2 = positions[indices[t * 3 + 2]];
+            const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            const f32 area = glm::length(normal);
+
+            centroids[cluster] += (p0 + p1 + p2) * (area / 3.0f);
+            normals[cluster] += normal;
+            areas[cluster] += area;
+        }
+        meshCentroid += centroids[cluster];
+        meshArea += areas[cluster];
+    }
+    if (meshArea > 0.0f) meshCentroid /= meshArea;
+
+    // Clusters far out along their own normal occlude the rest from most
+    // directions they're seen from; draw those first
+    Vector<f32> keys(clusterCount, 0.0f);
+    for (u32 cluster = 0; cluster < clusterCount; ++cluster) {
+        const f32 normalLength = glm::length(normals[cluster]);
+        if (areas[cluster] <= 0.0f || normalLength <= 0.0f) continue;
+        keys[cluster] = glm::dot(centroids[cluster] / areas[cluster] - meshCentroid, normals[cluster] / normalLength);
+    }
+
+    Vector<u32> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&keys](u32 a, u32 b) { return keys[a] > keys[b]; });
+
+    Vector<u32> sorted;
+    sorted.reserve(triangleCount * 3);
+    for (u32 cluster : order) {
+        sorted.insert(sorted.end(), indices + clusterStarts[cluster] * 3, indices + clusterStarts[cluster + 1] * 3);
+    }
+    std::copy(sorted.begin(), sorted.end(), indices);
+}
+
+u32 MeshOptimizer::OptimizeVertexFetch(const u32* indices, u32 indexCount, u32 vertexCount, Vector<u32>& remap) {
+    remap.assign(vertexCount, None);
+
+    u32 next = 0;
+    for (u32 i = 0; i < indexCount; ++i) {
+        if (remap[indices[i]] == None) {
+            remap[indices[i]] = next++;
+        }
+    }
+
+    const u32 usedCount = next;
+    for (u32& slot : remap) {
+        if (slot == None) slot = next++;
+    }
+    return usedCount;
+}
+
+} // namespace Engine
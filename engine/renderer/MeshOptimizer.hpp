@@ -0,0 +1,52 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// MeshOptimizer - triangle and vertex ordering for GPU throughput.
+//
+// Run at import (Mesh::Optimize) so every draw benefits:
+//   OptimizeVertexCache  Tipsify (Sander et al. 2007): fan out from the most
+//                        recently used vertex so post-transform cache hits
+//                        stay high, jumping to dead-end vertices when a fan
+//                        runs out.
+//   OptimizeOverdraw     splits the cache-ordered triangles into clusters
+//                        where the cache restarts anyway, or at little cost
+//                        (within threshold of the cluster's ACMR), and sorts
+//                        them outward-facing first, so from most viewpoints
+//                        near surfaces draw before what they hide.
+//   OptimizeVertexFetch  renumbers vertices in first-use order so vertex
+//                        fetch walks the buffer linearly.
+//
+// ACMR (average cache miss ratio, misses per triangle) and ATVR (misses per
+// used vertex, 1.0 ideal) are measured on a FIFO cache of CacheSize
+// entries, a reasonable stand-in for current hardware.
+namespace MeshOptimizer {
+
+    constexpr u32 CacheSize = 16;
+
+    struct VertexCacheStats {
+        f32 ACMR = 0.0f;
+        f32 ATVR = 0.0f;
+    };
+
+    VertexCacheStats AnalyzeVertexCache(const u32* indices, u32 indexCount, u32 vertexCount,
+                                        u32 cacheSize = CacheSize);
+
+    // Reorders the triangles in place; indices must be below vertexCount
+    void OptimizeVertexCache(u32* indices, u32 indexCount, u32 vertexCount, u32 cacheSize = CacheSize);
+
+    // Reorders cache-optimized triangles in place. positions is indexed by
+    // the indices.
+    void OptimizeOverdraw(u32* indices, u32 indexCount, const glm::vec3* positions, u32 vertexCount,
+                          f32 threshold = 1.05f, u32 cacheSize = CacheSize);
+
+    // remap[old] = new, in first-use order with unused vertices last.
+    // Returns the number of used vertices.
+    u32 OptimizeVertexFetch(const u32* indices, u32 indexCount, u32 vertexCount, Vector<u32>& remap);
+
+} // namespace MeshOptimizer
+
+} // namespace Engine
@@ -0,0 +1,139 @@
+#include "renderer/MeshSimplifier.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 Unassigned = ~0u;
+constexpr u32 MaxGridSize = 1u << 16;
+
+using Triangle = std::array<u32, 3>;
+
+// One clustering pass with cubic cells of cellSize. Writes the surviving
+// triangles to out and returns the largest vertex displacement.
+f32 Cluster(const Vector<glm::vec3>& positions, const u32* indices, u32 indexCount,
+            const glm::vec3& boundsMin, f32 cellSize, Vector<u32>& remap, Vector<u32>& out) {
+    std::fill(remap.begin(), remap.end(), Unassigned);
+
+    HashMap<u64, u32> cells;
+    Vector<glm::vec3> sums;
+    Vector<u32> counts;
+
+    // Only vertices the triangles use take part
+    for (u32 i = 0; i < indexCount; ++i) {
+        const u32 vertex = indices[i];
+        if (remap[vertex] != Unassigned) continue;
+
+        const glm::vec3 cell = (positions[vertex] - boundsMin) / cellSize;
+        const u64 x = static_cast<u64>(std::clamp(cell.x, 0.0f, static_cast<f32>(MaxGridSize)));
+        const u64 y = static_cast<u64>(std::clamp(cell.y, 0.0f, static_cast<f32>(MaxGridSize)));
+        const u64 z = static_cast<u64>(std::clamp(cell.z, 0.0f, static_cast<f32>(MaxGridSize)));
+        const u64 key = x | (y << 21) | (z << 42);
+
+        auto [it, inserted] = cells.try_emplace(key, static_cast<u32>(sums.size()));
+        if (inserted) {
+            sums.push_back(glm::vec3(0.0f));
+            counts.push_back(0);
+        }
+        remap[vertex] = it->second;
+        sums[it->second] += positions[vertex];
+        counts[it->second]++;
+    }
+
+    // Representative: the member nearest the cluster's average
+    const usize clusterCount = sums.size();
+    Vector<u32> representative(clusterCount, Unassigned);
+    Vector<f32> nearest(clusterCount, std::numeric_limits<f32>::max());
+    for (u32 vertex = 0; vertex < static_cast<u32>(remap.size()); ++vertex) {
+        const u32 cluster = remap[vertex];
+        if (cluster == Unassigned) continue;
+
+        const glm::vec3 offset = positions[vertex] - sums[cluster] / static_cast<f32>(counts[cluster]);
+        const f32 distance = glm::dot(offset, offset);
+        if (distance < nearest[cluster]) {
+            nearest[cluster] = distance;
+            representative[cluster] = vertex;
+        }
+    }
+
+    f32 error = 0.0f;
+    for (u32 vertex = 0; vertex < static_cast<u32>(remap.size()); ++vertex) {
+        if (remap[vertex] == Unassigned) continue;
+        const u32 target = representative[remap[vertex]];
+        error = std::max(error, glm::length(positions[vertex] - positions[target]));
+        remap[vertex] = target;
+    }
+
+    // Drop collapsed triangles, then duplicates. Rotating the smallest index
+    // first keeps the winding, so only true repeats compare equal.
+    Vector<Triangle> triangles;
+    triangles.reserve(indexCount / 3);
+    for (u32 i = 0; i + 2 < indexCount; i += 3) {
+        Triangle triangle = {remap[indices[i]], remap[indices[i + 1]], remap[indices[i + 2]]};
+        if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2]) continue;
+
+        auto smallest = std::min_element(triangle.begin(), triangle.end());
+        std::rotate(triangle.begin(), smallest, triangle.end());
+        triangles.push_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    triangles.erase(std::unique(triangles.begin(), triangles.end()), triangles.end());
+
+    out.clear();
+    out.reserve(triangles.size() * 3);
+    for (const Triangle& triangle : triangles) {
+        out.insert(out.end(), triangle.begin(), triangle.end());
+    }
+    return error;
+}
+
+} // anonymous namespace
+
+f32 MeshSimplifier::Simplify(const Vector<glm::vec3>& positions, const u32* indices, u32 indexCount,
+                             u32 targetIndexCount, Vector<u32>& result) {
+    result.clear();
+    if (indexCount < 3 || positions.empty()) return 0.0f;
+
+    if (targetIndexCount >= indexCount) {
+        result.assign(indices, indices + indexCount);
+        return 0.0f;
+    }
+
+    glm::vec3 boundsMin(std::numeric_limits<f32>::max());
+    glm::vec3 boundsMax(std::numeric_limits<f32>::lowest());
+    for (u32 i = 0; i < indexCount; ++i) {
+        boundsMin = glm::min(boundsMin, positions[indices[i]]);
+        boundsMax = glm::max(boundsMax, positions[indices[i]]);
+    }
+    const glm::vec3 size = boundsMax - boundsMin;
+    const f32 extent = std::max(size.x, std::max(size.y, size.z));
+    if (!(extent > 0.0f)) return 0.0f;
+
+    // Finer grids keep more triangles; find the finest within the target
+    Vector<u32> remap(positions.size());
+    Vector<u32> candidate;
+    f32 error = 0.0f;
+    u32 low = 1;
+    u32 high = MaxGridSize;
+    while (low <= high) {
+        const u32 grid = low + (high - low) / 2;
+        const f32 candidateError = Cluster(positions, indices, indexCount, boundsMin,
+                                           extent / static_cast<f32>(grid), remap, candidate);
+        if (candidate.size() <= targetIndexCount) {
+            if (candidate.size() >= result.size()) {
+                result.swap(candidate);
+                error = candidateError;
+            }
+            low = grid + 1;
+        } else {
+            high = grid - 1;
+        }
+    }
+    return error;
+}
+
+} // namespace Engine
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// MeshSimplifier - index-only triangle reduction for mesh LOD chains.
+//
+// Vertex clustering: positions snap to a uniform grid, every vertex in a
+// cell is replaced by one representative (the original vertex nearest the
+// cell's average), and triangles that collapse or repeat another are
+// dropped. The result indexes the input vertices, so LODs share the mesh's
+// vertex buffer and are just further index ranges. The grid resolution is
+// searched for the finest one that meets the target.
+//
+// Attribute seams are not preserved: a representative's normal and UV
+// apply on both sides of one. That is invisible at the distances coarse
+// levels are selected at, and keeps the vertex buffer untouched.
+namespace MeshSimplifier {
+
+    // Writes at most targetIndexCount indices to result, empty if no grid
+    // keeps a triangle. Returns the farthest any used vertex moved, in mesh
+    // units.
+    f32 Simplify(const Vector<glm::vec3>& positions, const u32* indices, u32 indexCount,
+                 u32 targetIndexCount, Vector<u32>& result);
+
+} // namespace MeshSimplifier
+
+} // namespace Engine
@@ -0,0 +1,131 @@
+#include "renderer/MeshletBuilder.hpp"
+#include "renderer/Mesh.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 Unassigned = ~0u;
+
+// Sphere, cone and apex of the meshlet's triangles
+void ComputeBounds(const Vector<glm::vec3>& positions, const u32* indices, Meshlet& meshlet) {
+    const u32* triangles = indices + meshlet.IndexOffset;
+    const u32 indexCount = meshlet.TriangleCount * 3;
+
+    // Sphere: around the box center, out to the farthest vertex
+    glm::vec3 boundsMin(std::numeric_limits<f32>::max());
+    glm::vec3 boundsMax(std::numeric_limits<f32>::lowest());
+    for (u32 i = 0; i < indexCount; ++i) {
+        boundsMin = glm::min(boundsMin, positions[triangles[i]]);
+        boundsMax = glm::max(boundsMax, positions[triangles[i]]);
+    }
+    const glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    f32 radius = 0.0f;
+    for (u32 i = 0; i < indexCount; ++i) {
+        radius = std::max(radius, glm::length(positions[triangles[i]] - center));
+    }
+    meshlet.Center = center;
+    meshlet.Radius = radius;
+
+    // Cone: axis along the average face normal, opening to the widest one
+    Vector<glm::vec3> normals;
+    normals.reserve(meshlet.TriangleCount);
+    glm::vec3 sum(0.0f);
+    for (u32 t = 0; t < meshlet.TriangleCount; ++t) {
+        const glm::vec3& p0 = positions[triangles[t * 3]];
+        const glm::vec3& p1 = positions[triangles[t * 3 + 1]];
+        const glm::vec3& p2 = positions[triangles[t * 3 + 2]];
+        const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        const f32 length = glm::length(normal);
+        if (length <= 0.0f) continue;
+
+        normals.push_back(normal / length);
+        sum += normals.back();
+    }
+
+    const f32 sumLength = glm::length(sum);
+    if (normals.empty() || sumLength <= 0.0f) return;
+    const glm::vec3 axis = sum / sumLength;
+
+    f32 minDot = 1.0f;
+    for (const glm::vec3& normal : normals) {
+        minDot = std::min(minDot, glm::dot(normal, axis));
+    }
+    if (minDot <= 0.1f) return;     // Too wide to ever face away entirely
+
+    // Apex: back along the axis until every triangle's plane is in front of
+    // it, so the cone test holds for the faces and not just their normals
+    f32 maxT = 0.0f;
+    u32 normalIndex = 0;
+    for (u32 t = 0; t < meshlet.TriangleCount; ++t) {
+        const glm::vec3& p0 = positions[triangles[t * 3]];
+        const glm::vec3& p1 = positions[triangles[t * 3 + 1]];
+        const glm::vec3& p2 = positions[triangles[t * 3 + 2]];
+        if (glm::length(glm::cross(p1 - p0, p2 - p0)) <= 0.0f) continue;
+
+        const glm::vec3& normal = normals[normalIndex++];
+        const f32 t0 = glm::dot(center - p0, normal) / glm::dot(axis, normal);
+        maxT = std::max(maxT, t0);
+    }
+
+    meshlet.ConeAxis = axis;
+    meshlet.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+    meshlet.ConeApex = center - axis * maxT;
+}
+
+} // anonymous namespace
+
+void MeshletBuilder::Build(const Vector<glm::vec3>& positions, const u32* indices, u32 indexCount,
+                           Vector<Meshlet>& meshlets, u32 maxVertices, u32 maxTriangles) {
+    const u32 triangleCount = indexCount / 3;
+    if (triangleCount == 0 || maxVertices < 3 || maxTriangles == 0) return;
+
+    // owner[v] is the meshlet v was last counted in
+    Vector<u32> owner(positions.size(), Unassigned);
+    const usize firstMeshlet = meshlets.size();
+
+    Meshlet current;
+    auto close = [&]() {
+        if (current.TriangleCount == 0) return;
+        meshlets.push_back(current);
+        current = Meshlet();
+    };
+
+    for (u32 t = 0; t < triangleCount; ++t) {
+        const u32* triangle = indices + t * 3;
+        const u32 id = static_cast<u32>(meshlets.size());
+
+        u32 added = 0;
+        for (u32 c = 0; c < 3; ++c) {
+            const bool repeated = (c > 0 && triangle[c] == triangle[0]) || (c > 1 && triangle[c] == triangle[1]);
+            if (owner[triangle[c]] != id && !repeated) added++;
+        }
+
+        if (current.VertexCount + added > maxVertices || current.TriangleCount == maxTriangles) {
+            close();
+            added = 3;
+            if (triangle[0] == triangle[1] || triangle[0] == triangle[2]) added--;
+            if (triangle[1] == triangle[2]) added--;
+        }
+
+        if (current.TriangleCount == 0) {
+            current.IndexOffset = t * 3;
+        }
+        const u32 newId = static_cast<u32>(meshlets.size());
+        for (u32 c = 0; c < 3; ++c) {
+            owner[triangle[c]] = newId;
+        }
+        current.VertexCount += added;
+        current.TriangleCount++;
+    }
+    close();
+
+    for (usize i = firstMeshlet; i < meshlets.size(); ++i) {
+        ComputeBounds(positions, indices, meshlets[i]);
+    }
+}
+
+} // namespace Engine
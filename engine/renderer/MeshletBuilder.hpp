@@ -0,0 +1,34 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+struct Meshlet;
+
+// MeshletBuilder - splits an index range into meshlets for MeshletCuller.
+//
+// Triangles are taken in index order and a meshlet is closed as soon as the
+// next triangle would exceed maxVertices unique vertices or maxTriangles, so
+// each meshlet is a contiguous run of the input and draws straight from the
+// mesh's own index buffer. Locality therefore comes from the triangle order:
+// run it after MeshOptimizer, whose cache order keeps runs compact.
+//
+// Bounds per meshlet: a sphere around its vertices and a normal cone with
+// an apex, such that the whole meshlet faces away from any viewer for which
+// dot(normalize(apex - viewer), axis) >= cutoff. Meshlets whose normals
+// spread over (nearly) a hemisphere get cutoff > 1 and never cone-cull.
+namespace MeshletBuilder {
+
+    constexpr u32 DefaultMaxVertices = 64;
+    constexpr u32 DefaultMaxTriangles = 124;
+
+    // Appends to meshlets; IndexOffset is relative to indices
+    void Build(const Vector<glm::vec3>& positions, const u32* indices, u32 indexCount,
+               Vector<Meshlet>& meshlets,
+               u32 maxVertices = DefaultMaxVertices, u32 maxTriangles = DefaultMaxTriangles);
+
+} // namespace MeshletBuilder
+
+} // namespace Engine
@@ -5,28 +5,77 @@
 #include "renderer/opengl/GLVertexArray.hpp"
 
 #include <glm/glm.hpp>
+#include <algorithm>
 
 namespace Engine {
 
+// Packed 64-bit render sort key. Higher fields dominate the order.
+//
+// Opaque (front-to-back inside a state bucket, minimizes state changes):
+//   [63..60] pass  [59] 0  [58..48] shader  [47..32] material  [31..16] mesh  [15..0] depth
+//
+// Translucent (back-to-front is required for correct blending, so depth
+// comes before state):
+//   [63..60] pass  [59] 1  [58..43] inverted depth  [42..32] shader  [31..16] material  [15..0] mesh
+//
+// Shader, material and mesh are truncated ids; collisions only cost an
+// extra state change, never correctness.
+namespace RenderSortKey {
+
+    constexpr u32 PassBits = 4;
+    constexpr u32 ShaderBits = 11;
+    constexpr u32 MaterialBits = 16;
+    constexpr u32 MeshBits = 16;
+    constexpr u32 DepthBits = 16;
+
+    constexpr u64 Mask(u32 bits) { return (u64(1) << bits) - 1; }
+
+    // Depth normalized to [0, 1] over the queue's depth range
+    inline u64 QuantizeDepth(f32 normalizedDepth) {
+        f32 depth = std::clamp(normalizedDepth, 0.0f, 1.0f);
+        return static_cast<u64>(depth * static_cast<f32>(Mask(DepthBits)));
+    }
+
+    inline u64 Encode(u32 pass, bool translucent, u32 shader, u32 material, u32 mesh, f32 normalizedDepth) {
+        u64 key = (u64(pass) & Mask(PassBits)) << 60;
+        u64 depth = QuantizeDepth(normalizedDepth);
+
+        if (!translucent) {
+            key |= (u64(shader) & Mask(ShaderBits)) << 48;
+            key |= (u64(material) & Mask(MaterialBits)) << 32;
+            key |= (u64(mesh) & Mask(MeshBits)) << 16;
+            key |= depth;
+        } else {
+            key |= u64(1) << 59;
+            key |= (Mask(DepthBits) - depth) << 43;
+            key |= (u64(shader) & Mask(ShaderBits)) << 32;
+            key |= (u64(material) & Mask(MaterialBits)) << 16;
+            key |= u64(mesh) & Mask(MeshBits);
+        }
+        return key;
+    }
+
+} // namespace RenderSortKey
+
 struct RenderCommand {
     Ref<Shader> ShaderRef;
     Ref<VertexArray> VAORef;
     glm::mat4 Transform{1.0f};
     u32 IndexCount = 0;
-    u32 SortKey = 0;
+    u32 BaseVertex = 0;      // Mesh start in a shared (GeometryPool) VAO
+    u32 BaseIndex = 0;
+
+    // Sort inputs (the key itself is built by RenderQueue::Sort)
+    u32 MaterialId = 0;
+    f32 Depth = 0.0f;        // View-space distance
+    u8 Pass = 0;
+    bool Translucent = false;
 
     RenderCommand() = default;
 
     RenderCommand(Ref<Shader> shader, Ref<VertexArray> vao,
                   const glm::mat4& transform, u32 indexCount)
-        : ShaderRef(shader), VAORef(vao), Transform(transform), IndexCount(indexCount) {
-        // Generate sort key from shader ID for efficient sorting
-        SortKey = shader ? shader->GetRendererID() : 0;
-    }
-
-    bool operator<(const RenderCommand& other) const {
-        return SortKey < other.SortKey;
-    }
+        : ShaderRef(shader), VAORef(vao), Transform(transform), IndexCount(indexCount) {}
 };
 
 } // namespace Engine
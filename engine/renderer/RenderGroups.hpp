@@ -0,0 +1,37 @@
+#pragma once
+
+#include <entt/entt.hpp>
+#include "ecs/Components/Transform.hpp"
+#include "ecs/Components/Renderable.hpp"
+#include "ecs/Components/LightComponents.hpp"
+
+namespace Engine {
+
+// Owning groups for the component sets the renderer walks every frame.
+//
+// An owning group keeps the entities it matches packed at the front of each
+// owned pool, in the same order, so iterating it streams parallel arrays
+// instead of walking the smallest pool and probing the others per entity
+// (BM_ECSViewIteration vs BM_ECSPartialGroupIteration in ECSBenchmarks).
+//
+// A pool can be owned by one group only, and an owned pool must not be
+// sorted. Transform is therefore only ever a get<> here, which leaves it to
+// TransformSystem's storage sort. The systems register the groups in
+// OnCreate so existing entities are packed once, up front; later calls
+// return the same group.
+
+// Meshes: geometry and shadow caster gathers. MaterialComponent stays out
+// of it so entities without one still cast shadows.
+inline auto RenderableGroup(entt::registry& registry) {
+    return registry.group<MeshComponent, Renderable>(entt::get<Transform>);
+}
+
+inline auto PointLightGroup(entt::registry& registry) {
+    return registry.group<PointLightComponent>(entt::get<Transform>);
+}
+
+inline auto SpotLightGroup(entt::registry& registry) {
+    return registry.group<SpotLightComponent>(entt::get<Transform>);
+}
+
+} // namespace Engine
@@ -1,15 +1,128 @@
 #include "RenderQueue.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Telemetry.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
 
 #include <glad/gl.h>
 
 namespace Engine {
 
+namespace {
+
+const TelemetryCounter s_QueueDrawCalls("RenderQueue.DrawCalls");
+const TelemetryCounter s_QueueTriangles("RenderQueue.Triangles");
+
+} // anonymous namespace
+
+RenderQueue::RenderQueue() {
+    ResizeBuckets();
+}
+
+void RenderQueue::ResizeBuckets() {
+    m_Buckets.resize(JobSystem::GetWorkerCount() + 1);
+}
+
+template<typename... Args>
+void RenderQueue::Record(Args&&... args) {
+    i32 worker = JobSystem::GetCurrentWorkerIndex();
+    usize bucket = static_cast<usize>(worker + 1);
+
+    // Workers own their bucket; everyone else (or workers spawned after the
+    // queue was sized) goes through the shared one
+    if (worker >= 0 && bucket < m_Buckets.size()) {
+        m_Buckets[bucket].Commands.emplace_back(std::forward<Args>(args)...);
+        return;
+    }
+
+    while (m_SharedLock.test_and_set(std::memory_order_acquire)) {
+    }
+    m_Buckets[0].Commands.emplace_back(std::forward<Args>(args)...);
+    m_SharedLock.clear(std::memory_order_release);
+}
+
+void RenderQueue::Submit(const RenderCommand& command) {
+    Record(command);
+}
+
+void RenderQueue::Submit(Ref<Shader> shader, Ref<VertexArray> vao,
+                         const glm::mat4& transform, u32 indexCount) {
+    Record(std::move(shader), std::move(vao), transform, indexCount);
+}
+
+void RenderQueue::MergeBuckets() {
+    for (auto& bucket : m_Buckets) {
+        if (bucket.Commands.empty()) continue;
+
+        m_Commands.insert(m_Commands.end(),
+                          std::make_move_iterator(bucket.Commands.begin()),
+                          std::make_move_iterator(bucket.Commands.end()));
+        bucket.Commands.clear();  // Keeps capacity for the next frame
+        m_Sorted = false;
+    }
+}
+
+void RenderQueue::Clear() {
+    m_Commands.clear();
+    for (auto& bucket : m_Buckets) {
+        bucket.Commands.clear();
+    }
+    m_SortedKeys.clear();
+    m_Sorted = false;
+    m_Stats = {};
+
+    // Pick up a JobSystem that was (re)initialized after construction
+    if (m_Buckets.size() != JobSystem::GetWorkerCount() + 1) {
+        ResizeBuckets();
+    }
+}
+
+usize RenderQueue::GetCommandCount() const {
+    usize count = m_Commands.size();
+    for (const auto& bucket : m_Buckets) {
+        count += bucket.Commands.size();
+    }
+    return count;
+}
+
+void RenderQueue::Sort() {
+    MergeBuckets();
+
+    const u32 count = static_cast<u32>(m_Commands.size());
+    m_SortedKeys.resize(count);
+
+    const f32 depthRange = m_FarDepth - m_NearDepth;
+    const f32 invDepthRange = depthRange > 0.0f ? 1.0f / depthRange : 0.0f;
+
+    for (u32 i = 0; i < count; ++i) {
+        const auto& cmd = m_Commands[i];
+        u32 shaderID = cmd.ShaderRef ? cmd.ShaderRef->GetRendererID() : 0;
+        u32 meshID = cmd.VAORef ? cmd.VAORef->GetRendererID() : 0;
+        f32 depth = (cmd.Depth - m_NearDepth) * invDepthRange;
+
+        m_SortedKeys[i].Key = RenderSortKey::Encode(cmd.Pass, cmd.Translucent, shaderID, cmd.MaterialId, meshID, depth);
+        m_SortedKeys[i].Index = i;
+    }
+
+    RadixSort(m_SortedKeys, m_SortScratch);
+    m_Sorted = true;
+}
+
 void RenderQueue::Flush() {
     m_Stats = {};
 
+    // Commands recorded after Sort() still need to be merged (and sorted)
+    const bool wasSorted = m_Sorted;
+    MergeBuckets();
+    if (wasSorted && !m_Sorted) {
+        Sort();
+    }
+
     u32 lastShaderID = 0;
+    u32 lastVAOID = 0;
 
-    for (const auto& cmd : m_Commands) {
+    const u32 count = static_cast<u32>(m_Commands.size());
+    for (u32 i = 0; i < count; ++i) {
+        const auto& cmd = m_Commands[m_Sorted ? m_SortedKeys[i].Index : i];
         if (!cmd.ShaderRef || !cmd.VAORef) {
             continue;
         }
@@ -25,13 +138,25 @@ void RenderQueue::Flush() {
         // Set transform uniform
         cmd.ShaderRef->SetMat4("u_Model", cmd.Transform);
 
-        // Bind VAO and draw
-        cmd.VAORef->Bind();
-        glDrawElements(GL_TRIANGLES, cmd.IndexCount, GL_UNSIGNED_INT, nullptr);
+        // Same for the VAO; the key groups equal meshes together
+        u32 vaoID = cmd.VAORef->GetRendererID();
+        if (vaoID != lastVAOID) {
+            cmd.VAORef->Bind();
+            lastVAOID = vaoID;
+            m_Stats.VAOBinds++;
+        }
+
+        PipelineWarmup::RecordDraw(GL_TRIANGLES);
+        glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(cmd.IndexCount), GL_UNSIGNED_INT,
+                                 reinterpret_cast<const void*>(static_cast<usize>(cmd.BaseIndex) * sizeof(u32)),
+                                 static_cast<GLint>(cmd.BaseVertex));
 
         m_Stats.DrawCalls++;
         m_Stats.Triangles += cmd.IndexCount / 3;
     }
+
+    s_QueueDrawCalls.Add(m_Stats.DrawCalls);
+    s_QueueTriangles.Add(m_Stats.Triangles);
 }
 
 } // namespace Engine
@@ -1,49 +1,84 @@
 #pragma once
 
 #include "core/Types.hpp"
+#include "core/RadixSort.hpp"
 #include "renderer/RenderCommand.hpp"
 
-#include <algorithm>
+#include <atomic>
 
 namespace Engine {
 
+// RenderQueue - collects draw commands, sorts them and issues GL calls.
+//
+// Submit() is thread-safe: every JobSystem worker records into its own
+// bucket without locking, other threads share one spin-locked bucket.
+// Sort()/Flush() run on the GL thread once recording is done; they merge the
+// buckets into one stream (bucket storage is kept for the next frame) and
+// only then translate it into GL calls.
 class RenderQueue {
 public:
-    RenderQueue() = default;
+    RenderQueue();
     ~RenderQueue() = default;
 
-    void Submit(const RenderCommand& command) {
-        m_Commands.push_back(command);
-    }
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
 
+    void Submit(const RenderCommand& command);
     void Submit(Ref<Shader> shader, Ref<VertexArray> vao,
-                const glm::mat4& transform, u32 indexCount) {
-        m_Commands.emplace_back(shader, vao, transform, indexCount);
-    }
+                const glm::mat4& transform, u32 indexCount);
 
-    void Sort() {
-        std::sort(m_Commands.begin(), m_Commands.end());
+    // Range used to quantize RenderCommand::Depth into the sort key
+    void SetDepthRange(f32 nearDepth, f32 farDepth) {
+        m_NearDepth = nearDepth;
+        m_FarDepth = farDepth;
     }
 
+    // Merge buckets, build packed keys and radix sort them; commands
+    // themselves don't move
+    void Sort();
+
+    // Draw in sorted order (submission order if Sort() wasn't called)
     void Flush();
 
-    void Clear() {
-        m_Commands.clear();
-        m_Stats = {};
-    }
+    // GL thread only, not concurrently with Submit()
+    void Clear();
 
     struct Statistics {
         u32 DrawCalls = 0;
         u32 ShaderBinds = 0;
+        u32 VAOBinds = 0;
         u32 Triangles = 0;
     };
 
     const Statistics& GetStats() const { return m_Stats; }
 
-    usize GetCommandCount() const { return m_Commands.size(); }
+    // GL thread only; includes commands not merged yet
+    usize GetCommandCount() const;
+
+private:
+    // One per worker plus a shared one; padded so workers don't false-share
+    struct alignas(64) CommandBucket {
+        Vector<RenderCommand> Commands;
+    };
+
+    template<typename... Args>
+    void Record(Args&&... args);
+
+    void MergeBuckets();
+    void ResizeBuckets();
 
 private:
-    Vector<RenderCommand> m_Commands;
+    Vector<CommandBucket> m_Buckets;    // [0] shared, [1 + worker] per worker
+    std::atomic_flag m_SharedLock = ATOMIC_FLAG_INIT;
+
+    Vector<RenderCommand> m_Commands;   // Merged stream
+    Vector<SortKeyIndex> m_SortedKeys;
+    Vector<SortKeyIndex> m_SortScratch;
+    bool m_Sorted = false;
+
+    f32 m_NearDepth = 0.1f;
+    f32 m_FarDepth = 1000.0f;
+
     Statistics m_Stats;
 };
 
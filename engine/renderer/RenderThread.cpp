@@ -0,0 +1,101 @@
+#include "RenderThread.hpp"
+#include "core/Window.hpp"
+#include "core/Logger.hpp"
+#include "core/Profiler.hpp"
+#include "resources/ResourceManager.hpp"
+
+#include <GLFW/glfw3.h>
+
+namespace Engine {
+
+RenderThread::RenderThread(Window& window)
+    : m_Window(window)
+{
+    // A context is current on at most one thread
+    glfwMakeContextCurrent(nullptr);
+    m_Thread = std::thread([this] { ThreadMain(); });
+
+    // Loads issued from the main thread now go through the upload queue
+    ResourceManager::Instance().SetGLThread(m_Thread.get_id());
+
+    LOG_CORE_INFO("Render thread started");
+}
+
+RenderThread::~RenderThread() {
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Condition.wait(lock, [this] { return !m_Busy; });
+        m_Stopping = true;
+    }
+    m_Condition.notify_all();
+    m_Thread.join();
+
+    glfwMakeContextCurrent(m_Window.GetNativeWindow());
+    ResourceManager::Instance().SetGLThread(std::this_thread::get_id());
+
+    LOG_CORE_INFO("Render thread stopped");
+}
+
+void RenderThread::Submit() {
+    PROFILE_SCOPE("RenderThread::Submit");
+
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Condition.wait(lock, [this] { return !m_Busy; });
+        m_Busy = true;
+        m_WriteIndex ^= 1;
+    }
+    m_Condition.notify_all();
+}
+
+void RenderThread::WaitIdle() {
+    PROFILE_SCOPE("RenderThread::WaitIdle");
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Condition.wait(lock, [this] { return !m_Busy; });
+}
+
+void RenderThread::ThreadMain() {
+    PROFILE_THREAD("Render");
+    glfwMakeContextCurrent(m_Window.GetNativeWindow());
+
+    while (true) {
+        FramePacket* packet = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [this] { return m_Busy || m_Stopping; });
+            if (!m_Busy) break;
+
+            // Submit() flipped the write index past the packet it handed over
+            packet = &m_Packets[m_WriteIndex ^ 1];
+        }
+
+        Execute(*packet);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Busy = false;
+        }
+        m_Condition.notify_all();
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
+
+void RenderThread::Execute(FramePacket& packet) {
+    PROFILE_SCOPE("RenderFrame");
+    const u64 start = Profiler::Now();
+
+    for (const auto& command : packet.Commands) {
+        command(packet);
+    }
+
+    {
+        PROFILE_SCOPE("SwapBuffers");
+        m_Window.SwapBuffers();
+    }
+
+    m_RenderTimeMs = static_cast<f32>(static_cast<f64>(Profiler::Now() - start) / 1.0e6);
+}
+
+} // namespace Engine
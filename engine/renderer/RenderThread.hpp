@@ -0,0 +1,70 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/FramePacket.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Engine {
+
+class Window;
+
+// RenderThread - owns the window's GL context and draws frame N-1 while the
+// main thread simulates frame N.
+//
+// Packets are double-buffered: the main thread fills GetPacket() and hands
+// it over with Submit(), which swaps it with the one the render thread just
+// finished. The render thread runs the packet's commands in order and swaps
+// the window's buffers, so frame time becomes max(simulation, rendering)
+// rather than their sum. The main thread never waits for more than the
+// previous frame.
+//
+// Creating one moves the context off the calling thread (and makes the
+// render thread ResourceManager's GL thread); destroying it finishes the
+// last packet and moves the context back.
+//
+// Only packet commands draw: Application skips OnRender() and the Render /
+// PostRender system phases in this mode (see
+// Application::SetRenderThreadEnabled).
+class RenderThread {
+public:
+    explicit RenderThread(Window& window);
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    // The packet being filled; main thread only
+    FramePacket& GetPacket() { return m_Packets[m_WriteIndex]; }
+
+    // Hand GetPacket() to the render thread, waiting for the previous one first
+    void Submit();
+
+    // Block until the last submitted packet has been drawn and presented
+    void WaitIdle();
+
+    // Render thread time of the last packet, swap included
+    f32 GetRenderTimeMs() const { return m_RenderTimeMs; }
+
+private:
+    void ThreadMain();
+    void Execute(FramePacket& packet);
+
+private:
+    Window& m_Window;
+    std::thread m_Thread;
+
+    FramePacket m_Packets[2];
+    u32 m_WriteIndex = 0;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_Busy = false;        // A packet is submitted and not presented yet
+    bool m_Stopping = false;
+
+    f32 m_RenderTimeMs = 0.0f;  // Written by the render thread while m_Busy
+};
+
+} // namespace Engine
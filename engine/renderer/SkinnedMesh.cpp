@@ -0,0 +1,93 @@
+#include "renderer/SkinnedMesh.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "animation/Skeleton.hpp"
+#include "core/Logger.hpp"
+#include <glad/gl.h>
+#include <algorithm>
+
+namespace Engine {
+
+SkinnedMesh::SkinnedMesh(const Skeleton& skeleton, Vector<Vertex> vertices, Vector<u32> indices,
+                         Vector<SkinWeights> weights)
+    : m_Vertices(std::move(vertices))
+    , m_Indices(std::move(indices))
+    , m_Weights(std::move(weights)) {
+    if (m_Weights.size() != m_Vertices.size()) {
+        LOG_CORE_WARN("SkinnedMesh: {} weights for {} vertices; the rest follow joint 0",
+                      m_Weights.size(), m_Vertices.size());
+        m_Weights.resize(m_Vertices.size());
+    }
+
+    const u32 jointCount = skeleton.GetJointCount();
+    const auto& bindModels = skeleton.GetBindModelMatrices();
+    m_JointRadii.assign(jointCount, -1.0f);
+
+    for (usize v = 0; v < m_Vertices.size(); ++v) {
+        const glm::vec3& position = m_Vertices[v].Position;
+        if (v == 0) {
+            m_Bounds = AABB(position, position);
+        } else {
+            m_Bounds.ExpandToInclude(position);
+        }
+
+        SkinWeights& skin = m_Weights[v];
+        for (u32 i = 0; i < 4; ++i) {
+            if (skin.Joints[i] >= jointCount) {
+                skin.Joints[i] = 0;
+                skin.Weights[i] = 0.0f;
+            }
+            if (skin.Weights[i] <= 0.0f) continue;
+
+            const u32 joint = skin.Joints[i];
+            const f32 distance = glm::length(position - glm::vec3(bindModels[joint][3]));
+            m_JointRadii[joint] = std::max(m_JointRadii[joint], distance);
+        }
+    }
+}
+
+SkinnedMesh::~SkinnedMesh() {
+    if (m_SourceBuffer) {
+        GLMemory::DeleteBuffers(1, &m_SourceBuffer);
+    }
+}
+
+void SkinnedMesh::Upload() {
+    if (m_SourceBuffer || m_Vertices.empty()) return;
+
+    Vector<GPUSkinVertex> source(m_Vertices.size());
+    for (usize v = 0; v < m_Vertices.size(); ++v) {
+        const Vertex& vertex = m_Vertices[v];
+        const SkinWeights& skin = m_Weights[v];
+        GPUSkinVertex& out = source[v];
+
+        out.Position = vertex.Position;
+        out.Normal = vertex.Normal;
+        out.Tangent = vertex.Tangent;
+        out.Bitangent = vertex.Bitangent;
+        out.U = vertex.TexCoords.x;
+        out.V = vertex.TexCoords.y;
+        out.Joints = static_cast<u32>(skin.Joints[0]) | (static_cast<u32>(skin.Joints[1]) << 8) |
+                     (static_cast<u32>(skin.Joints[2]) << 16) | (static_cast<u32>(skin.Joints[3]) << 24);
+        out.Weights = glm::vec4(skin.Weights[0], skin.Weights[1], skin.Weights[2], skin.Weights[3]);
+    }
+
+    glCreateBuffers(1, &m_SourceBuffer);
+    GLMemory::BufferStorage(m_SourceBuffer, source.size() * sizeof(GPUSkinVertex), source.data(), 0,
+                            MemoryTag::Geometry);
+}
+
+Ref<Mesh> SkinnedMesh::CreateInstance(const Ref<GeometryPool>& pool) const {
+    auto mesh = CreateRef<Mesh>(m_Vertices, m_Indices);
+    mesh->SetName(m_Name);
+    mesh->SetVertexFormat(VertexFormat::Full);
+    mesh->SetDepthStream(true);
+    mesh->SetResidency(MeshResidency::GPUOnly);
+    if (pool) {
+        mesh->Upload(pool);
+    } else {
+        mesh->Upload();
+    }
+    return mesh;
+}
+
+} // namespace Engine
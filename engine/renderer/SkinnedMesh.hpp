@@ -0,0 +1,84 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/Mesh.hpp"
+
+namespace Engine {
+
+class Skeleton;
+
+// Up to four joints moving one vertex. Weights sum to 1; unused slots
+// weigh 0.
+struct SkinWeights {
+    u8 Joints[4] = {};
+    f32 Weights[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+};
+
+// One bind-pose vertex as skinning.glsl reads it. Mirrors the std430
+// SkinVertex struct there, keep both in sync.
+struct GPUSkinVertex {
+    glm::vec3 Position;
+    u32 Joints = 0;         // Four u8 joint indices, first in the low byte
+    glm::vec3 Normal;
+    f32 U = 0.0f;
+    glm::vec3 Tangent;
+    f32 V = 0.0f;
+    glm::vec3 Bitangent;
+    u32 Padding = 0;
+    glm::vec4 Weights;
+};
+static_assert(sizeof(GPUSkinVertex) == 80, "GPUSkinVertex must match the std430 layout");
+
+// SkinnedMesh - bind-pose geometry of a skinned model and the joints that
+// move each vertex, shared by every entity playing it.
+//
+// It is never drawn itself: SkinningSystem gives each entity an instance
+// (CreateInstance), a pooled Mesh the compute pass overwrites with the
+// skinned vertices once a frame, reading the bind pose from the buffer
+// Upload creates.
+class SkinnedMesh {
+public:
+    // weights holds one entry per vertex, joints indexing skeleton
+    SkinnedMesh(const Skeleton& skeleton, Vector<Vertex> vertices, Vector<u32> indices, Vector<SkinWeights> weights);
+    ~SkinnedMesh();
+
+    SkinnedMesh(const SkinnedMesh&) = delete;
+    SkinnedMesh& operator=(const SkinnedMesh&) = delete;
+
+    // Create the bind-pose buffer skinning reads. GL thread.
+    void Upload();
+    bool IsUploaded() const { return m_SourceBuffer != 0; }
+    u32 GetSourceBuffer() const { return m_SourceBuffer; }
+
+    // A Mesh of the bind pose in the Full vertex format with a depth
+    // stream, uploaded into pool and keeping nothing on the CPU. GL thread.
+    Ref<Mesh> CreateInstance(const Ref<GeometryPool>& pool) const;
+
+    u32 GetVertexCount() const { return static_cast<u32>(m_Vertices.size()); }
+    const Vector<Vertex>& GetVertices() const { return m_Vertices; }
+    const Vector<u32>& GetIndices() const { return m_Indices; }
+    const Vector<SkinWeights>& GetWeights() const { return m_Weights; }
+
+    // Bind-pose bounds
+    const AABB& GetBounds() const { return m_Bounds; }
+
+    // How far the vertices each joint moves lie from it in the bind pose;
+    // negative for joints that move none. Under rigid joint motion every
+    // skinned vertex stays inside the spheres of its joints, which is how
+    // AnimationSystem bounds the animated mesh.
+    const Vector<f32>& GetJointRadii() const { return m_JointRadii; }
+
+    const String& GetName() const { return m_Name; }
+    void SetName(const String& name) { m_Name = name; }
+
+private:
+    Vector<Vertex> m_Vertices;
+    Vector<u32> m_Indices;
+    Vector<SkinWeights> m_Weights;
+    Vector<f32> m_JointRadii;
+    AABB m_Bounds;
+    u32 m_SourceBuffer = 0;
+    String m_Name;
+};
+
+} // namespace Engine
@@ -0,0 +1,131 @@
+#include "renderer/SkinningSystem.hpp"
+#include "renderer/SkinnedMesh.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "resources/ResourceManager.hpp"
+#include "core/Logger.hpp"
+#include <glad/gl.h>
+#include <algorithm>
+
+namespace Engine {
+
+void SkinningSystem::OnCreate(entt::registry& registry) {
+    (void)registry;
+    m_Ring = CreateScope<GPURingBuffer>(1024 * sizeof(glm::mat4));
+    OnReload();
+}
+
+void SkinningSystem::OnDestroy(entt::registry& registry) {
+    (void)registry;
+    m_Ring.reset();
+    m_Shader.reset();
+}
+
+void SkinningSystem::OnReload() {
+    m_Shader = CreateRef<Shader>("assets/shaders/animation/skinning.glsl");
+}
+
+bool SkinningSystem::CreateInstance(entt::registry& registry, entt::entity entity, SkinnedMeshComponent& skinned) {
+    ResourceManager& resources = ResourceManager::Instance();
+
+    Ref<Mesh> instance = skinned.Source->CreateInstance(resources.GetGeometryPool());
+    if (!instance->IsUploaded()) {
+        LOG_CORE_ERROR("SkinningSystem: Could not upload an instance of '{}'", skinned.Source->GetName());
+        return false;
+    }
+
+    MeshComponent& meshComponent = registry.get_or_emplace<MeshComponent>(entity);
+    meshComponent.Mesh = resources.AddMesh(instance);
+    meshComponent.LocalBounds = skinned.Source->GetBounds();
+    meshComponent.LocalSphere = BoundingSphere::FromAABB(meshComponent.LocalBounds);
+    skinned.Instance = std::move(instance);
+    return true;
+}
+
+void SkinningSystem::OnUpdate(entt::registry& registry, f32 deltaTime) {
+    (void)deltaTime;
+    m_Stats = {};
+    m_Jobs.clear();
+    m_Palettes.clear();
+
+    auto view = registry.view<SkinnedMeshComponent, AnimatorComponent>();
+    for (auto entity : view) {
+        auto& skinned = view.get<SkinnedMeshComponent>(entity);
+        const auto& animator = view.get<AnimatorComponent>(entity);
+
+        SkinnedMesh* source = skinned.Source.get();
+        if (!source || source->GetVertexCount() == 0 || animator.Palette.empty()) continue;
+
+        source->Upload();
+        if (!skinned.Instance && !CreateInstance(registry, entity, skinned)) continue;
+
+        const Mesh& instance = *skinned.Instance;
+        const VertexBuffer* vertices = instance.GetVertexBuffer();
+        if (!source->IsUploaded() || !vertices) continue;
+
+        PendingJob job;
+        job.Source = source;
+        job.VertexBuffer = vertices->GetRendererID();
+        job.PositionBuffer = instance.GetPositionBuffer() ? instance.GetPositionBuffer()->GetRendererID() : 0;
+        job.Job.VertexCount = source->GetVertexCount();
+        job.Job.OutputVertex = instance.GetBaseVertex();
+        job.Job.PaletteOffset = static_cast<u32>(m_Palettes.size());
+        m_Palettes.insert(m_Palettes.end(), animator.Palette.begin(), animator.Palette.end());
+        m_Jobs.push_back(job);
+
+        m_Stats.Instances++;
+        m_Stats.Vertices += job.Job.VertexCount;
+    }
+
+    if (!m_Jobs.empty() && m_Shader) {
+        Dispatch();
+    }
+}
+
+void SkinningSystem::Dispatch() {
+    // Instances sharing a source and output buffers go in one dispatch
+    std::sort(m_Jobs.begin(), m_Jobs.end(), [](const PendingJob& a, const PendingJob& b) {
+        if (a.Source != b.Source) return a.Source < b.Source;
+        if (a.VertexBuffer != b.VertexBuffer) return a.VertexBuffer < b.VertexBuffer;
+        return a.PositionBuffer < b.PositionBuffer;
+    });
+
+    GLStateCache& state = GLStateCache::Instance();
+    m_Ring->BeginFrame();
+    const auto palettes = m_Ring->Upload(m_Palettes.data(), m_Palettes.size());
+
+    m_Shader->Bind();
+    GPURingBuffer::BindRange(GL_SHADER_STORAGE_BUFFER, PaletteBinding, palettes);
+
+    for (usize first = 0; first < m_Jobs.size();) {
+        const PendingJob& group = m_Jobs[first];
+        usize last = first;
+        u32 maxVertices = 0;
+        m_GroupJobs.clear();
+        while (last < m_Jobs.size() && m_Jobs[last].Source == group.Source &&
+               m_Jobs[last].VertexBuffer == group.VertexBuffer &&
+               m_Jobs[last].PositionBuffer == group.PositionBuffer) {
+            m_GroupJobs.push_back(m_Jobs[last].Job);
+            maxVertices = std::max(maxVertices, m_Jobs[last].Job.VertexCount);
+            ++last;
+        }
+
+        const auto jobs = m_Ring->Upload(m_GroupJobs.data(), m_GroupJobs.size());
+        state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, SourceBinding, group.Source->GetSourceBuffer());
+        GPURingBuffer::BindRange(GL_SHADER_STORAGE_BUFFER, JobBinding, jobs);
+        state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, VertexBinding, group.VertexBuffer);
+        if (group.PositionBuffer) {
+            state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, PositionBinding, group.PositionBuffer);
+        }
+        m_Shader->SetInt("u_WritePositions", group.PositionBuffer ? 1 : 0);
+
+        glDispatchCompute((maxVertices + 63) / 64, static_cast<u32>(m_GroupJobs.size()), 1);
+        m_Stats.Dispatches++;
+        first = last;
+    }
+
+    // The passes after this fetch the instances as vertex attributes
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    m_Ring->EndFrame();
+}
+
+} // namespace Engine
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "ecs/System.hpp"
+#include "ecs/Components/Animation.hpp"
+#include "ecs/Components/Renderable.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include "renderer/opengl/GPURingBuffer.hpp"
+
+namespace Engine {
+
+class SkinnedMesh;
+
+// SkinningSystem - compute skinning of every animated entity, once a frame.
+//
+// Each entity with a SkinnedMeshComponent and an AnimatorComponent gets its
+// own instance of the bind-pose mesh in ResourceManager's GeometryPool, put
+// in its MeshComponent. Every update the palettes AnimationSystem left go
+// into one SSBO and animation/skinning.glsl writes the skinned vertices,
+// and their depth stream positions, over the instances - one dispatch per
+// source mesh and pool page. The depth prepass, G-buffer, shadow cascades
+// and spot / point atlas all draw the instances as ordinary meshes, so a
+// vertex is skinned once however many passes read it.
+//
+// Run after AnimationSystem and before anything draws. Motion vectors come
+// from the entity transform alone, not the skinning.
+class SkinningSystem : public ISystem {
+public:
+    DEFINE_SYSTEM(SkinningSystem, PreRender, 2)
+    SYSTEM_ACCESS(.Read<AnimatorComponent>().Write<SkinnedMeshComponent, MeshComponent>().MainThread())
+
+    struct Stats {
+        u32 Instances = 0;      // Skinned this frame
+        u32 Vertices = 0;
+        u32 Dispatches = 0;
+    };
+
+    void OnCreate(entt::registry& registry) override;
+    void OnDestroy(entt::registry& registry) override;
+    void OnUpdate(entt::registry& registry, f32 deltaTime) override;
+    void OnReload() override;
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    // Mirrors SkinJob in skinning.glsl, keep both in sync
+    struct GPUSkinJob {
+        u32 VertexCount = 0;
+        u32 OutputVertex = 0;
+        u32 PaletteOffset = 0;
+        u32 Padding = 0;
+    };
+
+    struct PendingJob {
+        const SkinnedMesh* Source = nullptr;
+        u32 VertexBuffer = 0;
+        u32 PositionBuffer = 0;     // 0 without a depth stream
+        GPUSkinJob Job;
+    };
+
+    // Give the entity its instance and a MeshComponent drawing it
+    bool CreateInstance(entt::registry& registry, entt::entity entity, SkinnedMeshComponent& skinned);
+
+    void Dispatch();
+
+private:
+    static constexpr u32 SourceBinding = 0;
+    static constexpr u32 PaletteBinding = 1;
+    static constexpr u32 JobBinding = 2;
+    static constexpr u32 VertexBinding = 3;
+    static constexpr u32 PositionBinding = 4;
+
+    Ref<Shader> m_Shader;
+    Scope<GPURingBuffer> m_Ring;
+
+    Vector<PendingJob> m_Jobs;
+    Vector<GPUSkinJob> m_GroupJobs;
+    Vector<glm::mat4> m_Palettes;
+    Stats m_Stats;
+};
+
+} // namespace Engine
@@ -1,7 +1,15 @@
 #include "renderer/Texture.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/TextureUploadRing.hpp"
 #include "core/Logger.hpp"
+#include "core/MappedFile.hpp"
 
 #include <glad/gl.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -10,6 +18,253 @@ namespace Engine {
 
 namespace {
 
+// Extension enums, not in the core 4.5 headers
+constexpr GLenum CompressedRGBAS3TCDXT1 = 0x83F1;
+constexpr GLenum CompressedRGBAS3TCDXT5 = 0x83F3;
+constexpr GLenum CompressedRGBAASTC4x4 = 0x93B0;
+constexpr GLenum CompressedRGBAASTC6x6 = 0x93B4;
+constexpr GLenum CompressedRGBAASTC8x8 = 0x93B7;
+
+bool HasGLExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (extension && std::strcmp(extension, name) == 0) return true;
+    }
+    return false;
+}
+
+bool IsFormatSupported(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1:
+        case TextureFormat::BC3: {
+            static const bool s3tc = HasGLExtension("GL_EXT_texture_compression_s3tc");
+            return s3tc;
+        }
+        case TextureFormat::ASTC4x4:
+        case TextureFormat::ASTC6x6:
+        case TextureFormat::ASTC8x8: {
+            static const bool astc = HasGLExtension("GL_KHR_texture_compression_astc_ldr");
+            return astc;
+        }
+        default:
+            return true;
+    }
+}
+
+// Block footprint and bytes per block; 1x1 blocks of one texel otherwise
+struct BlockInfo {
+    u32 Width = 1;
+    u32 Height = 1;
+    u32 Bytes = 0;
+};
+
+BlockInfo GetBlockInfo(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1:
+        case TextureFormat::BC4:     return {4, 4, 8};
+        case TextureFormat::BC3:
+        case TextureFormat::BC5:
+        case TextureFormat::BC7:
+        case TextureFormat::ASTC4x4: return {4, 4, 16};
+        case TextureFormat::ASTC6x6: return {6, 6, 16};
+        case TextureFormat::ASTC8x8: return {8, 8, 16};
+        case TextureFormat::R8:      return {1, 1, 1};
+        case TextureFormat::RG8:     return {1, 1, 2};
+        case TextureFormat::RGB8:    return {1, 1, 3};
+        case TextureFormat::RGBA8:   return {1, 1, 4};
+        default:                     return {1, 1, 0};
+    }
+}
+
+// Mip chain of a container, level 0 first, each level's bytes read from
+// file at levelOffsets[i]
+bool CopyLevels(TextureImage& image, const u8* file, usize fileSize,
+                const Vector<u64>& levelOffsets, const String& filepath) {
+    usize total = 0;
+    for (usize i = 0; i < levelOffsets.size(); ++i) {
+        TextureMipLevel level;
+        level.Width = std::max(1u, image.Width >> i);
+        level.Height = std::max(1u, image.Height >> i);
+        level.Offset = total;
+        level.Size = GetTextureLevelSize(image.Format, level.Width, level.Height);
+        if (levelOffsets[i] > fileSize || level.Size > fileSize - levelOffsets[i]) {
+            LOG_CORE_ERROR("Texture {}: mip level {} lies outside the file", filepath, i);
+            return false;
+        }
+        total += level.Size;
+        image.Levels.push_back(level);
+    }
+
+    image.Pixels.resize(total);
+    for (usize i = 0; i < levelOffsets.size(); ++i) {
+        std::memcpy(image.Pixels.data() + image.Levels[i].Offset, file + levelOffsets[i], image.Levels[i].Size);
+    }
+    return true;
+}
+
+TextureFormat FromVkFormat(u32 vkFormat) {
+    switch (vkFormat) {
+        case 9:   return TextureFormat::R8;         // VK_FORMAT_R8_UNORM
+        case 16:  return TextureFormat::RG8;        // VK_FORMAT_R8G8_UNORM
+        case 37:                                    // VK_FORMAT_R8G8B8A8_UNORM
+        case 43:  return TextureFormat::RGBA8;      // _SRGB
+        case 131: case 132:                         // VK_FORMAT_BC1_RGB_UNORM/SRGB_BLOCK
+        case 133: case 134: return TextureFormat::BC1;  // BC1_RGBA
+        case 137: case 138: return TextureFormat::BC3;
+        case 139: return TextureFormat::BC4;        // VK_FORMAT_BC4_UNORM_BLOCK
+        case 141: return TextureFormat::BC5;        // VK_FORMAT_BC5_UNORM_BLOCK
+        case 145: case 146: return TextureFormat::BC7;
+        case 157: case 158: return TextureFormat::ASTC4x4;
+        case 165: case 166: return TextureFormat::ASTC6x6;
+        case 171: case 172: return TextureFormat::ASTC8x8;
+        default:  return TextureFormat::None;
+    }
+}
+
+TextureFormat FromDXGIFormat(u32 dxgiFormat) {
+    switch (dxgiFormat) {
+        case 28: case 29: return TextureFormat::RGBA8;  // DXGI_FORMAT_R8G8B8A8_UNORM(_SRGB)
+        case 71: case 72: return TextureFormat::BC1;    // DXGI_FORMAT_BC1_UNORM(_SRGB)
+        case 77: case 78: return TextureFormat::BC3;
+        case 80: return TextureFormat::BC4;             // DXGI_FORMAT_BC4_UNORM
+        case 83: return TextureFormat::BC5;             // DXGI_FORMAT_BC5_UNORM
+        case 98: case 99: return TextureFormat::BC7;
+        default: return TextureFormat::None;
+    }
+}
+
+constexpr u32 FourCC(char a, char b, char c, char d) {
+    return static_cast<u32>(static_cast<u8>(a)) | (static_cast<u32>(static_cast<u8>(b)) << 8) |
+           (static_cast<u32>(static_cast<u8>(c)) << 16) | (static_cast<u32>(static_cast<u8>(d)) << 24);
+}
+
+u32 ReadU32(const u8* data) {
+    u32 value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+u64 ReadU64(const u8* data) {
+    u64 value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// KTX 2.0: 2D, one layer, one face, no supercompression
+bool DecodeKTX2(const u8* data, usize size, const String& filepath, TextureImage& image) {
+    static const u8 identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+    constexpr usize HeaderSize = 80;    // Identifier, header and index
+    constexpr usize LevelEntrySize = 24;
+
+    if (size < HeaderSize || std::memcmp(data, identifier, sizeof(identifier)) != 0) {
+        LOG_CORE_ERROR("Texture {}: not a KTX2 file", filepath);
+        return false;
+    }
+
+    const u32 vkFormat = ReadU32(data + 12);
+    const u32 width = ReadU32(data + 20);
+    const u32 height = ReadU32(data + 24);
+    const u32 depth = ReadU32(data + 28);
+    const u32 layers = ReadU32(data + 32);
+    const u32 faces = ReadU32(data + 36);
+    const u32 levelCount = std::max(1u, ReadU32(data + 40));
+    const u32 supercompression = ReadU32(data + 44);
+
+    image.Format = FromVkFormat(vkFormat);
+    if (image.Format == TextureFormat::None) {
+        LOG_CORE_ERROR("Texture {}: unsupported KTX2 vkFormat {}", filepath, vkFormat);
+        return false;
+    }
+    if (depth > 1 || layers > 1 || faces != 1 || width == 0 || height == 0) {
+        LOG_CORE_ERROR("Texture {}: only single 2D KTX2 images are supported", filepath);
+        return false;
+    }
+    if (supercompression != 0) {
+        LOG_CORE_ERROR("Texture {}: KTX2 supercompression scheme {} is not supported", filepath, supercompression);
+        return false;
+    }
+    if (size < HeaderSize + static_cast<usize>(levelCount) * LevelEntrySize) {
+        LOG_CORE_ERROR("Texture {}: truncated KTX2 level index", filepath);
+        return false;
+    }
+
+    image.Width = width;
+    image.Height = height;
+
+    Vector<u64> offsets(levelCount);
+    for (u32 i = 0; i < levelCount; ++i) {
+        offsets[i] = ReadU64(data + HeaderSize + i * LevelEntrySize);
+    }
+    return CopyLevels(image, data, size, offsets, filepath);
+}
+
+// DDS with a legacy FourCC (DXT1 / DXT5 / ATI1 / ATI2) or a DX10 header
+bool DecodeDDS(const u8* data, usize size, const String& filepath, TextureImage& image) {
+    constexpr usize HeaderSize = 4 + 124;   // Magic and DDS_HEADER
+    constexpr usize DX10HeaderSize = 20;
+    constexpr u32 PixelFormatFourCC = 0x4;
+
+    if (size < HeaderSize || ReadU32(data) != FourCC('D', 'D', 'S', ' ')) {
+        LOG_CORE_ERROR("Texture {}: not a DDS file", filepath);
+        return false;
+    }
+
+    const u32 height = ReadU32(data + 12);
+    const u32 width = ReadU32(data + 16);
+    const u32 levelCount = std::max(1u, ReadU32(data + 28));
+    const u32 pixelFlags = ReadU32(data + 80);
+    const u32 fourCC = ReadU32(data + 84);
+
+    usize dataOffset = HeaderSize;
+    image.Format = TextureFormat::None;
+    if (pixelFlags & PixelFormatFourCC) {
+        if (fourCC == FourCC('D', 'X', '1', '0')) {
+            if (size < HeaderSize + DX10HeaderSize) {
+                LOG_CORE_ERROR("Texture {}: truncated DDS DX10 header", filepath);
+                return false;
+            }
+            image.Format = FromDXGIFormat(ReadU32(data + HeaderSize));
+            dataOffset += DX10HeaderSize;
+        } else if (fourCC == FourCC('D', 'X', 'T', '1')) {
+            image.Format = TextureFormat::BC1;
+        } else if (fourCC == FourCC('D', 'X', 'T', '5')) {
+            image.Format = TextureFormat::BC3;
+        } else if (fourCC == FourCC('A', 'T', 'I', '1') || fourCC == FourCC('B', 'C', '4', 'U')) {
+            image.Format = TextureFormat::BC4;
+        } else if (fourCC == FourCC('A', 'T', 'I', '2') || fourCC == FourCC('B', 'C', '5', 'U')) {
+            image.Format = TextureFormat::BC5;
+        }
+    }
+    if (image.Format == TextureFormat::None || width == 0 || height == 0) {
+        LOG_CORE_ERROR("Texture {}: unsupported DDS pixel format", filepath);
+        return false;
+    }
+
+    image.Width = width;
+    image.Height = height;
+
+    // Levels follow each other, largest first
+    Vector<u64> offsets(levelCount);
+    u64 offset = dataOffset;
+    for (u32 i = 0; i < levelCount; ++i) {
+        offsets[i] = offset;
+        offset += GetTextureLevelSize(image.Format, std::max(1u, width >> i), std::max(1u, height >> i));
+    }
+    return CopyLevels(image, data, size, offsets, filepath);
+}
+
+bool HasExtension(const String& filepath, const char* extension) {
+    const usize length = std::strlen(extension);
+    if (filepath.size() < length) return false;
+    for (usize i = 0; i < length; ++i) {
+        const char c = static_cast<char>(std::tolower(static_cast<unsigned char>(filepath[filepath.size() - length + i])));
+        if (c != extension[i]) return false;
+    }
+    return true;
+}
+
 GLenum TextureFormatToGL(TextureFormat format) {
     switch (format) {
         case TextureFormat::R8:              return GL_R8;
@@ -25,6 +280,14 @@ GLenum TextureFormatToGL(TextureFormat format) {
         case TextureFormat::RGB32F:          return GL_RGB32F;
         case TextureFormat::RGBA32F:         return GL_RGBA32F;
         case TextureFormat::Depth24Stencil8: return GL_DEPTH24_STENCIL8;
+        case TextureFormat::BC1:             return CompressedRGBAS3TCDXT1;
+        case TextureFormat::BC3:             return CompressedRGBAS3TCDXT5;
+        case TextureFormat::BC4:             return GL_COMPRESSED_RED_RGTC1;
+        case TextureFormat::BC5:             return GL_COMPRESSED_RG_RGTC2;
+        case TextureFormat::BC7:             return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        case TextureFormat::ASTC4x4:         return CompressedRGBAASTC4x4;
+        case TextureFormat::ASTC6x6:         return CompressedRGBAASTC6x6;
+        case TextureFormat::ASTC8x8:         return CompressedRGBAASTC8x8;
         default: return GL_RGBA8;
     }
 }
@@ -122,73 +385,137 @@ u32 GetChannelCount(TextureFormat format) {
     }
 }
 
+// Pointer argument of the upload calls for byte offset of image.Pixels: an
+// offset into the staged copy, with the ring bound for unpacking, or the
+// client pixels. UnbindPixelSource() afterwards, since other client-memory
+// uploads expect no unpack buffer.
+const void* BindPixelSource(const TextureImage& image, usize offset) {
+    if (image.Staging && image.Staging->IsValid()) {
+        GLStateCache::Instance().BindBuffer(GL_PIXEL_UNPACK_BUFFER, image.Staging->Buffer);
+        return reinterpret_cast<const void*>(image.Staging->Offset + offset);
+    }
+    return image.Pixels.data() + offset;
+}
+
+void UnbindPixelSource() {
+    GLStateCache::Instance().BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
 } // namespace
 
-Texture2D::Texture2D(const TextureSpecification& spec)
-    : m_Width(spec.Width), m_Height(spec.Height), m_Format(spec.Format) {
-    CreateTexture(spec);
-    m_IsLoaded = true;
+usize GetTextureLevelSize(TextureFormat format, u32 width, u32 height) {
+    const BlockInfo block = GetBlockInfo(format);
+    const usize blocksX = (width + block.Width - 1) / block.Width;
+    const usize blocksY = (height + block.Height - 1) / block.Height;
+    return blocksX * blocksY * block.Bytes;
 }
 
-Texture2D::Texture2D(const String& filepath, bool flipVertically)
-    : m_FilePath(filepath) {
-    stbi_set_flip_vertically_on_load(flipVertically ? 1 : 0);
+u32 TextureImage::GetChannelCount() const {
+    switch (Format) {
+        case TextureFormat::BC4: return 1;
+        case TextureFormat::BC5: return 2;
+        case TextureFormat::BC1: return 3;
+        default: return IsCompressedFormat(Format) ? 4 : ::Engine::GetChannelCount(Format);
+    }
+}
+
+void TextureImage::Stage() {
+    if (!Staging) {
+        Staging = TextureUploadRing::Stage(Pixels.data(), Pixels.size());
+    }
+}
+
+TextureImage TextureImage::Decode(const String& filepath, bool flipVertically) {
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        LOG_CORE_ERROR("Failed to load texture: {}", filepath);
+        return TextureImage();
+    }
+    return Decode(file.Data(), file.Size(), filepath, flipVertically);
+}
+
+TextureImage TextureImage::Decode(const u8* data, usize size, const String& filepath, bool flipVertically) {
+    TextureImage image;
+
+    if (HasExtension(filepath, ".ktx2") || HasExtension(filepath, ".dds")) {
+        const bool decoded = HasExtension(filepath, ".ktx2") ? DecodeKTX2(data, size, filepath, image)
+                                                             : DecodeDDS(data, size, filepath, image);
+        if (!decoded) {
+            return TextureImage();
+        }
+        return image;
+    }
+
+    // Per-thread flag, so concurrent decodes don't race on stb_image's global
+    stbi_set_flip_vertically_on_load_thread(flipVertically ? 1 : 0);
 
     int width, height, channels;
-    stbi_uc* data = stbi_load(filepath.c_str(), &width, &height, &channels, 0);
+    stbi_uc* pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, 0);
 
-    if (!data) {
+    if (!pixels) {
         LOG_CORE_ERROR("Failed to load texture: {}", filepath);
         LOG_CORE_ERROR("stb_image error: {}", stbi_failure_reason());
-        return;
+        return image;
     }
 
-    m_Width = static_cast<u32>(width);
-    m_Height = static_cast<u32>(height);
-
     switch (channels) {
-        case 1: m_Format = TextureFormat::R8; break;
-        case 2: m_Format = TextureFormat::RG8; break;
-        case 3: m_Format = TextureFormat::RGB8; break;
-        case 4: m_Format = TextureFormat::RGBA8; break;
+        case 1: image.Format = TextureFormat::R8; break;
+        case 2: image.Format = TextureFormat::RG8; break;
+        case 3: image.Format = TextureFormat::RGB8; break;
+        case 4: image.Format = TextureFormat::RGBA8; break;
         default:
             LOG_CORE_ERROR("Unsupported channel count: {}", channels);
-            stbi_image_free(data);
-            return;
+            stbi_image_free(pixels);
+            return image;
     }
 
-    TextureSpecification spec;
-    spec.Width = m_Width;
-    spec.Height = m_Height;
-    spec.Format = m_Format;
-    spec.GenerateMipmaps = true;
-    spec.MinFilter = TextureFilter::LinearMipmapLinear;
-    spec.MagFilter = TextureFilter::Linear;
+    image.Width = static_cast<u32>(width);
+    image.Height = static_cast<u32>(height);
+    image.Pixels.assign(pixels, pixels + static_cast<usize>(width) * height * channels);
+    stbi_image_free(pixels);
+    return image;
+}
 
+Texture2D::Texture2D(const TextureSpecification& spec)
+    : m_Width(spec.Width), m_Height(spec.Height), m_Format(spec.Format) {
     CreateTexture(spec);
+    m_IsLoaded = true;
+}
 
-    glTextureSubImage2D(
-        m_RendererID, 0, 0, 0,
-        m_Width, m_Height,
-        TextureFormatToBaseFormat(m_Format),
-        GL_UNSIGNED_BYTE,
-        data
-    );
-
-    if (spec.GenerateMipmaps) {
-        glGenerateTextureMipmap(m_RendererID);
+Texture2D::Texture2D(const String& filepath, bool flipVertically)
+    : m_FilePath(filepath) {
+    TextureImage image = TextureImage::Decode(filepath, flipVertically);
+    if (!image.IsValid()) {
+        return;
     }
 
-    stbi_image_free(data);
-    m_IsLoaded = true;
+    Upload(image);
+
+    LOG_CORE_INFO("Loaded texture: {} ({}x{}, {} channels{})",
+                     filepath, m_Width, m_Height, image.GetChannelCount(),
+                     IsCompressedFormat(m_Format) ? ", compressed" : "");
+}
 
-    LOG_CORE_INFO("Loaded texture: {} ({}x{}, {} channels)",
-                     filepath, m_Width, m_Height, channels);
+Ref<Texture2D> Texture2D::CreatePending(const String& filepath, bool placeholder) {
+    Ref<Texture2D> texture;
+    if (placeholder) {
+        TextureSpecification spec;
+        spec.GenerateMipmaps = false;
+
+        texture = CreateRef<Texture2D>(spec);
+        const u32 white = 0xFFFFFFFFu;
+        texture->SetData(&white, sizeof(white));
+    } else {
+        texture = Ref<Texture2D>(new Texture2D());
+    }
+    texture->m_FilePath = filepath;
+    texture->m_IsLoaded = false;
+    return texture;
 }
 
 Texture2D::~Texture2D() {
     if (m_RendererID) {
-        glDeleteTextures(1, &m_RendererID);
+        GLMemory::DeleteTextures(1, &m_RendererID);
     }
 }
 
@@ -197,8 +524,12 @@ Texture2D::Texture2D(Texture2D&& other) noexcept
     , m_Width(other.m_Width)
     , m_Height(other.m_Height)
     , m_Format(other.m_Format)
+    , m_MipCount(other.m_MipCount)
+    , m_ResidentMip(other.m_ResidentMip)
+    , m_StoredMips(other.m_StoredMips)
     , m_FilePath(std::move(other.m_FilePath))
-    , m_IsLoaded(other.m_IsLoaded) {
+    , m_IsLoaded(other.m_IsLoaded)
+    , m_ContentVersion(other.m_ContentVersion) {
     other.m_RendererID = 0;
     other.m_IsLoaded = false;
 }
@@ -206,15 +537,19 @@ Texture2D::Texture2D(Texture2D&& other) noexcept
 Texture2D& Texture2D::operator=(Texture2D&& other) noexcept {
     if (this != &other) {
         if (m_RendererID) {
-            glDeleteTextures(1, &m_RendererID);
+            GLMemory::DeleteTextures(1, &m_RendererID);
         }
 
         m_RendererID = other.m_RendererID;
         m_Width = other.m_Width;
         m_Height = other.m_Height;
         m_Format = other.m_Format;
+        m_MipCount = other.m_MipCount;
+        m_ResidentMip = other.m_ResidentMip;
+        m_StoredMips = other.m_StoredMips;
         m_FilePath = std::move(other.m_FilePath);
         m_IsLoaded = other.m_IsLoaded;
+        m_ContentVersion = other.m_ContentVersion;
 
         other.m_RendererID = 0;
         other.m_IsLoaded = false;
@@ -223,20 +558,33 @@ Texture2D& Texture2D::operator=(Texture2D&& other) noexcept {
 }
 
 void Texture2D::Bind(u32 slot) const {
-    glBindTextureUnit(slot, m_RendererID);
+    GLStateCache::Instance().BindTextureUnit(slot, m_RendererID);
 }
 
 void Texture2D::Unbind() const {
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::Instance().BindTextureUnit(0, 0);
 }
 
 void Texture2D::SetData(const void* data, u32 size) {
+    if (IsCompressedFormat(m_Format)) {
+        LOG_CORE_ERROR("SetData is not supported on compressed textures");
+        return;
+    }
+
     u32 bpp = GetChannelCount(m_Format);
     if (size != m_Width * m_Height * bpp) {
         LOG_CORE_ERROR("Data size must match texture dimensions!");
         return;
     }
 
+    // Through the ring when it has room, so the call doesn't wait on the
+    // driver's copy of client memory
+    Ref<TextureStaging> staging = TextureUploadRing::Stage(data, size);
+    if (staging) {
+        GLStateCache::Instance().BindBuffer(GL_PIXEL_UNPACK_BUFFER, staging->Buffer);
+        data = reinterpret_cast<const void*>(staging->Offset);
+    }
+
     glTextureSubImage2D(
         m_RendererID, 0, 0, 0,
         m_Width, m_Height,
@@ -244,6 +592,224 @@ void Texture2D::SetData(const void* data, u32 size) {
         TextureFormatToDataType(m_Format),
         data
     );
+
+    if (staging) {
+        UnbindPixelSource();
+    }
+}
+
+void Texture2D::SetSubData(const void* data, u32 x, u32 y, u32 width, u32 height) {
+    if (IsCompressedFormat(m_Format)) {
+        LOG_CORE_ERROR("SetSubData is not supported on compressed textures");
+        return;
+    }
+
+    if (x + width > m_Width || y + height > m_Height) {
+        LOG_CORE_ERROR("SetSubData region exceeds texture dimensions!");
+        return;
+    }
+
+    Ref<TextureStaging> staging = TextureUploadRing::Stage(data, static_cast<usize>(width) * height * GetChannelCount(m_Format));
+    if (staging) {
+        GLStateCache::Instance().BindBuffer(GL_PIXEL_UNPACK_BUFFER, staging->Buffer);
+        data = reinterpret_cast<const void*>(staging->Offset);
+    }
+
+    glTextureSubImage2D(
+        m_RendererID, 0, x, y,
+        width, height,
+        TextureFormatToBaseFormat(m_Format),
+        TextureFormatToDataType(m_Format),
+        data
+    );
+
+    if (staging) {
+        UnbindPixelSource();
+    }
+}
+
+void Texture2D::Upload(const TextureImage& image, u32 firstMip) {
+    if (!image.IsValid()) {
+        LOG_CORE_ERROR("Texture2D::Upload: empty image for {}", m_FilePath);
+        return;
+    }
+
+    const bool compressed = IsCompressedFormat(image.Format);
+    if (compressed && !IsFormatSupported(image.Format)) {
+        LOG_CORE_ERROR("Texture2D::Upload: {} uses a compressed format this driver lacks", m_FilePath);
+        return;
+    }
+    if (compressed && image.Levels.empty()) {
+        LOG_CORE_ERROR("Texture2D::Upload: compressed image {} has no levels", m_FilePath);
+        return;
+    }
+
+    if (m_RendererID) {
+        GLMemory::DeleteTextures(1, &m_RendererID);
+        m_RendererID = 0;
+    }
+
+    m_Width = image.Width;
+    m_Height = image.Height;
+    m_Format = image.Format;
+
+    TextureSpecification spec;
+    spec.Width = m_Width;
+    spec.Height = m_Height;
+    spec.Format = m_Format;
+    spec.GenerateMipmaps = image.Levels.empty();
+    spec.MinFilter = TextureFilter::LinearMipmapLinear;
+    spec.MagFilter = TextureFilter::Linear;
+
+    if (spec.GenerateMipmaps) {
+        CreateTexture(spec);
+        m_ResidentMip = 0;
+        m_StoredMips = false;
+
+        glTextureSubImage2D(
+            m_RendererID, 0, 0, 0,
+            m_Width, m_Height,
+            TextureFormatToBaseFormat(m_Format),
+            GL_UNSIGNED_BYTE,
+            BindPixelSource(image, 0)
+        );
+        UnbindPixelSource();
+
+        glGenerateTextureMipmap(m_RendererID);
+        m_IsLoaded = true;
+        return;
+    }
+
+    // Stored mip chain, uploaded level by level
+    const u32 levelCount = static_cast<u32>(image.Levels.size());
+    firstMip = std::min(firstMip, levelCount - 1);
+
+    m_RendererID = CreateLevelStorage(image, firstMip);
+    for (u32 i = firstMip; i < levelCount; ++i) {
+        UploadLevel(m_RendererID, image, i, firstMip);
+    }
+    UnbindPixelSource();
+
+    m_MipCount = levelCount;
+    m_ResidentMip = firstMip;
+    m_StoredMips = true;
+    m_IsLoaded = true;
+}
+
+void Texture2D::SetResidentMip(const TextureImage& image, u32 mip) {
+    if (!m_StoredMips || image.Levels.size() != m_MipCount || image.Format != m_Format) {
+        LOG_CORE_ERROR("Texture2D::SetResidentMip: {} was not uploaded from this mip chain", m_FilePath);
+        return;
+    }
+
+    mip = std::min(mip, m_MipCount - 1);
+    if (mip == m_ResidentMip) return;
+
+    const u32 texture = CreateLevelStorage(image, mip);
+    for (u32 i = mip; i < m_MipCount; ++i) {
+        if (i < m_ResidentMip) {
+            UploadLevel(texture, image, i, mip);
+            continue;
+        }
+
+        // Already on the GPU; whole levels, so block formats copy as-is
+        const TextureMipLevel& level = image.Levels[i];
+        glCopyImageSubData(m_RendererID, GL_TEXTURE_2D, static_cast<GLint>(i - m_ResidentMip), 0, 0, 0,
+                           texture, GL_TEXTURE_2D, static_cast<GLint>(i - mip), 0, 0, 0,
+                           level.Width, level.Height, 1);
+    }
+    UnbindPixelSource();
+
+    GLMemory::DeleteTextures(1, &m_RendererID);
+    m_RendererID = texture;
+    m_ResidentMip = mip;
+}
+
+bool Texture2D::CanUpdate(const TextureImage& image) const {
+    if (!m_RendererID || !m_IsLoaded || !image.IsValid()) return false;
+    if (image.Width != m_Width || image.Height != m_Height || image.Format != m_Format) return false;
+
+    if (m_StoredMips) {
+        return image.Levels.size() == m_MipCount;
+    }
+    return image.Levels.empty();
+}
+
+void Texture2D::UpdateRows(const TextureImage& image, u32 firstRow, u32 rowCount) {
+    if (m_StoredMips || !CanUpdate(image)) {
+        LOG_CORE_ERROR("Texture2D::UpdateRows: image does not match the storage of {}", m_FilePath);
+        return;
+    }
+
+    firstRow = std::min(firstRow, m_Height);
+    rowCount = std::min(rowCount, m_Height - firstRow);
+    if (rowCount == 0) return;
+
+    const usize rowSize = static_cast<usize>(m_Width) * image.GetChannelCount();
+    glTextureSubImage2D(
+        m_RendererID, 0, 0, static_cast<GLint>(firstRow),
+        m_Width, rowCount,
+        TextureFormatToBaseFormat(m_Format),
+        GL_UNSIGNED_BYTE,
+        BindPixelSource(image, firstRow * rowSize)
+    );
+    UnbindPixelSource();
+
+    glGenerateTextureMipmap(m_RendererID);
+    m_ContentVersion++;
+}
+
+void Texture2D::UpdateLevel(const TextureImage& image, u32 mip) {
+    if (!m_StoredMips || !CanUpdate(image)) {
+        LOG_CORE_ERROR("Texture2D::UpdateLevel: image does not match the mip chain of {}", m_FilePath);
+        return;
+    }
+    if (mip < m_ResidentMip || mip >= m_MipCount) return;
+
+    UploadLevel(m_RendererID, image, mip, m_ResidentMip);
+    UnbindPixelSource();
+    m_ContentVersion++;
+}
+
+usize Texture2D::GetMemorySize() const {
+    usize size = 0;
+    for (u32 i = m_StoredMips ? m_ResidentMip : 0; i < m_MipCount; ++i) {
+        size += GetTextureLevelSize(m_Format, std::max(1u, m_Width >> i), std::max(1u, m_Height >> i));
+    }
+    return size;
+}
+
+u32 Texture2D::CreateLevelStorage(const TextureImage& image, u32 firstMip) const {
+    const u32 levelCount = static_cast<u32>(image.Levels.size()) - firstMip;
+    const TextureMipLevel& first = image.Levels[firstMip];
+
+    TextureSpecification spec;
+    spec.MinFilter = levelCount > 1 ? TextureFilter::LinearMipmapLinear : TextureFilter::Linear;
+    spec.MagFilter = TextureFilter::Linear;
+
+    u32 texture = 0;
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    GLMemory::TextureStorage2D(texture, levelCount, TextureFormatToGL(image.Format), first.Width, first.Height,
+                               MemoryTag::Resources);
+    glTextureParameteri(texture, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levelCount - 1));
+    glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, TextureFilterToGL(spec.MinFilter));
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, TextureFilterToGL(spec.MagFilter));
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, TextureWrapToGL(spec.WrapS));
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, TextureWrapToGL(spec.WrapT));
+    return texture;
+}
+
+void Texture2D::UploadLevel(u32 texture, const TextureImage& image, u32 mip, u32 firstMip) const {
+    const TextureMipLevel& level = image.Levels[mip];
+    const void* pixels = BindPixelSource(image, level.Offset);
+    const GLint target = static_cast<GLint>(mip - firstMip);
+    if (IsCompressedFormat(image.Format)) {
+        glCompressedTextureSubImage2D(texture, target, 0, 0, level.Width, level.Height,
+                                      TextureFormatToGL(image.Format), static_cast<GLsizei>(level.Size), pixels);
+    } else {
+        glTextureSubImage2D(texture, target, 0, 0, level.Width, level.Height,
+                            TextureFormatToBaseFormat(image.Format), GL_UNSIGNED_BYTE, pixels);
+    }
 }
 
 void Texture2D::CreateTexture(const TextureSpecification& spec) {
@@ -253,13 +819,15 @@ void Texture2D::CreateTexture(const TextureSpecification& spec) {
     if (spec.GenerateMipmaps) {
         mipLevels = static_cast<u32>(std::floor(std::log2(std::max(spec.Width, spec.Height)))) + 1;
     }
+    m_MipCount = mipLevels;
 
-    glTextureStorage2D(
+    GLMemory::TextureStorage2D(
         m_RendererID,
         mipLevels,
         TextureFormatToGL(spec.Format),
         spec.Width,
-        spec.Height
+        spec.Height,
+        MemoryTag::Resources
     );
 
     SetFilterAndWrap(spec);
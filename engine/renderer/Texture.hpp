@@ -19,9 +19,25 @@ enum class TextureFormat {
     RG32F,
     RGB32F,
     RGBA32F,
-    Depth24Stencil8
+    Depth24Stencil8,
+
+    // Block compressed, loaded from KTX2 / DDS with their mip chains. BC1 /
+    // BC3 need EXT_texture_compression_s3tc and ASTC KHR_texture_compression_astc_ldr;
+    // RGTC (BC4 / BC5) and BPTC (BC7) are core.
+    BC1,        // RGB(A1), 8 bytes per 4x4 block
+    BC3,        // RGBA, 16 bytes
+    BC4,        // R, 8 bytes
+    BC5,        // RG, 16 bytes
+    BC7,        // RGBA, 16 bytes
+    ASTC4x4,
+    ASTC6x6,
+    ASTC8x8
 };
 
+inline bool IsCompressedFormat(TextureFormat format) {
+    return format >= TextureFormat::BC1;
+}
+
 enum class TextureFilter {
     Nearest,
     Linear,
@@ -50,12 +66,59 @@ struct TextureSpecification {
     glm::vec4 BorderColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 };
 
+struct TextureMipLevel {
+    u32 Width = 0;
+    u32 Height = 0;
+    usize Offset = 0;       // Into TextureImage::Pixels
+    usize Size = 0;
+};
+
+struct TextureStaging;
+
+// Pixels of an image file, decoded without touching GL so it can run on a
+// worker thread; Texture2D::Upload takes it from there on the GL thread.
+// Stage() copies the pixels into the TextureUploadRing on that worker too,
+// and the uploads then read the staged copy instead of Pixels.
+// PNG / JPG / TGA / BMP go through stb_image. KTX2 (no supercompression) and
+// DDS are read with their stored mip chain and uploaded as stored, so
+// flipVertically does not apply to them - TextureCooker flips when cooking.
+struct TextureImage {
+    u32 Width = 0;
+    u32 Height = 0;
+    TextureFormat Format = TextureFormat::None;
+    Vector<u8> Pixels;              // Every level, back to back
+    Vector<TextureMipLevel> Levels; // Empty: Pixels is level 0 and mips are generated on upload
+    Ref<TextureStaging> Staging;    // Copy of Pixels in the upload ring, if staged
+
+    bool IsValid() const { return !Pixels.empty(); }
+    u32 GetChannelCount() const;
+
+    // Stage Pixels for upload; stays unstaged when the ring is full or not
+    // initialized. Any thread.
+    void Stage();
+
+    static TextureImage Decode(const String& filepath, bool flipVertically = true);
+
+    // Decode an image already in memory; filepath picks the container and names it in errors
+    static TextureImage Decode(const u8* data, usize size, const String& filepath, bool flipVertically = true);
+};
+
+// Bytes of one width x height level of format (block formats round up to
+// whole blocks)
+usize GetTextureLevelSize(TextureFormat format, u32 width, u32 height);
+
 class Texture2D {
 public:
     Texture2D(const TextureSpecification& spec);
     Texture2D(const String& filepath, bool flipVertically = true);
     ~Texture2D();
 
+    // 1x1 white stand-in for filepath while it loads elsewhere. IsLoaded()
+    // stays false until Upload() gives it the real image. Without the
+    // placeholder no GL call is made (and nothing can be sampled), so any
+    // thread may create one.
+    static Ref<Texture2D> CreatePending(const String& filepath, bool placeholder = true);
+
     Texture2D(const Texture2D&) = delete;
     Texture2D& operator=(const Texture2D&) = delete;
 
@@ -67,6 +130,45 @@ public:
 
     void SetData(const void* data, u32 size);
 
+    // Rewrite a width x height region of level 0 at (x, y), tightly packed;
+    // mips are left as they are
+    void SetSubData(const void* data, u32 x, u32 y, u32 width, u32 height);
+
+    // Replace the storage with a decoded image (new size, format and mips).
+    // With a stored mip chain only levels firstMip and smaller are made
+    // resident; GetWidth() / GetHeight() still report level 0.
+    void Upload(const TextureImage& image, u32 firstMip = 0);
+
+    // Move the first resident level of a stored mip chain to mip, adding the
+    // missing levels from image (the one given to Upload) and copying the
+    // ones already resident on the GPU. The GL name changes.
+    void SetResidentMip(const TextureImage& image, u32 mip);
+
+    // Whether image can rewrite the current storage in place: same size and
+    // format, and the same stored chain or none. The UpdateX functions keep
+    // the GL name, so bindless handles and bindings made from it stay valid.
+    bool CanUpdate(const TextureImage& image) const;
+
+    // Rewrite rows [firstRow, firstRow + rowCount) of level 0 and regenerate
+    // the mips (no stored chain)
+    void UpdateRows(const TextureImage& image, u32 firstRow, u32 rowCount);
+
+    // Rewrite one level of a stored chain; non-resident levels are skipped
+    void UpdateLevel(const TextureImage& image, u32 mip);
+
+    // Bumped whenever an UpdateX call changes the contents, for copies of
+    // the texture (MaterialLibrary's array layers) to follow
+    u32 GetContentVersion() const { return m_ContentVersion; }
+
+    // Levels of the full chain, and the largest one currently in storage.
+    // Only textures with a stored chain can be partially resident.
+    u32 GetMipCount() const { return m_MipCount; }
+    u32 GetResidentMip() const { return m_ResidentMip; }
+    bool HasStoredMips() const { return m_StoredMips; }
+
+    // Bytes of the resident levels
+    usize GetMemorySize() const;
+
     u32 GetWidth() const { return m_Width; }
     u32 GetHeight() const { return m_Height; }
     u32 GetRendererID() const { return m_RendererID; }
@@ -80,16 +182,27 @@ public:
     }
 
 private:
+    Texture2D() = default;  // No storage, see CreatePending
+
     void CreateTexture(const TextureSpecification& spec);
     void SetFilterAndWrap(const TextureSpecification& spec);
 
+    // Immutable storage for levels firstMip.. of image, filtered as Upload does
+    u32 CreateLevelStorage(const TextureImage& image, u32 firstMip) const;
+    // Leaves a staged image's ring bound for unpacking; callers unbind after their last level
+    void UploadLevel(u32 texture, const TextureImage& image, u32 mip, u32 firstMip) const;
+
 private:
     u32 m_RendererID = 0;
     u32 m_Width = 0;
     u32 m_Height = 0;
     TextureFormat m_Format = TextureFormat::None;
+    u32 m_MipCount = 1;
+    u32 m_ResidentMip = 0;
+    bool m_StoredMips = false;
     String m_FilePath;
     bool m_IsLoaded = false;
+    u32 m_ContentVersion = 0;
 };
 
 } // namespace Engine
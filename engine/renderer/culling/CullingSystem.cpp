@@ -0,0 +1,219 @@
+#include "CullingSystem.hpp"
+#include "core/JobSystem.hpp"
+#include "math/CullingKernels.hpp"
+
+#include <atomic>
+
+namespace Engine {
+
+void CullingSystem::OnCreate(entt::registry& registry) {
+    registry.on_construct<StaticGeometry>().connect<&CullingSystem::OnStaticChanged>(this);
+    registry.on_construct<MeshComponent>().connect<&CullingSystem::OnStaticChanged>(this);
+    registry.on_update<MeshComponent>().connect<&CullingSystem::OnStaticChanged>(this);
+    m_Connected = true;
+    m_StaticBoundsDirty = true;
+}
+
+void CullingSystem::OnDestroy(entt::registry& registry) {
+    if (!m_Connected) return;
+
+    registry.on_construct<StaticGeometry>().disconnect<&CullingSystem::OnStaticChanged>(this);
+    registry.on_construct<MeshComponent>().disconnect<&CullingSystem::OnStaticChanged>(this);
+    registry.on_update<MeshComponent>().disconnect<&CullingSystem::OnStaticChanged>(this);
+    m_Connected = false;
+    m_Index.Clear();
+}
+
+void CullingSystem::OnStaticChanged(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    (void)entity;
+    m_StaticBoundsDirty = true;
+}
+
+void CullingSystem::OnUpdate(entt::registry& registry, f32 deltaTime) {
+    (void)deltaTime;
+
+    m_Entities.clear();
+    for (auto entity : registry.view<Transform, MeshComponent, Renderable>()) {
+        m_Entities.push_back(entity);
+    }
+    m_SoAStart = static_cast<u32>(m_Entities.size());
+    for (auto entity : registry.view<WorldTransform, MeshComponent, Renderable>(entt::exclude<Transform>)) {
+        m_Entities.push_back(entity);
+    }
+
+    const u32 count = static_cast<u32>(m_Entities.size());
+    m_Bounds.resize(count);
+    m_IsStatic.resize(count);
+
+    const bool cull = m_CullingEnabled && m_Camera;
+
+    // Resolve storages up front; the chunks below only read and patch them
+    auto& transforms = registry.storage<Transform>();
+    auto& worlds = registry.storage<WorldTransform>();
+    auto& meshes = registry.storage<MeshComponent>();
+    auto& renderables = registry.storage<Renderable>();
+    auto& statics = registry.storage<StaticGeometry>();
+
+    const bool refreshStatic = m_StaticBoundsDirty;
+    std::atomic<u32> updatedCount{0};
+
+    JobSystem::ParallelFor(count, 1024, [&](u32 first, u32 last) {
+        u32 updated = 0;
+
+        for (u32 i = first; i < last; ++i) {
+            entt::entity entity = m_Entities[i];
+            auto& renderable = renderables.get(entity);
+            const bool isStatic = statics.contains(entity);
+
+            if (refreshStatic || !isStatic) {
+                const glm::mat4& world = i < m_SoAStart
+                    ? transforms.get(entity).WorldMatrix
+                    : worlds.get(entity).Matrix;
+
+                renderable.WorldBounds = meshes.get(entity).LocalBounds.Transform(world);
+                renderable.WorldSphere = BoundingSphere::FromAABB(renderable.WorldBounds);
+                ++updated;
+            }
+
+            m_Bounds[i] = renderable.WorldBounds;
+            m_IsStatic[i] = isStatic ? 1 : 0;
+
+            // With culling, the tree walk below marks what is visible
+            renderable.InFrustum = !cull;
+        }
+
+        updatedCount.fetch_add(updated, std::memory_order_relaxed);
+    });
+
+    UpdateSpatialIndex(refreshStatic);
+    m_StaticBoundsDirty = false;
+
+    u32 visible = count;
+    u32 accepted = 0;
+    u32 sphereTests = 0;
+    m_Stats.SubtreesAccepted = 0;
+    m_Stats.SubtreesRejected = 0;
+    m_Stats.SettledBySubtree = 0;
+
+    // Each frustum marks what it sees; InFrustum ends up as the union
+    auto cullFrustum = [&](const Frustum& frustum) {
+        u32 acceptedByFrustum = 0;
+        m_Candidates.clear();
+
+        const bool subtrees = m_Subtrees.Classify(registry, frustum);
+        m_Stats.SubtreesAccepted += m_Subtrees.GetStats().Accepted;
+        m_Stats.SubtreesRejected += m_Subtrees.GetStats().Rejected;
+
+        m_Index.QueryFrustum(frustum, [&](entt::entity entity, bool fullyInside) {
+            if (!fullyInside && subtrees) {
+                const Frustum::Containment settled = m_Subtrees.Get(entity);
+                if (settled != Frustum::Containment::Intersects) {
+                    ++m_Stats.SettledBySubtree;
+                    if (settled == Frustum::Containment::Outside) return;
+                    fullyInside = true;
+                }
+            }
+
+            if (fullyInside) {
+                renderables.get(entity).InFrustum = true;
+                ++acceptedByFrustum;
+            } else {
+                m_Candidates.push_back(entity);
+            }
+        });
+
+        const u32 candidateCount = static_cast<u32>(m_Candidates.size());
+        m_CenterX.resize(candidateCount);
+        m_CenterY.resize(candidateCount);
+        m_CenterZ.resize(candidateCount);
+        m_Radius.resize(candidateCount);
+        m_Visible.resize(candidateCount);
+
+        std::atomic<u32> visibleCount{0};
+
+        JobSystem::ParallelFor(candidateCount, 1024, [&](u32 first, u32 last) {
+            for (u32 i = first; i < last; ++i) {
+                const auto& sphere = renderables.get(m_Candidates[i]).WorldSphere;
+                m_CenterX[i] = sphere.Center.x;
+                m_CenterY[i] = sphere.Center.y;
+                m_CenterZ[i] = sphere.Center.z;
+                m_Radius[i] = sphere.Radius;
+            }
+
+            SphereStreams spheres{m_CenterX.data() + first, m_CenterY.data() + first,
+                                  m_CenterZ.data() + first, m_Radius.data() + first};
+            u32 visibleInChunk = CullingKernels::TestSpheres(frustum, spheres, m_Visible.data() + first, last - first);
+
+            for (u32 i = first; i < last; ++i) {
+                if (m_Visible[i]) {
+                    renderables.get(m_Candidates[i]).InFrustum = true;
+                }
+            }
+
+            visibleCount.fetch_add(visibleInChunk, std::memory_order_relaxed);
+        });
+
+        accepted += acceptedByFrustum;
+        sphereTests += candidateCount;
+        return acceptedByFrustum + visibleCount.load(std::memory_order_relaxed);
+    };
+
+    if (cull) {
+        visible = cullFrustum(m_Camera->GetFrustum());
+
+        u32 viewFrustums = 0;
+        for (const Camera* camera : m_ViewCameras) {
+            if (!camera) continue;
+            cullFrustum(camera->GetFrustum());
+            ++viewFrustums;
+        }
+
+        // Views overlap, so count the union rather than summing
+        if (viewFrustums > 0) {
+            visible = 0;
+            for (entt::entity entity : m_Entities) {
+                visible += renderables.get(entity).InFrustum ? 1 : 0;
+            }
+        }
+    }
+
+    m_Stats.Tested = count;
+    m_Stats.Visible = visible;
+    m_Stats.Culled = count - visible;
+    m_Stats.BoundsUpdated = updatedCount.load(std::memory_order_relaxed);
+    m_Stats.AcceptedByTree = accepted;
+    m_Stats.SphereTests = sphereTests;
+}
+
+void CullingSystem::UpdateSpatialIndex(bool refreshStatic) {
+    m_PendingStatic.clear();
+    m_DynamicEntities.clear();
+    m_DynamicBounds.clear();
+
+    const u32 count = static_cast<u32>(m_Entities.size());
+    for (u32 i = 0; i < count; ++i) {
+        if (m_IsStatic[i]) {
+            m_PendingStatic.push_back(m_Entities[i]);
+        } else {
+            m_DynamicEntities.push_back(m_Entities[i]);
+            m_DynamicBounds.push_back(m_Bounds[i]);
+        }
+    }
+
+    // Static tree only changes when statics were added, removed or invalidated
+    if (refreshStatic || m_PendingStatic != m_StaticEntities) {
+        m_StaticEntities.swap(m_PendingStatic);
+        m_StaticBounds.clear();
+        for (u32 i = 0; i < count; ++i) {
+            if (m_IsStatic[i]) {
+                m_StaticBounds.push_back(m_Bounds[i]);
+            }
+        }
+        m_Index.UpdateStatic(m_StaticEntities, m_StaticBounds);
+    }
+
+    m_Index.UpdateDynamic(m_DynamicEntities, m_DynamicBounds);
+}
+
+} // namespace Engine
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "ecs/System.hpp"
+#include "ecs/Components/Transform.hpp"
+#include "ecs/Components/TransformSoA.hpp"
+#include "ecs/Components/Renderable.hpp"
+#include "renderer/culling/SpatialIndex.hpp"
+#include "renderer/culling/SubtreeCulling.hpp"
+#include "camera/Camera.hpp"
+
+namespace Engine {
+
+// CullingSystem - computes world bounds and camera visibility for renderables.
+//
+// Every frame the world AABB / bounding sphere of each renderable is refreshed
+// (StaticGeometry only when invalidated) and fed into the SpatialIndex: the
+// static tree is rebuilt when the static set changes, the dynamic tree is
+// refitted. Culling walks both trees; subtrees fully inside the frustum are
+// accepted wholesale, items in straddling leaves are streamed into SoA arrays
+// and tested with CullingKernels, 4 or 8 spheres per plane test. The result
+// is written to Renderable::InFrustum, which the geometry pass already honours.
+// Before each frustum, Hierarchy subtrees are classified by their
+// SubtreeBounds (SubtreeCulling); straddling items inside a subtree found
+// wholly outside or inside skip the sphere test.
+//
+// The index is exposed for other consumers (shadow casters, picking, light
+// volumes); it is valid after this system's update for the current frame.
+//
+// Occlusion is not tested on the CPU: MeshletCuller tests meshlets against
+// the previous frame's Hi-Z pyramid on the GPU, which nothing reads back.
+class CullingSystem : public ISystem {
+public:
+    DEFINE_SYSTEM(CullingSystem, PreRender, 5)
+    SYSTEM_ACCESS(.Read<Transform, WorldTransform, MeshComponent, StaticGeometry, Hierarchy, SubtreeBounds>()
+                  .Write<Renderable>())
+
+    struct Stats {
+        u32 Tested = 0;
+        u32 Visible = 0;
+        u32 Culled = 0;
+        u32 BoundsUpdated = 0;
+        u32 AcceptedByTree = 0;   // Visible without a per-item test
+        u32 SphereTests = 0;      // Items from straddling leaves
+        u32 SubtreesAccepted = 0; // Hierarchy subtrees wholly inside a frustum
+        u32 SubtreesRejected = 0;
+        u32 SettledBySubtree = 0; // Straddling items that skipped the sphere test
+    };
+
+    void OnCreate(entt::registry& registry) override;
+    void OnDestroy(entt::registry& registry) override;
+    void OnUpdate(entt::registry& registry, f32 deltaTime) override;
+
+    // Camera reference (set by application, same as DeferredLightingSystem)
+    void SetCamera(Camera* camera) { m_Camera = camera; }
+
+    // Extra cameras rendered this frame (DeferredLightingSystem views);
+    // InFrustum becomes visible from any of them
+    void SetViewCameras(const Vector<const Camera*>& cameras) { m_ViewCameras = cameras; }
+
+    // When disabled every renderable is reported as in frustum
+    void SetCullingEnabled(bool enabled) { m_CullingEnabled = enabled; }
+    bool IsCullingEnabled() const { return m_CullingEnabled; }
+
+    // Recompute StaticGeometry bounds on the next update (e.g. after moving
+    // static entities in the editor)
+    void InvalidateStaticBounds() { m_StaticBoundsDirty = true; }
+
+    const Stats& GetStats() const { return m_Stats; }
+
+    const SpatialIndex& GetSpatialIndex() const { return m_Index; }
+
+private:
+    void OnStaticChanged(entt::registry& registry, entt::entity entity);
+    void UpdateSpatialIndex(bool refreshStatic);
+
+private:
+    Camera* m_Camera = nullptr;
+    Vector<const Camera*> m_ViewCameras;
+    bool m_CullingEnabled = true;
+    bool m_StaticBoundsDirty = true;
+    bool m_Connected = false;
+
+    // Renderables gathered this frame. Entities before m_SoAStart use
+    // Transform, the rest use WorldTransform.
+    Vector<entt::entity> m_Entities;
+    u32 m_SoAStart = 0;
+    Vector<AABB> m_Bounds;
+    Vector<u8> m_IsStatic;
+
+    SpatialIndex m_Index;
+    Vector<entt::entity> m_StaticEntities;
+    Vector<AABB> m_StaticBounds;
+    Vector<entt::entity> m_PendingStatic;
+    Vector<entt::entity> m_DynamicEntities;
+    Vector<AABB> m_DynamicBounds;
+
+    // SoA sphere streams for the frustum test, indexed like m_Candidates
+    Vector<entt::entity> m_Candidates;
+    Vector<f32> m_CenterX;
+    Vector<f32> m_CenterY;
+    Vector<f32> m_CenterZ;
+    Vector<f32> m_Radius;
+    Vector<u8> m_Visible;
+
+    SubtreeCulling m_Subtrees;
+
+    Stats m_Stats;
+};
+
+} // namespace Engine
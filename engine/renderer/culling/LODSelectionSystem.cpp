@@ -0,0 +1,83 @@
+#include "LODSelectionSystem.hpp"
+#include "resources/ResourceManager.hpp"
+#include "renderer/Mesh.hpp"
+#include "renderer/impostor/ImpostorLibrary.hpp"
+#include "renderer/RenderGroups.hpp"
+
+#include <algorithm>
+
+namespace Engine {
+
+void LODSelectionSystem::OnCreate(entt::registry& registry) {
+    // Packed and indexable, so a slice can resume at a position
+    RenderableGroup(registry);
+}
+
+void LODSelectionSystem::OnUpdate(entt::registry& registry, f32 deltaTime) {
+    (void)deltaTime;
+
+    m_Stats = {};
+    if (!m_Camera) return;
+
+    auto group = RenderableGroup(registry);
+
+    const ResourceManager& resources = ResourceManager::Instance();
+    const ImpostorLibrary& impostors = ImpostorLibrary::Instance();
+    const bool useImpostors = m_Settings.Impostors && !impostors.IsEmpty();
+    const f32 impostorError = impostors.GetError();
+    const glm::vec3 cameraPos = m_Camera->GetPosition();
+    const f32 pixelsPerUnit = m_Camera->GetProjectionMatrix()[1][1] * 0.5f * static_cast<f32>(m_ViewportHeight);
+    const f32 refineAbove = m_Settings.MaxScreenError * (1.0f + m_Settings.Hysteresis);
+    const f32 coarsenBelow = m_Settings.MaxScreenError * (1.0f - m_Settings.Hysteresis);
+
+    const bool passCompleted = ForEachInSlice(static_cast<u32>(group.size()), [&](u32 index) {
+        auto [meshComponent, renderable] = group.get<MeshComponent, Renderable>(group[index]);
+        if (!renderable.Visible || !renderable.InFrustum) return;
+
+        const Mesh* mesh = resources.GetMesh(meshComponent.Mesh);
+        if (!mesh) return;
+
+        const u32 maxLevel = std::min(static_cast<u32>(renderable.MaxLODLevel), mesh->GetLODCount() - 1);
+        u32 level = std::min(static_cast<u32>(renderable.LODLevel), maxLevel);
+        const bool hasImpostor = useImpostors && impostors.Find(mesh) != ImpostorLibrary::NoImpostor;
+        bool impostor = hasImpostor && renderable.LODLevel == Renderable::ImpostorLevel;
+
+        if (m_Settings.Enabled && (maxLevel > 0 || hasImpostor)) {
+            // LOD errors are relative to the radius; scale to pixels at the
+            // sphere's nearest point
+            const BoundingSphere& sphere = renderable.WorldSphere;
+            const f32 distance = std::max(glm::length(sphere.Center - cameraPos) - sphere.Radius, 0.1f);
+            const f32 pixelsPerError = sphere.Radius * pixelsPerUnit / distance;
+
+            // The impostor comes after the coarsest level, never finer
+            const f32 error = hasImpostor ? std::max(impostorError, mesh->GetLOD(maxLevel).Error) : 0.0f;
+            if (impostor && error * pixelsPerError > refineAbove) {
+                impostor = false;
+            }
+            if (!impostor) {
+                while (level > 0 && mesh->GetLOD(level).Error * pixelsPerError > refineAbove) {
+                    --level;
+                }
+                while (level < maxLevel && mesh->GetLOD(level + 1).Error * pixelsPerError <= coarsenBelow) {
+                    ++level;
+                }
+                impostor = hasImpostor && level == maxLevel && error * pixelsPerError <= coarsenBelow;
+            }
+        } else {
+            level = 0;
+            impostor = false;
+        }
+
+        const u32 selected = impostor ? Renderable::ImpostorLevel : level;
+        ++m_Stats.Selected;
+        if (selected > 0) ++m_Stats.Reduced;
+        if (impostor) ++m_Stats.Impostors;
+        if (selected != renderable.LODLevel) {
+            renderable.LODLevel = static_cast<u8>(selected);
+            ++m_Stats.Changed;
+        }
+    });
+    if (passCompleted) ++m_Stats.Passes;
+}
+
+} // namespace Engine
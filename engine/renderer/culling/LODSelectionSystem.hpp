@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ecs/System.hpp"
+#include "ecs/Components/Renderable.hpp"
+#include "camera/Camera.hpp"
+
+namespace Engine {
+
+// LODSelectionSystem - picks Renderable::LODLevel from projected mesh error.
+//
+// Each Mesh LOD records its deviation relative to the bounding sphere
+// radius; projected at the entity's distance that becomes an error in
+// pixels. The coarsest level under MaxScreenError is chosen, with a
+// hysteresis band around the threshold so objects near a boundary don't
+// flicker between levels frame to frame. Runs after CullingSystem and only
+// touches renderables in the frustum; the rest keep their last level.
+//
+// The geometry pass draws the selected level; shadows and extra views
+// reuse the main camera's choice. Past the coarsest level a mesh with an
+// ImpostorLibrary impostor moves on to Renderable::ImpostorLevel, using the
+// impostor's error the same way.
+//
+// Amortized: each update evaluates as many renderables as its slice allows
+// and the next one resumes from there, so with many renderables a level can
+// trail the camera by a few frames.
+class LODSelectionSystem : public ISystem {
+public:
+    DEFINE_SYSTEM(LODSelectionSystem, PreRender, 6)
+    SYSTEM_ACCESS(.Read<MeshComponent>().Write<Renderable>())
+    SYSTEM_AMORTIZED(0.25f, 2.0f)
+
+    struct Settings {
+        f32 MaxScreenError = 1.0f;  // Pixels
+        f32 Hysteresis = 0.15f;     // Fraction of MaxScreenError
+        bool Enabled = true;        // Off forces LOD 0
+        bool Impostors = true;      // Off keeps meshes with impostors on their LODs
+    };
+
+    struct Stats {
+        u32 Selected = 0;       // Renderables evaluated this frame
+        u32 Reduced = 0;        // Drawn below LOD 0
+        u32 Changed = 0;        // Level switched this frame
+        u32 Impostors = 0;      // Drawn as impostors
+        u32 Passes = 0;         // Full passes over the renderables completed
+    };
+
+    void OnCreate(entt::registry& registry) override;
+    void OnUpdate(entt::registry& registry, f32 deltaTime) override;
+
+    void SetCamera(Camera* camera) { m_Camera = camera; }
+    void SetViewportHeight(u32 height) { m_ViewportHeight = height; }
+
+    Settings& GetSettings() { return m_Settings; }
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    Camera* m_Camera = nullptr;
+    u32 m_ViewportHeight = 720;
+    Settings m_Settings;
+    Stats m_Stats;
+};
+
+} // namespace Engine
@@ -0,0 +1,285 @@
+#include "renderer/culling/MeshletCuller.hpp"
+#include "renderer/pipeline/HiZPyramid.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/Mesh.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 MaxGroupsPerDimension = 65535;
+
+u32 NextCapacity(u32 required) {
+    u32 capacity = 1024;
+    while (capacity < required) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+} // anonymous namespace
+
+MeshletCuller::MeshletCuller() {
+    m_InstanceRing = CreateScope<GPURingBuffer>(1024 * sizeof(InstanceData));
+    m_PreviousRing = CreateScope<GPURingBuffer>(1024 * sizeof(glm::mat4));
+    m_TaskRing = CreateScope<GPURingBuffer>(4096 * sizeof(Task));
+
+    glCreateBuffers(1, &m_CounterBuffer);
+    GLMemory::BufferStorage(m_CounterBuffer, sizeof(u32), nullptr, GL_DYNAMIC_STORAGE_BIT, MemoryTag::Renderer);
+
+    LoadShader();
+}
+
+MeshletCuller::~MeshletCuller() {
+    if (m_MeshletBuffer) GLMemory::DeleteBuffers(1, &m_MeshletBuffer);
+    if (m_OutputIndexBuffer) GLMemory::DeleteBuffers(1, &m_OutputIndexBuffer);
+    if (m_CommandBuffer) GLMemory::DeleteBuffers(1, &m_CommandBuffer);
+    if (m_CounterBuffer) GLMemory::DeleteBuffers(1, &m_CounterBuffer);
+    if (m_InstanceIndexBuffer) GLMemory::DeleteBuffers(1, &m_InstanceIndexBuffer);
+}
+
+void MeshletCuller::LoadShader() {
+    m_CullShader = CreateRef<Shader>("assets/shaders/deferred/meshlet_cull.glsl");
+}
+
+void MeshletCuller::Reload() {
+    LoadShader();
+}
+
+bool MeshletCuller::RegisterMesh(const Mesh& mesh) {
+    const Vector<Meshlet>& meshlets = mesh.GetMeshlets();
+    const u32 count = static_cast<u32>(meshlets.size());
+
+    auto it = m_Meshes.find(&mesh);
+    if (it != m_Meshes.end() && it->second.Data == meshlets.data() && it->second.MeshletCount == count) {
+        return true;
+    }
+    if (!m_MeshletBuffer || m_MeshletCount + count > m_MeshletCapacity) return false;
+
+    // Into the space the stored positions live in: the draw transform scales
+    // and offsets them back, and would do the same to mesh space bounds
+    const glm::vec4& dequant = mesh.GetPositionDequant();
+    const glm::vec3 offset(dequant);
+    Vector<Meshlet> converted(meshlets.begin(), meshlets.end());
+    for (Meshlet& meshlet : converted) {
+        meshlet.Center = (meshlet.Center - offset) / dequant.w;
+        meshlet.Radius /= dequant.w;
+        meshlet.ConeApex = (meshlet.ConeApex - offset) / dequant.w;
+    }
+    glNamedBufferSubData(m_MeshletBuffer, m_MeshletCount * sizeof(Meshlet), count * sizeof(Meshlet),
+                         converted.data());
+
+    // A replaced entry's old range stays dead until the next rebuild
+    MeshEntry& entry = m_Meshes[&mesh];
+    entry.Data = meshlets.data();
+    entry.FirstMeshlet = m_MeshletCount;
+    entry.MeshletCount = count;
+    m_MeshletCount += count;
+    return true;
+}
+
+void MeshletCuller::RebuildMeshletBuffer(const Vector<IndirectDrawBatcher::DrawItem>& items, u32 required) {
+    if (m_MeshletBuffer) {
+        GLMemory::DeleteBuffers(1, &m_MeshletBuffer);
+    }
+
+    // Only this frame's meshes come back, which also drops dead ones
+    m_Meshes.clear();
+    m_MeshletCount = 0;
+    m_MeshletCapacity = NextCapacity(std::max(required, m_MeshletCapacity));
+
+    glCreateBuffers(1, &m_MeshletBuffer);
+    GLMemory::BufferStorage(m_MeshletBuffer, m_MeshletCapacity * sizeof(Meshlet), nullptr, GL_DYNAMIC_STORAGE_BIT,
+                            MemoryTag::Renderer);
+
+    for (const auto& item : items) {
+        RegisterMesh(*item.ClusterMesh);
+    }
+}
+
+void MeshletCuller::EnsureOutputCapacity(u32 tasks, u32 indices) {
+    // Immutable storage, so growing means recreating; GL defers the release
+    // of buffers the GPU still reads
+    if (!m_CommandBuffer || tasks > m_CommandCapacity) {
+        if (m_CommandBuffer) GLMemory::DeleteBuffers(1, &m_CommandBuffer);
+        m_CommandCapacity = NextCapacity(tasks);
+        glCreateBuffers(1, &m_CommandBuffer);
+        GLMemory::BufferStorage(m_CommandBuffer, m_CommandCapacity * sizeof(DrawElementsIndirectCommand), nullptr, 0,
+                                MemoryTag::Renderer);
+    }
+
+    if (!m_OutputIndexBuffer || indices > m_OutputIndexCapacity) {
+        if (m_OutputIndexBuffer) GLMemory::DeleteBuffers(1, &m_OutputIndexBuffer);
+        m_OutputIndexCapacity = NextCapacity(indices);
+        glCreateBuffers(1, &m_OutputIndexBuffer);
+        GLMemory::BufferStorage(m_OutputIndexBuffer, m_OutputIndexCapacity * sizeof(u32), nullptr, 0,
+                                MemoryTag::Renderer);
+    }
+}
+
+void MeshletCuller::EnsureInstanceIndexCapacity(u32 required) {
+    if (m_InstanceIndexBuffer && required <= m_InstanceIndexCapacity) return;
+
+    if (m_InstanceIndexBuffer) {
+        GLMemory::DeleteBuffers(1, &m_InstanceIndexBuffer);
+    }
+
+    // Identity table, as in IndirectDrawBatcher: the command's baseInstance
+    // is the instance index
+    m_InstanceIndexCapacity = NextCapacity(required);
+    Vector<u32> indices(m_InstanceIndexCapacity);
+    for (u32 i = 0; i < m_InstanceIndexCapacity; ++i) {
+        indices[i] = i;
+    }
+    glCreateBuffers(1, &m_InstanceIndexBuffer);
+    GLMemory::BufferStorage(m_InstanceIndexBuffer, m_InstanceIndexCapacity * sizeof(u32), indices.data(), 0,
+                            MemoryTag::Renderer);
+}
+
+void MeshletCuller::Prepare(Vector<IndirectDrawBatcher::DrawItem>& items) {
+    m_Stats = {};
+    m_Groups.clear();
+    m_TaskCount = 0;
+
+    const u32 count = static_cast<u32>(items.size());
+    if (count == 0) return;
+
+    std::sort(items.begin(), items.end(), [](const auto& a, const auto& b) {
+        if (a.VAO != b.VAO) return a.VAO < b.VAO;
+        if (a.DepthVAO != b.DepthVAO) return a.DepthVAO < b.DepthVAO;
+        return a.ClusterMesh < b.ClusterMesh;
+    });
+
+    bool registered = true;
+    u32 uniqueMeshlets = 0;
+    u32 taskCount = 0;
+    u32 indexCount = 0;
+    for (u32 i = 0; i < count; ++i) {
+        const Mesh* mesh = items[i].ClusterMesh;
+        const u32 meshlets = static_cast<u32>(mesh->GetMeshlets().size());
+        if (i == 0 || items[i - 1].ClusterMesh != mesh) {
+            uniqueMeshlets += meshlets;
+            registered = RegisterMesh(*mesh) && registered;
+        }
+        taskCount += meshlets;
+        indexCount += items[i].IndexCount;
+    }
+    if (!registered) {
+        RebuildMeshletBuffer(items, uniqueMeshlets);
+    }
+    if (taskCount == 0) return;
+
+    m_InstanceRing->BeginFrame();
+    m_PreviousRing->BeginFrame();
+    m_TaskRing->BeginFrame();
+    m_Instances = m_InstanceRing->Allocate(count * sizeof(InstanceData));
+    m_PreviousTransforms = m_PreviousRing->Allocate(count * sizeof(glm::mat4));
+    m_Tasks = m_TaskRing->Allocate(taskCount * sizeof(Task));
+    if (!m_Instances || !m_PreviousTransforms || !m_Tasks) return;
+
+    EnsureOutputCapacity(taskCount, indexCount);
+    EnsureInstanceIndexCapacity(count);
+
+    auto* instances = static_cast<InstanceData*>(m_Instances.Data);
+    auto* previous = static_cast<glm::mat4*>(m_PreviousTransforms.Data);
+    auto* tasks = static_cast<Task*>(m_Tasks.Data);
+
+    for (u32 i = 0; i < count; ++i) {
+        const auto& item = items[i];
+        instances[i] = item.Instance;
+        previous[i] = item.PreviousTransform;
+
+        if (m_Groups.empty() || m_Groups.back().VAO != item.VAO || m_Groups.back().DepthVAO != item.DepthVAO) {
+            Group group;
+            group.VAO = item.VAO;
+            group.DepthVAO = item.DepthVAO;
+            group.FirstTask = m_TaskCount;
+            m_Groups.push_back(group);
+        }
+
+        const MeshEntry& entry = m_Meshes.at(item.ClusterMesh);
+        for (u32 m = 0; m < entry.MeshletCount; ++m) {
+            Task& task = tasks[m_TaskCount++];
+            task.Instance = i;
+            task.Meshlet = entry.FirstMeshlet + m;
+            task.BaseIndex = item.BaseIndex;
+            task.BaseVertex = item.BaseVertex;
+        }
+        m_Groups.back().TaskCount += entry.MeshletCount;
+    }
+
+    m_Stats.Instances = count;
+    m_Stats.Meshlets = m_TaskCount;
+}
+
+void MeshletCuller::Cull(const HiZPyramid* hiz) {
+    auto& state = GLStateCache::Instance();
+    if (m_Groups.empty()) return;
+
+    glClearNamedBufferData(m_CounterBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    m_CullShader->Bind();
+    const bool useHiZ = hiz && hiz->IsValid();
+    m_CullShader->SetInt("u_HiZEnabled", useHiZ ? 1 : 0);
+    if (useHiZ) {
+        m_CullShader->SetMat4("u_HiZViewProjection", hiz->GetViewProjection());
+        m_CullShader->SetFloat2("u_HiZUVScale", hiz->GetUVScale());
+        m_CullShader->SetInt("u_HiZLevelCount", static_cast<i32>(hiz->GetLevelCount()));
+        state.BindTextureUnit(0, hiz->GetTextureID());
+    }
+
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, MeshletBinding, m_MeshletBuffer);
+    GPURingBuffer::BindRange(GL_SHADER_STORAGE_BUFFER, TaskBinding, m_Tasks);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, OutputIndexBinding, m_OutputIndexBuffer);
+    GPURingBuffer::BindRange(GL_SHADER_STORAGE_BUFFER, IndirectDrawBatcher::InstanceBufferBinding, m_Instances);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, CommandBinding, m_CommandBuffer);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, CounterBinding, m_CounterBuffer);
+
+    for (const auto& group : m_Groups) {
+        // Meshlets copy their indices straight out of the mesh's own buffer
+        state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, SourceIndexBinding, group.VAO->GetIndexBuffer()->GetRendererID());
+        m_CullShader->SetUInt("u_FirstTask", group.FirstTask);
+        m_CullShader->SetUInt("u_TaskCount", group.TaskCount);
+
+        const u32 groupsX = std::min(group.TaskCount, MaxGroupsPerDimension);
+        const u32 groupsY = (group.TaskCount + groupsX - 1) / groupsX;
+        glDispatchCompute(groupsX, groupsY, 1);
+    }
+
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT);
+}
+
+void MeshletCuller::Draw(bool depthPass) {
+    if (m_Groups.empty()) return;
+
+    GPURingBuffer::BindRange(GL_SHADER_STORAGE_BUFFER, IndirectDrawBatcher::InstanceBufferBinding, m_Instances);
+    if (!depthPass) {
+        GPURingBuffer::BindRange(GL_SHADER_STORAGE_BUFFER, IndirectDrawBatcher::PreviousTransformBinding,
+                                 m_PreviousTransforms);
+    }
+    GLStateCache::Instance().BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_CommandBuffer);
+
+    for (const auto& group : m_Groups) {
+        VertexArray* vao = depthPass && group.DepthVAO ? group.DepthVAO : group.VAO;
+        vao->SetInstanceIndexBuffer(m_InstanceIndexBuffer, IndirectDrawBatcher::InstanceIndexLocation);
+        glVertexArrayElementBuffer(vao->GetRendererID(), m_OutputIndexBuffer);
+        vao->Bind();
+
+        const usize offset = group.FirstTask * sizeof(DrawElementsIndirectCommand);
+        PipelineWarmup::RecordDraw(GL_TRIANGLES);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(offset),
+                                    static_cast<GLsizei>(group.TaskCount), 0);
+        m_Stats.DrawCalls++;
+
+        glVertexArrayElementBuffer(vao->GetRendererID(), vao->GetIndexBuffer()->GetRendererID());
+    }
+
+    GLStateCache::Instance().BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+} // namespace Engine
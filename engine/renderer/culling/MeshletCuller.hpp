@@ -0,0 +1,144 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/pipeline/IndirectDrawBatcher.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include "renderer/opengl/GPURingBuffer.hpp"
+
+namespace Engine {
+
+class HiZPyramid;
+class Mesh;
+struct Meshlet;
+
+// MeshletCuller - GPU cluster culling for meshes split into meshlets.
+//
+// Prepare() expands draw items with a ClusterMesh into one task per
+// (instance, meshlet). Cull() runs meshlet_cull.glsl, one workgroup per
+// task: the meshlet's sphere is tested against the frustum, its normal cone
+// against the camera position and, given a pyramid, its projected bounds
+// against the previous frame's Hi-Z. Survivors reserve a range of a
+// compacted index buffer with an atomic and the group copies their indices
+// into it. Every task owns one indirect command, written with zero
+// instances when culled (GL 4.5 has no indirect draw count), so Draw() is a
+// single glMultiDrawElementsIndirect per vertex array, with the compacted
+// buffer swapped in as its element buffer for the duration.
+//
+// Bounds are uploaded once per mesh into a shared SSBO, converted to the
+// mesh's stored position space so the instance's draw transform (which
+// carries the dequantization) applies to them unchanged. The cone test
+// assumes uniform scale, as the normal transform does.
+//
+// GL_NV_mesh_shader would let a task shader do the same without the index
+// copy, but the loader carries no extensions and shaders have no mesh
+// stage, so compute is the only path.
+class MeshletCuller {
+public:
+    // Must match meshlet_cull.glsl
+    static constexpr u32 WorkgroupSize = 64;
+    static constexpr u32 MeshletBinding = 0;
+    static constexpr u32 TaskBinding = 1;
+    static constexpr u32 SourceIndexBinding = 2;
+    static constexpr u32 OutputIndexBinding = 3;
+    static constexpr u32 CommandBinding = 12;
+    static constexpr u32 CounterBinding = 13;
+
+    struct Stats {
+        u32 Instances = 0;
+        u32 Meshlets = 0;    // Tasks tested per view
+        u32 DrawCalls = 0;   // glMultiDrawElementsIndirect calls, every view
+    };
+
+    MeshletCuller();
+    ~MeshletCuller();
+
+    MeshletCuller(const MeshletCuller&) = delete;
+    MeshletCuller& operator=(const MeshletCuller&) = delete;
+
+    // Write instances and tasks for this frame. Every item needs a
+    // ClusterMesh with meshlets over its index range; items is reordered.
+    void Prepare(Vector<IndirectDrawBatcher::DrawItem>& items);
+
+    // Cull against the bound camera and write the commands. hiz may be null;
+    // it must hold depth seen from roughly the same camera. Once per view,
+    // before its Draw calls.
+    void Cull(const HiZPyramid* hiz);
+
+    // Draw what the last Cull kept. The caller binds the shader.
+    void Draw(bool depthPass);
+
+    bool IsEmpty() const { return m_Groups.empty(); }
+    const Stats& GetStats() const { return m_Stats; }
+
+    void Reload();
+
+private:
+    // Must match meshlet_cull.glsl
+    struct Task {
+        u32 Instance;
+        u32 Meshlet;        // Into the meshlet buffer
+        u32 BaseIndex;      // Of the mesh's LOD 0 in the vertex array's index buffer
+        u32 BaseVertex;
+    };
+
+    struct DrawElementsIndirectCommand {
+        u32 Count;
+        u32 InstanceCount;
+        u32 FirstIndex;
+        i32 BaseVertex;
+        u32 BaseInstance;
+    };
+
+    struct MeshEntry {
+        const Meshlet* Data = nullptr;  // Detects a new mesh at a reused address
+        u32 FirstMeshlet = 0;
+        u32 MeshletCount = 0;
+    };
+
+    // Consecutive tasks that share a vertex array
+    struct Group {
+        VertexArray* VAO = nullptr;
+        VertexArray* DepthVAO = nullptr;
+        u32 FirstTask = 0;
+        u32 TaskCount = 0;
+    };
+
+    void LoadShader();
+    bool RegisterMesh(const Mesh& mesh);
+    void RebuildMeshletBuffer(const Vector<IndirectDrawBatcher::DrawItem>& items, u32 required);
+    void EnsureOutputCapacity(u32 tasks, u32 indices);
+    void EnsureInstanceIndexCapacity(u32 required);
+
+private:
+    Ref<Shader> m_CullShader;
+
+    Scope<GPURingBuffer> m_InstanceRing;
+    Scope<GPURingBuffer> m_TaskRing;
+    Scope<GPURingBuffer> m_PreviousRing;   // Items' previous transforms, for the G-Buffer pass
+    GPURingBuffer::Allocation m_Instances;
+    GPURingBuffer::Allocation m_PreviousTransforms;
+    GPURingBuffer::Allocation m_Tasks;
+
+    // Bounds of every registered mesh, appended as meshes show up
+    u32 m_MeshletBuffer = 0;
+    u32 m_MeshletCapacity = 0;
+    u32 m_MeshletCount = 0;
+    HashMap<const Mesh*, MeshEntry> m_Meshes;
+
+    // Written by the GPU only
+    u32 m_OutputIndexBuffer = 0;
+    u32 m_OutputIndexCapacity = 0;
+    u32 m_CommandBuffer = 0;
+    u32 m_CommandCapacity = 0;
+    u32 m_CounterBuffer = 0;
+
+    u32 m_InstanceIndexBuffer = 0;
+    u32 m_InstanceIndexCapacity = 0;
+
+    Vector<Group> m_Groups;
+    u32 m_TaskCount = 0;
+
+    Stats m_Stats;
+};
+
+} // namespace Engine
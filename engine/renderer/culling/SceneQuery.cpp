@@ -0,0 +1,86 @@
+#include "SceneQuery.hpp"
+#include "core/JobSystem.hpp"
+
+#include <algorithm>
+
+namespace Engine {
+
+static_assert(SceneQuery::Grain % RayPacket::Width == 0, "Chunks must start on a packet boundary");
+
+void SceneQuery::Raycast(const Ray* rays, usize count, RayHit* hits, const f32* maxDistances,
+                         const Filter& filter) const {
+    Cast(rays, count, 0.0f, hits, maxDistances, filter);
+}
+
+void SceneQuery::SweepSphere(const Ray* rays, usize count, f32 radius, RayHit* hits, const f32* maxDistances,
+                             const Filter& filter) const {
+    Cast(rays, count, std::max(radius, 0.0f), hits, maxDistances, filter);
+}
+
+void SceneQuery::Cast(const Ray* rays, usize count, f32 inflate, RayHit* hits, const f32* maxDistances,
+                      const Filter& filter) const {
+    auto accept = [&filter](entt::entity entity) { return !filter || filter(entity); };
+
+    JobSystem::ParallelFor(static_cast<u32>(count), Grain, [&](u32 first, u32 last) {
+        RayHit packetHits[RayPacket::Width];
+        for (u32 i = first; i < last; i += RayPacket::Width) {
+            const u32 lanes = std::min(last - i, RayPacket::Width);
+            RayPacket packet(rays + i, lanes, maxDistances ? maxDistances + i : nullptr);
+            m_Index.RaycastPacket(packet, accept, packetHits, inflate);
+            std::copy_n(packetHits, lanes, hits + i);
+        }
+    });
+}
+
+void SceneQuery::LineOfSight(const glm::vec3* from, const glm::vec3* to, usize count, u8* visible,
+                             const Filter& filter) const {
+    Vector<Ray> rays(count);
+    Vector<f32> lengths(count);
+    for (usize i = 0; i < count; ++i) {
+        const glm::vec3 delta = to[i] - from[i];
+        lengths[i] = glm::length(delta);
+        rays[i].Origin = from[i];
+        rays[i].Direction = lengths[i] > 0.0f ? delta / lengths[i] : glm::vec3(0.0f, 0.0f, -1.0f);
+    }
+
+    Vector<RayHit> hits(count);
+    Cast(rays.data(), count, 0.0f, hits.data(), lengths.data(), filter);
+    for (usize i = 0; i < count; ++i) {
+        visible[i] = hits[i] ? 0 : 1;
+    }
+}
+
+void SceneQuery::Overlap(const AABB* boxes, usize count, Vector<entt::entity>& entities, Vector<u32>& offsets,
+                         const Filter& filter) const {
+    // Each chunk collects its own hits, concatenated in query order after.
+    // Chunks start on multiples of Grain; one may run to the end when the
+    // loop runs inline.
+    const u32 chunkCount = static_cast<u32>((count + Grain - 1) / Grain);
+    Vector<Vector<entt::entity>> chunkEntities(chunkCount);
+    Vector<u32> chunkEnds(chunkCount, 0);
+    offsets.assign(count + 1, 0);
+
+    JobSystem::ParallelFor(static_cast<u32>(count), Grain, [&](u32 first, u32 last) {
+        Vector<entt::entity>& found = chunkEntities[first / Grain];
+        for (u32 i = first; i < last; ++i) {
+            m_Index.QueryAABB(boxes[i], [&](entt::entity entity) {
+                if (!filter || filter(entity)) found.push_back(entity);
+            });
+            offsets[i + 1] = static_cast<u32>(found.size());  // Within the chunk for now
+        }
+        chunkEnds[first / Grain] = last;
+    });
+
+    entities.clear();
+    for (u32 chunk = 0; chunk < chunkCount; ++chunk) {
+        if (chunkEnds[chunk] == 0) continue;
+
+        const u32 base = static_cast<u32>(entities.size());
+        for (u32 i = chunk * Grain; i < chunkEnds[chunk]; ++i) {
+            offsets[i + 1] += base;
+        }
+        entities.insert(entities.end(), chunkEntities[chunk].begin(), chunkEntities[chunk].end());
+    }
+}
+
+} // namespace Engine
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/culling/SpatialIndex.hpp"
+#include <functional>
+
+namespace Engine {
+
+// SceneQuery - batched raycasts, sweeps and overlaps against a SpatialIndex.
+//
+// Queries run in batches: rays go through the index four at a time as
+// RayPacket lanes (one SIMD box test per node for the whole packet), and
+// batches are split over the job system in chunks of Grain queries. Tests
+// are against the renderable bounds CullingSystem last put in the index,
+// so hits are entities, not triangles. Camera collision, line-of-sight
+// checks and the like can issue thousands per frame; a single query is a
+// batch of one.
+//
+// Filters run on job threads and must not touch state other threads write.
+class SceneQuery {
+public:
+    using RayHit = SpatialIndex::RayHit;
+    using Filter = std::function<bool(entt::entity)>;   // False skips the entity; empty takes all
+
+    static constexpr u32 Grain = 64;    // Queries per job, a multiple of RayPacket::Width
+
+    explicit SceneQuery(const SpatialIndex& index) : m_Index(index) {}
+
+    // hits[i] is the closest entity rays[i] hits within maxDistances[i]
+    // (unbounded when null). A ray starting inside bounds hits them at 0.
+    void Raycast(const Ray* rays, usize count, RayHit* hits, const f32* maxDistances = nullptr,
+                 const Filter& filter = {}) const;
+
+    // Raycast for a sphere of radius moving along each ray, against the
+    // bounds grown by radius - conservative, since the corners of the grown
+    // boxes are square rather than rounded
+    void SweepSphere(const Ray* rays, usize count, f32 radius, RayHit* hits, const f32* maxDistances = nullptr,
+                     const Filter& filter = {}) const;
+
+    // visible[i] = 1 when no bounds lie between from[i] and to[i]. The
+    // entities at either end block too unless the filter skips them.
+    void LineOfSight(const glm::vec3* from, const glm::vec3* to, usize count, u8* visible,
+                     const Filter& filter = {}) const;
+
+    // Entities whose bounds intersect boxes[i] are
+    // entities[offsets[i] .. offsets[i + 1]); offsets gets count + 1 entries
+    void Overlap(const AABB* boxes, usize count, Vector<entt::entity>& entities, Vector<u32>& offsets,
+                 const Filter& filter = {}) const;
+
+private:
+    void Cast(const Ray* rays, usize count, f32 inflate, RayHit* hits, const f32* maxDistances,
+              const Filter& filter) const;
+
+private:
+    const SpatialIndex& m_Index;
+};
+
+} // namespace Engine
@@ -0,0 +1,54 @@
+#include "SpatialIndex.hpp"
+
+namespace Engine {
+
+void SpatialIndex::UpdateStatic(const Vector<entt::entity>& entities, const Vector<AABB>& bounds) {
+    m_StaticEntities = entities;
+    m_Static.Build(bounds);
+
+    m_Stats.StaticItems = m_Static.GetItemCount();
+    m_Stats.StaticNodes = m_Static.GetNodeCount();
+    m_Stats.StaticRebuilds++;
+}
+
+void SpatialIndex::UpdateDynamic(const Vector<entt::entity>& entities, const Vector<AABB>& bounds) {
+    if (entities.empty()) {
+        m_Dynamic.Clear();
+        m_DynamicEntities.clear();
+        m_Stats.DynamicItems = 0;
+        m_Stats.DynamicNodes = 0;
+        return;
+    }
+
+    // Same entities in the same order: keep the topology and refit. The
+    // culling system gathers in storage order, which only changes when
+    // entities are added or removed.
+    if (!m_Dynamic.IsEmpty() && entities == m_DynamicEntities) {
+        m_Dynamic.Refit(bounds);
+        m_Stats.DynamicRefits++;
+
+        if (m_Dynamic.ComputeSAHCost() <= m_DynamicBuildCost * RebuildCostRatio) {
+            return;
+        }
+    } else {
+        m_DynamicEntities = entities;
+    }
+
+    m_Dynamic.Build(bounds);
+    m_DynamicBuildCost = m_Dynamic.ComputeSAHCost();
+
+    m_Stats.DynamicItems = m_Dynamic.GetItemCount();
+    m_Stats.DynamicNodes = m_Dynamic.GetNodeCount();
+    m_Stats.DynamicRebuilds++;
+}
+
+void SpatialIndex::Clear() {
+    m_Static.Clear();
+    m_Dynamic.Clear();
+    m_StaticEntities.clear();
+    m_DynamicEntities.clear();
+    m_DynamicBuildCost = 0.0f;
+    m_Stats = Stats{};
+}
+
+} // namespace Engine
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "math/BVH.hpp"
+#include <entt/entt.hpp>
+
+namespace Engine {
+
+// SpatialIndex - world-space acceleration structure over renderable bounds.
+//
+// Split in two trees with different update policies:
+//   - Static:  SAH BVH over StaticGeometry entities, rebuilt only when the
+//              static set or its bounds change.
+//   - Dynamic: SAH BVH over everything else, refitted every frame while the
+//              entity set is unchanged and rebuilt when it changes or when
+//              refitting has degraded its SAH cost too far.
+//
+// Maintained by CullingSystem. Frustum culling, shadow caster selection,
+// light-volume queries and editor picking go through it instead of walking
+// the registry. Bounds are those of the last CullingSystem update.
+class SpatialIndex {
+public:
+    // Rebuild the dynamic tree once refits have made it this much worse
+    static constexpr f32 RebuildCostRatio = 1.5f;
+
+    struct Stats {
+        u32 StaticItems = 0;
+        u32 DynamicItems = 0;
+        u32 StaticNodes = 0;
+        u32 DynamicNodes = 0;
+        u32 StaticRebuilds = 0;
+        u32 DynamicRebuilds = 0;
+        u32 DynamicRefits = 0;
+    };
+
+    struct RayHit {
+        entt::entity Entity = entt::null;
+        f32 Distance = std::numeric_limits<f32>::max();
+
+        explicit operator bool() const { return Entity != entt::null; }
+    };
+
+    // entities[i] has world bounds bounds[i]
+    void UpdateStatic(const Vector<entt::entity>& entities, const Vector<AABB>& bounds);
+    void UpdateDynamic(const Vector<entt::entity>& entities, const Vector<AABB>& bounds);
+    void Clear();
+
+    // func(entt::entity, bool fullyInside)
+    template<typename Func>
+    void QueryFrustum(const Frustum& frustum, Func&& func) const {
+        m_Static.QueryFrustum(frustum, [&](u32 item, bool inside) { func(m_StaticEntities[item], inside); });
+        m_Dynamic.QueryFrustum(frustum, [&](u32 item, bool inside) { func(m_DynamicEntities[item], inside); });
+    }
+
+    // Same as QueryFrustum restricted to one tree (shadow caching draws the
+    // two sets into different targets)
+    template<typename Func>
+    void QueryStaticFrustum(const Frustum& frustum, Func&& func) const {
+        m_Static.QueryFrustum(frustum, [&](u32 item, bool inside) { func(m_StaticEntities[item], inside); });
+    }
+
+    template<typename Func>
+    void QueryDynamicFrustum(const Frustum& frustum, Func&& func) const {
+        m_Dynamic.QueryFrustum(frustum, [&](u32 item, bool inside) { func(m_DynamicEntities[item], inside); });
+    }
+
+    // func(entt::entity) for every entity whose bounds intersect box
+    template<typename Func>
+    void QueryAABB(const AABB& box, Func&& func) const {
+        m_Static.QueryAABB(box, [&](u32 item) { func(m_StaticEntities[item]); });
+        m_Dynamic.QueryAABB(box, [&](u32 item) { func(m_DynamicEntities[item]); });
+    }
+
+
+    // func(entt::entity) for every entity whose bounds touch the sphere
+    template<typename Func>
+    void QuerySphere(const glm::vec3& center, f32 radius, Func&& func) const {
+        AABB box = AABB::FromCenterExtents(center, glm::vec3(radius));
+        const f32 radiusSq = radius * radius;
+        auto test = [&](const AABB& bounds) {
+            glm::vec3 closest = glm::clamp(center, bounds.Min, bounds.Max);
+            glm::vec3 delta = closest - center;
+            return glm::dot(delta, delta) <= radiusSq;
+        };
+        m_Static.QueryAABB(box, [&](u32 item) {
+            if (test(m_Static.GetItemBounds(item))) func(m_StaticEntities[item]);
+        });
+        m_Dynamic.QueryAABB(box, [&](u32 item) {
+            if (test(m_Dynamic.GetItemBounds(item))) func(m_DynamicEntities[item]);
+        });
+    }
+
+    // Closest entity whose bounds the ray hits; filter(entt::entity) -> bool
+    template<typename Filter>
+    RayHit Raycast(const Ray& ray, Filter&& filter) const {
+        RayHit result;
+        auto staticHit = m_Static.Raycast(ray, [&](u32 item) { return filter(m_StaticEntities[item]); });
+        if (staticHit) {
+            result.Entity = m_StaticEntities[staticHit.Item];
+            result.Distance = staticHit.Distance;
+        }
+        auto dynamicHit = m_Dynamic.Raycast(ray, [&](u32 item) { return filter(m_DynamicEntities[item]); },
+                                            result.Distance);
+        if (dynamicHit) {
+            result.Entity = m_DynamicEntities[dynamicHit.Item];
+            result.Distance = dynamicHit.Distance;
+        }
+        return result;
+    }
+
+    // Raycast for every lane of packet (BVH::RaycastPacket over both trees);
+    // hits[lane] for each. inflate grows the bounds, for sphere sweeps.
+    template<typename Filter>
+    void RaycastPacket(RayPacket& packet, Filter&& filter, RayHit* hits, f32 inflate = 0.0f) const {
+        BVH::RayHit treeHits[RayPacket::Width];
+        m_Static.RaycastPacket(packet, [&](u32 item) { return filter(m_StaticEntities[item]); }, treeHits, inflate);
+        for (u32 lane = 0; lane < RayPacket::Width; ++lane) {
+            hits[lane] = RayHit{};
+            hits[lane].Distance = treeHits[lane].Distance;
+            if (treeHits[lane]) hits[lane].Entity = m_StaticEntities[treeHits[lane].Item];
+        }
+
+        // The packet's distances now stop at the static hits
+        m_Dynamic.RaycastPacket(packet, [&](u32 item) { return filter(m_DynamicEntities[item]); }, treeHits, inflate);
+        for (u32 lane = 0; lane < RayPacket::Width; ++lane) {
+            if (!treeHits[lane]) continue;
+            hits[lane].Entity = m_DynamicEntities[treeHits[lane].Item];
+            hits[lane].Distance = treeHits[lane].Distance;
+        }
+    }
+
+    const BVH& GetStaticBVH() const { return m_Static; }
+    const BVH& GetDynamicBVH() const { return m_Dynamic; }
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    BVH m_Static;
+    BVH m_Dynamic;
+    Vector<entt::entity> m_StaticEntities;
+    Vector<entt::entity> m_DynamicEntities;
+    f32 m_DynamicBuildCost = 0.0f;
+
+    Stats m_Stats;
+};
+
+} // namespace Engine
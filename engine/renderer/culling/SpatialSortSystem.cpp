@@ -0,0 +1,132 @@
+#include "SpatialSortSystem.hpp"
+#include "renderer/RenderGroups.hpp"
+#include "core/JobSystem.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace Engine {
+
+namespace {
+
+// Spread the low 10 bits of v to every third bit
+u32 Part1By2(u32 v) {
+    v &= 0x3FF;
+    v = (v | (v << 16)) & 0x030000FF;
+    v = (v | (v << 8)) & 0x0300F00F;
+    v = (v | (v << 4)) & 0x030C30C3;
+    v = (v | (v << 2)) & 0x09249249;
+    return v;
+}
+
+u32 MortonCode(const glm::vec3& cell) {
+    return Part1By2(static_cast<u32>(cell.x)) | (Part1By2(static_cast<u32>(cell.y)) << 1) |
+           (Part1By2(static_cast<u32>(cell.z)) << 2);
+}
+
+// A group this far out of order or less is fixed by insertion sort
+constexpr u32 IncrementalDivisor = 32;
+
+} // anonymous namespace
+
+void SpatialSortSystem::OnCreate(entt::registry& registry) {
+    RenderableGroup(registry);
+    PointLightGroup(registry);
+    SpotLightGroup(registry);
+    m_Elapsed = m_Interval;     // First pass on the first update
+}
+
+void SpatialSortSystem::OnUpdate(entt::registry& registry, f32 deltaTime) {
+    m_Elapsed += deltaTime;
+    if (m_Elapsed < m_Interval) return;
+    m_Elapsed = 0.0f;
+
+    const auto start = std::chrono::steady_clock::now();
+    m_Stats.Sorted = 0;
+    m_Stats.Inversions = 0;
+    m_Stats.Incremental = true;
+
+    auto renderables = RenderableGroup(registry);
+    auto pointLights = PointLightGroup(registry);
+    auto spotLights = SpotLightGroup(registry);
+
+    // Everything the groups hold, to quantize positions to
+    m_Entities.clear();
+    m_Entities.insert(m_Entities.end(), renderables.begin(), renderables.end());
+    m_Entities.insert(m_Entities.end(), pointLights.begin(), pointLights.end());
+    m_Entities.insert(m_Entities.end(), spotLights.begin(), spotLights.end());
+    if (m_Entities.empty()) return;
+
+    auto& transforms = registry.storage<Transform>();
+    glm::vec3 minimum(std::numeric_limits<f32>::max());
+    glm::vec3 maximum(std::numeric_limits<f32>::lowest());
+    usize slots = 0;
+    for (entt::entity entity : m_Entities) {
+        const glm::vec3 position(transforms.get(entity).WorldMatrix[3]);
+        minimum = glm::min(minimum, position);
+        maximum = glm::max(maximum, position);
+        slots = std::max(slots, static_cast<usize>(entt::to_entity(entity)) + 1);
+    }
+
+    m_BoundsMin = minimum;
+    const glm::vec3 extent = maximum - minimum;
+    m_BoundsScale = glm::vec3(extent.x > 0.0f ? 1023.0f / extent.x : 0.0f,
+                              extent.y > 0.0f ? 1023.0f / extent.y : 0.0f,
+                              extent.z > 0.0f ? 1023.0f / extent.z : 0.0f);
+
+    // Each entity writes its own slot
+    m_Codes.resize(slots);
+    JobSystem::ParallelFor(static_cast<u32>(m_Entities.size()), 1024, [&](u32 first, u32 last) {
+        for (u32 i = first; i < last; ++i) {
+            const entt::entity entity = m_Entities[i];
+            const glm::vec3 position(transforms.get(entity).WorldMatrix[3]);
+            const glm::vec3 cell = glm::clamp((position - m_BoundsMin) * m_BoundsScale, glm::vec3(0.0f), glm::vec3(1023.0f));
+            m_Codes[entt::to_entity(entity)] = MortonCode(cell);
+        }
+    });
+
+    SortGroup(renderables);
+    SortGroup(pointLights);
+    SortGroup(spotLights);
+
+    // Renderables fetch their Transform through the sparse set; in the same
+    // order those fetches stream too
+    if (m_SortTransforms) {
+        registry.sort<Transform, MeshComponent>();
+    }
+
+    m_Stats.Milliseconds = std::chrono::duration<f32, std::milli>(std::chrono::steady_clock::now() - start).count();
+    m_Stats.Passes++;
+}
+
+template<typename Group>
+void SpatialSortSystem::SortGroup(Group group) {
+    const u32 count = static_cast<u32>(group.size());
+    if (count < 2) return;
+
+    u32 inversions = 0;
+    u32 previous = 0;
+    for (auto it = group.begin(); it != group.end(); ++it) {
+        const u32 code = CodeOf(*it);
+        inversions += it != group.begin() && code < previous;
+        previous = code;
+    }
+    m_Stats.Inversions += inversions;
+    if (inversions == 0) return;
+
+    // Iteration follows the comparator
+    auto byCode = [this](const entt::entity a, const entt::entity b) { return CodeOf(a) < CodeOf(b); };
+    if (inversions <= count / IncrementalDivisor) {
+        group.sort(byCode, entt::insertion_sort{});
+    } else {
+        group.sort(byCode);
+        m_Stats.Incremental = false;
+    }
+    m_Stats.Sorted += count;
+}
+
+u32 SpatialSortSystem::CodeOf(entt::entity entity) const {
+    return m_Codes[entt::to_entity(entity)];
+}
+
+} // namespace Engine
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "ecs/System.hpp"
+#include "ecs/Components/Transform.hpp"
+#include "ecs/Components/Renderable.hpp"
+#include "ecs/Components/LightComponents.hpp"
+
+namespace Engine {
+
+// SpatialSortSystem - keeps the render groups in Morton order of world position.
+//
+// EnTT pools are in insertion order, so entities that are neighbours in the
+// world are scattered through memory, and culling, shadow caster gathers
+// and light assignment - which visit them by region - touch cache lines at
+// random. Every Interval seconds this system computes a 30-bit Morton code
+// of each renderable's and light's world position, quantized to the bounds
+// of all of them, and sorts RenderableGroup, PointLightGroup and
+// SpotLightGroup by it (group.sort, which reorders every owned pool
+// together). A group already in order is left alone; one only slightly out
+// of order - objects drifting between cells - is fixed by insertion sort,
+// linear in the entities plus the displacement, rather than a full sort.
+//
+// The Transform pool is a get<> of the groups and is sorted to follow the
+// renderable group with SetSortTransforms(true). Leave it off when
+// TransformSystem::SetSortStorage keeps that pool in hierarchy order; the
+// two orders would undo each other.
+//
+// Optional: not registered by default. Positions are read from Transform,
+// so run it after TransformSystem.
+class SpatialSortSystem : public ISystem {
+public:
+    DEFINE_SYSTEM(SpatialSortSystem, PreRender, 1)
+    SYSTEM_ACCESS(.Write<Transform, MeshComponent, Renderable, PointLightComponent, SpotLightComponent>())
+
+    struct Stats {
+        u32 Sorted = 0;         // Entities reordered by the last pass
+        u32 Inversions = 0;     // Adjacent pairs out of order before it
+        bool Incremental = false;
+        f32 Milliseconds = 0.0f;
+        u32 Passes = 0;
+    };
+
+    void OnCreate(entt::registry& registry) override;
+    void OnUpdate(entt::registry& registry, f32 deltaTime) override;
+
+    // Seconds between passes; 0 sorts every frame
+    void SetInterval(f32 seconds) { m_Interval = seconds; }
+    f32 GetInterval() const { return m_Interval; }
+
+    void SetSortTransforms(bool enabled) { m_SortTransforms = enabled; }
+    bool GetSortTransforms() const { return m_SortTransforms; }
+
+    // Sort on the next update regardless of the interval
+    void Invalidate() { m_Elapsed = m_Interval; }
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    // Morton codes of group's entities, then sort it if they are out of order
+    template<typename Group>
+    void SortGroup(Group group);
+
+    u32 CodeOf(entt::entity entity) const;
+
+private:
+    f32 m_Interval = 1.0f;
+    f32 m_Elapsed = 0.0f;
+    bool m_SortTransforms = false;
+
+    glm::vec3 m_BoundsMin{0.0f};
+    glm::vec3 m_BoundsScale{0.0f};      // To [0, 1023] per axis
+    Vector<u32> m_Codes;                // Per entity slot (entt::to_entity)
+    Vector<entt::entity> m_Entities;    // Of the group being sorted, in group order
+
+    Stats m_Stats;
+};
+
+} // namespace Engine
@@ -0,0 +1,89 @@
+#include "SubtreeCulling.hpp"
+
+#include <algorithm>
+
+namespace Engine {
+
+bool SubtreeCulling::Classify(entt::registry& registry, const Frustum& frustum) {
+    m_Stats = {};
+    if (++m_Pass == 0) {
+        // Stamps wrapped; none may look current
+        std::fill(m_Stamp.begin(), m_Stamp.end(), 0u);
+        m_Pass = 1;
+    }
+
+    auto& subtrees = registry.storage<SubtreeBounds>();
+    if (subtrees.empty()) return false;
+
+    auto& hierarchies = registry.storage<Hierarchy>();
+    const usize slots = registry.storage<entt::entity>().size();
+    if (m_Stamp.size() < slots) {
+        m_Stamp.resize(slots, 0);
+        m_State.resize(slots, Frustum::Containment::Intersects);
+    }
+
+    // Top-level subtrees: the parent carries no bounds of its own
+    m_Stack.clear();
+    for (entt::entity entity : subtrees) {
+        const entt::entity parent = hierarchies.contains(entity) ? hierarchies.get(entity).Parent : entt::null;
+        if (parent == entt::null || !subtrees.contains(parent)) {
+            m_Stack.push_back(entity);
+        }
+    }
+
+    m_Settled.clear();
+    while (!m_Stack.empty()) {
+        const entt::entity entity = m_Stack.back();
+        m_Stack.pop_back();
+
+        const SubtreeBounds& bounds = subtrees.get(entity);
+        ++m_Stats.Tested;
+        const Frustum::Containment state = bounds.IsEmpty() ? Frustum::Containment::Outside
+                                                            : frustum.ClassifyBox(bounds.Bounds);
+        if (state != Frustum::Containment::Intersects) {
+            ++(state == Frustum::Containment::Outside ? m_Stats.Rejected : m_Stats.Accepted);
+            m_Settled.emplace_back(entity, state);    // Marked after the walk, which needs m_Stack
+            continue;
+        }
+
+        for (entt::entity child = hierarchies.get(entity).FirstChild; child != entt::null;
+             child = hierarchies.get(child).NextSibling) {
+            if (subtrees.contains(child)) m_Stack.push_back(child);
+        }
+    }
+
+    for (const auto& [root, state] : m_Settled) {
+        Resolve(registry, root, state);
+    }
+    return true;
+}
+
+void SubtreeCulling::Resolve(entt::registry& registry, entt::entity root, Frustum::Containment state) {
+    auto& hierarchies = registry.storage<Hierarchy>();
+
+    m_Stack.clear();
+    m_Stack.push_back(root);
+    while (!m_Stack.empty()) {
+        const entt::entity entity = m_Stack.back();
+        m_Stack.pop_back();
+
+        Mark(entity, state);
+        for (entt::entity child = hierarchies.get(entity).FirstChild; child != entt::null;
+             child = hierarchies.get(child).NextSibling) {
+            m_Stack.push_back(child);
+        }
+    }
+}
+
+void SubtreeCulling::Mark(entt::entity entity, Frustum::Containment state) {
+    const usize slot = static_cast<usize>(entt::to_entity(entity));
+    if (slot >= m_Stamp.size()) {
+        m_Stamp.resize(slot + 1, 0);
+        m_State.resize(slot + 1, Frustum::Containment::Intersects);
+    }
+    m_Stamp[slot] = m_Pass;
+    m_State[slot] = state;
+    ++m_Stats.Resolved;
+}
+
+} // namespace Engine
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "ecs/Components/Hierarchy.hpp"
+#include "math/Frustum.hpp"
+#include <entt/entt.hpp>
+#include <utility>
+
+namespace Engine {
+
+// SubtreeCulling - resolves whole Hierarchy subtrees against a frustum.
+//
+// Classify() tests the SubtreeBounds TransformSystem keeps on hierarchy
+// parents, top-level subtrees first. A subtree entirely outside or inside
+// settles every entity in it with that one test; one that straddles the
+// frustum is opened and its child subtrees tested in turn. Culling passes
+// then ask Get() before testing an entity of their own and only test what
+// comes back Intersects - unresolved, or not in a hierarchy at all.
+//
+// Reuse one instance across frustums; each Classify replaces the last.
+class SubtreeCulling {
+public:
+    struct Stats {
+        u32 Tested = 0;     // SubtreeBounds tested
+        u32 Rejected = 0;   // Subtrees found outside
+        u32 Accepted = 0;   // Subtrees found inside
+        u32 Resolved = 0;   // Entities settled by either
+    };
+
+    // False when the registry has no SubtreeBounds; Get is then Intersects
+    // for everything
+    bool Classify(entt::registry& registry, const Frustum& frustum);
+
+    // Outside or Inside when a subtree containing entity settled it
+    Frustum::Containment Get(entt::entity entity) const {
+        const usize slot = static_cast<usize>(entt::to_entity(entity));
+        return slot < m_Stamp.size() && m_Stamp[slot] == m_Pass ? m_State[slot] : Frustum::Containment::Intersects;
+    }
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    void Resolve(entt::registry& registry, entt::entity root, Frustum::Containment state);
+    void Mark(entt::entity entity, Frustum::Containment state);
+
+private:
+    // Per entity slot (entt::to_entity); a state is current when its stamp is
+    Vector<u32> m_Stamp;
+    Vector<Frustum::Containment> m_State;
+    u32 m_Pass = 0;
+
+    Vector<entt::entity> m_Stack;
+    Vector<std::pair<entt::entity, Frustum::Containment>> m_Settled;  // Subtrees found outside or inside
+    Stats m_Stats;
+};
+
+} // namespace Engine
@@ -0,0 +1,314 @@
+#include "renderer/debug/DebugDraw.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include "renderer/opengl/GLVertexArray.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
+#include "renderer/opengl/GPURingBuffer.hpp"
+#include "renderer/shadows/ShadowTypes.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 ModeCount = static_cast<u32>(DebugDrawMode::Count);
+constexpr u32 VertexBinding = 0;    // debug_lines.glsl
+
+// Layout of the GPU append buffer, see debug_draw.glsl
+struct DrawArraysIndirectCommand {
+    u32 Count;
+    u32 InstanceCount;
+    u32 First;
+    u32 BaseInstance;
+};
+constexpr usize GPUHeaderSize = 256;
+constexpr usize GPUVerticesSize = static_cast<usize>(DebugDraw::GPUVerticesPerMode) * ModeCount *
+                                  sizeof(DebugDraw::Vertex);
+static_assert(sizeof(DebugDraw::Vertex) == 16, "DebugDraw::Vertex must match the std430 DebugVertex");
+static_assert(sizeof(DrawArraysIndirectCommand) * ModeCount <= GPUHeaderSize, "Commands must fit the header");
+
+// Producers, any thread
+std::mutex s_Mutex;
+DebugDraw::Frame s_Pending;
+bool s_WarnedFull = false;
+
+// GL thread
+Ref<Shader> s_Shader;
+Scope<VertexArray> s_EmptyVAO;          // Core profile draws need one bound
+Scope<GPURingBuffer> s_VertexRing;
+u32 s_GPUBuffer = 0;
+u32 s_GPUHeaderTemplate = 0;            // Copied over the header by BeginFrame
+bool s_GPUFrameOpen = false;
+u32 s_LastVertexCount = 0;
+
+u32 PackColor(const glm::vec4& color) {
+    const glm::vec4 c = glm::clamp(color, glm::vec4(0.0f), glm::vec4(1.0f)) * 255.0f + 0.5f;
+    return static_cast<u32>(c.x) | (static_cast<u32>(c.y) << 8) | (static_cast<u32>(c.z) << 16) |
+           (static_cast<u32>(c.w) << 24);
+}
+
+// Append vertex pairs under the lock
+void Append(const DebugDraw::Vertex* vertices, u32 count, DebugDrawMode mode) {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    Vector<DebugDraw::Vertex>& target = s_Pending.Vertices[static_cast<u32>(mode)];
+    if (target.size() + count > DebugDraw::MaxVerticesPerMode) {
+        // Nobody calls Render(), or something draws far too much
+        if (!s_WarnedFull) {
+            LOG_CORE_WARN("DebugDraw: over {} vertices this frame, dropping lines", DebugDraw::MaxVerticesPerMode);
+            s_WarnedFull = true;
+        }
+        return;
+    }
+    target.insert(target.end(), vertices, vertices + count);
+}
+
+// The 12 edges of a box given its corners in AABB::GetCorners order
+void AppendBoxEdges(const glm::vec3 corners[8], const glm::vec4& color, DebugDrawMode mode) {
+    static constexpr u8 Edges[12][2] = {
+        {0, 1}, {2, 3}, {4, 5}, {6, 7},     // Along x
+        {0, 2}, {1, 3}, {4, 6}, {5, 7},     // Along y
+        {0, 4}, {1, 5}, {2, 6}, {3, 7}      // Along z
+    };
+
+    const u32 packed = PackColor(color);
+    DebugDraw::Vertex vertices[24];
+    for (u32 i = 0; i < 12; ++i) {
+        vertices[i * 2] = {corners[Edges[i][0]], packed};
+        vertices[i * 2 + 1] = {corners[Edges[i][1]], packed};
+    }
+    Append(vertices, 24, mode);
+}
+
+// Point shared by three planes; false if two of them are parallel
+bool IntersectPlanes(const Plane& a, const Plane& b, const Plane& c, glm::vec3& point) {
+    const glm::vec3 bc = glm::cross(b.Normal, c.Normal);
+    const f32 denominator = glm::dot(a.Normal, bc);
+    if (std::abs(denominator) < 1e-6f) return false;
+
+    point = (-a.Distance * bc - b.Distance * glm::cross(c.Normal, a.Normal) -
+             c.Distance * glm::cross(a.Normal, b.Normal)) / denominator;
+    return true;
+}
+
+void DrawVertices(u32 first, u32 count, u32 end) {
+    if (count == 0) return;
+    s_Shader->SetInt("u_VertexEnd", static_cast<i32>(end));
+    PipelineWarmup::RecordDraw(GL_LINES);
+    glDrawArrays(GL_LINES, static_cast<GLint>(first), static_cast<GLsizei>(count));
+}
+
+} // anonymous namespace
+
+void DebugDraw::Init() {
+    s_Shader = CreateRef<Shader>("assets/shaders/debug/debug_lines.glsl");
+    s_EmptyVAO = CreateScope<VertexArray>();
+    s_VertexRing = CreateScope<GPURingBuffer>(16384 * sizeof(Vertex));
+
+    DrawArraysIndirectCommand header[ModeCount] = {};
+    for (u32 mode = 0; mode < ModeCount; ++mode) {
+        header[mode] = {0, 1, mode * GPUVerticesPerMode, 0};
+    }
+    glCreateBuffers(1, &s_GPUHeaderTemplate);
+    GLMemory::BufferStorage(s_GPUHeaderTemplate, sizeof(header), header, 0, MemoryTag::Renderer);
+
+    glCreateBuffers(1, &s_GPUBuffer);
+    GLMemory::BufferStorage(s_GPUBuffer, GPUHeaderSize + GPUVerticesSize, nullptr, 0, MemoryTag::Renderer);
+}
+
+void DebugDraw::Shutdown() {
+    if (s_GPUBuffer) {
+        GLMemory::DeleteBuffers(1, &s_GPUBuffer);
+        GLMemory::DeleteBuffers(1, &s_GPUHeaderTemplate);
+        s_GPUBuffer = 0;
+        s_GPUHeaderTemplate = 0;
+    }
+    s_VertexRing.reset();
+    s_EmptyVAO.reset();
+    s_Shader.reset();
+    s_GPUFrameOpen = false;
+}
+
+void DebugDraw::BeginFrame() {
+    if (!s_GPUBuffer) return;
+
+    // A GPU-side copy: no wait on last frame's draws still reading the buffer
+    glCopyNamedBufferSubData(s_GPUHeaderTemplate, s_GPUBuffer, 0, 0,
+                             sizeof(DrawArraysIndirectCommand) * ModeCount);
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, AppendBinding, s_GPUBuffer);
+    s_GPUFrameOpen = true;
+}
+
+void DebugDraw::DrawLine(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color, DebugDrawMode mode) {
+    const u32 packed = PackColor(color);
+    const Vertex vertices[2] = {{from, packed}, {to, packed}};
+    Append(vertices, 2, mode);
+}
+
+void DebugDraw::DrawBox(const AABB& box, const glm::vec4& color, DebugDrawMode mode) {
+    glm::vec3 corners[8];
+    box.GetCorners(corners);
+    AppendBoxEdges(corners, color, mode);
+}
+
+void DebugDraw::DrawBox(const AABB& localBox, const glm::mat4& transform, const glm::vec4& color,
+                        DebugDrawMode mode) {
+    glm::vec3 corners[8];
+    localBox.GetCorners(corners);
+    for (auto& corner : corners) {
+        corner = glm::vec3(transform * glm::vec4(corner, 1.0f));
+    }
+    AppendBoxEdges(corners, color, mode);
+}
+
+void DebugDraw::DrawSphere(const glm::vec3& center, f32 radius, const glm::vec4& color, DebugDrawMode mode,
+                           u32 segments) {
+    segments = std::clamp(segments, 4u, MaxSphereSegments);
+
+    const u32 packed = PackColor(color);
+    Vertex vertices[MaxSphereSegments * 2 * 3];
+    u32 count = 0;
+
+    const f32 step = 6.28318530718f / static_cast<f32>(segments);
+    for (u32 i = 0; i < segments; ++i) {
+        const f32 a0 = step * static_cast<f32>(i);
+        const f32 a1 = step * static_cast<f32>(i + 1);
+        const glm::vec2 p0(std::cos(a0) * radius, std::sin(a0) * radius);
+        const glm::vec2 p1(std::cos(a1) * radius, std::sin(a1) * radius);
+
+        // XY, XZ and YZ circles
+        vertices[count++] = {center + glm::vec3(p0.x, p0.y, 0.0f), packed};
+        vertices[count++] = {center + glm::vec3(p1.x, p1.y, 0.0f), packed};
+        vertices[count++] = {center + glm::vec3(p0.x, 0.0f, p0.y), packed};
+        vertices[count++] = {center + glm::vec3(p1.x, 0.0f, p1.y), packed};
+        vertices[count++] = {center + glm::vec3(0.0f, p0.x, p0.y), packed};
+        vertices[count++] = {center + glm::vec3(0.0f, p1.x, p1.y), packed};
+    }
+    Append(vertices, count, mode);
+}
+
+void DebugDraw::DrawFrustum(const glm::mat4& viewProjection, const glm::vec4& color, DebugDrawMode mode) {
+    const glm::mat4 inverse = glm::inverse(viewProjection);
+
+    // NDC cube corners in AABB::GetCorners order
+    glm::vec3 corners[8];
+    for (u32 i = 0; i < 8; ++i) {
+        const glm::vec4 ndc((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f);
+        const glm::vec4 world = inverse * ndc;
+        corners[i] = glm::vec3(world) / world.w;
+    }
+    AppendBoxEdges(corners, color, mode);
+}
+
+void DebugDraw::DrawFrustum(const Frustum& frustum, const glm::vec4& color, DebugDrawMode mode) {
+    // Same corner order as the NDC cube: x from Left to Right, y from Bottom
+    // to Top, z from Near to Far
+    glm::vec3 corners[8];
+    for (u32 i = 0; i < 8; ++i) {
+        const Plane& x = frustum.GetPlane((i & 1) ? Frustum::Right : Frustum::Left);
+        const Plane& y = frustum.GetPlane((i & 2) ? Frustum::Top : Frustum::Bottom);
+        const Plane& z = frustum.GetPlane((i & 4) ? Frustum::Far : Frustum::Near);
+        if (!IntersectPlanes(x, y, z, corners[i])) return;
+    }
+    AppendBoxEdges(corners, color, mode);
+}
+
+void DebugDraw::DrawCascade(const CascadeInfo& cascade, const glm::vec4& color, DebugDrawMode mode) {
+    DrawFrustum(cascade.ViewProjectionMatrix, color, mode);
+}
+
+DebugDraw::Frame DebugDraw::TakeFrame() {
+    Frame frame;
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    for (u32 mode = 0; mode < ModeCount; ++mode) {
+        // Start the next frame with about as much room as this one needed
+        frame.Vertices[mode].reserve(s_Pending.Vertices[mode].size());
+        std::swap(frame.Vertices[mode], s_Pending.Vertices[mode]);
+    }
+    s_WarnedFull = false;
+    return frame;
+}
+
+void DebugDraw::Render(u32 sceneDepth, const glm::vec2& depthUVScale, u32 viewportWidth, u32 viewportHeight) {
+    Render(TakeFrame(), sceneDepth, depthUVScale, viewportWidth, viewportHeight);
+}
+
+void DebugDraw::Render(const Frame& frame, u32 sceneDepth, const glm::vec2& depthUVScale,
+                       u32 viewportWidth, u32 viewportHeight) {
+    if (!s_Shader) return;
+
+    const Vector<Vertex>& tested = frame.Vertices[static_cast<u32>(DebugDrawMode::DepthTested)];
+    const Vector<Vertex>& overlay = frame.Vertices[static_cast<u32>(DebugDrawMode::Overlay)];
+    const u32 testedCount = static_cast<u32>(tested.size());
+    const u32 overlayCount = static_cast<u32>(overlay.size());
+    s_LastVertexCount = testedCount + overlayCount;
+
+    auto& state = GLStateCache::Instance();
+
+    GLStateCache::ScopedState savedState;
+    RenderState lineState;
+    lineState.DepthTest = sceneDepth == 0;
+    lineState.DepthFunc = GL_LEQUAL;
+    lineState.DepthWrite = false;
+    lineState.Blend = true;
+    lineState.CullFace = false;
+    state.Apply(lineState);
+
+    s_Shader->Bind();
+    s_Shader->SetFloat2("u_ViewportSize", glm::vec2(static_cast<f32>(std::max(viewportWidth, 1u)),
+                                                    static_cast<f32>(std::max(viewportHeight, 1u))));
+    s_Shader->SetFloat2("u_DepthUVScale", depthUVScale);
+    state.BindTextureUnit(0, sceneDepth);
+    s_EmptyVAO->Bind();
+
+    // CPU lines: both modes in one upload, one draw each
+    if (s_LastVertexCount > 0) {
+        s_VertexRing->BeginFrame();
+        GPURingBuffer::Allocation allocation = s_VertexRing->Allocate(s_LastVertexCount * sizeof(Vertex));
+        if (allocation) {
+            Vertex* vertices = static_cast<Vertex*>(allocation.Data);
+            std::copy(tested.begin(), tested.end(), vertices);
+            std::copy(overlay.begin(), overlay.end(), vertices + testedCount);
+            GPURingBuffer::BindRange(GL_SHADER_STORAGE_BUFFER, VertexBinding, allocation);
+
+            s_Shader->SetInt("u_DepthTest", sceneDepth != 0 ? 1 : 0);
+            DrawVertices(0, testedCount, testedCount);
+
+            state.SetDepthTest(false);
+            s_Shader->SetInt("u_DepthTest", 0);
+            DrawVertices(testedCount, overlayCount, s_LastVertexCount);
+        }
+        s_VertexRing->EndFrame();
+    }
+
+    // GPU lines: the counts are only known to the GPU, so draw indirect
+    if (s_GPUFrameOpen) {
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+        state.BindBufferRange(GL_SHADER_STORAGE_BUFFER, VertexBinding, s_GPUBuffer, GPUHeaderSize, GPUVerticesSize);
+        state.BindBuffer(GL_DRAW_INDIRECT_BUFFER, s_GPUBuffer);
+
+        for (u32 mode = 0; mode < ModeCount; ++mode) {
+            const bool depthTested = mode == static_cast<u32>(DebugDrawMode::DepthTested);
+            state.SetDepthTest(depthTested && sceneDepth == 0);
+            s_Shader->SetInt("u_DepthTest", depthTested && sceneDepth != 0 ? 1 : 0);
+            s_Shader->SetInt("u_VertexEnd", static_cast<i32>((mode + 1) * GPUVerticesPerMode));
+            PipelineWarmup::RecordDraw(GL_LINES);
+            glDrawArraysIndirect(GL_LINES,
+                                 reinterpret_cast<const void*>(mode * sizeof(DrawArraysIndirectCommand)));
+        }
+
+        state.BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        s_GPUFrameOpen = false;
+    }
+}
+
+u32 DebugDraw::GetLastVertexCount() {
+    return s_LastVertexCount;
+}
+
+} // namespace Engine
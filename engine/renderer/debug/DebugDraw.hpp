@@ -0,0 +1,102 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "math/AABB.hpp"
+#include "math/Frustum.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+struct CascadeInfo;
+
+enum class DebugDrawMode : u32 {
+    DepthTested = 0,    // Hidden behind scene geometry
+    Overlay,            // Always on top
+    Count
+};
+
+// DebugDraw - immediate-mode world-space debug lines.
+//
+// Draw*() may be called from any thread, any time during the frame; shapes
+// are expanded into line vertices and appended under a lock, so nothing is
+// created in the registry and nothing goes through the geometry passes.
+// Render() draws everything collected since the last Render() with vertex
+// pulling from one ring buffer upload: one draw call per mode. Depth-tested
+// lines are compared against the scene depth texture passed in rather than
+// the target's depth buffer, so they work on any overlay target and at any
+// render scale.
+//
+// Compute shaders can draw too: include common/debug_draw.glsl and call
+// DebugDrawLine(). Those lines go into a GPU buffer at AppendBinding that
+// BeginFrame() empties, and are drawn by Render() with indirect draws whose
+// vertex counts the shaders' atomics wrote. Lines past GPUVerticesPerMode
+// are dropped.
+//
+// With a render thread, call TakeFrame() on the main thread at extraction
+// and hand the result to Render() in the packet.
+class DebugDraw {
+public:
+    static constexpr u32 AppendBinding = 15;            // std430, must match debug_draw.glsl
+    static constexpr u32 GPUVerticesPerMode = 65536;    // Must match debug_draw.glsl
+    static constexpr u32 MaxVerticesPerMode = 1u << 20; // CPU side, per frame
+    static constexpr u32 MaxSphereSegments = 64;
+
+    // Mirrors DebugVertex in debug_lines.glsl (std430)
+    struct Vertex {
+        glm::vec3 Position;
+        u32 Color;          // RGBA8, unpackUnorm4x8
+    };
+
+    struct Frame {
+        Vector<Vertex> Vertices[static_cast<u32>(DebugDrawMode::Count)];
+    };
+
+    // GL thread
+    static void Init();
+    static void Shutdown();
+
+    // Empty the GPU append buffer and bind it at AppendBinding, before any
+    // compute pass that may draw
+    static void BeginFrame();
+
+    // Any thread
+    static void DrawLine(const glm::vec3& from, const glm::vec3& to, const glm::vec4& color,
+                         DebugDrawMode mode = DebugDrawMode::DepthTested);
+    static void DrawBox(const AABB& box, const glm::vec4& color, DebugDrawMode mode = DebugDrawMode::DepthTested);
+    static void DrawBox(const AABB& localBox, const glm::mat4& transform, const glm::vec4& color,
+                        DebugDrawMode mode = DebugDrawMode::DepthTested);
+
+    // Three great circles
+    static void DrawSphere(const glm::vec3& center, f32 radius, const glm::vec4& color,
+                           DebugDrawMode mode = DebugDrawMode::DepthTested, u32 segments = 24);
+
+    // The volume clip space maps to under viewProjection (camera or light)
+    static void DrawFrustum(const glm::mat4& viewProjection, const glm::vec4& color,
+                            DebugDrawMode mode = DebugDrawMode::DepthTested);
+
+    // From the planes; planes that don't meet (DisablePlane'd ones) skip the frustum
+    static void DrawFrustum(const Frustum& frustum, const glm::vec4& color,
+                            DebugDrawMode mode = DebugDrawMode::DepthTested);
+
+    // The cascade's light-space box
+    static void DrawCascade(const CascadeInfo& cascade, const glm::vec4& color,
+                            DebugDrawMode mode = DebugDrawMode::Overlay);
+
+    // Everything drawn since the last call
+    static Frame TakeFrame();
+
+    // GL thread. Draws frame and the GPU lines into the bound framebuffer
+    // with the camera uniform block. sceneDepth is the depth texture of the
+    // same view with depthUVScale of it rendered (GBuffer at render scale);
+    // 0 falls back to the bound depth buffer.
+    static void Render(const Frame& frame, u32 sceneDepth, const glm::vec2& depthUVScale,
+                       u32 viewportWidth, u32 viewportHeight);
+
+    // Single-threaded shorthand: Render(TakeFrame(), ...)
+    static void Render(u32 sceneDepth, const glm::vec2& depthUVScale, u32 viewportWidth, u32 viewportHeight);
+
+    // Line vertices drawn by the last Render(), CPU side
+    static u32 GetLastVertexCount();
+};
+
+} // namespace Engine
@@ -1,13 +1,25 @@
 #include "DebugRenderer.hpp"
 #include "renderer/shadows/CascadedShadowMap.hpp"
 #include "renderer/pipeline/GBuffer.hpp"
+#include "renderer/pipeline/HiZPyramid.hpp"
+#include "renderer/debug/OverdrawCounter.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
 #include "resources/ResourceManager.hpp"
 #include "core/Logger.hpp"
 
 #include <glad/gl.h>
+#include <algorithm>
 
 namespace Engine {
 
+namespace {
+
+// Invocations per pixel at the hot end of the heatmap
+constexpr f32 OverdrawHeatmapMax = 8.0f;
+
+} // anonymous namespace
+
 DebugRenderer::DebugRenderer() = default;
 
 DebugRenderer::~DebugRenderer() {
@@ -66,13 +78,9 @@ void DebugRenderer::CreateQuad() {
 void DebugRenderer::Render(u32 windowWidth, u32 windowHeight) {
     if (!m_Initialized || m_ActiveView == DebugView::None) return;
 
-    // Save OpenGL state
-    GLboolean depthTest, blend;
-    glGetBooleanv(GL_DEPTH_TEST, &depthTest);
-    glGetBooleanv(GL_BLEND, &blend);
-
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_BLEND);
+    GLStateCache::ScopedState savedState;
+    GLStateCache::Instance().SetDepthTest(false);
+    GLStateCache::Instance().SetBlend(false);
 
     switch (m_ActiveView) {
         case DebugView::CSMCascades:
@@ -84,18 +92,22 @@ void DebugRenderer::Render(u32 windowWidth, u32 windowHeight) {
         case DebugView::GBufferMetalRough:
             RenderGBufferView(windowWidth, windowHeight);
             break;
+        case DebugView::HiZPyramid:
+            RenderHiZView(windowWidth, windowHeight);
+            break;
+        case DebugView::Overdraw:
+            RenderOverdrawView(windowWidth, windowHeight);
+            break;
         default:
             break;
     }
-
-    // Restore state
-    if (depthTest) glEnable(GL_DEPTH_TEST);
-    if (blend) glEnable(GL_BLEND);
 }
 
-void DebugRenderer::RenderQuad(f32 x, f32 y, f32 w, f32 h, u32 textureId, i32 layer, i32 mode) {
+void DebugRenderer::RenderQuad(f32 x, f32 y, f32 w, f32 h, u32 textureId, i32 layer, i32 mode,
+                               const glm::vec2& uvScale) {
     m_DebugShader->Bind();
     m_DebugShader->SetFloat4("u_Viewport", glm::vec4(x, y, w, h));
+    m_DebugShader->SetFloat2("u_UVScale", uvScale);
     m_DebugShader->SetInt("u_Mode", mode);
     m_DebugShader->SetInt("u_Layer", layer);
     m_DebugShader->SetFloat("u_NearPlane", 0.1f);
@@ -104,16 +116,20 @@ void DebugRenderer::RenderQuad(f32 x, f32 y, f32 w, f32 h, u32 textureId, i32 la
     if (mode == 0) {
         // CSM depth array
         m_DebugShader->SetInt("u_DepthArray", 0);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D_ARRAY, textureId);
+        GLStateCache::Instance().BindTextureUnit(0, textureId);
+    } else if (mode == 7) {
+        // Unsigned integer counts, on a unit of their own
+        m_DebugShader->SetInt("u_Counts", 1);
+        m_DebugShader->SetFloat("u_HeatmapMax", OverdrawHeatmapMax);
+        GLStateCache::Instance().BindTextureUnit(1, textureId);
     } else {
         // 2D texture
         m_DebugShader->SetInt("u_Texture2D", 0);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, textureId);
+        GLStateCache::Instance().BindTextureUnit(0, textureId);
     }
 
     m_QuadVAO->Bind();
+    PipelineWarmup::RecordDraw(GL_TRIANGLES);
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
 }
 
@@ -154,38 +170,85 @@ void DebugRenderer::RenderGBufferView(u32 windowWidth, u32 windowHeight) {
             break;
         case DebugView::GBufferNormals:
             textureId = m_GBuffer->GetNormalTextureID();
-            mode = 3;  // Normal visualization mode
+            mode = m_GBuffer->IsCompact() ? 4 : 3;  // Octahedral / plain normal visualization
             break;
         case DebugView::GBufferDepth:
             textureId = m_GBuffer->GetDepthTextureID();
             mode = 2;  // Depth visualization
             break;
         case DebugView::GBufferMetalRough:
-            textureId = m_GBuffer->GetPositionTextureID();  // Position has depth in W
+            if (m_GBuffer->IsCompact()) {
+                textureId = m_GBuffer->GetAlbedoTextureID();  // Metal/rough packed in A
+                mode = 5;
+            } else {
+                textureId = m_GBuffer->GetPositionTextureID();  // Position has depth in W
+            }
             break;
         default:
             return;
     }
 
-    RenderQuad(x, y, size, size, textureId, 0, mode);
+    const glm::vec2 uvScale = m_GBuffer->GetFramebuffer().GetViewportUVScale();
+    RenderQuad(x, y, size, size, textureId, 0, mode, uvScale);
+}
+
+void DebugRenderer::RenderHiZView(u32 windowWidth, u32 windowHeight) {
+    if (!m_HiZ || m_HiZ->GetTextureID() == 0) {
+        LOG_CORE_WARN("DebugRenderer: No Hi-Z pyramid built for debug view");
+        return;
+    }
+
+    f32 size = m_ViewportScale;
+    f32 padding = 0.01f;
+
+    // Levels 0-3 in a column on the right, like the cascades
+    const u32 levels = std::min(m_HiZ->GetLevelCount(), 4u);
+    for (u32 i = 0; i < levels; i++) {
+        f32 x = 1.0f - size - padding;
+        f32 y = padding + (size + padding) * static_cast<f32>(i);
+
+        RenderQuad(x, y, size, size, m_HiZ->GetTextureID(), static_cast<i32>(i), 6, m_HiZ->GetUVScale());
+    }
+}
+
+void DebugRenderer::RenderOverdrawView(u32 windowWidth, u32 windowHeight) {
+    if (!m_Overdraw || m_Overdraw->GetTextureID() == 0) {
+        LOG_CORE_WARN("DebugRenderer: No overdraw counts for debug view");
+        return;
+    }
+
+    f32 size = m_ViewportScale * 2.0f;
+    f32 x = 1.0f - size - 0.01f;
+    f32 y = 0.01f;
+
+    RenderQuad(x, y, size, size, m_Overdraw->GetTextureID(), 0, 7, m_Overdraw->GetUVScale());
+}
+
+void DebugRenderer::SetOverdrawCounter(OverdrawCounter* counter) {
+    if (m_Overdraw && m_Overdraw != counter) m_Overdraw->SetEnabled(false);
+    m_Overdraw = counter;
+    if (m_Overdraw) m_Overdraw->SetEnabled(m_ActiveView == DebugView::Overdraw);
+}
+
+void DebugRenderer::SetActiveView(DebugView view) {
+    m_ActiveView = view;
+    if (m_Overdraw) m_Overdraw->SetEnabled(view == DebugView::Overdraw);
 }
 
 void DebugRenderer::CycleView() {
     u32 current = static_cast<u32>(m_ActiveView);
     current = (current + 1) % static_cast<u32>(DebugView::Count);
-    m_ActiveView = static_cast<DebugView>(current);
+    SetActiveView(static_cast<DebugView>(current));
 
     const char* viewNames[] = {"None", "CSM Cascades", "GBuffer Albedo",
-                                "GBuffer Normals", "GBuffer Depth", "GBuffer Metal/Rough"};
+                                "GBuffer Normals", "GBuffer Depth", "GBuffer Metal/Rough", "Hi-Z Pyramid",
+                                "Overdraw"};
+    static_assert(sizeof(viewNames) / sizeof(viewNames[0]) == static_cast<u32>(DebugView::Count));
     LOG_CORE_INFO("Debug View: {}", viewNames[current]);
 }
 
 void DebugRenderer::ToggleView(DebugView view) {
-    if (m_ActiveView == view) {
-        m_ActiveView = DebugView::None;
-    } else {
-        m_ActiveView = view;
-    }
+    SetActiveView(m_ActiveView == view ? DebugView::None : view);
 }
 
 } // namespace Engine
@@ -10,6 +10,8 @@ namespace Engine {
 // Forward declarations
 class CascadedShadowMap;
 class GBuffer;
+class HiZPyramid;
+class OverdrawCounter;
 
 enum class DebugView : u32 {
     None = 0,
@@ -18,6 +20,8 @@ enum class DebugView : u32 {
     GBufferNormals,     // World-space normals
     GBufferDepth,       // Depth buffer
     GBufferMetalRough,  // Metallic/Roughness packed texture
+    HiZPyramid,         // First Hi-Z levels, min / max depth
+    Overdraw,           // Fragment shader invocations per pixel, as a heatmap
     Count
 };
 
@@ -32,12 +36,15 @@ public:
     // Set sources for debug visualization
     void SetCSM(const CascadedShadowMap* csm) { m_CSM = csm; }
     void SetGBuffer(const GBuffer* gbuffer) { m_GBuffer = gbuffer; }
+    void SetHiZ(const HiZPyramid* pyramid) { m_HiZ = pyramid; }
+    // Counts only while the Overdraw view is active
+    void SetOverdrawCounter(OverdrawCounter* counter);
 
     // Render debug overlay
     void Render(u32 windowWidth, u32 windowHeight);
 
     // Control active view
-    void SetActiveView(DebugView view) { m_ActiveView = view; }
+    void SetActiveView(DebugView view);
     DebugView GetActiveView() const { return m_ActiveView; }
     void CycleView();
     void ToggleView(DebugView view);
@@ -49,9 +56,12 @@ public:
 
 private:
     void CreateQuad();
-    void RenderQuad(f32 x, f32 y, f32 w, f32 h, u32 textureId, i32 layer, i32 mode);
+    void RenderQuad(f32 x, f32 y, f32 w, f32 h, u32 textureId, i32 layer, i32 mode,
+                    const glm::vec2& uvScale = glm::vec2(1.0f));
     void RenderCSMCascades(u32 windowWidth, u32 windowHeight);
     void RenderGBufferView(u32 windowWidth, u32 windowHeight);
+    void RenderHiZView(u32 windowWidth, u32 windowHeight);
+    void RenderOverdrawView(u32 windowWidth, u32 windowHeight);
 
 private:
     Ref<Shader> m_DebugShader;
@@ -59,6 +69,8 @@ private:
 
     const CascadedShadowMap* m_CSM = nullptr;
     const GBuffer* m_GBuffer = nullptr;
+    const HiZPyramid* m_HiZ = nullptr;
+    OverdrawCounter* m_Overdraw = nullptr;
 
     DebugView m_ActiveView = DebugView::None;
     f32 m_ViewportScale = 0.2f;  // Each viewport is 20% of screen width
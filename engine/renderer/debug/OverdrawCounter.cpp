@@ -0,0 +1,59 @@
+#include "renderer/debug/OverdrawCounter.hpp"
+#include "renderer/pipeline/GBuffer.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+
+namespace Engine {
+
+OverdrawCounter::~OverdrawCounter() {
+    if (m_Texture) GLMemory::DeleteTextures(1, &m_Texture);
+}
+
+void OverdrawCounter::SetEnabled(bool enabled) {
+    m_Enabled = enabled;
+
+    // Nothing to keep between sessions
+    if (!enabled && m_Texture) {
+        GLMemory::DeleteTextures(1, &m_Texture);
+        m_Texture = 0;
+        m_Width = 0;
+        m_Height = 0;
+    }
+}
+
+void OverdrawCounter::Allocate(u32 width, u32 height) {
+    if (m_Texture) GLMemory::DeleteTextures(1, &m_Texture);
+
+    m_Width = width;
+    m_Height = height;
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_Texture);
+    GLMemory::TextureStorage2D(m_Texture, 1, GL_R32UI, static_cast<i32>(width), static_cast<i32>(height),
+                               MemoryTag::Renderer);
+    glTextureParameteri(m_Texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(m_Texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTextureParameteri(m_Texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_Texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    LOG_CORE_INFO("Overdraw counter: {}x{}", width, height);
+}
+
+void OverdrawCounter::Begin(const GBuffer& gbuffer) {
+    if (gbuffer.GetWidth() != m_Width || gbuffer.GetHeight() != m_Height) {
+        Allocate(gbuffer.GetWidth(), gbuffer.GetHeight());
+    }
+    m_UVScale = gbuffer.GetFramebuffer().GetViewportUVScale();
+
+    const u32 zero = 0;
+    glClearTexImage(m_Texture, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    glBindImageTexture(ImageBinding, m_Texture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+}
+
+void OverdrawCounter::End() {
+    // Sampled by the debug view
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+} // namespace Engine
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+class GBuffer;
+
+// OverdrawCounter - fragment shader invocations per pixel of a geometry pass.
+//
+// An R32UI image the size of the G-Buffer, cleared by Begin() and bound at
+// ImageBinding; the OVERDRAW variant of geometry.glsl adds one to its pixel
+// with imageAtomicAdd for every invocation. Early fragment tests stay on, so
+// fragments the depth test rejects (behind the depth prepass, say) are not
+// counted, the same as they are not shaded. Read it after End() through
+// GetUVScale(), like the G-Buffer; DebugView::Overdraw shows it as a heatmap.
+//
+// Costs an atomic per fragment: enable it only while someone looks.
+class OverdrawCounter {
+public:
+    // Must match geometry.glsl
+    static constexpr u32 ImageBinding = 0;
+
+    OverdrawCounter() = default;
+    ~OverdrawCounter();
+
+    OverdrawCounter(const OverdrawCounter&) = delete;
+    OverdrawCounter& operator=(const OverdrawCounter&) = delete;
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const { return m_Enabled; }
+
+    // Around the counted pass, which renders into gbuffer
+    void Begin(const GBuffer& gbuffer);
+    void End();
+
+    // Zero until counted once
+    u32 GetTextureID() const { return m_Texture; }
+    glm::vec2 GetUVScale() const { return m_UVScale; }
+
+private:
+    void Allocate(u32 width, u32 height);
+
+private:
+    u32 m_Texture = 0;
+    u32 m_Width = 0;
+    u32 m_Height = 0;
+    glm::vec2 m_UVScale{1.0f};
+    bool m_Enabled = false;
+};
+
+} // namespace Engine
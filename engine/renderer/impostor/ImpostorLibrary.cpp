@@ -0,0 +1,325 @@
+#include "renderer/impostor/ImpostorLibrary.hpp"
+#include "renderer/opengl/GLBuffer.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
+#include "renderer/Material.hpp"
+#include "renderer/Mesh.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 InitialLayers = 4;
+constexpr u32 MinMipFrameSize = 4;     // Smallest view the mip chain goes down to
+
+// Octahedral [0, 1]^2 back to a direction, +Y at the center; must match
+// OctahedralDecode in impostor.glsl
+glm::vec3 OctahedralDecode(glm::vec2 uv) {
+    const glm::vec2 e = uv * 2.0f - 1.0f;
+    glm::vec3 n(e.x, 1.0f - std::abs(e.x) - std::abs(e.y), e.y);
+    if (n.y < 0.0f) {
+        const f32 x = (1.0f - std::abs(n.z)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+        const f32 z = (1.0f - std::abs(n.x)) * (n.z >= 0.0f ? 1.0f : -1.0f);
+        n.x = x;
+        n.z = z;
+    }
+    return glm::normalize(n);
+}
+
+// View basis for a frame direction; must match FrameBasis in impostor.glsl
+void FrameBasis(const glm::vec3& direction, glm::vec3& right, glm::vec3& up) {
+    const glm::vec3 worldUp = std::abs(direction.y) > 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    right = glm::normalize(glm::cross(worldUp, direction));
+    up = glm::cross(direction, right);
+}
+
+} // anonymous namespace
+
+ImpostorLibrary& ImpostorLibrary::Instance() {
+    static ImpostorLibrary instance;
+    return instance;
+}
+
+bool ImpostorLibrary::SetSettings(const ImpostorSettings& settings) {
+    if (!m_Meshes.empty()) {
+        LOG_CORE_WARN("ImpostorLibrary: settings change while {} impostors exist, Clear() first", m_Meshes.size());
+        return false;
+    }
+    if (settings.FramesPerSide == 0 || settings.FrameResolution < MinMipFrameSize ||
+        (settings.FrameResolution & (settings.FrameResolution - 1)) != 0) {
+        LOG_CORE_ERROR("ImpostorLibrary: {} frames of {} pixels per side", settings.FramesPerSide,
+                       settings.FrameResolution);
+        return false;
+    }
+
+    Clear();
+    m_Settings = settings;
+    return true;
+}
+
+void ImpostorLibrary::LoadShaders() {
+    m_BakeShader = CreateRef<Shader>("assets/shaders/deferred/impostor_bake.glsl", "",
+                                     MaterialLibrary::Instance().GetShaderDefines());
+}
+
+void ImpostorLibrary::Reload() {
+    if (m_BakeShader) {
+        LoadShaders();
+    }
+}
+
+void ImpostorLibrary::CreateResources() {
+    if (m_Framebuffer) return;
+
+    LoadShaders();
+
+    // Corners of the unit quad, counter-clockwise facing the view
+    const f32 corners[] = {-1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f};
+    const u32 indices[] = {0, 1, 2, 2, 3, 0};
+    m_QuadVAO = CreateRef<VertexArray>();
+    auto vbo = CreateRef<VertexBuffer>(corners, static_cast<u32>(sizeof(corners)));
+    vbo->SetLayout({
+        { ShaderDataType::Float2, "a_Corner" }
+    });
+    m_QuadVAO->AddVertexBuffer(vbo);
+    m_QuadVAO->SetIndexBuffer(CreateRef<IndexBuffer>(indices, 6));
+
+    const u32 atlasSize = m_Settings.FramesPerSide * m_Settings.FrameResolution;
+    m_Levels = 1;
+    while ((m_Settings.FrameResolution >> m_Levels) >= MinMipFrameSize) {
+        ++m_Levels;
+    }
+
+    glCreateRenderbuffers(1, &m_DepthRenderbuffer);
+    glNamedRenderbufferStorage(m_DepthRenderbuffer, GL_DEPTH_COMPONENT24, atlasSize, atlasSize);
+
+    glCreateFramebuffers(1, &m_Framebuffer);
+    glNamedFramebufferRenderbuffer(m_Framebuffer, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_DepthRenderbuffer);
+    const GLenum drawBuffers[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glNamedFramebufferDrawBuffers(m_Framebuffer, 2, drawBuffers);
+}
+
+bool ImpostorLibrary::EnsureLayerCapacity(u32 required) {
+    if (required <= m_LayerCapacity) return true;
+
+    u32 capacity = std::max(m_LayerCapacity * 2, InitialLayers);
+    while (capacity < required) {
+        capacity *= 2;
+    }
+
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    capacity = std::min(capacity, static_cast<u32>(maxLayers));
+    if (capacity < required) {
+        LOG_CORE_WARN("ImpostorLibrary: atlas arrays are full ({} layers)", m_LayerCapacity);
+        return false;
+    }
+
+    // Immutable storage, so growing copies every layer into new arrays
+    const u32 atlasSize = m_Settings.FramesPerSide * m_Settings.FrameResolution;
+    auto grow = [&](u32& array, GLenum format) {
+        u32 texture = 0;
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &texture);
+        GLMemory::TextureStorage3D(texture, static_cast<GLsizei>(m_Levels), format, atlasSize, atlasSize, capacity,
+                                   MemoryTag::Renderer);
+        glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        if (array) {
+            for (u32 level = 0; level < m_Levels; ++level) {
+                const u32 size = std::max(1u, atlasSize >> level);
+                glCopyImageSubData(array, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, 0,
+                                   texture, GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, 0,
+                                   size, size, static_cast<GLsizei>(m_LayerCapacity));
+            }
+            GLMemory::DeleteTextures(1, &array);
+        }
+        array = texture;
+    };
+    grow(m_AlbedoArray, GL_RGBA8);
+    grow(m_NormalDepthArray, GL_RGBA8);
+
+    m_LayerCapacity = capacity;
+    return true;
+}
+
+u32 ImpostorLibrary::AllocateLayer() {
+    if (!m_FreeLayers.empty()) {
+        const u32 layer = m_FreeLayers.back();
+        m_FreeLayers.pop_back();
+        return layer;
+    }
+
+    const u32 layer = static_cast<u32>(m_Impostors.size());
+    if (!EnsureLayerCapacity(layer + 1)) return NoImpostor;
+    m_Impostors.push_back({});
+    return layer;
+}
+
+u32 ImpostorLibrary::Bake(const Mesh& mesh, u32 materialId) {
+    if (!mesh.IsUploaded()) {
+        LOG_CORE_WARN("ImpostorLibrary: can't bake a mesh that isn't uploaded");
+        return NoImpostor;
+    }
+    const BoundingSphere& sphere = mesh.GetBoundingSphere();
+    if (sphere.Radius <= 0.0f) {
+        LOG_CORE_WARN("ImpostorLibrary: can't bake a mesh without bounds");
+        return NoImpostor;
+    }
+
+    CreateResources();
+
+    u32 layer = Find(&mesh);
+    if (layer == NoImpostor) {
+        layer = AllocateLayer();
+        if (layer == NoImpostor) return NoImpostor;
+    }
+
+    const MaterialLibrary& materials = MaterialLibrary::Instance();
+    const u32 material = materials.Contains(materialId) ? materialId : MaterialLibrary::DefaultMaterial;
+
+    auto& state = GLStateCache::Instance();
+    GLStateCache::ScopedState savedState;
+    RenderState bakeState;
+    bakeState.CullFace = false;     // Cards and open meshes seen from behind
+    state.Apply(bakeState);
+
+    glNamedFramebufferTextureLayer(m_Framebuffer, GL_COLOR_ATTACHMENT0, m_AlbedoArray, 0, static_cast<GLint>(layer));
+    glNamedFramebufferTextureLayer(m_Framebuffer, GL_COLOR_ATTACHMENT1, m_NormalDepthArray, 0,
+                                   static_cast<GLint>(layer));
+    const f32 clearColor[] = {0.0f, 0.0f, 0.0f, 0.0f};
+    const f32 clearDepth = 1.0f;
+    glClearNamedFramebufferfv(m_Framebuffer, GL_COLOR, 0, clearColor);
+    glClearNamedFramebufferfv(m_Framebuffer, GL_COLOR, 1, clearColor);
+    glClearNamedFramebufferfv(m_Framebuffer, GL_DEPTH, 0, &clearDepth);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+
+    m_BakeShader->Bind();
+    m_BakeShader->SetMat4("u_Model", mesh.GetDrawTransform(glm::mat4(1.0f)));
+    m_BakeShader->SetFloat4("u_Sphere", glm::vec4(sphere.Center, sphere.Radius));
+    m_BakeShader->SetUInt("u_MaterialIndex", material);
+    materials.Bind();
+    mesh.GetVertexArray()->Bind();
+
+    const MeshLOD lod = mesh.GetLOD(0);
+    const usize indexOffset = (static_cast<usize>(mesh.GetBaseIndex()) + lod.IndexOffset) * sizeof(u32);
+    const u32 frames = m_Settings.FramesPerSide;
+    const u32 resolution = m_Settings.FrameResolution;
+    for (u32 y = 0; y < frames; ++y) {
+        for (u32 x = 0; x < frames; ++x) {
+            const glm::vec3 direction = OctahedralDecode((glm::vec2(x, y) + 0.5f) / static_cast<f32>(frames));
+            glm::vec3 right, up;
+            FrameBasis(direction, right, up);
+
+            glViewport(static_cast<GLint>(x * resolution), static_cast<GLint>(y * resolution),
+                       static_cast<GLsizei>(resolution), static_cast<GLsizei>(resolution));
+            m_BakeShader->SetFloat3("u_FrameDirection", direction);
+            m_BakeShader->SetFloat3("u_FrameRight", right);
+            m_BakeShader->SetFloat3("u_FrameUp", up);
+            PipelineWarmup::RecordDraw(GL_TRIANGLES);
+            glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(lod.IndexCount), GL_UNSIGNED_INT,
+                                     reinterpret_cast<const void*>(indexOffset),
+                                     static_cast<GLint>(mesh.GetBaseVertex()));
+        }
+    }
+
+    // Passes bind their own targets and viewports
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glGenerateTextureMipmap(m_AlbedoArray);
+    glGenerateTextureMipmap(m_NormalDepthArray);
+
+    m_Meshes[&mesh] = layer;
+    GPUImpostor& impostor = m_Impostors[layer];
+    impostor.Sphere = glm::vec4(sphere.Center, sphere.Radius);
+    impostor.Layer = layer;
+    m_Dirty = true;
+
+    UpdateStats();
+    return layer;
+}
+
+void ImpostorLibrary::Remove(const Mesh& mesh) {
+    auto it = m_Meshes.find(&mesh);
+    if (it == m_Meshes.end()) return;
+
+    m_FreeLayers.push_back(it->second);
+    m_Meshes.erase(it);
+    UpdateStats();
+}
+
+void ImpostorLibrary::Clear() {
+    if (m_AlbedoArray) GLMemory::DeleteTextures(1, &m_AlbedoArray);
+    if (m_NormalDepthArray) GLMemory::DeleteTextures(1, &m_NormalDepthArray);
+    if (m_ImpostorBuffer) GLMemory::DeleteBuffers(1, &m_ImpostorBuffer);
+    if (m_DepthRenderbuffer) glDeleteRenderbuffers(1, &m_DepthRenderbuffer);
+    if (m_Framebuffer) glDeleteFramebuffers(1, &m_Framebuffer);
+    m_AlbedoArray = m_NormalDepthArray = m_ImpostorBuffer = 0;
+    m_DepthRenderbuffer = m_Framebuffer = 0;
+    m_LayerCapacity = 0;
+    m_BufferCapacity = 0;
+    m_QuadVAO.reset();
+
+    m_Meshes.clear();
+    m_Impostors.clear();
+    m_FreeLayers.clear();
+    m_Dirty = false;
+    m_Stats = {};
+}
+
+u32 ImpostorLibrary::Find(const Mesh* mesh) const {
+    auto it = m_Meshes.find(mesh);
+    return it != m_Meshes.end() ? it->second : NoImpostor;
+}
+
+f32 ImpostorLibrary::GetError() const {
+    // About 2 * sqrt(2) * FramesPerSide views around the equator
+    const f32 halfStep = glm::pi<f32>() / (2.0f * 1.4142f * static_cast<f32>(m_Settings.FramesPerSide));
+    return std::sin(halfStep);
+}
+
+void ImpostorLibrary::Bind() {
+    if (m_Impostors.empty()) return;
+
+    if (m_Dirty) {
+        const u32 required = static_cast<u32>(m_Impostors.size());
+        if (required > m_BufferCapacity) {
+            if (m_ImpostorBuffer) GLMemory::DeleteBuffers(1, &m_ImpostorBuffer);
+            m_BufferCapacity = m_LayerCapacity;
+            glCreateBuffers(1, &m_ImpostorBuffer);
+            GLMemory::BufferStorage(m_ImpostorBuffer, m_BufferCapacity * sizeof(GPUImpostor), nullptr,
+                                    GL_DYNAMIC_STORAGE_BIT, MemoryTag::Renderer);
+        }
+        glNamedBufferSubData(m_ImpostorBuffer, 0, required * sizeof(GPUImpostor), m_Impostors.data());
+        m_Dirty = false;
+    }
+
+    auto& state = GLStateCache::Instance();
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, ImpostorBinding, m_ImpostorBuffer);
+    state.BindTextureUnit(AlbedoUnit, m_AlbedoArray);
+    state.BindTextureUnit(NormalDepthUnit, m_NormalDepthArray);
+}
+
+void ImpostorLibrary::UpdateStats() {
+    m_Stats.Impostors = static_cast<u32>(m_Meshes.size());
+    m_Stats.Layers = m_LayerCapacity;
+
+    const u32 atlasSize = m_Settings.FramesPerSide * m_Settings.FrameResolution;
+    usize layerBytes = 0;
+    for (u32 level = 0; level < m_Levels; ++level) {
+        const i32 size = static_cast<i32>(std::max(1u, atlasSize >> level));
+        layerBytes += GLMemory::GetLevelSize(GL_RGBA8, size, size);
+    }
+    m_Stats.Memory = layerBytes * 2 * m_LayerCapacity;
+}
+
+} // namespace Engine
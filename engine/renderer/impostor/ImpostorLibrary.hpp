@@ -0,0 +1,126 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include "renderer/opengl/GLVertexArray.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+class Mesh;
+
+struct ImpostorSettings {
+    u32 FramesPerSide = 8;          // Octahedral views per atlas edge
+    u32 FrameResolution = 128;      // Pixels per view edge, power of two
+};
+
+// ImpostorLibrary - baked billboards standing in for distant meshes.
+//
+// Bake() renders LOD 0 of a mesh from FramesPerSide^2 directions spread
+// over the sphere by an octahedral mapping (+Y at the center of the
+// atlas), each an orthographic view of the bounding sphere, into one layer
+// of two texture arrays: albedo with coverage in alpha, and the mesh space
+// normal with the depth across the sphere in alpha. Colors are the
+// material's, untinted, so instances multiply in their own color as the
+// geometry pass does.
+//
+// LODSelectionSystem moves renderables whose mesh has an impostor to
+// Renderable::ImpostorLevel once even the coarsest LOD is below the screen
+// error GetError() allows; DeferredLightingSystem then draws them as one
+// quad each through an IndirectDrawBatcher and impostor.glsl, which picks
+// the view nearest the camera direction, alpha-tests it and writes the
+// G-Buffer with the baked normal and a depth offset into the sphere.
+// Impostors skip the depth prepass; shadow passes keep drawing the mesh.
+//
+// One impostor per mesh, baked with the material given; other materials on
+// the same mesh show it at a distance. GL thread only; bake between frames.
+class ImpostorLibrary {
+public:
+    // Must match impostor.glsl
+    static constexpr u32 ImpostorBinding = 7;
+    static constexpr u32 AlbedoUnit = 0;
+    static constexpr u32 NormalDepthUnit = 1;
+
+    static constexpr u32 NoImpostor = ~0u;
+
+    struct Stats {
+        u32 Impostors = 0;
+        u32 Layers = 0;         // Allocated in each array
+        usize Memory = 0;       // Both arrays, every mip
+    };
+
+    static ImpostorLibrary& Instance();
+
+    ImpostorLibrary(const ImpostorLibrary&) = delete;
+    ImpostorLibrary& operator=(const ImpostorLibrary&) = delete;
+
+    // Only while the library is empty; Clear() first
+    bool SetSettings(const ImpostorSettings& settings);
+    const ImpostorSettings& GetSettings() const { return m_Settings; }
+
+    // Render mesh's impostor with MaterialLibrary material materialId,
+    // replacing any it had. The mesh must be uploaded and the material's
+    // textures resident (MaterialLibrary::Update). Returns the impostor's
+    // index, NoImpostor on failure.
+    u32 Bake(const Mesh& mesh, u32 materialId = 0);
+    void Remove(const Mesh& mesh);
+    void Clear();
+
+    // Index of mesh's impostor, NoImpostor if it has none. Any thread, as
+    // long as nothing bakes meanwhile.
+    u32 Find(const Mesh* mesh) const;
+    bool IsEmpty() const { return m_Meshes.empty(); }
+
+    // LOD error of every impostor, relative to the bounding radius: half the
+    // angle between neighbouring views, the largest parallax a view shows
+    f32 GetError() const;
+
+    // Arrays and impostor buffer, and the shared quad impostor.glsl expects
+    void Bind();
+    VertexArray* GetQuadVertexArray() const { return m_QuadVAO.get(); }
+
+    const Stats& GetStats() const { return m_Stats; }
+
+    void Reload();
+
+private:
+    ImpostorLibrary() = default;
+    ~ImpostorLibrary() = default;
+
+    // Must match impostor.glsl
+    struct GPUImpostor {
+        glm::vec4 Sphere;           // Mesh space center, radius
+        u32 Layer;
+        u32 Padding[3];
+    };
+
+    void LoadShaders();
+    void CreateResources();
+    bool EnsureLayerCapacity(u32 required);
+    u32 AllocateLayer();
+    void UpdateStats();
+
+private:
+    ImpostorSettings m_Settings;
+
+    Ref<Shader> m_BakeShader;
+    Ref<VertexArray> m_QuadVAO;
+
+    u32 m_AlbedoArray = 0;
+    u32 m_NormalDepthArray = 0;
+    u32 m_DepthRenderbuffer = 0;
+    u32 m_Framebuffer = 0;
+    u32 m_LayerCapacity = 0;
+    u32 m_Levels = 0;
+
+    HashMap<const Mesh*, u32> m_Meshes;     // Layer, which is also the index
+    Vector<GPUImpostor> m_Impostors;        // Per layer
+    Vector<u32> m_FreeLayers;
+    u32 m_ImpostorBuffer = 0;
+    u32 m_BufferCapacity = 0;
+    bool m_Dirty = false;
+
+    Stats m_Stats;
+};
+
+} // namespace Engine
@@ -0,0 +1,98 @@
+#include "renderer/lighting/ClusteredLightCuller.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <cmath>
+
+namespace Engine {
+
+namespace {
+
+// Near / far clip distances of a GL perspective projection
+void ExtractClipPlanes(const glm::mat4& projection, f32& zNear, f32& zFar) {
+    const f32 a = projection[2][2];
+    const f32 b = projection[3][2];
+    zNear = b / (a - 1.0f);
+    zFar = b / (a + 1.0f);
+
+    if (!(zNear > 0.0f) || !(zFar > zNear)) {
+        zNear = 0.1f;
+        zFar = 1000.0f;
+    }
+}
+
+} // anonymous namespace
+
+ClusteredLightCuller::ClusteredLightCuller() {
+    glCreateBuffers(1, &m_ClusterSSBO);
+    GLMemory::BufferStorage(m_ClusterSSBO, ClusterCount * sizeof(glm::uvec4), nullptr, 0, MemoryTag::Renderer);
+
+    glCreateBuffers(1, &m_LightIndexSSBO);
+    GLMemory::BufferStorage(m_LightIndexSSBO, MaxLightIndices * sizeof(u32), nullptr, 0, MemoryTag::Renderer);
+
+    glCreateBuffers(1, &m_CounterSSBO);
+    GLMemory::BufferStorage(m_CounterSSBO, sizeof(u32), nullptr, GL_DYNAMIC_STORAGE_BIT, MemoryTag::Renderer);
+
+    LoadShader();
+}
+
+ClusteredLightCuller::~ClusteredLightCuller() {
+    if (m_ClusterSSBO) GLMemory::DeleteBuffers(1, &m_ClusterSSBO);
+    if (m_LightIndexSSBO) GLMemory::DeleteBuffers(1, &m_LightIndexSSBO);
+    if (m_CounterSSBO) GLMemory::DeleteBuffers(1, &m_CounterSSBO);
+}
+
+void ClusteredLightCuller::LoadShader() {
+    m_CullShader = CreateRef<Shader>("assets/shaders/deferred/light_culling.glsl");
+}
+
+void ClusteredLightCuller::Reload() {
+    LoadShader();
+}
+
+void ClusteredLightCuller::Cull(const Camera& camera, u32 width, u32 height,
+                                u32 pointLightCount, u32 spotLightCount) {
+    m_ScreenSize = glm::vec2(static_cast<f32>(width), static_cast<f32>(height));
+    ExtractClipPlanes(camera.GetProjectionMatrix(), m_ZNear, m_ZFar);
+
+    const u32 zero = 0;
+    glNamedBufferSubData(m_CounterSSBO, 0, sizeof(u32), &zero);
+
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, ClusterBinding, m_ClusterSSBO);
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, LightIndexBinding, m_LightIndexSSBO);
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, CounterBinding, m_CounterSSBO);
+
+    m_CullShader->Bind();
+    m_CullShader->SetUInt3("u_GridSize", glm::uvec3(GridX, GridY, GridZ));
+    m_CullShader->SetFloat2("u_ScreenSize", m_ScreenSize);
+    m_CullShader->SetFloat("u_ZNear", m_ZNear);
+    m_CullShader->SetFloat("u_ZFar", m_ZFar);
+    m_CullShader->SetUInt("u_PointLightCount", pointLightCount);
+    m_CullShader->SetUInt("u_SpotLightCount", spotLightCount);
+    m_CullShader->SetUInt("u_MaxLightIndices", MaxLightIndices);
+
+    glDispatchCompute((ClusterCount + ThreadsPerGroup - 1) / ThreadsPerGroup, 1, 1);
+
+    // Lighting reads the lists as SSBOs in the fragment shader
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void ClusteredLightCuller::Bind(Shader& shader) const {
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, ClusterBinding, m_ClusterSSBO);
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, LightIndexBinding, m_LightIndexSSBO);
+
+    // slice = log(viewZ) * scale + bias
+    const f32 logRatio = std::log(m_ZFar / m_ZNear);
+    const f32 scale = static_cast<f32>(GridZ) / logRatio;
+    const f32 bias = -static_cast<f32>(GridZ) * std::log(m_ZNear) / logRatio;
+
+    shader.SetUInt3("u_ClusterGridSize", glm::uvec3(GridX, GridY, GridZ));
+    shader.SetFloat2("u_ScreenSize", m_ScreenSize);
+    shader.SetFloat("u_ZNear", m_ZNear);
+    shader.SetFloat("u_ClusterScale", scale);
+    shader.SetFloat("u_ClusterBias", bias);
+}
+
+} // namespace Engine
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include "camera/Camera.hpp"
+
+namespace Engine {
+
+// ClusteredLightCuller - bins point and spot lights into a 3D froxel grid.
+//
+// The view frustum is split into GridX x GridY screen tiles and GridZ
+// exponential depth slices. A compute pass (light_culling.glsl) tests every
+// light's bounding sphere against each cluster and writes per-cluster index
+// lists to SSBOs; the lighting shader then only iterates the lights of the
+// cluster a pixel falls into.
+//
+// Light data itself lives in SSBOs owned by the lighting system, bound at
+// PointLightBinding / SpotLightBinding before Cull(); the view and inverse
+// projection come from the camera uniform block.
+class ClusteredLightCuller {
+public:
+    static constexpr u32 GridX = 16;
+    static constexpr u32 GridY = 9;
+    static constexpr u32 GridZ = 24;
+    static constexpr u32 ClusterCount = GridX * GridY * GridZ;
+
+    // Must match light_culling.glsl
+    static constexpr u32 ThreadsPerGroup = 128;
+    static constexpr u32 MaxLightsPerCluster = 128;
+
+    // Budget for the global index list, as an average per cluster
+    static constexpr u32 AverageLightsPerCluster = 32;
+    static constexpr u32 MaxLightIndices = ClusterCount * AverageLightsPerCluster;
+
+    // SSBO binding points shared by the culling and lighting shaders
+    static constexpr u32 PointLightBinding = 5;
+    static constexpr u32 SpotLightBinding = 6;
+    static constexpr u32 ClusterBinding = 7;
+    static constexpr u32 LightIndexBinding = 8;
+    static constexpr u32 CounterBinding = 9;
+
+    ClusteredLightCuller();
+    ~ClusteredLightCuller();
+
+    ClusteredLightCuller(const ClusteredLightCuller&) = delete;
+    ClusteredLightCuller& operator=(const ClusteredLightCuller&) = delete;
+
+    // Build the cluster light lists for this frame
+    void Cull(const Camera& camera, u32 width, u32 height, u32 pointLightCount, u32 spotLightCount);
+
+    // Bind cluster buffers and set the lookup uniforms on the lighting shader
+    void Bind(Shader& shader) const;
+
+    void Reload();
+
+private:
+    void LoadShader();
+
+private:
+    Ref<Shader> m_CullShader;
+
+    u32 m_ClusterSSBO = 0;
+    u32 m_LightIndexSSBO = 0;
+    u32 m_CounterSSBO = 0;
+
+    glm::vec2 m_ScreenSize{1.0f};
+    f32 m_ZNear = 0.1f;
+    f32 m_ZFar = 1000.0f;
+};
+
+} // namespace Engine
@@ -1,44 +1,326 @@
 #include "renderer/lighting/DeferredLightingSystem.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
 #include "renderer/shadows/ShadowMapSystem.hpp"
+#include "renderer/Material.hpp"
+#include "renderer/impostor/ImpostorLibrary.hpp"
+#include "renderer/RenderGroups.hpp"
+#include "renderer/opengl/GPUProfiler.hpp"
+#include "resources/ResourceManager.hpp"
 #include "ecs/Components/Transform.hpp"
+#include "ecs/Components/TransformSoA.hpp"
 #include "ecs/Components/Renderable.hpp"
 #include "ecs/Components/LightComponents.hpp"
+#include "ecs/Registry.hpp"
 #include "core/Logger.hpp"
+#include "core/Telemetry.hpp"
+#include "core/JobSystem.hpp"
 
 #include <glad/gl.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace Engine {
 
+namespace {
+
+const TelemetryGauge s_EntitiesRendered("Deferred.EntitiesRendered");
+const TelemetryGauge s_GeometryDrawCalls("Deferred.DrawCalls");
+const TelemetryGauge s_Triangles("Deferred.Triangles");
+const TelemetryGauge s_PointLights("Deferred.PointLights");
+const TelemetryGauge s_SpotLights("Deferred.SpotLights");
+
+// Keywords of lighting.glsl / lighting_tiled.glsl
+enum LightingKeyword : u32 {
+    LightingKeywordShadows = 0,
+    LightingKeywordPCFSamples = 1,
+    LightingKeywordVirtualShadows = 2,
+    LightingKeywordEVSM = 3
+};
+
+Vector<ShaderKeyword> LightingKeywords() {
+    return {
+        {"SHADOWS", {}},
+        {"PCF_SAMPLES", {"4", "8", "16"}},
+        {"VIRTUAL_SHADOWS", {}},
+        {"EVSM", {}}
+    };
+}
+
+// Keywords forward.glsl adds after the lighting ones, so a LightingVariantKey
+// selects the same shadow variant in it
+enum ForwardKeyword : u32 {
+    ForwardKeywordOIT = 4,
+    ForwardKeywordBindless = 5
+};
+
+Vector<ShaderKeyword> ForwardKeywords() {
+    Vector<ShaderKeyword> keywords = LightingKeywords();
+    keywords.push_back({"OIT", {}});
+    keywords.push_back({"BINDLESS_TEXTURES", {}});
+    return keywords;
+}
+
+MaterialBlend BlendOf(const MaterialLibrary& materials, const IndirectDrawBatcher::DrawItem& item) {
+    const Material* material = materials.Get(item.Instance.MaterialIndex);
+    return material ? material->Blend : MaterialBlend::Opaque;
+}
+
+// The Poisson disk has 16 taps; ShadowSettings::PCFSamples rounds up to a
+// compiled count
+u32 PCFSampleVariant(u32 samples) {
+    if (samples <= 4) return 0;
+    if (samples <= 8) return 1;
+    return 2;
+}
+
+GPUPointLight MakeGPUPointLight(const glm::vec3& position, const PointLightComponent& light) {
+    GPUPointLight gpuLight;
+    gpuLight.Position = glm::vec4(position, light.Radius);
+    gpuLight.ColorIntensity = glm::vec4(light.Color, light.Intensity);
+    gpuLight.Attenuation = glm::vec4(light.Constant, light.Linear, light.Quadratic, -1.0f);  // Shadow slot set later
+    return gpuLight;
+}
+
+GPUSpotLight MakeGPUSpotLight(const glm::vec3& position, const SpotLightComponent& light) {
+    GPUSpotLight gpuLight;
+    gpuLight.Position = glm::vec4(position, light.Range);
+    gpuLight.Direction = glm::vec4(glm::normalize(light.Direction), -1.0f);  // Shadow slot set later
+    gpuLight.ColorIntensity = glm::vec4(light.Color, light.Intensity);
+    gpuLight.CutoffAttenuation = glm::vec4(
+        glm::cos(light.InnerCutOff),
+        glm::cos(light.OuterCutOff),
+        light.Linear,
+        light.Quadratic
+    );
+    return gpuLight;
+}
+
+// Same lookup order as the gather views: AoS Transform first, then SoA
+bool TryGetWorldPosition(entt::registry& registry, entt::entity entity, glm::vec3& position) {
+    if (auto* transform = registry.try_get<Transform>(entity)) {
+        position = transform->GetWorldPosition();
+        return true;
+    }
+    if (auto* world = registry.try_get<WorldTransform>(entity)) {
+        position = world->GetWorldPosition();
+        return true;
+    }
+    return false;
+}
+
+template<typename GPULight>
+struct LightEntry {
+    entt::entity Entity;
+    GPULight Light;
+};
+
+template<typename GPULight>
+void SplitEntries(const FrameVector<LightEntry<GPULight>>& entries, Vector<GPULight>& lights,
+                  Vector<entt::entity>& entities, HashMap<entt::entity, u32>& slots) {
+    lights.clear();
+    entities.clear();
+    slots.clear();
+    lights.reserve(entries.size());
+    entities.reserve(entries.size());
+
+    for (const auto& entry : entries) {
+        slots[entry.Entity] = static_cast<u32>(lights.size());
+        lights.push_back(entry.Light);
+        entities.push_back(entry.Entity);
+    }
+}
+
+// Light SSBOs use immutable storage, so growing means recreating them (and
+// re-uploading everything)
+bool EnsureLightCapacity(u32& buffer, u32& capacity, u32 required, usize stride) {
+    if (buffer && required <= capacity) return false;
+
+    u32 newCapacity = std::max(capacity, 64u);
+    while (newCapacity < required) {
+        newCapacity *= 2;
+    }
+
+    if (buffer) GLMemory::DeleteBuffers(1, &buffer);
+    glCreateBuffers(1, &buffer);
+    GLMemory::BufferStorage(buffer, newCapacity * stride, nullptr, 0, MemoryTag::Renderer);
+    capacity = newCapacity;
+    return true;
+}
+
+// The light budget's fade scales intensity; culled lights get a zero
+// radius / range, which the light culling skips
+GPUPointLight ApplyBudgetFade(GPUPointLight light, f32 fade) {
+    light.ColorIntensity.w *= fade;
+    if (fade <= 0.0f) light.Position.w = 0.0f;
+    return light;
+}
+
+GPUSpotLight ApplyBudgetFade(GPUSpotLight light, f32 fade) {
+    light.ColorIntensity.w *= fade;
+    if (fade <= 0.0f) light.Position.w = 0.0f;
+    return light;
+}
+
+// Bounding sphere of the cone: apex plus the disc at full range
+LightBudget::Light MakeBudgetLight(entt::entity entity, const GPUSpotLight& light) {
+    const f32 range = light.Position.w;
+    const f32 cosOuter = std::max(light.CutoffAttenuation.y, 0.01f);
+    const f32 capRadius = range * std::sqrt(std::max(1.0f - cosOuter * cosOuter, 0.0f)) / cosOuter;
+
+    const glm::vec3 color(light.ColorIntensity);
+    return {entity, glm::vec3(light.Position) + glm::vec3(light.Direction) * (range * 0.5f),
+            std::sqrt(0.25f * range * range + capRadius * capRadius),
+            light.ColorIntensity.w * std::max({color.r, color.g, color.b})};
+}
+
+LightBudget::Light MakeBudgetLight(entt::entity entity, const GPUPointLight& light) {
+    const glm::vec3 color(light.ColorIntensity);
+    return {entity, glm::vec3(light.Position), light.Position.w,
+            light.ColorIntensity.w * std::max({color.r, color.g, color.b})};
+}
+
+// Stage the dirty slots in the ring, faded, and copy them into the persistent
+// SSBO, one copy per run of adjacent slots. Returns the number of lights uploaded.
+template<typename GPULight>
+u32 UploadLightSlots(GPURingBuffer& ring, u32 buffer, const Vector<GPULight>& lights, const Vector<f32>& fades,
+                     Vector<u32>& dirtySlots, bool full) {
+    const u32 count = static_cast<u32>(lights.size());
+    u32 uploaded = 0;
+
+    auto copyRange = [&](u32 first, u32 rangeCount) {
+        auto staging = ring.Allocate(rangeCount * sizeof(GPULight));
+        if (!staging) return;
+
+        auto* staged = static_cast<GPULight*>(staging.Data);
+        for (u32 i = 0; i < rangeCount; ++i) {
+            staged[i] = ApplyBudgetFade(lights[first + i], fades[first + i]);
+        }
+
+        glCopyNamedBufferSubData(staging.Buffer, buffer,
+                                 static_cast<GLintptr>(staging.Offset),
+                                 static_cast<GLintptr>(first * sizeof(GPULight)),
+                                 static_cast<GLsizeiptr>(rangeCount * sizeof(GPULight)));
+        uploaded += rangeCount;
+    };
+
+    if (full) {
+        if (count > 0) copyRange(0, count);
+    } else if (!dirtySlots.empty()) {
+        std::sort(dirtySlots.begin(), dirtySlots.end());
+        dirtySlots.erase(std::unique(dirtySlots.begin(), dirtySlots.end()), dirtySlots.end());
+
+        u32 first = dirtySlots[0];
+        u32 last = first;
+        for (usize i = 1; i < dirtySlots.size(); ++i) {
+            if (dirtySlots[i] == last + 1) {
+                last = dirtySlots[i];
+                continue;
+            }
+            copyRange(first, last - first + 1);
+            first = last = dirtySlots[i];
+        }
+        copyRange(first, last - first + 1);
+    }
+
+    dirtySlots.clear();
+    return uploaded;
+}
+
+// Write each light's shadow slot (its index in `shadowed`, -1 for lights that
+// lost their shadow) and mark the slots that changed
+template<typename GPULight, typename SlotField>
+void AssignShadowSlots(const Vector<entt::entity>& shadowed, Vector<entt::entity>& previous,
+                       Vector<GPULight>& lights, const HashMap<entt::entity, u32>& slots,
+                       Vector<u32>& dirtySlots, SlotField&& slotField) {
+    auto assign = [&](entt::entity entity, f32 shadowSlot) {
+        auto slot = slots.find(entity);
+        if (slot == slots.end()) return;
+
+        f32& current = slotField(lights[slot->second]);
+        if (current != shadowSlot) {
+            current = shadowSlot;
+            dirtySlots.push_back(slot->second);
+        }
+    };
+
+    for (auto entity : previous) {
+        if (std::find(shadowed.begin(), shadowed.end(), entity) == shadowed.end()) {
+            assign(entity, -1.0f);
+        }
+    }
+    for (u32 i = 0; i < static_cast<u32>(shadowed.size()); ++i) {
+        assign(shadowed[i], static_cast<f32>(i));
+    }
+
+    previous = shadowed;
+}
+
+Scope<Framebuffer> CreateLightingBuffer(u32 width, u32 height) {
+    FramebufferSpecification spec;
+    spec.Width = width;
+    spec.Height = height;
+    spec.Attachments = {
+        FramebufferTextureFormat::RGBA16F,
+        FramebufferTextureFormat::Depth24Stencil8
+    };
+    return CreateScope<Framebuffer>(spec);
+}
+
+} // anonymous namespace
+
 DeferredLightingSystem::DeferredLightingSystem() {
     m_DirectionalLights.reserve(MaxDirectionalLights);
-    m_PointLights.reserve(MaxPointLights);
-    m_SpotLights.reserve(MaxSpotLights);
 }
 
 DeferredLightingSystem::~DeferredLightingSystem() {
-    if (m_DirectionalLightUBO) glDeleteBuffers(1, &m_DirectionalLightUBO);
-    if (m_PointLightUBO) glDeleteBuffers(1, &m_PointLightUBO);
-    if (m_SpotLightUBO) glDeleteBuffers(1, &m_SpotLightUBO);
+    if (m_PointLightSSBO) GLMemory::DeleteBuffers(1, &m_PointLightSSBO);
+    if (m_SpotLightSSBO) GLMemory::DeleteBuffers(1, &m_SpotLightSSBO);
 }
 
 void DeferredLightingSystem::OnCreate(entt::registry& registry) {
-    (void)registry;
+    registry.on_construct<PointLightComponent>().connect<&DeferredLightingSystem::OnLightStructureChanged>(this);
+    registry.on_destroy<PointLightComponent>().connect<&DeferredLightingSystem::OnLightStructureChanged>(this);
+    registry.on_update<PointLightComponent>().connect<&DeferredLightingSystem::OnPointLightUpdated>(this);
+    registry.on_construct<SpotLightComponent>().connect<&DeferredLightingSystem::OnLightStructureChanged>(this);
+    registry.on_destroy<SpotLightComponent>().connect<&DeferredLightingSystem::OnLightStructureChanged>(this);
+    registry.on_update<SpotLightComponent>().connect<&DeferredLightingSystem::OnSpotLightUpdated>(this);
+    m_Connected = true;
+    m_LightsStructureDirty = true;
+
+    RenderableGroup(registry);
+    PointLightGroup(registry);
+    SpotLightGroup(registry);
 
     m_GBuffer = CreateScope<GBuffer>(m_Width, m_Height);
-
-    FramebufferSpecification lightingSpec;
-    lightingSpec.Width = m_Width;
-    lightingSpec.Height = m_Height;
-    lightingSpec.Attachments = {
-        FramebufferTextureFormat::RGBA16F,
-        FramebufferTextureFormat::Depth24Stencil8
-    };
-    m_LightingBuffer = CreateScope<Framebuffer>(lightingSpec);
+    m_Batcher = CreateScope<IndirectDrawBatcher>();
+    m_Batcher->SetPreviousTransforms(true);     // Velocity target
+    m_DepthBatcher = CreateScope<IndirectDrawBatcher>();
+    m_ImpostorBatcher = CreateScope<IndirectDrawBatcher>();
+    m_ImpostorBatcher->SetPreviousTransforms(true);
+    m_MaskedBatcher = CreateScope<IndirectDrawBatcher>(256);
+    m_TransparentBatcher = CreateScope<IndirectDrawBatcher>(256);
+    m_Transparency = CreateScope<WeightedBlendedOIT>();
+    m_ClusterCuller = CreateScope<ClusteredLightCuller>();
+    m_Device = IRenderDevice::Create(RenderBackend::OpenGL);
+    m_HiZ = CreateScope<HiZPyramid>();
+    m_AmbientOcclusion = CreateScope<AmbientOcclusion>();
+    m_VolumetricFog = CreateScope<VolumetricFog>();
+    m_Overdraw = CreateScope<OverdrawCounter>();
+    m_MeshletCuller = CreateScope<MeshletCuller>();
+    m_Scatter = CreateScope<ScatterRenderer>();
+    m_Terrain = CreateScope<TerrainRenderer>();
+    m_TemporalAA = CreateScope<TemporalAA>();
+    m_MainCameraUniforms = CreateScope<CameraUniformBuffer>();
+    m_LightingBuffer = CreateLightingBuffer(m_Width, m_Height);
+    ApplyRenderScale(m_RenderScale);
 
     LoadShaders();
     CreateScreenQuad();
-    CreateLightUBOs();
+    CreateLightBuffers();
 
     m_Initialized = true;
 
@@ -46,26 +328,261 @@ void DeferredLightingSystem::OnCreate(entt::registry& registry) {
 }
 
 void DeferredLightingSystem::OnDestroy(entt::registry& registry) {
-    (void)registry;
+    if (m_Connected) {
+        registry.on_construct<PointLightComponent>().disconnect<&DeferredLightingSystem::OnLightStructureChanged>(this);
+        registry.on_destroy<PointLightComponent>().disconnect<&DeferredLightingSystem::OnLightStructureChanged>(this);
+        registry.on_update<PointLightComponent>().disconnect<&DeferredLightingSystem::OnPointLightUpdated>(this);
+        registry.on_construct<SpotLightComponent>().disconnect<&DeferredLightingSystem::OnLightStructureChanged>(this);
+        registry.on_destroy<SpotLightComponent>().disconnect<&DeferredLightingSystem::OnLightStructureChanged>(this);
+        registry.on_update<SpotLightComponent>().disconnect<&DeferredLightingSystem::OnSpotLightUpdated>(this);
+        m_Connected = false;
+    }
+    m_Views.clear();
     m_Initialized = false;
 }
 
-void DeferredLightingSystem::OnUpdate(entt::registry& registry, f32 deltaTime) {
-    (void)deltaTime;
+void DeferredLightingSystem::OnLightStructureChanged(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    (void)entity;
+    m_LightsStructureDirty = true;
+}
 
+void DeferredLightingSystem::OnPointLightUpdated(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    m_UpdatedPointLights.push_back(entity);
+}
+
+void DeferredLightingSystem::OnSpotLightUpdated(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    m_UpdatedSpotLights.push_back(entity);
+}
+
+void DeferredLightingSystem::OnUpdate(entt::registry& registry, f32 deltaTime) {
     if (!m_Initialized || !m_Camera) return;
 
     m_Stats = {};
 
+    if (m_FramesToSettle > 0 && --m_FramesToSettle == 0) {
+        ShrinkToOutputSize();
+    }
+    UpdateRenderScale();
     GatherLights(registry);
+    ApplyLightBudget(deltaTime);
+
+    // A new sub-pixel offset per frame; culling keeps the unjittered frustum
+    const glm::vec2 jitter = m_TemporalAAEnabled
+        ? m_TemporalAA->NextJitter(m_RenderWidth, m_RenderHeight, m_Width, m_Height)
+        : glm::vec2(0.0f);
+    if (jitter != m_Camera->GetProjectionJitter()) {
+        m_Camera->SetProjectionJitter(jitter);
+    }
+
+    // Built once for the main camera, shared by every view
+    PrepareGeometry(registry);
+    UploadLightData();
+
+    const bool hasViews = std::any_of(m_Views.begin(), m_Views.end(), [](const Scope<View>& view) {
+        return view && view->Enabled && view->ViewCamera;
+    });
+    // The caller's upload went out before the jitter changed
+    if (hasViews || m_TemporalAAEnabled) {
+        m_MainCameraUniforms->Upload(*m_Camera);
+    }
+
+    RenderView(GetMainTargets());
+
+    if (m_ShadowSystem && m_ShadowSystem->IsVirtualShadowMapActive()) {
+        m_ShadowSystem->AnalyzeVisibleSurfaces(*m_GBuffer, m_Camera->GetViewProjectionMatrix());
+    }
+
+    if (hasViews) {
+        for (auto& view : m_Views) {
+            if (!view || !view->Enabled || !view->ViewCamera) continue;
+
+            view->CameraUniforms->Upload(*view->ViewCamera);
+            RenderView(GetViewTargets(*view));
+        }
+
+        // Whatever draws next (particles, overlays) is for the main camera
+        m_MainCameraUniforms->Bind();
+    }
+
+    // Draw calls add up over every view
+    const auto& batchStats = m_Batcher->GetStats();
+    m_Stats.EntitiesRendered = batchStats.Instances;
+    m_Stats.Batches = batchStats.Batches;
+    m_Stats.DrawCalls = batchStats.DrawCalls;
+    if (m_DepthPrepass) {
+        m_Stats.PrepassDrawCalls = m_DepthBatcher->GetStats().DrawCalls;
+    }
+    const auto& meshletStats = m_MeshletCuller->GetStats();
+    m_Stats.EntitiesRendered += meshletStats.Instances;
+    m_Stats.MeshletInstances = meshletStats.Instances;
+    m_Stats.MeshletsTested = meshletStats.Meshlets;
+    m_Stats.MeshletDrawCalls = meshletStats.DrawCalls;
+    m_Stats.ScatterInstances = m_Scatter->GetStats().Instances;
+    m_Stats.ScatterDrawCalls = m_Scatter->GetStats().DrawCalls;
+    m_Stats.ImpostorInstances = m_ImpostorBatcher->GetStats().Instances;
+    m_Stats.ImpostorDrawCalls = m_ImpostorBatcher->GetStats().DrawCalls;
+    m_Stats.TerrainNodes = m_Terrain->GetStats().Nodes;
+    m_Stats.TerrainDrawCalls = m_Terrain->GetStats().DrawCalls;
+    m_Stats.ForwardInstances = m_MaskedBatcher->GetStats().Instances + m_TransparentBatcher->GetStats().Instances;
+    m_Stats.ForwardDrawCalls = m_MaskedBatcher->GetStats().DrawCalls + m_TransparentBatcher->GetStats().DrawCalls;
+
+    s_EntitiesRendered.Set(m_Stats.EntitiesRendered);
+    s_GeometryDrawCalls.Set(m_Stats.DrawCalls + m_Stats.PrepassDrawCalls + m_Stats.MeshletDrawCalls +
+                            m_Stats.ScatterDrawCalls + m_Stats.ImpostorDrawCalls + m_Stats.TerrainDrawCalls +
+                            m_Stats.ForwardDrawCalls);
+    s_Triangles.Set(m_Stats.Triangles);
+    s_PointLights.Set(m_Stats.PointLightCount);
+    s_SpotLights.Set(m_Stats.SpotLightCount);
+
+    m_LightRing->EndFrame();
+}
+
+void DeferredLightingSystem::RenderView(const ViewTargets& view) {
+    const bool mainView = view.Geometry == m_GBuffer.get();
+
+    if (!m_MeshletCuller->IsEmpty()) {
+        GPU_PROFILE_SCOPE_STATS("Meshlet Culling");
+        // The pyramid is the main view's, from last frame
+        m_MeshletCuller->Cull(mainView && m_HiZEnabled ? m_HiZ.get() : nullptr);
+    }
+
+    if (!m_Scatter->IsEmpty()) {
+        GPU_PROFILE_SCOPE_STATS("Scatter Culling");
+        m_Scatter->Cull(view.RenderHeight);
+    }
+
+    if (!m_Terrain->IsEmpty() && view.ViewCamera) {
+        GPU_PROFILE_SCOPE_STATS("Terrain Selection");
+        m_Terrain->Select(*view.ViewCamera, view.RenderHeight);
+    }
+
+    // The main view's pyramid and AO only need the G-Buffer's size to be
+    // recorded: workers record them while the geometry is drawn here, and
+    // they are submitted once the depth is written, before the lighting
+    // pass reads the AO
+    const bool ambientOcclusion = mainView && m_AmbientOcclusion->GetSettings().Enabled;
+    const bool hiz = mainView && (m_HiZEnabled || ambientOcclusion);
+    JobCounter recorded;
+    if (hiz) {
+        m_HiZ->Prepare(*m_GBuffer, m_Camera->GetViewProjectionMatrix());
+        JobSystem::Submit([this] {
+            m_HiZCommands.Reset();
+            m_HiZ->Record(m_HiZCommands, *m_GBuffer);
+        }, &recorded);
+    }
+    if (ambientOcclusion) {
+        m_AmbientOcclusion->Prepare(*m_GBuffer);
+        JobSystem::Submit([this] {
+            m_OcclusionCommands.Reset();
+            m_AmbientOcclusion->Record(m_OcclusionCommands, *m_GBuffer, *m_HiZ);
+        }, &recorded);
+    }
+
+    if (m_DepthPrepass) {
+        GPU_PROFILE_SCOPE_STATS("Depth Prepass");
+        DepthPrepass(view);
+    }
+
+    {
+        GPU_PROFILE_SCOPE_STATS("Geometry");
+        GeometryPass(view);
+    }
 
-    GeometryPass(registry);
+    JobSystem::Wait(recorded);
+    if (hiz) {
+        GPU_PROFILE_SCOPE_STATS("Hi-Z");
+        m_Device->Submit(m_HiZCommands);
+    }
 
-    LightingPass(registry);
+    if (ambientOcclusion) {
+        GPU_PROFILE_SCOPE_STATS("Ambient Occlusion");
+        m_Device->Submit(m_OcclusionCommands);
+    }
+
+    // Point / spot lights binned into clusters: the clustered lighting pass
+    // shades from them, the fog lights its froxels with them and the
+    // forward pass uses them in either mode
+    const bool volumetricFog = mainView && m_VolumetricFog->GetSettings().Enabled;
+    const bool forward = !m_MaskedItems.empty() || !m_TransparentItems.empty();
+    if (m_LightingMode == LightingMode::Clustered || volumetricFog || forward) {
+        GPU_PROFILE_SCOPE_STATS("Light Clusters");
+        m_ClusterCuller->Cull(*view.ViewCamera, view.RenderWidth, view.RenderHeight,
+                              m_Stats.PointLightCount, m_Stats.SpotLightCount);
+    }
+
+    if (volumetricFog) {
+        GPU_PROFILE_SCOPE_STATS("Volumetric Fog");
+        m_VolumetricFog->Compute([this](Shader& shader) {
+            shader.SetFloat4("u_AmbientLight", m_AmbientLight);
+            shader.SetInt("u_DirectionalLightCount", static_cast<i32>(m_Stats.DirectionalLightCount));
+            shader.SetInt("u_Shadows", m_ShadowSystem && m_ShadowSystem->GetSettings().Enabled ? 1 : 0);
+            BindShadowInputs(shader, 0);
+            m_ClusterCuller->Bind(shader);
+        });
+    }
+
+    {
+        GPU_PROFILE_SCOPE_STATS("Lighting");
+        LightingPass(view);
+    }
+
+    if (forward) {
+        GPU_PROFILE_SCOPE_STATS("Forward");
+        ForwardPass(view);
+    }
 }
 
 void DeferredLightingSystem::OnReload() {
     LoadShaders();
+    if (m_ClusterCuller) {
+        m_ClusterCuller->Reload();
+    }
+    if (m_HiZ) {
+        m_HiZ->Reload();
+    }
+    if (m_AmbientOcclusion) {
+        m_AmbientOcclusion->Reload();
+    }
+    if (m_VolumetricFog) {
+        m_VolumetricFog->Reload();
+    }
+    if (m_MeshletCuller) {
+        m_MeshletCuller->Reload();
+    }
+    if (m_Scatter) {
+        m_Scatter->Reload();
+    }
+    if (m_Terrain) {
+        m_Terrain->Reload();
+    }
+    if (m_Transparency) {
+        m_Transparency->Reload();
+    }
+    ImpostorLibrary::Instance().Reload();
+    if (m_TemporalAA) {
+        m_TemporalAA->Reload();
+    }
+}
+
+void DeferredLightingSystem::SetTemporalAA(bool enabled) {
+    if (enabled && !m_TemporalAAEnabled && m_TemporalAA) {
+        m_TemporalAA->Reset();
+    }
+    m_TemporalAAEnabled = enabled;
+}
+
+DeferredLightingSystem::SceneColor DeferredLightingSystem::ResolveSceneColor() {
+    if (!m_Initialized || !m_TemporalAAEnabled) {
+        return {m_LightingBuffer.get(), GetRenderUVScale()};
+    }
+
+    GPU_PROFILE_SCOPE("TAA Resolve");
+    const Framebuffer& resolved = m_TemporalAA->Resolve(*m_LightingBuffer, GetRenderUVScale(), *m_GBuffer,
+                                                        m_Width, m_Height);
+    return {&resolved, glm::vec2(1.0f)};
 }
 
 void DeferredLightingSystem::Resize(u32 width, u32 height) {
@@ -75,13 +592,156 @@ void DeferredLightingSystem::Resize(u32 width, u32 height) {
     m_Height = height;
 
     if (m_GBuffer) {
-        m_GBuffer->Resize(width, height);
+        m_GBuffer->Fit(width, height);
+    }
+    if (m_LightingBuffer) {
+        m_LightingBuffer->Fit(width, height);
+    }
+    ApplyRenderScale(m_RenderScale);
+    m_FramesToSettle = ResizeSettleFrames;
+}
+
+void DeferredLightingSystem::ShrinkToOutputSize() {
+    if (m_GBuffer) {
+        m_GBuffer->Fit(m_Width, m_Height, true);
     }
     if (m_LightingBuffer) {
-        m_LightingBuffer->Resize(width, height);
+        m_LightingBuffer->Fit(m_Width, m_Height, true);
+    }
+    for (auto& view : m_Views) {
+        if (view) {
+            view->Geometry->Fit(view->Width, view->Height, true);
+            view->Lighting->Fit(view->Width, view->Height, true);
+        }
+    }
+    ApplyRenderScale(m_RenderScale);
+}
+
+void DeferredLightingSystem::UpdateRenderScale() {
+    f32 scale = m_FixedRenderScale;
+    if (m_DynamicResolution.GetSettings().Enabled) {
+        // Timings are a few frames old; the controller allows for that
+        scale = m_DynamicResolution.Update(GPUProfiler::GetTotalTimeMs());
+    }
+    if (scale != m_RenderScale) {
+        ApplyRenderScale(scale);
+    }
+}
+
+void DeferredLightingSystem::ApplyRenderScale(f32 scale) {
+    m_RenderScale = std::clamp(scale, 0.1f, 1.0f);
+    m_RenderWidth = std::max(1u, static_cast<u32>(std::lround(static_cast<f32>(m_Width) * m_RenderScale)));
+    m_RenderHeight = std::max(1u, static_cast<u32>(std::lround(static_cast<f32>(m_Height) * m_RenderScale)));
+
+    if (m_GBuffer) {
+        m_GBuffer->SetViewport(m_RenderWidth, m_RenderHeight);
+    }
+    if (m_LightingBuffer) {
+        m_LightingBuffer->SetViewport(m_RenderWidth, m_RenderHeight);
+    }
+    for (auto& view : m_Views) {
+        if (view) {
+            ApplyViewRenderScale(*view);
+        }
+    }
+}
+
+void DeferredLightingSystem::ApplyViewRenderScale(View& view) {
+    view.RenderWidth = std::max(1u, static_cast<u32>(std::lround(static_cast<f32>(view.Width) * m_RenderScale)));
+    view.RenderHeight = std::max(1u, static_cast<u32>(std::lround(static_cast<f32>(view.Height) * m_RenderScale)));
+    view.Geometry->SetViewport(view.RenderWidth, view.RenderHeight);
+    view.Lighting->SetViewport(view.RenderWidth, view.RenderHeight);
+}
+
+void DeferredLightingSystem::SetGBufferLayout(GBufferLayout layout) {
+    m_GBuffer->SetLayout(layout);
+    for (auto& view : m_Views) {
+        if (view) {
+            view->Geometry->SetLayout(layout);
+        }
     }
 }
 
+DeferredLightingSystem::ViewHandle DeferredLightingSystem::AddView(const Camera* camera, u32 width, u32 height) {
+    auto view = CreateScope<View>();
+    view->ViewCamera = camera;
+    view->Width = std::max(width, 1u);
+    view->Height = std::max(height, 1u);
+    view->Geometry = CreateScope<GBuffer>(view->Width, view->Height, m_GBuffer->GetLayout());
+    view->Lighting = CreateLightingBuffer(view->Width, view->Height);
+    view->CameraUniforms = CreateScope<CameraUniformBuffer>();
+    ApplyViewRenderScale(*view);
+
+    // Reuse a removed view's slot
+    for (u32 i = 0; i < static_cast<u32>(m_Views.size()); ++i) {
+        if (!m_Views[i]) {
+            m_Views[i] = std::move(view);
+            return i;
+        }
+    }
+    m_Views.push_back(std::move(view));
+    return static_cast<ViewHandle>(m_Views.size() - 1);
+}
+
+void DeferredLightingSystem::RemoveView(ViewHandle view) {
+    if (view < m_Views.size()) {
+        m_Views[view].reset();
+    }
+}
+
+void DeferredLightingSystem::SetViewCamera(ViewHandle view, const Camera* camera) {
+    if (View* target = FindView(view)) {
+        target->ViewCamera = camera;
+    }
+}
+
+void DeferredLightingSystem::SetViewEnabled(ViewHandle view, bool enabled) {
+    if (View* target = FindView(view)) {
+        target->Enabled = enabled;
+    }
+}
+
+void DeferredLightingSystem::ResizeView(ViewHandle view, u32 width, u32 height) {
+    View* target = FindView(view);
+    if (!target || width == 0 || height == 0) return;
+
+    target->Width = width;
+    target->Height = height;
+    target->Geometry->Fit(width, height);
+    target->Lighting->Fit(width, height);
+    ApplyViewRenderScale(*target);
+    m_FramesToSettle = ResizeSettleFrames;
+}
+
+Framebuffer* DeferredLightingSystem::GetViewLightingBuffer(ViewHandle view) {
+    View* target = FindView(view);
+    return target ? target->Lighting.get() : nullptr;
+}
+
+GBuffer* DeferredLightingSystem::GetViewGBuffer(ViewHandle view) {
+    View* target = FindView(view);
+    return target ? target->Geometry.get() : nullptr;
+}
+
+DeferredLightingSystem::View* DeferredLightingSystem::FindView(ViewHandle view) {
+    return view < m_Views.size() ? m_Views[view].get() : nullptr;
+}
+
+DeferredLightingSystem::ViewTargets DeferredLightingSystem::GetMainTargets() const {
+    return {m_Camera, m_GBuffer.get(), m_LightingBuffer.get(), m_RenderWidth, m_RenderHeight};
+}
+
+DeferredLightingSystem::ViewTargets DeferredLightingSystem::GetViewTargets(const View& view) const {
+    return {view.ViewCamera, view.Geometry.get(), view.Lighting.get(), view.RenderWidth, view.RenderHeight};
+}
+
+glm::vec2 DeferredLightingSystem::GetRenderUVScale() const {
+    if (m_LightingBuffer) {
+        return m_LightingBuffer->GetViewportUVScale();
+    }
+    return glm::vec2(1.0f);
+}
+
 u32 DeferredLightingSystem::GetLightingTextureID() const {
     if (m_LightingBuffer) {
         return m_LightingBuffer->GetColorAttachmentRendererID(0);
@@ -89,118 +749,425 @@ u32 DeferredLightingSystem::GetLightingTextureID() const {
     return 0;
 }
 
-void DeferredLightingSystem::GeometryPass(entt::registry& registry) {
-    m_GBuffer->Bind();
-    m_GBuffer->Clear();
+void DeferredLightingSystem::PrepareGeometry(entt::registry& registry) {
+    GatherDrawItems(registry);
+
+    // Materials come from one SSBO indexed per instance, so textured
+    // materials still draw in a single multi-draw per vertex array
+    MaterialLibrary& materials = MaterialLibrary::Instance();
+    m_Stats.Triangles = 0;
+    for (const auto& item : m_DrawItems) {
+        m_Stats.Triangles += item.IndexCount / 3;
+        if (item.Instance.MaterialIndex != MaterialLibrary::DefaultMaterial) {
+            materials.ReportScreenSize(item.Instance.MaterialIndex, item.ScreenSize);
+        }
+    }
+    materials.Update();
+
+    // Masked and transparent materials are shaded forward after lighting,
+    // drawn whole. Impostors were baked opaque and stay deferred.
+    m_MaskedItems.clear();
+    m_TransparentItems.clear();
+    auto forward = std::stable_partition(m_DrawItems.begin(), m_DrawItems.end(), [&materials](const auto& item) {
+        return item.Impostor || BlendOf(materials, item) == MaterialBlend::Opaque;
+    });
+    for (auto it = forward; it != m_DrawItems.end(); ++it) {
+        it->ClusterMesh = nullptr;
+        auto& items = BlendOf(materials, *it) == MaterialBlend::Masked ? m_MaskedItems : m_TransparentItems;
+        items.push_back(*it);
+    }
+    m_DrawItems.erase(forward, m_DrawItems.end());
+    m_MaskedBatcher->Prepare(m_MaskedItems);
+    m_TransparentBatcher->Prepare(m_TransparentItems);
+
+    // Clustered items leave the batcher's list
+    m_MeshletItems.clear();
+    auto clustered = std::stable_partition(m_DrawItems.begin(), m_DrawItems.end(),
+                                           [](const auto& item) { return item.ClusterMesh == nullptr; });
+    m_MeshletItems.assign(clustered, m_DrawItems.end());
+    m_DrawItems.erase(clustered, m_DrawItems.end());
+    m_MeshletCuller->Prepare(m_MeshletItems);
+
+    // So do impostors, which only the G-Buffer fill draws
+    m_ImpostorItems.clear();
+    auto impostors = std::stable_partition(m_DrawItems.begin(), m_DrawItems.end(),
+                                           [](const auto& item) { return !item.Impostor; });
+    m_ImpostorItems.assign(impostors, m_DrawItems.end());
+    m_DrawItems.erase(impostors, m_DrawItems.end());
+    m_ImpostorBatcher->Prepare(m_ImpostorItems);
+    m_Scatter->BeginFrame();
+    m_Terrain->BeginFrame();
+
+    m_Batcher->Prepare(m_DrawItems);
+
+    if (m_DepthPrepass) {
+        // Same instances, so the transforms (dequantization included) match;
+        // only the vertex array changes. Meshes without a depth stream draw
+        // their full one.
+        m_DepthDrawItems.assign(m_DrawItems.begin(), m_DrawItems.end());
+        for (auto& item : m_DepthDrawItems) {
+            if (item.DepthVAO) {
+                item.VAO = item.DepthVAO;
+            }
+        }
+        m_DepthBatcher->Prepare(m_DepthDrawItems);
+    }
+}
+
+void DeferredLightingSystem::DepthPrepass(const ViewTargets& view) {
+    view.Geometry->Bind();
+    view.Geometry->Clear();
 
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
+    GLStateCache::Instance().Apply(RenderState{});
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
 
-    m_GeometryShader->Bind();
+    m_DepthPrepassShader->Bind();
+    m_DepthBatcher->Draw();
+    m_MeshletCuller->Draw(true);
+    m_Scatter->Draw(true);
+    m_Terrain->Draw(true, false);
+
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
 
-    glm::mat4 viewProj = m_Camera->GetViewProjectionMatrix();
-    m_GeometryShader->SetMat4("u_ViewProjection", viewProj);
-    m_GeometryShader->SetFloat("u_NearPlane", 0.1f);
-    m_GeometryShader->SetFloat("u_FarPlane", 1000.0f);
+void DeferredLightingSystem::GeometryPass(const ViewTargets& view) {
+    auto& state = GLStateCache::Instance();
+    view.Geometry->Bind();
+
+    RenderState geometryState;
+    if (m_DepthPrepass) {
+        // Only the surface the prepass kept passes; both vertex shaders
+        // declare gl_Position invariant, so its depth matches exactly
+        geometryState.DepthFunc = GL_EQUAL;
+        geometryState.DepthWrite = false;
+    } else {
+        view.Geometry->Clear();
+    }
+    state.Apply(geometryState);
 
-    auto view = registry.view<Transform, MeshComponent, MaterialComponent, Renderable>();
-    for (auto entity : view) {
-        auto& transform = view.get<Transform>(entity);
-        auto& mesh = view.get<MeshComponent>(entity);
-        auto& material = view.get<MaterialComponent>(entity);
-        auto& renderable = view.get<Renderable>(entity);
+    const bool countOverdraw = m_Overdraw->IsEnabled() && view.Geometry == m_GBuffer.get();
+    if (countOverdraw && !m_OverdrawShader) {
+        ShaderDefines defines = MaterialLibrary::Instance().GetShaderDefines();
+        defines.push_back({"OVERDRAW", ""});
+        m_OverdrawShader = CreateRef<Shader>("assets/shaders/deferred/geometry.glsl", "", defines);
+    }
+    Shader& shader = countOverdraw ? *m_OverdrawShader : *m_GeometryShader;
+    if (countOverdraw) {
+        m_Overdraw->Begin(*view.Geometry);
+    }
 
-        if (!renderable.Visible || !renderable.InFrustum) continue;
-        if (!mesh.VAO) continue;
+    shader.Bind();
 
-        glm::mat4 model = transform.WorldMatrix;
-        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+    shader.SetInt("u_CompactGBuffer", view.Geometry->IsCompact() ? 1 : 0);
 
-        m_GeometryShader->SetMat4("u_Model", model);
-        m_GeometryShader->SetMat3("u_NormalMatrix", normalMatrix);
+    MaterialLibrary::Instance().Bind();
+    m_Batcher->Draw();
+    m_MeshletCuller->Draw(false);
+    m_Scatter->Draw(false);
+    m_Terrain->Draw(false, view.Geometry->IsCompact());
 
-        m_GeometryShader->SetFloat4("u_AlbedoColor", material.BaseColor);
-        m_GeometryShader->SetFloat("u_Metallic", material.Metallic);
-        m_GeometryShader->SetFloat("u_Roughness", material.Roughness);
-        m_GeometryShader->SetFloat("u_AO", 1.0f);
-        m_GeometryShader->SetFloat3("u_EmissiveColor", glm::vec3(0.0f));
-        m_GeometryShader->SetFloat("u_EmissiveIntensity", 0.0f);
-        m_GeometryShader->SetFloat("u_NormalStrength", 1.0f);
-        m_GeometryShader->SetFloat2("u_TilingFactor", glm::vec2(1.0f));
-        m_GeometryShader->SetInt("u_TextureFlags", 0);
+    if (!m_ImpostorItems.empty()) {
+        // Depth comes from the atlas, so impostors test and write it here
+        // rather than in the prepass
+        state.SetDepthFunc(GL_LESS);
+        state.SetDepthWrite(true);
 
-        mesh.VAO->Bind();
-        glDrawElements(GL_TRIANGLES, mesh.IndexCount, GL_UNSIGNED_INT, nullptr);
+        ImpostorLibrary& impostors = ImpostorLibrary::Instance();
+        m_ImpostorShader->Bind();
+        m_ImpostorShader->SetInt("u_CompactGBuffer", view.Geometry->IsCompact() ? 1 : 0);
+        m_ImpostorShader->SetInt("u_FramesPerSide", static_cast<i32>(impostors.GetSettings().FramesPerSide));
+        impostors.Bind();
+        m_ImpostorBatcher->Draw();
+    }
 
-        m_Stats.EntitiesRendered++;
+    if (countOverdraw) {
+        m_Overdraw->End();
     }
 
-    m_GBuffer->Unbind();
+    state.SetDepthWrite(true);
+    state.SetDepthFunc(GL_LESS);
+
+    view.Geometry->Unbind();
 }
 
-void DeferredLightingSystem::LightingPass(entt::registry& registry) {
-    (void)registry;
+void DeferredLightingSystem::GatherDrawItems(entt::registry& registry) {
+    m_DrawItems.clear();
+
+    const ResourceManager& resources = ResourceManager::Instance();
+    const MaterialLibrary& materials = MaterialLibrary::Instance();
+    const glm::vec3 cameraPos = m_Camera->GetPosition();
+    const f32 pixelsPerUnit = m_Camera->GetProjectionMatrix()[1][1] * 0.5f * static_cast<f32>(m_RenderHeight);
+
+    const bool meshletCulling = m_MeshletCulling;
+
+    const ImpostorLibrary& impostors = ImpostorLibrary::Instance();
+
+    auto gather = [&resources, &materials, &impostors, cameraPos, pixelsPerUnit, meshletCulling](FrameVector<IndirectDrawBatcher::DrawItem>& out,
+                     entt::entity entity, const glm::mat4& world, const glm::mat4& previousWorld,
+                     const MeshComponent& meshComponent, const MaterialComponent& material,
+                     const Renderable& renderable) {
+        if (!renderable.Visible || !renderable.InFrustum) return;
+        const Mesh* mesh = resources.GetMesh(meshComponent.Mesh);
+        if (!mesh) return;
+        resources.RequestMesh(*mesh);   // Streams it back in when evicted
+        if (!mesh->IsUploaded()) return;
+
+        IndirectDrawBatcher::DrawItem item;
+        item.VAO = mesh->GetVertexArray().get();
+        item.DepthVAO = mesh->GetDepthPassVertexArray();
+        // LODSelectionSystem's level; each level is its own index range
+        const MeshLOD lod = mesh->GetLOD(renderable.LODLevel);
+        item.IndexCount = lod.IndexCount;
+        item.BaseVertex = mesh->GetBaseVertex();
+        item.BaseIndex = mesh->GetBaseIndex() + lod.IndexOffset;
+        item.MeshId = meshComponent.MeshId;
+        item.MaterialId = material.MaterialId;
+        item.Instance.Transform = mesh->GetDrawTransform(world);
+        item.PreviousTransform = previousWorld == world ? item.Instance.Transform
+                                                        : mesh->GetDrawTransform(previousWorld);
+        item.Instance.Color = material.BaseColor;
+        item.Instance.MaterialParams = glm::vec4(material.Metallic, material.Roughness, 1.0f, 1.0f);
+        item.Instance.EntityId = static_cast<u32>(entity);
+        item.Instance.MaterialIndex = materials.Contains(material.MaterialId)
+            ? material.MaterialId : MaterialLibrary::DefaultMaterial;
+
+        const f32 radius = renderable.WorldSphere.Radius;
+        const f32 distance = std::max(glm::length(renderable.WorldSphere.Center - cameraPos) - radius, 0.1f);
+        item.ScreenSize = 2.0f * radius * pixelsPerUnit / distance;
+
+        // One quad at the sphere's center, placed by impostor.glsl from the
+        // undequantized matrices
+        const u32 impostor = renderable.LODLevel == Renderable::ImpostorLevel ? impostors.Find(mesh)
+                                                                              : ImpostorLibrary::NoImpostor;
+        if (impostor != ImpostorLibrary::NoImpostor) {
+            item.VAO = impostors.GetQuadVertexArray();
+            item.DepthVAO = nullptr;
+            item.IndexCount = 6;
+            item.BaseVertex = 0;
+            item.BaseIndex = 0;
+            item.Instance.Transform = world;
+            item.PreviousTransform = previousWorld;
+            item.Instance.Flags = impostor;
+            item.Impostor = true;
+        }
+
+        // Meshlets cover LOD 0 only; coarser levels are cheap enough whole
+        if (meshletCulling && renderable.LODLevel == 0 && !mesh->GetMeshlets().empty()) {
+            item.ClusterMesh = mesh;
+        }
+        out.push_back(item);
+    };
 
-    UploadLightData();
+    // Entities TransformSystem doesn't resolve have no previous matrix and
+    // only move with the camera
+    const auto& previous = registry.storage<PreviousWorldTransform>();
+    auto previousOf = [&previous](entt::entity entity, const glm::mat4& world) -> const glm::mat4& {
+        return previous.contains(entity) ? previous.get(entity).Matrix : world;
+    };
+
+    // Mesh, Renderable and Transform stream from the group; only the
+    // material is looked up
+    const auto& materialComponents = registry.storage<MaterialComponent>();
+    ParallelGather(RenderableGroup(registry), m_DrawItems,
+        [&](auto& out, entt::entity entity, const MeshComponent& mesh, const Renderable& renderable,
+            const Transform& transform) {
+            if (!materialComponents.contains(entity)) return;
+            gather(out, entity, transform.WorldMatrix, previousOf(entity, transform.WorldMatrix),
+                   mesh, materialComponents.get(entity), renderable);
+        });
+
+    ParallelGather<WorldTransform, MeshComponent, MaterialComponent, Renderable>(registry, m_DrawItems,
+        [&](auto& out, entt::entity entity, const WorldTransform& world, const MeshComponent& mesh,
+            const MaterialComponent& material, const Renderable& renderable) {
+            gather(out, entity, world.Matrix, previousOf(entity, world.Matrix), mesh, material, renderable);
+        });
+}
 
-    m_LightingBuffer->Bind();
+void DeferredLightingSystem::LightingPass(const ViewTargets& view) {
+    auto& state = GLStateCache::Instance();
+    if (m_LightingMode == LightingMode::TiledCompute) {
+        TiledLightingPass(view);
+        return;
+    }
+
+    view.Lighting->Bind();
     // Light gray background for editor
-    m_LightingBuffer->Clear(glm::vec4(0.15f, 0.15f, 0.17f, 1.0f), 1.0f);
+    view.Lighting->Clear(glm::vec4(0.15f, 0.15f, 0.17f, 1.0f), 1.0f);
 
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_CULL_FACE);
+    RenderState screenState;
+    screenState.DepthTest = false;
+    screenState.CullFace = false;
+    state.Apply(screenState);
 
-    m_LightingShader->Bind();
+    Shader& lightingShader = *m_LightingShaders->Get(LightingVariantKey());
+    lightingShader.Bind();
+    BindLightingInputs(lightingShader, view);
+    m_ClusterCuller->Bind(lightingShader);
 
-    m_GBuffer->BindTextures(0);
-    m_LightingShader->SetInt("u_GPosition", 0);
-    m_LightingShader->SetInt("u_GNormal", 1);
-    m_LightingShader->SetInt("u_GAlbedo", 2);
-    m_LightingShader->SetInt("u_GEmission", 3);
+    m_ScreenQuadVAO->Bind();
+    PipelineWarmup::RecordDraw(GL_TRIANGLES);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
 
-    m_LightingShader->SetFloat3("u_CameraPos", m_Camera->GetPosition());
-    m_LightingShader->SetFloat4("u_AmbientLight", m_AmbientLight);
+    view.Lighting->Unbind();
 
-    m_LightingShader->SetInt("u_DirectionalLightCount", static_cast<i32>(m_Stats.DirectionalLightCount));
-    m_LightingShader->SetInt("u_PointLightCount", static_cast<i32>(m_Stats.PointLightCount));
-    m_LightingShader->SetInt("u_SpotLightCount", static_cast<i32>(m_Stats.SpotLightCount));
+    state.SetDepthTest(true);
+}
 
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_DirectionalLightUBO);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 1, m_PointLightUBO);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 2, m_SpotLightUBO);
+void DeferredLightingSystem::TiledLightingPass(const ViewTargets& view) {
+    // Every pixel is overwritten by the compute pass; clearing still resets
+    // the lighting buffer's depth for the passes drawn on top of it
+    view.Lighting->Bind();
+    view.Lighting->Clear(glm::vec4(0.15f, 0.15f, 0.17f, 1.0f), 1.0f);
+    view.Lighting->Unbind();
 
-    // Bind shadow maps and data
-    bool shadowsEnabled = false;
-    if (m_ShadowSystem && m_ShadowSystem->GetSettings().Enabled) {
-        shadowsEnabled = true;
+    Shader& tiledShader = *m_TiledLightingShaders->Get(LightingVariantKey());
+    tiledShader.Bind();
+    BindLightingInputs(tiledShader, view);
 
-        // Bind CSM shadow map texture (slot 4)
-        m_ShadowSystem->BindCSMTexture(4);
-        m_LightingShader->SetInt("u_CSMShadowMap", 4);
+    tiledShader.SetFloat2("u_ScreenSize", glm::vec2(static_cast<f32>(view.RenderWidth), static_cast<f32>(view.RenderHeight)));
+    tiledShader.SetUInt("u_PointLightCount", m_Stats.PointLightCount);
+    tiledShader.SetUInt("u_SpotLightCount", m_Stats.SpotLightCount);
 
-        // Bind spot shadow atlas texture (slot 5)
-        m_ShadowSystem->BindSpotAtlasTexture(5);
-        m_LightingShader->SetInt("u_SpotShadowAtlas", 5);
+    glBindImageTexture(0, view.Lighting->GetColorAttachmentRendererID(0), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
 
-        // Bind shadow UBO (binding = 3)
-        glBindBufferBase(GL_UNIFORM_BUFFER, 3, m_ShadowSystem->GetShadowDataUBO());
+    glDispatchCompute((view.RenderWidth + TileSize - 1) / TileSize, (view.RenderHeight + TileSize - 1) / TileSize, 1);
+
+    // Later passes sample or render into the lighting buffer
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT |
+                    GL_FRAMEBUFFER_BARRIER_BIT);
+}
+
+void DeferredLightingSystem::ForwardPass(const ViewTargets& view) {
+    auto& state = GLStateCache::Instance();
+
+    // Scene depth to test against; it also stays for whatever draws into
+    // the lighting buffer next
+    const GLint width = static_cast<GLint>(view.RenderWidth);
+    const GLint height = static_cast<GLint>(view.RenderHeight);
+    glBlitNamedFramebuffer(view.Geometry->GetFramebuffer().GetRendererID(), view.Lighting->GetRendererID(),
+                           0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+    MaterialLibrary::Instance().Bind();
+
+    auto bindShader = [this](bool transparent) {
+        Shader& shader = *m_ForwardShaders->Get(ForwardVariantKey(transparent));
+        shader.Bind();
+        shader.SetFloat4("u_AmbientLight", m_AmbientLight);
+        shader.SetInt("u_DirectionalLightCount", static_cast<i32>(m_Stats.DirectionalLightCount));
+        BindShadowInputs(shader, ForwardShadowUnit);
+        m_ClusterCuller->Bind(shader);
+    };
+
+    if (!m_MaskedItems.empty()) {
+        view.Lighting->Bind();
+        state.Apply(RenderState{});
+
+        bindShader(false);
+        m_MaskedBatcher->Draw();
+
+        view.Lighting->Unbind();
     }
-    m_LightingShader->SetInt("u_ShadowsEnabled", shadowsEnabled ? 1 : 0);
 
-    m_ScreenQuadVAO->Bind();
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+    if (!m_TransparentItems.empty()) {
+        // Both faces of a transparent surface show
+        m_Transparency->Begin(*view.Lighting);
+        state.SetCullFace(false);
+
+        bindShader(true);
+        m_TransparentBatcher->Draw();
 
-    m_LightingBuffer->Unbind();
+        m_Transparency->End();
+        m_Transparency->Composite(*view.Lighting);
+    }
+}
+
+void DeferredLightingSystem::BindLightingInputs(Shader& shader, const ViewTargets& view) {
+    view.Geometry->BindTextures(0);
+    shader.SetInt("u_GPosition", 0);
+    shader.SetInt("u_GNormal", 1);
+    shader.SetInt("u_GAlbedo", 2);
+    shader.SetInt("u_GEmission", 3);
+    shader.SetInt("u_CompactGBuffer", view.Geometry->IsCompact() ? 1 : 0);
+    shader.SetFloat2("u_UVScale", view.Lighting->GetViewportUVScale());
+    shader.SetFloat4("u_AmbientLight", m_AmbientLight);
+
+    shader.SetInt("u_DirectionalLightCount", static_cast<i32>(m_Stats.DirectionalLightCount));
+
+    // Shadow maps at 4..11, after the G-Buffer
+    BindShadowInputs(shader, 4);
+
+    // AO at 12; only the main view computes it
+    const bool ambientOcclusion = view.Geometry == m_GBuffer.get() &&
+                                  m_AmbientOcclusion->GetSettings().Enabled && m_AmbientOcclusion->IsValid();
+    if (ambientOcclusion) {
+        GLStateCache::Instance().BindTextureUnit(12, m_AmbientOcclusion->GetTextureID());
+    }
+    shader.SetInt("u_AmbientOcclusion", 12);
+    shader.SetInt("u_HasAmbientOcclusion", ambientOcclusion ? 1 : 0);
+
+    // Fog volume at 13; also only the main view's
+    const bool volumetricFog = view.Geometry == m_GBuffer.get() &&
+                               m_VolumetricFog->GetSettings().Enabled && m_VolumetricFog->IsValid();
+    if (volumetricFog) {
+        m_VolumetricFog->Bind(shader, 13);
+    }
+    shader.SetInt("u_VolumetricFog", 13);
+    shader.SetInt("u_HasVolumetricFog", volumetricFog ? 1 : 0);
+}
+
+void DeferredLightingSystem::BindShadowInputs(Shader& shader, u32 firstUnit) {
+    // Bind shadow maps and data; the variant decides whether they're read
+    if (!m_ShadowSystem || !m_ShadowSystem->GetSettings().Enabled) return;
+
+    m_ShadowSystem->BindCSMTexture(firstUnit);
+    shader.SetInt("u_CSMShadowMap", static_cast<i32>(firstUnit));
+
+    m_ShadowSystem->BindSpotAtlasTexture(firstUnit + 1);
+    shader.SetInt("u_SpotShadowAtlas", static_cast<i32>(firstUnit + 1));
+
+    m_ShadowSystem->BindPointAtlasTexture(firstUnit + 2);
+    shader.SetInt("u_PointShadowAtlas", static_cast<i32>(firstUnit + 2));
+
+    // The virtual shadow map and its page table
+    if (m_ShadowSystem->IsVirtualShadowMapActive()) {
+        m_ShadowSystem->BindVirtualShadowTextures(firstUnit + 3, firstUnit + 4);
+        shader.SetInt("u_VSMShadowMap", static_cast<i32>(firstUnit + 3));
+        shader.SetInt("u_VSMPageTable", static_cast<i32>(firstUnit + 4));
+    }
+
+    // The prefiltered moment maps
+    if (m_ShadowSystem->IsMomentFilteringActive()) {
+        m_ShadowSystem->BindMomentTextures(firstUnit + 5, firstUnit + 6, firstUnit + 7);
+        shader.SetInt("u_CSMMoments", static_cast<i32>(firstUnit + 5));
+        shader.SetInt("u_SpotMoments", static_cast<i32>(firstUnit + 6));
+        shader.SetInt("u_PointMoments", static_cast<i32>(firstUnit + 7));
+    }
+
+    // Bind shadow UBO (binding = 3)
+    m_ShadowSystem->BindShadowData(3);
+}
+
+ShaderVariantKey DeferredLightingSystem::LightingVariantKey() const {
+    ShaderVariantKey key = 0;
+    if (m_ShadowSystem && m_ShadowSystem->GetSettings().Enabled) {
+        key = m_LightingShaders->Select(key, LightingKeywordShadows, true);
+        key = m_LightingShaders->Select(key, LightingKeywordPCFSamples,
+                                        PCFSampleVariant(m_ShadowSystem->GetSettings().PCFSamples));
+        key = m_LightingShaders->Select(key, LightingKeywordVirtualShadows, m_ShadowSystem->IsVirtualShadowMapActive());
+        key = m_LightingShaders->Select(key, LightingKeywordEVSM, m_ShadowSystem->IsMomentFilteringActive());
+    }
+    return key;
+}
 
-    glEnable(GL_DEPTH_TEST);
+ShaderVariantKey DeferredLightingSystem::ForwardVariantKey(bool transparent) const {
+    ShaderVariantKey key = LightingVariantKey();
+    key = m_ForwardShaders->Select(key, ForwardKeywordOIT, transparent);
+    key = m_ForwardShaders->Select(key, ForwardKeywordBindless, MaterialLibrary::Instance().IsBindless());
+    return key;
 }
 
 void DeferredLightingSystem::GatherLights(entt::registry& registry) {
     m_DirectionalLights.clear();
-    m_PointLights.clear();
-    m_SpotLights.clear();
 
     auto ambientView = registry.view<AmbientLightComponent>();
     for (auto entity : ambientView) {
@@ -209,6 +1176,7 @@ void DeferredLightingSystem::GatherLights(entt::registry& registry) {
         break;
     }
 
+    // At most four, cheaper to rebuild than to track
     auto dirView = registry.view<DirectionalLightComponent>();
     for (auto entity : dirView) {
         if (m_DirectionalLights.size() >= MaxDirectionalLights) break;
@@ -223,67 +1191,198 @@ void DeferredLightingSystem::GatherLights(entt::registry& registry) {
         m_DirectionalLights.push_back(gpuLight);
     }
 
-    auto pointView = registry.view<Transform, PointLightComponent>();
-    for (auto entity : pointView) {
-        if (m_PointLights.size() >= MaxPointLights) break;
+    if (m_LightsStructureDirty) {
+        RebuildLights(registry);
+    } else {
+        PatchLights(registry);
+    }
 
-        auto& transform = pointView.get<Transform>(entity);
-        auto& light = pointView.get<PointLightComponent>(entity);
-        if (!light.Enabled) continue;
+    ApplyShadowSlots();
 
-        GPUPointLight gpuLight;
-        gpuLight.Position = glm::vec4(transform.GetWorldPosition(), light.Radius);
-        gpuLight.ColorIntensity = glm::vec4(light.Color, light.Intensity);
-        gpuLight.Attenuation = glm::vec4(light.Constant, light.Linear, light.Quadratic, 0.0f);
+    m_Stats.DirectionalLightCount = static_cast<u32>(m_DirectionalLights.size());
+    m_Stats.PointLightCount = static_cast<u32>(m_PointLights.size());
+    m_Stats.SpotLightCount = static_cast<u32>(m_SpotLights.size());
+}
 
-        m_PointLights.push_back(gpuLight);
+void DeferredLightingSystem::RebuildLights(entt::registry& registry) {
+    // Point and spot lights can number in the hundreds - gather them on the workers.
+    // The transform is generic so SoA entities only stream their WorldTransform.
+    auto gatherPoint = [](FrameVector<LightEntry<GPUPointLight>>& out, entt::entity entity, const auto& transform,
+                          const PointLightComponent& light) {
+        if (!light.Enabled) return;
+        out.push_back({entity, MakeGPUPointLight(transform.GetWorldPosition(), light)});
+    };
+    FrameVector<LightEntry<GPUPointLight>> pointEntries;
+    ParallelGather(PointLightGroup(registry), pointEntries,
+        [&gatherPoint](auto& out, entt::entity entity, const PointLightComponent& light, const Transform& transform) {
+            gatherPoint(out, entity, transform, light);
+        }, 128);
+    ParallelGather<WorldTransform, PointLightComponent>(registry, pointEntries, gatherPoint, 128);
+    SplitEntries(pointEntries, m_PointLights, m_PointLightEntities, m_PointLightSlots);
+
+    auto gatherSpot = [](FrameVector<LightEntry<GPUSpotLight>>& out, entt::entity entity, const auto& transform,
+                         const SpotLightComponent& light) {
+        if (!light.Enabled) return;
+        out.push_back({entity, MakeGPUSpotLight(transform.GetWorldPosition(), light)});
+    };
+    FrameVector<LightEntry<GPUSpotLight>> spotEntries;
+    ParallelGather(SpotLightGroup(registry), spotEntries,
+        [&gatherSpot](auto& out, entt::entity entity, const SpotLightComponent& light, const Transform& transform) {
+            gatherSpot(out, entity, transform, light);
+        }, 128);
+    ParallelGather<WorldTransform, SpotLightComponent>(registry, spotEntries, gatherSpot, 128);
+    SplitEntries(spotEntries, m_SpotLights, m_SpotLightEntities, m_SpotLightSlots);
+
+    m_UpdatedPointLights.clear();
+    m_UpdatedSpotLights.clear();
+    m_DirtyPointSlots.clear();
+    m_DirtySpotSlots.clear();
+    m_LightsStructureDirty = false;
+    m_FullLightUpload = true;
+}
+
+void DeferredLightingSystem::PatchLights(entt::registry& registry) {
+    // Patched / replaced components. Toggling Enabled adds or removes a slot,
+    // which needs the order-preserving rebuild.
+    bool rebuild = false;
+    for (auto entity : m_UpdatedPointLights) {
+        auto* light = registry.try_get<PointLightComponent>(entity);
+        auto slot = m_PointLightSlots.find(entity);
+        glm::vec3 position;
+        if (!light || !TryGetWorldPosition(registry, entity, position)) continue;
+
+        if (light->Enabled != (slot != m_PointLightSlots.end())) {
+            rebuild = true;
+            break;
+        }
+        if (slot == m_PointLightSlots.end()) continue;
+
+        m_PointLights[slot->second] = MakeGPUPointLight(position, *light);
+        m_DirtyPointSlots.push_back(slot->second);
     }
+    m_UpdatedPointLights.clear();
 
-    auto spotView = registry.view<Transform, SpotLightComponent>();
-    for (auto entity : spotView) {
-        if (m_SpotLights.size() >= MaxSpotLights) break;
+    for (auto entity : m_UpdatedSpotLights) {
+        if (rebuild) break;
 
-        auto& transform = spotView.get<Transform>(entity);
-        auto& light = spotView.get<SpotLightComponent>(entity);
-        if (!light.Enabled) continue;
+        auto* light = registry.try_get<SpotLightComponent>(entity);
+        auto slot = m_SpotLightSlots.find(entity);
+        glm::vec3 position;
+        if (!light || !TryGetWorldPosition(registry, entity, position)) continue;
 
-        GPUSpotLight gpuLight;
-        gpuLight.Position = glm::vec4(transform.GetWorldPosition(), light.Range);
-        gpuLight.Direction = glm::vec4(glm::normalize(light.Direction), 0.0f);
-        gpuLight.ColorIntensity = glm::vec4(light.Color, light.Intensity);
-        gpuLight.CutoffAttenuation = glm::vec4(
-            glm::cos(light.InnerCutOff),
-            glm::cos(light.OuterCutOff),
-            light.Linear,
-            light.Quadratic
-        );
+        if (light->Enabled != (slot != m_SpotLightSlots.end())) {
+            rebuild = true;
+            break;
+        }
+        if (slot == m_SpotLightSlots.end()) continue;
 
-        m_SpotLights.push_back(gpuLight);
+        m_SpotLights[slot->second] = MakeGPUSpotLight(position, *light);
+        m_DirtySpotSlots.push_back(slot->second);
     }
+    m_UpdatedSpotLights.clear();
 
-    m_Stats.DirectionalLightCount = static_cast<u32>(m_DirectionalLights.size());
-    m_Stats.PointLightCount = static_cast<u32>(m_PointLights.size());
-    m_Stats.SpotLightCount = static_cast<u32>(m_SpotLights.size());
-}
+    if (rebuild) {
+        RebuildLights(registry);
+        return;
+    }
 
-void DeferredLightingSystem::UploadLightData() {
-    if (!m_DirectionalLights.empty()) {
-        glNamedBufferSubData(m_DirectionalLightUBO, 0,
-                              m_DirectionalLights.size() * sizeof(GPUDirectionalLight),
-                              m_DirectionalLights.data());
+    // Moved lights: transforms don't signal, so compare against the last
+    // uploaded position (no allocation, no rebuild for static lights)
+    for (u32 i = 0; i < static_cast<u32>(m_PointLightEntities.size()); ++i) {
+        glm::vec3 position;
+        if (!TryGetWorldPosition(registry, m_PointLightEntities[i], position)) continue;
+
+        glm::vec4& cached = m_PointLights[i].Position;
+        if (position != glm::vec3(cached)) {
+            cached = glm::vec4(position, cached.w);
+            m_DirtyPointSlots.push_back(i);
+        }
     }
 
-    if (!m_PointLights.empty()) {
-        glNamedBufferSubData(m_PointLightUBO, 0,
-                              m_PointLights.size() * sizeof(GPUPointLight),
-                              m_PointLights.data());
+    for (u32 i = 0; i < static_cast<u32>(m_SpotLightEntities.size()); ++i) {
+        glm::vec3 position;
+        if (!TryGetWorldPosition(registry, m_SpotLightEntities[i], position)) continue;
+
+        glm::vec4& cached = m_SpotLights[i].Position;
+        if (position != glm::vec3(cached)) {
+            cached = glm::vec4(position, cached.w);
+            m_DirtySpotSlots.push_back(i);
+        }
     }
+}
+
+void DeferredLightingSystem::ApplyShadowSlots() {
+    // The shadow system ranks its lights every frame, so slots move around;
+    // only lights whose slot changed are re-uploaded
+    static const Vector<entt::entity> noShadows;
+    const bool shadowsEnabled = m_ShadowSystem && m_ShadowSystem->GetSettings().Enabled;
+
+    AssignShadowSlots(shadowsEnabled ? m_ShadowSystem->GetShadowedSpotLights() : noShadows,
+                      m_ShadowedSpotLights, m_SpotLights, m_SpotLightSlots, m_DirtySpotSlots,
+                      [](GPUSpotLight& light) -> f32& { return light.Direction.w; });
+    AssignShadowSlots(shadowsEnabled ? m_ShadowSystem->GetShadowedPointLights() : noShadows,
+                      m_ShadowedPointLights, m_PointLights, m_PointLightSlots, m_DirtyPointSlots,
+                      [](GPUPointLight& light) -> f32& { return light.Attenuation.w; });
+}
+
+void DeferredLightingSystem::ApplyLightBudget(f32 deltaTime) {
+    // Only slots whose fade moved are re-uploaded; a rebuild uploads everything
+    auto evaluate = [&](LightBudget& budget, const auto& lights, const Vector<entt::entity>& entities,
+                        u32 maxLights, Vector<f32>& applied, Vector<u32>& dirtySlots) {
+        m_BudgetLights.clear();
+        for (u32 i = 0; i < static_cast<u32>(lights.size()); ++i) {
+            m_BudgetLights.push_back(MakeBudgetLight(entities[i], lights[i]));
+        }
+        budget.Evaluate(*m_Camera, m_BudgetLights, m_LightBudgetSettings, maxLights, deltaTime, m_BudgetFades);
+
+        if (applied.size() != m_BudgetFades.size()) {
+            applied.assign(m_BudgetFades.size(), 1.0f);
+            m_FullLightUpload = true;
+        }
+        for (u32 i = 0; i < static_cast<u32>(m_BudgetFades.size()); ++i) {
+            if (applied[i] != m_BudgetFades[i]) {
+                applied[i] = m_BudgetFades[i];
+                dirtySlots.push_back(i);
+            }
+        }
+    };
+
+    evaluate(m_PointBudget, m_PointLights, m_PointLightEntities, m_LightBudgetSettings.MaxPointLights,
+             m_PointLightFades, m_DirtyPointSlots);
+    evaluate(m_SpotBudget, m_SpotLights, m_SpotLightEntities, m_LightBudgetSettings.MaxSpotLights,
+             m_SpotLightFades, m_DirtySpotSlots);
 
-    if (!m_SpotLights.empty()) {
-        glNamedBufferSubData(m_SpotLightUBO, 0,
-                              m_SpotLights.size() * sizeof(GPUSpotLight),
-                              m_SpotLights.data());
+    m_Stats.LightsCulled = m_PointBudget.GetCulledCount() + m_SpotBudget.GetCulledCount();
+    m_Stats.LightsFading = m_PointBudget.GetFadingCount() + m_SpotBudget.GetFadingCount();
+}
+
+void DeferredLightingSystem::UploadLightData() {
+    m_LightRing->BeginFrame();
+
+    // The UBO block is always MaxDirectionalLights entries; only the first
+    // u_DirectionalLightCount are read
+    auto directional = m_LightRing->Allocate(MaxDirectionalLights * sizeof(GPUDirectionalLight));
+    if (directional && !m_DirectionalLights.empty()) {
+        std::memcpy(directional.Data, m_DirectionalLights.data(),
+                    m_DirectionalLights.size() * sizeof(GPUDirectionalLight));
     }
+    GPURingBuffer::BindRange(GL_UNIFORM_BUFFER, 0, directional);
+
+    // Point / spot lights live in persistent SSBOs; only changed slots are copied in
+    const u32 pointCount = static_cast<u32>(m_PointLights.size());
+    const u32 spotCount = static_cast<u32>(m_SpotLights.size());
+    bool fullPoint = EnsureLightCapacity(m_PointLightSSBO, m_PointLightCapacity, pointCount, sizeof(GPUPointLight));
+    bool fullSpot = EnsureLightCapacity(m_SpotLightSSBO, m_SpotLightCapacity, spotCount, sizeof(GPUSpotLight));
+
+    m_Stats.LightsUploaded =
+        UploadLightSlots(*m_LightRing, m_PointLightSSBO, m_PointLights, m_PointLightFades, m_DirtyPointSlots,
+                         m_FullLightUpload || fullPoint) +
+        UploadLightSlots(*m_LightRing, m_SpotLightSSBO, m_SpotLights, m_SpotLightFades, m_DirtySpotSlots,
+                         m_FullLightUpload || fullSpot);
+    m_FullLightUpload = false;
+
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, ClusteredLightCuller::PointLightBinding, m_PointLightSSBO);
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, ClusteredLightCuller::SpotLightBinding, m_SpotLightSSBO);
 }
 
 void DeferredLightingSystem::CreateScreenQuad() {
@@ -311,26 +1410,32 @@ void DeferredLightingSystem::CreateScreenQuad() {
     m_ScreenQuadVAO->SetIndexBuffer(ibo);
 }
 
-void DeferredLightingSystem::CreateLightUBOs() {
-    glCreateBuffers(1, &m_DirectionalLightUBO);
-    glNamedBufferStorage(m_DirectionalLightUBO,
-                          MaxDirectionalLights * sizeof(GPUDirectionalLight),
-                          nullptr, GL_DYNAMIC_STORAGE_BIT);
-
-    glCreateBuffers(1, &m_PointLightUBO);
-    glNamedBufferStorage(m_PointLightUBO,
-                          MaxPointLights * sizeof(GPUPointLight),
-                          nullptr, GL_DYNAMIC_STORAGE_BIT);
+void DeferredLightingSystem::CreateLightBuffers() {
+    // Directional UBO plus staging for patched lights; the ring grows for
+    // frames that re-upload everything
+    const usize frameSize = MaxDirectionalLights * sizeof(GPUDirectionalLight) +
+                            256 * sizeof(GPUPointLight) + 64 * sizeof(GPUSpotLight);
+    m_LightRing = CreateScope<GPURingBuffer>(frameSize);
 
-    glCreateBuffers(1, &m_SpotLightUBO);
-    glNamedBufferStorage(m_SpotLightUBO,
-                          MaxSpotLights * sizeof(GPUSpotLight),
-                          nullptr, GL_DYNAMIC_STORAGE_BIT);
+    // Point / spot SSBOs are (re)allocated on demand in UploadLightData
 }
 
 void DeferredLightingSystem::LoadShaders() {
-    m_GeometryShader = CreateRef<Shader>("assets/shaders/deferred/geometry.glsl");
-    m_LightingShader = CreateRef<Shader>("assets/shaders/deferred/lighting.glsl");
+    m_GeometryShader = CreateRef<Shader>("assets/shaders/deferred/geometry.glsl", "",
+                                         MaterialLibrary::Instance().GetShaderDefines());
+    m_OverdrawShader.reset();
+    m_DepthPrepassShader = CreateRef<Shader>("assets/shaders/deferred/depth_prepass.glsl");
+    m_ImpostorShader = CreateRef<Shader>("assets/shaders/deferred/impostor.glsl");
+    m_LightingShaders = CreateScope<ShaderVariants>("assets/shaders/deferred/lighting.glsl", LightingKeywords());
+    m_TiledLightingShaders = CreateScope<ShaderVariants>("assets/shaders/deferred/lighting_tiled.glsl", LightingKeywords());
+    m_ForwardShaders = CreateScope<ShaderVariants>("assets/shaders/deferred/forward.glsl", ForwardKeywords());
+
+    // Shadows on at the default sample count, and off; other sample counts
+    // compile when selected
+    ShaderVariantKey shadowed = m_LightingShaders->Select(0, LightingKeywordShadows, true);
+    shadowed = m_LightingShaders->Select(shadowed, LightingKeywordPCFSamples, PCFSampleVariant(ShadowSettings{}.PCFSamples));
+    m_LightingShaders->Prewarm({0, shadowed});
+    m_TiledLightingShaders->Prewarm({0, shadowed});
 
     LOG_CORE_INFO("Deferred lighting shaders loaded");
 }
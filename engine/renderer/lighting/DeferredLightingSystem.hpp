@@ -3,10 +3,28 @@
 #include "ecs/System.hpp"
 #include "renderer/pipeline/GBuffer.hpp"
 #include "renderer/pipeline/Framebuffer.hpp"
+#include "renderer/pipeline/DynamicResolution.hpp"
+#include "renderer/pipeline/IndirectDrawBatcher.hpp"
+#include "renderer/pipeline/HiZPyramid.hpp"
+#include "renderer/pipeline/AmbientOcclusion.hpp"
+#include "renderer/pipeline/VolumetricFog.hpp"
+#include "renderer/pipeline/TemporalAA.hpp"
+#include "renderer/pipeline/WeightedBlendedOIT.hpp"
+#include "renderer/culling/MeshletCuller.hpp"
+#include "renderer/scatter/ScatterRenderer.hpp"
+#include "renderer/terrain/TerrainRenderer.hpp"
+#include "renderer/debug/OverdrawCounter.hpp"
+#include "renderer/lighting/ClusteredLightCuller.hpp"
+#include "renderer/lighting/LightBudget.hpp"
+#include "renderer/rhi/RenderDevice.hpp"
 #include "renderer/opengl/GLShader.hpp"
+#include "renderer/opengl/GLShaderVariants.hpp"
 #include "renderer/opengl/GLVertexArray.hpp"
+#include "renderer/opengl/GPURingBuffer.hpp"
+#include "renderer/CameraUniformBuffer.hpp"
 #include "camera/Camera.hpp"
 #include <glm/glm.hpp>
+#include <algorithm>
 
 namespace Engine {
 
@@ -18,16 +36,22 @@ struct GPUDirectionalLight {
 struct GPUPointLight {
     glm::vec4 Position;
     glm::vec4 ColorIntensity;
-    glm::vec4 Attenuation;
+    glm::vec4 Attenuation;      // w = point shadow slot in the shadow UBO, -1 = unshadowed
 };
 
 struct GPUSpotLight {
     glm::vec4 Position;
-    glm::vec4 Direction;
+    glm::vec4 Direction;        // w = shadow slot in the shadow UBO, -1 = unshadowed
     glm::vec4 ColorIntensity;
     glm::vec4 CutoffAttenuation;
 };
 
+// How the lighting buffer is shaded from the G-Buffer
+enum class LightingMode : u8 {
+    Clustered,      // Full-screen quad reading per-cluster light lists
+    TiledCompute    // Compute shader culling lights per 16x16 tile in shared memory
+};
+
 class DeferredLightingSystem : public ISystem {
 public:
     DeferredLightingSystem();
@@ -41,8 +65,32 @@ public:
     void OnReload() override;
 
     void SetCamera(Camera* camera) { m_Camera = camera; }
+
+    // Output size. The G-Buffer and lighting buffer are allocated with
+    // headroom (Framebuffer::Fit), so resizing while a window edge is
+    // dragged only moves the viewport; once the size has held for
+    // ResizeSettleFrames frames, buffers left much larger than it are
+    // shrunk. Views resize the same way.
+    static constexpr u32 ResizeSettleFrames = 30;
     void Resize(u32 width, u32 height);
 
+    // The geometry and lighting passes render into a render scale * size
+    // viewport of those buffers, so changing the scale never reallocates.
+    // Whatever samples the lighting texture afterwards (tonemapping) reads
+    // the rendered region through GetRenderUVScale() and upscales it.
+    //
+    // The fixed scale is used while dynamic resolution is off; when it is
+    // on, the scale follows the GPU frame time every frame.
+    void SetRenderScale(f32 scale) { m_FixedRenderScale = std::clamp(scale, 0.1f, 1.0f); }
+    f32 GetFixedRenderScale() const { return m_FixedRenderScale; }
+    f32 GetRenderScale() const { return m_RenderScale; }
+    u32 GetRenderWidth() const { return m_RenderWidth; }
+    u32 GetRenderHeight() const { return m_RenderHeight; }
+    glm::vec2 GetRenderUVScale() const;
+
+    DynamicResolution& GetDynamicResolution() { return m_DynamicResolution; }
+    const DynamicResolution& GetDynamicResolution() const { return m_DynamicResolution; }
+
     // Shadow system integration (forward declared at namespace level)
     void SetShadowSystem(class ShadowMapSystem* shadowSystem) { m_ShadowSystem = shadowSystem; }
 
@@ -53,28 +101,223 @@ public:
 
     u32 GetLightingTextureID() const;
 
+    // Compact trades explicit position for depth reconstruction (see GBuffer.hpp)
+    void SetGBufferLayout(GBufferLayout layout);
+    GBufferLayout GetGBufferLayout() const { return m_GBuffer->GetLayout(); }
+
+    void SetLightingMode(LightingMode mode) { m_LightingMode = mode; }
+    LightingMode GetLightingMode() const { return m_LightingMode; }
+
+    // Light budget - point and spot lights are ranked by screen coverage
+    // every frame; small and distant ones fade out and past the count caps
+    // the lowest scores are dropped (see LightBudget). Shadow slots follow
+    // ShadowSettings' own budget.
+    LightBudgetSettings& GetLightBudget() { return m_LightBudgetSettings; }
+    const LightBudgetSettings& GetLightBudget() const { return m_LightBudgetSettings; }
+
+    // Depth prepass - lays down depth from the meshes' position-only streams
+    // first, then fills the G-Buffer with GL_EQUAL and depth writes off, so
+    // the G-Buffer fragment shader (material fetches, normal mapping, five
+    // render targets) runs once per pixel instead of once per overdrawn
+    // layer. Costs a second, cheap pass over the geometry; worth it for
+    // scenes with depth complexity, not for sparse ones. The G-Buffer depth
+    // is complete before any color is written either way, so its consumers
+    // (Hi-Z, particle soft depth) are unchanged.
+    void SetDepthPrepass(bool enabled) { m_DepthPrepass = enabled; }
+    bool IsDepthPrepassEnabled() const { return m_DepthPrepass; }
+
+    // Min / max depth pyramid of the main view, rebuilt after its geometry
+    // pass each frame while enabled (or while ambient occlusion needs it)
+    void SetHiZEnabled(bool enabled) { m_HiZEnabled = enabled; }
+    bool IsHiZEnabled() const { return m_HiZEnabled; }
+    const HiZPyramid& GetHiZPyramid() const { return *m_HiZ; }
+
+    // Half resolution GTAO of the main view, multiplied into the lighting
+    // pass's ambient term; toggled and tuned through its settings
+    AmbientOcclusion& GetAmbientOcclusion() { return *m_AmbientOcclusion; }
+
+    // Froxel volumetric fog of the main view, lit from the light clusters
+    // and shadow maps before the lighting pass, which applies it with one
+    // 3D fetch per pixel; toggled and tuned through its settings
+    VolumetricFog& GetVolumetricFog() { return *m_VolumetricFog; }
+
+    // Fragment shader invocations per pixel of the main view's geometry
+    // pass, counted while the counter is enabled (DebugView::Overdraw)
+    OverdrawCounter& GetOverdrawCounter() { return *m_Overdraw; }
+
+    // Forward+ - meshes whose MaterialLibrary material is Masked or
+    // Transparent skip the G-Buffer. After each view's lighting pass they
+    // are shaded into its lighting buffer with the deferred pass's light
+    // buffers, shadow maps and cluster lists (built once more only in
+    // LightingMode::TiledCompute, which has none), depth-tested against the
+    // G-Buffer's depth, which is copied into the lighting buffer first.
+    // Masked surfaces write depth; transparent ones are resolved through
+    // WeightedBlendedOIT, so they need no sorting. Neither writes entity
+    // ids or motion vectors, and their impostors are drawn opaque.
+    //
+    // Shadow maps of the forward pass bind from this unit, below
+    // MaterialLibrary::FirstArrayUnit
+    static constexpr u32 ForwardShadowUnit = 0;
+
+    // Meshlet culling - meshes with meshlets drawn at LOD 0 go through
+    // MeshletCuller instead of the batcher: per view, clusters outside the
+    // frustum, facing away or behind last frame's Hi-Z (main view only) are
+    // dropped on the GPU before the depth prepass and G-Buffer fill.
+    void SetMeshletCulling(bool enabled) { m_MeshletCulling = enabled; }
+    bool IsMeshletCullingEnabled() const { return m_MeshletCulling; }
+
+    // Scatter layers - foliage and clutter drawn without entities, culled and
+    // LOD-selected per cell on the GPU for every view (see ScatterRenderer)
+    ScatterRenderer& GetScatter() { return *m_Scatter; }
+
+    // Heightfield terrain - CDLOD nodes picked per view, drawn after the
+    // meshes in the depth prepass and G-Buffer fill (see TerrainRenderer)
+    TerrainRenderer& GetTerrain() { return *m_Terrain; }
+
+    // Temporal anti-aliasing - while enabled the main camera's projection is
+    // jittered every frame (and its uniform block uploaded here), and
+    // ResolveSceneColor() accumulates the lighting buffer into a history at
+    // the full output size through the G-Buffer's motion vectors. Below
+    // render scale 1 that is also the upscale, in place of the spatial one
+    // in post-processing. Extra views are not jittered or resolved.
+    void SetTemporalAA(bool enabled);
+    bool IsTemporalAAEnabled() const { return m_TemporalAAEnabled; }
+    TemporalAA& GetTemporalAA() { return *m_TemporalAA; }
+
+    // What post-processing reads: a framebuffer and the UV extent of its
+    // rendered region in the first attachment
+    struct SceneColor {
+        const Framebuffer* Buffer = nullptr;
+        glm::vec2 UVScale{1.0f};
+    };
+
+    // Call once per frame after everything has been drawn into the lighting
+    // buffer (particles included) and before post-processing. Runs the TAA
+    // resolve when enabled; otherwise returns the lighting buffer as is.
+    SceneColor ResolveSceneColor();
+
+    // Extra views - cameras rendered after the main one each frame into
+    // their own G-Buffer and lighting buffer: split-screen players, further
+    // editor viewports, picture-in-picture. The draw list and its instance
+    // buffers, the light buffers and the shadow maps are built once for the
+    // main camera and shared; each view only redraws the geometry pass and
+    // rebuilds its light clusters. Renderable::InFrustum is shared too, so
+    // the culling system must be given every view's camera
+    // (CullingSystem::SetViewCameras). Cascaded shadows are fitted to the
+    // main camera, so a view looking elsewhere gets the cascades' coverage.
+    //
+    // Views follow the main view's render scale and G-Buffer layout. The
+    // camera uniform block is left bound to the main camera afterwards.
+    using ViewHandle = u32;
+    static constexpr ViewHandle InvalidView = ~0u;
+
+    ViewHandle AddView(const Camera* camera, u32 width, u32 height);
+    void RemoveView(ViewHandle view);
+    void SetViewCamera(ViewHandle view, const Camera* camera);
+    void SetViewEnabled(ViewHandle view, bool enabled);
+    void ResizeView(ViewHandle view, u32 width, u32 height);
+
+    // Null for a removed view
+    Framebuffer* GetViewLightingBuffer(ViewHandle view);
+    GBuffer* GetViewGBuffer(ViewHandle view);
+
+    // Must match lighting_tiled.glsl
+    static constexpr u32 TileSize = 16;
+
+    // Point and spot lights are SSBO-backed and clustered, so only the
+    // directional lights have a fixed cap
     static constexpr u32 MaxDirectionalLights = 4;
-    static constexpr u32 MaxPointLights = 256;
-    static constexpr u32 MaxSpotLights = 64;
 
     struct Stats {
         u32 DirectionalLightCount = 0;
         u32 PointLightCount = 0;
         u32 SpotLightCount = 0;
         u32 EntitiesRendered = 0;
+        u32 Batches = 0;      // Unique (mesh, material) buckets
+        u32 DrawCalls = 0;    // Geometry pass multi-draw calls
+        u32 PrepassDrawCalls = 0;     // Depth prepass multi-draw calls
+        u32 Triangles = 0;    // Main view, at the selected LODs, before meshlet culling
+        u32 MeshletInstances = 0;     // Instances drawn through the meshlet culler
+        u32 MeshletsTested = 0;       // Per view
+        u32 MeshletDrawCalls = 0;
+        u32 ScatterInstances = 0;     // Stored in scatter layers, before culling
+        u32 ScatterDrawCalls = 0;
+        u32 ImpostorInstances = 0;
+        u32 ImpostorDrawCalls = 0;
+        u32 TerrainNodes = 0;         // Last view
+        u32 TerrainDrawCalls = 0;
+        u32 ForwardInstances = 0;     // Masked and transparent
+        u32 ForwardDrawCalls = 0;
+        u32 LightsUploaded = 0;   // Point / spot lights patched this frame
+        u32 LightsCulled = 0;     // Point / spot lights dropped by the light budget
+        u32 LightsFading = 0;     // Crossing the budget's count cap
     };
 
     const Stats& GetStats() const { return m_Stats; }
 
+    // Point / spot lights are tracked incrementally: edits are picked up
+    // through registry.patch()/replace() and moves by comparing positions.
+    // Call this after editing light components in place without patching.
+    void InvalidateLights() { m_LightsStructureDirty = true; }
+
 private:
-    void GeometryPass(entt::registry& registry);
-    void LightingPass(entt::registry& registry);
+    struct View {
+        const Camera* ViewCamera = nullptr;
+        Scope<GBuffer> Geometry;
+        Scope<Framebuffer> Lighting;
+        Scope<CameraUniformBuffer> CameraUniforms;
+        u32 Width = 0;
+        u32 Height = 0;
+        u32 RenderWidth = 0;
+        u32 RenderHeight = 0;
+        bool Enabled = true;
+    };
+
+    // What one view's passes render with; the main view's are the members
+    struct ViewTargets {
+        const Camera* ViewCamera = nullptr;
+        GBuffer* Geometry = nullptr;
+        Framebuffer* Lighting = nullptr;
+        u32 RenderWidth = 0;
+        u32 RenderHeight = 0;
+    };
+
+    void UpdateRenderScale();
+    void ShrinkToOutputSize();
+    void ApplyRenderScale(f32 scale);
+    void ApplyViewRenderScale(View& view);
+    View* FindView(ViewHandle view);
+    ViewTargets GetMainTargets() const;
+    ViewTargets GetViewTargets(const View& view) const;
+
+    void PrepareGeometry(entt::registry& registry);
+    void GatherDrawItems(entt::registry& registry);
+    void RenderView(const ViewTargets& view);
+    void DepthPrepass(const ViewTargets& view);
+    void GeometryPass(const ViewTargets& view);
+    void LightingPass(const ViewTargets& view);
+    void TiledLightingPass(const ViewTargets& view);
+    void ForwardPass(const ViewTargets& view);
+    void BindLightingInputs(Shader& shader, const ViewTargets& view);
+    void BindShadowInputs(Shader& shader, u32 firstUnit);
+
+    // Lighting variant for the current shadow settings
+    ShaderVariantKey LightingVariantKey() const;
+    ShaderVariantKey ForwardVariantKey(bool transparent) const;
 
     void GatherLights(entt::registry& registry);
+    void RebuildLights(entt::registry& registry);
+    void PatchLights(entt::registry& registry);
+    void ApplyShadowSlots();
+    void ApplyLightBudget(f32 deltaTime);
     void UploadLightData();
 
+    void OnLightStructureChanged(entt::registry& registry, entt::entity entity);
+    void OnPointLightUpdated(entt::registry& registry, entt::entity entity);
+    void OnSpotLightUpdated(entt::registry& registry, entt::entity entity);
+
     void CreateScreenQuad();
-    void CreateLightUBOs();
+    void CreateLightBuffers();
     void LoadShaders();
 
 private:
@@ -84,24 +327,103 @@ private:
     Scope<GBuffer> m_GBuffer;
     Scope<Framebuffer> m_LightingBuffer;
 
+    // Removed views leave a null slot so handles stay valid
+    Vector<Scope<View>> m_Views;
+    Scope<CameraUniformBuffer> m_MainCameraUniforms;
+
     Ref<Shader> m_GeometryShader;
-    Ref<Shader> m_LightingShader;
+    Ref<Shader> m_OverdrawShader;                  // OVERDRAW variant, built on first use
+    Ref<Shader> m_DepthPrepassShader;
+    Ref<Shader> m_ImpostorShader;
+    Scope<ShaderVariants> m_LightingShaders;       // Keywords: LightingKeyword
+    Scope<ShaderVariants> m_TiledLightingShaders;
+    Scope<ShaderVariants> m_ForwardShaders;        // Lighting keywords, then ForwardKeyword
 
     Ref<VertexArray> m_ScreenQuadVAO;
 
+    Scope<IndirectDrawBatcher> m_Batcher;
+    Scope<IndirectDrawBatcher> m_DepthBatcher;     // Same items on their depth streams
+    Scope<ClusteredLightCuller> m_ClusterCuller;
+    Scope<IRenderDevice> m_Device;                 // Submits the lists below
+    Scope<HiZPyramid> m_HiZ;
+    Scope<AmbientOcclusion> m_AmbientOcclusion;
+    CommandList m_HiZCommands;                     // Recorded on workers each frame
+    CommandList m_OcclusionCommands;
+    Scope<VolumetricFog> m_VolumetricFog;
+    Scope<OverdrawCounter> m_Overdraw;
+    Vector<IndirectDrawBatcher::DrawItem> m_DrawItems;
+    Vector<IndirectDrawBatcher::DrawItem> m_DepthDrawItems;
+    Scope<MeshletCuller> m_MeshletCuller;
+    Vector<IndirectDrawBatcher::DrawItem> m_MeshletItems;
+    Scope<IndirectDrawBatcher> m_ImpostorBatcher;  // Quads of ImpostorLibrary, after the other geometry
+    Vector<IndirectDrawBatcher::DrawItem> m_ImpostorItems;
+    Scope<IndirectDrawBatcher> m_MaskedBatcher;    // Forward+, see ForwardPass
+    Scope<IndirectDrawBatcher> m_TransparentBatcher;
+    Vector<IndirectDrawBatcher::DrawItem> m_MaskedItems;
+    Vector<IndirectDrawBatcher::DrawItem> m_TransparentItems;
+    Scope<WeightedBlendedOIT> m_Transparency;
+    Scope<ScatterRenderer> m_Scatter;
+    Scope<TerrainRenderer> m_Terrain;
+    Scope<TemporalAA> m_TemporalAA;
+
     Vector<GPUDirectionalLight> m_DirectionalLights;
     Vector<GPUPointLight> m_PointLights;
     Vector<GPUSpotLight> m_SpotLights;
     glm::vec4 m_AmbientLight{0.03f, 0.03f, 0.03f, 1.0f};
 
-    u32 m_DirectionalLightUBO = 0;
-    u32 m_PointLightUBO = 0;
-    u32 m_SpotLightUBO = 0;
+    // Slot -> entity and back for the point / spot arrays
+    Vector<entt::entity> m_PointLightEntities;
+    Vector<entt::entity> m_SpotLightEntities;
+    HashMap<entt::entity, u32> m_PointLightSlots;
+    HashMap<entt::entity, u32> m_SpotLightSlots;
+
+    // Filled by the on_update signals, consumed by PatchLights
+    Vector<entt::entity> m_UpdatedPointLights;
+    Vector<entt::entity> m_UpdatedSpotLights;
+    Vector<u32> m_DirtyPointSlots;
+    Vector<u32> m_DirtySpotSlots;
+    bool m_LightsStructureDirty = true;   // Rebuild the arrays
+    bool m_FullLightUpload = true;        // Re-upload everything
+
+    // Spot / point lights given a shadow slot last frame (ShadowMapSystem order)
+    Vector<entt::entity> m_ShadowedSpotLights;
+    Vector<entt::entity> m_ShadowedPointLights;
+
+    // Budget fade per slot, multiplied in at upload (0 = culled)
+    LightBudgetSettings m_LightBudgetSettings;
+    LightBudget m_PointBudget;
+    LightBudget m_SpotBudget;
+    Vector<LightBudget::Light> m_BudgetLights;
+    Vector<f32> m_BudgetFades;
+    Vector<f32> m_PointLightFades;
+    Vector<f32> m_SpotLightFades;
+
+    // Directional UBO per frame, staging for point / spot patches
+    Scope<GPURingBuffer> m_LightRing;
+    u32 m_PointLightSSBO = 0;
+    u32 m_SpotLightSSBO = 0;
+    u32 m_PointLightCapacity = 0;
+    u32 m_SpotLightCapacity = 0;
+
+    LightingMode m_LightingMode = LightingMode::Clustered;
+    bool m_DepthPrepass = false;
+    bool m_HiZEnabled = true;
+    bool m_MeshletCulling = true;
+    bool m_TemporalAAEnabled = false;
 
     Stats m_Stats;
     u32 m_Width = 1280;
     u32 m_Height = 720;
+    u32 m_FramesToSettle = 0;      // Until ShrinkToOutputSize(), 0 when settled
+
+    DynamicResolution m_DynamicResolution;
+    f32 m_FixedRenderScale = 1.0f;
+    f32 m_RenderScale = 1.0f;
+    u32 m_RenderWidth = 1280;
+    u32 m_RenderHeight = 720;
+
     bool m_Initialized = false;
+    bool m_Connected = false;
 };
 
 } // namespace Engine
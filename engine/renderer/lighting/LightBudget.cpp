@@ -0,0 +1,105 @@
+#include "renderer/lighting/LightBudget.hpp"
+#include "camera/Camera.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+namespace {
+
+// Fraction of the screen height covered by a sphere, 1 when the camera is inside it
+f32 ProjectedCoverage(const Camera& camera, const glm::vec3& center, f32 radius) {
+    f32 distance = glm::length(center - camera.GetPosition());
+    if (distance <= radius) return 1.0f;
+
+    const glm::mat4& proj = camera.GetProjectionMatrix();
+    return std::min(radius * proj[1][1] / distance, 1.0f);
+}
+
+// Same weighting as the shadow caster ranking
+f32 LightImportance(f32 brightness) {
+    return std::clamp(brightness, 0.5f, 2.0f);
+}
+
+// 0 below the threshold, 1 from threshold * band up
+f32 CoverageFade(f32 score, f32 threshold, f32 band) {
+    if (threshold <= 0.0f) return 1.0f;
+
+    const f32 upper = threshold * std::max(band, 1.0f);
+    if (score >= upper) return 1.0f;
+    if (score <= threshold) return 0.0f;
+
+    f32 t = (score - threshold) / (upper - threshold);
+    return t * t * (3.0f - 2.0f * t);
+}
+
+} // anonymous namespace
+
+void LightBudget::Evaluate(const Camera& camera, const Vector<Light>& lights, const LightBudgetSettings& settings,
+                           u32 maxLights, f32 deltaTime, Vector<f32>& fades) {
+    const u32 count = static_cast<u32>(lights.size());
+    fades.assign(count, 1.0f);
+    m_Culled = 0;
+    m_Fading = 0;
+
+    if (!settings.Enabled) {
+        m_RankFades.clear();
+        return;
+    }
+
+    const Frustum& frustum = camera.GetFrustum();
+
+    // Score everything; only visible lights that survive the coverage cut compete for the cap
+    m_Scores.resize(count);
+    m_Ranked.clear();
+    for (u32 i = 0; i < count; ++i) {
+        const Light& light = lights[i];
+        f32 score = ProjectedCoverage(camera, light.Center, light.Radius) * LightImportance(light.Brightness);
+        m_Scores[i] = score;
+        fades[i] = CoverageFade(score, settings.MinScreenCoverage, settings.FadeBand);
+
+        if (fades[i] > 0.0f && frustum.IsSphereVisible(light.Center, light.Radius)) {
+            m_Ranked.push_back(i);
+        }
+    }
+
+    if (m_Ranked.size() > maxLights) {
+        std::nth_element(m_Ranked.begin(), m_Ranked.begin() + maxLights, m_Ranked.end(),
+                         [this](u32 a, u32 b) { return m_Scores[a] > m_Scores[b]; });
+    }
+
+    // Rank fades move towards 1 inside the cap and 0 outside it
+    const f32 step = settings.FadeTime > 0.0f ? deltaTime / settings.FadeTime : 1.0f;
+    m_NextRankFades.clear();
+
+    for (u32 r = 0; r < static_cast<u32>(m_Ranked.size()); ++r) {
+        const u32 i = m_Ranked[r];
+        const f32 target = r < maxLights ? 1.0f : 0.0f;
+
+        auto previous = m_RankFades.find(lights[i].Entity);
+        f32 rankFade = previous != m_RankFades.end() ? previous->second : target;
+        rankFade = rankFade < target ? std::min(rankFade + step, target) : std::max(rankFade - step, target);
+
+        // Fully faded-in lights are the default and aren't tracked
+        if (rankFade < 1.0f) {
+            m_NextRankFades[lights[i].Entity] = rankFade;
+        }
+        fades[i] *= rankFade;
+
+        if (rankFade != target) m_Fading++;
+    }
+    std::swap(m_RankFades, m_NextRankFades);
+
+    for (f32 fade : fades) {
+        if (fade <= 0.0f) m_Culled++;
+    }
+}
+
+void LightBudget::Reset() {
+    m_RankFades.clear();
+    m_Culled = 0;
+    m_Fading = 0;
+}
+
+} // namespace Engine
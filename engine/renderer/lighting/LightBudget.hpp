@@ -0,0 +1,66 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+class Camera;
+
+struct LightBudgetSettings {
+    bool Enabled = true;
+    u32 MaxPointLights = 512;           // Shaded per frame, highest score first
+    u32 MaxSpotLights = 128;
+    f32 MinScreenCoverage = 0.004f;     // Score below which a light is culled
+    f32 FadeBand = 2.0f;                // Lights fade in up to MinScreenCoverage * FadeBand
+    f32 FadeTime = 0.3f;                // Seconds to fade a light in or out of the count cap
+};
+
+// LightBudget - per-frame importance ranking of one kind of light (point or
+// spot) for DeferredLightingSystem.
+//
+// A light's score is the fraction of the screen height its bounding sphere
+// covers, weighted by brightness - the same measure ShadowMapSystem ranks
+// shadow casters by. Below MinScreenCoverage a light is culled; over the
+// FadeBand above it the light fades with its score, so distant lights dim
+// out as the camera leaves rather than popping. Of the visible lights that
+// remain, only the maxLights highest scores are shaded; lights crossing that
+// cut fade over FadeTime instead of switching in one frame. Lights outside
+// the view aren't ranked (the light culling drops them anyway) and take
+// their target fade immediately.
+//
+// The result is one fade per light, 0 = culled, multiplied into the light's
+// intensity when it is uploaded.
+class LightBudget {
+public:
+    struct Light {
+        entt::entity Entity;
+        glm::vec3 Center;               // Bounding sphere
+        f32 Radius;
+        f32 Brightness;                 // Intensity * brightest color channel
+    };
+
+    // Fills fades with one value per light, in the order of lights
+    void Evaluate(const Camera& camera, const Vector<Light>& lights, const LightBudgetSettings& settings,
+                  u32 maxLights, f32 deltaTime, Vector<f32>& fades);
+
+    // Forget the fade history; every light takes its target next frame
+    void Reset();
+
+    u32 GetCulledCount() const { return m_Culled; }
+    u32 GetFadingCount() const { return m_Fading; }
+
+private:
+    // Count-cap fade per entity, carried across rebuilds of the light arrays
+    HashMap<entt::entity, f32> m_RankFades;
+    HashMap<entt::entity, f32> m_NextRankFades;
+
+    Vector<f32> m_Scores;
+    Vector<u32> m_Ranked;
+
+    u32 m_Culled = 0;
+    u32 m_Fading = 0;
+};
+
+} // namespace Engine
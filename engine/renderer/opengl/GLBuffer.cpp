@@ -1,58 +1,174 @@
 #include "GLBuffer.hpp"
+#include "GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "core/Logger.hpp"
 #include <glad/gl.h>
+#include <cstring>
 
 namespace Engine {
 
-// VertexBuffer
+// BufferStorage
 
-VertexBuffer::VertexBuffer(u32 size) {
+BufferStorage::BufferStorage(u32 size, const void* data, BufferUsage usage)
+    : m_Usage(usage)
+    , m_Size(size)
+{
     glCreateBuffers(1, &m_RendererID);
-    glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-    glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+
+    switch (m_Usage) {
+        case BufferUsage::Static:
+            GLMemory::BufferStorage(m_RendererID, size, data, 0, MemoryTag::Geometry);
+            break;
+        case BufferUsage::Dynamic:
+            GLMemory::BufferStorage(m_RendererID, size, data, GL_DYNAMIC_STORAGE_BIT, MemoryTag::Geometry);
+            break;
+        case BufferUsage::Stream: {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            const GLsizeiptr totalSize = static_cast<GLsizeiptr>(size) * StreamRegions;
+            GLMemory::BufferStorage(m_RendererID, static_cast<usize>(totalSize), nullptr, flags, MemoryTag::Geometry);
+            m_Mapped = static_cast<u8*>(glMapNamedBufferRange(m_RendererID, 0, totalSize, flags));
+            if (!m_Mapped) {
+                LOG_CORE_ERROR("BufferStorage: Failed to map {} byte stream buffer", totalSize);
+            }
+            if (m_Mapped && data) {
+                std::memcpy(m_Mapped, data, size);
+                m_Written = true;
+            }
+            break;
+        }
+    }
 }
 
-VertexBuffer::VertexBuffer(const f32* vertices, u32 size) {
-    glCreateBuffers(1, &m_RendererID);
-    glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-    glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+BufferStorage::~BufferStorage() {
+    for (void*& fence : m_Fences) {
+        if (fence) {
+            glDeleteSync(static_cast<GLsync>(fence));
+            fence = nullptr;
+        }
+    }
+    if (m_Mapped) {
+        glUnmapNamedBuffer(m_RendererID);
+        m_Mapped = nullptr;
+    }
+    GLMemory::DeleteBuffers(1, &m_RendererID);
+}
+
+bool BufferStorage::Write(const void* data, u32 size) {
+    if (size > m_Size) {
+        LOG_CORE_ERROR("BufferStorage: Write of {} bytes exceeds the {} byte buffer", size, m_Size);
+        return false;
+    }
+
+    switch (m_Usage) {
+        case BufferUsage::Static:
+            LOG_CORE_ERROR("BufferStorage: Static buffers can't be written after creation");
+            return false;
+
+        case BufferUsage::Dynamic:
+            glNamedBufferSubData(m_RendererID, 0, size, data);
+            return true;
+
+        case BufferUsage::Stream:
+            if (!m_Mapped) return false;
+
+            // Everything submitted so far may read the current region
+            if (m_Written) {
+                if (m_Fences[m_Region]) {
+                    glDeleteSync(static_cast<GLsync>(m_Fences[m_Region]));
+                }
+                m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                m_Region = (m_Region + 1) % StreamRegions;
+            }
+
+            WaitForRegion(m_Region);
+            std::memcpy(m_Mapped + GetOffset(), data, size);
+            m_Written = true;
+            return true;
+    }
+    return false;
+}
+
+bool BufferStorage::WriteRange(const void* data, u32 size, u32 offset) {
+    if (m_Usage != BufferUsage::Dynamic) {
+        LOG_CORE_ERROR("BufferStorage: Range writes need Dynamic storage");
+        return false;
+    }
+    if (offset > m_Size || size > m_Size - offset) {
+        LOG_CORE_ERROR("BufferStorage: Write of {} bytes at {} exceeds the {} byte buffer", size, offset, m_Size);
+        return false;
+    }
+
+    glNamedBufferSubData(m_RendererID, offset, size, data);
+    return true;
+}
+
+void BufferStorage::WaitForRegion(u32 region) {
+    GLsync fence = static_cast<GLsync>(m_Fences[region]);
+    if (!fence) return;
+
+    // Normally already signalled
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+        LOG_CORE_WARN("BufferStorage: fence wait failed, writing region {} anyway", region);
+    }
+
+    glDeleteSync(fence);
+    m_Fences[region] = nullptr;
+}
+
+// VertexBuffer
+
+VertexBuffer::VertexBuffer(u32 size, BufferUsage usage)
+    : m_Storage(size, nullptr, usage) {
 }
 
-VertexBuffer::~VertexBuffer() {
-    glDeleteBuffers(1, &m_RendererID);
+VertexBuffer::VertexBuffer(const f32* vertices, u32 size)
+    : m_Storage(size, vertices, BufferUsage::Static) {
 }
 
 void VertexBuffer::Bind() const {
-    glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+    GLStateCache::Instance().BindBuffer(GL_ARRAY_BUFFER, m_Storage.GetRendererID());
 }
 
 void VertexBuffer::Unbind() const {
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLStateCache::Instance().BindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void VertexBuffer::SetData(const void* data, u32 size) {
-    glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+    m_Storage.Write(data, size);
+}
+
+void VertexBuffer::SetSubData(const void* data, u32 size, u32 offset) {
+    m_Storage.WriteRange(data, size, offset);
 }
 
 // IndexBuffer
 
 IndexBuffer::IndexBuffer(const u32* indices, u32 count)
-    : m_Count(count) {
-    glCreateBuffers(1, &m_RendererID);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(u32), indices, GL_STATIC_DRAW);
+    : m_Storage(count * sizeof(u32), indices, BufferUsage::Static)
+    , m_Count(count) {
 }
 
-IndexBuffer::~IndexBuffer() {
-    glDeleteBuffers(1, &m_RendererID);
+IndexBuffer::IndexBuffer(u32 maxCount, BufferUsage usage)
+    : m_Storage(maxCount * sizeof(u32), nullptr, usage) {
 }
 
 void IndexBuffer::Bind() const {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Storage.GetRendererID());
 }
 
 void IndexBuffer::Unbind() const {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
+void IndexBuffer::SetData(const u32* indices, u32 count) {
+    if (m_Storage.Write(indices, count * sizeof(u32))) {
+        m_Count = count;
+    }
+}
+
+void IndexBuffer::SetSubData(const u32* indices, u32 count, u32 firstIndex) {
+    m_Storage.WriteRange(indices, count * sizeof(u32), firstIndex * sizeof(u32));
+}
+
 } // namespace Engine
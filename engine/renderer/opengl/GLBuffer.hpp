@@ -5,8 +5,10 @@
 
 namespace Engine {
 
+// UShort4Norm / Short4Norm are read as normalized floats, Half2 as floats
 enum class ShaderDataType {
-    None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, Bool
+    None = 0, Float, Float2, Float3, Float4, Mat3, Mat4, Int, Int2, Int3, Int4, UInt, Bool,
+    UShort4Norm, Short4Norm, Half2
 };
 
 static u32 ShaderDataTypeSize(ShaderDataType type) {
@@ -21,7 +23,11 @@ static u32 ShaderDataTypeSize(ShaderDataType type) {
         case ShaderDataType::Int2:   return 4 * 2;
         case ShaderDataType::Int3:   return 4 * 3;
         case ShaderDataType::Int4:   return 4 * 4;
+        case ShaderDataType::UInt:   return 4;
         case ShaderDataType::Bool:   return 1;
+        case ShaderDataType::UShort4Norm: return 2 * 4;
+        case ShaderDataType::Short4Norm:  return 2 * 4;
+        case ShaderDataType::Half2:       return 2 * 2;
         default: return 0;
     }
 }
@@ -32,11 +38,13 @@ struct BufferElement {
     u32 Size;
     u32 Offset;
     bool Normalized;
+    i32 Location;       // Attribute location, -1 = the one after the previous element
 
     BufferElement() = default;
 
-    BufferElement(ShaderDataType type, const String& name, bool normalized = false)
-        : Name(name), Type(type), Size(ShaderDataTypeSize(type)), Offset(0), Normalized(normalized) {}
+    BufferElement(ShaderDataType type, const String& name, bool normalized = false, i32 location = -1)
+        : Name(name), Type(type), Size(ShaderDataTypeSize(type)), Offset(0), Normalized(normalized),
+          Location(location) {}
 
     u32 GetComponentCount() const {
         switch (Type) {
@@ -50,7 +58,11 @@ struct BufferElement {
             case ShaderDataType::Int2:   return 2;
             case ShaderDataType::Int3:   return 3;
             case ShaderDataType::Int4:   return 4;
+            case ShaderDataType::UInt:   return 1;
             case ShaderDataType::Bool:   return 1;
+            case ShaderDataType::UShort4Norm: return 4;
+            case ShaderDataType::Short4Norm:  return 4;
+            case ShaderDataType::Half2:       return 2;
             default: return 0;
         }
     }
@@ -89,37 +101,106 @@ private:
     u32 m_Stride = 0;
 };
 
+// How a VertexBuffer / IndexBuffer is written after creation. All storage
+// is immutable (glNamedBufferStorage); only the contents change.
+enum class BufferUsage {
+    Static,     // Contents fixed at creation
+    Dynamic,    // SetData() through glNamedBufferSubData
+    Stream      // SetData() into a persistently mapped ring, see BufferStorage
+};
+
+// BufferStorage - the GL buffer behind VertexBuffer and IndexBuffer.
+//
+// Stream storage holds StreamRegions copies of the requested size, mapped
+// once. Every Write() fences the region written last, moves to the next one
+// and waits on the fence left there StreamRegions writes ago, so uploads
+// never orphan or stall on the draws still reading older data. With one
+// write per frame a region is reused three frames later.
+class BufferStorage {
+public:
+    static constexpr u32 StreamRegions = 3;
+
+    BufferStorage(u32 size, const void* data, BufferUsage usage);
+    ~BufferStorage();
+
+    BufferStorage(const BufferStorage&) = delete;
+    BufferStorage& operator=(const BufferStorage&) = delete;
+
+    bool Write(const void* data, u32 size);
+
+    // Dynamic only: write [offset, offset + size) and leave the rest
+    bool WriteRange(const void* data, u32 size, u32 offset);
+
+    u32 GetRendererID() const { return m_RendererID; }
+    BufferUsage GetUsage() const { return m_Usage; }
+    u32 GetSize() const { return m_Size; }
+
+    // Byte offset of the data last written (non-zero only for Stream)
+    u32 GetOffset() const { return m_Region * m_Size; }
+
+private:
+    void WaitForRegion(u32 region);
+
+private:
+    u32 m_RendererID = 0;
+    BufferUsage m_Usage = BufferUsage::Static;
+    u32 m_Size = 0;             // Per region for Stream
+
+    u8* m_Mapped = nullptr;
+    u32 m_Region = 0;
+    bool m_Written = false;
+    void* m_Fences[StreamRegions] = {};
+};
+
 class VertexBuffer {
 public:
-    VertexBuffer(u32 size);
+    VertexBuffer(u32 size, BufferUsage usage = BufferUsage::Dynamic);
     VertexBuffer(const f32* vertices, u32 size);
-    ~VertexBuffer();
+    ~VertexBuffer() = default;
 
     void Bind() const;
     void Unbind() const;
 
+    // Dynamic / Stream only. Stream data lands at GetOffset().
     void SetData(const void* data, u32 size);
 
+    // Dynamic only, for buffers shared by several meshes (see GeometryPool)
+    void SetSubData(const void* data, u32 size, u32 offset);
+
     const BufferLayout& GetLayout() const { return m_Layout; }
     void SetLayout(const BufferLayout& layout) { m_Layout = layout; }
 
+    u32 GetRendererID() const { return m_Storage.GetRendererID(); }
+    BufferUsage GetUsage() const { return m_Storage.GetUsage(); }
+    u32 GetOffset() const { return m_Storage.GetOffset(); }
+
 private:
-    u32 m_RendererID = 0;
+    BufferStorage m_Storage;
     BufferLayout m_Layout;
 };
 
 class IndexBuffer {
 public:
     IndexBuffer(const u32* indices, u32 count);
-    ~IndexBuffer();
+    IndexBuffer(u32 maxCount, BufferUsage usage);
+    ~IndexBuffer() = default;
 
     void Bind() const;
     void Unbind() const;
 
+    // Dynamic / Stream only. Stream indices land at GetOffset(), which goes
+    // into the draw call's indices pointer.
+    void SetData(const u32* indices, u32 count);
+
+    // Dynamic only. Writes count indices starting at firstIndex.
+    void SetSubData(const u32* indices, u32 count, u32 firstIndex);
+
     u32 GetCount() const { return m_Count; }
+    u32 GetRendererID() const { return m_Storage.GetRendererID(); }
+    u32 GetOffset() const { return m_Storage.GetOffset(); }
 
 private:
-    u32 m_RendererID = 0;
+    BufferStorage m_Storage;
     u32 m_Count = 0;
 };
 
@@ -0,0 +1,167 @@
+#include "GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include <glad/gl.h>
+#include <algorithm>
+
+namespace Engine {
+
+namespace {
+
+// Extension formats glad's core profile header does not define
+constexpr GLenum CompressedRGBS3TCDXT1 = 0x83F0;
+constexpr GLenum CompressedRGBAS3TCDXT1 = 0x83F1;
+constexpr GLenum CompressedRGBAS3TCDXT5 = 0x83F3;
+constexpr GLenum CompressedRGBAASTC4x4 = 0x93B0;
+constexpr GLenum CompressedRGBAASTC6x6 = 0x93B4;
+constexpr GLenum CompressedRGBAASTC8x8 = 0x93B7;
+
+struct Allocation {
+    u64 Size = 0;
+    MemoryTag Tag = MemoryTag::General;
+    MemoryTracker::GPUKind Kind = MemoryTracker::GPUKind::Buffer;
+};
+
+// Keyed by buffer / texture name; the two namespaces are separate in GL
+HashMap<u32, Allocation> s_Buffers;
+HashMap<u32, Allocation> s_Textures;
+
+void Record(HashMap<u32, Allocation>& objects, u32 id, u64 size, MemoryTag tag, MemoryTracker::GPUKind kind) {
+    auto [it, inserted] = objects.try_emplace(id, Allocation{size, tag, kind});
+    if (!inserted) {
+        // Same name handed out again after a delete we did not see
+        MemoryTracker::RecordGPU(it->second.Tag, it->second.Kind, -static_cast<i64>(it->second.Size));
+        it->second = Allocation{size, tag, kind};
+    }
+    MemoryTracker::RecordGPU(tag, kind, static_cast<i64>(size));
+}
+
+void Release(HashMap<u32, Allocation>& objects, i32 count, const u32* ids) {
+    for (i32 i = 0; i < count; ++i) {
+        auto it = objects.find(ids[i]);
+        if (it == objects.end()) continue;
+        MemoryTracker::RecordGPU(it->second.Tag, it->second.Kind, -static_cast<i64>(it->second.Size));
+        objects.erase(it);
+    }
+}
+
+struct BlockInfo {
+    u32 Width = 1;
+    u32 Height = 1;
+    u32 Bytes = 0;      // Per block; per texel when the block is 1x1
+};
+
+BlockInfo GetBlockInfo(u32 internalFormat) {
+    switch (internalFormat) {
+        case GL_R8:
+            return {1, 1, 1};
+        case GL_RG8:
+        case GL_R16F:
+        case GL_DEPTH_COMPONENT16:
+            return {1, 1, 2};
+        case GL_RGB8:
+        case GL_SRGB8:
+        case GL_DEPTH_COMPONENT24:
+            return {1, 1, 3};
+        case GL_RGBA8:
+        case GL_SRGB8_ALPHA8:
+        case GL_RG16:
+        case GL_RG16F:
+        case GL_R32F:
+        case GL_R32UI:
+        case GL_R32I:
+        case GL_R11F_G11F_B10F:
+        case GL_RGB10_A2:
+        case GL_DEPTH_COMPONENT32F:
+        case GL_DEPTH24_STENCIL8:
+            return {1, 1, 4};
+        case GL_RGB16F:
+            return {1, 1, 6};
+        case GL_RGBA16F:
+        case GL_RG32F:
+        case GL_RG32UI:
+        case GL_DEPTH32F_STENCIL8:
+            return {1, 1, 8};
+        case GL_RGB32F:
+            return {1, 1, 12};
+        case GL_RGBA32F:
+        case GL_RGBA32UI:
+            return {1, 1, 16};
+
+        case CompressedRGBS3TCDXT1:
+        case CompressedRGBAS3TCDXT1:
+        case GL_COMPRESSED_RED_RGTC1:
+            return {4, 4, 8};
+        case CompressedRGBAS3TCDXT5:
+        case GL_COMPRESSED_RG_RGTC2:
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+        case CompressedRGBAASTC4x4:
+            return {4, 4, 16};
+        case CompressedRGBAASTC6x6:
+            return {6, 6, 16};
+        case CompressedRGBAASTC8x8:
+            return {8, 8, 16};
+
+        default:
+            return {};
+    }
+}
+
+u64 GetMipChainSize(u32 internalFormat, i32 levels, i32 width, i32 height) {
+    u64 size = 0;
+    for (i32 level = 0; level < levels; ++level) {
+        size += GLMemory::GetLevelSize(internalFormat, std::max(1, width >> level), std::max(1, height >> level));
+    }
+    return size;
+}
+
+} // anonymous namespace
+
+void GLMemory::BufferStorage(u32 buffer, usize size, const void* data, u32 flags, MemoryTag tag) {
+    glNamedBufferStorage(buffer, static_cast<GLsizeiptr>(size), data, flags);
+    Record(s_Buffers, buffer, size, tag, MemoryTracker::GPUKind::Buffer);
+}
+
+void GLMemory::TextureStorage2D(u32 texture, i32 levels, u32 internalFormat, i32 width, i32 height, MemoryTag tag) {
+    glTextureStorage2D(texture, levels, internalFormat, width, height);
+    Record(s_Textures, texture, GetMipChainSize(internalFormat, levels, width, height), tag,
+           MemoryTracker::GPUKind::Texture);
+}
+
+void GLMemory::TextureStorage3D(u32 texture, i32 levels, u32 internalFormat, i32 width, i32 height, i32 depth,
+                                MemoryTag tag) {
+    glTextureStorage3D(texture, levels, internalFormat, width, height, depth);
+
+    // Array layers (the only 3D storage the engine creates) keep their count at every level
+    Record(s_Textures, texture, GetMipChainSize(internalFormat, levels, width, height) * static_cast<u64>(depth), tag,
+           MemoryTracker::GPUKind::Texture);
+}
+
+void GLMemory::TextureStorage2DMultisample(u32 texture, i32 samples, u32 internalFormat, i32 width, i32 height,
+                                           bool fixedSampleLocations, MemoryTag tag) {
+    glTextureStorage2DMultisample(texture, samples, internalFormat, width, height,
+                                  fixedSampleLocations ? GL_TRUE : GL_FALSE);
+    Record(s_Textures, texture, GetLevelSize(internalFormat, width, height) * static_cast<u64>(samples), tag,
+           MemoryTracker::GPUKind::Texture);
+}
+
+void GLMemory::DeleteBuffers(i32 count, const u32* buffers) {
+    Release(s_Buffers, count, buffers);
+    GLStateCache::Instance().OnBuffersDeleted(count, buffers);
+    glDeleteBuffers(count, buffers);
+}
+
+void GLMemory::DeleteTextures(i32 count, const u32* textures) {
+    Release(s_Textures, count, textures);
+    GLStateCache::Instance().OnTexturesDeleted(count, textures);
+    glDeleteTextures(count, textures);
+}
+
+usize GLMemory::GetLevelSize(u32 internalFormat, i32 width, i32 height) {
+    const BlockInfo block = GetBlockInfo(internalFormat);
+    const usize blocksX = (static_cast<usize>(std::max(width, 1)) + block.Width - 1) / block.Width;
+    const usize blocksY = (static_cast<usize>(std::max(height, 1)) + block.Height - 1) / block.Height;
+    return blocksX * blocksY * block.Bytes;
+}
+
+} // namespace Engine
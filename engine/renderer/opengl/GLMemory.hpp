@@ -0,0 +1,36 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/MemoryTracker.hpp"
+
+namespace Engine {
+
+// GLMemory - buffer and texture storage with per-subsystem accounting.
+//
+// Stand-ins for glNamedBufferStorage / glTextureStorage* and glDeleteBuffers /
+// glDeleteTextures: the storage size of every object is recorded under a
+// MemoryTag when it is created and released when it is deleted, and the
+// totals show up in MemoryTracker::GetStats. Texture sizes come from the
+// internal format (block-compressed ones included); drivers pad and may keep
+// extra copies, so they are a lower bound. Deleting an object that was not
+// created here is fine, it just has nothing to release.
+//
+// GL thread only.
+class GLMemory {
+public:
+    static void BufferStorage(u32 buffer, usize size, const void* data, u32 flags, MemoryTag tag);
+
+    static void TextureStorage2D(u32 texture, i32 levels, u32 internalFormat, i32 width, i32 height, MemoryTag tag);
+    static void TextureStorage3D(u32 texture, i32 levels, u32 internalFormat, i32 width, i32 height, i32 depth,
+                                 MemoryTag tag);
+    static void TextureStorage2DMultisample(u32 texture, i32 samples, u32 internalFormat, i32 width, i32 height,
+                                            bool fixedSampleLocations, MemoryTag tag);
+
+    static void DeleteBuffers(i32 count, const u32* buffers);
+    static void DeleteTextures(i32 count, const u32* textures);
+
+    // Bytes of one width x height level of internalFormat; 0 if unknown
+    static usize GetLevelSize(u32 internalFormat, i32 width, i32 height);
+};
+
+} // namespace Engine
@@ -0,0 +1,188 @@
+#include "renderer/opengl/GLRenderDevice.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/GLVertexArray.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
+#include "core/Profiler.hpp"
+
+#include <glad/gl.h>
+
+namespace Engine {
+
+namespace {
+
+u32 ToGLTopology(PrimitiveTopology topology) {
+    switch (topology) {
+        case PrimitiveTopology::Triangles:     return GL_TRIANGLES;
+        case PrimitiveTopology::TriangleStrip: return GL_TRIANGLE_STRIP;
+        case PrimitiveTopology::Lines:         return GL_LINES;
+        case PrimitiveTopology::Points:        return GL_POINTS;
+    }
+    return GL_TRIANGLES;
+}
+
+u32 ToGLImageAccess(ImageAccess access) {
+    switch (access) {
+        case ImageAccess::Read:      return GL_READ_ONLY;
+        case ImageAccess::Write:     return GL_WRITE_ONLY;
+        case ImageAccess::ReadWrite: return GL_READ_WRITE;
+    }
+    return GL_READ_WRITE;
+}
+
+// The image load / store formats among TextureFormat
+u32 ToGLImageFormat(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::R8:      return GL_R8;
+        case TextureFormat::RG8:     return GL_RG8;
+        case TextureFormat::RGBA8:   return GL_RGBA8;
+        case TextureFormat::R16F:    return GL_R16F;
+        case TextureFormat::RG16F:   return GL_RG16F;
+        case TextureFormat::RGBA16F: return GL_RGBA16F;
+        case TextureFormat::R32F:    return GL_R32F;
+        case TextureFormat::RG32F:   return GL_RG32F;
+        case TextureFormat::RGBA32F: return GL_RGBA32F;
+        default:                     return GL_RGBA8;
+    }
+}
+
+// GL only needs barriers where shaders wrote memory incoherently; the bits
+// name how the writes are read next
+GLbitfield ToGLBarrierBits(ResourceAccess after) {
+    GLbitfield bits = 0;
+    if (HasAccess(after, ResourceAccess::VertexInput))  bits |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+    if (HasAccess(after, ResourceAccess::IndexInput))   bits |= GL_ELEMENT_ARRAY_BARRIER_BIT;
+    if (HasAccess(after, ResourceAccess::Uniform))      bits |= GL_UNIFORM_BARRIER_BIT;
+    if (HasAccess(after, ResourceAccess::Storage))      bits |= GL_SHADER_STORAGE_BARRIER_BIT;
+    if (HasAccess(after, ResourceAccess::TextureFetch)) bits |= GL_TEXTURE_FETCH_BARRIER_BIT;
+    if (HasAccess(after, ResourceAccess::ShaderImage))  bits |= GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+    if (HasAccess(after, ResourceAccess::Indirect))     bits |= GL_COMMAND_BARRIER_BIT;
+    if (HasAccess(after, ResourceAccess::RenderTarget)) bits |= GL_FRAMEBUFFER_BARRIER_BIT;
+    if (HasAccess(after, ResourceAccess::Transfer)) {
+        bits |= GL_BUFFER_UPDATE_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT;
+    }
+    return bits;
+}
+
+// Commands of one list; the pipeline carries over from one command to the next
+struct GLCommandExecutor {
+    IRenderDevice::Stats& Stats;
+    Shader* Program = nullptr;
+    u32 Topology = GL_TRIANGLES;
+
+    void operator()(const RHICommand::BindPipeline& command) {
+        const PipelineDesc& pipeline = command.Pipeline;
+        Program = pipeline.Program;
+        Topology = ToGLTopology(pipeline.Topology);
+        if (Program) Program->Bind();
+        if (!pipeline.Compute) GLStateCache::Instance().Apply(pipeline.State);
+    }
+
+    void operator()(const RHICommand::BindVertexArray& command) {
+        if (command.Array) {
+            command.Array->Bind();
+        } else {
+            GLStateCache::Instance().BindVertexArray(0);
+        }
+    }
+
+    void operator()(const RHICommand::BindBuffer& command) {
+        const u32 target = command.Binding == BufferBinding::Uniform ? GL_UNIFORM_BUFFER : GL_SHADER_STORAGE_BUFFER;
+        GLStateCache::Instance().BindBufferRange(target, command.Index, command.Buffer, command.Offset, command.Size);
+    }
+
+    void operator()(const RHICommand::BindTexture& command) {
+        GLStateCache::Instance().BindTextureUnit(command.Unit, command.Texture);
+    }
+
+    void operator()(const RHICommand::BindImage& command) {
+        glBindImageTexture(command.Unit, command.Texture, static_cast<GLint>(command.Level), GL_FALSE, 0,
+                           ToGLImageAccess(command.Access), ToGLImageFormat(command.Format));
+    }
+
+    void operator()(const RHICommand::SetInt& command) {
+        if (Program) Program->SetInt(command.Uniform, command.Value);
+    }
+
+    void operator()(const RHICommand::SetInt2& command) {
+        if (Program) Program->SetInt2(command.Uniform, command.Value);
+    }
+
+    void operator()(const RHICommand::SetFloat& command) {
+        if (Program) Program->SetFloat(command.Uniform, command.Value);
+    }
+
+    void operator()(const RHICommand::SetFloat4& command) {
+        if (Program) Program->SetFloat4(command.Uniform, command.Value);
+    }
+
+    void operator()(const RHICommand::SetMat4& command) {
+        if (Program) Program->SetMat4(command.Uniform, command.Value);
+    }
+
+    void operator()(const RHICommand::Draw& command) {
+        PipelineWarmup::RecordDraw(Topology);
+        glDrawArraysInstancedBaseInstance(Topology, static_cast<GLint>(command.FirstVertex),
+                                          static_cast<GLsizei>(command.VertexCount),
+                                          static_cast<GLsizei>(command.InstanceCount), command.FirstInstance);
+        Stats.DrawCalls++;
+    }
+
+    void operator()(const RHICommand::DrawIndexed& command) {
+        PipelineWarmup::RecordDraw(Topology);
+        glDrawElementsInstancedBaseVertexBaseInstance(
+            Topology, static_cast<GLsizei>(command.IndexCount), GL_UNSIGNED_INT,
+            reinterpret_cast<const void*>(static_cast<usize>(command.FirstIndex) * sizeof(u32)),
+            static_cast<GLsizei>(command.InstanceCount), command.BaseVertex, command.FirstInstance);
+        Stats.DrawCalls++;
+    }
+
+    void operator()(const RHICommand::DrawIndexedIndirect& command) {
+        GLStateCache::Instance().BindBuffer(GL_DRAW_INDIRECT_BUFFER, command.Buffer);
+        PipelineWarmup::RecordDraw(Topology);
+        glMultiDrawElementsIndirect(Topology, GL_UNSIGNED_INT, reinterpret_cast<const void*>(command.Offset),
+                                    static_cast<GLsizei>(command.DrawCount), static_cast<GLsizei>(command.Stride));
+        Stats.DrawCalls++;
+    }
+
+    void operator()(const RHICommand::Dispatch& command) {
+        glDispatchCompute(command.GroupsX, command.GroupsY, command.GroupsZ);
+        Stats.Dispatches++;
+    }
+
+    void operator()(const RHICommand::DispatchIndirect& command) {
+        GLStateCache::Instance().BindBuffer(GL_DISPATCH_INDIRECT_BUFFER, command.Buffer);
+        glDispatchComputeIndirect(static_cast<GLintptr>(command.Offset));
+        Stats.Dispatches++;
+    }
+
+    void operator()(const RHICommand::Barrier& command) {
+        const GLbitfield bits = ToGLBarrierBits(command.After);
+        if (bits == 0) return;
+        glMemoryBarrier(bits);
+        Stats.Barriers++;
+    }
+};
+
+} // anonymous namespace
+
+void GLRenderDevice::Submit(const Vector<CommandList>& lists) {
+    PROFILE_SCOPE("GLRenderDevice::Submit");
+    for (const CommandList& list : lists) {
+        Execute(list);
+    }
+}
+
+void GLRenderDevice::Submit(const CommandList& list) {
+    PROFILE_SCOPE("GLRenderDevice::Submit");
+    Execute(list);
+}
+
+void GLRenderDevice::Execute(const CommandList& list) {
+    if (list.IsEmpty()) return;
+
+    list.Visit(GLCommandExecutor{m_Stats});
+    m_Stats.Lists++;
+    m_Stats.Commands += list.GetCommandCount();
+}
+
+} // namespace Engine
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "renderer/rhi/RenderDevice.hpp"
+
+namespace Engine {
+
+// GLRenderDevice - the OpenGL backend of IRenderDevice.
+//
+// Translates commands into GL 4.5 calls on the calling thread, which must
+// own the context. State goes through GLStateCache, so a list's binds cost
+// nothing when GL already has them, and the state a list leaves behind is
+// what the cache reports afterwards. GL orders commands itself; Barrier()
+// only matters after shader writes and becomes glMemoryBarrier for the
+// accesses that follow.
+class GLRenderDevice : public IRenderDevice {
+public:
+    RenderBackend GetBackend() const override { return RenderBackend::OpenGL; }
+
+    void Submit(const Vector<CommandList>& lists) override;
+    void Submit(const CommandList& list) override;
+
+private:
+    void Execute(const CommandList& list);
+};
+
+} // namespace Engine
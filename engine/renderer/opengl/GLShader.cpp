@@ -1,14 +1,143 @@
 #include "GLShader.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
 #include "core/Logger.hpp"
+#include "core/JobSystem.hpp"
 
 #include <glad/gl.h>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <iterator>
+#include <mutex>
 #include <sstream>
+#include <string_view>
 
 namespace Engine {
 
+namespace {
+
+// Header of a program binary cache file. The key covers the shader source
+// and the driver, so an edited shader or a driver update misses the cache.
+struct ProgramBinaryHeader {
+    u32 Magic = 0;
+    u32 Version = 0;
+    u64 Key = 0;
+    u32 Format = 0;
+    u32 Size = 0;
+};
+
+constexpr u32 ProgramBinaryMagic = 0x42535650u;   // "PVSB"
+constexpr u32 ProgramBinaryVersion = 1;
+
+// KHR_parallel_shader_compile / ARB_parallel_shader_compile, same value;
+// the glad loader is generated without extensions
+constexpr GLenum CompletionStatusKHR = 0x91B1;
+
+u64 HashBytes(const void* data, usize size, u64 hash = 14695981039346656037ull) {
+    const u8* bytes = static_cast<const u8*>(data);
+    for (usize i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Binaries are only valid for the driver that produced them
+u64 DriverHash() {
+    static const u64 hash = [] {
+        u64 result = 14695981039346656037ull;
+        for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+            const char* value = reinterpret_cast<const char*>(glGetString(name));
+            if (value) {
+                result = HashBytes(value, std::strlen(value), result);
+            }
+        }
+        return result;
+    }();
+    return hash;
+}
+
+bool HasGLExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (extension && std::strcmp(extension, name) == 0) return true;
+    }
+    return false;
+}
+
+// Compiles run on driver threads by default once the extension is present
+// (GL_MAX_SHADER_COMPILER_THREADS starts implementation-defined, not 0)
+bool SupportsParallelCompile() {
+    static const bool supported = HasGLExtension("GL_KHR_parallel_shader_compile") ||
+                                  HasGLExtension("GL_ARB_parallel_shader_compile");
+    return supported;
+}
+
+bool SupportsProgramBinaries() {
+    static const bool supported = [] {
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }();
+    return supported;
+}
+
+// Shader files read ahead by Shader::PrefetchSources, by normalized path
+struct PrefetchedSource {
+    std::string Text;
+    std::filesystem::file_time_type WriteTime;
+};
+
+std::mutex s_PrefetchMutex;
+HashMap<String, PrefetchedSource> s_Prefetched;
+
+constexpr std::uintmax_t MaxPrefetchSize = 1u << 20;
+
+String PrefetchKey(const String& filepath) {
+    return std::filesystem::path(filepath).lexically_normal().generic_string();
+}
+
+// The prefetched text of filepath if it is unchanged on disk
+bool TakePrefetched(const String& filepath, std::string& text) {
+    std::lock_guard<std::mutex> lock(s_PrefetchMutex);
+    if (s_Prefetched.empty()) return false;
+
+    auto it = s_Prefetched.find(PrefetchKey(filepath));
+    if (it == s_Prefetched.end()) return false;
+
+    std::error_code error;
+    if (std::filesystem::last_write_time(filepath, error) != it->second.WriteTime || error) return false;
+
+    // Includes are read once per shader including them; keep the copy
+    text = it->second.Text;
+    return true;
+}
+
+// Names the program across sessions in the pipeline manifest: the file and
+// its defines, or the name of a shader built from source strings
+StringId MakePipelineKey(const String& filepath, const String& name, const ShaderDefines& defines) {
+    if (filepath.empty()) return StringId("source:" + name);
+
+    String key = filepath;
+    for (const auto& define : defines) {
+        key += ' ';
+        key += define.Name;
+        if (!define.Value.empty()) {
+            key += '=';
+            key += define.Value;
+        }
+    }
+    return StringId(key);
+}
+
+} // anonymous namespace
+
 static GLenum ShaderTypeFromString(const std::string& type) {
     if (type == "vertex") return GL_VERTEX_SHADER;
     if (type == "fragment" || type == "pixel") return GL_FRAGMENT_SHADER;
@@ -19,17 +148,18 @@ static GLenum ShaderTypeFromString(const std::string& type) {
     return 0;
 }
 
-Shader::Shader(const String& filepath) {
-    std::string source = ReadFile(filepath);
-    auto shaderSources = PreProcess(source);
-    Compile(shaderSources);
-
+Shader::Shader(const String& filepath, const String& binaryCacheDirectory, const ShaderDefines& defines)
+    : m_FilePath(filepath)
+    , m_BinaryCacheDirectory(binaryCacheDirectory)
+    , m_Defines(defines) {
     // Extract name from filepath
     auto lastSlash = filepath.find_last_of("/\\");
     lastSlash = lastSlash == String::npos ? 0 : lastSlash + 1;
     auto lastDot = filepath.rfind('.');
     auto count = lastDot == String::npos ? filepath.size() - lastSlash : lastDot - lastSlash;
     m_Name = filepath.substr(lastSlash, count);
+
+    Reload();
 }
 
 Shader::Shader(const String& name, const String& vertexSrc, const String& fragmentSrc)
@@ -37,15 +167,180 @@ Shader::Shader(const String& name, const String& vertexSrc, const String& fragme
     std::unordered_map<u32, std::string> sources;
     sources[GL_VERTEX_SHADER] = vertexSrc;
     sources[GL_FRAGMENT_SHADER] = fragmentSrc;
-    Compile(sources);
+    BeginCompile(sources);
 }
 
 Shader::~Shader() {
+    DiscardPending();
+    PipelineWarmup::OnProgramDeleted(m_RendererID);
+    GLStateCache::Instance().OnProgramDeleted(m_RendererID);
     glDeleteProgram(m_RendererID);
 }
 
+bool Shader::Reload() {
+    if (m_FilePath.empty()) return false;
+
+    std::string source = ReadFile(m_FilePath);
+    if (source.empty()) return false;
+
+    m_IncludedFiles.clear();
+    m_IncludeGraph.clear();
+    Vector<String> stageIncludes;
+    source = ExpandIncludes(source, m_FilePath, 0, stageIncludes);
+
+    // Defines go right after each stage's #version line
+    std::string defineBlock;
+    for (const auto& define : m_Defines) {
+        defineBlock += "#define " + define.Name + " " + (define.Value.empty() ? "1" : define.Value) + "\n";
+    }
+
+    // One cache file per shader path and define set, overwritten whenever
+    // the key changes. Included files are part of the expanded source.
+    m_CachePath.clear();
+    if (!m_BinaryCacheDirectory.empty() && SupportsProgramBinaries()) {
+        m_CacheKey = HashBytes(source.data(), source.size(), DriverHash());
+        m_CacheKey = HashBytes(defineBlock.data(), defineBlock.size(), m_CacheKey);
+        u64 pathHash = HashBytes(m_FilePath.data(), m_FilePath.size());
+        pathHash = HashBytes(defineBlock.data(), defineBlock.size(), pathHash);
+        m_CachePath = m_BinaryCacheDirectory + "/" + m_Name + "_" +
+                      std::to_string(pathHash & 0xFFFFFFFFull) + ".bin";
+
+        if (u32 program = LoadProgramBinary(m_CachePath, m_CacheKey)) {
+            DiscardPending();
+            AdoptProgram(program);
+            m_FromBinaryCache = true;
+            m_Status = ShaderCompileStatus::Ready;
+            return true;
+        }
+    }
+
+    m_FromBinaryCache = false;
+
+    auto shaderSources = PreProcess(source);
+    if (!defineBlock.empty()) {
+        for (auto& [type, stageSource] : shaderSources) {
+            InsertDefines(stageSource, defineBlock);
+        }
+    }
+    BeginCompile(shaderSources);
+    return true;
+}
+
+std::string Shader::ExpandIncludes(const std::string& source, const String& filepath, u32 depth,
+                                   Vector<String>& stageIncludes) {
+    constexpr u32 MaxIncludeDepth = 16;
+    constexpr std::string_view Directive = "#include";
+    constexpr std::string_view StageToken = "#type";
+
+    std::string result;
+    result.reserve(source.size());
+
+    usize lineStart = 0;
+    while (lineStart < source.size()) {
+        usize lineEnd = source.find('\n', lineStart);
+        if (lineEnd == std::string::npos) lineEnd = source.size();
+        std::string_view line(source.data() + lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+
+        usize first = line.find_first_not_of(" \t");
+        if (first != std::string_view::npos && line.substr(first, StageToken.size()) == StageToken) {
+            // Each stage is its own compile unit and needs its own copy
+            stageIncludes.clear();
+        }
+        if (first == std::string_view::npos || line.substr(first, Directive.size()) != Directive) {
+            result.append(line);
+            result += '\n';
+            continue;
+        }
+
+        usize open = line.find('"', first + Directive.size());
+        usize close = open == std::string_view::npos ? open : line.find('"', open + 1);
+        if (close == std::string_view::npos) {
+            LOG_CORE_ERROR("Shader '{}': malformed #include in {}", m_Name, filepath);
+            result.append(line);
+            result += '\n';
+            continue;
+        }
+
+        // Relative to the including file, then to each directory above it,
+        // so "common/pbr.glsl" resolves from anywhere under assets/shaders
+        std::filesystem::path includeName(std::string(line.substr(open + 1, close - open - 1)));
+        std::filesystem::path includePath;
+        std::error_code error;
+        for (auto directory = std::filesystem::path(filepath).parent_path(); ; directory = directory.parent_path()) {
+            auto candidate = directory / includeName;
+            if (std::filesystem::is_regular_file(candidate, error)) {
+                includePath = candidate.lexically_normal();
+                break;
+            }
+            if (directory.empty() || directory == directory.parent_path()) break;
+        }
+
+        if (includePath.empty()) {
+            LOG_CORE_ERROR("Shader '{}': cannot find include \"{}\" from {}", m_Name, includeName.string(), filepath);
+            continue;
+        }
+        if (depth >= MaxIncludeDepth) {
+            LOG_CORE_ERROR("Shader '{}': includes nested deeper than {} at {}", m_Name, MaxIncludeDepth, filepath);
+            continue;
+        }
+
+        String includeKey = includePath.generic_string();
+        const bool newEdge = std::none_of(m_IncludeGraph.begin(), m_IncludeGraph.end(),
+            [&](const ShaderIncludeEdge& edge) { return edge.Included == includeKey && edge.Includer == filepath; });
+        if (newEdge) {
+            m_IncludeGraph.push_back({filepath, includeKey});
+        }
+
+        // Every file once per stage, like #pragma once
+        if (std::find(stageIncludes.begin(), stageIncludes.end(), includeKey) != stageIncludes.end()) {
+            continue;
+        }
+        stageIncludes.push_back(includeKey);
+        if (std::find(m_IncludedFiles.begin(), m_IncludedFiles.end(), includeKey) == m_IncludedFiles.end()) {
+            m_IncludedFiles.push_back(includeKey);
+        }
+
+        result += ExpandIncludes(ReadFile(includeKey), includeKey, depth + 1, stageIncludes);
+    }
+
+    return result;
+}
+
+void Shader::InsertDefines(std::string& stageSource, const std::string& defineBlock) {
+    // #version must stay the first directive
+    usize version = stageSource.find("#version");
+    usize insertAt = 0;
+    if (version != std::string::npos) {
+        usize lineEnd = stageSource.find('\n', version);
+        insertAt = lineEnd == std::string::npos ? stageSource.size() : lineEnd + 1;
+    }
+    stageSource.insert(insertAt, defineBlock);
+}
+
+ShaderCompileStatus Shader::Poll(bool wait) {
+    if (m_Status != ShaderCompileStatus::Compiling) return m_Status;
+
+    // Without the extension the status query below is what waits
+    if (!wait && SupportsParallelCompile()) {
+        GLint complete = GL_FALSE;
+        glGetProgramiv(m_PendingProgram, CompletionStatusKHR, &complete);
+        if (complete == GL_FALSE) return m_Status;
+    }
+
+    FinishCompile();
+    return m_Status;
+}
+
+bool Shader::IsReady() {
+    Poll(false);
+    return m_RendererID != 0;
+}
+
 std::string Shader::ReadFile(const String& filepath) {
     std::string result;
+    if (TakePrefetched(filepath, result)) return result;
+
     std::ifstream in(filepath, std::ios::in | std::ios::binary);
 
     if (in) {
@@ -61,6 +356,39 @@ std::string Shader::ReadFile(const String& filepath) {
     return result;
 }
 
+void Shader::PrefetchSources(const String& directory) {
+    Vector<std::filesystem::path> files;
+    std::error_code error;
+    for (auto it = std::filesystem::recursive_directory_iterator(directory, error);
+         !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error)) {
+        if (it->is_regular_file(error) && it->file_size(error) <= MaxPrefetchSize) {
+            files.push_back(it->path());
+        }
+    }
+
+    JobSystem::ParallelFor(static_cast<u32>(files.size()), 4, [&files](u32 first, u32 last) {
+        for (u32 i = first; i < last; ++i) {
+            std::error_code fileError;
+            PrefetchedSource source;
+            source.WriteTime = std::filesystem::last_write_time(files[i], fileError);
+            std::ifstream in(files[i], std::ios::in | std::ios::binary);
+            if (fileError || !in) continue;
+
+            source.Text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            const String key = files[i].lexically_normal().generic_string();
+            std::lock_guard<std::mutex> lock(s_PrefetchMutex);
+            s_Prefetched.insert_or_assign(key, std::move(source));
+        }
+    });
+
+    LOG_CORE_INFO("Prefetched {} shader files from {}", files.size(), directory);
+}
+
+void Shader::ReleasePrefetchedSources() {
+    std::lock_guard<std::mutex> lock(s_PrefetchMutex);
+    s_Prefetched = {};
+}
+
 std::unordered_map<u32, std::string> Shader::PreProcess(const std::string& source) {
     std::unordered_map<u32, std::string> shaderSources;
 
@@ -83,10 +411,88 @@ std::unordered_map<u32, std::string> Shader::PreProcess(const std::string& sourc
     return shaderSources;
 }
 
-void Shader::Compile(const std::unordered_map<u32, std::string>& shaderSources) {
+u32 Shader::LoadProgramBinary(const String& cachePath, u64 key) {
+    std::ifstream in(cachePath, std::ios::in | std::ios::binary);
+    if (!in) return 0;
+
+    ProgramBinaryHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || header.Magic != ProgramBinaryMagic || header.Version != ProgramBinaryVersion ||
+        header.Key != key || header.Size == 0) {
+        return 0;
+    }
+
+    std::vector<char> binary(header.Size);
+    in.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+    if (!in) return 0;
+
     GLuint program = glCreateProgram();
-    std::vector<GLuint> shaderIDs;
-    shaderIDs.reserve(shaderSources.size());
+    glProgramBinary(program, header.Format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // The driver may still reject a binary it produced, e.g. after a
+    // change the driver string doesn't show; compile from source then
+    GLint isLinked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+    if (isLinked == GL_FALSE) {
+        glDeleteProgram(program);
+        LOG_CORE_INFO("Shader '{}': cached binary rejected by the driver, recompiling", m_Name);
+        return 0;
+    }
+
+    return program;
+}
+
+void Shader::SaveProgramBinary(const String& cachePath, u64 key) const {
+    GLint length = 0;
+    glGetProgramiv(m_RendererID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    std::vector<char> binary(static_cast<usize>(length));
+    GLenum format = 0;
+    glGetProgramBinary(m_RendererID, length, &length, &format, binary.data());
+    if (length <= 0) return;
+
+    std::error_code error;
+    std::filesystem::path path(cachePath);
+    std::filesystem::create_directories(path.parent_path(), error);
+
+    // Write a temporary and rename it, so an interrupted write can't leave
+    // a truncated entry behind
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_CORE_WARN("Shader '{}': could not write binary cache {}", m_Name, cachePath);
+            return;
+        }
+
+        ProgramBinaryHeader header;
+        header.Magic = ProgramBinaryMagic;
+        header.Version = ProgramBinaryVersion;
+        header.Key = key;
+        header.Format = format;
+        header.Size = static_cast<u32>(length);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(binary.data(), length);
+        if (!out) return;
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+    }
+}
+
+void Shader::BeginCompile(const std::unordered_map<u32, std::string>& shaderSources) {
+    // A compile still in flight is superseded by this one
+    DiscardPending();
+
+    // No status queries here: with KHR_parallel_shader_compile the driver
+    // compiles and links on its own threads until Poll() asks
+    GLuint program = glCreateProgram();
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    m_PendingStages.reserve(shaderSources.size());
 
     for (auto& [type, source] : shaderSources) {
         GLuint shader = glCreateShader(type);
@@ -95,102 +501,206 @@ void Shader::Compile(const std::unordered_map<u32, std::string>& shaderSources)
         glShaderSource(shader, 1, &sourceCStr, nullptr);
         glCompileShader(shader);
 
+        glAttachShader(program, shader);
+        m_PendingStages.push_back(shader);
+    }
+
+    glLinkProgram(program);
+
+    m_PendingProgram = program;
+    m_Status = ShaderCompileStatus::Compiling;
+}
+
+void Shader::FinishCompile() {
+    GLuint program = m_PendingProgram;
+    bool compiled = true;
+
+    for (auto id : m_PendingStages) {
         GLint isCompiled = 0;
-        glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
+        glGetShaderiv(id, GL_COMPILE_STATUS, &isCompiled);
         if (isCompiled == GL_FALSE) {
             GLint maxLength = 0;
-            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &maxLength);
+            glGetShaderiv(id, GL_INFO_LOG_LENGTH, &maxLength);
 
-            std::vector<GLchar> infoLog(maxLength);
-            glGetShaderInfoLog(shader, maxLength, &maxLength, infoLog.data());
-
-            glDeleteShader(shader);
+            std::vector<GLchar> infoLog(static_cast<usize>(std::max(maxLength, 1)));
+            glGetShaderInfoLog(id, maxLength, &maxLength, infoLog.data());
 
             LOG_CORE_ERROR("Shader compilation failed: {}", infoLog.data());
-            return;
+            compiled = false;
         }
-
-        glAttachShader(program, shader);
-        shaderIDs.push_back(shader);
     }
 
-    glLinkProgram(program);
-
     GLint isLinked = 0;
-    glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
-    if (isLinked == GL_FALSE) {
-        GLint maxLength = 0;
-        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &maxLength);
-
-        std::vector<GLchar> infoLog(maxLength);
-        glGetProgramInfoLog(program, maxLength, &maxLength, infoLog.data());
+    if (compiled) {
+        glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+        if (isLinked == GL_FALSE) {
+            GLint maxLength = 0;
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &maxLength);
 
-        glDeleteProgram(program);
+            std::vector<GLchar> infoLog(static_cast<usize>(std::max(maxLength, 1)));
+            glGetProgramInfoLog(program, maxLength, &maxLength, infoLog.data());
 
-        for (auto id : shaderIDs) {
-            glDeleteShader(id);
+            LOG_CORE_ERROR("Shader linking failed: {}", infoLog.data());
         }
+    }
+
+    for (auto id : m_PendingStages) {
+        glDetachShader(program, id);
+        glDeleteShader(id);
+    }
+    m_PendingStages.clear();
+    m_PendingProgram = 0;
 
-        LOG_CORE_ERROR("Shader linking failed: {}", infoLog.data());
+    // On failure the previous program, if any, stays in use
+    if (!compiled || isLinked == GL_FALSE) {
+        glDeleteProgram(program);
+        m_Status = ShaderCompileStatus::Failed;
         return;
     }
 
-    for (auto id : shaderIDs) {
-        glDetachShader(program, id);
+    AdoptProgram(program);
+    m_Status = ShaderCompileStatus::Ready;
+
+    if (!m_CachePath.empty()) {
+        SaveProgramBinary(m_CachePath, m_CacheKey);
+    }
+}
+
+void Shader::DiscardPending() {
+    if (!m_PendingProgram) return;
+
+    for (auto id : m_PendingStages) {
         glDeleteShader(id);
     }
+    m_PendingStages.clear();
+    glDeleteProgram(m_PendingProgram);
+    m_PendingProgram = 0;
+    m_Status = m_RendererID ? ShaderCompileStatus::Ready : ShaderCompileStatus::Failed;
+}
 
+void Shader::AdoptProgram(u32 program) {
+    if (m_RendererID) {
+        PipelineWarmup::OnProgramDeleted(m_RendererID);
+        GLStateCache::Instance().OnProgramDeleted(m_RendererID);
+        glDeleteProgram(m_RendererID);
+    }
     m_RendererID = program;
+    ReflectUniforms();
+    PipelineWarmup::OnProgramLinked(m_RendererID, MakePipelineKey(m_FilePath, m_Name, m_Defines));
 }
 
-void Shader::Bind() const {
-    glUseProgram(m_RendererID);
+void Shader::ReflectUniforms() {
+    m_UniformLocations.clear();
+
+    GLint uniformCount = 0;
+    glGetProgramInterfaceiv(m_RendererID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformCount);
+    GLint maxNameLength = 0;
+    glGetProgramInterfaceiv(m_RendererID, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+
+    std::vector<GLchar> nameBuffer(static_cast<usize>(std::max(maxNameLength, 1)));
+    std::string elementName;
+
+    auto add = [this](const char* name, usize length, i32 location) {
+        const u32 hash = UniformHandle::Hash(name, length);
+        auto [it, inserted] = m_UniformLocations.emplace(hash, location);
+        if (!inserted && it->second != location) {
+            LOG_CORE_WARN("Shader '{}': uniform '{}' collides with another name's hash",
+                          m_Name, std::string_view(name, length));
+        }
+    };
+
+    const GLenum properties[] = { GL_LOCATION, GL_ARRAY_SIZE };
+    for (GLint i = 0; i < uniformCount; ++i) {
+        // Block members have no location and are set through their buffer
+        GLint values[2] = {};
+        glGetProgramResourceiv(m_RendererID, GL_UNIFORM, static_cast<GLuint>(i),
+                               2, properties, 2, nullptr, values);
+        const i32 location = values[0];
+        const i32 arraySize = values[1];
+        if (location < 0) continue;
+
+        GLsizei length = 0;
+        glGetProgramResourceName(m_RendererID, GL_UNIFORM, static_cast<GLuint>(i),
+                                 static_cast<GLsizei>(nameBuffer.size()), &length, nameBuffer.data());
+        std::string_view name(nameBuffer.data(), static_cast<usize>(length));
+
+        // Arrays report "name[0]"; register the bare name and every element,
+        // whose locations follow the first
+        if (name.ends_with("[0]")) {
+            name.remove_suffix(3);
+            add(name.data(), name.size(), location);
+            for (i32 element = 0; element < arraySize; ++element) {
+                elementName.assign(name);
+                elementName += '[';
+                elementName += std::to_string(element);
+                elementName += ']';
+                add(elementName.data(), elementName.size(), location + element);
+            }
+        } else {
+            add(name.data(), name.size(), location);
+        }
+    }
+}
+
+void Shader::Bind() {
+    // Nothing to draw with yet: wait for the first compile. A reload keeps
+    // drawing with the previous program until the new one has linked.
+    Poll(m_RendererID == 0);
+    GLStateCache::Instance().UseProgram(m_RendererID);
 }
 
 void Shader::Unbind() const {
-    glUseProgram(0);
+    GLStateCache::Instance().UseProgram(0);
 }
 
-i32 Shader::GetUniformLocation(const String& name) {
-    if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end()) {
-        return m_UniformLocationCache[name];
-    }
+i32 Shader::GetUniformLocation(UniformHandle uniform) const {
+    // Uniforms the program does not use resolve to -1, which GL ignores
+    auto it = m_UniformLocations.find(uniform.GetHash());
+    return it != m_UniformLocations.end() ? it->second : -1;
+}
+
+void Shader::SetInt(UniformHandle uniform, i32 value) {
+    glUniform1i(GetUniformLocation(uniform), value);
+}
+
+void Shader::SetInt2(UniformHandle uniform, const glm::ivec2& value) {
+    glUniform2i(GetUniformLocation(uniform), value.x, value.y);
+}
 
-    i32 location = glGetUniformLocation(m_RendererID, name.c_str());
-    m_UniformLocationCache[name] = location;
-    return location;
+void Shader::SetUInt(UniformHandle uniform, u32 value) {
+    glUniform1ui(GetUniformLocation(uniform), value);
 }
 
-void Shader::SetInt(const String& name, i32 value) {
-    glUniform1i(GetUniformLocation(name), value);
+void Shader::SetUInt3(UniformHandle uniform, const glm::uvec3& value) {
+    glUniform3ui(GetUniformLocation(uniform), value.x, value.y, value.z);
 }
 
-void Shader::SetIntArray(const String& name, i32* values, u32 count) {
-    glUniform1iv(GetUniformLocation(name), static_cast<GLsizei>(count), values);
+void Shader::SetIntArray(UniformHandle uniform, i32* values, u32 count) {
+    glUniform1iv(GetUniformLocation(uniform), static_cast<GLsizei>(count), values);
 }
 
-void Shader::SetFloat(const String& name, f32 value) {
-    glUniform1f(GetUniformLocation(name), value);
+void Shader::SetFloat(UniformHandle uniform, f32 value) {
+    glUniform1f(GetUniformLocation(uniform), value);
 }
 
-void Shader::SetFloat2(const String& name, const glm::vec2& value) {
-    glUniform2f(GetUniformLocation(name), value.x, value.y);
+void Shader::SetFloat2(UniformHandle uniform, const glm::vec2& value) {
+    glUniform2f(GetUniformLocation(uniform), value.x, value.y);
 }
 
-void Shader::SetFloat3(const String& name, const glm::vec3& value) {
-    glUniform3f(GetUniformLocation(name), value.x, value.y, value.z);
+void Shader::SetFloat3(UniformHandle uniform, const glm::vec3& value) {
+    glUniform3f(GetUniformLocation(uniform), value.x, value.y, value.z);
 }
 
-void Shader::SetFloat4(const String& name, const glm::vec4& value) {
-    glUniform4f(GetUniformLocation(name), value.x, value.y, value.z, value.w);
+void Shader::SetFloat4(UniformHandle uniform, const glm::vec4& value) {
+    glUniform4f(GetUniformLocation(uniform), value.x, value.y, value.z, value.w);
 }
 
-void Shader::SetMat3(const String& name, const glm::mat3& value) {
-    glUniformMatrix3fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+void Shader::SetMat3(UniformHandle uniform, const glm::mat3& value) {
+    glUniformMatrix3fv(GetUniformLocation(uniform), 1, GL_FALSE, glm::value_ptr(value));
 }
 
-void Shader::SetMat4(const String& name, const glm::mat4& value) {
-    glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
+void Shader::SetMat4(UniformHandle uniform, const glm::mat4& value) {
+    glUniformMatrix4fv(GetUniformLocation(uniform), 1, GL_FALSE, glm::value_ptr(value));
 }
 
 } // namespace Engine
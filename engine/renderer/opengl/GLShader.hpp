@@ -6,38 +6,154 @@
 
 namespace Engine {
 
+// Uniform name hashed with FNV-1a. Literals hash at compile time, so
+// Set*("u_Name", ...) does no string work at runtime; names built at runtime
+// hash on the spot without allocating. The name pointer is only used for
+// diagnostics and is valid for the duration of the call.
+class UniformHandle {
+public:
+    template<usize N>
+    consteval UniformHandle(const char (&name)[N])
+        : m_Hash(Hash(name, N - 1)), m_Name(name) {}
+
+    UniformHandle(const String& name)
+        : m_Hash(Hash(name.data(), name.size())), m_Name(name.c_str()) {}
+
+    static constexpr u32 Hash(const char* name, usize length) {
+        u32 hash = 2166136261u;
+        for (usize i = 0; i < length; ++i) {
+            hash ^= static_cast<u8>(name[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    constexpr u32 GetHash() const { return m_Hash; }
+    constexpr const char* GetName() const { return m_Name; }
+
+private:
+    u32 m_Hash;
+    const char* m_Name;
+};
+
+// Preprocessor define added after #version in every stage; an empty value
+// defines the name as 1
+struct ShaderDefine {
+    String Name;
+    String Value;
+};
+
+using ShaderDefines = Vector<ShaderDefine>;
+
+// An #include the preprocessor resolved: Includer - the shader file or an
+// included file - pulls in Included, both paths as they were resolved
+struct ShaderIncludeEdge {
+    String Includer;
+    String Included;
+};
+
+enum class ShaderCompileStatus : u8 {
+    Compiling,  // Compile / link in flight, see Shader::Poll
+    Ready,      // Linked
+    Failed      // Last compile or link failed (a previous program may still be in use)
+};
+
 class Shader {
 public:
-    Shader(const String& filepath);
+    // #include "file" lines are expanded from the including file's
+    // directory or the nearest one above it. With a binary cache directory
+    // the linked program is stored there and loaded instead of compiling
+    // while the source, defines and driver are unchanged.
+    Shader(const String& filepath, const String& binaryCacheDirectory = "", const ShaderDefines& defines = {});
     Shader(const String& name, const String& vertexSrc, const String& fragmentSrc);
     ~Shader();
 
-    void Bind() const;
+    // Binding a shader whose first compile is still running waits for it
+    void Bind();
     void Unbind() const;
 
-    void SetInt(const String& name, i32 value);
-    void SetIntArray(const String& name, i32* values, u32 count);
-    void SetFloat(const String& name, f32 value);
-    void SetFloat2(const String& name, const glm::vec2& value);
-    void SetFloat3(const String& name, const glm::vec3& value);
-    void SetFloat4(const String& name, const glm::vec4& value);
-    void SetMat3(const String& name, const glm::mat3& value);
-    void SetMat4(const String& name, const glm::mat4& value);
+    void SetInt(UniformHandle uniform, i32 value);
+    void SetInt2(UniformHandle uniform, const glm::ivec2& value);
+    void SetIntArray(UniformHandle uniform, i32* values, u32 count);
+    void SetUInt(UniformHandle uniform, u32 value);
+    void SetUInt3(UniformHandle uniform, const glm::uvec3& value);
+    void SetFloat(UniformHandle uniform, f32 value);
+    void SetFloat2(UniformHandle uniform, const glm::vec2& value);
+    void SetFloat3(UniformHandle uniform, const glm::vec3& value);
+    void SetFloat4(UniformHandle uniform, const glm::vec4& value);
+    void SetMat3(UniformHandle uniform, const glm::mat3& value);
+    void SetMat4(UniformHandle uniform, const glm::mat4& value);
 
     const String& GetName() const { return m_Name; }
     u32 GetRendererID() const { return m_RendererID; }
+    bool IsFromBinaryCache() const { return m_FromBinaryCache; }
+
+    // Compiles are started without waiting on the driver. Poll() finishes
+    // one once GL_COMPLETION_STATUS_KHR reports it done (or right away with
+    // wait, or without KHR_parallel_shader_compile).
+    ShaderCompileStatus Poll(bool wait = false);
+    ShaderCompileStatus GetStatus() const { return m_Status; }
+
+    // Has a program to draw with; polls, never waits
+    bool IsReady();
+
+    // Recompile from the source file. The current program stays bound by
+    // Bind() until the new one links; a failed compile keeps it for good.
+    bool Reload();
+    const String& GetFilePath() const { return m_FilePath; }
+    const ShaderDefines& GetDefines() const { return m_Defines; }
+
+    // Files pulled in by #include at the last (re)load, and which file
+    // included each (every edge once, nested includes too)
+    const Vector<String>& GetIncludedFiles() const { return m_IncludedFiles; }
+    const Vector<ShaderIncludeEdge>& GetIncludeGraph() const { return m_IncludeGraph; }
+
+    // Read every file under directory into memory, the reads spread over
+    // the job system, so shaders created while it runs or afterwards take
+    // their source and includes from there instead of the disk. Returns when
+    // the reads are done; safe on any thread. A file changed since it was
+    // read is read again.
+    static void PrefetchSources(const String& directory);
+    static void ReleasePrefetchedSources();
 
 private:
     std::string ReadFile(const String& filepath);
     std::unordered_map<u32, std::string> PreProcess(const std::string& source);
-    void Compile(const std::unordered_map<u32, std::string>& shaderSources);
+    std::string ExpandIncludes(const std::string& source, const String& filepath, u32 depth,
+                               Vector<String>& stageIncludes);
+    static void InsertDefines(std::string& stageSource, const std::string& defineBlock);
+    void BeginCompile(const std::unordered_map<u32, std::string>& shaderSources);
+    void FinishCompile();
+    void DiscardPending();
+    void AdoptProgram(u32 program);
+
+    // Program binary cache; Load returns 0 on any mismatch or driver rejection
+    u32 LoadProgramBinary(const String& cachePath, u64 key);
+    void SaveProgramBinary(const String& cachePath, u64 key) const;
 
-    i32 GetUniformLocation(const String& name);
+    // Fill m_UniformLocations from the linked program's active uniforms
+    void ReflectUniforms();
+    i32 GetUniformLocation(UniformHandle uniform) const;
 
 private:
     u32 m_RendererID = 0;
     String m_Name;
-    mutable std::unordered_map<String, i32> m_UniformLocationCache;
+    String m_FilePath;
+    String m_BinaryCacheDirectory;
+    ShaderDefines m_Defines;
+    Vector<String> m_IncludedFiles;
+    Vector<ShaderIncludeEdge> m_IncludeGraph;
+    String m_CachePath;
+    u64 m_CacheKey = 0;
+    bool m_FromBinaryCache = false;
+
+    // Program being compiled; m_RendererID keeps the last one that linked
+    ShaderCompileStatus m_Status = ShaderCompileStatus::Failed;
+    u32 m_PendingProgram = 0;
+    Vector<u32> m_PendingStages;
+
+    // Name hash -> location of every active uniform, array elements included
+    HashMap<u32, i32> m_UniformLocations;
 };
 
 } // namespace Engine
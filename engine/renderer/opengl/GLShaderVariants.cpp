@@ -0,0 +1,77 @@
+#include "GLShaderVariants.hpp"
+#include "core/Logger.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace Engine {
+
+ShaderVariants::ShaderVariants(const String& filepath, Vector<ShaderKeyword> keywords,
+                               const String& binaryCacheDirectory)
+    : m_FilePath(filepath)
+    , m_BinaryCacheDirectory(binaryCacheDirectory)
+    , m_Keywords(std::move(keywords)) {
+    u32 shift = 0;
+    m_Bits.reserve(m_Keywords.size());
+    for (const auto& keyword : m_Keywords) {
+        KeywordBits bits;
+        bits.ValueCount = keyword.Values.empty() ? 2u : static_cast<u32>(keyword.Values.size());
+        u32 width = static_cast<u32>(std::bit_width(bits.ValueCount - 1));
+        bits.Shift = shift;
+        bits.Mask = ((1u << width) - 1u) << shift;
+        shift += width;
+        m_Bits.push_back(bits);
+    }
+
+    if (shift > 32) {
+        LOG_CORE_ERROR("ShaderVariants '{}': keywords need {} key bits, only 32 available", filepath, shift);
+    }
+}
+
+ShaderVariantKey ShaderVariants::Select(ShaderVariantKey key, u32 keyword, u32 value) const {
+    if (keyword >= m_Bits.size()) return key;
+
+    const KeywordBits& bits = m_Bits[keyword];
+    value = std::min(value, bits.ValueCount - 1);
+    return (key & ~bits.Mask) | ((value << bits.Shift) & bits.Mask);
+}
+
+const Ref<Shader>& ShaderVariants::Get(ShaderVariantKey key) {
+    auto it = m_Variants.find(key);
+    if (it != m_Variants.end()) return it->second;
+
+    auto shader = CreateRef<Shader>(m_FilePath, m_BinaryCacheDirectory, BuildDefines(key));
+    LOG_CORE_DEBUG("ShaderVariants '{}': compiling variant {:#x}", m_FilePath, key);
+    return m_Variants.emplace(key, std::move(shader)).first->second;
+}
+
+void ShaderVariants::Prewarm(std::initializer_list<ShaderVariantKey> keys) {
+    for (ShaderVariantKey key : keys) {
+        Get(key);
+    }
+}
+
+void ShaderVariants::ReloadAll() {
+    for (auto& [key, shader] : m_Variants) {
+        shader->Reload();
+    }
+}
+
+ShaderDefines ShaderVariants::BuildDefines(ShaderVariantKey key) const {
+    ShaderDefines defines;
+    for (usize i = 0; i < m_Keywords.size(); ++i) {
+        const ShaderKeyword& keyword = m_Keywords[i];
+        u32 value = (key & m_Bits[i].Mask) >> m_Bits[i].Shift;
+
+        if (keyword.Values.empty()) {
+            if (value != 0) {
+                defines.push_back({keyword.Name, ""});
+            }
+        } else {
+            defines.push_back({keyword.Name, keyword.Values[std::min<usize>(value, keyword.Values.size() - 1)]});
+        }
+    }
+    return defines;
+}
+
+} // namespace Engine
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include <initializer_list>
+
+namespace Engine {
+
+// A keyword of a ShaderVariants set. Without values it is a switch, defined
+// (as 1) when on and left undefined when off; otherwise it is defined to the
+// selected value.
+struct ShaderKeyword {
+    String Name;
+    Vector<String> Values;
+};
+
+// Which value every keyword takes, a few bits per keyword. 0 selects the
+// first value (or off) for all of them.
+using ShaderVariantKey = u32;
+
+// ShaderVariants - one shader file compiled once per keyword combination.
+//
+// Instead of branching at runtime on a uniform, the shader tests the
+// keyword with #ifdef / #if and each combination becomes its own program.
+// Variants compile the first time their key is asked for, so only
+// combinations that are actually drawn cost anything.
+class ShaderVariants {
+public:
+    ShaderVariants(const String& filepath, Vector<ShaderKeyword> keywords, const String& binaryCacheDirectory = "");
+
+    ShaderVariants(const ShaderVariants&) = delete;
+    ShaderVariants& operator=(const ShaderVariants&) = delete;
+
+    // key with keyword (index in the constructor list) set to value
+    ShaderVariantKey Select(ShaderVariantKey key, u32 keyword, u32 value) const;
+    ShaderVariantKey Select(ShaderVariantKey key, u32 keyword, bool enabled) const {
+        return Select(key, keyword, enabled ? 1u : 0u);
+    }
+
+    // Starts the compile on first use (see Shader::Poll). The reference
+    // lasts until the next new variant; the Shader as long as this object.
+    const Ref<Shader>& Get(ShaderVariantKey key);
+
+    // Start compiling variants before they are first drawn
+    void Prewarm(std::initializer_list<ShaderVariantKey> keys);
+
+    // Recompile every variant created so far
+    void ReloadAll();
+
+    const String& GetFilePath() const { return m_FilePath; }
+    u32 GetVariantCount() const { return static_cast<u32>(m_Variants.size()); }
+
+private:
+    struct KeywordBits {
+        u32 Shift = 0;
+        u32 Mask = 0;
+        u32 ValueCount = 0;
+    };
+
+    ShaderDefines BuildDefines(ShaderVariantKey key) const;
+
+private:
+    String m_FilePath;
+    String m_BinaryCacheDirectory;
+    Vector<ShaderKeyword> m_Keywords;
+    Vector<KeywordBits> m_Bits;
+    HashMap<ShaderVariantKey, Ref<Shader>> m_Variants;
+};
+
+} // namespace Engine
@@ -0,0 +1,252 @@
+#include "renderer/opengl/GLStateCache.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+#include <iterator>
+
+namespace Engine {
+
+namespace {
+
+// Order of GLStateCache::m_TargetBuffers
+constexpr u32 TrackedTargets[] = {
+    GL_ARRAY_BUFFER,
+    GL_DRAW_INDIRECT_BUFFER,
+    GL_DISPATCH_INDIRECT_BUFFER,
+    GL_PIXEL_PACK_BUFFER,
+    GL_PIXEL_UNPACK_BUFFER
+};
+
+void SetCapability(GLenum capability, bool enabled) {
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+}
+
+} // anonymous namespace
+
+GLStateCache& GLStateCache::Instance() {
+    static GLStateCache instance;
+    return instance;
+}
+
+GLStateCache::GLStateCache() {
+    Invalidate();
+}
+
+void GLStateCache::BeginFrame() {
+    m_LastFrameStats = m_FrameStats;
+    m_FrameStats = {};
+}
+
+void GLStateCache::Invalidate() {
+    static_assert(std::size(TrackedTargets) == TrackedTargetCount, "TrackedTargetCount must match TrackedTargets");
+
+    m_Known = 0;
+    ++m_PipelineGeneration;
+    m_Program = Unknown;
+    m_VertexArray = Unknown;
+    std::fill(std::begin(m_TextureUnits), std::end(m_TextureUnits), Unknown);
+    std::fill(std::begin(m_UniformBuffers), std::end(m_UniformBuffers), BufferBinding{});
+    std::fill(std::begin(m_StorageBuffers), std::end(m_StorageBuffers), BufferBinding{});
+    std::fill(std::begin(m_TargetBuffers), std::end(m_TargetBuffers), Unknown);
+}
+
+bool GLStateCache::IsCurrent(u32 bit, bool matches) {
+    if ((m_Known & bit) && matches) {
+        ++m_FrameStats.Skipped;
+        return true;
+    }
+    m_Known |= bit;
+    ++m_FrameStats.Issued;
+    ++m_PipelineGeneration;
+    return false;
+}
+
+bool GLStateCache::IsBound(u32& cached, u32 value) {
+    if (cached == value) {
+        ++m_FrameStats.Skipped;
+        return true;
+    }
+    cached = value;
+    ++m_FrameStats.Issued;
+    return false;
+}
+
+void GLStateCache::Apply(const RenderState& state) {
+    SetDepthTest(state.DepthTest);
+    SetDepthWrite(state.DepthWrite);
+    SetDepthFunc(state.DepthFunc);
+    SetBlend(state.Blend);
+    if (state.Blend) {
+        // The function doesn't matter while blending is off
+        SetBlendFunc(state.BlendSource, state.BlendDestination);
+    }
+    SetCullFace(state.CullFace);
+}
+
+void GLStateCache::SetDepthTest(bool enabled) {
+    if (IsCurrent(DepthTestBit, m_State.DepthTest == enabled)) return;
+    m_State.DepthTest = enabled;
+    SetCapability(GL_DEPTH_TEST, enabled);
+}
+
+void GLStateCache::SetDepthWrite(bool enabled) {
+    if (IsCurrent(DepthWriteBit, m_State.DepthWrite == enabled)) return;
+    m_State.DepthWrite = enabled;
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+void GLStateCache::SetDepthFunc(u32 func) {
+    if (IsCurrent(DepthFuncBit, m_State.DepthFunc == func)) return;
+    m_State.DepthFunc = func;
+    glDepthFunc(func);
+}
+
+void GLStateCache::SetBlend(bool enabled) {
+    if (IsCurrent(BlendBit, m_State.Blend == enabled)) return;
+    m_State.Blend = enabled;
+    SetCapability(GL_BLEND, enabled);
+}
+
+void GLStateCache::SetBlendFunc(u32 source, u32 destination) {
+    if (IsCurrent(BlendFuncBit, m_State.BlendSource == source && m_State.BlendDestination == destination)) return;
+    m_State.BlendSource = source;
+    m_State.BlendDestination = destination;
+    glBlendFunc(source, destination);
+}
+
+void GLStateCache::SetBlendFuncIndexed(u32 drawBuffer, u32 source, u32 destination) {
+    m_Known &= ~BlendFuncBit;
+    ++m_FrameStats.Issued;
+    ++m_PipelineGeneration;
+    glBlendFunci(drawBuffer, source, destination);
+}
+
+void GLStateCache::SetCullFace(bool enabled) {
+    if (IsCurrent(CullFaceBit, m_State.CullFace == enabled)) return;
+    m_State.CullFace = enabled;
+    SetCapability(GL_CULL_FACE, enabled);
+}
+
+void GLStateCache::Restore(const Snapshot& snapshot) {
+    const RenderState& state = snapshot.State;
+    if (snapshot.Known & DepthTestBit) SetDepthTest(state.DepthTest);
+    if (snapshot.Known & DepthWriteBit) SetDepthWrite(state.DepthWrite);
+    if (snapshot.Known & DepthFuncBit) SetDepthFunc(state.DepthFunc);
+    if (snapshot.Known & BlendBit) SetBlend(state.Blend);
+    if (snapshot.Known & BlendFuncBit) SetBlendFunc(state.BlendSource, state.BlendDestination);
+    if (snapshot.Known & CullFaceBit) SetCullFace(state.CullFace);
+}
+
+void GLStateCache::UseProgram(u32 program) {
+    if (IsBound(m_Program, program)) return;
+    ++m_PipelineGeneration;
+    glUseProgram(program);
+}
+
+void GLStateCache::BindVertexArray(u32 vertexArray) {
+    if (IsBound(m_VertexArray, vertexArray)) return;
+    ++m_PipelineGeneration;
+    glBindVertexArray(vertexArray);
+}
+
+void GLStateCache::BindTextureUnit(u32 unit, u32 texture) {
+    if (unit < MaxTextureUnits) {
+        if (IsBound(m_TextureUnits[unit], texture)) return;
+    } else {
+        ++m_FrameStats.Issued;
+    }
+    glBindTextureUnit(unit, texture);
+}
+
+GLStateCache::BufferBinding* GLStateCache::FindIndexedBinding(u32 target, u32 index) {
+    if (index >= MaxBufferBindings) return nullptr;
+    if (target == GL_UNIFORM_BUFFER) return &m_UniformBuffers[index];
+    if (target == GL_SHADER_STORAGE_BUFFER) return &m_StorageBuffers[index];
+    return nullptr;
+}
+
+const GLStateCache::BufferBinding* GLStateCache::FindIndexedBinding(u32 target, u32 index) const {
+    return const_cast<GLStateCache*>(this)->FindIndexedBinding(target, index);
+}
+
+u32 GLStateCache::GetBoundBuffer(u32 target, u32 index) const {
+    const BufferBinding* binding = FindIndexedBinding(target, index);
+    return binding && binding->Buffer != Unknown ? binding->Buffer : 0;
+}
+
+u32* GLStateCache::FindTargetBinding(u32 target) {
+    for (u32 i = 0; i < TrackedTargetCount; ++i) {
+        if (TrackedTargets[i] == target) return &m_TargetBuffers[i];
+    }
+    return nullptr;
+}
+
+void GLStateCache::BindBufferBase(u32 target, u32 index, u32 buffer) {
+    BindBufferRange(target, index, buffer, 0, 0);
+}
+
+void GLStateCache::BindBufferRange(u32 target, u32 index, u32 buffer, usize offset, usize size) {
+    if (BufferBinding* binding = FindIndexedBinding(target, index)) {
+        if (binding->Buffer == buffer && binding->Offset == offset && binding->Size == size) {
+            ++m_FrameStats.Skipped;
+            return;
+        }
+        *binding = {buffer, offset, size};
+    }
+    ++m_FrameStats.Issued;
+
+    if (size == 0) {
+        glBindBufferBase(target, index, buffer);
+    } else {
+        glBindBufferRange(target, index, buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+    }
+}
+
+void GLStateCache::BindBuffer(u32 target, u32 buffer) {
+    u32* binding = FindTargetBinding(target);
+    if (binding && IsBound(*binding, buffer)) return;
+    if (!binding) ++m_FrameStats.Issued;
+    glBindBuffer(target, buffer);
+}
+
+void GLStateCache::OnProgramDeleted(u32 program) {
+    // A deleted program stays in use until another one is; a new program
+    // with the recycled name must still be bound
+    if (m_Program == program) m_Program = Unknown;
+}
+
+void GLStateCache::OnVertexArrayDeleted(u32 vertexArray) {
+    if (m_VertexArray == vertexArray) m_VertexArray = Unknown;
+}
+
+void GLStateCache::OnBuffersDeleted(i32 count, const u32* buffers) {
+    for (i32 i = 0; i < count; ++i) {
+        const u32 buffer = buffers[i];
+        if (buffer == 0) continue;
+
+        for (auto& binding : m_UniformBuffers) {
+            if (binding.Buffer == buffer) binding = {};
+        }
+        for (auto& binding : m_StorageBuffers) {
+            if (binding.Buffer == buffer) binding = {};
+        }
+        for (auto& binding : m_TargetBuffers) {
+            if (binding == buffer) binding = Unknown;
+        }
+    }
+}
+
+void GLStateCache::OnTexturesDeleted(i32 count, const u32* textures) {
+    for (i32 i = 0; i < count; ++i) {
+        if (textures[i] == 0) continue;
+        for (auto& unit : m_TextureUnits) {
+            if (unit == textures[i]) unit = Unknown;
+        }
+    }
+}
+
+} // namespace Engine
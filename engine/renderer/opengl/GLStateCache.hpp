@@ -0,0 +1,180 @@
+#pragma once
+
+#include "core/Types.hpp"
+
+namespace Engine {
+
+// RenderState - the fixed-function state a pass draws with. Defaults are
+// opaque geometry: depth tested and written with GL_LESS, back faces
+// culled, no blending. GL enums are stored as u32 so this header doesn't
+// need glad. Culling always removes back faces, GL's default glCullFace
+// mode, which the renderer never changes; CullFace only switches it on and
+// off.
+struct RenderState {
+    bool DepthTest = true;
+    bool DepthWrite = true;
+    u32 DepthFunc = 0x0201;         // GL_LESS
+    bool Blend = false;
+    u32 BlendSource = 0x0302;       // GL_SRC_ALPHA
+    u32 BlendDestination = 0x0303;  // GL_ONE_MINUS_SRC_ALPHA
+    bool CullFace = true;
+};
+
+// GLStateCache - shadow copy of the GL context state the renderer changes
+// between passes, so only actual changes reach the driver.
+//
+// Covers the RenderState fields plus the bound program, vertex array,
+// texture units, uniform / storage buffer bindings and the non-indexed
+// buffer targets used for indirect draws and readbacks. Every setter
+// compares against the shadow and returns early when GL already has that
+// value; passes that must put state back take a Snapshot (ScopedState)
+// instead of reading it with glGet*, which stalls until the driver's
+// command queue catches up.
+//
+// A value is unknown until first set, and again after Invalidate() (for
+// code that changed GL state behind the cache's back). Unknown values are
+// always sent and never restored. Deleting an object through GLMemory,
+// Shader or VertexArray forgets its bindings, so a recycled name is bound
+// again.
+//
+// GL thread only: the render thread when rendering is threaded.
+class GLStateCache {
+public:
+    static constexpr u32 MaxTextureUnits = 32;
+    static constexpr u32 MaxBufferBindings = 16;   // Per indexed target
+
+    struct Snapshot {
+        RenderState State;
+        u32 Known = 0;              // StateBits holding a tracked value
+    };
+
+    // Restores the fixed-function state seen at construction on destruction
+    class ScopedState {
+    public:
+        ScopedState() : m_Saved(GLStateCache::Instance().GetSnapshot()) {}
+        ~ScopedState() { GLStateCache::Instance().Restore(m_Saved); }
+
+        ScopedState(const ScopedState&) = delete;
+        ScopedState& operator=(const ScopedState&) = delete;
+
+    private:
+        Snapshot m_Saved;
+    };
+
+    // GL calls issued and skipped as redundant over a frame
+    struct Stats {
+        u32 Issued = 0;
+        u32 Skipped = 0;
+    };
+
+    static GLStateCache& Instance();
+
+    // Start a frame: the counts so far become GetFrameStats()
+    void BeginFrame();
+    const Stats& GetFrameStats() const { return m_LastFrameStats; }
+
+    // Fixed function
+    void Apply(const RenderState& state);
+    void SetDepthTest(bool enabled);
+    void SetDepthWrite(bool enabled);
+    void SetDepthFunc(u32 func);
+    void SetBlend(bool enabled);
+    void SetBlendFunc(u32 source, u32 destination);
+    void SetCullFace(bool enabled);
+
+    // Blend function of one draw buffer (glBlendFunci). Always sent; the
+    // shared function becomes unknown, so the next SetBlendFunc() or
+    // Restore() sets every draw buffer again.
+    void SetBlendFuncIndexed(u32 drawBuffer, u32 source, u32 destination);
+
+    Snapshot GetSnapshot() const { return {m_State, m_Known}; }
+
+    // Bumped whenever the program, vertex array or fixed-function state
+    // reaches GL, or the cache is invalidated; equal values mean the draw
+    // pipeline hasn't changed in between
+    u32 GetPipelineGeneration() const { return m_PipelineGeneration; }
+
+    // Re-apply the known values of a snapshot
+    void Restore(const Snapshot& snapshot);
+
+    // Bindings
+    void UseProgram(u32 program);
+    void BindVertexArray(u32 vertexArray);
+    void BindTextureUnit(u32 unit, u32 texture);
+
+    // GL_UNIFORM_BUFFER / GL_SHADER_STORAGE_BUFFER bindings are tracked,
+    // other indexed targets go straight through. Size 0 binds the whole
+    // buffer.
+    void BindBufferBase(u32 target, u32 index, u32 buffer);
+    void BindBufferRange(u32 target, u32 index, u32 buffer, usize offset, usize size);
+
+    // Non-indexed targets (draw / dispatch indirect, pixel pack / unpack,
+    // array buffer). GL_ELEMENT_ARRAY_BUFFER belongs to the bound vertex
+    // array and is not tracked.
+    void BindBuffer(u32 target, u32 buffer);
+
+    // Bound program / vertex array; 0 when none or unknown
+    u32 GetProgram() const { return m_Program == Unknown ? 0 : m_Program; }
+    u32 GetVertexArray() const { return m_VertexArray == Unknown ? 0 : m_VertexArray; }
+
+    // Buffer at index of GL_UNIFORM_BUFFER / GL_SHADER_STORAGE_BUFFER; 0 when
+    // none, unknown or untracked
+    u32 GetBoundBuffer(u32 target, u32 index) const;
+
+    // Forget everything; the next setters reach GL unconditionally
+    void Invalidate();
+
+    // Called before the objects are deleted
+    void OnProgramDeleted(u32 program);
+    void OnVertexArrayDeleted(u32 vertexArray);
+    void OnBuffersDeleted(i32 count, const u32* buffers);
+    void OnTexturesDeleted(i32 count, const u32* textures);
+
+private:
+    enum StateBit : u32 {
+        DepthTestBit  = 1 << 0,
+        DepthWriteBit = 1 << 1,
+        DepthFuncBit  = 1 << 2,
+        BlendBit      = 1 << 3,
+        BlendFuncBit  = 1 << 4,
+        CullFaceBit   = 1 << 5
+    };
+
+    static constexpr u32 Unknown = 0xFFFFFFFFu;
+    static constexpr u32 TrackedTargetCount = 5;
+
+    struct BufferBinding {
+        u32 Buffer = Unknown;
+        usize Offset = 0;
+        usize Size = 0;
+    };
+
+    GLStateCache();
+
+    // True if bit is known and already matches; otherwise marks it known
+    bool IsCurrent(u32 bit, bool matches);
+
+    // True if cached already equals value (counted as skipped); otherwise stores it
+    bool IsBound(u32& cached, u32 value);
+
+    BufferBinding* FindIndexedBinding(u32 target, u32 index);
+    const BufferBinding* FindIndexedBinding(u32 target, u32 index) const;
+    u32* FindTargetBinding(u32 target);
+
+private:
+    RenderState m_State;
+    u32 m_Known = 0;
+    u32 m_PipelineGeneration = 0;
+
+    u32 m_Program = Unknown;
+    u32 m_VertexArray = Unknown;
+    u32 m_TextureUnits[MaxTextureUnits];
+    BufferBinding m_UniformBuffers[MaxBufferBindings];
+    BufferBinding m_StorageBuffers[MaxBufferBindings];
+    u32 m_TargetBuffers[TrackedTargetCount];
+
+    Stats m_FrameStats;
+    Stats m_LastFrameStats;
+};
+
+} // namespace Engine
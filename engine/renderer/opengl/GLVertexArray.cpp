@@ -1,5 +1,8 @@
 #include "GLVertexArray.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
 #include <glad/gl.h>
+#include <algorithm>
 
 namespace Engine {
 
@@ -15,104 +18,248 @@ static GLenum ShaderDataTypeToOpenGLBaseType(ShaderDataType type) {
         case ShaderDataType::Int2:   return GL_INT;
         case ShaderDataType::Int3:   return GL_INT;
         case ShaderDataType::Int4:   return GL_INT;
+        case ShaderDataType::UInt:   return GL_UNSIGNED_INT;
         case ShaderDataType::Bool:   return GL_BOOL;
+        case ShaderDataType::UShort4Norm: return GL_UNSIGNED_SHORT;
+        case ShaderDataType::Short4Norm:  return GL_SHORT;
+        case ShaderDataType::Half2:       return GL_HALF_FLOAT;
         default: return 0;
     }
 }
 
+u64 VertexFormat::Hash() const {
+    if (Attributes.empty()) return 0;
+
+    // FNV-1a over the fields
+    u64 hash = 14695981039346656037ull;
+    auto mix = [&hash](u32 value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+    for (const auto& attribute : Attributes) {
+        mix(attribute.Location);
+        mix(attribute.Binding);
+        mix(attribute.Type);
+        mix(attribute.Components);
+        mix(attribute.Offset);
+        mix((attribute.Normalized ? 1u : 0u) | (attribute.Integer ? 2u : 0u));
+    }
+    for (const auto& binding : Bindings) {
+        mix(binding.Index);
+        mix(binding.Stride);
+        mix(binding.Divisor);
+    }
+    return hash ? hash : 1;
+}
+
 VertexArray::VertexArray() {
     glCreateVertexArrays(1, &m_RendererID);
 }
 
+VertexArray::VertexArray(const VertexFormat& format, u32 bufferID) : VertexArray() {
+    for (const auto& binding : format.Bindings) {
+        glVertexArrayVertexBuffer(m_RendererID, binding.Index, bufferID, 0, static_cast<GLsizei>(binding.Stride));
+        if (binding.Divisor) {
+            glVertexArrayBindingDivisor(m_RendererID, binding.Index, binding.Divisor);
+        }
+        RecordBinding(binding.Index, binding.Stride, binding.Divisor);
+    }
+    for (const auto& attribute : format.Attributes) {
+        SetAttributeFormat(attribute);
+    }
+    PipelineWarmup::OnVertexFormatChanged(m_RendererID, m_Format);
+}
+
 VertexArray::~VertexArray() {
+    PipelineWarmup::OnVertexArrayDeleted(m_RendererID);
+    GLStateCache::Instance().OnVertexArrayDeleted(m_RendererID);
     glDeleteVertexArrays(1, &m_RendererID);
 }
 
 void VertexArray::Bind() const {
-    glBindVertexArray(m_RendererID);
+    RefreshStreamOffsets();
+    GLStateCache::Instance().BindVertexArray(m_RendererID);
 }
 
 void VertexArray::Unbind() const {
-    glBindVertexArray(0);
+    GLStateCache::Instance().BindVertexArray(0);
 }
 
-void VertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) {
-    glBindVertexArray(m_RendererID);
-    vertexBuffer->Bind();
+u32 VertexArray::SpecifyAttribute(const BufferElement& element, u32 location, u32 binding) {
+    VertexFormat::Attribute attribute;
+    attribute.Location = location;
+    attribute.Binding = binding;
+    attribute.Type = ShaderDataTypeToOpenGLBaseType(element.Type);
+    attribute.Components = element.GetComponentCount();
+    attribute.Offset = element.Offset;
+    attribute.Normalized = element.Normalized;
+
+    switch (element.Type) {
+        case ShaderDataType::UShort4Norm:
+        case ShaderDataType::Short4Norm:
+            attribute.Normalized = true;
+            SetAttributeFormat(attribute);
+            return location + 1;
+        case ShaderDataType::Float:
+        case ShaderDataType::Float2:
+        case ShaderDataType::Float3:
+        case ShaderDataType::Float4:
+        case ShaderDataType::Half2:
+            SetAttributeFormat(attribute);
+            return location + 1;
+        case ShaderDataType::Int:
+        case ShaderDataType::Int2:
+        case ShaderDataType::Int3:
+        case ShaderDataType::Int4:
+        case ShaderDataType::UInt:
+        case ShaderDataType::Bool:
+            attribute.Integer = true;
+            SetAttributeFormat(attribute);
+            return location + 1;
+        case ShaderDataType::Mat3:
+        case ShaderDataType::Mat4: {
+            // One vec3 / vec4 attribute per column
+            u32 rows = element.Type == ShaderDataType::Mat3 ? 3 : 4;
+            attribute.Components = rows;
+            for (u32 i = 0; i < rows; i++) {
+                attribute.Location = location;
+                attribute.Offset = element.Offset + static_cast<u32>(sizeof(f32)) * rows * i;
+                SetAttributeFormat(attribute);
+                location++;
+            }
+            return location;
+        }
+        default:
+            return location;
+    }
+}
 
+void VertexArray::SetAttributeFormat(const VertexFormat::Attribute& attribute) {
+    glEnableVertexArrayAttrib(m_RendererID, attribute.Location);
+    if (attribute.Integer) {
+        glVertexArrayAttribIFormat(m_RendererID, attribute.Location, static_cast<GLint>(attribute.Components),
+                                   attribute.Type, attribute.Offset);
+    } else {
+        glVertexArrayAttribFormat(m_RendererID, attribute.Location, static_cast<GLint>(attribute.Components),
+                                  attribute.Type, attribute.Normalized ? GL_TRUE : GL_FALSE, attribute.Offset);
+    }
+    glVertexArrayAttribBinding(m_RendererID, attribute.Location, attribute.Binding);
+
+    auto& attributes = m_Format.Attributes;
+    auto it = std::lower_bound(attributes.begin(), attributes.end(), attribute.Location,
+                               [](const VertexFormat::Attribute& a, u32 location) { return a.Location < location; });
+    if (it != attributes.end() && it->Location == attribute.Location) {
+        *it = attribute;
+    } else {
+        attributes.insert(it, attribute);
+    }
+}
+
+void VertexArray::RecordBinding(u32 binding, u32 stride, u32 divisor) {
+    auto& bindings = m_Format.Bindings;
+    auto it = std::lower_bound(bindings.begin(), bindings.end(), binding,
+                               [](const VertexFormat::Binding& b, u32 index) { return b.Index < index; });
+    if (it != bindings.end() && it->Index == binding) {
+        *it = {binding, stride, divisor};
+    } else {
+        bindings.insert(it, {binding, stride, divisor});
+    }
+}
+
+void VertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) {
+    // One binding per vertex buffer; attribute locations continue across buffers
+    const u32 binding = static_cast<u32>(m_VertexBuffers.size());
     const auto& layout = vertexBuffer->GetLayout();
+    const GLsizei stride = static_cast<GLsizei>(layout.GetStride());
+
+    glVertexArrayVertexBuffer(m_RendererID, binding, vertexBuffer->GetRendererID(),
+                              vertexBuffer->GetOffset(), stride);
+
+    bool perInstance = false;
     for (const auto& element : layout) {
-        switch (element.Type) {
-            case ShaderDataType::Float:
-            case ShaderDataType::Float2:
-            case ShaderDataType::Float3:
-            case ShaderDataType::Float4: {
-                glEnableVertexAttribArray(m_VertexBufferIndex);
-                glVertexAttribPointer(m_VertexBufferIndex,
-                    static_cast<GLint>(element.GetComponentCount()),
-                    ShaderDataTypeToOpenGLBaseType(element.Type),
-                    element.Normalized ? GL_TRUE : GL_FALSE,
-                    static_cast<GLsizei>(layout.GetStride()),
-                    reinterpret_cast<const void*>(static_cast<uintptr_t>(element.Offset)));
-                m_VertexBufferIndex++;
-                break;
-            }
-            case ShaderDataType::Int:
-            case ShaderDataType::Int2:
-            case ShaderDataType::Int3:
-            case ShaderDataType::Int4:
-            case ShaderDataType::Bool: {
-                glEnableVertexAttribArray(m_VertexBufferIndex);
-                glVertexAttribIPointer(m_VertexBufferIndex,
-                    static_cast<GLint>(element.GetComponentCount()),
-                    ShaderDataTypeToOpenGLBaseType(element.Type),
-                    static_cast<GLsizei>(layout.GetStride()),
-                    reinterpret_cast<const void*>(static_cast<uintptr_t>(element.Offset)));
-                m_VertexBufferIndex++;
-                break;
-            }
-            case ShaderDataType::Mat3: {
-                u32 rows = 3;
-                for (u32 i = 0; i < rows; i++) {
-                    glEnableVertexAttribArray(m_VertexBufferIndex);
-                    glVertexAttribPointer(m_VertexBufferIndex,
-                        rows,
-                        ShaderDataTypeToOpenGLBaseType(element.Type),
-                        element.Normalized ? GL_TRUE : GL_FALSE,
-                        static_cast<GLsizei>(layout.GetStride()),
-                        reinterpret_cast<const void*>(static_cast<uintptr_t>(element.Offset + sizeof(f32) * rows * i)));
-                    glVertexAttribDivisor(m_VertexBufferIndex, 1);
-                    m_VertexBufferIndex++;
-                }
-                break;
-            }
-            case ShaderDataType::Mat4: {
-                u32 rows = 4;
-                for (u32 i = 0; i < rows; i++) {
-                    glEnableVertexAttribArray(m_VertexBufferIndex);
-                    glVertexAttribPointer(m_VertexBufferIndex,
-                        rows,
-                        ShaderDataTypeToOpenGLBaseType(element.Type),
-                        element.Normalized ? GL_TRUE : GL_FALSE,
-                        static_cast<GLsizei>(layout.GetStride()),
-                        reinterpret_cast<const void*>(static_cast<uintptr_t>(element.Offset + sizeof(f32) * rows * i)));
-                    glVertexAttribDivisor(m_VertexBufferIndex, 1);
-                    m_VertexBufferIndex++;
-                }
-                break;
-            }
-            default:
-                break;
+        if (element.Location >= 0) {
+            m_VertexBufferIndex = static_cast<u32>(element.Location);
+        }
+        m_VertexBufferIndex = SpecifyAttribute(element, m_VertexBufferIndex, binding);
+
+        if (element.Type == ShaderDataType::Mat3 || element.Type == ShaderDataType::Mat4) {
+            perInstance = true;
         }
     }
 
+    // Divisors are per binding with DSA: a buffer holding matrices is per instance
+    if (perInstance) {
+        glVertexArrayBindingDivisor(m_RendererID, binding, 1);
+    }
+    RecordBinding(binding, static_cast<u32>(stride), perInstance ? 1 : 0);
+    PipelineWarmup::OnVertexFormatChanged(m_RendererID, m_Format);
+
     m_VertexBuffers.push_back(vertexBuffer);
+    m_BoundOffsets.push_back(vertexBuffer->GetOffset());
 }
 
 void VertexArray::SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer) {
-    glBindVertexArray(m_RendererID);
-    indexBuffer->Bind();
+    glVertexArrayElementBuffer(m_RendererID, indexBuffer->GetRendererID());
     m_IndexBuffer = indexBuffer;
 }
 
+void VertexArray::SetInstanceIndexBuffer(u32 bufferID, u32 location) {
+    if (m_InstanceIndexBuffer == bufferID && m_InstanceIndexLocation == location) return;
+
+    glVertexArrayVertexBuffer(m_RendererID, InstanceIndexBinding, bufferID, 0, sizeof(u32));
+    glVertexArrayBindingDivisor(m_RendererID, InstanceIndexBinding, 1);
+    RecordBinding(InstanceIndexBinding, sizeof(u32), 1);
+
+    VertexFormat::Attribute attribute;
+    attribute.Location = location;
+    attribute.Binding = InstanceIndexBinding;
+    attribute.Type = GL_UNSIGNED_INT;
+    attribute.Components = 1;
+    attribute.Integer = true;
+    SetAttributeFormat(attribute);
+    PipelineWarmup::OnVertexFormatChanged(m_RendererID, m_Format);
+
+    m_InstanceIndexBuffer = bufferID;
+    m_InstanceIndexLocation = location;
+}
+
+void VertexArray::SetInstanceDataBuffer(const BufferLayout& layout, u32 stride, u32 bufferID, usize offset) {
+    if (!m_HasInstanceDataFormat) {
+        // Formats and attribute bindings stay with the VAO; only the buffer
+        // behind the binding moves from call to call
+        u32 location = 0;
+        for (const auto& element : layout) {
+            if (element.Location >= 0) {
+                location = static_cast<u32>(element.Location);
+            }
+            location = SpecifyAttribute(element, location, InstanceDataBinding);
+        }
+        glVertexArrayBindingDivisor(m_RendererID, InstanceDataBinding, 1);
+        RecordBinding(InstanceDataBinding, stride, 1);
+        PipelineWarmup::OnVertexFormatChanged(m_RendererID, m_Format);
+        m_HasInstanceDataFormat = true;
+    } else if (m_InstanceDataBuffer == bufferID && m_InstanceDataOffset == offset) {
+        return;
+    }
+
+    glVertexArrayVertexBuffer(m_RendererID, InstanceDataBinding, bufferID,
+                              static_cast<GLintptr>(offset), static_cast<GLsizei>(stride));
+    m_InstanceDataBuffer = bufferID;
+    m_InstanceDataOffset = offset;
+}
+
+void VertexArray::RefreshStreamOffsets() const {
+    for (usize i = 0; i < m_VertexBuffers.size(); i++) {
+        const auto& vertexBuffer = m_VertexBuffers[i];
+        if (vertexBuffer->GetUsage() != BufferUsage::Stream) continue;
+
+        u32 offset = vertexBuffer->GetOffset();
+        if (offset == m_BoundOffsets[i]) continue;
+
+        glVertexArrayVertexBuffer(m_RendererID, static_cast<u32>(i), vertexBuffer->GetRendererID(),
+                                  offset, static_cast<GLsizei>(vertexBuffer->GetLayout().GetStride()));
+        m_BoundOffsets[i] = offset;
+    }
+}
+
 } // namespace Engine
@@ -6,9 +6,48 @@
 
 namespace Engine {
 
+// The attribute formats and binding strides / divisors of a vertex array,
+// without the buffers behind them: enough to build another vertex array a
+// program accepts the same way (PipelineWarmup).
+struct VertexFormat {
+    struct Attribute {
+        u32 Location = 0;
+        u32 Binding = 0;
+        u32 Type = 0;               // GL component type
+        u32 Components = 0;
+        u32 Offset = 0;             // Relative to the binding's element
+        bool Normalized = false;
+        bool Integer = false;       // Specified with glVertexArrayAttribIFormat
+    };
+
+    struct Binding {
+        u32 Index = 0;
+        u32 Stride = 0;
+        u32 Divisor = 0;
+    };
+
+    Vector<Attribute> Attributes;   // By location
+    Vector<Binding> Bindings;       // By index
+
+    // 0 for a format without attributes
+    u64 Hash() const;
+};
+
+// Vertex formats are set up with DSA. Each vertex buffer gets its own
+// binding; Bind() re-points bindings of Stream buffers at the region they
+// last wrote.
 class VertexArray {
 public:
+    // Bindings used by SetInstanceDataBuffer / SetInstanceIndexBuffer, above
+    // any vertex buffer's
+    static constexpr u32 InstanceDataBinding = 14;
+    static constexpr u32 InstanceIndexBinding = 15;
+
     VertexArray();
+
+    // A vertex array with format's attributes, every binding sourced from
+    // the start of bufferID
+    VertexArray(const VertexFormat& format, u32 bufferID);
     ~VertexArray();
 
     void Bind() const;
@@ -17,14 +56,46 @@ public:
     void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer);
     void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer);
 
+    // Source a per-instance u32 attribute from a raw GL buffer (divisor 1).
+    // No-op if that buffer is already attached at the location.
+    void SetInstanceIndexBuffer(u32 bufferID, u32 location);
+
+    // Source the per-instance attributes in layout from a raw GL buffer of
+    // stride-byte records (divisor 1). The formats are specified on the first
+    // call only and must not change afterwards; later calls just re-point the
+    // binding, and are a no-op for the same buffer and offset.
+    void SetInstanceDataBuffer(const BufferLayout& layout, u32 stride, u32 bufferID, usize offset);
+
+    u32 GetRendererID() const { return m_RendererID; }
+    const VertexFormat& GetFormat() const { return m_Format; }
+
     const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() const { return m_VertexBuffers; }
     const Ref<IndexBuffer>& GetIndexBuffer() const { return m_IndexBuffer; }
 
+private:
+    // Format location (and the following ones for matrices) from element,
+    // sourced from binding; returns the next free location
+    u32 SpecifyAttribute(const BufferElement& element, u32 location, u32 binding);
+
+    // Enable and format one attribute, recording it in m_Format
+    void SetAttributeFormat(const VertexFormat::Attribute& attribute);
+    // Record a binding's stride and divisor, set by the caller
+    void RecordBinding(u32 binding, u32 stride, u32 divisor);
+
+    void RefreshStreamOffsets() const;
+
 private:
     u32 m_RendererID = 0;
+    VertexFormat m_Format;
     u32 m_VertexBufferIndex = 0;
     std::vector<Ref<VertexBuffer>> m_VertexBuffers;
+    mutable std::vector<u32> m_BoundOffsets;    // Per binding, for Stream buffers
     Ref<IndexBuffer> m_IndexBuffer;
+    u32 m_InstanceIndexBuffer = 0;
+    u32 m_InstanceIndexLocation = 0;
+    bool m_HasInstanceDataFormat = false;
+    u32 m_InstanceDataBuffer = 0;
+    usize m_InstanceDataOffset = 0;
 };
 
 } // namespace Engine
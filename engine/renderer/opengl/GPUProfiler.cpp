@@ -0,0 +1,287 @@
+#include "renderer/opengl/GPUProfiler.hpp"
+#include "core/Logger.hpp"
+#include "core/Profiler.hpp"
+
+#include <glad/gl.h>
+#include <cstring>
+
+// GL_ARB_pipeline_statistics_query, core in 4.6
+#ifndef GL_VERTICES_SUBMITTED_ARB
+    #define GL_VERTICES_SUBMITTED_ARB 0x82EE
+    #define GL_PRIMITIVES_SUBMITTED_ARB 0x82EF
+    #define GL_FRAGMENT_SHADER_INVOCATIONS_ARB 0x82F4
+    #define GL_COMPUTE_SHADER_INVOCATIONS_ARB 0x82F5
+#endif
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 StatisticCount = 4;
+constexpr GLenum StatisticTargets[StatisticCount] = {
+    GL_VERTICES_SUBMITTED_ARB,
+    GL_PRIMITIVES_SUBMITTED_ARB,
+    GL_FRAGMENT_SHADER_INVOCATIONS_ARB,
+    GL_COMPUTE_SHADER_INVOCATIONS_ARB
+};
+
+struct Zone {
+    const char* Name = nullptr;
+    u32 Depth = 0;
+    u32 BeginQuery = 0;     // Indices into FrameQueries::Queries
+    u32 EndQuery = 0;
+    u32 StatsSlot = ~0u;    // Index into FrameQueries::StatsQueries, ~0u without
+};
+
+struct FrameQueries {
+    GLuint Queries[GPUProfiler::MaxZonesPerFrame * 2] = {};
+    u32 UsedQueries = 0;
+    u32 LastIssued = 0;     // Query written last, which completes last
+    Vector<Zone> Zones;
+    i64 ClockOffset = 0;    // Profiler::Now() minus GPU time at BeginFrame
+    bool Pending = false;
+
+    // One query per statistic per stats zone; created when first enabled
+    GLuint StatsQueries[StatisticCount][GPUProfiler::MaxZonesPerFrame] = {};
+    u32 UsedStats = 0;
+    bool StatsEnabled = false;  // Latched at BeginFrame
+};
+
+FrameQueries s_Frames[GPUProfiler::FrameLatency];
+u32 s_CurrentFrame = 0;
+bool s_InFrame = false;
+bool s_Initialized = false;
+
+bool s_StatsSupported = false;
+bool s_StatsRequested = false;
+bool s_StatsCreated = false;
+u32 s_OpenStatsZone = ~0u;  // Zone whose statistics queries are running
+
+bool HasGLExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (extension && std::strcmp(extension, name) == 0) return true;
+    }
+    return false;
+}
+
+// Open zones, as indices into the frame's zones; ~0u for zones that did not
+// fit in the frame
+Vector<u32> s_ZoneStack;
+
+Vector<GPUProfiler::PassTiming> s_Results;
+f32 s_TotalTimeMs = 0.0f;
+u32 s_DroppedFrames = 0;
+
+// Read a finished frame's queries; false while the GPU still owes some
+bool Resolve(FrameQueries& frame) {
+    if (frame.UsedQueries > 0) {
+        // Queries complete in order, so the last one being ready means all are
+        GLint available = 0;
+        glGetQueryObjectiv(frame.Queries[frame.LastIssued], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+    }
+
+    s_Results.clear();
+    s_TotalTimeMs = 0.0f;
+    for (const Zone& zone : frame.Zones) {
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(frame.Queries[zone.BeginQuery], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(frame.Queries[zone.EndQuery], GL_QUERY_RESULT, &end);
+        if (end < begin) end = begin;
+
+        GPUProfiler::PassTiming timing;
+        timing.Name = zone.Name;
+        timing.Depth = zone.Depth;
+        timing.TimeMs = static_cast<f32>(static_cast<f64>(end - begin) / 1.0e6);
+        if (zone.StatsSlot != ~0u) {
+            GLuint64 values[StatisticCount] = {};
+            for (u32 i = 0; i < StatisticCount; ++i) {
+                glGetQueryObjectui64v(frame.StatsQueries[i][zone.StatsSlot], GL_QUERY_RESULT, &values[i]);
+            }
+            timing.HasStatistics = true;
+            timing.Statistics.VerticesSubmitted = values[0];
+            timing.Statistics.PrimitivesSubmitted = values[1];
+            timing.Statistics.FragmentInvocations = values[2];
+            timing.Statistics.ComputeInvocations = values[3];
+        }
+        s_Results.push_back(timing);
+        if (zone.Depth == 0) {
+            s_TotalTimeMs += timing.TimeMs;
+        }
+
+#ifdef ENGINE_ENABLE_PROFILING
+        Profiler::RecordGPU(zone.Name,
+                            static_cast<u64>(static_cast<i64>(begin) + frame.ClockOffset),
+                            static_cast<u64>(static_cast<i64>(end) + frame.ClockOffset));
+#endif
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+void GPUProfiler::Init() {
+    if (s_Initialized) return;
+
+    for (auto& frame : s_Frames) {
+        glCreateQueries(GL_TIMESTAMP, static_cast<GLsizei>(MaxZonesPerFrame * 2), frame.Queries);
+        frame.Zones.reserve(MaxZonesPerFrame);
+    }
+    s_ZoneStack.reserve(16);
+
+    GLint major = 0;
+    GLint minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    s_StatsSupported = (major > 4 || (major == 4 && minor >= 6)) ||
+                       HasGLExtension("GL_ARB_pipeline_statistics_query");
+    s_Initialized = true;
+}
+
+void GPUProfiler::Shutdown() {
+    if (!s_Initialized) return;
+
+    for (auto& frame : s_Frames) {
+        glDeleteQueries(static_cast<GLsizei>(MaxZonesPerFrame * 2), frame.Queries);
+        if (s_StatsCreated) {
+            for (auto& queries : frame.StatsQueries) {
+                glDeleteQueries(static_cast<GLsizei>(MaxZonesPerFrame), queries);
+            }
+        }
+        frame = FrameQueries{};
+    }
+    s_ZoneStack.clear();
+    s_Results.clear();
+    s_InFrame = false;
+    s_StatsCreated = false;
+    s_OpenStatsZone = ~0u;
+    s_Initialized = false;
+}
+
+bool GPUProfiler::IsInitialized() {
+    return s_Initialized;
+}
+
+void GPUProfiler::BeginFrame() {
+    if (!s_Initialized) return;
+
+    // Close what the last frame left open, or its end queries would never
+    // be written
+    if (!s_ZoneStack.empty()) {
+        LOG_CORE_WARN("GPUProfiler: {} zones left open at the end of the frame", s_ZoneStack.size());
+        while (!s_ZoneStack.empty()) {
+            EndZone();
+        }
+    }
+
+    s_CurrentFrame = (s_CurrentFrame + 1) % FrameLatency;
+    FrameQueries& frame = s_Frames[s_CurrentFrame];
+
+    // The slot's previous frame was recorded FrameLatency - 1 frames ago
+    if (frame.Pending && !Resolve(frame)) {
+        s_DroppedFrames++;
+    }
+
+    frame.UsedQueries = 0;
+    frame.UsedStats = 0;
+    frame.Zones.clear();
+    frame.Pending = true;
+
+    // Statistics queries are only created once someone asks for them
+    if (s_StatsRequested && s_StatsSupported && !s_StatsCreated) {
+        for (auto& slot : s_Frames) {
+            for (u32 i = 0; i < StatisticCount; ++i) {
+                glCreateQueries(StatisticTargets[i], static_cast<GLsizei>(MaxZonesPerFrame), slot.StatsQueries[i]);
+            }
+        }
+        s_StatsCreated = true;
+    }
+    frame.StatsEnabled = s_StatsRequested && s_StatsCreated;
+
+    // Pair the GPU clock with the CPU one to place zones on the trace
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    frame.ClockOffset = static_cast<i64>(Profiler::Now()) - static_cast<i64>(gpuNow);
+
+    s_InFrame = true;
+}
+
+void GPUProfiler::BeginZone(const char* name, bool statistics) {
+    if (!s_InFrame) return;
+
+    FrameQueries& frame = s_Frames[s_CurrentFrame];
+    if (frame.Zones.size() >= MaxZonesPerFrame) {
+        s_ZoneStack.push_back(~0u);
+        return;
+    }
+
+    Zone zone;
+    zone.Name = name;
+    zone.Depth = static_cast<u32>(s_ZoneStack.size());
+    zone.BeginQuery = frame.UsedQueries++;
+    zone.EndQuery = frame.UsedQueries++;
+    glQueryCounter(frame.Queries[zone.BeginQuery], GL_TIMESTAMP);
+    frame.LastIssued = zone.BeginQuery;
+
+    if (statistics && frame.StatsEnabled && s_OpenStatsZone == ~0u) {
+        zone.StatsSlot = frame.UsedStats++;
+        for (u32 i = 0; i < StatisticCount; ++i) {
+            glBeginQuery(StatisticTargets[i], frame.StatsQueries[i][zone.StatsSlot]);
+        }
+        s_OpenStatsZone = static_cast<u32>(frame.Zones.size());
+    }
+
+    s_ZoneStack.push_back(static_cast<u32>(frame.Zones.size()));
+    frame.Zones.push_back(zone);
+}
+
+void GPUProfiler::EndZone() {
+    if (!s_InFrame || s_ZoneStack.empty()) return;
+
+    const u32 index = s_ZoneStack.back();
+    s_ZoneStack.pop_back();
+    if (index == ~0u) return;
+
+    FrameQueries& frame = s_Frames[s_CurrentFrame];
+    if (index == s_OpenStatsZone) {
+        for (u32 i = 0; i < StatisticCount; ++i) {
+            glEndQuery(StatisticTargets[i]);
+        }
+        s_OpenStatsZone = ~0u;
+    }
+    frame.LastIssued = frame.Zones[index].EndQuery;
+    glQueryCounter(frame.Queries[frame.LastIssued], GL_TIMESTAMP);
+}
+
+void GPUProfiler::SetPipelineStatisticsEnabled(bool enabled) {
+    if (enabled && s_Initialized && !s_StatsSupported) {
+        LOG_CORE_WARN("GPUProfiler: pipeline statistics queries are not supported by this driver");
+    }
+    s_StatsRequested = enabled;
+}
+
+bool GPUProfiler::IsPipelineStatisticsEnabled() {
+    return s_StatsRequested && s_StatsSupported;
+}
+
+bool GPUProfiler::IsPipelineStatisticsSupported() {
+    return s_StatsSupported;
+}
+
+const Vector<GPUProfiler::PassTiming>& GPUProfiler::GetResults() {
+    return s_Results;
+}
+
+f32 GPUProfiler::GetTotalTimeMs() {
+    return s_TotalTimeMs;
+}
+
+u32 GPUProfiler::GetDroppedFrames() {
+    return s_DroppedFrames;
+}
+
+} // namespace Engine
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "core/Types.hpp"
+
+namespace Engine {
+
+// GPUProfiler - per-pass GPU timings from timestamp queries.
+//
+// Every zone brackets its GL commands with a pair of glQueryCounter
+// (GL_TIMESTAMP) queries. The queries of a frame live in one slot of a ring
+// of FrameLatency slots and are read when the slot comes round again, two
+// frames later, once the GPU has long finished them; a frame whose queries
+// are still not available then is dropped rather than waited for. Results
+// feed GetResults() and, with ENGINE_ENABLE_PROFILING, the "GPU" track of
+// the profiler trace.
+//
+// Pipeline statistics (GL_ARB_pipeline_statistics_query): while enabled,
+// zones opened with GPU_PROFILE_SCOPE_STATS also count the vertices and
+// primitives submitted and the fragment and compute shader invocations of
+// their commands, read back with the timings. Statistics queries of one kind
+// cannot nest, so a stats zone inside another one only gets its timing.
+//
+// GL thread only. Zones may nest; names must outlive the profiler.
+class GPUProfiler {
+public:
+    static constexpr u32 FrameLatency = 3;
+    static constexpr u32 MaxZonesPerFrame = 64;
+
+    static void Init();
+    static void Shutdown();
+    static bool IsInitialized();
+
+    // Start a frame: reads back the frame recorded FrameLatency - 1 frames ago
+    static void BeginFrame();
+
+    static void BeginZone(const char* name, bool statistics = false);
+    static void EndZone();
+
+    // Takes effect at the next BeginFrame(). No-op without driver support.
+    static void SetPipelineStatisticsEnabled(bool enabled);
+    static bool IsPipelineStatisticsEnabled();
+    static bool IsPipelineStatisticsSupported();
+
+    struct PipelineStatistics {
+        u64 VerticesSubmitted = 0;
+        u64 PrimitivesSubmitted = 0;
+        u64 FragmentInvocations = 0;
+        u64 ComputeInvocations = 0;
+    };
+
+    struct PassTiming {
+        const char* Name = nullptr;
+        u32 Depth = 0;          // Nesting level
+        f32 TimeMs = 0.0f;
+        bool HasStatistics = false;
+        PipelineStatistics Statistics;
+    };
+
+    // Zones of the newest frame read back, in the order they began
+    static const Vector<PassTiming>& GetResults();
+
+    // Sum of that frame's top-level zones
+    static f32 GetTotalTimeMs();
+
+    // Frames whose queries were not ready in time
+    static u32 GetDroppedFrames();
+};
+
+class GPUProfileScope {
+public:
+    explicit GPUProfileScope(const char* name, bool statistics = false) { GPUProfiler::BeginZone(name, statistics); }
+    ~GPUProfileScope() { GPUProfiler::EndZone(); }
+
+    GPUProfileScope(const GPUProfileScope&) = delete;
+    GPUProfileScope& operator=(const GPUProfileScope&) = delete;
+};
+
+} // namespace Engine
+
+#define GPU_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GPU_PROFILE_CONCAT(a, b) GPU_PROFILE_CONCAT_IMPL(a, b)
+#define GPU_PROFILE_SCOPE(name) ::Engine::GPUProfileScope GPU_PROFILE_CONCAT(gpuProfileScope, __COUNTER__)(name)
+// Also collects pipeline statistics while they are enabled
+#define GPU_PROFILE_SCOPE_STATS(name) ::Engine::GPUProfileScope GPU_PROFILE_CONCAT(gpuProfileScope, __COUNTER__)(name, true)
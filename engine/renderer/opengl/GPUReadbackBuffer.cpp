@@ -0,0 +1,96 @@
+#include "renderer/opengl/GPUReadbackBuffer.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+
+namespace Engine {
+
+namespace {
+
+constexpr GLbitfield ReadbackMapFlags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+} // anonymous namespace
+
+GPUReadbackBuffer::GPUReadbackBuffer(usize slotSize)
+    : m_SlotSize(slotSize)
+{
+    const usize totalSize = slotSize * SlotCount;
+
+    glCreateBuffers(1, &m_Buffer);
+    GLMemory::BufferStorage(m_Buffer, static_cast<GLsizeiptr>(totalSize), nullptr,
+                            ReadbackMapFlags | GL_CLIENT_STORAGE_BIT, MemoryTag::Renderer);
+    m_Mapped = static_cast<const u8*>(glMapNamedBufferRange(m_Buffer, 0, static_cast<GLsizeiptr>(totalSize), ReadbackMapFlags));
+
+    if (!m_Mapped) {
+        LOG_CORE_ERROR("GPUReadbackBuffer: failed to map {} bytes", totalSize);
+    }
+}
+
+GPUReadbackBuffer::~GPUReadbackBuffer() {
+    for (auto& fence : m_Fences) {
+        if (fence) glDeleteSync(static_cast<GLsync>(fence));
+    }
+    if (m_Buffer) {
+        glUnmapNamedBuffer(m_Buffer);
+        GLMemory::DeleteBuffers(1, &m_Buffer);
+    }
+}
+
+u32 GPUReadbackBuffer::Enqueue(u32 sourceBuffer, usize sourceOffset) {
+    const u32 slot = m_NextSlot;
+    m_NextSlot = (m_NextSlot + 1) % SlotCount;
+
+    // A slot still in flight is simply overwritten: the GPU runs the copies
+    // in order, so the newer one lands last
+    if (m_Fences[slot]) {
+        glDeleteSync(static_cast<GLsync>(m_Fences[slot]));
+    }
+
+    glCopyNamedBufferSubData(sourceBuffer, m_Buffer,
+                             static_cast<GLintptr>(sourceOffset),
+                             static_cast<GLintptr>(slot * m_SlotSize),
+                             static_cast<GLsizeiptr>(m_SlotSize));
+    m_Fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_Sequence[slot] = ++m_EnqueueCount;
+
+    return slot;
+}
+
+bool GPUReadbackBuffer::Poll(u32& outSlot) {
+    bool found = false;
+    u32 newest = 0;
+
+    for (u32 slot = 0; slot < SlotCount; ++slot) {
+        GLsync fence = static_cast<GLsync>(m_Fences[slot]);
+        if (!fence) continue;
+
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) continue;
+
+        if (!found || m_Sequence[slot] > m_Sequence[newest]) {
+            newest = slot;
+            found = true;
+        }
+    }
+
+    if (!found || !m_Mapped) return false;
+
+    // Anything enqueued before the newest result is stale now
+    for (u32 slot = 0; slot < SlotCount; ++slot) {
+        if (m_Fences[slot] && m_Sequence[slot] <= m_Sequence[newest]) {
+            glDeleteSync(static_cast<GLsync>(m_Fences[slot]));
+            m_Fences[slot] = nullptr;
+        }
+    }
+
+    outSlot = newest;
+    return true;
+}
+
+const void* GPUReadbackBuffer::GetData(u32 slot) const {
+    if (!m_Mapped || slot >= SlotCount) return nullptr;
+    return m_Mapped + slot * m_SlotSize;
+}
+
+} // namespace Engine
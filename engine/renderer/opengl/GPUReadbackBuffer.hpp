@@ -0,0 +1,44 @@
+#pragma once
+
+#include "core/Types.hpp"
+
+namespace Engine {
+
+// GPUReadbackBuffer - asynchronous GPU -> CPU copies without stalling.
+//
+// A persistently mapped buffer split into SlotCount slots. Enqueue() copies
+// a range of a GPU buffer into the next slot and fences it; Poll() returns
+// the newest slot whose copy has finished, without waiting. Results arrive a
+// few frames late, which suits statistics and other non-critical feedback.
+class GPUReadbackBuffer {
+public:
+    static constexpr u32 SlotCount = 4;
+
+    explicit GPUReadbackBuffer(usize slotSize);
+    ~GPUReadbackBuffer();
+
+    GPUReadbackBuffer(const GPUReadbackBuffer&) = delete;
+    GPUReadbackBuffer& operator=(const GPUReadbackBuffer&) = delete;
+
+    // Queue a copy of slotSize bytes from sourceBuffer. Returns the slot used.
+    u32 Enqueue(u32 sourceBuffer, usize sourceOffset = 0);
+
+    // Newest completed slot since the last successful Poll(); older pending
+    // slots count as consumed. False when nothing new has landed.
+    bool Poll(u32& outSlot);
+
+    const void* GetData(u32 slot) const;
+    usize GetSlotSize() const { return m_SlotSize; }
+
+private:
+    u32 m_Buffer = 0;
+    const u8* m_Mapped = nullptr;
+    usize m_SlotSize = 0;
+
+    u32 m_NextSlot = 0;
+    void* m_Fences[SlotCount] = {};
+    u32 m_Sequence[SlotCount] = {};     // Enqueue order, to find the newest slot
+    u32 m_EnqueueCount = 0;
+};
+
+} // namespace Engine
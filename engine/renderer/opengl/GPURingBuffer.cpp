@@ -0,0 +1,176 @@
+#include "renderer/opengl/GPURingBuffer.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+
+namespace Engine {
+
+namespace {
+
+constexpr GLbitfield PersistentMapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+usize AlignUp(usize value, usize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // anonymous namespace
+
+GPURingBuffer::GPURingBuffer(usize frameCapacity) {
+    GLint uniformAlignment = 0;
+    GLint storageAlignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+    m_Alignment = std::max<usize>({16, static_cast<usize>(uniformAlignment), static_cast<usize>(storageAlignment)});
+
+    CreateBuffer(AlignUp(std::max<usize>(frameCapacity, m_Alignment), m_Alignment));
+}
+
+GPURingBuffer::~GPURingBuffer() {
+    for (auto& fence : m_Fences) {
+        if (fence) glDeleteSync(static_cast<GLsync>(fence));
+    }
+    for (auto& retired : m_Retired) {
+        if (retired.Fence) glDeleteSync(static_cast<GLsync>(retired.Fence));
+        glUnmapNamedBuffer(retired.Buffer);
+        GLMemory::DeleteBuffers(1, &retired.Buffer);
+    }
+    if (m_Buffer) {
+        glUnmapNamedBuffer(m_Buffer);
+        GLMemory::DeleteBuffers(1, &m_Buffer);
+    }
+}
+
+void GPURingBuffer::CreateBuffer(usize frameCapacity) {
+    m_FrameCapacity = frameCapacity;
+    const usize totalSize = frameCapacity * FramesInFlight;
+
+    glCreateBuffers(1, &m_Buffer);
+    GLMemory::BufferStorage(m_Buffer, static_cast<GLsizeiptr>(totalSize), nullptr, PersistentMapFlags,
+                            MemoryTag::Renderer);
+    m_Mapped = static_cast<u8*>(glMapNamedBufferRange(m_Buffer, 0, static_cast<GLsizeiptr>(totalSize), PersistentMapFlags));
+
+    if (!m_Mapped) {
+        LOG_CORE_ERROR("GPURingBuffer: failed to map {} bytes", totalSize);
+    }
+}
+
+void GPURingBuffer::Grow(usize required) {
+    usize capacity = m_FrameCapacity * 2;
+    while (capacity < required) {
+        capacity *= 2;
+    }
+    LOG_CORE_INFO("GPURingBuffer: growing frame capacity {} -> {} bytes", m_FrameCapacity, capacity);
+
+    // Earlier allocations (this and previous frames) still point into the old
+    // buffer, so it lives until the end-of-frame fence
+    m_Retired.push_back({m_Buffer, nullptr});
+
+    for (auto& fence : m_Fences) {
+        if (fence) {
+            glDeleteSync(static_cast<GLsync>(fence));
+            fence = nullptr;
+        }
+    }
+
+    CreateBuffer(AlignUp(capacity, m_Alignment));
+    m_Head = 0;
+}
+
+void* GPURingBuffer::InsertFence() {
+    return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void GPURingBuffer::WaitForRegion(u32 region) {
+    GLsync fence = static_cast<GLsync>(m_Fences[region]);
+    if (!fence) return;
+
+    // Normally already signalled: the region was last used FramesInFlight frames ago
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) {
+        LOG_CORE_WARN("GPURingBuffer: fence wait failed, writing region {} anyway", region);
+    }
+
+    glDeleteSync(fence);
+    m_Fences[region] = nullptr;
+}
+
+void GPURingBuffer::ReleaseRetired() {
+    auto it = std::remove_if(m_Retired.begin(), m_Retired.end(), [](RetiredBuffer& retired) {
+        if (!retired.Fence) return false;
+
+        GLenum status = glClientWaitSync(static_cast<GLsync>(retired.Fence), 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return false;
+
+        glDeleteSync(static_cast<GLsync>(retired.Fence));
+        glUnmapNamedBuffer(retired.Buffer);
+        GLMemory::DeleteBuffers(1, &retired.Buffer);
+        return true;
+    });
+    m_Retired.erase(it, m_Retired.end());
+}
+
+void GPURingBuffer::BeginFrame() {
+    if (m_FrameOpen) {
+        EndFrame();
+    }
+
+    ReleaseRetired();
+
+    m_Region = (m_Region + 1) % FramesInFlight;
+    WaitForRegion(m_Region);
+
+    m_Head = 0;
+    m_FrameOpen = true;
+}
+
+void GPURingBuffer::EndFrame() {
+    if (!m_FrameOpen) return;
+
+    if (m_Fences[m_Region]) {
+        glDeleteSync(static_cast<GLsync>(m_Fences[m_Region]));
+    }
+    m_Fences[m_Region] = InsertFence();
+
+    for (auto& retired : m_Retired) {
+        if (!retired.Fence) {
+            retired.Fence = InsertFence();
+        }
+    }
+
+    m_FrameOpen = false;
+}
+
+GPURingBuffer::Allocation GPURingBuffer::Allocate(usize size) {
+    if (!m_FrameOpen) {
+        LOG_CORE_WARN("GPURingBuffer: Allocate() outside BeginFrame()/EndFrame()");
+        BeginFrame();
+    }
+
+    // Zero-sized ranges can't be bound
+    const usize alignedSize = AlignUp(std::max<usize>(size, 16), m_Alignment);
+    if (m_Head + alignedSize > m_FrameCapacity) {
+        Grow(m_Head + alignedSize);
+    }
+    if (!m_Mapped) return {};
+
+    Allocation allocation;
+    allocation.Buffer = m_Buffer;
+    allocation.Offset = static_cast<usize>(m_Region) * m_FrameCapacity + m_Head;
+    allocation.Data = m_Mapped + allocation.Offset;
+    allocation.Size = std::max<usize>(size, 16);
+
+    m_Head += alignedSize;
+    return allocation;
+}
+
+void GPURingBuffer::BindRange(u32 target, u32 binding, const Allocation& allocation) {
+    if (!allocation) return;
+
+    GLStateCache::Instance().BindBufferRange(target, binding, allocation.Buffer, allocation.Offset,
+                                             allocation.Size);
+}
+
+} // namespace Engine
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "core/Types.hpp"
+
+#include <cstring>
+
+namespace Engine {
+
+// GPURingBuffer - persistently mapped streaming buffer for per-frame uploads.
+//
+// Storage is split into FramesInFlight regions. BeginFrame() moves to the
+// next region and waits on the fence placed when that region was last used,
+// so the CPU never overwrites data the GPU may still read and no
+// glBufferSubData implicit sync happens. Allocations are sub-ranges of the
+// current region, aligned for UBO and SSBO binding offsets.
+//
+// If a frame needs more than the region size the buffer is recreated twice
+// as large; the old one is kept alive until the GPU is done with it, so
+// allocations made earlier in the frame stay valid.
+class GPURingBuffer {
+public:
+    static constexpr u32 FramesInFlight = 3;
+
+    struct Allocation {
+        void* Data = nullptr;   // Mapped write pointer
+        u32 Buffer = 0;         // GL buffer holding the range
+        usize Offset = 0;       // Byte offset inside Buffer
+        usize Size = 0;
+
+        explicit operator bool() const { return Data != nullptr; }
+    };
+
+    explicit GPURingBuffer(usize frameCapacity);
+    ~GPURingBuffer();
+
+    GPURingBuffer(const GPURingBuffer&) = delete;
+    GPURingBuffer& operator=(const GPURingBuffer&) = delete;
+
+    // Switch to the next region. Also fences the previous frame if EndFrame()
+    // wasn't called, which covers every command issued up to now.
+    void BeginFrame();
+
+    // Fence the current region after the commands that read it
+    void EndFrame();
+
+    Allocation Allocate(usize size);
+
+    template<typename T>
+    Allocation Upload(const T* data, usize count) {
+        Allocation allocation = Allocate(count * sizeof(T));
+        if (allocation && count > 0) {
+            std::memcpy(allocation.Data, data, count * sizeof(T));
+        }
+        return allocation;
+    }
+
+    // glBindBufferRange for GL_UNIFORM_BUFFER / GL_SHADER_STORAGE_BUFFER
+    static void BindRange(u32 target, u32 binding, const Allocation& allocation);
+
+    usize GetFrameCapacity() const { return m_FrameCapacity; }
+    u32 GetRendererID() const { return m_Buffer; }
+
+private:
+    struct RetiredBuffer {
+        u32 Buffer = 0;
+        void* Fence = nullptr;   // Set at the end of the frame it was retired in
+    };
+
+    void CreateBuffer(usize frameCapacity);
+    void Grow(usize required);
+    void WaitForRegion(u32 region);
+    void ReleaseRetired();
+    void* InsertFence();
+
+private:
+    u32 m_Buffer = 0;
+    u8* m_Mapped = nullptr;
+    usize m_FrameCapacity = 0;
+    usize m_Alignment = 256;
+
+    u32 m_Region = 0;
+    usize m_Head = 0;            // Bytes used in the current region
+    bool m_FrameOpen = false;
+
+    void* m_Fences[FramesInFlight] = {};
+    Vector<RetiredBuffer> m_Retired;
+};
+
+} // namespace Engine
@@ -0,0 +1,451 @@
+#include "renderer/opengl/PipelineWarmup.hpp"
+#include "renderer/opengl/GLVertexArray.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 ManifestVersion = 1;
+constexpr usize ZeroBufferSize = 64 * 1024;     // Vertices, uniform and storage blocks read from it
+constexpr u32 WarmupVertexCount = 3;
+
+// One pipeline: what a draw call site had bound when it drew
+struct Entry {
+    StringId Program;
+    u64 Format = 0;                 // VertexFormat::Hash
+    GLStateCache::Snapshot State;
+    u32 Mode = 0;                   // Primitive
+    u32 UnusedSessions = 0;         // Sessions since it was last recorded, as loaded
+    bool Used = false;              // Recorded this session
+    bool Warm = false;              // Drawn this session, by the game or by Run()
+};
+
+bool s_Initialized = false;
+String s_ManifestPath;
+
+Vector<Entry> s_Entries;
+HashMap<u64, u32> s_EntryIndex;             // Key() -> index in s_Entries
+bool s_WarnedFull = false;
+
+// Live objects, maintained whether or not the warm-up is initialized
+HashMap<u32, StringId> s_ProgramKeys;       // GL program -> key
+HashMap<StringId, u32> s_Programs;          // Key -> GL program most recently linked
+HashMap<u32, u64> s_VertexArrayFormats;     // GL vertex array -> format hash
+HashMap<u64, VertexFormat> s_Formats;       // Every format seen or loaded
+
+// Warm-up objects, created by the first Run() that draws
+u32 s_ZeroBuffer = 0;
+u32 s_Framebuffer = 0;
+u32 s_Renderbuffers[2] = {};
+HashMap<u64, Scope<VertexArray>> s_WarmupArrays;
+
+u64 Key(StringId program, u64 format, const GLStateCache::Snapshot& state, u32 mode) {
+    // FNV-1a over the fields
+    u64 hash = 14695981039346656037ull;
+    auto mix = [&hash](u64 value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+    const RenderState& s = state.State;
+    mix(program.GetValue());
+    mix(format);
+    mix(mode);
+    mix(state.Known);
+    mix((s.DepthTest ? 1u : 0u) | (s.DepthWrite ? 2u : 0u) | (s.Blend ? 4u : 0u) | (s.CullFace ? 8u : 0u));
+    mix(s.DepthFunc);
+    mix(s.BlendSource);
+    mix(s.BlendDestination);
+    return hash;
+}
+
+Entry* AddEntry(StringId program, u64 format, GLStateCache::Snapshot state, u32 mode) {
+    // The blend function doesn't matter while blending is off
+    if (!state.State.Blend) {
+        state.State.BlendSource = RenderState{}.BlendSource;
+        state.State.BlendDestination = RenderState{}.BlendDestination;
+    }
+
+    const u64 key = Key(program, format, state, mode);
+    auto it = s_EntryIndex.find(key);
+    if (it != s_EntryIndex.end()) return &s_Entries[it->second];
+
+    if (s_Entries.size() >= PipelineWarmup::MaxEntries) {
+        if (!s_WarnedFull) {
+            LOG_CORE_WARN("PipelineWarmup: manifest full ({} entries), later pipelines are not recorded",
+                          PipelineWarmup::MaxEntries);
+            s_WarnedFull = true;
+        }
+        return nullptr;
+    }
+
+    s_EntryIndex.emplace(key, static_cast<u32>(s_Entries.size()));
+    Entry& entry = s_Entries.emplace_back();
+    entry.Program = program;
+    entry.Format = format;
+    entry.State = state;
+    entry.Mode = mode;
+    return &entry;
+}
+
+// Manifest text, one record per line:
+//   PipelineManifest <version>
+//   format <id> <attributes> <bindings> (<location> <binding> <type> <components> <offset> <flags>)... (<index> <stride> <divisor>)...
+//   pipeline <unused sessions> <format id> <mode> <known> <depth test> <depth write> <depth func> <blend> <source> <destination> <cull> <program key>
+// Format id 0 is the format without attributes; the program key runs to the
+// end of the line.
+void LoadManifest() {
+    std::ifstream file(s_ManifestPath);
+    if (!file) return;
+
+    String line;
+    u32 version = 0;
+    if (!std::getline(file, line) || std::sscanf(line.c_str(), "PipelineManifest %u", &version) != 1 ||
+        version != ManifestVersion) {
+        LOG_CORE_WARN("PipelineWarmup: ignoring {}, not a version {} manifest", s_ManifestPath, ManifestVersion);
+        return;
+    }
+
+    HashMap<u32, u64> formatIds;        // File id -> hash
+    u32 skipped = 0;
+    while (std::getline(file, line)) {
+        std::istringstream in(line);
+        String kind;
+        in >> kind;
+
+        if (kind == "format") {
+            u32 id = 0, attributeCount = 0, bindingCount = 0;
+            in >> id >> attributeCount >> bindingCount;
+            VertexFormat format;
+            for (u32 i = 0; i < attributeCount && in; ++i) {
+                VertexFormat::Attribute attribute;
+                u32 flags = 0;
+                in >> attribute.Location >> attribute.Binding >> attribute.Type >> attribute.Components >>
+                    attribute.Offset >> flags;
+                attribute.Normalized = (flags & 1) != 0;
+                attribute.Integer = (flags & 2) != 0;
+                format.Attributes.push_back(attribute);
+            }
+            for (u32 i = 0; i < bindingCount && in; ++i) {
+                VertexFormat::Binding binding;
+                in >> binding.Index >> binding.Stride >> binding.Divisor;
+                format.Bindings.push_back(binding);
+            }
+            if (!in || id == 0) {
+                ++skipped;
+                continue;
+            }
+            const u64 hash = format.Hash();
+            formatIds[id] = hash;
+            s_Formats.try_emplace(hash, std::move(format));
+        } else if (kind == "pipeline") {
+            u32 unused = 0, formatId = 0, mode = 0, known = 0;
+            u32 depthTest = 0, depthWrite = 0, blend = 0, cull = 0;
+            GLStateCache::Snapshot state;
+            in >> unused >> formatId >> mode >> known >> depthTest >> depthWrite >> state.State.DepthFunc >> blend >>
+                state.State.BlendSource >> state.State.BlendDestination >> cull;
+            String program;
+            std::getline(in >> std::ws, program);
+            auto format = formatIds.find(formatId);
+            if (!in || program.empty() || (formatId != 0 && format == formatIds.end())) {
+                ++skipped;
+                continue;
+            }
+            state.Known = known;
+            state.State.DepthTest = depthTest != 0;
+            state.State.DepthWrite = depthWrite != 0;
+            state.State.Blend = blend != 0;
+            state.State.CullFace = cull != 0;
+
+            if (Entry* entry = AddEntry(StringId(program), formatId == 0 ? 0 : format->second, state, mode)) {
+                entry->UnusedSessions = unused;
+            }
+        }
+    }
+
+    if (skipped > 0) {
+        LOG_CORE_WARN("PipelineWarmup: skipped {} malformed records in {}", skipped, s_ManifestPath);
+    }
+    LOG_CORE_INFO("PipelineWarmup: {} pipelines in {}", s_Entries.size(), s_ManifestPath);
+}
+
+void CreateWarmupObjects() {
+    if (s_Framebuffer) return;
+
+    const Vector<u8> zeros(ZeroBufferSize, 0);
+    glCreateBuffers(1, &s_ZeroBuffer);
+    GLMemory::BufferStorage(s_ZeroBuffer, ZeroBufferSize, zeros.data(), 0, MemoryTag::Renderer);
+
+    glCreateRenderbuffers(2, s_Renderbuffers);
+    glNamedRenderbufferStorage(s_Renderbuffers[0], GL_RGBA8, 1, 1);
+    glNamedRenderbufferStorage(s_Renderbuffers[1], GL_DEPTH24_STENCIL8, 1, 1);
+
+    glCreateFramebuffers(1, &s_Framebuffer);
+    glNamedFramebufferRenderbuffer(s_Framebuffer, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, s_Renderbuffers[0]);
+    glNamedFramebufferRenderbuffer(s_Framebuffer, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, s_Renderbuffers[1]);
+}
+
+void DestroyWarmupObjects() {
+    s_WarmupArrays.clear();
+    if (!s_Framebuffer) return;
+
+    glDeleteFramebuffers(1, &s_Framebuffer);
+    glDeleteRenderbuffers(2, s_Renderbuffers);
+    GLMemory::DeleteBuffers(1, &s_ZeroBuffer);
+    s_Framebuffer = 0;
+    s_Renderbuffers[0] = s_Renderbuffers[1] = 0;
+    s_ZeroBuffer = 0;
+}
+
+// A vertex array of the format, sourcing the zero buffer
+const VertexArray& GetWarmupArray(u64 formatHash) {
+    auto it = s_WarmupArrays.find(formatHash);
+    if (it != s_WarmupArrays.end()) return *it->second;
+
+    auto format = s_Formats.find(formatHash);
+    auto vertexArray = CreateScope<VertexArray>(format != s_Formats.end() ? format->second : VertexFormat{},
+                                                s_ZeroBuffer);
+    return *s_WarmupArrays.emplace(formatHash, std::move(vertexArray)).first->second;
+}
+
+} // anonymous namespace
+
+void PipelineWarmup::Init(const String& manifestPath) {
+    if (s_Initialized) return;
+
+    s_ManifestPath = manifestPath;
+    s_Entries.clear();
+    s_EntryIndex.clear();
+    s_WarnedFull = false;
+    LoadManifest();
+
+    s_Initialized = true;
+    SetRecording(true);
+}
+
+void PipelineWarmup::Shutdown() {
+    if (!s_Initialized) return;
+
+    Save();
+    SetRecording(false);
+    DestroyWarmupObjects();
+    s_Entries.clear();
+    s_EntryIndex.clear();
+    s_Initialized = false;
+}
+
+bool PipelineWarmup::IsInitialized() {
+    return s_Initialized;
+}
+
+bool PipelineWarmup::Save() {
+    if (!s_Initialized) return false;
+
+    std::error_code error;
+    const std::filesystem::path path(s_ManifestPath);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+
+    // Write a temporary and rename it, so a crash while saving keeps the
+    // previous manifest
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::out | std::ios::trunc);
+        if (!out) {
+            LOG_CORE_WARN("PipelineWarmup: could not write {}", s_ManifestPath);
+            return false;
+        }
+
+        out << "PipelineManifest " << ManifestVersion << '\n';
+
+        HashMap<u64, u32> formatIds;
+        for (const Entry& entry : s_Entries) {
+            const u32 unused = entry.Used ? 0 : entry.UnusedSessions + 1;
+            if (unused > MaxUnusedSessions) continue;
+
+            u32 formatId = 0;
+            if (entry.Format != 0) {
+                auto format = s_Formats.find(entry.Format);
+                if (format == s_Formats.end()) continue;
+
+                auto [id, added] = formatIds.try_emplace(entry.Format, static_cast<u32>(formatIds.size()) + 1);
+                formatId = id->second;
+                if (added) {
+                    const VertexFormat& f = format->second;
+                    out << "format " << formatId << ' ' << f.Attributes.size() << ' ' << f.Bindings.size();
+                    for (const auto& a : f.Attributes) {
+                        out << ' ' << a.Location << ' ' << a.Binding << ' ' << a.Type << ' ' << a.Components << ' '
+                            << a.Offset << ' ' << ((a.Normalized ? 1 : 0) | (a.Integer ? 2 : 0));
+                    }
+                    for (const auto& b : f.Bindings) {
+                        out << ' ' << b.Index << ' ' << b.Stride << ' ' << b.Divisor;
+                    }
+                    out << '\n';
+                }
+            }
+
+            const RenderState& s = entry.State.State;
+            out << "pipeline " << unused << ' ' << formatId << ' ' << entry.Mode << ' ' << entry.State.Known << ' '
+                << s.DepthTest << ' ' << s.DepthWrite << ' ' << s.DepthFunc << ' ' << s.Blend << ' '
+                << s.BlendSource << ' ' << s.BlendDestination << ' ' << s.CullFace << ' '
+                << entry.Program.View() << '\n';
+        }
+
+        if (!out) {
+            LOG_CORE_WARN("PipelineWarmup: could not write {}", s_ManifestPath);
+            out.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+void PipelineWarmup::SetRecording(bool enabled) {
+    s_Recording = enabled && s_Initialized;
+    s_RecordedGeneration = ~0u;
+}
+
+u32 PipelineWarmup::GetEntryCount() {
+    return static_cast<u32>(s_Entries.size());
+}
+
+PipelineWarmup::Stats PipelineWarmup::Run() {
+    Stats stats;
+    if (!s_Initialized) return stats;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    Vector<std::pair<Entry*, u32>> pending;     // With the program to draw it with
+    for (Entry& entry : s_Entries) {
+        if (entry.Warm) {
+            ++stats.Warm;
+            continue;
+        }
+        auto program = s_Programs.find(entry.Program);
+        if (program == s_Programs.end()) {
+            ++stats.Pending;
+            continue;
+        }
+        pending.emplace_back(&entry, program->second);
+    }
+    if (pending.empty()) return stats;
+
+    CreateWarmupObjects();
+
+    auto& cache = GLStateCache::Instance();
+    GLStateCache::ScopedState scopedState;
+
+    // Run() happens while loading, where reading the viewport back is fine
+    GLint viewport[4] = {};
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, s_Framebuffer);
+    glViewport(0, 0, 1, 1);
+
+    // Blocks nothing has bound yet read zeros rather than whatever GL has
+    Vector<std::pair<u32, u32>> borrowed;
+    for (const u32 target : {GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER}) {
+        for (u32 index = 0; index < GLStateCache::MaxBufferBindings; ++index) {
+            if (cache.GetBoundBuffer(target, index) != 0) continue;
+            cache.BindBufferBase(target, index, s_ZeroBuffer);
+            borrowed.emplace_back(target, index);
+        }
+    }
+
+    const bool recording = s_Recording;
+    s_Recording = false;
+    for (auto [entry, program] : pending) {
+        cache.Restore(entry->State);
+        cache.UseProgram(program);
+        cache.BindVertexArray(GetWarmupArray(entry->Format).GetRendererID());
+        // Every vertex reads the same zeros: a degenerate primitive, nothing
+        // is rasterized but the driver still builds the pipeline
+        glDrawArrays(entry->Mode, 0, WarmupVertexCount);
+        entry->Warm = true;
+        ++stats.Replayed;
+    }
+    s_Recording = recording;
+    s_RecordedGeneration = ~0u;
+
+    for (const auto& [target, index] : borrowed) {
+        cache.BindBufferBase(target, index, 0);
+    }
+    cache.BindVertexArray(0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    // Some drivers only compile when the commands are submitted; wait so
+    // that happens here and not in the first frame
+    glFinish();
+
+    stats.Milliseconds = std::chrono::duration<f32, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_CORE_INFO("PipelineWarmup: drew {} pipelines in {:.1f} ms ({} pending, {} already warm)", stats.Replayed,
+                  stats.Milliseconds, stats.Pending, stats.Warm);
+    return stats;
+}
+
+void PipelineWarmup::Record(u32 generation, u32 mode) {
+    s_RecordedGeneration = generation;
+    s_RecordedMode = mode;
+
+    auto& cache = GLStateCache::Instance();
+    auto program = s_ProgramKeys.find(cache.GetProgram());
+    if (program == s_ProgramKeys.end()) return;      // Not linked by a Shader
+
+    auto format = s_VertexArrayFormats.find(cache.GetVertexArray());
+    const u64 formatHash = format != s_VertexArrayFormats.end() ? format->second : 0;
+
+    if (Entry* entry = AddEntry(program->second, formatHash, cache.GetSnapshot(), mode)) {
+        entry->Used = true;
+        entry->Warm = true;
+    }
+}
+
+void PipelineWarmup::OnProgramLinked(u32 program, StringId key) {
+    s_ProgramKeys[program] = key;
+    s_Programs[key] = program;
+    s_RecordedGeneration = ~0u;
+}
+
+void PipelineWarmup::OnProgramDeleted(u32 program) {
+    auto it = s_ProgramKeys.find(program);
+    if (it == s_ProgramKeys.end()) return;
+
+    auto live = s_Programs.find(it->second);
+    if (live != s_Programs.end() && live->second == program) {
+        s_Programs.erase(live);
+    }
+    s_ProgramKeys.erase(it);
+}
+
+void PipelineWarmup::OnVertexFormatChanged(u32 vertexArray, const VertexFormat& format) {
+    const u64 hash = format.Hash();
+    s_VertexArrayFormats[vertexArray] = hash;
+    if (hash != 0) {
+        s_Formats.try_emplace(hash, format);
+    }
+    // A change to the bound vertex array doesn't show in the cache's generation
+    s_RecordedGeneration = ~0u;
+}
+
+void PipelineWarmup::OnVertexArrayDeleted(u32 vertexArray) {
+    s_VertexArrayFormats.erase(vertexArray);
+}
+
+} // namespace Engine
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/StringId.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+
+namespace Engine {
+
+struct VertexFormat;
+
+// PipelineWarmup - draws every pipeline the game used in earlier sessions
+// once, offscreen, before the first frame, so drivers compile their
+// state-dependent shader variants during loading instead of on first use.
+//
+// GL drivers finish a program only when it is drawn with: the vertex fetch
+// for the bound attribute formats, the blend and depth setup and the
+// primitive type are baked in at the first draw that uses a combination,
+// which shows as a hitch the first time an effect, material or particle
+// system appears. While recording, every draw call site reports itself
+// with RecordDraw(); the combination of program, vertex format, RenderState
+// and primitive is added to a usage set whenever GLStateCache reports the
+// pipeline changed. Shutdown() merges that set into the manifest on disk -
+// programs named by shader file and defines, vertex formats by their
+// attribute layout - and drops entries unused for MaxUnusedSessions.
+//
+// Run() replays the manifest: for each entry whose program is linked, it
+// draws three vertices from a zero-filled buffer through a vertex array of
+// the recorded format (a degenerate triangle, nothing is rasterized) into a
+// 1x1 framebuffer with the recorded state, every unbound uniform and
+// storage buffer binding pointed at the zero buffer. Entries whose shader
+// isn't loaded yet are skipped and warmed by a later Run() - call it again
+// after loading a level - and an entry is only replayed once per session.
+//
+// Framebuffer formats aren't recorded; drivers that recompile per render
+// target format still hitch on those.
+//
+// GL thread only.
+class PipelineWarmup {
+public:
+    static constexpr u32 MaxEntries = 4096;
+    static constexpr u32 MaxUnusedSessions = 8;
+
+    static void Init(const String& manifestPath = "cache/pipelines.manifest");
+    // Save the manifest and free the warm-up objects
+    static void Shutdown();
+    static bool IsInitialized();
+
+    // Write the manifest now; false if it couldn't be written
+    static bool Save();
+
+    // Record draws into the usage set; on after Init()
+    static void SetRecording(bool enabled);
+    static bool IsRecording() { return s_Recording; }
+
+    struct Stats {
+        u32 Replayed = 0;       // Entries drawn by this run
+        u32 Pending = 0;        // Entries whose program isn't linked yet
+        u32 Warm = 0;           // Entries replayed or recorded earlier this session
+        f32 Milliseconds = 0.0f;
+    };
+
+    // Draw the manifest entries not warm yet
+    static Stats Run();
+
+    // Entries in the manifest and recorded this session
+    static u32 GetEntryCount();
+
+    // Called right before a draw with its primitive mode. Cheap while the
+    // pipeline stays the same.
+    static void RecordDraw(u32 mode) {
+        if (!s_Recording) return;
+        const u32 generation = GLStateCache::Instance().GetPipelineGeneration();
+        if (generation == s_RecordedGeneration && mode == s_RecordedMode) return;
+        Record(generation, mode);
+    }
+
+    // Shader: a program was linked / is about to be deleted
+    static void OnProgramLinked(u32 program, StringId key);
+    static void OnProgramDeleted(u32 program);
+
+    // VertexArray: its format changed / it is about to be deleted
+    static void OnVertexFormatChanged(u32 vertexArray, const VertexFormat& format);
+    static void OnVertexArrayDeleted(u32 vertexArray);
+
+private:
+    static void Record(u32 generation, u32 mode);
+
+    static inline bool s_Recording = false;
+    static inline u32 s_RecordedGeneration = ~0u;
+    static inline u32 s_RecordedMode = ~0u;
+};
+
+} // namespace Engine
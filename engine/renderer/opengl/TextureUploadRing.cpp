@@ -0,0 +1,197 @@
+#include "renderer/opengl/TextureUploadRing.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+namespace Engine {
+
+namespace {
+
+constexpr GLbitfield PersistentMapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+struct Block {
+    u64 Id = 0;
+    usize Offset = 0;
+    usize Size = 0;
+    bool Released = false;
+    GLsync Fence = nullptr;     // Set by the first BeginFrame() after the release
+};
+
+std::mutex s_Mutex;
+u32 s_Buffer = 0;
+u8* s_Mapped = nullptr;
+usize s_Capacity = 0;
+usize s_Head = 0;               // Where the next block goes
+u64 s_NextId = 0;
+u32 s_Generation = 0;           // Bumped by Init(), so blocks of a previous ring are ignored
+u32 s_Failures = 0;
+std::deque<Block> s_Blocks;     // Allocation order, so ids are consecutive
+
+usize AlignUp(usize value, usize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Under s_Mutex. Free space is [head, capacity) plus [0, tail) once wrapped,
+// or [head, tail); head never catches up with tail, so equal means empty.
+bool AllocateRange(usize size, usize& offset) {
+    const usize alignedSize = AlignUp(size, TextureUploadRing::Alignment);
+    if (alignedSize > s_Capacity) return false;
+
+    if (s_Blocks.empty()) {
+        offset = 0;
+    } else {
+        const usize tail = s_Blocks.front().Offset;
+        if (s_Head >= tail) {
+            if (s_Head + alignedSize <= s_Capacity) {
+                offset = s_Head;
+            } else if (alignedSize < tail) {
+                offset = 0;
+            } else {
+                return false;
+            }
+        } else if (s_Head + alignedSize < tail) {
+            offset = s_Head;
+        } else {
+            return false;
+        }
+    }
+
+    s_Head = offset + alignedSize;
+    return true;
+}
+
+bool IsSignaled(GLsync fence) {
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+}
+
+} // anonymous namespace
+
+TextureStaging::~TextureStaging() {
+    TextureUploadRing::Release(m_Id, m_Generation);
+}
+
+bool TextureStaging::IsValid() const {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    return s_Mapped && m_Generation == s_Generation;
+}
+
+void TextureUploadRing::Init(usize capacity) {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    if (s_Mapped) return;
+
+    s_Capacity = AlignUp(capacity, Alignment);
+    glCreateBuffers(1, &s_Buffer);
+    GLMemory::BufferStorage(s_Buffer, static_cast<GLsizeiptr>(s_Capacity), nullptr, PersistentMapFlags,
+                            MemoryTag::Resources);
+    s_Mapped = static_cast<u8*>(glMapNamedBufferRange(s_Buffer, 0, static_cast<GLsizeiptr>(s_Capacity),
+                                                      PersistentMapFlags));
+    if (!s_Mapped) {
+        LOG_CORE_ERROR("TextureUploadRing: failed to map {} bytes, textures upload from client memory", s_Capacity);
+        GLMemory::DeleteBuffers(1, &s_Buffer);
+        s_Capacity = 0;
+        return;
+    }
+
+    s_Head = 0;
+    s_Generation++;
+    LOG_CORE_INFO("Texture upload ring: {} MB", s_Capacity >> 20);
+}
+
+void TextureUploadRing::Shutdown() {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    if (!s_Mapped) return;
+
+    for (auto& block : s_Blocks) {
+        if (block.Fence) glDeleteSync(block.Fence);
+    }
+    s_Blocks.clear();
+
+    glUnmapNamedBuffer(s_Buffer);
+    GLMemory::DeleteBuffers(1, &s_Buffer);
+    s_Mapped = nullptr;
+    s_Capacity = 0;
+    s_Head = 0;
+}
+
+bool TextureUploadRing::IsInitialized() {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    return s_Mapped != nullptr;
+}
+
+Ref<TextureStaging> TextureUploadRing::Stage(const void* data, usize size) {
+    if (!data || size == 0) return nullptr;
+
+    u8* destination = nullptr;
+    u64 id = 0;
+    u32 generation = 0;
+    u32 buffer = 0;
+    usize offset = 0;
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        if (!s_Mapped) return nullptr;
+
+        if (!AllocateRange(size, offset)) {
+            s_Failures++;
+            return nullptr;
+        }
+
+        id = s_NextId++;
+        s_Blocks.push_back({id, offset, size});
+        destination = s_Mapped + offset;
+        generation = s_Generation;
+        buffer = s_Buffer;
+    }
+
+    // Outside the lock: the block is ours until the staging is released
+    std::memcpy(destination, data, size);
+    return CreateRef<TextureStaging>(id, generation, buffer, offset, size);
+}
+
+void TextureUploadRing::Release(u64 id, u32 generation) {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    if (!s_Mapped || generation != s_Generation || s_Blocks.empty()) return;
+
+    const u64 first = s_Blocks.front().Id;
+    if (id < first || id - first >= s_Blocks.size()) return;
+    s_Blocks[static_cast<usize>(id - first)].Released = true;
+}
+
+void TextureUploadRing::BeginFrame() {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    if (!s_Mapped) return;
+
+    // Whatever read a released block was issued before this fence
+    for (auto& block : s_Blocks) {
+        if (block.Released && !block.Fence) {
+            block.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+    }
+
+    while (!s_Blocks.empty() && s_Blocks.front().Fence && IsSignaled(s_Blocks.front().Fence)) {
+        glDeleteSync(s_Blocks.front().Fence);
+        s_Blocks.pop_front();
+    }
+    if (s_Blocks.empty()) {
+        s_Head = 0;
+    }
+}
+
+TextureUploadRing::Stats TextureUploadRing::GetStats() {
+    std::lock_guard<std::mutex> lock(s_Mutex);
+
+    Stats stats;
+    stats.Capacity = s_Capacity;
+    stats.BlocksInUse = static_cast<u32>(s_Blocks.size());
+    stats.StagingFailures = s_Failures;
+    for (const auto& block : s_Blocks) {
+        stats.BytesInUse += block.Size;
+    }
+    return stats;
+}
+
+} // namespace Engine
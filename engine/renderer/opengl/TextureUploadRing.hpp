@@ -0,0 +1,76 @@
+#pragma once
+
+#include "core/Types.hpp"
+
+namespace Engine {
+
+// Pixels copied into the upload ring. The space goes back to the ring when
+// the last Ref is dropped, on any thread, and is reused once the GPU has
+// finished the commands issued before then.
+struct TextureStaging {
+    u32 Buffer = 0;         // GL buffer to bind as GL_PIXEL_UNPACK_BUFFER
+    usize Offset = 0;       // Of the first byte in Buffer
+    usize Size = 0;
+
+    TextureStaging(u64 id, u32 generation, u32 buffer, usize offset, usize size)
+        : Buffer(buffer), Offset(offset), Size(size), m_Id(id), m_Generation(generation) {}
+    ~TextureStaging();
+
+    TextureStaging(const TextureStaging&) = delete;
+    TextureStaging& operator=(const TextureStaging&) = delete;
+
+    // False once the ring it came from was shut down
+    bool IsValid() const;
+
+private:
+    u64 m_Id;
+    u32 m_Generation;
+};
+
+// TextureUploadRing - persistently mapped pixel unpack buffer that decoded
+// texture pixels are staged in off the GL thread.
+//
+// Decoding jobs call Stage() with the bytes an upload will read: they are
+// copied into the ring right there, on the worker, and the texture later
+// uploads with glTextureSubImage2D from the buffer bound to
+// GL_PIXEL_UNPACK_BUFFER at the staged offset. The GL thread then never
+// touches client memory, and the driver copies out of the buffer on the GPU
+// timeline instead of blocking the call while it copies.
+//
+// Space is handed out in order and given back in order: BeginFrame() fences
+// the blocks released since the last call and frees the oldest ones whose
+// fences have signalled. A block held for a long time (a streamed texture's
+// source image) holds up everything staged after it, so long-lived images
+// should drop their staging after the upload. When the ring has no room,
+// Stage() returns null and the upload reads client memory as before.
+//
+// Init() / BeginFrame() / Shutdown() on the GL thread; Stage() anywhere.
+class TextureUploadRing {
+public:
+    static constexpr usize DefaultCapacity = 64ull << 20;
+    static constexpr usize Alignment = 256;
+
+    static void Init(usize capacity = DefaultCapacity);
+    static void Shutdown();
+    static bool IsInitialized();
+
+    // Copy size bytes into the ring; null when it isn't initialized or full
+    static Ref<TextureStaging> Stage(const void* data, usize size);
+
+    // Fence released blocks and reclaim the space of finished ones
+    static void BeginFrame();
+
+    struct Stats {
+        usize Capacity = 0;
+        usize BytesInUse = 0;       // Staged and not reclaimed yet
+        u32 BlocksInUse = 0;
+        u32 StagingFailures = 0;    // Stage() calls that found no room, total
+    };
+    static Stats GetStats();
+
+private:
+    friend struct TextureStaging;
+    static void Release(u64 id, u32 generation);
+};
+
+} // namespace Engine
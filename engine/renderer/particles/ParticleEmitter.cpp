@@ -1,22 +1,107 @@
 #include "renderer/particles/ParticleEmitter.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
+#include "renderer/particles/ParticlePool.hpp"
+#include "renderer/opengl/GPUProfiler.hpp"
 #include "resources/ResourceManager.hpp"
 #include "core/Logger.hpp"
 
 #include <glad/gl.h>
-#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
 
 namespace Engine {
 
-ParticleEmitter::ParticleEmitter(const EmitterSettings& settings)
+namespace {
+
+constexpr i32 SceneDepthSlot = 1;
+
+bool HasSceneDepth(const ParticleSceneDepth* sceneDepth) {
+    return sceneDepth && sceneDepth->Valid && sceneDepth->DepthTexture != 0;
+}
+
+} // anonymous namespace
+
+void BindSceneDepthForCollision(Shader& shader, const ParticleSceneDepth* sceneDepth) {
+    bool valid = HasSceneDepth(sceneDepth);
+    shader.SetInt("u_SceneDepthValid", valid ? 1 : 0);
+    if (!valid) return;
+
+    GLStateCache::Instance().BindTextureUnit(SceneDepthSlot, sceneDepth->DepthTexture);
+    shader.SetInt("u_SceneDepth", SceneDepthSlot);
+    shader.SetMat4("u_DepthViewProjection", sceneDepth->ViewProjection);
+    shader.SetMat4("u_DepthInverseViewProjection", sceneDepth->InverseViewProjection);
+    shader.SetFloat3("u_DepthCameraPosition", sceneDepth->CameraPosition);
+    shader.SetFloat2("u_DepthUVScale", sceneDepth->UVScale);
+}
+
+void BindSceneDepthForSoftParticles(Shader& shader, const ParticleSceneDepth* sceneDepth) {
+    bool valid = HasSceneDepth(sceneDepth);
+    shader.SetInt("u_SceneDepthValid", valid ? 1 : 0);
+    if (!valid) return;
+
+    GLStateCache::Instance().BindTextureUnit(SceneDepthSlot, sceneDepth->DepthTexture);
+    shader.SetInt("u_SceneDepth", SceneDepthSlot);
+    shader.SetFloat2("u_ScreenSize", sceneDepth->ScreenSize);
+    shader.SetFloat2("u_ProjectionParams", sceneDepth->ProjectionParams);
+}
+
+GPUParticleEmitter PackParticleEmitter(const EmitterSettings& settings, const EmitterState& state,
+                                       f32 deltaTime, f32 sizeScale) {
+    GPUParticleEmitter data;
+    data.Position = glm::vec4(settings.Position, 1.0f);
+    data.ShapeSize = glm::vec4(settings.ShapeSize, 0.0f);
+    data.VelocityMin = glm::vec4(settings.VelocityMin, settings.SpeedMin);
+    data.VelocityMax = glm::vec4(settings.VelocityMax, settings.SpeedMax);
+    data.GravityDrag = glm::vec4(settings.Gravity, settings.Drag);
+    data.ColorStart = settings.ColorStart;
+    data.ColorEnd = settings.ColorEnd;
+    data.LifetimeSize = glm::vec4(settings.LifetimeMin, settings.LifetimeMax,
+                                  settings.SizeStart * sizeScale, settings.SizeEnd * sizeScale);
+    data.SpawnParams = glm::vec4(settings.SizeVariance * sizeScale, settings.RotationMin,
+                                 settings.RotationMax, settings.Turbulence);
+    data.TimeParams = glm::vec4(deltaTime, state.Time, settings.AngularVelocityMin, settings.AngularVelocityMax);
+    data.CollisionParams = glm::vec4(settings.CollisionBounce, settings.CollisionFriction,
+                                     settings.CollisionThickness, settings.SoftParticleDistance);
+
+    // The field tiles, so its drift wraps at a tile instead of growing without bound
+    const f32 tileSize = std::max(settings.TurbulenceFieldSize, 1e-3f);
+    const glm::vec3 offset = glm::mod(-settings.TurbulenceFieldScroll * state.Time, glm::vec3(tileSize));
+    data.FieldParams = glm::vec4(offset, 1.0f / tileSize);
+
+    u32 flags = settings.DepthCollision ? PARTICLE_EMITTER_FLAG_DEPTH_COLLISION : 0u;
+    u32 field = settings.TurbulenceField ? 0u : PARTICLE_NO_VECTOR_FIELD;
+    data.Range = glm::uvec4(0u, 0u, 0u, 0u);
+    data.Draw = glm::uvec4(0xFFFFFFFFu, static_cast<u32>(settings.Shape), flags, field);
+    return data;
+}
+
+ParticleEmitter::ParticleEmitter(const EmitterSettings& settings, ParticlePool* pool)
     : m_Settings(settings)
     , m_RNG(std::random_device{}())
 {
+    if (pool) {
+        m_PoolSlot = pool->AllocateRange(m_Settings.MaxParticles);
+        if (m_PoolSlot >= 0) {
+            m_Pool = pool;
+            if (m_Settings.PlayOnStart) {
+                Play();
+            }
+            return;
+        }
+        LOG_CORE_WARN("ParticleEmitter: Particle pool full, using standalone buffers for {} particles",
+                      m_Settings.MaxParticles);
+    }
+
     CreateGPUBuffers();
 
     // Load shaders
     auto& resources = ResourceManager::Instance();
     m_UpdateShader = resources.LoadShader("particle_update", "assets/shaders/particles/particle_update.glsl");
     m_RenderShader = resources.LoadShader("particle_render", "assets/shaders/particles/particle_render.glsl");
+    m_EmitShader = resources.LoadShader("particle_emit", "assets/shaders/particles/particle_emit.glsl");
 
     // Diagnostic logging
     if (!m_UpdateShader) {
@@ -25,17 +110,13 @@ ParticleEmitter::ParticleEmitter(const EmitterSettings& settings)
     if (!m_RenderShader) {
         LOG_CORE_ERROR("ParticleEmitter: Failed to load particle_render shader!");
     }
+    if (!m_EmitShader) {
+        LOG_CORE_ERROR("ParticleEmitter: Failed to load particle_emit shader!");
+    }
 
     // Create dummy VAO for instanced rendering (OpenGL 4.5 requires a VAO to be bound)
     glCreateVertexArrays(1, &m_DummyVAO);
 
-    // Initialize dead list with all indices
-    m_DeadList.resize(m_Settings.MaxParticles);
-    for (u32 i = 0; i < m_Settings.MaxParticles; i++) {
-        m_DeadList[i] = i;
-    }
-    m_NextFreeIndex = 0;
-
     // Auto-play if configured
     if (m_Settings.PlayOnStart) {
         Play();
@@ -49,19 +130,41 @@ ParticleEmitter::~ParticleEmitter() {
 ParticleEmitter::ParticleEmitter(ParticleEmitter&& other) noexcept
     : m_Settings(std::move(other.m_Settings))
     , m_State(other.m_State)
+    , m_Pool(other.m_Pool)
+    , m_PoolSlot(other.m_PoolSlot)
+    , m_SimulationStep(other.m_SimulationStep)
+    , m_LOD(other.m_LOD)
+    , m_LODPendingTime(other.m_LODPendingTime)
+    , m_TickPhase(other.m_TickPhase)
+    , m_SceneDepth(other.m_SceneDepth)
     , m_ParticleSSBO(other.m_ParticleSSBO)
     , m_CounterSSBO(other.m_CounterSSBO)
     , m_DeadListSSBO(other.m_DeadListSSBO)
+    , m_AliveListSSBO(other.m_AliveListSSBO)
+    , m_DrawCommandBuffer(other.m_DrawCommandBuffer)
+    , m_EmitterUBO(other.m_EmitterUBO)
+    , m_DummyVAO(other.m_DummyVAO)
     , m_UpdateShader(std::move(other.m_UpdateShader))
     , m_RenderShader(std::move(other.m_RenderShader))
-    , m_CPUParticles(std::move(other.m_CPUParticles))
-    , m_DeadList(std::move(other.m_DeadList))
-    , m_NextFreeIndex(other.m_NextFreeIndex)
+    , m_TransparentShader(std::move(other.m_TransparentShader))
+    , m_EmitShader(std::move(other.m_EmitShader))
+    , m_Sorter(std::move(other.m_Sorter))
+    , m_PendingEmitCount(other.m_PendingEmitCount)
+    , m_CounterReadback(std::move(other.m_CounterReadback))
     , m_RNG(std::move(other.m_RNG))
 {
+    std::copy(std::begin(other.m_ReadbackEmitted), std::end(other.m_ReadbackEmitted), std::begin(m_ReadbackEmitted));
+    std::copy(std::begin(other.m_ReadbackStale), std::end(other.m_ReadbackStale), std::begin(m_ReadbackStale));
+
     other.m_ParticleSSBO = 0;
     other.m_CounterSSBO = 0;
     other.m_DeadListSSBO = 0;
+    other.m_AliveListSSBO = 0;
+    other.m_DrawCommandBuffer = 0;
+    other.m_EmitterUBO = 0;
+    other.m_DummyVAO = 0;
+    other.m_Pool = nullptr;
+    other.m_PoolSlot = -1;
 }
 
 ParticleEmitter& ParticleEmitter::operator=(ParticleEmitter&& other) noexcept {
@@ -70,19 +173,40 @@ ParticleEmitter& ParticleEmitter::operator=(ParticleEmitter&& other) noexcept {
 
         m_Settings = std::move(other.m_Settings);
         m_State = other.m_State;
+        m_Pool = other.m_Pool;
+        m_PoolSlot = other.m_PoolSlot;
+        m_SimulationStep = other.m_SimulationStep;
+        m_LOD = other.m_LOD;
+        m_LODPendingTime = other.m_LODPendingTime;
+        m_TickPhase = other.m_TickPhase;
+        m_SceneDepth = other.m_SceneDepth;
         m_ParticleSSBO = other.m_ParticleSSBO;
         m_CounterSSBO = other.m_CounterSSBO;
         m_DeadListSSBO = other.m_DeadListSSBO;
+        m_AliveListSSBO = other.m_AliveListSSBO;
+        m_DrawCommandBuffer = other.m_DrawCommandBuffer;
+        m_EmitterUBO = other.m_EmitterUBO;
+        m_DummyVAO = other.m_DummyVAO;
         m_UpdateShader = std::move(other.m_UpdateShader);
         m_RenderShader = std::move(other.m_RenderShader);
-        m_CPUParticles = std::move(other.m_CPUParticles);
-        m_DeadList = std::move(other.m_DeadList);
-        m_NextFreeIndex = other.m_NextFreeIndex;
+        m_TransparentShader = std::move(other.m_TransparentShader);
+        m_EmitShader = std::move(other.m_EmitShader);
+        m_Sorter = std::move(other.m_Sorter);
+        m_PendingEmitCount = other.m_PendingEmitCount;
+        m_CounterReadback = std::move(other.m_CounterReadback);
+        std::copy(std::begin(other.m_ReadbackEmitted), std::end(other.m_ReadbackEmitted), std::begin(m_ReadbackEmitted));
+        std::copy(std::begin(other.m_ReadbackStale), std::end(other.m_ReadbackStale), std::begin(m_ReadbackStale));
         m_RNG = std::move(other.m_RNG);
 
         other.m_ParticleSSBO = 0;
         other.m_CounterSSBO = 0;
         other.m_DeadListSSBO = 0;
+        other.m_AliveListSSBO = 0;
+        other.m_DrawCommandBuffer = 0;
+        other.m_EmitterUBO = 0;
+        other.m_DummyVAO = 0;
+        other.m_Pool = nullptr;
+        other.m_PoolSlot = -1;
     }
     return *this;
 }
@@ -90,54 +214,126 @@ ParticleEmitter& ParticleEmitter::operator=(ParticleEmitter&& other) noexcept {
 void ParticleEmitter::CreateGPUBuffers() {
     u32 maxParticles = m_Settings.MaxParticles;
 
-    // Initialize CPU particle buffer
-    m_CPUParticles.resize(maxParticles);
-    for (auto& p : m_CPUParticles) {
-        p.VelLife.w = -1.0f;  // Mark as dead
-    }
-
-    // Create particle SSBO
+    // Create particle SSBO; no CPU copy is kept, ResetGPUState() fills it on the GPU
     glCreateBuffers(1, &m_ParticleSSBO);
-    glNamedBufferStorage(m_ParticleSSBO,
+    GLMemory::BufferStorage(m_ParticleSSBO,
         maxParticles * sizeof(GPUParticle),
-        m_CPUParticles.data(),
-        GL_DYNAMIC_STORAGE_BIT);
+        nullptr,
+        GL_DYNAMIC_STORAGE_BIT,
+        MemoryTag::Particles);
 
     // Create counter SSBO (aliveCount, deadCount, padding[2])
-    u32 counters[4] = {0, maxParticles, 0, 0};
     glCreateBuffers(1, &m_CounterSSBO);
-    glNamedBufferStorage(m_CounterSSBO, sizeof(counters), counters, GL_DYNAMIC_STORAGE_BIT);
+    GLMemory::BufferStorage(m_CounterSSBO, 4 * sizeof(u32), nullptr, GL_DYNAMIC_STORAGE_BIT, MemoryTag::Particles);
 
     // Create dead list SSBO
     glCreateBuffers(1, &m_DeadListSSBO);
-    glNamedBufferStorage(m_DeadListSSBO,
+    GLMemory::BufferStorage(m_DeadListSSBO,
+        maxParticles * sizeof(u32),
+        nullptr,
+        GL_DYNAMIC_STORAGE_BIT,
+        MemoryTag::Particles);
+
+    // Create alive list SSBO and the indirect draw command it sizes
+    glCreateBuffers(1, &m_AliveListSSBO);
+    GLMemory::BufferStorage(m_AliveListSSBO,
         maxParticles * sizeof(u32),
         nullptr,
-        GL_DYNAMIC_STORAGE_BIT);
+        0,
+        MemoryTag::Particles);
+
+    ParticleDrawCommand command;
+    glCreateBuffers(1, &m_DrawCommandBuffer);
+    GLMemory::BufferStorage(m_DrawCommandBuffer, sizeof(command), &command, GL_DYNAMIC_STORAGE_BIT,
+                            MemoryTag::Particles);
+
+    // Parameters go in one block write per pass instead of a uniform call each
+    glCreateBuffers(1, &m_EmitterUBO);
+    GLMemory::BufferStorage(m_EmitterUBO, sizeof(GPUParticleEmitter), nullptr, GL_DYNAMIC_STORAGE_BIT,
+                            MemoryTag::Particles);
+
+    // Counters come back a few frames late, only for stats and IsFinished()
+    m_CounterReadback = CreateScope<GPUReadbackBuffer>(4 * sizeof(u32));
+
+    ResetGPUState();
 
     LOG_CORE_DEBUG("ParticleEmitter: Created GPU buffers for {} particles", maxParticles);
 }
 
+void ParticleEmitter::ResetGPUState() {
+    const u32 maxParticles = m_Settings.MaxParticles;
+
+    // Every particle starts dead and on the dead list
+    ParticlePool::ResetParticles(m_ParticleSSBO, m_DeadListSSBO, 0, maxParticles);
+
+    u32 counters[4] = {0, maxParticles, 0, 0};
+    glNamedBufferSubData(m_CounterSSBO, 0, sizeof(counters), counters);
+
+    ParticleDrawCommand command;
+    glNamedBufferSubData(m_DrawCommandBuffer, 0, sizeof(command), &command);
+
+    // Copies queued before now describe the old particles
+    std::fill(std::begin(m_ReadbackStale), std::end(m_ReadbackStale), true);
+}
+
 void ParticleEmitter::DestroyGPUBuffers() {
+    if (m_Pool) {
+        m_Pool->FreeRange(m_PoolSlot);
+        m_Pool = nullptr;
+        m_PoolSlot = -1;
+    }
     if (m_ParticleSSBO) {
-        glDeleteBuffers(1, &m_ParticleSSBO);
+        GLMemory::DeleteBuffers(1, &m_ParticleSSBO);
         m_ParticleSSBO = 0;
     }
     if (m_CounterSSBO) {
-        glDeleteBuffers(1, &m_CounterSSBO);
+        GLMemory::DeleteBuffers(1, &m_CounterSSBO);
         m_CounterSSBO = 0;
     }
     if (m_DeadListSSBO) {
-        glDeleteBuffers(1, &m_DeadListSSBO);
+        GLMemory::DeleteBuffers(1, &m_DeadListSSBO);
         m_DeadListSSBO = 0;
     }
+    if (m_AliveListSSBO) {
+        GLMemory::DeleteBuffers(1, &m_AliveListSSBO);
+        m_AliveListSSBO = 0;
+    }
+    if (m_DrawCommandBuffer) {
+        GLMemory::DeleteBuffers(1, &m_DrawCommandBuffer);
+        m_DrawCommandBuffer = 0;
+    }
+    if (m_EmitterUBO) {
+        GLMemory::DeleteBuffers(1, &m_EmitterUBO);
+        m_EmitterUBO = 0;
+    }
     if (m_DummyVAO) {
+        GLStateCache::Instance().OnVertexArrayDeleted(m_DummyVAO);
         glDeleteVertexArrays(1, &m_DummyVAO);
         m_DummyVAO = 0;
     }
+    m_CounterReadback.reset();
+}
+
+void ParticleEmitter::ScheduledUpdate(f32 deltaTime, u64 frameIndex) {
+    // Frozen emitters drop the time instead of catching it up later
+    if (m_LOD.TickInterval == 0) {
+        m_SimulationStep = 0.0f;
+        return;
+    }
+
+    m_LODPendingTime += deltaTime;
+    if ((frameIndex + m_TickPhase) % m_LOD.TickInterval != 0) {
+        m_SimulationStep = 0.0f;
+        return;
+    }
+
+    f32 step = m_LODPendingTime;
+    m_LODPendingTime = 0.0f;
+    Update(step);
 }
 
 void ParticleEmitter::Update(f32 deltaTime) {
+    m_SimulationStep = 0.0f;
     if (!m_State.Playing) return;
 
     m_State.Time += deltaTime;
@@ -157,14 +353,13 @@ void ParticleEmitter::Update(f32 deltaTime) {
         m_State.Time = m_Settings.StartDelay;
     }
 
-    // Continuous spawn
+    // Continuous spawn; the emit pass drops whatever the dead list can't hold
     if (m_Settings.SpawnRate > 0.0f) {
-        m_State.SpawnAccumulator += m_Settings.SpawnRate * deltaTime;
+        m_State.SpawnAccumulator += m_Settings.SpawnRate * m_LOD.SpawnRateScale * deltaTime;
 
-        while (m_State.SpawnAccumulator >= 1.0f && m_State.AliveCount < m_Settings.MaxParticles) {
-            SpawnParticle();
-            m_State.SpawnAccumulator -= 1.0f;
-        }
+        u32 count = static_cast<u32>(m_State.SpawnAccumulator);
+        m_State.SpawnAccumulator -= static_cast<f32>(count);
+        Emit(count);
     }
 
     // Burst spawning
@@ -176,156 +371,210 @@ void ParticleEmitter::Update(f32 deltaTime) {
         }
     }
 
-    // Update particles on GPU
-    UpdateGPU(deltaTime);
+    // Update particles on GPU; pooled emitters step in ParticlePool::Simulate
+    m_SimulationStep = deltaTime;
+    if (!IsPooled()) {
+        UpdateGPU(deltaTime);
+    }
+}
+
+void ParticleEmitter::BindSimulationBuffers() {
+    auto& state = GLStateCache::Instance();
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_ParticleSSBO);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_CounterSSBO);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_DeadListSSBO);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_AliveListSSBO);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_DrawCommandBuffer);
 }
 
 void ParticleEmitter::UpdateGPU(f32 deltaTime) {
-    if (!m_UpdateShader || m_State.AliveCount == 0) return;
+    BindSimulationBuffers();
 
-    m_UpdateShader->Bind();
+    // The alive list is rebuilt from scratch: zero the command's InstanceCount
+    glClearNamedBufferSubData(m_DrawCommandBuffer, GL_R32UI,
+                              offsetof(ParticleDrawCommand, InstanceCount), sizeof(u32),
+                              GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
 
-    // Bind buffers
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_ParticleSSBO);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_CounterSSBO);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_DeadListSSBO);
+    UploadEmitterBlock(deltaTime);
 
-    // Set uniforms
-    m_UpdateShader->SetFloat("u_DeltaTime", deltaTime);
-    m_UpdateShader->SetFloat("u_Time", m_State.Time);
-    m_UpdateShader->SetFloat3("u_Gravity", m_Settings.Gravity);
-    m_UpdateShader->SetFloat("u_Drag", m_Settings.Drag);
-    m_UpdateShader->SetFloat("u_Turbulence", m_Settings.Turbulence);
-    m_UpdateShader->SetFloat4("u_ColorStart", m_Settings.ColorStart);
-    m_UpdateShader->SetFloat4("u_ColorEnd", m_Settings.ColorEnd);
-    m_UpdateShader->SetFloat("u_SizeStart", m_Settings.SizeStart);
-    m_UpdateShader->SetFloat("u_SizeEnd", m_Settings.SizeEnd);
-
-    // Dispatch compute shader
-    u32 workGroups = (m_Settings.MaxParticles + 255) / 256;
-    glDispatchCompute(workGroups, 1, 1);
-
-    // Memory barrier to ensure writes are visible
-    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-
-    // Read back alive count for CPU tracking
-    u32 counters[4];
-    glGetNamedBufferSubData(m_CounterSSBO, 0, sizeof(counters), counters);
-    m_State.AliveCount = counters[0];
+    // Simulate first: particles dying this frame free their slots for the emit pass
+    if (m_UpdateShader && m_State.AliveCount > 0) {
+        m_UpdateShader->Bind();
+
+        if (m_Settings.DepthCollision) {
+            BindSceneDepthForCollision(*m_UpdateShader, m_SceneDepth);
+        }
+        if (m_Settings.TurbulenceField) {
+            m_Settings.TurbulenceField->Bind(PARTICLE_VECTOR_FIELD_UNIT);
+            m_UpdateShader->SetInt("u_VectorField", static_cast<i32>(PARTICLE_VECTOR_FIELD_UNIT));
+        }
+
+        // Dispatch compute shader
+        u32 workGroups = (m_Settings.MaxParticles + 255) / 256;
+        glDispatchCompute(workGroups, 1, 1);
+
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+    }
+
+    DispatchEmit();
+    ReadbackCounters();
 }
 
-void ParticleEmitter::Render(const glm::mat4& viewProjection,
-                              const glm::vec3& cameraRight,
-                              const glm::vec3& cameraUp,
-                              const glm::vec3& cameraPos) {
-    if (!m_RenderShader || m_State.AliveCount == 0) return;
+void ParticleEmitter::UploadEmitterBlock(f32 deltaTime) {
+    GPUParticleEmitter data = PackParticleEmitter(m_Settings, m_State, deltaTime, m_LOD.SizeScale);
+    data.Range = glm::uvec4(0u, m_Settings.MaxParticles, m_PendingEmitCount, static_cast<u32>(m_RNG()));
 
-    m_RenderShader->Bind();
+    glNamedBufferSubData(m_EmitterUBO, 0, sizeof(data), &data);
+    GLStateCache::Instance().BindBufferBase(GL_UNIFORM_BUFFER, PARTICLE_EMITTER_UBO_BINDING, m_EmitterUBO);
+}
 
-    // Bind particle buffer
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_ParticleSSBO);
+void ParticleEmitter::DispatchEmit() {
+    if (m_PendingEmitCount == 0 || !m_EmitShader) return;
 
-    // Set uniforms
-    m_RenderShader->SetMat4("u_ViewProjection", viewProjection);
-    m_RenderShader->SetFloat3("u_CameraRight", cameraRight);
-    m_RenderShader->SetFloat3("u_CameraUp", cameraUp);
-    m_RenderShader->SetFloat3("u_CameraPosition", cameraPos);
-    m_RenderShader->SetInt("u_BlendMode", static_cast<i32>(m_Settings.BlendMode));
+    BindSimulationBuffers();
 
-    // Texture
-    bool useTexture = m_Settings.Texture && m_Settings.Texture->IsLoaded();
-    m_RenderShader->SetInt("u_UseTexture", useTexture ? 1 : 0);
-    if (useTexture) {
-        m_Settings.Texture->Bind(0);
-        m_RenderShader->SetInt("u_Texture", 0);
-    }
+    m_EmitShader->Bind();
+    glDispatchCompute((m_PendingEmitCount + 63) / 64, 1, 1);
+    m_PendingEmitCount = 0;
 
-    // Set blend mode
-    glEnable(GL_BLEND);
-    switch (m_Settings.BlendMode) {
-        case ParticleBlendMode::Additive:
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-            break;
-        case ParticleBlendMode::Alpha:
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            break;
-        case ParticleBlendMode::Multiply:
-            glBlendFunc(GL_DST_COLOR, GL_ZERO);
-            break;
-        case ParticleBlendMode::Premultiplied:
-            glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-            break;
-    }
+    // Rendering reads the particles and the draw command, the next update the counters
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+}
 
-    // Disable depth write for particles (they're transparent)
-    glDepthMask(GL_FALSE);
+void ParticleEmitter::ReadbackCounters() {
+    if (!m_CounterReadback) return;
 
-    // Bind dummy VAO - OpenGL 4.5 requires a VAO to be bound for drawing
-    glBindVertexArray(m_DummyVAO);
+    // The copy reads counters written by the compute passes
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    u32 queued = m_CounterReadback->Enqueue(m_CounterSSBO);
+    m_ReadbackEmitted[queued] = m_State.TotalEmitted;
+    m_ReadbackStale[queued] = false;
+
+    u32 slot = 0;
+    if (!m_CounterReadback->Poll(slot) || m_ReadbackStale[slot]) return;
+
+    const u32* counters = static_cast<const u32*>(m_CounterReadback->GetData(slot));
+    if (!counters) return;
+
+    ApplyAliveReadback(counters[0], m_ReadbackEmitted[slot]);
+}
+
+void ParticleEmitter::ApplyAliveReadback(u32 aliveAtCopy, u32 emittedAtCopy) {
+    // Particles emitted after that copy aren't in its count yet
+    u32 emittedSince = m_State.TotalEmitted - emittedAtCopy;
+    m_State.AliveCount = std::min(aliveAtCopy + emittedSince, m_Settings.MaxParticles);
+}
 
-    // Draw instanced quads (4 vertices per particle)
-    // Using gl_InstanceID in shader to access particle data from SSBO
-    glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, m_Settings.MaxParticles);
+u32 ParticleEmitter::TakePendingEmitCount() {
+    u32 count = m_PendingEmitCount;
+    m_PendingEmitCount = 0;
+    return count;
+}
 
-    // Restore state
-    glDepthMask(GL_TRUE);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+u32 ParticleEmitter::GetParticleSSBO() const {
+    return m_Pool ? m_Pool->GetParticleSSBO() : m_ParticleSSBO;
 }
 
-void ParticleEmitter::SpawnParticle() {
-    if (m_State.AliveCount >= m_Settings.MaxParticles) return;
+void ParticleEmitter::Render(ParticlePass pass) {
+    // The pool draws pooled emitters in one pass
+    if (IsPooled() || !IsDrawnIn(pass)) return;
 
-    // Find a dead slot
-    u32 index = m_NextFreeIndex;
-    m_NextFreeIndex = (m_NextFreeIndex + 1) % m_Settings.MaxParticles;
+    GPU_PROFILE_SCOPE_STATS("Particles");
 
-    // Check if slot is actually free (has negative lifetime)
-    // In a production system, we'd use the dead list from GPU
+    // Bursts requested after Update() (or while paused)
+    if (m_PendingEmitCount > 0) {
+        UploadEmitterBlock(0.0f);
+        DispatchEmit();
+    }
+
+    if (!m_RenderShader || m_State.AliveCount == 0) return;
 
-    GPUParticle p;
+    // The OIT targets blend in any order
+    const bool transparent = pass == ParticlePass::Transparent;
+    if (transparent && !m_TransparentShader) {
+        auto& resources = ResourceManager::Instance();
+        m_TransparentShader = resources.HasShader("particle_render_oit")
+            ? resources.GetShader("particle_render_oit")
+            : resources.LoadShader("particle_render_oit", "assets/shaders/particles/particle_render.glsl",
+                                   {{"OIT", ""}});
+    }
+    Shader& shader = transparent ? *m_TransparentShader : *m_RenderShader;
 
-    // Position
-    p.PosSize.x = m_Settings.Position.x;
-    p.PosSize.y = m_Settings.Position.y;
-    p.PosSize.z = m_Settings.Position.z;
-    glm::vec3 offset = GetSpawnPosition();
-    p.PosSize.x += offset.x;
-    p.PosSize.y += offset.y;
-    p.PosSize.z += offset.z;
+    // Back to front; the sort rewrites the alive list the draw reads
+    if (NeedsDepthSort() && !transparent) {
+        if (!m_Sorter) {
+            m_Sorter = CreateScope<ParticleSorter>(m_Settings.MaxParticles);
+        }
+        m_Sorter->Sort(m_ParticleSSBO, m_AliveListSSBO, m_DrawCommandBuffer, m_State.AliveCount);
+    }
 
-    // Size
-    p.PosSize.w = m_Settings.SizeStart + RandomFloat(-m_Settings.SizeVariance, m_Settings.SizeVariance);
+    shader.Bind();
 
-    // Velocity
-    glm::vec3 vel = GetSpawnVelocity();
-    p.VelLife.x = vel.x;
-    p.VelLife.y = vel.y;
-    p.VelLife.z = vel.z;
+    // Bind particle buffer and the live indices that select them
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_ParticleSSBO);
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_AliveListSSBO);
 
-    // Lifetime
-    f32 lifetime = RandomFloat(m_Settings.LifetimeMin, m_Settings.LifetimeMax);
-    p.VelLife.w = lifetime;
+    // Set uniforms
+    shader.SetInt("u_BlendMode", static_cast<i32>(m_Settings.BlendMode));
+    shader.SetFloat("u_SoftDistance", m_Settings.SoftParticleDistance);
+    BindSceneDepthForSoftParticles(shader, m_SceneDepth);
 
-    // Color
-    p.Color = m_Settings.ColorStart;
+    // Texture
+    bool useTexture = m_Settings.Texture && m_Settings.Texture->IsLoaded();
+    shader.SetInt("u_UseTexture", useTexture ? 1 : 0);
+    if (useTexture) {
+        m_Settings.Texture->Bind(0);
+        shader.SetInt("u_Texture", 0);
+    }
 
-    // Params: age, rotation, angularVelocity, maxLifetime
-    p.Params.x = 0.0f;  // Age
-    p.Params.y = RandomFloat(m_Settings.RotationMin, m_Settings.RotationMax);
-    p.Params.z = RandomFloat(m_Settings.AngularVelocityMin, m_Settings.AngularVelocityMax);
-    p.Params.w = lifetime;  // Max lifetime for interpolation
+    // Set blend mode; WeightedBlendedOIT::Begin() set up the transparent pass
+    if (!transparent) {
+        GLStateCache::Instance().SetBlend(true);
+        switch (m_Settings.BlendMode) {
+            case ParticleBlendMode::Additive:
+                GLStateCache::Instance().SetBlendFunc(GL_SRC_ALPHA, GL_ONE);
+                break;
+            case ParticleBlendMode::Alpha:
+                GLStateCache::Instance().SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                break;
+            case ParticleBlendMode::Multiply:
+                GLStateCache::Instance().SetBlendFunc(GL_DST_COLOR, GL_ZERO);
+                break;
+            case ParticleBlendMode::Premultiplied:
+                GLStateCache::Instance().SetBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+                break;
+        }
+    }
 
-    // Upload single particle to GPU
-    glNamedBufferSubData(m_ParticleSSBO, index * sizeof(GPUParticle), sizeof(GPUParticle), &p);
+    // Disable depth write for particles (they're transparent)
+    GLStateCache::Instance().SetDepthWrite(false);
 
-    m_State.AliveCount++;
-    m_State.TotalEmitted++;
+    // Bind dummy VAO - OpenGL 4.5 requires a VAO to be bound for drawing
+    GLStateCache::Instance().BindVertexArray(m_DummyVAO);
+
+    // One instanced quad per live particle (4 vertices each). The instance
+    // count comes from the GPU, gl_InstanceID indexes the alive list.
+    GLStateCache::Instance().BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_DrawCommandBuffer);
+    PipelineWarmup::RecordDraw(GL_TRIANGLE_FAN);
+    glDrawArraysIndirect(GL_TRIANGLE_FAN, nullptr);
+    GLStateCache::Instance().BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    // Restore state; WeightedBlendedOIT::End() does for the transparent pass
+    if (!transparent) {
+        GLStateCache::Instance().SetDepthWrite(true);
+        GLStateCache::Instance().SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
 }
 
 void ParticleEmitter::Emit(u32 count) {
-    for (u32 i = 0; i < count && m_State.AliveCount < m_Settings.MaxParticles; i++) {
-        SpawnParticle();
-    }
+    // More than MaxParticles in one dispatch could never find slots
+    count = std::min(count, m_Settings.MaxParticles - std::min(m_PendingEmitCount, m_Settings.MaxParticles));
+    if (count == 0) return;
+
+    m_PendingEmitCount += count;
+    m_State.TotalEmitted += count;
+    m_State.AliveCount = std::min(m_State.AliveCount + count, m_Settings.MaxParticles);
 }
 
 void ParticleEmitter::Play() {
@@ -347,97 +596,35 @@ void ParticleEmitter::Reset() {
     m_State.BurstTimer = 0.0f;
     m_State.AliveCount = 0;
     m_State.TotalEmitted = 0;
-    m_NextFreeIndex = 0;
-
-    // Clear all particles on GPU
-    for (auto& p : m_CPUParticles) {
-        p.VelLife.w = -1.0f;
-    }
-    glNamedBufferSubData(m_ParticleSSBO, 0, m_CPUParticles.size() * sizeof(GPUParticle), m_CPUParticles.data());
-
-    // Reset counters
-    u32 counters[4] = {0, m_Settings.MaxParticles, 0, 0};
-    glNamedBufferSubData(m_CounterSSBO, 0, sizeof(counters), counters);
-}
+    m_PendingEmitCount = 0;
 
-bool ParticleEmitter::IsFinished() const {
-    if (m_Settings.Loop) return false;
-    if (m_Settings.Duration > 0.0f) {
-        return m_State.Time >= m_Settings.Duration + m_Settings.StartDelay && m_State.AliveCount == 0;
+    if (m_Pool) {
+        m_Pool->ResetRange(m_PoolSlot);
+        return;
     }
-    return !m_State.Playing && m_State.AliveCount == 0;
-}
 
-f32 ParticleEmitter::RandomFloat(f32 min, f32 max) {
-    return min + m_Dist(m_RNG) * (max - min);
+    // Kill every particle, refill the dead list and reset counters
+    ResetGPUState();
 }
 
-glm::vec3 ParticleEmitter::RandomVec3(const glm::vec3& min, const glm::vec3& max) {
-    return glm::vec3(
-        RandomFloat(min.x, max.x),
-        RandomFloat(min.y, max.y),
-        RandomFloat(min.z, max.z)
-    );
+bool ParticleEmitter::NeedsDepthSort() const {
+    return m_Settings.DepthSort && IsOrderDependent(m_Settings.BlendMode);
 }
 
-glm::vec3 ParticleEmitter::GetSpawnPosition() {
-    switch (m_Settings.Shape) {
-        case EmitterShape::Point:
-            return glm::vec3(0.0f);
-
-        case EmitterShape::Box:
-            return RandomVec3(-m_Settings.ShapeSize * 0.5f, m_Settings.ShapeSize * 0.5f);
-
-        case EmitterShape::Sphere: {
-            // Random point in sphere
-            f32 u = RandomFloat(0.0f, 1.0f);
-            f32 v = RandomFloat(0.0f, 1.0f);
-            f32 theta = 2.0f * glm::pi<f32>() * u;
-            f32 phi = glm::acos(2.0f * v - 1.0f);
-            f32 r = m_Settings.ShapeSize.x * glm::pow(RandomFloat(0.0f, 1.0f), 1.0f / 3.0f);
-            return glm::vec3(
-                r * glm::sin(phi) * glm::cos(theta),
-                r * glm::sin(phi) * glm::sin(theta),
-                r * glm::cos(phi)
-            );
-        }
-
-        case EmitterShape::Circle: {
-            f32 angle = RandomFloat(0.0f, glm::two_pi<f32>());
-            f32 r = m_Settings.ShapeSize.x * glm::sqrt(RandomFloat(0.0f, 1.0f));
-            return glm::vec3(r * glm::cos(angle), 0.0f, r * glm::sin(angle));
-        }
-
-        case EmitterShape::Line: {
-            f32 t = RandomFloat(0.0f, 1.0f);
-            return glm::vec3(t * m_Settings.ShapeSize.x - m_Settings.ShapeSize.x * 0.5f, 0.0f, 0.0f);
-        }
-
-        default:
-            return glm::vec3(0.0f);
+bool ParticleEmitter::IsDrawnIn(ParticlePass pass) const {
+    switch (pass) {
+        case ParticlePass::Blended:     return !IsOrderDependent(m_Settings.BlendMode);
+        case ParticlePass::Transparent: return IsOrderDependent(m_Settings.BlendMode);
+        default:                        return true;
     }
 }
 
-glm::vec3 ParticleEmitter::GetSpawnVelocity() {
-    glm::vec3 vel = RandomVec3(m_Settings.VelocityMin, m_Settings.VelocityMax);
-
-    // Apply speed range
-    f32 speed = RandomFloat(m_Settings.SpeedMin, m_Settings.SpeedMax);
-    if (glm::length(vel) > 0.001f) {
-        vel = glm::normalize(vel) * speed;
-    } else {
-        // Random direction if velocity is zero
-        vel = glm::vec3(
-            RandomFloat(-1.0f, 1.0f),
-            RandomFloat(-1.0f, 1.0f),
-            RandomFloat(-1.0f, 1.0f)
-        );
-        if (glm::length(vel) > 0.001f) {
-            vel = glm::normalize(vel) * speed;
-        }
+bool ParticleEmitter::IsFinished() const {
+    if (m_Settings.Loop) return false;
+    if (m_Settings.Duration > 0.0f) {
+        return m_State.Time >= m_Settings.Duration + m_Settings.StartDelay && m_State.AliveCount == 0;
     }
-
-    return vel;
+    return !m_State.Playing && m_State.AliveCount == 0;
 }
 
 } // namespace Engine
@@ -1,14 +1,30 @@
 #pragma once
 
 #include "ParticleTypes.hpp"
+#include "ParticleSorter.hpp"
 #include "renderer/opengl/GLShader.hpp"
+#include "renderer/opengl/GPUReadbackBuffer.hpp"
 #include <random>
 
 namespace Engine {
 
+class ParticlePool;
+
+// Scene depth uniforms shared by the standalone and pooled shaders. The depth
+// texture goes to slot 1, slot 0 is the particle texture.
+void BindSceneDepthForCollision(Shader& shader, const ParticleSceneDepth* sceneDepth);
+void BindSceneDepthForSoftParticles(Shader& shader, const ParticleSceneDepth* sceneDepth);
+
+// Emitter parameters as the simulation shaders read them. Range is left zero
+// and Draw.x unset (~0u) for the caller to fill.
+GPUParticleEmitter PackParticleEmitter(const EmitterSettings& settings, const EmitterState& state,
+                                       f32 deltaTime, f32 sizeScale);
+
 class ParticleEmitter {
 public:
-    explicit ParticleEmitter(const EmitterSettings& settings);
+    // With a pool the emitter takes a range of its buffers and is simulated
+    // and drawn by the pool; it falls back to its own buffers when full
+    explicit ParticleEmitter(const EmitterSettings& settings, ParticlePool* pool = nullptr);
     ~ParticleEmitter();
 
     // Non-copyable
@@ -21,19 +37,28 @@ public:
 
     // Lifecycle
     void Update(f32 deltaTime);
-    void Render(const glm::mat4& viewProjection, const glm::vec3& cameraRight,
-                const glm::vec3& cameraUp, const glm::vec3& cameraPos);
+
+    // Update() on the frames the LOD tick interval selects, with every
+    // skipped frame's time caught up in that step
+    void ScheduledUpdate(f32 deltaTime, u64 frameIndex);
+    // Camera from the per-frame camera uniform block. Nothing is drawn when
+    // the blend mode isn't part of pass.
+    void Render(ParticlePass pass = ParticlePass::All);
+    bool IsDrawnIn(ParticlePass pass) const;
 
     // Control
     void Play();
     void Pause();
     void Stop();
     void Reset();
-    void Emit(u32 count);  // Burst emit
+    void Emit(u32 count);  // Burst emit, spawned on the GPU with the next dispatch
 
     // State
     bool IsPlaying() const { return m_State.Playing; }
     bool IsFinished() const;
+
+    // Upper bound on live particles: the GPU count read back a few frames
+    // ago plus everything emitted since
     u32 GetAliveCount() const { return m_State.AliveCount; }
 
     // Transform
@@ -45,43 +70,95 @@ public:
     const EmitterSettings& GetSettings() const { return m_Settings; }
 
     // GPU buffer access (for external rendering)
-    u32 GetParticleSSBO() const { return m_ParticleSSBO; }
+    u32 GetParticleSSBO() const;
     u32 GetMaxParticles() const { return m_Settings.MaxParticles; }
 
+    // DepthSort is set and the blend mode depends on draw order
+    bool NeedsDepthSort() const;
+
+    // LOD (chosen by ParticleSystem). The phase staggers reduced-rate ticks
+    // of different emitters across frames.
+    void SetLOD(const EmitterLOD& lod) { m_LOD = lod; }
+    const EmitterLOD& GetLOD() const { return m_LOD; }
+    void SetTickPhase(u32 phase) { m_TickPhase = phase; }
+    f32 GetSizeScale() const { return m_LOD.SizeScale; }
+
+    // Depth for DepthCollision / SoftParticleDistance, owned by the caller
+    void SetSceneDepth(const ParticleSceneDepth* sceneDepth) { m_SceneDepth = sceneDepth; }
+
+    // Pooled simulation (see ParticlePool)
+    bool IsPooled() const { return m_PoolSlot >= 0; }
+    i32 GetPoolSlot() const { return m_PoolSlot; }
+    const EmitterState& GetState() const { return m_State; }
+    f32 GetSimulationStep() const { return m_SimulationStep; }
+    u32 TakePendingEmitCount();
+
+    // Alive count from a counter copy taken when TotalEmitted was emittedAtCopy
+    void ApplyAliveReadback(u32 aliveAtCopy, u32 emittedAtCopy);
+
 private:
     void CreateGPUBuffers();
     void DestroyGPUBuffers();
-    void SpawnParticle();
+    void ResetGPUState();
+    void BindSimulationBuffers();
     void UpdateGPU(f32 deltaTime);
 
-    // Random helpers
-    f32 RandomFloat(f32 min, f32 max);
-    glm::vec3 RandomVec3(const glm::vec3& min, const glm::vec3& max);
-    glm::vec3 GetSpawnPosition();
-    glm::vec3 GetSpawnVelocity();
+    // Write this frame's parameters, with m_PendingEmitCount and a fresh
+    // seed, to the emitter block read by the update and emit passes
+    void UploadEmitterBlock(f32 deltaTime);
+
+    // Pops m_PendingEmitCount slots off the dead list and spawns into them
+    // (after UploadEmitterBlock)
+    void DispatchEmit();
+
+    // Queue this frame's counters and pick up whichever copy has landed
+    void ReadbackCounters();
 
 private:
     EmitterSettings m_Settings;
     EmitterState m_State;
 
+    // Pool range, when the pool simulates this emitter
+    ParticlePool* m_Pool = nullptr;
+    i32 m_PoolSlot = -1;
+    f32 m_SimulationStep = 0.0f;   // Delta time of the last Update(), 0 when paused
+
+    EmitterLOD m_LOD;
+    f32 m_LODPendingTime = 0.0f;    // Time not yet simulated at a reduced rate
+    u32 m_TickPhase = 0;
+
+    const ParticleSceneDepth* m_SceneDepth = nullptr;
+
     // GPU resources
     u32 m_ParticleSSBO = 0;     // Particle data buffer
     u32 m_CounterSSBO = 0;      // Alive/dead counters
     u32 m_DeadListSSBO = 0;     // Dead particle indices
+    u32 m_AliveListSSBO = 0;    // Live particle indices, rebuilt every update
+    u32 m_DrawCommandBuffer = 0; // ParticleDrawCommand sized by the alive list
+    u32 m_EmitterUBO = 0;       // GPUParticleEmitter for the simulation passes
     u32 m_DummyVAO = 0;         // Dummy VAO for instanced rendering
 
     // Shaders
     Ref<Shader> m_UpdateShader;
     Ref<Shader> m_RenderShader;
+    Ref<Shader> m_TransparentShader;    // OIT variant, loaded for the first transparent pass
+    Ref<Shader> m_EmitShader;
+
+    // Created on the first sorted draw
+    Scope<ParticleSorter> m_Sorter;
+
+    // Particles requested since the last emit dispatch
+    u32 m_PendingEmitCount = 0;
 
-    // CPU particle buffer for spawning
-    Vector<GPUParticle> m_CPUParticles;
-    Vector<u32> m_DeadList;
-    u32 m_NextFreeIndex = 0;
+    // Counter SSBO copies, read without waiting on the GPU. Each slot
+    // remembers TotalEmitted at the time of its copy; slots queued before a
+    // Reset() are ignored.
+    Scope<GPUReadbackBuffer> m_CounterReadback;
+    u32 m_ReadbackEmitted[GPUReadbackBuffer::SlotCount] = {};
+    bool m_ReadbackStale[GPUReadbackBuffer::SlotCount] = {};
 
-    // Random number generator
+    // Seeds the emit shader's per-dispatch random streams
     std::mt19937 m_RNG;
-    std::uniform_real_distribution<f32> m_Dist{0.0f, 1.0f};
 };
 
 } // namespace Engine
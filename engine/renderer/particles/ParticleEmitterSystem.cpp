@@ -0,0 +1,97 @@
+#include "renderer/particles/ParticleEmitterSystem.hpp"
+#include "renderer/particles/ParticleEmitter.hpp"
+#include "core/MemoryTracker.hpp"
+
+namespace Engine {
+
+void ParticleEmitterSystem::OnCreate(entt::registry& registry) {
+    m_ParticleSystem.Initialize();
+
+    // Finished bursts are destroyed by the ParticleSystem; forget them here
+    // and clear their components once it has stepped
+    m_ParticleSystem.SetFinishedCallback([this](ParticleEmitter* emitter) {
+        auto it = m_Owners.find(emitter);
+        if (it == m_Owners.end()) return;
+        m_Finished.push_back(it->second);
+        m_Owners.erase(it);
+    });
+
+    registry.on_destroy<ParticleEmitterComponent>().connect<&ParticleEmitterSystem::OnComponentDestroyed>(this);
+}
+
+void ParticleEmitterSystem::OnDestroy(entt::registry& registry) {
+    registry.on_destroy<ParticleEmitterComponent>().disconnect<&ParticleEmitterSystem::OnComponentDestroyed>(this);
+
+    for (auto [entity, emitter] : registry.view<ParticleEmitterComponent>().each()) {
+        emitter.Emitter = nullptr;
+    }
+    m_Owners.clear();
+    m_ParticleSystem.SetFinishedCallback(nullptr);
+    m_ParticleSystem.Shutdown();
+}
+
+void ParticleEmitterSystem::OnComponentDestroyed(entt::registry& registry, entt::entity entity) {
+    DestroyEmitter(registry.get<ParticleEmitterComponent>(entity));
+}
+
+void ParticleEmitterSystem::CreateEmitter(entt::entity entity, ParticleEmitterComponent& component) {
+    component.Emitter = m_ParticleSystem.CreateEmitter(component.Settings);
+    m_Owners[component.Emitter] = entity;
+}
+
+void ParticleEmitterSystem::DestroyEmitter(ParticleEmitterComponent& component) {
+    if (!component.Emitter) return;
+    m_Owners.erase(component.Emitter);
+    m_ParticleSystem.DestroyEmitter(component.Emitter);
+    component.Emitter = nullptr;
+}
+
+void ParticleEmitterSystem::OnUpdate(entt::registry& registry, f32 deltaTime) {
+    MEMORY_TAG(Particles);
+
+    auto placeEmitter = [this](entt::entity entity, ParticleEmitterComponent& emitter, const glm::mat4& world) {
+        if (!emitter.Enabled) {
+            DestroyEmitter(emitter);
+            return;
+        }
+
+        // Buffers (or the pool range) are sized, and pooling decided, when
+        // the emitter is created; changing either starts it over
+        if (emitter.Emitter) {
+            const EmitterSettings& current = emitter.Emitter->GetSettings();
+            if (current.MaxParticles != emitter.Settings.MaxParticles ||
+                current.DepthSort != emitter.Settings.DepthSort) {
+                DestroyEmitter(emitter);
+            }
+        }
+        if (!emitter.Emitter) {
+            CreateEmitter(entity, emitter);
+        }
+
+        // Everything else takes effect in place; Position goes to world space
+        EmitterSettings& settings = emitter.Emitter->GetSettings();
+        settings = emitter.Settings;
+        settings.Position = glm::vec3(world * glm::vec4(emitter.Settings.Position, 1.0f));
+    };
+
+    // One pass per transform layout; an entity has one or the other
+    for (auto [entity, emitter, transform] : registry.view<ParticleEmitterComponent, Transform>().each()) {
+        placeEmitter(entity, emitter, transform.WorldMatrix);
+    }
+    for (auto [entity, emitter, world] : registry.view<ParticleEmitterComponent, WorldTransform>().each()) {
+        placeEmitter(entity, emitter, world.Matrix);
+    }
+
+    // Culls by bounds, then one parameter upload and one dispatch for all pooled emitters
+    m_ParticleSystem.Update(deltaTime);
+
+    for (entt::entity entity : m_Finished) {
+        if (auto* emitter = registry.try_get<ParticleEmitterComponent>(entity)) {
+            emitter->Emitter = nullptr;
+            emitter->Enabled = false;
+        }
+    }
+    m_Finished.clear();
+}
+
+} // namespace Engine
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ecs/System.hpp"
+#include "ecs/Components/Transform.hpp"
+#include "ecs/Components/TransformSoA.hpp"
+#include "ecs/Components/ParticleEmitterComponent.hpp"
+#include "renderer/particles/ParticleSystem.hpp"
+
+namespace Engine {
+
+// ParticleEmitterSystem - simulates the registry's ParticleEmitterComponents.
+//
+// Owns a ParticleSystem whose emitters mirror the components: one is created
+// when a component is first seen enabled, and destroyed with the component
+// or when it is disabled. Each update takes one pass over the components and
+// their world transforms to copy every component's Settings to its emitter,
+// placed in world space, then steps the ParticleSystem once, which culls
+// emitters by their bounds against the camera and writes every pooled
+// emitter's parameters in one upload ahead of its single simulation
+// dispatch. Nothing is per-entity glue code.
+//
+// A one-shot (non-looping) emitter that finishes is destroyed by the
+// ParticleSystem; its component is disabled, so it isn't replayed until
+// enabled again.
+//
+// Creating and stepping emitters is GL work, so it runs in the Render phase,
+// on the thread that owns the context. Drawing stays with the caller, after
+// the scene is lit, through GetParticleSystem().Render(...) as with any
+// other ParticleSystem.
+class ParticleEmitterSystem : public ISystem {
+public:
+    DEFINE_SYSTEM(ParticleEmitterSystem, Render, 40)
+    SYSTEM_ACCESS(.Read<Transform, WorldTransform>().Write<ParticleEmitterComponent>().MainThread())
+
+    void OnCreate(entt::registry& registry) override;
+    void OnDestroy(entt::registry& registry) override;
+    void OnUpdate(entt::registry& registry, f32 deltaTime) override;
+
+    // For culling, LOD and billboarding, as ParticleSystem::SetCamera
+    void SetCamera(Camera* camera) { m_ParticleSystem.SetCamera(camera); }
+
+    ParticleSystem& GetParticleSystem() { return m_ParticleSystem; }
+
+private:
+    void OnComponentDestroyed(entt::registry& registry, entt::entity entity);
+
+    void CreateEmitter(entt::entity entity, ParticleEmitterComponent& component);
+    void DestroyEmitter(ParticleEmitterComponent& component);
+
+private:
+    ParticleSystem m_ParticleSystem;
+    HashMap<ParticleEmitter*, entt::entity> m_Owners;
+    Vector<entt::entity> m_Finished;    // Destroyed by the ParticleSystem this update
+};
+
+} // namespace Engine
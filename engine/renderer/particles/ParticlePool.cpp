@@ -0,0 +1,532 @@
+#include "renderer/particles/ParticlePool.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
+#include "renderer/particles/ParticleEmitter.hpp"
+#include "renderer/opengl/GPUProfiler.hpp"
+#include "resources/ResourceManager.hpp"
+#include "core/FrameAllocator.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 NoEmitter = 0xFFFFFFFFu;
+constexpr u32 CounterStride = 4 * sizeof(u32);
+constexpr u32 InstanceIndexLocation = 8;
+
+void ApplyBlendMode(ParticleBlendMode mode) {
+    auto& state = GLStateCache::Instance();
+    switch (mode) {
+        case ParticleBlendMode::Additive:
+            state.SetBlendFunc(GL_SRC_ALPHA, GL_ONE);
+            break;
+        case ParticleBlendMode::Alpha:
+            state.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            break;
+        case ParticleBlendMode::Multiply:
+            state.SetBlendFunc(GL_DST_COLOR, GL_ZERO);
+            break;
+        case ParticleBlendMode::Premultiplied:
+            state.SetBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            break;
+    }
+}
+
+} // anonymous namespace
+
+ParticlePool::ParticlePool(u32 capacity)
+    : m_Capacity(capacity)
+    , m_RNG(std::random_device{}())
+{
+    m_FreeRanges.push_back({0, m_Capacity});
+    m_SlotRanges.resize(MAX_POOLED_EMITTERS);
+    m_SlotGenerations.resize(MAX_POOLED_EMITTERS, 0);
+
+    CreateGPUBuffers();
+
+    auto& resources = ResourceManager::Instance();
+    m_UpdateShader = resources.LoadShader("particle_pool_update", "assets/shaders/particles/particle_pool_update.glsl");
+    m_EmitShader = resources.LoadShader("particle_pool_emit", "assets/shaders/particles/particle_pool_emit.glsl");
+    m_RenderShader = resources.LoadShader("particle_pool_render", "assets/shaders/particles/particle_pool_render.glsl");
+
+    if (!m_UpdateShader) {
+        LOG_CORE_ERROR("ParticlePool: Failed to load particle_pool_update shader!");
+    }
+    if (!m_EmitShader) {
+        LOG_CORE_ERROR("ParticlePool: Failed to load particle_pool_emit shader!");
+    }
+    if (!m_RenderShader) {
+        LOG_CORE_ERROR("ParticlePool: Failed to load particle_pool_render shader!");
+    }
+}
+
+ParticlePool::~ParticlePool() {
+    DestroyGPUBuffers();
+}
+
+void ParticlePool::CreateGPUBuffers() {
+    glCreateBuffers(1, &m_ParticleSSBO);
+    GLMemory::BufferStorage(m_ParticleSSBO, static_cast<usize>(m_Capacity) * sizeof(GPUParticle), nullptr, GL_DYNAMIC_STORAGE_BIT,
+                            MemoryTag::Particles);
+
+    // Everything starts dead and unowned
+    const glm::vec4 deadParticle(0.0f, 0.0f, 0.0f, -1.0f);
+    glClearNamedBufferData(m_ParticleSSBO, GL_RGBA32F, GL_RGBA, GL_FLOAT, &deadParticle);
+
+    glCreateBuffers(1, &m_OwnerSSBO);
+    GLMemory::BufferStorage(m_OwnerSSBO, static_cast<usize>(m_Capacity) * sizeof(u32), nullptr, GL_DYNAMIC_STORAGE_BIT,
+                            MemoryTag::Particles);
+    glClearNamedBufferData(m_OwnerSSBO, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &NoEmitter);
+
+    glCreateBuffers(1, &m_CounterSSBO);
+    GLMemory::BufferStorage(m_CounterSSBO, MAX_POOLED_EMITTERS * CounterStride, nullptr, GL_DYNAMIC_STORAGE_BIT,
+                            MemoryTag::Particles);
+    glClearNamedBufferData(m_CounterSSBO, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    glCreateBuffers(1, &m_DeadListSSBO);
+    GLMemory::BufferStorage(m_DeadListSSBO, static_cast<usize>(m_Capacity) * sizeof(u32), nullptr, GL_DYNAMIC_STORAGE_BIT,
+                            MemoryTag::Particles);
+
+    glCreateBuffers(1, &m_AliveListSSBO);
+    GLMemory::BufferStorage(m_AliveListSSBO, static_cast<usize>(m_Capacity) * sizeof(u32), nullptr, 0,
+                            MemoryTag::Particles);
+
+    glCreateBuffers(1, &m_DrawCommandBuffer);
+    GLMemory::BufferStorage(m_DrawCommandBuffer, MAX_POOLED_EMITTERS * sizeof(ParticleDrawCommand), nullptr, 0,
+                            MemoryTag::Particles);
+
+    // gl_InstanceID ignores baseInstance, so the render shader reads
+    // baseInstance + gl_InstanceID from an instanced 0..capacity attribute
+    Vector<u32> indices(m_Capacity);
+    std::iota(indices.begin(), indices.end(), 0u);
+    glCreateBuffers(1, &m_InstanceIndexBuffer);
+    GLMemory::BufferStorage(m_InstanceIndexBuffer, indices.size() * sizeof(u32), indices.data(), 0,
+                            MemoryTag::Particles);
+
+    glCreateVertexArrays(1, &m_VAO);
+    glVertexArrayVertexBuffer(m_VAO, 0, m_InstanceIndexBuffer, 0, sizeof(u32));
+    glEnableVertexArrayAttrib(m_VAO, InstanceIndexLocation);
+    glVertexArrayAttribIFormat(m_VAO, InstanceIndexLocation, 1, GL_UNSIGNED_INT, 0);
+    glVertexArrayAttribBinding(m_VAO, InstanceIndexLocation, 0);
+    glVertexArrayBindingDivisor(m_VAO, 0, 1);
+
+    const usize frameCapacity = MAX_POOLED_EMITTERS * (sizeof(GPUParticleEmitter) + sizeof(ParticleDrawCommand)) + 512;
+    m_FrameBuffer = CreateScope<GPURingBuffer>(frameCapacity);
+
+    // Counters come back a few frames late, only for stats and IsFinished()
+    m_CounterReadback = CreateScope<GPUReadbackBuffer>(MAX_POOLED_EMITTERS * CounterStride);
+
+    LOG_CORE_DEBUG("ParticlePool: Created GPU buffers for {} particles", m_Capacity);
+}
+
+void ParticlePool::DestroyGPUBuffers() {
+    u32 buffers[] = {m_ParticleSSBO, m_OwnerSSBO, m_CounterSSBO, m_DeadListSSBO,
+                     m_AliveListSSBO, m_DrawCommandBuffer, m_InstanceIndexBuffer};
+    GLMemory::DeleteBuffers(static_cast<i32>(std::size(buffers)), buffers);
+    m_ParticleSSBO = m_OwnerSSBO = m_CounterSSBO = m_DeadListSSBO = 0;
+    m_AliveListSSBO = m_DrawCommandBuffer = m_InstanceIndexBuffer = 0;
+
+    if (m_VAO) {
+        GLStateCache::Instance().OnVertexArrayDeleted(m_VAO);
+        glDeleteVertexArrays(1, &m_VAO);
+        m_VAO = 0;
+    }
+    m_FrameBuffer.reset();
+    m_CounterReadback.reset();
+}
+
+i32 ParticlePool::AllocateRange(u32 count) {
+    if (count == 0) return InvalidSlot;
+
+    // Lowest free slot keeps the emit dispatch's row count small
+    i32 slot = InvalidSlot;
+    for (u32 i = 0; i < MAX_POOLED_EMITTERS; i++) {
+        if (m_SlotRanges[i].Count == 0) {
+            slot = static_cast<i32>(i);
+            break;
+        }
+    }
+    if (slot == InvalidSlot) return InvalidSlot;
+
+    // First fit
+    auto it = std::find_if(m_FreeRanges.begin(), m_FreeRanges.end(),
+        [count](const Range& range) { return range.Count >= count; });
+    if (it == m_FreeRanges.end()) return InvalidSlot;
+
+    Range range = {it->Offset, count};
+    it->Offset += count;
+    it->Count -= count;
+    if (it->Count == 0) {
+        m_FreeRanges.erase(it);
+    }
+
+    m_SlotRanges[slot] = range;
+    m_SlotCount = std::max(m_SlotCount, static_cast<u32>(slot) + 1);
+    m_UsedCapacity += count;
+    m_HighWater = std::max(m_HighWater, range.Offset + range.Count);
+
+    SetOwner(range, static_cast<u32>(slot));
+    ResetRange(slot);
+
+    return slot;
+}
+
+void ParticlePool::FreeRange(i32 slot) {
+    if (slot < 0 || slot >= static_cast<i32>(m_SlotCount)) return;
+
+    Range range = m_SlotRanges[slot];
+    if (range.Count == 0) return;
+
+    SetOwner(range, NoEmitter);
+    m_SlotRanges[slot] = {};
+    m_SlotGenerations[slot]++;
+    m_UsedCapacity -= range.Count;
+
+    // Insert sorted and merge with the neighbours
+    auto it = std::lower_bound(m_FreeRanges.begin(), m_FreeRanges.end(), range,
+        [](const Range& a, const Range& b) { return a.Offset < b.Offset; });
+    it = m_FreeRanges.insert(it, range);
+
+    auto next = std::next(it);
+    if (next != m_FreeRanges.end() && it->Offset + it->Count == next->Offset) {
+        it->Count += next->Count;
+        m_FreeRanges.erase(next);
+    }
+    if (it != m_FreeRanges.begin()) {
+        auto prev = std::prev(it);
+        if (prev->Offset + prev->Count == it->Offset) {
+            prev->Count += it->Count;
+            m_FreeRanges.erase(it);
+        }
+    }
+
+    // Nothing past a free range that reaches the end needs simulating
+    const Range& last = m_FreeRanges.back();
+    m_HighWater = (last.Offset + last.Count == m_Capacity) ? last.Offset : m_Capacity;
+
+    while (m_SlotCount > 0 && m_SlotRanges[m_SlotCount - 1].Count == 0) {
+        m_SlotCount--;
+    }
+}
+
+void ParticlePool::ResetRange(i32 slot) {
+    if (slot < 0 || slot >= static_cast<i32>(m_SlotCount)) return;
+
+    const Range& range = m_SlotRanges[slot];
+    if (range.Count == 0) return;
+
+    // Every slot of the range starts dead and on its dead stack
+    ResetParticles(m_ParticleSSBO, m_DeadListSSBO, range.Offset, range.Count);
+
+    u32 counters[4] = {0, range.Count, 0, 0};
+    glNamedBufferSubData(m_CounterSSBO, static_cast<usize>(slot) * CounterStride, sizeof(counters), counters);
+
+    // Copies queued before now describe the old particles
+    m_SlotGenerations[slot]++;
+}
+
+void ParticlePool::ResetParticles(u32 particleSSBO, u32 deadListSSBO, u32 offset, u32 count) {
+    if (count == 0) return;
+
+    auto& resources = ResourceManager::Instance();
+    Ref<Shader> shader = resources.HasShader("particle_reset")
+        ? resources.GetShader("particle_reset")
+        : resources.LoadShader("particle_reset", "assets/shaders/particles/particle_reset.glsl");
+
+    if (shader) {
+        shader->Bind();
+        shader->SetUInt("u_Offset", offset);
+        shader->SetUInt("u_Count", count);
+        GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, particleSSBO);
+        GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, deadListSSBO);
+        glDispatchCompute((count + 255) / 256, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        return;
+    }
+
+    // No compute shader: clear in place and upload the dead stack from frame memory
+    LOG_CORE_ERROR("ParticlePool: Failed to load particle_reset shader!");
+    const glm::vec4 deadParticle(0.0f, 0.0f, 0.0f, -1.0f);
+    glClearNamedBufferSubData(particleSSBO, GL_RGBA32F,
+                              static_cast<usize>(offset) * sizeof(GPUParticle),
+                              static_cast<usize>(count) * sizeof(GPUParticle),
+                              GL_RGBA, GL_FLOAT, &deadParticle);
+
+    FrameVector<u32> deadList(count);
+    std::iota(deadList.begin(), deadList.end(), offset);
+    glNamedBufferSubData(deadListSSBO, static_cast<usize>(offset) * sizeof(u32),
+                         deadList.size() * sizeof(u32), deadList.data());
+}
+
+void ParticlePool::SetOwner(const Range& range, u32 owner) {
+    glClearNamedBufferSubData(m_OwnerSSBO, GL_R32UI,
+                              static_cast<usize>(range.Offset) * sizeof(u32),
+                              static_cast<usize>(range.Count) * sizeof(u32),
+                              GL_RED_INTEGER, GL_UNSIGNED_INT, &owner);
+}
+
+void ParticlePool::BindSimulationBuffers() {
+    auto& state = GLStateCache::Instance();
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_ParticleSSBO);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_CounterSSBO);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_DeadListSSBO);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_AliveListSSBO);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_DrawCommandBuffer);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, m_OwnerSSBO);
+}
+
+void ParticlePool::Simulate(const Vector<ParticleEmitter*>& emitters) {
+    m_FrameBuffer->BeginFrame();
+    m_DrawRuns.clear();
+    m_EmitterAllocation = {};
+
+    if (m_SlotCount == 0) return;
+
+    // Slots without an emitter this frame keep their range but sit still
+    m_EmitterData.assign(m_SlotCount, GPUParticleEmitter{});
+    for (u32 slot = 0; slot < m_SlotCount; slot++) {
+        const Range& range = m_SlotRanges[slot];
+        m_EmitterData[slot].Range = glm::uvec4(range.Offset, range.Count, 0u, 0u);
+        m_EmitterData[slot].Draw = glm::uvec4(NoEmitter, 0u, 0u, 0u);
+    }
+
+    u32 maxEmitCount = 0;
+    bool anyAlive = false;
+    m_VectorFields.clear();
+    for (ParticleEmitter* emitter : emitters) {
+        i32 slot = emitter->GetPoolSlot();
+        if (slot < 0 || slot >= static_cast<i32>(m_SlotCount)) continue;
+
+        const Range& range = m_SlotRanges[slot];
+        u32 emitCount = std::min(emitter->TakePendingEmitCount(), range.Count);
+
+        // Paused emitters step by zero, which only re-lists their particles
+        GPUParticleEmitter& data = m_EmitterData[slot];
+        data = PackParticleEmitter(emitter->GetSettings(), emitter->GetState(),
+                                   emitter->GetSimulationStep(), emitter->GetSizeScale());
+        data.Range = glm::uvec4(range.Offset, range.Count, emitCount, static_cast<u32>(m_RNG()));
+        data.Draw.w = AssignVectorField(emitter->GetSettings().TurbulenceField.get());
+
+        maxEmitCount = std::max(maxEmitCount, emitCount);
+        anyAlive = anyAlive || emitter->GetAliveCount() > 0;
+    }
+
+    BuildDrawRuns(emitters);
+
+    m_EmitterAllocation = m_FrameBuffer->Upload(m_EmitterData.data(), m_EmitterData.size());
+    if (!m_EmitterAllocation) return;
+
+    // Fresh commands zero every alive list before the passes append to them
+    if (!m_DrawCommands.empty()) {
+        auto commandAllocation = m_FrameBuffer->Upload(m_DrawCommands.data(), m_DrawCommands.size());
+        if (!commandAllocation) return;
+        glCopyNamedBufferSubData(commandAllocation.Buffer, m_DrawCommandBuffer,
+                                 static_cast<GLintptr>(commandAllocation.Offset), 0,
+                                 static_cast<GLsizeiptr>(commandAllocation.Size));
+    }
+
+    BindSimulationBuffers();
+    GPURingBuffer::BindRange(GL_SHADER_STORAGE_BUFFER, 5, m_EmitterAllocation);
+
+    // Simulate first: particles dying this frame free their slots for the emit pass
+    if (m_UpdateShader && anyAlive && m_HighWater > 0) {
+        m_UpdateShader->Bind();
+        m_UpdateShader->SetUInt("u_ParticleCount", m_HighWater);
+        BindSceneDepthForCollision(*m_UpdateShader, m_SceneDepth);
+        for (usize i = 0; i < m_VectorFields.size(); i++) {
+            m_VectorFields[i]->Bind(PARTICLE_VECTOR_FIELD_UNIT + static_cast<u32>(i));
+        }
+
+        glDispatchCompute((m_HighWater + 255) / 256, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    // One row of workgroups per emitter slot
+    if (m_EmitShader && maxEmitCount > 0) {
+        m_EmitShader->Bind();
+        glDispatchCompute((maxEmitCount + 63) / 64, m_SlotCount, 1);
+    }
+
+    // Rendering reads the particles and the draw commands, the copy the counters
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    ReadbackCounters(emitters);
+}
+
+u32 ParticlePool::AssignVectorField(const VectorField* field) {
+    if (!field) return PARTICLE_NO_VECTOR_FIELD;
+
+    auto it = std::find(m_VectorFields.begin(), m_VectorFields.end(), field);
+    if (it != m_VectorFields.end()) {
+        return static_cast<u32>(it - m_VectorFields.begin());
+    }
+    if (m_VectorFields.size() == MAX_PARTICLE_VECTOR_FIELDS) {
+        // Falls back to the random force
+        if (!m_WarnedVectorFields) {
+            LOG_CORE_WARN("ParticlePool: more than {} vector fields in one simulation", MAX_PARTICLE_VECTOR_FIELDS);
+            m_WarnedVectorFields = true;
+        }
+        return PARTICLE_NO_VECTOR_FIELD;
+    }
+
+    m_VectorFields.push_back(field);
+    return static_cast<u32>(m_VectorFields.size() - 1);
+}
+
+void ParticlePool::BuildDrawRuns(const Vector<ParticleEmitter*>& emitters) {
+    m_DrawOrder.clear();
+    m_DrawCommands.clear();
+
+    for (ParticleEmitter* emitter : emitters) {
+        i32 slot = emitter->GetPoolSlot();
+        if (slot < 0 || slot >= static_cast<i32>(m_SlotCount)) continue;
+        if (emitter->GetAliveCount() == 0 || !emitter->GetLOD().Visible) continue;
+        m_DrawOrder.push_back(emitter);
+    }
+
+    // Group by blend state and texture so each group is one multi-draw
+    std::stable_sort(m_DrawOrder.begin(), m_DrawOrder.end(),
+        [](const ParticleEmitter* a, const ParticleEmitter* b) {
+            const auto& sa = a->GetSettings();
+            const auto& sb = b->GetSettings();
+            if (sa.BlendMode != sb.BlendMode) return sa.BlendMode < sb.BlendMode;
+            return sa.Texture.get() < sb.Texture.get();
+        });
+
+    for (ParticleEmitter* emitter : m_DrawOrder) {
+        const auto& settings = emitter->GetSettings();
+        i32 slot = emitter->GetPoolSlot();
+        u32 commandIndex = static_cast<u32>(m_DrawCommands.size());
+
+        // baseInstance lands the instance attribute at the emitter's range
+        ParticleDrawCommand command;
+        command.BaseInstance = m_SlotRanges[slot].Offset;
+        m_DrawCommands.push_back(command);
+        m_EmitterData[slot].Draw.x = commandIndex;
+
+        if (m_DrawRuns.empty() ||
+            m_DrawRuns.back().BlendMode != settings.BlendMode ||
+            m_DrawRuns.back().Texture != settings.Texture) {
+            DrawRun run;
+            run.BlendMode = settings.BlendMode;
+            run.Texture = settings.Texture;
+            run.FirstCommand = commandIndex;
+            m_DrawRuns.push_back(run);
+        }
+        m_DrawRuns.back().CommandCount++;
+    }
+}
+
+void ParticlePool::ReadbackCounters(const Vector<ParticleEmitter*>& emitters) {
+    if (!m_CounterReadback) return;
+
+    u32 queued = m_CounterReadback->Enqueue(m_CounterSSBO);
+    auto& records = m_ReadbackRecords[queued];
+    records.assign(m_SlotCount, ReadbackRecord{NoEmitter, 0});
+    for (const ParticleEmitter* emitter : emitters) {
+        i32 slot = emitter->GetPoolSlot();
+        if (slot < 0 || slot >= static_cast<i32>(m_SlotCount)) continue;
+        records[slot] = {m_SlotGenerations[slot], emitter->GetState().TotalEmitted};
+    }
+
+    u32 readSlot = 0;
+    if (!m_CounterReadback->Poll(readSlot)) return;
+
+    const u32* counters = static_cast<const u32*>(m_CounterReadback->GetData(readSlot));
+    if (!counters) return;
+
+    // Ranges reset or reassigned since that copy don't match their generation
+    const auto& landed = m_ReadbackRecords[readSlot];
+    for (ParticleEmitter* emitter : emitters) {
+        i32 slot = emitter->GetPoolSlot();
+        if (slot < 0 || slot >= static_cast<i32>(landed.size())) continue;
+        if (landed[slot].Generation != m_SlotGenerations[slot]) continue;
+
+        emitter->ApplyAliveReadback(counters[slot * 4], landed[slot].Emitted);
+    }
+}
+
+void ParticlePool::Render(ParticlePass pass) {
+    if (!m_RenderShader || m_DrawRuns.empty() || !m_EmitterAllocation) return;
+
+    auto isDrawn = [pass](const DrawRun& run) {
+        switch (pass) {
+            case ParticlePass::Blended:     return !IsOrderDependent(run.BlendMode);
+            case ParticlePass::Transparent: return IsOrderDependent(run.BlendMode);
+            default:                        return true;
+        }
+    };
+    if (std::none_of(m_DrawRuns.begin(), m_DrawRuns.end(), isDrawn)) return;
+
+    // The OIT targets blend in any order
+    const bool transparent = pass == ParticlePass::Transparent;
+    if (transparent && !m_TransparentShader) {
+        m_TransparentShader = ResourceManager::Instance().LoadShader(
+            "particle_pool_render_oit", "assets/shaders/particles/particle_pool_render.glsl", {{"OIT", ""}});
+    }
+    Shader& shader = transparent ? *m_TransparentShader : *m_RenderShader;
+
+    GPU_PROFILE_SCOPE_STATS("Particles");
+    shader.Bind();
+
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_ParticleSSBO);
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_AliveListSSBO);
+
+    // Per-emitter soft particle distance, through each particle's owner
+    GPURingBuffer::BindRange(GL_SHADER_STORAGE_BUFFER, 5, m_EmitterAllocation);
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, m_OwnerSSBO);
+    BindSceneDepthForSoftParticles(shader, m_SceneDepth);
+
+    shader.SetInt("u_Texture", 0);
+
+    // WeightedBlendedOIT::Begin() set up the transparent pass
+    if (!transparent) {
+        GLStateCache::Instance().SetBlend(true);
+        GLStateCache::Instance().SetDepthWrite(false);
+    }
+
+    GLStateCache::Instance().BindVertexArray(m_VAO);
+    GLStateCache::Instance().BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_DrawCommandBuffer);
+
+    for (const DrawRun& run : m_DrawRuns) {
+        if (!isDrawn(run)) continue;
+
+        shader.SetInt("u_BlendMode", static_cast<i32>(run.BlendMode));
+
+        bool useTexture = run.Texture && run.Texture->IsLoaded();
+        shader.SetInt("u_UseTexture", useTexture ? 1 : 0);
+        if (useTexture) {
+            run.Texture->Bind(0);
+        }
+
+        if (!transparent) {
+            ApplyBlendMode(run.BlendMode);
+        }
+
+        const usize offset = static_cast<usize>(run.FirstCommand) * sizeof(ParticleDrawCommand);
+        PipelineWarmup::RecordDraw(GL_TRIANGLE_FAN);
+        glMultiDrawArraysIndirect(GL_TRIANGLE_FAN, reinterpret_cast<const void*>(offset),
+                                  static_cast<i32>(run.CommandCount), 0);
+    }
+
+    GLStateCache::Instance().BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    // Restore state; WeightedBlendedOIT::End() does for the transparent pass
+    if (!transparent) {
+        GLStateCache::Instance().SetDepthWrite(true);
+        GLStateCache::Instance().SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
+}
+
+void ParticlePool::EndFrame() {
+    m_FrameBuffer->EndFrame();
+}
+
+} // namespace Engine
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "ParticleTypes.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include "renderer/opengl/GPUReadbackBuffer.hpp"
+#include "renderer/opengl/GPURingBuffer.hpp"
+#include <random>
+
+namespace Engine {
+
+class ParticleEmitter;
+
+// ParticlePool - shared storage for many small emitters.
+//
+// Every pooled emitter owns a contiguous range of one large particle SSBO,
+// with its dead stack and alive list at the same offsets in the pool's
+// index buffers. Emitter parameters are packed into an SSBO each frame, so
+// a single update dispatch and a single emit dispatch simulate all of them,
+// and one glMultiDrawArraysIndirect per blend mode / texture run draws them.
+class ParticlePool {
+public:
+    static constexpr i32 InvalidSlot = -1;
+
+    explicit ParticlePool(u32 capacity = DEFAULT_PARTICLE_POOL_CAPACITY);
+    ~ParticlePool();
+
+    ParticlePool(const ParticlePool&) = delete;
+    ParticlePool& operator=(const ParticlePool&) = delete;
+
+    // Reserve count particles. Returns the emitter slot, or InvalidSlot when
+    // the pool is out of emitter slots or has no free range large enough.
+    i32 AllocateRange(u32 count);
+    void FreeRange(i32 slot);
+
+    // Kill the particles of a range and refill its dead stack
+    void ResetRange(i32 slot);
+
+    // Kill count particles from offset and push them back on the dead stack
+    // at the same offset, on the GPU. Standalone emitters share it: their
+    // buffers are laid out like a single range.
+    static void ResetParticles(u32 particleSSBO, u32 deadListSSBO, u32 offset, u32 count);
+
+    // Step and emit every pooled emitter in the list (ParticleEmitter::Update
+    // must have run this frame)
+    void Simulate(const Vector<ParticleEmitter*>& emitters);
+
+    // Camera from the per-frame camera uniform block; the runs whose blend
+    // mode is part of pass. May be called for several passes a frame.
+    void Render(ParticlePass pass = ParticlePass::All);
+
+    // After the frame's last Render(): the per-frame emitter data may be
+    // recycled once the GPU is done with it
+    void EndFrame();
+
+    u32 GetParticleSSBO() const { return m_ParticleSSBO; }
+    u32 GetCapacity() const { return m_Capacity; }
+    u32 GetUsedCapacity() const { return m_UsedCapacity; }
+    u32 GetDrawCallCount() const { return static_cast<u32>(m_DrawRuns.size()); }
+
+    // Depth for collision and soft particles, owned by the caller
+    void SetSceneDepth(const ParticleSceneDepth* sceneDepth) { m_SceneDepth = sceneDepth; }
+
+private:
+    struct Range {
+        u32 Offset = 0;
+        u32 Count = 0;
+    };
+
+    // Emitters sharing blend state and texture, drawn by one multi-draw
+    struct DrawRun {
+        ParticleBlendMode BlendMode = ParticleBlendMode::Additive;
+        Ref<Texture2D> Texture;
+        u32 FirstCommand = 0;
+        u32 CommandCount = 0;
+    };
+
+    // Emitted total and slot generation at the time of a counter copy
+    struct ReadbackRecord {
+        u32 Generation = 0;
+        u32 Emitted = 0;
+    };
+
+    void CreateGPUBuffers();
+    void DestroyGPUBuffers();
+    void BindSimulationBuffers();
+    void SetOwner(const Range& range, u32 owner);
+    void BuildDrawRuns(const Vector<ParticleEmitter*>& emitters);
+
+    // Texture slot of field in this simulation, PARTICLE_NO_VECTOR_FIELD
+    // for none or when every slot is taken
+    u32 AssignVectorField(const VectorField* field);
+    void ReadbackCounters(const Vector<ParticleEmitter*>& emitters);
+
+private:
+    u32 m_Capacity = 0;
+    u32 m_UsedCapacity = 0;
+    u32 m_HighWater = 0;        // End of the furthest range handed out
+
+    // Free ranges sorted by offset, merged on free
+    Vector<Range> m_FreeRanges;
+
+    // Per emitter slot
+    Vector<Range> m_SlotRanges;
+    Vector<u32> m_SlotGenerations;  // Bumped on allocate / free / reset
+    u32 m_SlotCount = 0;            // Highest slot in use + 1
+
+    // GPU resources
+    u32 m_ParticleSSBO = 0;
+    u32 m_OwnerSSBO = 0;            // Emitter slot of every particle
+    u32 m_CounterSSBO = 0;          // {alive, dead, pad, pad} per slot
+    u32 m_DeadListSSBO = 0;
+    u32 m_AliveListSSBO = 0;
+    u32 m_DrawCommandBuffer = 0;    // ParticleDrawCommand per drawn emitter
+    u32 m_InstanceIndexBuffer = 0;  // 0..capacity, read with baseInstance
+    u32 m_VAO = 0;
+
+    Ref<Shader> m_UpdateShader;
+    Ref<Shader> m_EmitShader;
+    Ref<Shader> m_RenderShader;
+    Ref<Shader> m_TransparentShader;    // OIT variant, loaded for the first transparent pass
+
+    // Per-frame emitter parameters and draw commands
+    Scope<GPURingBuffer> m_FrameBuffer;
+    Vector<GPUParticleEmitter> m_EmitterData;
+    GPURingBuffer::Allocation m_EmitterAllocation;  // Read again by the render pass
+    Vector<ParticleDrawCommand> m_DrawCommands;
+    Vector<ParticleEmitter*> m_DrawOrder;
+    Vector<DrawRun> m_DrawRuns;
+    Vector<const VectorField*> m_VectorFields;     // Bound for the update dispatch, by slot
+    bool m_WarnedVectorFields = false;
+
+    Scope<GPUReadbackBuffer> m_CounterReadback;
+    Vector<ReadbackRecord> m_ReadbackRecords[GPUReadbackBuffer::SlotCount];
+
+    const ParticleSceneDepth* m_SceneDepth = nullptr;
+
+    std::mt19937 m_RNG;
+};
+
+} // namespace Engine
@@ -0,0 +1,89 @@
+#include "renderer/particles/ParticleSorter.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "resources/ResourceManager.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+
+namespace Engine {
+
+namespace {
+
+// Values of the MODE_* constants in particle_sort.glsl
+enum class SortMode : u32 {
+    BuildSortLocal = 0,
+    MergeGlobal = 1,
+    MergeLocal = 2,
+    WriteBack = 3
+};
+
+u32 NextPowerOfTwo(u32 value) {
+    u32 result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+ParticleSorter::ParticleSorter(u32 maxParticles)
+    : m_Capacity(NextPowerOfTwo(std::max(maxParticles, BlockSize)))
+{
+    glCreateBuffers(1, &m_SortBuffer);
+    GLMemory::BufferStorage(m_SortBuffer, static_cast<usize>(m_Capacity) * 2 * sizeof(u32), nullptr, 0,
+                            MemoryTag::Particles);
+
+    m_SortShader = ResourceManager::Instance().LoadShader("particle_sort", "assets/shaders/particles/particle_sort.glsl");
+    if (!m_SortShader) {
+        LOG_CORE_ERROR("ParticleSorter: Failed to load particle_sort shader!");
+    }
+}
+
+ParticleSorter::~ParticleSorter() {
+    if (m_SortBuffer) {
+        GLMemory::DeleteBuffers(1, &m_SortBuffer);
+    }
+}
+
+void ParticleSorter::Sort(u32 particleSSBO, u32 aliveListSSBO, u32 drawCommandBuffer, u32 aliveUpperBound) {
+    auto& state = GLStateCache::Instance();
+    m_LastSortSize = 0;
+    if (!m_SortShader || aliveUpperBound < 2) return;
+
+    // Padded to a power of two; the padding keys sort past the alive list
+    const u32 sortSize = std::min(NextPowerOfTwo(std::max(aliveUpperBound, BlockSize)), m_Capacity);
+    const u32 blockCount = sortSize / BlockSize;
+
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, particleSSBO);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, aliveListSSBO);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, drawCommandBuffer);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, m_SortBuffer);
+
+    m_SortShader->Bind();
+
+    auto dispatch = [&](SortMode mode, u32 mergeSize, u32 mergeStride) {
+        m_SortShader->SetUInt("u_Mode", static_cast<u32>(mode));
+        m_SortShader->SetUInt("u_MergeSize", mergeSize);
+        m_SortShader->SetUInt("u_MergeStride", mergeStride);
+        glDispatchCompute(blockCount, 1, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    };
+
+    dispatch(SortMode::BuildSortLocal, BlockSize, BlockSize / 2);
+
+    for (u32 mergeSize = BlockSize * 2; mergeSize <= sortSize; mergeSize <<= 1) {
+        for (u32 stride = mergeSize / 2; stride >= BlockSize; stride >>= 1) {
+            dispatch(SortMode::MergeGlobal, mergeSize, stride);
+        }
+        dispatch(SortMode::MergeLocal, mergeSize, BlockSize / 2);
+    }
+
+    dispatch(SortMode::WriteBack, 0, 0);
+
+    m_LastSortSize = sortSize;
+}
+
+} // namespace Engine
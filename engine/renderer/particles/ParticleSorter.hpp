@@ -0,0 +1,40 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// ParticleSorter - GPU bitonic sort of an emitter's alive list by camera
+// distance, farthest first, for alpha-blended and premultiplied emitters.
+//
+// Keys are built from the alive list the simulation wrote, so the sorted
+// list feeds the same indirect draw. Each 1024-key block is sorted in shared
+// memory; larger merges take one global pass per stride down to 1024 and
+// finish in shared memory. 1M particles is about 70 dispatches.
+class ParticleSorter {
+public:
+    static constexpr u32 BlockSize = 1024;
+
+    explicit ParticleSorter(u32 maxParticles);
+    ~ParticleSorter();
+
+    ParticleSorter(const ParticleSorter&) = delete;
+    ParticleSorter& operator=(const ParticleSorter&) = delete;
+
+    // Sort the first InstanceCount entries of aliveList. aliveUpperBound
+    // (never below the GPU count) sizes the sort; the draw command supplies
+    // the exact count. Distances are to the camera of the camera uniform block.
+    void Sort(u32 particleSSBO, u32 aliveListSSBO, u32 drawCommandBuffer, u32 aliveUpperBound);
+
+    u32 GetLastSortSize() const { return m_LastSortSize; }
+
+private:
+    Ref<Shader> m_SortShader;
+    u32 m_SortBuffer = 0;       // uvec2 {key, particle index} per entry
+    u32 m_Capacity = 0;         // Power of two, at least BlockSize
+    u32 m_LastSortSize = 0;
+};
+
+} // namespace Engine
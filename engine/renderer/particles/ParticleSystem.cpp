@@ -1,11 +1,61 @@
 #include "renderer/particles/ParticleSystem.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/pipeline/Framebuffer.hpp"
+#include "renderer/pipeline/WeightedBlendedOIT.hpp"
 #include "core/Logger.hpp"
+#include "core/MemoryTracker.hpp"
+#include "core/Telemetry.hpp"
+#include "math/Frustum.hpp"
+#include "resources/ResourceManager.hpp"
 
 #include <glad/gl.h>
 #include <algorithm>
 
 namespace Engine {
 
+namespace {
+
+const TelemetryGauge s_AliveParticles("Particles.Alive");
+const TelemetryGauge s_ActiveEmitters("Particles.ActiveEmitters");
+
+EmitterLOD SelectLOD(const EmitterSettings& settings, const Frustum& frustum,
+                     const glm::vec3& cameraPos, f32 projectionScale) {
+    EmitterLOD lod;
+
+    if (!settings.LODBands.empty()) {
+        f32 distance = glm::length(settings.Position - cameraPos);
+        f32 coverage = distance > settings.BoundsRadius
+            ? settings.BoundsRadius * projectionScale / distance
+            : 1.0f;
+
+        u32 band = static_cast<u32>(settings.LODBands.size()) - 1;
+        for (u32 i = 0; i < settings.LODBands.size(); i++) {
+            const auto& candidate = settings.LODBands[i];
+            if (distance <= candidate.MaxDistance && coverage >= candidate.MinScreenCoverage) {
+                band = i;
+                break;
+            }
+        }
+
+        const auto& selected = settings.LODBands[band];
+        lod.Band = band;
+        lod.TickInterval = std::max(selected.TickInterval, 1u);
+        lod.SpawnRateScale = selected.SpawnRateScale;
+        lod.SizeScale = selected.SizeScale;
+    }
+
+    if (!frustum.IsSphereVisible(settings.Position, settings.BoundsRadius)) {
+        lod.Visible = false;
+        lod.TickInterval = settings.CulledTickInterval == 0
+            ? 0
+            : std::max(lod.TickInterval, settings.CulledTickInterval);
+    }
+
+    return lod;
+}
+
+} // anonymous namespace
+
 ParticleSystem::ParticleSystem() {
     m_Emitters.reserve(32);
 }
@@ -17,6 +67,9 @@ ParticleSystem::~ParticleSystem() {
 void ParticleSystem::Initialize() {
     if (m_Initialized) return;
 
+    m_Pool = CreateScope<ParticlePool>();
+    m_Pool->SetSceneDepth(&m_SceneDepth);
+
     LOG_CORE_INFO("ParticleSystem initialized");
     m_Initialized = true;
 }
@@ -25,6 +78,7 @@ void ParticleSystem::Shutdown() {
     if (!m_Initialized) return;
 
     ClearAllEmitters();
+    m_Pool.reset();
     m_Initialized = false;
 
     LOG_CORE_INFO("ParticleSystem shutdown");
@@ -32,86 +86,152 @@ void ParticleSystem::Shutdown() {
 
 void ParticleSystem::Update(f32 deltaTime) {
     if (!m_Initialized) return;
+    MEMORY_TAG(Particles);
 
     f32 scaledDt = deltaTime * m_TimeScale;
 
-    // Update all emitters
+    UpdateLOD();
+
+    // Update all emitters; reduced-rate ones tick on their scheduled frames
     for (auto& emitter : m_Emitters) {
         if (emitter) {
-            emitter->Update(scaledDt);
+            emitter->ScheduledUpdate(scaledDt, m_FrameIndex);
+        }
+    }
+    m_FrameIndex++;
+
+    // Remove finished non-looping emitters, returning their slots to the pool
+    usize kept = 0;
+    for (ParticleEmitter* emitter : m_Emitters) {
+        if (emitter->IsFinished() && !emitter->GetSettings().Loop) {
+            if (m_OnFinished) m_OnFinished(emitter);
+            m_EmitterStorage.Destroy(emitter);
+        } else {
+            m_Emitters[kept++] = emitter;
         }
     }
+    m_Emitters.resize(kept);
 
-    // Remove finished non-looping emitters
-    m_Emitters.erase(
-        std::remove_if(m_Emitters.begin(), m_Emitters.end(),
-            [](const Scope<ParticleEmitter>& e) {
-                return e && e->IsFinished() && !e->GetSettings().Loop;
-            }),
-        m_Emitters.end()
-    );
+    // Simulate every pooled emitter at once
+    m_PooledEmitters.clear();
+    for (ParticleEmitter* emitter : m_Emitters) {
+        if (emitter->IsPooled()) {
+            m_PooledEmitters.push_back(emitter);
+        }
+    }
+    if (m_Pool) {
+        m_Pool->Simulate(m_PooledEmitters);
+    }
 
     UpdateStats();
 }
 
-void ParticleSystem::Render() {
+bool ParticleSystem::BeginRender() {
     if (!m_Initialized) {
         LOG_CORE_WARN("ParticleSystem::Render() called but system not initialized");
-        return;
+        return false;
     }
     if (!m_Camera) {
         LOG_CORE_WARN("ParticleSystem::Render() called but no camera set (call SetCamera first)");
-        return;
+        return false;
     }
 
-    // Get camera vectors for billboarding
-    glm::mat4 viewProj = m_Camera->GetViewProjectionMatrix();
-    glm::vec3 cameraPos = m_Camera->GetPosition();
+    // The depth bound now was rendered with this camera; billboarding and
+    // sorting read it from the camera uniform block
+    if (m_SceneDepth.DepthTexture) {
+        const glm::mat4& projection = m_Camera->GetProjectionMatrix();
+        m_SceneDepth.ViewProjection = m_Camera->GetViewProjectionMatrix();
+        m_SceneDepth.InverseViewProjection = m_Camera->GetInverseViewProjectionMatrix();
+        m_SceneDepth.CameraPosition = m_Camera->GetPosition();
+        m_SceneDepth.ProjectionParams = glm::vec2(projection[2][2], projection[3][2]);
+        m_SceneDepth.Valid = true;
+    }
+    return true;
+}
 
-    // Extract right and up vectors from view matrix
-    glm::mat4 view = m_Camera->GetViewMatrix();
-    glm::vec3 cameraRight = glm::vec3(view[0][0], view[1][0], view[2][0]);
-    glm::vec3 cameraUp = glm::vec3(view[0][1], view[1][1], view[2][1]);
+void ParticleSystem::RenderPass(ParticlePass pass) {
+    for (auto& emitter : m_Emitters) {
+        if (emitter && !emitter->IsPooled() && emitter->GetLOD().Visible && emitter->GetAliveCount() > 0) {
+            emitter->Render(pass);
+        }
+    }
 
-    // Sort emitters by blend mode (draw alpha-blended last)
-    // For now, just render in order
+    if (m_Pool) {
+        m_Pool->Render(pass);
+    }
+}
+
+void ParticleSystem::Render() {
+    MEMORY_TAG(Particles);
+    if (!BeginRender()) return;
 
     // Disable depth writing for transparent particles
-    glDepthMask(GL_FALSE);
-    glEnable(GL_BLEND);
+    GLStateCache::Instance().SetDepthWrite(false);
+    GLStateCache::Instance().SetBlend(true);
 
-    for (auto& emitter : m_Emitters) {
-        if (emitter && emitter->GetAliveCount() > 0) {
-            emitter->Render(viewProj, cameraRight, cameraUp, cameraPos);
-        }
+    RenderPass(ParticlePass::All);
+    if (m_Pool) {
+        m_Pool->EndFrame();
     }
 
     // Restore state
-    glDepthMask(GL_TRUE);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLStateCache::Instance().SetDepthWrite(true);
+    GLStateCache::Instance().SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void ParticleSystem::Render(WeightedBlendedOIT& transparency, Framebuffer& target) {
+    MEMORY_TAG(Particles);
+    if (!BeginRender()) return;
+
+    const bool hasTransparent = std::any_of(m_Emitters.begin(), m_Emitters.end(), [](const ParticleEmitter* emitter) {
+        return emitter && emitter->IsDrawnIn(ParticlePass::Transparent) && emitter->GetLOD().Visible &&
+               emitter->GetAliveCount() > 0;
+    });
+
+    if (hasTransparent) {
+        transparency.Begin(target);
+        RenderPass(ParticlePass::Transparent);
+        transparency.End();
+        transparency.Composite(target);
+    }
+
+    // Additive and multiplied emitters over the resolved ones
+    target.Bind();
+    GLStateCache::Instance().SetDepthWrite(false);
+    GLStateCache::Instance().SetBlend(true);
+    RenderPass(ParticlePass::Blended);
+    if (m_Pool) {
+        m_Pool->EndFrame();
+    }
+
+    GLStateCache::Instance().SetDepthWrite(true);
+    GLStateCache::Instance().SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
 ParticleEmitter* ParticleSystem::CreateEmitter(const EmitterSettings& settings) {
-    auto emitter = CreateScope<ParticleEmitter>(settings);
-    ParticleEmitter* ptr = emitter.get();
-    m_Emitters.push_back(std::move(emitter));
+    // Sorting works on an emitter's own alive list, so sorted emitters stay standalone
+    ParticlePool* pool = (m_PoolingEnabled && !settings.DepthSort) ? m_Pool.get() : nullptr;
+    ParticleEmitter* emitter = m_EmitterStorage.Create(settings, pool);
+    emitter->SetTickPhase(m_NextTickPhase++);
+    emitter->SetSceneDepth(&m_SceneDepth);
+    m_Emitters.push_back(emitter);
 
     LOG_CORE_DEBUG("ParticleSystem: Created emitter (max {} particles)", settings.MaxParticles);
-    return ptr;
+    return emitter;
 }
 
 void ParticleSystem::DestroyEmitter(ParticleEmitter* emitter) {
-    m_Emitters.erase(
-        std::remove_if(m_Emitters.begin(), m_Emitters.end(),
-            [emitter](const Scope<ParticleEmitter>& e) {
-                return e.get() == emitter;
-            }),
-        m_Emitters.end()
-    );
+    auto it = std::find(m_Emitters.begin(), m_Emitters.end(), emitter);
+    if (it == m_Emitters.end()) return;
+
+    m_Emitters.erase(it);
+    m_EmitterStorage.Destroy(emitter);
 }
 
 void ParticleSystem::ClearAllEmitters() {
     m_Emitters.clear();
+    m_PooledEmitters.clear();
+    m_EmitterStorage.Clear();
 }
 
 void ParticleSystem::PauseAll() {
@@ -130,11 +250,62 @@ void ParticleSystem::ResumeAll() {
     }
 }
 
+void ParticleSystem::SetSceneDepth(u32 depthTexture, u32 width, u32 height, const glm::vec2& uvScale) {
+    if (m_SceneDepth.DepthTexture != depthTexture) {
+        m_SceneDepth.Valid = false;
+    }
+    m_SceneDepth.DepthTexture = depthTexture;
+    m_SceneDepth.ScreenSize = glm::vec2(static_cast<f32>(width), static_cast<f32>(height));
+    m_SceneDepth.UVScale = uvScale;
+}
+
+void ParticleSystem::UpdateLOD() {
+    // Without a camera everything runs at full rate
+    if (!m_Camera) {
+        for (auto& emitter : m_Emitters) {
+            if (emitter) {
+                emitter->SetLOD(EmitterLOD{});
+            }
+        }
+        return;
+    }
+
+    const Frustum& frustum = m_Camera->GetFrustum();
+    glm::vec3 cameraPos = m_Camera->GetPosition();
+
+    // Bounds radius -> fraction of the screen height
+    f32 projectionScale = m_Camera->GetProjectionMatrix()[1][1];
+
+    // Streamed emitter textures ask for the mip their largest particle needs
+    // at the near edge of the bounds
+    TextureStreamer& streamer = ResourceManager::Instance().GetTextureStreamer();
+    const f32 halfScreenHeight = m_SceneDepth.ScreenSize.y * 0.5f;
+
+    for (auto& emitter : m_Emitters) {
+        if (!emitter) continue;
+
+        const auto& settings = emitter->GetSettings();
+        emitter->SetLOD(SelectLOD(settings, frustum, cameraPos, projectionScale));
+
+        if (settings.Texture && emitter->GetLOD().Visible && halfScreenHeight > 0.0f) {
+            const f32 distance = std::max(glm::length(settings.Position - cameraPos) - settings.BoundsRadius, 0.01f);
+            const f32 size = std::max(settings.SizeStart, settings.SizeEnd) * emitter->GetSizeScale();
+            streamer.RequestScreenSize(*settings.Texture, size * projectionScale / distance * halfScreenHeight);
+        }
+    }
+}
+
 void ParticleSystem::UpdateStats() {
     m_Stats.TotalEmitters = static_cast<u32>(m_Emitters.size());
     m_Stats.ActiveEmitters = 0;
     m_Stats.TotalParticles = 0;
     m_Stats.AliveParticles = 0;
+    m_Stats.PooledEmitters = static_cast<u32>(m_PooledEmitters.size());
+    m_Stats.SortedEmitters = 0;
+    m_Stats.CulledEmitters = 0;
+    m_Stats.ReducedEmitters = 0;
+    m_Stats.PoolCapacityUsed = m_Pool ? m_Pool->GetUsedCapacity() : 0;
+    m_Stats.PoolDrawCalls = m_Pool ? m_Pool->GetDrawCallCount() : 0;
 
     for (const auto& emitter : m_Emitters) {
         if (emitter) {
@@ -143,8 +314,22 @@ void ParticleSystem::UpdateStats() {
             if (emitter->IsPlaying()) {
                 m_Stats.ActiveEmitters++;
             }
+            if (!emitter->IsPooled() && emitter->NeedsDepthSort()) {
+                m_Stats.SortedEmitters++;
+            }
+
+            const EmitterLOD& lod = emitter->GetLOD();
+            if (!lod.Visible) {
+                m_Stats.CulledEmitters++;
+            }
+            if (lod.TickInterval != 1 || lod.SpawnRateScale < 1.0f) {
+                m_Stats.ReducedEmitters++;
+            }
         }
     }
+
+    s_AliveParticles.Set(m_Stats.AliveParticles);
+    s_ActiveEmitters.Set(m_Stats.ActiveEmitters);
 }
 
 } // namespace Engine
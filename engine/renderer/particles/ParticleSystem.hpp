@@ -1,11 +1,17 @@
 #pragma once
 
 #include "ParticleEmitter.hpp"
+#include "ParticlePool.hpp"
 #include "camera/Camera.hpp"
+#include "core/ObjectPool.hpp"
+#include <functional>
 
 namespace Engine {
 
-// Standalone particle system for use in demos (non-ECS)
+class Framebuffer;
+class WeightedBlendedOIT;
+
+// Particle system driven directly (demos) or by ParticleEmitterSystem (ECS)
 class ParticleSystem {
 public:
     ParticleSystem();
@@ -15,11 +21,29 @@ public:
     void Initialize();
     void Shutdown();
     void Update(f32 deltaTime);
+
+    // Every emitter into the bound framebuffer, blended in emitter order;
+    // emitters with DepthSort are sorted back to front first
     void Render();
 
+    // Alpha and Premultiplied emitters accumulate into transparency in any
+    // order, unsorted, and are composited over target in one pass; Additive
+    // and Multiply ones, whose order never mattered, then blend straight
+    // into target. target's depth must hold the scene depth and its first
+    // color attachment must be RGBA16F (the lighting buffer).
+    void Render(WeightedBlendedOIT& transparency, Framebuffer& target);
+
     // Camera (required for billboarding)
     void SetCamera(Camera* camera) { m_Camera = camera; }
 
+    // Scene depth (e.g. the G-buffer depth) for depth collision and soft
+    // particles. Render() must run after the depth is written; collision in
+    // the next Update() reuses that frame's depth and camera. 0 disables.
+    // width / height are the texture's size; uvScale is the part of it the
+    // scene was rendered into (DeferredLightingSystem::GetRenderUVScale).
+    void SetSceneDepth(u32 depthTexture, u32 width, u32 height,
+                       const glm::vec2& uvScale = glm::vec2(1.0f));
+
     // Emitter management
     ParticleEmitter* CreateEmitter(const EmitterSettings& settings);
     void DestroyEmitter(ParticleEmitter* emitter);
@@ -32,15 +56,43 @@ public:
     void PauseAll();
     void ResumeAll();
 
+    // New emitters share the particle pool (one dispatch / multi-draw for all)
+    void SetPoolingEnabled(bool enabled) { m_PoolingEnabled = enabled; }
+    bool IsPoolingEnabled() const { return m_PoolingEnabled; }
+
+    // Finished non-looping emitters are destroyed by Update(). Owners that
+    // hold emitter pointers (ParticleEmitterSystem) are told about each one
+    // just before, to drop theirs.
+    using FinishedCallback = std::function<void(ParticleEmitter*)>;
+    void SetFinishedCallback(FinishedCallback callback) { m_OnFinished = std::move(callback); }
+
     // Stats
     const ParticleStats& GetStats() const { return m_Stats; }
 
 private:
+    // Scene depth matrices for this frame's draws; false if rendering can't happen
+    bool BeginRender();
+    void RenderPass(ParticlePass pass);
+
+    // Pick each emitter's LOD band and visibility from the camera
+    void UpdateLOD();
     void UpdateStats();
 
 private:
-    Vector<Scope<ParticleEmitter>> m_Emitters;
+    // Declared before the emitters, which free their ranges on destruction
+    Scope<ParticlePool> m_Pool;
+
+    // Emitters live in pooled slots so bursts of short-lived effects reuse
+    // memory instead of going back to the heap; m_Emitters is the update order
+    ObjectPool<ParticleEmitter> m_EmitterStorage;
+    Vector<ParticleEmitter*> m_Emitters;
+    Vector<ParticleEmitter*> m_PooledEmitters;
+    bool m_PoolingEnabled = true;
+    FinishedCallback m_OnFinished;
+    u64 m_FrameIndex = 0;
+    u32 m_NextTickPhase = 0;
     Camera* m_Camera = nullptr;
+    ParticleSceneDepth m_SceneDepth;
     f32 m_TimeScale = 1.0f;
     bool m_Initialized = false;
     ParticleStats m_Stats;
@@ -2,6 +2,7 @@
 
 #include "core/Types.hpp"
 #include "renderer/Texture.hpp"
+#include "renderer/particles/VectorField.hpp"
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
 
@@ -17,6 +18,69 @@ struct GPUParticle {
 
 static_assert(sizeof(GPUParticle) == 64, "GPUParticle must be 64 bytes for GPU alignment");
 
+// glDrawArraysIndirect command; the update / emit passes bump InstanceCount
+// for every live particle they append to the alive list
+struct ParticleDrawCommand {
+    u32 Count = 4;              // Quad corners
+    u32 InstanceCount = 0;
+    u32 First = 0;
+    u32 BaseInstance = 0;
+};
+
+// Shared particle pool (see ParticlePool)
+constexpr u32 DEFAULT_PARTICLE_POOL_CAPACITY = 256 * 1024;
+constexpr u32 MAX_POOLED_EMITTERS = 1024;
+
+// Per-emitter parameters of the pooled simulation (std430, matches
+// EmitterParams in particle_pool_update.glsl / particle_pool_emit.glsl)
+struct alignas(16) GPUParticleEmitter {
+    glm::vec4 Position;         // xyz = position
+    glm::vec4 ShapeSize;        // xyz = box size or sphere radius
+    glm::vec4 VelocityMin;      // xyz = velocity min, w = speed min
+    glm::vec4 VelocityMax;      // xyz = velocity max, w = speed max
+    glm::vec4 GravityDrag;      // xyz = gravity, w = drag
+    glm::vec4 ColorStart;
+    glm::vec4 ColorEnd;
+    glm::vec4 LifetimeSize;     // x = lifetime min, y = lifetime max, z = size start, w = size end
+    glm::vec4 SpawnParams;      // x = size variance, y = rotation min, z = rotation max, w = turbulence
+    glm::vec4 TimeParams;       // x = delta time, y = time, z = angular velocity min, w = angular velocity max
+    glm::vec4 CollisionParams;  // x = bounce, y = friction, z = thickness, w = soft particle distance
+    glm::uvec4 Range;           // x = first particle, y = capacity, z = emit count, w = seed
+    glm::uvec4 Draw;            // x = draw command index (~0u = not drawn), y = EmitterShape, z = flags,
+                                // w = vector field slot (PARTICLE_NO_VECTOR_FIELD = random turbulence)
+    glm::vec4 FieldParams;      // xyz = vector field offset, w = 1 / field tile size
+};
+
+static_assert(sizeof(GPUParticleEmitter) == 224, "GPUParticleEmitter must match the std430 layout");
+
+// GPUParticleEmitter::Draw.z
+constexpr u32 PARTICLE_EMITTER_FLAG_DEPTH_COLLISION = 1u << 0;
+
+// GPUParticleEmitter::Draw.w of emitters without a TurbulenceField
+constexpr u32 PARTICLE_NO_VECTOR_FIELD = ~0u;
+
+// Vector fields a pooled simulation dispatch can sample, on texture units
+// PARTICLE_VECTOR_FIELD_UNIT onwards; a standalone emitter uses the first
+constexpr u32 MAX_PARTICLE_VECTOR_FIELDS = 4;
+constexpr u32 PARTICLE_VECTOR_FIELD_UNIT = 2;
+
+// Uniform block binding of a standalone emitter's GPUParticleEmitter
+// (std140 matches the std430 layout above)
+constexpr u32 PARTICLE_EMITTER_UBO_BINDING = 2;
+
+// Scene depth the particles collide with and fade against, see
+// ParticleSystem::SetSceneDepth
+struct ParticleSceneDepth {
+    u32 DepthTexture = 0;
+    bool Valid = false;                     // Matrices match the texture contents
+    glm::mat4 ViewProjection{1.0f};         // Camera the depth was rendered with
+    glm::mat4 InverseViewProjection{1.0f};
+    glm::vec3 CameraPosition{0.0f};
+    glm::vec2 ScreenSize{0.0f};
+    glm::vec2 UVScale{1.0f};                // Rendered region of the texture (dynamic resolution)
+    glm::vec2 ProjectionParams{0.0f};       // projection[2][2], projection[3][2]
+};
+
 // Blend modes for particle rendering
 enum class ParticleBlendMode : u32 {
     Additive = 0,   // Fire, sparks, glow effects
@@ -25,6 +89,19 @@ enum class ParticleBlendMode : u32 {
     Premultiplied = 3  // Pre-multiplied alpha
 };
 
+// Alpha and Premultiplied blending depend on draw order; Additive and
+// Multiply commute
+inline bool IsOrderDependent(ParticleBlendMode mode) {
+    return mode == ParticleBlendMode::Alpha || mode == ParticleBlendMode::Premultiplied;
+}
+
+// Emitters a particle draw covers
+enum class ParticlePass : u8 {
+    All,            // Every emitter, blended into the bound target in emitter order
+    Blended,        // Order-independent blend modes only
+    Transparent     // Order-dependent ones, into WeightedBlendedOIT targets, unsorted
+};
+
 // Emitter shape for spawn positions
 enum class EmitterShape : u32 {
     Point = 0,      // All particles spawn at center
@@ -35,6 +112,17 @@ enum class EmitterShape : u32 {
     Line = 5        // Along a line segment
 };
 
+// Reduced simulation for distant or small emitters. A band applies while
+// the camera is within MaxDistance and the emitter bounds cover at least
+// MinScreenCoverage of the screen height; past every band the last one holds.
+struct ParticleLODBand {
+    f32 MaxDistance = 0.0f;
+    f32 MinScreenCoverage = 0.0f;
+    f32 SpawnRateScale = 1.0f;
+    f32 SizeScale = 1.0f;
+    u32 TickInterval = 1;           // Simulate every Nth frame, skipped time caught up
+};
+
 // Particle emitter settings
 struct EmitterSettings {
     // === Spawn Settings ===
@@ -78,10 +166,21 @@ struct EmitterSettings {
     // === Physics ===
     glm::vec3 Gravity = glm::vec3(0.0f, -9.81f, 0.0f);
     f32 Drag = 0.1f;
-    f32 Turbulence = 0.0f;          // Random force strength
+    f32 Turbulence = 0.0f;          // Random force strength, or the field's with a TurbulenceField
+    Ref<VectorField> TurbulenceField = nullptr;     // Shared baked field, sampled instead of the random force
+    f32 TurbulenceFieldSize = 10.0f;                // World units one tile of the field covers
+    glm::vec3 TurbulenceFieldScroll = glm::vec3(0.0f); // Field drift, world units per second
+
+    // === Scene Interaction (needs ParticleSystem::SetSceneDepth) ===
+    bool DepthCollision = false;    // Bounce off the depth buffer
+    f32 CollisionBounce = 0.3f;     // Normal velocity kept after a hit
+    f32 CollisionFriction = 0.2f;   // Tangential velocity lost per hit
+    f32 CollisionThickness = 0.5f;  // Depth behind a surface that still collides
+    f32 SoftParticleDistance = 0.0f; // Fade distance near geometry, 0 = hard edges
 
     // === Rendering ===
     ParticleBlendMode BlendMode = ParticleBlendMode::Additive;
+    bool DepthSort = false;         // Back-to-front GPU sort (Alpha / Premultiplied only)
     Ref<Texture2D> Texture = nullptr;
     u32 SpriteSheetRows = 1;
     u32 SpriteSheetCols = 1;
@@ -93,6 +192,20 @@ struct EmitterSettings {
     bool PlayOnStart = true;
     f32 Duration = 0.0f;            // 0 = infinite
     f32 StartDelay = 0.0f;
+
+    // === LOD ===
+    Vector<ParticleLODBand> LODBands;   // Nearest first; empty = full rate everywhere
+    f32 BoundsRadius = 5.0f;            // Sphere around Position for culling and coverage
+    u32 CulledTickInterval = 8;         // Tick rate outside the frustum, 0 = freeze
+};
+
+// LOD picked for an emitter by ParticleSystem each frame
+struct EmitterLOD {
+    u32 Band = 0;                   // Index into LODBands, 0 without bands
+    u32 TickInterval = 1;           // 0 = frozen
+    f32 SpawnRateScale = 1.0f;
+    f32 SizeScale = 1.0f;
+    bool Visible = true;            // Bounds intersect the camera frustum
 };
 
 // Particle emitter runtime state
@@ -111,6 +224,12 @@ struct ParticleStats {
     u32 ActiveEmitters = 0;
     u32 TotalParticles = 0;
     u32 AliveParticles = 0;
+    u32 PooledEmitters = 0;         // Simulated together by the shared pool
+    u32 PoolCapacityUsed = 0;       // Particle slots reserved in the pool
+    u32 PoolDrawCalls = 0;          // Multi-draws issued for the pool
+    u32 SortedEmitters = 0;         // Depth sorted before drawing
+    u32 CulledEmitters = 0;         // Outside the frustum, not drawn
+    u32 ReducedEmitters = 0;        // Simulating below full rate
     f32 UpdateTimeMs = 0.0f;
     f32 RenderTimeMs = 0.0f;
 };
@@ -175,6 +294,8 @@ inline EmitterSettings Smoke() {
     s.Turbulence = 0.8f;
 
     s.BlendMode = ParticleBlendMode::Alpha;
+    s.DepthSort = true;
+    s.SoftParticleDistance = 0.5f;
     return s;
 }
 
@@ -201,6 +322,9 @@ inline EmitterSettings Sparks() {
     s.Gravity = glm::vec3(0.0f, -9.81f, 0.0f);           // Real gravity
     s.Drag = 0.05f;
 
+    s.DepthCollision = true;
+    s.CollisionBounce = 0.4f;
+
     s.BlendMode = ParticleBlendMode::Additive;
     return s;
 }
@@ -228,6 +352,8 @@ inline EmitterSettings Explosion() {
     s.Gravity = glm::vec3(0.0f, -3.0f, 0.0f);
     s.Drag = 0.8f;
 
+    s.DepthCollision = true;
+
     s.BlendMode = ParticleBlendMode::Additive;
     s.Loop = false;
     return s;
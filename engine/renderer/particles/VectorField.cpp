@@ -0,0 +1,136 @@
+#include "renderer/particles/VectorField.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "core/Logger.hpp"
+#include "core/MappedFile.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+#include <charconv>
+
+namespace Engine {
+
+namespace {
+
+// Largest FGA grid accepted per side
+constexpr u32 MaxFGASize = 256;
+
+const char* SkipSeparators(const char* p, const char* end) {
+    while (p < end && (*p == ',' || *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) ++p;
+    return p;
+}
+
+bool ParseFloat(const char*& p, const char* end, f32& value) {
+    p = SkipSeparators(p, end);
+    if (p < end && *p == '+') ++p;
+
+    auto [next, error] = std::from_chars(p, end, value);
+    if (error != std::errc()) return false;
+    p = next;
+    return true;
+}
+
+} // anonymous namespace
+
+VectorField::VectorField(u32 width, u32 height, u32 depth, const glm::vec3* data)
+    : m_Width(width)
+    , m_Height(height)
+    , m_Depth(depth)
+{
+    glCreateTextures(GL_TEXTURE_3D, 1, &m_Texture);
+    GLMemory::TextureStorage3D(m_Texture, 1, GL_RGBA16F, static_cast<i32>(width), static_cast<i32>(height),
+                               static_cast<i32>(depth), MemoryTag::Particles);
+    glTextureParameteri(m_Texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(m_Texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(m_Texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(m_Texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTextureParameteri(m_Texture, GL_TEXTURE_WRAP_R, GL_REPEAT);
+
+    if (data) {
+        glTextureSubImage3D(m_Texture, 0, 0, 0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height),
+                            static_cast<GLsizei>(depth), GL_RGB, GL_FLOAT, data);
+    }
+}
+
+VectorField::~VectorField() {
+    if (m_Texture) GLMemory::DeleteTextures(1, &m_Texture);
+}
+
+void VectorField::Bind(u32 unit) const {
+    GLStateCache::Instance().BindTextureUnit(unit, m_Texture);
+}
+
+Ref<VectorField> VectorField::CreateCurlNoise(const CurlNoiseSettings& settings) {
+    const u32 resolution = std::max(settings.Resolution, 4u);
+    auto field = CreateRef<VectorField>(resolution, resolution, resolution);
+
+    // The potential goes through a scratch field, the curl differentiates it
+    VectorField potential(resolution, resolution, resolution);
+
+    Shader shader("assets/shaders/particles/curl_noise_bake.glsl");
+    shader.Bind();
+    shader.SetInt("u_Resolution", static_cast<i32>(resolution));
+    shader.SetInt("u_Frequency", static_cast<i32>(std::max(settings.Frequency, 1u)));
+    shader.SetInt("u_Octaves", static_cast<i32>(std::clamp(settings.Octaves, 1u, 8u)));
+    shader.SetUInt("u_Seed", settings.Seed);
+
+    const u32 groups = (resolution + GroupSize - 1) / GroupSize;
+
+    shader.SetInt("u_Pass", 0);
+    glBindImageTexture(0, potential.GetTextureID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    glDispatchCompute(groups, groups, groups);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+    shader.SetInt("u_Pass", 1);
+    glBindImageTexture(0, field->GetTextureID(), 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    glBindImageTexture(1, potential.GetTextureID(), 0, GL_TRUE, 0, GL_READ_ONLY, GL_RGBA16F);
+    glDispatchCompute(groups, groups, groups);
+
+    // Particle updates sample it
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+    LOG_CORE_DEBUG("VectorField: baked {}^3 curl noise, frequency {}, {} octaves",
+                   resolution, settings.Frequency, settings.Octaves);
+    return field;
+}
+
+Ref<VectorField> VectorField::LoadFGA(const String& filepath) {
+    MappedFile file(filepath);
+    if (!file.IsOpen()) {
+        LOG_CORE_ERROR("VectorField: failed to open '{}'", filepath);
+        return nullptr;
+    }
+
+    const char* p = file.Begin();
+    const char* end = file.End();
+
+    f32 header[9];
+    for (f32& value : header) {
+        if (!ParseFloat(p, end, value)) {
+            LOG_CORE_ERROR("VectorField: '{}' has no FGA header", filepath);
+            return nullptr;
+        }
+    }
+
+    const u32 width = static_cast<u32>(header[0]);
+    const u32 height = static_cast<u32>(header[1]);
+    const u32 depth = static_cast<u32>(header[2]);
+    if (width == 0 || height == 0 || depth == 0 ||
+        width > MaxFGASize || height > MaxFGASize || depth > MaxFGASize) {
+        LOG_CORE_ERROR("VectorField: '{}' has an invalid size {}x{}x{}", filepath, width, height, depth);
+        return nullptr;
+    }
+
+    Vector<glm::vec3> vectors(static_cast<usize>(width) * height * depth);
+    for (glm::vec3& vector : vectors) {
+        if (!ParseFloat(p, end, vector.x) || !ParseFloat(p, end, vector.y) || !ParseFloat(p, end, vector.z)) {
+            LOG_CORE_ERROR("VectorField: '{}' ends before its {}x{}x{} vectors", filepath, width, height, depth);
+            return nullptr;
+        }
+    }
+
+    return CreateRef<VectorField>(width, height, depth, vectors.data());
+}
+
+} // namespace Engine
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// VectorField - a tiling 3D grid of vectors in an RGBA16F texture, sampled
+// with one trilinear, repeat-wrapped fetch.
+//
+// Particle turbulence reads one per emitter (EmitterSettings::TurbulenceField)
+// instead of a random force per particle per frame: a smooth, divergence-free
+// field makes particles swirl rather than jitter, and the fetch costs less
+// than evaluating the noise it was baked from. Fields are shared by name
+// through ResourceManager::LoadVectorField / GenerateVectorField.
+class VectorField {
+public:
+    // Curl of a periodic gradient noise potential, baked on the GPU
+    struct CurlNoiseSettings {
+        u32 Resolution = 32;        // Texels per side
+        u32 Frequency = 4;          // Noise cells per tile on the first octave
+        u32 Octaves = 2;            // Each doubles the frequency and halves the amplitude
+        u32 Seed = 0;
+    };
+
+    // Must match curl_noise_bake.glsl
+    static constexpr u32 GroupSize = 4;
+
+    // Roughly unit length vectors, tiling in every direction
+    static Ref<VectorField> CreateCurlNoise(const CurlNoiseSettings& settings);
+
+    // An FGA file: "sizeX,sizeY,sizeZ, minX,minY,minZ, maxX,maxY,maxZ" then
+    // x-fastest vectors, comma or whitespace separated. The bounds are
+    // ignored, the emitter decides the tile size. Null on failure.
+    static Ref<VectorField> LoadFGA(const String& filepath);
+
+    // Storage for width x height x depth texels; data (x-fastest) may be null
+    VectorField(u32 width, u32 height, u32 depth, const glm::vec3* data = nullptr);
+    ~VectorField();
+
+    VectorField(const VectorField&) = delete;
+    VectorField& operator=(const VectorField&) = delete;
+
+    void Bind(u32 unit) const;
+
+    u32 GetTextureID() const { return m_Texture; }
+    u32 GetWidth() const { return m_Width; }
+    u32 GetHeight() const { return m_Height; }
+    u32 GetDepth() const { return m_Depth; }
+    usize GetMemorySize() const { return static_cast<usize>(m_Width) * m_Height * m_Depth * 8; }
+
+private:
+    u32 m_Texture = 0;
+    u32 m_Width = 0;
+    u32 m_Height = 0;
+    u32 m_Depth = 0;
+};
+
+} // namespace Engine
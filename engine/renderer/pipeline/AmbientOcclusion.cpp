@@ -0,0 +1,106 @@
+#include "renderer/pipeline/AmbientOcclusion.hpp"
+#include "renderer/pipeline/GBuffer.hpp"
+#include "renderer/pipeline/HiZPyramid.hpp"
+#include "renderer/pipeline/RenderTargetPool.hpp"
+#include "renderer/rhi/CommandList.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+
+namespace Engine {
+
+AmbientOcclusion::AmbientOcclusion() {
+    LoadShaders();
+}
+
+AmbientOcclusion::~AmbientOcclusion() {
+    Release();
+}
+
+void AmbientOcclusion::LoadShaders() {
+    m_OcclusionShader = CreateRef<Shader>("assets/shaders/deferred/gtao.glsl");
+    m_UpsampleShader = CreateRef<Shader>("assets/shaders/deferred/gtao_upsample.glsl");
+}
+
+void AmbientOcclusion::Reload() {
+    LoadShaders();
+}
+
+void AmbientOcclusion::Allocate(u32 width, u32 height) {
+    Release();
+
+    m_Width = width;
+    m_Height = height;
+    m_HalfTexture = RenderTargetPool::Acquire(GL_R8, (width + 1) / 2, (height + 1) / 2);
+    m_Texture = RenderTargetPool::Acquire(GL_R8, width, height);
+    for (u32 texture : {m_HalfTexture, m_Texture}) {
+        glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+}
+
+void AmbientOcclusion::Release() {
+    RenderTargetPool::Release(m_HalfTexture);
+    RenderTargetPool::Release(m_Texture);
+    m_HalfTexture = 0;
+    m_Texture = 0;
+}
+
+void AmbientOcclusion::Prepare(const GBuffer& gbuffer) {
+    if (gbuffer.GetWidth() != m_Width || gbuffer.GetHeight() != m_Height) {
+        Allocate(gbuffer.GetWidth(), gbuffer.GetHeight());
+    }
+}
+
+void AmbientOcclusion::Record(CommandList& commands, const GBuffer& gbuffer, const HiZPyramid& hiz) const {
+    if (!hiz.IsValid()) return;
+
+    const glm::ivec2 size(static_cast<i32>(gbuffer.GetViewportWidth()), static_cast<i32>(gbuffer.GetViewportHeight()));
+    const glm::ivec2 halfSize = (size + 1) / 2;
+    const i32 group = static_cast<i32>(GroupSize);
+
+    PipelineDesc occlusion;
+    occlusion.Program = m_OcclusionShader.get();
+    occlusion.Compute = true;
+
+    // Half resolution, one texel per Hi-Z level 0 texel
+    commands.BindPipeline(occlusion);
+    commands.SetInt2("u_HalfSize", halfSize);
+    commands.SetInt2("u_DepthSize", size);
+    commands.SetInt("u_LevelCount", static_cast<i32>(hiz.GetLevelCount()));
+    commands.SetInt("u_CompactGBuffer", gbuffer.IsCompact() ? 1 : 0);
+    commands.SetFloat("u_Radius", m_Settings.Radius);
+    commands.SetFloat("u_Intensity", m_Settings.Intensity);
+    commands.SetFloat("u_MaxPixelRadius", m_Settings.MaxPixelRadius);
+    commands.SetInt("u_Directions", static_cast<i32>(std::clamp(m_Settings.Directions, 1u, MaxDirections)));
+    commands.SetInt("u_Steps", static_cast<i32>(std::clamp(m_Settings.Steps, 1u, MaxSteps)));
+    commands.BindTexture(0, hiz.GetTextureID());
+    commands.BindTexture(1, gbuffer.GetNormalTextureID());
+    commands.BindImage(0, m_HalfTexture, 0, ImageAccess::Write, TextureFormat::R8);
+
+    commands.Dispatch((halfSize.x + group - 1) / group, (halfSize.y + group - 1) / group, 1);
+    commands.Barrier(ResourceAccess::ShaderImage, ResourceAccess::TextureFetch);
+
+    PipelineDesc upsample;
+    upsample.Program = m_UpsampleShader.get();
+    upsample.Compute = true;
+
+    // Back to full resolution, guided by depth
+    commands.BindPipeline(upsample);
+    commands.SetInt2("u_Size", size);
+    commands.SetInt2("u_HalfSize", halfSize);
+    commands.SetFloat("u_DepthSharpness", m_Settings.DepthSharpness);
+    commands.BindTexture(0, hiz.GetTextureID());
+    commands.BindTexture(1, m_HalfTexture);
+    commands.BindTexture(2, gbuffer.GetDepthTextureID());
+    commands.BindImage(0, m_Texture, 0, ImageAccess::Write, TextureFormat::R8);
+
+    commands.Dispatch((size.x + group - 1) / group, (size.y + group - 1) / group, 1);
+
+    // The lighting pass samples it
+    commands.Barrier(ResourceAccess::ShaderImage, ResourceAccess::TextureFetch | ResourceAccess::ShaderImage);
+}
+
+} // namespace Engine
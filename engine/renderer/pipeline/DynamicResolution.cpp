@@ -0,0 +1,64 @@
+#include "renderer/pipeline/DynamicResolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+f32 DynamicResolution::Update(f32 gpuTimeMs) {
+    const Settings& settings = m_Settings;
+    const f32 minScale = std::clamp(settings.MinScale, ScaleGranularity, 1.0f);
+    const f32 maxScale = std::clamp(settings.MaxScale, minScale, 1.0f);
+
+    if (!settings.Enabled) {
+        m_Scale = maxScale;
+        m_Accumulated = 0.0f;
+        m_Samples = 0;
+        return m_Scale;
+    }
+
+    m_Scale = std::clamp(m_Scale, minScale, maxScale);
+
+    if (gpuTimeMs <= 0.0f) return m_Scale;
+    if (m_SettleRemaining > 0) {
+        m_SettleRemaining--;
+        return m_Scale;
+    }
+
+    m_Accumulated += gpuTimeMs;
+    m_Samples++;
+    if (m_Samples < std::max(settings.AdjustInterval, 1u)) return m_Scale;
+
+    m_AverageGPUTimeMs = m_Accumulated / static_cast<f32>(m_Samples);
+    m_Accumulated = 0.0f;
+    m_Samples = 0;
+
+    const f32 target = std::max(settings.TargetGPUTimeMs, 0.1f);
+    const bool overBudget = m_AverageGPUTimeMs > target;
+    const bool underBudget = m_AverageGPUTimeMs < target * settings.IncreaseThreshold;
+    if (!overBudget && !underBudget) return m_Scale;
+
+    f32 scale = m_Scale * std::sqrt(target / m_AverageGPUTimeMs);
+    scale = std::clamp(scale, m_Scale - settings.MaxStep, m_Scale + settings.MaxStep);
+
+    // Whole granularity steps, at least one in the direction of the budget
+    f32 steps = std::round((scale - m_Scale) / ScaleGranularity);
+    steps = overBudget ? std::min(steps, -1.0f) : std::max(steps, 1.0f);
+    scale = std::clamp(m_Scale + steps * ScaleGranularity, minScale, maxScale);
+
+    if (scale != m_Scale) {
+        m_Scale = scale;
+        m_SettleRemaining = settings.SettleFrames;
+    }
+    return m_Scale;
+}
+
+void DynamicResolution::Reset() {
+    m_Scale = std::clamp(m_Settings.MaxScale, 0.0f, 1.0f);
+    m_AverageGPUTimeMs = 0.0f;
+    m_Accumulated = 0.0f;
+    m_Samples = 0;
+    m_SettleRemaining = 0;
+}
+
+} // namespace Engine
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "core/Types.hpp"
+
+namespace Engine {
+
+// DynamicResolution - picks the 3D render scale from measured GPU frame time.
+//
+// Fed one GPU frame time per frame (GPUProfiler::GetTotalTimeMs(), which
+// already lags a few frames). Every AdjustInterval frames the average is
+// compared with the budget: over budget the scale drops, under
+// IncreaseThreshold of it the scale rises. Shading cost goes with the pixel
+// count, so the new scale is current * sqrt(target / measured), limited to
+// MaxStep per adjustment and moved in whole ScaleGranularity steps so the
+// render size doesn't wander by a pixel every interval. The frames right
+// after a change still report the old resolution and are skipped.
+//
+// The scale applies to both axes; callers render into a viewport of
+// scale * size inside attachments allocated at full size.
+class DynamicResolution {
+public:
+    static constexpr f32 ScaleGranularity = 0.05f;
+
+    struct Settings {
+        bool Enabled = false;
+        f32 TargetGPUTimeMs = 14.0f;    // Leaves headroom in a 60 Hz frame
+        f32 MinScale = 0.5f;
+        f32 MaxScale = 1.0f;            // Attachments are allocated at 1.0
+        f32 IncreaseThreshold = 0.85f;  // Fraction of the target to grow below
+        f32 MaxStep = 0.1f;             // Largest change per adjustment
+        u32 AdjustInterval = 8;         // Frames averaged per decision
+        u32 SettleFrames = 3;           // Frames ignored after a change
+    };
+
+    Settings& GetSettings() { return m_Settings; }
+    const Settings& GetSettings() const { return m_Settings; }
+
+    // Feed the latest GPU frame time (0 = no result) and get the scale to use
+    f32 Update(f32 gpuTimeMs);
+
+    f32 GetScale() const { return m_Scale; }
+    f32 GetAverageGPUTimeMs() const { return m_AverageGPUTimeMs; }
+
+    // Back to MaxScale with no history
+    void Reset();
+
+private:
+    Settings m_Settings;
+
+    f32 m_Scale = 1.0f;
+    f32 m_AverageGPUTimeMs = 0.0f;
+    f32 m_Accumulated = 0.0f;
+    u32 m_Samples = 0;
+    u32 m_SettleRemaining = 0;
+};
+
+} // namespace Engine
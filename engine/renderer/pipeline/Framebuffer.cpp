@@ -1,7 +1,10 @@
 #include "renderer/pipeline/Framebuffer.hpp"
+#include "renderer/pipeline/RenderTargetPool.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
 #include "core/Logger.hpp"
 
 #include <glad/gl.h>
+#include <algorithm>
 
 namespace Engine {
 
@@ -13,7 +16,9 @@ GLenum FramebufferTextureFormatToGL(FramebufferTextureFormat format) {
         case FramebufferTextureFormat::RGBA16F:         return GL_RGBA16F;
         case FramebufferTextureFormat::RGBA32F:         return GL_RGBA32F;
         case FramebufferTextureFormat::RG16F:           return GL_RG16F;
+        case FramebufferTextureFormat::RG16:            return GL_RG16;
         case FramebufferTextureFormat::R11G11B10F:      return GL_R11F_G11F_B10F;
+        case FramebufferTextureFormat::R32UI:           return GL_R32UI;
         case FramebufferTextureFormat::Depth24Stencil8: return GL_DEPTH24_STENCIL8;
         case FramebufferTextureFormat::Depth32F:        return GL_DEPTH_COMPONENT32F;
         default: return GL_RGBA8;
@@ -38,6 +43,10 @@ GLenum TextureWrapToGL(TextureWrap wrap) {
     }
 }
 
+bool IsIntegerFormat(FramebufferTextureFormat format) {
+    return format == FramebufferTextureFormat::R32UI;
+}
+
 bool IsDepthFormat(FramebufferTextureFormat format) {
     switch (format) {
         case FramebufferTextureFormat::Depth24Stencil8:
@@ -58,8 +67,18 @@ GLenum GetDepthAttachmentType(FramebufferTextureFormat format) {
 
 } // namespace
 
+u32 FramebufferTextureFormatToGLFormat(FramebufferTextureFormat format) {
+    return FramebufferTextureFormatToGL(format);
+}
+
+bool IsDepthFramebufferTextureFormat(FramebufferTextureFormat format) {
+    return IsDepthFormat(format);
+}
+
 Framebuffer::Framebuffer(const FramebufferSpecification& spec)
-    : m_Specification(spec) {
+    : m_Specification(spec)
+    , m_ViewportWidth(spec.Width)
+    , m_ViewportHeight(spec.Height) {
     for (const auto& attachment : spec.Attachments.Attachments) {
         if (IsDepthFormat(attachment.Format)) {
             m_DepthAttachmentSpec = attachment;
@@ -81,7 +100,9 @@ Framebuffer::Framebuffer(Framebuffer&& other) noexcept
     , m_ColorAttachmentSpecs(std::move(other.m_ColorAttachmentSpecs))
     , m_DepthAttachmentSpec(other.m_DepthAttachmentSpec)
     , m_ColorAttachments(std::move(other.m_ColorAttachments))
-    , m_DepthAttachment(other.m_DepthAttachment) {
+    , m_DepthAttachment(other.m_DepthAttachment)
+    , m_ViewportWidth(other.m_ViewportWidth)
+    , m_ViewportHeight(other.m_ViewportHeight) {
     other.m_RendererID = 0;
     other.m_DepthAttachment = 0;
 }
@@ -96,6 +117,8 @@ Framebuffer& Framebuffer::operator=(Framebuffer&& other) noexcept {
         m_DepthAttachmentSpec = other.m_DepthAttachmentSpec;
         m_ColorAttachments = std::move(other.m_ColorAttachments);
         m_DepthAttachment = other.m_DepthAttachment;
+        m_ViewportWidth = other.m_ViewportWidth;
+        m_ViewportHeight = other.m_ViewportHeight;
 
         other.m_RendererID = 0;
         other.m_DepthAttachment = 0;
@@ -105,7 +128,7 @@ Framebuffer& Framebuffer::operator=(Framebuffer&& other) noexcept {
 
 void Framebuffer::Bind() {
     glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
-    glViewport(0, 0, m_Specification.Width, m_Specification.Height);
+    glViewport(0, 0, m_ViewportWidth, m_ViewportHeight);
 }
 
 void Framebuffer::Unbind() {
@@ -117,15 +140,54 @@ void Framebuffer::BindDefault() {
 }
 
 void Framebuffer::Resize(u32 width, u32 height) {
-    if (width == 0 || height == 0 || width > 8192 || height > 8192) {
+    if (width == 0 || height == 0 || width > MaxSize || height > MaxSize) {
         LOG_CORE_WARN("Invalid framebuffer size: {}x{}", width, height);
         return;
     }
 
     m_Specification.Width = width;
     m_Specification.Height = height;
+    m_ViewportWidth = width;
+    m_ViewportHeight = height;
+
+    Invalidate();
+}
+
+bool Framebuffer::Fit(u32 width, u32 height, bool shrink) {
+    if (width == 0 || height == 0 || width > MaxSize || height > MaxSize) {
+        LOG_CORE_WARN("Invalid framebuffer size: {}x{}", width, height);
+        return false;
+    }
 
+    const auto withHeadroom = [](u32 size) {
+        const u32 padded = (size + size / 8 + FitGranularity - 1) / FitGranularity * FitGranularity;
+        return std::min(padded, MaxSize);
+    };
+    const u32 paddedWidth = withHeadroom(width);
+    const u32 paddedHeight = withHeadroom(height);
+
+    const bool fits = width <= m_Specification.Width && height <= m_Specification.Height;
+    const bool oversized = m_Specification.Width > paddedWidth || m_Specification.Height > paddedHeight;
+    if (fits && !(shrink && oversized)) {
+        SetViewport(width, height);
+        return false;
+    }
+
+    m_Specification.Width = paddedWidth;
+    m_Specification.Height = paddedHeight;
     Invalidate();
+    SetViewport(width, height);
+    return true;
+}
+
+void Framebuffer::SetViewport(u32 width, u32 height) {
+    m_ViewportWidth = std::clamp(width, 1u, m_Specification.Width);
+    m_ViewportHeight = std::clamp(height, 1u, m_Specification.Height);
+}
+
+glm::vec2 Framebuffer::GetViewportUVScale() const {
+    return glm::vec2(static_cast<f32>(m_ViewportWidth) / static_cast<f32>(m_Specification.Width),
+                     static_cast<f32>(m_ViewportHeight) / static_cast<f32>(m_Specification.Height));
 }
 
 void Framebuffer::Invalidate() {
@@ -137,7 +199,21 @@ void Framebuffer::Invalidate() {
 
     CreateAttachments();
 
-    if (m_ColorAttachments.size() > 1) {
+    const auto& drawBuffers = m_Specification.DrawBuffers;
+    if (!drawBuffers.empty()) {
+        if (drawBuffers.size() > 8) {
+            LOG_CORE_ERROR("Too many draw buffers (max 8)");
+            return;
+        }
+
+        GLenum buffers[8];
+        for (size_t i = 0; i < drawBuffers.size(); ++i) {
+            buffers[i] = drawBuffers[i] >= 0
+                ? GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(drawBuffers[i])
+                : GL_NONE;
+        }
+        glNamedFramebufferDrawBuffers(m_RendererID, static_cast<GLsizei>(drawBuffers.size()), buffers);
+    } else if (m_ColorAttachments.size() > 1) {
         if (m_ColorAttachments.size() > 8) {
             LOG_CORE_ERROR("Too many color attachments (max 8)");
             return;
@@ -161,40 +237,26 @@ void Framebuffer::Invalidate() {
 }
 
 void Framebuffer::CreateAttachments() {
-    bool multisample = m_Specification.Samples > 1;
-    GLenum textureTarget = multisample ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+    const bool multisample = m_Specification.Samples > 1;
 
     // Color attachments
     if (!m_ColorAttachmentSpecs.empty()) {
         m_ColorAttachments.resize(m_ColorAttachmentSpecs.size());
-        glCreateTextures(textureTarget, static_cast<GLsizei>(m_ColorAttachments.size()),
-                         m_ColorAttachments.data());
 
         for (size_t i = 0; i < m_ColorAttachments.size(); ++i) {
             const auto& spec = m_ColorAttachmentSpecs[i];
 
-            if (multisample) {
-                glTextureStorage2DMultisample(
-                    m_ColorAttachments[i],
-                    m_Specification.Samples,
-                    FramebufferTextureFormatToGL(spec.Format),
-                    m_Specification.Width,
-                    m_Specification.Height,
-                    GL_TRUE
-                );
-            } else {
-                glTextureStorage2D(
-                    m_ColorAttachments[i],
-                    1,
-                    FramebufferTextureFormatToGL(spec.Format),
-                    m_Specification.Width,
-                    m_Specification.Height
-                );
+            m_ColorAttachments[i] = RenderTargetPool::Acquire(FramebufferTextureFormatToGL(spec.Format),
+                                                              m_Specification.Width, m_Specification.Height,
+                                                              m_Specification.Samples);
 
+            if (!multisample) {
+                // Integer textures are incomplete with linear filtering
+                const bool integer = IsIntegerFormat(spec.Format);
                 glTextureParameteri(m_ColorAttachments[i], GL_TEXTURE_MIN_FILTER,
-                                    TextureFilterToGL(spec.MinFilter));
+                                    integer ? GL_NEAREST : TextureFilterToGL(spec.MinFilter));
                 glTextureParameteri(m_ColorAttachments[i], GL_TEXTURE_MAG_FILTER,
-                                    TextureFilterToGL(spec.MagFilter));
+                                    integer ? GL_NEAREST : TextureFilterToGL(spec.MagFilter));
                 glTextureParameteri(m_ColorAttachments[i], GL_TEXTURE_WRAP_S,
                                     TextureWrapToGL(spec.WrapS));
                 glTextureParameteri(m_ColorAttachments[i], GL_TEXTURE_WRAP_T,
@@ -210,26 +272,11 @@ void Framebuffer::CreateAttachments() {
 
     // Depth attachment
     if (m_DepthAttachmentSpec.Format != FramebufferTextureFormat::None) {
-        glCreateTextures(textureTarget, 1, &m_DepthAttachment);
-
-        if (multisample) {
-            glTextureStorage2DMultisample(
-                m_DepthAttachment,
-                m_Specification.Samples,
-                FramebufferTextureFormatToGL(m_DepthAttachmentSpec.Format),
-                m_Specification.Width,
-                m_Specification.Height,
-                GL_TRUE
-            );
-        } else {
-            glTextureStorage2D(
-                m_DepthAttachment,
-                1,
-                FramebufferTextureFormatToGL(m_DepthAttachmentSpec.Format),
-                m_Specification.Width,
-                m_Specification.Height
-            );
+        m_DepthAttachment = RenderTargetPool::Acquire(FramebufferTextureFormatToGL(m_DepthAttachmentSpec.Format),
+                                                      m_Specification.Width, m_Specification.Height,
+                                                      m_Specification.Samples);
 
+        if (!multisample) {
             glTextureParameteri(m_DepthAttachment, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
             glTextureParameteri(m_DepthAttachment, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
             glTextureParameteri(m_DepthAttachment, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -249,14 +296,13 @@ void Framebuffer::DeleteAttachments() {
         m_RendererID = 0;
     }
 
-    if (!m_ColorAttachments.empty()) {
-        glDeleteTextures(static_cast<GLsizei>(m_ColorAttachments.size()),
-                         m_ColorAttachments.data());
-        m_ColorAttachments.clear();
+    for (u32 texture : m_ColorAttachments) {
+        RenderTargetPool::Release(texture);
     }
+    m_ColorAttachments.clear();
 
     if (m_DepthAttachment) {
-        glDeleteTextures(1, &m_DepthAttachment);
+        RenderTargetPool::Release(m_DepthAttachment);
         m_DepthAttachment = 0;
     }
 }
@@ -274,12 +320,12 @@ void Framebuffer::BindColorTexture(u32 attachmentIndex, u32 slot) {
         LOG_CORE_ERROR("Color attachment index out of range: {}", attachmentIndex);
         return;
     }
-    glBindTextureUnit(slot, m_ColorAttachments[attachmentIndex]);
+    GLStateCache::Instance().BindTextureUnit(slot, m_ColorAttachments[attachmentIndex]);
 }
 
 void Framebuffer::BindDepthTexture(u32 slot) {
     if (m_DepthAttachment) {
-        glBindTextureUnit(slot, m_DepthAttachment);
+        GLStateCache::Instance().BindTextureUnit(slot, m_DepthAttachment);
     }
 }
 
@@ -291,12 +337,25 @@ void Framebuffer::ClearColorAttachment(u32 index, const glm::vec4& value) {
     glClearNamedFramebufferfv(m_RendererID, GL_COLOR, index, &value[0]);
 }
 
+void Framebuffer::ClearColorAttachment(u32 index, u32 value) {
+    if (index >= m_ColorAttachments.size()) {
+        LOG_CORE_ERROR("Color attachment index out of range: {}", index);
+        return;
+    }
+    const GLuint values[4] = {value, 0, 0, 0};
+    glClearNamedFramebufferuiv(m_RendererID, GL_COLOR, static_cast<GLint>(index), values);
+}
+
 void Framebuffer::ClearDepthAttachment(f32 value) {
     glClearNamedFramebufferfv(m_RendererID, GL_DEPTH, 0, &value);
 }
 
 void Framebuffer::Clear(const glm::vec4& clearColor, f32 depthValue) {
     for (size_t i = 0; i < m_ColorAttachments.size(); ++i) {
+        if (IsIntegerFormat(m_ColorAttachmentSpecs[i].Format)) {
+            ClearColorAttachment(static_cast<u32>(i), static_cast<u32>(clearColor.r));
+            continue;
+        }
         glClearNamedFramebufferfv(m_RendererID, GL_COLOR, static_cast<GLint>(i), &clearColor[0]);
     }
 
@@ -14,13 +14,21 @@ enum class FramebufferTextureFormat {
     RGBA16F,
     RGBA32F,
     RG16F,
+    RG16,
     R11G11B10F,
 
+    // Integer formats (nearest filtering only)
+    R32UI,
+
     // Depth/Stencil
     Depth24Stencil8,
     Depth32F
 };
 
+// GL internal format for an attachment format
+u32 FramebufferTextureFormatToGLFormat(FramebufferTextureFormat format);
+bool IsDepthFramebufferTextureFormat(FramebufferTextureFormat format);
+
 struct FramebufferTextureSpecification {
     FramebufferTextureFormat Format = FramebufferTextureFormat::None;
     TextureFilter MinFilter = TextureFilter::Linear;
@@ -46,6 +54,10 @@ struct FramebufferSpecification {
     FramebufferAttachmentSpecification Attachments;
     u32 Samples = 1;
     bool SwapChainTarget = false;
+
+    // Color attachment written by each fragment output location, -1 for
+    // none. Empty maps location i to attachment i.
+    Vector<i32> DrawBuffers;
 };
 
 class Framebuffer {
@@ -62,9 +74,32 @@ public:
     void Bind();
     void Unbind();
 
+    static constexpr u32 MaxSize = 8192;
+    static constexpr u32 FitGranularity = 64;
+
+    // Reallocates the attachments and resets the viewport to the full size
     void Resize(u32 width, u32 height);
     void Invalidate();
 
+    // Makes width x height the viewport, reallocating only when it doesn't
+    // fit the attachments. A reallocation leaves headroom - an eighth more,
+    // rounded up to FitGranularity - so a size that changes every frame (a
+    // panel being dragged wider) reallocates every few dozen pixels instead
+    // of every frame; sampling has to scale UVs by GetViewportUVScale(). With
+    // shrink, attachments larger than that headroom are cut back to it: pass
+    // it once the size has settled. Returns true if it reallocated.
+    bool Fit(u32 width, u32 height, bool shrink = false);
+
+    // Region from the origin that is rendered into; Bind() makes it the GL
+    // viewport. Used to render at a fraction of the allocated size without
+    // touching the attachments (clamped to the allocation).
+    void SetViewport(u32 width, u32 height);
+    u32 GetViewportWidth() const { return m_ViewportWidth; }
+    u32 GetViewportHeight() const { return m_ViewportHeight; }
+
+    // Viewport size over allocated size: the UV extent of the rendered region
+    glm::vec2 GetViewportUVScale() const;
+
     u32 GetColorAttachmentRendererID(u32 index = 0) const;
     u32 GetDepthAttachmentRendererID() const { return m_DepthAttachment; }
 
@@ -72,6 +107,7 @@ public:
     void BindDepthTexture(u32 slot);
 
     void ClearColorAttachment(u32 index, const glm::vec4& value);
+    void ClearColorAttachment(u32 index, u32 value);     // R32UI attachments
     void ClearDepthAttachment(f32 value = 1.0f);
     void Clear(const glm::vec4& clearColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), f32 depthValue = 1.0f);
 
@@ -99,6 +135,9 @@ private:
 
     Vector<u32> m_ColorAttachments;
     u32 m_DepthAttachment = 0;
+
+    u32 m_ViewportWidth = 0;
+    u32 m_ViewportHeight = 0;
 };
 
 } // namespace Engine
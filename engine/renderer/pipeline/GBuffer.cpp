@@ -1,29 +1,90 @@
 #include "renderer/pipeline/GBuffer.hpp"
 
+#include <entt/entt.hpp>
 #include <glad/gl.h>
 
 namespace Engine {
 
-GBuffer::GBuffer(u32 width, u32 height) {
+GBuffer::GBuffer(u32 width, u32 height, GBufferLayout layout)
+    : m_Layout(layout) {
+    CreateFramebuffer(width, height);
+}
+
+void GBuffer::CreateFramebuffer(u32 width, u32 height) {
     FramebufferSpecification spec;
     spec.Width = width;
     spec.Height = height;
-    spec.Attachments = {
-        // RT0: Position (RGB) + Linear Depth (A)
-        FramebufferTextureFormat::RGBA16F,
-        // RT1: Normal (RGB) + Metallic (A)
-        FramebufferTextureFormat::RGBA16F,
-        // RT2: Albedo (RGB) + Roughness (A)
-        FramebufferTextureFormat::RGBA8,
-        // RT3: Emission (RGB) + AO (A)
-        FramebufferTextureFormat::RGBA8,
-        // Depth + Stencil
-        FramebufferTextureFormat::Depth24Stencil8
-    };
+
+    if (m_Layout == GBufferLayout::Compact) {
+        spec.Attachments = {
+            // RT0: Octahedral normal
+            FramebufferTextureFormat::RG16,
+            // RT1: Albedo (RGB) + packed Metallic/Roughness (A)
+            FramebufferTextureFormat::RGBA8,
+            // RT2: Emission (RGB) + AO (A)
+            FramebufferTextureFormat::RGBA8,
+            // RT3: Entity ID
+            FramebufferTextureFormat::R32UI,
+            // RT4: Velocity
+            FramebufferTextureFormat::RG16F,
+            // Depth + Stencil (also the position source)
+            FramebufferTextureFormat::Depth24Stencil8
+        };
+        // Output 3 (emission in the standard layout) is unused, the
+        // entity ID at output 4 lands in RT3 and velocity at 5 in RT4
+        spec.DrawBuffers = {0, 1, 2, -1, 3, 4};
+    } else {
+        spec.Attachments = {
+            // RT0: Position (RGB) + Linear Depth (A)
+            FramebufferTextureFormat::RGBA16F,
+            // RT1: Normal (RGB) + Metallic (A)
+            FramebufferTextureFormat::RGBA16F,
+            // RT2: Albedo (RGB) + Roughness (A)
+            FramebufferTextureFormat::RGBA8,
+            // RT3: Emission (RGB) + AO (A)
+            FramebufferTextureFormat::RGBA8,
+            // RT4: Entity ID
+            FramebufferTextureFormat::R32UI,
+            // RT5: Velocity
+            FramebufferTextureFormat::RG16F,
+            // Depth + Stencil
+            FramebufferTextureFormat::Depth24Stencil8
+        };
+    }
 
     m_Framebuffer = CreateScope<Framebuffer>(spec);
 }
 
+void GBuffer::SetLayout(GBufferLayout layout) {
+    if (layout == m_Layout) return;
+
+    m_Layout = layout;
+    const u32 viewportWidth = m_Framebuffer->GetViewportWidth();
+    const u32 viewportHeight = m_Framebuffer->GetViewportHeight();
+    CreateFramebuffer(m_Framebuffer->GetWidth(), m_Framebuffer->GetHeight());
+    m_Framebuffer->SetViewport(viewportWidth, viewportHeight);
+}
+
+u32 GBuffer::GetBytesPerPixel() const {
+    // Depth24Stencil8 is 4 bytes in both layouts
+    return IsCompact() ? 4 + 4 + 4 + 4 + 4 + 4 : 8 + 8 + 4 + 4 + 4 + 4 + 4;
+}
+
+i32 GBuffer::GetAttachmentIndex(Attachment attachment) const {
+    if (!IsCompact()) {
+        return static_cast<i32>(attachment);
+    }
+
+    switch (attachment) {
+        case Normal:   return 0;
+        case Albedo:   return 1;
+        case Emission: return 2;
+        case EntityId: return 3;
+        case Velocity: return 4;
+        default:       return -1;
+    }
+}
+
 void GBuffer::Bind() {
     m_Framebuffer->Bind();
 }
@@ -37,58 +98,91 @@ void GBuffer::Resize(u32 width, u32 height) {
 }
 
 void GBuffer::Clear() {
+    if (IsCompact()) {
+        // Octahedral (0.5, 0.5) decodes to +Z; alpha 16/255 is roughness ~0.5
+        m_Framebuffer->ClearColorAttachment(0, glm::vec4(0.5f, 0.5f, 0.0f, 0.0f));
+        m_Framebuffer->ClearColorAttachment(1, glm::vec4(0.0f, 0.0f, 0.0f, 16.0f / 255.0f));
+        m_Framebuffer->ClearColorAttachment(2, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+        m_Framebuffer->ClearColorAttachment(3, static_cast<u32>(entt::null));
+        m_Framebuffer->ClearColorAttachment(4, glm::vec4(0.0f));
+        m_Framebuffer->ClearDepthAttachment(1.0f);
+        return;
+    }
+
     m_Framebuffer->ClearColorAttachment(Position, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
     m_Framebuffer->ClearColorAttachment(Normal, glm::vec4(0.5f, 0.5f, 0.5f, 0.0f));
     m_Framebuffer->ClearColorAttachment(Albedo, glm::vec4(0.0f, 0.0f, 0.0f, 0.5f));
     m_Framebuffer->ClearColorAttachment(Emission, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+    m_Framebuffer->ClearColorAttachment(EntityId, static_cast<u32>(entt::null));
+    m_Framebuffer->ClearColorAttachment(Velocity, glm::vec4(0.0f));
     m_Framebuffer->ClearDepthAttachment(1.0f);
 }
 
 void GBuffer::BindTextures(u32 startSlot) {
-    m_Framebuffer->BindColorTexture(Position, startSlot);
-    m_Framebuffer->BindColorTexture(Normal, startSlot + 1);
-    m_Framebuffer->BindColorTexture(Albedo, startSlot + 2);
-    m_Framebuffer->BindColorTexture(Emission, startSlot + 3);
+    if (IsCompact()) {
+        m_Framebuffer->BindDepthTexture(startSlot);
+    } else {
+        m_Framebuffer->BindColorTexture(Position, startSlot);
+    }
+    BindNormalTexture(startSlot + 1);
+    BindAlbedoTexture(startSlot + 2);
+    BindEmissionTexture(startSlot + 3);
 }
 
 void GBuffer::BindPositionTexture(u32 slot) {
-    m_Framebuffer->BindColorTexture(Position, slot);
+    i32 index = GetAttachmentIndex(Position);
+    if (index >= 0) {
+        m_Framebuffer->BindColorTexture(static_cast<u32>(index), slot);
+    }
 }
 
 void GBuffer::BindNormalTexture(u32 slot) {
-    m_Framebuffer->BindColorTexture(Normal, slot);
+    m_Framebuffer->BindColorTexture(static_cast<u32>(GetAttachmentIndex(Normal)), slot);
 }
 
 void GBuffer::BindAlbedoTexture(u32 slot) {
-    m_Framebuffer->BindColorTexture(Albedo, slot);
+    m_Framebuffer->BindColorTexture(static_cast<u32>(GetAttachmentIndex(Albedo)), slot);
 }
 
 void GBuffer::BindEmissionTexture(u32 slot) {
-    m_Framebuffer->BindColorTexture(Emission, slot);
+    m_Framebuffer->BindColorTexture(static_cast<u32>(GetAttachmentIndex(Emission)), slot);
 }
 
 void GBuffer::BindDepthTexture(u32 slot) {
     m_Framebuffer->BindDepthTexture(slot);
 }
 
+void GBuffer::BindVelocityTexture(u32 slot) {
+    m_Framebuffer->BindColorTexture(static_cast<u32>(GetAttachmentIndex(Velocity)), slot);
+}
+
 u32 GBuffer::GetPositionTextureID() const {
-    return m_Framebuffer->GetColorAttachmentRendererID(Position);
+    i32 index = GetAttachmentIndex(Position);
+    return index >= 0 ? m_Framebuffer->GetColorAttachmentRendererID(static_cast<u32>(index)) : 0;
 }
 
 u32 GBuffer::GetNormalTextureID() const {
-    return m_Framebuffer->GetColorAttachmentRendererID(Normal);
+    return m_Framebuffer->GetColorAttachmentRendererID(static_cast<u32>(GetAttachmentIndex(Normal)));
 }
 
 u32 GBuffer::GetAlbedoTextureID() const {
-    return m_Framebuffer->GetColorAttachmentRendererID(Albedo);
+    return m_Framebuffer->GetColorAttachmentRendererID(static_cast<u32>(GetAttachmentIndex(Albedo)));
 }
 
 u32 GBuffer::GetEmissionTextureID() const {
-    return m_Framebuffer->GetColorAttachmentRendererID(Emission);
+    return m_Framebuffer->GetColorAttachmentRendererID(static_cast<u32>(GetAttachmentIndex(Emission)));
 }
 
 u32 GBuffer::GetDepthTextureID() const {
     return m_Framebuffer->GetDepthAttachmentRendererID();
 }
 
+u32 GBuffer::GetEntityIdTextureID() const {
+    return m_Framebuffer->GetColorAttachmentRendererID(static_cast<u32>(GetAttachmentIndex(EntityId)));
+}
+
+u32 GBuffer::GetVelocityTextureID() const {
+    return m_Framebuffer->GetColorAttachmentRendererID(static_cast<u32>(GetAttachmentIndex(Velocity)));
+}
+
 } // namespace Engine
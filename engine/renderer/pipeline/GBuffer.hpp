@@ -5,12 +5,38 @@
 
 namespace Engine {
 
-// G-Buffer layout optimized for PBR Deferred Rendering:
+// G-Buffer layouts for PBR Deferred Rendering.
+//
+// Standard (32 bytes of color per pixel):
 // RT0 (RGBA16F): Position.xyz + Linear Depth
 // RT1 (RGBA16F): Normal.xyz (world space, encoded) + Metallic
 // RT2 (RGBA8):   Albedo.rgb + Roughness
 // RT3 (RGBA8):   Emission.rgb + AO
+// RT4 (R32UI):   Entity ID
+// RT5 (RG16F):   Velocity
+//
+// Compact (20 bytes of color per pixel):
+// RT0 (RG16):    Normal (world space, octahedral)
+// RT1 (RGBA8):   Albedo.rgb + Metallic (3 bits) | Roughness (5 bits)
+// RT2 (RGBA8):   Emission.rgb + AO
+// RT3 (R32UI):   Entity ID
+// RT4 (RG16F):   Velocity
+// Position is reconstructed from depth and the inverse view-projection.
+//
+// The entity ID target holds the entity drawn at each pixel (the entt
+// identifier, version included) for picking; uncovered pixels hold
+// entt::null. The geometry shader writes it to output location 4 in both
+// layouts.
+//
+// Velocity is the screen-space motion of each pixel since the previous frame
+// in UV units (current minus previous, unjittered), for temporal
+// reprojection. The geometry shader writes it to output location 5.
+//
 // Depth: Depth24Stencil8
+enum class GBufferLayout : u8 {
+    Standard,
+    Compact
+};
 
 class GBuffer {
 public:
@@ -19,10 +45,12 @@ public:
         Normal = 1,
         Albedo = 2,
         Emission = 3,
-        Count = 4
+        EntityId = 4,
+        Velocity = 5,
+        Count = 6
     };
 
-    GBuffer(u32 width, u32 height);
+    GBuffer(u32 width, u32 height, GBufferLayout layout = GBufferLayout::Standard);
     ~GBuffer() = default;
 
     GBuffer(const GBuffer&) = delete;
@@ -34,30 +62,57 @@ public:
     void Bind();
     void Unbind();
     void Resize(u32 width, u32 height);
+    // Keeps the attachments when width x height fits (see Framebuffer::Fit)
+    bool Fit(u32 width, u32 height, bool shrink = false) { return m_Framebuffer->Fit(width, height, shrink); }
+
+    // Renders into the lower-left width x height region (see Framebuffer::SetViewport)
+    void SetViewport(u32 width, u32 height) { m_Framebuffer->SetViewport(width, height); }
 
     void Clear();
 
+    // Recreates the attachments; texture IDs change
+    void SetLayout(GBufferLayout layout);
+    GBufferLayout GetLayout() const { return m_Layout; }
+    bool IsCompact() const { return m_Layout == GBufferLayout::Compact; }
+
+    // Color + depth bytes written per pixel by the geometry pass
+    u32 GetBytesPerPixel() const;
+
+    // Position, Normal, Albedo, Emission at consecutive slots; the compact
+    // layout has no position target and binds depth in its slot instead
     void BindTextures(u32 startSlot = 0);
     void BindPositionTexture(u32 slot);
     void BindNormalTexture(u32 slot);
     void BindAlbedoTexture(u32 slot);
     void BindEmissionTexture(u32 slot);
     void BindDepthTexture(u32 slot);
+    void BindVelocityTexture(u32 slot);
 
-    u32 GetPositionTextureID() const;
+    u32 GetPositionTextureID() const;   // 0 in the compact layout
     u32 GetNormalTextureID() const;
     u32 GetAlbedoTextureID() const;
     u32 GetEmissionTextureID() const;
     u32 GetDepthTextureID() const;
+    u32 GetEntityIdTextureID() const;
+    u32 GetVelocityTextureID() const;
 
     u32 GetWidth() const { return m_Framebuffer->GetWidth(); }
     u32 GetHeight() const { return m_Framebuffer->GetHeight(); }
+    u32 GetViewportWidth() const { return m_Framebuffer->GetViewportWidth(); }
+    u32 GetViewportHeight() const { return m_Framebuffer->GetViewportHeight(); }
 
     Framebuffer& GetFramebuffer() { return *m_Framebuffer; }
     const Framebuffer& GetFramebuffer() const { return *m_Framebuffer; }
 
+private:
+    void CreateFramebuffer(u32 width, u32 height);
+
+    // Color attachment holding the target, -1 if the layout doesn't store it
+    i32 GetAttachmentIndex(Attachment attachment) const;
+
 private:
     Scope<Framebuffer> m_Framebuffer;
+    GBufferLayout m_Layout = GBufferLayout::Standard;
 };
 
 } // namespace Engine
@@ -0,0 +1,92 @@
+#include "renderer/pipeline/HiZPyramid.hpp"
+#include "renderer/pipeline/GBuffer.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/rhi/CommandList.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+#include <bit>
+
+namespace Engine {
+
+HiZPyramid::HiZPyramid() {
+    // The last workgroup of each build resets it
+    const u32 zero = 0;
+    glCreateBuffers(1, &m_CounterBuffer);
+    GLMemory::BufferStorage(m_CounterBuffer, sizeof(u32), &zero, 0, MemoryTag::Renderer);
+
+    LoadShader();
+}
+
+HiZPyramid::~HiZPyramid() {
+    if (m_Texture) GLMemory::DeleteTextures(1, &m_Texture);
+    if (m_CounterBuffer) GLMemory::DeleteBuffers(1, &m_CounterBuffer);
+}
+
+void HiZPyramid::LoadShader() {
+    m_BuildShader = CreateRef<Shader>("assets/shaders/deferred/hiz_build.glsl");
+}
+
+void HiZPyramid::Reload() {
+    LoadShader();
+}
+
+void HiZPyramid::Allocate(u32 depthWidth, u32 depthHeight) {
+    if (m_Texture) GLMemory::DeleteTextures(1, &m_Texture);
+
+    m_DepthWidth = depthWidth;
+    m_DepthHeight = depthHeight;
+    m_Width = std::max(std::bit_ceil(depthWidth) / 2, 1u);
+    m_Height = std::max(std::bit_ceil(depthHeight) / 2, 1u);
+    m_LevelCount = std::min(static_cast<u32>(std::bit_width(std::max(m_Width, m_Height))), MaxLevels);
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_Texture);
+    GLMemory::TextureStorage2D(m_Texture, static_cast<i32>(m_LevelCount), GL_RG32F,
+                               static_cast<i32>(m_Width), static_cast<i32>(m_Height), MemoryTag::Renderer);
+    glTextureParameteri(m_Texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTextureParameteri(m_Texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTextureParameteri(m_Texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_Texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    LOG_CORE_INFO("Hi-Z pyramid: {}x{}, {} levels", m_Width, m_Height, m_LevelCount);
+}
+
+void HiZPyramid::Prepare(const GBuffer& gbuffer, const glm::mat4& viewProjection) {
+    m_ViewProjection = viewProjection;
+
+    if (gbuffer.GetWidth() != m_DepthWidth || gbuffer.GetHeight() != m_DepthHeight) {
+        Allocate(gbuffer.GetWidth(), gbuffer.GetHeight());
+    }
+
+    m_UVScale = glm::vec2(static_cast<f32>(gbuffer.GetViewportWidth()), static_cast<f32>(gbuffer.GetViewportHeight())) /
+                (2.0f * glm::vec2(static_cast<f32>(m_Width), static_cast<f32>(m_Height)));
+}
+
+void HiZPyramid::Record(CommandList& commands, const GBuffer& gbuffer) const {
+    PipelineDesc pipeline;
+    pipeline.Program = m_BuildShader.get();
+    pipeline.Compute = true;
+    commands.BindPipeline(pipeline);
+    commands.SetInt2("u_DepthSize", glm::ivec2(static_cast<i32>(gbuffer.GetViewportWidth()),
+                                                static_cast<i32>(gbuffer.GetViewportHeight())));
+    commands.SetInt("u_LevelCount", static_cast<i32>(m_LevelCount));
+
+    commands.BindTexture(0, gbuffer.GetDepthTextureID());
+
+    // Every image unit gets a level; the shader never touches the repeats
+    // past the level count
+    for (u32 level = 0; level < MaxLevels; ++level) {
+        commands.BindImage(level, m_Texture, std::min(level, m_LevelCount - 1), ImageAccess::ReadWrite,
+                           TextureFormat::RG32F);
+    }
+    commands.BindBuffer(BufferBinding::Storage, CounterBinding, m_CounterBuffer);
+
+    // Level 0 texels cover 2x2 depth texels
+    const u32 groupTexels = TileSize / 2;
+    commands.Dispatch((m_Width + groupTexels - 1) / groupTexels, (m_Height + groupTexels - 1) / groupTexels, 1);
+
+    commands.Barrier(ResourceAccess::ShaderImage, ResourceAccess::TextureFetch | ResourceAccess::ShaderImage);
+}
+
+} // namespace Engine
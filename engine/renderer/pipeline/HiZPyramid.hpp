@@ -0,0 +1,90 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+class GBuffer;
+class CommandList;
+
+// HiZPyramid - min / max depth mip chain built from the G-Buffer depth.
+//
+// An RG32F texture: R is the nearest (min) depth a texel covers, G the
+// farthest (max). Level 0 is half the depth buffer's size rounded up to a
+// power of two, so every level is an exact 2x2 reduction of the one below
+// and no texel at an odd edge gets lost. Texels outside the rendered
+// viewport hold (1, 0), which neither reduction picks up.
+//
+// Built in a single compute dispatch (hiz_build.glsl): each workgroup
+// reduces a 64x64 depth tile through levels 0-5 in shared memory, and the
+// last workgroup to finish, found with an atomic counter, reduces the rest
+// from everyone's level 5. Levels stop at MaxLevels, which keeps every
+// level bound as an image at once. The dispatch is recorded into a
+// CommandList, so it can be recorded on a worker while the G-Buffer is
+// still being drawn, and runs when the list is submitted.
+//
+// Occlusion culling, screen-space collision and AO sample it through
+// GetUVScale(); sample with textureLod / texelFetch, never filtered.
+class HiZPyramid {
+public:
+    // Must match hiz_build.glsl
+    static constexpr u32 MaxLevels = 8;
+    static constexpr u32 TileSize = 64;         // Depth texels per workgroup side
+    static constexpr u32 CounterBinding = 0;    // SSBO
+
+    HiZPyramid();
+    ~HiZPyramid();
+
+    HiZPyramid(const HiZPyramid&) = delete;
+    HiZPyramid& operator=(const HiZPyramid&) = delete;
+
+    // Size the pyramid for the G-Buffer and take the view-projection its
+    // depth is rendered with, on the thread owning the GL context. Storage
+    // follows the G-Buffer's allocated size, so render scale changes don't
+    // reallocate.
+    void Prepare(const GBuffer& gbuffer, const glm::mat4& viewProjection);
+
+    // Record the rebuild from the G-Buffer's depth over its viewport. Makes
+    // no GL calls, so any thread can record once Prepare() has run; the
+    // list must be submitted after the depth is written.
+    void Record(CommandList& commands, const GBuffer& gbuffer) const;
+
+    // Built at least once; the texture is undefined before
+    bool IsValid() const { return m_Texture != 0; }
+
+    u32 GetTextureID() const { return m_Texture; }
+    u32 GetWidth() const { return m_Width; }        // Level 0
+    u32 GetHeight() const { return m_Height; }
+    u32 GetLevelCount() const { return m_LevelCount; }
+
+    // Viewport UV (0-1 across the rendered region) times this is pyramid UV
+    glm::vec2 GetUVScale() const { return m_UVScale; }
+
+    // What the depth was rendered with; next frame's occlusion tests project
+    // into the pyramid with it
+    const glm::mat4& GetViewProjection() const { return m_ViewProjection; }
+
+    void Reload();
+
+private:
+    void Allocate(u32 depthWidth, u32 depthHeight);
+    void LoadShader();
+
+private:
+    Ref<Shader> m_BuildShader;
+
+    u32 m_Texture = 0;
+    u32 m_CounterBuffer = 0;
+
+    u32 m_DepthWidth = 0;
+    u32 m_DepthHeight = 0;
+    u32 m_Width = 0;
+    u32 m_Height = 0;
+    u32 m_LevelCount = 0;
+    glm::vec2 m_UVScale{1.0f};
+    glm::mat4 m_ViewProjection{1.0f};
+};
+
+} // namespace Engine
@@ -0,0 +1,161 @@
+#include "renderer/pipeline/IndirectDrawBatcher.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+
+namespace Engine {
+
+namespace {
+
+u32 NextCapacity(u32 required) {
+    u32 capacity = 1024;
+    while (capacity < required) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+} // anonymous namespace
+
+IndirectDrawBatcher::IndirectDrawBatcher(u32 initialCapacity) {
+    const u32 capacity = NextCapacity(initialCapacity);
+    m_InstanceRing = CreateScope<GPURingBuffer>(capacity * sizeof(InstanceData));
+    m_CommandRing = CreateScope<GPURingBuffer>(capacity * sizeof(DrawElementsIndirectCommand));
+    EnsureIndexCapacity(capacity);
+}
+
+IndirectDrawBatcher::~IndirectDrawBatcher() {
+    if (m_InstanceIndexBuffer) {
+        GLMemory::DeleteBuffers(1, &m_InstanceIndexBuffer);
+    }
+}
+
+void IndirectDrawBatcher::EnsureIndexCapacity(u32 required) {
+    if (m_InstanceIndexBuffer && required <= m_IndexCapacity) return;
+
+    // Immutable storage, so growing means recreating. Deleting a buffer the
+    // GPU still reads is safe in GL; the driver defers the release.
+    if (m_InstanceIndexBuffer) {
+        GLMemory::DeleteBuffers(1, &m_InstanceIndexBuffer);
+    }
+
+    m_IndexCapacity = NextCapacity(required);
+
+    // Identity table: instance attribute value == baseInstance + gl_InstanceID
+    Vector<u32> indices(m_IndexCapacity);
+    for (u32 i = 0; i < m_IndexCapacity; ++i) {
+        indices[i] = i;
+    }
+    glCreateBuffers(1, &m_InstanceIndexBuffer);
+    GLMemory::BufferStorage(m_InstanceIndexBuffer, m_IndexCapacity * sizeof(u32), indices.data(), 0,
+                            MemoryTag::Renderer);
+}
+
+void IndirectDrawBatcher::Prepare(Vector<DrawItem>& items) {
+    m_Stats = {};
+    m_Batches.clear();
+    m_MultiDraws.clear();
+
+    const u32 count = static_cast<u32>(items.size());
+    if (count == 0) return;
+
+    EnsureIndexCapacity(count);
+
+    // Batches never outnumber items, so size the command range for the worst case
+    m_InstanceRing->BeginFrame();
+    m_CommandRing->BeginFrame();
+    m_Instances = m_InstanceRing->Allocate(count * sizeof(InstanceData));
+    m_Commands = m_CommandRing->Allocate(count * sizeof(DrawElementsIndirectCommand));
+    if (!m_Instances || !m_Commands) return;
+
+    m_PreviousTransforms = {};
+    if (m_WritePreviousTransforms) {
+        if (!m_PreviousRing) {
+            m_PreviousRing = CreateScope<GPURingBuffer>(m_IndexCapacity * sizeof(glm::mat4));
+        }
+        m_PreviousRing->BeginFrame();
+        m_PreviousTransforms = m_PreviousRing->Allocate(count * sizeof(glm::mat4));
+    }
+
+    std::sort(items.begin(), items.end(), [](const DrawItem& a, const DrawItem& b) {
+        if (a.VAO != b.VAO) return a.VAO < b.VAO;
+        if (a.BaseIndex != b.BaseIndex) return a.BaseIndex < b.BaseIndex;
+        if (a.BaseVertex != b.BaseVertex) return a.BaseVertex < b.BaseVertex;
+        return a.MaterialId < b.MaterialId;
+    });
+
+    InstanceData* instances = static_cast<InstanceData*>(m_Instances.Data);
+    auto* commands = static_cast<DrawElementsIndirectCommand*>(m_Commands.Data);
+    auto* previous = static_cast<glm::mat4*>(m_PreviousTransforms.Data);
+
+    for (u32 i = 0; i < count; ++i) {
+        const DrawItem& item = items[i];
+        instances[i] = item.Instance;
+        if (previous) {
+            previous[i] = item.PreviousTransform;
+        }
+
+        bool newVAO = m_MultiDraws.empty() || m_MultiDraws.back().VAO != item.VAO;
+        bool newMesh = newVAO || items[i - 1].BaseIndex != item.BaseIndex ||
+                       items[i - 1].BaseVertex != item.BaseVertex;
+        bool newBatch = newMesh || m_Batches.back().MaterialId != item.MaterialId;
+
+        if (newVAO) {
+            MultiDraw draw;
+            draw.VAO = item.VAO;
+            draw.FirstCommand = static_cast<u32>(m_Batches.size());
+            m_MultiDraws.push_back(draw);
+        }
+
+        if (newBatch) {
+            BatchInfo batch;
+            batch.MeshId = item.MeshId;
+            batch.MaterialId = item.MaterialId;
+            batch.StartIndex = i;
+            m_Batches.push_back(batch);
+            m_MultiDraws.back().CommandCount++;
+
+            DrawElementsIndirectCommand& command = commands[m_Batches.size() - 1];
+            command.Count = item.IndexCount;
+            command.InstanceCount = 0;
+            command.FirstIndex = item.BaseIndex;
+            command.BaseVertex = static_cast<i32>(item.BaseVertex);
+            command.BaseInstance = i;
+        }
+
+        m_Batches.back().InstanceCount++;
+        commands[m_Batches.size() - 1].InstanceCount++;
+    }
+
+    m_Stats.Instances = count;
+    m_Stats.Batches = static_cast<u32>(m_Batches.size());
+}
+
+void IndirectDrawBatcher::Draw() {
+    if (m_MultiDraws.empty()) return;
+
+    GPURingBuffer::BindRange(GL_SHADER_STORAGE_BUFFER, InstanceBufferBinding, m_Instances);
+    if (m_PreviousTransforms) {
+        GPURingBuffer::BindRange(GL_SHADER_STORAGE_BUFFER, PreviousTransformBinding, m_PreviousTransforms);
+    }
+    GLStateCache::Instance().BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_Commands.Buffer);
+
+    for (const auto& draw : m_MultiDraws) {
+        draw.VAO->SetInstanceIndexBuffer(m_InstanceIndexBuffer, InstanceIndexLocation);
+        draw.VAO->Bind();
+
+        const usize offset = m_Commands.Offset + draw.FirstCommand * sizeof(DrawElementsIndirectCommand);
+        PipelineWarmup::RecordDraw(GL_TRIANGLES);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                    reinterpret_cast<const void*>(offset),
+                                    static_cast<GLsizei>(draw.CommandCount), 0);
+        m_Stats.DrawCalls++;
+    }
+
+    GLStateCache::Instance().BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+} // namespace Engine
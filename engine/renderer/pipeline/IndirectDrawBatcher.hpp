@@ -0,0 +1,114 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "ecs/Components/Renderable.hpp"
+#include "renderer/opengl/GLVertexArray.hpp"
+#include "renderer/opengl/GPURingBuffer.hpp"
+
+namespace Engine {
+
+class Mesh;
+
+// IndirectDrawBatcher - instanced multi-draw-indirect submission.
+//
+// Draw items are bucketed by (mesh, MaterialId). Per-instance data goes into
+// a persistently mapped SSBO and every bucket becomes one indirect command;
+// all buckets that share a vertex array are issued with a single
+// glMultiDrawElementsIndirect, so draw calls scale with unique vertex arrays
+// rather than entities. Meshes in a GeometryPool page share one vertex array
+// and are told apart by their base vertex / index.
+//
+// GL 4.5 has no gl_BaseInstance, so each vertex array gets an extra per-instance
+// attribute (InstanceIndexLocation) sourced from an identity buffer; the
+// command's baseInstance offsets into it and the shader reads
+// Instances[a_InstanceIndex] relative to this frame's bound range.
+//
+// Instances and commands stream through GPURingBuffers, so the CPU never
+// writes into a region the GPU may still be reading.
+//
+// With previous transforms enabled, each item's PreviousTransform also goes
+// into a parallel stream at PreviousTransformBinding, for passes that write
+// motion vectors. Passes that don't leave it off and skip the copy.
+class IndirectDrawBatcher {
+public:
+    static constexpr u32 InstanceBufferBinding = 4;   // std430 binding point
+    static constexpr u32 InstanceIndexLocation = 8;   // Vertex attribute location
+    static constexpr u32 PreviousTransformBinding = 14;   // std430 binding point
+
+    struct DrawItem {
+        VertexArray* VAO = nullptr;  // With the base offsets, identifies the mesh
+        VertexArray* DepthVAO = nullptr;    // Position-only stream for depth passes, null for none
+        u32 IndexCount = 0;
+        u32 BaseVertex = 0;
+        u32 BaseIndex = 0;
+        u32 MeshId = 0;
+        u32 MaterialId = 0;
+        InstanceData Instance;
+        glm::mat4 PreviousTransform{1.0f};  // Instance.Transform as of last frame
+        f32 ScreenSize = 0.0f;      // Projected diameter in pixels, for the caller's texture streaming
+        const Mesh* ClusterMesh = nullptr;  // Meshlets to cull per cluster (MeshletCuller), null to draw whole
+        bool Impostor = false;      // Quad of ImpostorLibrary's; Instance.Flags is the impostor
+    };
+
+    struct Stats {
+        u32 Instances = 0;
+        u32 Batches = 0;     // Unique (mesh, material) buckets
+        u32 DrawCalls = 0;   // glMultiDrawElementsIndirect calls
+    };
+
+    explicit IndirectDrawBatcher(u32 initialCapacity = 4096);
+    ~IndirectDrawBatcher();
+
+    IndirectDrawBatcher(const IndirectDrawBatcher&) = delete;
+    IndirectDrawBatcher& operator=(const IndirectDrawBatcher&) = delete;
+
+    // Sort items into buckets and write instance data and commands for this
+    // frame. items is reordered.
+    void Prepare(Vector<DrawItem>& items);
+
+    // Issue the prepared draws. The caller binds the shader. May be called
+    // more than once per Prepare, e.g. once per view; the next Prepare fences
+    // every draw that read this frame's buffers.
+    void Draw();
+
+    void SetPreviousTransforms(bool enabled) { m_WritePreviousTransforms = enabled; }
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    struct DrawElementsIndirectCommand {
+        u32 Count;
+        u32 InstanceCount;
+        u32 FirstIndex;
+        i32 BaseVertex;
+        u32 BaseInstance;
+    };
+
+    // Consecutive commands that share a vertex array
+    struct MultiDraw {
+        VertexArray* VAO = nullptr;
+        u32 FirstCommand = 0;
+        u32 CommandCount = 0;
+    };
+
+    void EnsureIndexCapacity(u32 required);
+
+private:
+    Scope<GPURingBuffer> m_InstanceRing;
+    Scope<GPURingBuffer> m_CommandRing;
+    GPURingBuffer::Allocation m_Instances;
+    GPURingBuffer::Allocation m_Commands;
+    Scope<GPURingBuffer> m_PreviousRing;   // Created when first written
+    GPURingBuffer::Allocation m_PreviousTransforms;
+    bool m_WritePreviousTransforms = false;
+
+    u32 m_InstanceIndexBuffer = 0;
+    u32 m_IndexCapacity = 0;
+
+    Vector<BatchInfo> m_Batches;
+    Vector<MultiDraw> m_MultiDraws;
+
+    Stats m_Stats;
+};
+
+} // namespace Engine
@@ -0,0 +1,287 @@
+#include "renderer/pipeline/PostProcessStack.hpp"
+#include "renderer/pipeline/Framebuffer.hpp"
+#include "renderer/pipeline/RenderTargetPool.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Engine {
+
+namespace {
+
+// Must match exposure_adapt.glsl
+struct ExposureState {
+    f32 AdaptedLuminance = 0.0f;    // 0 = not adapted yet, take the first average as is
+    f32 Exposure = 1.0f;
+    f32 Padding[2] = {};
+};
+
+u32 GroupCount(u32 size) {
+    return (size + PostProcessStack::GroupSize - 1) / PostProcessStack::GroupSize;
+}
+
+u32 LevelSize(u32 size, u32 level) {
+    return std::max(size >> level, 1u);
+}
+
+} // anonymous namespace
+
+PostProcessStack::PostProcessStack() {
+    glCreateBuffers(1, &m_HistogramBuffer);
+    const Vector<u32> bins(HistogramBins, 0);
+    GLMemory::BufferStorage(m_HistogramBuffer, HistogramBins * sizeof(u32), bins.data(), 0, MemoryTag::Renderer);
+
+    const ExposureState exposure;
+    glCreateBuffers(1, &m_ExposureBuffer);
+    GLMemory::BufferStorage(m_ExposureBuffer, sizeof(ExposureState), &exposure, 0, MemoryTag::Renderer);
+
+    glCreateTextures(GL_TEXTURE_3D, 1, &m_LUTTexture);
+    GLMemory::TextureStorage3D(m_LUTTexture, 1, GL_RGBA8, LUTSize, LUTSize, LUTSize, MemoryTag::Renderer);
+    glTextureParameteri(m_LUTTexture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(m_LUTTexture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(m_LUTTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_LUTTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_LUTTexture, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+    LoadShaders();
+}
+
+PostProcessStack::~PostProcessStack() {
+    if (m_HistogramBuffer) GLMemory::DeleteBuffers(1, &m_HistogramBuffer);
+    if (m_ExposureBuffer) GLMemory::DeleteBuffers(1, &m_ExposureBuffer);
+    if (m_BloomTexture) GLMemory::DeleteTextures(1, &m_BloomTexture);
+    if (m_LUTTexture) GLMemory::DeleteTextures(1, &m_LUTTexture);
+    RenderTargetPool::Release(m_OutputTexture);
+    if (m_OutputFramebuffer) glDeleteFramebuffers(1, &m_OutputFramebuffer);
+}
+
+void PostProcessStack::LoadShaders() {
+    m_DownsampleShader = CreateRef<Shader>("assets/shaders/postprocess/bloom_downsample.glsl");
+    m_UpsampleShader = CreateRef<Shader>("assets/shaders/postprocess/bloom_upsample.glsl");
+    m_ExposureShader = CreateRef<Shader>("assets/shaders/postprocess/exposure_adapt.glsl");
+    m_CompositeShader = CreateRef<Shader>("assets/shaders/postprocess/post_composite.glsl");
+}
+
+void PostProcessStack::Reload() {
+    LoadShaders();
+}
+
+void PostProcessStack::AllocateBloom(u32 hdrWidth, u32 hdrHeight) {
+    if (m_BloomTexture) GLMemory::DeleteTextures(1, &m_BloomTexture);
+
+    m_HDRWidth = hdrWidth;
+    m_HDRHeight = hdrHeight;
+    m_BloomWidth = std::max((hdrWidth + 1) / 2, 1u);
+    m_BloomHeight = std::max((hdrHeight + 1) / 2, 1u);
+    m_BloomLevelCount = std::min(static_cast<u32>(std::bit_width(std::max(m_BloomWidth, m_BloomHeight))),
+                                 MaxBloomLevels);
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_BloomTexture);
+    GLMemory::TextureStorage2D(m_BloomTexture, static_cast<i32>(m_BloomLevelCount), GL_R11F_G11F_B10F,
+                               static_cast<i32>(m_BloomWidth), static_cast<i32>(m_BloomHeight), MemoryTag::Renderer);
+    glTextureParameteri(m_BloomTexture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+    glTextureParameteri(m_BloomTexture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(m_BloomTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_BloomTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    LOG_CORE_INFO("Bloom chain: {}x{}, {} levels", m_BloomWidth, m_BloomHeight, m_BloomLevelCount);
+}
+
+void PostProcessStack::AllocateOutput(u32 width, u32 height) {
+    RenderTargetPool::Release(m_OutputTexture);
+    if (!m_OutputFramebuffer) glCreateFramebuffers(1, &m_OutputFramebuffer);
+
+    m_OutputWidth = width;
+    m_OutputHeight = height;
+
+    m_OutputTexture = RenderTargetPool::Acquire(GL_RGBA8, width, height);
+    glTextureParameteri(m_OutputTexture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(m_OutputTexture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glNamedFramebufferTexture(m_OutputFramebuffer, GL_COLOR_ATTACHMENT0, m_OutputTexture, 0);
+}
+
+void PostProcessStack::UpdateGradingLUT() {
+    const Settings& s = m_Settings;
+    if (m_GradingKey.Contrast == s.Contrast && m_GradingKey.Saturation == s.Saturation &&
+        m_GradingKey.ColorFilter == s.ColorFilter) {
+        return;
+    }
+    m_GradingKey.Contrast = s.Contrast;
+    m_GradingKey.Saturation = s.Saturation;
+    m_GradingKey.ColorFilter = s.ColorFilter;
+
+    // Indexed by the display (gamma encoded) color, so the table spends its
+    // resolution where the eye does
+    const glm::vec3 lumaWeights(0.2126f, 0.7152f, 0.0722f);
+    const f32 step = 1.0f / static_cast<f32>(LUTSize - 1);
+    Vector<u8> texels(LUTSize * LUTSize * LUTSize * 4);
+    usize i = 0;
+    for (u32 b = 0; b < LUTSize; ++b) {
+        for (u32 g = 0; g < LUTSize; ++g) {
+            for (u32 r = 0; r < LUTSize; ++r) {
+                glm::vec3 color(static_cast<f32>(r) * step, static_cast<f32>(g) * step, static_cast<f32>(b) * step);
+                color = (color - 0.5f) * s.Contrast + 0.5f;
+                color = glm::mix(glm::vec3(glm::dot(color, lumaWeights)), color, s.Saturation);
+                color = glm::clamp(color * s.ColorFilter, 0.0f, 1.0f);
+
+                texels[i++] = static_cast<u8>(std::lround(color.r * 255.0f));
+                texels[i++] = static_cast<u8>(std::lround(color.g * 255.0f));
+                texels[i++] = static_cast<u8>(std::lround(color.b * 255.0f));
+                texels[i++] = 255;
+            }
+        }
+    }
+    glTextureSubImage3D(m_LUTTexture, 0, 0, 0, 0, LUTSize, LUTSize, LUTSize, GL_RGBA, GL_UNSIGNED_BYTE,
+                        texels.data());
+}
+
+void PostProcessStack::Render(const Framebuffer& hdr, const glm::vec2& uvScale, u32 outputWidth, u32 outputHeight,
+                              f32 deltaTime) {
+    if (outputWidth == 0 || outputHeight == 0) return;
+
+    if (outputWidth != m_OutputWidth || outputHeight != m_OutputHeight) {
+        AllocateOutput(outputWidth, outputHeight);
+    }
+    if (hdr.GetWidth() != m_HDRWidth || hdr.GetHeight() != m_HDRHeight) {
+        AllocateBloom(hdr.GetWidth(), hdr.GetHeight());
+    }
+    UpdateGradingLUT();
+
+    // The histogram rides on the first bloom downsample, so auto-exposure
+    // needs that pass even with bloom off
+    if (m_Settings.Bloom || m_Settings.AutoExposure) {
+        const glm::uvec2 renderSize(
+            std::max(static_cast<u32>(std::lround(uvScale.x * static_cast<f32>(hdr.GetWidth()))), 1u),
+            std::max(static_cast<u32>(std::lround(uvScale.y * static_cast<f32>(hdr.GetHeight()))), 1u));
+        RenderBloom(hdr, renderSize);
+    }
+    if (m_Settings.AutoExposure) {
+        AdaptExposure(deltaTime);
+    }
+    Composite(hdr, uvScale);
+}
+
+void PostProcessStack::RenderBloom(const Framebuffer& hdr, const glm::uvec2& renderSize) {
+    auto& state = GLStateCache::Instance();
+    const Settings& s = m_Settings;
+    const u32 levels = s.Bloom ? std::clamp(s.BloomLevels, 1u, m_BloomLevelCount) : 1;
+
+    // Each level covers half the one below, within its allocation
+    m_BloomRegions.resize(levels);
+    for (u32 level = 0; level < levels; ++level) {
+        const glm::uvec2 below = level == 0 ? renderSize : m_BloomRegions[level - 1];
+        m_BloomRegions[level] = glm::min((below + 1u) / 2u,
+                                         glm::uvec2(LevelSize(m_BloomWidth, level), LevelSize(m_BloomHeight, level)));
+    }
+
+    auto uvMax = [this](u32 level) {
+        return glm::vec2(m_BloomRegions[level]) /
+               glm::vec2(static_cast<f32>(LevelSize(m_BloomWidth, level)), static_cast<f32>(LevelSize(m_BloomHeight, level)));
+    };
+
+    m_DownsampleShader->Bind();
+    m_DownsampleShader->SetFloat("u_Threshold", s.BloomThreshold);
+    m_DownsampleShader->SetFloat("u_Knee", s.BloomKnee);
+    m_DownsampleShader->SetFloat("u_MinLogLuminance", s.MinLogLuminance);
+    m_DownsampleShader->SetFloat("u_LogLuminanceRange", std::max(s.MaxLogLuminance - s.MinLogLuminance, 0.01f));
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, HistogramBinding, m_HistogramBuffer);
+
+    for (u32 level = 0; level < levels; ++level) {
+        const bool first = level == 0;
+        if (first) {
+            state.BindTextureUnit(0, hdr.GetColorAttachmentRendererID(0));
+            m_DownsampleShader->SetInt("u_SourceLevel", 0);
+            m_DownsampleShader->SetFloat2("u_SourceUVMax", glm::vec2(renderSize) /
+                glm::vec2(static_cast<f32>(hdr.GetWidth()), static_cast<f32>(hdr.GetHeight())));
+        } else {
+            state.BindTextureUnit(0, m_BloomTexture);
+            m_DownsampleShader->SetInt("u_SourceLevel", static_cast<i32>(level - 1));
+            m_DownsampleShader->SetFloat2("u_SourceUVMax", uvMax(level - 1));
+        }
+        m_DownsampleShader->SetInt("u_FirstPass", first ? 1 : 0);
+        m_DownsampleShader->SetInt("u_Histogram", first && s.AutoExposure ? 1 : 0);
+        m_DownsampleShader->SetInt2("u_DestSize", glm::ivec2(m_BloomRegions[level]));
+
+        glBindImageTexture(0, m_BloomTexture, static_cast<i32>(level), GL_FALSE, 0, GL_WRITE_ONLY, GL_R11F_G11F_B10F);
+        glDispatchCompute(GroupCount(m_BloomRegions[level].x), GroupCount(m_BloomRegions[level].y), 1);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
+                        GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    if (!s.Bloom) return;
+
+    // Back up the chain: every level adds the tent-filtered one below it
+    m_UpsampleShader->Bind();
+    state.BindTextureUnit(0, m_BloomTexture);
+    for (u32 level = levels - 1; level-- > 0;) {
+        m_UpsampleShader->SetInt("u_SourceLevel", static_cast<i32>(level + 1));
+        m_UpsampleShader->SetFloat2("u_SourceUVMax", uvMax(level + 1));
+        m_UpsampleShader->SetInt2("u_DestSize", glm::ivec2(m_BloomRegions[level]));
+
+        glBindImageTexture(0, m_BloomTexture, static_cast<i32>(level), GL_FALSE, 0, GL_READ_WRITE, GL_R11F_G11F_B10F);
+        glDispatchCompute(GroupCount(m_BloomRegions[level].x), GroupCount(m_BloomRegions[level].y), 1);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+    }
+}
+
+void PostProcessStack::AdaptExposure(f32 deltaTime) {
+    const Settings& s = m_Settings;
+
+    m_ExposureShader->Bind();
+    m_ExposureShader->SetFloat("u_MinLogLuminance", s.MinLogLuminance);
+    m_ExposureShader->SetFloat("u_LogLuminanceRange", std::max(s.MaxLogLuminance - s.MinLogLuminance, 0.01f));
+    m_ExposureShader->SetFloat("u_LowPercent", s.LowPercent);
+    m_ExposureShader->SetFloat("u_HighPercent", std::max(s.HighPercent, s.LowPercent));
+    m_ExposureShader->SetFloat("u_Adaptation", 1.0f - std::exp(-std::max(deltaTime, 0.0f) * s.AdaptationSpeed));
+    m_ExposureShader->SetFloat("u_KeyValue", s.KeyValue);
+
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, HistogramBinding, m_HistogramBuffer);
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, ExposureBinding, m_ExposureBuffer);
+    glDispatchCompute(1, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void PostProcessStack::Composite(const Framebuffer& hdr, const glm::vec2& uvScale) {
+    auto& state = GLStateCache::Instance();
+    const Settings& s = m_Settings;
+    const bool bloom = s.Bloom && !m_BloomRegions.empty();
+
+    m_CompositeShader->Bind();
+    m_CompositeShader->SetInt2("u_OutputSize", glm::ivec2(static_cast<i32>(m_OutputWidth),
+                                                          static_cast<i32>(m_OutputHeight)));
+    m_CompositeShader->SetFloat2("u_UVScale", uvScale);
+    m_CompositeShader->SetFloat("u_Sharpness", uvScale.x < 1.0f ? s.Sharpness : 0.0f);
+    m_CompositeShader->SetFloat("u_Exposure", s.Exposure);
+    m_CompositeShader->SetInt("u_AutoExposure", s.AutoExposure ? 1 : 0);
+    m_CompositeShader->SetFloat("u_Gamma", s.Gamma);
+    m_CompositeShader->SetFloat("u_BloomIntensity", bloom ? s.BloomIntensity : 0.0f);
+    if (bloom) {
+        m_CompositeShader->SetFloat2("u_BloomUVMax", glm::vec2(m_BloomRegions[0]) /
+            glm::vec2(static_cast<f32>(m_BloomWidth), static_cast<f32>(m_BloomHeight)));
+    }
+
+    state.BindTextureUnit(0, hdr.GetColorAttachmentRendererID(0));
+    state.BindTextureUnit(1, m_BloomTexture);
+    state.BindTextureUnit(2, m_LUTTexture);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, ExposureBinding, m_ExposureBuffer);
+    glBindImageTexture(0, m_OutputTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+
+    glDispatchCompute(GroupCount(m_OutputWidth), GroupCount(m_OutputHeight), 1);
+    glMemoryBarrier(GL_FRAMEBUFFER_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+
+void PostProcessStack::Blit(u32 framebuffer, i32 x, i32 y) const {
+    if (!m_OutputFramebuffer) return;
+
+    const i32 width = static_cast<i32>(m_OutputWidth);
+    const i32 height = static_cast<i32>(m_OutputHeight);
+    glBlitNamedFramebuffer(m_OutputFramebuffer, framebuffer, 0, 0, width, height, x, y, x + width, y + height,
+                           GL_COLOR_BUFFER_BIT, GL_NEAREST);
+}
+
+} // namespace Engine
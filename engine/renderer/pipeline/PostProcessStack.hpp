@@ -0,0 +1,138 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+class Framebuffer;
+
+// PostProcessStack - HDR to display in compute: bloom, auto-exposure, color
+// grading and tonemapping.
+//
+// Per frame:
+//   bloom_downsample.glsl  13-tap downsample of the lighting buffer into
+//                          bloom level 0 with a soft threshold, Karis
+//                          averaged against fireflies; the same pass bins
+//                          log luminance into a 256-bin histogram. Further
+//                          dispatches halve down the chain.
+//   bloom_upsample.glsl    tent-filters each level into the one above,
+//                          accumulating back up to level 0.
+//   exposure_adapt.glsl    one workgroup averages the histogram between the
+//                          low / high percentiles, eases the adapted
+//                          luminance toward it and clears the bins. The
+//                          result stays on the GPU for the composite.
+//   post_composite.glsl    reads the scene once more at output resolution
+//                          (upscaling and sharpening a dynamic resolution
+//                          render), adds bloom, applies exposure, ACES,
+//                          gamma and the grading LUT, and writes the
+//                          display image.
+//
+// Bloom works over the rendered region of the lighting buffer, so dynamic
+// resolution changes don't reallocate it. The grading LUT is a 32^3 table
+// baked on the CPU whenever the grading settings change.
+//
+// The result lands in an RGBA8 texture; Blit() copies it to a framebuffer
+// (compute can't write the default one).
+class PostProcessStack {
+public:
+    // Must match the post shaders
+    static constexpr u32 HistogramBins = 256;
+    static constexpr u32 GroupSize = 16;
+    static constexpr u32 MaxBloomLevels = 6;
+    static constexpr u32 LUTSize = 32;
+    static constexpr u32 HistogramBinding = 0;      // SSBO
+    static constexpr u32 ExposureBinding = 1;       // SSBO
+
+    struct Settings {
+        f32 Exposure = 1.0f;            // Manual exposure; compensation on top of auto
+        f32 Gamma = 2.2f;
+        f32 Sharpness = 0.25f;          // Applied only when upscaling
+
+        bool AutoExposure = false;
+        f32 MinLogLuminance = -10.0f;   // Histogram range, log2
+        f32 MaxLogLuminance = 6.0f;
+        f32 LowPercent = 0.5f;          // Percentiles averaged between; darker and
+        f32 HighPercent = 0.95f;        // brighter texels are ignored
+        f32 AdaptationSpeed = 1.5f;     // Per second
+        f32 KeyValue = 0.18f;           // Middle grey the average maps to
+
+        bool Bloom = true;
+        f32 BloomThreshold = 1.0f;
+        f32 BloomKnee = 0.5f;           // Soft threshold width, fraction of the threshold
+        f32 BloomIntensity = 0.04f;
+        u32 BloomLevels = MaxBloomLevels;
+
+        f32 Contrast = 1.0f;
+        f32 Saturation = 1.0f;
+        glm::vec3 ColorFilter{1.0f};
+    };
+
+    PostProcessStack();
+    ~PostProcessStack();
+
+    PostProcessStack(const PostProcessStack&) = delete;
+    PostProcessStack& operator=(const PostProcessStack&) = delete;
+
+    // Process the region uvScale of hdr's first attachment into an
+    // outputWidth x outputHeight image. deltaTime drives exposure adaptation.
+    void Render(const Framebuffer& hdr, const glm::vec2& uvScale, u32 outputWidth, u32 outputHeight,
+                f32 deltaTime);
+
+    // Copy the last Render's result to framebuffer (0 = default), lower left
+    // corner at (x, y)
+    void Blit(u32 framebuffer, i32 x = 0, i32 y = 0) const;
+
+    u32 GetOutputTextureID() const { return m_OutputTexture; }
+    u32 GetBloomTextureID() const { return m_BloomTexture; }
+
+    Settings& GetSettings() { return m_Settings; }
+    const Settings& GetSettings() const { return m_Settings; }
+
+    void Reload();
+
+private:
+    struct GradingKey {
+        f32 Contrast = -1.0f;
+        f32 Saturation = -1.0f;
+        glm::vec3 ColorFilter{-1.0f};
+    };
+
+    void LoadShaders();
+    void AllocateBloom(u32 hdrWidth, u32 hdrHeight);
+    void AllocateOutput(u32 width, u32 height);
+    void UpdateGradingLUT();
+    void RenderBloom(const Framebuffer& hdr, const glm::uvec2& renderSize);
+    void AdaptExposure(f32 deltaTime);
+    void Composite(const Framebuffer& hdr, const glm::vec2& uvScale);
+
+private:
+    Ref<Shader> m_DownsampleShader;
+    Ref<Shader> m_UpsampleShader;
+    Ref<Shader> m_ExposureShader;
+    Ref<Shader> m_CompositeShader;
+
+    u32 m_BloomTexture = 0;
+    u32 m_BloomWidth = 0;       // Level 0 allocation
+    u32 m_BloomHeight = 0;
+    u32 m_BloomLevelCount = 0;
+    u32 m_HDRWidth = 0;
+    u32 m_HDRHeight = 0;
+    Vector<glm::uvec2> m_BloomRegions;  // Rendered texels per level this frame
+
+    u32 m_HistogramBuffer = 0;
+    u32 m_ExposureBuffer = 0;
+
+    u32 m_LUTTexture = 0;
+    GradingKey m_GradingKey;
+
+    u32 m_OutputTexture = 0;
+    u32 m_OutputFramebuffer = 0;
+    u32 m_OutputWidth = 0;
+    u32 m_OutputHeight = 0;
+
+    Settings m_Settings;
+};
+
+} // namespace Engine
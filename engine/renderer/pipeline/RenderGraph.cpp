@@ -0,0 +1,447 @@
+#include "renderer/pipeline/RenderGraph.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GPUProfiler.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+#include <cstring>
+
+namespace Engine {
+
+namespace {
+
+GLbitfield BarrierBit(RenderGraph::Access access) {
+    switch (access) {
+        case RenderGraph::Access::ColorAttachment:
+        case RenderGraph::Access::DepthAttachment: return GL_FRAMEBUFFER_BARRIER_BIT;
+        case RenderGraph::Access::Sampled:         return GL_TEXTURE_FETCH_BARRIER_BIT;
+        case RenderGraph::Access::StorageImage:    return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+        case RenderGraph::Access::StorageBuffer:   return GL_SHADER_STORAGE_BARRIER_BIT;
+        case RenderGraph::Access::UniformBuffer:   return GL_UNIFORM_BARRIER_BIT;
+        case RenderGraph::Access::IndirectCommand: return GL_COMMAND_BARRIER_BIT;
+        case RenderGraph::Access::VertexBuffer:    return GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+        case RenderGraph::Access::Copy:
+            return GL_BUFFER_UPDATE_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT;
+        default: return 0;
+    }
+}
+
+// Writes that later accesses only see after a glMemoryBarrier
+bool IsIncoherentWrite(RenderGraph::Access access) {
+    return access == RenderGraph::Access::StorageImage || access == RenderGraph::Access::StorageBuffer;
+}
+
+} // anonymous namespace
+
+// ---------------------------------------------------------------------------
+// Builder / Context
+// ---------------------------------------------------------------------------
+
+void RenderGraph::Builder::Read(Resource resource, Access access) {
+    if (resource >= m_Graph.m_Versions.size()) {
+        LOG_CORE_ERROR("RenderGraph: pass '{}' reads an invalid resource", m_Graph.m_Passes[m_Pass].Name);
+        return;
+    }
+    m_Graph.m_Versions[resource].Readers.push_back(m_Pass);
+    m_Graph.m_Passes[m_Pass].Accesses.push_back({resource, access, false});
+}
+
+RenderGraph::Resource RenderGraph::Builder::Write(Resource resource, Access access) {
+    return m_Graph.RecordWrite(m_Pass, resource, access);
+}
+
+RenderGraph::Resource RenderGraph::Builder::WriteColor(Resource texture, u32 index) {
+    Resource version = m_Graph.RecordWrite(m_Pass, texture, Access::ColorAttachment);
+    if (version != InvalidResource) {
+        m_Graph.m_Passes[m_Pass].Attachments.push_back({version, index, false});
+    }
+    return version;
+}
+
+RenderGraph::Resource RenderGraph::Builder::WriteDepth(Resource texture) {
+    Resource version = m_Graph.RecordWrite(m_Pass, texture, Access::DepthAttachment);
+    if (version != InvalidResource) {
+        m_Graph.m_Passes[m_Pass].Attachments.push_back({version, 0, true});
+    }
+    return version;
+}
+
+void RenderGraph::Builder::SideEffect() {
+    m_Graph.m_Passes[m_Pass].SideEffect = true;
+}
+
+u32 RenderGraph::Context::GetTexture(Resource resource) const {
+    return m_Graph.GetResource(resource).Handle;
+}
+
+u32 RenderGraph::Context::GetBuffer(Resource resource) const {
+    return m_Graph.GetResource(resource).Handle;
+}
+
+const RenderGraph::TextureDesc& RenderGraph::Context::GetTextureDesc(Resource resource) const {
+    return m_Graph.GetResource(resource).Desc;
+}
+
+// ---------------------------------------------------------------------------
+// Declaration
+// ---------------------------------------------------------------------------
+
+RenderGraph::~RenderGraph() {
+    ReleaseResources();
+}
+
+RenderGraph::Resource RenderGraph::CreateTexture(const char* name, const TextureDesc& desc) {
+    return AddResource(name, desc, 0, false, false);
+}
+
+RenderGraph::Resource RenderGraph::ImportTexture(const char* name, u32 texture) {
+    return AddResource(name, TextureDesc(), texture, true, false);
+}
+
+RenderGraph::Resource RenderGraph::ImportTexture(const char* name, u32 texture, const TextureDesc& desc) {
+    return AddResource(name, desc, texture, true, false);
+}
+
+RenderGraph::Resource RenderGraph::ImportBuffer(const char* name, u32 buffer) {
+    return AddResource(name, TextureDesc(), buffer, true, true);
+}
+
+RenderGraph::Resource RenderGraph::AddResource(const char* name, const TextureDesc& desc, u32 handle,
+                                               bool imported, bool isBuffer) {
+    ResourceEntry entry;
+    entry.Name = name;
+    entry.Desc = desc;
+    entry.Handle = handle;
+    entry.Imported = imported;
+    entry.IsBuffer = isBuffer;
+    m_Resources.push_back(entry);
+
+    return AddVersion(static_cast<u32>(m_Resources.size() - 1), NoPass, InvalidResource);
+}
+
+RenderGraph::Resource RenderGraph::AddVersion(u32 resourceIndex, u32 producer, Resource previous) {
+    VersionEntry version;
+    version.ResourceIndex = resourceIndex;
+    version.Producer = producer;
+    version.Previous = previous;
+    m_Versions.push_back(std::move(version));
+
+    const Resource handle = static_cast<Resource>(m_Versions.size() - 1);
+    m_Resources[resourceIndex].LatestVersion = handle;
+    return handle;
+}
+
+RenderGraph::Resource RenderGraph::RecordWrite(u32 pass, Resource resource, Access access) {
+    if (resource >= m_Versions.size()) {
+        LOG_CORE_ERROR("RenderGraph: pass '{}' writes an invalid resource", m_Passes[pass].Name);
+        return InvalidResource;
+    }
+
+    // Two writers of one version would need a copy; not supported
+    const u32 resourceIndex = m_Versions[resource].ResourceIndex;
+    if (m_Resources[resourceIndex].LatestVersion != resource) {
+        LOG_CORE_ERROR("RenderGraph: pass '{}' writes an old version of '{}'",
+                       m_Passes[pass].Name, m_Resources[resourceIndex].Name);
+        return InvalidResource;
+    }
+
+    Resource version = AddVersion(resourceIndex, pass, resource);
+    m_Passes[pass].Accesses.push_back({version, access, true});
+    return version;
+}
+
+void RenderGraph::AddPass(const char* name, const SetupFunc& setup, ExecuteFunc execute) {
+    PassEntry pass;
+    pass.Name = name;
+    pass.Execute = std::move(execute);
+    m_Passes.push_back(std::move(pass));
+
+    Builder builder(*this, static_cast<u32>(m_Passes.size() - 1));
+    setup(builder);
+
+    m_Compiled = false;
+}
+
+// ---------------------------------------------------------------------------
+// Compilation
+// ---------------------------------------------------------------------------
+
+void RenderGraph::Compile() {
+    CullPasses();
+    SortPasses();
+    AllocateTransients();
+
+    m_Stats.Passes = static_cast<u32>(m_Passes.size());
+    m_Stats.CulledPasses = m_Stats.Passes - static_cast<u32>(m_Order.size());
+    m_Compiled = true;
+}
+
+void RenderGraph::CullPasses() {
+    Vector<u32> pending;
+    auto keep = [this, &pending](u32 pass) {
+        if (pass != NoPass && !m_Passes[pass].Alive) {
+            m_Passes[pass].Alive = true;
+            pending.push_back(pass);
+        }
+    };
+
+    for (u32 i = 0; i < m_Passes.size(); ++i) {
+        m_Passes[i].Alive = false;
+    }
+    for (u32 i = 0; i < m_Passes.size(); ++i) {
+        if (m_Passes[i].SideEffect) keep(i);
+    }
+    for (const auto& resource : m_Resources) {
+        if (resource.Imported) keep(m_Versions[resource.LatestVersion].Producer);
+    }
+
+    // A live pass needs the producers of what it reads, and of what it
+    // writes on top of
+    while (!pending.empty()) {
+        const u32 pass = pending.back();
+        pending.pop_back();
+
+        for (const auto& access : m_Passes[pass].Accesses) {
+            const VersionEntry& version = m_Versions[access.Version];
+            if (access.IsWrite) {
+                if (version.Previous != InvalidResource) keep(m_Versions[version.Previous].Producer);
+            } else {
+                keep(version.Producer);
+            }
+        }
+    }
+}
+
+void RenderGraph::SortPasses() {
+    // A version can only be read once its writer has been declared, and only
+    // the latest version can be written, so declaration order already puts
+    // every producer before its readers and every reader before the next
+    // writer
+    m_Order.clear();
+    for (u32 pass = 0; pass < m_Passes.size(); ++pass) {
+        if (m_Passes[pass].Alive) m_Order.push_back(pass);
+    }
+}
+
+void RenderGraph::AllocateTransients() {
+    for (u32 position = 0; position < m_Order.size(); ++position) {
+        for (const auto& access : m_Passes[m_Order[position]].Accesses) {
+            ResourceEntry& resource = m_Resources[m_Versions[access.Version].ResourceIndex];
+            resource.FirstUse = std::min(resource.FirstUse, position);
+            resource.LastUse = std::max(resource.LastUse, position);
+        }
+    }
+
+    Vector<u32> transients;
+    for (u32 i = 0; i < m_Resources.size(); ++i) {
+        if (!m_Resources[i].Imported && m_Resources[i].FirstUse != NoPass) transients.push_back(i);
+    }
+    std::sort(transients.begin(), transients.end(), [this](u32 a, u32 b) {
+        return m_Resources[a].FirstUse < m_Resources[b].FirstUse;
+    });
+
+    for (u32 index : transients) {
+        ResourceEntry& resource = m_Resources[index];
+
+        // Alias a pooled texture whose last user this frame has finished
+        PooledTexture* match = nullptr;
+        for (auto& pooled : m_Pool) {
+            if (pooled.Desc == resource.Desc && (!pooled.UsedThisFrame || pooled.BusyUntil < resource.FirstUse)) {
+                match = &pooled;
+                break;
+            }
+        }
+
+        if (!match) {
+            PooledTexture pooled;
+            pooled.Desc = resource.Desc;
+
+            const FramebufferTextureFormat format = resource.Desc.Format;
+            const GLenum filter = format == FramebufferTextureFormat::R32UI ? GL_NEAREST : GL_LINEAR;
+            glCreateTextures(GL_TEXTURE_2D, 1, &pooled.Texture);
+            GLMemory::TextureStorage2D(pooled.Texture, 1, FramebufferTextureFormatToGLFormat(format),
+                                       static_cast<i32>(resource.Desc.Width), static_cast<i32>(resource.Desc.Height),
+                                       MemoryTag::Renderer);
+            glTextureParameteri(pooled.Texture, GL_TEXTURE_MIN_FILTER, filter);
+            glTextureParameteri(pooled.Texture, GL_TEXTURE_MAG_FILTER, filter);
+            glTextureParameteri(pooled.Texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTextureParameteri(pooled.Texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+            m_Pool.push_back(pooled);
+            match = &m_Pool.back();
+        }
+
+        match->UsedThisFrame = true;
+        match->BusyUntil = resource.LastUse;
+        resource.Handle = match->Texture;
+    }
+
+    m_Stats.TransientTextures = static_cast<u32>(transients.size());
+}
+
+// ---------------------------------------------------------------------------
+// Execution
+// ---------------------------------------------------------------------------
+
+void RenderGraph::Execute() {
+    if (!m_Compiled) {
+        Compile();
+    }
+
+    std::fill(std::begin(m_LastBarrier), std::end(m_LastBarrier), 0u);
+    m_Stats.Barriers = 0;
+
+    const Context context(*this);
+    for (u32 position = 0; position < m_Order.size(); ++position) {
+        const PassEntry& pass = m_Passes[m_Order[position]];
+
+        m_Stats.Barriers += IssueBarriers(position, pass);
+
+        if (!pass.Attachments.empty()) {
+            BindAttachments(pass);
+        }
+
+        {
+            GPUProfileScope scope(pass.Name);
+            if (pass.Execute) pass.Execute(context);
+        }
+
+        if (!pass.Attachments.empty()) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+
+        for (const auto& access : pass.Accesses) {
+            if (access.IsWrite && IsIncoherentWrite(access.Type)) {
+                m_Resources[m_Versions[access.Version].ResourceIndex].LastIncoherentWrite = position + 1;
+            }
+        }
+    }
+
+    RecyclePool();
+
+    m_Resources.clear();
+    m_Versions.clear();
+    m_Passes.clear();
+    m_Order.clear();
+    m_Compiled = false;
+}
+
+u32 RenderGraph::IssueBarriers(u32 position, const PassEntry& pass) {
+    GLbitfield bits = 0;
+    for (const auto& access : pass.Accesses) {
+        // A write's version is new; what it is ordered against is the resource
+        const ResourceEntry& resource = GetResource(access.Version);
+        const u32 type = static_cast<u32>(access.Type);
+        if (resource.LastIncoherentWrite > m_LastBarrier[type]) {
+            bits |= BarrierBit(access.Type);
+            m_LastBarrier[type] = position;
+        }
+    }
+
+    if (bits == 0) return 0;
+
+    glMemoryBarrier(bits);
+    return 1;
+}
+
+void RenderGraph::BindAttachments(const PassEntry& pass) {
+    constexpr u32 MaxColorAttachments = 8;
+
+    Vector<u32> textures(MaxColorAttachments + 1, 0);
+    const TextureDesc* size = nullptr;
+    FramebufferTextureFormat depthFormat = FramebufferTextureFormat::None;
+    for (const auto& attachment : pass.Attachments) {
+        const ResourceEntry& resource = GetResource(attachment.Version);
+        if (attachment.Depth) {
+            textures[MaxColorAttachments] = resource.Handle;
+            depthFormat = resource.Desc.Format;
+        } else if (attachment.Index < MaxColorAttachments) {
+            textures[attachment.Index] = resource.Handle;
+        }
+        if (!size && resource.Desc.Width > 0) size = &resource.Desc;
+    }
+
+    auto cached = std::find_if(m_Framebuffers.begin(), m_Framebuffers.end(),
+                               [&textures](const CachedFramebuffer& fb) { return fb.Textures == textures; });
+    if (cached == m_Framebuffers.end()) {
+        CachedFramebuffer fb;
+        fb.Textures = textures;
+        glCreateFramebuffers(1, &fb.Framebuffer);
+
+        GLenum drawBuffers[MaxColorAttachments];
+        GLsizei drawBufferCount = 0;
+        for (u32 i = 0; i < MaxColorAttachments; ++i) {
+            drawBuffers[i] = textures[i] ? GL_COLOR_ATTACHMENT0 + i : GL_NONE;
+            if (textures[i]) {
+                glNamedFramebufferTexture(fb.Framebuffer, GL_COLOR_ATTACHMENT0 + i, textures[i], 0);
+                drawBufferCount = static_cast<GLsizei>(i + 1);
+            }
+        }
+        glNamedFramebufferDrawBuffers(fb.Framebuffer, drawBufferCount, drawBuffers);
+
+        if (textures[MaxColorAttachments]) {
+            const GLenum point = depthFormat == FramebufferTextureFormat::Depth24Stencil8
+                ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+            glNamedFramebufferTexture(fb.Framebuffer, point, textures[MaxColorAttachments], 0);
+        }
+
+        if (glCheckNamedFramebufferStatus(fb.Framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            LOG_CORE_ERROR("RenderGraph: framebuffer for pass '{}' is not complete", pass.Name);
+        }
+
+        m_Framebuffers.push_back(std::move(fb));
+        cached = m_Framebuffers.end() - 1;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, cached->Framebuffer);
+    if (size) {
+        glViewport(0, 0, static_cast<GLsizei>(size->Width), static_cast<GLsizei>(size->Height));
+    }
+}
+
+void RenderGraph::RecyclePool() {
+    u32 kept = 0;
+    for (u32 i = 0; i < m_Pool.size(); ++i) {
+        PooledTexture& pooled = m_Pool[i];
+        pooled.FramesUnused = pooled.UsedThisFrame ? 0 : pooled.FramesUnused + 1;
+        pooled.UsedThisFrame = false;
+
+        if (pooled.FramesUnused > MaxUnusedFrames) {
+            // Framebuffers holding it go too
+            const u32 texture = pooled.Texture;
+            std::erase_if(m_Framebuffers, [texture](const CachedFramebuffer& fb) {
+                if (std::find(fb.Textures.begin(), fb.Textures.end(), texture) == fb.Textures.end()) return false;
+                glDeleteFramebuffers(1, &fb.Framebuffer);
+                return true;
+            });
+            GLMemory::DeleteTextures(1, &texture);
+            continue;
+        }
+        m_Pool[kept++] = pooled;
+    }
+    m_Pool.resize(kept);
+    m_Stats.PooledTextures = kept;
+}
+
+void RenderGraph::ReleaseResources() {
+    for (const auto& fb : m_Framebuffers) {
+        glDeleteFramebuffers(1, &fb.Framebuffer);
+    }
+    m_Framebuffers.clear();
+
+    for (const auto& pooled : m_Pool) {
+        GLMemory::DeleteTextures(1, &pooled.Texture);
+    }
+    m_Pool.clear();
+    m_Stats.PooledTextures = 0;
+}
+
+bool RenderGraph::IsPassCulled(const char* name) const {
+    for (const auto& pass : m_Passes) {
+        if (std::strcmp(pass.Name, name) == 0) return !pass.Alive;
+    }
+    return false;
+}
+
+} // namespace Engine
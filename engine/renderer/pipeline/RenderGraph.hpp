@@ -0,0 +1,235 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/pipeline/Framebuffer.hpp"
+
+namespace Engine {
+
+// RenderGraph - a frame's passes, declared with what they read and write.
+//
+// Each pass gets a setup callback, run immediately against a Builder, and
+// an execute callback run later by Execute(). Writing a resource creates a
+// new version of it, and readers name the version they consume. That is
+// enough to compile the frame:
+//
+//  - Ordering: a version can only be read after its writer is declared,
+//    and only the latest version can be written, so declaration order is a
+//    topological order of the dependencies: producers before readers,
+//    readers before the next writer. Surviving passes run in it.
+//  - Culling: only imported resources (the swapchain, persistent targets,
+//    particle buffers) and passes marked SideEffect are outputs. A pass
+//    whose writes never reach an output is dropped, e.g. a debug view
+//    nobody presents.
+//  - Transients: CreateTexture textures get storage only while a surviving
+//    pass uses them. GL has no placement into shared memory, so aliasing
+//    works through a persistent pool: a texture with the same size and
+//    format is handed to the next transient whose lifetime starts after
+//    the last use of the previous one. Contents do not survive, so the
+//    first writer clears.
+//  - Barriers: image stores and SSBO writes are incoherent. Before each
+//    pass, the graph issues one glMemoryBarrier with the bits for that
+//    pass's accesses to resources written that way since the last
+//    matching barrier, and no more.
+//
+// Passes that declare WriteColor / WriteDepth run with a framebuffer of
+// those attachments bound (cached) and the viewport set to their size.
+// Other passes bind what they need. Pass and resource names must outlive
+// the frame (string literals); they are also the GPU profiler zones.
+//
+// Build, Execute, repeat every frame. GL thread only.
+class RenderGraph {
+public:
+    using Resource = u32;       // One version of a texture or buffer
+    static constexpr Resource InvalidResource = ~0u;
+
+    enum class Access : u8 {
+        ColorAttachment,
+        DepthAttachment,
+        Sampled,
+        StorageImage,           // imageLoad / imageStore
+        StorageBuffer,
+        UniformBuffer,
+        IndirectCommand,
+        VertexBuffer,
+        Copy,                   // Blits, buffer copies, readbacks
+        Count
+    };
+
+    struct TextureDesc {
+        u32 Width = 0;
+        u32 Height = 0;
+        FramebufferTextureFormat Format = FramebufferTextureFormat::RGBA16F;
+
+        bool operator==(const TextureDesc&) const = default;
+    };
+
+    class Builder {
+    public:
+        void Read(Resource resource, Access access);
+
+        // Writes on top of the given version, which must be the latest, and
+        // returns the new one. The old contents are kept, so the previous
+        // writer stays alive.
+        Resource Write(Resource resource, Access access);
+
+        // Writes bound as attachments of the pass's framebuffer
+        Resource WriteColor(Resource texture, u32 index = 0);
+        Resource WriteDepth(Resource texture);
+
+        // Never culled (presents, readbacks, anything with effects outside the graph)
+        void SideEffect();
+
+    private:
+        friend class RenderGraph;
+        Builder(RenderGraph& graph, u32 pass) : m_Graph(graph), m_Pass(pass) {}
+
+        RenderGraph& m_Graph;
+        u32 m_Pass;
+    };
+
+    class Context {
+    public:
+        u32 GetTexture(Resource resource) const;
+        u32 GetBuffer(Resource resource) const;
+        const TextureDesc& GetTextureDesc(Resource resource) const;
+
+    private:
+        friend class RenderGraph;
+        explicit Context(const RenderGraph& graph) : m_Graph(graph) {}
+
+        const RenderGraph& m_Graph;
+    };
+
+    using SetupFunc = std::function<void(Builder&)>;
+    using ExecuteFunc = std::function<void(const Context&)>;
+
+    struct Stats {
+        u32 Passes = 0;             // Declared
+        u32 CulledPasses = 0;
+        u32 TransientTextures = 0;  // Transients used this frame
+        u32 PooledTextures = 0;     // GL textures backing them
+        u32 Barriers = 0;           // glMemoryBarrier calls
+    };
+
+    RenderGraph() = default;
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    Resource CreateTexture(const char* name, const TextureDesc& desc);
+
+    // Persistent resources owned elsewhere; their final versions are outputs.
+    // The desc is only needed to use the texture as a graph attachment.
+    Resource ImportTexture(const char* name, u32 texture);
+    Resource ImportTexture(const char* name, u32 texture, const TextureDesc& desc);
+    Resource ImportBuffer(const char* name, u32 buffer);
+
+    void AddPass(const char* name, const SetupFunc& setup, ExecuteFunc execute);
+
+    // Order, cull and allocate; Execute() compiles if this wasn't called
+    void Compile();
+
+    // Run the surviving passes, then clear the frame for the next build
+    void Execute();
+
+    // Frees the transient pool and cached framebuffers
+    void ReleaseResources();
+
+    // Valid between Compile() and Execute()
+    bool IsPassCulled(const char* name) const;
+
+    const Stats& GetStats() const { return m_Stats; }
+
+    // Unused pooled textures are freed after this many frames
+    static constexpr u32 MaxUnusedFrames = 16;
+
+private:
+    static constexpr u32 NoPass = ~0u;
+
+    struct ResourceEntry {
+        const char* Name = "";
+        TextureDesc Desc;
+        u32 Handle = 0;             // GL texture or buffer
+        bool Imported = false;
+        bool IsBuffer = false;
+        Resource LatestVersion = InvalidResource;
+        u32 FirstUse = NoPass;      // Positions in m_Order
+        u32 LastUse = 0;
+        u32 LastIncoherentWrite = 0;    // Execution position + 1, 0 for none
+    };
+
+    struct VersionEntry {
+        u32 ResourceIndex = 0;
+        u32 Producer = NoPass;
+        Resource Previous = InvalidResource;
+        Vector<u32> Readers;
+    };
+
+    struct AccessEntry {
+        Resource Version = InvalidResource;
+        Access Type = Access::Sampled;
+        bool IsWrite = false;
+    };
+
+    struct AttachmentEntry {
+        Resource Version = InvalidResource;
+        u32 Index = 0;
+        bool Depth = false;
+    };
+
+    struct PassEntry {
+        const char* Name = "";
+        ExecuteFunc Execute;
+        Vector<AccessEntry> Accesses;
+        Vector<AttachmentEntry> Attachments;
+        bool SideEffect = false;
+        bool Alive = false;
+    };
+
+    struct PooledTexture {
+        TextureDesc Desc;
+        u32 Texture = 0;
+        u32 BusyUntil = 0;          // Last position using it this frame
+        bool UsedThisFrame = false;
+        u32 FramesUnused = 0;
+    };
+
+    struct CachedFramebuffer {
+        Vector<u32> Textures;       // Color 0..7 then depth, 0 for none
+        u32 Framebuffer = 0;
+    };
+
+    Resource AddResource(const char* name, const TextureDesc& desc, u32 handle, bool imported, bool isBuffer);
+    Resource AddVersion(u32 resourceIndex, u32 producer, Resource previous);
+    Resource RecordWrite(u32 pass, Resource resource, Access access);
+
+    void CullPasses();
+    void SortPasses();
+    void AllocateTransients();
+    void RecyclePool();
+
+    u32 IssueBarriers(u32 position, const PassEntry& pass);
+    void BindAttachments(const PassEntry& pass);
+
+    const ResourceEntry& GetResource(Resource version) const {
+        return m_Resources[m_Versions[version].ResourceIndex];
+    }
+
+private:
+    Vector<ResourceEntry> m_Resources;
+    Vector<VersionEntry> m_Versions;
+    Vector<PassEntry> m_Passes;
+    Vector<u32> m_Order;
+    bool m_Compiled = false;
+
+    // Position the last barrier for each access was issued before
+    u32 m_LastBarrier[static_cast<u32>(Access::Count)] = {};
+
+    Vector<PooledTexture> m_Pool;
+    Vector<CachedFramebuffer> m_Framebuffers;
+
+    Stats m_Stats;
+};
+
+} // namespace Engine
@@ -0,0 +1,133 @@
+#include "renderer/pipeline/RenderTargetPool.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+
+namespace Engine {
+
+namespace {
+
+struct TargetKey {
+    u32 Format = 0;
+    u32 Width = 0;
+    u32 Height = 0;
+    u32 Samples = 1;
+
+    bool operator==(const TargetKey& other) const {
+        return Format == other.Format && Width == other.Width && Height == other.Height && Samples == other.Samples;
+    }
+};
+
+struct IdleTarget {
+    u32 Texture = 0;
+    TargetKey Key;
+    usize Bytes = 0;
+    u64 ReleasedFrame = 0;
+};
+
+Vector<IdleTarget> s_Idle;              // Release order, oldest first
+HashMap<u32, TargetKey> s_InUse;        // Texture -> how it was created
+usize s_IdleBytes = 0;
+u64 s_Frame = 0;
+u32 s_Reused = 0;
+u32 s_Created = 0;
+
+void DeleteIdle(usize first, usize count) {
+    for (usize i = first; i < first + count; ++i) {
+        s_IdleBytes -= s_Idle[i].Bytes;
+        GLMemory::DeleteTextures(1, &s_Idle[i].Texture);
+    }
+    s_Idle.erase(s_Idle.begin() + static_cast<std::ptrdiff_t>(first),
+                 s_Idle.begin() + static_cast<std::ptrdiff_t>(first + count));
+}
+
+} // anonymous namespace
+
+u32 RenderTargetPool::Acquire(u32 internalFormat, u32 width, u32 height, u32 samples) {
+    const TargetKey key{internalFormat, width, height, std::max(samples, 1u)};
+
+    // Most recently released first: its memory is the likeliest to be resident
+    for (usize i = s_Idle.size(); i-- > 0;) {
+        if (s_Idle[i].Key == key) {
+            const u32 texture = s_Idle[i].Texture;
+            s_IdleBytes -= s_Idle[i].Bytes;
+            s_Idle.erase(s_Idle.begin() + static_cast<std::ptrdiff_t>(i));
+            s_InUse[texture] = key;
+            s_Reused++;
+            return texture;
+        }
+    }
+
+    u32 texture = 0;
+    if (key.Samples > 1) {
+        glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &texture);
+        GLMemory::TextureStorage2DMultisample(texture, static_cast<i32>(key.Samples), internalFormat,
+                                              static_cast<i32>(width), static_cast<i32>(height), GL_TRUE,
+                                              MemoryTag::Renderer);
+    } else {
+        glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+        GLMemory::TextureStorage2D(texture, 1, internalFormat, static_cast<i32>(width), static_cast<i32>(height),
+                                   MemoryTag::Renderer);
+    }
+    s_InUse[texture] = key;
+    s_Created++;
+    return texture;
+}
+
+void RenderTargetPool::Release(u32 texture) {
+    if (!texture) return;
+
+    auto it = s_InUse.find(texture);
+    if (it == s_InUse.end()) {
+        GLMemory::DeleteTextures(1, &texture);
+        return;
+    }
+
+    IdleTarget idle;
+    idle.Texture = texture;
+    idle.Key = it->second;
+    idle.Bytes = GLMemory::GetLevelSize(idle.Key.Format, static_cast<i32>(idle.Key.Width),
+                                        static_cast<i32>(idle.Key.Height)) * idle.Key.Samples;
+    idle.ReleasedFrame = s_Frame;
+    s_InUse.erase(it);
+
+    s_Idle.push_back(idle);
+    s_IdleBytes += idle.Bytes;
+
+    usize evict = 0;
+    for (usize bytes = s_IdleBytes; bytes > MaxIdleBytes && evict < s_Idle.size(); ++evict) {
+        bytes -= s_Idle[evict].Bytes;
+    }
+    if (evict > 0) {
+        DeleteIdle(0, evict);
+    }
+}
+
+void RenderTargetPool::BeginFrame() {
+    s_Frame++;
+
+    usize expired = 0;
+    while (expired < s_Idle.size() && s_Frame - s_Idle[expired].ReleasedFrame > MaxIdleFrames) {
+        ++expired;
+    }
+    if (expired > 0) {
+        DeleteIdle(0, expired);
+    }
+}
+
+void RenderTargetPool::Clear() {
+    DeleteIdle(0, s_Idle.size());
+}
+
+RenderTargetPool::Stats RenderTargetPool::GetStats() {
+    Stats stats;
+    stats.Idle = static_cast<u32>(s_Idle.size());
+    stats.IdleBytes = s_IdleBytes;
+    stats.InUse = static_cast<u32>(s_InUse.size());
+    stats.Reused = s_Reused;
+    stats.Created = s_Created;
+    return stats;
+}
+
+} // namespace Engine
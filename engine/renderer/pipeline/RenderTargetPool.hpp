@@ -0,0 +1,49 @@
+#pragma once
+
+#include "core/Types.hpp"
+
+namespace Engine {
+
+// RenderTargetPool - recycles render target textures by format, size and
+// sample count.
+//
+// Framebuffers take their attachments from here and hand them back when they
+// are reallocated or destroyed. A released texture waits in the pool for up
+// to MaxIdleFrames frames (counted by BeginFrame()), so a target recreated at
+// a size in use recently - a view toggled off and on, the G-buffer layout
+// switched back, a window returning to its previous size - gets the old
+// storage back instead of a new allocation. Once the idle textures add up to
+// more than MaxIdleBytes the oldest are deleted.
+//
+// Textures come back with whatever contents and sampler state they had.
+//
+// GL thread only.
+class RenderTargetPool {
+public:
+    static constexpr u32 MaxIdleFrames = 120;
+    static constexpr usize MaxIdleBytes = 256ull << 20;
+
+    // A width x height texture of internalFormat; multisampled when samples
+    // is above 1
+    static u32 Acquire(u32 internalFormat, u32 width, u32 height, u32 samples = 1);
+
+    // Hand a texture from Acquire() back; others are deleted
+    static void Release(u32 texture);
+
+    // Age the idle textures and delete the expired ones
+    static void BeginFrame();
+
+    // Delete every idle texture
+    static void Clear();
+
+    struct Stats {
+        u32 Idle = 0;           // Textures waiting for reuse
+        usize IdleBytes = 0;
+        u32 InUse = 0;          // Acquired and not released
+        u32 Reused = 0;         // Acquire() calls served from the pool, total
+        u32 Created = 0;        // Acquire() calls that allocated, total
+    };
+    static Stats GetStats();
+};
+
+} // namespace Engine
@@ -0,0 +1,119 @@
+#include "renderer/pipeline/TemporalAA.hpp"
+#include "renderer/pipeline/GBuffer.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+namespace {
+
+// Radical inverse of index in base; index 0 is skipped by the caller since
+// it would be (0, 0) in both bases
+f32 Halton(u32 index, u32 base) {
+    f32 fraction = 1.0f;
+    f32 result = 0.0f;
+    while (index > 0) {
+        fraction /= static_cast<f32>(base);
+        result += fraction * static_cast<f32>(index % base);
+        index /= base;
+    }
+    return result;
+}
+
+} // anonymous namespace
+
+TemporalAA::TemporalAA() {
+    LoadShader();
+}
+
+void TemporalAA::LoadShader() {
+    m_ResolveShader = CreateRef<Shader>("assets/shaders/postprocess/taa_resolve.glsl");
+}
+
+void TemporalAA::Reload() {
+    LoadShader();
+}
+
+void TemporalAA::AllocateHistory(u32 width, u32 height) {
+    FramebufferSpecification spec;
+    spec.Width = width;
+    spec.Height = height;
+    spec.Attachments = {FramebufferTextureFormat::RGBA16F};
+
+    for (auto& history : m_History) {
+        if (history) {
+            history->Resize(width, height);
+        } else {
+            history = CreateScope<Framebuffer>(spec);
+        }
+    }
+    m_HasHistory = false;
+
+    LOG_CORE_INFO("TAA history: {}x{}", width, height);
+}
+
+glm::vec2 TemporalAA::NextJitter(u32 renderWidth, u32 renderHeight, u32 outputWidth, u32 outputHeight) {
+    renderWidth = std::max(renderWidth, 1u);
+    renderHeight = std::max(renderHeight, 1u);
+
+    // Upscaling by r per axis leaves each output pixel r^2 times fewer
+    // samples per frame, so the cycle grows to match
+    const f32 upscale = static_cast<f32>(outputWidth * outputHeight) / static_cast<f32>(renderWidth * renderHeight);
+    const u32 phases = std::clamp(MinJitterPhases * static_cast<u32>(std::ceil(std::max(upscale, 1.0f))),
+                                  MinJitterPhases, MaxJitterPhases);
+
+    m_JitterIndex = m_JitterIndex % phases + 1;
+    const glm::vec2 offset(Halton(m_JitterIndex, 2) - 0.5f, Halton(m_JitterIndex, 3) - 0.5f);
+
+    // The projection's z column is offset, so the image itself moves by
+    // minus the jitter: texel t shows what an unjittered render would have
+    // at t + m_JitterPixels
+    m_JitterPixels = offset;
+    return offset * 2.0f / glm::vec2(static_cast<f32>(renderWidth), static_cast<f32>(renderHeight));
+}
+
+const Framebuffer& TemporalAA::Resolve(const Framebuffer& color, const glm::vec2& uvScale, const GBuffer& geometry,
+                                       u32 outputWidth, u32 outputHeight) {
+    outputWidth = std::max(outputWidth, 1u);
+    outputHeight = std::max(outputHeight, 1u);
+    if (!m_History[0] || m_History[0]->GetWidth() != outputWidth || m_History[0]->GetHeight() != outputHeight) {
+        AllocateHistory(outputWidth, outputHeight);
+    }
+
+    const u32 previous = m_Current;
+    const u32 next = m_Current ^ 1u;
+    const glm::ivec2 renderSize(
+        std::max(static_cast<i32>(std::lround(uvScale.x * static_cast<f32>(color.GetWidth()))), 1),
+        std::max(static_cast<i32>(std::lround(uvScale.y * static_cast<f32>(color.GetHeight()))), 1));
+
+    m_ResolveShader->Bind();
+    m_ResolveShader->SetInt2("u_RenderSize", renderSize);
+    m_ResolveShader->SetInt2("u_OutputSize", glm::ivec2(static_cast<i32>(outputWidth), static_cast<i32>(outputHeight)));
+    m_ResolveShader->SetFloat2("u_JitterPixels", m_JitterPixels);
+    m_ResolveShader->SetInt("u_HistoryValid", m_HasHistory ? 1 : 0);
+    m_ResolveShader->SetFloat("u_BlendFactor", m_Settings.BlendFactor);
+    m_ResolveShader->SetFloat("u_MotionBlendFactor", m_Settings.MotionBlendFactor);
+    m_ResolveShader->SetFloat("u_MotionScale", std::max(m_Settings.MotionScale, 1.0f));
+    m_ResolveShader->SetFloat("u_VarianceClip", m_Settings.VarianceClip);
+
+    GLStateCache::Instance().BindTextureUnit(0, color.GetColorAttachmentRendererID(0));
+    GLStateCache::Instance().BindTextureUnit(1, geometry.GetVelocityTextureID());
+    GLStateCache::Instance().BindTextureUnit(2, geometry.GetDepthTextureID());
+    GLStateCache::Instance().BindTextureUnit(3, m_History[previous]->GetColorAttachmentRendererID(0));
+    glBindImageTexture(0, m_History[next]->GetColorAttachmentRendererID(0), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+    glDispatchCompute((outputWidth + GroupSize - 1) / GroupSize, (outputHeight + GroupSize - 1) / GroupSize, 1);
+
+    // Post-processing samples the result; the next Resolve reads it as history
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+    m_Current = next;
+    m_HasHistory = true;
+    return *m_History[next];
+}
+
+} // namespace Engine
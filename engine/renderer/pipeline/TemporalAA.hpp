@@ -0,0 +1,98 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/pipeline/Framebuffer.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+class GBuffer;
+
+// TemporalAA - temporal anti-aliasing and upscaling of the lighting buffer.
+//
+// The camera's projection is offset by a different sub-pixel amount every
+// frame (NextJitter(), a Halton (2, 3) sequence), so consecutive frames
+// sample each pixel at different positions. Resolve() runs
+// taa_resolve.glsl at output resolution:
+//   - the current frame is reconstructed at the output pixel from the 3x3
+//     input texels around it, weighted by the distance of their jittered
+//     sample positions;
+//   - the history is fetched where the pixel was last frame, following the
+//     G-Buffer velocity of the nearest surface in the neighbourhood, with a
+//     Catmull-Rom filter;
+//   - the history is clipped to the variance box of the neighbourhood in
+//     YCoCg, which rejects disocclusions and shading changes without
+//     per-object masks, and blended in with an exponential weight.
+// Blending runs on luminance-weighted colors so single bright samples don't
+// flicker.
+//
+// The input may be any rendered region of the lighting buffer, so at render
+// scale below 1 the history accumulates detail from several jittered low
+// resolution frames and Resolve() doubles as a temporal upscaler. More
+// jitter phases are used the larger the upscale, so every output pixel gets
+// covered.
+//
+// The history is two RGBA16F framebuffers at output size used in turn; the
+// one written last is the result, read by post-processing with a UV scale
+// of 1.
+class TemporalAA {
+public:
+    // Must match taa_resolve.glsl
+    static constexpr u32 GroupSize = 8;
+    static constexpr u32 MinJitterPhases = 8;
+    static constexpr u32 MaxJitterPhases = 32;
+
+    struct Settings {
+        f32 BlendFactor = 0.1f;         // Weight of the current frame at rest
+        f32 MotionBlendFactor = 0.3f;   // Weight when the pixel moves MotionScale pixels or more
+        f32 MotionScale = 16.0f;
+        f32 VarianceClip = 1.25f;       // Box half extent in standard deviations
+    };
+
+    TemporalAA();
+    ~TemporalAA() = default;
+
+    TemporalAA(const TemporalAA&) = delete;
+    TemporalAA& operator=(const TemporalAA&) = delete;
+
+    // Advance the sequence and return this frame's projection jitter in NDC
+    // units (Camera::SetProjectionJitter) for a render of renderWidth x
+    // renderHeight shown at outputWidth x outputHeight
+    glm::vec2 NextJitter(u32 renderWidth, u32 renderHeight, u32 outputWidth, u32 outputHeight);
+
+    // Accumulate the uvScale region of color's first attachment, rendered
+    // with the last NextJitter() offset, into an outputWidth x outputHeight
+    // image. geometry supplies the depth and velocity of the same frame.
+    const Framebuffer& Resolve(const Framebuffer& color, const glm::vec2& uvScale, const GBuffer& geometry,
+                               u32 outputWidth, u32 outputHeight);
+
+    // Last Resolve() result, null before the first
+    const Framebuffer* GetOutput() const { return m_HasHistory ? m_History[m_Current].get() : nullptr; }
+
+    // Drop the history, e.g. on a camera cut; the next Resolve() starts over
+    void Reset() { m_HasHistory = false; }
+
+    Settings& GetSettings() { return m_Settings; }
+    const Settings& GetSettings() const { return m_Settings; }
+
+    void Reload();
+
+private:
+    void LoadShader();
+    void AllocateHistory(u32 width, u32 height);
+
+private:
+    Ref<Shader> m_ResolveShader;
+
+    Scope<Framebuffer> m_History[2];
+    u32 m_Current = 0;          // Written by the last Resolve
+    bool m_HasHistory = false;
+
+    u32 m_JitterIndex = 0;
+    glm::vec2 m_JitterPixels{0.0f};   // Last NextJitter, in render texels
+
+    Settings m_Settings;
+};
+
+} // namespace Engine
@@ -0,0 +1,139 @@
+#include "renderer/pipeline/VolumetricFog.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+namespace {
+
+// Texels of the three RGBA16F volumes
+constexpr usize BytesPerTexel = 8;
+
+u32 CreateVolume(u32 width, u32 height, u32 depth) {
+    u32 texture = 0;
+    glCreateTextures(GL_TEXTURE_3D, 1, &texture);
+    GLMemory::TextureStorage3D(texture, 1, GL_RGBA16F, static_cast<i32>(width), static_cast<i32>(height),
+                               static_cast<i32>(depth), MemoryTag::Renderer);
+    glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    return texture;
+}
+
+} // anonymous namespace
+
+VolumetricFog::VolumetricFog() {
+    LoadShaders();
+}
+
+VolumetricFog::~VolumetricFog() {
+    Release();
+}
+
+void VolumetricFog::LoadShaders() {
+    // Four shadow taps per light are plenty once the froxels are blurred over time
+    m_InjectShader = CreateRef<Shader>("assets/shaders/deferred/volumetric_fog_inject.glsl", "",
+                                       ShaderDefines{{"PCF_SAMPLES", "4"}});
+    m_IntegrateShader = CreateRef<Shader>("assets/shaders/deferred/volumetric_fog_integrate.glsl");
+}
+
+void VolumetricFog::Reload() {
+    LoadShaders();
+}
+
+void VolumetricFog::Allocate(u32 width, u32 height, u32 depth) {
+    Release();
+
+    m_Width = width;
+    m_Height = height;
+    m_Depth = depth;
+    m_Scattering[0] = CreateVolume(width, height, depth);
+    m_Scattering[1] = CreateVolume(width, height, depth);
+    m_Integrated = CreateVolume(width, height, depth);
+    m_HistoryValid = false;
+}
+
+void VolumetricFog::Release() {
+    u32 textures[] = {m_Scattering[0], m_Scattering[1], m_Integrated};
+    if (m_Integrated) GLMemory::DeleteTextures(3, textures);
+    m_Scattering[0] = 0;
+    m_Scattering[1] = 0;
+    m_Integrated = 0;
+}
+
+usize VolumetricFog::GetMemorySize() const {
+    return m_Integrated ? 3 * static_cast<usize>(m_Width) * m_Height * m_Depth * BytesPerTexel : 0;
+}
+
+void VolumetricFog::Compute(const std::function<void(Shader&)>& bindLights) {
+    const u32 width = std::clamp(m_Settings.GridWidth, 8u, 512u);
+    const u32 height = std::clamp(m_Settings.GridHeight, 8u, 512u);
+    const u32 depth = std::clamp(m_Settings.GridDepth, 8u, 256u);
+    if (width != m_Width || height != m_Height || depth != m_Depth) {
+        Allocate(width, height, depth);
+    }
+
+    // Slices are spread over a different range, last frame's no longer line up
+    if (m_Settings.Range != m_Range) {
+        m_Range = m_Settings.Range;
+        m_HistoryValid = false;
+    }
+
+    auto& state = GLStateCache::Instance();
+    const u32 history = m_Current;
+    m_Current ^= 1;
+
+    // Golden ratio sequence: every frame samples another depth in each slice
+    const f32 jitter = static_cast<f32>(std::fmod(static_cast<f64>(m_FrameIndex) * 0.6180339887, 1.0));
+    const f32 blend = m_HistoryValid ? std::clamp(m_Settings.TemporalBlend, 0.01f, 1.0f) : 1.0f;
+
+    m_InjectShader->Bind();
+    bindLights(*m_InjectShader);
+    m_InjectShader->SetUInt3("u_GridSize", glm::uvec3(width, height, depth));
+    m_InjectShader->SetFloat("u_Range", m_Settings.Range);
+    m_InjectShader->SetFloat("u_Jitter", jitter);
+    m_InjectShader->SetFloat("u_TemporalBlend", blend);
+    m_InjectShader->SetFloat("u_Density", m_Settings.Density);
+    m_InjectShader->SetFloat3("u_Albedo", m_Settings.Albedo);
+    m_InjectShader->SetFloat("u_Anisotropy", std::clamp(m_Settings.Anisotropy, -0.95f, 0.95f));
+    m_InjectShader->SetFloat("u_BaseHeight", m_Settings.BaseHeight);
+    m_InjectShader->SetFloat("u_HeightFalloff", std::max(m_Settings.HeightFalloff, 0.0f));
+    m_InjectShader->SetFloat("u_AmbientIntensity", m_Settings.AmbientIntensity);
+
+    // History after the shadow maps, which take units 0..7
+    state.BindTextureUnit(8, m_Scattering[history]);
+    glBindImageTexture(0, m_Scattering[m_Current], 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+    const u32 inject = InjectGroupSize;
+    glDispatchCompute((width + inject - 1) / inject, (height + inject - 1) / inject, (depth + inject - 1) / inject);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+    // Front to back along every column
+    m_IntegrateShader->Bind();
+    m_IntegrateShader->SetUInt3("u_GridSize", glm::uvec3(width, height, depth));
+    m_IntegrateShader->SetFloat("u_Range", m_Settings.Range);
+    state.BindTextureUnit(0, m_Scattering[m_Current]);
+    glBindImageTexture(0, m_Integrated, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+
+    const u32 integrate = IntegrateGroupSize;
+    glDispatchCompute((width + integrate - 1) / integrate, (height + integrate - 1) / integrate, 1);
+
+    // The lighting pass samples it; the next injection samples this frame's scattering
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+    m_HistoryValid = true;
+    m_FrameIndex++;
+}
+
+void VolumetricFog::Bind(Shader& shader, u32 unit) const {
+    GLStateCache::Instance().BindTextureUnit(unit, m_Integrated);
+    shader.SetFloat("u_FogRange", m_Range);
+}
+
+} // namespace Engine
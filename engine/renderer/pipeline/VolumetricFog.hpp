@@ -0,0 +1,106 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include <glm/glm.hpp>
+#include <functional>
+
+namespace Engine {
+
+// VolumetricFog - participating media lit per froxel and integrated along
+// the view rays, so the lighting passes apply fog with one 3D fetch.
+//
+// The camera frustum up to Range is split into GridWidth x GridHeight
+// screen tiles and GridDepth exponential depth slices, the same layout as
+// ClusteredLightCuller's clusters at a finer resolution.
+// volumetric_fog_inject.glsl writes every froxel's scattered light and
+// extinction: height fog density, lit by the ambient term, the directional
+// lights (the first one through its cascaded shadows) and the point and
+// spot lights of the cluster the froxel falls into, with their shadows,
+// through a Henyey-Greenstein phase function. The sample position is
+// jittered along the slice every frame and blended with last frame's
+// result, reprojected through the previous view-projection, which hides
+// the slice banding a low depth resolution would otherwise show.
+// volumetric_fog_integrate.glsl then walks each froxel column front to back
+// and stores the light scattered towards the camera up to each slice and
+// the transmittance through it.
+//
+// Fog replaces stacks of alpha-blended particles for atmosphere: its cost
+// is fixed by the grid, not by the overdraw on screen.
+class VolumetricFog {
+public:
+    // Must match volumetric_fog_inject.glsl and volumetric_fog_integrate.glsl
+    static constexpr u32 InjectGroupSize = 4;
+    static constexpr u32 IntegrateGroupSize = 8;
+
+    struct Settings {
+        bool Enabled = false;
+        f32 Density = 0.02f;            // Extinction per world unit at BaseHeight
+        glm::vec3 Albedo{0.9f};         // Scattered share of the extinction, the rest is absorbed
+        f32 Anisotropy = 0.3f;          // Henyey-Greenstein g, positive scatters forward
+        f32 BaseHeight = 0.0f;
+        f32 HeightFalloff = 0.05f;      // Density decays by exp(-falloff * height above BaseHeight); 0 = uniform
+        f32 AmbientIntensity = 1.0f;
+        f32 Range = 100.0f;             // View depth covered; fog stays as it is at Range beyond
+        f32 TemporalBlend = 0.1f;       // Weight of this frame's samples, 1 disables reprojection
+        u32 GridWidth = 160;
+        u32 GridHeight = 90;
+        u32 GridDepth = 64;
+    };
+
+    VolumetricFog();
+    ~VolumetricFog();
+
+    VolumetricFog(const VolumetricFog&) = delete;
+    VolumetricFog& operator=(const VolumetricFog&) = delete;
+
+    // Inject and integrate for the camera in the camera uniform block, whose
+    // near plane starts the first slice. bindLights binds the light
+    // buffers, shadow maps and light clusters into the injection shader: the
+    // lighting pass's inputs, see common/lighting.glsl and
+    // common/light_clusters.glsl.
+    void Compute(const std::function<void(Shader&)>& bindLights);
+
+    // Bind the integrated volume at unit and set the lookup uniforms of
+    // common/volumetric_fog.glsl
+    void Bind(Shader& shader, u32 unit) const;
+
+    // Computed at least once; the texture is undefined before
+    bool IsValid() const { return m_Integrated != 0 && m_FrameIndex > 0; }
+
+    // Drop the history, e.g. after a camera cut
+    void ResetHistory() { m_HistoryValid = false; }
+
+    Settings& GetSettings() { return m_Settings; }
+    const Settings& GetSettings() const { return m_Settings; }
+
+    // GPU memory of the three volumes
+    usize GetMemorySize() const;
+
+    void Reload();
+
+private:
+    void Allocate(u32 width, u32 height, u32 depth);
+    void Release();
+    void LoadShaders();
+
+private:
+    Ref<Shader> m_InjectShader;
+    Ref<Shader> m_IntegrateShader;
+
+    // Scattering (rgb) and extinction (a), this frame's and last frame's
+    u32 m_Scattering[2] = {0, 0};
+    u32 m_Integrated = 0;           // In-scattered light (rgb) and transmittance (a)
+    u32 m_Current = 0;              // Index into m_Scattering written this frame
+    u32 m_Width = 0;
+    u32 m_Height = 0;
+    u32 m_Depth = 0;
+
+    f32 m_Range = 0.0f;             // Settings::Range the history was computed with
+    bool m_HistoryValid = false;
+    u64 m_FrameIndex = 0;
+
+    Settings m_Settings;
+};
+
+} // namespace Engine
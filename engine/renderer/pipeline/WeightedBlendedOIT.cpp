@@ -0,0 +1,100 @@
+#include "renderer/pipeline/WeightedBlendedOIT.hpp"
+#include "renderer/pipeline/Framebuffer.hpp"
+#include "renderer/pipeline/RenderTargetPool.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+
+namespace Engine {
+
+WeightedBlendedOIT::WeightedBlendedOIT() {
+    Reload();
+}
+
+WeightedBlendedOIT::~WeightedBlendedOIT() {
+    Release();
+    if (m_Framebuffer) glDeleteFramebuffers(1, &m_Framebuffer);
+}
+
+void WeightedBlendedOIT::Reload() {
+    m_CompositeShader = CreateRef<Shader>("assets/shaders/postprocess/oit_composite.glsl");
+}
+
+void WeightedBlendedOIT::Allocate(u32 width, u32 height) {
+    Release();
+    if (!m_Framebuffer) glCreateFramebuffers(1, &m_Framebuffer);
+
+    m_Width = width;
+    m_Height = height;
+    m_Accumulation = RenderTargetPool::Acquire(GL_RGBA16F, width, height);
+    m_Revealage = RenderTargetPool::Acquire(GL_R16F, width, height);
+    for (u32 texture : {m_Accumulation, m_Revealage}) {
+        glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    }
+
+    glNamedFramebufferTexture(m_Framebuffer, GL_COLOR_ATTACHMENT0, m_Accumulation, 0);
+    glNamedFramebufferTexture(m_Framebuffer, GL_COLOR_ATTACHMENT1, m_Revealage, 0);
+    const GLenum buffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glNamedFramebufferDrawBuffers(m_Framebuffer, 2, buffers);
+}
+
+void WeightedBlendedOIT::Release() {
+    RenderTargetPool::Release(m_Accumulation);
+    RenderTargetPool::Release(m_Revealage);
+    m_Accumulation = 0;
+    m_Revealage = 0;
+}
+
+void WeightedBlendedOIT::Begin(const Framebuffer& target) {
+    if (target.GetSpecification().Samples > 1) {
+        LOG_CORE_ERROR("WeightedBlendedOIT: multisampled targets are not supported");
+    }
+    if (target.GetWidth() != m_Width || target.GetHeight() != m_Height) {
+        Allocate(target.GetWidth(), target.GetHeight());
+    }
+
+    // The target may have been reallocated since the last frame
+    glNamedFramebufferTexture(m_Framebuffer, GL_DEPTH_ATTACHMENT, target.GetDepthAttachmentRendererID(), 0);
+
+    const GLfloat accumulation[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    const GLfloat revealage[4] = {1.0f, 0.0f, 0.0f, 0.0f};
+    glClearNamedFramebufferfv(m_Framebuffer, GL_COLOR, 0, accumulation);
+    glClearNamedFramebufferfv(m_Framebuffer, GL_COLOR, 1, revealage);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+    glViewport(0, 0, static_cast<GLsizei>(target.GetViewportWidth()), static_cast<GLsizei>(target.GetViewportHeight()));
+
+    auto& state = GLStateCache::Instance();
+    m_SavedState = state.GetSnapshot();
+    state.SetDepthTest(true);
+    state.SetDepthWrite(false);
+    state.SetBlend(true);
+    state.SetBlendFuncIndexed(0, GL_ONE, GL_ONE);
+    state.SetBlendFuncIndexed(1, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+}
+
+void WeightedBlendedOIT::End() {
+    GLStateCache::Instance().Restore(m_SavedState);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void WeightedBlendedOIT::Composite(Framebuffer& target) {
+    if (!m_Accumulation || !m_CompositeShader) return;
+
+    const u32 width = target.GetViewportWidth();
+    const u32 height = target.GetViewportHeight();
+
+    m_CompositeShader->Bind();
+    m_CompositeShader->SetInt2("u_Size", glm::ivec2(static_cast<i32>(width), static_cast<i32>(height)));
+    GLStateCache::Instance().BindTextureUnit(0, m_Accumulation);
+    GLStateCache::Instance().BindTextureUnit(1, m_Revealage);
+    glBindImageTexture(0, target.GetColorAttachmentRendererID(0), 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA16F);
+
+    glDispatchCompute((width + GroupSize - 1) / GroupSize, (height + GroupSize - 1) / GroupSize, 1);
+
+    // Later passes sample or render into the target
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+}
+
+} // namespace Engine
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+
+namespace Engine {
+
+class Framebuffer;
+
+// WeightedBlendedOIT - transparent surfaces drawn in any order, resolved
+// over the scene in one pass.
+//
+// Between Begin() and End(), fragment shaders that include
+// common/oit.glsl add their premultiplied color, scaled by a depth and
+// coverage weight, to an RGBA16F accumulation target and multiply an R16F
+// revealage target by (1 - alpha). Both blend commutatively, so neither the
+// CPU nor the GPU has to sort. Composite() then blends the weighted average
+// color over the target by the remaining revealage, with a compute pass over
+// its viewport.
+//
+// The targets are tested against the target's own depth attachment
+// (attached, not copied) and never write depth. The result is exact for one
+// layer per pixel and an approximation where layers of very different
+// colors overlap, fine for smoke, dust and glass.
+class WeightedBlendedOIT {
+public:
+    // Must match oit_composite.glsl
+    static constexpr u32 GroupSize = 8;
+
+    WeightedBlendedOIT();
+    ~WeightedBlendedOIT();
+
+    WeightedBlendedOIT(const WeightedBlendedOIT&) = delete;
+    WeightedBlendedOIT& operator=(const WeightedBlendedOIT&) = delete;
+
+    // Bind and clear the targets at target's size and viewport, with depth
+    // testing against its depth, depth writes off and the blending above
+    void Begin(const Framebuffer& target);
+
+    // Put the fixed-function state back as it was before Begin()
+    void End();
+
+    // Resolve into target's first color attachment, which must be RGBA16F
+    void Composite(Framebuffer& target);
+
+    void Reload();
+
+private:
+    void Allocate(u32 width, u32 height);
+    void Release();
+
+private:
+    u32 m_Framebuffer = 0;
+    u32 m_Accumulation = 0;
+    u32 m_Revealage = 0;
+    u32 m_Width = 0;
+    u32 m_Height = 0;
+
+    Ref<Shader> m_CompositeShader;
+    GLStateCache::Snapshot m_SavedState;
+};
+
+} // namespace Engine
@@ -0,0 +1,80 @@
+#include "renderer/rhi/CommandList.hpp"
+
+namespace Engine {
+
+void CommandList::Reset() {
+    m_Data.clear();
+    m_CommandCount = 0;
+}
+
+void CommandList::BindPipeline(const PipelineDesc& pipeline) {
+    Record(RHICommand::BindPipeline{pipeline});
+}
+
+void CommandList::BindVertexArray(VertexArray* vertexArray) {
+    Record(RHICommand::BindVertexArray{vertexArray});
+}
+
+void CommandList::BindBuffer(BufferBinding binding, u32 index, u32 buffer, usize offset, usize size) {
+    Record(RHICommand::BindBuffer{binding, index, buffer, offset, size});
+}
+
+void CommandList::BindTexture(u32 unit, u32 texture) {
+    Record(RHICommand::BindTexture{unit, texture});
+}
+
+void CommandList::BindImage(u32 unit, u32 texture, u32 level, ImageAccess access, TextureFormat format) {
+    Record(RHICommand::BindImage{unit, texture, level, access, format});
+}
+
+void CommandList::SetInt(UniformHandle uniform, i32 value) {
+    Record(RHICommand::SetInt{uniform, value});
+}
+
+void CommandList::SetInt2(UniformHandle uniform, const glm::ivec2& value) {
+    Record(RHICommand::SetInt2{uniform, value});
+}
+
+void CommandList::SetFloat(UniformHandle uniform, f32 value) {
+    Record(RHICommand::SetFloat{uniform, value});
+}
+
+void CommandList::SetFloat4(UniformHandle uniform, const glm::vec4& value) {
+    Record(RHICommand::SetFloat4{uniform, value});
+}
+
+void CommandList::SetMat4(UniformHandle uniform, const glm::mat4& value) {
+    Record(RHICommand::SetMat4{uniform, value});
+}
+
+void CommandList::Draw(u32 vertexCount, u32 instanceCount, u32 firstVertex, u32 firstInstance) {
+    if (vertexCount == 0 || instanceCount == 0) return;
+    Record(RHICommand::Draw{vertexCount, instanceCount, firstVertex, firstInstance});
+}
+
+void CommandList::DrawIndexed(u32 indexCount, u32 instanceCount, u32 firstIndex,
+                              i32 baseVertex, u32 firstInstance) {
+    if (indexCount == 0 || instanceCount == 0) return;
+    Record(RHICommand::DrawIndexed{indexCount, instanceCount, firstIndex, baseVertex, firstInstance});
+}
+
+void CommandList::DrawIndexedIndirect(u32 buffer, usize offset, u32 drawCount, u32 stride) {
+    if (drawCount == 0) return;
+    Record(RHICommand::DrawIndexedIndirect{buffer, offset, drawCount, stride});
+}
+
+void CommandList::Dispatch(u32 groupsX, u32 groupsY, u32 groupsZ) {
+    if (groupsX == 0 || groupsY == 0 || groupsZ == 0) return;
+    Record(RHICommand::Dispatch{groupsX, groupsY, groupsZ});
+}
+
+void CommandList::DispatchIndirect(u32 buffer, usize offset) {
+    Record(RHICommand::DispatchIndirect{buffer, offset});
+}
+
+void CommandList::Barrier(ResourceAccess before, ResourceAccess after) {
+    if (before == ResourceAccess::None || after == ResourceAccess::None) return;
+    Record(RHICommand::Barrier{before, after});
+}
+
+} // namespace Engine
@@ -0,0 +1,336 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/Texture.hpp"
+
+#include <glm/glm.hpp>
+#include <new>
+#include <type_traits>
+
+namespace Engine {
+
+class VertexArray;
+
+enum class PrimitiveTopology : u8 {
+    Triangles,
+    TriangleStrip,
+    Lines,
+    Points
+};
+
+enum class BufferBinding : u8 {
+    Uniform,
+    Storage
+};
+
+enum class ImageAccess : u8 {
+    Read,
+    Write,
+    ReadWrite
+};
+
+// How a resource is used on either side of a barrier. Flags combine.
+enum class ResourceAccess : u32 {
+    None         = 0,
+    VertexInput  = 1 << 0,
+    IndexInput   = 1 << 1,
+    Uniform      = 1 << 2,
+    Storage      = 1 << 3,     // Shader storage buffers, read or written
+    TextureFetch = 1 << 4,
+    ShaderImage  = 1 << 5,     // imageLoad / imageStore
+    Indirect     = 1 << 6,     // Draw / dispatch arguments
+    RenderTarget = 1 << 7,
+    Transfer     = 1 << 8,     // Buffer / texture uploads, copies and readbacks
+    All          = 0xFFFFFFFFu
+};
+
+constexpr ResourceAccess operator|(ResourceAccess a, ResourceAccess b) {
+    return static_cast<ResourceAccess>(static_cast<u32>(a) | static_cast<u32>(b));
+}
+
+constexpr bool HasAccess(ResourceAccess access, ResourceAccess flag) {
+    return (static_cast<u32>(access) & static_cast<u32>(flag)) != 0;
+}
+
+// A draw or compute pipeline: the program plus the fixed-function state it
+// draws with. Compute pipelines set Compute; binding one leaves the
+// fixed-function state as it was, and State and Topology are ignored.
+struct PipelineDesc {
+    Shader* Program = nullptr;
+    RenderState State;
+    PrimitiveTopology Topology = PrimitiveTopology::Triangles;
+    bool Compute = false;
+};
+
+// Commands as they are stored in a CommandList; backends receive them one
+// by one from CommandList::Visit. Object names (buffer, texture) are the
+// backend's renderer ids.
+namespace RHICommand {
+
+    enum class Type : u8 {
+        BindPipeline,
+        BindVertexArray,
+        BindBuffer,
+        BindTexture,
+        BindImage,
+        SetInt,
+        SetInt2,
+        SetFloat,
+        SetFloat4,
+        SetMat4,
+        Draw,
+        DrawIndexed,
+        DrawIndexedIndirect,
+        Dispatch,
+        DispatchIndirect,
+        Barrier
+    };
+
+    struct BindPipeline {
+        static constexpr Type Kind = Type::BindPipeline;
+        PipelineDesc Pipeline;
+    };
+
+    struct BindVertexArray {
+        static constexpr Type Kind = Type::BindVertexArray;
+        VertexArray* Array;
+    };
+
+    struct BindBuffer {
+        static constexpr Type Kind = Type::BindBuffer;
+        BufferBinding Binding;
+        u32 Index;
+        u32 Buffer;
+        usize Offset;
+        usize Size;     // 0 binds the whole buffer
+    };
+
+    struct BindTexture {
+        static constexpr Type Kind = Type::BindTexture;
+        u32 Unit;
+        u32 Texture;
+    };
+
+    // One level of a texture for imageLoad / imageStore; Format is an
+    // uncompressed R, RG or RGBA format matching the shader's declaration
+    struct BindImage {
+        static constexpr Type Kind = Type::BindImage;
+        u32 Unit;
+        u32 Texture;
+        u32 Level;
+        ImageAccess Access;
+        TextureFormat Format;
+    };
+
+    // Uniforms apply to the program of the last BindPipeline
+    struct SetInt {
+        static constexpr Type Kind = Type::SetInt;
+        UniformHandle Uniform;
+        i32 Value;
+    };
+
+    struct SetInt2 {
+        static constexpr Type Kind = Type::SetInt2;
+        UniformHandle Uniform;
+        glm::ivec2 Value;
+    };
+
+    struct SetFloat {
+        static constexpr Type Kind = Type::SetFloat;
+        UniformHandle Uniform;
+        f32 Value;
+    };
+
+    struct SetFloat4 {
+        static constexpr Type Kind = Type::SetFloat4;
+        UniformHandle Uniform;
+        glm::vec4 Value;
+    };
+
+    struct SetMat4 {
+        static constexpr Type Kind = Type::SetMat4;
+        UniformHandle Uniform;
+        glm::mat4 Value;
+    };
+
+    struct Draw {
+        static constexpr Type Kind = Type::Draw;
+        u32 VertexCount;
+        u32 InstanceCount;
+        u32 FirstVertex;
+        u32 FirstInstance;
+    };
+
+    // u32 indices, as everywhere in the renderer
+    struct DrawIndexed {
+        static constexpr Type Kind = Type::DrawIndexed;
+        u32 IndexCount;
+        u32 InstanceCount;
+        u32 FirstIndex;
+        i32 BaseVertex;
+        u32 FirstInstance;
+    };
+
+    struct DrawIndexedIndirect {
+        static constexpr Type Kind = Type::DrawIndexedIndirect;
+        u32 Buffer;
+        usize Offset;
+        u32 DrawCount;
+        u32 Stride;     // 0 for tightly packed commands
+    };
+
+    struct Dispatch {
+        static constexpr Type Kind = Type::Dispatch;
+        u32 GroupsX;
+        u32 GroupsY;
+        u32 GroupsZ;
+    };
+
+    struct DispatchIndirect {
+        static constexpr Type Kind = Type::DispatchIndirect;
+        u32 Buffer;
+        usize Offset;
+    };
+
+    // Work before the barrier that accessed resources as Before is visible
+    // to work after it accessing them as After
+    struct Barrier {
+        static constexpr Type Kind = Type::Barrier;
+        ResourceAccess Before;
+        ResourceAccess After;
+    };
+
+} // namespace RHICommand
+
+// CommandList - a recorded stream of GPU commands, independent of the
+// backend that runs them.
+//
+// Recording only writes into the list's own memory and makes no API calls,
+// so any thread can record one: a render job fills its own list on a
+// JobSystem worker, and the thread owning the device runs the finished
+// lists in order through IRenderDevice::Submit. Nothing synchronizes work
+// inside or across lists except Barrier(), recorded where a later command
+// reads what an earlier one wrote, so the same stream is correct on a
+// backend that doesn't track hazards itself.
+//
+// Commands are packed records in one growing block; Reset() keeps its
+// capacity, so a list reused every frame stops allocating. Objects are
+// referenced, not owned: the shaders, vertex arrays and buffers a list
+// names must outlive its submission, as must runtime-built uniform names.
+class CommandList {
+public:
+    CommandList() = default;
+
+    CommandList(CommandList&&) = default;
+    CommandList& operator=(CommandList&&) = default;
+    CommandList(const CommandList&) = delete;
+    CommandList& operator=(const CommandList&) = delete;
+
+    // Forget the commands, keep the memory
+    void Reset();
+
+    void BindPipeline(const PipelineDesc& pipeline);
+    void BindVertexArray(VertexArray* vertexArray);
+    void BindBuffer(BufferBinding binding, u32 index, u32 buffer, usize offset = 0, usize size = 0);
+    void BindTexture(u32 unit, u32 texture);
+    void BindImage(u32 unit, u32 texture, u32 level, ImageAccess access, TextureFormat format);
+
+    void SetInt(UniformHandle uniform, i32 value);
+    void SetInt2(UniformHandle uniform, const glm::ivec2& value);
+    void SetFloat(UniformHandle uniform, f32 value);
+    void SetFloat4(UniformHandle uniform, const glm::vec4& value);
+    void SetMat4(UniformHandle uniform, const glm::mat4& value);
+
+    void Draw(u32 vertexCount, u32 instanceCount = 1, u32 firstVertex = 0, u32 firstInstance = 0);
+    void DrawIndexed(u32 indexCount, u32 instanceCount = 1, u32 firstIndex = 0,
+                     i32 baseVertex = 0, u32 firstInstance = 0);
+    void DrawIndexedIndirect(u32 buffer, usize offset, u32 drawCount, u32 stride = 0);
+    void Dispatch(u32 groupsX, u32 groupsY = 1, u32 groupsZ = 1);
+    void DispatchIndirect(u32 buffer, usize offset = 0);
+    void Barrier(ResourceAccess before, ResourceAccess after);
+
+    bool IsEmpty() const { return m_CommandCount == 0; }
+    u32 GetCommandCount() const { return m_CommandCount; }
+    usize GetMemorySize() const { return m_Data.capacity(); }
+
+    // Calls visitor(const RHICommand::X&) for every command, in recording order
+    template<typename Visitor>
+    void Visit(Visitor&& visitor) const;
+
+private:
+    // Every record starts on this alignment; the block itself comes from
+    // operator new, which aligns at least as much
+    static constexpr usize RecordAlignment = 16;
+
+    struct Header {
+        RHICommand::Type Type;
+        u32 Size;       // Header included, a multiple of RecordAlignment
+    };
+
+    static constexpr usize AlignRecord(usize size) {
+        return (size + RecordAlignment - 1) & ~(RecordAlignment - 1);
+    }
+
+    // Header padded to the record alignment
+    static constexpr usize PayloadOffset = RecordAlignment;
+    static_assert(sizeof(Header) <= RecordAlignment);
+
+    template<typename T>
+    void Record(const T& command);
+
+    template<typename T>
+    static const T& Payload(const u8* record) {
+        return *std::launder(reinterpret_cast<const T*>(record + PayloadOffset));
+    }
+
+private:
+    Vector<u8> m_Data;
+    u32 m_CommandCount = 0;
+};
+
+template<typename T>
+void CommandList::Record(const T& command) {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>);
+    static_assert(alignof(T) <= RecordAlignment);
+
+    const usize offset = m_Data.size();
+    const usize size = PayloadOffset + AlignRecord(sizeof(T));
+    m_Data.resize(offset + size);
+
+    new (m_Data.data() + offset) Header{T::Kind, static_cast<u32>(size)};
+    new (m_Data.data() + offset + PayloadOffset) T(command);
+    ++m_CommandCount;
+}
+
+template<typename Visitor>
+void CommandList::Visit(Visitor&& visitor) const {
+    // Qualified throughout: the member functions share the command names
+    const u8* record = m_Data.data();
+    const u8* end = record + m_Data.size();
+    while (record < end) {
+        const Header& header = *std::launder(reinterpret_cast<const Header*>(record));
+        switch (header.Type) {
+            case RHICommand::Type::BindPipeline:        visitor(Payload<RHICommand::BindPipeline>(record)); break;
+            case RHICommand::Type::BindVertexArray:     visitor(Payload<RHICommand::BindVertexArray>(record)); break;
+            case RHICommand::Type::BindBuffer:          visitor(Payload<RHICommand::BindBuffer>(record)); break;
+            case RHICommand::Type::BindTexture:         visitor(Payload<RHICommand::BindTexture>(record)); break;
+            case RHICommand::Type::BindImage:           visitor(Payload<RHICommand::BindImage>(record)); break;
+            case RHICommand::Type::SetInt:              visitor(Payload<RHICommand::SetInt>(record)); break;
+            case RHICommand::Type::SetInt2:             visitor(Payload<RHICommand::SetInt2>(record)); break;
+            case RHICommand::Type::SetFloat:            visitor(Payload<RHICommand::SetFloat>(record)); break;
+            case RHICommand::Type::SetFloat4:           visitor(Payload<RHICommand::SetFloat4>(record)); break;
+            case RHICommand::Type::SetMat4:             visitor(Payload<RHICommand::SetMat4>(record)); break;
+            case RHICommand::Type::Draw:                visitor(Payload<RHICommand::Draw>(record)); break;
+            case RHICommand::Type::DrawIndexed:         visitor(Payload<RHICommand::DrawIndexed>(record)); break;
+            case RHICommand::Type::DrawIndexedIndirect: visitor(Payload<RHICommand::DrawIndexedIndirect>(record)); break;
+            case RHICommand::Type::Dispatch:            visitor(Payload<RHICommand::Dispatch>(record)); break;
+            case RHICommand::Type::DispatchIndirect:    visitor(Payload<RHICommand::DispatchIndirect>(record)); break;
+            case RHICommand::Type::Barrier:             visitor(Payload<RHICommand::Barrier>(record)); break;
+        }
+        record += header.Size;
+    }
+}
+
+} // namespace Engine
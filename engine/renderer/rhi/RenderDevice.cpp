@@ -0,0 +1,13 @@
+#include "renderer/rhi/RenderDevice.hpp"
+#include "renderer/opengl/GLRenderDevice.hpp"
+
+namespace Engine {
+
+Scope<IRenderDevice> IRenderDevice::Create(RenderBackend backend) {
+    switch (backend) {
+        case RenderBackend::OpenGL: return CreateScope<GLRenderDevice>();
+    }
+    return nullptr;
+}
+
+} // namespace Engine
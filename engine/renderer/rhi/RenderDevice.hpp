@@ -0,0 +1,48 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/rhi/CommandList.hpp"
+
+namespace Engine {
+
+enum class RenderBackend : u8 {
+    OpenGL
+};
+
+// IRenderDevice - runs recorded CommandLists on a graphics backend.
+//
+// The device belongs to the thread that owns the backend's context (the
+// render thread when rendering is threaded); Submit() runs there. Lists
+// are recorded anywhere beforehand, typically one per render job, and
+// submitted together in the order their output must land in. Submission
+// order and the lists' own barriers are the only synchronization: a list
+// reading what an earlier one wrote records the Barrier() for it.
+class IRenderDevice {
+public:
+    struct Stats {
+        u32 Lists = 0;
+        u32 Commands = 0;
+        u32 DrawCalls = 0;
+        u32 Dispatches = 0;
+        u32 Barriers = 0;
+    };
+
+    virtual ~IRenderDevice() = default;
+
+    static Scope<IRenderDevice> Create(RenderBackend backend = RenderBackend::OpenGL);
+
+    virtual RenderBackend GetBackend() const = 0;
+
+    // Run the lists in order; the lists can be reset or re-recorded after
+    virtual void Submit(const Vector<CommandList>& lists) = 0;
+    virtual void Submit(const CommandList& list) = 0;
+
+    // Counts since the last ResetStats()
+    const Stats& GetStats() const { return m_Stats; }
+    void ResetStats() { m_Stats = {}; }
+
+protected:
+    Stats m_Stats;
+};
+
+} // namespace Engine
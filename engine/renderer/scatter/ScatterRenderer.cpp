@@ -0,0 +1,362 @@
+#include "renderer/scatter/ScatterRenderer.hpp"
+#include "renderer/pipeline/IndirectDrawBatcher.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
+#include "renderer/Material.hpp"
+#include "renderer/Mesh.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 MaxGroupsPerDimension = 65535;
+
+u32 NextCapacity(u32 required) {
+    u32 capacity = 1024;
+    while (capacity < required) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+// Groups past 65535 wrap into y, as the shader expects
+void DispatchWrapped(u32 groups) {
+    const u32 groupsX = std::min(groups, MaxGroupsPerDimension);
+    const u32 groupsY = (groups + groupsX - 1) / groupsX;
+    glDispatchCompute(groupsX, groupsY, 1);
+}
+
+// v turned about +Y, as scatter_cull.glsl builds the instance rotation
+glm::vec3 RotateYaw(const glm::vec3& v, f32 yaw) {
+    const f32 c = std::cos(yaw);
+    const f32 s = std::sin(yaw);
+    return {c * v.x + s * v.z, v.y, -s * v.x + c * v.z};
+}
+
+} // anonymous namespace
+
+ScatterRenderer::ScatterRenderer() {
+    LoadShaders();
+}
+
+ScatterRenderer::~ScatterRenderer() {
+    ReleaseSceneBuffers();
+    if (m_OutputBuffer) GLMemory::DeleteBuffers(1, &m_OutputBuffer);
+    if (m_PreviousBuffer) GLMemory::DeleteBuffers(1, &m_PreviousBuffer);
+    if (m_InstanceIndexBuffer) GLMemory::DeleteBuffers(1, &m_InstanceIndexBuffer);
+}
+
+void ScatterRenderer::LoadShaders() {
+    // One file, one entry point per stage
+    const String path = "assets/shaders/deferred/scatter_cull.glsl";
+    m_CellShader = CreateRef<Shader>(path, "", ShaderDefines{{"CULL_CELLS", ""}});
+    m_CommandShader = CreateRef<Shader>(path, "", ShaderDefines{{"BUILD_COMMANDS", ""}});
+    m_InstanceShader = CreateRef<Shader>(path, "", ShaderDefines{{"CULL_INSTANCES", ""}});
+}
+
+void ScatterRenderer::Reload() {
+    LoadShaders();
+}
+
+u32 ScatterRenderer::AddLayer(const ScatterLayerDesc& desc) {
+    Layer layer;
+    layer.Desc = desc;
+    layer.Desc.CellSize = std::max(desc.CellSize, 0.01f);
+    m_Layers.push_back(std::move(layer));
+    m_Dirty = true;
+    return static_cast<u32>(m_Layers.size() - 1);
+}
+
+void ScatterRenderer::AddInstances(u32 layer, const ScatterInstance* instances, usize count) {
+    if (layer >= m_Layers.size() || count == 0) return;
+
+    auto& target = m_Layers[layer].Instances;
+    target.insert(target.end(), instances, instances + count);
+    m_Dirty = true;
+}
+
+void ScatterRenderer::ClearLayer(u32 layer) {
+    if (layer >= m_Layers.size()) return;
+
+    m_Layers[layer].Instances.clear();
+    m_Layers[layer].Instances.shrink_to_fit();
+    m_Dirty = true;
+}
+
+void ScatterRenderer::Clear() {
+    m_Layers.clear();
+    m_Dirty = true;
+}
+
+void ScatterRenderer::SetMaxVisibleInstances(u32 count) {
+    m_MaxVisibleInstances = std::max(count, 1u);
+    m_Dirty = true;
+}
+
+void ScatterRenderer::ReleaseSceneBuffers() {
+    u32* buffers[] = {&m_InstanceBuffer, &m_CellBuffer, &m_LayerBuffer, &m_LODBuffer,
+                      &m_CellStateBuffer, &m_CounterBuffer, &m_CommandBuffer};
+    for (u32* buffer : buffers) {
+        if (*buffer) {
+            GLMemory::DeleteBuffers(1, buffer);
+            *buffer = 0;
+        }
+    }
+    m_CellCount = 0;
+    m_CommandCount = 0;
+    m_InstanceCount = 0;
+    m_Groups.clear();
+}
+
+void ScatterRenderer::BuildCells(u32 layerIndex, Vector<GPUScatterInstance>& instances,
+                                 Vector<GPUCell>& cells) const {
+    const Layer& layer = m_Layers[layerIndex];
+    const BoundingSphere& sphere = layer.Desc.Mesh->GetBoundingSphere();
+    const f32 inverseCell = 1.0f / layer.Desc.CellSize;
+
+    // Sort by grid cell so each cell is one contiguous range
+    struct Keyed {
+        u64 Key;
+        u32 Index;
+    };
+    Vector<Keyed> keyed(layer.Instances.size());
+    for (u32 i = 0; i < keyed.size(); ++i) {
+        const glm::vec3& position = layer.Instances[i].Position;
+        const auto x = static_cast<u32>(static_cast<i32>(std::floor(position.x * inverseCell)));
+        const auto z = static_cast<u32>(static_cast<i32>(std::floor(position.z * inverseCell)));
+        keyed[i] = {(static_cast<u64>(x) << 32) | z, i};
+    }
+    std::sort(keyed.begin(), keyed.end(), [](const Keyed& a, const Keyed& b) {
+        return a.Key != b.Key ? a.Key < b.Key : a.Index < b.Index;
+    });
+
+    for (usize first = 0; first < keyed.size();) {
+        usize last = first;
+        while (last < keyed.size() && keyed[last].Key == keyed[first].Key &&
+               last - first < MaxCellInstances) {
+            ++last;
+        }
+
+        GPUCell cell{};
+        cell.FirstInstance = static_cast<u32>(instances.size());
+        cell.InstanceCount = static_cast<u32>(last - first);
+        cell.Layer = layerIndex;
+        cell.Min = glm::vec3(std::numeric_limits<f32>::max());
+        cell.Max = glm::vec3(std::numeric_limits<f32>::lowest());
+
+        for (usize i = first; i < last; ++i) {
+            const ScatterInstance& source = layer.Instances[keyed[i].Index];
+            const f32 scale = std::max(source.Scale, 0.0f);
+
+            // The mesh's sphere where the shader will put it
+            const glm::vec3 center = source.Position + scale * RotateYaw(sphere.Center, source.Yaw);
+            const glm::vec3 extents(sphere.Radius * scale);
+            cell.Min = glm::min(cell.Min, center - extents);
+            cell.Max = glm::max(cell.Max, center + extents);
+            cell.MaxScale = std::max(cell.MaxScale, scale);
+
+            GPUScatterInstance packed;
+            packed.Position = source.Position;
+            packed.YawScale = glm::packHalf2x16(glm::vec2(source.Yaw, scale));
+            instances.push_back(packed);
+        }
+
+        cells.push_back(cell);
+        first = last;
+    }
+}
+
+void ScatterRenderer::Upload() {
+    ReleaseSceneBuffers();
+
+    const u32 layerCount = static_cast<u32>(m_Layers.size());
+    Vector<GPUScatterInstance> instances;
+    Vector<GPUCell> cells;
+    Vector<GPULayer> layers(layerCount);
+    Vector<GPULOD> lods(layerCount * MaxLODs, GPULOD{0, 0, 0, 0.0f});
+
+    const MaterialLibrary& materials = MaterialLibrary::Instance();
+    for (u32 i = 0; i < layerCount; ++i) {
+        const Layer& layer = m_Layers[i];
+        const ScatterLayerDesc& desc = layer.Desc;
+        const Mesh* mesh = desc.Mesh.get();
+        if (!mesh || !mesh->IsUploaded() || layer.Instances.empty()) {
+            layers[i] = {};
+            continue;
+        }
+
+        GPULayer& gpu = layers[i];
+        gpu.Color = desc.Color;
+        gpu.MaterialParams = glm::vec4(desc.Metallic, desc.Roughness, 1.0f, 1.0f);
+        gpu.Sphere = glm::vec4(mesh->GetBoundingSphere().Center, mesh->GetBoundingSphere().Radius);
+        gpu.Dequant = mesh->GetPositionDequant();
+        gpu.MaxDistance = desc.MaxDistance;
+        gpu.MaxScreenError = desc.MaxScreenError;
+        gpu.MaterialIndex = materials.Contains(desc.MaterialId) ? desc.MaterialId : MaterialLibrary::DefaultMaterial;
+        gpu.LODCount = std::min(mesh->GetLODCount(), MaxLODs);
+
+        for (u32 level = 0; level < gpu.LODCount; ++level) {
+            const MeshLOD lod = mesh->GetLOD(level);
+            GPULOD& entry = lods[i * MaxLODs + level];
+            entry.IndexCount = lod.IndexCount;
+            entry.FirstIndex = mesh->GetBaseIndex() + lod.IndexOffset;
+            entry.BaseVertex = static_cast<i32>(mesh->GetBaseVertex());
+            entry.Error = lod.Error;
+        }
+
+        BuildCells(i, instances, cells);
+
+        VertexArray* vao = mesh->GetVertexArray().get();
+        VertexArray* depthVAO = mesh->GetDepthPassVertexArray();
+        if (!m_Groups.empty() && m_Groups.back().VAO == vao && m_Groups.back().DepthVAO == depthVAO &&
+            m_Groups.back().FirstLayer + m_Groups.back().LayerCount == i) {
+            m_Groups.back().LayerCount++;
+        } else {
+            m_Groups.push_back({vao, depthVAO, i, 1});
+        }
+    }
+
+    m_Dirty = false;
+    if (cells.empty()) return;
+
+    m_CellCount = static_cast<u32>(cells.size());
+    m_InstanceCount = static_cast<u32>(instances.size());
+    m_CommandCount = layerCount * MaxLODs;
+
+    glCreateBuffers(1, &m_InstanceBuffer);
+    GLMemory::BufferStorage(m_InstanceBuffer, instances.size() * sizeof(GPUScatterInstance), instances.data(), 0,
+                            MemoryTag::Renderer);
+    glCreateBuffers(1, &m_CellBuffer);
+    GLMemory::BufferStorage(m_CellBuffer, cells.size() * sizeof(GPUCell), cells.data(), 0, MemoryTag::Renderer);
+    glCreateBuffers(1, &m_LayerBuffer);
+    GLMemory::BufferStorage(m_LayerBuffer, layers.size() * sizeof(GPULayer), layers.data(), 0, MemoryTag::Renderer);
+    glCreateBuffers(1, &m_LODBuffer);
+    GLMemory::BufferStorage(m_LODBuffer, lods.size() * sizeof(GPULOD), lods.data(), 0, MemoryTag::Renderer);
+
+    glCreateBuffers(1, &m_CellStateBuffer);
+    GLMemory::BufferStorage(m_CellStateBuffer, m_CellCount * sizeof(u32), nullptr, 0, MemoryTag::Renderer);
+    glCreateBuffers(1, &m_CounterBuffer);
+    GLMemory::BufferStorage(m_CounterBuffer, (1 + m_CommandCount) * sizeof(u32), nullptr, GL_DYNAMIC_STORAGE_BIT,
+                            MemoryTag::Renderer);
+    glCreateBuffers(1, &m_CommandBuffer);
+    GLMemory::BufferStorage(m_CommandBuffer, m_CommandCount * sizeof(DrawElementsIndirectCommand), nullptr, 0,
+                            MemoryTag::Renderer);
+
+    EnsureOutputCapacity(std::min(m_InstanceCount, m_MaxVisibleInstances));
+
+    LOG_CORE_INFO("ScatterRenderer: {} instances in {} cells over {} layers", m_InstanceCount, m_CellCount,
+                  layerCount);
+}
+
+void ScatterRenderer::EnsureOutputCapacity(u32 required) {
+    if (m_OutputBuffer && required <= m_OutputCapacity) return;
+
+    if (m_OutputBuffer) GLMemory::DeleteBuffers(1, &m_OutputBuffer);
+    if (m_PreviousBuffer) GLMemory::DeleteBuffers(1, &m_PreviousBuffer);
+    if (m_InstanceIndexBuffer) GLMemory::DeleteBuffers(1, &m_InstanceIndexBuffer);
+
+    m_OutputCapacity = NextCapacity(required);
+    glCreateBuffers(1, &m_OutputBuffer);
+    GLMemory::BufferStorage(m_OutputBuffer, m_OutputCapacity * sizeof(InstanceData), nullptr, 0,
+                            MemoryTag::Renderer);
+    glCreateBuffers(1, &m_PreviousBuffer);
+    GLMemory::BufferStorage(m_PreviousBuffer, m_OutputCapacity * sizeof(glm::mat4), nullptr, 0,
+                            MemoryTag::Renderer);
+
+    // Identity table, as in IndirectDrawBatcher: the command's baseInstance
+    // is the instance index
+    Vector<u32> indices(m_OutputCapacity);
+    for (u32 i = 0; i < m_OutputCapacity; ++i) {
+        indices[i] = i;
+    }
+    glCreateBuffers(1, &m_InstanceIndexBuffer);
+    GLMemory::BufferStorage(m_InstanceIndexBuffer, m_OutputCapacity * sizeof(u32), indices.data(), 0,
+                            MemoryTag::Renderer);
+}
+
+void ScatterRenderer::BeginFrame() {
+    if (m_Dirty) {
+        Upload();
+    }
+
+    m_Stats = {};
+    m_Stats.Layers = static_cast<u32>(m_Layers.size());
+    m_Stats.Instances = m_InstanceCount;
+    m_Stats.Cells = m_CellCount;
+}
+
+void ScatterRenderer::Cull(u32 viewportHeight) {
+    if (IsEmpty()) return;
+
+    auto& state = GLStateCache::Instance();
+    const u32 cellGroups = (m_CellCount + WorkgroupSize - 1) / WorkgroupSize;
+    const u32 capacity = std::min(m_OutputCapacity, m_MaxVisibleInstances);
+
+    glClearNamedBufferData(m_CounterBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, ScatterInstanceBinding, m_InstanceBuffer);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, CellBinding, m_CellBuffer);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, LayerBinding, m_LayerBuffer);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, LODBinding, m_LODBuffer);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, CellStateBinding, m_CellStateBuffer);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, CommandBinding, m_CommandBuffer);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, CounterBinding, m_CounterBuffer);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, IndirectDrawBatcher::InstanceBufferBinding, m_OutputBuffer);
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, IndirectDrawBatcher::PreviousTransformBinding, m_PreviousBuffer);
+
+    m_CellShader->Bind();
+    m_CellShader->SetUInt("u_CellCount", m_CellCount);
+    m_CellShader->SetUInt("u_OutputCapacity", capacity);
+    m_CellShader->SetFloat("u_ViewportHeight", static_cast<f32>(viewportHeight));
+    DispatchWrapped(cellGroups);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    m_CommandShader->Bind();
+    m_CommandShader->SetUInt("u_CommandCount", m_CommandCount);
+    glDispatchCompute(1, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    // One workgroup per cell; culled ones leave at once
+    m_InstanceShader->Bind();
+    m_InstanceShader->SetUInt("u_CellCount", m_CellCount);
+    DispatchWrapped(m_CellCount);
+
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void ScatterRenderer::Draw(bool depthPass) {
+    if (IsEmpty()) return;
+
+    auto& state = GLStateCache::Instance();
+    state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, IndirectDrawBatcher::InstanceBufferBinding, m_OutputBuffer);
+    if (!depthPass) {
+        state.BindBufferBase(GL_SHADER_STORAGE_BUFFER, IndirectDrawBatcher::PreviousTransformBinding,
+                             m_PreviousBuffer);
+    }
+    state.BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_CommandBuffer);
+
+    for (const auto& group : m_Groups) {
+        VertexArray* vao = depthPass && group.DepthVAO ? group.DepthVAO : group.VAO;
+        vao->SetInstanceIndexBuffer(m_InstanceIndexBuffer, IndirectDrawBatcher::InstanceIndexLocation);
+        vao->Bind();
+
+        // Every LOD slot of every layer; empty ones draw zero instances
+        const usize offset = group.FirstLayer * MaxLODs * sizeof(DrawElementsIndirectCommand);
+        PipelineWarmup::RecordDraw(GL_TRIANGLES);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(offset),
+                                    static_cast<GLsizei>(group.LayerCount * MaxLODs), 0);
+        m_Stats.DrawCalls++;
+    }
+
+    state.BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+} // namespace Engine
@@ -0,0 +1,211 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+class Mesh;
+class VertexArray;
+
+// One scattered copy of a layer's mesh: upright, turned about +Y and
+// uniformly scaled
+struct ScatterInstance {
+    glm::vec3 Position{0.0f};
+    f32 Yaw = 0.0f;         // Radians
+    f32 Scale = 1.0f;
+};
+
+struct ScatterLayerDesc {
+    Ref<Mesh> Mesh;                 // Uploaded; its LODs are picked per cell
+    u32 MaterialId = 0;             // MaterialLibrary id
+    glm::vec4 Color{1.0f};
+    f32 Metallic = 0.0f;
+    f32 Roughness = 0.8f;
+    f32 MaxDistance = 150.0f;       // Nothing farther is drawn
+    f32 MaxScreenError = 1.0f;      // Pixels, as LODSelectionSystem
+    f32 CellSize = 32.0f;           // World units on X and Z
+};
+
+// ScatterRenderer - grass, rocks and other clutter in the millions, with
+// no entities and no per-instance CPU work per frame.
+//
+// Each layer is a mesh and a material; its instances are bucketed into a
+// grid of cells on X / Z when they change (at most MaxCellInstances per
+// cell) and uploaded once, 16 bytes each. Cull() runs scatter_cull.glsl
+// for the bound camera in three dispatches:
+//
+//   cells     - frustum and distance test per cell, then the coarsest LOD
+//               whose projected error stays under MaxScreenError; the cell
+//               reserves room for all its instances in the output and adds
+//               them to its (layer, LOD) command's count
+//   commands  - prefix sum of those counts into each command's first
+//               instance, with the LOD's index range
+//   instances - one workgroup per surviving cell: each instance's sphere is
+//               tested again and survivors append an InstanceData (and the
+//               same matrix as their previous transform) to their command
+//
+// Draw() is then one glMultiDrawElementsIndirect per run of layers sharing
+// a vertex array, through the G-Buffer and depth prepass shaders unchanged.
+// Cells past MaxVisibleInstances are dropped for the view rather than
+// overflowing, in whatever order the GPU reaches them.
+//
+// Instances are static: motion vectors carry camera motion only. Shadow
+// passes don't draw scatter layers. GL thread only.
+class ScatterRenderer {
+public:
+    // Must match scatter_cull.glsl
+    static constexpr u32 WorkgroupSize = 64;
+    static constexpr u32 MaxLODs = 8;
+    static constexpr u32 ScatterInstanceBinding = 0;
+    static constexpr u32 CellBinding = 1;
+    static constexpr u32 LayerBinding = 2;
+    static constexpr u32 LODBinding = 3;
+    static constexpr u32 CellStateBinding = 5;
+    static constexpr u32 CommandBinding = 12;
+    static constexpr u32 CounterBinding = 13;
+
+    // Larger cells are split, so one workgroup never walks too many
+    static constexpr u32 MaxCellInstances = 1024;
+
+    struct Stats {
+        u32 Layers = 0;
+        u32 Instances = 0;      // Stored, every layer
+        u32 Cells = 0;          // Tested per view
+        u32 DrawCalls = 0;      // glMultiDrawElementsIndirect calls, every view
+    };
+
+    ScatterRenderer();
+    ~ScatterRenderer();
+
+    ScatterRenderer(const ScatterRenderer&) = delete;
+    ScatterRenderer& operator=(const ScatterRenderer&) = delete;
+
+    // Returns the layer's index; an empty or unuploaded mesh draws nothing
+    u32 AddLayer(const ScatterLayerDesc& desc);
+    const ScatterLayerDesc& GetLayer(u32 layer) const { return m_Layers[layer].Desc; }
+    u32 GetLayerCount() const { return static_cast<u32>(m_Layers.size()); }
+
+    // Cells are rebuilt and re-uploaded at the next BeginFrame
+    void AddInstances(u32 layer, const ScatterInstance* instances, usize count);
+    void ClearLayer(u32 layer);
+    void Clear();
+
+    // Visible instances per view across every layer; sizes the output
+    void SetMaxVisibleInstances(u32 count);
+    u32 GetMaxVisibleInstances() const { return m_MaxVisibleInstances; }
+
+    // Upload changed layers and reset the stats. Once per frame, before any
+    // view's Cull.
+    void BeginFrame();
+
+    // Cull against the bound camera and write the commands. Once per view,
+    // before its Draw calls.
+    void Cull(u32 viewportHeight);
+
+    // Draw what the last Cull kept. The caller binds the shader.
+    void Draw(bool depthPass);
+
+    bool IsEmpty() const { return m_CellCount == 0; }
+    const Stats& GetStats() const { return m_Stats; }
+
+    void Reload();
+
+private:
+    // Must match scatter_cull.glsl. Yaw and scale are two halves.
+    struct GPUScatterInstance {
+        glm::vec3 Position;
+        u32 YawScale;
+    };
+
+    struct GPUCell {
+        glm::vec3 Min;
+        u32 FirstInstance;
+        glm::vec3 Max;
+        u32 InstanceCount;
+        u32 Layer;
+        f32 MaxScale;
+        u32 Padding0;
+        u32 Padding1;
+    };
+
+    struct GPULayer {
+        glm::vec4 Color;
+        glm::vec4 MaterialParams;
+        glm::vec4 Sphere;           // Mesh space center, radius
+        glm::vec4 Dequant;          // Mesh::GetPositionDequant
+        f32 MaxDistance;
+        f32 MaxScreenError;
+        u32 MaterialIndex;
+        u32 LODCount;
+    };
+
+    // One per (layer, LOD), layer * MaxLODs + LOD
+    struct GPULOD {
+        u32 IndexCount;             // 0 past the mesh's LODs
+        u32 FirstIndex;
+        i32 BaseVertex;
+        f32 Error;
+    };
+
+    struct DrawElementsIndirectCommand {
+        u32 Count;
+        u32 InstanceCount;
+        u32 FirstIndex;
+        i32 BaseVertex;
+        u32 BaseInstance;
+    };
+
+    struct Layer {
+        ScatterLayerDesc Desc;
+        Vector<ScatterInstance> Instances;
+    };
+
+    // Consecutive layers that share a vertex array
+    struct Group {
+        VertexArray* VAO = nullptr;
+        VertexArray* DepthVAO = nullptr;
+        u32 FirstLayer = 0;
+        u32 LayerCount = 0;
+    };
+
+    void LoadShaders();
+    void Upload();
+    void BuildCells(u32 layerIndex, Vector<GPUScatterInstance>& instances, Vector<GPUCell>& cells) const;
+    void EnsureOutputCapacity(u32 required);
+    void ReleaseSceneBuffers();
+
+private:
+    Ref<Shader> m_CellShader;
+    Ref<Shader> m_CommandShader;
+    Ref<Shader> m_InstanceShader;
+
+    Vector<Layer> m_Layers;
+    Vector<Group> m_Groups;
+    bool m_Dirty = false;
+
+    // Rebuilt by Upload
+    u32 m_InstanceBuffer = 0;
+    u32 m_CellBuffer = 0;
+    u32 m_LayerBuffer = 0;
+    u32 m_LODBuffer = 0;
+    u32 m_CellStateBuffer = 0;
+    u32 m_CounterBuffer = 0;    // Reserved total, then a count per command
+    u32 m_CommandBuffer = 0;
+    u32 m_CellCount = 0;
+    u32 m_CommandCount = 0;
+    u32 m_InstanceCount = 0;
+
+    // Written by the GPU only
+    u32 m_OutputBuffer = 0;
+    u32 m_PreviousBuffer = 0;
+    u32 m_OutputCapacity = 0;
+    u32 m_MaxVisibleInstances = 131072;
+
+    u32 m_InstanceIndexBuffer = 0;
+
+    Stats m_Stats;
+};
+
+} // namespace Engine
@@ -1,13 +1,42 @@
 #include "renderer/shadows/CascadedShadowMap.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
 #include "core/Logger.hpp"
 
 #include <glad/gl.h>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
+
 namespace Engine {
 
+namespace {
+
+// Fraction of a cascade's light-space extent added on each side when it is
+// cached, so the camera can move a little before the cascade is re-rendered
+constexpr f32 CacheGuardBand = 0.1f;
+
+// Cached and scheduled cascades are redrawn once the light turns more than
+// ~0.25 degrees
+constexpr f32 CacheDirectionThreshold = 0.99999f;
+
+// Longest update interval a cascade can be scheduled with
+constexpr u32 MaxCascadeUpdateInterval = 8;
+
+// Sphere radii are rounded up to this step so float noise in the corners
+// can't change the projection size from frame to frame
+constexpr f32 SphereRadiusStep = 1.0f / 16.0f;
+
+// Up vector of a light view, away from the light direction
+glm::vec3 LightViewUp(const glm::vec3& lightDir) {
+    return std::abs(lightDir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+}
+
+} // anonymous namespace
+
 CascadedShadowMap::CascadedShadowMap(u32 resolution)
     : m_Resolution(resolution) {
+    m_UpdateIntervals.fill(1);
     CreateResources();
 }
 
@@ -19,11 +48,27 @@ CascadedShadowMap::CascadedShadowMap(CascadedShadowMap&& other) noexcept
     : m_Resolution(other.m_Resolution)
     , m_DepthTextureArray(other.m_DepthTextureArray)
     , m_Framebuffer(other.m_Framebuffer)
+    , m_StaticDepthTextureArray(other.m_StaticDepthTextureArray)
+    , m_StaticFramebuffer(other.m_StaticFramebuffer)
+    , m_CachingEnabled(other.m_CachingEnabled)
+    , m_CacheValid(other.m_CacheValid)
+    , m_CachedLightDirection(other.m_CachedLightDirection)
+    , m_LightSpaceBounds(other.m_LightSpaceBounds)
+    , m_StableCascades(other.m_StableCascades)
+    , m_UpdateIntervals(other.m_UpdateIntervals)
+    , m_CascadeDue(other.m_CascadeDue)
+    , m_CascadeStale(other.m_CascadeStale)
+    , m_CascadeLightDirection(other.m_CascadeLightDirection)
+    , m_UpdateCount(other.m_UpdateCount)
     , m_Cascades(std::move(other.m_Cascades))
     , m_SplitDistances(std::move(other.m_SplitDistances))
     , m_Initialized(other.m_Initialized) {
     other.m_DepthTextureArray = 0;
     other.m_Framebuffer = 0;
+    other.m_StaticDepthTextureArray = 0;
+    other.m_StaticFramebuffer = 0;
+    other.m_CachingEnabled = false;
+    other.m_CacheValid = {};
     other.m_Initialized = false;
 }
 
@@ -34,12 +79,28 @@ CascadedShadowMap& CascadedShadowMap::operator=(CascadedShadowMap&& other) noexc
         m_Resolution = other.m_Resolution;
         m_DepthTextureArray = other.m_DepthTextureArray;
         m_Framebuffer = other.m_Framebuffer;
+        m_StaticDepthTextureArray = other.m_StaticDepthTextureArray;
+        m_StaticFramebuffer = other.m_StaticFramebuffer;
+        m_CachingEnabled = other.m_CachingEnabled;
+        m_CacheValid = other.m_CacheValid;
+        m_CachedLightDirection = other.m_CachedLightDirection;
+        m_LightSpaceBounds = other.m_LightSpaceBounds;
+        m_StableCascades = other.m_StableCascades;
+        m_UpdateIntervals = other.m_UpdateIntervals;
+        m_CascadeDue = other.m_CascadeDue;
+        m_CascadeStale = other.m_CascadeStale;
+        m_CascadeLightDirection = other.m_CascadeLightDirection;
+        m_UpdateCount = other.m_UpdateCount;
         m_Cascades = std::move(other.m_Cascades);
         m_SplitDistances = std::move(other.m_SplitDistances);
         m_Initialized = other.m_Initialized;
 
         other.m_DepthTextureArray = 0;
         other.m_Framebuffer = 0;
+        other.m_StaticDepthTextureArray = 0;
+        other.m_StaticFramebuffer = 0;
+        other.m_CachingEnabled = false;
+        other.m_CacheValid = {};
         other.m_Initialized = false;
     }
     return *this;
@@ -48,8 +109,8 @@ CascadedShadowMap& CascadedShadowMap::operator=(CascadedShadowMap&& other) noexc
 void CascadedShadowMap::CreateResources() {
     // Create 2D texture array for cascades (depth-only)
     glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_DepthTextureArray);
-    glTextureStorage3D(m_DepthTextureArray, 1, GL_DEPTH_COMPONENT32F,
-                       m_Resolution, m_Resolution, CSM_CASCADE_COUNT);
+    GLMemory::TextureStorage3D(m_DepthTextureArray, 1, GL_DEPTH_COMPONENT32F,
+                               m_Resolution, m_Resolution, CSM_CASCADE_COUNT, MemoryTag::Shadows);
 
     // Texture parameters for depth comparison
     glTextureParameteri(m_DepthTextureArray, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -72,6 +133,13 @@ void CascadedShadowMap::CreateResources() {
     glNamedFramebufferDrawBuffer(m_Framebuffer, GL_NONE);
     glNamedFramebufferReadBuffer(m_Framebuffer, GL_NONE);
 
+    if (m_CachingEnabled) {
+        CreateCacheResources();
+    }
+
+    // New layers hold nothing yet
+    InvalidateSchedule();
+
     m_Initialized = true;
 
     LOG_CORE_DEBUG("Created CSM with resolution {}x{} ({} cascades)",
@@ -79,19 +147,99 @@ void CascadedShadowMap::CreateResources() {
 }
 
 void CascadedShadowMap::DeleteResources() {
+    DeleteCacheResources();
+
     if (m_Framebuffer) {
         glDeleteFramebuffers(1, &m_Framebuffer);
         m_Framebuffer = 0;
     }
 
     if (m_DepthTextureArray) {
-        glDeleteTextures(1, &m_DepthTextureArray);
+        GLMemory::DeleteTextures(1, &m_DepthTextureArray);
         m_DepthTextureArray = 0;
     }
 
     m_Initialized = false;
 }
 
+void CascadedShadowMap::CreateCacheResources() {
+    // Same format as the sampled array so layers can be copied with glCopyImageSubData
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_StaticDepthTextureArray);
+    GLMemory::TextureStorage3D(m_StaticDepthTextureArray, 1, GL_DEPTH_COMPONENT32F,
+                               m_Resolution, m_Resolution, CSM_CASCADE_COUNT, MemoryTag::Shadows);
+
+    glCreateFramebuffers(1, &m_StaticFramebuffer);
+    glNamedFramebufferDrawBuffer(m_StaticFramebuffer, GL_NONE);
+    glNamedFramebufferReadBuffer(m_StaticFramebuffer, GL_NONE);
+
+    m_CacheValid = {};
+
+    LOG_CORE_DEBUG("Created CSM static cache ({}x{}, {} cascades)",
+                   m_Resolution, m_Resolution, CSM_CASCADE_COUNT);
+}
+
+void CascadedShadowMap::DeleteCacheResources() {
+    if (m_StaticFramebuffer) {
+        glDeleteFramebuffers(1, &m_StaticFramebuffer);
+        m_StaticFramebuffer = 0;
+    }
+
+    if (m_StaticDepthTextureArray) {
+        GLMemory::DeleteTextures(1, &m_StaticDepthTextureArray);
+        m_StaticDepthTextureArray = 0;
+    }
+
+    m_CacheValid = {};
+}
+
+void CascadedShadowMap::SetCachingEnabled(bool enabled) {
+    if (enabled == m_CachingEnabled) return;
+
+    m_CachingEnabled = enabled;
+    if (!m_Initialized) return;
+
+    if (enabled) {
+        CreateCacheResources();
+    } else {
+        DeleteCacheResources();
+    }
+}
+
+void CascadedShadowMap::InvalidateCache() {
+    m_CacheValid = {};
+}
+
+bool CascadedShadowMap::IsCascadeCached(u32 cascadeIndex) const {
+    return cascadeIndex < CSM_CASCADE_COUNT && m_CacheValid[cascadeIndex];
+}
+
+void CascadedShadowMap::MarkCascadeCached(u32 cascadeIndex) {
+    if (cascadeIndex >= CSM_CASCADE_COUNT || !m_StaticDepthTextureArray) return;
+    m_CacheValid[cascadeIndex] = true;
+}
+
+void CascadedShadowMap::SetUpdateIntervals(const std::array<u32, CSM_CASCADE_COUNT>& intervals) {
+    for (u32 i = 0; i < CSM_CASCADE_COUNT; ++i) {
+        m_UpdateIntervals[i] = std::clamp(intervals[i], 1u, MaxCascadeUpdateInterval);
+    }
+}
+
+void CascadedShadowMap::InvalidateSchedule() {
+    m_CascadeStale.fill(true);
+}
+
+bool CascadedShadowMap::IsCascadeDue(u32 cascadeIndex) const {
+    return cascadeIndex < CSM_CASCADE_COUNT && m_CascadeDue[cascadeIndex];
+}
+
+u32 CascadedShadowMap::GetDueCascadeCount() const {
+    u32 count = 0;
+    for (bool due : m_CascadeDue) {
+        count += due ? 1 : 0;
+    }
+    return count;
+}
+
 void CascadedShadowMap::Resize(u32 resolution) {
     if (resolution == m_Resolution) return;
 
@@ -114,6 +262,7 @@ void CascadedShadowMap::Update(const Camera& camera,
 
     CalculateCascadeSplits(nearPlane, maxDistance, lambda);
     CalculateCascadeMatrices(camera, glm::normalize(lightDirection));
+    m_UpdateCount++;
 }
 
 void CascadedShadowMap::CalculateCascadeSplits(f32 nearPlane, f32 maxDistance, f32 lambda) {
@@ -174,72 +323,66 @@ std::array<glm::vec3, 8> CascadedShadowMap::GetFrustumCornersWorldSpace(
     return corners;
 }
 
+bool CascadedShadowMap::CoversCorners(u32 cascadeIndex,
+                                      const std::array<glm::vec3, 8>& corners) const {
+    const glm::mat4& lightView = m_Cascades[cascadeIndex].ViewMatrix;
+    const AABB& bounds = m_LightSpaceBounds[cascadeIndex];
+
+    for (const auto& corner : corners) {
+        if (!bounds.Contains(glm::vec3(lightView * glm::vec4(corner, 1.0f)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void CascadedShadowMap::CalculateCascadeMatrices(const Camera& camera,
                                                   const glm::vec3& lightDir) {
+    // Cached layers were rendered from the direction they were cached with
+    if (glm::dot(lightDir, m_CachedLightDirection) < CacheDirectionThreshold) {
+        InvalidateCache();
+        m_CachedLightDirection = lightDir;
+    }
+
     for (u32 cascade = 0; cascade < CSM_CASCADE_COUNT; ++cascade) {
         f32 nearSplit = m_SplitDistances[cascade];
         f32 farSplit = m_SplitDistances[cascade + 1];
 
         auto corners = GetFrustumCornersWorldSpace(camera, nearSplit, farSplit);
 
-        // Calculate frustum center
-        glm::vec3 center(0.0f);
-        for (const auto& corner : corners) {
-            center += corner;
+        // Off-schedule cascades keep the projection their layer was drawn
+        // with, as long as it still fits the slice and the light
+        const u32 interval = m_UpdateIntervals[cascade];
+        const bool scheduled = (m_UpdateCount + cascade) % interval == 0;
+        const bool due = scheduled || m_CascadeStale[cascade] ||
+                         m_Cascades[cascade].SplitNear != nearSplit ||
+                         m_Cascades[cascade].SplitFar != farSplit ||
+                         glm::dot(lightDir, m_CascadeLightDirection[cascade]) < CacheDirectionThreshold ||
+                         !CoversCorners(cascade, corners);
+
+        m_CascadeDue[cascade] = due;
+        if (!due) {
+            continue;
         }
-        center /= 8.0f;
+        m_CascadeStale[cascade] = false;
+        m_CascadeLightDirection[cascade] = lightDir;
 
-        // Create light view matrix looking at frustum center
-        glm::mat4 lightView = glm::lookAt(
-            center - lightDir * 100.0f,  // Light position (far away in light direction)
-            center,
-            glm::vec3(0.0f, 1.0f, 0.0f)
-        );
+        m_Cascades[cascade].SplitNear = nearSplit;
+        m_Cascades[cascade].SplitFar = farSplit;
 
-        // Transform frustum corners to light space and find bounding box
-        f32 minX = std::numeric_limits<f32>::max();
-        f32 maxX = std::numeric_limits<f32>::lowest();
-        f32 minY = std::numeric_limits<f32>::max();
-        f32 maxY = std::numeric_limits<f32>::lowest();
-        f32 minZ = std::numeric_limits<f32>::max();
-        f32 maxZ = std::numeric_limits<f32>::lowest();
-
-        for (const auto& corner : corners) {
-            glm::vec4 lightSpaceCorner = lightView * glm::vec4(corner, 1.0f);
-            minX = std::min(minX, lightSpaceCorner.x);
-            maxX = std::max(maxX, lightSpaceCorner.x);
-            minY = std::min(minY, lightSpaceCorner.y);
-            maxY = std::max(maxY, lightSpaceCorner.y);
-            minZ = std::min(minZ, lightSpaceCorner.z);
-            maxZ = std::max(maxZ, lightSpaceCorner.z);
+        // Keep the cached projection while this slice of the frustum fits in it
+        if (m_CacheValid[cascade] && CoversCorners(cascade, corners)) {
+            continue;
         }
+        m_CacheValid[cascade] = false;
 
-        // Extend Z range to include shadow casters behind the camera frustum
-        constexpr f32 zMultiplier = 5.0f;
-        if (minZ < 0) {
-            minZ *= zMultiplier;
+        if (m_StableCascades) {
+            FitCascadeSphere(cascade, corners, lightDir);
         } else {
-            minZ /= zMultiplier;
+            FitCascade(cascade, corners, lightDir);
         }
-        if (maxZ < 0) {
-            maxZ /= zMultiplier;
-        } else {
-            maxZ *= zMultiplier;
-        }
-
-        // Create orthographic projection
-        glm::mat4 lightProjection = glm::ortho(minX, maxX, minY, maxY, minZ, maxZ);
-
-        // Stabilize the shadow map to prevent swimming/shimmer
-        glm::mat4 lightViewProj = lightProjection * lightView;
-        lightViewProj = StabilizeProjection(lightViewProj, m_Resolution);
 
-        // Store cascade info
-        m_Cascades[cascade].ViewMatrix = lightView;
-        m_Cascades[cascade].ProjectionMatrix = lightProjection;
-        m_Cascades[cascade].ViewProjectionMatrix = lightViewProj;
-        m_Cascades[cascade].SplitNear = nearSplit;
-        m_Cascades[cascade].SplitFar = farSplit;
+        const glm::mat4& lightViewProj = m_Cascades[cascade].ViewProjectionMatrix;
 
         // Calculate world-space AABB for frustum culling
         glm::mat4 invLightViewProj = glm::inverse(lightViewProj);
@@ -262,7 +405,123 @@ void CascadedShadowMap::CalculateCascadeMatrices(const Camera& camera,
             }
         }
         m_Cascades[cascade].WorldBounds = AABB(worldMin, worldMax);
+
+        // Casters anywhere between the light and the box still shadow it; the
+        // depth pass clamps them onto the near plane (GL_DEPTH_CLAMP)
+        m_Cascades[cascade].CasterFrustum.ExtractPlanes(lightViewProj);
+        m_Cascades[cascade].CasterFrustum.DisablePlane(Frustum::Near);
+    }
+}
+
+void CascadedShadowMap::FitCascade(u32 cascadeIndex,
+                                   const std::array<glm::vec3, 8>& corners,
+                                   const glm::vec3& lightDir) {
+    // Calculate frustum center
+    glm::vec3 center(0.0f);
+    for (const auto& corner : corners) {
+        center += corner;
+    }
+    center /= 8.0f;
+
+    // Create light view matrix looking at frustum center
+    glm::mat4 lightView = glm::lookAt(
+        center - lightDir * 100.0f,  // Light position (far away in light direction)
+        center,
+        LightViewUp(lightDir)
+    );
+
+    // Transform frustum corners to light space and find bounding box
+    f32 minX = std::numeric_limits<f32>::max();
+    f32 maxX = std::numeric_limits<f32>::lowest();
+    f32 minY = std::numeric_limits<f32>::max();
+    f32 maxY = std::numeric_limits<f32>::lowest();
+    f32 minZ = std::numeric_limits<f32>::max();
+    f32 maxZ = std::numeric_limits<f32>::lowest();
+
+    for (const auto& corner : corners) {
+        glm::vec4 lightSpaceCorner = lightView * glm::vec4(corner, 1.0f);
+        minX = std::min(minX, lightSpaceCorner.x);
+        maxX = std::max(maxX, lightSpaceCorner.x);
+        minY = std::min(minY, lightSpaceCorner.y);
+        maxY = std::max(maxY, lightSpaceCorner.y);
+        minZ = std::min(minZ, lightSpaceCorner.z);
+        maxZ = std::max(maxZ, lightSpaceCorner.z);
+    }
+
+    // Extend Z range to include shadow casters behind the camera frustum
+    constexpr f32 zMultiplier = 5.0f;
+    if (minZ < 0) {
+        minZ *= zMultiplier;
+    } else {
+        minZ /= zMultiplier;
+    }
+    if (maxZ < 0) {
+        maxZ /= zMultiplier;
+    } else {
+        maxZ *= zMultiplier;
+    }
+
+    // Leave room for the camera to move while the cascade stays cached or
+    // waits for its next scheduled update
+    if (m_CachingEnabled || m_UpdateIntervals[cascadeIndex] > 1) {
+        f32 padX = (maxX - minX) * CacheGuardBand;
+        f32 padY = (maxY - minY) * CacheGuardBand;
+        minX -= padX;
+        maxX += padX;
+        minY -= padY;
+        maxY += padY;
+    }
+    m_LightSpaceBounds[cascadeIndex] = AABB(glm::vec3(minX, minY, minZ), glm::vec3(maxX, maxY, maxZ));
+
+    // Create orthographic projection
+    glm::mat4 lightProjection = glm::ortho(minX, maxX, minY, maxY, minZ, maxZ);
+
+    // Stabilize the shadow map to prevent swimming/shimmer
+    glm::mat4 lightViewProj = lightProjection * lightView;
+    lightViewProj = StabilizeProjection(lightViewProj, m_Resolution);
+
+    // Store cascade info
+    m_Cascades[cascadeIndex].ViewMatrix = lightView;
+    m_Cascades[cascadeIndex].ProjectionMatrix = lightProjection;
+    m_Cascades[cascadeIndex].ViewProjectionMatrix = lightViewProj;
+}
+
+void CascadedShadowMap::FitCascadeSphere(u32 cascadeIndex,
+                                         const std::array<glm::vec3, 8>& corners,
+                                         const glm::vec3& lightDir) {
+    glm::vec3 center(0.0f);
+    for (const auto& corner : corners) {
+        center += corner;
+    }
+    center /= 8.0f;
+
+    // The slice is rigid, so its bounding sphere only changes with the
+    // splits: the projection keeps one size however the camera turns
+    f32 radius = 0.0f;
+    for (const auto& corner : corners) {
+        radius = std::max(radius, glm::length(corner - center));
     }
+    radius = std::ceil(radius / SphereRadiusStep) * SphereRadiusStep;
+
+    if (m_CachingEnabled || m_UpdateIntervals[cascadeIndex] > 1) {
+        radius *= 1.0f + CacheGuardBand;
+    }
+
+    // The eye sits on the sphere, facing its center; casters between it and
+    // the light are clamped onto the near plane
+    glm::mat4 lightView = glm::lookAt(center - lightDir * radius, center, LightViewUp(lightDir));
+    glm::mat4 lightProjection = glm::ortho(-radius, radius, -radius, radius, 0.0f, 2.0f * radius);
+
+    m_LightSpaceBounds[cascadeIndex] = AABB(glm::vec3(-radius, -radius, -2.0f * radius),
+                                            glm::vec3(radius, radius, 0.0f));
+
+    // With a constant extent, snapping the world origin to a texel anchors
+    // the whole texel grid in the world: contents only move in texel steps
+    glm::mat4 lightViewProj = StabilizeProjection(lightProjection * lightView, m_Resolution);
+
+    m_Cascades[cascadeIndex].ViewMatrix = lightView;
+    m_Cascades[cascadeIndex].ProjectionMatrix = lightProjection;
+    m_Cascades[cascadeIndex].ViewProjectionMatrix = lightViewProj;
 }
 
 glm::mat4 CascadedShadowMap::StabilizeProjection(const glm::mat4& lightViewProj,
@@ -292,18 +551,54 @@ void CascadedShadowMap::BindForCascade(u32 cascadeIndex) {
         return;
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+    BindLayer(m_Framebuffer, m_DepthTextureArray, cascadeIndex);
+}
+
+void CascadedShadowMap::BindForStaticCascade(u32 cascadeIndex) {
+    if (cascadeIndex >= CSM_CASCADE_COUNT || !m_StaticFramebuffer) {
+        LOG_CORE_ERROR("No static cache for cascade {}", cascadeIndex);
+        return;
+    }
+
+    BindLayer(m_StaticFramebuffer, m_StaticDepthTextureArray, cascadeIndex);
+}
+
+void CascadedShadowMap::RestoreCascadeFromCache(u32 cascadeIndex) {
+    if (!IsCascadeCached(cascadeIndex)) return;
+
+    glCopyImageSubData(m_StaticDepthTextureArray, GL_TEXTURE_2D_ARRAY, 0, 0, 0, static_cast<GLint>(cascadeIndex),
+                       m_DepthTextureArray, GL_TEXTURE_2D_ARRAY, 0, 0, 0, static_cast<GLint>(cascadeIndex),
+                       m_Resolution, m_Resolution, 1);
+}
+
+void CascadedShadowMap::BindLayer(u32 framebuffer, u32 texture, u32 cascadeIndex) {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
 
     // Attach specific layer of texture array
-    glNamedFramebufferTextureLayer(m_Framebuffer, GL_DEPTH_ATTACHMENT,
-                                    m_DepthTextureArray, 0, cascadeIndex);
+    glNamedFramebufferTextureLayer(framebuffer, GL_DEPTH_ATTACHMENT,
+                                    texture, 0, cascadeIndex);
 
+    ApplyDepthPassState();
+}
+
+void CascadedShadowMap::BindForAllCascades() {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+    glNamedFramebufferTexture(m_Framebuffer, GL_DEPTH_ATTACHMENT, m_DepthTextureArray, 0);
+
+    ApplyDepthPassState();
+}
+
+void CascadedShadowMap::ApplyDepthPassState() {
+    auto& state = GLStateCache::Instance();
     glViewport(0, 0, m_Resolution, m_Resolution);
 
     // Enable depth testing and writing
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-    glDepthMask(GL_TRUE);
+    state.SetDepthTest(true);
+    state.SetDepthFunc(GL_LESS);
+    state.SetDepthWrite(true);
+
+    // Casters in front of the near plane are flattened onto it instead of clipped
+    glEnable(GL_DEPTH_CLAMP);
 
     // Disable color writing
     glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
@@ -317,6 +612,7 @@ void CascadedShadowMap::Unbind() {
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
     // Restore state
+    glDisable(GL_DEPTH_CLAMP);
     glDisable(GL_POLYGON_OFFSET_FILL);
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 }
@@ -334,13 +630,12 @@ void CascadedShadowMap::ClearCascade(u32 cascadeIndex) {
     if (cascadeIndex >= CSM_CASCADE_COUNT) return;
 
     f32 clearDepth = 1.0f;
-    glNamedFramebufferTextureLayer(m_Framebuffer, GL_DEPTH_ATTACHMENT,
-                                    m_DepthTextureArray, 0, cascadeIndex);
-    glClearNamedFramebufferfv(m_Framebuffer, GL_DEPTH, 0, &clearDepth);
+    glClearTexSubImage(m_DepthTextureArray, 0, 0, 0, static_cast<GLint>(cascadeIndex),
+                       m_Resolution, m_Resolution, 1, GL_DEPTH_COMPONENT, GL_FLOAT, &clearDepth);
 }
 
 void CascadedShadowMap::BindTexture(u32 slot) const {
-    glBindTextureUnit(slot, m_DepthTextureArray);
+    GLStateCache::Instance().BindTextureUnit(slot, m_DepthTextureArray);
 }
 
 const CascadeInfo& CascadedShadowMap::GetCascadeInfo(u32 index) const {
@@ -30,10 +30,57 @@ public:
 
     // Bind framebuffer for rendering a specific cascade
     void BindForCascade(u32 cascadeIndex);
+
+    // Bind the whole texture array as a layered attachment; the shader picks
+    // the cascade per primitive through gl_Layer
+    void BindForAllCascades();
     void Unbind();
     void Clear();
+
+    // Clears the layer through the texture, independent of the bound
+    // framebuffer and the depth mask
     void ClearCascade(u32 cascadeIndex);
 
+    // Fit each cascade to the bounding sphere of its frustum slice and snap
+    // it to whole texels: the projection keeps its size as the camera turns
+    // and only moves in texel steps, so the map doesn't shimmer
+    void SetStableCascades(bool stable) { m_StableCascades = stable; }
+    bool IsStableCascades() const { return m_StableCascades; }
+
+    // Update schedule: cascade i is recomputed every intervals[i] frames of
+    // Update() (1 = every frame), staggered so far cascades don't come due
+    // together. In between it keeps its projection and its depth layer. A
+    // cascade is also due when its slice leaves the projection, its split
+    // changed or the light turned.
+    void SetUpdateIntervals(const std::array<u32, CSM_CASCADE_COUNT>& intervals);
+    const std::array<u32, CSM_CASCADE_COUNT>& GetUpdateIntervals() const { return m_UpdateIntervals; }
+
+    // Recompute every cascade on the next Update(), for when the layers went
+    // stale (shadows were skipped for a frame)
+    void InvalidateSchedule();
+
+    // Whether the last Update() recomputed the cascade; it must be drawn
+    // this frame, the others are sampled as they are
+    bool IsCascadeDue(u32 cascadeIndex) const;
+    u32 GetDueCascadeCount() const;
+
+    // Static caster caching. Each cascade keeps a second depth layer holding
+    // only static casters, rendered with a padded projection that is reused
+    // until the view frustum leaves it, the light turns or the static set
+    // changes. Dynamic casters are then drawn on top of a copy every frame.
+    void SetCachingEnabled(bool enabled);
+    bool IsCachingEnabled() const { return m_CachingEnabled; }
+    void InvalidateCache();
+    bool IsCascadeCached(u32 cascadeIndex) const;
+    void MarkCascadeCached(u32 cascadeIndex);
+
+    // Render target for the static layer of a cascade
+    void BindForStaticCascade(u32 cascadeIndex);
+
+    // Copy the static layer into the sampled layer (call before binding the
+    // cascade for dynamic casters, without clearing it)
+    void RestoreCascadeFromCache(u32 cascadeIndex);
+
     // Bind shadow map texture array for sampling in shaders
     void BindTexture(u32 slot) const;
     u32 GetTextureID() const { return m_DepthTextureArray; }
@@ -52,6 +99,10 @@ public:
 private:
     void CreateResources();
     void DeleteResources();
+    void CreateCacheResources();
+    void DeleteCacheResources();
+    void BindLayer(u32 framebuffer, u32 texture, u32 cascadeIndex);
+    void ApplyDepthPassState();
 
     void CalculateCascadeSplits(f32 nearPlane, f32 maxDistance, f32 lambda);
     void CalculateCascadeMatrices(const Camera& camera, const glm::vec3& lightDir);
@@ -62,6 +113,13 @@ private:
     // Calculate frustum corners in world space for a given near/far range
     std::array<glm::vec3, 8> GetFrustumCornersWorldSpace(const Camera& camera, f32 nearPlane, f32 farPlane) const;
 
+    // Light view and projection of a cascade from its frustum slice
+    void FitCascade(u32 cascadeIndex, const std::array<glm::vec3, 8>& corners, const glm::vec3& lightDir);
+    void FitCascadeSphere(u32 cascadeIndex, const std::array<glm::vec3, 8>& corners, const glm::vec3& lightDir);
+
+    // True if the current projection of a cascade still contains these corners
+    bool CoversCorners(u32 cascadeIndex, const std::array<glm::vec3, 8>& corners) const;
+
 private:
     u32 m_Resolution;
 
@@ -69,6 +127,24 @@ private:
     u32 m_DepthTextureArray = 0;        // GL_TEXTURE_2D_ARRAY
     u32 m_Framebuffer = 0;
 
+    // Static caster cache (only allocated while caching is enabled)
+    u32 m_StaticDepthTextureArray = 0;
+    u32 m_StaticFramebuffer = 0;
+    bool m_CachingEnabled = false;
+    std::array<bool, CSM_CASCADE_COUNT> m_CacheValid{};
+    glm::vec3 m_CachedLightDirection{0.0f};
+
+    // Projection extent of each cascade, in its ViewMatrix space
+    std::array<AABB, CSM_CASCADE_COUNT> m_LightSpaceBounds;
+
+    // Update schedule
+    bool m_StableCascades = true;
+    std::array<u32, CSM_CASCADE_COUNT> m_UpdateIntervals;
+    std::array<bool, CSM_CASCADE_COUNT> m_CascadeDue{};
+    std::array<bool, CSM_CASCADE_COUNT> m_CascadeStale;     // No usable layer yet
+    std::array<glm::vec3, CSM_CASCADE_COUNT> m_CascadeLightDirection{};
+    u32 m_UpdateCount = 0;
+
     // Per-cascade data
     std::array<CascadeInfo, CSM_CASCADE_COUNT> m_Cascades;
     std::array<f32, CSM_CASCADE_COUNT + 1> m_SplitDistances;
@@ -1,4 +1,6 @@
 #include "renderer/shadows/ShadowAtlas.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
 #include "core/Logger.hpp"
 
 #include <glad/gl.h>
@@ -21,10 +23,18 @@ ShadowAtlas::ShadowAtlas(ShadowAtlas&& other) noexcept
     , m_CurrentFrame(other.m_CurrentFrame)
     , m_DepthTexture(other.m_DepthTexture)
     , m_Framebuffer(other.m_Framebuffer)
+    , m_StaticDepthTexture(other.m_StaticDepthTexture)
+    , m_StaticFramebuffer(other.m_StaticFramebuffer)
+    , m_CachingEnabled(other.m_CachingEnabled)
     , m_Tiles(std::move(other.m_Tiles))
+    , m_FreeBlocks(std::move(other.m_FreeBlocks))
+    , m_AllocatedArea(other.m_AllocatedArea)
     , m_Initialized(other.m_Initialized) {
     other.m_DepthTexture = 0;
     other.m_Framebuffer = 0;
+    other.m_StaticDepthTexture = 0;
+    other.m_StaticFramebuffer = 0;
+    other.m_CachingEnabled = false;
     other.m_Initialized = false;
 }
 
@@ -36,11 +46,19 @@ ShadowAtlas& ShadowAtlas::operator=(ShadowAtlas&& other) noexcept {
         m_CurrentFrame = other.m_CurrentFrame;
         m_DepthTexture = other.m_DepthTexture;
         m_Framebuffer = other.m_Framebuffer;
+        m_StaticDepthTexture = other.m_StaticDepthTexture;
+        m_StaticFramebuffer = other.m_StaticFramebuffer;
+        m_CachingEnabled = other.m_CachingEnabled;
         m_Tiles = std::move(other.m_Tiles);
+        m_FreeBlocks = std::move(other.m_FreeBlocks);
+        m_AllocatedArea = other.m_AllocatedArea;
         m_Initialized = other.m_Initialized;
 
         other.m_DepthTexture = 0;
         other.m_Framebuffer = 0;
+        other.m_StaticDepthTexture = 0;
+        other.m_StaticFramebuffer = 0;
+        other.m_CachingEnabled = false;
         other.m_Initialized = false;
     }
     return *this;
@@ -49,7 +67,7 @@ ShadowAtlas& ShadowAtlas::operator=(ShadowAtlas&& other) noexcept {
 void ShadowAtlas::CreateResources() {
     // Create depth texture
     glCreateTextures(GL_TEXTURE_2D, 1, &m_DepthTexture);
-    glTextureStorage2D(m_DepthTexture, 1, GL_DEPTH_COMPONENT32F, m_AtlasSize, m_AtlasSize);
+    GLMemory::TextureStorage2D(m_DepthTexture, 1, GL_DEPTH_COMPONENT32F, m_AtlasSize, m_AtlasSize, MemoryTag::Shadows);
 
     // Texture parameters
     glTextureParameteri(m_DepthTexture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -83,101 +101,278 @@ void ShadowAtlas::CreateResources() {
 }
 
 void ShadowAtlas::DeleteResources() {
+    DeleteCacheResources();
+
     if (m_Framebuffer) {
         glDeleteFramebuffers(1, &m_Framebuffer);
         m_Framebuffer = 0;
     }
     if (m_DepthTexture) {
-        glDeleteTextures(1, &m_DepthTexture);
+        GLMemory::DeleteTextures(1, &m_DepthTexture);
         m_DepthTexture = 0;
     }
     m_Initialized = false;
 }
 
+void ShadowAtlas::CreateCacheResources() {
+    // Same format as the sampled atlas so tiles can be copied with glCopyImageSubData
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_StaticDepthTexture);
+    GLMemory::TextureStorage2D(m_StaticDepthTexture, 1, GL_DEPTH_COMPONENT32F, m_AtlasSize, m_AtlasSize,
+                               MemoryTag::Shadows);
+
+    glCreateFramebuffers(1, &m_StaticFramebuffer);
+    glNamedFramebufferTexture(m_StaticFramebuffer, GL_DEPTH_ATTACHMENT, m_StaticDepthTexture, 0);
+    glNamedFramebufferDrawBuffer(m_StaticFramebuffer, GL_NONE);
+    glNamedFramebufferReadBuffer(m_StaticFramebuffer, GL_NONE);
+
+    InvalidateCache();
+
+    LOG_CORE_DEBUG("Created ShadowAtlas static cache {}x{}", m_AtlasSize, m_AtlasSize);
+}
+
+void ShadowAtlas::DeleteCacheResources() {
+    if (m_StaticFramebuffer) {
+        glDeleteFramebuffers(1, &m_StaticFramebuffer);
+        m_StaticFramebuffer = 0;
+    }
+    if (m_StaticDepthTexture) {
+        GLMemory::DeleteTextures(1, &m_StaticDepthTexture);
+        m_StaticDepthTexture = 0;
+    }
+    InvalidateCache();
+}
+
+void ShadowAtlas::SetCachingEnabled(bool enabled) {
+    if (enabled == m_CachingEnabled) return;
+
+    m_CachingEnabled = enabled;
+    if (!m_Initialized) return;
+
+    if (enabled) {
+        CreateCacheResources();
+    } else {
+        DeleteCacheResources();
+    }
+}
+
+void ShadowAtlas::InvalidateCache() {
+    for (auto& tile : m_Tiles) {
+        tile.StaticCached = false;
+    }
+}
+
+bool ShadowAtlas::IsTileCached(i32 tileIndex, const glm::mat4& viewProjection) const {
+    if (tileIndex < 0 || static_cast<size_t>(tileIndex) >= m_Tiles.size()) return false;
+
+    const auto& tile = m_Tiles[tileIndex];
+    return tile.StaticCached && tile.CachedViewProj == viewProjection;
+}
+
+void ShadowAtlas::MarkTileCached(i32 tileIndex, const glm::mat4& viewProjection) {
+    if (tileIndex < 0 || static_cast<size_t>(tileIndex) >= m_Tiles.size()) return;
+    if (!m_StaticDepthTexture) return;
+
+    m_Tiles[tileIndex].StaticCached = true;
+    m_Tiles[tileIndex].CachedViewProj = viewProjection;
+}
+
+void ShadowAtlas::MarkTileRendered(i32 tileIndex, const glm::mat4& viewProjection) {
+    if (tileIndex < 0 || static_cast<size_t>(tileIndex) >= m_Tiles.size()) return;
+
+    m_Tiles[tileIndex].LastRenderedFrame = m_CurrentFrame;
+    m_Tiles[tileIndex].RenderedViewProj = viewProjection;
+}
+
 void ShadowAtlas::InitializeTiles() {
     m_Tiles.clear();
+    m_AllocatedArea = 0;
 
-    // Create a grid of 512x512 tiles (8x8 = 64 tiles for 4096 atlas)
-    // This gives a good balance between tile count and resolution
-    constexpr u32 defaultTileSize = 512;
-    u32 tilesPerRow = m_AtlasSize / defaultTileSize;
-
-    for (u32 y = 0; y < tilesPerRow; ++y) {
-        for (u32 x = 0; x < tilesPerRow; ++x) {
-            ShadowAtlasTile tile;
-            tile.X = x * defaultTileSize;
-            tile.Y = y * defaultTileSize;
-            tile.Size = defaultTileSize;
-            tile.LightIndex = -1;
-            tile.LastUsedFrame = 0;
-            m_Tiles.push_back(tile);
+    // One free list per power-of-two size, largest first
+    u32 levelCount = 1;
+    for (u32 size = MAX_SHADOW_TILE_SIZE; size > MIN_SHADOW_TILE_SIZE; size /= 2) {
+        ++levelCount;
+    }
+    m_FreeBlocks.assign(levelCount, {});
+
+    // The atlas starts as a grid of maximum-size blocks
+    u32 blocksPerRow = std::max(m_AtlasSize / MAX_SHADOW_TILE_SIZE, 1u);
+    for (u32 y = 0; y < blocksPerRow; ++y) {
+        for (u32 x = 0; x < blocksPerRow; ++x) {
+            m_FreeBlocks[0].push_back(glm::uvec2(x * MAX_SHADOW_TILE_SIZE, y * MAX_SHADOW_TILE_SIZE));
         }
     }
 
-    LOG_CORE_DEBUG("ShadowAtlas initialized with {} tiles ({}x{})",
-                   m_Tiles.size(), defaultTileSize, defaultTileSize);
+    LOG_CORE_DEBUG("ShadowAtlas initialized with {} {}x{} blocks ({} to {} tiles)",
+                   m_FreeBlocks[0].size(), MAX_SHADOW_TILE_SIZE, MAX_SHADOW_TILE_SIZE,
+                   MIN_SHADOW_TILE_SIZE, MAX_SHADOW_TILE_SIZE);
 }
 
 u32 ShadowAtlas::QuantizeTileSize(u32 size) {
-    // Quantize to power of 2: 256, 512, or 1024
-    if (size <= 256) return 256;
-    if (size <= 512) return 512;
-    return 1024;
+    u32 quantized = MIN_SHADOW_TILE_SIZE;
+    while (quantized < size && quantized < MAX_SHADOW_TILE_SIZE) {
+        quantized *= 2;
+    }
+    return quantized;
+}
+
+u32 ShadowAtlas::GetLevel(u32 size) const {
+    u32 level = 0;
+    for (u32 blockSize = MAX_SHADOW_TILE_SIZE; blockSize > size; blockSize /= 2) {
+        ++level;
+    }
+    return level;
+}
+
+bool ShadowAtlas::AllocateBlock(u32 size, u32& outX, u32& outY) {
+    const u32 level = GetLevel(size);
+
+    // Smallest free block that fits
+    i32 source = static_cast<i32>(level);
+    while (source >= 0 && m_FreeBlocks[source].empty()) {
+        --source;
+    }
+    if (source < 0) return false;
+
+    glm::uvec2 block = m_FreeBlocks[source].back();
+    m_FreeBlocks[source].pop_back();
+
+    // Split down to the requested level, keeping the first child each time
+    for (u32 l = static_cast<u32>(source) + 1; l <= level; ++l) {
+        u32 half = MAX_SHADOW_TILE_SIZE >> l;
+        m_FreeBlocks[l].push_back(block + glm::uvec2(half, 0));
+        m_FreeBlocks[l].push_back(block + glm::uvec2(0, half));
+        m_FreeBlocks[l].push_back(block + glm::uvec2(half, half));
+    }
+
+    outX = block.x;
+    outY = block.y;
+    return true;
+}
+
+void ShadowAtlas::FreeBlock(u32 x, u32 y, u32 size) {
+    u32 level = GetLevel(size);
+    glm::uvec2 block(x, y);
+
+    // Merge with the three siblings while they are all free
+    while (level > 0) {
+        u32 parentSize = size * 2;
+        glm::uvec2 parent(block.x / parentSize * parentSize, block.y / parentSize * parentSize);
+
+        auto& freeList = m_FreeBlocks[level];
+        u32 freeSiblings = 0;
+        for (const auto& candidate : freeList) {
+            if (candidate != block &&
+                candidate.x / parentSize * parentSize == parent.x &&
+                candidate.y / parentSize * parentSize == parent.y) {
+                ++freeSiblings;
+            }
+        }
+        if (freeSiblings < 3) break;
+
+        freeList.erase(std::remove_if(freeList.begin(), freeList.end(), [&](const glm::uvec2& candidate) {
+            return candidate.x / parentSize * parentSize == parent.x &&
+                   candidate.y / parentSize * parentSize == parent.y;
+        }), freeList.end());
+
+        block = parent;
+        size = parentSize;
+        --level;
+    }
+
+    m_FreeBlocks[level].push_back(block);
+}
+
+i32 ShadowAtlas::CreateTile(u32 x, u32 y, u32 size, i32 lightIndex) {
+    ShadowAtlasTile tile;
+    tile.X = x;
+    tile.Y = y;
+    tile.Size = size;
+    tile.LightIndex = lightIndex;
+    tile.LastUsedFrame = m_CurrentFrame;
+
+    m_AllocatedArea += size * size;
+
+    // Reuse a released slot so indices of live tiles don't move
+    for (size_t i = 0; i < m_Tiles.size(); ++i) {
+        if (m_Tiles[i].IsFree()) {
+            m_Tiles[i] = tile;
+            return static_cast<i32>(i);
+        }
+    }
+
+    m_Tiles.push_back(tile);
+    return static_cast<i32>(m_Tiles.size() - 1);
 }
 
 i32 ShadowAtlas::AllocateTile(u32 requestedSize, i32 lightIndex) {
     u32 size = QuantizeTileSize(requestedSize);
 
-    i32 tileIndex = FindOrEvictTile(size);
-    if (tileIndex < 0) {
-        LOG_CORE_WARN("ShadowAtlas: Failed to allocate tile for light {}", lightIndex);
-        return -1;
+    i32 existing = FindLightTile(lightIndex);
+    if (existing >= 0) {
+        auto& tile = m_Tiles[existing];
+
+        // Hysteresis around the power-of-two steps, so a light whose screen
+        // size hovers near a boundary doesn't re-render on every flip
+        bool keep = tile.Size == size ||
+                    (requestedSize * 8 > tile.Size * 3 && requestedSize * 4 <= tile.Size * 5);
+        if (keep) {
+            tile.LastUsedFrame = m_CurrentFrame;
+            return existing;
+        }
+
+        FreeTile(existing);
     }
 
-    m_Tiles[tileIndex].LightIndex = lightIndex;
-    m_Tiles[tileIndex].LastUsedFrame = m_CurrentFrame;
+    // Evict stale tiles before settling for a smaller size
+    for (u32 trySize = size; trySize >= MIN_SHADOW_TILE_SIZE; trySize /= 2) {
+        while (true) {
+            u32 x = 0;
+            u32 y = 0;
+            if (AllocateBlock(trySize, x, y)) {
+                return CreateTile(x, y, trySize, lightIndex);
+            }
+
+            i32 lru = FindLRUTile();
+            if (lru < 0) break;
+            FreeTile(lru);
+        }
+    }
 
-    return tileIndex;
+    LOG_CORE_WARN("ShadowAtlas: Failed to allocate tile for light {}", lightIndex);
+    return -1;
 }
 
 void ShadowAtlas::FreeTile(i32 tileIndex) {
     if (tileIndex < 0 || static_cast<size_t>(tileIndex) >= m_Tiles.size()) return;
 
-    m_Tiles[tileIndex].LightIndex = -1;
-    m_Tiles[tileIndex].LastUsedFrame = 0;
-}
+    auto& tile = m_Tiles[tileIndex];
+    if (tile.IsFree()) return;
 
-void ShadowAtlas::FreeAllTiles() {
-    for (auto& tile : m_Tiles) {
-        tile.LightIndex = -1;
-        tile.LastUsedFrame = 0;
-    }
-}
+    FreeBlock(tile.X, tile.Y, tile.Size);
+    m_AllocatedArea -= tile.Size * tile.Size;
 
-i32 ShadowAtlas::FindOrEvictTile(u32 size) {
-    // First try to find a free tile
-    i32 freeIndex = FindFreeTile(size);
-    if (freeIndex >= 0) return freeIndex;
+    tile = ShadowAtlasTile{};
+}
 
-    // No free tiles, try LRU eviction
-    return FindLRUTile(size);
+void ShadowAtlas::FreeAllTiles() {
+    InitializeTiles();
 }
 
-i32 ShadowAtlas::FindFreeTile(u32 size) {
+i32 ShadowAtlas::FindLightTile(i32 lightIndex) const {
     for (size_t i = 0; i < m_Tiles.size(); ++i) {
-        if (m_Tiles[i].IsFree() && m_Tiles[i].Size >= size) {
+        if (!m_Tiles[i].IsFree() && m_Tiles[i].LightIndex == lightIndex) {
             return static_cast<i32>(i);
         }
     }
     return -1;
 }
 
-i32 ShadowAtlas::FindLRUTile(u32 size) {
+i32 ShadowAtlas::FindLRUTile() const {
     i32 lruIndex = -1;
     u32 oldestFrame = m_CurrentFrame;
 
     for (size_t i = 0; i < m_Tiles.size(); ++i) {
-        if (m_Tiles[i].Size >= size && m_Tiles[i].LastUsedFrame < oldestFrame) {
+        if (!m_Tiles[i].IsFree() && m_Tiles[i].LastUsedFrame < oldestFrame) {
             oldestFrame = m_Tiles[i].LastUsedFrame;
             lruIndex = static_cast<i32>(i);
         }
@@ -207,9 +402,52 @@ void ShadowAtlas::BindForTile(i32 tileIndex) {
         return;
     }
 
-    const auto& tile = m_Tiles[tileIndex];
+    BindTileTarget(m_Framebuffer, tileIndex);
+
+    // Update last used frame
+    m_Tiles[tileIndex].LastUsedFrame = m_CurrentFrame;
+}
 
+void ShadowAtlas::BindForAtlas() {
+    auto& state = GLStateCache::Instance();
     glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+    glViewport(0, 0, m_AtlasSize, m_AtlasSize);
+    glDisable(GL_SCISSOR_TEST);
+
+    state.SetDepthTest(true);
+    state.SetDepthFunc(GL_LESS);
+    state.SetDepthWrite(true);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(1.1f, 4.0f);
+}
+
+void ShadowAtlas::BindForStaticTile(i32 tileIndex) {
+    if (tileIndex < 0 || static_cast<size_t>(tileIndex) >= m_Tiles.size() || !m_StaticFramebuffer) {
+        LOG_CORE_ERROR("ShadowAtlas: No static cache for tile {}", tileIndex);
+        return;
+    }
+
+    BindTileTarget(m_StaticFramebuffer, tileIndex);
+}
+
+void ShadowAtlas::RestoreTileFromCache(i32 tileIndex) {
+    if (tileIndex < 0 || static_cast<size_t>(tileIndex) >= m_Tiles.size()) return;
+
+    const auto& tile = m_Tiles[tileIndex];
+    if (!tile.StaticCached || !m_StaticDepthTexture) return;
+
+    glCopyImageSubData(m_StaticDepthTexture, GL_TEXTURE_2D, 0, tile.X, tile.Y, 0,
+                       m_DepthTexture, GL_TEXTURE_2D, 0, tile.X, tile.Y, 0,
+                       tile.Size, tile.Size, 1);
+}
+
+void ShadowAtlas::BindTileTarget(u32 framebuffer, i32 tileIndex) {
+    auto& state = GLStateCache::Instance();
+    const auto& tile = m_Tiles[tileIndex];
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
 
     // Set viewport to tile region
     glViewport(tile.X, tile.Y, tile.Size, tile.Size);
@@ -219,9 +457,9 @@ void ShadowAtlas::BindForTile(i32 tileIndex) {
     glScissor(tile.X, tile.Y, tile.Size, tile.Size);
 
     // Depth settings
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-    glDepthMask(GL_TRUE);
+    state.SetDepthTest(true);
+    state.SetDepthFunc(GL_LESS);
+    state.SetDepthWrite(true);
 
     // Disable color writing
     glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
@@ -229,9 +467,6 @@ void ShadowAtlas::BindForTile(i32 tileIndex) {
     // Polygon offset to reduce shadow acne
     glEnable(GL_POLYGON_OFFSET_FILL);
     glPolygonOffset(1.1f, 4.0f);
-
-    // Update last used frame
-    m_Tiles[tileIndex].LastUsedFrame = m_CurrentFrame;
 }
 
 void ShadowAtlas::Unbind() {
@@ -270,7 +505,7 @@ void ShadowAtlas::ClearTile(i32 tileIndex) {
 }
 
 void ShadowAtlas::BindTexture(u32 slot) const {
-    glBindTextureUnit(slot, m_DepthTexture);
+    GLStateCache::Instance().BindTextureUnit(slot, m_DepthTexture);
 }
 
 void ShadowAtlas::BeginFrame(u32 frameNumber) {
@@ -285,8 +520,8 @@ u32 ShadowAtlas::GetAllocatedTileCount() const {
     return count;
 }
 
-u32 ShadowAtlas::GetFreeTileCount() const {
-    return static_cast<u32>(m_Tiles.size()) - GetAllocatedTileCount();
+f32 ShadowAtlas::GetOccupancy() const {
+    return static_cast<f32>(m_AllocatedArea) / static_cast<f32>(m_AtlasSize * m_AtlasSize);
 }
 
 } // namespace Engine
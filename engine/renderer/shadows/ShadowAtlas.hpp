@@ -7,6 +7,14 @@
 
 namespace Engine {
 
+// ShadowAtlas - one depth texture shared by all shadowed spot lights (and a
+// second one by the cube faces of shadowed point lights).
+//
+// Tiles are power-of-two squares between MIN_SHADOW_TILE_SIZE and
+// MAX_SHADOW_TILE_SIZE handed out by a quadtree (2D buddy) allocator: a
+// block splits into four children on demand and siblings merge back when
+// all four are free. When the atlas is full, tiles not used this frame are
+// evicted in LRU order, after which the request falls back to smaller sizes.
 class ShadowAtlas {
 public:
     explicit ShadowAtlas(u32 atlasSize = DEFAULT_SPOT_SHADOW_ATLAS_SIZE);
@@ -18,7 +26,10 @@ public:
     ShadowAtlas(ShadowAtlas&& other) noexcept;
     ShadowAtlas& operator=(ShadowAtlas&& other) noexcept;
 
-    // Tile allocation
+    // Tile allocation. A light keeps the tile it had last frame, unless the
+    // requested size moved well away from it, so cached contents stay usable.
+    // Lights should be allocated in priority order: later requests may
+    // receive a smaller tile than asked for.
     // Returns tile index, or -1 if allocation failed
     i32 AllocateTile(u32 requestedSize, i32 lightIndex);
     void FreeTile(i32 tileIndex);
@@ -30,10 +41,27 @@ public:
 
     // Rendering
     void BindForTile(i32 tileIndex);
+
+    // Whole atlas as the target, for passes that place geometry into tiles
+    // themselves (point shadow faces)
+    void BindForAtlas();
     void Unbind();
     void Clear();
     void ClearTile(i32 tileIndex);
 
+    // Static caster caching: a second atlas holds each tile's static casters,
+    // copied into the sampled atlas before dynamic casters are drawn
+    void SetCachingEnabled(bool enabled);
+    bool IsCachingEnabled() const { return m_CachingEnabled; }
+    void InvalidateCache();
+    bool IsTileCached(i32 tileIndex, const glm::mat4& viewProjection) const;
+    void MarkTileCached(i32 tileIndex, const glm::mat4& viewProjection);
+
+    // Record what a tile was last rendered with (for throttled updates)
+    void MarkTileRendered(i32 tileIndex, const glm::mat4& viewProjection);
+    void BindForStaticTile(i32 tileIndex);
+    void RestoreTileFromCache(i32 tileIndex);
+
     // Texture binding for sampling
     void BindTexture(u32 slot) const;
     u32 GetTextureID() const { return m_DepthTexture; }
@@ -46,20 +74,30 @@ public:
     // Info
     u32 GetAtlasSize() const { return m_AtlasSize; }
     u32 GetAllocatedTileCount() const;
-    u32 GetFreeTileCount() const;
+    f32 GetOccupancy() const;           // Fraction of the atlas area in use
+
+    // Quantize size to a power of 2 in [MIN_SHADOW_TILE_SIZE, MAX_SHADOW_TILE_SIZE]
+    static u32 QuantizeTileSize(u32 size);
 
 private:
     void CreateResources();
     void DeleteResources();
+    void CreateCacheResources();
+    void DeleteCacheResources();
     void InitializeTiles();
 
-    // Find a free tile of the given size, or evict LRU if needed
-    i32 FindOrEvictTile(u32 size);
-    i32 FindFreeTile(u32 size);
-    i32 FindLRUTile(u32 size);
+    // Quadtree blocks
+    u32 GetLevel(u32 size) const;
+    bool AllocateBlock(u32 size, u32& outX, u32& outY);
+    void FreeBlock(u32 x, u32 y, u32 size);
+    i32 CreateTile(u32 x, u32 y, u32 size, i32 lightIndex);
+    void BindTileTarget(u32 framebuffer, i32 tileIndex);
 
-    // Quantize size to power of 2 (256, 512, 1024)
-    static u32 QuantizeTileSize(u32 size);
+    // Tile already owned by the light, or -1
+    i32 FindLightTile(i32 lightIndex) const;
+
+    // Least recently used tile not touched this frame, or -1
+    i32 FindLRUTile() const;
 
 private:
     u32 m_AtlasSize;
@@ -69,12 +107,19 @@ private:
     u32 m_DepthTexture = 0;
     u32 m_Framebuffer = 0;
 
-    // Tile management
-    // Pre-allocated grid: 4096 / 256 = 16x16 = 256 potential 256x256 tiles
-    // Or 8x8 = 64 potential 512x512 tiles
-    // Or 4x4 = 16 potential 1024x1024 tiles
+    // Static caster cache (only allocated while caching is enabled)
+    u32 m_StaticDepthTexture = 0;
+    u32 m_StaticFramebuffer = 0;
+    bool m_CachingEnabled = false;
+
+    // Tile slots; freed slots (LightIndex -1, Size 0) are reused so tile
+    // indices stay stable while allocated
     Vector<ShadowAtlasTile> m_Tiles;
 
+    // Free quadtree blocks per level, level 0 = MAX_SHADOW_TILE_SIZE
+    Vector<Vector<glm::uvec2>> m_FreeBlocks;
+    u32 m_AllocatedArea = 0;            // In texels
+
     bool m_Initialized = false;
 };
 
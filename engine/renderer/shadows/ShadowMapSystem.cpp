@@ -1,52 +1,185 @@
 #include "renderer/shadows/ShadowMapSystem.hpp"
 #include "ecs/Components/Transform.hpp"
+#include "ecs/Components/TransformSoA.hpp"
 #include "ecs/Components/Renderable.hpp"
 #include "ecs/Components/LightComponents.hpp"
+#include "ecs/Registry.hpp"
 #include "renderer/opengl/GLVertexArray.hpp"
+#include "renderer/opengl/GPUProfiler.hpp"
+#include "renderer/culling/SpatialIndex.hpp"
+#include "renderer/pipeline/GBuffer.hpp"
+#include "renderer/RenderGroups.hpp"
+#include "resources/ResourceManager.hpp"
 #include "core/Logger.hpp"
+#include "core/MemoryTracker.hpp"
+#include "core/Telemetry.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
 
 #include <glad/gl.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+#include <iterator>
+#include <atomic>
 
 namespace Engine {
 
+namespace {
+
+const TelemetryGauge s_ShadowDrawCalls("Shadows.DrawCalls");
+const TelemetryGauge s_SpotShadows("Shadows.SpotRendered");
+const TelemetryGauge s_PointFaces("Shadows.PointFacesRendered");
+const TelemetryGauge s_VirtualPages("Shadows.VirtualPagesRendered");
+
+constexpr UniformHandle CascadeViewProjUniforms[] = {
+    "u_CascadeViewProj[0]", "u_CascadeViewProj[1]", "u_CascadeViewProj[2]", "u_CascadeViewProj[3]"
+};
+static_assert(std::size(CascadeViewProjUniforms) == CSM_CASCADE_COUNT,
+              "Update depth_csm_layered.glsl when changing the cascade count");
+
+bool HasGLExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (extension && std::strcmp(extension, name) == 0) return true;
+    }
+    return false;
+}
+
+// Fraction of the screen height covered by a sphere, 1 when the camera is inside it
+f32 ProjectedCoverage(const Camera& camera, const glm::vec3& center, f32 radius) {
+    f32 distance = glm::length(center - camera.GetPosition());
+    if (distance <= radius) return 1.0f;
+
+    const glm::mat4& proj = camera.GetProjectionMatrix();
+    return std::min(radius * proj[1][1] / distance, 1.0f);
+}
+
+// Brightness factor applied to screen coverage when ranking shadowed lights
+f32 LightImportance(const glm::vec3& color, f32 intensity) {
+    f32 brightness = intensity * std::max({color.r, color.g, color.b});
+    return std::clamp(brightness, 0.5f, 2.0f);
+}
+
+// Shadows fade in between MinShadowCoverage and twice it
+f32 ShadowStrength(f32 priority, f32 minCoverage) {
+    if (minCoverage <= 0.0f) return 1.0f;
+    return std::clamp(priority / minCoverage - 1.0f, 0.0f, 1.0f);
+}
+
+template<typename Candidate>
+void KeepHighestPriority(Vector<Candidate>& candidates, usize maxCount) {
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) { return a.Priority > b.Priority; });
+
+    if (candidates.size() > maxCount) {
+        candidates.resize(maxCount);
+    }
+}
+
+// Cube face order +X, -X, +Y, -Y, +Z, -Z (the shadow lookup picks the face
+// from the major axis in the same order)
+const glm::vec3 CubeFaceDirections[POINT_SHADOW_FACE_COUNT] = {
+    {1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f},
+    {0.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f},
+    {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}
+};
+const glm::vec3 CubeFaceUps[POINT_SHADOW_FACE_COUNT] = {
+    {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f},
+    {0.0f, 0.0f, 1.0f},  {0.0f, 0.0f, -1.0f},
+    {0.0f, -1.0f, 0.0f}, {0.0f, -1.0f, 0.0f}
+};
+
+} // anonymous namespace
+
 ShadowMapSystem::ShadowMapSystem() {
     m_ShadowCasters.reserve(1000);
     m_SpotShadowData.reserve(MAX_SHADOW_CASTING_SPOT);
+    m_PointShadowData.reserve(MAX_SHADOW_CASTING_POINT);
+    m_PointFaces.reserve(MAX_SHADOW_CASTING_POINT * POINT_SHADOW_FACE_COUNT);
 }
 
-ShadowMapSystem::~ShadowMapSystem() {
-    if (m_ShadowDataUBO) {
-        glDeleteBuffers(1, &m_ShadowDataUBO);
-        m_ShadowDataUBO = 0;
-    }
-}
+ShadowMapSystem::~ShadowMapSystem() = default;
 
 void ShadowMapSystem::OnCreate(entt::registry& registry) {
-    (void)registry;
+    registry.on_construct<StaticGeometry>().connect<&ShadowMapSystem::OnStaticCastersChanged>(this);
+    registry.on_destroy<StaticGeometry>().connect<&ShadowMapSystem::OnStaticCastersChanged>(this);
+    m_Connected = true;
+
+    RenderableGroup(registry);
+    PointLightGroup(registry);
+    SpotLightGroup(registry);
 
     m_CSM = CreateScope<CascadedShadowMap>(m_Settings.CascadeResolution);
     m_SpotAtlas = CreateScope<ShadowAtlas>(m_Settings.SpotShadowAtlasSize);
+    m_PointAtlas = CreateScope<ShadowAtlas>(m_Settings.PointShadowAtlasSize);
 
     LoadShaders();
     CreateUBOs();
 
+    m_CascadeBatcher = CreateScope<IndirectDrawBatcher>(1024);
+    m_PointBatcher = CreateScope<IndirectDrawBatcher>(1024);
+
     m_Initialized = true;
 
-    LOG_CORE_INFO("ShadowMapSystem initialized (CSM {}x{}, {} cascades, SpotAtlas {}x{})",
+    LOG_CORE_INFO("ShadowMapSystem initialized (CSM {}x{}, {} cascades, SpotAtlas {}x{}, PointAtlas {}x{})",
                    m_Settings.CascadeResolution, m_Settings.CascadeResolution,
-                   CSM_CASCADE_COUNT, m_Settings.SpotShadowAtlasSize, m_Settings.SpotShadowAtlasSize);
+                   CSM_CASCADE_COUNT, m_Settings.SpotShadowAtlasSize, m_Settings.SpotShadowAtlasSize,
+                   m_Settings.PointShadowAtlasSize, m_Settings.PointShadowAtlasSize);
 }
 
 void ShadowMapSystem::OnDestroy(entt::registry& registry) {
-    (void)registry;
+    if (m_Connected) {
+        registry.on_construct<StaticGeometry>().disconnect<&ShadowMapSystem::OnStaticCastersChanged>(this);
+        registry.on_destroy<StaticGeometry>().disconnect<&ShadowMapSystem::OnStaticCastersChanged>(this);
+        m_Connected = false;
+    }
     m_Initialized = false;
 }
 
+void ShadowMapSystem::OnStaticCastersChanged(entt::registry& registry, entt::entity entity) {
+    (void)registry;
+    (void)entity;
+    m_CacheDirty = true;
+    m_CastersDirty = true;      // IsStatic of a cached caster
+    m_VSMCastersSeeded = false; // Tracked as dynamic or not
+}
+
+void ShadowMapSystem::UpdateCacheState() {
+    m_CSM->SetCachingEnabled(m_Settings.CacheStaticShadows);
+    m_SpotAtlas->SetCachingEnabled(m_Settings.CacheStaticShadows);
+
+    // The static tree is rebuilt whenever static geometry is added, removed
+    // or its bounds are invalidated, so its rebuild count doubles as a revision
+    u32 staticRevision = m_SpatialIndex ? m_SpatialIndex->GetStats().StaticRebuilds : 0;
+
+    if (m_CacheDirty || staticRevision != m_StaticRevision) {
+        m_CSM->InvalidateCache();
+        m_SpotAtlas->InvalidateCache();
+        if (m_VSM) {
+            m_VSM->InvalidateAll();
+        }
+        m_StaticRevision = staticRevision;
+        m_CacheDirty = false;
+    }
+}
+
 void ShadowMapSystem::OnUpdate(entt::registry& registry, f32 deltaTime) {
+    MEMORY_TAG(Shadows);
     (void)deltaTime;
 
-    if (!m_Initialized || !m_Camera || !m_Settings.Enabled) return;
+    if (!m_Initialized || !m_Camera || !m_Settings.Enabled) {
+        // The changes of this frame are dropped with it
+        m_CastersDirty = true;
+        m_VSMCastersSeeded = false;
+        m_VSMRendered = false;
+        if (m_CSM) {
+            m_CSM->InvalidateSchedule();
+        }
+        return;
+    }
 
     m_Stats = {};
     m_FrameNumber++;
@@ -55,49 +188,250 @@ void ShadowMapSystem::OnUpdate(entt::registry& registry, f32 deltaTime) {
     if (m_SpotAtlas) {
         m_SpotAtlas->BeginFrame(m_FrameNumber);
     }
+    if (m_PointAtlas) {
+        m_PointAtlas->BeginFrame(m_FrameNumber);
+    }
+
+    // Fresh ring region every frame: the lighting pass of earlier frames may
+    // still be reading the previous ones
+    m_ShadowDataRing->BeginFrame();
+
+    UpdateVirtualShadowMap();
+    UpdateMomentMaps();
+    UpdateCacheState();
+
+    GPU_PROFILE_SCOPE("Shadows");
 
     // Gather all shadow-casting entities
     GatherShadowCasters(registry);
 
     // Render directional light shadows (CSM)
-    RenderDirectionalShadows(registry);
+    {
+        GPU_PROFILE_SCOPE_STATS("Shadow Cascades");
+        RenderDirectionalShadows(registry);
+    }
 
     // Render spot light shadows
-    RenderSpotShadows(registry);
+    {
+        GPU_PROFILE_SCOPE_STATS("Spot Shadow Atlas");
+        RenderSpotShadows(registry);
+    }
+
+    // Render point light shadows (all cube faces in one pass)
+    {
+        GPU_PROFILE_SCOPE_STATS("Point Shadow Atlas");
+        RenderPointShadows(registry);
+    }
+
+    // Prefilter the maps for EVSM lookups
+    if (m_Moments) {
+        GPU_PROFILE_SCOPE_STATS("Shadow Moments");
+        FilterShadowMoments();
+    }
 
     // Upload shadow data to GPU
     UploadShadowData();
+
+    s_ShadowDrawCalls.Set(m_Stats.ShadowDrawCalls);
+    s_SpotShadows.Set(m_Stats.SpotShadowsRendered);
+    s_PointFaces.Set(m_Stats.PointFacesRendered);
+    s_VirtualPages.Set(m_Stats.VirtualPagesRendered);
 }
 
 void ShadowMapSystem::OnReload() {
     LoadShaders();
+    if (m_VSM) {
+        m_VSM->Reload();
+    }
+    if (m_Moments) {
+        m_Moments->Reload();
+    }
     LOG_CORE_INFO("Shadow shaders reloaded");
 }
 
 void ShadowMapSystem::GatherShadowCasters(entt::registry& registry) {
+    // Casters are looked up per cascade / light through the index instead
+    if (m_SpatialIndex) {
+        m_ShadowCasters.clear();
+        m_CastersDirty = true;
+        return;
+    }
+
+    if (!m_CastersDirty && PatchShadowCasters(registry)) return;
+    RebuildShadowCasters(registry);
+}
+
+void ShadowMapSystem::RebuildShadowCasters(entt::registry& registry) {
     m_ShadowCasters.clear();
 
-    auto view = registry.view<Transform, MeshComponent, Renderable>();
-    for (auto entity : view) {
-        auto& renderable = view.get<Renderable>(entity);
+    const auto& statics = registry.storage<StaticGeometry>();
+    const ResourceManager& resources = ResourceManager::Instance();
+    std::atomic<u32> pending{0};
+
+    ParallelGather(RenderableGroup(registry), m_ShadowCasters,
+        [&statics, &resources, &pending](FrameVector<ShadowCasterInfo>& out, entt::entity entity,
+           const MeshComponent& meshComponent, const Renderable& renderable, const Transform& transform) {
+            // Only gather entities that cast shadows and are visible
+            if (!renderable.CastShadows || !renderable.Visible) return;
+            const Mesh* mesh = resources.GetMesh(meshComponent.Mesh);
+            if (mesh) resources.RequestMesh(*mesh);
+            if (!mesh || !mesh->IsUploaded()) {
+                pending.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            ShadowCasterInfo info;
+            info.Entity = entity;
+            info.WorldMatrix = transform.WorldMatrix;
+            info.WorldBounds = renderable.WorldBounds;
+            info.Handle = meshComponent.Mesh;
+            info.Geometry = mesh;
+            info.MeshId = meshComponent.MeshId;
+            info.IndexCount = mesh->GetIndexCount();
+            info.IsStatic = statics.contains(entity);
+
+            out.push_back(info);
+        });
+
+    m_CasterSlots.assign(m_CasterSlots.size(), INVALID_CASTER);
+    for (u32 i = 0; i < static_cast<u32>(m_ShadowCasters.size()); ++i) {
+        const usize slot = static_cast<usize>(entt::to_entity(m_ShadowCasters[i].Entity));
+        if (slot >= m_CasterSlots.size()) {
+            m_CasterSlots.resize(slot + 1, INVALID_CASTER);
+        }
+        m_CasterSlots[slot] = i;
+    }
+
+    // A mesh finishing its upload raises no signal: gather again next frame
+    m_CastersDirty = pending.load(std::memory_order_relaxed) > 0;
+}
+
+bool ShadowMapSystem::PatchShadowCasters(entt::registry& registry) {
+    const ChangeSet* sets[] = {&Changes<Transform>(), &Changes<MeshComponent>(), &Changes<Renderable>()};
+
+    usize changed = 0;
+    for (const ChangeSet* set : sets) {
+        // Removals reorder the list; rebuilding is simpler than patching it
+        if (!set->GetRemoved().empty()) return false;
+        changed += set->GetChanged().size();
+    }
+    // Past this the parallel gather beats per-entity lookups
+    if (changed > m_ShadowCasters.size() / 2) return false;
+
+    // Meshes may have been reloaded or unloaded since the last frame
+    if (!ResolveCasterMeshes()) return false;
+
+    for (const ChangeSet* set : sets) {
+        for (entt::entity entity : set->GetChanged()) {
+            if (!PatchShadowCaster(registry, entity)) return false;
+        }
+    }
+    return true;
+}
+
+bool ShadowMapSystem::PatchShadowCaster(entt::registry& registry, entt::entity entity) {
+    const usize slot = static_cast<usize>(entt::to_entity(entity));
+    const u32 index = slot < m_CasterSlots.size() ? m_CasterSlots[slot] : INVALID_CASTER;
+    const bool cached = index != INVALID_CASTER && m_ShadowCasters[index].Entity == entity;
+
+    const Mesh* mesh = nullptr;
+    const auto* transform = registry.valid(entity) ? registry.try_get<Transform>(entity) : nullptr;
+    const auto* meshComponent = transform ? registry.try_get<MeshComponent>(entity) : nullptr;
+    const auto* renderable = meshComponent ? registry.try_get<Renderable>(entity) : nullptr;
+    if (renderable && renderable->CastShadows && renderable->Visible) {
+        mesh = ResourceManager::Instance().GetMesh(meshComponent->Mesh);
+        if (mesh && !mesh->IsUploaded()) mesh = nullptr;
+    }
 
-        // Only gather entities that cast shadows and are visible
-        if (!renderable.CastShadows || !renderable.Visible) continue;
+    // Became or stopped being a caster: the list changes shape
+    if ((mesh != nullptr) != cached) return false;
+    if (!mesh) return true;
+
+    ShadowCasterInfo& info = m_ShadowCasters[index];
+    info.WorldMatrix = transform->WorldMatrix;
+    info.WorldBounds = renderable->WorldBounds;
+    info.Handle = meshComponent->Mesh;
+    info.Geometry = mesh;
+    info.MeshId = meshComponent->MeshId;
+    info.IndexCount = mesh->GetIndexCount();
+    return true;
+}
 
-        auto& transform = view.get<Transform>(entity);
-        auto& mesh = view.get<MeshComponent>(entity);
+bool ShadowMapSystem::ResolveCasterMeshes() {
+    const ResourceManager& resources = ResourceManager::Instance();
+    for (auto& caster : m_ShadowCasters) {
+        const Mesh* mesh = resources.GetMesh(caster.Handle);
+        if (mesh) resources.RequestMesh(*mesh);
+        if (!mesh || !mesh->IsUploaded()) return false;
+        caster.Geometry = mesh;
+        caster.IndexCount = mesh->GetIndexCount();
+    }
+    return true;
+}
 
-        if (!mesh.VAO) continue;
+bool ShadowMapSystem::HasShadowCasters() const {
+    if (m_SpatialIndex) {
+        const auto& stats = m_SpatialIndex->GetStats();
+        return stats.StaticItems + stats.DynamicItems > 0;
+    }
+    return !m_ShadowCasters.empty();
+}
 
-        ShadowCasterInfo info;
-        info.Entity = entity;
-        info.WorldMatrix = transform.WorldMatrix;
-        info.WorldBounds = renderable.WorldBounds;
-        info.MeshId = mesh.MeshId;
-        info.IndexCount = mesh.IndexCount;
+template<typename Func>
+void ShadowMapSystem::ForEachCaster(entt::registry& registry, const Frustum& frustum, CasterSet set, Func&& func) {
+    const bool subtrees = m_CasterSubtrees.Classify(registry, frustum);
 
-        m_ShadowCasters.push_back(info);
+    if (!m_SpatialIndex) {
+        for (const auto& caster : m_ShadowCasters) {
+            if (set == CasterSet::Static && !caster.IsStatic) continue;
+            if (set == CasterSet::Dynamic && caster.IsStatic) continue;
+
+            const Frustum::Containment settled = subtrees ? m_CasterSubtrees.Get(caster.Entity)
+                                                          : Frustum::Containment::Intersects;
+            if (settled == Frustum::Containment::Outside) continue;
+            if (settled == Frustum::Containment::Intersects && !frustum.IsBoxVisible(caster.WorldBounds)) continue;
+            func(caster.WorldMatrix, *caster.Geometry, caster.MeshId);
+        }
+        return;
     }
+
+    const ResourceManager& resources = ResourceManager::Instance();
+    auto visit = [&](entt::entity entity, bool fullyInside) {
+        if (!registry.valid(entity)) return;
+        if (!fullyInside && subtrees && m_CasterSubtrees.Get(entity) == Frustum::Containment::Outside) return;
+
+        auto* renderable = registry.try_get<Renderable>(entity);
+        auto* meshComponent = registry.try_get<MeshComponent>(entity);
+        if (!renderable || !meshComponent) return;
+        if (!renderable->CastShadows || !renderable->Visible) return;
+
+        const Mesh* mesh = resources.GetMesh(meshComponent->Mesh);
+        if (!mesh || !mesh->IsUploaded()) return;
+
+        const glm::mat4* world = TransformLayout::TryGetWorldMatrix(registry, entity);
+        if (!world) return;
+
+        func(*world, *mesh, meshComponent->MeshId);
+    };
+
+    // The static tree holds exactly the StaticGeometry entities
+    if (set != CasterSet::Dynamic) m_SpatialIndex->QueryStaticFrustum(frustum, visit);
+    if (set != CasterSet::Static) m_SpatialIndex->QueryDynamicFrustum(frustum, visit);
+}
+
+u32 ShadowMapSystem::DrawCasters(entt::registry& registry, Shader& shader, const Frustum& frustum, CasterSet set) {
+    u32 count = 0;
+    ForEachCaster(registry, frustum, set, [&](const glm::mat4& world, const Mesh& mesh, u32) {
+        shader.SetMat4("u_Model", mesh.GetDrawTransform(world));
+        mesh.GetDepthPassVertexArray()->Bind();
+        PipelineWarmup::RecordDraw(GL_TRIANGLES);
+        glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(mesh.GetIndexCount()), GL_UNSIGNED_INT,
+                                 reinterpret_cast<const void*>(static_cast<usize>(mesh.GetBaseIndex()) * sizeof(u32)),
+                                 static_cast<GLint>(mesh.GetBaseVertex()));
+        count++;
+    });
+    m_Stats.ShadowDrawCalls += count;
+    return count;
 }
 
 void ShadowMapSystem::RenderDirectionalShadows(entt::registry& registry) {
@@ -128,14 +462,20 @@ void ShadowMapSystem::RenderDirectionalShadows(entt::registry& registry) {
         break;
     }
 
-    if (!foundLight || m_ShadowCasters.empty()) {
+    if (!foundLight || !HasShadowCasters()) {
         // No shadow casting light or no shadow casters
         // Still update CSM with dummy data to avoid stale shadows
         m_CSMData.ShadowParams.w = 0.0f;  // Disabled
+        m_CSM->InvalidateSchedule();
+        m_CascadesRendered = false;
+        m_VSMRendered = false;
+        m_VSMCastersSeeded = false;
         return;
     }
 
     // Update cascade matrices based on camera and light direction
+    m_CSM->SetStableCascades(m_Settings.StableCascades);
+    m_CSM->SetUpdateIntervals(m_Settings.CascadeUpdateIntervals);
     m_CSM->Update(*m_Camera,
                   m_CurrentLightDirection,
                   m_Settings.MaxShadowDistance,
@@ -144,60 +484,348 @@ void ShadowMapSystem::RenderDirectionalShadows(entt::registry& registry) {
     // Render each cascade
     m_DepthShader->Bind();
 
+    const bool caching = m_CSM->IsCachingEnabled();
+    const bool singlePass = m_Settings.SinglePassCascades && m_LayeredDepthShader;
+
+    // Drawn every frame: dynamic casters over the cached layer, or everything
+    const CasterSet frameSet = caching ? CasterSet::Dynamic : CasterSet::All;
+
     for (u32 cascade = 0; cascade < CSM_CASCADE_COUNT; ++cascade) {
+        // Off-schedule cascades are sampled from their last render
+        if (!m_CSM->IsCascadeDue(cascade)) {
+            m_Stats.ScheduledOutCascades++;
+            continue;
+        }
+
         const auto& cascadeInfo = m_CSM->GetCascadeInfo(cascade);
 
+        m_DepthShader->SetMat4("u_LightViewProj", cascadeInfo.ViewProjectionMatrix);
+
+        if (caching) {
+            // Static casters only when the cascade's projection changed
+            if (m_CSM->IsCascadeCached(cascade)) {
+                m_Stats.CachedCascades++;
+            } else {
+                m_CSM->BindForStaticCascade(cascade);
+                glClear(GL_DEPTH_BUFFER_BIT);
+                m_Stats.ShadowCastersRendered += DrawCasters(registry, *m_DepthShader, cascadeInfo.CasterFrustum, CasterSet::Static);
+                m_CSM->MarkCascadeCached(cascade);
+            }
+
+            // Dynamic casters go on top of a copy of the static layer
+            m_CSM->RestoreCascadeFromCache(cascade);
+        }
+
+        m_Stats.CascadesRendered++;
+        if (singlePass) continue;
+
         m_CSM->BindForCascade(cascade);
 
         // Clear the cascade depth buffer
-        glClear(GL_DEPTH_BUFFER_BIT);
+        if (!caching) {
+            glClear(GL_DEPTH_BUFFER_BIT);
+        }
 
-        m_DepthShader->SetMat4("u_LightViewProj", cascadeInfo.ViewProjectionMatrix);
+        // Render all shadow casters inside this cascade's extruded volume
+        m_Stats.ShadowCastersRendered += DrawCasters(registry, *m_DepthShader, cascadeInfo.CasterFrustum, frameSet);
+    }
 
-        // Render all shadow casters that intersect this cascade's frustum
-        for (const auto& caster : m_ShadowCasters) {
-            // Frustum cull against cascade bounds
-            if (!cascadeInfo.WorldBounds.Intersects(caster.WorldBounds)) continue;
+    if (singlePass && m_CSM->GetDueCascadeCount() > 0) {
+        RenderCascadesSinglePass(registry, frameSet, !caching);
+    }
 
-            m_DepthShader->SetMat4("u_Model", caster.WorldMatrix);
+    m_CSM->Unbind();
+    m_CascadesRendered = true;
 
-            // Get mesh VAO from registry
-            auto& mesh = registry.get<MeshComponent>(caster.Entity);
-            mesh.VAO->Bind();
-            glDrawElements(GL_TRIANGLES, mesh.IndexCount, GL_UNSIGNED_INT, nullptr);
+    RenderVirtualShadowPages(registry);
+}
 
-            m_Stats.ShadowCastersRendered++;
+void ShadowMapSystem::UpdateVirtualShadowMap() {
+    if (!m_Settings.UseVirtualShadowMap) {
+        if (m_VSM) {
+            m_VSM.reset();
+            LOG_CORE_INFO("Virtual shadow map released");
         }
+        m_VSMRendered = false;
+        return;
+    }
 
-        m_Stats.CascadesRendered++;
+    if (!m_VSMSupportChecked) {
+        m_VSMSupported = VirtualShadowMap::IsSupported();
+        m_VSMSupportChecked = true;
+        if (!m_VSMSupported) {
+            LOG_CORE_WARN("Virtual shadow map needs GL_ARB_sparse_texture with {}^2 depth textures, using cascades",
+                          VSM_VIRTUAL_RESOLUTION);
+        }
     }
+    if (!m_VSMSupported) return;
 
-    m_CSM->Unbind();
+    if (!m_VSM) {
+        m_VSM = CreateScope<VirtualShadowMap>();
+        m_VSMCastersSeeded = false;
+    }
+    m_VSM->SetPageBudget(m_Settings.VirtualShadowPageBudget);
+    m_VSM->SetPagesPerFrame(m_Settings.VirtualShadowPagesPerFrame);
 }
 
-void ShadowMapSystem::RenderSpotShadows(entt::registry& registry) {
-    if (!m_SpotAtlas || m_ShadowCasters.empty()) return;
+void ShadowMapSystem::UpdateMomentMaps() {
+    if (m_Settings.Filter != ShadowFilter::EVSM) {
+        if (m_Moments) {
+            m_Moments.reset();
+            LOG_CORE_INFO("Shadow moment maps released");
+        }
+        return;
+    }
 
+    if (!m_Moments) {
+        m_Moments = CreateScope<ShadowMomentMaps>();
+    }
+    m_Moments->SetFilter(m_Settings.EVSMPositiveExponent, m_Settings.EVSMNegativeExponent, m_Settings.EVSMBlurRadius);
+}
+
+void ShadowMapSystem::FilterShadowMoments() {
+    // After the passes, which may have resized the cascades; new storage
+    // holds nothing yet, so everything in use is filtered again
+    const bool reallocated = m_Moments->Resize(m_CSM->GetResolution(), m_SpotAtlas->GetAtlasSize(),
+                                               m_PointAtlas->GetAtlasSize());
+
+    if (m_CascadesRendered) {
+        for (u32 cascade = 0; cascade < CSM_CASCADE_COUNT; ++cascade) {
+            if (reallocated || m_CSM->IsCascadeDue(cascade)) {
+                m_Moments->FilterCascade(m_CSM->GetTextureID(), cascade);
+            }
+        }
+    }
+
+    if (reallocated) {
+        for (u32 slot = 0; slot < m_SpotShadowCount; ++slot) {
+            m_Moments->FilterSpotTile(m_SpotAtlas->GetTextureID(), m_SpotShadowData[slot].AtlasScaleOffset);
+        }
+    } else {
+        for (const glm::vec4& scaleOffset : m_RenderedSpotTiles) {
+            m_Moments->FilterSpotTile(m_SpotAtlas->GetTextureID(), scaleOffset);
+        }
+    }
+
+    // Point faces are all drawn every frame
+    for (const GPUPointShadowFace& face : m_PointFaces) {
+        m_Moments->FilterPointTile(m_PointAtlas->GetTextureID(), face.AtlasScaleOffset);
+    }
+
+    m_Stats.MomentRegionsFiltered = m_Moments->GetFilteredRegionCount();
+    m_Moments->Finish();
+}
+
+void ShadowMapSystem::TrackVirtualShadowCasters(entt::registry& registry) {
+    const auto& statics = registry.storage<StaticGeometry>();
+
+    // Static casters invalidate everything through UpdateCacheState(); only
+    // dynamic ones are followed page by page
+    if (!m_VSMCastersSeeded) {
+        m_VSM->ClearCasters();
+        for (auto [entity, meshComponent, renderable, transform] : RenderableGroup(registry).each()) {
+            (void)meshComponent;
+            (void)transform;
+            if (renderable.CastShadows && renderable.Visible && !statics.contains(entity)) {
+                m_VSM->TrackCaster(entity, renderable.WorldBounds);
+            }
+        }
+        m_VSM->InvalidateAll();
+        m_VSMCastersSeeded = true;
+        return;
+    }
+
+    const ChangeSet* sets[] = {&Changes<Transform>(), &Changes<MeshComponent>(), &Changes<Renderable>()};
+    for (const ChangeSet* set : sets) {
+        for (entt::entity entity : set->GetRemoved()) {
+            m_VSM->ForgetCaster(entity);
+        }
+        for (entt::entity entity : set->GetChanged()) {
+            const auto* renderable = registry.valid(entity) ? registry.try_get<Renderable>(entity) : nullptr;
+            if (renderable && renderable->CastShadows && renderable->Visible && !statics.contains(entity)) {
+                m_VSM->TrackCaster(entity, renderable->WorldBounds);
+            } else {
+                m_VSM->ForgetCaster(entity);
+            }
+        }
+    }
+}
+
+void ShadowMapSystem::RenderVirtualShadowPages(entt::registry& registry) {
+    m_VSMRendered = false;
+    if (!m_VSM || !m_VSM->IsValid()) return;
+
+    GPU_PROFILE_SCOPE_STATS("Virtual Shadow Pages");
+
+    m_VSM->BeginFrame(*m_Camera, m_CurrentLightDirection, m_Settings.VirtualShadowDistance);
+    TrackVirtualShadowCasters(registry);
+
+    const auto& rects = m_VSM->CollectDirtyRects();
+    if (!rects.empty()) {
+        m_DepthShader->Bind();
+
+        for (const auto& rect : rects) {
+            const glm::mat4 rectViewProj = m_VSM->GetRectViewProjection(rect);
+
+            // Extruded towards the light like the cascades: casters in front
+            // of the window are clamped onto its near plane
+            Frustum rectFrustum;
+            rectFrustum.ExtractPlanes(rectViewProj);
+            rectFrustum.DisablePlane(Frustum::Near);
+
+            m_VSM->BindForRect(rect);
+            m_DepthShader->SetMat4("u_LightViewProj", rectViewProj);
+            m_Stats.VirtualCastersRendered += DrawCasters(registry, *m_DepthShader, rectFrustum, CasterSet::All);
+        }
+
+        m_VSM->Unbind();
+        m_VSM->MarkRendered();
+    }
+
+    m_Stats.VirtualPagesRendered = m_VSM->GetStats().PagesRendered;
+    m_VSMRendered = true;
+}
+
+void ShadowMapSystem::AnalyzeVisibleSurfaces(const GBuffer& gbuffer, const glm::mat4& viewProjection) {
+    if (!m_VSMRendered) return;
+
+    GPU_PROFILE_SCOPE_STATS("Virtual Shadow Requests");
+
+    // Pages under the whole PCF kernel of every lookup
+    m_VSM->MarkRequiredPages(gbuffer, viewProjection, m_CurrentShadowSoftness + 1.0f);
+}
+
+void ShadowMapSystem::RenderCascadesSinglePass(entt::registry& registry, CasterSet set, bool clear) {
+    // One instance per (caster, cascade) pair; the cascade index rides in
+    // InstanceData::Flags and picks both the matrix and gl_Layer
+    m_CascadeDrawItems.clear();
+
+    for (u32 cascade = 0; cascade < CSM_CASCADE_COUNT; ++cascade) {
+        if (!m_CSM->IsCascadeDue(cascade)) continue;
+
+        const auto& cascadeInfo = m_CSM->GetCascadeInfo(cascade);
+
+        ForEachCaster(registry, cascadeInfo.CasterFrustum, set, [&](const glm::mat4& world, const Mesh& mesh, u32 meshId) {
+            IndirectDrawBatcher::DrawItem item;
+            item.VAO = mesh.GetDepthPassVertexArray();
+            item.IndexCount = mesh.GetIndexCount();
+            item.BaseVertex = mesh.GetBaseVertex();
+            item.BaseIndex = mesh.GetBaseIndex();
+            item.MeshId = meshId;
+            item.Instance.Transform = mesh.GetDrawTransform(world);
+            item.Instance.Flags = cascade;
+            m_CascadeDrawItems.push_back(item);
+        });
+    }
+
+    m_CascadeBatcher->Prepare(m_CascadeDrawItems);
+
+    m_CSM->BindForAllCascades();
+
+    // Clears every layer of the layered attachment, unless some keep the
+    // render of an earlier frame
+    if (clear) {
+        if (m_CSM->GetDueCascadeCount() == CSM_CASCADE_COUNT) {
+            glClear(GL_DEPTH_BUFFER_BIT);
+        } else {
+            for (u32 cascade = 0; cascade < CSM_CASCADE_COUNT; ++cascade) {
+                if (m_CSM->IsCascadeDue(cascade)) {
+                    m_CSM->ClearCascade(cascade);
+                }
+            }
+        }
+    }
+
+    m_LayeredDepthShader->Bind();
+    for (u32 cascade = 0; cascade < CSM_CASCADE_COUNT; ++cascade) {
+        m_LayeredDepthShader->SetMat4(CascadeViewProjUniforms[cascade], m_CSM->GetCascadeInfo(cascade).ViewProjectionMatrix);
+    }
+
+    m_CascadeBatcher->Draw();
+
+    m_Stats.ShadowCastersRendered += m_CascadeBatcher->GetStats().Instances;
+    m_Stats.ShadowDrawCalls += m_CascadeBatcher->GetStats().DrawCalls;
+}
+
+void ShadowMapSystem::RankSpotLights(entt::registry& registry) {
+    m_SpotCandidates.clear();
+
+    const Frustum& cameraFrustum = m_Camera->GetFrustum();
+
+    for (auto [entity, light, transform] : SpotLightGroup(registry).each()) {
+
+        if (!light.Enabled || !light.CastShadows) continue;
+
+        // Bounding sphere of the cone: apex plus the disc at full range
+        glm::vec3 lightDir = glm::normalize(light.Direction);
+        glm::vec3 center = transform.GetWorldPosition() + lightDir * (light.Range * 0.5f);
+        f32 capRadius = light.Range * std::tan(light.OuterCutOff);
+        f32 radius = std::sqrt(0.25f * light.Range * light.Range + capRadius * capRadius);
+
+        // Lights whose cone is off screen can't cast a visible shadow
+        if (!cameraFrustum.IsSphereVisible(center, radius)) continue;
+
+        f32 importance = LightImportance(light.Color, light.Intensity);
+        f32 priority = ProjectedCoverage(*m_Camera, center, radius) * importance;
+        if (priority <= m_Settings.MinShadowCoverage) continue;
+
+        m_SpotCandidates.push_back({entity, priority});
+    }
+
+    KeepHighestPriority(m_SpotCandidates, std::min<usize>(m_Settings.MaxShadowedSpotLights, MAX_SHADOW_CASTING_SPOT));
+}
+
+void ShadowMapSystem::RenderSpotShadows(entt::registry& registry) {
     m_SpotShadowData.clear();
+    m_ShadowedSpotLights.clear();
+    m_RenderedSpotTiles.clear();
     m_SpotShadowCount = 0;
 
-    // Find all shadow-casting spot lights
-    auto spotView = registry.view<Transform, SpotLightComponent>();
+    if (!m_SpotAtlas || !HasShadowCasters()) return;
 
-    m_SpotDepthShader->Bind();
+    // Highest priority first, so they get the atlas space they ask for
+    RankSpotLights(registry);
 
-    for (auto entity : spotView) {
-        if (m_SpotShadowCount >= MAX_SHADOW_CASTING_SPOT) break;
+    m_SpotDepthShader->Bind();
 
-        auto& transform = spotView.get<Transform>(entity);
-        auto& light = spotView.get<SpotLightComponent>(entity);
+    const u32 throttleInterval = std::max(m_Settings.SpotShadowThrottleInterval, 1u);
 
-        if (!light.Enabled || !light.CastShadows) continue;
+    for (const auto& candidate : m_SpotCandidates) {
+        entt::entity entity = candidate.Entity;
+        auto& transform = registry.get<Transform>(entity);
+        auto& light = registry.get<SpotLightComponent>(entity);
 
-        // Allocate tile in atlas
-        i32 tileIndex = m_SpotAtlas->AllocateTile(512, static_cast<i32>(m_SpotShadowCount));
+        // Tile size follows screen coverage; keyed by entity so the light keeps its tile
+        u32 lightId = entt::to_entity(entity);
+        u32 requestedSize = static_cast<u32>(candidate.Priority * m_Settings.SpotShadowResolutionScale *
+                                             static_cast<f32>(MAX_SHADOW_TILE_SIZE));
+        i32 tileIndex = m_SpotAtlas->AllocateTile(requestedSize, static_cast<i32>(lightId));
         if (tileIndex < 0) continue;
 
+        const ShadowAtlasTile& tile = m_SpotAtlas->GetTile(tileIndex);
+
+        // Store GPU data
+        GPUSpotShadowData gpuData;
+        gpuData.AtlasScaleOffset = m_SpotAtlas->GetTileScaleOffset(tileIndex);
+        gpuData.ShadowParams = glm::vec4(0.001f, 0.01f, 1.0f,
+                                         ShadowStrength(candidate.Priority, m_Settings.MinShadowCoverage));
+
+        // Lights that only rate the smallest tile refresh every few frames,
+        // staggered by entity so they don't all land on the same frame
+        bool throttled = tile.Size <= MIN_SHADOW_TILE_SIZE && throttleInterval > 1 &&
+                         tile.LastRenderedFrame != 0 &&
+                         m_FrameNumber - tile.LastRenderedFrame < throttleInterval &&
+                         (m_FrameNumber + lightId) % throttleInterval != 0;
+        if (throttled) {
+            // Sample with the matrix the tile was rendered with
+            gpuData.ViewProjection = tile.RenderedViewProj;
+            m_SpotShadowData.push_back(gpuData);
+            m_ShadowedSpotLights.push_back(entity);
+            m_SpotShadowCount++;
+            m_Stats.SpotShadowsThrottled++;
+            continue;
+        }
+
         // Get light position and direction
         glm::vec3 lightPos = transform.GetWorldPosition();
         glm::vec3 lightDir = glm::normalize(light.Direction);
@@ -214,35 +842,42 @@ void ShadowMapSystem::RenderSpotShadows(entt::registry& registry) {
 
         glm::mat4 lightViewProj = lightProj * lightView;
 
-        // Bind atlas tile for rendering
-        m_SpotAtlas->BindForTile(tileIndex);
-
-        // Clear the tile
-        glClear(GL_DEPTH_BUFFER_BIT);
-
         m_SpotDepthShader->SetMat4("u_LightViewProj", lightViewProj);
 
-        // Render shadow casters
-        for (const auto& caster : m_ShadowCasters) {
-            // Simple distance culling
-            glm::vec3 casterCenter = caster.WorldBounds.GetCenter();
-            f32 distance = glm::length(casterCenter - lightPos);
-            if (distance > light.Range * 1.5f) continue;
-
-            m_SpotDepthShader->SetMat4("u_Model", caster.WorldMatrix);
-
-            auto& mesh = registry.get<MeshComponent>(caster.Entity);
-            mesh.VAO->Bind();
-            glDrawElements(GL_TRIANGLES, mesh.IndexCount, GL_UNSIGNED_INT, nullptr);
+        // Render shadow casters inside the light's frustum
+        Frustum lightFrustum;
+        lightFrustum.ExtractPlanes(lightViewProj);
+
+        if (m_SpotAtlas->IsCachingEnabled()) {
+            // Static casters only when the light moved, changed shape or got a new tile
+            if (m_SpotAtlas->IsTileCached(tileIndex, lightViewProj)) {
+                m_Stats.CachedSpotShadows++;
+            } else {
+                m_SpotAtlas->BindForStaticTile(tileIndex);
+                glClear(GL_DEPTH_BUFFER_BIT);
+                m_Stats.SpotCastersRendered += DrawCasters(registry, *m_SpotDepthShader, lightFrustum, CasterSet::Static);
+                m_SpotAtlas->MarkTileCached(tileIndex, lightViewProj);
+            }
+
+            m_SpotAtlas->RestoreTileFromCache(tileIndex);
+            m_SpotAtlas->BindForTile(tileIndex);
+            m_Stats.SpotCastersRendered += DrawCasters(registry, *m_SpotDepthShader, lightFrustum, CasterSet::Dynamic);
+        } else {
+            // Bind atlas tile for rendering
+            m_SpotAtlas->BindForTile(tileIndex);
+
+            // Clear the tile
+            glClear(GL_DEPTH_BUFFER_BIT);
+
+            m_Stats.SpotCastersRendered += DrawCasters(registry, *m_SpotDepthShader, lightFrustum, CasterSet::All);
         }
 
-        // Store GPU data
-        GPUSpotShadowData gpuData;
-        gpuData.ViewProjection = lightViewProj;
-        gpuData.AtlasScaleOffset = m_SpotAtlas->GetTileScaleOffset(tileIndex);
-        gpuData.ShadowParams = glm::vec4(0.001f, 0.01f, 1.0f, 1.0f);  // bias, normalBias, softness, enabled
+        m_SpotAtlas->MarkTileRendered(tileIndex, lightViewProj);
 
+        gpuData.ViewProjection = lightViewProj;
+        m_RenderedSpotTiles.push_back(gpuData.AtlasScaleOffset);
         m_SpotShadowData.push_back(gpuData);
+        m_ShadowedSpotLights.push_back(entity);
         m_SpotShadowCount++;
         m_Stats.SpotShadowsRendered++;
     }
@@ -250,6 +885,137 @@ void ShadowMapSystem::RenderSpotShadows(entt::registry& registry) {
     m_SpotAtlas->Unbind();
 }
 
+void ShadowMapSystem::RankPointLights(entt::registry& registry) {
+    m_PointCandidates.clear();
+
+    const Frustum& cameraFrustum = m_Camera->GetFrustum();
+
+    for (auto [entity, light, transform] : PointLightGroup(registry).each()) {
+
+        if (!light.Enabled || !light.CastShadows) continue;
+
+        glm::vec3 center = transform.GetWorldPosition();
+        if (!cameraFrustum.IsSphereVisible(center, light.Radius)) continue;
+
+        f32 importance = LightImportance(light.Color, light.Intensity);
+        f32 priority = ProjectedCoverage(*m_Camera, center, light.Radius) * importance;
+        if (priority <= m_Settings.MinShadowCoverage) continue;
+
+        m_PointCandidates.push_back({entity, priority});
+    }
+
+    KeepHighestPriority(m_PointCandidates, std::min<usize>(m_Settings.MaxShadowedPointLights, MAX_SHADOW_CASTING_POINT));
+}
+
+void ShadowMapSystem::RenderPointShadows(entt::registry& registry) {
+    m_PointShadowData.clear();
+    m_ShadowedPointLights.clear();
+    m_PointFaces.clear();
+
+    if (!m_PointAtlas || !HasShadowCasters()) return;
+
+    RankPointLights(registry);
+    if (m_PointCandidates.empty()) return;
+
+    // One instance per (caster, face) pair; the face index rides in
+    // InstanceData::Flags and picks the matrix and atlas tile
+    m_PointDrawItems.clear();
+
+    for (const auto& candidate : m_PointCandidates) {
+        entt::entity entity = candidate.Entity;
+        glm::vec3 lightPos = registry.get<Transform>(entity).GetWorldPosition();
+        auto& light = registry.get<PointLightComponent>(entity);
+
+        GPUPointShadowData gpuData{};
+        gpuData.PositionFarPlane = glm::vec4(lightPos, light.Radius);
+        gpuData.ShadowParams = glm::vec4(0.001f, 0.02f, 1.0f,
+                                         ShadowStrength(candidate.Priority, m_Settings.MinShadowCoverage));
+
+        glm::mat4 faceProj = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, light.Radius);
+        u32 lightId = entt::to_entity(entity);
+        bool hasFaces = false;
+
+        for (u32 face = 0; face < POINT_SHADOW_FACE_COUNT; ++face) {
+            glm::mat4 faceViewProj = faceProj * glm::lookAt(lightPos, lightPos + CubeFaceDirections[face], CubeFaceUps[face]);
+            gpuData.FaceViewProjection[face] = faceViewProj;
+            gpuData.FaceScaleOffset[face] = glm::vec4(0.0f);
+
+            Frustum faceFrustum;
+            faceFrustum.ExtractPlanes(faceViewProj);
+
+            const u32 faceIndex = static_cast<u32>(m_PointFaces.size());
+            const usize firstItem = m_PointDrawItems.size();
+
+            ForEachCaster(registry, faceFrustum, CasterSet::All, [&](const glm::mat4& world, const Mesh& mesh, u32 meshId) {
+                IndirectDrawBatcher::DrawItem item;
+                item.VAO = mesh.GetDepthPassVertexArray();
+                item.IndexCount = mesh.GetIndexCount();
+                item.BaseVertex = mesh.GetBaseVertex();
+                item.BaseIndex = mesh.GetBaseIndex();
+                item.MeshId = meshId;
+                item.Instance.Transform = mesh.GetDrawTransform(world);
+                item.Instance.Flags = faceIndex;
+                m_PointDrawItems.push_back(item);
+            });
+
+            // Nothing can shadow this face: no tile, sampled as fully lit
+            if (m_PointDrawItems.size() == firstItem) {
+                m_Stats.PointFacesSkipped++;
+                continue;
+            }
+
+            // Keyed per face, so each face keeps its tile between frames
+            i32 faceKey = static_cast<i32>(lightId * POINT_SHADOW_FACE_COUNT + face);
+            i32 tileIndex = m_PointAtlas->AllocateTile(POINT_SHADOW_FACE_SIZE, faceKey);
+            if (tileIndex < 0) {
+                m_PointDrawItems.resize(firstItem);
+                continue;
+            }
+
+            glm::vec4 scaleOffset = m_PointAtlas->GetTileScaleOffset(tileIndex);
+            gpuData.FaceScaleOffset[face] = scaleOffset;
+            m_PointFaces.push_back({faceViewProj, scaleOffset});
+
+            m_Stats.PointFacesRendered++;
+            hasFaces = true;
+        }
+
+        if (!hasFaces) continue;
+
+        m_PointShadowData.push_back(gpuData);
+        m_ShadowedPointLights.push_back(entity);
+        m_Stats.PointShadowsRendered++;
+    }
+
+    if (m_PointFaces.empty()) return;
+
+    auto faces = m_ShadowDataRing->Upload(m_PointFaces.data(), m_PointFaces.size());
+    GPURingBuffer::BindRange(GL_SHADER_STORAGE_BUFFER, POINT_SHADOW_FACE_BINDING, faces);
+
+    m_PointBatcher->Prepare(m_PointDrawItems);
+
+    // Every face with casters is redrawn each frame, so one clear covers the atlas
+    m_PointAtlas->BindForAtlas();
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    // The vertex shader clips each face to its own tile
+    for (u32 plane = 0; plane < 4; ++plane) {
+        glEnable(GL_CLIP_DISTANCE0 + plane);
+    }
+
+    m_PointDepthShader->Bind();
+    m_PointBatcher->Draw();
+
+    for (u32 plane = 0; plane < 4; ++plane) {
+        glDisable(GL_CLIP_DISTANCE0 + plane);
+    }
+
+    m_PointAtlas->Unbind();
+
+    m_Stats.PointCastersRendered += m_PointBatcher->GetStats().Instances;
+    m_Stats.ShadowDrawCalls += m_PointBatcher->GetStats().DrawCalls;
+}
+
 void ShadowMapSystem::UploadShadowData() {
     // Fill CSM GPU data structure
     m_CSM->FillGPUData(m_CSMData,
@@ -257,40 +1023,76 @@ void ShadowMapSystem::UploadShadowData() {
                         m_CurrentShadowBias,
                         m_CurrentNormalBias);
 
-    // Upload CSM data to UBO
-    glNamedBufferSubData(m_ShadowDataUBO, 0, sizeof(GPUCascadedShadowData), &m_CSMData);
+    m_ShadowData = m_ShadowDataRing->Allocate(sizeof(GPUShadowUBO));
+    if (!m_ShadowData) return;
 
-    // Upload spot shadow data
+    u8* data = static_cast<u8*>(m_ShadowData.Data);
+
+    // CSM data
+    std::memcpy(data + offsetof(GPUShadowUBO, CSM), &m_CSMData, sizeof(GPUCascadedShadowData));
+
+    // Spot shadow data
     if (m_SpotShadowCount > 0) {
-        size_t spotOffset = sizeof(GPUCascadedShadowData);
-        size_t spotSize = m_SpotShadowCount * sizeof(GPUSpotShadowData);
-        glNamedBufferSubData(m_ShadowDataUBO, spotOffset, spotSize, m_SpotShadowData.data());
+        std::memcpy(data + offsetof(GPUShadowUBO, SpotShadows), m_SpotShadowData.data(),
+                    m_SpotShadowCount * sizeof(GPUSpotShadowData));
+    }
+
+    // Point shadow data
+    if (!m_PointShadowData.empty()) {
+        std::memcpy(data + offsetof(GPUShadowUBO, PointShadows), m_PointShadowData.data(),
+                    m_PointShadowData.size() * sizeof(GPUPointShadowData));
+    }
+
+    // Virtual shadow map, disabled unless its pages were drawn for this light
+    GPUVirtualShadowData virtualShadow{};
+    if (m_VSMRendered) {
+        m_VSM->FillGPUData(virtualShadow, m_CurrentShadowBias, m_CurrentNormalBias);
+    }
+    std::memcpy(data + offsetof(GPUShadowUBO, VirtualShadow), &virtualShadow, sizeof(GPUVirtualShadowData));
+
+    // Filtering
+    glm::vec4 filterParams(0.0f);
+    if (m_Moments) {
+        filterParams = glm::vec4(m_Moments->GetExponents(), std::clamp(m_Settings.LightBleedReduction, 0.0f, 0.95f), 1.0f);
     }
+    std::memcpy(data + offsetof(GPUShadowUBO, FilterParams), &filterParams, sizeof(glm::vec4));
+
+    // Shadow counts
+    glm::ivec4 counts(static_cast<i32>(m_SpotShadowCount), static_cast<i32>(m_PointShadowData.size()), 0, 0);
+    std::memcpy(data + offsetof(GPUShadowUBO, ShadowCounts), &counts, sizeof(glm::ivec4));
+}
 
-    // Upload shadow counts
-    glm::ivec4 counts(static_cast<i32>(m_SpotShadowCount), 0, 0, 0);
-    size_t countsOffset = sizeof(GPUCascadedShadowData) + MAX_SHADOW_CASTING_SPOT * sizeof(GPUSpotShadowData);
-    glNamedBufferSubData(m_ShadowDataUBO, countsOffset, sizeof(glm::ivec4), &counts);
+void ShadowMapSystem::BindShadowData(u32 binding) const {
+    GPURingBuffer::BindRange(GL_UNIFORM_BUFFER, binding, m_ShadowData);
 }
 
 void ShadowMapSystem::LoadShaders() {
     m_DepthShader = CreateRef<Shader>("assets/shaders/shadows/depth_csm.glsl");
     m_SpotDepthShader = CreateRef<Shader>("assets/shaders/shadows/depth_spot.glsl");
 
-    LOG_CORE_DEBUG("Shadow depth shaders loaded (CSM + Spot)");
+    // Writing gl_Layer from the vertex stage needs an extension; without it a
+    // pass-through geometry shader does the routing
+    if (HasGLExtension("GL_ARB_shader_viewport_layer_array")) {
+        m_LayeredDepthShader = CreateRef<Shader>("assets/shaders/shadows/depth_csm_layered.glsl");
+    } else {
+        m_LayeredDepthShader = CreateRef<Shader>("assets/shaders/shadows/depth_csm_layered_gs.glsl");
+    }
+
+    m_PointDepthShader = CreateRef<Shader>("assets/shaders/shadows/depth_point.glsl");
+
+    LOG_CORE_DEBUG("Shadow depth shaders loaded (CSM + layered CSM + Spot + Point)");
 }
 
 void ShadowMapSystem::CreateUBOs() {
-    // Calculate total UBO size: CSM + Spot shadows + counts
-    size_t uboSize = sizeof(GPUCascadedShadowData) +
-                     MAX_SHADOW_CASTING_SPOT * sizeof(GPUSpotShadowData) +
-                     sizeof(glm::ivec4);
+    // Per frame: the shadow UBO (CSM + spot + point shadows + counts) and the
+    // point shadow face list, plus room for the alignment between them
+    size_t uboSize = sizeof(GPUShadowUBO);
+    size_t faceSize = MAX_SHADOW_CASTING_POINT * POINT_SHADOW_FACE_COUNT * sizeof(GPUPointShadowFace);
 
-    glCreateBuffers(1, &m_ShadowDataUBO);
-    glNamedBufferStorage(m_ShadowDataUBO, uboSize, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    m_ShadowDataRing = CreateScope<GPURingBuffer>(uboSize + faceSize + 256);
 
-    LOG_CORE_DEBUG("Shadow UBO created (size: {} bytes, CSM + {} spot slots)",
-                   uboSize, MAX_SHADOW_CASTING_SPOT);
+    LOG_CORE_DEBUG("Shadow UBO ring created (size: {} bytes per frame, CSM + {} spot + {} point slots)",
+                   m_ShadowDataRing->GetFrameCapacity(), MAX_SHADOW_CASTING_SPOT, MAX_SHADOW_CASTING_POINT);
 }
 
 void ShadowMapSystem::BindCSMTexture(u32 slot) const {
@@ -305,4 +1107,25 @@ void ShadowMapSystem::BindSpotAtlasTexture(u32 slot) const {
     }
 }
 
+void ShadowMapSystem::BindPointAtlasTexture(u32 slot) const {
+    if (m_PointAtlas) {
+        m_PointAtlas->BindTexture(slot);
+    }
+}
+
+void ShadowMapSystem::BindMomentTextures(u32 cascadeSlot, u32 spotSlot, u32 pointSlot) const {
+    if (m_Moments) {
+        m_Moments->BindCascades(cascadeSlot);
+        m_Moments->BindSpotAtlas(spotSlot);
+        m_Moments->BindPointAtlas(pointSlot);
+    }
+}
+
+void ShadowMapSystem::BindVirtualShadowTextures(u32 mapSlot, u32 pageTableSlot) const {
+    if (m_VSM && m_VSM->IsValid()) {
+        m_VSM->BindTexture(mapSlot);
+        m_VSM->BindPageTable(pageTableSlot);
+    }
+}
+
 } // namespace Engine
@@ -1,20 +1,31 @@
 #pragma once
 
 #include "ecs/System.hpp"
+#include "ecs/Components/Transform.hpp"
+#include "ecs/Components/Renderable.hpp"
 #include "renderer/shadows/ShadowTypes.hpp"
 #include "renderer/shadows/CascadedShadowMap.hpp"
+#include "renderer/shadows/VirtualShadowMap.hpp"
+#include "renderer/shadows/ShadowMomentMaps.hpp"
 #include "renderer/shadows/ShadowAtlas.hpp"
+#include "renderer/culling/SubtreeCulling.hpp"
 #include "renderer/opengl/GLShader.hpp"
+#include "renderer/opengl/GPURingBuffer.hpp"
+#include "renderer/pipeline/IndirectDrawBatcher.hpp"
 #include "camera/Camera.hpp"
 
 namespace Engine {
 
+class SpatialIndex;
+class GBuffer;
+
 class ShadowMapSystem : public ISystem {
 public:
     ShadowMapSystem();
     ~ShadowMapSystem();
 
     DEFINE_SYSTEM(ShadowMapSystem, PreRender, 10);
+    SYSTEM_REACTS_TO(Transform, MeshComponent, Renderable)
 
     void OnCreate(entt::registry& registry) override;
     void OnDestroy(entt::registry& registry) override;
@@ -24,58 +35,186 @@ public:
     // Camera reference (set by application, same as DeferredLightingSystem)
     void SetCamera(Camera* camera) { m_Camera = camera; }
 
+    // Optional spatial index (owned by CullingSystem). When set, casters are
+    // selected per cascade / light by querying it instead of a linear pass.
+    void SetSpatialIndex(const SpatialIndex* index) { m_SpatialIndex = index; }
+
     // Access for lighting pass integration
     CascadedShadowMap* GetCSM() { return m_CSM.get(); }
     const CascadedShadowMap* GetCSM() const { return m_CSM.get(); }
 
+    // The virtual shadow map, while ShadowSettings::UseVirtualShadowMap is on
+    // and the driver supports it
+    bool IsVirtualShadowMapActive() const { return m_VSM && m_VSM->IsValid(); }
+    const VirtualShadowMap* GetVirtualShadowMap() const { return m_VSM.get(); }
+
+    // After the main view's geometry pass: request the virtual shadow map
+    // pages its depth samples land in (read back a few frames later)
+    void AnalyzeVisibleSurfaces(const GBuffer& gbuffer, const glm::mat4& viewProjection);
+
+    // Prefiltered moments for ShadowFilter::EVSM, filled every frame
+    bool IsMomentFilteringActive() const { return m_Moments != nullptr; }
+
     ShadowAtlas* GetSpotAtlas() { return m_SpotAtlas.get(); }
     const ShadowAtlas* GetSpotAtlas() const { return m_SpotAtlas.get(); }
 
+    ShadowAtlas* GetPointAtlas() { return m_PointAtlas.get(); }
+    const ShadowAtlas* GetPointAtlas() const { return m_PointAtlas.get(); }
+
     // Settings
     ShadowSettings& GetSettings() { return m_Settings; }
     const ShadowSettings& GetSettings() const { return m_Settings; }
 
-    // GPU data for binding in lighting pass
-    u32 GetShadowDataUBO() const { return m_ShadowDataUBO; }
+    // Spot lights with a shadow this frame; entry i uses shadow slot i
+    const Vector<entt::entity>& GetShadowedSpotLights() const { return m_ShadowedSpotLights; }
+
+    // Point lights with a shadow this frame; entry i uses point shadow slot i
+    const Vector<entt::entity>& GetShadowedPointLights() const { return m_ShadowedPointLights; }
+
+    // Bind this frame's shadow UBO range for the lighting pass
+    void BindShadowData(u32 binding) const;
+
+    // Drop cached static shadows (e.g. after editing static geometry). Changes
+    // to the StaticGeometry set are picked up automatically.
+    void InvalidateShadowCache() { m_CacheDirty = true; }
 
     // Texture binding for lighting pass
     void BindCSMTexture(u32 slot) const;
     void BindSpotAtlasTexture(u32 slot) const;
+    void BindPointAtlasTexture(u32 slot) const;
+    void BindVirtualShadowTextures(u32 mapSlot, u32 pageTableSlot) const;
+    void BindMomentTextures(u32 cascadeSlot, u32 spotSlot, u32 pointSlot) const;
 
     // Statistics
     struct Stats {
-        u32 ShadowCastersRendered = 0;
+        u32 ShadowCastersRendered = 0; // Cascade draws (caster x cascade)
+        u32 SpotCastersRendered = 0;   // Spot tile draws (caster x light)
         u32 CascadesRendered = 0;
         u32 SpotShadowsRendered = 0;
+        u32 SpotShadowsThrottled = 0;  // Low-priority tiles kept from an earlier frame
+        u32 ShadowDrawCalls = 0;
+        u32 CachedCascades = 0;        // Static casters reused from the cache
+        u32 ScheduledOutCascades = 0;  // Kept from an earlier frame by the update schedule
+        u32 CachedSpotShadows = 0;
+        u32 PointShadowsRendered = 0;
+        u32 PointFacesRendered = 0;
+        u32 PointFacesSkipped = 0;     // Faces without casters, sampled as lit
+        u32 PointCastersRendered = 0;  // Point face draws (caster x face)
+        u32 VirtualPagesRendered = 0;
+        u32 VirtualCastersRendered = 0; // Virtual shadow draws (caster x page rectangle)
+        u32 MomentRegionsFiltered = 0; // Cascades and tiles prefiltered for EVSM
         f32 ShadowPassTimeMs = 0.0f;
     };
     const Stats& GetStats() const { return m_Stats; }
 
 private:
+    void OnStaticCastersChanged(entt::registry& registry, entt::entity entity);
+    void UpdateCacheState();
+
+    // The caster list is kept across frames: rebuilt when casters come or
+    // go, otherwise only the entities whose Transform, MeshComponent or
+    // Renderable changed are patched
     void GatherShadowCasters(entt::registry& registry);
+    void RebuildShadowCasters(entt::registry& registry);
+    bool PatchShadowCasters(entt::registry& registry);
+    bool PatchShadowCaster(entt::registry& registry, entt::entity entity);
+    bool ResolveCasterMeshes();
+
+    bool HasShadowCasters() const;
+
+    // func(const glm::mat4& world, const Mesh& mesh, u32 meshId) for every
+    // shadow caster of the set whose bounds touch the light's frustum.
+    // Casters in a Hierarchy subtree wholly outside it are skipped unseen.
+    template<typename Func>
+    void ForEachCaster(entt::registry& registry, const Frustum& frustum, CasterSet set, Func&& func);
+
+    // Draw casters with the bound depth shader, returns the number drawn
+    u32 DrawCasters(entt::registry& registry, Shader& shader, const Frustum& frustum, CasterSet set);
+
     void RenderDirectionalShadows(entt::registry& registry);
+
+    // Cull casters per cascade into one instance list and draw every cascade
+    // layer with a single batched multi-draw
+    void RenderCascadesSinglePass(entt::registry& registry, CasterSet set, bool clear);
+
+    // Create or drop the virtual shadow map to follow the settings
+    void UpdateVirtualShadowMap();
+
+    // Redraw the dirty, requested pages of the virtual shadow map
+    void RenderVirtualShadowPages(entt::registry& registry);
+    void TrackVirtualShadowCasters(entt::registry& registry);
+
+    // Create or drop the moment maps to follow ShadowSettings::Filter, and
+    // prefilter every cascade and tile rendered this frame into them
+    void UpdateMomentMaps();
+    void FilterShadowMoments();
+
     void RenderSpotShadows(entt::registry& registry);
+    void RankSpotLights(entt::registry& registry);
+
+    // Cull casters per cube face of every shadowed point light and draw all
+    // faces into the point atlas with a single batched multi-draw
+    void RenderPointShadows(entt::registry& registry);
+    void RankPointLights(entt::registry& registry);
     void UploadShadowData();
     void LoadShaders();
     void CreateUBOs();
 
 private:
     Camera* m_Camera = nullptr;
+    const SpatialIndex* m_SpatialIndex = nullptr;
     ShadowSettings m_Settings;
 
     Scope<CascadedShadowMap> m_CSM;
     Scope<ShadowAtlas> m_SpotAtlas;
+    Scope<ShadowAtlas> m_PointAtlas;
+
+    Scope<VirtualShadowMap> m_VSM;
+    bool m_VSMSupportChecked = false;
+    bool m_VSMSupported = false;
+    bool m_VSMCastersSeeded = false;    // Dynamic caster bounds known since the last frame
+    bool m_VSMRendered = false;         // Pages drawn for this frame's light
+
+    Scope<ShadowMomentMaps> m_Moments;
+    bool m_CascadesRendered = false;    // Due cascades drawn this frame
+    Vector<glm::vec4> m_RenderedSpotTiles;  // Atlas scale / offset of tiles drawn this frame
 
     Ref<Shader> m_DepthShader;
     Ref<Shader> m_SpotDepthShader;
+    Ref<Shader> m_LayeredDepthShader;   // gl_Layer from the vertex stage, or a GS fallback
+    Ref<Shader> m_PointDepthShader;
+
+    Scope<IndirectDrawBatcher> m_CascadeBatcher;
+    Vector<IndirectDrawBatcher::DrawItem> m_CascadeDrawItems;
+
+    Scope<IndirectDrawBatcher> m_PointBatcher;
+    Vector<IndirectDrawBatcher::DrawItem> m_PointDrawItems;
+    Vector<GPUPointShadowFace> m_PointFaces;
 
     Vector<ShadowCasterInfo> m_ShadowCasters;
+    static constexpr u32 INVALID_CASTER = ~0u;
+    Vector<u32> m_CasterSlots;          // Per entity slot (entt::to_entity), index into m_ShadowCasters
+    bool m_CastersDirty = true;
+    SubtreeCulling m_CasterSubtrees;    // Of the frustum ForEachCaster is walking
 
     // GPU data
-    u32 m_ShadowDataUBO = 0;
+    Scope<GPURingBuffer> m_ShadowDataRing;
+    GPURingBuffer::Allocation m_ShadowData;
     GPUCascadedShadowData m_CSMData;
     Vector<GPUSpotShadowData> m_SpotShadowData;
+    Vector<entt::entity> m_ShadowedSpotLights;
     u32 m_SpotShadowCount = 0;
+    Vector<GPUPointShadowData> m_PointShadowData;
+    Vector<entt::entity> m_ShadowedPointLights;
+
+    // Shadow-casting lights by descending priority (screen coverage scaled
+    // by brightness); the first MAX_SHADOW_CASTING_SPOT / _POINT get tiles
+    struct ShadowCandidate {
+        entt::entity Entity;
+        f32 Priority;
+    };
+    Vector<ShadowCandidate> m_SpotCandidates;
+    Vector<ShadowCandidate> m_PointCandidates;
 
     // Current directional light shadow info
     glm::vec3 m_CurrentLightDirection{0.0f, -1.0f, 0.0f};
@@ -83,9 +222,14 @@ private:
     f32 m_CurrentNormalBias = 0.02f;
     f32 m_CurrentShadowSoftness = 1.0f;
 
+    // Static shadow cache invalidation
+    bool m_CacheDirty = true;
+    u32 m_StaticRevision = 0;           // SpatialIndex static rebuild count
+
     Stats m_Stats;
     u32 m_FrameNumber = 0;
     bool m_Initialized = false;
+    bool m_Connected = false;
 };
 
 } // namespace Engine
@@ -0,0 +1,211 @@
+#include "renderer/shadows/ShadowMomentMaps.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+namespace {
+
+// Compute workgroup side of shadow_moments.glsl
+constexpr u32 FilterGroupSize = 8;
+
+// exp(2c) has to stay below FLT_MAX for the second moment
+constexpr f32 MaxExponent = 42.0f;
+
+u32 GroupCount(u32 size) {
+    return (size + FilterGroupSize - 1) / FilterGroupSize;
+}
+
+} // anonymous namespace
+
+ShadowMomentMaps::ShadowMomentMaps() {
+    LoadShaders();
+}
+
+ShadowMomentMaps::~ShadowMomentMaps() {
+    Release(m_Cascades);
+    Release(m_SpotAtlas);
+    Release(m_PointAtlas);
+    if (m_Scratch) GLMemory::DeleteTextures(1, &m_Scratch);
+}
+
+void ShadowMomentMaps::LoadShaders() {
+    m_FilterShader = CreateRef<Shader>("assets/shaders/shadows/shadow_moments.glsl");
+    m_FilterArrayShader = CreateRef<Shader>("assets/shaders/shadows/shadow_moments.glsl", "",
+                                            ShaderDefines{{"DEPTH_ARRAY", "1"}});
+}
+
+void ShadowMomentMaps::Reload() {
+    LoadShaders();
+}
+
+bool ShadowMomentMaps::Resize(u32 cascadeResolution, u32 spotAtlasSize, u32 pointAtlasSize) {
+    const u32 cascadeSize = cascadeResolution / Downsample;
+    const u32 spotSize = spotAtlasSize / Downsample;
+    const u32 pointSize = pointAtlasSize / Downsample;
+
+    bool reallocated = false;
+    if (m_Cascades.Size != cascadeSize) {
+        Allocate(m_Cascades, cascadeSize, CSM_CASCADE_COUNT);
+        reallocated = true;
+    }
+    if (m_SpotAtlas.Size != spotSize) {
+        Allocate(m_SpotAtlas, spotSize, 0);
+        reallocated = true;
+    }
+    if (m_PointAtlas.Size != pointSize) {
+        Allocate(m_PointAtlas, pointSize, 0);
+        reallocated = true;
+    }
+
+    // A whole cascade layer is the largest region
+    EnsureScratch(std::max({cascadeSize, MAX_SHADOW_TILE_SIZE / Downsample, POINT_SHADOW_FACE_SIZE / Downsample}));
+    return reallocated;
+}
+
+void ShadowMomentMaps::Allocate(MomentTexture& map, u32 size, u32 layers) {
+    Release(map);
+
+    const i32 levels = static_cast<i32>(std::min(MaxLevels, static_cast<u32>(std::log2(size)) + 1));
+    if (layers > 0) {
+        glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &map.Texture);
+        GLMemory::TextureStorage3D(map.Texture, levels, GL_RGBA32F, static_cast<i32>(size), static_cast<i32>(size),
+                                   static_cast<i32>(layers), MemoryTag::Shadows);
+    } else {
+        glCreateTextures(GL_TEXTURE_2D, 1, &map.Texture);
+        GLMemory::TextureStorage2D(map.Texture, levels, GL_RGBA32F, static_cast<i32>(size), static_cast<i32>(size),
+                                   MemoryTag::Shadows);
+    }
+    glTextureParameteri(map.Texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTextureParameteri(map.Texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(map.Texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(map.Texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // Unrendered regions read as fully lit: both warps of the far plane
+    const glm::vec4 lit(std::exp(m_Exponents.x), std::exp(2.0f * m_Exponents.x),
+                        -std::exp(-m_Exponents.y), std::exp(-2.0f * m_Exponents.y));
+    for (i32 level = 0; level < levels; ++level) {
+        glClearTexImage(map.Texture, level, GL_RGBA, GL_FLOAT, &lit);
+    }
+
+    map.Size = size;
+    map.Layers = layers;
+    map.Written = false;
+
+    LOG_CORE_DEBUG("Shadow moment map {}x{} ({} layers, {} levels)", size, size, layers, levels);
+}
+
+void ShadowMomentMaps::Release(MomentTexture& map) {
+    if (map.Texture) GLMemory::DeleteTextures(1, &map.Texture);
+    map = {};
+}
+
+void ShadowMomentMaps::EnsureScratch(u32 size) {
+    if (m_ScratchSize >= size) return;
+    if (m_Scratch) GLMemory::DeleteTextures(1, &m_Scratch);
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_Scratch);
+    GLMemory::TextureStorage2D(m_Scratch, 1, GL_RGBA32F, static_cast<i32>(size), static_cast<i32>(size),
+                               MemoryTag::Shadows);
+    glTextureParameteri(m_Scratch, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(m_Scratch, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    m_ScratchSize = size;
+}
+
+void ShadowMomentMaps::SetFilter(f32 positiveExponent, f32 negativeExponent, u32 blurRadius) {
+    m_Exponents = glm::vec2(std::clamp(positiveExponent, 1.0f, MaxExponent),
+                            std::clamp(negativeExponent, 1.0f, MaxExponent));
+    m_BlurRadius = std::min(blurRadius, MaxBlurRadius);
+}
+
+void ShadowMomentMaps::FilterCascade(u32 depthArray, u32 cascade) {
+    const u32 depthSize = m_Cascades.Size * Downsample;
+    FilterRegion(depthArray, static_cast<i32>(cascade), m_Cascades, 0, 0, depthSize);
+}
+
+void ShadowMomentMaps::FilterSpotTile(u32 depthAtlas, const glm::vec4& atlasScaleOffset) {
+    FilterTile(m_SpotAtlas, depthAtlas, atlasScaleOffset);
+}
+
+void ShadowMomentMaps::FilterPointTile(u32 depthAtlas, const glm::vec4& atlasScaleOffset) {
+    FilterTile(m_PointAtlas, depthAtlas, atlasScaleOffset);
+}
+
+void ShadowMomentMaps::FilterTile(MomentTexture& target, u32 depthAtlas, const glm::vec4& atlasScaleOffset) {
+    const f32 depthSize = static_cast<f32>(target.Size * Downsample);
+    const u32 x = static_cast<u32>(std::lround(atlasScaleOffset.z * depthSize));
+    const u32 y = static_cast<u32>(std::lround(atlasScaleOffset.w * depthSize));
+    const u32 size = static_cast<u32>(std::lround(atlasScaleOffset.x * depthSize));
+    FilterRegion(depthAtlas, -1, target, x, y, size);
+}
+
+void ShadowMomentMaps::FilterRegion(u32 depthTexture, i32 layer, MomentTexture& target, u32 x, u32 y, u32 size) {
+    Shader* shader = layer >= 0 ? m_FilterArrayShader.get() : m_FilterShader.get();
+    if (!target.Texture || !shader || size < Downsample) return;
+
+    auto& state = GLStateCache::Instance();
+    const u32 regionSize = std::min(size / Downsample, m_ScratchSize);
+    const u32 groups = GroupCount(regionSize);
+
+    shader->Bind();
+    shader->SetInt2("u_RegionOffset", glm::ivec2(static_cast<i32>(x / Downsample), static_cast<i32>(y / Downsample)));
+    shader->SetInt("u_RegionSize", static_cast<i32>(regionSize));
+    shader->SetInt("u_BlurRadius", static_cast<i32>(m_BlurRadius));
+    shader->SetFloat2("u_Exponents", m_Exponents);
+    if (layer >= 0) {
+        shader->SetInt("u_DepthLayer", layer);
+    }
+
+    // Warp and blur across into the scratch
+    shader->SetInt("u_Pass", 0);
+    state.BindTextureUnit(0, depthTexture);
+    glBindImageTexture(0, m_Scratch, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+    glDispatchCompute(groups, groups, 1);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+    // Blur down into the region, one layer of the array bound as a 2D image
+    shader->SetInt("u_Pass", 1);
+    state.BindTextureUnit(1, m_Scratch);
+    glBindImageTexture(0, target.Texture, 0, GL_FALSE, std::max(layer, 0), GL_WRITE_ONLY, GL_RGBA32F);
+    glDispatchCompute(groups, groups, 1);
+
+    // The next region overwrites the scratch this pass read
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+    target.Written = true;
+    m_FilteredRegions++;
+}
+
+void ShadowMomentMaps::Finish() {
+    if (m_FilteredRegions == 0) return;
+
+    // Mips are built from the filtered level 0, and lighting samples them
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT |
+                    GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+    for (MomentTexture* map : {&m_Cascades, &m_SpotAtlas, &m_PointAtlas}) {
+        if (!map->Written) continue;
+        glGenerateTextureMipmap(map->Texture);
+        map->Written = false;
+    }
+    m_FilteredRegions = 0;
+}
+
+void ShadowMomentMaps::BindCascades(u32 slot) const {
+    GLStateCache::Instance().BindTextureUnit(slot, m_Cascades.Texture);
+}
+
+void ShadowMomentMaps::BindSpotAtlas(u32 slot) const {
+    GLStateCache::Instance().BindTextureUnit(slot, m_SpotAtlas.Texture);
+}
+
+void ShadowMomentMaps::BindPointAtlas(u32 slot) const {
+    GLStateCache::Instance().BindTextureUnit(slot, m_PointAtlas.Texture);
+}
+
+} // namespace Engine
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/shadows/ShadowTypes.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include <glm/glm.hpp>
+
+namespace Engine {
+
+// ShadowMomentMaps - prefiltered copies of the cascade and atlas depth maps
+// for ShadowFilter::EVSM.
+//
+// Each rendered region (a cascade layer, a spot tile or a point face tile)
+// is warped into exponential variance moments at half the depth resolution,
+// blurred with a separable Gaussian (shadow_moments.glsl) and mipmapped, so
+// the lighting pass takes one filtered fetch per light where PCF takes
+// PCF_SAMPLES depth taps. Regions keep their moments until they are
+// rendered again, matching what the depth maps keep (cached cascades,
+// throttled tiles).
+//
+// RGBA32F: the positive and negative warps and their squares. Atlas tiles
+// are power-of-two aligned and at least MIN_SHADOW_TILE_SIZE, so MaxLevels
+// mips never mix neighbouring tiles.
+class ShadowMomentMaps {
+public:
+    // Must match shadow_moments.glsl
+    static constexpr u32 Downsample = 2;        // Depth texels per moment texel, each axis
+    static constexpr u32 MaxBlurRadius = 4;
+    static constexpr u32 MaxLevels = 5;
+
+    ShadowMomentMaps();
+    ~ShadowMomentMaps();
+
+    ShadowMomentMaps(const ShadowMomentMaps&) = delete;
+    ShadowMomentMaps& operator=(const ShadowMomentMaps&) = delete;
+
+    // Storage follows the depth maps; unchanged sizes keep their moments.
+    // True when any map was (re)allocated and holds nothing yet.
+    bool Resize(u32 cascadeResolution, u32 spotAtlasSize, u32 pointAtlasSize);
+
+    // Exponents are clamped to what RGBA32F holds squared
+    void SetFilter(f32 positiveExponent, f32 negativeExponent, u32 blurRadius);
+    glm::vec2 GetExponents() const { return m_Exponents; }
+
+    // Filter one region of a depth map that was just rendered; Finish()
+    // builds the mips of every map written since the last call
+    void FilterCascade(u32 depthArray, u32 cascade);
+    void FilterSpotTile(u32 depthAtlas, const glm::vec4& atlasScaleOffset);
+    void FilterPointTile(u32 depthAtlas, const glm::vec4& atlasScaleOffset);
+    void Finish();
+
+    void BindCascades(u32 slot) const;
+    void BindSpotAtlas(u32 slot) const;
+    void BindPointAtlas(u32 slot) const;
+
+    // Regions filtered since the last Finish()
+    u32 GetFilteredRegionCount() const { return m_FilteredRegions; }
+
+    void Reload();
+
+private:
+    struct MomentTexture {
+        u32 Texture = 0;
+        u32 Size = 0;                   // Moment texels, level 0
+        u32 Layers = 0;                 // 0 = 2D texture
+        bool Written = false;
+    };
+
+    void LoadShaders();
+    void Allocate(MomentTexture& map, u32 size, u32 layers);
+    void Release(MomentTexture& map);
+    void EnsureScratch(u32 size);
+
+    // Region in depth texels of a layer (-1 = 2D depth texture)
+    void FilterRegion(u32 depthTexture, i32 layer, MomentTexture& target, u32 x, u32 y, u32 size);
+    void FilterTile(MomentTexture& target, u32 depthAtlas, const glm::vec4& atlasScaleOffset);
+
+private:
+    Ref<Shader> m_FilterShader;         // 2D depth (atlases)
+    Ref<Shader> m_FilterArrayShader;    // Depth array layers (cascades)
+
+    MomentTexture m_Cascades;
+    MomentTexture m_SpotAtlas;
+    MomentTexture m_PointAtlas;
+
+    // Horizontal pass output, region-local
+    u32 m_Scratch = 0;
+    u32 m_ScratchSize = 0;
+
+    glm::vec2 m_Exponents{40.0f, 8.0f};
+    u32 m_BlurRadius = 2;
+    u32 m_FilteredRegions = 0;
+};
+
+} // namespace Engine
@@ -2,12 +2,16 @@
 
 #include "core/Types.hpp"
 #include "math/AABB.hpp"
+#include "math/Frustum.hpp"
+#include "resources/ResourceHandle.hpp"
 #include <glm/glm.hpp>
 #include <entt/entt.hpp>
 #include <array>
 
 namespace Engine {
 
+class Mesh;
+
 // ============================================================================
 // Shadow System Constants
 // ============================================================================
@@ -20,9 +24,30 @@ constexpr u32 DEFAULT_CSM_RESOLUTION = 2048;
 constexpr u32 DEFAULT_SPOT_SHADOW_ATLAS_SIZE = 4096;
 constexpr u32 DEFAULT_POINT_SHADOW_ATLAS_SIZE = 2048;
 
+// Spot atlas tiles are powers of two in this range
+constexpr u32 MIN_SHADOW_TILE_SIZE = 128;
+constexpr u32 MAX_SHADOW_TILE_SIZE = 1024;
+
+// Point lights render up to six cube faces into their own atlas
+constexpr u32 POINT_SHADOW_FACE_COUNT = 6;
+constexpr u32 POINT_SHADOW_FACE_SIZE = 256;
+
+// Virtual (sparse) directional shadow map, one resolution on each side
+constexpr u32 VSM_VIRTUAL_RESOLUTION = 16384;
+
 // UBO binding point for shadow data (after light UBOs at 0, 1, 2)
 constexpr u32 SHADOW_UBO_BINDING = 3;
 
+// SSBO binding for the per-face matrices of the point shadow pass (after
+// the light culling buffers at 5..9)
+constexpr u32 POINT_SHADOW_FACE_BINDING = 10;
+
+// How the lighting pass filters shadow maps
+enum class ShadowFilter : u8 {
+    PCF,                                // PCFSamples depth taps per lookup
+    EVSM                                // One fetch from prefiltered exponential variance moments
+};
+
 // ============================================================================
 // Shadow Settings (runtime configurable)
 // ============================================================================
@@ -35,11 +60,58 @@ struct ShadowSettings {
     f32 MaxShadowDistance = 200.0f;
     f32 CascadeFadeRange = 0.1f;        // Blend between cascades
 
+    // Fit cascades to the bounding sphere of their slice and snap them to
+    // whole texels, so they don't shimmer as the camera moves and turns
+    bool StableCascades = true;
+
+    // Frames between re-renders of each cascade, near to far (1, 2, 4 or
+    // 8); in between a cascade keeps its last depth layer
+    std::array<u32, CSM_CASCADE_COUNT> CascadeUpdateIntervals = {1, 1, 2, 4};
+
+    // Filtering
+    ShadowFilter Filter = ShadowFilter::PCF;
+
     // PCF Settings
     u32 PCFSamples = 16;
     bool UsePCSS = false;               // Percentage-closer soft shadows
     f32 LightSize = 0.02f;              // For PCSS penumbra calculation
 
+    // EVSM Settings: warp exponents (up to 42), blur radius in moment texels
+    // (up to 4) and the light bleeding cut-off
+    f32 EVSMPositiveExponent = 40.0f;
+    f32 EVSMNegativeExponent = 8.0f;
+    u32 EVSMBlurRadius = 2;
+    f32 LightBleedReduction = 0.2f;
+
+    // Render static casters once into cache layers and only redraw dynamic
+    // casters per frame. Doubles shadow map memory.
+    bool CacheStaticShadows = true;
+
+    // Spot shadow tiles are sized from the light's screen coverage; lights
+    // that only get the smallest tile re-render every N frames
+    f32 SpotShadowResolutionScale = 1.0f;
+    u32 SpotShadowThrottleInterval = 4;
+
+    // Shadow budget: spot / point lights are ranked by screen coverage times
+    // brightness; below MinShadowCoverage they cast no shadow, and up to
+    // twice it their shadow fades in. At most MaxShadowed* lights of each
+    // kind (capped at MAX_SHADOW_CASTING_*) get one.
+    f32 MinShadowCoverage = 0.02f;
+    u32 MaxShadowedSpotLights = MAX_SHADOW_CASTING_SPOT;
+    u32 MaxShadowedPointLights = MAX_SHADOW_CASTING_POINT;
+
+    // Draw all cascades in one layered, instanced multi-draw instead of one
+    // pass per cascade
+    bool SinglePassCascades = true;
+
+    // Sparse virtual shadow map for the directional light, VirtualShadowDistance
+    // to each side of the camera; the cascades cover the rest and every page
+    // that isn't resident yet. Needs GL_ARB_sparse_texture.
+    bool UseVirtualShadowMap = false;
+    f32 VirtualShadowDistance = 64.0f;
+    u32 VirtualShadowPageBudget = 2048;     // Resident pages
+    u32 VirtualShadowPagesPerFrame = 128;   // Pages committed and drawn a frame
+
     // Atlas sizes
     u32 SpotShadowAtlasSize = DEFAULT_SPOT_SHADOW_ATLAS_SIZE;
     u32 PointShadowAtlasSize = DEFAULT_POINT_SHADOW_ATLAS_SIZE;
@@ -66,14 +138,29 @@ struct GPUCascadedShadowData {
 struct alignas(16) GPUSpotShadowData {
     glm::mat4 ViewProjection;           // 64 bytes - Light space transform
     glm::vec4 AtlasScaleOffset;         // 16 bytes - xy=scale, zw=offset in atlas UV
-    glm::vec4 ShadowParams;             // 16 bytes - x=bias, y=normalBias, z=softness, w=enabled
+    glm::vec4 ShadowParams;             // 16 bytes - x=bias, y=normalBias, z=softness, w=strength (0 = off)
 };  // Total: 96 bytes
 
-// Point light shadow data for GPU (cubemap shadows)
+// Point light shadow data for GPU (cube faces packed into the point atlas)
 struct alignas(16) GPUPointShadowData {
-    glm::vec4 PositionFarPlane;         // 16 bytes - xyz=position, w=farPlane
-    glm::vec4 ShadowParams;             // 16 bytes - x=bias, y=normalBias, z=softness, w=atlasLayer
-};  // Total: 32 bytes
+    glm::vec4 PositionFarPlane;                             // 16 bytes - xyz=position, w=farPlane
+    glm::vec4 ShadowParams;                                 // 16 bytes - x=bias, y=normalBias, z=softness, w=strength (0 = off)
+    glm::vec4 FaceScaleOffset[POINT_SHADOW_FACE_COUNT];     // 96 bytes - per face atlas UV, scale 0 = no casters
+    glm::mat4 FaceViewProjection[POINT_SHADOW_FACE_COUNT];  // 384 bytes - +X, -X, +Y, -Y, +Z, -Z
+};  // Total: 512 bytes
+
+// One cube face of the point shadow pass (std430 SSBO, indexed by
+// InstanceData::Flags)
+struct alignas(16) GPUPointShadowFace {
+    glm::mat4 ViewProjection;           // 64 bytes
+    glm::vec4 AtlasScaleOffset;         // 16 bytes - xy=scale, zw=offset in atlas UV
+};  // Total: 80 bytes
+
+// Virtual shadow map of the directional light
+struct alignas(16) GPUVirtualShadowData {
+    glm::mat4 ViewProjection;           // 64 bytes - Light space transform of the whole map
+    glm::vec4 Params;                   // 16 bytes - x=texelSize, y=bias, z=normalBias, w=enabled
+};  // Total: 80 bytes
 
 // ============================================================================
 // Complete Shadow UBO structure
@@ -85,8 +172,16 @@ struct GPUShadowUBO {
     // Spot shadow data (16 * 96 = 1536 bytes)
     GPUSpotShadowData SpotShadows[MAX_SHADOW_CASTING_SPOT];
 
+    // Point shadow data (8 * 512 = 4096 bytes)
+    GPUPointShadowData PointShadows[MAX_SHADOW_CASTING_POINT];
+
     // Counts and padding
     glm::ivec4 ShadowCounts;            // x=spotCount, y=pointCount, z=reserved, w=reserved
+
+    // Virtual shadow map (80 bytes)
+    GPUVirtualShadowData VirtualShadow;
+
+    glm::vec4 FilterParams;             // x=positiveExponent, y=negativeExponent, z=lightBleedReduction, w=evsm
 };
 
 // ============================================================================
@@ -100,7 +195,8 @@ struct CascadeInfo {
     glm::mat4 ViewProjectionMatrix;
     f32 SplitNear;
     f32 SplitFar;
-    AABB WorldBounds;                   // For frustum culling shadow casters
+    AABB WorldBounds;                   // Bounds of the light-space box
+    Frustum CasterFrustum;              // Light-space box extruded towards the light
 };
 
 // Information about a shadow-casting entity
@@ -108,8 +204,18 @@ struct ShadowCasterInfo {
     entt::entity Entity;
     glm::mat4 WorldMatrix;
     AABB WorldBounds;
+    MeshHandle Handle;
+    const Mesh* Geometry;               // Handle resolved this frame
     u32 MeshId;
     u32 IndexCount;
+    bool IsStatic;                      // StaticGeometry, drawn into the shadow cache
+};
+
+// Which casters a shadow pass draws
+enum class CasterSet : u8 {
+    All,
+    Static,
+    Dynamic
 };
 
 // Shadow atlas tile information
@@ -120,6 +226,14 @@ struct ShadowAtlasTile {
     i32 LightIndex = -1;                // -1 = free
     u32 LastUsedFrame = 0;              // For LRU eviction
 
+    // Static caster cache: valid while the owning light keeps this matrix
+    bool StaticCached = false;
+    glm::mat4 CachedViewProj{0.0f};
+
+    // Matrix of the last render, reused while the light's updates are throttled
+    u32 LastRenderedFrame = 0;
+    glm::mat4 RenderedViewProj{0.0f};
+
     bool IsFree() const { return LightIndex < 0; }
 
     glm::vec4 GetScaleOffset(u32 atlasSize) const {
@@ -0,0 +1,548 @@
+#include "renderer/shadows/VirtualShadowMap.hpp"
+#include "renderer/pipeline/GBuffer.hpp"
+#include "renderer/opengl/GLMemory.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "core/Logger.hpp"
+#include "core/MemoryTracker.hpp"
+
+#include <glad/gl.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+namespace Engine {
+
+namespace {
+
+constexpr GLenum DepthFormat = GL_DEPTH_COMPONENT32F;
+
+// The window re-centres once the camera is this fraction of its half
+// extent away from where it was centred
+constexpr f32 RecenterFraction = 0.25f;
+
+// Every page is drawn again once the light turns more than ~0.25 degrees
+constexpr f32 DirectionThreshold = 0.99999f;
+
+// Compute workgroup side of vsm_mark_pages.glsl
+constexpr u32 MarkGroupSize = 8;
+
+bool HasGLExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+        if (extension && std::strcmp(extension, name) == 0) return true;
+    }
+    return false;
+}
+
+// Up vector of a light view, away from the light direction
+glm::vec3 LightViewUp(const glm::vec3& lightDir) {
+    return std::abs(lightDir.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+}
+
+} // anonymous namespace
+
+VirtualShadowMap::VirtualShadowMap() {
+    CreateResources();
+    LoadShader();
+}
+
+VirtualShadowMap::~VirtualShadowMap() {
+    DeleteResources();
+}
+
+bool VirtualShadowMap::IsSupported() {
+    if (!HasGLExtension("GL_ARB_sparse_texture")) return false;
+
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_SPARSE_TEXTURE_SIZE_ARB, &maxSize);
+    if (static_cast<u32>(maxSize) < VSM_VIRTUAL_RESOLUTION) return false;
+
+    GLint pageSizes = 0;
+    glGetInternalformativ(GL_TEXTURE_2D, DepthFormat, GL_NUM_VIRTUAL_PAGE_SIZES_ARB, 1, &pageSizes);
+    return pageSizes > 0;
+}
+
+void VirtualShadowMap::CreateResources() {
+    GLint pageWidth = 0;
+    GLint pageHeight = 0;
+    glGetInternalformativ(GL_TEXTURE_2D, DepthFormat, GL_VIRTUAL_PAGE_SIZE_X_ARB, 1, &pageWidth);
+    glGetInternalformativ(GL_TEXTURE_2D, DepthFormat, GL_VIRTUAL_PAGE_SIZE_Y_ARB, 1, &pageHeight);
+    if (pageWidth <= 0 || pageHeight <= 0) {
+        LOG_CORE_ERROR("VirtualShadowMap: no sparse page size for 32-bit depth");
+        return;
+    }
+
+    m_PageWidth = static_cast<u32>(pageWidth);
+    m_PageHeight = static_cast<u32>(pageHeight);
+    m_PagesX = VSM_VIRTUAL_RESOLUTION / m_PageWidth;
+    m_PagesY = VSM_VIRTUAL_RESOLUTION / m_PageHeight;
+    const u32 pageCount = m_PagesX * m_PagesY;
+
+    // Storage is only virtual: committed pages are recorded one by one
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_Texture);
+    glTextureParameteri(m_Texture, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+    glTextureParameteri(m_Texture, GL_VIRTUAL_PAGE_SIZE_INDEX_ARB, 0);
+    glTextureStorage2D(m_Texture, 1, DepthFormat, VSM_VIRTUAL_RESOLUTION, VSM_VIRTUAL_RESOLUTION);
+    glTextureParameteri(m_Texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(m_Texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTextureParameteri(m_Texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_Texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glCreateFramebuffers(1, &m_Framebuffer);
+    glNamedFramebufferTexture(m_Framebuffer, GL_DEPTH_ATTACHMENT, m_Texture, 0);
+    glNamedFramebufferDrawBuffer(m_Framebuffer, GL_NONE);
+    glNamedFramebufferReadBuffer(m_Framebuffer, GL_NONE);
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_PageTableTexture);
+    GLMemory::TextureStorage2D(m_PageTableTexture, 1, GL_R8UI, static_cast<i32>(m_PagesX),
+                               static_cast<i32>(m_PagesY), MemoryTag::Shadows);
+    glTextureParameteri(m_PageTableTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(m_PageTableTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    const usize requestBytes = ((pageCount + 31) / 32) * sizeof(u32);
+    glCreateBuffers(1, &m_RequestBuffer);
+    GLMemory::BufferStorage(m_RequestBuffer, requestBytes, nullptr, GL_DYNAMIC_STORAGE_BIT, MemoryTag::Shadows);
+    m_RequestReadback = CreateScope<GPUReadbackBuffer>(requestBytes);
+
+    m_PageFlags.assign(pageCount, 0);
+    m_PageLastRequested.assign(pageCount, 0);
+    m_PageTable.assign(pageCount, 0);
+    m_Queued.assign(pageCount, 0);
+    m_RequestWords.assign(requestBytes / sizeof(u32), 0);
+    m_PageTableDirty = true;
+    m_ResidentCount = 0;
+
+    if (m_PageBudget == 0) m_PageBudget = pageCount;
+    if (m_PagesPerFrame == 0) m_PagesPerFrame = pageCount;
+
+    LOG_CORE_INFO("VirtualShadowMap: {}x{} virtual, {}x{} pages of {}x{}", VSM_VIRTUAL_RESOLUTION,
+                  VSM_VIRTUAL_RESOLUTION, m_PagesX, m_PagesY, m_PageWidth, m_PageHeight);
+}
+
+void VirtualShadowMap::DeleteResources() {
+    if (m_Texture) {
+        MemoryTracker::RecordGPU(MemoryTag::Shadows, MemoryTracker::GPUKind::Texture,
+                                 -static_cast<i64>(m_ResidentCount * GetPageBytes()));
+        GLMemory::DeleteTextures(1, &m_Texture);
+        m_Texture = 0;
+    }
+    if (m_Framebuffer) {
+        glDeleteFramebuffers(1, &m_Framebuffer);
+        m_Framebuffer = 0;
+    }
+    if (m_PageTableTexture) {
+        GLMemory::DeleteTextures(1, &m_PageTableTexture);
+        m_PageTableTexture = 0;
+    }
+    if (m_RequestBuffer) {
+        GLMemory::DeleteBuffers(1, &m_RequestBuffer);
+        m_RequestBuffer = 0;
+    }
+    m_RequestReadback.reset();
+    m_ResidentCount = 0;
+}
+
+void VirtualShadowMap::LoadShader() {
+    m_MarkShader = CreateRef<Shader>("assets/shaders/shadows/vsm_mark_pages.glsl");
+}
+
+void VirtualShadowMap::Reload() {
+    LoadShader();
+}
+
+void VirtualShadowMap::SetPageBudget(u32 pages) {
+    m_PageBudget = std::clamp(pages, 1u, std::max(m_PagesX * m_PagesY, 1u));
+}
+
+void VirtualShadowMap::BeginFrame(const Camera& camera, const glm::vec3& lightDirection, f32 halfExtent) {
+    if (!IsValid()) return;
+
+    m_FrameNumber++;
+    m_Stats = {};
+
+    UpdateWindow(camera, lightDirection, halfExtent);
+    ReadRequests();
+    UpdateResidency();
+}
+
+void VirtualShadowMap::UpdateWindow(const Camera& camera, const glm::vec3& lightDirection, f32 halfExtent) {
+    const glm::vec3 lightDir = glm::normalize(lightDirection);
+    const bool turned = !m_HasWindow || glm::dot(lightDir, m_LightDirection) < DirectionThreshold;
+    if (turned) {
+        m_LightDirection = lightDir;
+        m_LightRotation = glm::lookAt(glm::vec3(0.0f), lightDir, LightViewUp(lightDir));
+    }
+
+    const glm::vec3 eye = glm::vec3(m_LightRotation * glm::vec4(camera.GetPosition(), 1.0f));
+    const glm::vec3 offset = glm::abs(eye - m_Center);
+    const f32 limit = m_HalfExtent * RecenterFraction;
+    const bool moved = offset.x > limit || offset.y > limit || offset.z > limit;
+
+    if (!turned && !moved && halfExtent == m_HalfExtent) return;
+
+    // Light space looks down -z; the eye sits a window width towards the
+    // light and the depth range reaches as far past the camera. Casters
+    // beyond the near plane are clamped onto it (GL_DEPTH_CLAMP).
+    m_Center = eye;
+    m_HalfExtent = halfExtent;
+    m_View = glm::translate(glm::mat4(1.0f), -glm::vec3(eye.x, eye.y, eye.z + 2.0f * halfExtent)) * m_LightRotation;
+    m_Projection = glm::ortho(-halfExtent, halfExtent, -halfExtent, halfExtent, 0.0f, 4.0f * halfExtent);
+    m_ViewProjection = m_Projection * m_View;
+    m_HasWindow = true;
+
+    // Requests in flight address the old window
+    m_Generation++;
+    std::fill(m_RequestWords.begin(), m_RequestWords.end(), 0u);
+    InvalidateAll();
+}
+
+void VirtualShadowMap::ReadRequests() {
+    u32 slot = 0;
+    if (!m_RequestReadback->Poll(slot) || m_SlotGeneration[slot] != m_Generation) return;
+
+    std::memcpy(m_RequestWords.data(), m_RequestReadback->GetData(slot), m_RequestWords.size() * sizeof(u32));
+
+    for (u32 word = 0; word < static_cast<u32>(m_RequestWords.size()); ++word) {
+        u32 bits = m_RequestWords[word];
+        while (bits) {
+            const u32 page = word * 32 + static_cast<u32>(std::countr_zero(bits));
+            bits &= bits - 1;
+            m_PageLastRequested[page] = m_FrameNumber;
+        }
+    }
+}
+
+bool VirtualShadowMap::IsRequested(u32 page) const {
+    return (m_RequestWords[page / 32] >> (page % 32)) & 1u;
+}
+
+void VirtualShadowMap::UpdateResidency() {
+    const u32 pageCount = m_PagesX * m_PagesY;
+
+    // Eviction candidates, least recently requested first; built on demand
+    bool sorted = false;
+    usize nextEviction = 0;
+    auto evictOne = [&](bool allowRequested) {
+        if (!sorted) {
+            m_EvictionOrder.clear();
+            for (u32 page = 0; page < pageCount; ++page) {
+                if (m_PageFlags[page] & PageResident) m_EvictionOrder.push_back(page);
+            }
+            std::sort(m_EvictionOrder.begin(), m_EvictionOrder.end(), [this](u32 a, u32 b) {
+                const bool requestedA = IsRequested(a);
+                if (requestedA != IsRequested(b)) return !requestedA;
+                return m_PageLastRequested[a] < m_PageLastRequested[b];
+            });
+            sorted = true;
+        }
+        if (nextEviction == m_EvictionOrder.size()) return false;
+
+        const u32 page = m_EvictionOrder[nextEviction];
+        if (!allowRequested && IsRequested(page)) return false;
+        nextEviction++;
+        CommitPage(page, false);
+        m_Stats.PagesEvicted++;
+        return true;
+    };
+
+    // The budget may have shrunk
+    while (m_ResidentCount > m_PageBudget && evictOne(true)) {
+    }
+
+    // New pages get rendered this frame, so commits share the render budget
+    u32 commits = 0;
+    for (u32 page = 0; page < pageCount && commits < m_PagesPerFrame; ++page) {
+        if ((m_PageFlags[page] & PageResident) || !IsRequested(page)) continue;
+        if (m_ResidentCount >= m_PageBudget && !evictOne(false)) break;
+
+        CommitPage(page, true);
+        commits++;
+    }
+
+    m_Stats.PagesCommitted = commits;
+    m_Stats.ResidentPages = m_ResidentCount;
+    for (u32 word : m_RequestWords) {
+        m_Stats.RequiredPages += static_cast<u32>(std::popcount(word));
+    }
+
+    UploadPageTable();
+}
+
+void VirtualShadowMap::CommitPage(u32 page, bool commit) {
+    const GLint x = static_cast<GLint>((page % m_PagesX) * m_PageWidth);
+    const GLint y = static_cast<GLint>((page / m_PagesX) * m_PageHeight);
+
+    // glTexPageCommitmentARB works on the active unit's binding; the active
+    // unit is never changed from 0
+    GLStateCache::Instance().BindTextureUnit(0, m_Texture);
+    glTexPageCommitmentARB(GL_TEXTURE_2D, 0, x, y, 0, static_cast<GLsizei>(m_PageWidth),
+                           static_cast<GLsizei>(m_PageHeight), 1, commit ? GL_TRUE : GL_FALSE);
+
+    const i64 bytes = static_cast<i64>(GetPageBytes());
+    if (commit) {
+        m_PageFlags[page] = PageResident | PageDirty;
+        m_ResidentCount++;
+        MemoryTracker::RecordGPU(MemoryTag::Shadows, MemoryTracker::GPUKind::Texture, bytes);
+    } else {
+        m_PageFlags[page] = 0;
+        m_ResidentCount--;
+        MemoryTracker::RecordGPU(MemoryTag::Shadows, MemoryTracker::GPUKind::Texture, -bytes);
+    }
+
+    if (m_PageTable[page]) {
+        m_PageTable[page] = 0;
+        m_PageTableDirty = true;
+    }
+}
+
+void VirtualShadowMap::UploadPageTable() {
+    if (!m_PageTableDirty) return;
+
+    glTextureSubImage2D(m_PageTableTexture, 0, 0, 0, static_cast<GLsizei>(m_PagesX), static_cast<GLsizei>(m_PagesY),
+                        GL_RED_INTEGER, GL_UNSIGNED_BYTE, m_PageTable.data());
+    m_PageTableDirty = false;
+}
+
+bool VirtualShadowMap::GetPageRange(const AABB& worldBounds, PageRect& outRect) const {
+    // Orthographic along the light: a caster's shadow lands on the texels
+    // under its own footprint, at any depth
+    glm::vec2 minUV(std::numeric_limits<f32>::max());
+    glm::vec2 maxUV(std::numeric_limits<f32>::lowest());
+    for (u32 corner = 0; corner < 8; ++corner) {
+        const glm::vec3 point((corner & 1) ? worldBounds.Max.x : worldBounds.Min.x,
+                              (corner & 2) ? worldBounds.Max.y : worldBounds.Min.y,
+                              (corner & 4) ? worldBounds.Max.z : worldBounds.Min.z);
+        const glm::vec2 uv = glm::vec2(m_ViewProjection * glm::vec4(point, 1.0f)) * 0.5f + 0.5f;
+        minUV = glm::min(minUV, uv);
+        maxUV = glm::max(maxUV, uv);
+    }
+
+    if (maxUV.x < 0.0f || maxUV.y < 0.0f || minUV.x >= 1.0f || minUV.y >= 1.0f) return false;
+
+    const glm::vec2 pages(static_cast<f32>(m_PagesX), static_cast<f32>(m_PagesY));
+    const glm::uvec2 first = glm::uvec2(glm::clamp(minUV * pages, glm::vec2(0.0f), pages - 1.0f));
+    const glm::uvec2 last = glm::uvec2(glm::clamp(maxUV * pages, glm::vec2(0.0f), pages - 1.0f));
+
+    outRect.X = first.x;
+    outRect.Y = first.y;
+    outRect.Width = last.x - first.x + 1;
+    outRect.Height = last.y - first.y + 1;
+    return true;
+}
+
+void VirtualShadowMap::MarkDirty(const PageRect& rect) {
+    for (u32 y = rect.Y; y < rect.Y + rect.Height; ++y) {
+        for (u32 x = rect.X; x < rect.X + rect.Width; ++x) {
+            const u32 page = y * m_PagesX + x;
+            if (!(m_PageFlags[page] & PageResident)) continue;
+
+            m_PageFlags[page] |= PageDirty;
+            if (m_PageTable[page]) {
+                m_PageTable[page] = 0;
+                m_PageTableDirty = true;
+            }
+        }
+    }
+}
+
+void VirtualShadowMap::TrackCaster(entt::entity entity, const AABB& worldBounds) {
+    PageRect rect;
+    if (m_HasWindow) {
+        auto it = m_CasterBounds.find(entity);
+        if (it != m_CasterBounds.end() && GetPageRange(it->second, rect)) {
+            MarkDirty(rect);
+        }
+        if (GetPageRange(worldBounds, rect)) {
+            MarkDirty(rect);
+        }
+    }
+    m_CasterBounds[entity] = worldBounds;
+}
+
+void VirtualShadowMap::ForgetCaster(entt::entity entity) {
+    auto it = m_CasterBounds.find(entity);
+    if (it == m_CasterBounds.end()) return;
+
+    PageRect rect;
+    if (m_HasWindow && GetPageRange(it->second, rect)) {
+        MarkDirty(rect);
+    }
+    m_CasterBounds.erase(it);
+}
+
+void VirtualShadowMap::InvalidateAll() {
+    for (u32 page = 0; page < static_cast<u32>(m_PageFlags.size()); ++page) {
+        if (m_PageFlags[page] & PageResident) {
+            m_PageFlags[page] |= PageDirty;
+        }
+    }
+    std::fill(m_PageTable.begin(), m_PageTable.end(), u8{0});
+    m_PageTableDirty = true;
+}
+
+const Vector<VirtualShadowMap::PageRect>& VirtualShadowMap::CollectDirtyRects() {
+    m_DirtyRects.clear();
+    if (!IsValid()) return m_DirtyRects;
+
+    std::fill(m_Queued.begin(), m_Queued.end(), u8{0});
+
+    // Only requested pages are drawn; the rest stay dirty until they are
+    auto pending = [this](u32 x, u32 y) {
+        const u32 page = y * m_PagesX + x;
+        return m_PageFlags[page] == (PageResident | PageDirty) && !m_Queued[page] && IsRequested(page);
+    };
+
+    u32 budget = m_PagesPerFrame;
+    for (u32 y = 0; y < m_PagesY && budget > 0; ++y) {
+        for (u32 x = 0; x < m_PagesX && budget > 0; ++x) {
+            if (!pending(x, y)) continue;
+
+            // A horizontal run, grown downwards while the rows below match
+            PageRect rect{x, y, 1, 1};
+            while (rect.X + rect.Width < m_PagesX && rect.Width < budget && pending(rect.X + rect.Width, y)) {
+                rect.Width++;
+            }
+            while (rect.Y + rect.Height < m_PagesY && (rect.Height + 1) * rect.Width <= budget) {
+                bool matches = true;
+                for (u32 column = rect.X; column < rect.X + rect.Width && matches; ++column) {
+                    matches = pending(column, rect.Y + rect.Height);
+                }
+                if (!matches) break;
+                rect.Height++;
+            }
+
+            for (u32 row = rect.Y; row < rect.Y + rect.Height; ++row) {
+                std::fill_n(m_Queued.begin() + row * m_PagesX + rect.X, rect.Width, u8{1});
+            }
+            budget -= rect.Width * rect.Height;
+            m_DirtyRects.push_back(rect);
+            x += rect.Width - 1;
+        }
+    }
+
+    for (u8 flags : m_PageFlags) {
+        m_Stats.DirtyPages += flags == (PageResident | PageDirty) ? 1 : 0;
+    }
+    return m_DirtyRects;
+}
+
+glm::mat4 VirtualShadowMap::GetRectViewProjection(const PageRect& rect) const {
+    // Maps the rectangle's part of NDC onto the whole of it, so a viewport
+    // of the rectangle puts every texel where the full projection would
+    const glm::vec2 pages(static_cast<f32>(m_PagesX), static_cast<f32>(m_PagesY));
+    const glm::vec2 minNDC = glm::vec2(static_cast<f32>(rect.X), static_cast<f32>(rect.Y)) / pages * 2.0f - 1.0f;
+    const glm::vec2 maxNDC = glm::vec2(static_cast<f32>(rect.X + rect.Width), static_cast<f32>(rect.Y + rect.Height)) /
+                             pages * 2.0f - 1.0f;
+
+    const glm::vec2 scale = 2.0f / (maxNDC - minNDC);
+    const glm::vec2 center = (minNDC + maxNDC) * 0.5f;
+
+    glm::mat4 crop(1.0f);
+    crop[0][0] = scale.x;
+    crop[1][1] = scale.y;
+    crop[3][0] = -center.x * scale.x;
+    crop[3][1] = -center.y * scale.y;
+    return crop * m_ViewProjection;
+}
+
+void VirtualShadowMap::BindForRect(const PageRect& rect) {
+    auto& state = GLStateCache::Instance();
+    const GLint x = static_cast<GLint>(rect.X * m_PageWidth);
+    const GLint y = static_cast<GLint>(rect.Y * m_PageHeight);
+    const GLsizei width = static_cast<GLsizei>(rect.Width * m_PageWidth);
+    const GLsizei height = static_cast<GLsizei>(rect.Height * m_PageHeight);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+    glViewport(x, y, width, height);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(x, y, width, height);
+
+    state.SetDepthTest(true);
+    state.SetDepthFunc(GL_LESS);
+    state.SetDepthWrite(true);
+    glEnable(GL_DEPTH_CLAMP);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(1.1f, 4.0f);
+
+    glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+void VirtualShadowMap::Unbind() {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_DEPTH_CLAMP);
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+void VirtualShadowMap::MarkRendered() {
+    for (const PageRect& rect : m_DirtyRects) {
+        for (u32 y = rect.Y; y < rect.Y + rect.Height; ++y) {
+            for (u32 x = rect.X; x < rect.X + rect.Width; ++x) {
+                const u32 page = y * m_PagesX + x;
+                m_PageFlags[page] &= static_cast<u8>(~PageDirty);
+                m_PageTable[page] = 1;
+            }
+        }
+        m_Stats.PagesRendered += rect.Width * rect.Height;
+    }
+    m_Stats.DirtyPages -= std::min(m_Stats.DirtyPages, m_Stats.PagesRendered);
+
+    if (!m_DirtyRects.empty()) {
+        m_PageTableDirty = true;
+        UploadPageTable();
+    }
+    m_DirtyRects.clear();
+}
+
+void VirtualShadowMap::MarkRequiredPages(const GBuffer& gbuffer, const glm::mat4& viewProjection, f32 filterTexels) {
+    if (!IsValid() || !m_HasWindow || !m_MarkShader) return;
+
+    const u32 zero = 0;
+    glClearNamedBufferData(m_RequestBuffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+
+    const u32 width = gbuffer.GetViewportWidth();
+    const u32 height = gbuffer.GetViewportHeight();
+
+    m_MarkShader->Bind();
+    m_MarkShader->SetInt2("u_DepthSize", glm::ivec2(static_cast<i32>(width), static_cast<i32>(height)));
+    m_MarkShader->SetMat4("u_InvViewProjection", glm::inverse(viewProjection));
+    m_MarkShader->SetMat4("u_ShadowViewProjection", m_ViewProjection);
+    m_MarkShader->SetInt2("u_PageCount", glm::ivec2(static_cast<i32>(m_PagesX), static_cast<i32>(m_PagesY)));
+    m_MarkShader->SetFloat("u_FilterRadius", filterTexels / static_cast<f32>(VSM_VIRTUAL_RESOLUTION));
+
+    GLStateCache::Instance().BindTextureUnit(0, gbuffer.GetDepthTextureID());
+    GLStateCache::Instance().BindBufferBase(GL_SHADER_STORAGE_BUFFER, RequestBinding, m_RequestBuffer);
+
+    glDispatchCompute((width + MarkGroupSize - 1) / MarkGroupSize, (height + MarkGroupSize - 1) / MarkGroupSize, 1);
+
+    // The readback copy reads what the atomics wrote
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    const u32 slot = m_RequestReadback->Enqueue(m_RequestBuffer);
+    m_SlotGeneration[slot] = m_Generation;
+}
+
+void VirtualShadowMap::BindTexture(u32 slot) const {
+    GLStateCache::Instance().BindTextureUnit(slot, m_Texture);
+}
+
+void VirtualShadowMap::BindPageTable(u32 slot) const {
+    GLStateCache::Instance().BindTextureUnit(slot, m_PageTableTexture);
+}
+
+void VirtualShadowMap::FillGPUData(GPUVirtualShadowData& outData, f32 bias, f32 normalBias) const {
+    outData.ViewProjection = m_ViewProjection;
+    outData.Params = glm::vec4(
+        1.0f / static_cast<f32>(VSM_VIRTUAL_RESOLUTION),
+        bias,
+        normalBias,
+        IsValid() && m_HasWindow ? 1.0f : 0.0f
+    );
+}
+
+} // namespace Engine
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/shadows/ShadowTypes.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include "renderer/opengl/GPUReadbackBuffer.hpp"
+#include "camera/Camera.hpp"
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+#include <algorithm>
+
+namespace Engine {
+
+class GBuffer;
+
+// VirtualShadowMap - one VSM_VIRTUAL_RESOLUTION^2 directional shadow map
+// backed by sparse pages (GL_ARB_sparse_texture).
+//
+// The map is an orthographic window around the camera in light space
+// (ShadowSettings::VirtualShadowDistance to each side), so every surface in
+// it gets the same texel density; the cascades cover the rest. After
+// the geometry pass, a compute pass (vsm_mark_pages.glsl) projects the
+// G-Buffer depth into the map and sets a bit for every page a lighting
+// lookup will touch. The bits come back a few frames later; required pages
+// are committed up to a budget, least recently required pages are released
+// to make room.
+//
+// Page contents are cached across frames: a page is only rendered again
+// when it is dirty - newly committed, under the old or new bounds of a
+// dynamic caster that moved, or everything after the light turned, the
+// window re-centred or static geometry changed. Dirty pages are merged into
+// rectangles and drawn with a projection cropped to each, at most a page
+// budget per frame.
+//
+// The page table (R8UI, one texel per page) is 1 where a page holds a valid
+// render; the lighting pass falls back to the cascades everywhere else.
+class VirtualShadowMap {
+public:
+    // Must match vsm_mark_pages.glsl
+    static constexpr u32 RequestBinding = 0;    // SSBO, one bit per page
+
+    // A rectangle of pages
+    struct PageRect {
+        u32 X = 0;
+        u32 Y = 0;
+        u32 Width = 0;
+        u32 Height = 0;
+    };
+
+    struct Stats {
+        u32 ResidentPages = 0;
+        u32 RequiredPages = 0;      // In the newest request readback
+        u32 DirtyPages = 0;         // Resident pages waiting for a render
+        u32 PagesRendered = 0;
+        u32 PagesCommitted = 0;
+        u32 PagesEvicted = 0;
+    };
+
+    VirtualShadowMap();
+    ~VirtualShadowMap();
+
+    VirtualShadowMap(const VirtualShadowMap&) = delete;
+    VirtualShadowMap& operator=(const VirtualShadowMap&) = delete;
+
+    // Sparse GL_DEPTH_COMPONENT32F 2D textures of the virtual size
+    static bool IsSupported();
+    bool IsValid() const { return m_Texture != 0; }
+
+    void SetPageBudget(u32 pages);
+    void SetPagesPerFrame(u32 pages) { m_PagesPerFrame = std::max(pages, 1u); }
+
+    // Once a frame before rendering: follow the camera and the light (the
+    // window spans halfExtent around the camera), take the newest page
+    // requests and commit and evict pages
+    void BeginFrame(const Camera& camera, const glm::vec3& lightDirection, f32 halfExtent);
+
+    // Pages under a dynamic caster's previous and current bounds are drawn
+    // again; ForgetCaster when it stops casting or is destroyed
+    void TrackCaster(entt::entity entity, const AABB& worldBounds);
+    void ForgetCaster(entt::entity entity);
+    void ClearCasters() { m_CasterBounds.clear(); }
+
+    // Every page is drawn again (static casters changed)
+    void InvalidateAll();
+
+    // Dirty pages that are resident and requested, merged into rectangles;
+    // after BeginFrame() and the casters of the frame were tracked
+    const Vector<PageRect>& CollectDirtyRects();
+    glm::mat4 GetRectViewProjection(const PageRect& rect) const;
+
+    // Target and clear one rectangle; MarkRendered() once all are drawn
+    void BindForRect(const PageRect& rect);
+    void Unbind();
+    void MarkRendered();
+
+    // After the main view's geometry pass: request the pages its depth
+    // samples land in. filterTexels widens each lookup for the PCF kernel.
+    void MarkRequiredPages(const GBuffer& gbuffer, const glm::mat4& viewProjection, f32 filterTexels);
+
+    void BindTexture(u32 slot) const;
+    void BindPageTable(u32 slot) const;
+    void FillGPUData(GPUVirtualShadowData& outData, f32 bias, f32 normalBias) const;
+
+    const glm::mat4& GetViewProjection() const { return m_ViewProjection; }
+    u32 GetPageCountX() const { return m_PagesX; }
+    u32 GetPageCountY() const { return m_PagesY; }
+    u32 GetPageBudget() const { return m_PageBudget; }
+    usize GetPageBytes() const { return static_cast<usize>(m_PageWidth) * m_PageHeight * sizeof(f32); }
+    const Stats& GetStats() const { return m_Stats; }
+
+    void Reload();
+
+private:
+    enum PageFlags : u8 {
+        PageResident = 1 << 0,
+        PageDirty = 1 << 1
+    };
+
+    void CreateResources();
+    void DeleteResources();
+    void LoadShader();
+
+    void UpdateWindow(const Camera& camera, const glm::vec3& lightDirection, f32 halfExtent);
+    void ReadRequests();
+    void UpdateResidency();
+    void UploadPageTable();
+
+    bool IsRequested(u32 page) const;
+    void CommitPage(u32 page, bool commit);
+
+    // Pages covered by world bounds under the current projection; false if
+    // it misses the map
+    bool GetPageRange(const AABB& worldBounds, PageRect& outRect) const;
+    void MarkDirty(const PageRect& rect);
+
+private:
+    Ref<Shader> m_MarkShader;
+
+    u32 m_Texture = 0;
+    u32 m_Framebuffer = 0;
+    u32 m_PageTableTexture = 0;
+    u32 m_RequestBuffer = 0;
+    Scope<GPUReadbackBuffer> m_RequestReadback;
+
+    // Projection generation each readback slot was requested under; bits
+    // from an older window address different pages
+    u32 m_SlotGeneration[GPUReadbackBuffer::SlotCount] = {};
+    u32 m_Generation = 0;
+
+    u32 m_PageWidth = 0;                // Texels
+    u32 m_PageHeight = 0;
+    u32 m_PagesX = 0;
+    u32 m_PagesY = 0;
+    u32 m_PageBudget = 0;
+    u32 m_PagesPerFrame = 0;
+
+    Vector<u8> m_PageFlags;
+    Vector<u32> m_PageLastRequested;    // Frame of the last request, 0 = never
+    Vector<u8> m_PageTable;             // Uploaded copy: 1 = resident and rendered
+    Vector<u32> m_RequestWords;         // Newest readback
+    Vector<u32> m_EvictionOrder;        // Scratch
+    Vector<u8> m_Queued;                // Scratch, pages already in a rect
+    bool m_PageTableDirty = true;
+    u32 m_ResidentCount = 0;
+
+    Vector<PageRect> m_DirtyRects;
+    HashMap<entt::entity, AABB> m_CasterBounds;
+
+    // Window: light rotation and the camera position it was centred on
+    glm::mat4 m_LightRotation{1.0f};
+    glm::vec3 m_LightDirection{0.0f};
+    glm::vec3 m_Center{0.0f};           // Light space
+    f32 m_HalfExtent = 0.0f;
+    glm::mat4 m_View{1.0f};
+    glm::mat4 m_Projection{1.0f};
+    glm::mat4 m_ViewProjection{1.0f};
+    bool m_HasWindow = false;
+
+    u32 m_FrameNumber = 0;
+    Stats m_Stats;
+};
+
+} // namespace Engine
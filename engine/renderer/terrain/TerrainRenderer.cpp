@@ -0,0 +1,549 @@
+#include "renderer/terrain/TerrainRenderer.hpp"
+#include "renderer/opengl/GLBuffer.hpp"
+#include "renderer/opengl/GLStateCache.hpp"
+#include "renderer/opengl/PipelineWarmup.hpp"
+#include "renderer/Material.hpp"
+#include "resources/ResourceManager.hpp"
+#include "camera/Camera.hpp"
+#include "math/Frustum.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Logger.hpp"
+
+#include <glad/gl.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Engine {
+
+namespace {
+
+bool IsPowerOfTwo(u32 value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+u32 Log2(u32 value) {
+    u32 result = 0;
+    while (value > 1) {
+        value >>= 1;
+        ++result;
+    }
+    return result;
+}
+
+f32 DistanceSquared(const AABB& box, const glm::vec3& point) {
+    const glm::vec3 nearest = glm::clamp(point, box.Min, box.Max);
+    const glm::vec3 d = nearest - point;
+    return glm::dot(d, d);
+}
+
+// Mip chain layout of a square image of size texels and bytesPerTexel
+void SetLevels(TextureImage& image, u32 size, u32 bytesPerTexel) {
+    usize offset = 0;
+    for (u32 levelSize = size;; levelSize >>= 1) {
+        TextureMipLevel level;
+        level.Width = levelSize;
+        level.Height = levelSize;
+        level.Offset = offset;
+        level.Size = static_cast<usize>(levelSize) * levelSize * bytesPerTexel;
+        image.Levels.push_back(level);
+        offset += level.Size;
+        if (levelSize == 1) break;
+    }
+    image.Width = size;
+    image.Height = size;
+    image.Pixels.resize(offset);
+}
+
+} // anonymous namespace
+
+TerrainRenderer::TerrainRenderer() {
+    m_NodeRing = CreateScope<GPURingBuffer>(1024 * sizeof(GPUNode));
+    LoadShaders();
+}
+
+TerrainRenderer::~TerrainRenderer() {
+    Clear();
+}
+
+void TerrainRenderer::LoadShaders() {
+    ShaderDefines defines = MaterialLibrary::Instance().GetShaderDefines();
+    m_Shader = CreateRef<Shader>("assets/shaders/deferred/terrain.glsl", "", defines);
+    m_DepthShader = CreateRef<Shader>("assets/shaders/deferred/terrain.glsl", "", ShaderDefines{{"DEPTH_ONLY", ""}});
+}
+
+void TerrainRenderer::Reload() {
+    LoadShaders();
+}
+
+void TerrainRenderer::CreateGrid() {
+    // A quarter node: (NodeResolution / 2)^2 quads of integer grid coordinates
+    const u32 quads = m_Settings.NodeResolution / 2;
+    const u32 row = quads + 1;
+
+    Vector<f32> vertices;
+    vertices.reserve(row * row * 2);
+    for (u32 z = 0; z <= quads; ++z) {
+        for (u32 x = 0; x <= quads; ++x) {
+            vertices.push_back(static_cast<f32>(x));
+            vertices.push_back(static_cast<f32>(z));
+        }
+    }
+
+    // Counter-clockwise seen from +Y
+    Vector<u32> indices;
+    indices.reserve(quads * quads * 6);
+    for (u32 z = 0; z < quads; ++z) {
+        for (u32 x = 0; x < quads; ++x) {
+            const u32 a = z * row + x;
+            const u32 b = a + 1;
+            const u32 c = a + row;
+            const u32 d = c + 1;
+            indices.insert(indices.end(), {a, c, b, b, c, d});
+        }
+    }
+
+    m_GridVAO = CreateRef<VertexArray>();
+    auto vbo = CreateRef<VertexBuffer>(vertices.data(), static_cast<u32>(vertices.size() * sizeof(f32)));
+    vbo->SetLayout({
+        { ShaderDataType::Float2, "a_Grid" }
+    });
+    auto ibo = CreateRef<IndexBuffer>(indices.data(), static_cast<u32>(indices.size()));
+    m_GridVAO->AddVertexBuffer(vbo);
+    m_GridVAO->SetIndexBuffer(ibo);
+    m_GridIndexCount = static_cast<u32>(indices.size());
+}
+
+void TerrainRenderer::Clear() {
+    TextureStreamer& streamer = ResourceManager::Instance().GetTextureStreamer();
+    for (const Tile& tile : m_Tiles) {
+        if (tile.Height) streamer.Unregister(*tile.Height);
+        if (tile.Splat) streamer.Unregister(*tile.Splat);
+    }
+
+    m_Tiles.clear();
+    m_Heights.clear();
+    m_LevelReach.clear();
+    m_Nodes.clear();
+    m_Draws.clear();
+    m_Width = m_Depth = 0;
+    m_TilesX = m_TilesZ = 0;
+    m_LevelCount = 0;
+    m_Bounds = AABB();
+    m_Stats = {};
+}
+
+bool TerrainRenderer::Build(const TerrainSettings& settings, u32 width, u32 depth, const Vector<f32>& heights,
+                            const Vector<u8>& splat) {
+    if (width < 2 || depth < 2 || heights.size() != static_cast<usize>(width) * depth) {
+        LOG_CORE_ERROR("TerrainRenderer: {} heights for a {}x{} heightfield", heights.size(), width, depth);
+        return false;
+    }
+    if (!splat.empty() && splat.size() != heights.size() * 4) {
+        LOG_CORE_ERROR("TerrainRenderer: splat map needs four weights per height sample");
+        return false;
+    }
+    if (!IsPowerOfTwo(settings.TileResolution) || !IsPowerOfTwo(settings.NodeResolution) ||
+        settings.NodeResolution < 2 || settings.NodeResolution > settings.TileResolution) {
+        LOG_CORE_ERROR("TerrainRenderer: tile ({}) and node ({}) resolutions must be powers of two, node <= tile",
+                       settings.TileResolution, settings.NodeResolution);
+        return false;
+    }
+
+    Clear();
+
+    m_Settings = settings;
+    m_Settings.SampleSpacing = std::max(settings.SampleSpacing, 1e-3f);
+    m_Settings.MorphRegion = std::clamp(settings.MorphRegion, 0.01f, 1.0f);
+
+    // Shorter reaches let levels more than one apart touch, which the morph
+    // can't stitch
+    const f32 leafDiagonal = 1.4142f * static_cast<f32>(m_Settings.NodeResolution) * m_Settings.SampleSpacing;
+    m_Settings.LODDistance = std::max(settings.LODDistance, 2.0f * leafDiagonal);
+
+    m_Width = width;
+    m_Depth = depth;
+    m_Heights.resize(heights.size());
+    for (usize i = 0; i < heights.size(); ++i) {
+        m_Heights[i] = static_cast<u16>(std::round(std::clamp(heights[i], 0.0f, 1.0f) * 65535.0f));
+    }
+
+    const u32 tileQuads = m_Settings.TileResolution;
+    m_TilesX = (width - 2) / tileQuads + 1;
+    m_TilesZ = (depth - 2) / tileQuads + 1;
+    m_LevelCount = Log2(tileQuads / m_Settings.NodeResolution) + 1;
+
+    m_LevelReach.resize(m_LevelCount);
+    for (u32 level = 0; level < m_LevelCount; ++level) {
+        m_LevelReach[level] = m_Settings.LODDistance * static_cast<f32>(1u << level);
+    }
+    m_LevelReach.back() = std::numeric_limits<f32>::max();
+
+    m_Tiles.resize(m_TilesX * m_TilesZ);
+    for (u32 z = 0; z < m_TilesZ; ++z) {
+        for (u32 x = 0; x < m_TilesX; ++x) {
+            Tile& tile = m_Tiles[z * m_TilesX + x];
+            tile.Sample = glm::ivec2(x * tileQuads, z * tileQuads);
+            const bool right = x + 1 < m_TilesX;
+            const bool up = z + 1 < m_TilesZ;
+            tile.Neighbours[0] = right ? static_cast<i32>(z * m_TilesX + x + 1) : -1;
+            tile.Neighbours[1] = up ? static_cast<i32>((z + 1) * m_TilesX + x) : -1;
+            tile.Neighbours[2] = right && up ? static_cast<i32>((z + 1) * m_TilesX + x + 1) : -1;
+        }
+    }
+
+    // Decoding and the height pyramids are per tile; only the uploads need
+    // the GL thread
+    const u32 tileCount = static_cast<u32>(m_Tiles.size());
+    Vector<TextureImage> heightImages(tileCount);
+    Vector<TextureImage> splatImages(tileCount);
+    JobSystem::ParallelFor(tileCount, 1, [&](u32 first, u32 last) {
+        for (u32 i = first; i < last; ++i) {
+            BuildHeightRanges(m_Tiles[i]);
+            heightImages[i] = BuildHeightImage(m_Tiles[i]);
+            splatImages[i] = BuildSplatImage(m_Tiles[i], splat);
+        }
+    });
+
+    f32 minHeight = 1.0f;
+    f32 maxHeight = 0.0f;
+    for (u32 i = 0; i < tileCount; ++i) {
+        Tile& tile = m_Tiles[i];
+        const String name = "terrain/" + std::to_string(i % m_TilesX) + "_" + std::to_string(i / m_TilesX);
+        tile.Height = UploadTileTexture(name + "/height", std::move(heightImages[i]));
+        tile.Splat = UploadTileTexture(name + "/splat", std::move(splatImages[i]));
+
+        const glm::vec2& range = tile.HeightRanges.back()[0];
+        minHeight = std::min(minHeight, range.x);
+        maxHeight = std::max(maxHeight, range.y);
+    }
+
+    const f32 extentX = static_cast<f32>(m_TilesX * tileQuads) * m_Settings.SampleSpacing;
+    const f32 extentZ = static_cast<f32>(m_TilesZ * tileQuads) * m_Settings.SampleSpacing;
+    m_Bounds = AABB(m_Settings.Origin + glm::vec3(0.0f, minHeight * m_Settings.HeightScale, 0.0f),
+                    m_Settings.Origin + glm::vec3(extentX, maxHeight * m_Settings.HeightScale, extentZ));
+
+    if (!m_GridVAO || m_GridIndexCount != (m_Settings.NodeResolution / 2) * (m_Settings.NodeResolution / 2) * 6) {
+        CreateGrid();
+    }
+
+    m_Stats.Tiles = tileCount;
+    LOG_CORE_INFO("TerrainRenderer: {}x{} samples in {}x{} tiles, {} levels", width, depth, m_TilesX, m_TilesZ,
+                  m_LevelCount);
+    return true;
+}
+
+f32 TerrainRenderer::GetSample(i32 x, i32 z) const {
+    x = std::clamp(x, 0, static_cast<i32>(m_Width) - 1);
+    z = std::clamp(z, 0, static_cast<i32>(m_Depth) - 1);
+    return static_cast<f32>(m_Heights[static_cast<usize>(z) * m_Width + x]) / 65535.0f;
+}
+
+f32 TerrainRenderer::GetHeight(f32 x, f32 z) const {
+    if (m_Heights.empty()) return m_Settings.Origin.y;
+
+    const f32 sx = (x - m_Settings.Origin.x) / m_Settings.SampleSpacing;
+    const f32 sz = (z - m_Settings.Origin.z) / m_Settings.SampleSpacing;
+    const i32 ix = static_cast<i32>(std::floor(sx));
+    const i32 iz = static_cast<i32>(std::floor(sz));
+    const f32 fx = std::clamp(sx - static_cast<f32>(ix), 0.0f, 1.0f);
+    const f32 fz = std::clamp(sz - static_cast<f32>(iz), 0.0f, 1.0f);
+
+    const f32 h0 = glm::mix(GetSample(ix, iz), GetSample(ix + 1, iz), fx);
+    const f32 h1 = glm::mix(GetSample(ix, iz + 1), GetSample(ix + 1, iz + 1), fx);
+    return m_Settings.Origin.y + glm::mix(h0, h1, fz) * m_Settings.HeightScale;
+}
+
+void TerrainRenderer::BuildHeightRanges(Tile& tile) const {
+    const u32 node = m_Settings.NodeResolution;
+    const u32 leaves = m_Settings.TileResolution / node;
+
+    tile.HeightRanges.assign(m_LevelCount, {});
+    Vector<glm::vec2>& leafRanges = tile.HeightRanges[0];
+    leafRanges.resize(leaves * leaves);
+
+    // Leaves span node + 1 samples, sharing their edges with the next
+    for (u32 nz = 0; nz < leaves; ++nz) {
+        for (u32 nx = 0; nx < leaves; ++nx) {
+            glm::vec2 range(1.0f, 0.0f);
+            const i32 x0 = tile.Sample.x + static_cast<i32>(nx * node);
+            const i32 z0 = tile.Sample.y + static_cast<i32>(nz * node);
+            for (i32 z = z0; z <= z0 + static_cast<i32>(node); ++z) {
+                for (i32 x = x0; x <= x0 + static_cast<i32>(node); ++x) {
+                    const f32 h = GetSample(x, z);
+                    range.x = std::min(range.x, h);
+                    range.y = std::max(range.y, h);
+                }
+            }
+            leafRanges[nz * leaves + nx] = range;
+        }
+    }
+
+    for (u32 level = 1; level < m_LevelCount; ++level) {
+        const Vector<glm::vec2>& children = tile.HeightRanges[level - 1];
+        const u32 childCount = leaves >> (level - 1);
+        const u32 count = leaves >> level;
+        Vector<glm::vec2>& ranges = tile.HeightRanges[level];
+        ranges.resize(count * count);
+        for (u32 z = 0; z < count; ++z) {
+            for (u32 x = 0; x < count; ++x) {
+                glm::vec2 range(1.0f, 0.0f);
+                for (u32 c = 0; c < 4; ++c) {
+                    const glm::vec2& child = children[(z * 2 + (c >> 1)) * childCount + x * 2 + (c & 1)];
+                    range.x = std::min(range.x, child.x);
+                    range.y = std::max(range.y, child.y);
+                }
+                ranges[z * count + x] = range;
+            }
+        }
+    }
+}
+
+TextureImage TerrainRenderer::BuildHeightImage(const Tile& tile) const {
+    // Point-sampled chain: texel i of mip m is sample i * 2^m exactly, so a
+    // level-m node reads its vertices from mip m unfiltered
+    TextureImage image;
+    image.Format = TextureFormat::RG8;
+    SetLevels(image, m_Settings.TileResolution, 2);
+
+    for (u32 mip = 0; mip < image.Levels.size(); ++mip) {
+        const TextureMipLevel& level = image.Levels[mip];
+        u8* texels = image.Pixels.data() + level.Offset;
+        for (u32 z = 0; z < level.Height; ++z) {
+            for (u32 x = 0; x < level.Width; ++x) {
+                const i32 sx = tile.Sample.x + static_cast<i32>(x << mip);
+                const i32 sz = tile.Sample.y + static_cast<i32>(z << mip);
+                const u16 h = m_Heights[static_cast<usize>(std::clamp(sz, 0, static_cast<i32>(m_Depth) - 1)) * m_Width +
+                                        std::clamp(sx, 0, static_cast<i32>(m_Width) - 1)];
+                u8* texel = texels + (static_cast<usize>(z) * level.Width + x) * 2;
+                texel[0] = static_cast<u8>(h >> 8);
+                texel[1] = static_cast<u8>(h & 0xFF);
+            }
+        }
+    }
+    return image;
+}
+
+TextureImage TerrainRenderer::BuildSplatImage(const Tile& tile, const Vector<u8>& splat) const {
+    TextureImage image;
+    image.Format = TextureFormat::RGBA8;
+    SetLevels(image, m_Settings.TileResolution, 4);
+
+    const TextureMipLevel& base = image.Levels[0];
+    u8* texels = image.Pixels.data();
+    for (u32 z = 0; z < base.Height; ++z) {
+        for (u32 x = 0; x < base.Width; ++x) {
+            u8* texel = texels + (static_cast<usize>(z) * base.Width + x) * 4;
+            if (splat.empty()) {
+                texel[0] = 255;
+                texel[1] = texel[2] = texel[3] = 0;
+                continue;
+            }
+            const i32 sx = std::clamp(tile.Sample.x + static_cast<i32>(x), 0, static_cast<i32>(m_Width) - 1);
+            const i32 sz = std::clamp(tile.Sample.y + static_cast<i32>(z), 0, static_cast<i32>(m_Depth) - 1);
+            std::copy_n(splat.data() + (static_cast<usize>(sz) * m_Width + sx) * 4, 4, texel);
+        }
+    }
+
+    // Weights average down, unlike heights
+    for (u32 mip = 1; mip < image.Levels.size(); ++mip) {
+        const TextureMipLevel& source = image.Levels[mip - 1];
+        const TextureMipLevel& level = image.Levels[mip];
+        const u8* src = image.Pixels.data() + source.Offset;
+        u8* dst = image.Pixels.data() + level.Offset;
+        for (u32 z = 0; z < level.Height; ++z) {
+            for (u32 x = 0; x < level.Width; ++x) {
+                for (u32 c = 0; c < 4; ++c) {
+                    const usize row0 = (static_cast<usize>(z * 2) * source.Width + x * 2) * 4 + c;
+                    const usize row1 = row0 + static_cast<usize>(source.Width) * 4;
+                    const u32 sum = src[row0] + src[row0 + 4] + src[row1] + src[row1 + 4];
+                    dst[(static_cast<usize>(z) * level.Width + x) * 4 + c] = static_cast<u8>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+    return image;
+}
+
+Ref<Texture2D> TerrainRenderer::UploadTileTexture(const String& name, TextureImage image) {
+    // As ResourceManager uploads streamable textures
+    TextureStreamer& streamer = ResourceManager::Instance().GetTextureStreamer();
+    Ref<Texture2D> texture = Texture2D::CreatePending(name, false);
+    if (!streamer.GetSettings().Enabled || !TextureStreamer::CanStream(image)) {
+        texture->Upload(image);
+        return texture;
+    }
+
+    texture->Upload(image, streamer.GetInitialMip(image));
+    if (texture->IsLoaded()) {
+        streamer.Register(texture, std::move(image));
+    }
+    return texture;
+}
+
+AABB TerrainRenderer::GetNodeBounds(const Tile& tile, u32 level, u32 x, u32 z) const {
+    const u32 count = (m_Settings.TileResolution / m_Settings.NodeResolution) >> level;
+    const glm::vec2& range = tile.HeightRanges[level][z * count + x];
+    const f32 size = static_cast<f32>(m_Settings.NodeResolution << level) * m_Settings.SampleSpacing;
+
+    const glm::vec3 min = m_Settings.Origin + glm::vec3(
+        (static_cast<f32>(tile.Sample.x) * m_Settings.SampleSpacing) + static_cast<f32>(x) * size,
+        range.x * m_Settings.HeightScale,
+        (static_cast<f32>(tile.Sample.y) * m_Settings.SampleSpacing) + static_cast<f32>(z) * size);
+    return AABB(min, glm::vec3(min.x + size, m_Settings.Origin.y + range.y * m_Settings.HeightScale, min.z + size));
+}
+
+void TerrainRenderer::AddQuarter(const Tile& tile, u32 level, u32 x, u32 z, u32 quarter) {
+    const i32 nodeSamples = static_cast<i32>(m_Settings.NodeResolution << level);
+    const i32 half = nodeSamples / 2;
+
+    GPUNode node{};
+    node.Sample = tile.Sample + glm::ivec2(static_cast<i32>(x) * nodeSamples + static_cast<i32>(quarter & 1) * half,
+                                           static_cast<i32>(z) * nodeSamples + static_cast<i32>(quarter >> 1) * half);
+    node.Level = level;
+
+    // Morph into the next level over the end of this one's reach
+    if (level + 1 < m_LevelCount) {
+        const f32 end = m_LevelReach[level];
+        const f32 start = end * (1.0f - m_Settings.MorphRegion);
+        node.MorphStart = start;
+        node.MorphScale = 1.0f / (end - start);
+    } else {
+        node.MorphStart = std::numeric_limits<f32>::max();
+        node.MorphScale = 0.0f;
+    }
+    m_Nodes.push_back(node);
+}
+
+// Strugar's LODSelect. False when the node is out of its own level's reach,
+// leaving it to the parent to draw that area coarser.
+bool TerrainRenderer::SelectNode(const Tile& tile, const Frustum& frustum, const glm::vec3& cameraPos, u32 level,
+                                 u32 x, u32 z, u32& finestLevel) {
+    const AABB bounds = GetNodeBounds(tile, level, x, z);
+    const f32 distanceSq = DistanceSquared(bounds, cameraPos);
+    if (level + 1 < m_LevelCount && distanceSq > m_LevelReach[level] * m_LevelReach[level]) {
+        return false;
+    }
+    if (!frustum.IsBoxVisible(bounds)) {
+        return true;
+    }
+
+    const bool whole = level == 0 || distanceSq > m_LevelReach[level - 1] * m_LevelReach[level - 1];
+    for (u32 quarter = 0; quarter < 4; ++quarter) {
+        const u32 cx = x * 2 + (quarter & 1);
+        const u32 cz = z * 2 + (quarter >> 1);
+        if (whole || !SelectNode(tile, frustum, cameraPos, level - 1, cx, cz, finestLevel)) {
+            AddQuarter(tile, level, x, z, quarter);
+            finestLevel = std::min(finestLevel, level);
+        }
+    }
+    return true;
+}
+
+void TerrainRenderer::BeginFrame() {
+    m_NodeRing->BeginFrame();
+    m_Stats.DrawCalls = 0;
+}
+
+void TerrainRenderer::Select(const Camera& camera, u32 viewportHeight) {
+    m_Nodes.clear();
+    m_Draws.clear();
+    m_NodeAllocation = {};
+    m_Stats.Nodes = 0;
+    m_Stats.Triangles = 0;
+    if (m_Tiles.empty()) return;
+
+    Frustum frustum;
+    frustum.ExtractPlanes(camera.GetViewProjectionMatrix());
+    const glm::vec3 cameraPos = camera.GetPosition();
+    const f32 pixelsPerUnit = camera.GetProjectionMatrix()[1][1] * 0.5f * static_cast<f32>(viewportHeight);
+    const f32 tileSize = static_cast<f32>(m_Settings.TileResolution) * m_Settings.SampleSpacing;
+
+    TextureStreamer& streamer = ResourceManager::Instance().GetTextureStreamer();
+    const u32 root = m_LevelCount - 1;
+    for (u32 i = 0; i < m_Tiles.size(); ++i) {
+        const Tile& tile = m_Tiles[i];
+        const u32 first = static_cast<u32>(m_Nodes.size());
+        u32 finestLevel = root;
+        SelectNode(tile, frustum, cameraPos, root, 0, 0, finestLevel);
+        if (m_Nodes.size() == first) continue;
+
+        m_Draws.push_back({i, first, static_cast<u32>(m_Nodes.size()) - first});
+
+        // Level l reads every 2^l-th sample, mip l of the point-sampled
+        // chain; the shared edges read the neighbours' first rows
+        streamer.RequestMip(*tile.Height, finestLevel);
+        for (i32 neighbour : tile.Neighbours) {
+            if (neighbour >= 0) streamer.RequestMip(*m_Tiles[neighbour].Height, finestLevel);
+        }
+
+        const AABB bounds = GetNodeBounds(tile, root, 0, 0);
+        const f32 distance = std::max(std::sqrt(DistanceSquared(bounds, cameraPos)), 0.1f);
+        streamer.RequestScreenSize(*tile.Splat, tileSize * pixelsPerUnit / distance);
+    }
+
+    if (m_Nodes.empty()) return;
+
+    m_NodeAllocation = m_NodeRing->Upload(m_Nodes.data(), m_Nodes.size());
+    m_Stats.Nodes = static_cast<u32>(m_Nodes.size());
+    m_Stats.Triangles = m_Stats.Nodes * (m_GridIndexCount / 3);
+}
+
+void TerrainRenderer::Draw(bool depthPass, bool compactGBuffer) {
+    if (m_Draws.empty() || !m_NodeAllocation) return;
+
+    auto& state = GLStateCache::Instance();
+    Shader& shader = depthPass ? *m_DepthShader : *m_Shader;
+    shader.Bind();
+    shader.SetFloat3("u_TerrainOrigin", m_Settings.Origin);
+    shader.SetFloat("u_SampleSpacing", m_Settings.SampleSpacing);
+    shader.SetFloat("u_HeightScale", m_Settings.HeightScale);
+    shader.SetInt("u_TileResolution", static_cast<i32>(m_Settings.TileResolution));
+
+    if (!depthPass) {
+        const MaterialLibrary& materials = MaterialLibrary::Instance();
+        glm::vec4 tiling;
+        for (u32 i = 0; i < 4; ++i) {
+            const TerrainLayer& layer = m_Settings.Layers[i];
+            const u32 material = materials.Contains(layer.MaterialId) ? layer.MaterialId
+                                                                      : MaterialLibrary::DefaultMaterial;
+            shader.SetUInt("u_LayerMaterials[" + std::to_string(i) + "]", material);
+            tiling[i] = 1.0f / std::max(layer.Tiling, 1e-3f);
+        }
+        shader.SetFloat4("u_LayerTiling", tiling);
+        shader.SetInt("u_CompactGBuffer", compactGBuffer ? 1 : 0);
+    }
+
+    GPURingBuffer::BindRange(GL_SHADER_STORAGE_BUFFER, NodeBinding, m_NodeAllocation);
+    m_GridVAO->Bind();
+
+    for (const DrawRange& draw : m_Draws) {
+        const Tile& tile = m_Tiles[draw.Tile];
+
+        // Missing neighbours (the far edges) fall back to the tile itself,
+        // clamped to its last row / column
+        i32 mips[4];
+        i32 neighbourMask = 0;
+        for (u32 i = 0; i < 4; ++i) {
+            const i32 index = i == 0 ? static_cast<i32>(draw.Tile) : tile.Neighbours[i - 1];
+            const Texture2D& height = *m_Tiles[index >= 0 ? index : draw.Tile].Height;
+            state.BindTextureUnit(HeightUnit + i, height.GetRendererID());
+            mips[i] = static_cast<i32>(height.GetResidentMip());
+            if (i > 0 && index >= 0) neighbourMask |= 1 << (i - 1);
+        }
+        shader.SetIntArray("u_HeightMips", mips, 4);
+        shader.SetInt("u_NeighbourMask", neighbourMask);
+        shader.SetInt2("u_TileSample", tile.Sample);
+        shader.SetUInt("u_FirstNode", draw.FirstNode);
+        if (!depthPass) {
+            state.BindTextureUnit(SplatUnit, tile.Splat->GetRendererID());
+        }
+
+        PipelineWarmup::RecordDraw(GL_TRIANGLES);
+        glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(m_GridIndexCount), GL_UNSIGNED_INT, nullptr,
+                                static_cast<GLsizei>(draw.NodeCount));
+        m_Stats.DrawCalls++;
+    }
+}
+
+} // namespace Engine
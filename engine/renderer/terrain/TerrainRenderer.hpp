@@ -0,0 +1,173 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "math/AABB.hpp"
+#include "renderer/opengl/GLShader.hpp"
+#include "renderer/opengl/GLVertexArray.hpp"
+#include "renderer/opengl/GPURingBuffer.hpp"
+#include "renderer/Texture.hpp"
+#include <glm/glm.hpp>
+#include <array>
+
+namespace Engine {
+
+class Camera;
+class Frustum;
+
+// One of the four materials the splat map blends
+struct TerrainLayer {
+    u32 MaterialId = 0;         // MaterialLibrary id: base color, albedo map, roughness
+    f32 Tiling = 4.0f;          // World units per repeat of the material's maps
+};
+
+struct TerrainSettings {
+    glm::vec3 Origin{0.0f};     // World position of sample (0, 0) at height 0
+    f32 SampleSpacing = 1.0f;   // World units between samples on X and Z
+    f32 HeightScale = 64.0f;    // World height of a normalized 1.0
+    u32 TileResolution = 256;   // Quads per tile edge, power of two; one height and splat texture each
+    u32 NodeResolution = 32;    // Grid quads per node edge, power of two, at most TileResolution
+    f32 LODDistance = 96.0f;    // Reach of the finest level, each coarser one doubling it; at least two finest node diagonals
+    f32 MorphRegion = 0.3f;     // Fraction of each level's reach spent morphing into the next
+    std::array<TerrainLayer, 4> Layers;     // Weighted by the splat map's RGBA
+};
+
+// TerrainRenderer - heightfield terrain with CDLOD level of detail.
+//
+// Build() cuts the heightfield into tiles of TileResolution quads. Each
+// tile gets a 16-bit height texture (RG8, high byte first) whose stored
+// mips are point-sampled, so mip m holds exactly every 2^m-th sample, and
+// an RGBA8 splat texture; both are registered with ResourceManager's
+// TextureStreamer, which keeps the levels the selection asks for resident.
+// A min / max height pyramid per tile bounds every quadtree node.
+//
+// Per view, Select() walks each tile's quadtree on the CPU (Strugar's
+// CDLOD): nodes outside the frustum are dropped, nodes out of reach of the
+// next finer level are drawn whole and the others split, the parts left
+// outside that reach staying at their own level. Selected nodes are drawn
+// as quarters, so every draw is the same (NodeResolution / 2)^2 grid:
+// Draw() issues one instanced call per tile with its heights (and those of
+// its +X / +Z neighbours, for the shared edges) bound. deferred/terrain.glsl
+// places the grid, fetches heights in the vertex shader and morphs vertices
+// of each level into the next over its last MorphRegion, so neighbouring
+// levels meet without cracks.
+//
+// Heights fetched from a level the streamer hasn't brought in yet are
+// interpolated from the resident one. Terrain is not drawn into shadow
+// maps. GL thread only.
+class TerrainRenderer {
+public:
+    // Must match terrain.glsl
+    static constexpr u32 NodeBinding = 6;
+    static constexpr u32 HeightUnit = 0;        // Tile, +X, +Z, +XZ neighbours: 0-3
+    static constexpr u32 SplatUnit = 4;
+
+    struct Stats {
+        u32 Tiles = 0;
+        u32 Nodes = 0;          // Quarter nodes selected, last view
+        u32 Triangles = 0;      // Last view
+        u32 DrawCalls = 0;      // Every view
+    };
+
+    TerrainRenderer();
+    ~TerrainRenderer();
+
+    TerrainRenderer(const TerrainRenderer&) = delete;
+    TerrainRenderer& operator=(const TerrainRenderer&) = delete;
+
+    // heights are width x depth normalized samples, row by row along +X;
+    // splat, if not empty, four weights per sample in the same order
+    // (otherwise Layers[0] covers everything). Replaces any previous
+    // terrain. False for inconsistent sizes or settings.
+    bool Build(const TerrainSettings& settings, u32 width, u32 depth, const Vector<f32>& heights,
+               const Vector<u8>& splat = {});
+    void Clear();
+
+    bool IsEmpty() const { return m_Tiles.empty(); }
+    const TerrainSettings& GetSettings() const { return m_Settings; }
+    const AABB& GetBounds() const { return m_Bounds; }
+
+    // World height under (x, z), bilinear over the full-resolution samples;
+    // the nearest edge's off the terrain
+    f32 GetHeight(f32 x, f32 z) const;
+
+    // Ring buffer frame; once per frame, before any view's Select
+    void BeginFrame();
+
+    // Pick the nodes camera sees and request their height levels. Once per
+    // view, before its Draw calls.
+    void Select(const Camera& camera, u32 viewportHeight);
+
+    // Draw what the last Select picked, binding the terrain shader
+    void Draw(bool depthPass, bool compactGBuffer);
+
+    const Stats& GetStats() const { return m_Stats; }
+
+    void Reload();
+
+private:
+    // Must match terrain.glsl
+    struct GPUNode {
+        glm::ivec2 Sample;          // First global sample of the quarter
+        u32 Level;
+        u32 Padding;
+        f32 MorphStart;             // Camera distance where morphing begins
+        f32 MorphScale;             // 1 / morph length, 0 for the coarsest level
+        glm::vec2 Padding1;
+    };
+
+    struct Tile {
+        Ref<Texture2D> Height;
+        Ref<Texture2D> Splat;
+        glm::ivec2 Sample{0};       // First global sample
+        i32 Neighbours[3] = {-1, -1, -1};   // +X, +Z, +XZ tiles
+        // Node min / max normalized heights per level, level 0 first;
+        // level l is (TileResolution / NodeResolution >> l)^2 nodes
+        Vector<Vector<glm::vec2>> HeightRanges;
+    };
+
+    // Consecutive nodes of one tile
+    struct DrawRange {
+        u32 Tile = 0;
+        u32 FirstNode = 0;
+        u32 NodeCount = 0;
+    };
+
+    void LoadShaders();
+    void CreateGrid();
+    f32 GetSample(i32 x, i32 z) const;
+    void BuildHeightRanges(Tile& tile) const;
+    TextureImage BuildHeightImage(const Tile& tile) const;
+    TextureImage BuildSplatImage(const Tile& tile, const Vector<u8>& splat) const;
+    static Ref<Texture2D> UploadTileTexture(const String& name, TextureImage image);
+
+    AABB GetNodeBounds(const Tile& tile, u32 level, u32 x, u32 z) const;
+    bool SelectNode(const Tile& tile, const Frustum& frustum, const glm::vec3& cameraPos, u32 level, u32 x, u32 z,
+                    u32& finestLevel);
+    void AddQuarter(const Tile& tile, u32 level, u32 x, u32 z, u32 quarter);
+
+private:
+    TerrainSettings m_Settings;
+    u32 m_Width = 0;
+    u32 m_Depth = 0;
+    u32 m_TilesX = 0;
+    u32 m_TilesZ = 0;
+    u32 m_LevelCount = 0;
+    Vector<u16> m_Heights;      // Normalized * 65535, for GetHeight and the tiles
+    Vector<Tile> m_Tiles;
+    Vector<f32> m_LevelReach;   // Per level; the coarsest reaches everywhere
+    AABB m_Bounds;
+
+    Ref<Shader> m_Shader;
+    Ref<Shader> m_DepthShader;
+    Ref<VertexArray> m_GridVAO;     // One quarter node
+    u32 m_GridIndexCount = 0;
+
+    Scope<GPURingBuffer> m_NodeRing;
+    GPURingBuffer::Allocation m_NodeAllocation;
+    Vector<GPUNode> m_Nodes;
+    Vector<DrawRange> m_Draws;
+
+    Stats m_Stats;
+};
+
+} // namespace Engine
@@ -0,0 +1,278 @@
+#include "resources/AssetArchive.hpp"
+#include "resources/ResourceHandle.hpp"
+#include "core/Logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <lz4.h>
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 ArchiveMagic = 0x4B505650;    // 'PVPK'
+constexpr u32 ArchiveVersion = 1;
+constexpr usize EntryAlignment = 16;
+constexpr usize PageAlignment = 4096;
+
+struct AssetArchiveHeader {
+    u32 Magic = ArchiveMagic;
+    u32 Version = ArchiveVersion;
+    u32 EntryCount = 0;
+    u32 Reserved = 0;
+    u64 NamesOffset = 0;
+    u64 NamesSize = 0;
+};
+static_assert(sizeof(AssetArchiveHeader) == 32, "AssetArchiveHeader is part of the file format");
+
+struct AssetArchiveEntry {
+    u64 PathHash = 0;
+    u64 Offset = 0;
+    u64 Size = 0;               // Once decompressed
+    u64 StoredSize = 0;         // In the archive
+    u32 NameOffset = 0;         // Into the path strings
+    u32 NameLength = 0;
+    u32 Compression = 0;        // AssetCompression
+    u32 Reserved = 0;
+};
+static_assert(sizeof(AssetArchiveEntry) == 48, "AssetArchiveEntry is part of the file format");
+
+usize AlignUp(usize value, usize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// [offset, offset + size) lies inside the file
+bool InFile(u64 offset, u64 size, usize fileSize) {
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+bool ReadWholeFile(const String& filepath, Vector<u8>& bytes) {
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+
+    bytes.resize(static_cast<usize>(file.tellg()));
+    file.seekg(0);
+    return bytes.empty() || file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+struct PendingEntry {
+    String Path;
+    Vector<u8> Stored;
+    u64 Size = 0;
+    AssetCompression Compression = AssetCompression::None;
+    u64 Offset = 0;
+};
+
+} // anonymous namespace
+
+bool AssetArchive::Write(const Vector<Source>& sources, const String& filepath,
+                         const AssetArchiveWriteOptions& options) {
+    Vector<PendingEntry> entries;
+    entries.reserve(sources.size());
+    HashMap<String, bool> seen;
+
+    for (const Source& source : sources) {
+        if (!seen.emplace(source.Path, true).second) {
+            LOG_CORE_WARN("AssetArchive: {} listed twice, keeping the first", source.Path);
+            continue;
+        }
+
+        PendingEntry entry;
+        entry.Path = source.Path;
+        if (!ReadWholeFile(source.FilePath, entry.Stored)) {
+            LOG_CORE_ERROR("AssetArchive: could not read {}", source.FilePath);
+            return false;
+        }
+        entry.Size = entry.Stored.size();
+
+        if (options.Compress && !entry.Stored.empty() && entry.Stored.size() <= LZ4_MAX_INPUT_SIZE) {
+            Vector<u8> compressed(static_cast<usize>(LZ4_compressBound(static_cast<int>(entry.Stored.size()))));
+            const int compressedSize = LZ4_compress_default(reinterpret_cast<const char*>(entry.Stored.data()),
+                                                            reinterpret_cast<char*>(compressed.data()),
+                                                            static_cast<int>(entry.Stored.size()),
+                                                            static_cast<int>(compressed.size()));
+            const f32 saving = 1.0f - static_cast<f32>(compressedSize) / static_cast<f32>(entry.Stored.size());
+            if (compressedSize > 0 && saving >= options.MinCompressionSaving) {
+                compressed.resize(static_cast<usize>(compressedSize));
+                entry.Stored = std::move(compressed);
+                entry.Compression = AssetCompression::LZ4;
+            }
+        }
+        entries.push_back(std::move(entry));
+    }
+
+    // Table of contents in hash order, with the path strings after it
+    Vector<u32> toc(entries.size());
+    for (u32 i = 0; i < static_cast<u32>(toc.size()); ++i) toc[i] = i;
+    std::sort(toc.begin(), toc.end(), [&](u32 a, u32 b) {
+        return HashResourceName(entries[a].Path) < HashResourceName(entries[b].Path);
+    });
+
+    String names;
+    Vector<u32> nameOffsets(entries.size());
+    for (u32 index : toc) {
+        nameOffsets[index] = static_cast<u32>(names.size());
+        names += entries[index].Path;
+    }
+
+    AssetArchiveHeader header;
+    header.EntryCount = static_cast<u32>(entries.size());
+    header.NamesOffset = sizeof(AssetArchiveHeader) + entries.size() * sizeof(AssetArchiveEntry);
+    header.NamesSize = names.size();
+
+    // Small entries back to back in the given order, then the large ones page-aligned
+    usize offset = AlignUp(header.NamesOffset + header.NamesSize, EntryAlignment);
+    for (PendingEntry& entry : entries) {
+        if (entry.Stored.size() >= options.LargeEntrySize) continue;
+        entry.Offset = offset;
+        offset = AlignUp(offset + entry.Stored.size(), EntryAlignment);
+    }
+    for (PendingEntry& entry : entries) {
+        if (entry.Stored.size() < options.LargeEntrySize) continue;
+        offset = AlignUp(offset, PageAlignment);
+        entry.Offset = offset;
+        offset += entry.Stored.size();
+    }
+
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        LOG_CORE_ERROR("AssetArchive: could not create {}", filepath);
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (u32 index : toc) {
+        const PendingEntry& pending = entries[index];
+        AssetArchiveEntry entry;
+        entry.PathHash = HashResourceName(pending.Path);
+        entry.Offset = pending.Offset;
+        entry.Size = pending.Size;
+        entry.StoredSize = pending.Stored.size();
+        entry.NameOffset = nameOffsets[index];
+        entry.NameLength = static_cast<u32>(pending.Path.size());
+        entry.Compression = static_cast<u32>(pending.Compression);
+        file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+    file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+    // Entries in offset order, padding up to each
+    Vector<const PendingEntry*> byOffset;
+    byOffset.reserve(entries.size());
+    for (const PendingEntry& entry : entries) byOffset.push_back(&entry);
+    std::sort(byOffset.begin(), byOffset.end(), [](const auto* a, const auto* b) { return a->Offset < b->Offset; });
+
+    usize written = header.NamesOffset + header.NamesSize;
+    for (const PendingEntry* entry : byOffset) {
+        std::fill_n(std::ostreambuf_iterator<char>(file), entry->Offset - written, '\0');
+        file.write(reinterpret_cast<const char*>(entry->Stored.data()), static_cast<std::streamsize>(entry->Stored.size()));
+        written = entry->Offset + entry->Stored.size();
+    }
+
+    if (!file) {
+        LOG_CORE_ERROR("AssetArchive: failed writing {}", filepath);
+        return false;
+    }
+    LOG_CORE_INFO("Packed {} asset(s) into {} ({} KB)", entries.size(), filepath, written >> 10);
+    return true;
+}
+
+Ref<AssetArchive> AssetArchive::Open(const String& filepath) {
+    auto archive = CreateRef<AssetArchive>();
+    archive->m_FilePath = filepath;
+    if (!archive->m_File.Open(filepath)) {
+        LOG_CORE_ERROR("AssetArchive: could not open {}", filepath);
+        return nullptr;
+    }
+
+    const usize size = archive->m_File.Size();
+    auto fail = [&](const char* reason) -> Ref<AssetArchive> {
+        LOG_CORE_ERROR("AssetArchive: {} is not a valid archive ({})", filepath, reason);
+        return nullptr;
+    };
+
+    if (size < sizeof(AssetArchiveHeader)) return fail("truncated header");
+
+    AssetArchiveHeader header;
+    std::memcpy(&header, archive->m_File.Data(), sizeof(header));
+    if (header.Magic != ArchiveMagic) return fail("bad magic");
+    if (header.Version != ArchiveVersion) return fail("unsupported version");
+    if (!InFile(sizeof(AssetArchiveHeader), static_cast<u64>(header.EntryCount) * sizeof(AssetArchiveEntry), size) ||
+        !InFile(header.NamesOffset, header.NamesSize, size)) {
+        return fail("table of contents outside the file");
+    }
+
+    // Every entry is checked once here, so lookups can trust the table
+    const auto* entries = reinterpret_cast<const AssetArchiveEntry*>(archive->m_File.Data() + sizeof(AssetArchiveHeader));
+    for (u32 i = 0; i < header.EntryCount; ++i) {
+        const AssetArchiveEntry& entry = entries[i];
+        if (!InFile(entry.Offset, entry.StoredSize, size)) return fail("entry outside the file");
+        if (!InFile(entry.NameOffset, entry.NameLength, header.NamesSize)) return fail("name outside the path strings");
+        if (i > 0 && entry.PathHash < entries[i - 1].PathHash) return fail("unsorted table of contents");
+        if (entry.Compression > static_cast<u32>(AssetCompression::LZ4)) return fail("unknown compression");
+        if (entry.Compression == static_cast<u32>(AssetCompression::None) && entry.Size != entry.StoredSize) {
+            return fail("stored size mismatch");
+        }
+    }
+
+    archive->m_EntryCount = header.EntryCount;
+    archive->m_Names = reinterpret_cast<const char*>(archive->m_File.Data() + header.NamesOffset);
+    LOG_CORE_INFO("Mounted asset archive {} ({} entries)", filepath, header.EntryCount);
+    return archive;
+}
+
+u32 AssetArchive::FindEntry(const String& path) const {
+    if (m_EntryCount == 0) return InvalidEntry;
+
+    const auto* entries = reinterpret_cast<const AssetArchiveEntry*>(m_File.Data() + sizeof(AssetArchiveHeader));
+    const u64 hash = HashResourceName(path);
+    const AssetArchiveEntry* it = std::lower_bound(entries, entries + m_EntryCount, hash,
+        [](const AssetArchiveEntry& entry, u64 value) { return entry.PathHash < value; });
+
+    // Colliding hashes sit next to each other
+    for (; it != entries + m_EntryCount && it->PathHash == hash; ++it) {
+        if (it->NameLength == path.size() && std::memcmp(m_Names + it->NameOffset, path.data(), path.size()) == 0) {
+            return static_cast<u32>(it - entries);
+        }
+    }
+    return InvalidEntry;
+}
+
+AssetData AssetArchive::Read(const String& path) const {
+    const u32 index = FindEntry(path);
+    if (index == InvalidEntry) return {};
+
+    const auto& entry = reinterpret_cast<const AssetArchiveEntry*>(m_File.Data() + sizeof(AssetArchiveHeader))[index];
+    const u8* stored = m_File.Data() + entry.Offset;
+
+    AssetData data;
+    if (entry.Compression == static_cast<u32>(AssetCompression::None)) {
+        data.Data = stored;
+        data.Size = entry.StoredSize;
+        data.Owner = shared_from_this();
+        return data;
+    }
+
+    if (entry.Size > LZ4_MAX_INPUT_SIZE || entry.StoredSize > LZ4_MAX_INPUT_SIZE) {
+        LOG_CORE_ERROR("AssetArchive: {} in {} is too large to decompress", path, m_FilePath);
+        return {};
+    }
+
+    auto bytes = CreateRef<Vector<u8>>(static_cast<usize>(entry.Size));
+    const int decompressed = LZ4_decompress_safe(reinterpret_cast<const char*>(stored),
+                                                 reinterpret_cast<char*>(bytes->data()),
+                                                 static_cast<int>(entry.StoredSize), static_cast<int>(entry.Size));
+    if (decompressed != static_cast<int>(entry.Size)) {
+        LOG_CORE_ERROR("AssetArchive: {} in {} is corrupt", path, m_FilePath);
+        return {};
+    }
+
+    data.Data = bytes->data();
+    data.Size = bytes->size();
+    data.Owner = std::move(bytes);
+    return data;
+}
+
+} // namespace Engine
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/MappedFile.hpp"
+
+namespace Engine {
+
+// Bytes of one asset read from an archive: a view into the mapped archive,
+// or into the decompressed copy for compressed entries. Owner keeps them
+// alive, so the data can outlive the lookup and cross threads.
+struct AssetData {
+    const u8* Data = nullptr;
+    usize Size = 0;
+    Ref<const void> Owner;
+
+    explicit operator bool() const { return Data != nullptr; }
+};
+
+enum class AssetCompression : u32 {
+    None,
+    LZ4         // LZ4 block
+};
+
+struct AssetArchiveWriteOptions {
+    bool Compress = true;               // LZ4 entries that shrink by at least MinCompressionSaving
+    f32 MinCompressionSaving = 0.1f;
+    usize LargeEntrySize = 256u << 10;  // Entries from this size on are page-aligned after the small ones
+};
+
+// AssetArchive - pack of many asset files (.pvpak) mapped as one.
+//
+// The table of contents sits right after the header: entries sorted by the
+// FNV-1a hash of their path (HashResourceName), then the path strings, so a
+// lookup is a binary search over memory that was mapped once. Paths are
+// relative to the asset root with '/' separators, as ResourceManager is
+// given them.
+//
+// Small entries follow the table back to back in the order they were
+// written - the order the game loads them in, when the packer is given
+// one - so a level's worth of small files comes in with sequential reads.
+// Large entries follow, each on a page boundary. Every entry is at least
+// 16-byte aligned, as MeshFile blobs need. Uncompressed entries are read in
+// place; LZ4 ones are decompressed into a copy.
+//
+// Layout, little-endian:
+//   AssetArchiveHeader | AssetArchiveEntry[] | path strings | small entries | large entries
+class AssetArchive : public std::enable_shared_from_this<AssetArchive> {
+public:
+    static constexpr const char* Extension = ".pvpak";
+
+    struct Source {
+        String Path;        // Name in the archive
+        String FilePath;    // Where to read it from
+    };
+
+    // Pack sources, keeping their order for the small entries
+    static bool Write(const Vector<Source>& sources, const String& filepath,
+                      const AssetArchiveWriteOptions& options = {});
+
+    // Map and validate an archive; null when it can't be used
+    static Ref<AssetArchive> Open(const String& filepath);
+
+    bool Contains(const String& path) const { return FindEntry(path) != InvalidEntry; }
+
+    // The entry's bytes, empty when it isn't in the archive. Uncompressed
+    // entries are a view into the mapping, which the result keeps alive;
+    // compressed ones are decompressed into a copy the result owns. Any thread.
+    AssetData Read(const String& path) const;
+
+    u32 GetEntryCount() const { return m_EntryCount; }
+    const String& GetFilePath() const { return m_FilePath; }
+
+private:
+    static constexpr u32 InvalidEntry = ~0u;
+
+    u32 FindEntry(const String& path) const;
+
+    MappedFile m_File;
+    String m_FilePath;
+    const char* m_Names = nullptr;  // Path strings, not null-terminated
+    u32 m_EntryCount = 0;
+};
+
+} // namespace Engine
@@ -0,0 +1,292 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+
+namespace Engine {
+
+// 64-bit FNV-1a of a resource name; pools index names by it
+constexpr u64 HashResourceName(std::string_view name) {
+    u64 hash = 14695981039346656037ull;
+    for (char c : name) {
+        hash = (hash ^ static_cast<u8>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Slot index and generation into a ResourcePool<T>: 8 bytes, trivially
+// copyable, so components can hold one without refcounting. A handle goes
+// stale (Get() returns null) once its slot is removed, even if the slot is
+// reused for another resource.
+template<typename T>
+struct ResourceHandle {
+    static constexpr u32 InvalidIndex = ~0u;
+
+    u32 Index = InvalidIndex;
+    u32 Generation = 0;
+
+    // Set, not necessarily alive - ask the pool
+    bool IsSet() const { return Index != InvalidIndex; }
+    explicit operator bool() const { return IsSet(); }
+
+    bool operator==(const ResourceHandle& other) const = default;
+};
+
+class Texture2D;
+class Mesh;
+class Shader;
+class VectorField;
+
+using TextureHandle = ResourceHandle<Texture2D>;
+using MeshHandle = ResourceHandle<Mesh>;
+using ShaderHandle = ResourceHandle<Shader>;
+using VectorFieldHandle = ResourceHandle<VectorField>;
+static_assert(sizeof(MeshHandle) == 8, "Handles are stored in components, keep them small");
+
+// ResourcePool - dense slots of Ref<T> addressed by ResourceHandle<T>.
+//
+// Slots live in fixed-size pages that never move and are reused through a
+// free list; removing a slot bumps its generation so old handles stop
+// resolving. Names are optional, indexed by HashResourceName in sharded
+// maps. The pool owns one reference; Sweep() walks the slots to drop the
+// ones nobody else needs.
+//
+// Thread safety: Get() / IsAlive() are lock-free and Find(name) only takes
+// its shard's reader lock, so any thread can resolve handles and names.
+// Everything else serializes on one writer mutex. A pointer from Get() stays
+// valid until the slot is removed - removal (Remove, Sweep, Clear) belongs
+// to the thread that owns the resources, on the GL thread for GPU ones.
+template<typename T>
+class ResourcePool {
+public:
+    using Handle = ResourceHandle<T>;
+
+    static constexpr u32 PageBits = 10;
+    static constexpr u32 PageSize = 1u << PageBits;
+    static constexpr u32 MaxPages = 1024;       // About a million slots
+
+    ResourcePool() = default;
+    ~ResourcePool() { Clear(); }
+
+    ResourcePool(const ResourcePool&) = delete;
+    ResourcePool& operator=(const ResourcePool&) = delete;
+
+    // Add resource under name (may be empty). Adding a resource or a name
+    // that is already present returns the existing slot, with *added false -
+    // two threads adding the same name get the same handle.
+    Handle Add(const String& name, Ref<T> resource, bool* added = nullptr) {
+        if (added) *added = false;
+        if (!resource) return Handle{};
+
+        std::lock_guard<std::mutex> lock(m_WriteMutex);
+        if (auto it = m_ByPointer.find(resource.get()); it != m_ByPointer.end()) {
+            return MakeHandle(it->second);
+        }
+        if (!name.empty()) {
+            if (Handle existing = Find(name); existing) return existing;
+        }
+
+        u32 index;
+        if (!m_FreeSlots.empty()) {
+            index = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+        } else {
+            index = m_SlotCount.load(std::memory_order_relaxed);
+            if (index >= MaxPages * PageSize) {
+                return Handle{};
+            }
+            if ((index & (PageSize - 1)) == 0) {
+                m_PageStorage.push_back(std::make_unique<Slot[]>(PageSize));
+                m_Pages[index >> PageBits].store(m_PageStorage.back().get(), std::memory_order_release);
+            }
+            m_SlotCount.store(index + 1, std::memory_order_release);
+        }
+
+        Slot& slot = GetSlot(index);
+        const u32 generation = slot.Generation.load(std::memory_order_relaxed);
+        slot.Name = name;
+        slot.NameHash = name.empty() ? 0 : HashResourceName(name);
+        m_ByPointer[resource.get()] = index;
+        slot.Pointer.store(resource.get(), std::memory_order_release);
+        slot.Resource = std::move(resource);
+        if (!name.empty()) {
+            NameShard& shard = GetShard(slot.NameHash);
+            std::unique_lock<std::shared_mutex> shardLock(shard.Mutex);
+            shard.Slots[slot.NameHash] = NamedSlot{name, index, generation};
+        }
+        m_Count.fetch_add(1, std::memory_order_relaxed);
+        if (added) *added = true;
+        return Handle{index, generation};
+    }
+
+    bool Remove(Handle handle) {
+        std::lock_guard<std::mutex> lock(m_WriteMutex);
+        return RemoveLocked(handle);
+    }
+
+    bool IsAlive(Handle handle) const {
+        return Get(handle) != nullptr;
+    }
+
+    // Lock-free
+    T* Get(Handle handle) const {
+        const Slot* slot = TryGetSlot(handle.Index);
+        if (!slot) return nullptr;
+        T* resource = slot->Pointer.load(std::memory_order_acquire);
+        return slot->Generation.load(std::memory_order_acquire) == handle.Generation ? resource : nullptr;
+    }
+
+    Ref<T> GetRef(Handle handle) const {
+        std::lock_guard<std::mutex> lock(m_WriteMutex);
+        return IsAlive(handle) ? GetSlot(handle.Index).Resource : nullptr;
+    }
+
+    String GetName(Handle handle) const {
+        std::lock_guard<std::mutex> lock(m_WriteMutex);
+        return IsAlive(handle) ? GetSlot(handle.Index).Name : String();
+    }
+
+    Handle Find(const String& name) const {
+        if (name.empty()) return Handle{};
+        const u64 hash = HashResourceName(name);
+        const NameShard& shard = GetShard(hash);
+        std::shared_lock<std::shared_mutex> lock(shard.Mutex);
+        auto it = shard.Slots.find(hash);
+        if (it == shard.Slots.end() || it->second.Name != name) return Handle{};
+        return Handle{it->second.Index, it->second.Generation};
+    }
+
+    Handle Find(const T* resource) const {
+        std::lock_guard<std::mutex> lock(m_WriteMutex);
+        auto it = m_ByPointer.find(resource);
+        return it != m_ByPointer.end() ? MakeHandle(it->second) : Handle{};
+    }
+
+    // func(Handle, const Ref<T>&) for every live slot, under the writer lock
+    // (func must not call back into the pool)
+    template<typename Func>
+    void ForEach(Func&& func) const {
+        std::lock_guard<std::mutex> lock(m_WriteMutex);
+        const u32 slotCount = m_SlotCount.load(std::memory_order_relaxed);
+        for (u32 i = 0; i < slotCount; ++i) {
+            const Slot& slot = GetSlot(i);
+            if (slot.Resource) {
+                func(MakeHandle(i), slot.Resource);
+            }
+        }
+    }
+
+    // Remove every live slot for which keep(Handle, const Ref<T>&) is false.
+    // Returns the number removed.
+    template<typename Keep>
+    u32 Sweep(Keep&& keep) {
+        std::lock_guard<std::mutex> lock(m_WriteMutex);
+        u32 removed = 0;
+        const u32 slotCount = m_SlotCount.load(std::memory_order_relaxed);
+        for (u32 i = 0; i < slotCount; ++i) {
+            Slot& slot = GetSlot(i);
+            if (!slot.Resource) continue;
+
+            const Handle handle = MakeHandle(i);
+            if (!keep(handle, slot.Resource)) {
+                RemoveLocked(handle);
+                removed++;
+            }
+        }
+        return removed;
+    }
+
+    // Slots ever allocated, for per-slot side tables
+    u32 GetCapacity() const { return m_SlotCount.load(std::memory_order_acquire); }
+    usize GetCount() const { return m_Count.load(std::memory_order_relaxed); }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(m_WriteMutex);
+        const u32 slotCount = m_SlotCount.load(std::memory_order_relaxed);
+        for (u32 i = 0; i < slotCount; ++i) {
+            if (GetSlot(i).Resource) {
+                RemoveLocked(MakeHandle(i));
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<u32> Generation{1};     // Default handles (generation 0) never match
+        std::atomic<T*> Pointer{nullptr};   // Resource.get() while alive, for Get()
+        Ref<T> Resource;                    // Writer lock
+        String Name;
+        u64 NameHash = 0;
+    };
+
+    struct NamedSlot {
+        String Name;
+        u32 Index = 0;
+        u32 Generation = 0;
+    };
+
+    static constexpr u32 ShardCount = 16;
+
+    struct NameShard {
+        mutable std::shared_mutex Mutex;
+        HashMap<u64, NamedSlot> Slots;
+    };
+
+    Slot& GetSlot(u32 index) const {
+        return m_Pages[index >> PageBits].load(std::memory_order_relaxed)[index & (PageSize - 1)];
+    }
+
+    const Slot* TryGetSlot(u32 index) const {
+        if (index >= m_SlotCount.load(std::memory_order_acquire)) return nullptr;
+        const Slot* page = m_Pages[index >> PageBits].load(std::memory_order_acquire);
+        return page ? &page[index & (PageSize - 1)] : nullptr;
+    }
+
+    Handle MakeHandle(u32 index) const {
+        return Handle{index, GetSlot(index).Generation.load(std::memory_order_relaxed)};
+    }
+
+    NameShard& GetShard(u64 hash) { return m_Shards[hash % ShardCount]; }
+    const NameShard& GetShard(u64 hash) const { return m_Shards[hash % ShardCount]; }
+
+    bool RemoveLocked(Handle handle) {
+        if (!IsAlive(handle)) return false;
+
+        Slot& slot = GetSlot(handle.Index);
+        if (!slot.Name.empty()) {
+            NameShard& shard = GetShard(slot.NameHash);
+            std::unique_lock<std::shared_mutex> shardLock(shard.Mutex);
+            if (auto it = shard.Slots.find(slot.NameHash); it != shard.Slots.end() && it->second.Index == handle.Index) {
+                shard.Slots.erase(it);
+            }
+        }
+        m_ByPointer.erase(slot.Resource.get());
+
+        // Retire the handle before the pointer so Get() never pairs them wrongly
+        slot.Generation.store(handle.Generation + 1, std::memory_order_release);
+        slot.Pointer.store(nullptr, std::memory_order_release);
+        slot.Resource.reset();
+        slot.Name.clear();
+        slot.NameHash = 0;
+        m_FreeSlots.push_back(handle.Index);
+        m_Count.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    std::array<std::atomic<Slot*>, MaxPages> m_Pages{};
+    Vector<Scope<Slot[]>> m_PageStorage;
+    std::atomic<u32> m_SlotCount{0};
+    std::atomic<usize> m_Count{0};
+
+    mutable std::mutex m_WriteMutex;
+    Vector<u32> m_FreeSlots;
+    HashMap<const T*, u32> m_ByPointer;
+    std::array<NameShard, ShardCount> m_Shards;
+};
+
+} // namespace Engine
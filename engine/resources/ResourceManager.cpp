@@ -1,8 +1,71 @@
 #include "resources/ResourceManager.hpp"
+#include "resources/loaders/TextureLoader.hpp"
+#include "resources/cooking/AssetCooker.hpp"
+#include "resources/cooking/TextureCooker.hpp"
+#include "renderer/opengl/TextureUploadRing.hpp"
+#include "core/JobSystem.hpp"
 #include "core/Logger.hpp"
+#include "core/MemoryTracker.hpp"
+#include "ecs/Components/Renderable.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 
 namespace Engine {
 
+namespace {
+
+// Key of the reload source maps. Lexical only, so it costs no file system
+// access per load; loads and file events spell paths alike.
+String NormalizeSourcePath(const String& path) {
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(path, error);
+    return (error ? std::filesystem::path(path) : absolute).lexically_normal().generic_string();
+}
+
+// FNV-1a over 8-byte words, for telling changed regions of a reloaded
+// resource from unchanged ones
+u64 HashContent(const void* data, usize size) {
+    const u8* bytes = static_cast<const u8*>(data);
+    u64 hash = 14695981039346656037ull;
+    usize i = 0;
+    for (; i + sizeof(u64) <= size; i += sizeof(u64)) {
+        u64 word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Rows per hashed band of a texture without a stored mip chain
+constexpr u32 TextureReloadBandRows = 32;
+
+// One hash per stored level, or per band of level 0 rows
+Vector<u64> HashTextureRegions(const TextureImage& image) {
+    Vector<u64> hashes;
+    if (!image.Levels.empty()) {
+        for (const auto& level : image.Levels) {
+            hashes.push_back(HashContent(image.Pixels.data() + level.Offset, level.Size));
+        }
+        return hashes;
+    }
+
+    const usize rowSize = static_cast<usize>(image.Width) * image.GetChannelCount();
+    for (u32 row = 0; row < image.Height; row += TextureReloadBandRows) {
+        const u32 rows = std::min(TextureReloadBandRows, image.Height - row);
+        hashes.push_back(HashContent(image.Pixels.data() + row * rowSize, rows * rowSize));
+    }
+    return hashes;
+}
+
+} // namespace
+
 ResourceManager& ResourceManager::Instance() {
     static ResourceManager instance;
     return instance;
@@ -24,198 +87,876 @@ String ResourceManager::ResolvePath(const String& relativePath) const {
 
 // Texture management
 Ref<Texture2D> ResourceManager::LoadTexture(const String& name, const String& filepath, bool flipVertically) {
-    if (auto it = m_Textures.find(name); it != m_Textures.end()) {
-        LOG_CORE_WARN("Texture '{}' already loaded, returning cached version", name);
-        return it->second;
+    if (!IsGLThread()) {
+        return LoadTextureAsync(name, filepath, flipVertically);
     }
 
-    String fullPath = ResolvePath(filepath);
-    auto texture = CreateRef<Texture2D>(fullPath, flipVertically);
-
-    if (!texture->IsLoaded()) {
-        LOG_CORE_ERROR("Failed to load texture: {}", fullPath);
-        return nullptr;
+    String fullPath = TextureLoader::ResolveCookedPath(ResolvePath(filepath));
+    TextureLoadCallback noCallback;
+    Ref<Texture2D> texture;
+    if (!ClaimTextureLoad(name, fullPath, flipVertically, false, noCallback, texture)) {
+        LOG_CORE_WARN("Texture '{}' already loaded, returning cached version", name);
+        return texture;
     }
 
-    m_Textures[name] = texture;
-    LOG_CORE_INFO("Loaded texture: '{}' from {}", name, fullPath);
-    return texture;
+    FinishTextureLoad(name, texture, DecodeTexture(fullPath, flipVertically));
+    return texture->IsLoaded() ? texture : nullptr;
 }
 
 Ref<Texture2D> ResourceManager::GetTexture(const String& name) {
-    if (auto it = m_Textures.find(name); it != m_Textures.end()) {
-        return it->second;
-    }
-    return nullptr;
+    return m_Textures.GetRef(m_Textures.Find(name));
 }
 
 bool ResourceManager::HasTexture(const String& name) const {
-    return m_Textures.find(name) != m_Textures.end();
+    return m_Textures.IsAlive(m_Textures.Find(name));
 }
 
 void ResourceManager::UnloadTexture(const String& name) {
-    if (auto it = m_Textures.find(name); it != m_Textures.end()) {
-        m_Textures.erase(it);
+    if (m_Textures.Remove(m_Textures.Find(name))) {
         LOG_CORE_INFO("Unloaded texture: '{}'", name);
     }
 }
 
+TextureHandle ResourceManager::AddTexture(const Ref<Texture2D>& texture, const String& name) {
+    return m_Textures.Add(name, texture);
+}
+
 // Mesh management
 Ref<Mesh> ResourceManager::LoadMesh(const String& name, const String& filepath, const MeshLoadOptions& options) {
-    if (auto it = m_Meshes.find(name); it != m_Meshes.end()) {
+    if (!IsGLThread()) {
+        return LoadMeshAsync(name, filepath, options);
+    }
+
+    String fullPath = ResolvePath(filepath);
+    MeshLoadCallback noCallback;
+    Ref<Mesh> mesh;
+    if (!ClaimMeshLoad(name, fullPath, options, noCallback, mesh)) {
         LOG_CORE_WARN("Mesh '{}' already loaded, returning cached version", name);
-        return it->second;
+        return mesh;
     }
 
+    FinishMeshLoad(name, fullPath, mesh, ReadMesh(fullPath, GetCookedMeshPath(fullPath, options), options));
+    return mesh->IsUploaded() ? mesh : nullptr;
+}
+
+Ref<Mesh> ResourceManager::GetMesh(const String& name) {
+    return m_Meshes.GetRef(m_Meshes.Find(name));
+}
+
+bool ResourceManager::HasMesh(const String& name) const {
+    return m_Meshes.IsAlive(m_Meshes.Find(name));
+}
+
+void ResourceManager::UnloadMesh(const String& name) {
+    if (m_Meshes.Remove(m_Meshes.Find(name))) {
+        LOG_CORE_INFO("Unloaded mesh: '{}'", name);
+    }
+}
+
+MeshHandle ResourceManager::AddMesh(const Ref<Mesh>& mesh, const String& name) {
+    return m_Meshes.Add(name, mesh);
+}
+
+// Asynchronous loading
+bool ResourceManager::ClaimTextureLoad(const String& name, const String& fullPath, bool flipVertically,
+                                       bool placeholder, TextureLoadCallback& onLoaded, Ref<Texture2D>& texture) {
+    std::unique_lock<std::mutex> lock(m_PendingMutex);
+
+    if (Ref<Texture2D> cached = m_Textures.GetRef(m_Textures.Find(name))) {
+        texture = std::move(cached);
+        if (auto pending = m_PendingTextures.find(name); pending != m_PendingTextures.end()) {
+            if (onLoaded) pending->second.push_back(std::move(onLoaded));
+            return false;
+        }
+        lock.unlock();
+        if (onLoaded) onLoaded(texture, texture->IsLoaded());
+        return false;
+    }
+
+    texture = Texture2D::CreatePending(fullPath, placeholder);
+    TextureHandle handle = m_Textures.Add(name, texture);
+    m_TextureSources[NormalizeSourcePath(fullPath)].push_back({handle, flipVertically, CreateRef<Vector<u64>>()});
+    auto& callbacks = m_PendingTextures[name];
+    if (onLoaded) callbacks.push_back(std::move(onLoaded));
+    return true;
+}
+
+bool ResourceManager::ClaimMeshLoad(const String& name, const String& fullPath, const MeshLoadOptions& options,
+                                    MeshLoadCallback& onLoaded, Ref<Mesh>& mesh) {
+    std::unique_lock<std::mutex> lock(m_PendingMutex);
+
+    if (Ref<Mesh> cached = m_Meshes.GetRef(m_Meshes.Find(name))) {
+        mesh = std::move(cached);
+        if (auto pending = m_PendingMeshes.find(name); pending != m_PendingMeshes.end()) {
+            if (onLoaded) pending->second.push_back(std::move(onLoaded));
+            return false;
+        }
+        lock.unlock();
+        if (onLoaded) onLoaded(mesh, mesh->IsUploaded());
+        return false;
+    }
+
+    mesh = CreateRef<Mesh>();
+    MeshHandle handle = m_Meshes.Add(name, mesh);
+    m_MeshSources[NormalizeSourcePath(fullPath)].push_back({handle, fullPath, options, CreateRef<Vector<u64>>()});
+    auto& callbacks = m_PendingMeshes[name];
+    if (onLoaded) callbacks.push_back(std::move(onLoaded));
+    return true;
+}
+
+Ref<Texture2D> ResourceManager::LoadTextureAsync(const String& name, const String& filepath, bool flipVertically,
+                                                 TextureLoadCallback onLoaded) {
+    String fullPath = TextureLoader::ResolveCookedPath(ResolvePath(filepath));
+    Ref<Texture2D> texture;
+    if (!ClaimTextureLoad(name, fullPath, flipVertically, IsGLThread(), onLoaded, texture)) {
+        return texture;
+    }
+
+    JobSystem::Submit([this, name, fullPath, flipVertically, texture] {
+        auto image = CreateRef<TextureImage>(DecodeTexture(fullPath, flipVertically));
+        image->Stage();
+        QueueUpload([this, name, texture, image] {
+            FinishTextureLoad(name, texture, std::move(*image));
+        });
+    });
+
+    return texture;
+}
+
+Ref<Mesh> ResourceManager::LoadMeshAsync(const String& name, const String& filepath, const MeshLoadOptions& options,
+                                         MeshLoadCallback onLoaded) {
     String fullPath = ResolvePath(filepath);
-    auto mesh = MeshLoader::LoadOBJ(fullPath, options);
+    Ref<Mesh> mesh;
+    if (!ClaimMeshLoad(name, fullPath, options, onLoaded, mesh)) {
+        return mesh;
+    }
 
-    if (!mesh) {
+    // Mapping, OBJ parsing, tangent generation and cooking touch no GL state
+    String cookedPath = GetCookedMeshPath(fullPath, options);
+    JobSystem::Submit([this, name, fullPath, cookedPath, options, mesh] {
+        auto result = CreateRef<MeshReadResult>(ReadMesh(fullPath, cookedPath, options));
+        QueueUpload([this, name, fullPath, mesh, result] {
+            FinishMeshLoad(name, fullPath, mesh, *result);
+        });
+    });
+
+    return mesh;
+}
+
+void ResourceManager::QueueUpload(std::function<void()> upload) {
+    std::lock_guard<std::mutex> lock(m_UploadMutex);
+    m_Uploads.push_back(std::move(upload));
+}
+
+void ResourceManager::ProcessUploads(f32 budgetMs) {
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + std::chrono::duration<f32, std::milli>(budgetMs);
+
+    // Staging space of the uploads the GPU has finished goes back to the jobs
+    TextureUploadRing::BeginFrame();
+
+    do {
+        std::function<void()> upload;
+        {
+            std::lock_guard<std::mutex> lock(m_UploadMutex);
+            if (m_Uploads.empty()) return;
+            upload = std::move(m_Uploads.front());
+            m_Uploads.pop_front();
+        }
+        upload();
+        m_UploadCount++;
+    } while (Clock::now() < deadline);
+}
+
+u32 ResourceManager::ReloadFile(const String& filepath) {
+    const String key = NormalizeSourcePath(filepath);
+
+    Vector<std::pair<Ref<Texture2D>, TextureSource>> textures;
+    Vector<std::pair<Ref<Mesh>, MeshSource>> meshes;
+    {
+        // Sources of unloaded resources are dropped as they are found
+        std::lock_guard<std::mutex> lock(m_PendingMutex);
+        if (auto it = m_TextureSources.find(key); it != m_TextureSources.end()) {
+            std::erase_if(it->second, [this, &textures](const TextureSource& source) {
+                Ref<Texture2D> texture = m_Textures.GetRef(source.Handle);
+                if (!texture) return true;
+                textures.emplace_back(std::move(texture), source);
+                return false;
+            });
+            if (it->second.empty()) m_TextureSources.erase(it);
+        }
+        if (auto it = m_MeshSources.find(key); it != m_MeshSources.end()) {
+            std::erase_if(it->second, [this, &meshes](const MeshSource& source) {
+                Ref<Mesh> mesh = m_Meshes.GetRef(source.Handle);
+                if (!mesh) return true;
+                meshes.emplace_back(std::move(mesh), source);
+                return false;
+            });
+            if (it->second.empty()) m_MeshSources.erase(it);
+        }
+    }
+
+    for (const auto& entry : textures) {
+        const Ref<Texture2D>& texture = entry.first;
+        const TextureSource& source = entry.second;
+        JobSystem::Submit([this, texture, source, path = texture->GetFilePath()] {
+            auto image = CreateRef<TextureImage>(DecodeTexture(path, source.FlipVertically));
+            image->Stage();
+            QueueUpload([this, texture, source, image] {
+                ReloadTexture(texture, std::move(*image), *source.ContentHashes);
+            });
+        });
+    }
+
+    for (const auto& entry : meshes) {
+        const Ref<Mesh>& mesh = entry.first;
+        const MeshSource& source = entry.second;
+        String cookedPath = GetCookedMeshPath(source.FullPath, source.Options);
+        JobSystem::Submit([this, mesh, source, cookedPath] {
+            auto result = CreateRef<MeshReadResult>(ReadMesh(source.FullPath, cookedPath, source.Options));
+            QueueUpload([this, mesh, source, result] {
+                ReloadMesh(mesh, source.FullPath, *result, *source.ContentHashes);
+            });
+        });
+    }
+
+    return static_cast<u32>(textures.size() + meshes.size());
+}
+
+void ResourceManager::ReloadTexture(const Ref<Texture2D>& texture, TextureImage image, Vector<u64>& hashes) {
+    if (!image.IsValid()) {
+        LOG_CORE_ERROR("Failed to reload texture {}, keeping the previous image", texture->GetFilePath());
+        return;
+    }
+
+    Vector<u64> newHashes = HashTextureRegions(image);
+    const bool streamed = m_TextureStreamer.IsStreamed(*texture);
+
+    if (!texture->CanUpdate(image)) {
+        // New size or format: new storage, which MaterialLibrary follows
+        if (streamed) m_TextureStreamer.Unregister(*texture);
+        UploadTexture(texture, std::move(image));
+        hashes = std::move(newHashes);
+        LOG_CORE_INFO("Reloaded texture {} ({}x{})", texture->GetFilePath(), texture->GetWidth(), texture->GetHeight());
+        return;
+    }
+
+    // Without hashes from a previous reload every region counts as changed
+    const bool known = hashes.size() == newHashes.size();
+    const u32 regionCount = static_cast<u32>(newHashes.size());
+    u32 changed = 0;
+
+    if (texture->HasStoredMips()) {
+        for (u32 i = 0; i < regionCount; ++i) {
+            if (known && hashes[i] == newHashes[i]) continue;
+            texture->UpdateLevel(image, i);
+            changed++;
+        }
+    } else {
+        // Changed bands merge into one span of rows; mips are rebuilt once
+        u32 first = regionCount, last = 0;
+        for (u32 i = 0; i < regionCount; ++i) {
+            if (known && hashes[i] == newHashes[i]) continue;
+            first = std::min(first, i);
+            last = i;
+            changed++;
+        }
+        if (changed > 0) {
+            texture->UpdateRows(image, first * TextureReloadBandRows, (last - first + 1) * TextureReloadBandRows);
+        }
+    }
+
+    // Levels streamed in from now on come from the new chain
+    if (streamed) {
+        m_TextureStreamer.Register(texture, std::move(image));
+    }
+
+    hashes = std::move(newHashes);
+    LOG_CORE_INFO("Reloaded texture {} in place: {} of {} regions changed",
+                  texture->GetFilePath(), changed, regionCount);
+}
+
+void ResourceManager::ReloadMesh(const Ref<Mesh>& mesh, const String& fullPath, MeshReadResult& result,
+                                 Vector<u64>& hashes) {
+    if (!result.Cooked && !result.Parsed) {
+        LOG_CORE_ERROR("Failed to reload mesh {}, keeping the previous geometry", fullPath);
+        return;
+    }
+
+    Vector<PackedVertex> packed;
+    Vector<u8> positions;
+    const MeshGPUData data = result.Cooked ? result.Cooked->GetData() : result.Parsed->GetGPUData(packed, positions);
+
+    if (!mesh->CanUploadInPlace(data)) {
+        // New vertex or index count: a new range in the pool
+        Ref<Mesh> loaded = UploadMesh(fullPath, result);
+        if (!loaded) {
+            LOG_CORE_ERROR("Failed to upload reloaded mesh {}", fullPath);
+            return;
+        }
+        *mesh = std::move(*loaded);
+        hashes.clear();
+        LOG_CORE_INFO("Reloaded mesh {} ({} vertices)", fullPath, mesh->GetVertexCount());
+        return;
+    }
+
+    // Vertex, depth and index streams; unchanged ones are not uploaded
+    const u32 stride = Mesh::GetLayout(data.Format).GetStride();
+    const u32 positionStride = Mesh::GetPositionLayout(data.Format).GetStride();
+    const u32 indexCount = data.Indices ? data.IndexCount : 0;
+    Vector<u64> newHashes = {
+        HashContent(data.Vertices, static_cast<usize>(data.VertexCount) * stride),
+        data.Positions ? HashContent(data.Positions, static_cast<usize>(data.VertexCount) * positionStride) : 0,
+        data.Indices ? HashContent(data.Indices, static_cast<usize>(indexCount) * sizeof(u32)) : 0
+    };
+
+    MeshGPUData changed = data;
+    if (hashes.size() == newHashes.size()) {
+        if (hashes[0] == newHashes[0]) changed.Vertices = nullptr;
+        if (hashes[1] == newHashes[1]) changed.Positions = nullptr;
+        if (hashes[2] == newHashes[2]) changed.Indices = nullptr;
+    }
+
+    Ref<GeometryRange> range = mesh->GetGeometryRange();
+    if (result.Parsed) {
+        // CPU copy, bounds and submeshes of the new version; the stream
+        // pointers in data move along with its vectors
+        *mesh = std::move(*result.Parsed);
+    } else {
+        mesh->SetBounds(result.Cooked->GetBounds(), result.Cooked->GetBoundingSphere());
+        mesh->SetSubMeshes(result.Cooked->GetSubMeshes());
+    }
+    mesh->UploadInPlace(changed, range);
+
+    hashes = std::move(newHashes);
+    LOG_CORE_INFO("Reloaded mesh {} in place (vertices {}, indices {})", fullPath,
+                  changed.Vertices ? "changed" : "unchanged", changed.Indices ? "changed" : "unchanged");
+}
+
+void ResourceManager::UploadTexture(const Ref<Texture2D>& texture, TextureImage image) {
+    if (!m_TextureStreamer.GetSettings().Enabled || !TextureStreamer::CanStream(image)) {
+        texture->Upload(image);
+        return;
+    }
+
+    texture->Upload(image, m_TextureStreamer.GetInitialMip(image));
+    if (texture->IsLoaded()) {
+        m_TextureStreamer.Register(texture, std::move(image));
+    }
+}
+
+void ResourceManager::UpdateTextureStreaming() {
+    usize fixedBytes = 0;
+    m_Textures.ForEach([this, &fixedBytes](TextureHandle, const Ref<Texture2D>& texture) {
+        if (!m_TextureStreamer.IsStreamed(*texture)) {
+            fixedBytes += texture->GetMemorySize();
+        }
+    });
+
+    m_TextureStreamer.Update(fixedBytes);
+
+    if (m_TextureStreamer.GetStats().OverBudget) {
+        if (u32 unloaded = UnloadUnusedTextures(); unloaded > 0) {
+            LOG_CORE_INFO("Texture budget exceeded, unloaded {} unused textures", unloaded);
+        }
+    }
+}
+
+void ResourceManager::FinishTextureLoad(const String& name, const Ref<Texture2D>& texture, TextureImage image) {
+    const bool loaded = image.IsValid();
+    if (loaded) {
+        LOG_CORE_INFO("Loaded texture: '{}' from {} ({}x{})", name, texture->GetFilePath(),
+                      image.Width, image.Height);
+        UploadTexture(texture, std::move(image));
+    } else {
+        LOG_CORE_ERROR("Failed to load texture: {}", texture->GetFilePath());
+    }
+
+    Vector<TextureLoadCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(m_PendingMutex);
+        if (!loaded) {
+            m_Textures.Remove(m_Textures.Find(texture.get()));
+        }
+        auto pending = m_PendingTextures.find(name);
+        if (pending == m_PendingTextures.end()) return;
+        callbacks = std::move(pending->second);
+        m_PendingTextures.erase(pending);
+    }
+
+    for (auto& callback : callbacks) {
+        callback(texture, loaded);
+    }
+}
+
+void ResourceManager::FinishMeshLoad(const String& name, const String& fullPath, const Ref<Mesh>& mesh,
+                                     const MeshReadResult& result) {
+    Ref<Mesh> loaded = UploadMesh(fullPath, result);
+    if (loaded) {
+        *mesh = std::move(*loaded);
+        LOG_CORE_INFO("Loaded mesh: '{}' from {}", name, fullPath);
+    } else {
         LOG_CORE_ERROR("Failed to load mesh: {}", fullPath);
-        return nullptr;
     }
 
-    mesh->Upload();
-    m_Meshes[name] = mesh;
-    LOG_CORE_INFO("Loaded mesh: '{}' from {}", name, fullPath);
-    return mesh;
+    Vector<MeshLoadCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(m_PendingMutex);
+        if (!loaded) {
+            m_Meshes.Remove(m_Meshes.Find(mesh.get()));
+        }
+        auto pending = m_PendingMeshes.find(name);
+        if (pending == m_PendingMeshes.end()) return;
+        callbacks = std::move(pending->second);
+        m_PendingMeshes.erase(pending);
+    }
+
+    for (auto& callback : callbacks) {
+        callback(mesh, loaded != nullptr);
+    }
 }
 
-Ref<Mesh> ResourceManager::GetMesh(const String& name) {
-    if (auto it = m_Meshes.find(name); it != m_Meshes.end()) {
-        return it->second;
+String ResourceManager::GetCookedMeshPath(const String& fullPath, const MeshLoadOptions& options) const {
+    if (m_MeshCacheDirectory.empty() || MeshFile::IsMeshFile(fullPath)) {
+        return String();
+    }
+
+    // FNV-1a over the source path, continued with the options hash
+    u64 hash = AssetCooker::HashMeshOptions(options);
+    for (char c : fullPath) {
+        hash = (hash ^ static_cast<u8>(c)) * 1099511628211ull;
+    }
+
+    char suffix[24];
+    std::snprintf(suffix, sizeof(suffix), "_%016llx", static_cast<unsigned long long>(hash));
+
+    std::filesystem::path path(ResolvePath(m_MeshCacheDirectory));
+    path /= std::filesystem::path(fullPath).stem().string() + suffix + MeshFile::Extension;
+    return path.string();
+}
+
+ResourceManager::MeshReadResult ResourceManager::ReadMesh(const String& fullPath, const String& cookedPath,
+                                                          const MeshLoadOptions& options) const {
+    // The CPU copy and what parsing allocates count as geometry
+    MEMORY_TAG(Geometry);
+
+    MeshReadResult result;
+    result.Residency = options.Residency;
+
+    // Archives hold cooked meshes only: the one for these options, or a .pvmesh asked for by name
+    for (const String& path : {AssetCooker::GetCookedMeshPath(fullPath, options), fullPath}) {
+        if (!MeshFile::IsMeshFile(path)) continue;
+        if (AssetData data = ReadArchived(path)) {
+            auto file = CreateRef<MeshFile>();
+            if (file->Open(data, path)) {
+                result.Cooked = file;
+                RecordLoad(path);
+                return result;
+            }
+        }
+    }
+
+    if (MeshFile::IsMeshFile(fullPath)) {
+        auto file = CreateRef<MeshFile>();
+        if (file->Open(fullPath)) {
+            result.Cooked = file;
+            RecordLoad(fullPath);
+        }
+        return result;
+    }
+
+    // A cooked entry is used while it is at least as new as the source: the
+    // one AssetCooker put beside the source first, then the cache's
+    const String siblingPath = AssetCooker::GetCookedMeshPath(fullPath, options);
+    for (const String* path : {&siblingPath, &cookedPath}) {
+        if (path->empty()) continue;
+
+        std::error_code error;
+        auto cookedTime = std::filesystem::last_write_time(*path, error);
+        auto sourceTime = error ? cookedTime : std::filesystem::last_write_time(fullPath, error);
+        if (!error && cookedTime >= sourceTime) {
+            auto file = CreateRef<MeshFile>();
+            if (file->Open(*path)) {
+                result.Cooked = file;
+                RecordLoad(*path);
+                return result;
+            }
+        }
+    }
+
+    result.Parsed = MeshLoader::LoadOBJ(fullPath, options);
+    if (result.Parsed) {
+        RecordLoad(fullPath);
+    }
+    if (result.Parsed && !cookedPath.empty() && MeshFile::Write(*result.Parsed, cookedPath)) {
+        LOG_CORE_INFO("Cooked mesh {} to {}", fullPath, cookedPath);
+    }
+    return result;
+}
+
+TextureImage ResourceManager::DecodeTexture(const String& fullPath, bool flipVertically) const {
+    for (const String& path : {TextureCooker::GetCookedPath(fullPath), fullPath}) {
+        if (AssetData data = ReadArchived(path)) {
+            RecordLoad(path);
+            return TextureImage::Decode(data.Data, data.Size, path, flipVertically);
+        }
+    }
+
+    RecordLoad(fullPath);
+    return TextureImage::Decode(fullPath, flipVertically);
+}
+
+// Asset archives
+bool ResourceManager::MountArchive(const String& filepath) {
+    Ref<AssetArchive> archive = AssetArchive::Open(ResolvePath(filepath));
+    if (!archive) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_ArchiveMutex);
+    m_Archives.push_back(std::move(archive));
+    return true;
+}
+
+void ResourceManager::UnmountArchives() {
+    // Data already read keeps its archive mapped until released
+    std::lock_guard<std::mutex> lock(m_ArchiveMutex);
+    m_Archives.clear();
+}
+
+AssetData ResourceManager::ReadArchived(const String& fullPath) const {
+    Vector<Ref<AssetArchive>> archives;
+    {
+        std::lock_guard<std::mutex> lock(m_ArchiveMutex);
+        if (m_Archives.empty()) return {};
+        archives = m_Archives;
+    }
+
+    const String path = GetArchivePath(fullPath);
+    for (auto it = archives.rbegin(); it != archives.rend(); ++it) {
+        if (AssetData data = (*it)->Read(path)) {
+            return data;
+        }
+    }
+    return {};
+}
+
+String ResourceManager::GetArchivePath(const String& fullPath) const {
+    std::filesystem::path path(fullPath);
+    if (!m_BasePath.empty()) {
+        std::filesystem::path relative = path.lexically_relative(m_BasePath);
+        if (!relative.empty() && *relative.begin() != "..") {
+            path = std::move(relative);
+        }
+    }
+    return path.lexically_normal().generic_string();
+}
+
+void ResourceManager::SetLoadOrderRecording(bool enabled) {
+    std::lock_guard<std::mutex> lock(m_ArchiveMutex);
+    m_RecordLoadOrder = enabled;
+}
+
+void ResourceManager::RecordLoad(const String& fullPath) const {
+    std::lock_guard<std::mutex> lock(m_ArchiveMutex);
+    if (!m_RecordLoadOrder) return;
+
+    String path = GetArchivePath(fullPath);
+    if (m_LoadOrderSeen.emplace(path, true).second) {
+        m_LoadOrder.push_back(std::move(path));
+    }
+}
+
+bool ResourceManager::SaveLoadOrder(const String& filepath) const {
+    std::lock_guard<std::mutex> lock(m_ArchiveMutex);
+    std::ofstream file(ResolvePath(filepath), std::ios::trunc);
+    for (const String& path : m_LoadOrder) {
+        file << path << '\n';
+    }
+    if (!file) {
+        LOG_CORE_ERROR("Could not write the load order to {}", filepath);
+        return false;
+    }
+    LOG_CORE_INFO("Saved the load order of {} asset(s) to {}", m_LoadOrder.size(), filepath);
+    return true;
+}
+
+Ref<Mesh> ResourceManager::UploadMesh(const String& fullPath, const MeshReadResult& result) {
+    if (result.Cooked) {
+        auto mesh = result.Cooked->CreateMesh(GetGeometryPool(), result.Residency);
+        if (mesh) {
+            mesh->SetFilePath(fullPath);
+            mesh->SetName(std::filesystem::path(fullPath).stem().string());
+        }
+        return mesh;
+    }
+
+    if (result.Parsed) {
+        result.Parsed->SetResidency(result.Residency);
+        result.Parsed->Upload(GetGeometryPool());
+        return result.Parsed;
     }
     return nullptr;
 }
 
-bool ResourceManager::HasMesh(const String& name) const {
-    return m_Meshes.find(name) != m_Meshes.end();
+// Mesh residency
+void ResourceManager::UpdateMeshResidency() {
+    // Requests of the frame just drawn are in; the next frame's get a new stamp
+    const u64 frame = m_MeshFrame.fetch_add(1, std::memory_order_relaxed);
+
+    Vector<std::pair<MeshHandle, Ref<Mesh>>> restream;
+    Vector<std::pair<MeshHandle, Ref<Mesh>>> idle;
+    m_Meshes.ForEach([&](MeshHandle handle, const Ref<Mesh>& mesh) {
+        const u64 lastUsed = mesh->GetLastUsedFrame();
+        if (mesh->IsEvicted()) {
+            if (lastUsed == frame) restream.emplace_back(handle, mesh);
+        } else if (mesh->IsUploaded() && lastUsed == 0) {
+            // Not drawn since its upload: the eviction count starts now
+            mesh->MarkUsed(frame);
+        } else if (m_MeshEvictionFrames > 0 && mesh->IsUploaded() && frame - lastUsed >= m_MeshEvictionFrames) {
+            idle.emplace_back(handle, mesh);
+        }
+    });
+
+    for (const auto& [handle, mesh] : restream) {
+        RestreamMesh(handle, mesh);
+    }
+
+    u32 evicted = 0;
+    for (const auto& [handle, mesh] : idle) {
+        // Only what can come back goes
+        MeshSource source;
+        if (!mesh->HasCPUData() && !FindMeshSource(handle, mesh->GetFilePath(), source)) continue;
+        mesh->Evict();
+        ++evicted;
+    }
+    if (evicted > 0) {
+        LOG_CORE_INFO("Evicted the geometry of {} mesh(es) unused for {} frames", evicted, m_MeshEvictionFrames);
+    }
 }
 
-void ResourceManager::UnloadMesh(const String& name) {
-    if (auto it = m_Meshes.find(name); it != m_Meshes.end()) {
-        m_Meshes.erase(it);
-        LOG_CORE_INFO("Unloaded mesh: '{}'", name);
+void ResourceManager::RestreamMesh(MeshHandle handle, const Ref<Mesh>& mesh) {
+    if (mesh->HasCPUData()) {
+        mesh->Upload(GetGeometryPool());
+        return;
     }
+
+    // One read in flight per mesh; it is requested every frame until it lands
+    if (!m_RestreamingMeshes.emplace(mesh.get(), true).second) return;
+
+    // Left marked when it can't be read, so this is reported once
+    MeshSource source;
+    if (!FindMeshSource(handle, mesh->GetFilePath(), source)) {
+        LOG_CORE_ERROR("Mesh '{}' was evicted but has no file to stream it back in from", mesh->GetName());
+        return;
+    }
+
+    String cookedPath = GetCookedMeshPath(source.FullPath, source.Options);
+    JobSystem::Submit([this, mesh, source, cookedPath] {
+        auto result = CreateRef<MeshReadResult>(ReadMesh(source.FullPath, cookedPath, source.Options));
+        QueueUpload([this, mesh, source, result] {
+            m_RestreamingMeshes.erase(mesh.get());
+            if (!mesh->IsEvicted()) return;     // Reloaded in the meantime
+
+            // Keeping the policy the mesh had, should it have changed since the load
+            result->Residency = mesh->GetResidency();
+            Ref<Mesh> loaded = UploadMesh(source.FullPath, *result);
+            if (!loaded) {
+                LOG_CORE_ERROR("Failed to stream mesh {} back in", source.FullPath);
+                return;
+            }
+            *mesh = std::move(*loaded);
+            LOG_CORE_INFO("Streamed mesh {} back in", source.FullPath);
+        });
+    });
+}
+
+bool ResourceManager::FindMeshSource(MeshHandle handle, const String& fullPath, MeshSource& source) const {
+    if (fullPath.empty()) return false;
+
+    std::lock_guard<std::mutex> lock(m_PendingMutex);
+    auto it = m_MeshSources.find(NormalizeSourcePath(fullPath));
+    if (it == m_MeshSources.end()) return false;
+    for (const MeshSource& candidate : it->second) {
+        if (candidate.Handle == handle) {
+            source = candidate;
+            return true;
+        }
+    }
+    return false;
 }
 
 // Primitive meshes
+Ref<Mesh> ResourceManager::AddPrimitive(MeshHandle& slot, Ref<Mesh> mesh) {
+    mesh->SetVertexFormat(m_PrimitiveFormat);
+    mesh->Upload(GetGeometryPool());
+    slot = m_Meshes.Add(String(), mesh);
+    return mesh;
+}
+
 Ref<Mesh> ResourceManager::GetCube() {
-    if (!m_CubeMesh) {
-        m_CubeMesh = MeshLoader::CreateCube(1.0f);
-        m_CubeMesh->Upload();
+    if (Ref<Mesh> cached = m_Meshes.GetRef(m_CubeMesh)) {
+        return cached;
     }
-    return m_CubeMesh;
+    return AddPrimitive(m_CubeMesh, MeshLoader::CreateCube(1.0f));
 }
 
 Ref<Mesh> ResourceManager::GetSphere(u32 segments, u32 rings) {
-    u64 key = static_cast<u64>(segments) | (static_cast<u64>(rings) << 32);
-    if (auto it = m_SphereMeshes.find(key); it != m_SphereMeshes.end()) {
-        return it->second;
+    MeshHandle& slot = m_SphereMeshes[static_cast<u64>(segments) | (static_cast<u64>(rings) << 32)];
+    if (Ref<Mesh> cached = m_Meshes.GetRef(slot)) {
+        return cached;
     }
-
-    auto mesh = MeshLoader::CreateSphere(1.0f, segments, rings);
-    mesh->Upload();
-    m_SphereMeshes[key] = mesh;
-    return mesh;
+    return AddPrimitive(slot, MeshLoader::CreateSphere(1.0f, segments, rings));
 }
 
 Ref<Mesh> ResourceManager::GetPlane(u32 subdivisions) {
-    if (auto it = m_PlaneMeshes.find(subdivisions); it != m_PlaneMeshes.end()) {
-        return it->second;
+    MeshHandle& slot = m_PlaneMeshes[subdivisions];
+    if (Ref<Mesh> cached = m_Meshes.GetRef(slot)) {
+        return cached;
     }
-
-    auto mesh = MeshLoader::CreatePlane(1.0f, 1.0f, subdivisions);
-    mesh->Upload();
-    m_PlaneMeshes[subdivisions] = mesh;
-    return mesh;
+    return AddPrimitive(slot, MeshLoader::CreatePlane(1.0f, 1.0f, subdivisions));
 }
 
 Ref<Mesh> ResourceManager::GetCylinder(u32 segments) {
-    if (auto it = m_CylinderMeshes.find(segments); it != m_CylinderMeshes.end()) {
-        return it->second;
+    MeshHandle& slot = m_CylinderMeshes[segments];
+    if (Ref<Mesh> cached = m_Meshes.GetRef(slot)) {
+        return cached;
     }
+    return AddPrimitive(slot, MeshLoader::CreateCylinder(0.5f, 1.0f, segments));
+}
 
-    auto mesh = MeshLoader::CreateCylinder(0.5f, 1.0f, segments);
-    mesh->Upload();
-    m_CylinderMeshes[segments] = mesh;
-    return mesh;
+const Ref<GeometryPool>& ResourceManager::GetGeometryPool() {
+    if (!m_GeometryPool) {
+        m_GeometryPool = CreateRef<GeometryPool>();
+    }
+    return m_GeometryPool;
 }
 
 // Shader management
-Ref<Shader> ResourceManager::LoadShader(const String& name, const String& filepath) {
-    if (auto it = m_Shaders.find(name); it != m_Shaders.end()) {
+Ref<Shader> ResourceManager::LoadShader(const String& name, const String& filepath, const ShaderDefines& defines) {
+    if (ShaderHandle cached = m_Shaders.Find(name); cached) {
         LOG_CORE_WARN("Shader '{}' already loaded, returning cached version", name);
-        return it->second;
+        return m_Shaders.GetRef(cached);
     }
 
     String fullPath = ResolvePath(filepath);
-    auto shader = CreateRef<Shader>(fullPath);
+    String cacheDirectory = m_ShaderCacheDirectory.empty() ? String() : ResolvePath(m_ShaderCacheDirectory);
+    auto shader = CreateRef<Shader>(fullPath, cacheDirectory, defines);
 
-    m_Shaders[name] = shader;
-    LOG_CORE_INFO("Loaded shader: '{}' from {}", name, fullPath);
+    m_Shaders.Add(name, shader);
+    LOG_CORE_INFO("Loaded shader: '{}' from {}{}", name, fullPath,
+                  shader->IsFromBinaryCache() ? " (cached binary)" : "");
     return shader;
 }
 
 Ref<Shader> ResourceManager::GetShader(const String& name) {
-    if (auto it = m_Shaders.find(name); it != m_Shaders.end()) {
-        return it->second;
-    }
-    return nullptr;
+    return m_Shaders.GetRef(m_Shaders.Find(name));
 }
 
 bool ResourceManager::HasShader(const String& name) const {
-    return m_Shaders.find(name) != m_Shaders.end();
+    return m_Shaders.IsAlive(m_Shaders.Find(name));
 }
 
 void ResourceManager::UnloadShader(const String& name) {
-    if (auto it = m_Shaders.find(name); it != m_Shaders.end()) {
-        m_Shaders.erase(it);
+    if (m_Shaders.Remove(m_Shaders.Find(name))) {
         LOG_CORE_INFO("Unloaded shader: '{}'", name);
     }
 }
 
+// Vector field management
+Ref<VectorField> ResourceManager::LoadVectorField(const String& name, const String& filepath) {
+    if (VectorFieldHandle cached = m_VectorFields.Find(name); cached) {
+        return m_VectorFields.GetRef(cached);
+    }
+
+    String fullPath = ResolvePath(filepath);
+    auto field = VectorField::LoadFGA(fullPath);
+    if (!field) return nullptr;
+
+    m_VectorFields.Add(name, field);
+    LOG_CORE_INFO("Loaded vector field: '{}' from {} ({}x{}x{})", name, fullPath,
+                  field->GetWidth(), field->GetHeight(), field->GetDepth());
+    return field;
+}
+
+Ref<VectorField> ResourceManager::GenerateVectorField(const String& name,
+                                                      const VectorField::CurlNoiseSettings& settings) {
+    if (VectorFieldHandle cached = m_VectorFields.Find(name); cached) {
+        return m_VectorFields.GetRef(cached);
+    }
+
+    auto field = VectorField::CreateCurlNoise(settings);
+    m_VectorFields.Add(name, field);
+    LOG_CORE_INFO("Generated vector field: '{}' ({}^3 curl noise)", name, field->GetWidth());
+    return field;
+}
+
+Ref<VectorField> ResourceManager::GetVectorField(const String& name) {
+    return m_VectorFields.GetRef(m_VectorFields.Find(name));
+}
+
+bool ResourceManager::HasVectorField(const String& name) const {
+    return m_VectorFields.IsAlive(m_VectorFields.Find(name));
+}
+
+void ResourceManager::UnloadVectorField(const String& name) {
+    if (m_VectorFields.Remove(m_VectorFields.Find(name))) {
+        LOG_CORE_INFO("Unloaded vector field: '{}'", name);
+    }
+}
+
 // General management
 void ResourceManager::Clear() {
-    m_Textures.clear();
-    m_Meshes.clear();
-    m_Shaders.clear();
-    m_CubeMesh.reset();
+    // Loads in flight still complete into their handles, without callbacks
+    {
+        std::lock_guard<std::mutex> lock(m_PendingMutex);
+        m_PendingTextures.clear();
+        m_PendingMeshes.clear();
+        m_TextureSources.clear();
+        m_MeshSources.clear();
+    }
+    m_Textures.Clear();
+    m_TextureStreamer.Clear();
+    m_Meshes.Clear();
+    m_Shaders.Clear();
+    m_VectorFields.Clear();
+    m_CubeMesh = MeshHandle{};
     m_SphereMeshes.clear();
     m_PlaneMeshes.clear();
     m_CylinderMeshes.clear();
+    m_GeometryPool.reset();     // Lives on while pooled meshes are referenced
     LOG_CORE_INFO("ResourceManager cleared");
 }
 
-void ResourceManager::UnloadUnused() {
-    u32 unloaded = 0;
+u32 ResourceManager::UnloadUnusedTextures() {
+    return m_Textures.Sweep([](TextureHandle, const Ref<Texture2D>& texture) {
+        return texture.use_count() > 1;
+    });
+}
 
-    for (auto it = m_Textures.begin(); it != m_Textures.end();) {
-        if (it->second.use_count() == 1) {
-            it = m_Textures.erase(it);
-            ++unloaded;
-        } else {
-            ++it;
+void ResourceManager::UnloadUnused(const entt::registry* registry) {
+    // Handles don't hold references, so mark the slots components point at
+    Vector<u8> usedMeshes(m_Meshes.GetCapacity(), 0);
+    Vector<u8> usedShaders(m_Shaders.GetCapacity(), 0);
+    if (registry) {
+        for (auto [entity, mesh] : registry->view<MeshComponent>().each()) {
+            if (m_Meshes.IsAlive(mesh.Mesh)) usedMeshes[mesh.Mesh.Index] = 1;
         }
-    }
-
-    for (auto it = m_Meshes.begin(); it != m_Meshes.end();) {
-        if (it->second.use_count() == 1) {
-            it = m_Meshes.erase(it);
-            ++unloaded;
-        } else {
-            ++it;
+        for (auto [entity, material] : registry->view<MaterialComponent>().each()) {
+            if (m_Shaders.IsAlive(material.Shader)) usedShaders[material.Shader.Index] = 1;
         }
     }
 
-    for (auto it = m_Shaders.begin(); it != m_Shaders.end();) {
-        if (it->second.use_count() == 1) {
-            it = m_Shaders.erase(it);
-            ++unloaded;
-        } else {
-            ++it;
-        }
-    }
+    u32 unloaded = UnloadUnusedTextures();
+    unloaded += m_Meshes.Sweep([&usedMeshes](MeshHandle handle, const Ref<Mesh>& mesh) {
+        return usedMeshes[handle.Index] || mesh.use_count() > 1;
+    });
+    unloaded += m_Shaders.Sweep([&usedShaders](ShaderHandle handle, const Ref<Shader>& shader) {
+        return usedShaders[handle.Index] || shader.use_count() > 1;
+    });
+    unloaded += m_VectorFields.Sweep([](VectorFieldHandle, const Ref<VectorField>& field) {
+        return field.use_count() > 1;
+    });
 
     if (unloaded > 0) {
         LOG_CORE_INFO("Unloaded {} unused resources", unloaded);
@@ -224,13 +965,22 @@ void ResourceManager::UnloadUnused() {
 
 ResourceManager::Stats ResourceManager::GetStats() const {
     Stats stats;
-    stats.TexturesLoaded = static_cast<u32>(m_Textures.size());
-    stats.MeshesLoaded = static_cast<u32>(m_Meshes.size() +
-        (m_CubeMesh ? 1 : 0) +
-        m_SphereMeshes.size() +
-        m_PlaneMeshes.size() +
-        m_CylinderMeshes.size());
-    stats.ShadersLoaded = static_cast<u32>(m_Shaders.size());
+    stats.TexturesLoaded = static_cast<u32>(m_Textures.GetCount());
+    stats.MeshesLoaded = static_cast<u32>(m_Meshes.GetCount());
+    stats.ShadersLoaded = static_cast<u32>(m_Shaders.GetCount());
+    stats.VectorFieldsLoaded = static_cast<u32>(m_VectorFields.GetCount());
+    {
+        std::lock_guard<std::mutex> lock(m_PendingMutex);
+        stats.PendingLoads = static_cast<u32>(m_PendingTextures.size() + m_PendingMeshes.size());
+    }
+    m_Textures.ForEach([&stats](TextureHandle, const Ref<Texture2D>& texture) {
+        stats.EstimatedMemory += texture->GetMemorySize();
+    });
+    m_Meshes.ForEach([&stats](MeshHandle, const Ref<Mesh>& mesh) {
+        if (mesh->IsEvicted()) stats.MeshesEvicted++;
+        stats.MeshCPUMemory += mesh->GetCPUMemorySize();
+        stats.MeshGPUMemory += mesh->GetGPUMemorySize();
+    });
     return stats;
 }
 
@@ -4,10 +4,34 @@
 #include "renderer/Texture.hpp"
 #include "renderer/Mesh.hpp"
 #include "renderer/opengl/GLShader.hpp"
+#include "renderer/particles/VectorField.hpp"
+#include "resources/loaders/MeshFile.hpp"
 #include "resources/loaders/MeshLoader.hpp"
+#include "resources/AssetArchive.hpp"
+#include "resources/ResourceHandle.hpp"
+#include "resources/TextureStreamer.hpp"
+#include <entt/entt.hpp>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 namespace Engine {
 
+// ResourceManager - textures, meshes, shaders and vector fields in
+// generational pools.
+//
+// Every resource sits in a dense ResourcePool slot and is addressed by an
+// 8-byte handle (TextureHandle, MeshHandle, ShaderHandle); names are looked
+// up by hash. Loaders hand out Refs as before, while components store
+// handles and renderers resolve them as they draw - a stale handle resolves
+// to null instead of keeping the resource alive.
+//
+// Lookups (handles, names, Get*/Has*) are safe from any thread, handles
+// without taking a lock. Loads may be requested from any thread too: two
+// requests for the same name share one decode, and sync loads made off the
+// GL thread become async ones. Uploads, streaming, unloading and shaders
+// stay on the GL thread.
 class ResourceManager {
 public:
     static ResourceManager& Instance();
@@ -16,63 +40,302 @@ public:
     ResourceManager& operator=(const ResourceManager&) = delete;
 
     // Texture management
+    // Sync loads return null on failure. Off the GL thread they are started
+    // asynchronously instead and return the pending texture / mesh.
     Ref<Texture2D> LoadTexture(const String& name, const String& filepath, bool flipVertically = true);
     Ref<Texture2D> GetTexture(const String& name);
     bool HasTexture(const String& name) const;
     void UnloadTexture(const String& name);
 
-    // Mesh management
+    TextureHandle FindTexture(const String& name) const { return m_Textures.Find(name); }
+    TextureHandle AddTexture(const Ref<Texture2D>& texture, const String& name = String());
+    Texture2D* GetTexture(TextureHandle handle) const { return m_Textures.Get(handle); }
+
+    // Mesh management. Cooked .pvmesh files are mapped and uploaded as they
+    // are; OBJ files are cooked into the mesh cache on first load and read
+    // from there while the cooked file is newer than the source.
     Ref<Mesh> LoadMesh(const String& name, const String& filepath, const MeshLoadOptions& options = {});
     Ref<Mesh> GetMesh(const String& name);
     bool HasMesh(const String& name) const;
     void UnloadMesh(const String& name);
 
+    // Handle of a named mesh, or of any mesh (primitives, meshes built in
+    // code), registering it when it isn't pooled yet. Adding an already
+    // pooled mesh returns its existing handle.
+    MeshHandle FindMesh(const String& name) const { return m_Meshes.Find(name); }
+    MeshHandle AddMesh(const Ref<Mesh>& mesh, const String& name = String());
+    Mesh* GetMesh(MeshHandle handle) const { return m_Meshes.Get(handle); }
+    String GetMeshName(MeshHandle handle) const { return m_Meshes.GetName(handle); }
+
+    // Asynchronous loading: the file is read and decoded on the job system,
+    // then uploaded by ProcessUploads on the GL thread. The returned handle is
+    // cached and usable at once - a texture samples 1x1 white and a mesh has
+    // no geometry (IsUploaded() false) until its upload. onLoaded runs on the
+    // GL thread after the upload, or with loaded = false when the file failed.
+    // A texture requested off the GL thread has no storage, rather than the
+    // white stand-in, until its upload.
+    using TextureLoadCallback = std::function<void(const Ref<Texture2D>& texture, bool loaded)>;
+    using MeshLoadCallback = std::function<void(const Ref<Mesh>& mesh, bool loaded)>;
+
+    Ref<Texture2D> LoadTextureAsync(const String& name, const String& filepath, bool flipVertically = true,
+                                    TextureLoadCallback onLoaded = {});
+    Ref<Mesh> LoadMeshAsync(const String& name, const String& filepath, const MeshLoadOptions& options = {},
+                            MeshLoadCallback onLoaded = {});
+
+    // Upload finished asynchronous loads until budgetMs is spent (at least
+    // one per call). Application calls this once a frame.
+    void ProcessUploads(f32 budgetMs = DefaultUploadBudgetMs);
+
+    static constexpr f32 DefaultUploadBudgetMs = 2.0f;
+
+    // Uploads ProcessUploads has run so far - loads and hot reloads landing.
+    // A change means resources may look different than last frame.
+    u64 GetUploadCount() const { return m_UploadCount; }
+
+    // Hot reload: read filepath (as on disk, not relative to the base path)
+    // again on the job system for every texture and mesh loaded from it, and
+    // swap the result into the same objects in ProcessUploads, so handles
+    // and Refs stay valid. A texture or mesh keeping its size and layout is
+    // rewritten in its existing storage, uploading only the regions that
+    // changed since its previous reload. A file that fails to load keeps
+    // the old contents. Returns the number of resources being reloaded.
+    u32 ReloadFile(const String& filepath);
+
+    // Textures with a stored mip chain (KTX2 / DDS) are streamed: they load
+    // at a low mip and TextureStreamer brings in the levels their draws ask
+    // for within its VRAM budget, which every other cached texture counts
+    // against. When the budget cannot be met, textures nothing else holds
+    // are unloaded. Application calls this once a frame.
+    void UpdateTextureStreaming();
+    TextureStreamer& GetTextureStreamer() { return m_TextureStreamer; }
+
+    // Mesh residency. Renderers report the meshes they draw with
+    // RequestMesh; UpdateMeshResidency evicts the GPU geometry of meshes no
+    // renderer asked for in the last eviction-frames frames, and streams
+    // evicted ones back in once one does - from the CPU copy when the
+    // mesh's MeshResidency kept it, otherwise by reading its file again.
+    // Meshes with neither stay resident. Application calls
+    // UpdateMeshResidency once a frame.
+    void RequestMesh(const Mesh& mesh) const { mesh.MarkUsed(m_MeshFrame.load(std::memory_order_relaxed)); }
+    void UpdateMeshResidency();
+
+    // 0 (the default) evicts nothing
+    void SetMeshEvictionFrames(u32 frames) { m_MeshEvictionFrames = frames; }
+    u32 GetMeshEvictionFrames() const { return m_MeshEvictionFrames; }
+
     // Primitive meshes (cached automatically)
     Ref<Mesh> GetCube();
     Ref<Mesh> GetSphere(u32 segments = 32, u32 rings = 16);
     Ref<Mesh> GetPlane(u32 subdivisions = 1);
     Ref<Mesh> GetCylinder(u32 segments = 32);
 
-    // Shader management
-    Ref<Shader> LoadShader(const String& name, const String& filepath);
+    // Shared vertex / index storage every mesh above is uploaded into
+    const Ref<GeometryPool>& GetGeometryPool();
+
+    // Layout primitives are created with from now on (cached ones keep theirs)
+    void SetPrimitiveVertexFormat(VertexFormat format) { m_PrimitiveFormat = format; }
+    VertexFormat GetPrimitiveVertexFormat() const { return m_PrimitiveFormat; }
+
+    // Shader management; variants of one file load under different names
+    Ref<Shader> LoadShader(const String& name, const String& filepath, const ShaderDefines& defines = {});
     Ref<Shader> GetShader(const String& name);
     bool HasShader(const String& name) const;
     void UnloadShader(const String& name);
 
+    ShaderHandle FindShader(const String& name) const { return m_Shaders.Find(name); }
+    Shader* GetShader(ShaderHandle handle) const { return m_Shaders.Get(handle); }
+    String GetShaderName(ShaderHandle handle) const { return m_Shaders.GetName(handle); }
+
+    // Vector fields (particle turbulence), shared by name between emitters.
+    // Load reads an FGA file; Generate bakes tiling curl noise on the GPU.
+    // Both return the cached field when the name is taken, null on failure.
+    Ref<VectorField> LoadVectorField(const String& name, const String& filepath);
+    Ref<VectorField> GenerateVectorField(const String& name, const VectorField::CurlNoiseSettings& settings = {});
+    Ref<VectorField> GetVectorField(const String& name);
+    bool HasVectorField(const String& name) const;
+    void UnloadVectorField(const String& name);
+
+    // Where linked shader programs are cached between runs (relative to the
+    // base path); empty compiles every shader from source
+    void SetShaderCacheDirectory(const String& path) { m_ShaderCacheDirectory = path; }
+    const String& GetShaderCacheDirectory() const { return m_ShaderCacheDirectory; }
+
+    // Where OBJ meshes are cooked to (relative to the base path); empty
+    // parses every mesh from source
+    void SetMeshCacheDirectory(const String& path) { m_MeshCacheDirectory = path; }
+    const String& GetMeshCacheDirectory() const { return m_MeshCacheDirectory; }
+
+    // Asset archives (.pvpak, see AssetArchive) built from the base path.
+    // Textures and meshes are read from the most recently mounted archive
+    // holding them, cooked versions first, before loose files are tried.
+    bool MountArchive(const String& filepath);
+    void UnmountArchives();
+
+    // Record the relative path of every texture / mesh file read, in order,
+    // for PackAssets to lay the small ones out by
+    void SetLoadOrderRecording(bool enabled);
+    bool SaveLoadOrder(const String& filepath) const;
+
     // General management
     void Clear();
-    void UnloadUnused();
+
+    // Sweep the pools for resources nothing holds: no Ref outside the
+    // manager and, given a registry, no MeshComponent / MaterialComponent
+    // handle in it
+    void UnloadUnused(const entt::registry* registry = nullptr);
+
+    // Textures only (components don't reference them); returns the count
+    u32 UnloadUnusedTextures();
 
     // Statistics
     struct Stats {
         u32 TexturesLoaded = 0;
         u32 MeshesLoaded = 0;
         u32 ShadersLoaded = 0;
-        size_t EstimatedMemory = 0;
+        u32 VectorFieldsLoaded = 0;
+        u32 PendingLoads = 0;       // Decoding or waiting for ProcessUploads
+        size_t EstimatedMemory = 0;  // Texture storage currently resident
+        u32 MeshesEvicted = 0;
+        size_t MeshCPUMemory = 0;    // CPU copies and collision data (Mesh::GetCPUMemorySize)
+        size_t MeshGPUMemory = 0;    // Geometry of resident meshes (Mesh::GetGPUMemorySize)
     };
     Stats GetStats() const;
 
     void SetBasePath(const String& path) { m_BasePath = path; }
     const String& GetBasePath() const { return m_BasePath; }
 
+    // The thread owning the GL context: the one that first called Instance()
+    // until Application sets it
+    void SetGLThread(std::thread::id thread) { m_GLThread = thread; }
+    bool IsGLThread() const { return std::this_thread::get_id() == m_GLThread; }
+
 private:
-    ResourceManager() = default;
+    ResourceManager() : m_GLThread(std::this_thread::get_id()) {}
     ~ResourceManager() = default;
 
     String ResolvePath(const String& relativePath) const;
 
+    // Look name up and, when it isn't cached, claim it with a new pending
+    // resource. True when the caller must run the load; otherwise resource
+    // is the cached one and onLoaded was queued on its load or called.
+    // A claimed name is also recorded as loaded from fullPath for ReloadFile.
+    bool ClaimTextureLoad(const String& name, const String& fullPath, bool flipVertically, bool placeholder,
+                          TextureLoadCallback& onLoaded, Ref<Texture2D>& texture);
+    bool ClaimMeshLoad(const String& name, const String& fullPath, const MeshLoadOptions& options,
+                       MeshLoadCallback& onLoaded, Ref<Mesh>& mesh);
+
+    // Called by the loader jobs with the GL-thread half of a load
+    void QueueUpload(std::function<void()> upload);
+
+    // Upload a decoded image, handing it to the streamer when it can stream
+    void UploadTexture(const Ref<Texture2D>& texture, TextureImage image);
+    void FinishTextureLoad(const String& name, const Ref<Texture2D>& texture, TextureImage image);
+
+    // CPU half of a mesh load, safe on any thread: a mapped cooked file, or
+    // the parsed source (cooked to cookedPath when that is set)
+    struct MeshReadResult {
+        Ref<MeshFile> Cooked;
+        Ref<Mesh> Parsed;
+        MeshResidency Residency = MeshResidency::KeepCPU;  // Applied by UploadMesh
+    };
+    MeshReadResult ReadMesh(const String& fullPath, const String& cookedPath, const MeshLoadOptions& options) const;
+
+    // Decode from the mounted archives or, failing that, the file
+    TextureImage DecodeTexture(const String& fullPath, bool flipVertically) const;
+
+    // fullPath from the mounted archives; empty when none holds it
+    AssetData ReadArchived(const String& fullPath) const;
+    void RecordLoad(const String& fullPath) const;
+
+    // Path relative to the base path with '/' separators, as archives name entries
+    String GetArchivePath(const String& fullPath) const;
+
+    // GL half: upload the result into the geometry pool
+    Ref<Mesh> UploadMesh(const String& fullPath, const MeshReadResult& result);
+
+    // Cache entry for a source mesh and its options, empty without a cache
+    String GetCookedMeshPath(const String& fullPath, const MeshLoadOptions& options) const;
+
+    void FinishMeshLoad(const String& name, const String& fullPath, const Ref<Mesh>& mesh,
+                        const MeshReadResult& result);
+
+    // GL half of ReloadFile. hashes are the region hashes of the previous
+    // reload and are replaced by the new ones.
+    void ReloadTexture(const Ref<Texture2D>& texture, TextureImage image, Vector<u64>& hashes);
+    void ReloadMesh(const Ref<Mesh>& mesh, const String& fullPath, MeshReadResult& result, Vector<u64>& hashes);
+
+    // Upload an evicted mesh again, from its CPU copy or its file
+    void RestreamMesh(MeshHandle handle, const Ref<Mesh>& mesh);
+    struct MeshSource;
+    bool FindMeshSource(MeshHandle handle, const String& fullPath, MeshSource& source) const;
+
+    // Upload a new primitive in the primitive format and pool it in slot
+    Ref<Mesh> AddPrimitive(MeshHandle& slot, Ref<Mesh> mesh);
+
 private:
-    HashMap<String, Ref<Texture2D>> m_Textures;
-    HashMap<String, Ref<Mesh>> m_Meshes;
-    HashMap<String, Ref<Shader>> m_Shaders;
+    ResourcePool<Texture2D> m_Textures;
+    ResourcePool<Mesh> m_Meshes;
+    ResourcePool<Shader> m_Shaders;
+    ResourcePool<VectorField> m_VectorFields;
+
+    // Callbacks of loads still in flight, by resource name. Held while a
+    // name is claimed in the pool and its load registered, so concurrent
+    // requests either start the load or join it.
+    mutable std::mutex m_PendingMutex;
+    HashMap<String, Vector<TextureLoadCallback>> m_PendingTextures;
+    HashMap<String, Vector<MeshLoadCallback>> m_PendingMeshes;
+
+    // Where file-backed resources were read from, for ReloadFile, by
+    // normalized path (under m_PendingMutex). The hashes are only touched
+    // by the reloads on the GL thread.
+    struct TextureSource {
+        TextureHandle Handle;
+        bool FlipVertically = true;
+        Ref<Vector<u64>> ContentHashes;
+    };
+    struct MeshSource {
+        MeshHandle Handle;
+        String FullPath;
+        MeshLoadOptions Options;
+        Ref<Vector<u64>> ContentHashes;
+    };
+    HashMap<String, Vector<TextureSource>> m_TextureSources;
+    HashMap<String, Vector<MeshSource>> m_MeshSources;
+
+    // Residency frame RequestMesh stamps meshes with, and the evicted meshes
+    // being read back in (GL thread)
+    std::atomic<u64> m_MeshFrame{1};
+    u32 m_MeshEvictionFrames = 0;
+    HashMap<const Mesh*, bool> m_RestreamingMeshes;
+
+    std::mutex m_UploadMutex;
+    std::deque<std::function<void()>> m_Uploads;   // Decoded, waiting for the GL thread
+    u64 m_UploadCount = 0;                          // GL thread
+
+    TextureStreamer m_TextureStreamer;
+
+    // Mount order; searched from the back. The load order is recorded
+    // under the same lock.
+    mutable std::mutex m_ArchiveMutex;
+    Vector<Ref<AssetArchive>> m_Archives;
+    bool m_RecordLoadOrder = false;
+    mutable Vector<String> m_LoadOrder;
+    mutable HashMap<String, bool> m_LoadOrderSeen;
+
+    Ref<GeometryPool> m_GeometryPool;   // Created with the first mesh
+    VertexFormat m_PrimitiveFormat = VertexFormat::Full;
 
-    // Primitive cache
-    Ref<Mesh> m_CubeMesh;
-    HashMap<u64, Ref<Mesh>> m_SphereMeshes;  // key = segments | (rings << 32)
-    HashMap<u32, Ref<Mesh>> m_PlaneMeshes;   // key = subdivisions
-    HashMap<u32, Ref<Mesh>> m_CylinderMeshes; // key = segments
+    // Primitive cache, slots in m_Meshes. Swept like any other mesh once
+    // unused, and created again on the next request.
+    MeshHandle m_CubeMesh;
+    HashMap<u64, MeshHandle> m_SphereMeshes;  // key = segments | (rings << 32)
+    HashMap<u32, MeshHandle> m_PlaneMeshes;   // key = subdivisions
+    HashMap<u32, MeshHandle> m_CylinderMeshes; // key = segments
 
+    std::thread::id m_GLThread;
     String m_BasePath;
+    String m_ShaderCacheDirectory = "cache/shaders";
+    String m_MeshCacheDirectory = "cache/meshes";
 };
 
 } // namespace Engine
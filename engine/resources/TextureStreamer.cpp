@@ -0,0 +1,187 @@
+#include "resources/TextureStreamer.hpp"
+#include "core/Logger.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Engine {
+
+u32 TextureStreamer::GetFloorMip(const TextureImage& image) const {
+    const u32 levelCount = static_cast<u32>(image.Levels.size());
+    for (u32 i = 0; i < levelCount; ++i) {
+        if (std::max(image.Levels[i].Width, image.Levels[i].Height) <= m_Settings.MinResidentSize) {
+            return i;
+        }
+    }
+    return levelCount > 0 ? levelCount - 1 : 0;
+}
+
+u32 TextureStreamer::GetInitialMip(const TextureImage& image) const {
+    return CanStream(image) ? GetFloorMip(image) : 0;
+}
+
+void TextureStreamer::Register(const Ref<Texture2D>& texture, TextureImage image) {
+    if (!texture || !texture->HasStoredMips() || !CanStream(image)) {
+        LOG_CORE_WARN("TextureStreamer: {} has no stored mip chain to stream", texture ? texture->GetFilePath() : "");
+        return;
+    }
+
+    // A previous texture at the same address is gone by now
+    Entry& entry = m_Entries[texture.get()];
+    entry.Texture = texture;
+    entry.FloorMip = GetFloorMip(image);
+    entry.WantedMip = 0;
+    entry.RequestedMip = ~0u;
+    entry.LastUsedFrame = m_Frame;
+    entry.Source = std::move(image);
+
+    // Kept for as long as the texture streams: holding its staged copy would
+    // stall the upload ring behind it
+    entry.Source.Staging.reset();
+}
+
+void TextureStreamer::Unregister(const Texture2D& texture) {
+    m_Entries.erase(&texture);
+}
+
+bool TextureStreamer::IsStreamed(const Texture2D& texture) const {
+    return m_Entries.find(&texture) != m_Entries.end();
+}
+
+void TextureStreamer::RequestMip(const Texture2D& texture, u32 mip) {
+    auto it = m_Entries.find(&texture);
+    if (it == m_Entries.end()) return;
+    it->second.RequestedMip = std::min(it->second.RequestedMip, mip);
+}
+
+void TextureStreamer::RequestScreenSize(const Texture2D& texture, f32 screenPixels) {
+    RequestMip(texture, ComputeMip(texture, screenPixels));
+}
+
+u32 TextureStreamer::ComputeMip(const Texture2D& texture, f32 screenPixels) {
+    const u32 lastMip = texture.GetMipCount() - 1;
+    if (screenPixels <= 0.0f) return lastMip;
+
+    const f32 texelsPerPixel = static_cast<f32>(std::max(texture.GetWidth(), texture.GetHeight())) / screenPixels;
+    if (texelsPerPixel <= 1.0f) return 0;
+    return std::min(static_cast<u32>(std::floor(std::log2(texelsPerPixel))), lastMip);
+}
+
+bool TextureStreamer::EvictOne(const Entry* keep, usize& residentBytes) {
+    Entry* victim = nullptr;
+    Ref<Texture2D> victimTexture;
+    bool victimExcess = false;
+
+    for (auto& [key, entry] : m_Entries) {
+        if (&entry == keep) continue;
+        Ref<Texture2D> texture = entry.Texture.lock();
+        if (!texture || texture->GetResidentMip() >= entry.FloorMip) continue;
+
+        // Levels beyond the last request go first, then whole textures by age.
+        // Streaming one texture in never takes what an equally recent one uses.
+        const bool excess = texture->GetResidentMip() < entry.WantedMip;
+        if (keep && !excess && entry.LastUsedFrame >= keep->LastUsedFrame) continue;
+
+        if (!victim || (excess && !victimExcess) ||
+            (excess == victimExcess && entry.LastUsedFrame < victim->LastUsedFrame)) {
+            victim = &entry;
+            victimTexture = std::move(texture);
+            victimExcess = excess;
+        }
+    }
+
+    if (!victim) return false;
+
+    const usize before = victimTexture->GetMemorySize();
+    victimTexture->SetResidentMip(victim->Source, victimTexture->GetResidentMip() + 1);
+    residentBytes -= std::min(residentBytes, before - victimTexture->GetMemorySize());
+    m_Stats.LevelsEvicted++;
+    return true;
+}
+
+void TextureStreamer::Update(usize fixedBytes) {
+    m_Frame++;
+    m_Stats.LevelsStreamedIn = 0;
+    m_Stats.LevelsEvicted = 0;
+    m_Stats.OverBudget = false;
+
+    usize residentBytes = 0;
+    m_StreamIn.clear();
+
+    for (auto it = m_Entries.begin(); it != m_Entries.end();) {
+        Entry& entry = it->second;
+        Ref<Texture2D> texture = entry.Texture.lock();
+        if (!texture) {
+            it = m_Entries.erase(it);
+            continue;
+        }
+
+        if (entry.RequestedMip != ~0u) {
+            entry.WantedMip = entry.RequestedMip;
+            entry.LastUsedFrame = m_Frame;
+            entry.RequestedMip = ~0u;
+        }
+
+        residentBytes += texture->GetMemorySize();
+        if (texture->GetResidentMip() > entry.WantedMip) {
+            m_StreamIn.push_back(&entry);
+        }
+        ++it;
+    }
+
+    // Most recently used first, then whichever is furthest from its request
+    std::sort(m_StreamIn.begin(), m_StreamIn.end(), [](const Entry* a, const Entry* b) {
+        if (a->LastUsedFrame != b->LastUsedFrame) return a->LastUsedFrame > b->LastUsedFrame;
+        return a->Texture.lock()->GetResidentMip() - a->WantedMip >
+               b->Texture.lock()->GetResidentMip() - b->WantedMip;
+    });
+
+    const usize budget = m_Settings.BudgetBytes;
+    const u32 maxChanges = std::max(m_Settings.MaxChangesPerFrame, 1u);
+    u32 changes = 0;
+
+    // The budget may have shrunk, or the fixed textures grown, since last frame
+    while (fixedBytes + residentBytes > budget && changes < maxChanges && EvictOne(nullptr, residentBytes)) {
+        changes++;
+    }
+
+    for (Entry* entry : m_StreamIn) {
+        if (changes >= maxChanges) break;
+
+        Ref<Texture2D> texture = entry->Texture.lock();
+        const u32 mip = texture->GetResidentMip() - 1;
+        const usize cost = GetTextureLevelSize(texture->GetFormat(), entry->Source.Levels[mip].Width,
+                                               entry->Source.Levels[mip].Height);
+
+        while (fixedBytes + residentBytes + cost > budget && changes < maxChanges &&
+               EvictOne(entry, residentBytes)) {
+            changes++;
+        }
+        if (changes >= maxChanges) break;
+        if (fixedBytes + residentBytes + cost > budget) {
+            m_Stats.OverBudget = true;
+            continue;
+        }
+
+        texture->SetResidentMip(entry->Source, mip);
+        residentBytes += cost;
+        changes++;
+        m_Stats.LevelsStreamedIn++;
+    }
+
+    if (fixedBytes + residentBytes > budget) {
+        m_Stats.OverBudget = true;
+    }
+
+    m_Stats.StreamedTextures = static_cast<u32>(m_Entries.size());
+    m_Stats.ResidentBytes = residentBytes;
+    m_Stats.FixedBytes = fixedBytes;
+    m_Stats.BudgetBytes = budget;
+}
+
+void TextureStreamer::Clear() {
+    m_Entries.clear();
+    m_StreamIn.clear();
+    m_Stats = Stats{};
+}
+
+} // namespace Engine
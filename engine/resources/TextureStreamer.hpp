@@ -0,0 +1,109 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/Texture.hpp"
+
+namespace Engine {
+
+struct TextureStreamingSettings {
+    // Off: KTX2 / DDS textures upload their whole chain, as other formats do
+    bool Enabled = true;
+
+    // Texture memory (streamed and fixed) the streamer keeps residency under
+    usize BudgetBytes = 512ull << 20;
+
+    // Textures start with, and are never evicted below, the levels whose
+    // longer side is at most this many texels
+    u32 MinResidentSize = 64;
+
+    // Levels streamed in or evicted per Update(); each is one new texture
+    // with the resident levels copied over on the GPU
+    u32 MaxChangesPerFrame = 8;
+};
+
+// TextureStreamer - mip residency of textures with a stored mip chain.
+//
+// A registered texture keeps its decoded image (the KTX2 / DDS chain, still
+// block compressed) in system memory and only the levels from its resident
+// mip down on the GPU. Each frame whoever draws a texture reports the mip
+// its screen footprint needs; Update() then streams in one level at a time
+// towards the most detailed request, and when that would exceed the budget
+// evicts levels from the least recently used textures first. Textures no
+// one reports on stream up to full resolution and are the first to give
+// levels back. GL thread only.
+class TextureStreamer {
+public:
+    struct Stats {
+        u32 StreamedTextures = 0;
+        usize ResidentBytes = 0;    // Streamed textures
+        usize FixedBytes = 0;       // Everything else Update() was given
+        usize BudgetBytes = 0;
+        u32 LevelsStreamedIn = 0;   // Last Update()
+        u32 LevelsEvicted = 0;
+        bool OverBudget = false;    // Even with every texture at its floor
+    };
+
+    TextureStreamer() = default;
+    ~TextureStreamer() = default;
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    void SetSettings(const TextureStreamingSettings& settings) { m_Settings = settings; }
+    const TextureStreamingSettings& GetSettings() const { return m_Settings; }
+
+    // Whether image can be streamed: a stored chain of more than one level
+    static bool CanStream(const TextureImage& image) { return image.Levels.size() > 1; }
+
+    // Mip texture should start at when uploaded for streaming
+    u32 GetInitialMip(const TextureImage& image) const;
+
+    // Start streaming texture, already uploaded from image (which the
+    // streamer keeps). The texture is not kept alive by the streamer.
+    void Register(const Ref<Texture2D>& texture, TextureImage image);
+    void Unregister(const Texture2D& texture);
+    bool IsStreamed(const Texture2D& texture) const;
+
+    // Residency feedback for this frame; the most detailed request wins
+    void RequestMip(const Texture2D& texture, u32 mip);
+
+    // Texture drawn screenPixels across at its largest on screen
+    void RequestScreenSize(const Texture2D& texture, f32 screenPixels);
+
+    // Mip at which texture maps about one texel to a pixel when drawn
+    // screenPixels across
+    static u32 ComputeMip(const Texture2D& texture, f32 screenPixels);
+
+    // Apply this frame's requests. fixedBytes is the texture memory the
+    // streamer does not manage, counted against the same budget.
+    void Update(usize fixedBytes = 0);
+
+    void Clear();
+
+    const Stats& GetStats() const { return m_Stats; }
+
+private:
+    struct Entry {
+        WeakRef<Texture2D> Texture;
+        TextureImage Source;
+        u32 FloorMip = 0;           // Lowest residency eviction goes to
+        u32 WantedMip = 0;          // Most detailed mip last requested
+        u32 RequestedMip = ~0u;     // This frame, ~0u when unrequested
+        u64 LastUsedFrame = 0;
+    };
+
+    u32 GetFloorMip(const TextureImage& image) const;
+
+    // Drop one level from the least recently used texture that can spare one,
+    // skipping keep. Returns false when none can.
+    bool EvictOne(const Entry* keep, usize& residentBytes);
+
+private:
+    TextureStreamingSettings m_Settings;
+    HashMap<const Texture2D*, Entry> m_Entries;
+    Vector<Entry*> m_StreamIn;      // Scratch for Update()
+    u64 m_Frame = 0;
+    Stats m_Stats;
+};
+
+} // namespace Engine
@@ -0,0 +1,190 @@
+#include "resources/cooking/AssetCooker.hpp"
+#include "resources/loaders/MeshFile.hpp"
+#include "core/MappedFile.hpp"
+#include "core/Logger.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace Engine {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+enum class AssetKind : u8 { None, Texture, Mesh };
+
+struct ManifestEntry {
+    u64 ContentHash = 0;
+    u64 OptionsHash = 0;
+};
+
+// 64-bit FNV-1a, continued from hash
+u64 HashBytes(const void* bytes, usize size, u64 hash = 14695981039346656037ull) {
+    const u8* data = static_cast<const u8*>(bytes);
+    for (usize i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+AssetKind GetAssetKind(const fs::path& path) {
+    String extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" ||
+        extension == ".tga" || extension == ".bmp") {
+        return AssetKind::Texture;
+    }
+    if (extension == ".obj") {
+        return AssetKind::Mesh;
+    }
+    return AssetKind::None;
+}
+
+u64 HashTextureOptions(const TextureCookOptions& options) {
+    const u8 flags[] = {static_cast<u8>(options.Format), options.FlipVertically, options.GenerateMips};
+    return HashBytes(flags, sizeof(flags));
+}
+
+// Zero when the file can't be read
+u64 HashFileContent(const String& filepath) {
+    MappedFile file(filepath);
+    if (!file.IsOpen()) return 0;
+    return HashBytes(file.Data(), file.Size());
+}
+
+// One "<content hash> <options hash> <relative path>" line per cooked source
+HashMap<String, ManifestEntry> ReadManifest(const String& filepath) {
+    HashMap<String, ManifestEntry> manifest;
+    std::ifstream file(filepath);
+    String line;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        ManifestEntry entry;
+        String path;
+        stream >> std::hex >> entry.ContentHash >> entry.OptionsHash;
+        stream >> std::ws;
+        std::getline(stream, path);
+        if (!stream.fail() && !path.empty()) {
+            manifest[path] = entry;
+        }
+    }
+    return manifest;
+}
+
+bool WriteManifest(const String& filepath, const HashMap<String, ManifestEntry>& manifest) {
+    // Sorted, so the manifest diffs cleanly when it is checked in
+    Vector<const std::pair<const String, ManifestEntry>*> entries;
+    entries.reserve(manifest.size());
+    for (const auto& entry : manifest) {
+        entries.push_back(&entry);
+    }
+    std::sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+
+    std::ofstream file(filepath, std::ios::trunc);
+    if (!file) return false;
+    for (const auto* entry : entries) {
+        char hashes[40];
+        std::snprintf(hashes, sizeof(hashes), "%016llx %016llx ",
+                      static_cast<unsigned long long>(entry->second.ContentHash),
+                      static_cast<unsigned long long>(entry->second.OptionsHash));
+        file << hashes << entry->first << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+bool CookMesh(const String& source, const String& destination, const MeshLoadOptions& options) {
+    Ref<Mesh> mesh = MeshLoader::LoadOBJ(source, options);
+    if (!mesh || !MeshFile::Write(*mesh, destination)) {
+        LOG_CORE_ERROR("AssetCooker: failed to cook mesh {}", source);
+        return false;
+    }
+    LOG_CORE_INFO("Cooked mesh {} to {}", source, destination);
+    return true;
+}
+
+} // anonymous namespace
+
+AssetCookStats AssetCooker::CookDirectory(const String& directory, const AssetCookOptions& options) {
+    const String manifestPath = (fs::path(directory) / ManifestName).string();
+    HashMap<String, ManifestEntry> manifest = options.Force ? HashMap<String, ManifestEntry>()
+                                                            : ReadManifest(manifestPath);
+    HashMap<String, ManifestEntry> nextManifest;
+
+    const u64 textureOptionsHash = HashTextureOptions(options.Textures);
+    const u64 meshOptionsHash = HashMeshOptions(options.Meshes);
+
+    AssetCookStats stats;
+    std::error_code error;
+    for (auto it = fs::recursive_directory_iterator(directory, error); !error && it != fs::recursive_directory_iterator();
+         it.increment(error)) {
+        if (!it->is_regular_file()) continue;
+
+        const AssetKind kind = GetAssetKind(it->path());
+        if (kind == AssetKind::None) continue;
+
+        const String source = it->path().string();
+        const String destination = kind == AssetKind::Texture ? TextureCooker::GetCookedPath(source)
+                                                              : GetCookedMeshPath(source, options.Meshes);
+        const String key = it->path().lexically_relative(directory).generic_string();
+
+        ManifestEntry entry;
+        entry.ContentHash = HashFileContent(source);
+        entry.OptionsHash = kind == AssetKind::Texture ? textureOptionsHash : meshOptionsHash;
+
+        auto previous = manifest.find(key);
+        if (previous != manifest.end() && previous->second.ContentHash == entry.ContentHash &&
+            previous->second.OptionsHash == entry.OptionsHash && fs::exists(destination)) {
+            // The loaders take a cooked file while it is at least as new as its source
+            std::error_code timeError;
+            if (fs::last_write_time(destination, timeError) < fs::last_write_time(it->path(), timeError)) {
+                fs::last_write_time(destination, fs::file_time_type::clock::now(), timeError);
+            }
+            nextManifest[key] = entry;
+            stats.UpToDate++;
+            continue;
+        }
+
+        const bool cooked = kind == AssetKind::Texture ? TextureCooker::Cook(source, destination, options.Textures)
+                                                       : CookMesh(source, destination, options.Meshes);
+        if (cooked) {
+            nextManifest[key] = entry;
+            stats.Cooked++;
+        } else {
+            stats.Failed++;
+        }
+    }
+
+    if (error) {
+        LOG_CORE_ERROR("AssetCooker: could not walk {}: {}", directory, error.message());
+    }
+
+    // Sources that disappeared drop out of the manifest with it
+    if (!WriteManifest(manifestPath, nextManifest)) {
+        LOG_CORE_ERROR("AssetCooker: could not write {}", manifestPath);
+    }
+    return stats;
+}
+
+String AssetCooker::GetCookedMeshPath(const String& source, const MeshLoadOptions& options) {
+    char suffix[24];
+    std::snprintf(suffix, sizeof(suffix), ".%016llx", static_cast<unsigned long long>(HashMeshOptions(options)));
+
+    fs::path path(source);
+    path.replace_extension(String(suffix) + MeshFile::Extension);
+    return path.string();
+}
+
+u64 AssetCooker::HashMeshOptions(const MeshLoadOptions& options) {
+    const u8 flags[] = {options.FlipUVs, options.GenerateNormals, options.GenerateTangents,
+                        options.CalculateBounds, static_cast<u8>(options.Format),
+                        options.Optimize, options.Meshlets};
+    return HashBytes(&options.LODCount, sizeof(options.LODCount), HashBytes(flags, sizeof(flags)));
+}
+
+} // namespace Engine
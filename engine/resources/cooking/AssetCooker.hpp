@@ -0,0 +1,44 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "resources/cooking/TextureCooker.hpp"
+#include "resources/loaders/MeshLoader.hpp"
+
+namespace Engine {
+
+struct AssetCookOptions {
+    TextureCookOptions Textures;
+    MeshLoadOptions Meshes;     // Cooked meshes are only picked up when loaded with the same options
+    bool Force = false;         // Cook everything, ignoring the manifest
+};
+
+struct AssetCookStats {
+    u32 Cooked = 0;
+    u32 UpToDate = 0;
+    u32 Failed = 0;
+};
+
+// AssetCooker - offline conversion of a whole asset tree: source images to
+// KTX2 (TextureCooker) and OBJ meshes to .pvmesh with vertex ordering, LODs
+// and meshlets baked in, each beside its source where the loaders look for
+// it first.
+//
+// What was cooked is recorded in a manifest at the root of the tree, keyed
+// by the source's relative path, with a hash of its content and one of the
+// cook options. A source is cooked again only when either hash changed or
+// its output is missing, so touching a file or checking the tree out again
+// doesn't rebuild it.
+class AssetCooker {
+public:
+    static constexpr const char* ManifestName = ".cookmanifest";
+
+    static AssetCookStats CookDirectory(const String& directory, const AssetCookOptions& options = {});
+
+    // Where the cooked version of a source mesh goes for these load options
+    static String GetCookedMeshPath(const String& source, const MeshLoadOptions& options);
+
+    // Hash of every load option that changes a cooked mesh
+    static u64 HashMeshOptions(const MeshLoadOptions& options);
+};
+
+} // namespace Engine
@@ -0,0 +1,394 @@
+#include "resources/cooking/TextureCooker.hpp"
+#include "core/Logger.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#define STB_DXT_IMPLEMENTATION
+#include <stb_dxt.h>
+
+namespace Engine {
+
+namespace {
+
+constexpr usize LevelAlignment = 16;
+
+// Khronos data format descriptor values used by the basic descriptor block
+constexpr u32 DFDModelRGBSDA = 1;
+constexpr u32 DFDModelBC1A = 128;
+constexpr u32 DFDModelBC3 = 130;
+constexpr u32 DFDModelBC4 = 131;
+constexpr u32 DFDModelBC5 = 132;
+constexpr u32 DFDModelBC7 = 134;
+constexpr u32 DFDPrimariesBT709 = 1;
+constexpr u32 DFDTransferLinear = 1;
+constexpr u32 DFDChannelAlpha = 15;
+
+u32 ToVkFormat(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::R8:    return 9;    // VK_FORMAT_R8_UNORM
+        case TextureFormat::RG8:   return 16;   // VK_FORMAT_R8G8_UNORM
+        case TextureFormat::RGBA8: return 37;   // VK_FORMAT_R8G8B8A8_UNORM
+        case TextureFormat::BC1:   return 133;  // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+        case TextureFormat::BC3:   return 137;  // VK_FORMAT_BC3_UNORM_BLOCK
+        case TextureFormat::BC4:   return 139;  // VK_FORMAT_BC4_UNORM_BLOCK
+        case TextureFormat::BC5:   return 141;  // VK_FORMAT_BC5_UNORM_BLOCK
+        case TextureFormat::BC7:   return 145;  // VK_FORMAT_BC7_UNORM_BLOCK
+        default:                   return 0;
+    }
+}
+
+// Basic data format descriptor: total size, block header, one sample per
+// channel. Colors are declared linear, as the renderer samples them.
+Vector<u32> BuildDataFormatDescriptor(TextureFormat format) {
+    struct Sample {
+        u32 BitOffset;
+        u32 BitLength;
+        u32 Channel;
+        u32 Upper;
+    };
+
+    u32 model = DFDModelRGBSDA;
+    u32 blockSize = 0;          // Texel block dimension - 1, per axis
+    u32 bytesPlane0 = 0;
+    Vector<Sample> samples;
+
+    switch (format) {
+        case TextureFormat::R8:
+            bytesPlane0 = 1;
+            samples = {{0, 8, 0, 255}};
+            break;
+        case TextureFormat::RG8:
+            bytesPlane0 = 2;
+            samples = {{0, 8, 0, 255}, {8, 8, 1, 255}};
+            break;
+        case TextureFormat::RGBA8:
+            bytesPlane0 = 4;
+            samples = {{0, 8, 0, 255}, {8, 8, 1, 255}, {16, 8, 2, 255}, {24, 8, DFDChannelAlpha, 255}};
+            break;
+        case TextureFormat::BC1:
+            model = DFDModelBC1A; blockSize = 3 | (3 << 8); bytesPlane0 = 8;
+            samples = {{0, 64, 0, ~0u}};
+            break;
+        case TextureFormat::BC3:
+            model = DFDModelBC3; blockSize = 3 | (3 << 8); bytesPlane0 = 16;
+            samples = {{0, 64, DFDChannelAlpha, ~0u}, {64, 64, 0, ~0u}};
+            break;
+        case TextureFormat::BC4:
+            model = DFDModelBC4; blockSize = 3 | (3 << 8); bytesPlane0 = 8;
+            samples = {{0, 64, 0, ~0u}};
+            break;
+        case TextureFormat::BC5:
+            model = DFDModelBC5; blockSize = 3 | (3 << 8); bytesPlane0 = 16;
+            samples = {{0, 64, 0, ~0u}, {64, 64, 1, ~0u}};
+            break;
+        case TextureFormat::BC7:
+            model = DFDModelBC7; blockSize = 3 | (3 << 8); bytesPlane0 = 16;
+            samples = {{0, 128, 0, ~0u}};
+            break;
+        default:
+            return {};
+    }
+
+    const u32 blockBytes = 24 + static_cast<u32>(samples.size()) * 16;
+    Vector<u32> words;
+    words.push_back(4 + blockBytes);                        // dfdTotalSize
+    words.push_back(0);                                     // Khronos vendor, basic descriptor type
+    words.push_back(2 | (blockBytes << 16));                // Version 2, block size
+    words.push_back(model | (DFDPrimariesBT709 << 8) | (DFDTransferLinear << 16));
+    words.push_back(blockSize);
+    words.push_back(bytesPlane0);
+    words.push_back(0);
+    for (const auto& sample : samples) {
+        words.push_back(sample.BitOffset | ((sample.BitLength - 1) << 16) | (sample.Channel << 24));
+        words.push_back(0);                                 // Sample position
+        words.push_back(0);                                 // Lower
+        words.push_back(sample.Upper);
+    }
+    return words;
+}
+
+// Source pixels expanded to RGBA8
+Vector<u8> ToRGBA(const TextureImage& image) {
+    const u32 channels = image.GetChannelCount();
+    const usize texels = static_cast<usize>(image.Width) * image.Height;
+    Vector<u8> rgba(texels * 4);
+    for (usize i = 0; i < texels; ++i) {
+        const u8* in = image.Pixels.data() + i * channels;
+        u8* out = rgba.data() + i * 4;
+        out[0] = in[0];
+        out[1] = channels > 1 ? in[1] : in[0];
+        out[2] = channels > 2 ? in[2] : (channels > 1 ? 0 : in[0]);
+        out[3] = channels > 3 ? in[3] : 255;
+    }
+    return rgba;
+}
+
+// 2x2 box filter; odd edges repeat their last texel
+Vector<u8> Downsample(const Vector<u8>& rgba, u32 width, u32 height, u32 outWidth, u32 outHeight) {
+    Vector<u8> out(static_cast<usize>(outWidth) * outHeight * 4);
+    for (u32 y = 0; y < outHeight; ++y) {
+        const u32 y0 = std::min(y * 2, height - 1);
+        const u32 y1 = std::min(y * 2 + 1, height - 1);
+        for (u32 x = 0; x < outWidth; ++x) {
+            const u32 x0 = std::min(x * 2, width - 1);
+            const u32 x1 = std::min(x * 2 + 1, width - 1);
+            for (u32 c = 0; c < 4; ++c) {
+                const u32 sum = rgba[(static_cast<usize>(y0) * width + x0) * 4 + c] +
+                                rgba[(static_cast<usize>(y0) * width + x1) * 4 + c] +
+                                rgba[(static_cast<usize>(y1) * width + x0) * 4 + c] +
+                                rgba[(static_cast<usize>(y1) * width + x1) * 4 + c];
+                out[(static_cast<usize>(y) * outWidth + x) * 4 + c] = static_cast<u8>((sum + 2) / 4);
+            }
+        }
+    }
+    return out;
+}
+
+// One level of RGBA8 texels in format, appended to out
+void EncodeLevel(const Vector<u8>& rgba, u32 width, u32 height, TextureFormat format, Vector<u8>& out) {
+    if (!IsCompressedFormat(format)) {
+        const u32 channels = format == TextureFormat::R8 ? 1 : format == TextureFormat::RG8 ? 2 : 4;
+        const usize texels = static_cast<usize>(width) * height;
+        for (usize i = 0; i < texels; ++i) {
+            out.insert(out.end(), rgba.begin() + i * 4, rgba.begin() + i * 4 + channels);
+        }
+        return;
+    }
+
+    u8 block[64];
+    u8 channel[32];
+    u8 encoded[16];
+    for (u32 by = 0; by < height; by += 4) {
+        for (u32 bx = 0; bx < width; bx += 4) {
+            // Edge blocks clamp to the last row / column
+            for (u32 y = 0; y < 4; ++y) {
+                for (u32 x = 0; x < 4; ++x) {
+                    const usize src = (static_cast<usize>(std::min(by + y, height - 1)) * width +
+                                       std::min(bx + x, width - 1)) * 4;
+                    std::memcpy(block + (y * 4 + x) * 4, rgba.data() + src, 4);
+                    channel[(y * 4 + x) * 2 + 0] = rgba[src + 0];
+                    channel[(y * 4 + x) * 2 + 1] = rgba[src + 1];
+                }
+            }
+
+            usize size = 16;
+            switch (format) {
+                case TextureFormat::BC1:
+                    stb_compress_dxt_block(encoded, block, 0, STB_DXT_HIGHQUAL);
+                    size = 8;
+                    break;
+                case TextureFormat::BC3:
+                    stb_compress_dxt_block(encoded, block, 1, STB_DXT_HIGHQUAL);
+                    break;
+                case TextureFormat::BC4: {
+                    u8 red[16];
+                    for (u32 i = 0; i < 16; ++i) red[i] = channel[i * 2];
+                    stb_compress_bc4_block(encoded, red);
+                    size = 8;
+                    break;
+                }
+                case TextureFormat::BC5:
+                    stb_compress_bc5_block(encoded, channel);
+                    break;
+                default:
+                    return;
+            }
+            out.insert(out.end(), encoded, encoded + size);
+        }
+    }
+}
+
+TextureFormat ChooseFormat(TextureCookFormat requested, const TextureImage& source, const Vector<u8>& rgba) {
+    switch (requested) {
+        case TextureCookFormat::BC1:   return TextureFormat::BC1;
+        case TextureCookFormat::BC3:   return TextureFormat::BC3;
+        case TextureCookFormat::BC4:   return TextureFormat::BC4;
+        case TextureCookFormat::BC5:   return TextureFormat::BC5;
+        case TextureCookFormat::RGBA8: return TextureFormat::RGBA8;
+        default: break;
+    }
+
+    switch (source.GetChannelCount()) {
+        case 1: return TextureFormat::BC4;
+        case 2: return TextureFormat::BC5;
+        case 3: return TextureFormat::BC1;
+        default: break;
+    }
+
+    for (usize i = 3; i < rgba.size(); i += 4) {
+        if (rgba[i] != 255) return TextureFormat::BC3;
+    }
+    return TextureFormat::BC1;
+}
+
+bool IsSourceImage(const std::filesystem::path& path) {
+    String extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".png" || extension == ".jpg" || extension == ".jpeg" ||
+           extension == ".tga" || extension == ".bmp";
+}
+
+} // anonymous namespace
+
+String TextureCooker::GetCookedPath(const String& source) {
+    return std::filesystem::path(source).replace_extension(".ktx2").string();
+}
+
+bool TextureCooker::Cook(const String& source, const String& destination, const TextureCookOptions& options) {
+    TextureImage image = TextureImage::Decode(source, options.FlipVertically);
+    if (!image.IsValid() || IsCompressedFormat(image.Format) || !image.Levels.empty()) {
+        LOG_CORE_ERROR("TextureCooker: {} is not a source image", source);
+        return false;
+    }
+
+    Vector<u8> rgba = ToRGBA(image);
+
+    TextureImage cooked;
+    cooked.Width = image.Width;
+    cooked.Height = image.Height;
+    cooked.Format = ChooseFormat(options.Format, image, rgba);
+
+    u32 width = image.Width;
+    u32 height = image.Height;
+    while (true) {
+        TextureMipLevel level;
+        level.Width = width;
+        level.Height = height;
+        level.Offset = cooked.Pixels.size();
+        EncodeLevel(rgba, width, height, cooked.Format, cooked.Pixels);
+        level.Size = cooked.Pixels.size() - level.Offset;
+        cooked.Levels.push_back(level);
+
+        if (!options.GenerateMips || (width == 1 && height == 1)) break;
+
+        const u32 nextWidth = std::max(1u, width / 2);
+        const u32 nextHeight = std::max(1u, height / 2);
+        rgba = Downsample(rgba, width, height, nextWidth, nextHeight);
+        width = nextWidth;
+        height = nextHeight;
+    }
+
+    if (!WriteKTX2(cooked, destination)) {
+        return false;
+    }
+
+    LOG_CORE_INFO("TextureCooker: {} -> {} ({}x{}, {} levels, {:.1f} KB)", source, destination,
+                  cooked.Width, cooked.Height, cooked.Levels.size(), cooked.Pixels.size() / 1024.0);
+    return true;
+}
+
+u32 TextureCooker::CookDirectory(const String& directory, const TextureCookOptions& options) {
+    namespace fs = std::filesystem;
+
+    std::error_code error;
+    u32 cooked = 0;
+    for (auto it = fs::recursive_directory_iterator(directory, error); !error && it != fs::recursive_directory_iterator();
+         it.increment(error)) {
+        if (!it->is_regular_file() || !IsSourceImage(it->path())) continue;
+
+        const String source = it->path().string();
+        const String destination = GetCookedPath(source);
+
+        std::error_code timeError;
+        auto cookedTime = fs::last_write_time(destination, timeError);
+        if (!timeError && cookedTime >= fs::last_write_time(it->path(), timeError) && !timeError) {
+            continue;
+        }
+
+        if (Cook(source, destination, options)) {
+            ++cooked;
+        }
+    }
+
+    if (error) {
+        LOG_CORE_ERROR("TextureCooker: could not walk {}: {}", directory, error.message());
+    }
+    return cooked;
+}
+
+bool TextureCooker::WriteKTX2(const TextureImage& image, const String& filepath) {
+    static const u8 identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+    const u32 vkFormat = ToVkFormat(image.Format);
+    const Vector<u32> dfd = BuildDataFormatDescriptor(image.Format);
+    if (vkFormat == 0 || dfd.empty() || !image.IsValid()) {
+        LOG_CORE_ERROR("TextureCooker: cannot write {} in this format", filepath);
+        return false;
+    }
+
+    Vector<TextureMipLevel> levels = image.Levels;
+    if (levels.empty()) {
+        levels.push_back({image.Width, image.Height, 0, image.Pixels.size()});
+    }
+
+    const u32 levelCount = static_cast<u32>(levels.size());
+    const usize dfdOffset = 80 + static_cast<usize>(levelCount) * 24;
+    const usize dfdSize = dfd.size() * sizeof(u32);
+
+    // Level data goes smallest level first, as the container specifies
+    Vector<u64> fileOffsets(levelCount);
+    usize offset = dfdOffset + dfdSize;
+    for (u32 i = levelCount; i-- > 0;) {
+        offset = (offset + LevelAlignment - 1) & ~(LevelAlignment - 1);
+        fileOffsets[i] = offset;
+        offset += levels[i].Size;
+    }
+
+    Vector<u8> file(offset, 0);
+    auto put32 = [&](usize at, u32 value) { std::memcpy(file.data() + at, &value, sizeof(value)); };
+    auto put64 = [&](usize at, u64 value) { std::memcpy(file.data() + at, &value, sizeof(value)); };
+
+    std::memcpy(file.data(), identifier, sizeof(identifier));
+    put32(12, vkFormat);
+    put32(16, 1);                           // typeSize
+    put32(20, image.Width);
+    put32(24, image.Height);
+    put32(28, 0);                           // pixelDepth
+    put32(32, 0);                           // layerCount
+    put32(36, 1);                           // faceCount
+    put32(40, levelCount);
+    put32(44, 0);                           // supercompressionScheme
+    put32(48, static_cast<u32>(dfdOffset));
+    put32(52, static_cast<u32>(dfdSize));
+    put32(56, 0);                           // No key / value data
+    put32(60, 0);
+    put64(64, 0);                           // No supercompression global data
+    put64(72, 0);
+
+    for (u32 i = 0; i < levelCount; ++i) {
+        put64(80 + i * 24 + 0, fileOffsets[i]);
+        put64(80 + i * 24 + 8, levels[i].Size);
+        put64(80 + i * 24 + 16, levels[i].Size);
+        std::memcpy(file.data() + fileOffsets[i], image.Pixels.data() + levels[i].Offset, levels[i].Size);
+    }
+    std::memcpy(file.data() + dfdOffset, dfd.data(), dfdSize);
+
+    std::error_code error;
+    std::filesystem::path path(filepath);
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+        if (!out) {
+            LOG_CORE_ERROR("TextureCooker: could not write {}", filepath);
+            out.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace Engine
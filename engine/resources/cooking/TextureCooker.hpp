@@ -0,0 +1,44 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "renderer/Texture.hpp"
+
+namespace Engine {
+
+enum class TextureCookFormat : u8 {
+    Auto,       // By channel count: BC4, BC5, BC1, or BC3 when alpha is used
+    BC1,
+    BC3,
+    BC4,
+    BC5,
+    RGBA8       // Uncompressed, with the mip chain precomputed
+};
+
+struct TextureCookOptions {
+    TextureCookFormat Format = TextureCookFormat::Auto;
+    bool FlipVertically = true;     // As TextureLoader flips source images
+    bool GenerateMips = true;
+};
+
+// TextureCooker - offline conversion of source images to KTX2.
+//
+// The source is decoded with stb_image, its mip chain built with a box
+// filter and every level block-compressed with stb_dxt, so loading the
+// result is a plain copy into compressed storage. TextureLoader picks a
+// cooked .ktx2 next to a source image up automatically.
+class TextureCooker {
+public:
+    static bool Cook(const String& source, const String& destination, const TextureCookOptions& options = {});
+
+    // Cook every PNG / JPG / TGA / BMP under directory to a .ktx2 beside it,
+    // skipping those whose .ktx2 is newer. Returns the number cooked.
+    static u32 CookDirectory(const String& directory, const TextureCookOptions& options = {});
+
+    // Write an image (any format TextureImage holds, levels included) as KTX2
+    static bool WriteKTX2(const TextureImage& image, const String& filepath);
+
+    // Where the cooked version of a source image goes
+    static String GetCookedPath(const String& source);
+};
+
+} // namespace Engine
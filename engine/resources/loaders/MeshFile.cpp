@@ -0,0 +1,329 @@
+#include "resources/loaders/MeshFile.hpp"
+#include "core/Logger.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Engine {
+
+namespace {
+
+constexpr u32 MeshFileMagic = 0x534D5650;   // 'PVMS'
+constexpr u32 MeshFileVersion = 3;      // 2: LOD table, 3: meshlets
+constexpr usize MeshFileAlignment = 16;
+
+constexpr u32 MeshFileFlagPositions = 1u << 0;
+
+struct MeshFileHeader {
+    u32 Magic = MeshFileMagic;
+    u32 Version = MeshFileVersion;
+    u32 Format = 0;             // VertexFormat
+    u32 Flags = 0;
+    u32 VertexCount = 0;
+    u32 IndexCount = 0;
+    u32 SubMeshCount = 0;
+    u32 LODCount = 0;           // 0 for LOD 0 alone
+    u64 VertexOffset = 0;
+    u64 PositionOffset = 0;
+    u64 IndexOffset = 0;
+    u64 SubMeshOffset = 0;
+    u64 LODOffset = 0;
+    f32 BoundsMin[3] = {};
+    f32 BoundsMax[3] = {};
+    f32 SphereCenter[3] = {};
+    f32 SphereRadius = 0.0f;
+    f32 PositionDequant[4] = {};
+    u32 MeshletCount = 0;
+    u32 Reserved = 0;
+    u64 MeshletOffset = 0;
+};
+static_assert(sizeof(MeshFileHeader) == 144, "MeshFileHeader is part of the file format");
+
+struct MeshFileSubMesh {
+    u32 BaseVertex = 0;
+    u32 BaseIndex = 0;
+    u32 IndexCount = 0;
+    u32 MaterialIndex = 0;
+    char Name[48] = {};
+};
+static_assert(sizeof(MeshFileSubMesh) == 64, "MeshFileSubMesh is part of the file format");
+
+struct MeshFileLOD {
+    u32 IndexOffset = 0;
+    u32 IndexCount = 0;
+    f32 Error = 0.0f;
+    u32 Reserved = 0;
+};
+static_assert(sizeof(MeshFileLOD) == 16, "MeshFileLOD is part of the file format");
+
+// Meshlets are stored as Engine::Meshlet, whose layout is already fixed
+static_assert(sizeof(Meshlet) == 64, "Meshlet is part of the file format");
+
+usize AlignUp(usize value) {
+    return (value + MeshFileAlignment - 1) & ~(MeshFileAlignment - 1);
+}
+
+// [offset, offset + size) lies inside the file
+bool InFile(u64 offset, u64 size, usize fileSize) {
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+} // anonymous namespace
+
+bool MeshFile::IsMeshFile(const String& filepath) {
+    return std::filesystem::path(filepath).extension() == Extension;
+}
+
+bool MeshFile::Write(Mesh& mesh, const String& filepath) {
+    Vector<PackedVertex> packed;
+    Vector<u8> positions;
+    const MeshGPUData data = mesh.GetGPUData(packed, positions);
+    if (!data.Vertices || data.VertexCount == 0) {
+        LOG_CORE_WARN("MeshFile: '{}' has no vertices to cook", mesh.GetName());
+        return false;
+    }
+
+    const u32 stride = Mesh::GetLayout(data.Format).GetStride();
+    const u32 positionStride = Mesh::GetPositionLayout(data.Format).GetStride();
+    const usize vertexBytes = static_cast<usize>(data.VertexCount) * stride;
+    const usize positionBytes = data.Positions ? static_cast<usize>(data.VertexCount) * positionStride : 0;
+    const usize indexBytes = static_cast<usize>(data.IndexCount) * sizeof(u32);
+    const auto& subMeshes = mesh.GetSubMeshes();
+    const usize subMeshBytes = subMeshes.size() * sizeof(MeshFileSubMesh);
+
+    MeshFileHeader header;
+    header.Format = static_cast<u32>(data.Format);
+    header.Flags = data.Positions ? MeshFileFlagPositions : 0;
+    header.VertexCount = data.VertexCount;
+    header.IndexCount = data.IndexCount;
+    header.SubMeshCount = static_cast<u32>(subMeshes.size());
+    header.LODCount = data.LODCount;
+    header.VertexOffset = AlignUp(sizeof(MeshFileHeader));
+    header.PositionOffset = AlignUp(header.VertexOffset + vertexBytes);
+    header.IndexOffset = AlignUp(header.PositionOffset + positionBytes);
+    header.SubMeshOffset = AlignUp(header.IndexOffset + indexBytes);
+    header.LODOffset = AlignUp(header.SubMeshOffset + subMeshBytes);
+    const auto& meshlets = mesh.GetMeshlets();
+    header.MeshletCount = static_cast<u32>(meshlets.size());
+    header.MeshletOffset = AlignUp(header.LODOffset + data.LODCount * sizeof(MeshFileLOD));
+
+    const AABB& bounds = mesh.GetBounds();
+    const BoundingSphere& sphere = mesh.GetBoundingSphere();
+    std::memcpy(header.BoundsMin, &bounds.Min, sizeof(header.BoundsMin));
+    std::memcpy(header.BoundsMax, &bounds.Max, sizeof(header.BoundsMax));
+    std::memcpy(header.SphereCenter, &sphere.Center, sizeof(header.SphereCenter));
+    header.SphereRadius = sphere.Radius;
+    std::memcpy(header.PositionDequant, &data.PositionDequant, sizeof(header.PositionDequant));
+
+    std::error_code error;
+    std::filesystem::path path(filepath);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+
+    // Write a temporary and rename it, so an interrupted cook can't leave a
+    // truncated file behind
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_CORE_WARN("MeshFile: could not write {}", filepath);
+            return false;
+        }
+
+        static const char padding[MeshFileAlignment] = {};
+        auto writeAt = [&](u64 offset, const void* bytes, usize size) {
+            const u64 position = static_cast<u64>(out.tellp());
+            out.write(padding, static_cast<std::streamsize>(offset - position));
+            out.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+        };
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeAt(header.VertexOffset, data.Vertices, vertexBytes);
+        writeAt(header.PositionOffset, data.Positions, positionBytes);
+        writeAt(header.IndexOffset, data.Indices, indexBytes);
+        writeAt(header.SubMeshOffset, nullptr, 0);
+
+        for (const auto& subMesh : subMeshes) {
+            MeshFileSubMesh entry;
+            entry.BaseVertex = subMesh.BaseVertex;
+            entry.BaseIndex = subMesh.BaseIndex;
+            entry.IndexCount = subMesh.IndexCount;
+            entry.MaterialIndex = subMesh.MaterialIndex;
+            std::strncpy(entry.Name, subMesh.Name.c_str(), sizeof(entry.Name) - 1);
+            out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        }
+
+        writeAt(header.LODOffset, nullptr, 0);
+        for (u32 i = 0; i < data.LODCount; ++i) {
+            MeshFileLOD entry;
+            entry.IndexOffset = data.LODs[i].IndexOffset;
+            entry.IndexCount = data.LODs[i].IndexCount;
+            entry.Error = data.LODs[i].Error;
+            out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        }
+
+        writeAt(header.MeshletOffset, meshlets.data(), meshlets.size() * sizeof(Meshlet));
+
+        if (!out) {
+            LOG_CORE_WARN("MeshFile: could not write {}", filepath);
+            out.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool MeshFile::Open(const String& filepath) {
+    Close();
+    if (!m_File.Open(filepath)) {
+        return false;
+    }
+    return Parse(m_File.Data(), m_File.Size(), filepath);
+}
+
+bool MeshFile::Open(const AssetData& data, const String& filepath) {
+    Close();
+    if (!data) {
+        return false;
+    }
+    m_Archived = data;
+    return Parse(data.Data, data.Size, filepath);
+}
+
+void MeshFile::Close() {
+    m_File.Close();
+    m_Archived = AssetData();
+    m_Bytes = nullptr;
+    m_Data = MeshGPUData();
+    m_SubMeshes.clear();
+    m_LODs.clear();
+    m_Meshlets.clear();
+}
+
+bool MeshFile::Parse(const u8* bytes, usize size, const String& filepath) {
+    m_FilePath = filepath;
+    auto fail = [&](const char* reason) {
+        LOG_CORE_ERROR("MeshFile: {} is not a valid mesh file ({})", filepath, reason);
+        Close();
+        return false;
+    };
+
+    if (size < sizeof(MeshFileHeader)) return fail("truncated header");
+
+    MeshFileHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    if (header.Magic != MeshFileMagic) return fail("bad magic");
+    if (header.Version != MeshFileVersion) return fail("unsupported version");
+    if (header.Format > static_cast<u32>(VertexFormat::Packed)) return fail("unknown vertex format");
+
+    const VertexFormat format = static_cast<VertexFormat>(header.Format);
+    const bool hasPositions = (header.Flags & MeshFileFlagPositions) != 0;
+    const u64 vertexBytes = static_cast<u64>(header.VertexCount) * Mesh::GetLayout(format).GetStride();
+    const u64 positionBytes = hasPositions ?
+        static_cast<u64>(header.VertexCount) * Mesh::GetPositionLayout(format).GetStride() : 0;
+    const u64 indexBytes = static_cast<u64>(header.IndexCount) * sizeof(u32);
+    const u64 subMeshBytes = static_cast<u64>(header.SubMeshCount) * sizeof(MeshFileSubMesh);
+    const u64 lodBytes = static_cast<u64>(header.LODCount) * sizeof(MeshFileLOD);
+    const u64 meshletBytes = static_cast<u64>(header.MeshletCount) * sizeof(Meshlet);
+
+    if (header.VertexCount == 0) return fail("no vertices");
+    if (!InFile(header.VertexOffset, vertexBytes, size) ||
+        !InFile(header.PositionOffset, positionBytes, size) ||
+        !InFile(header.IndexOffset, indexBytes, size) ||
+        !InFile(header.SubMeshOffset, subMeshBytes, size) ||
+        !InFile(header.LODOffset, lodBytes, size) ||
+        !InFile(header.MeshletOffset, meshletBytes, size)) {
+        return fail("blob outside the file");
+    }
+    if (header.VertexOffset % MeshFileAlignment || header.PositionOffset % MeshFileAlignment ||
+        header.IndexOffset % MeshFileAlignment || header.SubMeshOffset % MeshFileAlignment ||
+        header.LODOffset % MeshFileAlignment || header.MeshletOffset % MeshFileAlignment) {
+        return fail("misaligned blob");
+    }
+
+    const u8* base = bytes;
+    m_Data.Format = format;
+    m_Data.Vertices = base + header.VertexOffset;
+    m_Data.Positions = hasPositions ? base + header.PositionOffset : nullptr;
+    m_Data.VertexCount = header.VertexCount;
+    m_Data.Indices = header.IndexCount ? reinterpret_cast<const u32*>(base + header.IndexOffset) : nullptr;
+    m_Data.IndexCount = header.IndexCount;
+    std::memcpy(&m_Data.PositionDequant, header.PositionDequant, sizeof(header.PositionDequant));
+
+    glm::vec3 boundsMin, boundsMax, sphereCenter;
+    std::memcpy(&boundsMin, header.BoundsMin, sizeof(boundsMin));
+    std::memcpy(&boundsMax, header.BoundsMax, sizeof(boundsMax));
+    std::memcpy(&sphereCenter, header.SphereCenter, sizeof(sphereCenter));
+    m_Bounds = AABB(boundsMin, boundsMax);
+    m_BoundingSphere = BoundingSphere(sphereCenter, header.SphereRadius);
+
+    m_SubMeshes.reserve(header.SubMeshCount);
+    for (u32 i = 0; i < header.SubMeshCount; ++i) {
+        MeshFileSubMesh entry;
+        std::memcpy(&entry, base + header.SubMeshOffset + i * sizeof(MeshFileSubMesh), sizeof(entry));
+        entry.Name[sizeof(entry.Name) - 1] = '\0';
+
+        SubMesh subMesh;
+        subMesh.BaseVertex = entry.BaseVertex;
+        subMesh.BaseIndex = entry.BaseIndex;
+        subMesh.IndexCount = entry.IndexCount;
+        subMesh.MaterialIndex = entry.MaterialIndex;
+        subMesh.Name = entry.Name;
+        m_SubMeshes.push_back(std::move(subMesh));
+    }
+
+    m_LODs.reserve(header.LODCount);
+    for (u32 i = 0; i < header.LODCount; ++i) {
+        MeshFileLOD entry;
+        std::memcpy(&entry, base + header.LODOffset + i * sizeof(MeshFileLOD), sizeof(entry));
+        if (entry.IndexOffset > header.IndexCount || entry.IndexCount > header.IndexCount - entry.IndexOffset) {
+            return fail("LOD outside the index buffer");
+        }
+        m_LODs.push_back({entry.IndexOffset, entry.IndexCount, entry.Error});
+    }
+    m_Data.LODs = m_LODs.empty() ? nullptr : m_LODs.data();
+    m_Data.LODCount = static_cast<u32>(m_LODs.size());
+
+    // Meshlets index LOD 0
+    const u32 lod0Count = m_LODs.empty() ? header.IndexCount : m_LODs[0].IndexCount;
+    m_Meshlets.resize(header.MeshletCount);
+    if (header.MeshletCount > 0) {
+        std::memcpy(m_Meshlets.data(), base + header.MeshletOffset, meshletBytes);
+    }
+    for (const Meshlet& meshlet : m_Meshlets) {
+        if (meshlet.IndexOffset > lod0Count || meshlet.TriangleCount > (lod0Count - meshlet.IndexOffset) / 3) {
+            return fail("meshlet outside LOD 0");
+        }
+    }
+
+    m_Bytes = bytes;
+    return true;
+}
+
+Ref<Mesh> MeshFile::CreateMesh(const Ref<GeometryPool>& pool, MeshResidency residency) const {
+    if (!IsOpen()) return nullptr;
+
+    auto mesh = CreateRef<Mesh>();
+    mesh->SetResidency(residency);
+    mesh->SetFilePath(m_FilePath);
+    mesh->SetName(std::filesystem::path(m_FilePath).stem().string());
+    mesh->SetBounds(m_Bounds, m_BoundingSphere);
+    for (const auto& subMesh : m_SubMeshes) {
+        mesh->AddSubMesh(subMesh);
+    }
+    mesh->SetMeshlets(m_Meshlets);
+
+    mesh->Upload(m_Data, pool);
+    return mesh->IsUploaded() ? mesh : nullptr;
+}
+
+} // namespace Engine
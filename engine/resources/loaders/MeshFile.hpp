@@ -0,0 +1,62 @@
+#pragma once
+
+#include "core/Types.hpp"
+#include "core/MappedFile.hpp"
+#include "resources/AssetArchive.hpp"
+#include "renderer/Mesh.hpp"
+
+namespace Engine {
+
+// Cooked mesh file (.pvmesh): the vertex, depth-stream and index blobs in
+// the layout Mesh uploads, followed by submeshes, LODs and meshlets, with
+// bounds and position dequantization in the header. Open() maps the file and
+// validates it on any thread; CreateMesh() hands the mapped blobs straight
+// to buffer storage on the GL thread, with no parsing or intermediate copy.
+//
+// Layout, little-endian, blobs 16-byte aligned:
+//   MeshFileHeader | vertices | positions | u32 indices (every LOD) |
+//   MeshFileSubMesh[] | MeshFileLOD[] | Meshlet[]
+class MeshFile {
+public:
+    static constexpr const char* Extension = ".pvmesh";
+
+    // Cook mesh (with CPU data, e.g. just loaded from OBJ) to filepath
+    static bool Write(Mesh& mesh, const String& filepath);
+
+    static bool IsMeshFile(const String& filepath);
+
+    bool Open(const String& filepath);
+    bool IsOpen() const { return m_Bytes != nullptr; }
+
+    // Use a mesh file read from an AssetArchive, in place; filepath names it
+    bool Open(const AssetData& data, const String& filepath);
+
+    // Upload the mapped blobs, into the pool when one is given.
+    // MeshResidency::Collision quantizes its collision data from them.
+    Ref<Mesh> CreateMesh(const Ref<GeometryPool>& pool = nullptr,
+                         MeshResidency residency = Mesh::GetDefaultResidency()) const;
+
+    const MeshGPUData& GetData() const { return m_Data; }
+    const Vector<SubMesh>& GetSubMeshes() const { return m_SubMeshes; }
+    const Vector<Meshlet>& GetMeshlets() const { return m_Meshlets; }
+    const AABB& GetBounds() const { return m_Bounds; }
+    const BoundingSphere& GetBoundingSphere() const { return m_BoundingSphere; }
+    const String& GetFilePath() const { return m_FilePath; }
+
+private:
+    bool Parse(const u8* bytes, usize size, const String& filepath);
+    void Close();
+
+    MappedFile m_File;
+    AssetData m_Archived;       // Keeps archived bytes alive instead of m_File
+    const u8* m_Bytes = nullptr;
+    MeshGPUData m_Data;
+    Vector<SubMesh> m_SubMeshes;
+    Vector<MeshLOD> m_LODs;     // m_Data.LODs points here
+    Vector<Meshlet> m_Meshlets;
+    AABB m_Bounds;
+    BoundingSphere m_BoundingSphere;
+    String m_FilePath;
+};
+
+} // namespace Engine
@@ -1,15 +1,27 @@
 #include "resources/loaders/MeshLoader.hpp"
+#include "core/JobSystem.hpp"
 #include "core/Logger.hpp"
-#include <fstream>
-#include <sstream>
-#include <unordered_map>
+#include "core/MappedFile.hpp"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <chrono>
 #include <cmath>
+#include <limits>
 #include <glm/gtc/constants.hpp>
 
 namespace Engine {
 
 namespace {
 
+// Files at least this large are split into per-worker chunks
+constexpr usize ParallelParseChunkBytes = 4u << 20;
+
+// A negative index resolved against a chunk's own counts. MergeOBJ adds the
+// counts of the chunks before it; anything else below -1 is out of range.
+constexpr i32 RelativeIndexBias = std::numeric_limits<i32>::min() / 2;
+
 struct VertexKey {
     i32 p, t, n;
     bool operator==(const VertexKey& other) const {
@@ -17,143 +29,321 @@ struct VertexKey {
     }
 };
 
-struct VertexKeyHash {
-    size_t operator()(const VertexKey& k) const {
-        return std::hash<i32>()(k.p) ^ (std::hash<i32>()(k.t) << 1) ^ (std::hash<i32>()(k.n) << 2);
+// Maps OBJ corners (position / uv / normal triples) to output vertices.
+// Linear probing over a power-of-two table sized for every corner being
+// unique, so it never rehashes; slots index into the key array.
+class VertexDeduplicator {
+public:
+    explicit VertexDeduplicator(usize maxVertices) {
+        const usize capacity = std::bit_ceil(std::max<usize>(16, maxVertices + maxVertices / 2));
+        m_Mask = capacity - 1;
+        m_Slots.assign(capacity, Empty);
+        m_Keys.reserve(maxVertices);
     }
-};
 
-Vector<String> Split(const String& str, char delimiter) {
-    Vector<String> tokens;
-    std::istringstream stream(str);
-    String token;
-    while (std::getline(stream, token, delimiter)) {
-        if (!token.empty()) {
-            tokens.push_back(token);
+    // Vertex index of key; inserted is set when it is a new vertex
+    u32 FindOrInsert(const VertexKey& key, bool& inserted) {
+        for (usize slot = Hash(key) & m_Mask;; slot = (slot + 1) & m_Mask) {
+            const u32 vertex = m_Slots[slot];
+            if (vertex == Empty) {
+                const u32 index = static_cast<u32>(m_Keys.size());
+                m_Slots[slot] = index;
+                m_Keys.push_back(key);
+                inserted = true;
+                return index;
+            }
+            if (m_Keys[vertex] == key) {
+                inserted = false;
+                return vertex;
+            }
         }
     }
-    return tokens;
+
+private:
+    static constexpr u32 Empty = ~0u;
+
+    static usize Hash(const VertexKey& key) {
+        u32 h = static_cast<u32>(key.p) * 0x9E3779B1u;
+        h ^= static_cast<u32>(key.t) * 0x85EBCA77u;
+        h ^= static_cast<u32>(key.n) * 0xC2B2AE3Du;
+        h ^= h >> 15;
+        h *= 0x2C1B3C6Du;
+        h ^= h >> 12;
+        return h;
+    }
+
+    Vector<u32> m_Slots;
+    Vector<VertexKey> m_Keys;
+    usize m_Mask = 0;
+};
+
+bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
 }
 
-String Trim(const String& str) {
-    size_t start = str.find_first_not_of(" \t\r\n");
-    if (start == String::npos) return "";
-    size_t end = str.find_last_not_of(" \t\r\n");
-    return str.substr(start, end - start + 1);
+const char* SkipBlanks(const char* p, const char* end) {
+    while (p < end && IsBlank(*p)) ++p;
+    return p;
 }
 
-} // namespace
+const char* NextLine(const char* p, const char* end) {
+    const void* newline = std::memchr(p, '\n', static_cast<usize>(end - p));
+    return newline ? static_cast<const char*>(newline) + 1 : end;
+}
 
-bool MeshLoader::ParseOBJ(const String& filepath, OBJData& data) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        LOG_CORE_ERROR("Failed to open OBJ file: {}", filepath);
-        return false;
+// Keyword at p followed by a blank
+bool MatchKeyword(const char* p, const char* end, const char* keyword, usize length) {
+    return static_cast<usize>(end - p) > length &&
+           std::memcmp(p, keyword, length) == 0 &&
+           IsBlank(p[length]);
+}
+
+const char* ParseFloat(const char* p, const char* end, f32& value) {
+    p = SkipBlanks(p, end);
+    if (p < end && *p == '+') ++p;
+
+    auto [next, error] = std::from_chars(p, end, value);
+    if (error != std::errc()) {
+        value = 0.0f;
     }
+    return next;
+}
 
-    String line;
-    while (std::getline(file, line)) {
-        line = Trim(line);
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
+// OBJ indices are one-based; negative ones count back from the last element
+// read so far (count of them in this chunk)
+const char* ParseIndex(const char* p, const char* end, usize count, i32& index) {
+    i32 value = 0;
+    auto [next, error] = std::from_chars(p, end, value);
+    if (error != std::errc() || value == 0) {
+        index = -1;
+    } else if (value > 0) {
+        index = value - 1;
+    } else {
+        index = RelativeIndexBias + static_cast<i32>(count) + value;
+    }
+    return next;
+}
+
+// Rest of the line with surrounding blanks removed
+String ParseName(const char* p, const char* end) {
+    p = SkipBlanks(p, end);
+    const char* last = p;
+    while (last < end && *last != '\n') ++last;
+    while (last > p && IsBlank(last[-1])) --last;
+    return String(p, last);
+}
+
+i32 ResolveIndex(i32 index, u32 base) {
+    if (index >= -1) return index;
+    const i32 resolved = static_cast<i32>(base) + (index - RelativeIndexBias);
+    return resolved >= 0 ? resolved : -1;
+}
 
-        std::istringstream iss(line);
-        String prefix;
-        iss >> prefix;
+} // namespace
+
+void MeshLoader::ParseOBJRange(const char* begin, const char* end, OBJData& data) {
+    for (const char* p = begin; p < end; p = NextLine(p, end)) {
+        p = SkipBlanks(p, end);
+        if (p >= end) break;
 
-        if (prefix == "v") {
+        if (MatchKeyword(p, end, "v", 1)) {
             glm::vec3 pos;
-            iss >> pos.x >> pos.y >> pos.z;
+            const char* q = ParseFloat(p + 1, end, pos.x);
+            q = ParseFloat(q, end, pos.y);
+            ParseFloat(q, end, pos.z);
             data.Positions.push_back(pos);
         }
-        else if (prefix == "vn") {
+        else if (MatchKeyword(p, end, "vn", 2)) {
             glm::vec3 normal;
-            iss >> normal.x >> normal.y >> normal.z;
+            const char* q = ParseFloat(p + 2, end, normal.x);
+            q = ParseFloat(q, end, normal.y);
+            ParseFloat(q, end, normal.z);
             data.Normals.push_back(normal);
         }
-        else if (prefix == "vt") {
+        else if (MatchKeyword(p, end, "vt", 2)) {
             glm::vec2 uv;
-            iss >> uv.x >> uv.y;
+            const char* q = ParseFloat(p + 2, end, uv.x);
+            ParseFloat(q, end, uv.y);
             data.TexCoords.push_back(uv);
         }
-        else if (prefix == "f") {
-            OBJData::Face face;
-            String vertexStr;
-            while (iss >> vertexStr) {
-                OBJData::Face::Index idx;
-                auto parts = Split(vertexStr, '/');
-
-                if (parts.size() >= 1 && !parts[0].empty()) {
-                    idx.Position = std::stoi(parts[0]) - 1;
-                }
-                if (parts.size() >= 2 && !parts[1].empty()) {
-                    idx.TexCoord = std::stoi(parts[1]) - 1;
-                }
-                if (parts.size() >= 3 && !parts[2].empty()) {
-                    idx.Normal = std::stoi(parts[2]) - 1;
+        else if (MatchKeyword(p, end, "f", 1)) {
+            const usize firstCorner = data.FaceIndices.size();
+            const char* q = p + 1;
+
+            // v, v/vt, v//vn or v/vt/vn per corner
+            while (true) {
+                q = SkipBlanks(q, end);
+                if (q >= end || *q == '\n' || *q == '#') break;
+
+                OBJData::Index idx;
+                q = ParseIndex(q, end, data.Positions.size(), idx.Position);
+                if (q < end && *q == '/') {
+                    ++q;
+                    if (q < end && *q != '/') {
+                        q = ParseIndex(q, end, data.TexCoords.size(), idx.TexCoord);
+                    }
+                    if (q < end && *q == '/') {
+                        ++q;
+                        q = ParseIndex(q, end, data.Normals.size(), idx.Normal);
+                    }
                 }
 
-                face.Indices.push_back(idx);
+                // Skip whatever is left of a malformed corner
+                while (q < end && !IsBlank(*q) && *q != '\n') ++q;
+
+                data.FaceIndices.push_back(idx);
             }
-            if (face.Indices.size() >= 3) {
-                data.Faces.push_back(face);
+
+            if (data.FaceIndices.size() - firstCorner >= 3) {
+                data.FaceStarts.push_back(static_cast<u32>(data.FaceIndices.size()));
+            } else {
+                data.FaceIndices.resize(firstCorner);
             }
         }
-        else if (prefix == "mtllib") {
-            iss >> data.MaterialLib;
+        else if (MatchKeyword(p, end, "mtllib", 6)) {
+            data.MaterialLib = ParseName(p + 6, end);
         }
-        else if (prefix == "usemtl") {
-            iss >> data.CurrentMaterial;
+        else if (MatchKeyword(p, end, "usemtl", 6)) {
+            data.CurrentMaterial = ParseName(p + 6, end);
         }
     }
+}
+
+void MeshLoader::MergeOBJ(Vector<OBJData>& chunks, OBJData& data) {
+    usize positions = 0, normals = 0, texCoords = 0, corners = 0, faces = 0;
+    for (const auto& chunk : chunks) {
+        positions += chunk.Positions.size();
+        normals += chunk.Normals.size();
+        texCoords += chunk.TexCoords.size();
+        corners += chunk.FaceIndices.size();
+        faces += chunk.GetFaceCount();
+    }
+
+    data.Positions.reserve(positions);
+    data.Normals.reserve(normals);
+    data.TexCoords.reserve(texCoords);
+    data.FaceIndices.reserve(corners);
+    data.FaceStarts.reserve(faces + 1);
+
+    for (auto& chunk : chunks) {
+        const u32 positionBase = static_cast<u32>(data.Positions.size());
+        const u32 texCoordBase = static_cast<u32>(data.TexCoords.size());
+        const u32 normalBase = static_cast<u32>(data.Normals.size());
+        const u32 cornerBase = static_cast<u32>(data.FaceIndices.size());
+
+        data.Positions.insert(data.Positions.end(), chunk.Positions.begin(), chunk.Positions.end());
+        data.Normals.insert(data.Normals.end(), chunk.Normals.begin(), chunk.Normals.end());
+        data.TexCoords.insert(data.TexCoords.end(), chunk.TexCoords.begin(), chunk.TexCoords.end());
+
+        for (const auto& idx : chunk.FaceIndices) {
+            data.FaceIndices.push_back({
+                ResolveIndex(idx.Position, positionBase),
+                ResolveIndex(idx.TexCoord, texCoordBase),
+                ResolveIndex(idx.Normal, normalBase)
+            });
+        }
+        for (usize f = 1; f < chunk.FaceStarts.size(); ++f) {
+            data.FaceStarts.push_back(cornerBase + chunk.FaceStarts[f]);
+        }
 
+        if (!chunk.MaterialLib.empty() && data.MaterialLib.empty()) {
+            data.MaterialLib = std::move(chunk.MaterialLib);
+        }
+        if (!chunk.CurrentMaterial.empty()) {
+            data.CurrentMaterial = std::move(chunk.CurrentMaterial);
+        }
+    }
+}
+
+bool MeshLoader::ParseOBJ(const String& filepath, OBJData& data) {
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        LOG_CORE_ERROR("Failed to open OBJ file: {}", filepath);
+        return false;
+    }
+
+    const char* begin = file.Begin();
+    const char* end = file.End();
+
+    usize chunkCount = 1;
+    if (JobSystem::IsInitialized()) {
+        chunkCount = std::clamp<usize>(file.Size() / ParallelParseChunkBytes, 1, JobSystem::GetWorkerCount() + 1);
+    }
+
+    // Chunk boundaries moved forward to the next line start
+    Vector<const char*> bounds(chunkCount + 1, end);
+    bounds[0] = begin;
+    for (usize i = 1; i < chunkCount; ++i) {
+        const char* split = begin + file.Size() * i / chunkCount;
+        bounds[i] = NextLine(std::max(split, bounds[i - 1]), end);
+    }
+
+    Vector<OBJData> chunks(chunkCount);
+    if (chunkCount == 1) {
+        ParseOBJRange(begin, end, chunks[0]);
+    } else {
+        JobSystem::ParallelFor(static_cast<u32>(chunkCount), 1, [&](u32 first, u32 last) {
+            for (u32 i = first; i < last; ++i) {
+                ParseOBJRange(bounds[i], bounds[i + 1], chunks[i]);
+            }
+        });
+    }
+
+    MergeOBJ(chunks, data);
     return true;
 }
 
 Ref<Mesh> MeshLoader::ConvertOBJToMesh(const OBJData& data, const MeshLoadOptions& options) {
+    const usize faceCount = data.GetFaceCount();
+    const usize cornerCount = data.FaceIndices.size();
+
     Vector<Vertex> vertices;
     Vector<u32> indices;
-    std::unordered_map<VertexKey, u32, VertexKeyHash> vertexMap;
-
-    for (const auto& face : data.Faces) {
-        Vector<u32> faceIndices;
-
-        for (const auto& idx : face.Indices) {
-            VertexKey key{idx.Position, idx.TexCoord, idx.Normal};
-
-            auto it = vertexMap.find(key);
-            if (it != vertexMap.end()) {
-                faceIndices.push_back(it->second);
-            } else {
-                Vertex vertex{};
+    vertices.reserve(std::min(cornerCount, data.Positions.size() * 2));
+    indices.reserve((cornerCount - 2 * faceCount) * 3);
+    VertexDeduplicator vertexMap(cornerCount);
+
+    auto resolveCorner = [&](const OBJData::Index& idx) {
+        bool inserted = false;
+        const u32 index = vertexMap.FindOrInsert(VertexKey{idx.Position, idx.TexCoord, idx.Normal}, inserted);
+        if (!inserted) {
+            return index;
+        }
 
-                if (idx.Position >= 0 && idx.Position < static_cast<i32>(data.Positions.size())) {
-                    vertex.Position = data.Positions[idx.Position];
-                }
+        Vertex vertex{};
 
-                if (idx.Normal >= 0 && idx.Normal < static_cast<i32>(data.Normals.size())) {
-                    vertex.Normal = data.Normals[idx.Normal];
-                }
+        if (idx.Position >= 0 && idx.Position < static_cast<i32>(data.Positions.size())) {
+            vertex.Position = data.Positions[idx.Position];
+        }
 
-                if (idx.TexCoord >= 0 && idx.TexCoord < static_cast<i32>(data.TexCoords.size())) {
-                    vertex.TexCoords = data.TexCoords[idx.TexCoord];
-                    if (options.FlipUVs) {
-                        vertex.TexCoords.y = 1.0f - vertex.TexCoords.y;
-                    }
-                }
+        if (idx.Normal >= 0 && idx.Normal < static_cast<i32>(data.Normals.size())) {
+            vertex.Normal = data.Normals[idx.Normal];
+        }
 
-                u32 newIndex = static_cast<u32>(vertices.size());
-                vertices.push_back(vertex);
-                vertexMap[key] = newIndex;
-                faceIndices.push_back(newIndex);
+        if (idx.TexCoord >= 0 && idx.TexCoord < static_cast<i32>(data.TexCoords.size())) {
+            vertex.TexCoords = data.TexCoords[idx.TexCoord];
+            if (options.FlipUVs) {
+                vertex.TexCoords.y = 1.0f - vertex.TexCoords.y;
             }
         }
 
-        for (size_t i = 1; i + 1 < faceIndices.size(); ++i) {
-            indices.push_back(faceIndices[0]);
-            indices.push_back(faceIndices[i]);
-            indices.push_back(faceIndices[i + 1]);
+        vertices.push_back(vertex);
+        return index;
+    };
+
+    // Fan triangulation
+    for (usize f = 0; f < faceCount; ++f) {
+        const u32 first = data.FaceStarts[f];
+        const u32 last = data.FaceStarts[f + 1];
+
+        const u32 anchor = resolveCorner(data.FaceIndices[first]);
+        u32 previous = resolveCorner(data.FaceIndices[first + 1]);
+        for (u32 c = first + 2; c < last; ++c) {
+            const u32 current = resolveCorner(data.FaceIndices[c]);
+            indices.push_back(anchor);
+            indices.push_back(previous);
+            indices.push_back(current);
+            previous = current;
         }
     }
 
@@ -171,22 +361,38 @@ Ref<Mesh> MeshLoader::ConvertOBJToMesh(const OBJData& data, const MeshLoadOption
         mesh->RecalculateBounds();
     }
 
+    if (options.LODCount > 0) {
+        mesh->GenerateLODs(options.LODCount);
+    }
+
+    if (options.Optimize) {
+        mesh->Optimize();
+    }
+
+    if (options.Meshlets) {
+        mesh->BuildMeshlets();
+    }
+
+    mesh->SetVertexFormat(options.Format);
     return mesh;
 }
 
 Ref<Mesh> MeshLoader::LoadOBJ(const String& filepath, const MeshLoadOptions& options) {
+    const auto startTime = std::chrono::steady_clock::now();
+
     OBJData data;
     if (!ParseOBJ(filepath, data)) {
         return nullptr;
     }
 
-    if (data.Positions.empty() || data.Faces.empty()) {
+    if (data.Positions.empty() || data.GetFaceCount() == 0) {
         LOG_CORE_ERROR("OBJ file has no geometry: {}", filepath);
         return nullptr;
     }
 
     auto mesh = ConvertOBJToMesh(data, options);
     mesh->SetFilePath(filepath);
+    mesh->SetResidency(options.Residency);
 
     size_t nameStart = filepath.find_last_of("/\\");
     String filename = (nameStart != String::npos) ? filepath.substr(nameStart + 1) : filepath;
@@ -196,12 +402,14 @@ Ref<Mesh> MeshLoader::LoadOBJ(const String& filepath, const MeshLoadOptions& opt
     }
     mesh->SetName(filename);
 
-    LOG_CORE_INFO("Loaded OBJ: {} ({} vertices, {} faces, {} normals, {} UVs)",
+    const f64 elapsedMs = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    LOG_CORE_INFO("Loaded OBJ: {} ({} vertices, {} faces, {} normals, {} UVs) in {:.1f} ms",
                   filepath,
                   data.Positions.size(),
-                  data.Faces.size(),
+                  data.GetFaceCount(),
                   data.Normals.size(),
-                  data.TexCoords.size());
+                  data.TexCoords.size(),
+                  elapsedMs);
 
     return mesh;
 }
@@ -299,6 +507,7 @@ Ref<Mesh> MeshLoader::CreateSphere(float radius, u32 segments, u32 rings) {
 
     auto mesh = CreateRef<Mesh>(std::move(vertices), std::move(indices));
     mesh->SetName("Sphere");
+    mesh->Optimize();
     return mesh;
 }
 
@@ -342,6 +551,7 @@ Ref<Mesh> MeshLoader::CreatePlane(float width, float height, u32 subdivisions) {
 
     auto mesh = CreateRef<Mesh>(std::move(vertices), std::move(indices));
     mesh->SetName("Plane");
+    mesh->Optimize();
     return mesh;
 }
 
@@ -458,6 +668,7 @@ Ref<Mesh> MeshLoader::CreateCylinder(float radius, float height, u32 segments) {
 
     auto mesh = CreateRef<Mesh>(std::move(vertices), std::move(indices));
     mesh->SetName("Cylinder");
+    mesh->Optimize();
     return mesh;
 }
 
@@ -10,12 +10,18 @@ struct MeshLoadOptions {
     bool GenerateNormals = false;
     bool GenerateTangents = true;
     bool CalculateBounds = true;
+    VertexFormat Format = VertexFormat::Full;   // GPU layout, see PackedVertex
+    u32 LODCount = 0;           // Simplified levels to generate (Mesh::GenerateLODs), cooked with the mesh
+    bool Optimize = true;       // Cache / overdraw / fetch ordering (Mesh::Optimize), cooked with the mesh
+    bool Meshlets = false;      // Meshlets for GPU cluster culling (Mesh::BuildMeshlets), cooked with the mesh
+    MeshResidency Residency = Mesh::GetDefaultResidency();  // CPU data kept after upload; not cooked
 };
 
 class MeshLoader {
 public:
     static Ref<Mesh> LoadOBJ(const String& filepath, const MeshLoadOptions& options = {});
 
+    // Procedural primitives come out Mesh::Optimize'd
     static Ref<Mesh> CreateCube(float size = 1.0f);
     static Ref<Mesh> CreateSphere(float radius = 1.0f, u32 segments = 32, u32 rings = 16);
     static Ref<Mesh> CreatePlane(float width = 1.0f, float height = 1.0f, u32 subdivisions = 1);
@@ -27,20 +33,29 @@ private:
         Vector<glm::vec3> Normals;
         Vector<glm::vec2> TexCoords;
 
-        struct Face {
-            struct Index {
-                i32 Position = -1;
-                i32 TexCoord = -1;
-                i32 Normal = -1;
-            };
-            Vector<Index> Indices;
+        // Zero-based, -1 when the corner has no such attribute
+        struct Index {
+            i32 Position = -1;
+            i32 TexCoord = -1;
+            i32 Normal = -1;
         };
-        Vector<Face> Faces;
+
+        // Corners of all faces back to back: face f is
+        // FaceIndices[FaceStarts[f] .. FaceStarts[f + 1])
+        Vector<Index> FaceIndices;
+        Vector<u32> FaceStarts{0};
         String MaterialLib;
         String CurrentMaterial;
+
+        usize GetFaceCount() const { return FaceStarts.size() - 1; }
     };
 
     static bool ParseOBJ(const String& filepath, OBJData& data);
+
+    // Parse whole lines in [begin, end). Negative (relative) indices that
+    // can't be resolved within the range are left encoded for MergeOBJ.
+    static void ParseOBJRange(const char* begin, const char* end, OBJData& data);
+    static void MergeOBJ(Vector<OBJData>& chunks, OBJData& data);
     static Ref<Mesh> ConvertOBJToMesh(const OBJData& data, const MeshLoadOptions& options);
 };
 
@@ -1,31 +1,42 @@
 #include "resources/loaders/TextureLoader.hpp"
+#include "resources/cooking/TextureCooker.hpp"
+#include "resources/ResourceManager.hpp"
 #include "core/Logger.hpp"
 #include <filesystem>
 
 namespace Engine {
 
-HashMap<String, Ref<Texture2D>> TextureLoader::s_TextureCache;
 Ref<Texture2D> TextureLoader::s_DefaultWhite;
 Ref<Texture2D> TextureLoader::s_DefaultBlack;
 Ref<Texture2D> TextureLoader::s_DefaultNormal;
 
-Ref<Texture2D> TextureLoader::Load(const String& filepath, bool flipVertically) {
-    // Check cache first
-    auto it = s_TextureCache.find(filepath);
-    if (it != s_TextureCache.end()) {
-        return it->second;
+String TextureLoader::ResolveCookedPath(const String& filepath) {
+    namespace fs = std::filesystem;
+
+    const fs::path source(filepath);
+    if (source.extension() == ".ktx2" || source.extension() == ".dds") {
+        return filepath;
     }
 
-    // Load new texture
-    auto texture = CreateRef<Texture2D>(filepath, flipVertically);
+    std::error_code error;
+    const String cooked = TextureCooker::GetCookedPath(filepath);
+    auto cookedTime = fs::last_write_time(cooked, error);
+    if (error) return filepath;
+    auto sourceTime = fs::last_write_time(source, error);
+    return (error || cookedTime >= sourceTime) ? cooked : filepath;
+}
+
+Ref<Texture2D> TextureLoader::Load(const String& filepath, bool flipVertically) {
+    auto& resources = ResourceManager::Instance();
+    if (auto texture = resources.GetTexture(filepath)) {
+        return texture;
+    }
 
-    if (texture->IsLoaded()) {
-        s_TextureCache[filepath] = texture;
-        LOG_CORE_DEBUG("TextureLoader: Cached texture '{}'", filepath);
-    } else {
+    // Cooked containers are stored already flipped
+    auto texture = resources.LoadTexture(filepath, filepath, flipVertically);
+    if (!texture) {
         LOG_CORE_WARN("TextureLoader: Failed to load '{}'", filepath);
     }
-
     return texture;
 }
 
@@ -40,7 +51,7 @@ PBRTextureSet TextureLoader::LoadPBRSet(const String& directory) {
     const Vector<String> roughnessNames = {"roughness", "rough"};
     const Vector<String> aoNames = {"ao", "ambient_occlusion", "ambientocclusion", "occlusion"};
     const Vector<String> emissiveNames = {"emissive", "emission", "glow"};
-    const Vector<String> extensions = {".png", ".jpg", ".jpeg", ".tga", ".bmp"};
+    const Vector<String> extensions = {".png", ".jpg", ".jpeg", ".tga", ".bmp", ".ktx2", ".dds"};
 
     auto findTexture = [&](const Vector<String>& names) -> String {
         for (const auto& name : names) {
@@ -193,20 +204,19 @@ Ref<Texture2D> TextureLoader::GetDefaultNormal() {
 }
 
 void TextureLoader::ClearCache() {
-    size_t count = s_TextureCache.size();
-    s_TextureCache.clear();
     s_DefaultWhite.reset();
     s_DefaultBlack.reset();
     s_DefaultNormal.reset();
-    LOG_CORE_INFO("TextureLoader: Cleared cache ({} textures)", count);
+    ResourceManager::Instance().UnloadUnusedTextures();
+    LOG_CORE_INFO("TextureLoader: Cleared cache");
 }
 
 size_t TextureLoader::GetCacheSize() {
-    return s_TextureCache.size();
+    return ResourceManager::Instance().GetStats().TexturesLoaded;
 }
 
 bool TextureLoader::IsLoaded(const String& filepath) {
-    return s_TextureCache.find(filepath) != s_TextureCache.end();
+    return ResourceManager::Instance().HasTexture(filepath);
 }
 
 } // namespace Engine
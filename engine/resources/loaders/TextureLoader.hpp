@@ -24,9 +24,14 @@ struct PBRTextureSet {
 
 class TextureLoader {
 public:
-    // Load a texture (cached - returns existing if already loaded)
+    // Load a texture through ResourceManager, cached under its path (returns
+    // existing if already loaded or loading). Null on failure.
     static Ref<Texture2D> Load(const String& filepath, bool flipVertically = true);
 
+    // The TextureCooker .ktx2 beside a source image while it is at least as
+    // new as the source, filepath otherwise
+    static String ResolveCookedPath(const String& filepath);
+
     // Load a PBR texture set from a directory
     // Expects files named: albedo.png, normal.png, metallic.png, roughness.png, ao.png, emissive.png
     static PBRTextureSet LoadPBRSet(const String& directory);
@@ -50,13 +55,13 @@ public:
     static Ref<Texture2D> GetDefaultBlack();
     static Ref<Texture2D> GetDefaultNormal();   // (128, 128, 255) - flat normal
 
-    // Cache management
+    // Cache management. Loaded textures live in ResourceManager's cache;
+    // ClearCache drops the defaults and the textures nothing else holds.
     static void ClearCache();
     static size_t GetCacheSize();
     static bool IsLoaded(const String& filepath);
 
 private:
-    static HashMap<String, Ref<Texture2D>> s_TextureCache;
     static Ref<Texture2D> s_DefaultWhite;
     static Ref<Texture2D> s_DefaultBlack;
     static Ref<Texture2D> s_DefaultNormal;
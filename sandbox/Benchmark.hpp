@@ -0,0 +1,329 @@
+#pragma once
+
+#include "DemoBase.hpp"
+#include "renderer/opengl/GPUProfiler.hpp"
+#include "core/FrameRecorder.hpp"
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace Demos {
+
+// Benchmark run parameters, filled from the command line
+struct BenchmarkSettings {
+    std::string Demo;                       // Registry id or display name
+    Engine::u32 WarmupFrames = 120;
+    Engine::u32 MeasuredFrames = 1000;
+    Engine::f32 FixedDeltaTime = 1.0f / 60.0f;
+    Engine::f32 OrbitSeconds = 20.0f;       // One turn of the camera path
+    std::string OutputPath = "benchmark.json";
+    std::string Label;                      // Free text copied to the report, e.g. a commit
+    std::vector<std::pair<std::string, std::string>> Parameters;  // --param key=value, for the demo
+    std::string ReplayPath;                 // FrameRecorder log driving the demo instead of the orbit
+};
+
+// Scripted camera for benchmarks: orbits the origin at the height and
+// distance the demo's own camera started from. Driven by the fixed
+// timestep, so every run sees the same views on the same frames.
+class BenchmarkCameraController : public Engine::CameraController {
+public:
+    BenchmarkCameraController(const glm::vec3& start, Engine::f32 aspectRatio, Engine::f32 orbitSeconds)
+        : m_OrbitSeconds(orbitSeconds) {
+        Engine::PerspectiveCameraSettings settings;
+        settings.AspectRatio = aspectRatio;
+        m_Camera = Engine::PerspectiveCamera(settings);
+
+        m_Radius = glm::max(glm::length(glm::vec2(start.x, start.z)), 1.0f);
+        m_Height = start.y;
+        m_StartAngle = std::atan2(start.z, start.x);
+        UpdateView();
+    }
+
+    void OnUpdate(Engine::f32 deltaTime) override {
+        m_Time += deltaTime;
+        UpdateView();
+    }
+
+    void OnEvent(Engine::Event& event) override {
+        if (event.GetEventType() == Engine::EventType::WindowResize) {
+            auto& resize = static_cast<Engine::WindowResizeEvent&>(event);
+            if (resize.GetHeight() > 0) {
+                m_Camera.SetAspectRatio(static_cast<Engine::f32>(resize.GetWidth()) /
+                                        static_cast<Engine::f32>(resize.GetHeight()));
+            }
+        }
+    }
+
+    Engine::Camera& GetCamera() override { return m_Camera; }
+    const Engine::Camera& GetCamera() const override { return m_Camera; }
+
+    void SetEnabled(bool) override {}
+    bool IsEnabled() const override { return true; }
+
+private:
+    void UpdateView() {
+        const Engine::f32 angle = m_StartAngle + glm::two_pi<Engine::f32>() * m_Time / m_OrbitSeconds;
+        // Bob a little so the view also sweeps vertically
+        const Engine::f32 height = m_Height * (1.0f + 0.25f * std::sin(2.0f * angle));
+        const glm::vec3 position(m_Radius * std::cos(angle), height, m_Radius * std::sin(angle));
+        m_Camera.SetView(position, glm::normalize(-position), glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+
+    Engine::PerspectiveCamera m_Camera;
+    Engine::f32 m_OrbitSeconds;
+    Engine::f32 m_Radius = 1.0f;
+    Engine::f32 m_Height = 0.0f;
+    Engine::f32 m_StartAngle = 0.0f;
+    Engine::f32 m_Time = 0.0f;
+};
+
+// Runs a demo for WarmupFrames + MeasuredFrames and writes a JSON report
+// of the measured frames: frame / CPU / GPU time percentiles, per-pass GPU
+// times, draw calls and memory. Keys are stable so reports from different
+// commits can be diffed or compared by a script.
+class BenchmarkRunner {
+public:
+    explicit BenchmarkRunner(const BenchmarkSettings& settings)
+        : m_Settings(settings),
+          m_FrameTimes(settings.MeasuredFrames),
+          m_CPUTimes(settings.MeasuredFrames),
+          m_GPUTimes(settings.MeasuredFrames) {}
+
+    const BenchmarkSettings& GetSettings() const { return m_Settings; }
+
+    // Swap the demo's camera for the scripted one, unless a replay drives
+    // the demo's own controls; then the run ends with the replay
+    void Begin(DemoBase& demo) {
+        m_Demo = &demo;
+
+        if (Engine::FrameRecorder::IsReplaying()) {
+            const Engine::u32 frames = Engine::FrameRecorder::GetReplayFrameCount();
+            const Engine::u32 available = frames > m_Settings.WarmupFrames + 1 ? frames - m_Settings.WarmupFrames - 1 : 0;
+            m_Settings.MeasuredFrames = std::min(m_Settings.MeasuredFrames, std::max(available, 1u));
+            LOG_INFO("Benchmark: {} warmup + {} measured frames of '{}' replayed from {}",
+                     m_Settings.WarmupFrames, m_Settings.MeasuredFrames, demo.GetName(), m_Settings.ReplayPath);
+            return;
+        }
+
+        auto& cameras = demo.GetCameraManager();
+        const auto* camera = cameras.GetActiveCamera();
+        const glm::vec3 start = camera ? camera->GetPosition() : glm::vec3(0.0f, 10.0f, 30.0f);
+
+        cameras.Register("benchmark", Engine::CreateScope<BenchmarkCameraController>(
+            start, demo.GetWindow().GetAspectRatio(), m_Settings.OrbitSeconds));
+        cameras.SetActive("benchmark");
+
+        LOG_INFO("Benchmark: {} warmup + {} measured frames of '{}' at {:.4f} s steps",
+                 m_Settings.WarmupFrames, m_Settings.MeasuredFrames, demo.GetName(),
+                 m_Settings.FixedDeltaTime);
+    }
+
+    // Call once per frame after the demo's update; the timings are those
+    // of the previous frame (GPU: of the frame read back this frame).
+    // Returns true once every measured frame has been recorded.
+    bool OnFrame(Engine::Application& app) {
+        m_Frame++;
+        if (m_Frame == m_Settings.WarmupFrames + 1) {
+            m_DroppedAtStart = Engine::GPUProfiler::GetDroppedFrames();
+        }
+        if (m_Frame <= m_Settings.WarmupFrames + 1) {
+            // Frame 1 has no previous frame; the warmup ones are discarded
+            return false;
+        }
+
+        m_FrameTimes.Push(Engine::Time::GetFrameTime() * 1000.0f);
+        m_CPUTimes.Push(app.GetCPUTimeMs());
+        m_GPUTimes.Push(Engine::GPUProfiler::GetTotalTimeMs());
+
+        for (const auto& pass : Engine::GPUProfiler::GetResults()) {
+            GetPassHistory(pass.Name).Push(pass.TimeMs);
+        }
+
+        if (const auto* lighting = m_Demo->GetLightingSystem()) {
+            m_GeometryDrawCalls.Add(lighting->GetStats().DrawCalls);
+            m_EntitiesRendered.Add(lighting->GetStats().EntitiesRendered);
+        }
+        if (const auto* shadows = m_Demo->GetShadowSystem()) {
+            m_ShadowDrawCalls.Add(shadows->GetStats().ShadowDrawCalls);
+        }
+
+        return m_FrameTimes.GetCount() >= m_Settings.MeasuredFrames;
+    }
+
+    bool WriteReport() const {
+        std::FILE* file = std::fopen(m_Settings.OutputPath.c_str(), "wb");
+        if (!file) {
+            LOG_ERROR("Benchmark: could not write {}", m_Settings.OutputPath);
+            return false;
+        }
+
+        auto& window = m_Demo->GetWindow();
+        const auto* glVendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+        const auto* glRenderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+        const auto* glVersion = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+
+        std::fputs("{\n  \"demo\": ", file);
+        WriteString(file, m_Demo->GetName());
+        std::fputs(",\n  \"label\": ", file);
+        WriteString(file, m_Settings.Label.c_str());
+        std::fputs(",\n  \"parameters\": {", file);
+        for (size_t i = 0; i < m_Settings.Parameters.size(); i++) {
+            std::fputs(i == 0 ? "" : ", ", file);
+            WriteString(file, m_Settings.Parameters[i].first.c_str());
+            std::fputs(": ", file);
+            WriteString(file, m_Settings.Parameters[i].second.c_str());
+        }
+        std::fputs("}", file);
+        std::fprintf(file, ",\n  \"timestamp\": %lld", static_cast<long long>(std::time(nullptr)));
+#ifdef NDEBUG
+        std::fputs(",\n  \"build\": \"release\"", file);
+#else
+        std::fputs(",\n  \"build\": \"debug\"", file);
+#endif
+        std::fputs(",\n  \"gl\": {\"vendor\": ", file);
+        WriteString(file, glVendor);
+        std::fputs(", \"renderer\": ", file);
+        WriteString(file, glRenderer);
+        std::fputs(", \"version\": ", file);
+        WriteString(file, glVersion);
+        std::fputs("}", file);
+
+        std::fprintf(file, ",\n  \"resolution\": [%u, %u]", window.GetWidth(), window.GetHeight());
+        std::fprintf(file, ",\n  \"vsync\": %s", window.IsVSync() ? "true" : "false");
+        std::fprintf(file, ",\n  \"warmupFrames\": %u", m_Settings.WarmupFrames);
+        std::fprintf(file, ",\n  \"measuredFrames\": %u", m_FrameTimes.GetCount());
+        std::fprintf(file, ",\n  \"fixedDeltaTime\": %.6f", static_cast<double>(m_Settings.FixedDeltaTime));
+        if (!m_Settings.ReplayPath.empty()) {
+            std::fputs(",\n  \"replay\": {\"path\": ", file);
+            WriteString(file, m_Settings.ReplayPath.c_str());
+            std::fprintf(file, ", \"diverged\": %s}", Engine::FrameRecorder::HasReplayDiverged() ? "true" : "false");
+        }
+
+        std::fputs(",\n  \"frameMs\": ", file);
+        WriteSummary(file, m_FrameTimes);
+        std::fputs(",\n  \"cpuMs\": ", file);
+        WriteSummary(file, m_CPUTimes);
+        std::fputs(",\n  \"gpuMs\": ", file);
+        WriteSummary(file, m_GPUTimes);
+        std::fprintf(file, ",\n  \"gpuDroppedFrames\": %u",
+                     Engine::GPUProfiler::GetDroppedFrames() - m_DroppedAtStart);
+
+        std::fputs(",\n  \"gpuPasses\": {", file);
+        for (size_t i = 0; i < m_PassTimes.size(); i++) {
+            std::fputs(i == 0 ? "\n    " : ",\n    ", file);
+            WriteString(file, m_PassTimes[i].first);
+            std::fputs(": ", file);
+            WriteSummary(file, m_PassTimes[i].second);
+        }
+        std::fputs(m_PassTimes.empty() ? "}" : "\n  }", file);
+
+        std::fputs(",\n  \"drawCalls\": {\"geometry\": ", file);
+        m_GeometryDrawCalls.Write(file);
+        std::fputs(", \"shadow\": ", file);
+        m_ShadowDrawCalls.Write(file);
+        std::fputs("}", file);
+        std::fputs(",\n  \"entitiesRendered\": ", file);
+        m_EntitiesRendered.Write(file);
+
+        const auto resources = Engine::ResourceManager::Instance().GetStats();
+        std::fprintf(file, ",\n  \"memory\": {\"textureBytes\": %llu, \"peakResidentBytes\": %llu}",
+                     static_cast<unsigned long long>(resources.EstimatedMemory),
+                     static_cast<unsigned long long>(GetPeakResidentBytes()));
+        std::fputs("\n}\n", file);
+
+        const bool ok = std::fclose(file) == 0;
+        if (ok) {
+            const auto frame = m_FrameTimes.Summarize();
+            LOG_INFO("Benchmark: frame p50 {:.2f} ms, p99 {:.2f} ms; report written to {}",
+                     frame.P50, frame.P99, m_Settings.OutputPath);
+        } else {
+            LOG_ERROR("Benchmark: could not write {}", m_Settings.OutputPath);
+        }
+        return ok;
+    }
+
+private:
+    struct Counter {
+        Engine::u64 Sum = 0;
+        Engine::u32 Min = ~0u;
+        Engine::u32 Max = 0;
+        Engine::u32 Count = 0;
+
+        void Add(Engine::u32 value) {
+            Sum += value;
+            Min = glm::min(Min, value);
+            Max = glm::max(Max, value);
+            Count++;
+        }
+
+        void Write(std::FILE* file) const {
+            std::fprintf(file, "{\"avg\": %.2f, \"min\": %u, \"max\": %u}",
+                         Count ? static_cast<double>(Sum) / Count : 0.0, Count ? Min : 0u, Max);
+        }
+    };
+
+    Engine::TimingHistory& GetPassHistory(const char* name) {
+        for (auto& [passName, history] : m_PassTimes) {
+            if (passName == name) return history;
+        }
+        return m_PassTimes.emplace_back(name, Engine::TimingHistory(m_Settings.MeasuredFrames)).second;
+    }
+
+    static void WriteSummary(std::FILE* file, const Engine::TimingHistory& history) {
+        const auto s = history.Summarize();
+        std::fprintf(file, "{\"avg\": %.3f, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f}",
+                     static_cast<double>(s.Average), static_cast<double>(s.P50),
+                     static_cast<double>(s.P95), static_cast<double>(s.P99),
+                     static_cast<double>(s.Max));
+    }
+
+    static void WriteString(std::FILE* file, const char* text) {
+        std::fputc('"', file);
+        for (const char* c = text ? text : ""; *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                std::fputc('\\', file);
+                std::fputc(*c, file);
+            } else if (static_cast<unsigned char>(*c) >= 0x20) {
+                std::fputc(*c, file);
+            }
+        }
+        std::fputc('"', file);
+    }
+
+    static Engine::u64 GetPeakResidentBytes() {
+#if defined(__unix__) || defined(__APPLE__)
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+        return static_cast<Engine::u64>(usage.ru_maxrss);           // Bytes
+#else
+        return static_cast<Engine::u64>(usage.ru_maxrss) * 1024;    // Kilobytes
+#endif
+#else
+        return 0;
+#endif
+    }
+
+private:
+    BenchmarkSettings m_Settings;
+    DemoBase* m_Demo = nullptr;
+    Engine::u32 m_Frame = 0;
+    Engine::u32 m_DroppedAtStart = 0;
+
+    Engine::TimingHistory m_FrameTimes;     // Wall time between frames
+    Engine::TimingHistory m_CPUTimes;       // Main thread, up to the swap
+    Engine::TimingHistory m_GPUTimes;       // Sum of top-level GPU zones
+    std::vector<std::pair<const char*, Engine::TimingHistory>> m_PassTimes;
+
+    Counter m_GeometryDrawCalls;
+    Counter m_ShadowDrawCalls;
+    Counter m_EntitiesRendered;
+};
+
+} // namespace Demos
@@ -2,6 +2,7 @@
 
 #include "Engine.hpp"
 #include "renderer/debug/DebugRenderer.hpp"
+#include "renderer/opengl/GPUProfiler.hpp"
 #include <glad/gl.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <imgui.h>
@@ -22,6 +23,20 @@ public:
     virtual void OnEvent(Engine::Event& e) {}
     virtual void OnResize(Engine::u32 width, Engine::u32 height) {}
 
+    // Render thread mode (--render-thread). A demo that supports it renders
+    // only from the commands OnExtract records: they run on the render thread
+    // while OnUpdate simulates the next frame, so after OnInit the registry
+    // and the rendering systems are touched nowhere else, and the commands
+    // carry the frame's camera and parameters by value. OnImGuiRender runs
+    // while the render thread is idle. A demo opts in by redeclaring
+    // SupportsRenderThread; REGISTER_DEMO records it without creating one.
+    static constexpr bool SupportsRenderThread = false;
+    virtual void OnExtract(Engine::FramePacket& packet) {}
+
+    // Scene parameter from the command line (--param key=value), applied
+    // before OnInit. Returns false for keys the demo doesn't know.
+    virtual bool SetParameter(const std::string& key, const std::string& value) { return false; }
+
     // Info
     virtual const char* GetName() const = 0;
     virtual const char* GetDescription() const = 0;
@@ -30,10 +45,16 @@ public:
     void SetWindow(Engine::Window* window) { m_Window = window; }
     Engine::Window& GetWindow() { return *m_Window; }
 
+    // Used by the benchmark runner to drive the camera and read stats
+    Engine::CameraManager& GetCameraManager() { return m_CameraManager; }
+    const Engine::DeferredLightingSystem* GetLightingSystem() const { return m_LightingSystem.get(); }
+    const Engine::ShadowMapSystem* GetShadowSystem() const { return m_ShadowSystem.get(); }
+
 protected:
     // Common resources available to all demos
     entt::registry m_Registry;
     Engine::CameraManager m_CameraManager;
+    Engine::Scope<Engine::TransformSystem> m_TransformSystem;
     Engine::Scope<Engine::ShadowMapSystem> m_ShadowSystem;
     Engine::Scope<Engine::DeferredLightingSystem> m_LightingSystem;
 
@@ -41,14 +62,14 @@ protected:
     Engine::Ref<Engine::Mesh> m_SphereMesh;
     Engine::Ref<Engine::Mesh> m_PlaneMesh;
     Engine::Ref<Engine::Mesh> m_CylinderMesh;
-    Engine::Ref<Engine::Shader> m_TonemapShader;
-    Engine::Ref<Engine::VertexArray> m_ScreenQuadVAO;
+    Engine::Scope<Engine::PostProcessStack> m_PostProcess;
 
     Engine::Window* m_Window = nullptr;
 
     // Demo state
     float m_Time = 0.0f;
     float m_Exposure = 1.0f;
+    float m_UpscaleSharpness = 0.25f;
     bool m_ShowStats = true;
     bool m_ShadowsEnabled = true;
     bool m_ShowHelp = true;
@@ -66,31 +87,43 @@ protected:
         m_PlaneMesh = Engine::MeshLoader::CreatePlane(1.0f, 1.0f, 1);
         m_CylinderMesh = Engine::MeshLoader::CreateCylinder(0.5f, 1.0f, 32);
 
+        // World matrices: demos only set local transforms
+        m_TransformSystem = Engine::CreateScope<Engine::TransformSystem>();
+        m_TransformSystem->Create(m_Registry);
+
         // Initialize shadow system
         m_ShadowSystem = Engine::CreateScope<Engine::ShadowMapSystem>();
-        m_ShadowSystem->OnCreate(m_Registry);
+        m_ShadowSystem->Create(m_Registry);
 
         // Initialize deferred lighting system
         m_LightingSystem = Engine::CreateScope<Engine::DeferredLightingSystem>();
-        m_LightingSystem->OnCreate(m_Registry);
+        m_LightingSystem->Create(m_Registry);
         m_LightingSystem->Resize(m_Window->GetWidth(), m_Window->GetHeight());
         m_LightingSystem->SetShadowSystem(m_ShadowSystem.get());
 
-        // Load tonemap shader
-        m_TonemapShader = resources.LoadShader("tonemap", "assets/shaders/postprocess/tonemap.glsl");
-        CreateScreenQuad();
+        m_PostProcess = Engine::CreateScope<Engine::PostProcessStack>();
 
         // Initialize debug renderer
         m_DebugRenderer = Engine::CreateScope<Engine::DebugRenderer>();
         m_DebugRenderer->Initialize();
         m_DebugRenderer->SetCSM(m_ShadowSystem->GetCSM());
         m_DebugRenderer->SetGBuffer(&m_LightingSystem->GetGBuffer());
+        m_DebugRenderer->SetHiZ(&m_LightingSystem->GetHiZPyramid());
+        m_DebugRenderer->SetOverdrawCounter(&m_LightingSystem->GetOverdrawCounter());
     }
 
     void ShutdownRenderingSystems() {
         if (m_DebugRenderer) m_DebugRenderer->Shutdown();
-        m_ShadowSystem->OnDestroy(m_Registry);
-        m_LightingSystem->OnDestroy(m_Registry);
+        m_ShadowSystem->Destroy(m_Registry);
+        m_LightingSystem->Destroy(m_Registry);
+        m_TransformSystem->Destroy(m_Registry);
+    }
+
+    // Resolve the world matrices of everything moved since the last frame.
+    // RenderScene() and RenderView() start with it; demos that cull or draw
+    // by hand call it first.
+    void ResolveTransforms() {
+        m_TransformSystem->Update(m_Registry, 0.0f);
     }
 
     // Handle debug input (F3 to cycle views, F1 for help)
@@ -135,35 +168,88 @@ protected:
         ImGui::End();
     }
 
-    // Render final image with tonemapping
+    // TAA resolve when enabled, then post-process (bloom, exposure, grading,
+    // tonemapping) onto the window
     void RenderTonemapped() {
+        auto& settings = m_PostProcess->GetSettings();
+        settings.Exposure = m_Exposure;
+        settings.Sharpness = m_UpscaleSharpness;
+
+        const auto scene = m_LightingSystem->ResolveSceneColor();
+        {
+            GPU_PROFILE_SCOPE("Post Process");
+            m_PostProcess->Render(*scene.Buffer, scene.UVScale,
+                                  m_Window->GetWidth(), m_Window->GetHeight(), ImGui::GetIO().DeltaTime);
+        }
+
         Engine::Framebuffer::BindDefault();
         glViewport(0, 0, m_Window->GetWidth(), m_Window->GetHeight());
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glDisable(GL_DEPTH_TEST);
-
-        m_TonemapShader->Bind();
-        m_TonemapShader->SetInt("u_HDRBuffer", 0);
-        m_TonemapShader->SetFloat("u_Exposure", m_Exposure);
-        m_TonemapShader->SetFloat("u_Gamma", 2.2f);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        m_PostProcess->Blit(0);
+    }
 
-        m_LightingSystem->GetLightingBuffer().BindColorTexture(0, 0);
+    // What a frame is drawn with, taken on the main thread
+    struct FrameView {
+        Engine::Camera Camera;      // Sliced: the base holds every matrix the passes read
+        float Exposure = 1.0f;
+        Engine::u32 Width = 0;
+        Engine::u32 Height = 0;
+    };
+
+    FrameView CaptureView() const {
+        FrameView view;
+        if (const auto* camera = m_CameraManager.GetActiveCamera()) {
+            view.Camera = *camera;
+        }
+        view.Exposure = m_Exposure;
+        view.Width = m_Window->GetWidth();
+        view.Height = m_Window->GetHeight();
+        return view;
+    }
 
-        m_ScreenQuadVAO->Bind();
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+    // RenderScene() and RenderTonemapped() from a captured view, touching no
+    // state the simulation changes; the render thread path
+    void RenderView(const FrameView& view, float deltaTime) {
+        m_ViewCamera = view.Camera;
+        if (!m_ViewUniforms) {
+            m_ViewUniforms = Engine::CreateScope<Engine::CameraUniformBuffer>();
+        }
+        m_ViewUniforms->Upload(m_ViewCamera);
+
+        ResolveTransforms();
+        m_ShadowSystem->SetCamera(&m_ViewCamera);
+        m_LightingSystem->SetCamera(&m_ViewCamera);
+        m_ShadowSystem->Update(m_Registry, 0.0f);
+        m_LightingSystem->Update(m_Registry, 0.0f);
+
+        auto& settings = m_PostProcess->GetSettings();
+        settings.Exposure = view.Exposure;
+        settings.Sharpness = m_UpscaleSharpness;
+
+        const auto scene = m_LightingSystem->ResolveSceneColor();
+        {
+            GPU_PROFILE_SCOPE("Post Process");
+            m_PostProcess->Render(*scene.Buffer, scene.UVScale, view.Width, view.Height, deltaTime);
+        }
 
-        glEnable(GL_DEPTH_TEST);
+        Engine::Framebuffer::BindDefault();
+        glViewport(0, 0, view.Width, view.Height);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        m_PostProcess->Blit(0);
     }
 
     // Render shadows and deferred lighting pass
     void RenderScene() {
+        m_CameraManager.UploadUniforms();
+
         if (auto* cam = m_CameraManager.GetActiveCamera()) {
             m_ShadowSystem->SetCamera(const_cast<Engine::Camera*>(cam));
             m_LightingSystem->SetCamera(const_cast<Engine::Camera*>(cam));
         }
 
-        m_ShadowSystem->OnUpdate(m_Registry, 0.0f);
-        m_LightingSystem->OnUpdate(m_Registry, 0.0f);
+        ResolveTransforms();
+        m_ShadowSystem->Update(m_Registry, 0.0f);
+        m_LightingSystem->Update(m_Registry, 0.0f);
     }
 
     // Entity creation helpers
@@ -180,14 +266,24 @@ protected:
         if (rotation != glm::vec3(0.0f)) {
             t.SetRotation(glm::quat(rotation));
         }
-        t.UpdateWorldMatrix();
     }
 
     void SetMesh(entt::entity e, Engine::Ref<Engine::Mesh> mesh) {
-        auto& mc = m_Registry.emplace_or_replace<Engine::MeshComponent>(e);
-        mc.VAO = mesh->GetVertexArray();
-        mc.IndexCount = mesh->GetIndexCount();
+        m_Registry.emplace_or_replace<Engine::MeshComponent>(e, MakeMeshComponent(mesh));
+    }
+
+    // For prefab defaults and override arrays
+    Engine::MeshComponent MakeMeshComponent(const Engine::Ref<Engine::Mesh>& mesh) {
+        // One pool entry per mesh, however many entities share it
+        auto [it, added] = m_MeshHandles.try_emplace(mesh.get());
+        if (added) {
+            it->second = Engine::ResourceManager::Instance().AddMesh(mesh);
+        }
+
+        Engine::MeshComponent mc;
+        mc.Mesh = it->second;
         mc.LocalBounds = mesh->GetBounds();
+        return mc;
     }
 
     void SetMaterial(entt::entity e, const glm::vec4& color,
@@ -247,7 +343,6 @@ protected:
 
         auto& t = m_Registry.emplace<Engine::Transform>(e);
         t.SetPosition(pos);
-        t.UpdateWorldMatrix();
 
         auto& light = m_Registry.emplace<Engine::PointLightComponent>(e);
         light.Color = color;
@@ -265,7 +360,6 @@ protected:
 
         auto& t = m_Registry.emplace<Engine::Transform>(e);
         t.SetPosition(pos);
-        t.UpdateWorldMatrix();
 
         auto& light = m_Registry.emplace<Engine::SpotLightComponent>(e);
         light.Direction = glm::normalize(dir);
@@ -280,25 +374,13 @@ protected:
     }
 
 private:
-    void CreateScreenQuad() {
-        float vertices[] = {
-            -1.0f,  1.0f, 0.0f,  0.0f, 1.0f,
-            -1.0f, -1.0f, 0.0f,  0.0f, 0.0f,
-             1.0f, -1.0f, 0.0f,  1.0f, 0.0f,
-             1.0f,  1.0f, 0.0f,  1.0f, 1.0f
-        };
-        Engine::u32 indices[] = {0, 1, 2, 2, 3, 0};
-
-        m_ScreenQuadVAO = Engine::CreateRef<Engine::VertexArray>();
-        auto vbo = Engine::CreateRef<Engine::VertexBuffer>(vertices, sizeof(vertices));
-        vbo->SetLayout({
-            {Engine::ShaderDataType::Float3, "a_Position"},
-            {Engine::ShaderDataType::Float2, "a_TexCoords"}
-        });
-        auto ibo = Engine::CreateRef<Engine::IndexBuffer>(indices, 6);
-        m_ScreenQuadVAO->AddVertexBuffer(vbo);
-        m_ScreenQuadVAO->SetIndexBuffer(ibo);
-    }
+    // RenderView's copy of the camera, with its own uniform block so the
+    // previous view-projection is the last one drawn
+    Engine::Camera m_ViewCamera;
+    Engine::Scope<Engine::CameraUniformBuffer> m_ViewUniforms;
+
+    // Meshes are held by the Refs demos keep, so the pointers stay unique
+    Engine::HashMap<const Engine::Mesh*, Engine::MeshHandle> m_MeshHandles;
 };
 
 } // namespace Demos
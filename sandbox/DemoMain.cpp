@@ -0,0 +1,133 @@
+// Game Engine Demos
+// Interactive demo launcher, or an unattended benchmark of one demo:
+//
+//   SandboxDemos --benchmark LightingStressTest [--warmup 120] [--frames 1000]
+//                [--dt 0.016667] [--orbit 20] [--output benchmark.json] [--label <text>]
+//                [--param key=value ...]
+//   SandboxDemos --telemetry <name>    (also combines with --benchmark)
+//
+// Reproducing a run: record it interactively, then replay it as often as
+// needed, alone or as a benchmark of the same demo:
+//
+//   SandboxDemos --demo LightingStressTest --record hitch.frec
+//   SandboxDemos --benchmark LightingStressTest --replay hitch.frec
+//
+// Drawing on a render thread, one demo that supports it:
+//
+//   SandboxDemos --render-thread [--demo ShadowQualityDemo]
+
+#include "DemoRegistry.hpp"
+#include "core/Telemetry.hpp"
+#include "core/FrameRecorder.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+void PrintUsage(const char* program) {
+    std::printf("Usage: %s [--benchmark <demo> [options]] [--telemetry <name>]\n"
+                "          [--demo <demo>] [--record <path> | --replay <path>] [--render-thread]\n"
+                "  --warmup <n>     Frames run before measuring (default 120)\n"
+                "  --frames <n>     Frames measured (default 1000)\n"
+                "  --dt <seconds>   Fixed timestep (default 1/60)\n"
+                "  --orbit <s>      Seconds per turn of the camera path (default 20)\n"
+                "  --output <path>  JSON report (default benchmark.json)\n"
+                "  --label <text>   Copied to the report, e.g. the commit\n"
+                "  --param <k=v>    Scene parameter for the demo, repeatable\n"
+                "  --telemetry <name>  Publish engine counters to shared memory <name>\n"
+                "  --demo <demo>    Demo to start with (interactive)\n"
+                "  --record <path>  Log every frame's input and timing to <path>\n"
+                "  --replay <path>  Drive the frames from a recorded log\n"
+                "  --render-thread  Draw on a render thread (interactive, no demo switching)\n"
+                "Demos:\n", program);
+    for (const auto& demo : Demos::DemoRegistry::Instance().GetDemos()) {
+        std::printf("  %-22s %s%s\n", demo.Id, demo.Name, demo.RenderThread ? " (--render-thread)" : "");
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Demos::BenchmarkSettings benchmark;
+    bool runBenchmark = false;
+    const char* telemetryName = nullptr;
+    const char* recordPath = nullptr;
+    std::string startDemo;
+    bool renderThread = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        const bool hasValue = value != nullptr;
+
+        // The one flag without a value
+        if (std::strcmp(arg, "--render-thread") == 0) {
+            renderThread = true;
+            continue;
+        }
+
+        if (std::strcmp(arg, "--benchmark") == 0 && hasValue) {
+            benchmark.Demo = value;
+            runBenchmark = true;
+        } else if (std::strcmp(arg, "--warmup") == 0 && hasValue) {
+            benchmark.WarmupFrames = static_cast<Engine::u32>(std::strtoul(value, nullptr, 10));
+        } else if (std::strcmp(arg, "--frames") == 0 && hasValue) {
+            benchmark.MeasuredFrames = std::max(1u, static_cast<Engine::u32>(std::strtoul(value, nullptr, 10)));
+        } else if (std::strcmp(arg, "--dt") == 0 && hasValue) {
+            benchmark.FixedDeltaTime = std::strtof(value, nullptr);
+        } else if (std::strcmp(arg, "--orbit") == 0 && hasValue) {
+            benchmark.OrbitSeconds = std::max(1.0f, std::strtof(value, nullptr));
+        } else if (std::strcmp(arg, "--output") == 0 && hasValue) {
+            benchmark.OutputPath = value;
+        } else if (std::strcmp(arg, "--label") == 0 && hasValue) {
+            benchmark.Label = value;
+        } else if (std::strcmp(arg, "--telemetry") == 0 && hasValue) {
+            telemetryName = value;
+        } else if (std::strcmp(arg, "--demo") == 0 && hasValue) {
+            startDemo = value;
+        } else if (std::strcmp(arg, "--record") == 0 && hasValue) {
+            recordPath = value;
+        } else if (std::strcmp(arg, "--replay") == 0 && hasValue) {
+            benchmark.ReplayPath = value;
+        } else if (std::strcmp(arg, "--param") == 0 && hasValue && std::strchr(value, '=')) {
+            const char* split = std::strchr(value, '=');
+            benchmark.Parameters.emplace_back(std::string(value, split), std::string(split + 1));
+        } else {
+            PrintUsage(argv[0]);
+            return std::strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+        i++;
+    }
+
+    if (runBenchmark && benchmark.FixedDeltaTime <= 0.0f) {
+        std::fprintf(stderr, "--dt must be positive\n");
+        return 1;
+    }
+    if (recordPath && !benchmark.ReplayPath.empty()) {
+        std::fprintf(stderr, "--record and --replay are exclusive\n");
+        return 1;
+    }
+    // The benchmark runner reads the rendering systems from the main thread
+    if (runBenchmark && renderThread) {
+        std::fprintf(stderr, "--benchmark and --render-thread are exclusive\n");
+        return 1;
+    }
+
+    Demos::DemoLauncher launcher(runBenchmark ? &benchmark : nullptr, startDemo, renderThread);
+    if (telemetryName) {
+        Engine::Telemetry::Export(telemetryName);
+    }
+    if (recordPath && !Engine::FrameRecorder::StartRecording(recordPath)) {
+        return 1;
+    }
+    if (!benchmark.ReplayPath.empty() && !Engine::FrameRecorder::StartReplay(benchmark.ReplayPath)) {
+        return 1;
+    }
+    launcher.Run();
+    Engine::FrameRecorder::StopReplay();
+    Engine::Telemetry::StopExport();
+    return launcher.GetExitCode();
+}
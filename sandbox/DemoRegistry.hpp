@@ -1,6 +1,8 @@
 #pragma once
 
 #include "DemoBase.hpp"
+#include "Benchmark.hpp"
+#include <cctype>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -9,8 +11,10 @@ namespace Demos {
 
 // Demo info for registration
 struct DemoInfo {
+    const char* Id;             // Class name, for the command line
     const char* Name;
     const char* Description;
+    bool RenderThread;          // DemoClass::SupportsRenderThread
     std::function<std::unique_ptr<DemoBase>()> CreateFn;
 };
 
@@ -22,9 +26,9 @@ public:
         return instance;
     }
 
-    void Register(const char* name, const char* description,
+    void Register(const char* id, const char* name, const char* description, bool renderThread,
                   std::function<std::unique_ptr<DemoBase>()> createFn) {
-        m_Demos.push_back({name, description, std::move(createFn)});
+        m_Demos.push_back({id, name, description, renderThread, std::move(createFn)});
     }
 
     const std::vector<DemoInfo>& GetDemos() const { return m_Demos; }
@@ -36,6 +40,18 @@ public:
         return nullptr;
     }
 
+    // Index of the demo whose id or name matches, ignoring case, spaces
+    // and punctuation; -1 if none does
+    int Find(const char* name) const {
+        const std::string key = Normalize(name);
+        for (size_t i = 0; i < m_Demos.size(); i++) {
+            if (Normalize(m_Demos[i].Id) == key || Normalize(m_Demos[i].Name) == key) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
     std::unique_ptr<DemoBase> Create(const char* name) {
         for (const auto& demo : m_Demos) {
             if (strcmp(demo.Name, name) == 0) {
@@ -45,6 +61,17 @@ public:
         return nullptr;
     }
 
+private:
+    static std::string Normalize(const char* text) {
+        std::string result;
+        for (const char* c = text; *c; ++c) {
+            if (std::isalnum(static_cast<unsigned char>(*c))) {
+                result.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(*c))));
+            }
+        }
+        return result;
+    }
+
 private:
     std::vector<DemoInfo> m_Demos;
 };
@@ -56,8 +83,10 @@ private:
             DemoClass##Registrar() { \
                 auto instance = std::make_unique<DemoClass>(); \
                 DemoRegistry::Instance().Register( \
+                    #DemoClass, \
                     instance->GetName(), \
                     instance->GetDescription(), \
+                    DemoClass::SupportsRenderThread, \
                     []() { return std::make_unique<DemoClass>(); } \
                 ); \
             } \
@@ -66,9 +95,34 @@ private:
     }
 
 // Demo Launcher Application
+//
+// Interactive by default, starting with startDemo if given. Given benchmark
+// settings it runs that one demo unattended - vsync off, fixed timestep,
+// scripted camera or a FrameRecorder replay, no UI - writes the report and
+// exits.
+//
+// With renderThread the frames are drawn on the engine's render thread from
+// what the demo extracts (DemoBase::OnExtract). Demos are created and
+// destroyed with the GL context on the main thread, so this mode runs the
+// one demo it starts with, startDemo or the first that supports it, and
+// doesn't switch. Only ShadowQualityDemo supports it; the others, and any
+// demo that registers Render-phase systems with the application, draw on
+// the main thread.
 class DemoLauncher : public Engine::Application {
 public:
-    DemoLauncher() : Application("Game Engine Demo Launcher", 1600, 900) {}
+    explicit DemoLauncher(const BenchmarkSettings* benchmark = nullptr, const std::string& startDemo = {},
+                          bool renderThread = false)
+        : Application("Game Engine Demo Launcher", 1600, 900), m_StartDemo(startDemo) {
+        if (benchmark) {
+            m_Benchmark = std::make_unique<BenchmarkRunner>(*benchmark);
+            GetWindow().SetVSync(false);
+            Engine::Time::SetFixedDeltaTime(benchmark->FixedDeltaTime);
+        }
+        SetRenderThreadEnabled(renderThread);
+    }
+
+    // Process exit code: non-zero when a benchmark could not run or report
+    int GetExitCode() const { return m_ExitCode; }
 
 protected:
     void OnInit() override {
@@ -80,9 +134,31 @@ protected:
             LOG_INFO("  [{}] {} - {}", i + 1, demos[i].Name, demos[i].Description);
         }
 
-        // Start with first demo if available
+        if (m_Benchmark) {
+            const int index = DemoRegistry::Instance().Find(m_Benchmark->GetSettings().Demo.c_str());
+            if (index < 0) {
+                LOG_ERROR("Benchmark: no demo named '{}'", m_Benchmark->GetSettings().Demo);
+                m_ExitCode = 1;
+                Close();
+                return;
+            }
+            SwitchDemo(static_cast<size_t>(index));
+            m_Benchmark->Begin(*m_CurrentDemo);
+            return;
+        }
+
+        if (IsRenderThreadEnabled()) {
+            StartRenderThreadDemo();
+            return;
+        }
+
+        // Start with the requested demo, or the first one
+        const int start = m_StartDemo.empty() ? 0 : DemoRegistry::Instance().Find(m_StartDemo.c_str());
+        if (start < 0) {
+            LOG_WARN("No demo named '{}'", m_StartDemo);
+        }
         if (!demos.empty()) {
-            SwitchDemo(0);
+            SwitchDemo(start < 0 ? 0 : static_cast<size_t>(start));
         }
     }
 
@@ -95,14 +171,20 @@ protected:
     }
 
     void OnUpdate(Engine::f32 dt) override {
+        if (m_Benchmark) {
+            UpdateBenchmark(dt);
+            return;
+        }
+
         // Handle demo switching with number keys 1-9
+        const bool canSwitch = !IsRenderThreadEnabled();
         Engine::i32 keys[] = {
             Engine::Key::D1, Engine::Key::D2, Engine::Key::D3,
             Engine::Key::D4, Engine::Key::D5, Engine::Key::D6,
             Engine::Key::D7, Engine::Key::D8, Engine::Key::D9
         };
         for (int i = 0; i < 9; i++) {
-            if (Engine::Input::IsKeyJustPressed(keys[i])) {
+            if (canSwitch && Engine::Input::IsKeyJustPressed(keys[i])) {
                 size_t demoIndex = static_cast<size_t>(i);
                 if (demoIndex < DemoRegistry::Instance().GetDemos().size()) {
                     SwitchDemo(demoIndex);
@@ -138,8 +220,19 @@ protected:
         }
     }
 
+    void OnExtract(Engine::FramePacket& packet) override {
+        if (m_CurrentDemo) {
+            m_CurrentDemo->OnExtract(packet);
+        }
+    }
+
     void OnImGuiRender() override {
-        RenderDemoSelector();
+        // Benchmarks measure the demo alone
+        if (m_Benchmark) return;
+
+        if (!IsRenderThreadEnabled()) {
+            RenderDemoSelector();
+        }
 
         if (m_CurrentDemo) {
             m_CurrentDemo->OnImGuiRender();
@@ -147,6 +240,57 @@ protected:
     }
 
 private:
+    void UpdateBenchmark(Engine::f32 dt) {
+        // A replayed Escape is the recording's, not an abort
+        if (!Engine::FrameRecorder::IsReplaying() && Engine::Input::IsKeyJustPressed(Engine::Key::Escape)) {
+            LOG_WARN("Benchmark aborted");
+            m_ExitCode = 1;
+            Close();
+            return;
+        }
+
+        m_CurrentDemo->OnUpdate(dt);
+
+        if (m_Benchmark->OnFrame(*this)) {
+            if (!m_Benchmark->WriteReport()) {
+                m_ExitCode = 1;
+            }
+            Close();
+        }
+    }
+
+    void StartRenderThreadDemo() {
+        auto& registry = DemoRegistry::Instance();
+        const auto& demos = registry.GetDemos();
+
+        int index = -1;
+        if (!m_StartDemo.empty()) {
+            index = registry.Find(m_StartDemo.c_str());
+            if (index < 0) {
+                LOG_ERROR("No demo named '{}'", m_StartDemo);
+            } else if (!demos[index].RenderThread) {
+                LOG_ERROR("{} doesn't support the render thread", demos[index].Name);
+                index = -1;
+            }
+        } else {
+            for (size_t i = 0; i < demos.size() && index < 0; i++) {
+                if (demos[i].RenderThread) {
+                    index = static_cast<int>(i);
+                }
+            }
+            if (index < 0) {
+                LOG_ERROR("No demo supports the render thread");
+            }
+        }
+
+        if (index < 0) {
+            m_ExitCode = 1;
+            Close();
+            return;
+        }
+        SwitchDemo(static_cast<size_t>(index));
+    }
+
     void SwitchDemo(size_t index) {
         if (m_CurrentDemo) {
             m_CurrentDemo->OnShutdown();
@@ -155,6 +299,13 @@ private:
         m_CurrentDemo = DemoRegistry::Instance().Create(index);
 
         if (m_CurrentDemo) {
+            if (m_Benchmark) {
+                for (const auto& [key, value] : m_Benchmark->GetSettings().Parameters) {
+                    if (!m_CurrentDemo->SetParameter(key, value)) {
+                        LOG_WARN("{} has no parameter '{}'", m_CurrentDemo->GetName(), key);
+                    }
+                }
+            }
             m_CurrentDemo->SetWindow(&GetWindow());
             m_CurrentDemo->OnInit();
             m_CurrentDemoIndex = index;
@@ -193,6 +344,9 @@ private:
 private:
     std::unique_ptr<DemoBase> m_CurrentDemo;
     size_t m_CurrentDemoIndex = 0;
+    std::unique_ptr<BenchmarkRunner> m_Benchmark;
+    std::string m_StartDemo;
+    int m_ExitCode = 0;
 };
 
 } // namespace Demos
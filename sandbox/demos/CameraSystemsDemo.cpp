@@ -111,11 +111,16 @@ public:
 
     void OnResize(Engine::u32 width, Engine::u32 height) override {
         m_LightingSystem->Resize(width, height);
+        if (m_PipView != Engine::DeferredLightingSystem::InvalidView) {
+            m_LightingSystem->ResizeView(m_PipView, width / PipDivisor, height / PipDivisor);
+        }
     }
 
     void OnRender() override {
+        UpdatePictureInPicture();
         RenderScene();
         RenderTonemapped();
+        RenderPictureInPicture();
     }
 
     void OnImGuiRender() override {
@@ -171,11 +176,49 @@ public:
         ImGui::Separator();
 
         ImGui::SliderFloat("Exposure", &m_Exposure, 0.1f, 3.0f);
+        ImGui::Checkbox("Picture-in-Picture", &m_ShowPip);
 
         ImGui::End();
     }
 
 private:
+    // A second camera drawn as an extra view into the top-right corner
+    void UpdatePictureInPicture() {
+        const char* pipName = m_CameraManager.GetActiveName() == "fps" ? "orbital" : "fps";
+        const Engine::Camera* pipCamera = &m_CameraManager.Get(pipName)->GetCamera();
+
+        if (m_PipView == Engine::DeferredLightingSystem::InvalidView) {
+            if (!m_ShowPip) return;
+            m_PipView = m_LightingSystem->AddView(pipCamera,
+                                                  GetWindow().GetWidth() / PipDivisor,
+                                                  GetWindow().GetHeight() / PipDivisor);
+        }
+
+        m_LightingSystem->SetViewCamera(m_PipView, pipCamera);
+        m_LightingSystem->SetViewEnabled(m_PipView, m_ShowPip);
+    }
+
+    void RenderPictureInPicture() {
+        if (!m_ShowPip || m_PipView == Engine::DeferredLightingSystem::InvalidView) return;
+
+        Engine::Framebuffer* pip = m_LightingSystem->GetViewLightingBuffer(m_PipView);
+        if (!pip) return;
+
+        // Its own stack, so bloom and exposure follow the inset camera
+        if (!m_PipPostProcess) {
+            m_PipPostProcess = Engine::CreateScope<Engine::PostProcessStack>();
+        }
+        auto& settings = m_PipPostProcess->GetSettings();
+        settings.Exposure = m_Exposure;
+        settings.Sharpness = 0.0f;
+
+        const Engine::u32 width = GetWindow().GetWidth() / PipDivisor;
+        const Engine::u32 height = GetWindow().GetHeight() / PipDivisor;
+        m_PipPostProcess->Render(*pip, pip->GetViewportUVScale(), width, height, ImGui::GetIO().DeltaTime);
+        m_PipPostProcess->Blit(0, static_cast<Engine::i32>(GetWindow().GetWidth() - width - 10),
+                               static_cast<Engine::i32>(GetWindow().GetHeight() - height - 10));
+    }
+
     void CreateEnvironment() {
         // Ground
         CreateObject(m_CubeMesh,
@@ -261,12 +304,10 @@ private:
         auto& bodyT = m_Registry.get<Engine::Transform>(m_CharacterBody);
         bodyT.SetPosition(x, 1.25f + glm::sin(m_Time * 8.0f) * 0.1f, z);  // Subtle bobbing
         bodyT.SetRotation(glm::angleAxis(facing, glm::vec3(0.0f, 1.0f, 0.0f)));
-        bodyT.UpdateWorldMatrix();
 
         // Update head
         auto& headT = m_Registry.get<Engine::Transform>(m_CharacterHead);
         headT.SetPosition(x, 2.5f + glm::sin(m_Time * 8.0f) * 0.1f, z);
-        headT.UpdateWorldMatrix();
 
         m_CharacterPosition = glm::vec3(x, 1.5f, z);
     }
@@ -301,6 +342,11 @@ private:
     entt::entity m_CharacterHead;
     glm::vec3 m_CharacterPosition = {0.0f, 1.5f, 0.0f};
     bool m_CursorEnabled = true;
+
+    static constexpr Engine::u32 PipDivisor = 4;
+    Engine::DeferredLightingSystem::ViewHandle m_PipView = Engine::DeferredLightingSystem::InvalidView;
+    bool m_ShowPip = false;
+    Engine::Scope<Engine::PostProcessStack> m_PipPostProcess;
 };
 
 REGISTER_DEMO(CameraSystemsDemo)
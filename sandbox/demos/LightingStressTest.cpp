@@ -260,7 +260,6 @@ private:
                 basePos.y + yOffset,
                 glm::sin(angle) * newRadius
             );
-            t.UpdateWorldMatrix();
         }
     }
 
@@ -280,7 +280,6 @@ private:
                 4.0f + glm::sin(m_Time * 0.5f + i) * 1.5f,
                 glm::sin(angle) * radius
             );
-            t.UpdateWorldMatrix();
         }
     }
 
@@ -1,6 +1,9 @@
 #include "../DemoBase.hpp"
 #include "../DemoRegistry.hpp"
-#include "renderer/particles/ParticleSystem.hpp"
+#include "renderer/particles/ParticleEmitterSystem.hpp"
+#include "renderer/pipeline/RenderGraph.hpp"
+#include "renderer/pipeline/WeightedBlendedOIT.hpp"
+#include "resources/ResourceManager.hpp"
 
 namespace Demos {
 
@@ -28,9 +31,12 @@ public:
 
         InitializeRenderingSystems();
 
-        // Initialize particle system
-        m_ParticleSystem = Engine::CreateScope<Engine::ParticleSystem>();
-        m_ParticleSystem->Initialize();
+        // Effects attached to entities go through the emitter system; the
+        // others are created on its ParticleSystem directly
+        m_EmitterSystem = Engine::CreateScope<Engine::ParticleEmitterSystem>();
+        m_EmitterSystem->Create(m_Registry);
+        m_ParticleSystem = &m_EmitterSystem->GetParticleSystem();
+        m_Transparency = Engine::CreateScope<Engine::WeightedBlendedOIT>();
 
         CreateEnvironment();
         CreateParticleEffects();
@@ -44,7 +50,9 @@ public:
     }
 
     void OnShutdown() override {
-        m_ParticleSystem->Shutdown();
+        m_RenderGraph.ReleaseResources();
+        m_EmitterSystem->Destroy(m_Registry);
+        m_Transparency.reset();
         ShutdownRenderingSystems();
         Engine::Input::SetCursorMode(true);
     }
@@ -84,9 +92,15 @@ public:
         m_CameraManager.OnUpdate(dt);
         m_Time += dt;
 
-        // Update particle system
-        m_ParticleSystem->SetCamera(const_cast<Engine::Camera*>(m_CameraManager.GetActiveCamera()));
-        m_ParticleSystem->Update(dt);
+        // The magic orb circles the right pillar, its emitter in tow
+        auto& orb = m_Registry.get<Engine::Transform>(m_MagicOrb);
+        orb.SetPosition(6.0f + glm::cos(m_Time) * 2.0f, 2.5f + glm::sin(m_Time * 2.0f) * 0.3f,
+                        glm::sin(m_Time) * 2.0f);
+
+        // Update particle system, the entities' emitters where they are now
+        ResolveTransforms();
+        m_EmitterSystem->SetCamera(const_cast<Engine::Camera*>(m_CameraManager.GetActiveCamera()));
+        m_EmitterSystem->Update(m_Registry, dt);
     }
 
     void OnEvent(Engine::Event& e) override {
@@ -98,12 +112,64 @@ public:
     }
 
     void OnRender() override {
-        RenderScene();
-
-        // Render particles after scene but before tonemapping
-        m_ParticleSystem->Render();
-
-        RenderTonemapped();
+        using Access = Engine::RenderGraph::Access;
+        using Builder = Engine::RenderGraph::Builder;
+        using Context = Engine::RenderGraph::Context;
+
+        auto& gbuffer = m_LightingSystem->GetGBuffer();
+        auto& lightingBuffer = m_LightingSystem->GetLightingBuffer();
+
+        auto sceneDepth = m_RenderGraph.ImportTexture("Scene Depth", gbuffer.GetDepthTextureID());
+        auto hdr = m_RenderGraph.ImportTexture("HDR", lightingBuffer.GetColorAttachmentRendererID(0));
+        auto hdrDepth = m_RenderGraph.ImportTexture("HDR Depth", lightingBuffer.GetDepthAttachmentRendererID());
+        auto backbuffer = m_RenderGraph.ImportTexture("Backbuffer", 0);
+
+        m_RenderGraph.AddPass("Scene", [&](Builder& builder) {
+            sceneDepth = builder.Write(sceneDepth, Access::DepthAttachment);
+            hdr = builder.Write(hdr, Access::ColorAttachment);
+        }, [this](const Context&) {
+            RenderScene();
+        });
+
+        // Copied into the lighting buffer, the G-buffer depth depth-tests
+        // the particles
+        m_RenderGraph.AddPass("Particle Depth", [&](Builder& builder) {
+            builder.Read(sceneDepth, Access::Copy);
+            hdrDepth = builder.Write(hdrDepth, Access::Copy);
+        }, [&gbuffer, &lightingBuffer](const Context&) {
+            glBlitNamedFramebuffer(gbuffer.GetFramebuffer().GetRendererID(), lightingBuffer.GetRendererID(),
+                                   0, 0, gbuffer.GetWidth(), gbuffer.GetHeight(),
+                                   0, 0, lightingBuffer.GetWidth(), lightingBuffer.GetHeight(),
+                                   GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+        });
+
+        // Into the HDR buffer after the scene, before tonemapping. The
+        // G-buffer depth also drives collision and soft particles.
+        m_RenderGraph.AddPass("Particles", [&](Builder& builder) {
+            builder.Read(sceneDepth, Access::Sampled);
+            builder.Read(hdrDepth, Access::DepthAttachment);
+            hdr = builder.Write(hdr, Access::ColorAttachment);
+        }, [this, &gbuffer, &lightingBuffer](const Context&) {
+            m_ParticleSystem->SetSceneDepth(gbuffer.GetDepthTextureID(), gbuffer.GetWidth(), gbuffer.GetHeight(),
+                                            m_LightingSystem->GetRenderUVScale());
+            if (m_UseOIT) {
+                m_ParticleSystem->Render(*m_Transparency, lightingBuffer);
+            } else {
+                lightingBuffer.Bind();
+                m_ParticleSystem->Render();
+            }
+            lightingBuffer.Unbind();
+        });
+
+        m_RenderGraph.AddPass("Tonemap", [&](Builder& builder) {
+            builder.Read(hdr, Access::Sampled);
+            builder.Write(backbuffer, Access::ColorAttachment);
+            builder.SideEffect();
+        }, [this](const Context&) {
+            RenderTonemapped();
+        });
+
+        m_RenderGraph.Execute();
     }
 
     void OnImGuiRender() override {
@@ -116,18 +182,22 @@ public:
         auto& stats = m_ParticleSystem->GetStats();
         ImGui::Text("Emitters: %u active / %u total", stats.ActiveEmitters, stats.TotalEmitters);
         ImGui::Text("Particles: %u alive / %u max", stats.AliveParticles, stats.TotalParticles);
+        ImGui::Text("Pooled: %u emitters, %u slots, %u draws", stats.PooledEmitters, stats.PoolCapacityUsed, stats.PoolDrawCalls);
+        ImGui::Text("Depth sorted: %u emitters", stats.SortedEmitters);
+        ImGui::Text("LOD: %u reduced, %u culled", stats.ReducedEmitters, stats.CulledEmitters);
+
+        const auto& graphStats = m_RenderGraph.GetStats();
+        ImGui::Text("Render graph: %u passes (%u culled), %u barriers",
+                    graphStats.Passes, graphStats.CulledPasses, graphStats.Barriers);
 
         ImGui::Separator();
         ImGui::Text("Effects (press to toggle):");
 
         const char* effectNames[] = {"Fire", "Smoke", "Sparks", "Rain", "Snow", "Magic"};
         for (int i = 0; i < 6; i++) {
-            bool active = (i < static_cast<int>(m_Emitters.size())) && m_Emitters[i] && m_Emitters[i]->IsPlaying();
+            bool active = IsEffectActive(i);
             if (ImGui::Checkbox(effectNames[i], &active)) {
-                if (i < static_cast<int>(m_Emitters.size()) && m_Emitters[i]) {
-                    if (active) m_Emitters[i]->Play();
-                    else m_Emitters[i]->Pause();
-                }
+                SetEffectActive(i, active);
             }
             ImGui::SameLine();
             ImGui::TextDisabled("[%d]", i + 1);
@@ -141,6 +211,31 @@ public:
 
         ImGui::Separator();
 
+        // Sort benchmark: compare frame times with the sort on and off
+        bool stressActive = m_Emitters[6] != nullptr;
+        if (ImGui::Checkbox("Smoke Stress (1M)", &stressActive)) {
+            ToggleSmokeStress();
+        }
+        if (m_Emitters[6]) {
+            ImGui::SameLine();
+            ImGui::Checkbox("Depth Sort", &m_Emitters[6]->GetSettings().DepthSort);
+
+            // Baked turbulence against the per-particle random force
+            auto& stress = m_Emitters[6]->GetSettings();
+            bool curlNoise = stress.TurbulenceField != nullptr;
+            ImGui::SameLine();
+            if (ImGui::Checkbox("Curl Noise Field", &curlNoise)) {
+                stress.TurbulenceField = curlNoise
+                    ? Engine::ResourceManager::Instance().GenerateVectorField("curl_noise")
+                    : nullptr;
+            }
+            ImGui::Text("Frame: %.2f ms", Engine::Time::GetDeltaTime() * 1000.0f);
+        }
+
+        ImGui::Checkbox("Order-Independent Transparency", &m_UseOIT);
+
+        ImGui::Separator();
+
         ImGui::SliderFloat("Exposure", &m_Exposure, 0.1f, 3.0f);
 
         float timeScale = m_ParticleSystem->GetTimeScale();
@@ -189,6 +284,13 @@ private:
         // Reserve space for emitters
         m_Emitters.resize(7, nullptr);
 
+        // Shared LOD: full rate up close, then half and quarter rate further out
+        Engine::Vector<Engine::ParticleLODBand> lodBands = {
+            {15.0f, 0.0f, 1.0f, 1.0f, 1},
+            {30.0f, 0.0f, 0.5f, 1.25f, 2},
+            {1000.0f, 0.0f, 0.25f, 1.5f, 4},
+        };
+
         // Fire - on the pedestal
         auto fireSettings = Engine::ParticlePresets::Fire();
         fireSettings.Position = glm::vec3(0.0f, 1.0f, 0.0f);
@@ -204,6 +306,7 @@ private:
         // Sparks - from left pillar
         auto sparkSettings = Engine::ParticlePresets::Sparks();
         sparkSettings.Position = glm::vec3(-6.0f, 3.0f, 0.0f);
+        sparkSettings.LODBands = lodBands;
         m_Emitters[2] = m_ParticleSystem->CreateEmitter(sparkSettings);
         m_Emitters[2]->Pause();
 
@@ -221,11 +324,20 @@ private:
         m_Emitters[4] = m_ParticleSystem->CreateEmitter(snowSettings);
         m_Emitters[4]->Pause();
 
-        // Magic - orbiting
-        auto magicSettings = Engine::ParticlePresets::Magic();
-        magicSettings.Position = glm::vec3(6.0f, 2.0f, 0.0f);
-        m_Emitters[5] = m_ParticleSystem->CreateEmitter(magicSettings);
-        m_Emitters[5]->Pause();
+        // Magic - on an orb orbiting the right pillar. The entity carries
+        // the emitter, which ParticleEmitterSystem creates while the
+        // component is enabled; m_Emitters[MagicIndex] stays empty.
+        m_MagicOrb = CreateObject(m_SphereMesh,
+            {8.0f, 2.5f, 0.0f},
+            {0.3f, 0.3f, 0.3f},
+            {0.6f, 0.3f, 1.0f, 1.0f},
+            0.0f, 0.2f,
+            false
+        );
+        auto& magic = m_Registry.emplace<Engine::ParticleEmitterComponent>(m_MagicOrb);
+        magic.Settings = Engine::ParticlePresets::Magic();
+        magic.Settings.LODBands = lodBands;
+        magic.Enabled = false;
 
         LOG_INFO("Created {} particle emitters", m_Emitters.size());
     }
@@ -251,15 +363,49 @@ private:
     }
 
     void ToggleEmitter(int index, const char* name) {
+        const bool active = !IsEffectActive(index);
+        SetEffectActive(index, active);
+        LOG_INFO("{} {}", name, active ? "ON" : "OFF");
+    }
+
+    bool IsEffectActive(int index) const {
+        if (index == MagicIndex) {
+            return m_Registry.get<Engine::ParticleEmitterComponent>(m_MagicOrb).Enabled;
+        }
+        return index < static_cast<int>(m_Emitters.size()) && m_Emitters[index] && m_Emitters[index]->IsPlaying();
+    }
+
+    void SetEffectActive(int index, bool active) {
+        // Disabling the orb's component destroys its emitter and particles
+        if (index == MagicIndex) {
+            m_Registry.get<Engine::ParticleEmitterComponent>(m_MagicOrb).Enabled = active;
+            return;
+        }
         if (index >= static_cast<int>(m_Emitters.size()) || !m_Emitters[index]) return;
 
-        if (m_Emitters[index]->IsPlaying()) {
-            m_Emitters[index]->Pause();
-            LOG_INFO("{} OFF", name);
-        } else {
-            m_Emitters[index]->Play();
-            LOG_INFO("{} ON", name);
+        if (active) m_Emitters[index]->Play();
+        else m_Emitters[index]->Pause();
+    }
+
+    void ToggleSmokeStress() {
+        if (m_Emitters[6]) {
+            m_ParticleSystem->DestroyEmitter(m_Emitters[6]);
+            m_Emitters[6] = nullptr;
+            return;
         }
+
+        // Dense alpha-blended volume, worst case for unsorted blending
+        auto stressSettings = Engine::ParticlePresets::Smoke();
+        stressSettings.MaxParticles = 1000000;
+        stressSettings.SpawnRate = 300000.0f;
+        stressSettings.Shape = Engine::EmitterShape::Box;
+        stressSettings.ShapeSize = glm::vec3(12.0f, 1.0f, 12.0f);
+        stressSettings.Position = glm::vec3(0.0f, 1.0f, 0.0f);
+        stressSettings.SizeStart = 0.05f;
+        stressSettings.SizeEnd = 0.2f;
+        m_Emitters[6] = m_ParticleSystem->CreateEmitter(stressSettings);
+
+        LOG_INFO("Smoke stress ON ({} particles)", stressSettings.MaxParticles);
     }
 
     void TriggerExplosion() {
@@ -270,6 +416,10 @@ private:
             (m_RNG() % 10 - 5) * 1.0f
         );
 
+        // Stops once the burst has had time to die, so the ParticleSystem
+        // destroys the emitter instead of keeping it forever
+        explosionSettings.Duration = explosionSettings.LifetimeMax;
+
         auto* emitter = m_ParticleSystem->CreateEmitter(explosionSettings);
         emitter->Emit(explosionSettings.BurstCount);
 
@@ -280,9 +430,16 @@ private:
     }
 
 private:
-    Engine::Scope<Engine::ParticleSystem> m_ParticleSystem;
+    static constexpr int MagicIndex = 5;
+
+    Engine::Scope<Engine::ParticleEmitterSystem> m_EmitterSystem;
+    Engine::ParticleSystem* m_ParticleSystem = nullptr;    // m_EmitterSystem's
+    Engine::Scope<Engine::WeightedBlendedOIT> m_Transparency;
+    bool m_UseOIT = true;
+    Engine::RenderGraph m_RenderGraph;
     Engine::Vector<Engine::ParticleEmitter*> m_Emitters;
     entt::entity m_FireLight;
+    entt::entity m_MagicOrb = entt::null;
     std::mt19937 m_RNG{std::random_device{}()};
 };
 
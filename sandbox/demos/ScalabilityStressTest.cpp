@@ -0,0 +1,660 @@
+#include "../DemoBase.hpp"
+#include "../DemoRegistry.hpp"
+#include "core/Profiler.hpp"
+#include "renderer/Material.hpp"
+#include "renderer/culling/CullingSystem.hpp"
+#include "renderer/culling/LODSelectionSystem.hpp"
+#include "renderer/culling/SpatialSortSystem.hpp"
+#include "renderer/opengl/GPUProfiler.hpp"
+#include "renderer/particles/ParticleSystem.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+namespace Demos {
+
+// Parameterized scene for measuring how each subsystem scales: entity,
+// unique mesh, unique material, point light and emitter counts are all
+// knobs. A sweep steps one of them through a range, rebuilding the scene,
+// and records per-subsystem CPU / GPU times for every step.
+class ScalabilityStressTest : public DemoBase {
+public:
+    const char* GetName() const override { return "Scalability Stress Test"; }
+    const char* GetDescription() const override {
+        return "Parameterized scene sweeping entity, mesh, material, light and emitter counts";
+    }
+
+    bool SetParameter(const std::string& key, const std::string& value) override {
+        const auto number = static_cast<Engine::u32>(std::strtoul(value.c_str(), nullptr, 10));
+        if (key == "entities") m_Params.Entities = number;
+        else if (key == "meshes") m_Params.UniqueMeshes = std::clamp(number, 1u, MaxUniqueMeshes);
+        else if (key == "materials") m_Params.UniqueMaterials = std::max(number, 1u);
+        else if (key == "lights") m_Params.PointLights = number;
+        else if (key == "emitters") m_Params.Emitters = number;
+        else if (key == "dynamic") m_Params.DynamicFraction = std::clamp(std::strtof(value.c_str(), nullptr), 0.0f, 1.0f);
+        else if (key == "culling") m_Params.Culling = number != 0;
+        else if (key == "lods") m_Params.LODs = number != 0;
+        else if (key == "spatialsort") m_Params.SpatialSort = number != 0;
+        else if (key == "shadows") m_Params.Shadows = number != 0;
+        else if (key == "seed") m_Params.Seed = number;
+        else return false;
+        return true;
+    }
+
+    void OnInit() override {
+        LOG_INFO("Initializing Scalability Stress Test");
+
+        Engine::OrbitalCameraSettings orbSettings;
+        orbSettings.Radius = 60.0f;
+        orbSettings.MaxRadius = 1000.0f;
+        orbSettings.Elevation = 35.0f;
+        orbSettings.Smoothing = 8.0f;
+        orbSettings.FarPlane = 4000.0f;
+        m_CameraManager.Register("orbital",
+            Engine::CreateScope<Engine::OrbitalCameraController>(GetWindow().GetAspectRatio(), orbSettings));
+        m_CameraManager.SetActive("orbital");
+        Engine::Input::SetCursorMode(true);
+
+        InitializeRenderingSystems();
+
+        m_CullingSystem = Engine::CreateScope<Engine::CullingSystem>();
+        m_CullingSystem->Create(m_Registry);
+        m_ShadowSystem->SetSpatialIndex(&m_CullingSystem->GetSpatialIndex());
+        m_LODSystem = Engine::CreateScope<Engine::LODSelectionSystem>();
+        m_SpatialSortSystem = Engine::CreateScope<Engine::SpatialSortSystem>();
+        m_SpatialSortSystem->Create(m_Registry);
+
+        m_ParticleSystem = Engine::CreateScope<Engine::ParticleSystem>();
+        m_ParticleSystem->Initialize();
+
+        CreateAmbientLight({0.03f, 0.03f, 0.04f}, 1.0f);
+        m_Sun = CreateDirectionalLight({0.3f, -1.0f, 0.25f}, {1.0f, 0.95f, 0.85f}, 0.6f, m_Params.Shadows);
+
+        Rebuild();
+
+        m_Exposure = 0.8f;
+        glEnable(GL_DEPTH_TEST);
+    }
+
+    void OnShutdown() override {
+        ClearScene();
+        m_ParticleSystem->Shutdown();
+        m_CullingSystem->Destroy(m_Registry);
+        ShutdownRenderingSystems();
+    }
+
+    void OnUpdate(Engine::f32 dt) override {
+        m_CameraManager.OnUpdate(dt);
+        m_Time += dt;
+
+        UpdateSweep();
+
+        AnimateDynamic();
+
+        const Engine::u64 particleStart = Engine::Profiler::Now();
+        m_ParticleSystem->SetCamera(m_CameraManager.GetActiveCamera());
+        m_ParticleSystem->Update(dt);
+        m_FrameCPU[ParticleCPU] = ElapsedMs(particleStart);
+    }
+
+    void OnEvent(Engine::Event& e) override {
+        m_CameraManager.OnEvent(e);
+    }
+
+    void OnResize(Engine::u32 width, Engine::u32 height) override {
+        m_LightingSystem->Resize(width, height);
+    }
+
+    void OnRender() override {
+        auto* camera = m_CameraManager.GetActiveCamera();
+        m_CameraManager.UploadUniforms();
+
+        ResolveTransforms();
+
+        Engine::u64 start = Engine::Profiler::Now();
+        if (m_Params.SpatialSort) {
+            m_SpatialSortSystem->Update(m_Registry, Engine::Time::GetDeltaTime());
+        }
+        m_CullingSystem->SetCamera(camera);
+        m_CullingSystem->SetCullingEnabled(m_Params.Culling);
+        m_CullingSystem->Update(m_Registry, 0.0f);
+        m_LODSystem->SetCamera(camera);
+        m_LODSystem->SetViewportHeight(GetWindow().GetHeight());
+        m_LODSystem->GetSettings().Enabled = m_Params.LODs;
+        m_LODSystem->Update(m_Registry, 0.0f);
+        m_FrameCPU[CullCPU] = ElapsedMs(start);
+
+        m_ShadowSystem->SetCamera(camera);
+        m_LightingSystem->SetCamera(camera);
+
+        start = Engine::Profiler::Now();
+        m_ShadowSystem->Update(m_Registry, 0.0f);
+        m_FrameCPU[ShadowCPU] = ElapsedMs(start);
+
+        start = Engine::Profiler::Now();
+        m_LightingSystem->Update(m_Registry, 0.0f);
+        m_FrameCPU[LightingCPU] = ElapsedMs(start);
+
+        // Particles depth-test against the scene, as in the particle demo
+        auto& gbuffer = m_LightingSystem->GetGBuffer();
+        auto& lightingBuffer = m_LightingSystem->GetLightingBuffer();
+        m_ParticleSystem->SetSceneDepth(gbuffer.GetDepthTextureID(), gbuffer.GetWidth(), gbuffer.GetHeight(),
+                                        m_LightingSystem->GetRenderUVScale());
+        glBlitNamedFramebuffer(gbuffer.GetFramebuffer().GetRendererID(), lightingBuffer.GetRendererID(),
+                               0, 0, gbuffer.GetWidth(), gbuffer.GetHeight(),
+                               0, 0, lightingBuffer.GetWidth(), lightingBuffer.GetHeight(),
+                               GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+        start = Engine::Profiler::Now();
+        lightingBuffer.Bind();
+        m_ParticleSystem->Render();
+        lightingBuffer.Unbind();
+        m_FrameCPU[ParticleCPU] += ElapsedMs(start);
+
+        RenderTonemapped();
+    }
+
+    void OnImGuiRender() override {
+        ImGui::SetNextWindowPos(ImVec2(10, 120), ImGuiCond_FirstUseEver);
+        ImGui::Begin("Scalability Stress Test", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+
+        ImGui::Text("Frame: %.2f ms  CPU: %.2f ms  GPU: %.2f ms",
+                    Engine::Time::GetFrameTime() * 1000.0f,
+                    Engine::Application::Get().GetCPUTimeMs(),
+                    Engine::GPUProfiler::GetTotalTimeMs());
+
+        const auto& culling = m_CullingSystem->GetStats();
+        const auto& lighting = m_LightingSystem->GetStats();
+        ImGui::Text("Visible: %u / %u", culling.Visible, culling.Tested);
+        ImGui::Text("Draw calls: %u (%u batches), shadow draws: %u",
+                    lighting.DrawCalls, lighting.Batches, m_ShadowSystem->GetStats().ShadowDrawCalls);
+        ImGui::Text("Triangles: %u (%u reduced LOD)", lighting.Triangles, m_LODSystem->GetStats().Reduced);
+        ImGui::Text("Scene build: %.1f ms", m_LastBuildMs);
+
+        ImGui::Separator();
+
+        const bool sweeping = m_Sweep.Active;
+        ImGui::BeginDisabled(sweeping);
+
+        int entities = static_cast<int>(m_Params.Entities);
+        int meshes = static_cast<int>(m_Params.UniqueMeshes);
+        int materials = static_cast<int>(m_Params.UniqueMaterials);
+        int lights = static_cast<int>(m_Params.PointLights);
+        int emitters = static_cast<int>(m_Params.Emitters);
+        bool changed = false;
+        changed |= ImGui::DragInt("Entities", &entities, 1000.0f, 0, 1000000);
+        changed |= ImGui::SliderInt("Unique Meshes", &meshes, 1, static_cast<int>(MaxUniqueMeshes));
+        changed |= ImGui::DragInt("Unique Materials", &materials, 1.0f, 1, 4096);
+        changed |= ImGui::DragInt("Point Lights", &lights, 4.0f, 0, 4096);
+        changed |= ImGui::DragInt("Emitters", &emitters, 1.0f, 0, 512);
+        changed |= ImGui::SliderFloat("Dynamic Fraction", &m_Params.DynamicFraction, 0.0f, 1.0f);
+        if (changed) {
+            m_Params.Entities = static_cast<Engine::u32>(std::max(entities, 0));
+            m_Params.UniqueMeshes = static_cast<Engine::u32>(std::max(meshes, 1));
+            m_Params.UniqueMaterials = static_cast<Engine::u32>(std::max(materials, 1));
+            m_Params.PointLights = static_cast<Engine::u32>(std::max(lights, 0));
+            m_Params.Emitters = static_cast<Engine::u32>(std::max(emitters, 0));
+        }
+        if (ImGui::Button("Rebuild Scene")) {
+            Rebuild();
+        }
+
+        ImGui::Checkbox("Frustum Culling", &m_Params.Culling);
+        ImGui::Checkbox("Mesh LODs", &m_Params.LODs);
+        if (ImGui::Checkbox("Spatial Sort", &m_Params.SpatialSort) && m_Params.SpatialSort) {
+            m_SpatialSortSystem->Invalidate();
+        }
+        if (m_Params.SpatialSort) {
+            const auto& sort = m_SpatialSortSystem->GetStats();
+            ImGui::SameLine();
+            ImGui::TextDisabled("%u inversions, %.2f ms (%s)", sort.Inversions, sort.Milliseconds,
+                                sort.Incremental ? "incremental" : "full");
+        }
+        if (ImGui::Checkbox("Sun Shadows", &m_Params.Shadows)) {
+            m_Registry.get<Engine::DirectionalLightComponent>(m_Sun).CastShadows = m_Params.Shadows;
+        }
+
+        ImGui::Separator();
+
+        int axis = static_cast<int>(m_SweepAxis);
+        ImGui::Combo("Sweep", &axis, AxisNames, static_cast<int>(SweepAxis::Count));
+        m_SweepAxis = static_cast<SweepAxis>(axis);
+        ImGui::TextDisabled("Steps: %s", AxisStepsText(m_SweepAxis));
+        if (ImGui::Button("Run Sweep")) {
+            StartSweep(m_SweepAxis);
+        }
+        ImGui::EndDisabled();
+
+        if (sweeping) {
+            ImGui::SameLine();
+            ImGui::Text("Step %zu / %zu", m_Sweep.Step + 1, m_Sweep.Values.size());
+        }
+
+        if (!m_SweepRows.empty()) {
+            DrawSweepTable();
+        }
+
+        ImGui::End();
+    }
+
+private:
+    static constexpr Engine::u32 MaxUniqueMeshes = 64;
+    static constexpr Engine::u32 SettleFrames = 30;     // After a rebuild, before measuring
+    static constexpr Engine::u32 MeasureFrames = 120;
+
+    struct Parameters {
+        Engine::u32 Entities = 10000;
+        Engine::u32 UniqueMeshes = 4;
+        Engine::u32 UniqueMaterials = 16;
+        Engine::u32 PointLights = 64;
+        Engine::u32 Emitters = 4;
+        Engine::f32 DynamicFraction = 0.05f;   // Entities moved every frame
+        bool Culling = true;
+        bool LODs = true;
+        bool SpatialSort = false;   // Morton order of the render groups
+        bool Shadows = true;
+        Engine::u32 Seed = 1;
+    };
+
+    enum class SweepAxis { Entities, Meshes, Materials, Lights, Emitters, Count };
+    static constexpr const char* AxisNames[] = {"Entities", "Meshes", "Materials", "Lights", "Emitters"};
+
+    // Per-frame series recorded during a sweep step
+    enum Series {
+        FrameTime, MainCPU,
+        CullCPU, ShadowCPU, LightingCPU, ParticleCPU,
+        ShadowGPU, GeometryGPU, LightingGPU, ParticleGPU,
+        SeriesCount
+    };
+    static constexpr const char* SeriesNames[SeriesCount] = {
+        "frame_ms", "cpu_ms",
+        "cull_cpu_ms", "shadow_cpu_ms", "lighting_cpu_ms", "particle_cpu_ms",
+        "shadow_gpu_ms", "geometry_gpu_ms", "lighting_gpu_ms", "particle_gpu_ms"
+    };
+
+    struct SweepRow {
+        Engine::u32 Value = 0;
+        Engine::f32 BuildMs = 0.0f;
+        Engine::f32 Average[SeriesCount] = {};
+        Engine::f32 FrameP95 = 0.0f;
+        Engine::u32 Visible = 0;
+        Engine::u32 DrawCalls = 0;
+        Engine::u32 Batches = 0;
+        Engine::u32 ShadowDrawCalls = 0;
+    };
+
+    struct SweepState {
+        bool Active = false;
+        SweepAxis Axis = SweepAxis::Entities;
+        Engine::Vector<Engine::u32> Values;
+        size_t Step = 0;
+        Engine::u32 Frame = 0;
+        Parameters Saved;                       // Restored when the sweep ends
+        Engine::Vector<Engine::TimingHistory> Samples;
+    };
+
+    static Engine::Vector<Engine::u32> AxisSteps(SweepAxis axis) {
+        switch (axis) {
+            case SweepAxis::Entities:  return {1000, 10000, 100000, 1000000};
+            case SweepAxis::Meshes:    return {1, 4, 16, 64};
+            case SweepAxis::Materials: return {1, 16, 256, 4096};
+            case SweepAxis::Lights:    return {16, 64, 256, 1024, 4096};
+            case SweepAxis::Emitters:  return {0, 8, 64, 256};
+            default:                   return {};
+        }
+    }
+
+    static const char* AxisStepsText(SweepAxis axis) {
+        switch (axis) {
+            case SweepAxis::Entities:  return "1k, 10k, 100k, 1M";
+            case SweepAxis::Meshes:    return "1, 4, 16, 64";
+            case SweepAxis::Materials: return "1, 16, 256, 4096";
+            case SweepAxis::Lights:    return "16, 64, 256, 1024, 4096";
+            case SweepAxis::Emitters:  return "0, 8, 64, 256";
+            default:                   return "";
+        }
+    }
+
+    static Engine::f32 ElapsedMs(Engine::u64 start) {
+        return static_cast<Engine::f32>(static_cast<Engine::f64>(Engine::Profiler::Now() - start) / 1.0e6);
+    }
+
+    // Scene
+
+    void Rebuild() {
+        const Engine::u64 start = Engine::Profiler::Now();
+
+        ClearScene();
+        std::mt19937 rng(m_Params.Seed);
+
+        CreateMeshes();
+        CreateMaterials(rng);
+        CreateEntities(rng);
+        CreateLights(rng);
+        CreateEmitters(rng);
+
+        m_CullingSystem->InvalidateStaticBounds();
+        m_LastBuildMs = ElapsedMs(start);
+
+        LOG_INFO("Scalability scene: {} entities, {} meshes, {} materials, {} lights, {} emitters ({:.1f} ms)",
+                 m_Params.Entities, m_Params.UniqueMeshes, m_Params.UniqueMaterials,
+                 m_Params.PointLights, m_Params.Emitters, m_LastBuildMs);
+    }
+
+    void ClearScene() {
+        m_Registry.destroy(m_SceneEntities.begin(), m_SceneEntities.end());
+        m_SceneEntities.clear();
+        m_DynamicEntities.clear();
+        m_DynamicBase.clear();
+
+        auto& library = Engine::MaterialLibrary::Instance();
+        for (Engine::u32 id : m_Materials) {
+            library.Destroy(id);
+        }
+        m_Materials.clear();
+
+        m_ParticleSystem->ClearAllEmitters();
+    }
+
+    void CreateMeshes() {
+        // Kept across rebuilds so their pool entries are reused
+        while (m_Meshes.size() < m_Params.UniqueMeshes) {
+            const Engine::u32 i = static_cast<Engine::u32>(m_Meshes.size());
+            const Engine::u32 detail = 8 + 2 * (i / 2);
+            m_Meshes.push_back(i % 2 == 0
+                ? Engine::MeshLoader::CreateSphere(0.5f, detail, detail / 2 + 2)
+                : Engine::MeshLoader::CreateCylinder(0.5f, 1.0f, detail));
+            // Primitives arrive optimized; again so the new LODs are too
+            m_Meshes.back()->GenerateLODs(3);
+            m_Meshes.back()->Optimize();
+        }
+    }
+
+    void CreateMaterials(std::mt19937& rng) {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        auto& library = Engine::MaterialLibrary::Instance();
+
+        m_Materials.reserve(m_Params.UniqueMaterials);
+        for (Engine::u32 i = 0; i < m_Params.UniqueMaterials; i++) {
+            Engine::Material material;
+            material.Name = "Stress " + std::to_string(i);
+            material.BaseColor = glm::vec4(0.3f + 0.7f * unit(rng), 0.3f + 0.7f * unit(rng), 0.3f + 0.7f * unit(rng), 1.0f);
+            material.Metallic = unit(rng);
+            material.Roughness = 0.2f + 0.7f * unit(rng);
+            m_Materials.push_back(library.Create(material));
+        }
+    }
+
+    void CreateEntities(std::mt19937& rng) {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        // Square grid whose side grows with the count, jittered
+        const Engine::u32 count = m_Params.Entities;
+        const Engine::u32 side = std::max(1u, static_cast<Engine::u32>(std::ceil(std::sqrt(static_cast<double>(count)))));
+        const float half = static_cast<float>(side) * Spacing * 0.5f;
+
+        m_SceneEntities.push_back(CreateObject(m_PlaneMesh, {0.0f, 0.0f, 0.0f},
+                                               {half * 2.0f + 20.0f, 1.0f, half * 2.0f + 20.0f},
+                                               {0.2f, 0.2f, 0.22f, 1.0f}, 0.0f, 0.8f, false));
+
+        const auto dynamicCount = static_cast<Engine::u32>(static_cast<float>(count) * m_Params.DynamicFraction);
+        m_DynamicBase.reserve(dynamicCount);
+
+        Engine::Vector<Engine::MeshComponent> meshTemplates;
+        meshTemplates.reserve(m_Params.UniqueMeshes);
+        for (Engine::u32 m = 0; m < m_Params.UniqueMeshes; m++) {
+            meshTemplates.push_back(MakeMeshComponent(m_Meshes[m]));
+        }
+
+        Engine::Vector<Engine::Transform> transforms(count);
+        Engine::Vector<Engine::MeshComponent> meshes(count);
+        Engine::Vector<Engine::MaterialComponent> materials(count);
+        for (Engine::u32 i = 0; i < count; i++) {
+            const float x = static_cast<float>(i % side) * Spacing - half + (unit(rng) - 0.5f) * Spacing * 0.5f;
+            const float z = static_cast<float>(i / side) * Spacing - half + (unit(rng) - 0.5f) * Spacing * 0.5f;
+            const float scale = 0.5f + unit(rng);
+            const glm::vec3 position(x, scale * 0.5f, z);
+
+            transforms[i].SetPosition(position);
+            transforms[i].SetScale(glm::vec3(scale));
+            transforms[i].SetRotation(glm::quat(glm::vec3(0.0f, unit(rng) * glm::two_pi<float>(), 0.0f)));
+            meshes[i] = meshTemplates[i % m_Params.UniqueMeshes];
+            materials[i].MaterialId = m_Materials[(i / 7) % m_Materials.size()];
+
+            if (i < dynamicCount) {
+                m_DynamicBase.push_back(position);
+            }
+        }
+
+        // One create and one insert per pool for the whole grid; world
+        // matrices are left to TransformSystem
+        Engine::Prefab<Engine::Transform, Engine::MeshComponent, Engine::MaterialComponent, Engine::Renderable> prefab;
+        auto& renderable = prefab.Get<Engine::Renderable>();
+        renderable.Visible = true;
+        renderable.InFrustum = true;
+        renderable.CastShadows = true;
+
+        const size_t base = m_SceneEntities.size();
+        m_SceneEntities.resize(base + count);
+        entt::entity* first = m_SceneEntities.data() + base;
+        prefab.Spawn(m_Registry, first, first + count, transforms.data(), meshes.data(), materials.data());
+
+        m_DynamicEntities.assign(first, first + dynamicCount);
+        m_Registry.insert<Engine::StaticGeometry>(first + dynamicCount, first + count);
+    }
+
+    void CreateLights(std::mt19937& rng) {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        const float half = SceneHalfExtent();
+
+        for (Engine::u32 i = 0; i < m_Params.PointLights; i++) {
+            const glm::vec3 position((unit(rng) * 2.0f - 1.0f) * half, 1.5f + 2.5f * unit(rng),
+                                     (unit(rng) * 2.0f - 1.0f) * half);
+            const glm::vec3 color = glm::clamp(glm::vec3(unit(rng), unit(rng), unit(rng)) + 0.2f, 0.0f, 1.0f);
+            m_SceneEntities.push_back(CreatePointLight(position, color, 6.0f, 10.0f));
+        }
+    }
+
+    void CreateEmitters(std::mt19937& rng) {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        const float half = SceneHalfExtent();
+
+        for (Engine::u32 i = 0; i < m_Params.Emitters; i++) {
+            Engine::EmitterSettings settings;
+            switch (i % 3) {
+                case 0: settings = Engine::ParticlePresets::Fire(); break;
+                case 1: settings = Engine::ParticlePresets::Sparks(); break;
+                default: settings = Engine::ParticlePresets::Magic(); break;
+            }
+            settings.Position = glm::vec3((unit(rng) * 2.0f - 1.0f) * half, 0.5f,
+                                          (unit(rng) * 2.0f - 1.0f) * half);
+            m_ParticleSystem->CreateEmitter(settings);
+        }
+    }
+
+    float SceneHalfExtent() const {
+        const auto side = std::ceil(std::sqrt(static_cast<float>(std::max(m_Params.Entities, 1u))));
+        return side * Spacing * 0.5f;
+    }
+
+    void AnimateDynamic() {
+        for (size_t i = 0; i < m_DynamicEntities.size(); i++) {
+            auto& t = m_Registry.get<Engine::Transform>(m_DynamicEntities[i]);
+            const glm::vec3& base = m_DynamicBase[i];
+            t.SetPosition(base.x, base.y + 0.5f + 0.5f * glm::sin(m_Time * 2.0f + static_cast<float>(i)), base.z);
+        }
+    }
+
+    // Sweep
+
+    void StartSweep(SweepAxis axis) {
+        m_Sweep = SweepState{};
+        m_Sweep.Active = true;
+        m_Sweep.Axis = axis;
+        m_Sweep.Values = AxisSteps(axis);
+        m_Sweep.Saved = m_Params;
+        m_Sweep.Samples.assign(SeriesCount, Engine::TimingHistory(MeasureFrames));
+        m_SweepRows.clear();
+        m_SweepRowsAxis = axis;
+        BeginSweepStep();
+    }
+
+    void BeginSweepStep() {
+        const Engine::u32 value = m_Sweep.Values[m_Sweep.Step];
+        switch (m_Sweep.Axis) {
+            case SweepAxis::Entities:  m_Params.Entities = value; break;
+            case SweepAxis::Meshes:    m_Params.UniqueMeshes = value; break;
+            case SweepAxis::Materials: m_Params.UniqueMaterials = value; break;
+            case SweepAxis::Lights:    m_Params.PointLights = value; break;
+            case SweepAxis::Emitters:  m_Params.Emitters = value; break;
+            default: break;
+        }
+        Rebuild();
+
+        m_Sweep.Frame = 0;
+        for (auto& samples : m_Sweep.Samples) {
+            samples.Clear();
+        }
+    }
+
+    void UpdateSweep() {
+        if (!m_Sweep.Active) return;
+
+        // Timings read here are the previous frame's
+        if (++m_Sweep.Frame <= SettleFrames) return;
+
+        Engine::f32 frame[SeriesCount] = {};
+        frame[FrameTime] = Engine::Time::GetFrameTime() * 1000.0f;
+        frame[MainCPU] = Engine::Application::Get().GetCPUTimeMs();
+        for (Series s : {CullCPU, ShadowCPU, LightingCPU, ParticleCPU}) {
+            frame[s] = m_FrameCPU[s];
+        }
+        for (const auto& pass : Engine::GPUProfiler::GetResults()) {
+            if (pass.Depth != 0) continue;
+            if (std::strcmp(pass.Name, "Shadows") == 0) frame[ShadowGPU] += pass.TimeMs;
+            else if (std::strcmp(pass.Name, "Geometry") == 0) frame[GeometryGPU] += pass.TimeMs;
+            else if (std::strcmp(pass.Name, "Lighting") == 0) frame[LightingGPU] += pass.TimeMs;
+            else if (std::strcmp(pass.Name, "Particles") == 0) frame[ParticleGPU] += pass.TimeMs;
+        }
+        for (Engine::u32 s = 0; s < SeriesCount; s++) {
+            m_Sweep.Samples[s].Push(frame[s]);
+        }
+
+        if (m_Sweep.Frame < SettleFrames + MeasureFrames) return;
+
+        SweepRow row;
+        row.Value = m_Sweep.Values[m_Sweep.Step];
+        row.BuildMs = m_LastBuildMs;
+        for (Engine::u32 s = 0; s < SeriesCount; s++) {
+            row.Average[s] = m_Sweep.Samples[s].Summarize().Average;
+        }
+        row.FrameP95 = m_Sweep.Samples[FrameTime].Summarize().P95;
+        row.Visible = m_CullingSystem->GetStats().Visible;
+        row.DrawCalls = m_LightingSystem->GetStats().DrawCalls;
+        row.Batches = m_LightingSystem->GetStats().Batches;
+        row.ShadowDrawCalls = m_ShadowSystem->GetStats().ShadowDrawCalls;
+        m_SweepRows.push_back(row);
+
+        if (++m_Sweep.Step < m_Sweep.Values.size()) {
+            BeginSweepStep();
+            return;
+        }
+
+        m_Sweep.Active = false;
+        m_Params = m_Sweep.Saved;
+        Rebuild();
+        WriteSweepCSV();
+    }
+
+    void WriteSweepCSV() const {
+        char path[64];
+        std::snprintf(path, sizeof(path), "scalability_%s.csv", AxisNames[static_cast<int>(m_SweepRowsAxis)]);
+
+        std::FILE* file = std::fopen(path, "wb");
+        if (!file) {
+            LOG_ERROR("Could not write {}", path);
+            return;
+        }
+
+        std::fprintf(file, "%s,build_ms", AxisNames[static_cast<int>(m_SweepRowsAxis)]);
+        for (const char* name : SeriesNames) {
+            std::fprintf(file, ",%s", name);
+        }
+        std::fputs(",frame_p95_ms,visible,draw_calls,batches,shadow_draw_calls\n", file);
+
+        for (const auto& row : m_SweepRows) {
+            std::fprintf(file, "%u,%.3f", row.Value, static_cast<double>(row.BuildMs));
+            for (Engine::f32 average : row.Average) {
+                std::fprintf(file, ",%.3f", static_cast<double>(average));
+            }
+            std::fprintf(file, ",%.3f,%u,%u,%u,%u\n", static_cast<double>(row.FrameP95),
+                         row.Visible, row.DrawCalls, row.Batches, row.ShadowDrawCalls);
+        }
+        std::fclose(file);
+        LOG_INFO("Sweep written to {}", path);
+    }
+
+    void DrawSweepTable() {
+        constexpr ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+        if (!ImGui::BeginTable("SweepResults", 9, flags)) return;
+
+        ImGui::TableSetupColumn(AxisNames[static_cast<int>(m_SweepRowsAxis)]);
+        ImGui::TableSetupColumn("Frame");
+        ImGui::TableSetupColumn("p95");
+        ImGui::TableSetupColumn("Cull");
+        ImGui::TableSetupColumn("Shadow CPU/GPU");
+        ImGui::TableSetupColumn("Geometry GPU");
+        ImGui::TableSetupColumn("Lighting CPU/GPU");
+        ImGui::TableSetupColumn("Particles CPU/GPU");
+        ImGui::TableSetupColumn("Draws");
+        ImGui::TableHeadersRow();
+
+        for (const auto& row : m_SweepRows) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::Text("%u", row.Value);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", row.Average[FrameTime]);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", row.FrameP95);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", row.Average[CullCPU]);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f / %.2f", row.Average[ShadowCPU], row.Average[ShadowGPU]);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f", row.Average[GeometryGPU]);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f / %.2f", row.Average[LightingCPU], row.Average[LightingGPU]);
+            ImGui::TableNextColumn(); ImGui::Text("%.2f / %.2f", row.Average[ParticleCPU], row.Average[ParticleGPU]);
+            ImGui::TableNextColumn(); ImGui::Text("%u", row.DrawCalls);
+        }
+        ImGui::EndTable();
+
+        if (!m_Sweep.Active && ImGui::Button("Write CSV")) {
+            WriteSweepCSV();
+        }
+    }
+
+private:
+    static constexpr float Spacing = 3.0f;
+
+    Parameters m_Params;
+    Engine::Scope<Engine::CullingSystem> m_CullingSystem;
+    Engine::Scope<Engine::LODSelectionSystem> m_LODSystem;
+    Engine::Scope<Engine::SpatialSortSystem> m_SpatialSortSystem;
+    Engine::Scope<Engine::ParticleSystem> m_ParticleSystem;
+    entt::entity m_Sun = entt::null;
+
+    Engine::Vector<Engine::Ref<Engine::Mesh>> m_Meshes;
+    Engine::Vector<Engine::u32> m_Materials;            // MaterialLibrary ids
+    Engine::Vector<entt::entity> m_SceneEntities;       // Everything Rebuild() creates
+    Engine::Vector<entt::entity> m_DynamicEntities;
+    Engine::Vector<glm::vec3> m_DynamicBase;
+    Engine::f32 m_LastBuildMs = 0.0f;
+
+    // CPU time of this frame's subsystem calls
+    Engine::f32 m_FrameCPU[SeriesCount] = {};
+
+    SweepAxis m_SweepAxis = SweepAxis::Entities;
+    SweepState m_Sweep;
+    SweepAxis m_SweepRowsAxis = SweepAxis::Entities;
+    Engine::Vector<SweepRow> m_SweepRows;
+};
+
+REGISTER_DEMO(ScalabilityStressTest)
+
+} // namespace Demos
@@ -1,6 +1,8 @@
 #include "../DemoBase.hpp"
 #include "../DemoRegistry.hpp"
 
+#include <utility>
+
 namespace Demos {
 
 class ShadowQualityDemo : public DemoBase {
@@ -70,15 +72,6 @@ public:
 
         m_CameraManager.OnUpdate(dt);
         m_Time += dt;
-
-        // Rotate shadow casters
-        for (size_t i = 0; i < m_RotatingCasters.size(); i++) {
-            auto& t = m_Registry.get<Engine::Transform>(m_RotatingCasters[i]);
-            float angle = m_Time * 0.5f + static_cast<float>(i) * glm::pi<float>() / m_RotatingCasters.size();
-            glm::quat rot = glm::angleAxis(angle, glm::vec3(0.0f, 1.0f, 0.0f));
-            t.SetRotation(rot);
-            t.UpdateWorldMatrix();
-        }
     }
 
     void OnEvent(Engine::Event& e) override {
@@ -86,12 +79,21 @@ public:
     }
 
     void OnResize(Engine::u32 width, Engine::u32 height) override {
-        m_LightingSystem->Resize(width, height);
+        // Applied with the next frame, on whichever thread draws it
+        m_ResizePending = true;
     }
 
+    // Both modes draw through DrawFrame; the registry is only written there
     void OnRender() override {
-        RenderScene();
-        RenderTonemapped();
+        DrawFrame(CaptureFrame(), Engine::Time::GetDeltaTime());
+    }
+
+    static constexpr bool SupportsRenderThread = true;
+
+    void OnExtract(Engine::FramePacket& packet) override {
+        packet.Enqueue([this, frame = CaptureFrame()](const Engine::FramePacket& current) {
+            DrawFrame(frame, current.DeltaTime);
+        });
     }
 
     void OnImGuiRender() override {
@@ -135,6 +137,36 @@ public:
     }
 
 private:
+    struct Frame {
+        FrameView View;
+        float Time = 0.0f;
+        bool Resize = false;
+    };
+
+    Frame CaptureFrame() {
+        Frame frame;
+        frame.View = CaptureView();
+        frame.Time = m_Time;
+        frame.Resize = std::exchange(m_ResizePending, false);
+        return frame;
+    }
+
+    void DrawFrame(const Frame& frame, float deltaTime) {
+        if (frame.Resize) {
+            m_LightingSystem->Resize(frame.View.Width, frame.View.Height);
+        }
+
+        // Rotate shadow casters
+        for (size_t i = 0; i < m_RotatingCasters.size(); i++) {
+            auto& t = m_Registry.get<Engine::Transform>(m_RotatingCasters[i]);
+            float angle = frame.Time * 0.5f + static_cast<float>(i) * glm::pi<float>() / m_RotatingCasters.size();
+            glm::quat rot = glm::angleAxis(angle, glm::vec3(0.0f, 1.0f, 0.0f));
+            t.SetRotation(rot);
+        }
+
+        RenderView(frame.View, deltaTime);
+    }
+
     void CreateGround() {
         // Very large ground for distance testing
         CreateObject(m_CubeMesh,
@@ -239,6 +271,7 @@ private:
 private:
     Engine::Vector<entt::entity> m_RotatingCasters;
     bool m_CursorEnabled = false;
+    bool m_ResizePending = false;
 };
 
 REGISTER_DEMO(ShadowQualityDemo)
@@ -0,0 +1,188 @@
+#include "../DemoBase.hpp"
+#include "../DemoRegistry.hpp"
+#include "ecs/WorldPartition.hpp"
+#include "ecs/Components/Hierarchy.hpp"
+#include <algorithm>
+#include <random>
+
+namespace Demos {
+
+// A city too large to keep resident, streamed in WorldPartition cells around
+// the camera. The city is generated and split into cell files on start;
+// from then on only the cells near the camera are in the registry. The
+// ground and the lights without a position stay resident.
+class WorldStreamingDemo : public DemoBase {
+public:
+    const char* GetName() const override { return "World Streaming"; }
+    const char* GetDescription() const override {
+        return "City streamed in grid cells around the camera with WorldPartition";
+    }
+
+    void OnInit() override {
+        LOG_INFO("Initializing World Streaming Demo");
+
+        Engine::FPSCameraSettings fpsSettings;
+        fpsSettings.InitialPosition = {0.0f, 30.0f, 0.0f};
+        fpsSettings.InitialPitch = -15.0f;
+        fpsSettings.MovementSpeed = 30.0f;
+        fpsSettings.MouseSensitivity = 0.12f;
+        m_CameraManager.Register("fps",
+            Engine::CreateScope<Engine::FPSCameraController>(GetWindow().GetAspectRatio(), fpsSettings));
+        m_CameraManager.SetActive("fps");
+        Engine::Input::SetCursorMode(true);
+
+        InitializeRenderingSystems();
+
+        // Regenerated on every start, so the cells always match the current
+        // component layout
+        BuildCity();
+        const Engine::u32 cells = Engine::WorldPartition::Build(m_Registry, CellDirectory, CellSize);
+        if (cells == 0) {
+            LOG_ERROR("World Streaming: no cells written to {}", CellDirectory);
+        }
+
+        // Created after the build so they stay out of the cells
+        const float extent = Blocks * BlockSize * 0.5f + BlockSize;
+        CreateObject(m_CubeMesh, {0.0f, -0.25f, 0.0f}, {extent * 2.0f, 0.5f, extent * 2.0f},
+                     {0.2f, 0.2f, 0.22f, 1.0f}, 0.0f, 0.9f, false);
+        CreateAmbientLight({0.04f, 0.04f, 0.05f}, 1.0f);
+        CreateDirectionalLight({0.4f, -1.0f, 0.3f}, {1.0f, 0.95f, 0.85f}, 0.8f, true);
+        m_ShadowSystem->GetSettings().MaxShadowDistance = 150.0f;
+
+        Engine::WorldPartition::Settings settings;
+        settings.CellSize = CellSize;
+        m_Partition.Open(m_Registry, CellDirectory, settings);
+
+        m_Exposure = 0.9f;
+        glEnable(GL_DEPTH_TEST);
+
+        LOG_INFO("World Streaming: {} cells, Tab to capture the mouse, WASD to fly", cells);
+    }
+
+    void OnShutdown() override {
+        m_Partition.Close();
+        ShutdownRenderingSystems();
+        Engine::Input::SetCursorMode(true);
+    }
+
+    void OnUpdate(Engine::f32 dt) override {
+        if (Engine::Input::IsKeyJustPressed(Engine::Key::Tab)) {
+            m_CursorEnabled = !m_CursorEnabled;
+            Engine::Input::SetCursorMode(m_CursorEnabled);
+        }
+
+        if (Engine::Input::IsKeyPressed(Engine::Key::Equal)) {
+            m_Exposure = glm::min(3.0f, m_Exposure + dt * 1.5f);
+        }
+        if (Engine::Input::IsKeyPressed(Engine::Key::Minus)) {
+            m_Exposure = glm::max(0.1f, m_Exposure - dt * 1.5f);
+        }
+
+        m_CameraManager.OnUpdate(dt);
+        m_Time += dt;
+
+        // Loads and unloads for where the camera is now, within the frame budget
+        m_Partition.Update(m_CameraManager);
+    }
+
+    void OnEvent(Engine::Event& e) override {
+        m_CameraManager.OnEvent(e);
+    }
+
+    void OnResize(Engine::u32 width, Engine::u32 height) override {
+        m_LightingSystem->Resize(width, height);
+    }
+
+    void OnRender() override {
+        RenderScene();
+        RenderTonemapped();
+    }
+
+    void OnImGuiRender() override {
+        ImGui::SetNextWindowPos(ImVec2(10, 120), ImGuiCond_FirstUseEver);
+
+        ImGui::Begin("World Streaming", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+
+        ImGui::Text("FPS: %.0f (%.2f ms)", Engine::Time::GetFPS(), Engine::Time::GetDeltaTime() * 1000.0f);
+        if (const auto* camera = m_CameraManager.GetActiveCamera()) {
+            const glm::vec3& position = camera->GetPosition();
+            ImGui::Text("Camera: %.0f, %.0f, %.0f (cell %d, %d)", position.x, position.y, position.z,
+                        static_cast<int>(glm::floor(position.x / CellSize)),
+                        static_cast<int>(glm::floor(position.z / CellSize)));
+        }
+
+        ImGui::Separator();
+
+        const auto stats = m_Partition.GetStats();
+        ImGui::Text("Cells: %u loaded, %u loading, %u total", stats.LoadedCells, stats.LoadingCells, stats.Cells);
+        ImGui::Text("Resident entities: %u", stats.ResidentEntities);
+        ImGui::Text("Entities rendered: %u", m_LightingSystem->GetStats().EntitiesRendered);
+        ImGui::Text("Loaded / unloaded since start: %u / %u", stats.CellsLoaded, stats.CellsUnloaded);
+
+        ImGui::Separator();
+
+        auto& settings = m_Partition.GetSettings();
+        ImGui::SliderFloat("Load Radius", &settings.LoadRadius, CellSize * 0.5f, CellSize * 8.0f, "%.0f");
+        ImGui::SliderFloat("Unload Radius", &settings.UnloadRadius, CellSize * 0.5f, CellSize * 10.0f, "%.0f");
+        settings.UnloadRadius = std::max(settings.UnloadRadius, settings.LoadRadius);
+        ImGui::SliderFloat("Frame Budget (ms)", &settings.FrameBudgetMs, 0.25f, 8.0f, "%.2f");
+        ImGui::SliderFloat("Exposure", &m_Exposure, 0.1f, 3.0f);
+
+        ImGui::Separator();
+        ImGui::TextDisabled("Tab: Capture mouse");
+        ImGui::TextDisabled("WASD: Fly, Shift: Sprint");
+
+        ImGui::End();
+    }
+
+private:
+    // One lot per block: an unscaled root with the building and, on some,
+    // a rooftop dome below it, so cells carry whole hierarchies. Street
+    // lamps are roots of their own.
+    void BuildCity() {
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<float> height(4.0f, 40.0f);
+        std::uniform_real_distribution<float> shade(0.35f, 0.8f);
+
+        const float origin = -Blocks * BlockSize * 0.5f;
+        for (int x = 0; x < Blocks; x++) {
+            for (int z = 0; z < Blocks; z++) {
+                const glm::vec3 center = {origin + (x + 0.5f) * BlockSize, 0.0f, origin + (z + 0.5f) * BlockSize};
+                const float h = height(rng);
+                const float tint = shade(rng);
+
+                auto lot = CreateEntity();
+                SetTransform(lot, center);
+
+                auto building = CreateObject(m_CubeMesh, {0.0f, h * 0.5f, 0.0f}, {Footprint, h, Footprint},
+                                             {tint, tint, tint * 1.05f, 1.0f}, 0.1f, 0.7f);
+                Engine::HierarchyUtils::SetParent(m_Registry, building, lot);
+
+                if ((x + z) % 4 == 0) {
+                    auto dome = CreateObject(m_SphereMesh, {0.0f, h, 0.0f}, glm::vec3(Footprint * 0.3f),
+                                             {0.8f, 0.8f, 0.85f, 1.0f}, 0.9f, 0.25f);
+                    Engine::HierarchyUtils::SetParent(m_Registry, dome, lot);
+                }
+
+                if (x % 3 == 0 && z % 3 == 0) {
+                    const glm::vec3 corner = center + glm::vec3(BlockSize * 0.5f, 4.0f, BlockSize * 0.5f);
+                    CreatePointLight(corner, {1.0f, 0.8f, 0.55f}, 6.0f, 14.0f);
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr const char* CellDirectory = "cache/world_streaming";
+    static constexpr float CellSize = 64.0f;
+    static constexpr int Blocks = 48;           // Per side
+    static constexpr float BlockSize = 20.0f;
+    static constexpr float Footprint = 12.0f;
+
+    Engine::WorldPartition m_Partition;
+    bool m_CursorEnabled = true;
+};
+
+REGISTER_DEMO(WorldStreamingDemo)
+
+} // namespace Demos
@@ -0,0 +1,62 @@
+// AssetCooker - cooks a whole asset tree ahead of time: images to KTX2 and
+// OBJ meshes to .pvmesh with vertex ordering, LODs and meshlets baked in
+// (see AssetCooker). A manifest of content hashes at the root of the tree
+// keeps reruns to the sources that actually changed.
+//
+// Usage: AssetCooker <directory> [--format auto|bc1|bc3|bc4|bc5|rgba8] [--no-flip] [--no-mips]
+//                    [--lods <count>] [--meshlets] [--no-optimize] [--force]
+
+#include "resources/cooking/AssetCooker.hpp"
+#include "core/Logger.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace Engine;
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::printf("Usage: AssetCooker <directory> [--format auto|bc1|bc3|bc4|bc5|rgba8] [--no-flip] [--no-mips]\n"
+                    "                   [--lods <count>] [--meshlets] [--no-optimize] [--force]\n");
+        return 1;
+    }
+
+    Logger::Init();
+
+    AssetCookOptions options;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--no-flip") == 0) {
+            options.Textures.FlipVertically = false;
+        } else if (std::strcmp(argv[i], "--no-mips") == 0) {
+            options.Textures.GenerateMips = false;
+        } else if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            const char* format = argv[++i];
+            if (std::strcmp(format, "bc1") == 0)        options.Textures.Format = TextureCookFormat::BC1;
+            else if (std::strcmp(format, "bc3") == 0)   options.Textures.Format = TextureCookFormat::BC3;
+            else if (std::strcmp(format, "bc4") == 0)   options.Textures.Format = TextureCookFormat::BC4;
+            else if (std::strcmp(format, "bc5") == 0)   options.Textures.Format = TextureCookFormat::BC5;
+            else if (std::strcmp(format, "rgba8") == 0) options.Textures.Format = TextureCookFormat::RGBA8;
+            else if (std::strcmp(format, "auto") != 0) {
+                std::printf("Unknown format '%s'\n", format);
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--lods") == 0 && i + 1 < argc) {
+            options.Meshes.LODCount = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--meshlets") == 0) {
+            options.Meshes.Meshlets = true;
+        } else if (std::strcmp(argv[i], "--no-optimize") == 0) {
+            options.Meshes.Optimize = false;
+        } else if (std::strcmp(argv[i], "--force") == 0) {
+            options.Force = true;
+        } else {
+            std::printf("Unknown option '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    const AssetCookStats stats = AssetCooker::CookDirectory(argv[1], options);
+    std::printf("Cooked %u asset(s) under %s, %u up to date, %u failed\n",
+                stats.Cooked, argv[1], stats.UpToDate, stats.Failed);
+    return stats.Failed > 0 ? 1 : 0;
+}
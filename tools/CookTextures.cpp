@@ -0,0 +1,49 @@
+// CookTextures - converts the source images of an asset tree to KTX2 with
+// block compression and precomputed mips (see TextureCooker). Cooked files
+// land beside their sources, where TextureLoader picks them up.
+//
+// Usage: CookTextures <directory> [--format auto|bc1|bc3|bc4|bc5|rgba8] [--no-flip] [--no-mips]
+
+#include "resources/cooking/TextureCooker.hpp"
+#include "core/Logger.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace Engine;
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::printf("Usage: CookTextures <directory> [--format auto|bc1|bc3|bc4|bc5|rgba8] [--no-flip] [--no-mips]\n");
+        return 1;
+    }
+
+    Logger::Init();
+
+    TextureCookOptions options;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--no-flip") == 0) {
+            options.FlipVertically = false;
+        } else if (std::strcmp(argv[i], "--no-mips") == 0) {
+            options.GenerateMips = false;
+        } else if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            const char* format = argv[++i];
+            if (std::strcmp(format, "bc1") == 0)        options.Format = TextureCookFormat::BC1;
+            else if (std::strcmp(format, "bc3") == 0)   options.Format = TextureCookFormat::BC3;
+            else if (std::strcmp(format, "bc4") == 0)   options.Format = TextureCookFormat::BC4;
+            else if (std::strcmp(format, "bc5") == 0)   options.Format = TextureCookFormat::BC5;
+            else if (std::strcmp(format, "rgba8") == 0) options.Format = TextureCookFormat::RGBA8;
+            else if (std::strcmp(format, "auto") != 0) {
+                std::printf("Unknown format '%s'\n", format);
+                return 1;
+            }
+        } else {
+            std::printf("Unknown option '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    const u32 cooked = TextureCooker::CookDirectory(argv[1], options);
+    std::printf("Cooked %u texture(s) under %s\n", cooked, argv[1]);
+    return 0;
+}
@@ -0,0 +1,86 @@
+// PackAssets - packs an asset tree into one .pvpak archive (see
+// AssetArchive) that ResourceManager::MountArchive reads textures and
+// meshes from. Cook the tree with AssetCooker first to pack cooked files.
+//
+// Files named in the load order file (ResourceManager::SaveLoadOrder) come
+// first, in that order; the rest follow by path.
+//
+// Usage: PackAssets <directory> <output.pvpak> [--order <file>] [--no-compress]
+
+#include "resources/AssetArchive.hpp"
+#include "resources/cooking/AssetCooker.hpp"
+#include "core/Logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace Engine;
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::printf("Usage: PackAssets <directory> <output.pvpak> [--order <file>] [--no-compress]\n");
+        return 1;
+    }
+
+    Logger::Init();
+
+    const char* orderFile = nullptr;
+    AssetArchiveWriteOptions options;
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--order") == 0 && i + 1 < argc) {
+            orderFile = argv[++i];
+        } else if (std::strcmp(argv[i], "--no-compress") == 0) {
+            options.Compress = false;
+        } else {
+            std::printf("Unknown option '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    namespace fs = std::filesystem;
+    const fs::path root(argv[1]);
+    const fs::path output = fs::absolute(argv[2]);
+
+    // Every file under root by archive path, less the cook manifest and the output
+    HashMap<String, String> files;
+    std::error_code error;
+    for (auto it = fs::recursive_directory_iterator(root, error); !error && it != fs::recursive_directory_iterator();
+         it.increment(error)) {
+        if (!it->is_regular_file() || it->path().filename() == AssetCooker::ManifestName) continue;
+        if (fs::absolute(it->path()) == output) continue;
+        files[it->path().lexically_relative(root).generic_string()] = it->path().string();
+    }
+    if (error) {
+        std::printf("Could not walk %s: %s\n", argv[1], error.message().c_str());
+        return 1;
+    }
+
+    Vector<AssetArchive::Source> sources;
+    sources.reserve(files.size());
+    if (orderFile) {
+        std::ifstream order(orderFile);
+        String path;
+        while (std::getline(order, path)) {
+            auto file = files.find(path);
+            if (file == files.end()) continue;
+            sources.push_back({file->first, file->second});
+            files.erase(file);
+        }
+    }
+
+    const usize ordered = sources.size();
+    for (auto& [path, filepath] : files) {
+        sources.push_back({path, filepath});
+    }
+    std::sort(sources.begin() + static_cast<std::ptrdiff_t>(ordered), sources.end(),
+              [](const auto& a, const auto& b) { return a.Path < b.Path; });
+
+    if (!AssetArchive::Write(sources, output.string(), options)) {
+        return 1;
+    }
+    std::printf("Packed %zu file(s) (%zu in load order) into %s\n", sources.size(), ordered, argv[2]);
+    return 0;
+}